@@ -288,6 +288,39 @@ public class TestPrepareExecute extends BaseCQLTest {
     testInvalidPrepare("DELETE FROM test_pk_indices WHERE h2 = ? AND h1 = ?;");
   }
 
+  @Test
+  public void testRepeatedQueryAfterSchemaChange() throws Exception {
+    LOG.info("Begin test");
+
+    // Non-prepared statements are cached by the CQL proxy, so repeated queries should see schema
+    // changes made in between.
+    session.execute("CREATE TABLE test_query_cache (h INT PRIMARY KEY, v INT);");
+    String insert_stmt = "INSERT INTO test_query_cache (h, v) VALUES (1, 2);";
+    String select_stmt = "SELECT * FROM test_query_cache WHERE h = 1;";
+    for (int i = 0; i < 3; i++) {
+      session.execute(insert_stmt);
+      Row row = session.execute(select_stmt).one();
+      assertEquals(2, row.getColumnDefinitions().size());
+      assertEquals(2, row.getInt("v"));
+    }
+
+    session.execute("ALTER TABLE test_query_cache ADD c INT;");
+    session.execute("UPDATE test_query_cache SET c = 3 WHERE h = 1;");
+    Row row = session.execute(select_stmt).one();
+    assertEquals(3, row.getColumnDefinitions().size());
+    assertEquals(3, row.getInt("c"));
+
+    // Recreate the table with a different value type.
+    session.execute("DROP TABLE test_query_cache;");
+    session.execute("CREATE TABLE test_query_cache (h INT PRIMARY KEY, v BIGINT);");
+    session.execute(insert_stmt);
+    row = session.execute(select_stmt).one();
+    assertEquals(2, row.getColumnDefinitions().size());
+    assertEquals(2L, row.getLong("v"));
+
+    LOG.info("End test");
+  }
+
   @Test
   public void testDDLKeyspaceResolution() throws Exception {
     // Create 2 test keyspaces.
@@ -100,6 +100,20 @@ DEFINE_bool(
     stop_on_empty_read, true,
     "Stop reading if we get an empty set of rows on a read operation");
 
+DEFINE_double(
+    target_write_ops_per_sec, 0,
+    "Target rate of writes of all writer threads together. Writes arrive as a Poisson process and "
+    "latency is measured from the intended send time, so queueing delay is not hidden. 0 means "
+    "closed loop, i.e. each writer thread sends the next write as soon as the previous completes.");
+
+DEFINE_double(
+    target_read_ops_per_sec, 0,
+    "Target rate of reads of all reader threads together, see target_write_ops_per_sec.");
+
+DEFINE_string(
+    read_key_distribution, "default",
+    "Distribution of keys to read: default, uniform, zipfian, hotspot or latest.");
+
 using strings::Substitute;
 using std::atomic_long;
 using std::atomic_bool;
@@ -138,6 +152,8 @@ using yb::load_generator::MultiThreadedReader;
 using yb::load_generator::MultiThreadedWriter;
 using yb::load_generator::SingleThreadedScanner;
 using yb::load_generator::FormatHexForLoadTestKey;
+using yb::load_generator::MultiThreadedAction;
+using yb::load_generator::ParseKeyDistribution;
 
 // ------------------------------------------------------------------------------------------------
 
@@ -172,6 +188,8 @@ int main(int argc, char *argv[]) {
     LOG(FATAL) << "If reads only or writes only option is set, then we cannot drop the table";
   }
 
+  CHECK_OK(ParseKeyDistribution(FLAGS_read_key_distribution));
+
   bool use_redis_table =
       !FLAGS_target_redis_server_addresses.empty() || FLAGS_create_redis_table_and_exit;
 
@@ -348,6 +366,16 @@ bool DropTableIfNecessary(const shared_ptr<YBClient> &client, const YBTableName
   return false;
 }
 
+void LogLatency(const string& name, const MultiThreadedAction& action) {
+  const auto& histogram = action.latency_histogram();
+  LOG(INFO) << name << ": " << histogram.TotalCount() << " ops, latency (us): mean: "
+            << histogram.MeanValue() << ", p50: " << histogram.ValueAtPercentile(50)
+            << ", p90: " << histogram.ValueAtPercentile(90)
+            << ", p99: " << histogram.ValueAtPercentile(99)
+            << ", p99.9: " << histogram.ValueAtPercentile(99.9)
+            << ", max: " << histogram.MaxValue();
+}
+
 void LaunchYBLoadTest(SessionFactory *session_factory) {
   LOG(INFO) << "Starting load test";
   atomic_bool stop_flag(false);
@@ -356,19 +384,26 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     MultiThreadedWriter writer(
         FLAGS_num_rows, 0, FLAGS_num_writer_threads, session_factory, &stop_flag,
         FLAGS_value_size_bytes, FLAGS_max_num_write_errors);
+    writer.set_target_ops_per_sec(FLAGS_target_write_ops_per_sec);
 
     writer.Start();
     writer.WaitForCompletion();
+    LogLatency("Writes", writer);
   } else {
     MultiThreadedWriter writer(
         FLAGS_num_rows, 0, FLAGS_num_writer_threads, session_factory, &stop_flag,
         FLAGS_value_size_bytes, FLAGS_max_num_write_errors);
+    writer.set_target_ops_per_sec(FLAGS_target_write_ops_per_sec);
 
     writer.Start();
     MultiThreadedReader reader(FLAGS_num_rows, FLAGS_num_reader_threads, session_factory,
                                writer.InsertionPoint(), writer.InsertedKeys(), writer.FailedKeys(),
                                &stop_flag, FLAGS_value_size_bytes, FLAGS_max_num_read_errors,
                                FLAGS_stop_on_empty_read);
+    reader.set_target_ops_per_sec(FLAGS_target_read_ops_per_sec);
+    auto key_distribution = ParseKeyDistribution(FLAGS_read_key_distribution);
+    CHECK_OK(key_distribution);
+    reader.set_key_distribution(*key_distribution);
 
     reader.Start();
 
@@ -377,5 +412,7 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     // The reader will not stop on its own, so we stop it as soon as the writer stops.
     reader.Stop();
     reader.WaitForCompletion();
+    LogLatency("Writes", writer);
+    LogLatency("Reads", reader);
   }
 }
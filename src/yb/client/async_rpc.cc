@@ -22,8 +22,11 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/common/transaction.h"
 
+#include "yb/rpc/messenger.h"
+
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 
 // TODO: do we need word Redis in following two metrics? ReadRpc and WriteRpc objects emitting
@@ -53,6 +56,13 @@ DEFINE_bool(forward_redis_requests, true, "If false, the redis op will not be se
             "part of the reply and ignores the rest. For now, if this flag is true, we will only "
             "attempt to read from leaders, so redis_allow_reads_from_followers will be ignored.");
 
+DEFINE_int32(client_hedged_reads_budget_percent, 0,
+             "Max number of hedged reads, as percent of reads that could be served by any replica. "
+             "A hedged read is sent to another replica when the response to such read is not "
+             "received within p95 latency of the tablet server. 0 disables hedged reads.");
+TAG_FLAG(client_hedged_reads_budget_percent, advanced);
+TAG_FLAG(client_hedged_reads_budget_percent, runtime);
+
 using namespace std::placeholders;
 
 namespace yb {
@@ -83,6 +93,30 @@ bool LocalTabletServerOnly(const InFlightOps& ops) {
           !FLAGS_forward_redis_requests);
 }
 
+// Budget of hedged reads, in hundredths of a read. Each read that could be hedged adds
+// client_hedged_reads_budget_percent, and each hedged read takes 100.
+constexpr int64_t kHedgedReadCost = 100;
+constexpr int64_t kMaxHedgedReadsBudget = 100 * kHedgedReadCost;
+std::atomic<int64_t> hedged_reads_budget{0};
+
+void AddHedgedReadsBudget(int64_t amount) {
+  auto budget = hedged_reads_budget.load(std::memory_order_relaxed);
+  while (budget < kMaxHedgedReadsBudget &&
+         !hedged_reads_budget.compare_exchange_weak(
+             budget, std::min(budget + amount, kMaxHedgedReadsBudget))) {
+  }
+}
+
+bool TakeHedgedReadsBudget() {
+  auto budget = hedged_reads_budget.load(std::memory_order_relaxed);
+  while (budget >= kHedgedReadCost) {
+    if (hedged_reads_budget.compare_exchange_weak(budget, budget - kHedgedReadCost)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }
 
 AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
@@ -260,19 +294,19 @@ AsyncRpcBase<Req, Resp>::AsyncRpcBase(
 }
 
 template <class Req, class Resp>
-bool AsyncRpcBase<Req, Resp>::CommonResponseCheck(const Status& status) {
+bool AsyncRpcBase<Req, Resp>::CommonResponseCheck(const Status& status, const Resp& resp) {
   if (!status.ok()) {
     return false;
   }
-  if (resp_.has_error()) {
-    LOG(WARNING) << ToString() << " has error:" << resp_.error().DebugString()
+  if (resp.has_error()) {
+    LOG(WARNING) << ToString() << " has error:" << resp.error().DebugString()
                  << ". Requests not processed.";
     // If there is an error at the Rpc itself, there should be no individual responses.
     // All of them need to be marked as failed.
-    Failed(StatusFromPB(resp_.error().status()));
+    Failed(StatusFromPB(resp.error().status()));
     return false;
   }
-  auto restart_read_time = ReadHybridTime::FromRestartReadTimePB(resp_);
+  auto restart_read_time = ReadHybridTime::FromRestartReadTimePB(resp);
   if (restart_read_time) {
     auto read_point = batcher_->read_point();
     if (read_point) {
@@ -397,7 +431,7 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
     TRACE_TO(trace_, "Received from server: $0", resp_.trace_buffer());
   }
   batcher_->ProcessWriteResponse(*this, status);
-  if (!CommonResponseCheck(status)) {
+  if (!CommonResponseCheck(status, resp_)) {
     return;
   }
 
@@ -509,6 +543,11 @@ ReadRpc::ReadRpc(
         if (ql_op->read_time()) {
           ql_op->read_time().AddToPB(&req_);
         }
+        // Ops batched together are read at the same time, so the strictest bound applies.
+        if (ql_op->max_staleness_ms() != 0 &&
+            (!req_.has_max_staleness_ms() || ql_op->max_staleness_ms() < req_.max_staleness_ms())) {
+          req_.set_max_staleness_ms(ql_op->max_staleness_ms());
+        }
         break;
       }
       case YBOperation::Type::PGSQL_READ: {
@@ -556,19 +595,160 @@ void ReadRpc::CallRemoteMethod() {
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
+  send_time_ = MonoTime::Now();
+  tablet_invoker_.current_ts().ReadStarted();
+  MaybeScheduleHedgedRead();
   tablet_invoker_.proxy()->ReadAsync(
       req_, &resp_, PrepareController(),
       std::bind(&ReadRpc::Finished, this, Status::OK()));
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
+void ReadRpc::MaybeScheduleHedgedRead() {
+  const auto budget_percent = FLAGS_client_hedged_reads_budget_percent;
+  if (budget_percent <= 0 || num_attempts() > 1 ||
+      req_.consistency_level() != YBConsistencyLevel::CONSISTENT_PREFIX ||
+      tablet_invoker_.local_tserver_only() || IsLocalCall()) {
+    return;
+  }
+  AddHedgedReadsBudget(budget_percent);
+  auto delay = tablet_invoker_.current_ts().ReadLatencyP95();
+  if (!delay.Initialized() || delay.ToMicroseconds() == 0) {
+    return;
+  }
+
+  hedge_scheduled_ = true;
+  std::weak_ptr<ReadRpc> weak_self = std::static_pointer_cast<ReadRpc>(shared_from_this());
+  tablet_invoker_.client().messenger()->scheduler().Schedule(
+      [weak_self](const Status& status) {
+        auto self = weak_self.lock();
+        if (self && status.ok()) {
+          self->SendHedgedRead();
+        }
+      },
+      delay.ToSteadyDuration());
+}
+
+void ReadRpc::SendHedgedRead() {
+  HedgedRead* hedge;
+  {
+    std::lock_guard<simple_spinlock> lock(hedge_lock_);
+    if (primary_done_ || !TakeHedgedReadsBudget()) {
+      return;
+    }
+    auto* ts = tablet_invoker_.SelectHedgeTabletServer();
+    if (ts == nullptr) {
+      return;
+    }
+    // Request is copied while the primary read could not be processed, because processing
+    // restores parts of the request into operations.
+    hedge_.reset(new HedgedRead);
+    hedge_->req = req_;
+    hedge_->ts = ts;
+    hedge = hedge_.get();
+  }
+
+  TRACE_TO(trace_, "Sending hedged read to $0", hedge->ts->ToString());
+  auto status = hedge->ts->InitProxy(&tablet_invoker_.client());
+  if (!status.ok()) {
+    HedgedReadFinished(status);
+    return;
+  }
+  hedge->controller.set_deadline(retrier().deadline());
+  hedge->start = MonoTime::Now();
+  hedge->ts->ReadStarted();
+  auto self = std::static_pointer_cast<ReadRpc>(shared_from_this());
+  hedge->ts->proxy()->ReadAsync(
+      hedge->req, &hedge->resp, &hedge->controller, [self, hedge] {
+        self->HedgedReadFinished(hedge->controller.status());
+      });
+}
+
+void ReadRpc::HedgedReadFinished(const Status& status) {
+  if (hedge_->start.Initialized()) {
+    hedge_->ts->ReadFinished(status, MonoTime::Now().GetDeltaSince(hedge_->start));
+  }
+
+  bool take_hedge = false;
+  bool finish_primary = false;
+  bool release = false;
+  {
+    std::lock_guard<simple_spinlock> lock(hedge_lock_);
+    hedge_done_ = true;
+    if (completed_) {
+      return;
+    }
+    if (status.ok() && !hedge_->resp.has_error()) {
+      completed_ = true;
+      hedge_won_ = true;
+      take_hedge = true;
+      // Otherwise primary read will release this RPC when done.
+      release = primary_done_;
+    } else if (primary_done_) {
+      // Primary read failure was deferred, waiting for this one.
+      completed_ = true;
+      finish_primary = true;
+    }
+  }
+
+  if (take_hedge) {
+    TRACE_TO(trace_, "Hedged read to $0 won", hedge_->ts->ToString());
+    ProcessResponseFromTserver(Status::OK());
+    batcher_->RemoveInFlightOpsAfterFlushing(ops_, Status::OK(), PropagatedHybridTime());
+    batcher_->CheckForFinishedFlush();
+    if (release) {
+      retained_self_.reset();
+    }
+  } else if (finish_primary) {
+    AsyncRpc::Finished(deferred_primary_status_);
+  }
+}
+
+void ReadRpc::Finished(const Status& status) {
+  if (send_time_.Initialized()) {
+    tablet_invoker_.current_ts().ReadFinished(
+        status, MonoTime::Now().GetDeltaSince(send_time_));
+    send_time_ = MonoTime::kUninitialized;
+  }
+
+  bool hedge_won = false;
+  if (hedge_scheduled_) {
+    std::lock_guard<simple_spinlock> lock(hedge_lock_);
+    primary_done_ = true;
+    if (hedge_won_) {
+      // Result was taken from the hedged read, this RPC was kept only for the primary response.
+      hedge_won = true;
+    } else if (completed_) {
+      // Already decided to use the primary read, so this is a retry.
+    } else if (hedge_ && !hedge_done_ && (!status.ok() || resp_.has_error())) {
+      // Hedged read could still succeed.
+      deferred_primary_status_ = status;
+      return;
+    } else {
+      completed_ = true;
+    }
+  }
+  if (hedge_won) {
+    retained_self_.reset();
+    return;
+  }
+  AsyncRpc::Finished(status);
+}
+
+HybridTime ReadRpc::PropagatedHybridTime() {
+  return GetPropagatedHybridTime(hedge_won_ ? hedge_->resp : resp_);
+}
+
 void ReadRpc::ProcessResponseFromTserver(const Status& status) {
+  // When hedged read won, the primary response could be still written concurrently.
+  auto& resp = hedge_won_ ? hedge_->resp : resp_;
+  const auto& controller = hedge_won_ ? hedge_->controller : retrier().controller();
   TRACE_TO(trace_, "ProcessResponseFromTserver($0)", status.ToString(false));
-  if (resp_.has_trace_buffer()) {
-    TRACE_TO(trace_, "Received from server: $0", resp_.trace_buffer());
+  if (resp.has_trace_buffer()) {
+    TRACE_TO(trace_, "Received from server: $0", resp.trace_buffer());
   }
   batcher_->ProcessReadResponse(*this, status);
-  if (!CommonResponseCheck(status)) {
+  if (!CommonResponseCheck(status, resp)) {
     return;
   }
 
@@ -580,30 +760,39 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
     YBOperation* yb_op = op->yb_op.get();
     switch (yb_op->type()) {
       case YBOperation::Type::REDIS_READ: {
-        if (redis_idx >= resp_.redis_batch().size()) {
+        if (redis_idx >= resp.redis_batch().size()) {
           batcher_->AddOpCountMismatchError();
           return;
         }
         // Restore Redis read request PB and extract response.
         auto* redis_op = down_cast<YBRedisReadOp*>(yb_op);
         redis_op->mutable_request()->Swap(req_.mutable_redis_batch(redis_idx));
-        redis_op->mutable_response()->Swap(resp_.mutable_redis_batch(redis_idx));
+        redis_op->mutable_response()->Swap(resp.mutable_redis_batch(redis_idx));
+        auto* redis_response = redis_op->mutable_response();
+        if (redis_response->has_encoded_response_sidecar()) {
+          Slice encoded_response;
+          CHECK_OK(controller.GetSidecar(
+              redis_response->encoded_response_sidecar(), &encoded_response));
+          redis_response->set_encoded_response(
+              encoded_response.cdata(), encoded_response.size());
+          redis_response->clear_encoded_response_sidecar();
+        }
         redis_idx++;
         break;
       }
       case YBOperation::Type::QL_READ: {
-        if (ql_idx >= resp_.ql_batch().size()) {
+        if (ql_idx >= resp.ql_batch().size()) {
           batcher_->AddOpCountMismatchError();
           return;
         }
         // Restore QL read request PB and extract response.
         auto* ql_op = down_cast<YBqlReadOp*>(yb_op);
         ql_op->mutable_request()->Swap(req_.mutable_ql_batch(ql_idx));
-        ql_op->mutable_response()->Swap(resp_.mutable_ql_batch(ql_idx));
+        ql_op->mutable_response()->Swap(resp.mutable_ql_batch(ql_idx));
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          CHECK_OK(controller.GetSidecar(
               ql_response.rows_data_sidecar(), &rows_data));
           ql_op->mutable_rows_data()->assign(util::to_char_ptr(rows_data.data()), rows_data.size());
         }
@@ -611,18 +800,18 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
         break;
       }
       case YBOperation::Type::PGSQL_READ: {
-        if (pgsql_idx >= resp_.pgsql_batch().size()) {
+        if (pgsql_idx >= resp.pgsql_batch().size()) {
           batcher_->AddOpCountMismatchError();
           return;
         }
         // Restore PGSQL read request PB and extract response.
         auto* pgsql_op = down_cast<YBPgsqlReadOp*>(yb_op);
         pgsql_op->mutable_request()->Swap(req_.mutable_pgsql_batch(pgsql_idx));
-        pgsql_op->mutable_response()->Swap(resp_.mutable_pgsql_batch(pgsql_idx));
+        pgsql_op->mutable_response()->Swap(resp.mutable_pgsql_batch(pgsql_idx));
         const auto& pgsql_response = pgsql_op->response();
         if (pgsql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          CHECK_OK(controller.GetSidecar(
               pgsql_response.rows_data_sidecar(), &rows_data));
           down_cast<YBPgsqlReadOp*>(yb_op)->mutable_rows_data()->assign(
               util::to_char_ptr(rows_data.data()), rows_data.size());
@@ -638,16 +827,16 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
     }
   }
 
-  if (redis_idx != resp_.redis_batch().size() ||
-      ql_idx != resp_.ql_batch().size() ||
-      pgsql_idx != resp_.pgsql_batch().size()) {
+  if (redis_idx != resp.redis_batch().size() ||
+      ql_idx != resp.ql_batch().size() ||
+      pgsql_idx != resp.pgsql_batch().size()) {
     LOG(ERROR) << Substitute("Read response count mismatch: "
                              "$0 Redis requests sent, $1 responses received. "
                              "$2 QL requests sent, $3 responses received. "
                              "$4 QL requests sent, $5 responses received.",
-                             redis_idx, resp_.redis_batch().size(),
-                             ql_idx, resp_.ql_batch().size(),
-                             pgsql_idx, resp_.pgsql_batch().size());
+                             redis_idx, resp.redis_batch().size(),
+                             ql_idx, resp.ql_batch().size(),
+                             pgsql_idx, resp.pgsql_batch().size());
     batcher_->AddOpCountMismatchError();
     Failed(STATUS(IllegalState, "Read response count mismatch"));
   }
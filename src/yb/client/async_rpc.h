@@ -14,12 +14,15 @@
 #ifndef YB_CLIENT_ASYNC_RPC_H_
 #define YB_CLIENT_ASYNC_RPC_H_
 
+#include "yb/rpc/rpc_controller.h"
 #include "yb/rpc/rpc_fwd.h"
 
 #include "yb/tserver/tserver_service.proxy.h"
 
 #include "yb/client/tablet_rpc.h"
 
+#include "yb/util/locks.h"
+
 namespace yb {
 namespace client {
 
@@ -118,7 +121,7 @@ class AsyncRpcBase : public AsyncRpc {
 
  protected:
   // Returns `true` if caller should continue processing response, `false` otherwise.
-  bool CommonResponseCheck(const Status& status);
+  bool CommonResponseCheck(const Status& status, const Resp& resp);
 
  protected: // TODO replace with private
   const tserver::TabletServerErrorPB* response_error() const override {
@@ -156,8 +159,42 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
   virtual ~ReadRpc();
 
  private:
+  // Duplicate of the read sent to another replica when the response from the first one is late.
+  struct HedgedRead {
+    tserver::ReadRequestPB req;
+    tserver::ReadResponsePB resp;
+    rpc::RpcController controller;
+    RemoteTabletServer* ts = nullptr;
+    MonoTime start;
+  };
+
+  void Finished(const Status& status) override;
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+  HybridTime PropagatedHybridTime() override;
+
+  // Schedules hedged read if this read could be served by any replica and hedging budget is
+  // available.
+  void MaybeScheduleHedgedRead();
+  void SendHedgedRead();
+  void HedgedReadFinished(const Status& status);
+
+  // Time when the current attempt was sent, used to track read latency of tablet servers.
+  MonoTime send_time_;
+
+  // Set before sending the first attempt, so could be read without locking hedge_lock_.
+  bool hedge_scheduled_ = false;
+
+  // Protects the state below, when hedged read is scheduled.
+  simple_spinlock hedge_lock_;
+  std::unique_ptr<HedgedRead> hedge_;
+  bool primary_done_ = false;
+  bool hedge_done_ = false;
+  // Response of either primary or hedged read was taken as the result.
+  bool completed_ = false;
+  bool hedge_won_ = false;
+  // Failure of the primary read, that is processed only if hedged read fails too.
+  Status deferred_primary_status_;
 };
 
 }  // namespace internal
@@ -64,10 +64,17 @@
 
 DEFINE_bool(redis_allow_reads_from_followers, false,
             "If true, the read will be served from the closest replica in the same AZ, which can "
-            "be a follower.");
+            "be a follower. Otherwise only reads with CONSISTENT_PREFIX consistency level, i.e. "
+            "the ones from Redis connections in READONLY mode, are served from followers.");
 TAG_FLAG(redis_allow_reads_from_followers, evolving);
 TAG_FLAG(redis_allow_reads_from_followers, runtime);
 
+DEFINE_bool(client_respect_tablet_write_budget, true,
+            "Split writes to a tablet into RPCs that fit the write budget reported by the tablet "
+            "server, and send them one after another, instead of sending all of them at once.");
+TAG_FLAG(client_respect_tablet_write_budget, advanced);
+TAG_FLAG(client_respect_tablet_write_budget, runtime);
+
 using std::pair;
 using std::set;
 using std::unique_ptr;
@@ -204,7 +211,8 @@ void Batcher::CheckForFinishedFlush() {
 void Batcher::RunCallback(const Status& status) {
   auto runnable = std::make_shared<yb::FunctionRunnable>(
       [ cb{std::move(flush_callback_)}, status ]() { cb(status); });
-  if (!client_->callback_threadpool() || !client_->callback_threadpool()->Submit(runnable).ok()) {
+  if (run_callback_inline_ || !client_->callback_threadpool() ||
+      !client_->callback_threadpool()->Submit(runnable).ok()) {
     runnable->Run();
   }
 }
@@ -252,34 +260,33 @@ Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
   in_flight_op->yb_op = yb_op;
   in_flight_op->state = InFlightOpState::kLookingUpTablet;
 
+  // Partition key of hash partitioned tables is the encoded hash code, so it is decoded once and
+  // used both by the operation and for the tablet lookup.
+  const bool has_hash_code = !in_flight_op->partition_key.empty();
+  const uint16_t hash_code = has_hash_code
+      ? PartitionSchema::DecodeMultiColumnHashValue(in_flight_op->partition_key) : 0;
   switch (yb_op->type()) {
   case YBOperation::Type::QL_READ:
-    if (!in_flight_op->partition_key.empty()) {
-      down_cast<YBqlOp *>(yb_op.get())->SetHashCode(
-        PartitionSchema::DecodeMultiColumnHashValue(in_flight_op->partition_key));
+    if (has_hash_code) {
+      down_cast<YBqlOp *>(yb_op.get())->SetHashCode(hash_code);
     }
     break;
   case YBOperation::Type::QL_WRITE:
-    down_cast<YBqlOp*>(yb_op.get())->SetHashCode(
-      PartitionSchema::DecodeMultiColumnHashValue(in_flight_op->partition_key));
+    down_cast<YBqlOp*>(yb_op.get())->SetHashCode(hash_code);
     break;
   case YBOperation::Type::REDIS_READ:
-    down_cast<YBRedisReadOp*>(yb_op.get())->SetHashCode(
-      PartitionSchema::DecodeMultiColumnHashValue(in_flight_op->partition_key));
+    down_cast<YBRedisReadOp*>(yb_op.get())->SetHashCode(hash_code);
     break;
   case YBOperation::Type::REDIS_WRITE:
-    down_cast<YBRedisWriteOp*>(yb_op.get())->SetHashCode(
-      PartitionSchema::DecodeMultiColumnHashValue(in_flight_op->partition_key));
+    down_cast<YBRedisWriteOp*>(yb_op.get())->SetHashCode(hash_code);
     break;
   case YBOperation::Type::PGSQL_READ:
-    if (!in_flight_op->partition_key.empty()) {
-      down_cast<YBPgsqlOp *>(yb_op.get())->SetHashCode(
-        PartitionSchema::DecodeMultiColumnHashValue(in_flight_op->partition_key));
+    if (has_hash_code) {
+      down_cast<YBPgsqlOp *>(yb_op.get())->SetHashCode(hash_code);
     }
     break;
   case YBOperation::Type::PGSQL_WRITE:
-    down_cast<YBPgsqlOp*>(yb_op.get())->SetHashCode(
-      PartitionSchema::DecodeMultiColumnHashValue(in_flight_op->partition_key));
+    down_cast<YBPgsqlOp*>(yb_op.get())->SetHashCode(hash_code);
     break;
   }
 
@@ -293,9 +300,16 @@ Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
     // deadline_ is set in FlushAsync(), after all Add() calls are done, so
     // here we're forced to create a new deadline.
     MonoTime deadline = ComputeDeadlineUnlocked();
-    client_->data_->meta_cache_->LookupTabletByKey(
-        in_flight_op->yb_op->table(), in_flight_op->partition_key, deadline, &in_flight_op->tablet,
-        Bind(&Batcher::TabletLookupFinished, this, in_flight_op));
+    auto callback = Bind(&Batcher::TabletLookupFinished, this, in_flight_op);
+    if (in_flight_op->partition_key.size() == PartitionSchema::kPartitionKeySize) {
+      client_->data_->meta_cache_->LookupTabletByHashCode(
+          in_flight_op->yb_op->table(), hash_code, in_flight_op->partition_key, deadline,
+          &in_flight_op->tablet, callback);
+    } else {
+      client_->data_->meta_cache_->LookupTabletByKey(
+          in_flight_op->yb_op->table(), in_flight_op->partition_key, deadline,
+          &in_flight_op->tablet, callback);
+    }
   }
   return Status::OK();
 }
@@ -393,7 +407,9 @@ YB_DEFINE_ENUM(OpGroup, (kWrite)(kLeaderRead)(kConsistentPrefixRead));
 namespace {
 inline bool IsOkToReadFromFollower(const InFlightOpPtr& op) {
   return op->yb_op->type() == YBOperation::Type::REDIS_READ &&
-         FLAGS_redis_allow_reads_from_followers;
+         (FLAGS_redis_allow_reads_from_followers ||
+          std::static_pointer_cast<YBRedisReadOp>(op->yb_op)->yb_consistency_level() ==
+          YBConsistencyLevel::CONSISTENT_PREFIX);
 }
 
 inline bool IsQLConsistentPrefixRead(const InFlightOpPtr& op) {
@@ -499,6 +515,29 @@ YBTransactionPtr Batcher::transaction() const {
   return transaction_;
 }
 
+namespace {
+
+// Returns end of the prefix of write operations that fits the write budget of the tablet.
+// At least one operation is always included.
+InFlightOps::const_iterator WriteBudgetEnd(
+    const RemoteTablet& tablet, InFlightOps::const_iterator begin,
+    InFlightOps::const_iterator end) {
+  const int64_t budget = tablet.write_budget_bytes();
+  if (!FLAGS_client_respect_tablet_write_budget || budget < 0) {
+    return end;
+  }
+  int64_t total_size = 0;
+  for (auto it = begin; it != end; ++it) {
+    total_size += (**it).yb_op->space_used_by_request();
+    if (total_size > budget && it != begin) {
+      return it;
+    }
+  }
+  return end;
+}
+
+} // namespace
+
 void Batcher::FlushBuffer(
     RemoteTablet* tablet, InFlightOps::const_iterator begin, InFlightOps::const_iterator end,
     const bool allow_local_calls_in_curr_thread) {
@@ -515,9 +554,24 @@ void Batcher::FlushBuffer(
 
   // Split the read operations according to consistency levels since based on consistency
   // levels the read algorithm would differ.
+  auto op_group = GetOpGroup(*begin);
+  if (op_group == OpGroup::kWrite) {
+    // Writes that do not fit the budget are sent after the response to this RPC, which also
+    // brings the updated budget.
+    auto budget_end = WriteBudgetEnd(*tablet, begin, end);
+    if (budget_end != end) {
+      VLOG(3) << "Deferring " << (end - budget_end) << " writes to " << tablet->tablet_id()
+              << ", write budget: " << tablet->write_budget_bytes();
+      std::lock_guard<simple_spinlock> l(lock_);
+      auto& deferred = deferred_writes_[tablet];
+      DCHECK(deferred.empty());
+      deferred.assign(budget_end, end);
+      end = budget_end;
+    }
+  }
+
   InFlightOps ops(begin, end);
   std::shared_ptr<AsyncRpc> rpc;
-  auto op_group = GetOpGroup(*begin);
   switch (op_group) {
     case OpGroup::kWrite:
       rpc = std::make_shared<WriteRpc>(
@@ -586,9 +640,33 @@ void Batcher::ProcessReadResponse(const ReadRpc &rpc, const Status &s) {
   ProcessRpcStatus(rpc, s);
 }
 
+void Batcher::FlushDeferredWrites(RemoteTablet* tablet) {
+  InFlightOps ops;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    auto it = deferred_writes_.find(tablet);
+    if (it == deferred_writes_.end()) {
+      return;
+    }
+    ops.swap(it->second);
+    deferred_writes_.erase(it);
+    if (IsAbortedUnlocked()) {
+      // Deferred operations were not sent yet, so they were already failed by Abort.
+      return;
+    }
+  }
+  FlushBuffer(tablet, ops.begin(), ops.end(), /* allow_local_calls_in_curr_thread */ false);
+}
+
 void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
   ProcessRpcStatus(rpc, s);
 
+  RemoteTablet* tablet = rpc.ops().front()->tablet.get();
+  if (rpc.resp().has_write_budget_bytes()) {
+    tablet->set_write_budget_bytes(rpc.resp().write_budget_bytes());
+  }
+  FlushDeferredWrites(tablet);
+
   if (s.ok() && rpc.resp().has_propagated_hybrid_time()) {
     client_->data_->UpdateLatestObservedHybridTime(rpc.resp().propagated_hybrid_time());
   }
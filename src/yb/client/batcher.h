@@ -152,6 +152,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   bool allow_local_calls_in_curr_thread() const { return allow_local_calls_in_curr_thread_; }
 
+  // Run the flush callback in the thread that completes the flush, instead of the client callback
+  // thread pool.
+  void set_run_callback_inline(bool flag) { run_callback_inline_ = flag; }
+
  private:
   friend class RefCountedThreadSafe<Batcher>;
   friend class AsyncRpc;
@@ -186,6 +190,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
       RemoteTablet* tablet, InFlightOps::const_iterator begin, InFlightOps::const_iterator end,
       const bool allow_local_calls_in_curr_thread);
 
+  // Sends next part of write operations to the tablet, that were deferred because they did not
+  // fit the write budget of the tablet.
+  void FlushDeferredWrites(RemoteTablet* tablet);
+
   // Calls/Schedules flush_callback_ and resets it to free resources.
   void RunCallback(const Status& s);
 
@@ -240,6 +248,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   std::unordered_set<InFlightOpPtr> ops_;
   InFlightOps ops_queue_;
 
+  // Write operations that are sent to the tablet after the response to the previous write RPC to
+  // the same tablet is received. Protected by lock_.
+  std::unordered_map<RemoteTablet*, InFlightOps> deferred_writes_;
+
   // When each operation is added to the batcher, it is assigned a sequence number
   // which preserves the user's intended order. Preserving order is critical when
   // a batch contains multiple operations against the same row key. This member
@@ -265,6 +277,8 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // If true, we might allow the local calls to be run in the same IPC thread.
   bool allow_local_calls_in_curr_thread_ = true;
 
+  bool run_callback_inline_ = false;
+
   // The number of bytes used in the buffer for pending operations.
   AtomicInt<int64_t> buffer_bytes_used_;
 
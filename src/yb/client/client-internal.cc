@@ -77,6 +77,13 @@ DEFINE_test_flag(bool, assert_local_tablet_server_selected, false, "Verify that
 DEFINE_test_flag(string, assert_tablet_server_select_is_in_zone, "", "Verify that SelectTServer "
                  "selected a talet server in the AZ specified by this flag.");
 
+DEFINE_bool(client_latency_aware_replica_selection, true,
+            "Among equally close replicas, send reads that could be served by any replica to "
+            "the one with the lowest expected service time, estimated from its read latency and "
+            "number of outstanding reads.");
+TAG_FLAG(client_latency_aware_replica_selection, advanced);
+TAG_FLAG(client_latency_aware_replica_selection, runtime);
+
 DECLARE_string(flagfile);
 
 namespace yb {
@@ -353,6 +360,11 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
         if (ret == nullptr && !filtered.empty()) {
           ret = filtered[rand() % filtered.size()];
         }
+
+        if (FLAGS_client_latency_aware_replica_selection && ret != nullptr &&
+            !IsTabletServerLocal(*ret)) {
+          ret = SelectFastestReplica(filtered, ret);
+        }
       }
       break;
     }
@@ -760,6 +772,43 @@ bool YBClient::Data::IsLocalHostPort(const HostPort& hp) const {
   return ContainsKey(local_host_names_, hp.host());
 }
 
+int YBClient::Data::ReplicaProximity(const RemoteTabletServer& rts) const {
+  if (IsTabletServerLocal(rts)) {
+    return 0;
+  }
+  const auto& cloud_info = rts.cloud_info();
+  if (cloud_info_pb_.has_placement_zone() && cloud_info.has_placement_zone() &&
+      cloud_info_pb_.placement_zone() == cloud_info.placement_zone()) {
+    return 1;
+  }
+  if (cloud_info_pb_.has_placement_region() && cloud_info.has_placement_region() &&
+      cloud_info_pb_.placement_region() == cloud_info.placement_region()) {
+    return 2;
+  }
+  return 3;
+}
+
+RemoteTabletServer* YBClient::Data::SelectFastestReplica(
+    const vector<RemoteTabletServer*>& candidates, RemoteTabletServer* closest) const {
+  const int proximity = ReplicaProximity(*closest);
+  RemoteTabletServer* result = closest;
+  double best_time = closest->ExpectedReadServiceTime();
+  // Start from a random candidate, so replicas without latency statistics share the load.
+  const size_t start = rand() % candidates.size();
+  for (size_t i = 0; i != candidates.size(); ++i) {
+    auto* rts = candidates[(start + i) % candidates.size()];
+    if (rts == closest || ReplicaProximity(*rts) != proximity) {
+      continue;
+    }
+    const double time = rts->ExpectedReadServiceTime();
+    if (time < best_time) {
+      result = rts;
+      best_time = time;
+    }
+  }
+  return result;
+}
+
 bool YBClient::Data::IsTabletServerLocal(const RemoteTabletServer& rts) const {
   // If the uuid's are same, we are sure the tablet server is local, since if this client is used
   // via the CQL proxy, the tablet server's uuid is set in the client.
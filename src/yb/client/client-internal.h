@@ -156,6 +156,16 @@ class YBClient::Data {
 
   bool IsTabletServerLocal(const internal::RemoteTabletServer& rts) const;
 
+  // Returns 0 for the local tablet server, 1 for servers in the same zone, 2 for servers in
+  // the same region and 3 for others.
+  int ReplicaProximity(const internal::RemoteTabletServer& rts) const;
+
+  // Returns the replica with the lowest expected read service time among candidates that are
+  // as close as the closest one.
+  internal::RemoteTabletServer* SelectFastestReplica(
+      const std::vector<internal::RemoteTabletServer*>& candidates,
+      internal::RemoteTabletServer* closest) const;
+
   // Returns a non-failed replica of the specified tablet based on the provided selection criteria
   // and tablet server blacklist.
   //
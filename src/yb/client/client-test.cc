@@ -44,6 +44,7 @@
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
 #include "yb/client/client-test-util.h"
+#include "yb/client/completion_queue.h"
 #include "yb/client/meta_cache.h"
 #include "yb/client/table_handle.h"
 #include "yb/client/value.h"
@@ -1012,6 +1013,67 @@ TEST_F(ClientTest, TestBatchWithDuplicates) {
   ASSERT_EQ("{ int32:2, int32:1, string:\"Should succeed\", null }", rows[1]);
 }
 
+// Test that operations applied in AUTO_FLUSH_BACKGROUND mode are sent without explicit flushes,
+// and that Flush waits for all of them.
+TEST_F(ClientTest, TestBackgroundFlush) {
+  auto session = CreateSession();
+  ASSERT_OK(session->SetFlushMode(YBSession::AUTO_FLUSH_BACKGROUND));
+
+  const int kNumRows = 1000;
+  std::vector<std::shared_ptr<YBqlOp>> ops;
+  for (int i = 0; i != kNumRows; ++i) {
+    ops.emplace_back();
+    ASSERT_OK(ApplyInsertToSession(
+        session.get(), (i % 2 == 0) ? client_table_ : client_table2_, i, i * 10, "hello world",
+        &ops.back()));
+  }
+  FlushSessionOrDie(session);
+  ASSERT_FALSE(session->HasPendingOperations());
+  for (const auto& op : ops) {
+    ASSERT_TRUE(op->succeeded()) << op->ToString();
+  }
+
+  ASSERT_EQ(kNumRows / 2, CountRowsFromClient(client_table_));
+  ASSERT_EQ(kNumRows / 2, CountRowsFromClient(client_table2_));
+
+  // Flush without buffered or in flight operations completes immediately.
+  FlushSessionOrDie(session);
+}
+
+TEST_F(ClientTest, TestFlushCompletionQueue) {
+  CompletionQueue queue;
+  const int kNumSessions = 4;
+  const int kRowsPerSession = 100;
+  std::vector<YBSessionPtr> sessions;
+  for (int i = 0; i != kNumSessions; ++i) {
+    sessions.push_back(CreateSession());
+    sessions.back()->set_run_callbacks_inline(true);
+    for (int j = 0; j != kRowsPerSession; ++j) {
+      const int key = i * kRowsPerSession + j;
+      ASSERT_OK(ApplyInsertToSession(sessions.back().get(), client_table_, key, key, "hello"));
+    }
+    sessions.back()->FlushAsync(&queue, sessions.back().get());
+  }
+
+  std::set<void*> completed;
+  CompletionQueue::Completion completion;
+  for (int i = 0; i != kNumSessions; ++i) {
+    ASSERT_TRUE(queue.Next(&completion, MonoTime::Now() + 30s));
+    ASSERT_OK(completion.status);
+    ASSERT_TRUE(completed.insert(completion.tag).second);
+  }
+  ASSERT_FALSE(queue.TryNext(&completion));
+  for (const auto& session : sessions) {
+    ASSERT_EQ(1, completed.count(session.get()));
+  }
+  ASSERT_EQ(kNumSessions * kRowsPerSession, CountRowsFromClient(client_table_));
+
+  // Waiting for completion times out when nothing is in flight, and stops after shutdown.
+  ASSERT_FALSE(queue.Next(&completion, MonoTime::Now() + 10ms));
+  queue.Shutdown();
+  ASSERT_FALSE(queue.Next(&completion));
+}
+
 // Test flushing an empty batch (should be a no-op).
 TEST_F(ClientTest, TestEmptyBatch) {
   auto session = CreateSession();
@@ -39,6 +39,7 @@
 
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
+#include "yb/client/meta_cache.h"
 
 namespace yb {
 namespace client {
@@ -171,6 +172,50 @@ TEST(ClientUnitTest, TestRetryFunc) {
   ASSERT_LT(counter, 20);
 }
 
+TEST(ClientUnitTest, TestReadLatencyP95) {
+  internal::RemoteTabletServer ts("ts", nullptr);
+  ASSERT_EQ(0, ts.ReadLatencyP95().ToMicroseconds());
+
+  // Every 20th read takes 10ms, others take 1ms. So p95 is between them.
+  for (int i = 0; i != 10000; ++i) {
+    ts.UpdateReadLatency(MonoDelta::FromMicroseconds(i % 20 == 0 ? 10000 : 1000));
+  }
+  auto p95 = ts.ReadLatencyP95().ToMicroseconds();
+  ASSERT_GE(p95, 1000);
+  ASSERT_LE(p95, 10000);
+
+  // When all reads become slow, the estimation follows them.
+  for (int i = 0; i != 1000; ++i) {
+    ts.UpdateReadLatency(MonoDelta::FromMicroseconds(20000));
+  }
+  ASSERT_GE(ts.ReadLatencyP95().ToMicroseconds(), 15000);
+}
+
+TEST(ClientUnitTest, TestExpectedReadServiceTime) {
+  internal::RemoteTabletServer fast("fast", nullptr);
+  internal::RemoteTabletServer slow("slow", nullptr);
+  // Servers without statistics are probed first.
+  ASSERT_EQ(0, fast.ExpectedReadServiceTime());
+
+  for (int i = 0; i != 100; ++i) {
+    fast.ReadStarted();
+    fast.ReadFinished(Status::OK(), MonoDelta::FromMicroseconds(1000));
+    slow.ReadStarted();
+    slow.ReadFinished(Status::OK(), MonoDelta::FromMicroseconds(3000));
+  }
+  ASSERT_LT(fast.ExpectedReadServiceTime(), slow.ExpectedReadServiceTime());
+
+  // Outstanding reads make the fast server less attractive.
+  fast.ReadStarted();
+  fast.ReadStarted();
+  ASSERT_GT(fast.ExpectedReadServiceTime(), slow.ExpectedReadServiceTime());
+
+  // Failed reads do not affect latency.
+  fast.ReadFinished(STATUS(TimedOut, "Timed out"), MonoDelta::FromSeconds(10));
+  fast.ReadFinished(STATUS(TimedOut, "Timed out"), MonoDelta::FromSeconds(10));
+  ASSERT_LT(fast.ExpectedReadServiceTime(), slow.ExpectedReadServiceTime());
+}
+
 } // namespace client
 } // namespace yb
 
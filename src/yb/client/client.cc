@@ -43,6 +43,7 @@
 #include "yb/client/callbacks.h"
 #include "yb/client/client-internal.h"
 #include "yb/client/client_builder-internal.h"
+#include "yb/client/completion_queue.h"
 #include "yb/client/error-internal.h"
 #include "yb/client/error_collector.h"
 #include "yb/client/meta_cache.h"
@@ -757,6 +758,10 @@ rpc::ProxyCache& YBClient::proxy_cache() const {
   return *data_->proxy_cache_;
 }
 
+const CloudInfoPB& YBClient::cloud_info() const {
+  return data_->cloud_info_pb_;
+}
+
 ThreadPool *YBClient::callback_threadpool() {
   return data_->cb_threadpool_.get();
 }
@@ -1337,6 +1342,10 @@ const std::string& YBTable::FindPartitionStart(
   return data_->partitions_[idx];
 }
 
+const std::vector<std::string>& YBTable::GetPartitions() const {
+  return data_->partitions_;
+}
+
 //--------------------------------------------------------------------------------------------------
 
 YBPgsqlWriteOp* YBTable::NewPgsqlWrite() {
@@ -1433,6 +1442,10 @@ std::future<Status> YBSession::FlushFuture() {
   return MakeFuture<Status>([this](auto callback) { this->FlushAsync(std::move(callback)); });
 }
 
+void YBSession::FlushAsync(CompletionQueue* queue, void* tag) {
+  FlushAsync(queue->Callback(tag));
+}
+
 bool YBSession::HasPendingOperations() const {
   return data_->HasPendingOperations();
 }
@@ -1478,6 +1491,10 @@ void YBSession::set_allow_local_calls_in_curr_thread(bool flag) {
   data_->set_allow_local_calls_in_curr_thread(flag);
 }
 
+void YBSession::set_run_callbacks_inline(bool flag) {
+  data_->set_run_callbacks_inline(flag);
+}
+
 bool YBSession::allow_local_calls_in_curr_thread() const {
   return data_->allow_local_calls_in_curr_thread();
 }
@@ -492,6 +492,9 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
 
   rpc::ProxyCache& proxy_cache() const;
 
+  // Placement of this client, as specified in the builder.
+  const CloudInfoPB& cloud_info() const;
+
  private:
   class Data;
 
@@ -742,6 +745,9 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
   const std::string& FindPartitionStart(
       const std::string& partition_key, size_t group_by = 1) const;
 
+  // Returns sorted start keys of all partitions of this table.
+  const std::vector<std::string>& GetPartitions() const;
+
   //------------------------------------------------------------------------------------------------
   // Postgres support
   // Create a new QL operation for this table.
@@ -935,22 +941,19 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
     // has already flushed the buffer. This is the default flush mode.
     AUTO_FLUSH_SYNC,
 
-    // Apply() calls will return immediately, but the writes will be sent in
-    // the background, potentially batched together with other writes from
-    // the same session. If there is not sufficient buffer space, then Apply()
-    // may block for buffer space to be available.
+    // Apply() calls will return immediately, but the operations will be sent in
+    // the background, potentially batched together with other operations from
+    // the same session. When no batch of the session is in flight, operations are
+    // sent immediately. Otherwise they are buffered until previous batches complete,
+    // buffered operations reach client_background_flush_max_bytes, or
+    // client_background_flush_max_delay_us passes.
     //
     // Because writes are applied in the background, any errors will be stored
     // in a session-local buffer. Call CountPendingErrors() or GetPendingErrors()
-    // to retrieve them.
-    // TODO: provide an API for the user to specify a callback to do their own
-    // error reporting.
-    // TODO: specify which threads the background activity runs on (probably the
-    // messenger IO threads?)
-    //
-    // NOTE: This is not implemented yet, see KUDU-456.
+    // to retrieve them. Status of each operation is available through it once
+    // the operation is completed.
     //
-    // The Flush() call can be used to block until the buffer is empty.
+    // The Flush() call can be used to block until all applied operations are completed.
     AUTO_FLUSH_BACKGROUND,
 
     // Apply() calls will return immediately, and the writes will not be
@@ -1052,6 +1055,10 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   void FlushAsync(boost::function<void(const Status&)> callback);
   std::future<Status> FlushFuture();
 
+  // Flushes asynchronously and adds a completion with the specified tag to the queue, when
+  // the flush is completed. The queue should outlive the flush.
+  void FlushAsync(CompletionQueue* queue, void* tag);
+
   // Abort the unflushed or in-flight operations in the session.
   void Abort();
 
@@ -1092,6 +1099,11 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   void set_allow_local_calls_in_curr_thread(bool flag);
   bool allow_local_calls_in_curr_thread() const;
 
+  // Run flush callbacks directly on the reactor thread that completed the flush, instead of
+  // the client callback thread pool. Such callbacks should be fast and must not block, this is
+  // intended for callbacks that just hand off the result, e.g. CompletionQueue or futures.
+  void set_run_callbacks_inline(bool flag);
+
   YBClient* client() const;
 
  private:
@@ -51,6 +51,7 @@ class YBRedisOp;
 class YBRedisReadOp;
 class YBRedisWriteOp;
 
+class CompletionQueue;
 class YBSession;
 typedef std::shared_ptr<YBSession> YBSessionPtr;
 
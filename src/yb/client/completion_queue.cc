@@ -0,0 +1,77 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/client/completion_queue.h"
+
+#include <glog/logging.h>
+
+namespace yb {
+namespace client {
+
+CompletionQueue::~CompletionQueue() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LOG_IF(DFATAL, !queue_.empty()) << "Destroying completion queue with "
+                                  << queue_.size() << " unhandled completions";
+}
+
+void CompletionQueue::Push(void* tag, const Status& status) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(Completion{tag, status});
+  }
+  cond_.notify_one();
+}
+
+boost::function<void(const Status&)> CompletionQueue::Callback(void* tag) {
+  return [this, tag](const Status& status) {
+    Push(tag, status);
+  };
+}
+
+bool CompletionQueue::Next(Completion* completion, MonoTime deadline) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto predicate = [this] { return !queue_.empty() || shutdown_; };
+  if (deadline == MonoTime::kMax) {
+    cond_.wait(lock, predicate);
+  } else if (!cond_.wait_until(lock, deadline.ToSteadyTimePoint(), predicate)) {
+    return false;
+  }
+  return PopUnlocked(completion);
+}
+
+bool CompletionQueue::TryNext(Completion* completion) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return PopUnlocked(completion);
+}
+
+void CompletionQueue::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cond_.notify_all();
+}
+
+bool CompletionQueue::PopUnlocked(Completion* completion) {
+  if (queue_.empty()) {
+    return false;
+  }
+  *completion = std::move(queue_.front());
+  queue_.pop_front();
+  return true;
+}
+
+} // namespace client
+} // namespace yb
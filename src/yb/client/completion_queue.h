@@ -0,0 +1,79 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_CLIENT_COMPLETION_QUEUE_H
+#define YB_CLIENT_COMPLETION_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <boost/function.hpp>
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace client {
+
+// Queue of completed asynchronous operations, for callers that poll for completions from their own
+// threads instead of doing work in callbacks. Each completion is identified by the tag that was
+// provided when the operation was started.
+//
+// Combined with YBSession::set_run_callbacks_inline(true), completions are pushed directly from
+// reactor threads, so there is no extra thread hop between the RPC response and the poller.
+class CompletionQueue {
+ public:
+  struct Completion {
+    void* tag = nullptr;
+    Status status;
+  };
+
+  CompletionQueue() = default;
+  ~CompletionQueue();
+
+  CompletionQueue(const CompletionQueue&) = delete;
+  void operator=(const CompletionQueue&) = delete;
+
+  // Adds a completion. Could be invoked from any thread.
+  void Push(void* tag, const Status& status);
+
+  // Returns callback that adds a completion with the specified tag. The queue should outlive
+  // the callback.
+  boost::function<void(const Status&)> Callback(void* tag);
+
+  // Waits until a completion is available and takes it. Returns false if the deadline has passed
+  // or the queue was shut down and has no more completions.
+  bool Next(Completion* completion, MonoTime deadline = MonoTime::kMax);
+
+  // Takes a completion if one is available, without blocking.
+  bool TryNext(Completion* completion);
+
+  // Wakes up all waiters, Next does not block after this call.
+  void Shutdown();
+
+ private:
+  bool PopUnlocked(Completion* completion);
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Completion> queue_;
+  bool shutdown_ = false;
+};
+
+} // namespace client
+} // namespace yb
+
+#endif // YB_CLIENT_COMPLETION_QUEUE_H
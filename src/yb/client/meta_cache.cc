@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <mutex>
 
 #include <boost/bind.hpp>
@@ -168,6 +169,48 @@ const CloudInfoPB& RemoteTabletServer::cloud_info() const {
   return cloud_info_pb_;
 }
 
+void RemoteTabletServer::ReadStarted() {
+  outstanding_reads_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RemoteTabletServer::ReadFinished(const Status& status, MonoDelta latency) {
+  outstanding_reads_.fetch_sub(1, std::memory_order_relaxed);
+  if (status.ok()) {
+    UpdateReadLatency(latency);
+  }
+}
+
+double RemoteTabletServer::ExpectedReadServiceTime() const {
+  const auto latency = read_latency_ewma_us_.load(std::memory_order_relaxed);
+  const auto queue = 1 + std::max<int64_t>(outstanding_reads_.load(std::memory_order_relaxed), 0);
+  // Cubic penalty for the queue size, so replicas with long queues are avoided even if they were
+  // fast before.
+  return static_cast<double>(latency) * queue * queue * queue;
+}
+
+void RemoteTabletServer::UpdateReadLatency(MonoDelta latency) {
+  const int64_t sample = latency.ToMicroseconds();
+  const int64_t ewma = read_latency_ewma_us_.load(std::memory_order_relaxed);
+  read_latency_ewma_us_.store(
+      ewma == 0 ? std::max<int64_t>(sample, 1) : std::max<int64_t>(ewma + (sample - ewma) / 8, 1),
+      std::memory_order_relaxed);
+
+  const int64_t estimation = read_latency_p95_us_.load(std::memory_order_relaxed);
+  if (estimation == 0) {
+    read_latency_p95_us_.store(std::max<int64_t>(sample, 1), std::memory_order_relaxed);
+    return;
+  }
+  // Moving up 19 times faster than down keeps 5% of samples above the estimation.
+  const int64_t step = std::max<int64_t>(estimation / 64, 1);
+  const int64_t new_estimation = sample > estimation ? estimation + 19 * step
+                                                     : std::max<int64_t>(estimation - step, 1);
+  read_latency_p95_us_.store(new_estimation, std::memory_order_relaxed);
+}
+
+MonoDelta RemoteTabletServer::ReadLatencyP95() const {
+  return MonoDelta::FromMicroseconds(read_latency_p95_us_.load(std::memory_order_relaxed));
+}
+
 shared_ptr<TabletServerServiceProxy> RemoteTabletServer::proxy() const {
   std::lock_guard<simple_spinlock> l(lock_);
   return proxy_;
@@ -621,6 +664,7 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
   {
     std::lock_guard<decltype(mutex_)> l(mutex_);
+    std::vector<const TableId*> updated_tables;
     for (const TabletLocationsPB& loc : locations) {
       auto& table_data = tables_[loc.table_id()];
       auto& tablets_by_key = table_data.tablets_by_partition;
@@ -647,6 +691,9 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
         CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
         CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+        if (updated_tables.empty() || *updated_tables.back() != loc.table_id()) {
+          updated_tables.push_back(&loc.table_id());
+        }
       }
       remote->Refresh(ts_cache_, loc.replicas());
 
@@ -675,6 +722,21 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
         }
       }
     }
+
+    if (!updated_tables.empty()) {
+      TabletsByTable tablets_by_table;
+      {
+        auto current = tablets_by_table_.get();
+        tablets_by_table = *current;
+      }
+      for (const auto* table_id : updated_tables) {
+        const auto& tablets_by_partition = tables_[*table_id].tablets_by_partition;
+        tablets_by_table[*table_id] =
+            std::make_shared<const TabletsByPartition>(tablets_by_partition);
+      }
+      // Waits for lookups that use the old snapshot, they never lock mutex_.
+      tablets_by_table_.Set(std::move(tablets_by_table));
+    }
   }
 
   for (const auto& callback : to_notify) {
@@ -904,6 +966,116 @@ RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* tabl
   return nullptr;
 }
 
+RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathLockFree(const YBTable* table,
+                                                             const std::string& partition_key) {
+  DCHECK_EQ(partition_key, table->FindPartitionStart(partition_key));
+  RemoteTabletPtr result;
+  {
+    auto tablets_by_table = tablets_by_table_.get();
+    auto it = tablets_by_table->find(table->id());
+    if (PREDICT_FALSE(it == tablets_by_table->end())) {
+      return nullptr;
+    }
+    result = it->second->FindByPartitionStart(partition_key);
+    if (PREDICT_FALSE(!result)) {
+      return nullptr;
+    }
+  }
+
+  // Stale entries must be re-fetched.
+  if (result->stale()) {
+    return nullptr;
+  }
+
+  if (result->partition().partition_key_end().compare(partition_key) > 0 ||
+      result->partition().partition_key_end().empty()) {
+    // partition_key < partition.end OR tablet doesn't end.
+    return result;
+  }
+
+  return nullptr;
+}
+
+RemoteTabletPtr MetaCache::LookupTabletByHashCodeFastPathLockFree(const YBTable* table,
+                                                                  uint16_t hash_code) {
+  RemoteTabletPtr result;
+  {
+    auto tablets_by_table = tablets_by_table_.get();
+    auto it = tablets_by_table->find(table->id());
+    if (PREDICT_FALSE(it == tablets_by_table->end())) {
+      return nullptr;
+    }
+    result = it->second->FindByHashCode(hash_code);
+  }
+
+  // Stale entries must be re-fetched.
+  if (!result || result->stale()) {
+    return nullptr;
+  }
+  return result;
+}
+
+MetaCache::TabletsByPartition::TabletsByPartition(
+    const std::map<PartitionKey, RemoteTabletPtr>& tablets)
+    : tablets_(tablets.begin(), tablets.end()) {
+  hash_starts_.reserve(tablets_.size());
+  hash_ends_.reserve(tablets_.size());
+  for (const auto& entry : tablets_) {
+    const auto& start = entry.second->partition().partition_key_start();
+    const auto& end = entry.second->partition().partition_key_end();
+    if ((!start.empty() && start.size() != PartitionSchema::kPartitionKeySize) ||
+        (!end.empty() && end.size() != PartitionSchema::kPartitionKeySize)) {
+      hash_starts_.clear();
+      hash_ends_.clear();
+      return;
+    }
+    hash_starts_.push_back(start.empty() ? 0 : PartitionSchema::DecodeMultiColumnHashValue(start));
+    hash_ends_.push_back(
+        end.empty() ? 1U << 16 : PartitionSchema::DecodeMultiColumnHashValue(end));
+  }
+
+  if (hash_starts_.empty()) {
+    return;
+  }
+  hash_index_.resize(1U << kHashIndexBits);
+  uint32_t idx = 0;
+  for (uint32_t bucket = 0; bucket != hash_index_.size(); ++bucket) {
+    const uint32_t bucket_start = bucket << kHashIndexShift;
+    while (idx + 1 < hash_starts_.size() && hash_starts_[idx + 1] <= bucket_start) {
+      ++idx;
+    }
+    hash_index_[bucket] = idx;
+  }
+}
+
+RemoteTabletPtr MetaCache::TabletsByPartition::FindByPartitionStart(
+    const PartitionKey& partition_key) const {
+  auto it = std::lower_bound(
+      tablets_.begin(), tablets_.end(), partition_key,
+      [](const Tablets::value_type& entry, const PartitionKey& key) {
+        return entry.first < key;
+      });
+  if (it == tablets_.end() || it->first != partition_key) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+RemoteTabletPtr MetaCache::TabletsByPartition::FindByHashCode(uint16_t hash_code) const {
+  if (hash_index_.empty()) {
+    return nullptr;
+  }
+  auto idx = hash_index_[hash_code >> kHashIndexShift];
+  while (idx + 1 < hash_starts_.size() && hash_starts_[idx + 1] <= hash_code) {
+    ++idx;
+  }
+  // Tablet that contains hash_code could be not cached yet.
+  if (hash_starts_[idx] > hash_code || hash_ends_[idx] <= hash_code) {
+    return nullptr;
+  }
+  return tablets_[idx].second;
+}
+
 template <class Lock>
 bool MetaCache::FastLookupTabletByKeyUnlocked(
     const YBTable* table,
@@ -926,6 +1098,25 @@ bool MetaCache::FastLookupTabletByKeyUnlocked(
   return false;
 }
 
+void MetaCache::LookupTabletByHashCode(const YBTable* table,
+                                       uint16_t hash_code,
+                                       const std::string& partition_key,
+                                       const MonoTime& deadline,
+                                       RemoteTabletPtr* remote_tablet,
+                                       const StatusCallback& callback) {
+  DCHECK_EQ(hash_code, PartitionSchema::DecodeMultiColumnHashValue(partition_key));
+  auto result = LookupTabletByHashCodeFastPathLockFree(table, hash_code);
+  if (result && result->HasLeader()) {
+    VLOG(3) << "Fast lookup by hash code: found tablet " << result->tablet_id();
+    if (remote_tablet) {
+      *remote_tablet = result;
+    }
+    callback.Run(Status::OK());
+    return;
+  }
+  LookupTabletByKey(table, partition_key, deadline, remote_tablet, callback);
+}
+
 void MetaCache::LookupTabletByKey(const YBTable* table,
                                   const string& partition_key,
                                   const MonoTime& deadline,
@@ -933,10 +1124,14 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
                                   const StatusCallback& callback) {
   const auto& partition_start = table->FindPartitionStart(partition_key);
 
-  rpc::Rpcs::Handle rpc;
   {
-    boost::shared_lock<boost::shared_mutex> lock(mutex_);
-    if (FastLookupTabletByKeyUnlocked(table, partition_start, remote_tablet, callback, &lock)) {
+    auto result = LookupTabletByKeyFastPathLockFree(table, partition_start);
+    if (result && result->HasLeader()) {
+      VLOG(3) << "Fast lookup: found tablet " << result->tablet_id();
+      if (remote_tablet) {
+        *remote_tablet = result;
+      }
+      callback.Run(Status::OK());
       return;
     }
   }
@@ -33,6 +33,7 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <memory>
@@ -56,6 +57,7 @@
 #include "yb/tablet/metadata.pb.h"
 
 #include "yb/util/async_util.h"
+#include "yb/util/concurrent_value.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/semaphore.h"
@@ -127,10 +129,36 @@ class RemoteTabletServer {
 
   const CloudInfoPB& cloud_info() const;
 
+  // Should be invoked when a read is sent to this server, and when it completes. latency is
+  // ignored if read failed.
+  void ReadStarted();
+  void ReadFinished(const Status& status, MonoDelta latency);
+
+  // Updates estimations of read latency of this server with the latency of a completed read.
+  void UpdateReadLatency(MonoDelta latency);
+
+  // Returns estimated p95 latency of reads served by this server, or zero if it is not known yet.
+  MonoDelta ReadLatencyP95() const;
+
+  // Expected time in microseconds to serve a new read by this server, based on its average read
+  // latency and number of outstanding reads, like in the C3 replica selection algorithm.
+  // Returns zero if read latency is not known yet, so such servers are probed first.
+  double ExpectedReadServiceTime() const;
+
  private:
   mutable simple_spinlock lock_;
   const std::string uuid_;
 
+  // Streaming estimation of p95 read latency in microseconds. Relaxed accesses are enough, since
+  // it is only used for decisions about hedged reads.
+  std::atomic<int64_t> read_latency_p95_us_{0};
+
+  // Exponentially weighted moving average of read latency in microseconds.
+  std::atomic<int64_t> read_latency_ewma_us_{0};
+
+  // Reads sent to this server by this client and not completed yet.
+  std::atomic<int64_t> outstanding_reads_{0};
+
   std::vector<HostPort> rpc_hostports_;
   yb::CloudInfoPB cloud_info_pb_;
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy_;
@@ -224,6 +252,16 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // Return stringified representation of the list of replicas for this tablet.
   std::string ReplicasAsString() const;
 
+  // Memory for write operations that the tablet leader could accept, as reported in the last write
+  // response. Negative if unknown or unlimited.
+  int64_t write_budget_bytes() const {
+    return write_budget_bytes_.load(std::memory_order_relaxed);
+  }
+
+  void set_write_budget_bytes(int64_t value) {
+    write_budget_bytes_.store(value, std::memory_order_relaxed);
+  }
+
  private:
   // Same as ReplicasAsString(), except that the caller must hold lock_.
   std::string ReplicasAsStringUnlocked() const;
@@ -239,6 +277,8 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // The state of this tablet at each specific replica. Only updated after calling GetTabletStatus.
   std::unordered_map<std::string, tablet::TabletStatePB> replica_tablet_state_map_;
 
+  std::atomic<int64_t> write_budget_bytes_{-1};
+
   DISALLOW_COPY_AND_ASSIGN(RemoteTablet);
 };
 
@@ -274,6 +314,15 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
                          RemoteTabletPtr* remote_tablet,
                          const StatusCallback& callback);
 
+  // Same as LookupTabletByKey, for a partition_key that is the encoded hash_code of a hash
+  // partitioned table. Resolves cached tablets by hash code without comparing keys.
+  void LookupTabletByHashCode(const YBTable* table,
+                              uint16_t hash_code,
+                              const std::string& partition_key,
+                              const MonoTime& deadline,
+                              RemoteTabletPtr* remote_tablet,
+                              const StatusCallback& callback);
+
   void LookupTabletById(const TabletId& tablet_id,
                         const MonoTime& deadline,
                         RemoteTabletPtr* remote_tablet,
@@ -314,6 +363,15 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   RemoteTabletPtr LookupTabletByKeyFastPathUnlocked(const YBTable* table,
                                                     const std::string& partition_key);
 
+  // Same as LookupTabletByKeyFastPathUnlocked, but uses tablets_by_table_ snapshot, so does not
+  // require mutex_.
+  RemoteTabletPtr LookupTabletByKeyFastPathLockFree(const YBTable* table,
+                                                    const std::string& partition_key);
+
+  // Lookup tablet that contains hash code without locking mutex_. Returns nullptr if such tablet
+  // is not cached or partition bounds of the table are not hash codes.
+  RemoteTabletPtr LookupTabletByHashCodeFastPathLockFree(const YBTable* table, uint16_t hash_code);
+
   RemoteTabletPtr LookupTabletByIdFastPath(const TabletId& tablet_id);
 
   // Update our information about the given tablet server.
@@ -372,12 +430,50 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   typedef std::string PartitionGroupKey;
 
   struct TableData {
-    std::unordered_map<PartitionKey, RemoteTabletPtr> tablets_by_partition;
+    std::map<PartitionKey, RemoteTabletPtr> tablets_by_partition;
     std::unordered_map<PartitionGroupKey, PartitionToLookupData> tablet_lookups_by_group;
   };
 
   std::unordered_map<TableId, TableData> tables_;
 
+  // Immutable copy of tablets_by_partition of a table, so lookups are a binary search over
+  // contiguous memory.
+  class TabletsByPartition {
+   public:
+    typedef std::vector<std::pair<PartitionKey, RemoteTabletPtr>> Tablets;
+
+    explicit TabletsByPartition(const std::map<PartitionKey, RemoteTabletPtr>& tablets);
+
+    // Returns tablet that starts at partition_key if it is cached.
+    RemoteTabletPtr FindByPartitionStart(const PartitionKey& partition_key) const;
+
+    // Returns tablet that contains hash_code if it is cached and all partition bounds are hash
+    // codes.
+    RemoteTabletPtr FindByHashCode(uint16_t hash_code) const;
+
+   private:
+    static constexpr int kHashIndexBits = 12;
+    static constexpr int kHashIndexShift = 16 - kHashIndexBits;
+
+    // Sorted by partition start.
+    Tablets tablets_;
+
+    // Filled when all partition bounds are empty or 2 byte hash codes, like in hash partitioned
+    // tables. Tablet bounds as integers, the end is exclusive.
+    std::vector<uint32_t> hash_starts_;
+    std::vector<uint32_t> hash_ends_;
+
+    // Index of the last tablet that starts at or before the first hash code of each range of
+    // 2^kHashIndexShift hash codes, so only a few bounds are checked after it.
+    std::vector<uint32_t> hash_index_;
+  };
+
+  typedef std::unordered_map<TableId, std::shared_ptr<const TabletsByPartition>> TabletsByTable;
+
+  // Snapshot of tablets of all tables, used by lookups without locking mutex_. Replaced with
+  // mutex_ locked when new tablets are cached.
+  ConcurrentValue<TabletsByTable> tablets_by_table_;
+
   // Cache of tablets, keyed by tablet ID.
   //
   // Protected by lock_
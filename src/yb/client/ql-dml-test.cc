@@ -395,6 +395,87 @@ TEST_F(QLDmlTest, TestInsertMultipleRows) {
   }
 }
 
+TEST_F(QLDmlTest, TestInsertRowBlock) {
+  constexpr int kNumRows = 1000;
+
+  YBqlRowBlockWriter writer(
+      table_.table(), {table_.ColumnId("c1"), table_.ColumnId("c2")});
+  ASSERT_OK(writer.Init());
+  std::vector<QLValue> values(kAllColumns.size());
+  for (int i = 0; i != kNumRows; ++i) {
+    values[0].set_int32_value(i);
+    values[1].set_string_value(Format("h$0", i));
+    values[2].set_int32_value(i * 2);
+    values[3].set_string_value(Format("r$0", i));
+    values[4].set_int32_value(i * 3);
+    values[5].set_string_value(Format("c$0", i));
+    ASSERT_OK(writer.AddRow(values));
+  }
+  // Key values are required.
+  values[2].SetNull();
+  ASSERT_NOK(writer.AddRow(values));
+
+  const shared_ptr<YBSession> session(NewSession());
+  ASSERT_OK(session->SetFlushMode(YBSession::MANUAL_FLUSH));
+  auto ops = writer.TakeOps();
+  // Rows are grouped by tablet.
+  ASSERT_LE(ops.size(), static_cast<size_t>(CalcNumTablets(3)));
+  for (const auto& op : ops) {
+    ASSERT_OK(session->Apply(op));
+  }
+  ASSERT_OK(session->Flush());
+  for (const auto& op : ops) {
+    ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+  }
+  ASSERT_TRUE(writer.TakeOps().empty());
+
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_TRUE(VerifyRow(
+        session, i, Format("h$0", i), i * 2, Format("r$0", i), i * 3, Format("c$0", i)));
+  }
+}
+
+TEST_F(QLDmlTest, TestParallelScan) {
+  constexpr int kNumRows = 1000;
+
+  YBqlRowBlockWriter writer(
+      table_.table(), {table_.ColumnId("c1"), table_.ColumnId("c2")});
+  ASSERT_OK(writer.Init());
+  std::vector<QLValue> values(kAllColumns.size());
+  for (int i = 0; i != kNumRows; ++i) {
+    values[0].set_int32_value(i);
+    values[1].set_string_value("h");
+    values[2].set_int32_value(i);
+    values[3].set_string_value("r");
+    values[4].set_int32_value(i);
+    values[5].set_string_value("c");
+    ASSERT_OK(writer.AddRow(values));
+  }
+  const shared_ptr<YBSession> session(NewSession());
+  ASSERT_OK(session->SetFlushMode(YBSession::MANUAL_FLUSH));
+  for (const auto& op : writer.TakeOps()) {
+    ASSERT_OK(session->Apply(op));
+  }
+  ASSERT_OK(session->Flush());
+
+  std::mutex mutex;
+  std::map<int32_t, std::string> key_to_tablet;
+  ParallelScanOptions options;
+  options.iterator_options.columns = std::vector<std::string>{"h1", "c1"};
+  options.concurrency = 2;
+  ASSERT_OK(ParallelScan(table_, options, [&](const std::string& tablet_id, const QLRow& row) {
+    ASSERT_EQ(row.column(0).int32_value(), row.column(1).int32_value());
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_TRUE(key_to_tablet.emplace(row.column(0).int32_value(), tablet_id).second);
+  }));
+  ASSERT_EQ(kNumRows, key_to_tablet.size());
+  std::set<std::string> tablets;
+  for (const auto& key_and_tablet : key_to_tablet) {
+    tablets.insert(key_and_tablet.second);
+  }
+  ASSERT_EQ(CalcNumTablets(3), tablets.size());
+}
+
 TEST_F(QLDmlTest, TestSelectMultipleRows) {
   const auto session = NewSession();
   CHECK_OK(session->SetFlushMode(YBSession::MANUAL_FLUSH));
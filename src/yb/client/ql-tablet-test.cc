@@ -24,6 +24,8 @@
 #include "yb/consensus/consensus.pb.h"
 
 #include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/value.h"
 
 #include "yb/integration-tests/test_workload.h"
 
@@ -48,6 +50,10 @@ DECLARE_uint64(initial_seqno);
 DECLARE_int32(leader_lease_duration_ms);
 DECLARE_int64(db_write_buffer_size);
 DECLARE_string(time_source);
+DECLARE_bool(propagate_safe_time);
+DECLARE_bool(enable_external_write_batches);
+DECLARE_bool(parallelize_read_ops);
+DECLARE_int64(tablet_operation_memory_limit_mb);
 
 namespace yb {
 namespace client {
@@ -604,6 +610,260 @@ TEST_F(QLTabletTest, BoundaryValues) {
   }
 }
 
+// Checks that a follower serves reads with max_staleness_ms while it keeps up with the leader, and
+// rejects them after it stops receiving safe time from the leader.
+TEST_F(QLTabletTest, FollowerReadMaxStaleness) {
+  google::FlagSaver saver;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  ASSERT_NO_FATALS(FillTable(0, 10, &table));
+
+  master::GetTableLocationsRequestPB locations_req;
+  master::GetTableLocationsResponsePB locations_resp;
+  table.name().SetIntoTableIdentifierPB(locations_req.mutable_table());
+  ASSERT_OK(cluster_->mini_master()->master()->catalog_manager()->GetTableLocations(
+      &locations_req, &locations_resp));
+  ASSERT_EQ(1, locations_resp.tablet_locations_size());
+  const auto& tablet = locations_resp.tablet_locations(0);
+  std::string follower_uuid;
+  for (const auto& replica : tablet.replicas()) {
+    if (replica.role() == consensus::RaftPeerPB::FOLLOWER) {
+      follower_uuid = replica.ts_info().permanent_uuid();
+      break;
+    }
+  }
+  ASSERT_FALSE(follower_uuid.empty());
+  auto* tserver = cluster_->find_tablet_server(follower_uuid);
+  ASSERT_NE(tserver, nullptr);
+  auto endpoint = tserver->server()->rpc_server()->GetBoundAddresses().front();
+  tserver::TabletServerServiceProxy proxy(
+      &tserver->server()->proxy_cache(), HostPort::FromBoundEndpoint(endpoint));
+
+  auto read = [&](uint32_t max_staleness_ms) -> Result<tserver::ReadResponsePB> {
+    tserver::ReadRequestPB req;
+    std::string partition_key;
+    auto op = CreateReadOp(1, &table);
+    RETURN_NOT_OK(op->GetPartitionKey(&partition_key));
+    auto* ql_batch = req.add_ql_batch();
+    *ql_batch = op->request();
+    const auto& hash_code = PartitionSchema::DecodeMultiColumnHashValue(partition_key);
+    ql_batch->set_hash_code(hash_code);
+    ql_batch->set_max_hash_code(hash_code);
+    req.set_tablet_id(tablet.tablet_id());
+    req.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    req.set_max_staleness_ms(max_staleness_ms);
+
+    tserver::ReadResponsePB resp;
+    rpc::RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(1));
+    RETURN_NOT_OK(proxy.Read(req, &resp, &controller));
+    return resp;
+  };
+
+  const uint32_t kMaxStalenessMs = 1000;
+
+  auto resp = ASSERT_RESULT(read(kMaxStalenessMs));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, resp.ql_batch(0).status());
+
+  FLAGS_propagate_safe_time = false;
+  std::this_thread::sleep_for(std::chrono::milliseconds(kMaxStalenessMs * 2));
+
+  resp = ASSERT_RESULT(read(kMaxStalenessMs));
+  ASSERT_TRUE(resp.has_error()) << resp.ShortDebugString();
+  ASSERT_EQ(tserver::TabletServerErrorPB::STALE_FOLLOWER, resp.error().code());
+
+  // A looser bound is still satisfied by the same replica.
+  resp = ASSERT_RESULT(read(kMaxStalenessMs * 60));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+
+  FLAGS_propagate_safe_time = true;
+  ASSERT_OK(WaitFor([&]() -> Result<bool> {
+    auto resp = VERIFY_RESULT(read(kMaxStalenessMs));
+    return !resp.has_error();
+  }, 10s, "Follower caught up"));
+}
+
+// External write batch is accepted only when enabled, and only with keys of the target tablet.
+TEST_F(QLTabletTest, ExternalWriteBatch) {
+  google::FlagSaver saver;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 2);
+  ASSERT_NO_FATALS(FillTable(0, 10, &table));
+
+  constexpr int32_t kKey = 1;
+  constexpr int32_t kExternalValue = -1;
+  std::string partition_key;
+  ASSERT_OK(CreateReadOp(kKey, &table)->GetPartitionKey(&partition_key));
+
+  master::GetTableLocationsRequestPB locations_req;
+  master::GetTableLocationsResponsePB locations_resp;
+  table.name().SetIntoTableIdentifierPB(locations_req.mutable_table());
+  ASSERT_OK(cluster_->mini_master()->master()->catalog_manager()->GetTableLocations(
+      &locations_req, &locations_resp));
+  ASSERT_EQ(2, locations_resp.tablet_locations_size());
+  const master::TabletLocationsPB* key_tablet = nullptr;
+  const master::TabletLocationsPB* other_tablet = nullptr;
+  for (const auto& tablet : locations_resp.tablet_locations()) {
+    const auto& partition = tablet.partition();
+    if (partition_key >= partition.partition_key_start() &&
+        (partition.partition_key_end().empty() || partition_key < partition.partition_key_end())) {
+      key_tablet = &tablet;
+    } else {
+      other_tablet = &tablet;
+    }
+  }
+  ASSERT_NE(key_tablet, nullptr);
+  ASSERT_NE(other_tablet, nullptr);
+
+  const docdb::DocKey doc_key(
+      PartitionSchema::DecodeMultiColumnHashValue(partition_key),
+      {docdb::PrimitiveValue::Int32(kKey)});
+  const docdb::SubDocKey value_key(
+      doc_key, docdb::PrimitiveValue(ColumnId(table.ColumnId(kValue))));
+
+  auto write = [this](const master::TabletLocationsPB& tablet, const docdb::SubDocKey& key)
+      -> Result<tserver::WriteResponsePB> {
+    std::string leader_uuid;
+    for (const auto& replica : tablet.replicas()) {
+      if (replica.role() == consensus::RaftPeerPB::LEADER) {
+        leader_uuid = replica.ts_info().permanent_uuid();
+        break;
+      }
+    }
+    auto* tserver = cluster_->find_tablet_server(leader_uuid);
+    if (!tserver) {
+      return STATUS_FORMAT(NotFound, "No leader for $0", tablet.tablet_id());
+    }
+    auto endpoint = tserver->server()->rpc_server()->GetBoundAddresses().front();
+    tserver::TabletServerServiceProxy proxy(
+        &tserver->server()->proxy_cache(), HostPort::FromBoundEndpoint(endpoint));
+
+    tserver::WriteRequestPB req;
+    req.set_tablet_id(tablet.tablet_id());
+    req.set_external_write_batch(true);
+    auto* kv_pair = req.mutable_write_batch()->add_kv_pairs();
+    kv_pair->set_key(key.EncodeWithoutHt().data());
+    kv_pair->set_value(docdb::Value(docdb::PrimitiveValue::Int32(kExternalValue)).Encode());
+
+    tserver::WriteResponsePB resp;
+    rpc::RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(15));
+    RETURN_NOT_OK(proxy.Write(req, &resp, &controller));
+    return resp;
+  };
+
+  auto resp = ASSERT_RESULT(write(*key_tablet, value_key));
+  ASSERT_TRUE(resp.has_error()) << resp.ShortDebugString();
+
+  FLAGS_enable_external_write_batches = true;
+
+  resp = ASSERT_RESULT(write(*other_tablet, value_key));
+  ASSERT_TRUE(resp.has_error()) << resp.ShortDebugString();
+
+  const docdb::SubDocKey unknown_column_key(
+      doc_key, docdb::PrimitiveValue(ColumnId(table.ColumnId(kValue) + 1000)));
+  resp = ASSERT_RESULT(write(*key_tablet, unknown_column_key));
+  ASSERT_TRUE(resp.has_error()) << resp.ShortDebugString();
+
+  auto session = CreateSession();
+  ASSERT_EQ(ValueForKey(kKey), GetValue(session, kKey, &table));
+
+  resp = ASSERT_RESULT(write(*key_tablet, value_key));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  ASSERT_EQ(kExternalValue, GetValue(session, kKey, &table));
+}
+
+// Reads of a batch to the same tablet should return their own rows, in request order, whether they
+// are executed in parallel or not.
+TEST_F(QLTabletTest, ReadBatch) {
+  google::FlagSaver saver;
+  constexpr int kNumKeys = 100;
+  constexpr int kNumMissingKeys = 10;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  ASSERT_NO_FATALS(FillTable(0, kNumKeys, &table));
+
+  for (bool parallelize : {true, false}) {
+    FLAGS_parallelize_read_ops = parallelize;
+    auto session = CreateSession();
+    ASSERT_OK(session->SetFlushMode(YBSession::FlushMode::MANUAL_FLUSH));
+    std::vector<std::shared_ptr<YBqlReadOp>> ops;
+    for (int i = 0; i != kNumKeys + kNumMissingKeys; ++i) {
+      ops.push_back(CreateReadOp(i, &table));
+      ASSERT_OK(session->Apply(ops.back()));
+    }
+    ASSERT_OK(session->Flush());
+    for (int i = 0; i != kNumKeys + kNumMissingKeys; ++i) {
+      SCOPED_TRACE(Format("Key: $0, parallelize: $1", i, parallelize));
+      ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, ops[i]->response().status());
+      auto rowblock = RowsResult(ops[i].get()).GetRowBlock();
+      if (i < kNumKeys) {
+        ASSERT_EQ(1, rowblock->row_count());
+        ASSERT_EQ(ValueForKey(i), rowblock->row(0).column(0).int32_value());
+      } else {
+        ASSERT_EQ(0, rowblock->row_count());
+      }
+    }
+  }
+}
+
+// Writes to a tablet should be split into RPCs that fit the write budget reported by the tablet
+// server, so a batch bigger than the operation memory limit of the tablet still succeeds.
+TEST_F(QLTabletTest, WriteBudget) {
+  google::FlagSaver saver;
+  FLAGS_tablet_operation_memory_limit_mb = 1;
+  constexpr int kNumRows = 40;
+  constexpr size_t kValueSize = 64 * 1024;
+
+  YBSchemaBuilder builder;
+  builder.AddColumn(kKey)->Type(INT32)->HashPrimaryKey()->NotNull();
+  builder.AddColumn(kValue)->Type(STRING);
+  TableHandle table;
+  ASSERT_OK(table.Create(kTable1Name, 1, client_.get(), &builder));
+
+  auto write_op = [&table](int32_t key, const std::string& value) {
+    const auto op = table.NewInsertOp();
+    auto* const req = op->mutable_request();
+    QLAddInt32HashValue(req, key);
+    table.AddStringColumnValue(req, kValue, value);
+    return op;
+  };
+  auto value_for_key = [](int32_t key) {
+    return std::to_string(key) + std::string(kValueSize, 'x');
+  };
+
+  auto session = CreateSession();
+  // The first response brings the write budget of the tablet.
+  ASSERT_OK(session->Apply(write_op(0, "")));
+
+  ASSERT_OK(session->SetFlushMode(YBSession::FlushMode::MANUAL_FLUSH));
+  std::vector<std::shared_ptr<YBqlWriteOp>> ops;
+  for (int32_t key = 1; key <= kNumRows; ++key) {
+    ops.push_back(write_op(key, value_for_key(key)));
+    ASSERT_OK(session->Apply(ops.back()));
+  }
+  ASSERT_OK(session->Flush());
+  for (const auto& op : ops) {
+    ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status()) << op->ToString();
+  }
+
+  ASSERT_OK(session->SetFlushMode(YBSession::FlushMode::AUTO_FLUSH_SYNC));
+  for (int32_t key = 1; key <= kNumRows; ++key) {
+    const auto op = table.NewReadOp();
+    auto* const req = op->mutable_request();
+    QLAddInt32HashValue(req, key);
+    table.AddColumns({kValue}, req);
+    ASSERT_OK(session->Apply(op));
+    auto rowblock = RowsResult(op.get()).GetRowBlock();
+    ASSERT_EQ(1, rowblock->row_count()) << "Key: " << key;
+    ASSERT_EQ(value_for_key(key), rowblock->row(0).column(0).string_value()) << "Key: " << key;
+  }
+}
+
 // There was bug with MvccManager when clocks were skewed.
 // Client tries to read from follower and max safe time is requested w/o any limits,
 // so new operations could be added with HT lower than returned.
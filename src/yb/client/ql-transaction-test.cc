@@ -13,6 +13,8 @@
 //
 //
 
+#include <future>
+#include <set>
 #include <thread>
 
 #include <boost/optional/optional.hpp>
@@ -58,6 +60,21 @@ DECLARE_uint64(transaction_delay_status_reply_usec_in_tests);
 DECLARE_string(time_source);
 DECLARE_bool(flush_rocksdb_on_shutdown);
 DECLARE_int32(intents_flush_max_delay_ms);
+DECLARE_bool(enable_transaction_status_batching);
+DECLARE_int32(apply_intents_batch_records);
+DECLARE_bool(transaction_single_shard_fast_path);
+DECLARE_bool(transaction_parallel_commit);
+DECLARE_bool(transaction_skip_staged_commit_in_tests);
+DECLARE_int32(transaction_parallel_commit_window_ms);
+DECLARE_bool(enable_transaction_heartbeat_batching);
+DECLARE_bool(ql_enable_packed_row);
+DECLARE_int32(transaction_status_tablet_leaders_refresh_interval_ms);
+DECLARE_string(placement_cloud);
+DECLARE_string(placement_region);
+DECLARE_string(placement_zone);
+DECLARE_bool(enable_wait_queues);
+DECLARE_int32(wait_queue_max_wait_ms);
+DECLARE_int32(wait_queue_poll_interval_ms);
 
 namespace yb {
 namespace client {
@@ -570,6 +587,116 @@ TEST_F(QLTransactionTest, InsertUpdate) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
+TEST_F(QLTransactionTest, InsertUpdateWithStatusBatching) {
+  google::FlagSaver flag_saver;
+
+  FLAGS_enable_transaction_status_batching = true;
+  DisableApplyingIntents();
+  WriteData(); // Add data
+  WriteData(); // Update data
+  VerifyData();
+  ASSERT_OK(cluster_->RestartSync());
+}
+
+TEST_F(QLTransactionTest, ApplyIntentsInChunks) {
+  google::FlagSaver flag_saver;
+
+  // Each transaction writes more reverse index records than fit into a single chunk.
+  FLAGS_apply_intents_batch_records = 3;
+  WriteData(); // Add data
+  WriteData(WriteOpType::UPDATE); // Update data
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  VerifyData(1, WriteOpType::UPDATE);
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyData(1, WriteOpType::UPDATE);
+}
+
+TEST_F(QLTransactionTest, SingleShard) {
+  auto txn = CreateTransaction();
+  txn->ExpectCommitAfterNextFlush();
+  auto session = CreateSession(txn);
+  ASSERT_OK(WriteRow(session, 1, 1));
+  ASSERT_OK(txn->CommitFuture().get());
+
+  // Single shard transaction is not registered at status tablet.
+  ASSERT_EQ(0, CountTransactions());
+  VERIFY_ROW(CreateSession(), 1, 1);
+  CheckNoRunningTransactions();
+}
+
+TEST_F(QLTransactionTest, ReadOnly) {
+  WriteData();
+
+  auto txn = std::make_shared<YBTransaction>(
+      transaction_manager_.get_ptr(), IsolationLevel::SNAPSHOT_ISOLATION,
+      ReadOnlyTransaction::kTrue);
+  auto session = CreateSession(txn);
+  ASSERT_NO_FATALS(VerifyRows(session));
+  ASSERT_NOK(WriteRow(session, 1, 1));
+  ASSERT_OK(txn->CommitFuture().get());
+
+  // Read only transaction is not registered at status tablet.
+  ASSERT_EQ(0, CountTransactions());
+  CheckNoRunningTransactions();
+}
+
+class QLTransactionParallelCommitTest : public QLTransactionTest {
+ protected:
+  void SetUp() override {
+    FLAGS_transaction_single_shard_fast_path = false;
+    FLAGS_transaction_parallel_commit = true;
+    QLTransactionTest::SetUp();
+  }
+
+  void WriteAndCommit() {
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    ASSERT_OK(session->SetFlushMode(YBSession::FlushMode::MANUAL_FLUSH));
+    for (size_t r = 0; r != kNumRows; ++r) {
+      ASSERT_OK(WriteRow(
+          session, KeyForTransactionAndIndex(0, r),
+          ValueForTransactionAndIndex(0, r, WriteOpType::INSERT)));
+    }
+    txn->ExpectCommitAfterNextFlush();
+    ASSERT_OK(session->Flush());
+    ASSERT_OK(txn->CommitFuture().get());
+  }
+};
+
+TEST_F_EX(QLTransactionTest, ParallelCommit, QLTransactionParallelCommitTest) {
+  WriteAndCommit();
+  VerifyData();
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  CheckNoRunningTransactions();
+}
+
+// Staging deadline is only the cutoff for writes, so commit should not move clock to it.
+TEST_F_EX(QLTransactionTest, ParallelCommitTime, QLTransactionParallelCommitTest) {
+  google::FlagSaver flag_saver;
+  constexpr int kWindowMs = 60000;
+  FLAGS_transaction_parallel_commit_window_ms = kWindowMs;
+  auto start = clock_->Now();
+  WriteAndCommit();
+  ASSERT_LT(clock_->Now().PhysicalDiff(start), kWindowMs * 1000 / 2);
+  VerifyData();
+  CheckNoRunningTransactions();
+}
+
+// Status record is not updated by the client, so status tablet should find written intents and
+// commit the transaction.
+TEST_F_EX(QLTransactionTest, ParallelCommitResolve, QLTransactionParallelCommitTest) {
+  google::FlagSaver flag_saver;
+  FLAGS_transaction_skip_staged_commit_in_tests = true;
+  WriteAndCommit();
+  VerifyData();
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime + 5s,
+      "Transactions cleaned"));
+  CheckNoRunningTransactions();
+}
+
 TEST_F(QLTransactionTest, Cleanup) {
   WriteData();
   VerifyData();
@@ -597,6 +724,30 @@ TEST_F(QLTransactionTest, Heartbeat) {
   CheckNoRunningTransactions();
 }
 
+TEST_F(QLTransactionTest, BatchedHeartbeat) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_transaction_heartbeat_batching = true;
+  std::vector<YBTransactionPtr> transactions;
+  constexpr size_t kTransactions = 10;
+  for (size_t i = 0; i != kTransactions; ++i) {
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    WriteRows(session, i);
+    transactions.push_back(std::move(txn));
+  }
+  std::this_thread::sleep_for(GetTransactionTimeout() * 2);
+  CountDownLatch latch(kTransactions);
+  for (auto& transaction : transactions) {
+    transaction->Commit([&latch](const Status& status) {
+      EXPECT_OK(status);
+      latch.CountDown();
+    });
+  }
+  latch.Wait();
+  VerifyData(kTransactions);
+  CheckNoRunningTransactions();
+}
+
 TEST_F(QLTransactionTest, Expire) {
   google::FlagSaver flag_saver;
   SetDisableHeartbeatInTests(true);
@@ -721,6 +872,71 @@ TEST_F(QLTransactionTest, SimpleWriteConflict) {
   ASSERT_NOK(transaction->CommitFuture().get());
 }
 
+// Transactional insert of the full row should conflict with update of its column, even when
+// packed rows are enabled.
+TEST_F(QLTransactionTest, PackedRowWriteConflict) {
+  google::FlagSaver flag_saver;
+  FLAGS_ql_enable_packed_row = true;
+
+  constexpr int32_t kKey = 1;
+  auto insert_txn = CreateTransaction();
+  ASSERT_OK(WriteRow(CreateSession(insert_txn), kKey, 1, WriteOpType::INSERT));
+
+  auto update_txn = CreateTransaction();
+  auto update_result = WriteRow(CreateSession(update_txn), kKey, 2, WriteOpType::UPDATE);
+  auto update_status = update_result.ok() ? Status::OK() : update_result.status();
+  auto insert_commit_status = insert_txn->CommitFuture().get();
+  if (update_status.ok()) {
+    update_status = update_txn->CommitFuture().get();
+  }
+  LOG(INFO) << "Insert: " << insert_commit_status << ", update: " << update_status;
+  ASSERT_FALSE(insert_commit_status.ok() && update_status.ok());
+}
+
+// With wait queues enabled, a write that conflicts with a transaction of higher priority should
+// wait until that transaction is resolved, and then succeed without blocking the tablet.
+TEST_F(QLTransactionTest, WaitQueue) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_wait_queues = true;
+  FLAGS_wait_queue_max_wait_ms = 30000;
+  // Waiter should be resumed by the abort of its blocker, not by polling.
+  FLAGS_wait_queue_poll_interval_ms = 60000;
+
+  constexpr int kMaxIterations = 20;
+  constexpr int32_t kKey = 1;
+  int waited = 0;
+  for (int i = 0; i != kMaxIterations && waited < 2; ++i) {
+    auto blocker_txn = CreateTransaction();
+    ASSERT_OK(WriteRow(CreateSession(blocker_txn), kKey, i));
+
+    auto waiter_txn = CreateTransaction();
+    auto waiter_session = CreateSession(waiter_txn);
+    ASSERT_OK(waiter_session->SetFlushMode(YBSession::FlushMode::MANUAL_FLUSH));
+    const auto op = table_.NewInsertOp();
+    auto* const req = op->mutable_request();
+    QLAddInt32HashValue(req, kKey);
+    table_.AddInt32ColumnValue(req, kValueColumn, -i);
+    ASSERT_OK(waiter_session->Apply(op));
+    auto flush_future = waiter_session->FlushFuture();
+
+    // Transaction priorities are random, so the second write could abort the first one instead.
+    if (flush_future.wait_for(1s) == std::future_status::ready) {
+      ASSERT_OK(flush_future.get());
+      ASSERT_NOK(blocker_txn->CommitFuture().get());
+    } else {
+      ++waited;
+      // Other writes to the tablet should not be blocked by the waiting one.
+      ASSERT_OK(WriteRow(CreateSession(), kKey + 1, i));
+      blocker_txn->Abort();
+      ASSERT_EQ(flush_future.wait_for(10s), std::future_status::ready);
+      ASSERT_OK(flush_future.get());
+    }
+    ASSERT_OK(waiter_txn->CommitFuture().get());
+    VerifyRow(__LINE__, CreateSession(), kKey, -i);
+  }
+  ASSERT_GT(waited, 0);
+}
+
 TEST_F(QLTransactionTest, WriteConflicts) {
   struct ActiveTransaction {
     YBTransactionPtr transaction;
@@ -1361,6 +1577,82 @@ TEST_F(QLTransactionTest, ChangeLeader) {
   }
 }
 
+// Checks that status tablet with leader in the zone of the client is picked, and that picked
+// tablets follow leader changes of status tablets.
+TEST_F(QLTransactionTest, PickLocalPlacementStatusTablet) {
+  google::FlagSaver saver;
+  FLAGS_transaction_table_num_tablets = 12;
+  FLAGS_transaction_status_tablet_leaders_refresh_interval_ms = 100;
+
+  // Only the added tablet server is placed in the zone of the client.
+  FLAGS_placement_zone = "rack2";
+  ASSERT_OK(cluster_->AddTabletServer());
+  ASSERT_OK(cluster_->WaitForTabletServerCount(cluster_->num_tablet_servers()));
+  auto* local_server = cluster_->mini_tablet_server(cluster_->num_tablet_servers() - 1)->server();
+
+  CloudInfoPB cloud_info;
+  cloud_info.set_placement_cloud(FLAGS_placement_cloud);
+  cloud_info.set_placement_region(FLAGS_placement_region);
+  cloud_info.set_placement_zone(FLAGS_placement_zone);
+  YBClientBuilder builder;
+  builder.set_cloud_info_pb(cloud_info);
+  std::shared_ptr<YBClient> client;
+  ASSERT_OK(cluster_->CreateClient(&builder, &client));
+  TransactionManager manager(client, clock_, client::LocalTabletFilter());
+
+  auto pick_status_tablet = [&manager]() -> Result<TabletId> {
+    std::promise<Result<TabletId>> promise;
+    manager.PickStatusTablet([&promise](const Result<TabletId>& tablet) {
+      promise.set_value(tablet);
+    });
+    return promise.get_future().get();
+  };
+
+  auto local_leaders = [local_server] {
+    std::set<TabletId> result;
+    for (const auto& peer : local_server->tablet_manager()->GetTabletPeers()) {
+      if (peer->tablet() && peer->tablet()->transaction_coordinator() && peer->consensus() &&
+          peer->consensus()->leader_status() !=
+              consensus::Consensus::LeaderStatus::NOT_LEADER) {
+        result.insert(peer->tablet_id());
+      }
+    }
+    return result;
+  };
+
+  // Creates transaction table.
+  ASSERT_OK(pick_status_tablet());
+  ASSERT_OK(WaitFor([&local_leaders] { return !local_leaders().empty(); }, 30s,
+                    "Status tablet leader in local zone"));
+  auto local_tablets = local_leaders();
+
+  ASSERT_OK(WaitFor([&pick_status_tablet, &local_tablets]() -> Result<bool> {
+    constexpr int kPicks = 20;
+    for (int i = 0; i != kPicks; ++i) {
+      auto tablet = VERIFY_RESULT(pick_status_tablet());
+      if (local_tablets.count(tablet) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }, 30s, "Pick only local status tablets"));
+
+  for (const auto& peer : local_server->tablet_manager()->GetTabletPeers()) {
+    if (local_tablets.count(peer->tablet_id())) {
+      consensus::LeaderStepDownRequestPB req;
+      req.set_tablet_id(peer->tablet_id());
+      consensus::LeaderStepDownResponsePB resp;
+      ASSERT_OK(peer->consensus()->StepDown(&req, &resp));
+    }
+  }
+
+  // Leaders moved away from the local zone, so after refresh other status tablets are picked.
+  ASSERT_OK(WaitFor([&pick_status_tablet, &local_tablets]() -> Result<bool> {
+    auto tablet = VERIFY_RESULT(pick_status_tablet());
+    return local_tablets.count(tablet) == 0;
+  }, 30s, "Pick status tablet after leader change"));
+}
+
 class RemoteBootstrapTest : public QLTransactionTest {
  protected:
   void SetUp() override {
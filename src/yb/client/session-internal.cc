@@ -42,8 +42,24 @@
 
 #include "yb/rpc/messenger.h"
 
+#include "yb/util/flag_tags.h"
+
+using namespace std::literals;
+
 DEFINE_int32(client_read_write_timeout_ms, 60000, "Timeout for client read and write operations.");
 
+DEFINE_int64(client_background_flush_max_bytes, 1024 * 1024,
+             "In AUTO_FLUSH_BACKGROUND mode, buffered operations are flushed as soon as their "
+             "total size reaches this limit.");
+TAG_FLAG(client_background_flush_max_bytes, advanced);
+TAG_FLAG(client_background_flush_max_bytes, runtime);
+
+DEFINE_int32(client_background_flush_max_delay_us, 1000,
+             "In AUTO_FLUSH_BACKGROUND mode, max time operations are buffered while previous "
+             "batches of the session are in flight.");
+TAG_FLAG(client_background_flush_max_delay_us, advanced);
+TAG_FLAG(client_background_flush_max_delay_us, runtime);
+
 MAKE_ENUM_LIMITS(yb::client::YBSession::FlushMode,
                  yb::client::YBSession::AUTO_FLUSH_SYNC,
                  yb::client::YBSession::MANUAL_FLUSH);
@@ -86,9 +102,12 @@ void YBSessionData::FlushFinished(internal::BatcherPtr batcher) {
 }
 
 void YBSessionData::Abort() {
+  std::lock_guard<std::mutex> lock(background_flush_mutex_);
   if (batcher_ && batcher_->HasPendingOperations()) {
     batcher_->Abort(STATUS(Aborted, "Batch aborted"));
     batcher_.reset();
+    background_buffered_ops_ = 0;
+    background_buffered_bytes_ = 0;
   }
 }
 
@@ -102,6 +121,7 @@ void YBSessionData::SetReadPoint(const Retry retry) {
 }
 
 Status YBSessionData::Close(bool force) {
+  std::lock_guard<std::mutex> lock(background_flush_mutex_);
   if (batcher_) {
     if (batcher_->HasPendingOperations() && !force) {
       return STATUS(IllegalState, "Could not close. There are pending operations.");
@@ -113,7 +133,10 @@ Status YBSessionData::Close(bool force) {
 }
 
 void YBSessionData::FlushAsync(boost::function<void(const Status&)> callback) {
-  CHECK_NE(flush_mode_, YBSession::AUTO_FLUSH_BACKGROUND) << "TODO: handle flush background mode";
+  if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND) {
+    FlushAsyncInBackground(std::move(callback));
+    return;
+  }
 
   // Swap in a new batcher to start building the next batch.
   // Save off the old batcher.
@@ -125,17 +148,164 @@ void YBSessionData::FlushAsync(boost::function<void(const Status&)> callback) {
   internal::BatcherPtr old_batcher;
   old_batcher.swap(batcher_);
   if (old_batcher) {
-    {
-      std::lock_guard<simple_spinlock> l(lock_);
-      flushed_batchers_.insert(old_batcher);
-    }
-    old_batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread_);
-    old_batcher->FlushAsync(std::move(callback));
+    FlushBatcher(old_batcher, allow_local_calls_in_curr_thread_, std::move(callback));
   } else {
     callback(Status::OK());
   }
 }
 
+void YBSessionData::FlushBatcher(
+    const internal::BatcherPtr& batcher, bool allow_local_calls_in_curr_thread,
+    FlushCallback callback) {
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    flushed_batchers_.insert(batcher);
+  }
+  batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread);
+  batcher->set_run_callback_inline(run_callbacks_inline_);
+  batcher->FlushAsync(std::move(callback));
+}
+
+bool YBSessionData::HasFlushedBatchers() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return !flushed_batchers_.empty();
+}
+
+internal::BatcherPtr YBSessionData::TakeBatcherForBackgroundFlushUnlocked() {
+  internal::BatcherPtr result;
+  if (background_buffered_ops_ != 0) {
+    result.swap(batcher_);
+    background_buffered_ops_ = 0;
+    background_buffered_bytes_ = 0;
+  }
+  return result;
+}
+
+Status YBSessionData::ApplyInBackground(const std::vector<YBOperationPtr>& ops) {
+  internal::BatcherPtr to_flush;
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(background_flush_mutex_);
+    auto& batcher = Batcher();
+    for (const auto& op : ops) {
+      Status s = batcher.Add(op);
+      if (!PREDICT_FALSE(s.ok())) {
+        error_collector_->AddError(op, s);
+        return s;
+      }
+      ++background_buffered_ops_;
+      background_buffered_bytes_ += op->space_used_by_request();
+    }
+
+    // When nothing is in flight there is nothing to wait for, so ops are sent immediately.
+    // Otherwise they are buffered until the batch is big enough, previous batches are done or
+    // max delay passes, so one RPC carries the ops applied meanwhile.
+    if (!HasFlushedBatchers() ||
+        background_buffered_bytes_ >=
+            static_cast<size_t>(FLAGS_client_background_flush_max_bytes)) {
+      to_flush = TakeBatcherForBackgroundFlushUnlocked();
+    } else if (!background_flush_scheduled_) {
+      background_flush_scheduled_ = true;
+      schedule_flush = true;
+    }
+  }
+
+  if (to_flush) {
+    FlushBatcher(to_flush, allow_local_calls_in_curr_thread_, BackgroundFlushDoneCallback());
+  } else if (schedule_flush) {
+    std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+    client_->messenger()->scheduler().Schedule(
+        [weak_self](const Status&) {
+          auto self = weak_self.lock();
+          if (self) {
+            self->BackgroundFlushScheduled();
+          }
+        },
+        FLAGS_client_background_flush_max_delay_us * 1us);
+  }
+  return Status::OK();
+}
+
+YBSessionData::FlushCallback YBSessionData::BackgroundFlushDoneCallback() {
+  std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+  return [weak_self](const Status&) {
+    auto self = weak_self.lock();
+    if (self) {
+      self->BackgroundFlushDone();
+    }
+  };
+}
+
+void YBSessionData::BackgroundFlushScheduled() {
+  internal::BatcherPtr to_flush;
+  {
+    std::lock_guard<std::mutex> lock(background_flush_mutex_);
+    background_flush_scheduled_ = false;
+    to_flush = TakeBatcherForBackgroundFlushUnlocked();
+  }
+  if (to_flush) {
+    // Invoked on the scheduler thread, so local calls should not be executed inline.
+    FlushBatcher(
+        to_flush, false /* allow_local_calls_in_curr_thread */, BackgroundFlushDoneCallback());
+  }
+}
+
+void YBSessionData::BackgroundFlushDone() {
+  // Errors are reported to error_collector_ by the batcher.
+  internal::BatcherPtr to_flush;
+  std::vector<FlushCallback> waiters;
+  {
+    std::lock_guard<std::mutex> lock(background_flush_mutex_);
+    if (!HasFlushedBatchers()) {
+      to_flush = TakeBatcherForBackgroundFlushUnlocked();
+      if (!to_flush) {
+        waiters.swap(background_flush_waiters_);
+      }
+    }
+  }
+
+  if (to_flush) {
+    // Invoked on the callback thread of the previous batch.
+    FlushBatcher(
+        to_flush, false /* allow_local_calls_in_curr_thread */, BackgroundFlushDoneCallback());
+    return;
+  }
+
+  if (!waiters.empty()) {
+    Status status;
+    if (error_collector_->CountErrors() != 0) {
+      status = STATUS(IOError, "Errors occured while reaching out to the tablet servers");
+    }
+    for (const auto& waiter : waiters) {
+      waiter(status);
+    }
+  }
+}
+
+void YBSessionData::FlushAsyncInBackground(FlushCallback callback) {
+  internal::BatcherPtr to_flush;
+  bool done = false;
+  {
+    std::lock_guard<std::mutex> lock(background_flush_mutex_);
+    to_flush = TakeBatcherForBackgroundFlushUnlocked();
+    if (to_flush || HasFlushedBatchers()) {
+      background_flush_waiters_.push_back(std::move(callback));
+    } else {
+      done = true;
+    }
+  }
+
+  if (done) {
+    // Nothing is buffered or in flight.
+    callback(Status::OK());
+    return;
+  }
+
+  if (to_flush) {
+    FlushBatcher(to_flush, allow_local_calls_in_curr_thread_, BackgroundFlushDoneCallback());
+  }
+}
+
 bool YBSessionData::allow_local_calls_in_curr_thread() const {
   return allow_local_calls_in_curr_thread_;
 }
@@ -157,6 +327,10 @@ internal::Batcher& YBSessionData::Batcher() {
 }
 
 Status YBSessionData::Apply(YBOperationPtr yb_op) {
+  if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND) {
+    return ApplyInBackground({yb_op});
+  }
+
   Status s = Batcher().Add(yb_op);
   if (!PREDICT_FALSE(s.ok())) {
     error_collector_->AddError(yb_op, s);
@@ -172,6 +346,11 @@ Status YBSessionData::Apply(YBOperationPtr yb_op) {
 
 Status YBSessionData::Apply(
     const std::vector<YBOperationPtr>& ops, VerifyResponse verify_response) {
+  if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND) {
+    LOG_IF(DFATAL, verify_response) << "Verify response could be used only with sync flush mode.";
+    return ApplyInBackground(ops);
+  }
+
   auto& batcher = Batcher();
   for (const auto& op : ops) {
     Status s = batcher.Add(op);
@@ -205,11 +384,8 @@ Status YBSessionData::Flush() {
 }
 
 Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
-  if (mode == YBSession::AUTO_FLUSH_BACKGROUND) {
-    return STATUS(NotSupported, "AUTO_FLUSH_BACKGROUND has not been implemented in the"
-        " c++ client (see KUDU-456).");
-  }
-  if (batcher_ && batcher_->HasPendingOperations()) {
+  if ((batcher_ && batcher_->HasPendingOperations()) ||
+      (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND && HasFlushedBatchers())) {
     // TODO: there may be a more reasonable behavior here.
     return STATUS(IllegalState, "Cannot change flush mode when writes are buffered");
   }
@@ -224,6 +400,7 @@ Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
 
 void YBSessionData::SetTimeout(MonoDelta timeout) {
   CHECK_GE(timeout, MonoDelta::kZero);
+  std::lock_guard<std::mutex> lock(background_flush_mutex_);
   timeout_ = timeout;
   if (batcher_) {
     batcher_->SetTimeout(timeout);
@@ -236,8 +413,11 @@ int YBSessionData::CountBufferedOperations() const {
 }
 
 bool YBSessionData::HasPendingOperations() const {
-  if (batcher_ && batcher_->HasPendingOperations()) {
-    return true;
+  {
+    std::lock_guard<std::mutex> lock(background_flush_mutex_);
+    if (batcher_ && batcher_->HasPendingOperations()) {
+      return true;
+    }
   }
   std::lock_guard<simple_spinlock> l(lock_);
   for (const auto& b : flushed_batchers_) {
@@ -32,7 +32,9 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
+#include <mutex>
 #include <unordered_set>
+#include <vector>
 
 #include "yb/client/async_rpc.h"
 #include "yb/common/consistent_read_point.h"
@@ -102,9 +104,40 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   void set_allow_local_calls_in_curr_thread(bool flag);
   bool allow_local_calls_in_curr_thread() const;
 
+  void set_run_callbacks_inline(bool flag) {
+    run_callbacks_inline_ = flag;
+  }
+
  private:
+  typedef boost::function<void(const Status&)> FlushCallback;
+
   internal::Batcher& Batcher();
 
+  // Adds ops to the batcher and flushes it when it should not wait for more ops, or schedules
+  // flush after delay. Used in AUTO_FLUSH_BACKGROUND mode.
+  CHECKED_STATUS ApplyInBackground(const std::vector<YBOperationPtr>& ops);
+
+  // Flushes buffered ops in AUTO_FLUSH_BACKGROUND mode, callback is invoked when all ops applied
+  // to this session so far are completed.
+  void FlushAsyncInBackground(FlushCallback callback);
+
+  // Flushes the current batcher if it has buffered ops.
+  void BackgroundFlushScheduled();
+
+  // Called when a batcher flushed in AUTO_FLUSH_BACKGROUND mode is done.
+  void BackgroundFlushDone();
+  FlushCallback BackgroundFlushDoneCallback();
+
+  // Detaches the current batcher if it has buffered ops, so it could be flushed
+  // outside of background_flush_mutex_.
+  internal::BatcherPtr TakeBatcherForBackgroundFlushUnlocked();
+
+  bool HasFlushedBatchers() const;
+
+  void FlushBatcher(
+      const internal::BatcherPtr& batcher, bool allow_local_calls_in_curr_thread,
+      FlushCallback callback);
+
   // The client that this session is associated with.
   const std::shared_ptr<YBClient> client_;
 
@@ -112,6 +145,8 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   YBTransactionPtr transaction_;
   bool allow_local_calls_in_curr_thread_ = true;
 
+  bool run_callbacks_inline_ = false;
+
   // Lock protecting flushed_batchers_.
   mutable simple_spinlock lock_;
 
@@ -133,6 +168,20 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
 
   YBSession::FlushMode flush_mode_ = YBSession::AUTO_FLUSH_SYNC;
 
+  // Protects batcher_ and the state below in AUTO_FLUSH_BACKGROUND mode, where the batcher is
+  // also flushed by the scheduler and by completion of previous batches.
+  mutable std::mutex background_flush_mutex_;
+
+  // Number and size of ops buffered in batcher_ in AUTO_FLUSH_BACKGROUND mode.
+  size_t background_buffered_ops_ = 0;
+  size_t background_buffered_bytes_ = 0;
+
+  // Whether flush of buffered ops is scheduled in AUTO_FLUSH_BACKGROUND mode.
+  bool background_flush_scheduled_ = false;
+
+  // Callbacks of FlushAsync in AUTO_FLUSH_BACKGROUND mode, invoked when all ops are completed.
+  std::vector<FlushCallback> background_flush_waiters_;
+
   // Timeout for the next batch.
   MonoDelta timeout_;
 
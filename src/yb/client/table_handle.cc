@@ -13,6 +13,10 @@
 
 #include "yb/client/table_handle.h"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 #include "yb/client/client.h"
 #include "yb/client/yb_op.h"
 
@@ -252,9 +256,8 @@ void TableIterator::Move() {
     if (current_block_) {
       if (paging_state_) {
         auto& op = ops_[ops_index_];
-        *op->mutable_request()->mutable_paging_state() = *paging_state_;
-        REPORT_AND_RETURN_IF_NOT_OK(session_->Apply(op));
-        REPORT_AND_RETURN_IF_NOT_OK(session_->Flush());
+        op = std::move(prefetch_op_);
+        REPORT_AND_RETURN_IF_NOT_OK(prefetch_future_.get());
         if (QLResponsePB::YQL_STATUS_OK != op->response().status()) {
           HandleError(STATUS_FORMAT(RuntimeError, "Error for $0: $1", *op, op->response()));
         }
@@ -274,7 +277,9 @@ void TableIterator::Move() {
     REPORT_AND_RETURN_IF_NOT_OK(next_block);
     current_block_ = std::move(*next_block);
     paging_state_ = op.response().has_paging_state() ? &op.response().paging_state() : nullptr;
-    if (ops_index_ < partition_key_ends_.size() - 1 && paging_state_ &&
+    // Last tablet has empty partition key end. Do not compare by index, since only some tablets
+    // could be scanned.
+    if (!partition_key_ends_[ops_index_].empty() && paging_state_ &&
         paging_state_->next_partition_key() >= partition_key_ends_[ops_index_]) {
       paging_state_ = nullptr;
     }
@@ -282,9 +287,32 @@ void TableIterator::Move() {
 
     VLOG(4) << "New block: " << yb::ToString(current_block_->rows())
             << ", paging: " << yb::ToString(paging_state_);
+
+    if (paging_state_) {
+      PrefetchNextPage();
+    }
   }
 }
 
+void TableIterator::PrefetchNextPage() {
+  auto& op = *ops_[ops_index_];
+  prefetch_op_ = table_->NewReadOp();
+  *prefetch_op_->mutable_request() = op.request();
+  *prefetch_op_->mutable_request()->mutable_paging_state() = *paging_state_;
+  prefetch_op_->set_yb_consistency_level(op.yb_consistency_level());
+  if (op.read_time()) {
+    prefetch_op_->SetReadTime(op.read_time());
+  }
+  auto status = session_->Apply(prefetch_op_);
+  if (!status.ok()) {
+    // Remaining pages of this tablet are skipped after reporting the error.
+    paging_state_ = nullptr;
+    HandleError(status);
+    return;
+  }
+  prefetch_future_ = session_->FlushFuture();
+}
+
 void TableIterator::HandleError(const Status& status) {
   if (error_handler_) {
     error_handler_(status);
@@ -337,5 +365,59 @@ void FilterEqualImpl<std::string>::operator()(
   table.SetBinaryCondition(condition, column_, QL_OP_EQUAL, t_);
 }
 
+Status ParallelScan(const TableHandle& table, ParallelScanOptions options,
+                    const TableScanSink& sink) {
+  google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets;
+  RETURN_NOT_OK(table->client()->GetTablets(table.name(), 0, &tablets));
+  if (!options.iterator_options.columns) {
+    options.iterator_options.columns = table.AllColumnNames();
+  }
+
+  std::atomic<int> next_tablet{0};
+  std::mutex mutex;
+  Status result;
+  auto scan_tablets = [&] {
+    for (;;) {
+      const int tablet_index = next_tablet.fetch_add(1, std::memory_order_relaxed);
+      if (tablet_index >= tablets.size()) {
+        return;
+      }
+      const auto& tablet_id = tablets.Get(tablet_index).tablet_id();
+      bool failed = false;
+      auto tablet_options = options.iterator_options;
+      tablet_options.tablet = tablet_id;
+      tablet_options.error_handler = [&mutex, &result, &failed](const Status& status) {
+        failed = true;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = status;
+        }
+      };
+      TableIterator end;
+      for (TableIterator it(&table, tablet_options); it != end; ++it) {
+        if (failed) {
+          break;
+        }
+        sink(tablet_id, *it);
+      }
+      if (failed) {
+        return;
+      }
+    }
+  };
+
+  const size_t num_threads = std::min<size_t>(std::max<size_t>(options.concurrency, 1),
+                                              tablets.size());
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (size_t i = 0; i != num_threads; ++i) {
+    threads.emplace_back(scan_tablets);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return result;
+}
+
 } // namespace client
 } // namespace yb
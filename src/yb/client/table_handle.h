@@ -14,6 +14,7 @@
 #ifndef YB_CLIENT_TABLE_HANDLE_H
 #define YB_CLIENT_TABLE_HANDLE_H
 
+#include <future>
 #include <unordered_map>
 
 #include <boost/optional.hpp>
@@ -182,6 +183,10 @@ class TableIterator : public std::iterator<
   void Move();
   void HandleError(const Status& status);
 
+  // Sends request for the page that follows the current block, so it is fetched while the current
+  // block is consumed.
+  void PrefetchNextPage();
+
   const TableHandle* table_;
   std::vector<YBqlReadOpPtr> ops_;
   std::vector<std::string> partition_key_ends_;
@@ -189,11 +194,31 @@ class TableIterator : public std::iterator<
   size_t ops_index_ = 0;
   boost::optional<QLRowBlock> current_block_;
   const QLPagingStatePB* paging_state_ = nullptr;
+  // Read of the next page of the current tablet, present when paging_state_ is set.
+  YBqlReadOpPtr prefetch_op_;
+  std::shared_future<Status> prefetch_future_;
   size_t row_index_;
   YBSessionPtr session_;
   std::function<void(const Status&)> error_handler_;
 };
 
+struct ParallelScanOptions {
+  // Tablet and error handler are set for each tablet scan and should not be specified.
+  TableIteratorOptions iterator_options;
+
+  // Max number of tablets that are scanned at once.
+  size_t concurrency = 8;
+};
+
+// Invoked for each row of the table with id of the tablet that contains it.
+typedef std::function<void(const std::string& tablet_id, const QLRow& row)> TableScanSink;
+
+// Scans all tablets of the table, running up to options.concurrency tablet scans in parallel.
+// sink is invoked concurrently from scan threads, rows of the same tablet are passed from the same
+// thread in order. Returns the first error, other scans are stopped after it.
+CHECKED_STATUS ParallelScan(const TableHandle& table, ParallelScanOptions options,
+                            const TableScanSink& sink);
+
 inline bool operator==(const TableIterator& lhs, const TableIterator& rhs) {
   return lhs.Equals(rhs);
 }
@@ -67,6 +67,24 @@ void TabletInvoker::SelectLocalTabletServer() {
   VLOG(1) << "Using local tserver: " << current_ts_->ToString();
 }
 
+RemoteTabletServer* TabletInvoker::SelectHedgeTabletServer() const {
+  std::vector<RemoteTabletServer*> replicas;
+  tablet_->GetRemoteTabletServers(&replicas, UpdateLocalTsState::kFalse);
+  RemoteTabletServer* result = nullptr;
+  MonoDelta result_latency;
+  for (auto* ts : replicas) {
+    if (ts == current_ts_) {
+      continue;
+    }
+    auto latency = ts->ReadLatencyP95();
+    if (result == nullptr || latency < result_latency) {
+      result = ts;
+      result_latency = latency;
+    }
+  }
+  return result;
+}
+
 void TabletInvoker::SelectTabletServer()  {
   // Choose a destination TS according to the following algorithm:
   // 1. Select the leader, provided:
@@ -208,6 +226,28 @@ void TabletInvoker::FailToNewReplica(const Status& reason,
   LOG_IF(DFATAL, !status.ok()) << "Retry failed: " << status;
 }
 
+bool TabletInvoker::FollowLeaderHint(const tserver::TabletServerErrorPB* error) {
+  if (!tablet_ || ErrorCode(error) != tserver::TabletServerErrorPB::NOT_THE_LEADER ||
+      !error->has_leader_uuid()) {
+    return false;
+  }
+  std::vector<RemoteTabletServer*> replicas;
+  tablet_->GetRemoteTabletServers(&replicas, UpdateLocalTsState::kFalse);
+  for (RemoteTabletServer* ts : replicas) {
+    if (ts->permanent_uuid() == error->leader_uuid()) {
+      if (ContainsKey(followers_, ts)) {
+        // Hint is stale, this server already refused the request because it was a follower.
+        return false;
+      }
+      VLOG(1) << "Tablet " << tablet_id_ << ": " << current_ts_->ToString()
+              << " reported leader " << ts->ToString();
+      tablet_->MarkTServerAsLeader(ts);
+      return true;
+    }
+  }
+  return false;
+}
+
 bool TabletInvoker::Done(Status* status) {
   TRACE_TO(trace_, "Done($0)", status->ToString(false));
   ADOPT_TRACE(trace_);
@@ -272,7 +312,13 @@ bool TabletInvoker::Done(Status* status) {
       return true;
     }
 
-    if (status->IsIllegalState() || TabletNotFoundOnTServer(rpc_->response_error(), *status)) {
+    if (status->IsIllegalState() && FollowLeaderHint(rpc_->response_error())) {
+      // The follower told us who the leader is, so just retry to it without marking the follower
+      // as failed.
+      auto retry_status = retrier_->DelayedRetry(command_, *status);
+      LOG_IF(DFATAL, !retry_status.ok()) << "Retry failed: " << retry_status;
+    } else if (status->IsIllegalState() ||
+               TabletNotFoundOnTServer(rpc_->response_error(), *status)) {
       FailToNewReplica(*status, rpc_->response_error());
     } else {
       auto retry_status = retrier_->DelayedRetry(command_, *status);
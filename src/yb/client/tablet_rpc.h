@@ -70,9 +70,13 @@ class TabletInvoker {
   const RemoteTabletPtr& tablet() const { return tablet_; }
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy() const;
   YBClient& client() const { return *client_; }
-  const RemoteTabletServer& current_ts() { return *current_ts_; }
+  RemoteTabletServer& current_ts() { return *current_ts_; }
   bool local_tserver_only() const { return local_tserver_only_; }
 
+  // Returns replica other than current_ts_ with the lowest read latency, to send a hedged read
+  // to. Returns nullptr if there is no such replica.
+  RemoteTabletServer* SelectHedgeTabletServer() const;
+
  private:
   void SelectTabletServer();
 
@@ -89,6 +93,10 @@ class TabletInvoker {
   void FailToNewReplica(const Status& reason,
                         const tserver::TabletServerErrorPB* error_code = nullptr);
 
+  // Marks the leader reported by a follower in the error, as the leader of the tablet.
+  // Returns false if there is no such hint or it could not be used.
+  bool FollowLeaderHint(const tserver::TabletServerErrorPB* error);
+
   // Called when we finish a lookup (to find the new consensus leader). Retries
   // the rpc after a short delay.
   void LookupTabletCb(const Status& status);
@@ -17,6 +17,9 @@
 
 #include <unordered_set>
 
+#include <boost/optional/optional.hpp>
+#include <boost/optional/optional_io.hpp>
+
 #include "yb/client/async_rpc.h"
 #include "yb/client/client.h"
 #include "yb/client/in_flight_op.h"
@@ -32,6 +35,7 @@
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/scheduler.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/random_util.h"
 #include "yb/util/result.h"
@@ -41,6 +45,30 @@ using namespace std::placeholders;
 
 DEFINE_uint64(transaction_heartbeat_usec, 500000, "Interval of transaction heartbeat in usec.");
 DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat during test.");
+DEFINE_bool(enable_transaction_heartbeat_batching, false,
+            "Send heartbeats of all transactions with the same status tablet in a single RPC. "
+            "All servers of the cluster should support batched heartbeats.");
+TAG_FLAG(enable_transaction_heartbeat_batching, advanced);
+TAG_FLAG(enable_transaction_heartbeat_batching, runtime);
+DEFINE_bool(transaction_single_shard_fast_path, true,
+            "Send transaction, whose only batch is writes to a single tablet, as a single "
+            "non-transactional write, without intents and status tablet.");
+TAG_FLAG(transaction_single_shard_fast_path, advanced);
+TAG_FLAG(transaction_single_shard_fast_path, runtime);
+DEFINE_bool(transaction_parallel_commit, false,
+            "Send the status record of a transaction, whose last batch writes only to new tablets, "
+            "together with this batch, and report commit as soon as both are replicated.");
+TAG_FLAG(transaction_parallel_commit, advanced);
+TAG_FLAG(transaction_parallel_commit, runtime);
+DEFINE_int32(transaction_parallel_commit_window_ms, 1000,
+             "Max time since the start of the last batch of parallel commit, before which writes "
+             "of this batch should be replicated. Otherwise commit waits for the status record "
+             "to be updated.");
+TAG_FLAG(transaction_parallel_commit_window_ms, advanced);
+TAG_FLAG(transaction_parallel_commit_window_ms, runtime);
+DEFINE_bool(transaction_skip_staged_commit_in_tests, false,
+            "Do not update the status record after parallel commit is reported, so the status "
+            "tablet has to resolve it.");
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -55,6 +83,27 @@ TransactionMetadata CreateMetadata(IsolationLevel isolation, HybridTime read_tim
 YB_STRONGLY_TYPED_BOOL(Child);
 YB_DEFINE_ENUM(TransactionState, (kRunning)(kAborted)(kCommitted));
 
+// Returns true when ops are unconditional QL writes to the same tablet, so they are applied
+// atomically by a single write request.
+bool IsSingleShardWrite(const std::unordered_set<internal::InFlightOpPtr>& ops) {
+  const internal::RemoteTablet* tablet = nullptr;
+  for (const auto& op : ops) {
+    if (op->yb_op->type() != YBOperation::Type::QL_WRITE) {
+      return false;
+    }
+    const auto& request = static_cast<const YBqlWriteOp*>(op->yb_op.get())->request();
+    if (request.has_if_expr() || request.has_child_transaction_data()) {
+      return false;
+    }
+    if (tablet == nullptr) {
+      tablet = op->tablet.get();
+    } else if (tablet != op->tablet.get()) {
+      return false;
+    }
+  }
+  return tablet != nullptr;
+}
+
 } // namespace
 
 Result<ChildTransactionData> ChildTransactionData::FromPB(const ChildTransactionDataPB& data) {
@@ -71,11 +120,15 @@ Result<ChildTransactionData> ChildTransactionData::FromPB(const ChildTransaction
 
 class YBTransaction::Impl final {
  public:
-  Impl(TransactionManager* manager, YBTransaction* transaction, IsolationLevel isolation)
+  Impl(TransactionManager* manager, YBTransaction* transaction, IsolationLevel isolation,
+       ReadOnlyTransaction read_only)
       : manager_(manager),
         transaction_(transaction),
         read_point_(manager->clock()),
-        child_(Child::kFalse) {
+        child_(Child::kFalse),
+        read_only_(read_only) {
+    LOG_IF(DFATAL, read_only_ && isolation != IsolationLevel::SNAPSHOT_ISOLATION)
+        << "Read only transaction with isolation " << IsolationLevel_Name(isolation);
     if (isolation == IsolationLevel::SNAPSHOT_ISOLATION) {
       read_point_.SetCurrentReadTime();
       metadata_ = CreateMetadata(isolation, read_point_.GetReadTime());
@@ -92,7 +145,8 @@ class YBTransaction::Impl final {
       : manager_(manager),
         transaction_(transaction),
         read_point_(manager->clock()),
-        child_(Child::kTrue) {
+        child_(Child::kTrue),
+        read_only_(ReadOnlyTransaction::kFalse) {
     read_point_.SetReadTime(std::move(data.read_time), std::move(data.local_limits));
     metadata_ = std::move(data.metadata);
     Init();
@@ -101,11 +155,13 @@ class YBTransaction::Impl final {
   }
 
   ~Impl() {
-    manager_->rpcs().Abort({&heartbeat_handle_, &commit_handle_, &abort_handle_});
+    manager_->rpcs().Abort(
+        {&heartbeat_handle_, &commit_handle_, &abort_handle_, &staging_handle_});
   }
 
   YBTransactionPtr CreateSimilarTransaction() {
-    return std::make_shared<YBTransaction>(manager_, metadata_.isolation);
+    return std::make_shared<YBTransaction>(
+        manager_, metadata_.isolation, ReadOnlyTransaction(read_only_));
   }
 
   // This transaction is a restarted transaction, so we set it up with data from original one.
@@ -122,6 +178,10 @@ class YBTransaction::Impl final {
       other->read_point_ = std::move(read_point_);
       other->read_point_.Restart();
       state_.store(TransactionState::kAborted, std::memory_order_release);
+      if (read_only_) {
+        // Nothing was registered, restart time is picked by local read point.
+        return;
+      }
     }
     DoAbort(Status::OK(), transaction);
   }
@@ -134,9 +194,40 @@ class YBTransaction::Impl final {
     VLOG_WITH_PREFIX(1) << "Prepare";
 
     bool has_tablets_without_parameters = false;
+    std::vector<TabletId> staged_tablets;
     {
       std::unique_lock<std::mutex> lock(mutex_);
+      if (single_shard_ || staging_) {
+        // Single shard write was already committed, or staged batch was the last one, so nothing
+        // could be added to it.
+        lock.unlock();
+        FailPrepare(STATUS(IllegalState, "Flush after last transaction batch"), waiter);
+        return false;
+      }
+      if (read_only_) {
+        lock.unlock();
+        for (const auto& op : ops) {
+          if (!op->yb_op->read_only()) {
+            FailPrepare(STATUS(IllegalState, "Write in read only transaction"), waiter);
+            return false;
+          }
+        }
+        // Metadata is not filled, so reads are sent as non-transactional reads at the read time
+        // of this transaction.
+        return true;
+      }
       if (!ready_) {
+        if (commit_after_next_flush_ && tablets_.empty() && !child_ &&
+            !requested_status_tablet_.load(std::memory_order_acquire) &&
+            GetAtomicFlag(&FLAGS_transaction_single_shard_fast_path) &&
+            IsSingleShardWrite(ops)) {
+          // Transaction metadata is not filled, so the batch is sent as a non-transactional
+          // write. It is applied directly to regular DB at its hybrid time, under locks and
+          // after conflict resolution with intents of other transactions.
+          VLOG_WITH_PREFIX(1) << "Prepare, single shard";
+          single_shard_ = true;
+          return true;
+        }
         waiters_.push_back(std::move(waiter));
         lock.unlock();
         RequestStatusTablet();
@@ -144,6 +235,15 @@ class YBTransaction::Impl final {
         return false;
       }
 
+      if (commit_after_next_flush_ && !child_ &&
+          GetAtomicFlag(&FLAGS_transaction_parallel_commit) && OnlyNewTablets(ops)) {
+        // Staged writes are checked by presence of any intents of this transaction in a tablet,
+        // so it is used only when the last batch writes to new tablets.
+        staging_ = true;
+        staging_deadline_ = manager_->Now().AddMicroseconds(
+            GetAtomicFlag(&FLAGS_transaction_parallel_commit_window_ms) * 1000);
+      }
+
       for (const auto& op : ops) {
         VLOG_WITH_PREFIX(1) << "Prepare, op: " << op->ToString();
         DCHECK(op->tablet != nullptr);
@@ -155,6 +255,13 @@ class YBTransaction::Impl final {
           has_tablets_without_parameters = !it->second.has_parameters;
         }
       }
+
+      if (staging_) {
+        staged_tablets.reserve(tablets_.size());
+        for (const auto& tablet : tablets_) {
+          staged_tablets.push_back(tablet.first);
+        }
+      }
     }
 
     if (has_tablets_without_parameters) {
@@ -162,10 +269,33 @@ class YBTransaction::Impl final {
     } else {
       metadata->transaction_id = metadata_.transaction_id;
     }
+    if (!staged_tablets.empty()) {
+      SendStaging(staged_tablets, transaction_->shared_from_this());
+    }
     return true;
   }
 
   void Flushed(const internal::InFlightOps& ops, const Status& status) {
+    if (read_only_) {
+      // Reads are not tracked, because there is nothing to commit.
+      return;
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (single_shard_) {
+        SingleShardFlushed(ops, status, &lock);
+        return;
+      }
+      if (staging_) {
+        // Clock was updated by responses, so it is not less than hybrid time of the writes.
+        staged_flush_time_ = manager_->Now();
+        staged_flush_status_ = BatchResult(ops, status);
+        VLOG_WITH_PREFIX(1) << "Staged batch flushed: " << *staged_flush_status_
+                            << ", time: " << staged_flush_time_;
+        MaybeFinishStaged(&lock);
+        return;
+      }
+    }
     if (status.ok()) {
       std::lock_guard<std::mutex> lock(mutex_);
       TabletStates::iterator it = tablets_.end();
@@ -207,6 +337,26 @@ class YBTransaction::Impl final {
       }
       state_.store(TransactionState::kCommitted, std::memory_order_release);
       commit_callback_ = std::move(callback);
+      if (read_only_) {
+        lock.unlock();
+        commit_callback_(Status::OK());
+        return;
+      }
+      if (single_shard_) {
+        VLOG_WITH_PREFIX(1) << "Commit single shard, flushed: " << single_shard_status_;
+        if (!single_shard_status_) {
+          // Callback will be invoked when the write is flushed.
+          return;
+        }
+        auto status = *single_shard_status_;
+        lock.unlock();
+        commit_callback_(status);
+        return;
+      }
+      if (staging_) {
+        MaybeFinishStaged(&lock);
+        return;
+      }
       if (!ready_) {
         waiters_.emplace_back(std::bind(&Impl::DoCommit, this, _1, transaction));
         lock.unlock();
@@ -231,6 +381,15 @@ class YBTransaction::Impl final {
         return;
       }
       state_.store(TransactionState::kAborted, std::memory_order_release);
+      if (read_only_) {
+        return;
+      }
+      if (single_shard_) {
+        // Nothing was registered at status tablet, and the write could not be rolled back.
+        VLOG_WITH_PREFIX(1) << "Abort single shard, flushed: " << single_shard_status_;
+        return;
+      }
+
       if (!ready_) {
         waiters_.emplace_back(std::bind(&Impl::DoAbort, this, _1, transaction));
         lock.unlock();
@@ -245,6 +404,15 @@ class YBTransaction::Impl final {
     return read_point_.IsRestartRequired();
   }
 
+  bool read_only() const {
+    return read_only_;
+  }
+
+  void ExpectCommitAfterNextFlush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    commit_after_next_flush_ = true;
+  }
+
   std::shared_future<TransactionMetadata> TEST_GetMetadata() {
     std::unique_lock<std::mutex> lock(mutex_);
     if (metadata_future_.valid()) {
@@ -278,6 +446,12 @@ class YBTransaction::Impl final {
       callback(STATUS(IllegalState, "Restart required"));
       return;
     }
+    if (single_shard_ || read_only_) {
+      lock.unlock();
+      callback(STATUS_FORMAT(IllegalState, "Child of $0 transaction",
+                             single_shard_ ? "single shard" : "read only"));
+      return;
+    }
     if (!ready_) {
       waiters_.emplace_back(std::bind(
           &Impl::DoPrepareChild, this, _1, transaction, std::move(callback), nullptr /* lock */));
@@ -345,6 +519,12 @@ class YBTransaction::Impl final {
     heartbeat_handle_ = manager_->rpcs().InvalidHandle();
     commit_handle_ = manager_->rpcs().InvalidHandle();
     abort_handle_ = manager_->rpcs().InvalidHandle();
+    staging_handle_ = manager_->rpcs().InvalidHandle();
+  }
+
+  void FailPrepare(const Status& status, const Waiter& waiter) {
+    manager_->client()->messenger()->scheduler().Schedule(
+        [waiter, status](const Status&) { waiter(status); }, std::chrono::milliseconds(0));
   }
 
   CHECKED_STATUS CheckRunning(std::unique_lock<std::mutex>* lock) {
@@ -404,6 +584,14 @@ class YBTransaction::Impl final {
       return;
     }
 
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (staging_) {
+        SendStagedAbort(transaction);
+        return;
+      }
+    }
+
     tserver::AbortTransactionRequestPB req;
     req.set_tablet_id(status_tablet_->tablet_id());
     req.set_propagated_hybrid_time(manager_->Now().ToUint64());
@@ -426,9 +614,151 @@ class YBTransaction::Impl final {
 
     manager_->UpdateClock(propagated_hybrid_time);
     manager_->rpcs().Unregister(&commit_handle_);
+    if (staged_commit_reported_) {
+      // Status tablet resolves staging transaction by itself, when this update is lost.
+      LOG_IF_WITH_PREFIX(WARNING, !status.ok()) << "Failed to complete staged commit: " << status;
+      return;
+    }
     commit_callback_(status);
   }
 
+  // Returns true when none of the tablets of ops received writes of this transaction yet.
+  bool OnlyNewTablets(const std::unordered_set<internal::InFlightOpPtr>& ops) const {
+    for (const auto& op : ops) {
+      if (tablets_.count(op->tablet->tablet_id())) {
+        return false;
+      }
+    }
+    return !ops.empty();
+  }
+
+  // Sends staging record, that lists all involved tablets, together with the last batch.
+  void SendStaging(const std::vector<TabletId>& tablets, const YBTransactionPtr& transaction) {
+    VLOG_WITH_PREFIX(1) << "Staging, tablets: " << yb::ToString(tablets)
+                        << ", deadline: " << staging_deadline_;
+
+    tserver::UpdateTransactionRequestPB req;
+    req.set_tablet_id(status_tablet_->tablet_id());
+    req.set_propagated_hybrid_time(manager_->Now().ToUint64());
+    auto& state = *req.mutable_state();
+    state.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
+    state.set_status(TransactionStatus::STAGING);
+    for (const auto& tablet : tablets) {
+      state.add_tablets(tablet);
+    }
+    state.set_staging_deadline(staging_deadline_.ToUint64());
+
+    manager_->rpcs().RegisterAndStart(
+        UpdateTransaction(
+            TransactionRpcDeadline(),
+            status_tablet_.get(),
+            manager_->client().get(),
+            &req,
+            std::bind(&Impl::StagingDone, this, _1, _2, transaction)),
+        &staging_handle_);
+  }
+
+  void StagingDone(const Status& status,
+                   HybridTime propagated_hybrid_time,
+                   const YBTransactionPtr& transaction) {
+    VLOG_WITH_PREFIX(1) << "Staged: " << status;
+
+    manager_->UpdateClock(propagated_hybrid_time);
+    manager_->rpcs().Unregister(&staging_handle_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    staging_status_ = status;
+    MaybeFinishStaged(&lock);
+  }
+
+  // Completes commit of staging transaction, when commit is requested, and both staging record
+  // and the last batch are done.
+  void MaybeFinishStaged(std::unique_lock<std::mutex>* lock) {
+    if (state_.load(std::memory_order_acquire) != TransactionState::kCommitted ||
+        !staging_status_ || !staged_flush_status_ || staged_commit_sent_) {
+      return;
+    }
+    staged_commit_sent_ = true;
+    Status status = *staging_status_;
+    if (status.ok()) {
+      status = *staged_flush_status_;
+    }
+    auto transaction = transaction_->shared_from_this();
+    if (!status.ok()) {
+      lock->unlock();
+      commit_callback_(status);
+      SendStagedAbort(transaction);
+      return;
+    }
+
+    // Writes were replicated before the staging deadline, so the status tablet would commit this
+    // transaction even if the following update is lost.
+    staged_commit_reported_ = staged_flush_time_ <= staging_deadline_;
+    // Commit time is not less than hybrid time of the writes, since clock was updated by their
+    // responses, and not greater than the current time. The status tablet commits at max of it
+    // and hybrid time of the staging record. Staging deadline is used only as cutoff for writes.
+    auto commit_time = staged_flush_time_;
+    VLOG_WITH_PREFIX(1) << "Finish staged, reported: " << staged_commit_reported_
+                        << ", commit time: " << commit_time;
+
+    tserver::UpdateTransactionRequestPB req;
+    req.set_tablet_id(status_tablet_->tablet_id());
+    req.set_propagated_hybrid_time(manager_->Now().ToUint64());
+    auto& state = *req.mutable_state();
+    state.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
+    state.set_status(TransactionStatus::COMMITTED);
+    for (const auto& tablet : tablets_) {
+      state.add_tablets(tablet.first);
+    }
+    state.set_commit_hybrid_time(commit_time.ToUint64());
+    lock->unlock();
+
+    if (staged_commit_reported_) {
+      commit_callback_(Status::OK());
+      if (GetAtomicFlag(&FLAGS_transaction_skip_staged_commit_in_tests)) {
+        return;
+      }
+    }
+    manager_->rpcs().RegisterAndStart(
+        UpdateTransaction(
+            TransactionRpcDeadline(),
+            status_tablet_.get(),
+            manager_->client().get(),
+            &req,
+            std::bind(&Impl::CommitDone, this, _1, _2, transaction)),
+        &commit_handle_);
+  }
+
+  // Aborts staging transaction. Abort requested by other transactions just waits until staging
+  // transaction is resolved, so the abort is sent as a status update.
+  void SendStagedAbort(const YBTransactionPtr& transaction) {
+    VLOG_WITH_PREFIX(1) << "Abort staged";
+
+    tserver::UpdateTransactionRequestPB req;
+    req.set_tablet_id(status_tablet_->tablet_id());
+    req.set_propagated_hybrid_time(manager_->Now().ToUint64());
+    auto& state = *req.mutable_state();
+    state.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
+    state.set_status(TransactionStatus::ABORTED);
+
+    manager_->rpcs().RegisterAndStart(
+        UpdateTransaction(
+            TransactionRpcDeadline(),
+            status_tablet_.get(),
+            manager_->client().get(),
+            &req,
+            std::bind(&Impl::StagedAbortDone, this, _1, _2, transaction)),
+        &abort_handle_);
+  }
+
+  void StagedAbortDone(const Status& status,
+                       HybridTime propagated_hybrid_time,
+                       const YBTransactionPtr& transaction) {
+    VLOG_WITH_PREFIX(1) << "Aborted staged: " << status;
+
+    manager_->UpdateClock(propagated_hybrid_time);
+    manager_->rpcs().Unregister(&abort_handle_);
+  }
+
   void AbortDone(const Status& status,
                  const tserver::AbortTransactionResponsePB& response,
                  const YBTransactionPtr& transaction) {
@@ -489,6 +819,14 @@ class YBTransaction::Impl final {
       return;
     }
 
+    if (status == TransactionStatus::PENDING &&
+        GetAtomicFlag(&FLAGS_enable_transaction_heartbeat_batching)) {
+      manager_->SendHeartbeat(
+          status_tablet_, metadata_.transaction_id,
+          std::bind(&Impl::HeartbeatDone, this, _1, _2, status, transaction));
+      return;
+    }
+
     tserver::UpdateTransactionRequestPB req;
     req.set_tablet_id(status_tablet_->tablet_id());
     req.set_propagated_hybrid_time(manager_->Now().ToUint64());
@@ -542,6 +880,33 @@ class YBTransaction::Impl final {
     }
   }
 
+  // Returns status of the batch, that also fails when any of its ops failed.
+  static Status BatchResult(const internal::InFlightOps& ops, const Status& status) {
+    if (!status.ok()) {
+      return status;
+    }
+    for (const auto& op : ops) {
+      if (!op->yb_op->succeeded()) {
+        return STATUS_FORMAT(IllegalState, "Write failed: $0", op->ToString());
+      }
+    }
+    return Status::OK();
+  }
+
+  void SingleShardFlushed(const internal::InFlightOps& ops,
+                          const Status& status,
+                          std::unique_lock<std::mutex>* lock) {
+    Status result = BatchResult(ops, status);
+    VLOG_WITH_PREFIX(1) << "Single shard flushed: " << result;
+    single_shard_status_ = result;
+    if (state_.load(std::memory_order_acquire) != TransactionState::kCommitted) {
+      return;
+    }
+    // Commit was requested before the write was flushed.
+    lock->unlock();
+    commit_callback_(result);
+  }
+
   void SetError(const Status& status) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (error_.ok()) {
@@ -585,12 +950,33 @@ class YBTransaction::Impl final {
   std::atomic<TransactionState> state_{TransactionState::kRunning};
   // Transaction is successfully initialized and ready to process intents.
   const bool child_;
+  // Transaction does not write and is not registered at status tablet.
+  const bool read_only_;
   bool ready_ = false;
+  // Caller will commit this transaction right after the next flush.
+  bool commit_after_next_flush_ = false;
+  // The only batch of this transaction was sent as a non-transactional single shard write.
+  bool single_shard_ = false;
+  // Result of the single shard write, not set while it is in flight.
+  boost::optional<Status> single_shard_status_;
+  // The last batch of this transaction was sent together with staging record.
+  bool staging_ = false;
+  // Writes of the last batch should be replicated before this time, to report commit before
+  // the status record is updated.
+  HybridTime staging_deadline_;
+  // Results of the staging record and of the last batch, not set while they are in flight.
+  boost::optional<Status> staging_status_;
+  boost::optional<Status> staged_flush_status_;
+  HybridTime staged_flush_time_;
+  bool staged_commit_sent_ = false;
+  // Commit was reported to the caller before the status record was updated.
+  bool staged_commit_reported_ = false;
   CommitCallback commit_callback_;
   Status error_;
   rpc::Rpcs::Handle heartbeat_handle_;
   rpc::Rpcs::Handle commit_handle_;
   rpc::Rpcs::Handle abort_handle_;
+  rpc::Rpcs::Handle staging_handle_;
 
   struct TabletState {
     bool has_parameters = false;
@@ -618,8 +1004,9 @@ class YBTransaction::Impl final {
 };
 
 YBTransaction::YBTransaction(TransactionManager* manager,
-                             IsolationLevel isolation)
-    : impl_(new Impl(manager, this, isolation)) {
+                             IsolationLevel isolation,
+                             ReadOnlyTransaction read_only)
+    : impl_(new Impl(manager, this, isolation, read_only)) {
 }
 
 YBTransaction::YBTransaction(TransactionManager* manager, ChildTransactionData data)
@@ -667,6 +1054,14 @@ bool YBTransaction::IsRestartRequired() const {
   return impl_->IsRestartRequired();
 }
 
+bool YBTransaction::read_only() const {
+  return impl_->read_only();
+}
+
+void YBTransaction::ExpectCommitAfterNextFlush() {
+  impl_->ExpectCommitAfterNextFlush();
+}
+
 YBTransactionPtr YBTransaction::CreateRestartedTransaction() {
   auto result = impl_->CreateSimilarTransaction();
   impl_->SetupRestart(result->impl_.get());
@@ -29,6 +29,7 @@
 #include "yb/client/client_fwd.h"
 
 #include "yb/util/status.h"
+#include "yb/util/strongly_typed_bool.h"
 
 namespace yb {
 
@@ -41,6 +42,8 @@ typedef std::function<void(const Status&)> Waiter;
 typedef std::function<void(const Status&)> CommitCallback;
 typedef std::function<void(const Result<ChildTransactionDataPB>&)> PrepareChildCallback;
 
+YB_STRONGLY_TYPED_BOOL(ReadOnlyTransaction);
+
 struct ChildTransactionData {
   TransactionMetadata metadata;
   ReadHybridTime read_time;
@@ -54,7 +57,10 @@ struct ChildTransactionData {
 // to indicate that this session will send commands related to this transaction.
 class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
  public:
-  YBTransaction(TransactionManager* manager, IsolationLevel isolation);
+  // Read only snapshot isolation transaction only fixes read point. It does not register at
+  // status tablet and does not send heartbeats, so it cannot write.
+  YBTransaction(TransactionManager* manager, IsolationLevel isolation,
+                ReadOnlyTransaction read_only = ReadOnlyTransaction::kFalse);
 
   // Creates "child" transaction.
   // Child transaction shares same metadata as parent transaction, so all writes are done
@@ -93,6 +99,14 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
 
   bool IsRestartRequired() const;
 
+  bool read_only() const;
+
+  // Notifies transaction that it will be committed right after the next flush, and nothing else
+  // will be flushed in its context. If this flush is the first one and contains only unconditional
+  // writes to a single tablet, it is sent as a single non-transactional write, and the
+  // transaction does not use status tablet at all.
+  void ExpectCommitAfterNextFlush();
+
   YBTransactionPtr CreateRestartedTransaction();
 
   // Prepares child data, so child transaction could be started in another server.
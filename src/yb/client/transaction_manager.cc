@@ -15,19 +15,65 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/tserver/tserver_service.pb.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
 #include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 
 #include "yb/client/client.h"
+#include "yb/client/meta_cache.h"
+#include "yb/client/tablet_rpc.h"
+
+#include "yb/master/master.pb.h"
+
+using namespace std::literals;
 
 DEFINE_uint64(transaction_table_num_tablets, 24,
               "Automatically create transaction table with specified number of tablets if missing. "
               "0 to disable.");
 
+DEFINE_uint64(transaction_table_num_tablets_per_tserver, 0,
+              "When creating transaction table, use at least the specified number of tablets per "
+              "live tablet server, so the number of status tablets grows with the cluster. "
+              "0 to use only transaction_table_num_tablets.");
+TAG_FLAG(transaction_table_num_tablets_per_tserver, advanced);
+
+DEFINE_bool(prefer_local_placement_transaction_status_tablets, true,
+            "When there is no status tablet on the local tablet server, pick status tablet whose "
+            "leader is in the same zone, or else region, as the client.");
+TAG_FLAG(prefer_local_placement_transaction_status_tablets, advanced);
+TAG_FLAG(prefer_local_placement_transaction_status_tablets, runtime);
+
+DEFINE_int32(transaction_status_tablet_leaders_refresh_interval_ms, 60000,
+             "Interval of refreshing leaders of transaction status tablets, that are used to pick "
+             "status tablets with local placement leaders. 0 to disable refresh.");
+TAG_FLAG(transaction_status_tablet_leaders_refresh_interval_ms, advanced);
+TAG_FLAG(transaction_status_tablet_leaders_refresh_interval_ms, runtime);
+
+DEFINE_int32(transaction_heartbeat_batch_window_ms, 10,
+             "Max time that a transaction heartbeat waits for heartbeats of other transactions "
+             "to the same status tablet, before being sent.");
+TAG_FLAG(transaction_heartbeat_batch_window_ms, advanced);
+TAG_FLAG(transaction_heartbeat_batch_window_ms, runtime);
+
+DEFINE_int32(transaction_heartbeat_batch_size, 1000,
+             "Max number of transaction heartbeats sent in a single RPC.");
+TAG_FLAG(transaction_heartbeat_batch_size, advanced);
+TAG_FLAG(transaction_heartbeat_batch_size, runtime);
+
 namespace yb {
 namespace client {
 
@@ -41,12 +87,69 @@ const YBTableName kTransactionTableName("system", "transactions");
 // Resolved - final state, when all tablets are resolved and written to cache.
 YB_DEFINE_ENUM(TransactionTableStatus, (kIdle)(kExists)(kUpdating)(kResolved));
 
-void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>& tablets,
+struct LocalPlacementTablets {
+  // Tablets whose leader was in the zone of the client, when leaders were fetched.
+  std::vector<TabletId> zone;
+  // Tablets whose leader was in the region of the client, when leaders were fetched.
+  std::vector<TabletId> region;
+};
+
+typedef std::shared_ptr<const LocalPlacementTablets> LocalPlacementTabletsPtr;
+
+struct TransactionTableState {
+  explicit TransactionTableState(LocalTabletFilter filter = LocalTabletFilter())
+      : local_tablet_filter(std::move(filter)) {}
+
+  LocalTabletFilter local_tablet_filter;
+  std::atomic<TransactionTableStatus> status{TransactionTableStatus::kIdle};
+  std::vector<TabletId> tablets;
+
+  LocalPlacementTabletsPtr local_placement_tablets() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return local_placement_tablets_;
+  }
+
+  void SetLocalPlacementTablets(LocalPlacementTabletsPtr tablets) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    local_placement_tablets_ = std::move(tablets);
+    refreshing_ = false;
+    next_refresh_ = CoarseMonoClock::Now() +
+                    FLAGS_transaction_status_tablet_leaders_refresh_interval_ms * 1ms;
+  }
+
+  // Returns true when leaders of status tablets should be refreshed, only one caller is asked to
+  // do it at a time. Caller should invoke SetLocalPlacementTablets or RefreshFailed after that.
+  bool StartRefresh() {
+    if (FLAGS_transaction_status_tablet_leaders_refresh_interval_ms <= 0) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (refreshing_ || CoarseMonoClock::Now() < next_refresh_) {
+      return false;
+    }
+    refreshing_ = true;
+    return true;
+  }
+
+  void RefreshFailed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshing_ = false;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  LocalPlacementTabletsPtr local_placement_tablets_;
+  bool refreshing_ = false;
+  CoarseMonoClock::TimePoint next_refresh_;
+};
+
+void InvokeCallback(const TransactionTableState& table_state,
                     const PickStatusTabletCallback& callback) {
+  const auto& filter = table_state.local_tablet_filter;
   if (filter) {
     std::vector<const TabletId*> ids;
-    ids.reserve(tablets.size());
-    for (const auto& id : tablets) {
+    ids.reserve(table_state.tablets.size());
+    for (const auto& id : table_state.tablets) {
       ids.push_back(&id);
     }
     filter(&ids);
@@ -54,18 +157,54 @@ void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>
       callback(*RandomElement(ids));
       return;
     }
-    LOG(WARNING) << "No local transaction status tablet";
+    YB_LOG_EVERY_N_SECS(WARNING, 10) << "No local transaction status tablet";
   }
-  callback(RandomElement(tablets));
+  auto local_placement_tablets = table_state.local_placement_tablets();
+  if (FLAGS_prefer_local_placement_transaction_status_tablets && local_placement_tablets) {
+    if (!local_placement_tablets->zone.empty()) {
+      callback(RandomElement(local_placement_tablets->zone));
+      return;
+    }
+    if (!local_placement_tablets->region.empty()) {
+      callback(RandomElement(local_placement_tablets->region));
+      return;
+    }
+  }
+  callback(RandomElement(table_state.tablets));
 }
 
-struct TransactionTableState {
-  LocalTabletFilter local_tablet_filter;
-  std::atomic<TransactionTableStatus> status{TransactionTableStatus::kIdle};
-  std::vector<TabletId> tablets;
-};
+// Returns zone and region local tablets, using leaders from locations.
+LocalPlacementTabletsPtr MakeLocalPlacementTablets(
+    const CloudInfoPB& cloud_info, const std::vector<master::TabletLocationsPB>& locations) {
+  auto result = std::make_shared<LocalPlacementTablets>();
+  for (const auto& location : locations) {
+    for (const auto& replica : location.replicas()) {
+      if (replica.role() != consensus::RaftPeerPB::LEADER) {
+        continue;
+      }
+      const auto& leader_cloud_info = replica.ts_info().cloud_info();
+      if (!cloud_info.has_placement_region() ||
+          leader_cloud_info.placement_cloud() != cloud_info.placement_cloud() ||
+          leader_cloud_info.placement_region() != cloud_info.placement_region()) {
+        break;
+      }
+      if (cloud_info.has_placement_zone() &&
+          leader_cloud_info.placement_zone() == cloud_info.placement_zone()) {
+        result->zone.push_back(location.tablet_id());
+      } else {
+        result->region.push_back(location.tablet_id());
+      }
+      break;
+    }
+  }
+  VLOG(1) << "Status tablets: " << locations.size()
+          << ", zone local: " << result->zone.size()
+          << ", region local: " << result->region.size();
+  return result;
+}
 
 // Picks status tablet for transaction.
+// When status tablets are already resolved, this task is used to refresh their leaders.
 class PickStatusTabletTask {
  public:
   PickStatusTabletTask(const YBClientPtr& client,
@@ -84,7 +223,17 @@ class PickStatusTabletTask {
 
     // TODO(dtxn) async
     std::vector<TabletId> tablets;
-    status = client_->GetTablets(kTransactionTableName, 0, &tablets, /* ranges */ nullptr);
+    std::vector<master::TabletLocationsPB> locations;
+    status = client_->GetTablets(
+        kTransactionTableName, 0, &tablets, /* ranges */ nullptr, &locations);
+    bool resolved =
+        table_state_->status.load(std::memory_order_acquire) == TransactionTableStatus::kResolved;
+    if (resolved && (!status.ok() || tablets.empty())) {
+      LOG(WARNING) << "Failed to refresh status tablet leaders: " << status;
+      table_state_->RefreshFailed();
+      InvokeCallback(*table_state_, callback_);
+      return;
+    }
     if (!status.ok()) {
       callback_(status);
       return;
@@ -97,10 +246,25 @@ class PickStatusTabletTask {
     if (table_state_->status.compare_exchange_strong(
         expected, TransactionTableStatus::kUpdating, std::memory_order_acq_rel)) {
       table_state_->tablets = tablets;
+      table_state_->SetLocalPlacementTablets(
+          MakeLocalPlacementTablets(client_->cloud_info(), locations));
       table_state_->status.store(TransactionTableStatus::kResolved, std::memory_order_release);
+      InvokeCallback(*table_state_, callback_);
+      return;
+    }
+    if (resolved) {
+      // Set of status tablets does not change, only their leaders.
+      table_state_->SetLocalPlacementTablets(
+          MakeLocalPlacementTablets(client_->cloud_info(), locations));
+      InvokeCallback(*table_state_, callback_);
+      return;
     }
 
-    InvokeCallback(table_state_->local_tablet_filter, tablets, callback_);
+    TransactionTableState table_state(table_state_->local_tablet_filter);
+    table_state.tablets = std::move(tablets);
+    table_state.SetLocalPlacementTablets(
+        MakeLocalPlacementTablets(client_->cloud_info(), locations));
+    InvokeCallback(table_state, callback_);
   }
 
   void Done(const Status& status) {
@@ -128,6 +292,7 @@ class PickStatusTabletTask {
       LOG(WARNING) << "Failed to open transaction table: " << status.ToString();
       auto tablets = FLAGS_transaction_table_num_tablets;
       if (tablets > 0 && status.IsNotFound()) {
+        tablets = std::max(tablets, NumTabletsForLiveTabletServers());
         status = client_->CreateNamespaceIfNotExists(kTransactionTableName.namespace_name());
         if (status.ok()) {
           std::unique_ptr<client::YBTableCreator> table_creator(client_->NewTableCreator());
@@ -150,6 +315,20 @@ class PickStatusTabletTask {
     return status;
   }
 
+  uint64_t NumTabletsForLiveTabletServers() {
+    const auto per_tserver = FLAGS_transaction_table_num_tablets_per_tserver;
+    if (per_tserver == 0) {
+      return 0;
+    }
+    std::vector<std::unique_ptr<YBTabletServer>> tablet_servers;
+    auto status = client_->ListTabletServers(&tablet_servers);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to list tablet servers: " << status;
+      return 0;
+    }
+    return per_tserver * tablet_servers.size();
+  }
+
   YBClientPtr client_;
   TransactionTableState* table_state_;
   PickStatusTabletCallback callback_;
@@ -163,7 +342,7 @@ class InvokeCallbackTask {
   }
 
   void Run() {
-    InvokeCallback(table_state_->local_tablet_filter, table_state_->tablets, callback_);
+    InvokeCallback(*table_state_, callback_);
   }
 
   void Done(const Status& status) {
@@ -181,6 +360,148 @@ class InvokeCallbackTask {
 constexpr size_t kQueueLimit = 150;
 constexpr size_t kMaxWorkers = 50;
 
+// Combines heartbeats of transactions with the same status tablet into BatchedHeartbeat RPCs.
+//
+// Heartbeats are accumulated for at most transaction_heartbeat_batch_window_ms, or until
+// transaction_heartbeat_batch_size of them are collected for the same tablet.
+class HeartbeatBatcher : public std::enable_shared_from_this<HeartbeatBatcher> {
+ public:
+  HeartbeatBatcher(const YBClientPtr& client, const scoped_refptr<ClockBase>& clock)
+      : client_(client), clock_(clock) {
+  }
+
+  void Add(const internal::RemoteTabletPtr& status_tablet,
+           const TransactionId& transaction_id,
+           UpdateTransactionCallback callback) {
+    std::vector<Entry> entries;
+    bool schedule_flush = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& queue = pending_[status_tablet->tablet_id()];
+      queue.tablet = status_tablet;
+      queue.entries.push_back(Entry{transaction_id, std::move(callback)});
+      if (queue.entries.size() >= static_cast<size_t>(FLAGS_transaction_heartbeat_batch_size)) {
+        entries.swap(queue.entries);
+      } else if (!flush_scheduled_) {
+        flush_scheduled_ = true;
+        schedule_flush = true;
+      }
+    }
+
+    if (!entries.empty()) {
+      SendBatch(status_tablet, std::move(entries));
+    } else if (schedule_flush) {
+      std::weak_ptr<HeartbeatBatcher> weak_self = shared_from_this();
+      client_->messenger()->scheduler().Schedule(
+          [weak_self](const Status& status) {
+            auto self = weak_self.lock();
+            if (self) {
+              self->ScheduledFlush(status);
+            }
+          },
+          FLAGS_transaction_heartbeat_batch_window_ms * 1ms);
+    }
+  }
+
+  void Shutdown() {
+    rpcs_.Shutdown();
+  }
+
+ private:
+  struct Entry {
+    TransactionId transaction_id;
+    UpdateTransactionCallback callback;
+  };
+
+  struct TabletQueue {
+    internal::RemoteTabletPtr tablet;
+    std::vector<Entry> entries;
+  };
+
+  void ScheduledFlush(const Status& status) {
+    std::unordered_map<TabletId, TabletQueue> pending;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      flush_scheduled_ = false;
+      pending.swap(pending_);
+    }
+
+    if (!status.ok()) {
+      // Scheduler is shutting down, so heartbeats are dropped. Failing them would make
+      // transactions resend them.
+      VLOG(1) << "Dropping heartbeats: " << status;
+      return;
+    }
+
+    for (auto& p : pending) {
+      if (!p.second.entries.empty()) {
+        SendBatch(p.second.tablet, std::move(p.second.entries));
+      }
+    }
+  }
+
+  void SendBatch(const internal::RemoteTabletPtr& tablet, std::vector<Entry> entries) {
+    tserver::UpdateTransactionRequestPB req;
+    req.set_tablet_id(tablet->tablet_id());
+    req.set_propagated_hybrid_time(clock_->Now().ToUint64());
+    auto& state = *req.mutable_state();
+    state.set_status(TransactionStatus::PENDING);
+    state.mutable_heartbeat_transaction_ids()->Reserve(entries.size());
+    for (const auto& entry : entries) {
+      state.add_heartbeat_transaction_ids(entry.transaction_id.begin(),
+                                          entry.transaction_id.size());
+    }
+
+    auto handle = rpcs_.Prepare();
+    if (handle == rpcs_.InvalidHandle()) {
+      // Transaction manager is shutting down, so heartbeats are dropped.
+      return;
+    }
+    auto batch = std::make_shared<std::vector<Entry>>(std::move(entries));
+    *handle = BatchedHeartbeat(
+        TransactionRpcDeadline(),
+        tablet.get(),
+        client_.get(),
+        &req,
+        [self = shared_from_this(), handle, batch](
+            const Status& status, const tserver::UpdateTransactionResponsePB& response) {
+          self->rpcs_.Unregister(handle);
+          self->Finished(status, response, batch.get());
+        });
+    (**handle).SendRpc();
+  }
+
+  void Finished(const Status& status,
+                const tserver::UpdateTransactionResponsePB& response,
+                std::vector<Entry>* entries) {
+    auto propagated_hybrid_time = internal::GetPropagatedHybridTime(response);
+    std::unordered_set<TransactionId, TransactionIdHash> expired;
+    if (status.ok()) {
+      for (const auto& id : response.expired_transaction_ids()) {
+        auto decoded_id = FullyDecodeTransactionId(id);
+        if (decoded_id.ok()) {
+          expired.insert(*decoded_id);
+        }
+      }
+    }
+    for (auto& entry : *entries) {
+      if (status.ok() && expired.count(entry.transaction_id)) {
+        entry.callback(STATUS(Expired, "Transaction expired"), propagated_hybrid_time);
+      } else {
+        entry.callback(status, propagated_hybrid_time);
+      }
+    }
+  }
+
+  YBClientPtr client_;
+  scoped_refptr<ClockBase> clock_;
+  rpc::Rpcs rpcs_;
+
+  std::mutex mutex_;
+  std::unordered_map<TabletId, TabletQueue> pending_;
+  bool flush_scheduled_ = false;
+};
+
 } // namespace
 
 class TransactionManager::Impl {
@@ -192,14 +513,21 @@ class TransactionManager::Impl {
         table_state_{std::move(local_tablet_filter)},
         thread_pool_("TransactionManager", kQueueLimit, kMaxWorkers),
         tasks_pool_(kQueueLimit),
-        invoke_callback_tasks_(kQueueLimit) {
+        invoke_callback_tasks_(kQueueLimit),
+        heartbeat_batcher_(std::make_shared<HeartbeatBatcher>(client, clock)) {
     CHECK(clock);
   }
 
   void PickStatusTablet(PickStatusTabletCallback callback) {
     if (table_state_.status.load(std::memory_order_acquire) == TransactionTableStatus::kResolved) {
+      if (table_state_.StartRefresh()) {
+        if (tasks_pool_.Enqueue(&thread_pool_, client_, &table_state_, callback)) {
+          return;
+        }
+        table_state_.RefreshFailed();
+      }
       if (ThreadRestrictions::IsWaitAllowed()) {
-        InvokeCallback(table_state_.local_tablet_filter, table_state_.tablets, callback);
+        InvokeCallback(table_state_, callback);
       } else if (!invoke_callback_tasks_.Enqueue(&thread_pool_, &table_state_, callback)) {
         callback(STATUS_FORMAT(ServiceUnavailable, "Invoke callback queue overflow, exists: $0",
                                invoke_callback_tasks_.size()));
@@ -235,7 +563,14 @@ class TransactionManager::Impl {
     clock_->Update(time);
   }
 
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& transaction_id,
+                     UpdateTransactionCallback callback) {
+    heartbeat_batcher_->Add(status_tablet, transaction_id, std::move(callback));
+  }
+
   void Shutdown() {
+    heartbeat_batcher_->Shutdown();
     rpcs_.Shutdown();
   }
 
@@ -248,6 +583,7 @@ class TransactionManager::Impl {
   yb::rpc::TasksPool<PickStatusTabletTask> tasks_pool_;
   yb::rpc::TasksPool<InvokeCallbackTask> invoke_callback_tasks_;
   yb::rpc::Rpcs rpcs_;
+  std::shared_ptr<HeartbeatBatcher> heartbeat_batcher_;
 };
 
 TransactionManager::TransactionManager(
@@ -287,5 +623,11 @@ void TransactionManager::UpdateClock(HybridTime time) {
   impl_->UpdateClock(time);
 }
 
+void TransactionManager::SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                                       const TransactionId& transaction_id,
+                                       UpdateTransactionCallback callback) {
+  impl_->SendHeartbeat(status_tablet, transaction_id, std::move(callback));
+}
+
 } // namespace client
 } // namespace yb
@@ -20,9 +20,11 @@
 #include <memory>
 
 #include "yb/client/client_fwd.h"
+#include "yb/client/transaction_rpc.h"
 
 #include "yb/common/clock.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
@@ -51,6 +53,13 @@ class TransactionManager {
 
   void UpdateClock(HybridTime time);
 
+  // Sends PENDING heartbeat of specified transaction to its status tablet. Heartbeats of
+  // transactions that have the same status tablet are combined into a single RPC.
+  // Callback receives Expired status for transactions that are not alive anymore.
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& transaction_id,
+                     UpdateTransactionCallback callback);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
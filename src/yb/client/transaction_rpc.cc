@@ -153,6 +153,52 @@ struct UpdateTransactionTraits {
 
 constexpr const char* UpdateTransactionTraits::kName;
 
+struct BatchedHeartbeatTraits {
+  static constexpr const char* kName = "BatchedHeartbeat";
+
+  typedef tserver::UpdateTransactionRequestPB Request;
+  typedef tserver::UpdateTransactionResponsePB Response;
+  typedef BatchedHeartbeatCallback Callback;
+
+  static void CallCallback(
+      const Callback& callback, const Status& status, const Response& response) {
+    callback(status, response);
+  }
+
+  static void InvokeAsync(tserver::TabletServerServiceProxy* proxy,
+                          const Request& request,
+                          Response* response,
+                          rpc::RpcController* controller,
+                          rpc::ResponseCallback callback) {
+    proxy->UpdateTransactionAsync(request, response, controller, std::move(callback));
+  }
+};
+
+constexpr const char* BatchedHeartbeatTraits::kName;
+
+struct CheckStagedWritesTraits {
+  static constexpr const char* kName = "CheckStagedWrites";
+
+  typedef tserver::UpdateTransactionRequestPB Request;
+  typedef tserver::UpdateTransactionResponsePB Response;
+  typedef CheckStagedWritesCallback Callback;
+
+  static void CallCallback(
+      const Callback& callback, const Status& status, const Response& response) {
+    callback(status, response);
+  }
+
+  static void InvokeAsync(tserver::TabletServerServiceProxy* proxy,
+                          const Request& request,
+                          Response* response,
+                          rpc::RpcController* controller,
+                          rpc::ResponseCallback callback) {
+    proxy->UpdateTransactionAsync(request, response, controller, std::move(callback));
+  }
+};
+
+constexpr const char* CheckStagedWritesTraits::kName;
+
 struct GetTransactionStatusTraits {
   static constexpr const char* kName = "GetTransactionStatus";
 
@@ -211,6 +257,26 @@ rpc::RpcCommandPtr UpdateTransaction(
       deadline, tablet, client, req, std::move(callback));
 }
 
+rpc::RpcCommandPtr BatchedHeartbeat(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    BatchedHeartbeatCallback callback) {
+  return std::make_shared<TransactionRpc<BatchedHeartbeatTraits>>(
+      deadline, tablet, client, req, std::move(callback));
+}
+
+rpc::RpcCommandPtr CheckStagedWrites(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    CheckStagedWritesCallback callback) {
+  return std::make_shared<TransactionRpc<CheckStagedWritesTraits>>(
+      deadline, tablet, client, req, std::move(callback));
+}
+
 rpc::RpcCommandPtr GetTransactionStatus(
     const MonoTime& deadline,
     internal::RemoteTablet* tablet,
@@ -36,6 +36,7 @@ class AbortTransactionResponsePB;
 class GetTransactionStatusRequestPB;
 class GetTransactionStatusResponsePB;
 class UpdateTransactionRequestPB;
+class UpdateTransactionResponsePB;
 
 }
 
@@ -58,6 +59,28 @@ MUST_USE_RESULT rpc::RpcCommandPtr UpdateTransaction(
     tserver::UpdateTransactionRequestPB* req,
     UpdateTransactionCallback callback);
 
+typedef std::function<void(const Status&, const tserver::UpdateTransactionResponsePB&)>
+    BatchedHeartbeatCallback;
+
+// Sends heartbeat of multiple transactions, listed in heartbeat_transaction_ids of request state.
+MUST_USE_RESULT rpc::RpcCommandPtr BatchedHeartbeat(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    BatchedHeartbeatCallback callback);
+
+typedef std::function<void(const Status&, const tserver::UpdateTransactionResponsePB&)>
+    CheckStagedWritesCallback;
+
+// Checks that writes of staging transaction are present in tablet, specified in request.
+MUST_USE_RESULT rpc::RpcCommandPtr CheckStagedWrites(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    CheckStagedWritesCallback callback);
+
 typedef std::function<void(const Status&, const tserver::GetTransactionStatusResponsePB&)>
     GetTransactionStatusCallback;
 
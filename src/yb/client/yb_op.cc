@@ -40,7 +40,10 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/common/redis_protocol.pb.h"
 #include "yb/common/ql_protocol.pb.h"
+#include "yb/common/ql_columnar.h"
 #include "yb/common/ql_rowblock.h"
+#include "yb/common/ql_value.h"
+#include "yb/util/yb_partition.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
 
 namespace yb {
@@ -194,11 +197,23 @@ YBqlWriteOp *YBqlWriteOp::NewDelete(const std::shared_ptr<YBTable>& table) {
   return NewYBqlWriteOp(table, QLWriteRequestPB::QL_STMT_DELETE);
 }
 
+size_t YBqlWriteOp::space_used_by_request() const {
+  return ql_write_request_->SpaceUsedLong();
+}
+
 std::string YBqlWriteOp::ToString() const {
+  if (ql_write_request_->has_row_block()) {
+    return Format("QL_WRITE row block of $0 rows", ql_write_request_->row_block_num_rows());
+  }
   return "QL_WRITE " + ql_write_request_->ShortDebugString();
 }
 
 Status YBqlWriteOp::GetPartitionKey(string* partition_key) const {
+  if (ql_write_request_->has_row_block()) {
+    // All rows of the block belong to the same tablet, so the first row is used.
+    *partition_key = PartitionSchema::EncodeMultiColumnHashValue(ql_write_request_->hash_code());
+    return Status::OK();
+  }
   return table_->partition_schema().EncodeKey(ql_write_request_->hashed_column_values(),
                                               partition_key);
 }
@@ -211,6 +226,92 @@ uint16_t YBqlWriteOp::GetHashCode() const {
   return ql_write_request_->hash_code();
 }
 
+// YBqlRowBlockWriter -----------------------------------------------------------------
+
+YBqlRowBlockWriter::YBqlRowBlockWriter(const std::shared_ptr<YBTable>& table,
+                                       std::vector<int32_t> column_ids)
+    : table_(table), column_ids_(std::move(column_ids)) {
+}
+
+YBqlRowBlockWriter::~YBqlRowBlockWriter() {}
+
+Status YBqlRowBlockWriter::Init() {
+  const Schema& schema = table_->InternalSchema();
+  if (!table_->index_map().empty()) {
+    return STATUS(NotSupported, "Row block could not be used for table with indexes");
+  }
+  num_hash_key_columns_ = schema.num_hash_key_columns();
+  num_key_columns_ = schema.num_key_columns();
+  if (num_hash_key_columns_ == 0) {
+    return STATUS(NotSupported, "Row block could be used only for hash partitioned tables");
+  }
+  types_.clear();
+  types_.reserve(num_key_columns_ + column_ids_.size());
+  for (size_t i = 0; i < num_key_columns_; i++) {
+    types_.push_back(schema.column(i).type());
+  }
+  for (const auto column_id : column_ids_) {
+    const auto column = schema.column_by_id(ColumnId(column_id));
+    RETURN_NOT_OK(column);
+    if (column->is_static() || column->type()->HasComplexValues() ||
+        schema.is_key_column(ColumnId(column_id))) {
+      return STATUS_FORMAT(InvalidArgument, "Column $0 could not be written by row block",
+                           column->name());
+    }
+    types_.push_back(column->type());
+  }
+  return Status::OK();
+}
+
+Status YBqlRowBlockWriter::AddRow(const std::vector<QLValue>& values) {
+  if (values.size() != types_.size()) {
+    return STATUS_FORMAT(InvalidArgument, "Wrong number of values: $0, expected: $1",
+                         values.size(), types_.size());
+  }
+  hash_key_.clear();
+  for (size_t i = 0; i < num_key_columns_; i++) {
+    if (values[i].IsNull()) {
+      return STATUS_FORMAT(InvalidArgument, "Null value for key column $0", i);
+    }
+    if (i < num_hash_key_columns_) {
+      AppendToKey(values[i].value(), &hash_key_);
+    }
+  }
+  const uint16_t hash_code = YBPartition::HashColumnCompoundValue(hash_key_);
+
+  auto& block = blocks_[table_->FindPartitionStart(
+      PartitionSchema::EncodeMultiColumnHashValue(hash_code))];
+  if (!block.op) {
+    block.op.reset(table_->NewQLInsert());
+    block.op->mutable_request()->set_hash_code(hash_code);
+  }
+  uint8_t encoded_hash_code[sizeof(uint16_t)];
+  NetworkByteOrder::Store16(encoded_hash_code, hash_code);
+  block.data.append(encoded_hash_code, sizeof(encoded_hash_code));
+  for (size_t i = 0; i != values.size(); ++i) {
+    values[i].Serialize(types_[i], YQL_CLIENT_CQL, &block.data);
+  }
+  ++block.num_rows;
+  return Status::OK();
+}
+
+std::vector<YBqlWriteOpPtr> YBqlRowBlockWriter::TakeOps() {
+  std::vector<YBqlWriteOpPtr> result;
+  result.reserve(blocks_.size());
+  for (auto& partition_and_block : blocks_) {
+    auto& block = partition_and_block.second;
+    auto* req = block.op->mutable_request();
+    req->set_row_block(block.data.data(), block.data.size());
+    req->set_row_block_num_rows(block.num_rows);
+    for (const auto column_id : column_ids_) {
+      req->add_row_block_column_ids(column_id);
+    }
+    result.push_back(std::move(block.op));
+  }
+  blocks_.clear();
+  return result;
+}
+
 // YBqlWriteOp::HashHash/Equal ---------------------------------------------------------------
 size_t YBqlWriteOp::HashKeyComparator::operator() (const YBqlWriteOpPtr& op) const {
   size_t hash = 0;
@@ -306,6 +407,10 @@ YBqlReadOp *YBqlReadOp::NewSelect(const shared_ptr<YBTable>& table) {
   return op;
 }
 
+size_t YBqlReadOp::space_used_by_request() const {
+  return ql_read_request_->SpaceUsedLong();
+}
+
 std::string YBqlReadOp::ToString() const {
   return "QL_READ " + ql_read_request_->DebugString();
 }
@@ -390,7 +495,11 @@ Result<QLRowBlock> YBqlReadOp::MakeRowBlock() const {
   QLRowBlock result(schema);
   Slice data(rows_data_);
   if (!data.empty()) {
-    RETURN_NOT_OK(result.Deserialize(request().client(), &data));
+    if (request().rows_data_format() == QL_ROWS_DATA_COLUMNAR) {
+      RETURN_NOT_OK(DeserializeColumnarRowsData(data, &result));
+    } else {
+      RETURN_NOT_OK(result.Deserialize(request().client(), &data));
+    }
   }
   return result;
 }
@@ -438,6 +547,10 @@ YBPgsqlWriteOp *YBPgsqlWriteOp::NewDelete(const std::shared_ptr<YBTable>& table)
   return NewYBPgsqlWriteOp(table, PgsqlWriteRequestPB::PGSQL_DELETE);
 }
 
+size_t YBPgsqlWriteOp::space_used_by_request() const {
+  return write_request_->SpaceUsedLong();
+}
+
 std::string YBPgsqlWriteOp::ToString() const {
   return "PGSQL_WRITE " + write_request_->ShortDebugString();
 }
@@ -471,6 +584,10 @@ YBPgsqlReadOp *YBPgsqlReadOp::NewSelect(const shared_ptr<YBTable>& table) {
   return op;
 }
 
+size_t YBPgsqlReadOp::space_used_by_request() const {
+  return read_request_->SpaceUsedLong();
+}
+
 std::string YBPgsqlReadOp::ToString() const {
   return "PGSQL_READ " + read_request_->DebugString();
 }
@@ -34,6 +34,8 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "yb/client/client_fwd.h"
 
@@ -41,6 +43,8 @@
 #include "yb/common/partition.h"
 #include "yb/common/read_hybrid_time.h"
 
+#include "yb/util/faststring.h"
+
 namespace yb {
 
 class RedisWriteRequestPB;
@@ -51,6 +55,8 @@ class QLWriteRequestPB;
 class QLReadRequestPB;
 class QLResponsePB;
 class QLRowBlock;
+class QLType;
+class QLValue;
 
 namespace client {
 
@@ -97,6 +103,9 @@ class YBOperation {
   virtual bool read_only() = 0;
   virtual bool succeeded() = 0;
 
+  // Estimated memory used by the request, when it is handled by the tablet server.
+  virtual size_t space_used_by_request() const = 0;
+
   virtual void SetHashCode(uint16_t hash_code) = 0;
 
   const scoped_refptr<internal::RemoteTablet>& tablet() const {
@@ -131,7 +140,6 @@ class YBRedisOp : public YBOperation {
   virtual ~YBRedisOp();
 
   bool has_response() { return redis_response_ ? true : false; }
-  virtual size_t space_used_by_request() const = 0;
 
   const RedisResponsePB& response() const;
 
@@ -208,12 +216,21 @@ class YBRedisReadOp : public YBRedisOp {
 
   CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  const YBConsistencyLevel yb_consistency_level() {
+    return yb_consistency_level_;
+  }
+
+  void set_yb_consistency_level(const YBConsistencyLevel yb_consistency_level) {
+    yb_consistency_level_ = yb_consistency_level;
+  }
+
  protected:
   virtual Type type() const override { return REDIS_READ; }
 
  private:
   friend class YBTable;
   std::unique_ptr<RedisReadRequestPB> redis_read_request_;
+  YBConsistencyLevel yb_consistency_level_ = YBConsistencyLevel::STRONG;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -255,6 +272,8 @@ class YBqlWriteOp : public YBqlOp {
 
   QLWriteRequestPB* mutable_request() { return ql_write_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   std::string ToString() const override;
 
   bool read_only() override { return false; };
@@ -291,6 +310,46 @@ class YBqlWriteOp : public YBqlOp {
   std::unique_ptr<QLWriteRequestPB> ql_write_request_;
 };
 
+// Builds inserts of many rows with the same set of columns, for bulk ingest. Rows are encoded into
+// a compact binary block per tablet, instead of creating protobuf objects per row and per column,
+// and the tablet server writes them directly to the DocDB write batch.
+class YBqlRowBlockWriter {
+ public:
+  // column_ids - regular columns written for each row, they should have scalar types.
+  YBqlRowBlockWriter(const std::shared_ptr<YBTable>& table, std::vector<int32_t> column_ids);
+  ~YBqlRowBlockWriter();
+
+  // Checks that the table and columns could be written using row blocks.
+  CHECKED_STATUS Init();
+
+  // Adds a row, values should contain values of all key columns in the schema order, followed by
+  // values of column_ids columns. Values are encoded immediately, so they could be reused by the
+  // caller for the next row.
+  CHECKED_STATUS AddRow(const std::vector<QLValue>& values);
+
+  // Returns insert operations for rows added since the previous call, one per tablet.
+  std::vector<YBqlWriteOpPtr> TakeOps();
+
+ private:
+  struct Block {
+    YBqlWriteOpPtr op;
+    faststring data;
+    uint32_t num_rows = 0;
+  };
+
+  const std::shared_ptr<YBTable> table_;
+  const std::vector<int32_t> column_ids_;
+  size_t num_hash_key_columns_ = 0;
+  size_t num_key_columns_ = 0;
+  std::vector<std::shared_ptr<QLType>> types_;
+
+  // Blocks by the partition start of their tablet.
+  std::unordered_map<std::string, Block> blocks_;
+
+  // Buffer for the hash key of the current row.
+  std::string hash_key_;
+};
+
 class YBqlReadOp : public YBqlOp {
  public:
   virtual ~YBqlReadOp();
@@ -304,6 +363,8 @@ class YBqlReadOp : public YBqlOp {
 
   QLReadRequestPB* mutable_request() { return ql_read_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   virtual std::string ToString() const override;
 
   virtual bool read_only() override { return true; };
@@ -328,6 +389,11 @@ class YBqlReadOp : public YBqlOp {
   const ReadHybridTime& read_time() const { return read_time_; }
   void SetReadTime(const ReadHybridTime& value) { read_time_ = value; }
 
+  // Allows a CONSISTENT_PREFIX read to be served by any replica whose data is at most this much
+  // behind the current time. Zero means no bound.
+  uint32_t max_staleness_ms() const { return max_staleness_ms_; }
+  void set_max_staleness_ms(uint32_t value) { max_staleness_ms_ = value; }
+
  protected:
   virtual Type type() const override { return QL_READ; }
 
@@ -337,6 +403,7 @@ class YBqlReadOp : public YBqlOp {
   std::unique_ptr<QLReadRequestPB> ql_read_request_;
   YBConsistencyLevel yb_consistency_level_;
   ReadHybridTime read_time_;
+  uint32_t max_staleness_ms_ = 0;
 };
 
 std::vector<ColumnSchema> MakeColumnSchemasFromColDesc(
@@ -381,6 +448,8 @@ class YBPgsqlWriteOp : public YBPgsqlOp {
 
   PgsqlWriteRequestPB* mutable_request() { return write_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   std::string ToString() const override;
 
   bool read_only() override { return false; };
@@ -415,6 +484,8 @@ class YBPgsqlReadOp : public YBPgsqlOp {
 
   PgsqlReadRequestPB* mutable_request() { return read_request_.get(); }
 
+  size_t space_used_by_request() const override;
+
   virtual std::string ToString() const override;
 
   virtual bool read_only() override { return true; };
@@ -13,6 +13,7 @@
 
 #include "yb/common/doc_hybrid_time.h"
 
+#include "yb/gutil/macros.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/cast.h"
@@ -23,6 +24,8 @@
 using yb::util::VarInt;
 using yb::util::FastEncodeDescendingSignedVarInt;
 using yb::util::FastDecodeDescendingSignedVarInt;
+using yb::util::FastDecodeDescendingSignedVarInts;
+using yb::util::FastEncodeDescendingSignedVarInts;
 using yb::util::FormatBytesAsStr;
 using yb::util::FormatSliceAsStr;
 using yb::util::QuotesType;
@@ -52,15 +55,15 @@ char* DocHybridTime::EncodedInDocDbFormat(char* dest) const {
   // than the YugaByte epoch.
   char* out = dest;
 
-  // Hybrid time generation number. This is currently always 0. In the future this can be used to
-  // reset hybrid time throughout the entire cluster back to a lower value if it gets stuck at some
-  // far-in-the-future point due to a temporary clock issue.
-  out = FastEncodeDescendingSignedVarInt(0, out);
-
-  out = FastEncodeDescendingSignedVarInt(
-      static_cast<int64_t>(hybrid_time_.GetPhysicalValueMicros() - kYugaByteMicrosecondEpoch),
-      out);
-  out = FastEncodeDescendingSignedVarInt(hybrid_time_.GetLogicalValue(), out);
+  const int64_t components[] = {
+    // Hybrid time generation number. This is currently always 0. In the future this can be used
+    // to reset hybrid time throughout the entire cluster back to a lower value if it gets stuck at
+    // some far-in-the-future point due to a temporary clock issue.
+    0,
+    static_cast<int64_t>(hybrid_time_.GetPhysicalValueMicros() - kYugaByteMicrosecondEpoch),
+    static_cast<int64_t>(hybrid_time_.GetLogicalValue())
+  };
+  out = FastEncodeDescendingSignedVarInts(components, arraysize(components), out);
 
   // We add one to write_id to ensure the negated value used in the encoding is always negative
   // (i.e. is never zero).  Then we shift it left by kNumBitsForHybridTimeSize bits so that we
@@ -87,12 +90,12 @@ char* DocHybridTime::EncodedInDocDbFormat(char* dest) const {
 Status DocHybridTime::DecodeFrom(Slice *slice) {
   const size_t previous_size = slice->size();
   {
+    // Generation number, physical and logical components.
+    int64_t components[3];
+    RETURN_NOT_OK(FastDecodeDescendingSignedVarInts(slice, components, arraysize(components)));
     // Currently we just ignore the generation number as it should always be 0.
-    RETURN_NOT_OK(FastDecodeDescendingSignedVarInt(slice));
-    int64_t decoded_micros =
-        kYugaByteMicrosecondEpoch + VERIFY_RESULT(FastDecodeDescendingSignedVarInt(slice));
-
-    int64_t decoded_logical = VERIFY_RESULT(FastDecodeDescendingSignedVarInt(slice));
+    int64_t decoded_micros = kYugaByteMicrosecondEpoch + components[1];
+    int64_t decoded_logical = components[2];
 
     hybrid_time_ = HybridTime::FromMicrosecondsAndLogicalValue(decoded_micros, decoded_logical);
   }
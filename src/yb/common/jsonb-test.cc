@@ -151,5 +151,43 @@ TEST(JsonbTest, TestArrays) {
   VerifyArray(document);
 }
 
+TEST(JsonbTest, TestObjectKeyLookup) {
+  // Keys of different lengths, so that their sorted order differs from the order of insertion.
+  std::string json = "{";
+  constexpr int kNumKeys = 100;
+  for (int i = 0; i != kNumKeys; ++i) {
+    json += (i ? ", \"k" : "\"k") + to_string(i * 7 % kNumKeys) + "\" : " + to_string(i);
+  }
+  json += ", \"nested\" : { \"a\" : [10, 20] } }";
+  Jsonb jsonb;
+  ASSERT_OK(jsonb.FromString(json));
+
+  auto apply = [&jsonb](const std::vector<std::string>& keys, JsonOperatorPB last_operator,
+                        QLValue* result) {
+    QLJsonColumnOperationsPB json_ops;
+    for (const auto& key : keys) {
+      auto* op = json_ops.add_json_operations();
+      op->set_json_operator(JsonOperatorPB::JSON_OBJECT);
+      op->mutable_operand()->mutable_value()->set_string_value(key);
+    }
+    json_ops.mutable_json_operations(json_ops.json_operations_size() - 1)->set_json_operator(
+        last_operator);
+    return Jsonb::ApplyJsonbOperators(jsonb.SerializedJsonb(), json_ops, result);
+  };
+
+  for (int i = 0; i != kNumKeys; ++i) {
+    QLValue result;
+    ASSERT_OK(apply({"k" + to_string(i * 7 % kNumKeys)}, JsonOperatorPB::JSON_TEXT, &result));
+    ASSERT_EQ(to_string(i), result.string_value());
+  }
+
+  QLValue result;
+  ASSERT_OK(apply({"nested", "a"}, JsonOperatorPB::JSON_TEXT, &result));
+  ASSERT_EQ("[10,20]", result.string_value());
+
+  ASSERT_OK(apply({"k100"}, JsonOperatorPB::JSON_OBJECT, &result));
+  ASSERT_TRUE(result.IsNull());
+}
+
 }  // namespace common
 }  // namespace yb
@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_columnar.h"
+#include "yb/common/ql_rowblock.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class QLColumnarTest : public YBTest {
+ protected:
+  Schema CreateSchema() {
+    return Schema({ ColumnSchema("i32", INT32),
+                    ColumnSchema("i64", INT64),
+                    ColumnSchema("timestamp", TIMESTAMP),
+                    ColumnSchema("str", STRING),
+                    ColumnSchema("dbl", DOUBLE) }, 0);
+  }
+
+  // Converts rows to the columnar format and back, checks that rows are preserved.
+  void CheckRoundTrip(const QLRowBlock& rows, size_t* columnar_size = nullptr) {
+    faststring cql_rows_data;
+    rows.Serialize(YQL_CLIENT_CQL, &cql_rows_data);
+
+    std::vector<std::shared_ptr<QLType>> column_types;
+    for (const auto& column : rows.schema().columns()) {
+      column_types.push_back(column.type());
+    }
+    faststring columnar_rows_data;
+    ASSERT_OK(CQLRowsDataToColumnar(column_types, cql_rows_data, &columnar_rows_data));
+
+    QLRowBlock result(rows.schema());
+    ASSERT_OK(DeserializeColumnarRowsData(columnar_rows_data, &result));
+    ASSERT_EQ(rows.ToString(), result.ToString());
+    if (columnar_size) {
+      *columnar_size = columnar_rows_data.size();
+      LOG(INFO) << "CQL size: " << cql_rows_data.size() << ", columnar size: " << *columnar_size;
+      ASSERT_LT(*columnar_size, cql_rows_data.size());
+    }
+  }
+};
+
+TEST_F(QLColumnarTest, RoundTrip) {
+  QLRowBlock rows(CreateSchema());
+  // Empty result.
+  CheckRoundTrip(rows);
+
+  constexpr int kNumRows = 1000;
+  const std::vector<std::string> strings = { "abc", "", "some longer string" };
+  for (int i = 0; i != kNumRows; ++i) {
+    auto& row = rows.Extend();
+    row.mutable_column(0)->set_int32_value(i - kNumRows / 2);
+    if (i % 7 == 0) {
+      row.mutable_column(1)->SetNull();
+    } else {
+      row.mutable_column(1)->set_int64_value(std::numeric_limits<int64_t>::max() - i);
+    }
+    row.mutable_column(2)->set_timestamp_value(1000000LL * (1500000000 + i));
+    row.mutable_column(3)->set_string_value(strings[i % strings.size()]);
+    row.mutable_column(4)->set_double_value(i * 0.5);
+  }
+  size_t columnar_size = 0;
+  CheckRoundTrip(rows, &columnar_size);
+
+  // Values that could not be bit packed or put into dictionary are stored as is.
+  for (int i = 0; i != kNumRows; ++i) {
+    rows.row(i).mutable_column(0)->set_int32_value(i % 2 ? std::numeric_limits<int32_t>::min()
+                                                         : std::numeric_limits<int32_t>::max());
+    rows.row(i).mutable_column(3)->set_string_value(std::to_string(i));
+  }
+  CheckRoundTrip(rows);
+}
+
+TEST_F(QLColumnarTest, Corruption) {
+  QLRowBlock rows(CreateSchema());
+  for (int i = 0; i != 10; ++i) {
+    auto& row = rows.Extend();
+    for (size_t column = 0; column != rows.schema().num_columns(); ++column) {
+      row.mutable_column(column)->SetNull();
+    }
+  }
+  faststring cql_rows_data;
+  rows.Serialize(YQL_CLIENT_CQL, &cql_rows_data);
+  std::vector<std::shared_ptr<QLType>> column_types(
+      rows.schema().num_columns(), QLType::Create(INT32));
+  faststring columnar_rows_data;
+  ASSERT_OK(CQLRowsDataToColumnar(column_types, cql_rows_data, &columnar_rows_data));
+
+  // Truncated data is detected.
+  for (size_t size = 0; size != columnar_rows_data.size(); ++size) {
+    QLRowBlock result(rows.schema());
+    ASSERT_NOK(DeserializeColumnarRowsData(Slice(columnar_rows_data.data(), size), &result));
+  }
+
+  ASSERT_NOK(CQLRowsDataToColumnar(
+      column_types, Slice(cql_rows_data.data(), cql_rows_data.size() - 1), &columnar_rows_data));
+}
+
+} // namespace yb
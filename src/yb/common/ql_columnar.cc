@@ -0,0 +1,395 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_columnar.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "yb/common/ql_rowblock.h"
+#include "yb/common/ql_type.h"
+#include "yb/common/wire_protocol.h"
+
+#include "yb/gutil/bits.h"
+
+#include "yb/util/coding.h"
+#include "yb/util/hash_util.h"
+#include "yb/util/rle-encoding.h"
+
+namespace yb {
+
+namespace {
+
+enum class ColumnEncoding : uint32_t {
+  kPlain = 0,
+  kBitPacked = 1,
+  kDictionary = 2,
+};
+
+// RLE encoder supports values up to 32 bits.
+constexpr int kMaxBitWidth = 32;
+
+// Null flags of all rows of a column, and values of rows that are not null, in the CQL format
+// without the length.
+struct ColumnValues {
+  std::vector<bool> nulls;
+  std::vector<Slice> values;
+};
+
+struct SliceHash {
+  size_t operator()(const Slice& slice) const {
+    return HashUtil::MurmurHash2_64(slice.data(), slice.size(), 0 /* seed */);
+  }
+};
+
+// Returns size of CQL serialized integer of the specified type, or 0 if it is not an integer.
+size_t IntegerSize(const QLType& type) {
+  switch (type.main()) {
+    case INT8:
+      return 1;
+    case INT16:
+      return 2;
+    case INT32:
+      return 4;
+    case INT64: FALLTHROUGH_INTENDED;
+    case TIMESTAMP:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+int64_t LoadInteger(const Slice& value) {
+  switch (value.size()) {
+    case 1:
+      return static_cast<int8_t>(value[0]);
+    case 2:
+      return static_cast<int16_t>(NetworkByteOrder::Load16(value.data()));
+    case 4:
+      return static_cast<int32_t>(NetworkByteOrder::Load32(value.data()));
+    case 8:
+      return static_cast<int64_t>(NetworkByteOrder::Load64(value.data()));
+  }
+  LOG(FATAL) << "Unexpected integer size: " << value.size();
+  return 0;
+}
+
+void StoreInteger(int64_t value, size_t size, faststring* buffer) {
+  switch (size) {
+    case 1:
+      CQLEncodeNum(Store8, static_cast<int8_t>(value), buffer);
+      return;
+    case 2:
+      CQLEncodeNum(NetworkByteOrder::Store16, static_cast<int16_t>(value), buffer);
+      return;
+    case 4:
+      CQLEncodeNum(NetworkByteOrder::Store32, static_cast<int32_t>(value), buffer);
+      return;
+    case 8:
+      CQLEncodeNum(NetworkByteOrder::Store64, value, buffer);
+      return;
+  }
+  LOG(FATAL) << "Unexpected integer size: " << size;
+}
+
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+int BitWidth(uint64_t max_value) {
+  return max_value == 0 ? 0 : Bits::Log2FloorNonZero64(max_value) + 1;
+}
+
+template <class T>
+void PutRleBlock(const std::vector<T>& values, int bit_width, faststring* out) {
+  faststring block;
+  RleEncoder<T> encoder(&block, bit_width);
+  for (const auto& value : values) {
+    encoder.Put(value);
+  }
+  encoder.Flush();
+  PutVarint32(out, encoder.len());
+  out->append(block.data(), encoder.len());
+}
+
+void PutCQLValue(const Slice& value, faststring* out) {
+  CQLEncodeLength(static_cast<int32_t>(value.size()), out);
+  out->append(value.data(), value.size());
+}
+
+bool EncodeBitPacked(size_t integer_size, const std::vector<Slice>& values, faststring* out) {
+  if (integer_size == 0 || values.empty()) {
+    return false;
+  }
+  std::vector<int64_t> integers;
+  integers.reserve(values.size());
+  for (const auto& value : values) {
+    if (value.size() != integer_size) {
+      return false;
+    }
+    integers.push_back(LoadInteger(value));
+  }
+  const auto minmax = std::minmax_element(integers.begin(), integers.end());
+  const int64_t min = *minmax.first;
+  const int bit_width = BitWidth(
+      static_cast<uint64_t>(*minmax.second) - static_cast<uint64_t>(min));
+  if (bit_width > kMaxBitWidth) {
+    return false;
+  }
+  PutVarint32(out, static_cast<uint32_t>(ColumnEncoding::kBitPacked));
+  PutVarint64(out, ZigZagEncode(min));
+  PutVarint32(out, bit_width);
+  if (bit_width != 0) {
+    std::vector<uint64_t> deltas;
+    deltas.reserve(integers.size());
+    for (auto integer : integers) {
+      deltas.push_back(static_cast<uint64_t>(integer) - static_cast<uint64_t>(min));
+    }
+    PutRleBlock(deltas, bit_width, out);
+  }
+  return true;
+}
+
+bool EncodeDictionary(const std::vector<Slice>& values, faststring* out) {
+  if (values.empty()) {
+    return false;
+  }
+  std::unordered_map<Slice, uint64_t, SliceHash> indexes;
+  std::vector<Slice> dictionary;
+  std::vector<uint64_t> value_indexes;
+  value_indexes.reserve(values.size());
+  for (const auto& value : values) {
+    auto it = indexes.emplace(value, dictionary.size()).first;
+    if (it->second == dictionary.size()) {
+      dictionary.push_back(value);
+      // Dictionary does not pay off when less than a half of values are repeated.
+      if (dictionary.size() * 2 > values.size()) {
+        return false;
+      }
+    }
+    value_indexes.push_back(it->second);
+  }
+  PutVarint32(out, static_cast<uint32_t>(ColumnEncoding::kDictionary));
+  PutVarint64(out, dictionary.size());
+  for (const auto& value : dictionary) {
+    PutCQLValue(value, out);
+  }
+  const int bit_width = std::max(BitWidth(dictionary.size() - 1), 1);
+  PutVarint32(out, bit_width);
+  PutRleBlock(value_indexes, bit_width, out);
+  return true;
+}
+
+void EncodeColumn(const QLType& type, const ColumnValues& column, faststring* out) {
+  const bool has_nulls = column.values.size() != column.nulls.size();
+  PutVarint32(out, has_nulls);
+  if (has_nulls) {
+    PutRleBlock(column.nulls, 1 /* bit_width */, out);
+  }
+  if (EncodeBitPacked(IntegerSize(type), column.values, out) ||
+      EncodeDictionary(column.values, out)) {
+    return;
+  }
+  PutVarint32(out, static_cast<uint32_t>(ColumnEncoding::kPlain));
+  for (const auto& value : column.values) {
+    PutCQLValue(value, out);
+  }
+}
+
+CHECKED_STATUS GetVarint(Slice* data, uint64_t* value) {
+  if (!GetVarint64(data, value)) {
+    return STATUS(Corruption, "Bad varint in columnar rows data");
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS GetBlock(Slice* data, Slice* block) {
+  if (!GetLengthPrefixedSlice(data, block)) {
+    return STATUS(Corruption, "Truncated block in columnar rows data");
+  }
+  return Status::OK();
+}
+
+template <class T>
+CHECKED_STATUS DecodeRleBlock(Slice* data, int bit_width, size_t count, std::vector<T>* values) {
+  Slice block;
+  RETURN_NOT_OK(GetBlock(data, &block));
+  RleDecoder<T> decoder(block.data(), block.size(), bit_width);
+  values->resize(count);
+  for (size_t i = 0; i != count; ++i) {
+    T value;
+    if (!decoder.Get(&value)) {
+      return STATUS(Corruption, "Truncated RLE block in columnar rows data");
+    }
+    (*values)[i] = value;
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS GetBitWidth(Slice* data, int* bit_width) {
+  uint64_t value = 0;
+  RETURN_NOT_OK(GetVarint(data, &value));
+  if (value > kMaxBitWidth) {
+    return STATUS_FORMAT(Corruption, "Bad bit width in columnar rows data: $0", value);
+  }
+  *bit_width = static_cast<int>(value);
+  return Status::OK();
+}
+
+// Decodes values of the column and stores them to not null rows.
+CHECKED_STATUS DecodeColumnValues(const std::shared_ptr<QLType>& type,
+                                  const std::vector<QLValue*>& values, Slice* data) {
+  uint64_t encoding = 0;
+  RETURN_NOT_OK(GetVarint(data, &encoding));
+  switch (static_cast<ColumnEncoding>(encoding)) {
+    case ColumnEncoding::kPlain:
+      for (auto* value : values) {
+        RETURN_NOT_OK(value->Deserialize(type, YQL_CLIENT_CQL, data));
+      }
+      return Status::OK();
+    case ColumnEncoding::kBitPacked: {
+      const size_t integer_size = IntegerSize(*type);
+      if (integer_size == 0) {
+        return STATUS_FORMAT(Corruption, "Bit packed column of type $0", type->ToString());
+      }
+      uint64_t encoded_min = 0;
+      RETURN_NOT_OK(GetVarint(data, &encoded_min));
+      const int64_t min = ZigZagDecode(encoded_min);
+      int bit_width = 0;
+      RETURN_NOT_OK(GetBitWidth(data, &bit_width));
+      std::vector<uint64_t> deltas;
+      if (bit_width != 0) {
+        RETURN_NOT_OK(DecodeRleBlock(data, bit_width, values.size(), &deltas));
+      } else {
+        deltas.resize(values.size());
+      }
+      // Values are converted back to the CQL format, so they are interpreted the same way as
+      // values deserialized from CQL rows, e.g. timestamp precision is adjusted.
+      faststring buffer;
+      for (size_t i = 0; i != values.size(); ++i) {
+        buffer.clear();
+        StoreInteger(static_cast<int64_t>(static_cast<uint64_t>(min) + deltas[i]), integer_size,
+                     &buffer);
+        Slice slice(buffer.data(), buffer.size());
+        RETURN_NOT_OK(values[i]->Deserialize(type, YQL_CLIENT_CQL, &slice));
+      }
+      return Status::OK();
+    }
+    case ColumnEncoding::kDictionary: {
+      uint64_t dictionary_size = 0;
+      RETURN_NOT_OK(GetVarint(data, &dictionary_size));
+      if (dictionary_size > data->size()) {
+        return STATUS_FORMAT(Corruption, "Bad dictionary size: $0", dictionary_size);
+      }
+      std::vector<QLValue> dictionary(dictionary_size);
+      for (auto& value : dictionary) {
+        RETURN_NOT_OK(value.Deserialize(type, YQL_CLIENT_CQL, data));
+      }
+      int bit_width = 0;
+      RETURN_NOT_OK(GetBitWidth(data, &bit_width));
+      std::vector<uint64_t> indexes;
+      RETURN_NOT_OK(DecodeRleBlock(data, bit_width, values.size(), &indexes));
+      for (size_t i = 0; i != values.size(); ++i) {
+        if (indexes[i] >= dictionary_size) {
+          return STATUS_FORMAT(Corruption, "Bad dictionary index: $0", indexes[i]);
+        }
+        *values[i] = dictionary[indexes[i]];
+      }
+      return Status::OK();
+    }
+  }
+  return STATUS_FORMAT(Corruption, "Unknown column encoding: $0", encoding);
+}
+
+} // namespace
+
+Status CQLRowsDataToColumnar(const std::vector<std::shared_ptr<QLType>>& column_types,
+                             const Slice& cql_rows_data,
+                             faststring* columnar_rows_data) {
+  Slice data = cql_rows_data;
+  int32_t row_count = 0;
+  RETURN_NOT_OK(CQLDecodeNum(sizeof(row_count), NetworkByteOrder::Load32, &data, &row_count));
+
+  std::vector<ColumnValues> columns(column_types.size());
+  for (auto& column : columns) {
+    column.nulls.reserve(row_count);
+    column.values.reserve(row_count);
+  }
+  for (int32_t row = 0; row != row_count; ++row) {
+    for (auto& column : columns) {
+      int32_t length = 0;
+      RETURN_NOT_OK(CQLDecodeNum(sizeof(length), NetworkByteOrder::Load32, &data, &length));
+      column.nulls.push_back(length < 0);
+      if (length < 0) {
+        continue;
+      }
+      if (data.size() < static_cast<size_t>(length)) {
+        return STATUS(Corruption, "Truncated CQL rows data");
+      }
+      column.values.emplace_back(data.data(), length);
+      data.remove_prefix(length);
+    }
+  }
+  if (!data.empty()) {
+    return STATUS(Corruption, "Extra data at the end of CQL rows data");
+  }
+
+  columnar_rows_data->clear();
+  PutVarint64(columnar_rows_data, row_count);
+  for (size_t i = 0; i != columns.size(); ++i) {
+    EncodeColumn(*column_types[i], columns[i], columnar_rows_data);
+  }
+  return Status::OK();
+}
+
+Status DeserializeColumnarRowsData(Slice data, QLRowBlock* row_block) {
+  uint64_t row_count = 0;
+  RETURN_NOT_OK(GetVarint(&data, &row_count));
+  const size_t first_row = row_block->row_count();
+  for (uint64_t i = 0; i != row_count; ++i) {
+    row_block->Extend();
+  }
+
+  const Schema& schema = row_block->schema();
+  std::vector<bool> nulls;
+  std::vector<QLValue*> values;
+  for (size_t column = 0; column != schema.num_columns(); ++column) {
+    uint64_t has_nulls = 0;
+    RETURN_NOT_OK(GetVarint(&data, &has_nulls));
+    if (has_nulls) {
+      RETURN_NOT_OK(DecodeRleBlock(&data, 1 /* bit_width */, row_count, &nulls));
+    } else {
+      nulls.assign(row_count, false);
+    }
+    values.clear();
+    for (size_t i = 0; i != row_count; ++i) {
+      auto* value = row_block->row(first_row + i).mutable_column(column);
+      if (nulls[i]) {
+        value->SetNull();
+      } else {
+        values.push_back(value);
+      }
+    }
+    RETURN_NOT_OK(DecodeColumnValues(schema.column(column).type(), values, &data));
+  }
+  if (!data.empty()) {
+    return STATUS(Corruption, "Extra data at the end of columnar rows data");
+  }
+  return Status::OK();
+}
+
+} // namespace yb
@@ -0,0 +1,52 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Columnar format of QL rows data. A client could request it instead of the CQL format to reduce
+// size of results with many rows. The format is:
+//   rows := varint(row_count) column*
+//   column := varint(has_nulls) [block(nulls)] varint(encoding) values
+//   block := varint(size) bytes
+// where nulls are RLE encoded null flags of all rows, and values are present only for rows that are
+// not null. Values are encoded depending on the encoding:
+//   kPlain: CQL serialized values.
+//   kBitPacked: zigzag_varint(min) varint(bit_width) [block(RLE encoded value - min)], used for
+//               integers when bit_width is small enough.
+//   kDictionary: varint(dictionary_size) CQL serialized dictionary values varint(bit_width)
+//                block(RLE encoded dictionary indexes), used when there are many repeated values.
+
+#ifndef YB_COMMON_QL_COLUMNAR_H
+#define YB_COMMON_QL_COLUMNAR_H
+
+#include <memory>
+#include <vector>
+
+#include "yb/util/faststring.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class QLType;
+class QLRowBlock;
+
+// Converts rows data in the CQL format, i.e. the row count followed by serialized values of all
+// rows, to the columnar format.
+CHECKED_STATUS CQLRowsDataToColumnar(const std::vector<std::shared_ptr<QLType>>& column_types,
+                                     const Slice& cql_rows_data,
+                                     faststring* columnar_rows_data);
+
+// Decodes rows data in the columnar format, and appends decoded rows to the row block.
+CHECKED_STATUS DeserializeColumnarRowsData(Slice data, QLRowBlock* row_block);
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_COLUMNAR_H
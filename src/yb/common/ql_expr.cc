@@ -31,11 +31,14 @@ CHECKED_STATUS QLExprExecutor::EvalExpr(const QLExpressionPB& ql_expr,
       break;
 
     case QLExpressionPB::ExprCase::kJsonColumn: {
-      QLValue ql_value;
+      // Operators are applied to the column value in the row, without copying the document.
       const QLJsonColumnOperationsPB& json_ops = ql_expr.json_column();
-      RETURN_NOT_OK(table_row.ReadColumn(json_ops.column_id(), &ql_value));
-      common::Jsonb jsonb(std::move(ql_value.jsonb_value()));
-      RETURN_NOT_OK(jsonb.ApplyJsonbOperators(json_ops, result));
+      const auto value = table_row.GetValue(json_ops.column_id());
+      if (!value || value->value_case() != QLValuePB::kJsonbValue) {
+        result->SetNull();
+        break;
+      }
+      RETURN_NOT_OK(common::Jsonb::ApplyJsonbOperators(value->jsonb_value(), json_ops, result));
       break;
     }
 
@@ -425,14 +428,68 @@ CHECKED_STATUS QLExprExecutor::ReadTSCallValue(const PgsqlBCallPB& ql_expr,
 
 //--------------------------------------------------------------------------------------------------
 
+void QLTableRow::Clear() {
+  for (ColumnIdRep col_id : assigned_) {
+    if (col_id >= 0 && col_id < kMaxDenseColumnId) {
+      dense_columns_[col_id].assigned = false;
+    }
+  }
+  assigned_.clear();
+  sparse_columns_.clear();
+}
+
+const QLTableColumn* QLTableRow::FindColumn(ColumnIdRep col_id) const {
+  if (col_id >= 0 && col_id < kMaxDenseColumnId) {
+    if (static_cast<size_t>(col_id) >= dense_columns_.size() || !dense_columns_[col_id].assigned) {
+      return nullptr;
+    }
+    return &dense_columns_[col_id].column;
+  }
+  auto it = sparse_columns_.find(col_id);
+  return it == sparse_columns_.end() ? nullptr : &it->second;
+}
+
+QLTableColumn& QLTableRow::AssignColumn(ColumnIdRep col_id) {
+  if (col_id >= 0 && col_id < kMaxDenseColumnId) {
+    if (static_cast<size_t>(col_id) >= dense_columns_.size()) {
+      dense_columns_.resize(col_id + 1);
+    }
+    DenseColumn& dense_column = dense_columns_[col_id];
+    if (!dense_column.assigned) {
+      // Reset the storage left from the previous row to a default constructed column.
+      dense_column.assigned = true;
+      dense_column.column.value.Clear();
+      dense_column.column.ttl_seconds = 0;
+      dense_column.column.write_time = QLTableColumn::kUninitializedWriteTime;
+      assigned_.push_back(col_id);
+    }
+    return dense_column.column;
+  }
+  auto it = sparse_columns_.find(col_id);
+  if (it == sparse_columns_.end()) {
+    it = sparse_columns_.emplace(col_id, QLTableColumn()).first;
+    assigned_.push_back(col_id);
+  }
+  return it->second;
+}
+
+std::string QLTableRow::ToString() const {
+  std::string result = "{";
+  for (ColumnIdRep col_id : assigned_) {
+    result += Format(" $0: $1", col_id, *FindColumn(col_id));
+  }
+  result += " }";
+  return result;
+}
+
 CHECKED_STATUS QLTableRow::ReadColumn(ColumnIdRep col_id, QLValue *col_value) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(col_id);
+  if (column == nullptr) {
     col_value->SetNull();
     return Status::OK();
   }
 
-  *col_value = col_iter->second.value;
+  *col_value = column->value;
   return Status::OK();
 }
 
@@ -441,21 +498,21 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
                                                  QLValue *col_value) const {
   col_value->SetNull();
 
-  const auto& col_iter = col_map_.find(subcol.column_id());
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(subcol.column_id());
+  if (column == nullptr) {
     // Not exists.
     return Status::OK();
-  } else if (col_iter->second.value.has_map_value()) {
+  } else if (column->value.has_map_value()) {
     // map['key']
-    auto& map = col_iter->second.value.map_value();
+    auto& map = column->value.map_value();
     for (int i = 0; i < map.keys_size(); i++) {
       if (map.keys(i) == index_arg.value()) {
           *col_value = map.values(i);
       }
     }
-  } else if (col_iter->second.value.has_list_value()) {
+  } else if (column->value.has_list_value()) {
     // list[index]
-    auto& list = col_iter->second.value.list_value();
+    auto& list = column->value.list_value();
     if (index_arg.value().has_int32_value()) {
       int list_index = index_arg.int32_value();
       if (list_index >= 0 && list_index < list.elems_size()) {
@@ -467,79 +524,78 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
 }
 
 CHECKED_STATUS QLTableRow::GetTTL(ColumnIdRep col_id, int64_t *ttl_seconds) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(col_id);
+  if (column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *ttl_seconds = col_iter->second.ttl_seconds;
+  *ttl_seconds = column->ttl_seconds;
   return Status::OK();
 }
 
 CHECKED_STATUS QLTableRow::GetWriteTime(ColumnIdRep col_id, int64_t *write_time) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(col_id);
+  if (column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  DCHECK_NE(QLTableColumn::kUninitializedWriteTime, col_iter->second.write_time);
-  *write_time = col_iter->second.write_time;
+  DCHECK_NE(QLTableColumn::kUninitializedWriteTime, column->write_time);
+  *write_time = column->write_time;
   return Status::OK();
 }
 
 CHECKED_STATUS QLTableRow::GetValue(ColumnIdRep col_id, QLValue *column) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* table_column = FindColumn(col_id);
+  if (table_column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *column = std::move(col_iter->second.value);
+  *column = table_column->value;
   return Status::OK();
 }
 
 boost::optional<const QLValuePB&> QLTableRow::GetValue(ColumnIdRep col_id) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const QLTableColumn* column = FindColumn(col_id);
+  if (column == nullptr) {
     return boost::none;
   }
-  return col_iter->second.value;
+  return column->value;
 }
 
 void QLTableRow::ClearValue(ColumnIdRep col_id) {
-  col_map_[col_id].value.Clear();
+  AssignColumn(col_id).value.Clear();
 }
 
 bool QLTableRow::MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const {
-  auto this_iter = col_map_.find(col_id);
-  auto source_iter = source.col_map_.find(col_id);
-  if (this_iter != col_map_.end() && source_iter != source.col_map_.end()) {
-    return this_iter->second.value == source_iter->second.value;
-  }
-  if (this_iter != col_map_.end() || source_iter != source.col_map_.end()) {
-    return false;
+  const QLTableColumn* this_column = FindColumn(col_id);
+  const QLTableColumn* source_column = source.FindColumn(col_id);
+  if (this_column != nullptr && source_column != nullptr) {
+    return this_column->value == source_column->value;
   }
-  return true;
+  return this_column == nullptr && source_column == nullptr;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id) {
-  return col_map_[col_id];
+  return AssignColumn(col_id);
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id, const QLValue& ql_value) {
-  col_map_[col_id].value = ql_value.value();
-  return col_map_[col_id];
+  QLTableColumn& column = AssignColumn(col_id);
+  column.value = ql_value.value();
+  return column;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id, const QLValuePB& ql_value) {
-  col_map_[col_id].value = ql_value;
-  return col_map_[col_id];
+  QLTableColumn& column = AssignColumn(col_id);
+  column.value = ql_value;
+  return column;
 }
 
 CHECKED_STATUS QLTableRow::CopyColumn(ColumnIdRep col_id,
                                       const QLTableRow& source) {
-  auto col_iter = source.col_map_.find(col_id);
-  if (col_iter != source.col_map_.end()) {
-    col_map_[col_id] = col_iter->second;
+  const QLTableColumn* column = source.FindColumn(col_id);
+  if (column != nullptr) {
+    AssignColumn(col_id) = *column;
   }
   return Status::OK();
 }
@@ -549,9 +605,9 @@ std::string QLTableRow::ToString(const Schema& schema) const {
   ret.append("{ ");
 
   for (size_t col_idx = 0; col_idx < schema.num_columns(); col_idx++) {
-    auto it = col_map_.find(schema.column_id(col_idx));
-    if (it != col_map_.end() && it->second.value.value_case() != QLValuePB::VALUE_NOT_SET) {
-      ret += it->second.value.ShortDebugString();
+    const QLTableColumn* column = FindColumn(schema.column_id(col_idx));
+    if (column != nullptr && column->value.value_case() != QLValuePB::VALUE_NOT_SET) {
+      ret += column->value.ShortDebugString();
     } else {
       ret += "null";
     }
@@ -52,16 +52,16 @@ class QLTableRow {
 
   // Check if row is empty (no column).
   bool IsEmpty() const {
-    return col_map_.empty();
+    return assigned_.empty();
   }
 
   // Get column count.
   size_t ColumnCount() const {
-    return col_map_.size();
+    return assigned_.size();
   }
 
-  // Clear the row.
-  void Clear() { col_map_.clear(); }
+  // Clear the row. Storage of columns is kept, so filling the row again does not allocate them.
+  void Clear();
 
   // Compare column value between two rows.
   bool MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const;
@@ -118,20 +118,37 @@ class QLTableRow {
 
   // For testing only (no status check).
   const QLTableColumn& TestValue(ColumnIdRep col_id) const {
-    return col_map_.at(col_id);
+    const QLTableColumn* column = FindColumn(col_id);
+    CHECK(column != nullptr) << "Column not found: " << col_id;
+    return *column;
   }
   const QLTableColumn& TestValue(const ColumnId& col) const {
-    return col_map_.at(col.rep());
+    return TestValue(col.rep());
   }
 
-  std::string ToString() const {
-    return yb::ToString(col_map_);
-  }
+  std::string ToString() const;
 
   std::string ToString(const Schema& schema) const;
 
  private:
-  std::unordered_map<ColumnIdRep, QLTableColumn> col_map_;
+  // Column ids of a table are assigned sequentially, so columns are stored in an array indexed by
+  // id. Ids above this limit are stored in a map.
+  static constexpr ColumnIdRep kMaxDenseColumnId = 4096;
+
+  struct DenseColumn {
+    QLTableColumn column;
+    bool assigned = false;
+  };
+
+  // Returns the column, or nullptr when it is not assigned.
+  const QLTableColumn* FindColumn(ColumnIdRep col_id) const;
+
+  QLTableColumn& AssignColumn(ColumnIdRep col_id);
+
+  std::vector<DenseColumn> dense_columns_;
+  std::unordered_map<ColumnIdRep, QLTableColumn> sparse_columns_;
+  // Ids of assigned columns, in assignment order.
+  std::vector<ColumnIdRep> assigned_;
 };
 
 class QLExprExecutor {
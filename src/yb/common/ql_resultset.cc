@@ -25,45 +25,27 @@ QLRSRowDesc::~QLRSRowDesc() {
 
 //--------------------------------------------------------------------------------------------------
 
-QLRSRow::QLRSRow(int32_t rscol_count) : rscols_(rscol_count) {
+QLResultSet::QLResultSet(const QLRSRowDesc* rsrow_desc, faststring* rows_data)
+    : rsrow_desc_(rsrow_desc), rows_data_(rows_data), rsrow_count_pos_(rows_data->size()) {
+  CQLEncodeLength(0, rows_data_);
 }
 
-QLRSRow::~QLRSRow() {
-}
-
-CHECKED_STATUS QLRSRow::CQLSerialize(const QLClient& client,
-                                     const QLRSRowDesc& rsrow_desc,
-                                     faststring* buffer) const {
-  DCHECK_EQ(rsrow_desc.rscol_count(), rscol_count()) << "Wrong count of fields in result set";
-  int idx = 0;
-  for (auto rscol_desc : rsrow_desc.rscol_descs()) {
-    rscols_[idx].Serialize(rscol_desc.ql_type(), client, buffer);
-    idx++;
-  }
-  return Status::OK();
-}
-
-//--------------------------------------------------------------------------------------------------
-
-QLResultSet::QLResultSet() {
+QLResultSet::~QLResultSet() {
 }
 
-QLResultSet::~QLResultSet() {
+void QLResultSet::AllocateRow() {
+  ++rsrow_count_;
+  CQLEncodeLength(static_cast<int32_t>(rsrow_count_), rows_data_->data() + rsrow_count_pos_);
 }
 
-QLRSRow *QLResultSet::AllocateRSRow(int32_t rscol_count) {
-  rsrows_.emplace_back(rscol_count);
-  return &rsrows_.back();
+void QLResultSet::AppendColumn(size_t index, const QLValue& value) {
+  AppendColumn(index, value.value());
 }
 
-CHECKED_STATUS QLResultSet::CQLSerialize(const QLClient& client,
-                                         const QLRSRowDesc& rsrow_desc,
-                                         faststring* buffer) const {
-  CQLEncodeLength(rsrows_.size(), buffer);
-  for (const auto& rsrow : rsrows_) {
-    RETURN_NOT_OK(rsrow.CQLSerialize(client, rsrow_desc, buffer));
-  }
-  return Status::OK();
+void QLResultSet::AppendColumn(size_t index, const QLValuePB& value) {
+  DCHECK_LT(index, rsrow_desc_->rscol_count()) << "Wrong count of fields in result set";
+  QLValue::Serialize(rsrow_desc_->rscol_descs()[index].ql_type(), YQL_CLIENT_CQL, value,
+                     rows_data_);
 }
 
 } // namespace yb
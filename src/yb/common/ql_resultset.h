@@ -33,10 +33,10 @@ class QLRSRowDesc {
     RSColDesc(const string& name, const QLType::SharedPtr& ql_type)
         : name_(name), ql_type_(ql_type) {
     }
-    const string& name() {
+    const string& name() const {
       return name_;
     }
-    const QLType::SharedPtr& ql_type() {
+    const QLType::SharedPtr& ql_type() const {
       return ql_type_;
     }
    private:
@@ -60,57 +60,36 @@ class QLRSRowDesc {
 };
 
 //--------------------------------------------------------------------------------------------------
-// A rsrow represents the values of a row in the resultset.
-class QLRSRow {
- public:
-  explicit QLRSRow(int32_t rscol_count);
-  QLRSRow(QLRSRow&& other) : rscols_(std::move(other.rscols_)) { }
-  virtual ~QLRSRow();
-
-  const std::vector<QLValue>& rscols() const {
-    return rscols_;
-  }
-
-  size_t rscol_count() const { return rscols_.size(); }
-
-  QLValue *rscol(int32_t index) {
-    return &rscols_[index];
-  }
-
-  CHECKED_STATUS CQLSerialize(const QLClient& client,
-                              const QLRSRowDesc& rsrow_desc,
-                              faststring* buffer) const;
-
- private:
-  std::vector<QLValue> rscols_;
-};
-
-// A set of rsrows.
+// A set of rsrows. Rows are serialized with CQL encoding format as they are appended, so column
+// values are not copied into intermediate rows, and could be serialized in place from the table
+// row.
 class QLResultSet {
  public:
   typedef std::shared_ptr<QLResultSet> SharedPtr;
 
-  // Constructor and destructor.
-  QLResultSet();
+  // Rows are appended to rows_data, that starts with the row count.
+  QLResultSet(const QLRSRowDesc* rsrow_desc, faststring* rows_data);
   virtual ~QLResultSet();
 
-  const std::vector<QLRSRow>& rsrows() const {
-    return rsrows_;
-  }
+  // Starts a new rsrow at the end of result set. All its columns should be appended, in order,
+  // before the next row is started.
+  void AllocateRow();
 
-  // Allocate a new rsrow and append it to the end of result set.
-  QLRSRow *AllocateRSRow(int32_t rscol_count);
+  void AppendColumn(size_t index, const QLValue& value);
+  void AppendColumn(size_t index, const QLValuePB& value);
 
   // Row count
-  size_t rsrow_count() const { return rsrows_.size(); }
+  size_t rsrow_count() const { return rsrow_count_; }
 
-  // Serialization routines with CQL encoding format.
-  CHECKED_STATUS CQLSerialize(const QLClient& client,
-                              const QLRSRowDesc& rsrow_desc,
-                              faststring* buffer) const;
+  // Size of serialized rows.
+  size_t rows_data_size() const { return rows_data_->size() - rsrow_count_pos_; }
 
  private:
-  std::vector<QLRSRow> rsrows_;
+  const QLRSRowDesc* rsrow_desc_;
+  faststring* rows_data_;
+  // Position of the row count in rows_data_.
+  size_t rsrow_count_pos_;
+  size_t rsrow_count_ = 0;
 };
 
 } // namespace yb
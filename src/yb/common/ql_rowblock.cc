@@ -141,7 +141,7 @@ Status QLRowBlock::GetRowCount(const QLClient client, const std::string& data, s
 }
 
 Status QLRowBlock::AppendRowsData(
-    const QLClient client, const std::string& src, std::string* dst) {
+    const QLClient client, std::string&& src, std::string* dst) {
   CHECK_EQ(client, YQL_CLIENT_CQL);
   int32_t src_cnt = 0;
   Slice src_slice(src);
@@ -151,7 +151,7 @@ Status QLRowBlock::AppendRowsData(
     Slice dst_slice(*dst);
     RETURN_NOT_OK(CQLDecodeNum(sizeof(dst_cnt), NetworkByteOrder::Load32, &dst_slice, &dst_cnt));
     if (dst_cnt == 0) {
-      *dst = src;
+      *dst = std::move(src);
     } else {
       dst->append(util::to_char_ptr(src_slice.data()), src_slice.size());
       dst_cnt += src_cnt;
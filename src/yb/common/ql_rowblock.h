@@ -116,8 +116,9 @@ class QLRowBlock {
   // Return row count.
   static CHECKED_STATUS GetRowCount(QLClient client, const std::string& data, size_t* count);
 
-  // Append rows data. Caller should ensure the column schemas are the same.
-  static CHECKED_STATUS AppendRowsData(QLClient client, const std::string& src, std::string* dst);
+  // Append rows data. Caller should ensure the column schemas are the same. Source rows are
+  // consumed, they are moved to dst when it has no rows yet.
+  static CHECKED_STATUS AppendRowsData(QLClient client, std::string&& src, std::string* dst);
 
  private:
   // Schema of the selected columns. (Note: this schema has no key column definitions)
@@ -22,6 +22,9 @@
 #include "yb/common/ql_rowwise_iterator_interface.h"
 
 namespace yb {
+
+class QLPagingStatePB;
+
 namespace common {
 
 class PgsqlScanSpec;
@@ -56,6 +59,16 @@ class YQLStorageIf {
                                           std::unique_ptr<common::QLScanSpec>* static_row_spec,
                                           ReadHybridTime* req_read_time) const = 0;
 
+  // Keeps the iterator of a paged read, so the read continued from paging_state could use it
+  // instead of creating a new one and seeking to the next row. Storages that do not cache
+  // iterators just destroy it.
+  virtual void CacheIterator(const QLReadRequestPB& request,
+                             const QLPagingStatePB& paging_state,
+                             std::unique_ptr<YQLRowwiseIteratorIf> iter) const {}
+
+  // Destroys cached iterators. Should be invoked before the underlying storage is closed.
+  virtual void ClearIteratorCache() {}
+
   //------------------------------------------------------------------------------------------------
   // PGSQL Support.
   virtual CHECKED_STATUS GetIterator(const PgsqlReadRequestPB& request,
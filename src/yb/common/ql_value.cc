@@ -302,33 +302,38 @@ void AppendToKey(const QLValuePB &value_pb, string *bytes) {
 
 void QLValue::Serialize(
     const std::shared_ptr<QLType>& ql_type, const QLClient& client, faststring* buffer) const {
+  Serialize(ql_type, client, pb_, buffer);
+}
+
+void QLValue::Serialize(const std::shared_ptr<QLType>& ql_type, const QLClient& client,
+                        const QLValuePB& pb, faststring* buffer) {
   CHECK_EQ(client, YQL_CLIENT_CQL);
-  if (IsNull()) {
+  if (yb::IsNull(pb)) {
     CQLEncodeLength(-1, buffer);
     return;
   }
 
   switch (ql_type->main()) {
     case INT8:
-      CQLEncodeNum(Store8, int8_value(), buffer);
+      CQLEncodeNum(Store8, static_cast<int8_t>(pb.int8_value()), buffer);
       return;
     case INT16:
-      CQLEncodeNum(NetworkByteOrder::Store16, int16_value(), buffer);
+      CQLEncodeNum(NetworkByteOrder::Store16, static_cast<int16_t>(pb.int16_value()), buffer);
       return;
     case INT32:
-      CQLEncodeNum(NetworkByteOrder::Store32, int32_value(), buffer);
+      CQLEncodeNum(NetworkByteOrder::Store32, pb.int32_value(), buffer);
       return;
     case INT64:
-      CQLEncodeNum(NetworkByteOrder::Store64, int64_value(), buffer);
+      CQLEncodeNum(NetworkByteOrder::Store64, pb.int64_value(), buffer);
       return;
     case FLOAT:
-      CQLEncodeFloat(NetworkByteOrder::Store32, float_value(), buffer);
+      CQLEncodeFloat(NetworkByteOrder::Store32, pb.float_value(), buffer);
       return;
     case DOUBLE:
-      CQLEncodeFloat(NetworkByteOrder::Store64, double_value(), buffer);
+      CQLEncodeFloat(NetworkByteOrder::Store64, pb.double_value(), buffer);
       return;
     case DECIMAL: {
-      auto decimal = util::DecimalFromComparable(decimal_value());
+      auto decimal = util::DecimalFromComparable(pb.decimal_value());
       bool is_out_of_range = false;
       CQLEncodeBytes(decimal.EncodeToSerializedBigDecimal(&is_out_of_range), buffer);
       if(is_out_of_range) {
@@ -339,24 +344,27 @@ void QLValue::Serialize(
     }
     case VARINT: {
       bool is_out_of_range = false;
-      CQLEncodeBytes(varint_value().EncodeToTwosComplement(&is_out_of_range), buffer);
+      util::VarInt varint;
+      size_t num_decoded_bytes;
+      CHECK_OK(varint.DecodeFromComparable(pb.varint_value(), &num_decoded_bytes));
+      CQLEncodeBytes(varint.EncodeToTwosComplement(&is_out_of_range), buffer);
       // This should never happen
       if(is_out_of_range) {
-        LOG(ERROR) << "Varint encoding returned out of range for " << varint_value().ToString();
+        LOG(ERROR) << "Varint encoding returned out of range for " << varint.ToString();
       }
       return;
     }
     case STRING:
-      CQLEncodeBytes(string_value(), buffer);
+      CQLEncodeBytes(pb.string_value(), buffer);
       return;
     case BOOL:
-      CQLEncodeNum(Store8, static_cast<uint8>(bool_value() ? 1 : 0), buffer);
+      CQLEncodeNum(Store8, static_cast<uint8>(pb.bool_value() ? 1 : 0), buffer);
       return;
     case BINARY:
-      CQLEncodeBytes(binary_value(), buffer);
+      CQLEncodeBytes(pb.binary_value(), buffer);
       return;
     case TIMESTAMP: {
-      int64_t val = DateTime::AdjustPrecision(timestamp_value_pb(),
+      int64_t val = DateTime::AdjustPrecision(pb.timestamp_value(),
                                               DateTime::kInternalPrecision,
                                               DateTime::CqlDateTimeInputFormat.input_precision());
       CQLEncodeNum(NetworkByteOrder::Store64, val, buffer);
@@ -364,33 +372,38 @@ void QLValue::Serialize(
     }
     case INET: {
       std::string bytes;
-      CHECK_OK(inetaddress_value().ToBytes(&bytes));
+      InetAddress addr;
+      CHECK_OK(addr.FromBytes(pb.inetaddress_value()));
+      CHECK_OK(addr.ToBytes(&bytes));
       CQLEncodeBytes(bytes, buffer);
       return;
     }
     case JSONB: {
       std::string json;
-      Jsonb jsonb(jsonb_value());
+      Jsonb jsonb(pb.jsonb_value());
       CHECK_OK(jsonb.ToJsonString(&json));
       CQLEncodeBytes(json, buffer);
       return;
     }
     case UUID: {
       std::string bytes;
-      CHECK_OK(uuid_value().ToBytes(&bytes));
+      Uuid uuid;
+      CHECK_OK(uuid.FromBytes(pb.uuid_value()));
+      CHECK_OK(uuid.ToBytes(&bytes));
       CQLEncodeBytes(bytes, buffer);
       return;
     }
     case TIMEUUID: {
       std::string bytes;
-      Uuid uuid = timeuuid_value();
+      Uuid uuid;
+      CHECK_OK(uuid.FromBytes(pb.timeuuid_value()));
       CHECK_OK(uuid.IsTimeUuid());
       CHECK_OK(uuid.ToBytes(&bytes));
       CQLEncodeBytes(bytes, buffer);
       return;
     }
     case MAP: {
-      QLMapValuePB map = map_value();
+      const QLMapValuePB& map = pb.map_value();
       DCHECK_EQ(map.keys_size(), map.values_size());
       int32_t start_pos = CQLStartCollection(buffer);
       int32_t length = static_cast<int32_t>(map.keys_size());
@@ -398,39 +411,39 @@ void QLValue::Serialize(
       const shared_ptr<QLType>& keys_type = ql_type->params()[0];
       const shared_ptr<QLType>& values_type = ql_type->params()[1];
       for (int i = 0; i < length; i++) {
-        QLValue(map.keys(i)).Serialize(keys_type, client, buffer);
-        QLValue(map.values(i)).Serialize(values_type, client, buffer);
+        Serialize(keys_type, client, map.keys(i), buffer);
+        Serialize(values_type, client, map.values(i), buffer);
       }
       CQLFinishCollection(start_pos, buffer);
       return;
     }
     case SET: {
-      QLSeqValuePB set = set_value();
+      const QLSeqValuePB& set = pb.set_value();
       int32_t start_pos = CQLStartCollection(buffer);
       int32_t length = static_cast<int32_t>(set.elems_size());
       CQLEncodeLength(length, buffer); // number of elements in collection
       const shared_ptr<QLType>& elems_type = ql_type->param_type(0);
       for (auto& elem : set.elems()) {
-        QLValue(elem).Serialize(elems_type, client, buffer);
+        Serialize(elems_type, client, elem, buffer);
       }
       CQLFinishCollection(start_pos, buffer);
       return;
     }
     case LIST: {
-      QLSeqValuePB list = list_value();
+      const QLSeqValuePB& list = pb.list_value();
       int32_t start_pos = CQLStartCollection(buffer);
       int32_t length = static_cast<int32_t>(list.elems_size());
       CQLEncodeLength(length, buffer);
       const shared_ptr<QLType>& elems_type = ql_type->param_type(0);
       for (auto& elem : list.elems()) {
-        QLValue(elem).Serialize(elems_type, client, buffer);
+        Serialize(elems_type, client, elem, buffer);
       }
       CQLFinishCollection(start_pos, buffer);
       return;
     }
 
     case USER_DEFINED_TYPE: {
-      QLMapValuePB map = map_value();
+      const QLMapValuePB& map = pb.map_value();
       DCHECK_EQ(map.keys_size(), map.values_size());
       int32_t start_pos = CQLStartCollection(buffer);
 
@@ -439,7 +452,7 @@ void QLValue::Serialize(
       int key_idx = 0;
       for (int i = 0; i < ql_type->udtype_field_names().size(); i++) {
         if (key_idx < map.keys_size() && map.keys(key_idx).int16_value() == i) {
-          QLValue(map.values(key_idx)).Serialize(ql_type->param_type(i), client, buffer);
+          Serialize(ql_type->param_type(i), client, map.values(key_idx), buffer);
           key_idx++;
         } else { // entry not found -> writing null
           CQLEncodeLength(-1, buffer);
@@ -450,7 +463,7 @@ void QLValue::Serialize(
       return;
     }
     case FROZEN: {
-      QLSeqValuePB frozen = frozen_value();
+      const QLSeqValuePB& frozen = pb.frozen_value();
       const auto& type = ql_type->param_type(0);
       switch (type->main()) {
         case MAP: {
@@ -461,8 +474,8 @@ void QLValue::Serialize(
           const shared_ptr<QLType> &keys_type = type->params()[0];
           const shared_ptr<QLType> &values_type = type->params()[1];
           for (int i = 0; i < length; i++) {
-            QLValue(frozen.elems(2 * i)).Serialize(keys_type, client, buffer);
-            QLValue(frozen.elems(2 * i + 1)).Serialize(values_type, client, buffer);
+            Serialize(keys_type, client, frozen.elems(2 * i), buffer);
+            Serialize(values_type, client, frozen.elems(2 * i + 1), buffer);
           }
           CQLFinishCollection(start_pos, buffer);
           return;
@@ -474,7 +487,7 @@ void QLValue::Serialize(
           CQLEncodeLength(length, buffer); // number of elements in collection
           const shared_ptr<QLType> &elems_type = type->param_type(0);
           for (auto &elem : frozen.elems()) {
-            QLValue(elem).Serialize(elems_type, client, buffer);
+            Serialize(elems_type, client, elem, buffer);
           }
           CQLFinishCollection(start_pos, buffer);
           return;
@@ -482,7 +495,7 @@ void QLValue::Serialize(
         case USER_DEFINED_TYPE: {
           int32_t start_pos = CQLStartCollection(buffer);
           for (int i = 0; i < frozen.elems_size(); i++) {
-            QLValue(frozen.elems(i)).Serialize(type->param_type(i), client, buffer);
+            Serialize(type->param_type(i), client, frozen.elems(i), buffer);
           }
           CQLFinishCollection(start_pos, buffer);
           return;
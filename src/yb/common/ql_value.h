@@ -374,6 +374,11 @@ class QLValue {
   virtual void Serialize(const std::shared_ptr<QLType>& ql_type,
                          const QLClient& client,
                          faststring* buffer) const;
+  // Serializes the protobuf value in place, elements of collections are not copied.
+  static void Serialize(const std::shared_ptr<QLType>& ql_type,
+                        const QLClient& client,
+                        const QLValuePB& pb,
+                        faststring* buffer);
   virtual CHECKED_STATUS Deserialize(const std::shared_ptr<QLType>& ql_type,
                                      const QLClient& client,
                                      Slice* data);
@@ -461,6 +461,54 @@ TEST(TestSchema, TestTableProperties) {
   ASSERT_FALSE(properties3.HasDefaultTimeToLive());
 }
 
+TEST(TestSchema, TestTablePropertiesUseRowCache) {
+  TableProperties properties;
+  ASSERT_FALSE(properties.use_row_cache());
+
+  properties.SetUseRowCache(true);
+  TablePropertiesPB pb;
+  properties.ToTablePropertiesPB(&pb);
+  ASSERT_TRUE(pb.use_row_cache());
+  ASSERT_TRUE(TableProperties::FromTablePropertiesPB(pb).use_row_cache());
+
+  // Altering other properties keeps the row cache setting.
+  TablePropertiesPB alter_pb;
+  alter_pb.set_default_time_to_live(1000);
+  properties.AlterFromTablePropertiesPB(alter_pb);
+  ASSERT_TRUE(properties.use_row_cache());
+
+  alter_pb.set_use_row_cache(false);
+  properties.AlterFromTablePropertiesPB(alter_pb);
+  ASSERT_FALSE(properties.use_row_cache());
+
+  properties.SetUseRowCache(true);
+  properties.Reset();
+  ASSERT_FALSE(properties.use_row_cache());
+}
+
+TEST(TestSchema, TestTablePropertiesReadOnly) {
+  TableProperties properties;
+  TablePropertiesPB pb;
+  properties.ToTablePropertiesPB(&pb);
+  ASSERT_FALSE(pb.has_is_read_only());
+
+  TablePropertiesPB alter_pb;
+  alter_pb.set_is_read_only(true);
+  properties.AlterFromTablePropertiesPB(alter_pb);
+  ASSERT_TRUE(properties.is_read_only());
+  properties.ToTablePropertiesPB(&pb);
+  ASSERT_TRUE(TableProperties::FromTablePropertiesPB(pb).is_read_only());
+
+  // Read only table could not be made writable again, also by altering other properties.
+  alter_pb.set_is_read_only(false);
+  properties.AlterFromTablePropertiesPB(alter_pb);
+  ASSERT_TRUE(properties.is_read_only());
+  alter_pb.Clear();
+  alter_pb.set_default_time_to_live(1000);
+  properties.AlterFromTablePropertiesPB(alter_pb);
+  ASSERT_TRUE(properties.is_read_only());
+}
+
 #ifdef NDEBUG
 TEST(TestKeyEncoder, BenchmarkSimpleKey) {
   faststring fs;
@@ -83,6 +83,10 @@ void TableProperties::ToTablePropertiesPB(TablePropertiesPB *pb) const {
   if (HasCopartitionTableId()) {
     pb->set_copartition_table_id(copartition_table_id_);
   }
+  pb->set_use_row_cache(use_row_cache_);
+  if (is_read_only_) {
+    pb->set_is_read_only(true);
+  }
 }
 
 TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -102,6 +106,12 @@ TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB&
   if (pb.has_copartition_table_id()) {
     table_properties.SetCopartitionTableId(pb.copartition_table_id());
   }
+  if (pb.has_use_row_cache()) {
+    table_properties.SetUseRowCache(pb.use_row_cache());
+  }
+  if (pb.has_is_read_only()) {
+    table_properties.SetReadOnly(pb.is_read_only());
+  }
   return table_properties;
 }
 
@@ -118,6 +128,13 @@ void TableProperties::AlterFromTablePropertiesPB(const TablePropertiesPB& pb) {
   if (pb.has_copartition_table_id()) {
     SetCopartitionTableId(pb.copartition_table_id());
   }
+  if (pb.has_use_row_cache()) {
+    SetUseRowCache(pb.use_row_cache());
+  }
+  // Archived tables are not expected to be written again, so read only could not be cleared.
+  if (pb.is_read_only()) {
+    SetReadOnly(true);
+  }
 }
 
 void TableProperties::Reset() {
@@ -126,6 +143,8 @@ void TableProperties::Reset() {
   is_transactional_ = false;
   consistency_level_ = YBConsistencyLevel::STRONG;
   copartition_table_id_ = kNoCopartitionTableId;
+  use_row_cache_ = false;
+  is_read_only_ = false;
 }
 
 Schema::Schema(const Schema& other)
@@ -407,6 +407,22 @@ class TableProperties {
     consistency_level_ = consistency_level;
   }
 
+  bool use_row_cache() const {
+    return use_row_cache_;
+  }
+
+  void SetUseRowCache(bool use_row_cache) {
+    use_row_cache_ = use_row_cache;
+  }
+
+  bool is_read_only() const {
+    return is_read_only_;
+  }
+
+  void SetReadOnly(bool is_read_only) {
+    is_read_only_ = is_read_only;
+  }
+
   TableId CopartitionTableId() const {
     return copartition_table_id_;
   }
@@ -434,6 +450,8 @@ class TableProperties {
   bool is_transactional_ = false;
   YBConsistencyLevel consistency_level_ = YBConsistencyLevel::STRONG;
   TableId copartition_table_id_ = kNoCopartitionTableId;
+  bool use_row_cache_ = false;
+  bool is_read_only_ = false;
 };
 
 // The schema for a set of rows.
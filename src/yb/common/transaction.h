@@ -16,6 +16,8 @@
 #ifndef YB_COMMON_TRANSACTION_H
 #define YB_COMMON_TRANSACTION_H
 
+#include <unordered_set>
+
 #include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 #include <boost/uuid/uuid.hpp>
@@ -41,6 +43,7 @@ namespace yb {
 
 using TransactionId = boost::uuids::uuid;
 typedef boost::hash<TransactionId> TransactionIdHash;
+typedef std::unordered_set<TransactionId, TransactionIdHash> TransactionIdSet;
 
 inline TransactionId GenerateTransactionId() { return Uuid::Generate(); }
 
@@ -106,6 +109,14 @@ class TransactionStatusManager {
 
   virtual void Abort(const TransactionId& id, TransactionStatusCallback callback) = 0;
 
+  // Returns final status of transaction, i.e. COMMITTED with commit time or ABORTED, if it was
+  // already found by some reader.
+  virtual boost::optional<TransactionStatusResult> ResolvedStatus(const TransactionId& id) = 0;
+
+  // Remembers final status of transaction, found by a reader, for other readers.
+  virtual void SetResolvedStatus(
+      const TransactionId& id, const TransactionStatusResult& result) = 0;
+
  private:
   friend class RequestScope;
 
@@ -131,6 +131,7 @@ class ConsensusAppendCallback {
 };
 
 YB_STRONGLY_TYPED_BOOL(TEST_SuppressVoteRequest);
+YB_STRONGLY_TYPED_BOOL(PreElection);
 
 // The external interface for a consensus peer.
 //
@@ -199,6 +200,11 @@ class Consensus {
         mode, pending_commit, must_be_committed_opid, originator_uuid, suppress_vote_request);
   }
 
+  // Called on the protege, when the leader of the specified term stepped down in its favor and
+  // revoked its lease. None of hybrid times used by the old leader is greater than ht_bound.
+  // If the protege wins an election for the next term, it does not wait out the old leader's lease.
+  virtual void LeaderLeaseRevoked(ConsensusTerm term, MicrosTime ht_bound) {}
+
   // We tried to step down, so you protege become leader.
   // But it failed to win election, so we should reset our withhold time and try to reelect ourself.
   // election_lost_by_uuid - uuid of protege that lost election.
@@ -350,6 +356,14 @@ class Consensus {
     return STATUS(NotFound, "Not implemented.");
   }
 
+  // Reads committed operations that follow 'from' from the log, for change data capture. Readers
+  // are expected to anchor the log at 'from' via LogAnchorRegistry, so operations they did not
+  // read yet are not garbage collected. Returns an empty result when there are no new committed
+  // operations.
+  virtual CHECKED_STATUS ReadReplicatedMessagesForCDC(const OpId& from, ReplicateMsgs* msgs) {
+    return STATUS(NotSupported, "Not implemented.");
+  }
+
   // Assuming we are the leader, wait until we have a valid leader lease (i.e. the old leader's
   // lease has expired, and we have replicated a new lease that has not expired yet).
   virtual CHECKED_STATUS WaitForLeaderLeaseImprecise(MonoTime deadline) = 0;
@@ -518,6 +532,11 @@ class ReplicaOperationFactory {
       const ConsensusRoundPtr& context, HybridTime propagated_safe_time) = 0;
   virtual void SetPropagatedSafeTime(HybridTime ht) = 0;
 
+  // Invoked before and after a run of committed operations is applied on a follower, so applies
+  // of operations from this run could be combined.
+  virtual void BeginApplyBatch() {}
+  virtual void EndApplyBatch() {}
+
   virtual ~ReplicaOperationFactory() {}
 };
 
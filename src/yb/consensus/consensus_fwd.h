@@ -28,6 +28,8 @@ typedef std::unique_ptr<ConsensusServiceProxy> ConsensusServiceProxyPtr;
 class PeerProxy;
 typedef std::unique_ptr<PeerProxy> PeerProxyPtr;
 
+class MultiRaftHeartbeatBatcher;
+
 } // namespace consensus
 } // namespace yb
 
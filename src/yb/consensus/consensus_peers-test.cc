@@ -30,7 +30,9 @@
 // under the License.
 //
 
+#include <atomic>
 #include <chrono>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -47,6 +49,7 @@
 #include "yb/fs/fs_manager.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 #include "yb/util/threadpool.h"
@@ -54,6 +57,9 @@
 
 using namespace std::chrono_literals;
 
+DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_int32(consensus_max_in_flight_requests_per_peer);
+
 METRIC_DECLARE_entity(tablet);
 
 namespace yb {
@@ -69,6 +75,38 @@ const char* kTabletId = "test-peers-tablet";
 const char* kLeaderUuid = "peer-0";
 const char* kFollowerUuid = "peer-1";
 
+// Delays responses, so several requests could be in flight to the peer.
+class SlowNoOpTestPeerProxy : public NoOpTestPeerProxy {
+ public:
+  using NoOpTestPeerProxy::NoOpTestPeerProxy;
+
+  void UpdateAsync(const ConsensusRequestPB* request,
+                   RequestTriggerMode trigger_mode,
+                   ConsensusResponsePB* response,
+                   rpc::RpcController* controller,
+                   const rpc::ResponseCallback& callback) override {
+    auto in_flight = ++in_flight_;
+    auto max_in_flight = max_in_flight_.load();
+    while (in_flight > max_in_flight &&
+           !max_in_flight_.compare_exchange_weak(max_in_flight, in_flight)) {
+    }
+    NoOpTestPeerProxy::UpdateAsync(
+        request, trigger_mode, response, controller, [this, callback] {
+      std::this_thread::sleep_for(10ms);
+      --in_flight_;
+      callback();
+    });
+  }
+
+  int max_in_flight() const {
+    return max_in_flight_.load();
+  }
+
+ private:
+  std::atomic<int> in_flight_{0};
+  std::atomic<int> max_in_flight_{0};
+};
+
 class ConsensusPeersTest : public YBTest {
  public:
   ConsensusPeersTest()
@@ -193,6 +231,28 @@ TEST_F(ConsensusPeersTest, TestRemotePeer) {
   CheckLastRemoteEntry(proxy, 2, 20);
 }
 
+TEST_F(ConsensusPeersTest, TestPipelinedRemotePeer) {
+  FLAGS_consensus_max_in_flight_requests_per_peer = 4;
+  // Send a few operations per request.
+  FLAGS_consensus_max_batch_size_bytes = 4_KB;
+
+  RaftPeerPB peer_pb;
+  peer_pb.set_permanent_uuid(kFollowerUuid);
+  auto proxy = new SlowNoOpTestPeerProxy(raft_pool_.get(), peer_pb);
+  auto remote_peer = ASSERT_RESULT(Peer::NewRemotePeer(
+      peer_pb, kTabletId, kLeaderUuid, message_queue_.get(), raft_pool_token_.get(),
+      PeerProxyPtr(proxy), nullptr /* consensus */));
+
+  AppendReplicateMessagesToQueue(message_queue_.get(), clock_, 1, 100, 1_KB);
+  remote_peer->SetTermForTest(14);
+  ASSERT_OK(remote_peer->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+
+  WaitForMajorityReplicatedIndex(100);
+  ASSERT_EQ(yb::OpId::FromPB(proxy->last_received()), yb::OpId(14, 100));
+  ASSERT_GT(proxy->max_in_flight(), 1);
+  remote_peer->Close();
+}
+
 TEST_F(ConsensusPeersTest, TestLocalAppendAndRemotePeerDelay) {
   // Create a set of remote peers
   std::unique_ptr<Peer> remote_peer1;
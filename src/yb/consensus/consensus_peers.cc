@@ -47,6 +47,8 @@
 #include "yb/consensus/consensus.proxy.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/log_compression.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
@@ -69,7 +71,20 @@ DEFINE_int32(consensus_rpc_timeout_ms, 3000,
              "Timeout used for all consensus internal RPC communications.");
 TAG_FLAG(consensus_rpc_timeout_ms, advanced);
 
+DEFINE_int32(consensus_max_in_flight_requests_per_peer, 1,
+             "Max number of UpdateConsensus RPCs with operations that the leader could have "
+             "outstanding to a single peer. When greater than one, the leader sends following "
+             "operations without waiting for the peer to acknowledge the previous ones.");
+TAG_FLAG(consensus_max_in_flight_requests_per_peer, advanced);
+
+DEFINE_bool(consensus_compress_ops, false,
+            "Compress operations sent to followers with LZ4. All servers of the cluster should "
+            "support compressed operations.");
+TAG_FLAG(consensus_compress_ops, advanced);
+TAG_FLAG(consensus_compress_ops, runtime);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
+DECLARE_bool(enable_multi_raft_heartbeat_batcher);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
                  "Fraction of the time when the leader will crash just before sending an "
@@ -114,16 +129,26 @@ Peer::Peer(
       peer_pb_(peer_pb),
       proxy_(std::move(proxy)),
       queue_(queue),
-      sem_(1),
+      max_in_flight_requests_(std::max(FLAGS_consensus_max_in_flight_requests_per_peer, 1)),
+      sem_(max_in_flight_requests_),
       heartbeater_(
           peer_pb.permanent_uuid(), MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms),
           std::bind(&Peer::SignalRequest, this, RequestTriggerMode::kAlwaysSend)),
       raft_pool_token_(raft_pool_token),
       state_(kPeerCreated),
-      consensus_(consensus) {}
+      consensus_(consensus) {
+  requests_.reserve(max_in_flight_requests_);
+  free_requests_.reserve(max_in_flight_requests_);
+  for (int i = 0; i != max_in_flight_requests_; ++i) {
+    requests_.push_back(std::make_unique<InFlightRequest>());
+    free_requests_.push_back(requests_.back().get());
+  }
+}
 
 void Peer::SetTermForTest(int term) {
-  response_.set_responder_term(term);
+  for (const auto& request : requests_) {
+    request->response.set_responder_term(term);
+  }
 }
 
 Status Peer::Init() {
@@ -179,32 +204,51 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
 }
 
 void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
-  DCHECK_EQ(sem_.GetValue(), 0) << "Cannot send request";
+  DCHECK_LT(sem_.GetValue(), max_in_flight_requests_) << "Cannot send request";
 
   std::unique_lock<Semaphore> lock(sem_, std::adopt_lock);
+  std::unique_lock<std::mutex> send_lock(send_mutex_);
+
+  InFlightRequest* in_flight = AcquireRequest();
+  if (PREDICT_FALSE(!in_flight)) {
+    LOG_WITH_PREFIX_UNLOCKED(DFATAL) << "No free request while holding the semaphore";
+    return;
+  }
+  auto& request = in_flight->request;
+  // Other requests that were sent to the peer and did not get response yet.
+  const bool other_requests_in_flight = in_flight_requests() > 1;
 
   // The peer has no pending request nor is sending: send the request.
   bool needs_remote_bootstrap = false;
   bool last_exchange_successful = false;
   RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
-  int64_t commit_index_before = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
-  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request_,
-      &replicate_msg_refs_, &needs_remote_bootstrap, &member_type, &last_exchange_successful);
-  int64_t commit_index_after = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
+  int64_t commit_index_before = last_sent_committed_index_;
+  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request,
+      &in_flight->replicate_msg_refs, &needs_remote_bootstrap, &member_type,
+      &last_exchange_successful);
+  int64_t commit_index_after = request.has_committed_index() ?
+      request.committed_index().index() : kMinimumOpIdIndex;
 
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX_UNLOCKED(INFO) << "Could not obtain request from queue for peer: "
         << peer_pb_.permanent_uuid() << ". Status: " << s.ToString();
+    ReleaseRequest(in_flight);
+    return;
+  }
+
+  // Requests are pipelined only while exchanges with the peer are successful. Otherwise we wait
+  // for outstanding requests, their responses will trigger the next request.
+  if (other_requests_in_flight && (needs_remote_bootstrap || !last_exchange_successful)) {
+    ReleaseRequest(in_flight);
     return;
   }
 
   if (PREDICT_FALSE(needs_remote_bootstrap)) {
-    Status s = SendRemoteBootstrapRequest();
+    Status s = SendRemoteBootstrapRequest(in_flight);
     if (!s.ok()) {
       LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Unable to generate remote bootstrap request for peer: "
                                         << s.ToString();
+      ReleaseRequest(in_flight);
     } else {
       lock.release();
     }
@@ -217,6 +261,8 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
       (member_type == RaftPeerPB::PRE_VOTER || member_type == RaftPeerPB::PRE_OBSERVER)) {
     if (PREDICT_TRUE(consensus_)) {
       auto uuid = peer_pb_.permanent_uuid();
+      ReleaseRequest(in_flight);
+      send_lock.unlock();
       lock.unlock();
       consensus::ChangeConfigRequestPB req;
       consensus::ChangeConfigResponsePB resp;
@@ -244,15 +290,21 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     }
   }
 
-  request_.set_tablet_id(tablet_id_);
-  request_.set_caller_uuid(leader_uuid_);
-  request_.set_dest_uuid(peer_pb_.permanent_uuid());
+  request.set_tablet_id(tablet_id_);
+  request.set_caller_uuid(leader_uuid_);
+  request.set_dest_uuid(peer_pb_.permanent_uuid());
+  last_sent_committed_index_ = commit_index_after;
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool req_has_ops = (request.ops_size() > 0) || (commit_index_after > commit_index_before);
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
   // happens during heartbeats). If not, just return.
-  if (PREDICT_FALSE(!req_has_ops && trigger_mode == RequestTriggerMode::kNonEmptyOnly)) {
+  // Status-only messages are not sent while other requests are in flight, since their responses
+  // carry the same information.
+  if (PREDICT_FALSE(!req_has_ops &&
+                    (trigger_mode == RequestTriggerMode::kNonEmptyOnly ||
+                     other_requests_in_flight))) {
+    ReleaseRequest(in_flight);
     return;
   }
 
@@ -262,22 +314,62 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   }
 
   MAYBE_FAULT(FLAGS_fault_crash_on_leader_request_fraction);
-  controller_.Reset();
+  in_flight->controller.Reset();
+  if (max_in_flight_requests_ > 1) {
+    queue_->RequestSentToPeer(peer_pb_.permanent_uuid(), request);
+    // Fill the window with requests for the following operations.
+    if (request.ops_size() > 0 && last_exchange_successful) {
+      WARN_NOT_OK(SignalRequest(RequestTriggerMode::kNonEmptyOnly),
+                  "Failed to signal pipelined request");
+    }
+  }
+  if (FLAGS_consensus_compress_ops && request.ops_size() > 0) {
+    WARN_NOT_OK(log::CompressOps(&request), "Failed to compress ops, sending them uncompressed");
+  }
 
   lock.release();
-  proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
-                      std::bind(&Peer::ProcessResponse, this));
+  if (!req_has_ops &&
+      proxy_->HeartbeatAsync(
+          &request, &in_flight->response,
+          std::bind(&Peer::ProcessResponse, this, in_flight, std::placeholders::_1))) {
+    return;
+  }
+  proxy_->UpdateAsync(&request, trigger_mode, &in_flight->response, &in_flight->controller,
+                      [this, in_flight] {
+    ProcessResponse(in_flight, in_flight->controller.status());
+  });
+}
+
+Peer::InFlightRequest* Peer::AcquireRequest() {
+  std::lock_guard<simple_spinlock> l(peer_lock_);
+  if (free_requests_.empty()) {
+    return nullptr;
+  }
+  auto result = free_requests_.back();
+  free_requests_.pop_back();
+  return result;
+}
+
+void Peer::ReleaseRequest(InFlightRequest* request) {
+  std::lock_guard<simple_spinlock> l(peer_lock_);
+  free_requests_.push_back(request);
+}
+
+size_t Peer::in_flight_requests() {
+  std::lock_guard<simple_spinlock> l(peer_lock_);
+  return requests_.size() - free_requests_.size();
 }
 
-void Peer::ProcessResponse() {
+void Peer::ProcessResponse(InFlightRequest* request, const Status& status) {
   // Note: This method runs on the reactor thread.
 
-  DCHECK_EQ(sem_.GetValue(), 0) << "Got a response when nothing was pending";
+  DCHECK_LT(sem_.GetValue(), max_in_flight_requests_) << "Got a response when nothing was pending";
 
   std::unique_lock<Semaphore> lock(sem_, std::adopt_lock);
+  const auto& response = request->response;
 
-  if (!controller_.status().ok()) {
-    if (controller_.status().IsRemoteError()) {
+  if (!status.ok()) {
+    if (status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
       // failure to serialize a protobuf. Therefore, we generally consider these errors to indicate
       // an unreachable peer.  However, a RemoteError wraps some other error propagated from the
@@ -285,54 +377,57 @@ void Peer::ProcessResponse() {
       // remote is responsive.
       queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
     }
-    ProcessResponseError(controller_.status());
+    ProcessResponseError(request, status);
     return;
   }
 
   // We should try to evict a follower which returns a WRONG UUID error.
-  if (response_.has_error() &&
-      response_.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
+  if (response.has_error() &&
+      response.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
     queue_->NotifyObserversOfFailedFollower(
         peer_pb_.permanent_uuid(),
         Substitute("Leader communication with peer $0 received error $1, will try to "
                    "evict peer", peer_pb_.permanent_uuid(),
-                   response_.error().ShortDebugString()));
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+                   response.error().ShortDebugString()));
+    ProcessResponseError(request, StatusFromPB(response.error().status()));
     return;
   }
 
   // Pass through errors we can respond to, like not found, since in that case
   // we will need to remotely bootstrap. TODO: Handle DELETED response once implemented.
-  if ((response_.has_error() &&
-      response_.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
-      (response_.status().has_error() &&
-          response_.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
+  if ((response.has_error() &&
+      response.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
+      (response.status().has_error() &&
+          response.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
     // Again, let the queue know that the remote is still responsive, since we will not be sending
     // this error response through to the queue.
     queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+    ProcessResponseError(request, StatusFromPB(response.error().status()));
     return;
   }
 
   // The queue's handling of the peer response may generate IO (reads against the WAL) and
   // SendNextRequest() may do the same thing. So we run the rest of the response handling logic on
   // our thread pool and not on the reactor thread.
-  Status s = raft_pool_token_->SubmitClosure(Bind(&Peer::DoProcessResponse, Unretained(this)));
+  Status s = raft_pool_token_->SubmitClosure(
+      Bind(&Peer::DoProcessResponse, Unretained(this), request));
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Unable to process peer response: " << s.ToString()
-        << ": " << response_.ShortDebugString();
+        << ": " << response.ShortDebugString();
+    ReleaseRequest(request);
   } else {
     lock.release();
   }
 }
 
-void Peer::DoProcessResponse() {
-  DCHECK_EQ(0, sem_.GetValue());
+void Peer::DoProcessResponse(InFlightRequest* request) {
+  DCHECK_LT(sem_.GetValue(), max_in_flight_requests_);
   std::unique_lock<Semaphore> lock(sem_, std::adopt_lock);
 
   failed_attempts_ = 0;
   bool more_pending = false;
-  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_, &more_pending);
+  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), request->response, &more_pending);
+  ReleaseRequest(request);
 
   if (more_pending && state_.load(std::memory_order_acquire) != kPeerClosed) {
     lock.release();
@@ -340,7 +435,7 @@ void Peer::DoProcessResponse() {
   }
 }
 
-Status Peer::SendRemoteBootstrapRequest() {
+Status Peer::SendRemoteBootstrapRequest(InFlightRequest* request) {
   if (!FLAGS_enable_remote_bootstrap) {
     failed_attempts_++;
     return STATUS(NotSupported, "remote bootstrap is disabled");
@@ -348,15 +443,16 @@ Status Peer::SendRemoteBootstrapRequest() {
 
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Sending request to remotely bootstrap";
   RETURN_NOT_OK(queue_->GetRemoteBootstrapRequestForPeer(peer_pb_.permanent_uuid(), &rb_request_));
-  controller_.Reset();
+  request->controller.Reset();
   proxy_->StartRemoteBootstrap(
-      &rb_request_, &rb_response_, &controller_,
-      std::bind(&Peer::ProcessRemoteBootstrapResponse, this));
+      &rb_request_, &rb_response_, &request->controller,
+      std::bind(&Peer::ProcessRemoteBootstrapResponse, this, request));
   return Status::OK();
 }
 
-void Peer::ProcessRemoteBootstrapResponse() {
+void Peer::ProcessRemoteBootstrapResponse(InFlightRequest* request) {
   std::unique_lock<Semaphore> lock(sem_, std::adopt_lock);
+  ReleaseRequest(request);
 
   // We treat remote bootstrap as fire-and-forget.
   if (rb_response_.has_error()) {
@@ -365,8 +461,9 @@ void Peer::ProcessRemoteBootstrapResponse() {
   }
 }
 
-void Peer::ProcessResponseError(const Status& status) {
-  DCHECK_EQ(0, sem_.GetValue());
+void Peer::ProcessResponseError(InFlightRequest* request, const Status& status) {
+  DCHECK_LT(sem_.GetValue(), max_in_flight_requests_);
+  ReleaseRequest(request);
   failed_attempts_++;
   LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Couldn't send request to peer " << peer_pb_.permanent_uuid()
       << " for tablet " << tablet_id_
@@ -395,11 +492,19 @@ void Peer::Close() {
   // Acquire the semaphore to wait for any concurrent request to finish.  They will see the state_
   // == kPeerClosed and not start any new requests, but we can't currently cancel the already-sent
   // ones. (see KUDU-699)
-  std::lock_guard<Semaphore> l(sem_);
+  for (int i = 0; i != max_in_flight_requests_; ++i) {
+    sem_.Acquire();
+  }
   queue_->UntrackPeer(peer_pb_.permanent_uuid());
-  // We don't own the ops (the queue does).
-  request_.mutable_ops()->ExtractSubrange(0, request_.ops_size(), /* elements */ nullptr);
-  replicate_msg_refs_.clear();
+  for (const auto& request : requests_) {
+    // We don't own the ops (the queue does).
+    request->request.mutable_ops()->ExtractSubrange(
+        0, request->request.ops_size(), /* elements */ nullptr);
+    request->replicate_msg_refs.clear();
+  }
+  for (int i = 0; i != max_in_flight_requests_; ++i) {
+    sem_.Release();
+  }
 }
 
 Peer::~Peer() {
@@ -407,8 +512,10 @@ Peer::~Peer() {
 }
 
 RpcPeerProxy::RpcPeerProxy(HostPort hostport,
-                           ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(hostport), consensus_proxy_(std::move(consensus_proxy)) {
+                           ConsensusServiceProxyPtr consensus_proxy,
+                           std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher)
+    : hostport_(hostport), consensus_proxy_(std::move(consensus_proxy)),
+      heartbeat_batcher_(std::move(heartbeat_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -420,6 +527,16 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+bool RpcPeerProxy::HeartbeatAsync(const ConsensusRequestPB* request,
+                                  ConsensusResponsePB* response,
+                                  const StdStatusCallback& callback) {
+  if (!heartbeat_batcher_) {
+    return false;
+  }
+  heartbeat_batcher_->AddRequest(request, response, callback);
+  return true;
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -458,7 +575,12 @@ RpcPeerProxyFactory::RpcPeerProxyFactory(
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(peer_pb.last_known_addr());
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(hostport, std::move(proxy));
+  std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher;
+  if (FLAGS_enable_multi_raft_heartbeat_batcher && messenger_) {
+    heartbeat_batcher = MultiRaftHeartbeatBatcher::Get(hostport, proxy_cache_, messenger_);
+  }
+  return std::make_unique<RpcPeerProxy>(
+      hostport, std::move(proxy), std::move(heartbeat_batcher));
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
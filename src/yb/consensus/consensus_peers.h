@@ -35,6 +35,7 @@
 
 #include <memory>
 #include <string>
+#include <mutex>
 #include <vector>
 #include <atomic>
 
@@ -52,6 +53,7 @@
 #include "yb/util/resettable_heartbeater.h"
 #include "yb/util/semaphore.h"
 #include "yb/util/status.h"
+#include "yb/util/status_callback.h"
 
 namespace yb {
 class HostPort;
@@ -113,6 +115,11 @@ namespace consensus {
 //        v                               v
 //  SignalRequest()                    return
 //
+// When consensus_max_in_flight_requests_per_peer is greater than one, the leader does not wait for
+// the response before sending the following operations, so up to that many UpdateConsensus RPCs
+// could be outstanding to the peer. Only requests with operations are pipelined, and only after
+// a successful exchange with the peer.
+//
 class Peer;
 typedef std::unique_ptr<Peer> PeerPtr;
 
@@ -170,28 +177,52 @@ class Peer {
        PeerProxyPtr proxy, PeerMessageQueue* queue,
        ThreadPoolToken* raft_pool_token, Consensus* consensus);
 
+  // State of a single UpdateConsensus RPC to the peer.
+  struct InFlightRequest {
+    ConsensusRequestPB request;
+    ConsensusResponsePB response;
+
+    // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
+    // loaded these messages from the LogCache, in which case we are potentially sharing the same
+    // object as other peers. Since the PB request itself can't hold reference counts, this holds
+    // them.
+    ReplicateMsgs replicate_msg_refs;
+
+    rpc::RpcController controller;
+  };
+
   void SendNextRequest(RequestTriggerMode trigger_mode);
 
-  // Signals that a response was received from the peer.  This method is called from the reactor
-  // thread and calls DoProcessResponse() on raft_pool_token_ to do any work that requires IO or
-  // lock-taking.
-  void ProcessResponse();
+  // Picks a request that is not in flight. Returns nullptr if all of them are in flight.
+  InFlightRequest* AcquireRequest();
+
+  // Returns request to the set of requests that are not in flight.
+  void ReleaseRequest(InFlightRequest* request);
+
+  // Number of requests that are in flight.
+  size_t in_flight_requests();
+
+  // Signals that a response was received from the peer, status is the status of the RPC.
+  // This method is called from the reactor thread and calls DoProcessResponse() on
+  // raft_pool_token_ to do any work that requires IO or lock-taking.
+  void ProcessResponse(InFlightRequest* request, const Status& status);
 
   // Run on 'raft_pool_token'. Does response handling that requires IO or may block.
-  void DoProcessResponse();
+  void DoProcessResponse(InFlightRequest* request);
 
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
   //
   // Returns a bad Status if remote bootstrap is disabled, or if the request cannot be generated for
   // some reason.
-  CHECKED_STATUS SendRemoteBootstrapRequest();
+  // The remote bootstrap RPC occupies 'request' until it completes.
+  CHECKED_STATUS SendRemoteBootstrapRequest(InFlightRequest* request);
 
   // Handle RPC callback from initiating remote bootstrap.
-  void ProcessRemoteBootstrapResponse();
+  void ProcessRemoteBootstrapResponse(InFlightRequest* request);
 
   // Signals there was an error sending the request to the peer.
-  void ProcessResponseError(const Status& status);
+  void ProcessResponseError(InFlightRequest* request, const Status& status);
 
   std::string LogPrefixUnlocked() const;
 
@@ -207,24 +238,27 @@ class Peer {
   PeerMessageQueue* queue_;
   uint64_t failed_attempts_ = 0;
 
-  // The latest consensus update request and response.
-  ConsensusRequestPB request_;
-  ConsensusResponsePB response_;
+  // Max number of outstanding requests to the peer.
+  const int max_in_flight_requests_;
+
+  // Consensus update requests, one per possible outstanding request.
+  std::vector<std::unique_ptr<InFlightRequest>> requests_;
+
+  // Requests that are not in flight. Protected by peer_lock_.
+  std::vector<InFlightRequest*> free_requests_;
+
+  // Serializes building and sending of requests, so operations are sent to the peer in order.
+  std::mutex send_mutex_;
+
+  // Committed index sent in the latest request. Protected by send_mutex_.
+  int64_t last_sent_committed_index_ = kMinimumOpIdIndex;
 
   // The latest remote bootstrap request and response.
   StartRemoteBootstrapRequestPB rb_request_;
   StartRemoteBootstrapResponsePB rb_response_;
 
-  // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
-  // loaded these messages from the LogCache, in which case we are potentially sharing the same
-  // object as other peers. Since the PB request_ itself can't hold reference counts, this holds
-  // them.
-  ReplicateMsgs replicate_msg_refs_;
-
-  rpc::RpcController controller_;
-
-  // Held if there is an outstanding request.  This is used in order to ensure that we only have a
-  // single request outstanding at a time, and to wait for the outstanding requests at Close().
+  // Held for each outstanding request.  This is used in order to limit the number of outstanding
+  // requests to max_in_flight_requests_, and to wait for the outstanding requests at Close().
   Semaphore sem_;
 
   // Heartbeater for remote peer implementations.  This will send status only requests to the remote
@@ -260,6 +294,15 @@ class PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) = 0;
 
+  // Sends a request without operations, that could be batched with requests of other tablets to
+  // the same server. Callback is invoked with the status of the RPC.
+  // Returns false if this proxy does not batch requests, so UpdateAsync should be used instead.
+  virtual bool HeartbeatAsync(const ConsensusRequestPB* request,
+                              ConsensusResponsePB* response,
+                              const StdStatusCallback& callback) {
+    return false;
+  }
+
   // Sends a RequestConsensusVote to a remote peer.
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
@@ -310,7 +353,8 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -318,6 +362,10 @@ class RpcPeerProxy : public PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) override;
 
+  bool HeartbeatAsync(const ConsensusRequestPB* request,
+                      ConsensusResponsePB* response,
+                      const StdStatusCallback& callback) override;
+
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
                                          rpc::RpcController* controller,
@@ -343,6 +391,8 @@ class RpcPeerProxy : public PeerProxy {
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  // Not null when heartbeats are batched.
+  std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
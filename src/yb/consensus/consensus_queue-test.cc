@@ -54,6 +54,8 @@
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_int32(consensus_max_in_flight_requests_per_peer);
+DECLARE_bool(remote_bootstrap_from_followers);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -265,6 +267,88 @@ TEST_F(ConsensusQueueTest, TestStartTrackingAfterStart) {
   request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
 }
 
+TEST_F(ConsensusQueueTest, TestReadReplicatedMessagesForCDC) {
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+
+  // Only committed operations are returned.
+  ReplicateMsgs msgs;
+  ASSERT_OK(queue_->ReadReplicatedMessagesForCDC(10, 20, &msgs));
+  ASSERT_EQ(10, msgs.size());
+  ASSERT_EQ(11, msgs.front()->id().index());
+  ASSERT_EQ(20, msgs.back()->id().index());
+
+  // Nothing new was committed.
+  ASSERT_OK(queue_->ReadReplicatedMessagesForCDC(20, 20, &msgs));
+  ASSERT_TRUE(msgs.empty());
+
+  ASSERT_OK(queue_->ReadReplicatedMessagesForCDC(20, 100, &msgs));
+  ASSERT_EQ(80, msgs.size());
+  ASSERT_EQ(100, msgs.back()->id().index());
+}
+
+// Tests that with several requests in flight, the following request continues after the previous
+// one, and that responses received out of order don't move the peer watermark backward.
+TEST_F(ConsensusQueueTest, TestPipelinedRequests) {
+  FLAGS_consensus_max_in_flight_requests_per_peer = 2;
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+
+  ConsensusRequestPB first_request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+
+  UpdatePeerWatermarkToOp(&first_request, &response, MakeOpId(7, 50), MinimumOpId(),
+                          &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  // Successful exchange, after which requests could be pipelined.
+  ReplicateMsgs first_refs;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(
+      kPeerUuid, &first_request, &first_refs, &needs_remote_bootstrap));
+  ASSERT_EQ(50, first_request.ops_size());
+  queue_->RequestSentToPeer(kPeerUuid, first_request);
+  SetLastReceivedAndLastCommitted(&response, first_request.ops(49).id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_FALSE(more_pending);
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 101, 10);
+  ASSERT_OK(queue_->RequestForPeer(
+      kPeerUuid, &first_request, &first_refs, &needs_remote_bootstrap));
+  ASSERT_EQ(10, first_request.ops_size());
+  queue_->RequestSentToPeer(kPeerUuid, first_request);
+
+  // The second request is built before the response to the first one.
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 111, 10);
+  ConsensusRequestPB second_request;
+  ReplicateMsgs second_refs;
+  ASSERT_OK(queue_->RequestForPeer(
+      kPeerUuid, &second_request, &second_refs, &needs_remote_bootstrap));
+  ASSERT_EQ(10, second_request.ops_size());
+  ASSERT_EQ(111, second_request.ops(0).id().index());
+  ASSERT_EQ(110, second_request.preceding_id().index());
+  queue_->RequestSentToPeer(kPeerUuid, second_request);
+
+  // Responses arrive in reverse order.
+  SetLastReceivedAndLastCommitted(&response, second_request.ops(9).id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_FALSE(more_pending);
+  SetLastReceivedAndLastCommitted(&response, first_request.ops(9).id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+
+  auto peer = queue_->GetTrackedPeerForTests(kPeerUuid);
+  ASSERT_EQ(120, peer.last_received.index());
+  ASSERT_EQ(121, peer.next_index);
+
+  // extract the ops from the requests to avoid double free
+  first_request.mutable_ops()->ExtractSubrange(0, first_request.ops_size(), nullptr);
+  second_request.mutable_ops()->ExtractSubrange(0, second_request.ops_size(), nullptr);
+}
+
 // Tests that the peers gets the messages pages, with the size of a page being
 // 'consensus_max_batch_size_bytes'
 TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
@@ -496,6 +580,58 @@ TEST_F(ConsensusQueueTest, TestQueueAdvancesCommittedIndex) {
   ASSERT_OPID_EQ(queue_->GetMajorityReplicatedOpIdForTests(), MakeOpId(1, 10));
 }
 
+// Checks watermarks when responses of peers above the watermarks, that reuse previously computed
+// watermarks, are interleaved with responses of peers that move them.
+TEST_F(ConsensusQueueTest, TestWatermarksWithRepeatedResponses) {
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(5));
+  for (int i = 1; i <= 4; ++i) {
+    queue_->TrackPeer(Format("peer-$0", i));
+  }
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 10);
+  WaitForLocalPeerToAckIndex(10);
+
+  ConsensusResponsePB response;
+  response.set_responder_term(1);
+  bool more_pending;
+
+  auto ack = [this, &response, &more_pending](const std::string& peer, const OpId& op_id) {
+    response.set_responder_uuid(peer);
+    SetLastReceivedAndLastCommitted(&response, op_id, MinimumOpId().index());
+    queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  };
+
+  ack("peer-1", MakeOpId(0, 5));
+  ack("peer-2", MakeOpId(0, 5));
+  ASSERT_OPID_EQ(queue_->GetMajorityReplicatedOpIdForTests(), MakeOpId(0, 5));
+
+  // peer-3 is above the watermark, so its responses do not move it.
+  ack("peer-3", MakeOpId(1, 10));
+  ack("peer-3", MakeOpId(1, 10));
+  ASSERT_OPID_EQ(queue_->GetMajorityReplicatedOpIdForTests(), MakeOpId(0, 5));
+
+  // peer-1 was at the watermark, so it moves.
+  ack("peer-1", MakeOpId(1, 10));
+  ASSERT_OPID_EQ(queue_->GetMajorityReplicatedOpIdForTests(), MakeOpId(1, 10));
+
+  // peer-4 did not respond yet, so nothing is replicated to all peers.
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), MinimumOpId());
+  ack("peer-4", MakeOpId(1, 10));
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), MakeOpId(0, 5));
+
+  // Responses of peers above the minimum do not change it, until peer-2 responds.
+  ack("peer-3", MakeOpId(1, 10));
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), MakeOpId(0, 5));
+  ack("peer-2", MakeOpId(1, 10));
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), MakeOpId(1, 10));
+
+  // Untracked peer does not hold the watermarks anymore.
+  queue_->UntrackPeer("peer-2");
+  ack("peer-3", MakeOpId(1, 10));
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), MakeOpId(1, 10));
+}
+
 // In this test we append a sequence of operations to a log
 // and then start tracking a peer whose first required operation
 // is before the first operation in the queue.
@@ -864,5 +1000,44 @@ TEST_F(ConsensusQueueTest, TestTriggerRemoteBootstrapIfTabletNotFound) {
             rb_req.bootstrap_peer_addr().ShortDebugString());
 }
 
+// Test that remote bootstrap is served by a follower that is caught up.
+TEST_F(ConsensusQueueTest, TestRemoteBootstrapFromFollower) {
+  FLAGS_remote_bootstrap_from_followers = true;
+  const std::string kFollowerUuid = "peer-2";
+  const RaftConfigPB config = BuildRaftConfigPBForTests(3);
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), config);
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+  WaitForLocalPeerToAckIndex(100);
+  queue_->TrackPeer(kPeerUuid);
+  queue_->TrackPeer(kFollowerUuid);
+
+  // The follower acks all operations, and then learns that they are committed.
+  ConsensusResponsePB response;
+  response.set_responder_term(1);
+  response.set_responder_uuid(kFollowerUuid);
+  bool more_pending = false;
+  SetLastReceivedAndLastCommitted(&response, MakeOpId(14, 100), MinimumOpId().index());
+  queue_->ResponseFromPeer(kFollowerUuid, response, &more_pending);
+  queue_->raft_pool_observers_token_->Wait();
+  ASSERT_EQ(100, queue_->GetCommittedIndexForTests().index());
+  SetLastReceivedAndLastCommitted(&response, MakeOpId(14, 100));
+  queue_->ResponseFromPeer(kFollowerUuid, response, &more_pending);
+
+  // The new peer does not have the tablet.
+  ConsensusResponsePB peer_response;
+  peer_response.set_responder_uuid(kPeerUuid);
+  peer_response.mutable_error()->set_code(tserver::TabletServerErrorPB::TABLET_NOT_FOUND);
+  StatusToPB(STATUS(NotFound, "No such tablet"), peer_response.mutable_error()->mutable_status());
+  queue_->ResponseFromPeer(kPeerUuid, peer_response, &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  StartRemoteBootstrapRequestPB rb_req;
+  ASSERT_OK(queue_->GetRemoteBootstrapRequestForPeer(kPeerUuid, &rb_req));
+  ASSERT_EQ(kFollowerUuid, rb_req.bootstrap_peer_uuid());
+  ASSERT_EQ(config.peers(2).last_known_addr().ShortDebugString(),
+            rb_req.bootstrap_peer_addr().ShortDebugString());
+}
+
 }  // namespace consensus
 }  // namespace yb
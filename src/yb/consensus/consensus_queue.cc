@@ -39,6 +39,7 @@
 #include <utility>
 
 #include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
 
 #include <gflags/gflags.h>
 
@@ -96,6 +97,15 @@ DECLARE_int32(rpc_max_message_size);
 
 DEFINE_bool(propagate_safe_time, true, "Propagate safe time to read from leader to followers");
 
+DECLARE_int32(consensus_max_in_flight_requests_per_peer);
+
+DEFINE_bool(remote_bootstrap_from_followers, false,
+            "Remote bootstrap new peers from a caught up follower instead of the leader, when "
+            "there is one. The leader still sends the final log catch up and changes the role "
+            "of the new peer.");
+TAG_FLAG(remote_bootstrap_from_followers, advanced);
+TAG_FLAG(remote_bootstrap_from_followers, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -105,6 +115,95 @@ using std::unique_ptr;
 using rpc::Messenger;
 using strings::Substitute;
 
+namespace {
+
+// Policies for watermark calculation by PeerMessageQueue::GetWatermark.
+
+struct LeaderLeaseExpirationPolicy {
+  typedef MonoTime result_type;
+  // Workaround for a gcc bug. That does not understand that Comparator is actually being used.
+  __attribute__((unused)) typedef std::less<result_type> Comparator;
+
+  static result_type Min() {
+    return result_type::kMin;
+  }
+
+  static result_type Max() {
+    return result_type::kMax;
+  }
+
+  static result_type ExtractValue(const PeerMessageQueue::TrackedPeer& peer) {
+    MonoTime lease_exp = peer.last_leader_lease_expiration_received_by_follower;
+    return lease_exp.Initialized() ? lease_exp : MonoTime::kMin;
+  }
+
+  static const char* Name() {
+    return "Leader lease expiration";
+  }
+
+  static bool LocalPeerHasInfiniteWatermark() {
+    return true;
+  }
+};
+
+struct HybridTimeLeaseExpirationPolicy {
+  typedef MicrosTime result_type;
+  // Workaround for a gcc bug. That does not understand that Comparator is actually being used.
+  __attribute__((unused)) typedef std::less<result_type> Comparator;
+
+  static result_type Min() {
+    return HybridTime::kMin.GetPhysicalValueMicros();
+  }
+
+  static result_type Max() {
+    return HybridTime::kMax.GetPhysicalValueMicros();
+  }
+
+  static result_type ExtractValue(const PeerMessageQueue::TrackedPeer& peer) {
+    return peer.last_ht_lease_expiration_received_by_follower;
+  }
+
+  static const char* Name() {
+    return "Hybrid time leader lease expiration";
+  }
+
+  static bool LocalPeerHasInfiniteWatermark() {
+    return true;
+  }
+};
+
+struct OpIdPolicy {
+  typedef OpId result_type;
+
+  static result_type Min() {
+    return MinimumOpId();
+  }
+
+  static result_type Max() {
+    return MaximumOpId();
+  }
+
+  static result_type ExtractValue(const PeerMessageQueue::TrackedPeer& peer) {
+    return peer.last_received;
+  }
+
+  struct Comparator {
+    bool operator()(const OpId& lhs, const OpId& rhs) {
+      return lhs.index() < rhs.index();
+    }
+  };
+
+  static const char* Name() {
+    return "OpId";
+  }
+
+  static bool LocalPeerHasInfiniteWatermark() {
+    return false;
+  }
+};
+
+} // namespace
+
 METRIC_DEFINE_gauge_int64(tablet, majority_done_ops, "Leader Operations Acked by Majority",
                           MetricUnit::kOperations,
                           "Number of operations in the leader queue ack'd by a majority but "
@@ -168,11 +267,14 @@ void PeerMessageQueue::SetLeaderMode(const OpId& committed_index,
   queue_state_.committed_index = committed_index;
   queue_state_.majority_replicated_opid = committed_index;
   queue_state_.active_config.reset(new RaftConfigPB(active_config));
+  // The config change operation, if any, is appended right after this call.
+  queue_state_.active_config_index = queue_state_.last_appended.index() + 1;
   CHECK(IsRaftConfigVoter(local_peer_uuid_, *queue_state_.active_config))
       << local_peer_pb_.ShortDebugString() << " not a voter in config: "
       << queue_state_.active_config->ShortDebugString();
   queue_state_.majority_size_ = MajoritySize(CountVoters(*queue_state_.active_config));
   queue_state_.mode = Mode::LEADER;
+  watermarks_.valid = false;
 
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Queue going to LEADER mode. State: "
       << queue_state_.ToString();
@@ -191,6 +293,7 @@ void PeerMessageQueue::SetNonLeaderMode() {
   queue_state_.active_config.reset();
   queue_state_.mode = Mode::NON_LEADER;
   queue_state_.majority_size_ = -1;
+  watermarks_.valid = false;
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Queue going to NON_LEADER mode. State: "
       << queue_state_.ToString();
 }
@@ -214,6 +317,7 @@ PeerMessageQueue::TrackedPeer* PeerMessageQueue::TrackPeerUnlocked(const string&
   // normal queue negotiation process will eventually find the right point to resume from.
   tracked_peer->next_index = queue_state_.last_appended.index() + 1;
   InsertOrDie(&peers_map_, uuid, tracked_peer);
+  watermarks_.valid = false;
 
   CheckPeersInActiveConfigIfLeaderUnlocked();
 
@@ -228,6 +332,7 @@ void PeerMessageQueue::UntrackPeer(const string& uuid) {
   TrackedPeer* peer = EraseKeyReturnValuePtr(&peers_map_, uuid);
   if (peer != nullptr) {
     delete peer;
+    watermarks_.valid = false;
   }
 }
 
@@ -307,6 +412,26 @@ Status PeerMessageQueue::AppendOperations(const ReplicateMsgs& msgs,
   return Status::OK();
 }
 
+Status PeerMessageQueue::ReadReplicatedMessagesForCDC(int64_t after_op_index,
+                                                      int64_t committed_index,
+                                                      ReplicateMsgs* msgs) {
+  msgs->clear();
+  if (after_op_index >= committed_index) {
+    return Status::OK();
+  }
+
+  OpId preceding_id;
+  RETURN_NOT_OK(log_cache_.ReadOps(
+      after_op_index, FLAGS_consensus_max_batch_size_bytes, msgs, &preceding_id));
+
+  // The log cache could also contain operations that are not committed yet.
+  auto it = std::find_if(msgs->begin(), msgs->end(), [committed_index](const auto& msg) {
+    return msg->id().index() > committed_index;
+  });
+  msgs->erase(it, msgs->end());
+  return Status::OK();
+}
+
 Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         ConsensusRequestPB* request,
                                         ReplicateMsgs* msg_refs,
@@ -352,6 +477,7 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 
     // Clear the requests without deleting the entries, as they may be in use by other peers.
     request->mutable_ops()->ExtractSubrange(0, request->ops_size(), /* elements */ nullptr);
+    request->clear_compressed_ops();
 
     // This is initialized to the queue's last appended op but gets set to the id of the
     // log entry preceding the first one in 'messages' if messages are found for the peer.
@@ -451,9 +577,39 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   return Status::OK();
 }
 
+void PeerMessageQueue::RequestSentToPeer(const std::string& uuid,
+                                         const ConsensusRequestPB& request) {
+  LockGuard lock(queue_lock_);
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, uuid);
+  if (PREDICT_FALSE(peer == nullptr || queue_state_.mode == Mode::NON_LEADER)) {
+    return;
+  }
+
+  const int64_t last_index = request.ops_size() > 0
+      ? request.ops(request.ops_size() - 1).id().index() : request.preceding_id().index();
+  // Following request continues from this one, without waiting for the response. Unless the
+  // peer position was changed by a response after the request was built.
+  if (request.ops_size() > 0 && peer->is_last_exchange_successful &&
+      peer->next_index == request.ops(0).id().index()) {
+    peer->next_index = last_index + 1;
+  }
+
+  peer->sent_leases.push_back(TrackedPeer::SentLease{
+      last_index,
+      peer->last_leader_lease_expiration_sent_to_follower,
+      peer->last_ht_lease_expiration_sent_to_follower});
+  // Dropping a lease only means that it would not be credited, and only the latest requests could
+  // be in flight.
+  while (peer->sent_leases.size() >
+             static_cast<size_t>(FLAGS_consensus_max_in_flight_requests_per_peer)) {
+    peer->sent_leases.pop_front();
+  }
+}
+
 Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
                                                           StartRemoteBootstrapRequestPB* req) {
   TrackedPeer* peer = nullptr;
+  RaftPeerPB source = local_peer_pb_;
   {
     LockGuard lock(queue_lock_);
     DCHECK_EQ(queue_state_.state, State::kQueueOpen);
@@ -462,6 +618,12 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
     if (PREDICT_FALSE(peer == nullptr || queue_state_.mode == Mode::NON_LEADER)) {
       return STATUS(NotFound, "Peer not tracked or queue not in leader mode.");
     }
+    if (FLAGS_remote_bootstrap_from_followers) {
+      const auto* follower = FindRemoteBootstrapSourceUnlocked(uuid);
+      if (follower) {
+        source = *follower;
+      }
+    }
   }
 
   if (PREDICT_FALSE(!peer->needs_remote_bootstrap)) {
@@ -476,13 +638,49 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
   req->Clear();
   req->set_dest_uuid(uuid);
   req->set_tablet_id(tablet_id_);
-  req->set_bootstrap_peer_uuid(local_peer_uuid_);
-  *req->mutable_bootstrap_peer_addr() = local_peer_pb_.last_known_addr();
+  req->set_bootstrap_peer_uuid(source.permanent_uuid());
+  *req->mutable_bootstrap_peer_addr() = source.last_known_addr();
   req->set_caller_term(queue_state_.current_term);
   peer->needs_remote_bootstrap = false; // Now reset the flag.
+  if (source.permanent_uuid() != local_peer_uuid_) {
+    LOG_WITH_PREFIX_UNLOCKED(INFO) << "Remote bootstrapping peer " << uuid << " from follower "
+                                   << source.permanent_uuid();
+  }
   return Status::OK();
 }
 
+const RaftPeerPB* PeerMessageQueue::FindRemoteBootstrapSourceUnlocked(
+    const std::string& uuid) const {
+  if (!queue_state_.active_config ||
+      queue_state_.committed_index.index() < queue_state_.active_config_index) {
+    // The bootstrapped peer gets the committed config of the source, so the active config should
+    // be committed.
+    return nullptr;
+  }
+
+  const RaftPeerPB* result = nullptr;
+  int64_t result_index = kInvalidOpIdIndex;
+  for (const auto& peer_pb : queue_state_.active_config->peers()) {
+    if (peer_pb.permanent_uuid() == uuid || peer_pb.permanent_uuid() == local_peer_uuid_ ||
+        peer_pb.member_type() != RaftPeerPB::VOTER || !peer_pb.has_last_known_addr()) {
+      continue;
+    }
+    const TrackedPeer* peer = FindPtrOrNull(peers_map_, peer_pb.permanent_uuid());
+    // Only healthy followers that have all committed operations, and know that the active config
+    // is committed.
+    if (peer == nullptr || !peer->is_last_exchange_successful || peer->needs_remote_bootstrap ||
+        peer->last_received.index() < queue_state_.committed_index.index() ||
+        peer->last_known_committed_idx < queue_state_.active_config_index) {
+      continue;
+    }
+    if (result == nullptr || peer->last_received.index() > result_index) {
+      result = &peer_pb;
+      result_index = peer->last_received.index();
+    }
+  }
+  return result;
+}
+
 void PeerMessageQueue::UpdateAllReplicatedOpId(OpId* result) {
   OpId new_op_id = MaximumOpId();
 
@@ -519,7 +717,7 @@ typename Policy::result_type PeerMessageQueue::GetWatermark() {
     return Policy::Max();
   }
 
-  constexpr size_t kMaxPracticalReplicationFactor = 5;
+  constexpr size_t kMaxPracticalReplicationFactor = 7;
   boost::container::small_vector<
       typename Policy::result_type, kMaxPracticalReplicationFactor> watermarks;
   watermarks.reserve(num_peers - 1);
@@ -573,99 +771,21 @@ typename Policy::result_type PeerMessageQueue::GetWatermark() {
   return *nth;
 }
 
-MonoTime PeerMessageQueue::LeaderLeaseExpirationWatermark() {
-  struct Policy {
-    typedef MonoTime result_type;
-    // Workaround for a gcc bug. That does not understand that Comparator is actually being used.
-    __attribute__((unused)) typedef std::less<result_type> Comparator;
-
-    static result_type Min() {
-      return result_type::kMin;
-    }
-
-    static result_type Max() {
-      return result_type::kMax;
-    }
-
-    static result_type ExtractValue(const TrackedPeer& peer) {
-      MonoTime lease_exp = peer.last_leader_lease_expiration_received_by_follower;
-      return lease_exp.Initialized() ? lease_exp : MonoTime::kMin;
-    }
-
-    static const char* Name() {
-      return "Leader lease expiration";
-    }
-
-    static bool LocalPeerHasInfiniteWatermark() {
-      return true;
-    }
-  };
-
-  return GetWatermark<Policy>();
-}
-
-MicrosTime PeerMessageQueue::HybridTimeLeaseExpirationWatermark() {
-  struct Policy {
-    typedef MicrosTime result_type;
-    // Workaround for a gcc bug. That does not understand that Comparator is actually being used.
-    __attribute__((unused)) typedef std::less<result_type> Comparator;
-
-    static result_type Min() {
-      return HybridTime::kMin.GetPhysicalValueMicros();
-    }
-
-    static result_type Max() {
-      return HybridTime::kMax.GetPhysicalValueMicros();
-    }
-
-    static result_type ExtractValue(const TrackedPeer& peer) {
-      return peer.last_ht_lease_expiration_received_by_follower;
-    }
-
-    static const char* Name() {
-      return "Hybrid time leader lease expiration";
-    }
-
-    static bool LocalPeerHasInfiniteWatermark() {
-      return true;
-    }
-  };
-
-  return GetWatermark<Policy>();
-}
-
-OpId PeerMessageQueue::OpIdWatermark() {
-  struct Policy {
-    typedef OpId result_type;
-
-    static result_type Min() {
-      return MinimumOpId();
-    }
-
-    static result_type Max() {
-      return MaximumOpId();
-    }
-
-    static result_type ExtractValue(const TrackedPeer& peer) {
-      return peer.last_received;
-    }
-
-    struct Comparator {
-      bool operator()(const OpId& lhs, const OpId& rhs) {
-        return lhs.index() < rhs.index();
-      }
-    };
-
-    static const char* Name() {
-      return "OpId";
-    }
-
-    static bool LocalPeerHasInfiniteWatermark() {
-      return false;
-    }
-  };
-
-  return GetWatermark<Policy>();
+template <class Policy>
+typename Policy::result_type PeerMessageQueue::UpdateWatermark(
+    const TrackedPeer& previous, const TrackedPeer& peer,
+    typename Policy::result_type* watermark) {
+  typename Policy::Comparator less;
+  const bool unchanged =
+      watermarks_.valid &&
+      ((peer.uuid == local_peer_uuid_ && Policy::LocalPeerHasInfiniteWatermark()) ||
+       (previous.is_last_exchange_successful && peer.is_last_exchange_successful &&
+        less(*watermark, Policy::ExtractValue(previous)) &&
+        !less(Policy::ExtractValue(peer), Policy::ExtractValue(previous))));
+  if (!unchanged) {
+    *watermark = GetWatermark<Policy>();
+  }
+  return *watermark;
 }
 
 void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& peer_uuid) {
@@ -683,6 +803,7 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
   MajorityReplicatedData majority_replicated;
   Mode mode_copy;
+  int64_t evict_through_index = -1;
   {
     LockGuard scoped_lock(queue_lock_);
     DCHECK_NE(State::kQueueConstructed, queue_state_.state);
@@ -739,6 +860,10 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     // Take a snapshot of the current peer status.
     TrackedPeer previous = *peer;
 
+    // Several requests could be in flight, so the peer could be ahead of the position it reports.
+    const bool pipelined = FLAGS_consensus_max_in_flight_requests_per_peer > 1 &&
+                           previous.is_last_exchange_successful && !status.has_error();
+
     // Update the peer status based on the response.
     peer->is_new = false;
     peer->last_known_committed_idx = status.last_committed_idx();
@@ -752,8 +877,14 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     bool peer_has_prefix_of_log = IsOpInLog(status.last_received());
     if (peer_has_prefix_of_log) {
       // If the latest thing in their log is in our log, we are in sync.
-      peer->last_received = status.last_received();
-      peer->next_index = peer->last_received.index() + 1;
+      if (!pipelined || !OpIdLessThan(status.last_received(), previous.last_received)) {
+        peer->last_received = status.last_received();
+      }
+      // Otherwise it is the response to an earlier request, that was handled after the responses
+      // to later requests.
+      peer->next_index = pipelined
+          ? std::max(peer->next_index, peer->last_received.index() + 1)
+          : peer->last_received.index() + 1;
 
     } else if (!OpIdEquals(status.last_received_current_leader(), MinimumOpId())) {
       // Their log may have diverged from ours, however we are in the process of replicating our ops
@@ -827,7 +958,8 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
     mode_copy = queue_state_.mode;
     if (mode_copy == Mode::LEADER) {
-      auto new_majority_replicated_opid = OpIdWatermark();
+      auto new_majority_replicated_opid =
+          UpdateWatermark<OpIdPolicy>(previous, *peer, &watermarks_.op_id);
       if (!OpIdEquals(new_majority_replicated_opid, MinimumOpId())) {
         if (new_majority_replicated_opid.index() == MaximumOpId().index()) {
           queue_state_.majority_replicated_opid = local_peer_->last_received;
@@ -837,29 +969,74 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       }
       majority_replicated.op_id = queue_state_.majority_replicated_opid;
 
-      peer->last_leader_lease_expiration_received_by_follower =
-          peer->last_leader_lease_expiration_sent_to_follower;
+      if (FLAGS_consensus_max_in_flight_requests_per_peer > 1) {
+        CreditSentLeasesUnlocked(peer);
+      } else {
+        peer->last_leader_lease_expiration_received_by_follower =
+            peer->last_leader_lease_expiration_sent_to_follower;
 
-      peer->last_ht_lease_expiration_received_by_follower =
-          peer->last_ht_lease_expiration_sent_to_follower;
+        peer->last_ht_lease_expiration_received_by_follower =
+            peer->last_ht_lease_expiration_sent_to_follower;
+      }
 
-      majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
+      majority_replicated.leader_lease_expiration = UpdateWatermark<LeaderLeaseExpirationPolicy>(
+          previous, *peer, &watermarks_.leader_lease_expiration);
 
-      majority_replicated.ht_lease_expiration = HybridTimeLeaseExpirationWatermark();
+      majority_replicated.ht_lease_expiration = UpdateWatermark<HybridTimeLeaseExpirationPolicy>(
+          previous, *peer, &watermarks_.ht_lease_expiration);
     }
 
-    UpdateAllReplicatedOpId(&queue_state_.all_replicated_opid);
-
-    log_cache_.EvictThroughOp(queue_state_.all_replicated_opid.index());
+    // The all replicated op id is the minimum over all peers, so it could change only if this peer
+    // was at the minimum.
+    const int64_t all_replicated_index = queue_state_.all_replicated_opid.index();
+    if (!watermarks_.valid || !previous.is_last_exchange_successful ||
+        previous.last_received.index() <= all_replicated_index ||
+        peer->last_received.index() < previous.last_received.index()) {
+      UpdateAllReplicatedOpId(&queue_state_.all_replicated_opid);
+    }
+    if (queue_state_.all_replicated_opid.index() != all_replicated_index) {
+      evict_through_index = queue_state_.all_replicated_opid.index();
+    }
+    watermarks_.valid = mode_copy == Mode::LEADER;
 
     UpdateMetrics();
   }
 
+  // Eviction walks the log cache, so it is done outside of the queue lock.
+  if (evict_through_index >= 0) {
+    log_cache_.EvictThroughOp(evict_through_index);
+  }
+
   if (mode_copy == Mode::LEADER) {
     NotifyObserversOfMajorityReplOpChange(majority_replicated);
   }
 }
 
+void PeerMessageQueue::CreditSentLeasesUnlocked(TrackedPeer* peer) {
+  // The peer has received all requests that bring it up to the op it has. The response could be
+  // for any of them, so only the earliest lease could be credited.
+  auto& leases = peer->sent_leases;
+  auto it = leases.begin();
+  boost::optional<TrackedPeer::SentLease> credited;
+  while (it != leases.end()) {
+    if (it->op_index <= peer->last_received.index()) {
+      if (!credited) {
+        credited = *it;
+      }
+      it = leases.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (!credited) {
+    return;
+  }
+  peer->last_leader_lease_expiration_received_by_follower = std::max(
+      peer->last_leader_lease_expiration_received_by_follower, credited->leader_lease_expiration);
+  peer->last_ht_lease_expiration_received_by_follower = std::max(
+      peer->last_ht_lease_expiration_received_by_follower, credited->ht_lease_expiration);
+}
+
 PeerMessageQueue::TrackedPeer PeerMessageQueue::GetTrackedPeerForTests(string uuid) {
   LockGuard scoped_lock(queue_lock_);
   TrackedPeer* tracked = FindOrDie(peers_map_, uuid);
@@ -33,6 +33,7 @@
 #ifndef YB_CONSENSUS_CONSENSUS_QUEUE_H_
 #define YB_CONSENSUS_CONSENSUS_QUEUE_H_
 
+#include <deque>
 #include <iosfwd>
 #include <map>
 #include <string>
@@ -145,6 +146,17 @@ class PeerMessageQueue {
     MicrosTime last_ht_lease_expiration_received_by_follower =
         HybridTime::kMin.GetPhysicalValueMicros();
 
+    // Lease expirations sent in requests that were not acknowledged yet, in the order of sending.
+    // Only used when several requests could be in flight to the peer, since then a response does
+    // not necessarily correspond to the latest request.
+    struct SentLease {
+      // Index of the last operation that the peer has after applying the request.
+      int64_t op_index;
+      MonoTime leader_lease_expiration;
+      MicrosTime ht_lease_expiration;
+    };
+    std::deque<SentLease> sent_leases;
+
     // Whether the follower was detected to need remote bootstrap.
     bool needs_remote_bootstrap = false;
 
@@ -238,9 +250,24 @@ class PeerMessageQueue {
       RaftPeerPB::MemberType* member_type = nullptr,
       bool* last_exchange_successful = nullptr);
 
+  // Reads operations that follow 'after_op_index' and are not after 'committed_index', for change
+  // data capture. The size of the result is limited like batches sent to peers. Returns an empty
+  // result when there are no such operations.
+  CHECKED_STATUS ReadReplicatedMessagesForCDC(int64_t after_op_index,
+                                              int64_t committed_index,
+                                              ReplicateMsgs* msgs);
+
+  // Notifies the queue that a request built by RequestForPeer() was sent to the peer. Only used
+  // when several requests could be in flight to the peer: following requests continue after the
+  // operations of this one.
+  void RequestSentToPeer(const std::string& uuid, const ConsensusRequestPB& request);
+
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
   // peer->needs_remote_bootstrap to false.
+  //
+  // When remote_bootstrap_from_followers is set, the peer is bootstrapped from a caught up
+  // follower if there is one, otherwise from this leader.
   CHECKED_STATUS GetRemoteBootstrapRequestForPeer(
       const std::string& uuid,
       StartRemoteBootstrapRequestPB* req);
@@ -302,6 +329,7 @@ class PeerMessageQueue {
 
  private:
   FRIEND_TEST(ConsensusQueueTest, TestQueueAdvancesCommittedIndex);
+  FRIEND_TEST(ConsensusQueueTest, TestRemoteBootstrapFromFollower);
 
   // Mode specifies how the queue currently behaves:
   //
@@ -361,6 +389,10 @@ class PeerMessageQueue {
     // The currently-active raft config. Only set if in LEADER mode.
     gscoped_ptr<RaftConfigPB> active_config;
 
+    // Index that the operation which introduced the active config could not exceed. A follower
+    // that knows that this index is committed also has the active config committed.
+    int64_t active_config_index = kInvalidOpIdIndex;
+
     std::string ToString() const;
   };
 
@@ -405,6 +437,10 @@ class PeerMessageQueue {
   // mode, does nothing.
   void CheckPeersInActiveConfigIfLeaderUnlocked() const;
 
+  // Returns follower that could be used as a remote bootstrap source for the specified peer,
+  // or nullptr if there is no such follower.
+  const RaftPeerPB* FindRemoteBootstrapSourceUnlocked(const std::string& uuid) const;
+
   // Callback when a REPLICATE message has finished appending to the local log.
   void LocalPeerAppendFinished(const OpId& id,
                                const StatusCallback& callback,
@@ -413,15 +449,24 @@ class PeerMessageQueue {
   // Updates op id replicated on each node.
   void UpdateAllReplicatedOpId(OpId* result);
 
+  // Updates lease expirations received by the peer, using leases of the requests that the peer
+  // has acknowledged.
+  void CreditSentLeasesUnlocked(TrackedPeer* peer);
+
   // Policy is responsible for tuning of watermark calculation.
   // I.e. simple leader lease or hybrid time leader lease etc.
   // It should provide result type and a function for extracting a value from a peer.
   template <class Policy>
   typename Policy::result_type GetWatermark();
 
-  MonoTime LeaderLeaseExpirationWatermark();
-  MicrosTime HybridTimeLeaseExpirationWatermark();
-  OpId OpIdWatermark();
+  // Returns the watermark after a response that changed the state of a single peer from
+  // 'previous' to 'peer'. The watermark stored in 'watermark' on an earlier response is reused
+  // without scanning all peers, when the response could not change it, i.e. the peer had a
+  // value above the watermark and this value did not decrease.
+  template <class Policy>
+  typename Policy::result_type UpdateWatermark(const TrackedPeer& previous,
+                                               const TrackedPeer& peer,
+                                               typename Policy::result_type* watermark);
 
   std::vector<PeerMessageQueueObserver*> observers_;
 
@@ -440,6 +485,16 @@ class PeerMessageQueue {
   PeersMap peers_map_;
   TrackedPeer* local_peer_ = nullptr;
 
+  // Watermarks computed on the last response from a peer. They are reused by UpdateWatermark only
+  // while the set of tracked peers and the majority size did not change.
+  struct Watermarks {
+    bool valid = false;
+    OpId op_id;
+    MonoTime leader_lease_expiration;
+    MicrosTime ht_lease_expiration = HybridTime::kMin.GetPhysicalValueMicros();
+  };
+  Watermarks watermarks_;
+
   using LockType = simple_spinlock;
   using LockGuard = std::lock_guard<LockType>;
   mutable LockType queue_lock_; // TODO: rename
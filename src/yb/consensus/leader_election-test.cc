@@ -496,6 +496,46 @@ TEST_F(LeaderElectionTest, TestWithErrorVotes) {
   pool_->Wait(); // Wait for the election callbacks to finish before we destroy proxies.
 }
 
+// Voters do not change their term on pre-election, so they grant votes with their own term, that
+// is lower than the election term.
+TEST_F(LeaderElectionTest, TestPreElection) {
+  const ConsensusTerm kElectionTerm = 5;
+  const int kNumVoters = 3;
+  const int kMajoritySize = 2;
+
+  InitUUIDs(kNumVoters, 0);
+  InitDelayableMockedProxies(kNumVoters, 0, 0, 0, false);
+  auto counter = InitVoteCounter(kNumVoters, kMajoritySize);
+
+  for (const auto& voter_uuid : voter_uuids_) {
+    VoteResponsePB response;
+    response.set_responder_uuid(voter_uuid);
+    response.set_responder_term(kElectionTerm - 1);
+    response.set_vote_granted(true);
+    down_cast<DelayablePeerProxy<MockedPeerProxy>*>(proxies_[voter_uuid])
+        ->proxy()->set_vote_response(response);
+  }
+
+  VoteRequestPB request;
+  request.set_candidate_uuid(candidate_uuid_);
+  request.set_candidate_term(kElectionTerm);
+  request.set_tablet_id(tablet_id_);
+  request.set_preelection(true);
+
+  auto election = make_scoped_refptr<LeaderElection>(
+      config_, proxy_factory_.get(), request, std::move(counter), kLeaderElectionTimeout,
+      TEST_SuppressVoteRequest::kFalse,
+      std::bind(&LeaderElectionTest::ElectionCallback, this, std::placeholders::_1));
+  election->Run();
+
+  latch_.Wait();
+  ASSERT_EQ(kElectionTerm, result_->election_term);
+  ASSERT_EQ(VOTE_GRANTED, result_->decision);
+  ASSERT_FALSE(result_->has_higher_term);
+
+  pool_->Wait(); // Wait for the election callbacks to finish before we destroy proxies.
+}
+
 ////////////////////////////////////////
 // VoteCounterTest
 ////////////////////////////////////////
@@ -34,6 +34,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
 #include <boost/bind.hpp>
@@ -42,16 +43,22 @@
 
 #include "yb/consensus/consensus-test-util.h"
 #include "yb/consensus/log-test-base.h"
+#include "yb/consensus/log_compression.h"
 #include "yb/consensus/log_index.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/coding.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/random.h"
 
 DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
 DECLARE_int32(log_min_segments_to_retain);
+DECLARE_bool(log_group_sync_across_tablets);
+DECLARE_bool(log_compress_entries);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
 DECLARE_int32(o_direct_block_alignment_bytes);
@@ -299,6 +306,248 @@ TEST_F(LogTest, TestFsyncDataSize) {
   LOG(INFO)<< "Wrote " << size << " batches to log";
 }
 
+// Tests periodic sync through the sync group shared by logs on the same file system.
+TEST_F(LogTest, TestGroupSync) {
+  FLAGS_log_group_sync_across_tablets = true;
+  options_.interval_durable_wal_write = MonoDelta::FromMilliseconds(1);
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(0);
+  opid.set_index(1);
+
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_OK(AppendNoOp(&opid));
+    SleepFor(MonoDelta::FromMilliseconds(2));
+  }
+
+  // RollOver() the batch so that we have a properly formed footer.
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  LogEntries entries;
+  ASSERT_OK(segments[0]->ReadEntries(&entries));
+  ASSERT_EQ(10, entries.size());
+  ASSERT_OK(log_->Close());
+}
+
+// Checks that concurrent syncs of different files through the same group are all served.
+TEST_F(LogTest, TestSyncGroupConcurrentSyncs) {
+  constexpr int kThreads = 8;
+  constexpr int kSyncsPerThread = 100;
+
+  auto group = ASSERT_RESULT(LogSyncGroup::ForPath(GetTestDataDirectory()));
+  auto same_group = ASSERT_RESULT(LogSyncGroup::ForPath(GetTestDataDirectory()));
+  ASSERT_EQ(group, same_group);
+
+  std::vector<gscoped_ptr<WritableFile>> files(kThreads);
+  for (int i = 0; i != kThreads; ++i) {
+    ASSERT_OK(env_->NewWritableFile(
+        JoinPathSegments(GetTestDataDirectory(), Format("sync_group_$0", i)), &files[i]));
+  }
+
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int i = 0; i != kThreads; ++i) {
+    threads.emplace_back([group, file = files[i].get(), &failures] {
+      for (int j = 0; j != kSyncsPerThread; ++j) {
+        if (!file->Append(Slice("data")).ok() || !group->Sync(file).ok()) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(0, failures.load());
+  LOG(INFO) << "Sync rounds: " << group->num_rounds();
+  ASSERT_GT(group->num_rounds(), 0);
+  ASSERT_LE(group->num_rounds(), kThreads * kSyncsPerThread);
+  for (auto& file : files) {
+    ASSERT_EQ(kSyncsPerThread * 4, file->Size());
+    ASSERT_OK(file->Close());
+  }
+}
+
+namespace {
+
+class FailingSyncFile : public WritableFile {
+ public:
+  CHECKED_STATUS PreAllocate(uint64_t size) override { return Status::OK(); }
+  CHECKED_STATUS Append(const Slice& data) override { return Status::OK(); }
+  CHECKED_STATUS AppendVector(const std::vector<Slice>& data_vector) override {
+    return Status::OK();
+  }
+  CHECKED_STATUS Close() override { return Status::OK(); }
+  CHECKED_STATUS Flush(FlushMode mode) override { return Status::OK(); }
+  CHECKED_STATUS Sync() override { return STATUS(IOError, "Injected writeback error"); }
+  uint64_t Size() const override { return 0; }
+  const std::string& filename() const override { return filename_; }
+
+ private:
+  const std::string filename_ = "failing_sync_file";
+};
+
+} // namespace
+
+// Checks that a failed sync of one file is reported only to the log that owns that file.
+TEST_F(LogTest, TestSyncGroupPerFileStatus) {
+  auto group = ASSERT_RESULT(LogSyncGroup::ForPath(GetTestDataDirectory()));
+
+  gscoped_ptr<WritableFile> good_file;
+  ASSERT_OK(env_->NewWritableFile(
+      JoinPathSegments(GetTestDataDirectory(), "sync_group_good"), &good_file));
+  FailingSyncFile failing_file;
+
+  std::atomic<bool> stop{false};
+  std::atomic<int> unexpected_failures{0};
+  std::thread thread([group, file = good_file.get(), &stop, &unexpected_failures] {
+    while (!stop.load()) {
+      if (!group->Sync(file).ok()) {
+        ++unexpected_failures;
+      }
+    }
+  });
+  for (int i = 0; i != 100; ++i) {
+    auto status = group->Sync(&failing_file);
+    ASSERT_TRUE(status.IsIOError()) << status;
+  }
+  stop = true;
+  thread.join();
+
+  ASSERT_EQ(0, unexpected_failures.load());
+  ASSERT_OK(group->Sync(good_file.get()));
+  ASSERT_OK(good_file->Close());
+}
+
+// Tests that entries of segments written with compression are read back.
+TEST_F(LogTest, TestCompressedEntries) {
+  FLAGS_log_compress_entries = true;
+  BuildLog();
+
+  OpId opid = MakeOpId(0, 1);
+  int size = 0;
+  ASSERT_OK(AppendNoOps(&opid, 10, &size));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(LZ4_LOG_ENTRY_COMPRESSION, segments[0]->header().compression());
+  LogEntries entries;
+  ASSERT_OK(segments[0]->ReadEntries(&entries));
+  ASSERT_EQ(10, entries.size());
+  for (size_t i = 0; i != entries.size(); ++i) {
+    ASSERT_EQ(i + 1, entries[i]->replicate().id().index());
+  }
+  ASSERT_OK(log_->Close());
+}
+
+// Tests that closed segments are opened using the manifest, and that a segment that changed since
+// the manifest was written is opened by reading it.
+TEST_F(LogTest, TestSegmentManifest) {
+  BuildLog();
+
+  OpId opid = MakeOpId(0, 1);
+  int size = 0;
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_OK(AppendNoOps(&opid, 10, &size));
+    ASSERT_OK(log_->AllocateSegmentAndRollOver());
+  }
+  ASSERT_OK(AppendNoOps(&opid, 10, &size));
+  ASSERT_OK(log_->Close());
+
+  SegmentSequence original_segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&original_segments));
+
+  std::unique_ptr<LogReader> reader;
+  ASSERT_OK(LogReader::Open(fs_manager_.get(), nullptr, kTestTablet, tablet_wal_path_, nullptr,
+                            &reader));
+  ASSERT_EQ(4, reader->num_segments_from_manifest_);
+  SegmentSequence segments;
+  ASSERT_OK(reader->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(4, segments.size());
+  for (size_t i = 0; i != segments.size(); ++i) {
+    ASSERT_EQ(original_segments[i]->footer().ShortDebugString(),
+              segments[i]->footer().ShortDebugString());
+    LogEntries entries;
+    ASSERT_OK(segments[i]->ReadEntries(&entries));
+    ASSERT_EQ(10, entries.size());
+  }
+
+  // Pretend that the last segment changed since the manifest was written.
+  const string manifest_path = JoinPathSegments(tablet_wal_path_, LogReader::kManifestFileName);
+  LogManifestPB manifest;
+  ASSERT_OK(pb_util::ReadPBContainerFromPath(env_.get(), manifest_path, &manifest));
+  ASSERT_EQ(4, manifest.segments_size());
+  auto* last = manifest.mutable_segments(manifest.segments_size() - 1);
+  last->set_file_size(last->file_size() + 1);
+  ASSERT_OK(pb_util::WritePBContainerToPath(
+      env_.get(), manifest_path, manifest, pb_util::OVERWRITE, pb_util::NO_SYNC));
+
+  ASSERT_OK(LogReader::Open(fs_manager_.get(), nullptr, kTestTablet, tablet_wal_path_, nullptr,
+                            &reader));
+  ASSERT_EQ(3, reader->num_segments_from_manifest_);
+  ASSERT_OK(reader->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(4, segments.size());
+  ASSERT_TRUE(segments.back()->HasFooter());
+}
+
+// Tests that ops compressed by the leader are restored on the follower.
+TEST_F(LogTest, TestCompressOps) {
+  constexpr int kNumOps = 10;
+  consensus::ReplicateMsgs msgs;
+  consensus::ConsensusRequestPB request;
+  for (int i = 1; i <= kNumOps; ++i) {
+    msgs.push_back(consensus::CreateDummyReplicate(1, i, clock_->Now(), 4096));
+    request.mutable_ops()->AddAllocated(msgs.back().get());
+  }
+  const int uncompressed_size = request.ByteSize();
+
+  ASSERT_OK(CompressOps(&request));
+  ASSERT_EQ(0, request.ops_size());
+  ASSERT_TRUE(request.has_compressed_ops());
+  ASSERT_LT(request.ByteSize(), uncompressed_size / 10);
+
+  consensus::ConsensusRequestPB received;
+  received.CopyFrom(request);
+  ASSERT_OK(UncompressOps(&received));
+  ASSERT_FALSE(received.has_compressed_ops());
+  ASSERT_EQ(kNumOps, received.ops_size());
+  for (int i = 0; i != kNumOps; ++i) {
+    ASSERT_EQ(msgs[i]->SerializeAsString(), received.ops(i).SerializeAsString());
+  }
+
+  // Corrupted data is reported instead of producing broken ops.
+  request.mutable_compressed_ops()->resize(request.compressed_ops().size() / 2);
+  ASSERT_FALSE(UncompressOps(&request).ok());
+}
+
+// Tests that size prefix of compressed block is validated.
+TEST_F(LogTest, TestUncompressInvalidSize) {
+  const std::string input(4096, 'x');
+  faststring compressed;
+  ASSERT_OK(CompressLz4(input, &compressed));
+  faststring uncompressed;
+  ASSERT_OK(UncompressLz4(Slice(compressed), &uncompressed));
+  ASSERT_EQ(input, uncompressed.ToString());
+
+  // Size that is bigger than any RPC message is rejected before allocating memory.
+  EncodeFixed32(compressed.data(), std::numeric_limits<uint32_t>::max());
+  auto status = UncompressLz4(Slice(compressed), &uncompressed);
+  ASSERT_TRUE(status.IsCorruption()) << status;
+
+  // Size that does not match the uncompressed data is reported.
+  EncodeFixed32(compressed.data(), input.size() + 1);
+  status = UncompressLz4(Slice(compressed), &uncompressed);
+  ASSERT_TRUE(status.IsCorruption()) << status;
+  EncodeFixed32(compressed.data(), input.size() - 1);
+  status = UncompressLz4(Slice(compressed), &uncompressed);
+  ASSERT_TRUE(status.IsCorruption()) << status;
+}
+
 // Regression test for part of KUDU-735:
 // if a log is not preallocated, we should properly track its on-disk size as we append to
 // it.
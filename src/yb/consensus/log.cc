@@ -42,6 +42,7 @@
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/log_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/map-util.h"
@@ -73,6 +74,24 @@ using namespace yb::size_literals;  // NOLINT.
 using namespace std::literals;  // NOLINT.
 using namespace std::placeholders;
 
+DEFINE_bool(log_group_sync_across_tablets, false,
+            "Combine concurrent periodic WAL syncs of tablets on the same file system into "
+            "rounds that start writeback of all their segments together before syncing each of "
+            "them. Does not apply when durable_wal_write is on.");
+TAG_FLAG(log_group_sync_across_tablets, advanced);
+
+DEFINE_bool(log_compress_entries, false,
+            "Compress entry batches of new WAL segments with LZ4. Segments written with "
+            "compression could not be read by servers that do not support it.");
+TAG_FLAG(log_compress_entries, advanced);
+
+DEFINE_bool(log_use_io_uring, false,
+            "Submit WAL segment writes asynchronously through io_uring, so the appender thread "
+            "does not wait for each write. Falls back to synchronous writes on kernels without "
+            "io_uring. Does not apply when durable_wal_write is on.");
+TAG_FLAG(log_use_io_uring, advanced);
+TAG_FLAG(log_compress_entries, runtime);
+
 // Log retention configuration.
 // -----------------------------
 DEFINE_int32(log_min_segments_to_retain, 2,
@@ -395,6 +414,17 @@ Status Log::Init() {
     YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned off. Buffered IO will be used for WAL.";
   }
 
+  // With O_DIRECT, sync writes buffered data of the segment, so it could not be shared.
+  if (FLAGS_log_group_sync_across_tablets && !durable_wal_write_) {
+    auto sync_group = LogSyncGroup::ForPath(log_dir_);
+    if (sync_group.ok()) {
+      sync_group_ = std::move(*sync_group);
+    } else {
+      YB_LOG_FIRST_N(WARNING, 1) << "Unable to use WAL sync group for " << log_dir_ << ": "
+                                 << sync_group.status();
+    }
+  }
+
   // We always create a new segment when the log starts.
   RETURN_NOT_OK(AsyncAllocateSegment());
   RETURN_NOT_OK(allocation_status_.Get());
@@ -661,7 +691,11 @@ Status Log::Sync() {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
-        RETURN_NOT_OK(active_segment_->Sync());
+        if (sync_group_) {
+          RETURN_NOT_OK(sync_group_->Sync(active_segment_->writable_file().get()));
+        } else {
+          RETURN_NOT_OK(active_segment_->Sync());
+        }
 
         if (log_hooks_) {
           RETURN_NOT_OK_PREPEND(log_hooks_->PostSyncIfFsyncEnabled(),
@@ -674,7 +708,9 @@ Status Log::Sync() {
   if (log_hooks_) {
     RETURN_NOT_OK_PREPEND(log_hooks_->PostSync(), "PostSync hook failed");
   }
-  // Update the reader on how far it can read the active segment.
+  // Update the reader on how far it can read the active segment. Appends could still be in flight
+  // when the segment was not synced, so wait for them before the reader could see their data.
+  RETURN_NOT_OK(active_segment_->writable_file()->WaitForAppends());
   reader_->UpdateLastSegmentOffset(active_segment_->written_offset());
 
   return Status::OK();
@@ -901,6 +937,7 @@ Status Log::Close() {
       RETURN_NOT_OK(Sync());
       RETURN_NOT_OK(CloseCurrentSegment());
       RETURN_NOT_OK(ReplaceSegmentInReaderUnlocked());
+      WARN_NOT_OK(reader_->WriteManifest(tablet_wal_path_), "Unable to write log manifest");
       log_state_ = kLogClosed;
       VLOG(1) << "Log closed";
 
@@ -947,6 +984,7 @@ Status Log::PreAllocateNewSegment() {
   WritableFileOptions opts;
   opts.sync_on_close = durable_wal_write_;
   opts.o_direct = durable_wal_write_;
+  opts.use_io_uring = FLAGS_log_use_io_uring;
   RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
 
   if (options_.preallocate_segments) {
@@ -988,6 +1026,9 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  if (FLAGS_log_compress_entries) {
+    header.set_compression(LZ4_LOG_ENTRY_COMPRESSION);
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
@@ -1006,8 +1047,11 @@ Status Log::SwitchToAllocatedSegment() {
   // the segments for other peers.
   {
     if (active_segment_.get() != nullptr) {
-      std::lock_guard<percpu_rwlock> l(state_lock_);
-      CHECK_OK(ReplaceSegmentInReaderUnlocked());
+      {
+        std::lock_guard<percpu_rwlock> l(state_lock_);
+        CHECK_OK(ReplaceSegmentInReaderUnlocked());
+      }
+      WARN_NOT_OK(reader_->WriteManifest(tablet_wal_path_), "Unable to write log manifest");
     }
   }
 
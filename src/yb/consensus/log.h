@@ -67,6 +67,7 @@ struct LogMetrics;
 class LogEntryBatch;
 class LogIndex;
 class LogReader;
+class LogSyncGroup;
 
 // Log interface, inspired by Raft's (logcabin) Log. Provides durability to YugaByte as a normal
 // Write Ahead Log and also plays the role of persistent storage for the consensus state machine.
@@ -416,6 +417,10 @@ class Log : public RefCountedThreadSafe<Log> {
   // For periodic sync, indicates number of bytes which need to be sync'ed.
   size_t periodic_sync_unsynced_bytes_ = 0;
 
+  // Not null when syncs of this log are combined with syncs of other tablets on the same file
+  // system.
+  std::shared_ptr<LogSyncGroup> sync_group_;
+
   // If true, ignore the 'durable_wal_write_' flags above.  This is used to disable fsync during
   // bootstrap.
   bool sync_disabled_;
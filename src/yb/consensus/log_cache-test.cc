@@ -59,6 +59,7 @@ using std::thread;
 
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
+DECLARE_int32(log_cache_readahead_kb);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -319,6 +320,49 @@ TEST_F(LogCacheTest, TestGlobalMemoryLimit) {
   ASSERT_LE(cache_->BytesUsed(), 1024 * 1024);
 }
 
+// Tests that ops following a request of a lagging peer are read ahead into the cache, unless they
+// were already replicated to all peers.
+TEST_F(LogCacheTest, TestReadahead) {
+  const int kPayloadSize = 1024;
+  FLAGS_log_cache_readahead_kb = 50;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 100, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  // Evict because of memory pressure, so ops are still needed by some peer.
+  {
+    std::lock_guard<simple_spinlock> lock(cache_->lock_);
+    cache_->EvictSomeUnlocked(100, MathLimits<int64_t>::kMax);
+  }
+  ASSERT_EQ(0, cache_->num_cached_ops());
+
+  ReplicateMsgs messages;
+  OpId preceding;
+  ASSERT_OK(cache_->ReadOps(10, 5 * kPayloadSize, &messages, &preceding));
+  ASSERT_GE(messages.size(), 1);
+  ASSERT_LT(messages.size(), 5);
+  ASSERT_EQ(11, messages.front()->id().index());
+  // Returned ops and about 50KB of readahead are cached.
+  const int64_t num_cached_ops = cache_->num_cached_ops();
+  ASSERT_GT(num_cached_ops, 40);
+  ASSERT_LT(num_cached_ops, 60);
+  ASSERT_EQ(11, cache_->cache_.upper_bound(0)->first);
+
+  // The next read is served from the cache.
+  const int64_t last_index = messages.back()->id().index();
+  messages.clear();
+  ASSERT_OK(cache_->ReadOps(last_index, 5 * kPayloadSize, &messages, &preceding));
+  ASSERT_EQ(last_index + 1, messages.front()->id().index());
+  ASSERT_EQ(num_cached_ops, cache_->num_cached_ops());
+
+  // Ops replicated to all peers are not read ahead.
+  messages.clear();
+  cache_->EvictThroughOp(100);
+  ASSERT_EQ(0, cache_->num_cached_ops());
+  ASSERT_OK(cache_->ReadOps(10, 5 * kPayloadSize, &messages, &preceding));
+  ASSERT_EQ(0, cache_->num_cached_ops());
+  ASSERT_EQ(0, cache_->BytesUsed());
+}
+
 // Test that the log cache properly replaces messages when an index
 // is reused. This is a regression test for a bug where the memtracker's
 // consumption wasn't properly managed when messages were replaced.
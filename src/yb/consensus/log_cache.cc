@@ -49,6 +49,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/allocation_sampler.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
@@ -68,6 +69,14 @@ DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "caching log entries across all tablets is kept under this threshold.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
+DEFINE_int32(log_cache_readahead_kb, 4096,
+             "When operations requested by a lagging peer are read from the WAL, read up to this "
+             "much beyond the request and keep it in the log cache, so the following requests "
+             "of this peer are served from memory. Operations that were replicated to all peers "
+             "are never read ahead. 0 to disable.");
+TAG_FLAG(log_cache_readahead_kb, advanced);
+TAG_FLAG(log_cache_readahead_kb, runtime);
+
 using strings::Substitute;
 
 namespace yb {
@@ -133,6 +142,7 @@ void LogCache::Init(const OpId& preceding_op) {
 Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
                                   const StatusCallback& callback) {
   CHECK_GT(msgs.size(), 0);
+  ScopedAllocationAttribution allocation_attribution(tracker_.get());
 
   // SpaceUsed is relatively expensive, so do calculations outside the lock
   int64_t mem_required = 0;
@@ -155,7 +165,9 @@ Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
     // we're overwriting.
     CHECK_LE(first_idx_in_batch, next_sequential_op_index_);
 
-    // Now remove the overwritten operations.
+    // Now remove the overwritten operations. Ops that are being read from the log at the same time
+    // could be overwritten ones, so they should not be cached.
+    ++num_overwrites_;
     for (int64_t i = first_idx_in_batch; i < next_sequential_op_index_; ++i) {
       auto it = cache_.find(i);
       if (it != cache_.end()) {
@@ -311,18 +323,34 @@ Status LogCache::ReadOps(int64_t after_op_index,
         up_to = iter->first - 1;
       }
 
+      const int64_t readahead_bytes = std::max(FLAGS_log_cache_readahead_kb, 0) * 1024LL;
+      const int64_t num_overwrites = num_overwrites_;
       l.unlock();
 
       ReplicateMsgs raw_replicate_ptrs;
       RETURN_NOT_OK_PREPEND(
         log_->GetLogReader()->ReadReplicatesInRange(
-            next_index, up_to, remaining_space, &raw_replicate_ptrs),
+            next_index, up_to, remaining_space + readahead_bytes, &raw_replicate_ptrs),
         Substitute("Failed to read ops $0..$1", next_index, up_to));
+
+      // SpaceUsed is relatively expensive, so do calculations outside the lock
+      vector<CacheEntry> entries_to_cache;
+      if (readahead_bytes > 0) {
+        entries_to_cache.reserve(raw_replicate_ptrs.size());
+        for (const auto& msg : raw_replicate_ptrs) {
+          entries_to_cache.push_back({ msg, static_cast<int64_t>(msg->SpaceUsedLong()) });
+        }
+      }
+
       l.lock();
       LOG_WITH_PREFIX_UNLOCKED(INFO) << "Successfully read " << raw_replicate_ptrs.size() << " ops "
                             << "from disk.";
 
       for (auto& msg : raw_replicate_ptrs) {
+        if (remaining_space <= 0 && !messages->empty()) {
+          // The rest was read ahead for the following requests.
+          break;
+        }
         CHECK_EQ(next_index, msg->id().index());
 
         remaining_space -= TotalByteSizeForMessage(*msg);
@@ -332,6 +360,10 @@ Status LogCache::ReadOps(int64_t after_op_index,
         }
       }
 
+      if (num_overwrites == num_overwrites_) {
+        CacheReadOpsUnlocked(&entries_to_cache);
+      }
+
     } else {
       // Pull contiguous messages from the cache until the size limit is achieved.
       for (; iter != cache_.end(); ++iter) {
@@ -355,8 +387,43 @@ Status LogCache::ReadOps(int64_t after_op_index,
 }
 
 
+void LogCache::CacheReadOpsUnlocked(vector<CacheEntry>* entries) {
+  DCHECK(lock_.is_locked());
+  // Ops that were already replicated to all peers would be read only by a new peer, so they are
+  // not worth the memory.
+  auto it = std::remove_if(entries->begin(), entries->end(), [this](const CacheEntry& entry) {
+    const int64_t index = entry.msg->id().index();
+    return index <= evicted_through_index_ || index >= next_sequential_op_index_ ||
+           cache_.count(index) != 0;
+  });
+  entries->erase(it, entries->end());
+  if (entries->empty()) {
+    return;
+  }
+
+  int64_t mem_required = 0;
+  for (const auto& entry : *entries) {
+    mem_required += entry.mem_usage;
+  }
+  // Ops are read ahead only into spare memory, they never cause other ops to be evicted.
+  if (!tracker_->TryConsume(mem_required)) {
+    VLOG_WITH_PREFIX_UNLOCKED(1) << "Not enough memory to cache " << entries->size()
+                                 << " ops read from disk: "
+                                 << HumanReadableNumBytes::ToString(mem_required);
+    return;
+  }
+
+  for (auto& entry : *entries) {
+    auto index = entry.msg->id().index();
+    EmplaceOrDie(&cache_, index, std::move(entry));
+  }
+  metrics_.log_cache_size->IncrementBy(mem_required);
+  metrics_.log_cache_num_ops->IncrementBy(entries->size());
+}
+
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
+  evicted_through_index_ = std::max(evicted_through_index_, index);
 
   EvictSomeUnlocked(index, MathLimits<int64_t>::kMax);
 }
@@ -147,6 +147,7 @@ class LogCache {
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
+  FRIEND_TEST(LogCacheTest, TestReadahead);
   friend class LogCacheTest;
 
   // An entry in the cache.
@@ -162,6 +163,10 @@ class LogCache {
   // 'stop_after_index' has been evicted, whichever comes first.
   void EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
 
+  // Inserts 'entries', that were read from the log, into the cache if there is spare memory for
+  // them. Skips ops that are already cached or were already evicted by EvictThroughOp().
+  void CacheReadOpsUnlocked(std::vector<CacheEntry>* entries);
+
   // Update metrics and MemTracker to account for the removal of the
   // given message.
   void AccountForMessageRemovalUnlocked(const CacheEntry& entry);
@@ -204,6 +209,13 @@ class LogCache {
   // log.  Protected by lock_.
   int64_t min_pinned_op_index_;
 
+  // Highest index passed to EvictThroughOp(), i.e. all ops up to it were replicated to all peers.
+  // Protected by lock_.
+  int64_t evicted_through_index_ = 0;
+
+  // Number of times operations in the cache were overwritten. Protected by lock_.
+  int64_t num_overwrites_ = 0;
+
   // Pointer to a parent memtracker for all log caches. This exists to compute server-wide cache
   // size and enforce a server-wide memory limit.  When the first instance of a log cache is
   // created, a new entry is added to MemTracker's static map; subsequent entries merely increment
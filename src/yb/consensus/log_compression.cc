@@ -0,0 +1,127 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/consensus/log_compression.h"
+
+#include <lz4.h>
+
+#include <gflags/gflags.h>
+
+#include "yb/consensus/consensus.pb.h"
+
+#include "yb/gutil/casts.h"
+
+#include "yb/util/coding.h"
+#include "yb/util/pb_util.h"
+
+DECLARE_int32(rpc_max_message_size);
+
+namespace yb {
+namespace log {
+
+namespace {
+
+const size_t kUncompressedSizeLength = sizeof(uint32_t);
+
+} // namespace
+
+Status CompressLz4(const Slice& input, faststring* output) {
+  if (input.size() > LZ4_MAX_INPUT_SIZE) {
+    return STATUS_FORMAT(InvalidArgument, "Too big input for LZ4 compression: $0", input.size());
+  }
+  const int bound = LZ4_compressBound(input.size());
+  output->resize(kUncompressedSizeLength + bound);
+  EncodeFixed32(output->data(), input.size());
+  const int compressed_size = LZ4_compress_default(
+      input.cdata(), pointer_cast<char*>(output->data() + kUncompressedSizeLength), input.size(),
+      bound);
+  if (compressed_size <= 0) {
+    return STATUS_FORMAT(RuntimeError, "LZ4 compression of $0 bytes failed", input.size());
+  }
+  output->resize(kUncompressedSizeLength + compressed_size);
+  return Status::OK();
+}
+
+Status UncompressLz4(const Slice& input, faststring* output) {
+  if (input.size() < kUncompressedSizeLength) {
+    return STATUS_FORMAT(Corruption, "Too short LZ4 compressed block: $0", input.size());
+  }
+  const uint32_t uncompressed_size = DecodeFixed32(input.data());
+  // Size prefix is not covered by LZ4 checks, so it is validated before allocating the output.
+  // Neither replicated ops nor log entry batches are bigger than an RPC message.
+  const uint32_t max_size = FLAGS_rpc_max_message_size;
+  if (uncompressed_size > max_size) {
+    return STATUS_FORMAT(Corruption, "Too big uncompressed size of LZ4 block: $0, max: $1",
+                         uncompressed_size, max_size);
+  }
+  output->resize(uncompressed_size);
+  const int compressed_size = input.size() - kUncompressedSizeLength;
+  const int result = LZ4_decompress_safe(
+      input.cdata() + kUncompressedSizeLength, pointer_cast<char*>(output->data()),
+      compressed_size, uncompressed_size);
+  if (result < 0 || static_cast<uint32_t>(result) != uncompressed_size) {
+    return STATUS_FORMAT(Corruption, "Failed to uncompress LZ4 block of $0 bytes, result: $1, "
+                         "expected size: $2", compressed_size, result, uncompressed_size);
+  }
+  return Status::OK();
+}
+
+Status CompressOps(consensus::ConsensusRequestPB* request) {
+  if (request->ops_size() == 0) {
+    return Status::OK();
+  }
+
+  // Serialized form of a request with only ops set, i.e. concatenation of ops.
+  consensus::ConsensusRequestPB ops_only;
+  ops_only.mutable_ops()->Swap(request->mutable_ops());
+  faststring serialized;
+  faststring compressed;
+  Status status;
+  if (!pb_util::AppendPartialToString(ops_only, &serialized)) {
+    status = STATUS(Corruption, "Failed to serialize ops");
+  } else {
+    status = CompressLz4(Slice(serialized), &compressed);
+  }
+  if (!status.ok() || compressed.size() >= serialized.size()) {
+    ops_only.mutable_ops()->Swap(request->mutable_ops());
+    return status;
+  }
+
+  ops_only.mutable_ops()->ExtractSubrange(0, ops_only.ops_size(), /* elements */ nullptr);
+  request->set_compressed_ops(compressed.data(), compressed.size());
+  return Status::OK();
+}
+
+Status UncompressOps(consensus::ConsensusRequestPB* request) {
+  if (!request->has_compressed_ops()) {
+    return Status::OK();
+  }
+  if (request->ops_size() != 0) {
+    return STATUS_FORMAT(InvalidArgument, "Request has both $0 ops and compressed ops",
+                         request->ops_size());
+  }
+
+  faststring serialized;
+  RETURN_NOT_OK(UncompressLz4(request->compressed_ops(), &serialized));
+  consensus::ConsensusRequestPB ops_only;
+  if (!ops_only.ParsePartialFromArray(serialized.data(), serialized.size())) {
+    return STATUS(Corruption, "Failed to parse compressed ops");
+  }
+  request->mutable_ops()->Swap(ops_only.mutable_ops());
+  request->clear_compressed_ops();
+  return Status::OK();
+}
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,48 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_CONSENSUS_LOG_COMPRESSION_H
+#define YB_CONSENSUS_LOG_COMPRESSION_H
+
+#include "yb/util/faststring.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+namespace consensus {
+class ConsensusRequestPB;
+}
+
+namespace log {
+
+// Compresses 'input' with LZ4 into 'output'. The compressed block is prefixed with the size of
+// uncompressed data.
+CHECKED_STATUS CompressLz4(const Slice& input, faststring* output);
+
+// Uncompresses data produced by CompressLz4() into 'output'.
+CHECKED_STATUS UncompressLz4(const Slice& input, faststring* output);
+
+// Replaces operations of the request with their compressed form in the compressed_ops field,
+// unless compression does not make the request smaller. Operations are not owned by the request,
+// so they are extracted without being deleted.
+CHECKED_STATUS CompressOps(consensus::ConsensusRequestPB* request);
+
+// Restores operations of the request from the compressed_ops field, if it is set.
+CHECKED_STATUS UncompressOps(consensus::ConsensusRequestPB* request);
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_LOG_COMPRESSION_H
@@ -34,6 +34,9 @@
 
 #include <algorithm>
 #include <mutex>
+#include <unordered_map>
+
+#include <gflags/gflags.h>
 
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/opid_util.h"
@@ -43,6 +46,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/coding.h"
 #include "yb/util/env_util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/hexdump.h"
 #include "yb/util/metrics.h"
 #include "yb/util/path_util.h"
@@ -61,6 +65,12 @@ METRIC_DEFINE_histogram(tablet, log_reader_read_batch_latency, "Log Read Latency
                         "Microseconds spent reading log entry batches",
                         60000000LU, 2);
 
+DEFINE_bool(log_use_segment_manifest, true,
+            "Keep headers and footers of closed log segments in a manifest file in the WAL "
+            "directory, and use it to open segments without reading them.");
+TAG_FLAG(log_use_segment_manifest, advanced);
+TAG_FLAG(log_use_segment_manifest, runtime);
+
 namespace yb {
 namespace log {
 
@@ -79,6 +89,7 @@ using env_util::ReadFully;
 using strings::Substitute;
 
 const int LogReader::kNoSizeLimit = -1;
+const char* const LogReader::kManifestFileName = "log-manifest";
 
 Status LogReader::Open(FsManager *fs_manager,
                        const scoped_refptr<LogIndex>& index,
@@ -151,12 +162,27 @@ Status LogReader::Init(const string& tablet_wal_path) {
 
   SegmentSequence read_segments;
 
+  LogManifestPB manifest;
+  std::unordered_map<string, const LogManifestSegmentPB*> manifest_segments;
+  const string manifest_path = JoinPathSegments(tablet_wal_path, kManifestFileName);
+  if (FLAGS_log_use_segment_manifest && env->FileExists(manifest_path)) {
+    Status s = pb_util::ReadPBContainerFromPath(env, manifest_path, &manifest);
+    if (s.ok()) {
+      for (const auto& manifest_segment : manifest.segments()) {
+        manifest_segments.emplace(manifest_segment.file_name(), &manifest_segment);
+      }
+    } else {
+      // The manifest is not synced, so it could be garbage after a crash.
+      LOG(WARNING) << "Unable to read log manifest " << manifest_path << ": " << s;
+    }
+  }
+
   // build a log segment from each file
   for (const string &log_file : log_files) {
     if (HasPrefixString(log_file, FsManager::kWalFileNamePrefix)) {
       string fqp = JoinPathSegments(tablet_wal_path, log_file);
       scoped_refptr<ReadableLogSegment> segment;
-      RETURN_NOT_OK_PREPEND(ReadableLogSegment::Open(env, fqp, &segment),
+      RETURN_NOT_OK_PREPEND(OpenSegment(fqp, FindPtrOrNull(manifest_segments, log_file), &segment),
                             "Unable to open readable log segment");
       DCHECK(segment);
       CHECK(segment->IsInitialized()) << "Uninitialized segment at: " << segment->path();
@@ -200,6 +226,60 @@ Status LogReader::Init(const string& tablet_wal_path) {
   return Status::OK();
 }
 
+Status LogReader::OpenSegment(const string& path,
+                              const LogManifestSegmentPB* manifest_segment,
+                              scoped_refptr<ReadableLogSegment>* segment) {
+  Env* env = fs_manager_->env();
+  if (manifest_segment) {
+    auto file_size = env->GetFileSize(path);
+    if (file_size.ok() && static_cast<int64_t>(*file_size) == manifest_segment->file_size()) {
+      VLOG(1) << "Using cached header and footer of wal segment: " << path;
+      std::shared_ptr<RandomAccessFile> readable_file;
+      RETURN_NOT_OK_PREPEND(env_util::OpenFileForRandom(env, path, &readable_file),
+                            "Unable to open file for reading");
+      segment->reset(new ReadableLogSegment(path, readable_file));
+      RETURN_NOT_OK_PREPEND((*segment)->Init(manifest_segment->header(),
+                                             manifest_segment->footer(),
+                                             manifest_segment->first_entry_offset()),
+                            "Unable to initialize segment");
+      ++num_segments_from_manifest_;
+      return Status::OK();
+    }
+    LOG(WARNING) << "Ignoring cached header and footer of wal segment " << path
+                 << ", file size changed: " << manifest_segment->file_size() << " => "
+                 << (file_size.ok() ? std::to_string(*file_size) : file_size.status().ToString());
+  }
+  return ReadableLogSegment::Open(env, path, segment);
+}
+
+Status LogReader::WriteManifest(const string& tablet_wal_path) const {
+  if (!FLAGS_log_use_segment_manifest) {
+    return Status::OK();
+  }
+
+  SegmentSequence segments;
+  RETURN_NOT_OK(GetSegmentsSnapshot(&segments));
+
+  LogManifestPB manifest;
+  for (const auto& segment : segments) {
+    if (!segment->HasFooter()) {
+      continue;
+    }
+    auto* manifest_segment = manifest.add_segments();
+    manifest_segment->set_file_name(BaseName(segment->path()));
+    manifest_segment->set_file_size(segment->file_size());
+    *manifest_segment->mutable_header() = segment->header();
+    *manifest_segment->mutable_footer() = segment->footer();
+    manifest_segment->set_first_entry_offset(segment->first_entry_offset());
+  }
+
+  // The manifest is validated against segment files when it is read, so it does not have to be
+  // synced.
+  return pb_util::WritePBContainerToPath(
+      fs_manager_->env(), JoinPathSegments(tablet_wal_path, kManifestFileName), manifest,
+      pb_util::OVERWRITE, pb_util::NO_SYNC);
+}
+
 Status LogReader::InitEmptyReaderForTests() {
   std::lock_guard<simple_spinlock> lock(lock_);
   state_ = kLogReaderReading;
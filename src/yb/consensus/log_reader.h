@@ -136,9 +136,13 @@ class LogReader {
 
   std::string ToString() const;
 
+  // Name of the file, in the WAL directory, that caches headers and footers of closed segments.
+  static const char* const kManifestFileName;
+
  private:
   FRIEND_TEST(LogTest, TestLogReader);
   FRIEND_TEST(LogTest, TestReadLogWithReplacedReplicates);
+  FRIEND_TEST(LogTest, TestSegmentManifest);
   friend class Log;
   friend class LogTest;
 
@@ -161,6 +165,10 @@ class LogReader {
   // Removes segments with sequence numbers less than or equal to 'seg_seqno' from this reader.
   CHECKED_STATUS TrimSegmentsUpToAndIncluding(int64_t seg_seqno);
 
+  // Writes headers and footers of all segments that have footers to the manifest in
+  // 'tablet_wal_path', so the next Init() could open them without reading them.
+  CHECKED_STATUS WriteManifest(const std::string& tablet_wal_path) const;
+
   // Replaces the last segment in the reader with 'segment'.
   // Used to replace a segment that was still in the process of being written
   // with its complete version which has a footer and index entries.
@@ -195,6 +203,12 @@ class LogReader {
   // Reads the headers of all segments in 'path_'.
   CHECKED_STATUS Init(const std::string& path_);
 
+  // Opens the segment at 'path'. Uses the header and footer cached in 'manifest_segment' when it
+  // is not null and still matches the file.
+  CHECKED_STATUS OpenSegment(const std::string& path,
+                             const LogManifestSegmentPB* manifest_segment,
+                             scoped_refptr<ReadableLogSegment>* segment);
+
   // Initializes an 'empty' reader for tests, i.e. does not scan a path looking for segments.
   CHECKED_STATUS InitEmptyReaderForTests();
 
@@ -215,6 +229,9 @@ class LogReader {
 
   State state_;
 
+  // Number of segments opened by Init() using the manifest, for tests.
+  size_t num_segments_from_manifest_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(LogReader);
 };
 
@@ -0,0 +1,103 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_sync_group.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <glog/logging.h>
+
+#include "yb/util/env.h"
+#include "yb/util/errno.h"
+#include "yb/util/thread_restrictions.h"
+
+namespace yb {
+namespace log {
+
+Result<std::shared_ptr<LogSyncGroup>> LogSyncGroup::ForPath(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return STATUS(IOError, "Failed to stat " + path, ErrnoToString(errno), errno);
+  }
+
+  static std::mutex mutex;
+  static std::unordered_map<dev_t, std::weak_ptr<LogSyncGroup>>* groups =
+      new std::unordered_map<dev_t, std::weak_ptr<LogSyncGroup>>;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& weak_group = (*groups)[st.st_dev];
+  auto result = weak_group.lock();
+  if (!result) {
+    LOG(INFO) << "Created WAL sync group for device " << st.st_dev << " using " << path;
+    result = std::make_shared<LogSyncGroup>();
+    weak_group = result;
+  }
+  return result;
+}
+
+Status LogSyncGroup::Sync(WritableFile* file) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!pending_) {
+    pending_ = std::make_shared<Round>();
+  }
+  auto round = pending_;
+  auto it = std::find(round->files.begin(), round->files.end(), file);
+  const size_t index = it - round->files.begin();
+  if (it == round->files.end()) {
+    round->files.push_back(file);
+  }
+
+  while (!round->done) {
+    if (!syncing_ && pending_ == round) {
+      // Become the leader of the round. All files of the round were written before their syncs
+      // were requested, so they are covered by it.
+      syncing_ = true;
+      pending_ = nullptr;
+      lock.unlock();
+      DoRound(round.get());
+      lock.lock();
+      syncing_ = false;
+      round->done = true;
+      ++num_rounds_;
+      cond_.notify_all();
+      break;
+    }
+    cond_.wait(lock);
+  }
+  return round->statuses[index];
+}
+
+void LogSyncGroup::DoRound(Round* round) {
+  ThreadRestrictions::AssertIOAllowed();
+  round->statuses.resize(round->files.size());
+  // Start writeback of all files, so their data is written to the device together.
+  for (size_t i = 0; i != round->files.size(); ++i) {
+    round->statuses[i] = round->files[i]->Flush(WritableFile::FLUSH_ASYNC);
+  }
+  for (size_t i = 0; i != round->files.size(); ++i) {
+    if (round->statuses[i].ok()) {
+      round->statuses[i] = round->files[i]->Sync();
+    }
+  }
+}
+
+uint64_t LogSyncGroup::num_rounds() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_rounds_;
+}
+
+} // namespace log
+} // namespace yb
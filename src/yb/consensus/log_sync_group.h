@@ -0,0 +1,82 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_LOG_SYNC_GROUP_H
+#define YB_CONSENSUS_LOG_SYNC_GROUP_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class WritableFile;
+
+namespace log {
+
+// Group commit of WAL syncs for logs of all tablets that reside on the same file system.
+//
+// A log asks the group to sync its active segment. Concurrent requests are combined into a round,
+// and the group leader syncs every file of the round. Writeback of all files is started first, and
+// then each file is synced with fdatasync, so the device sees the writes of a round together and
+// a single journal commit usually covers all of them. Requests that arrive while a round is in
+// progress are served by the next round.
+//
+// Only the files of the round are synced, so other writes to the file system, like SST flushes and
+// compactions, do not delay the WAL. Each requester gets the status of syncing its own file.
+class LogSyncGroup {
+ public:
+  LogSyncGroup() = default;
+
+  LogSyncGroup(const LogSyncGroup&) = delete;
+  void operator=(const LogSyncGroup&) = delete;
+
+  // Returns group for the file system containing the specified path.
+  static Result<std::shared_ptr<LogSyncGroup>> ForPath(const std::string& path);
+
+  // Makes data that was written to the file before the call durable. The file should stay alive
+  // until the call returns.
+  CHECKED_STATUS Sync(WritableFile* file);
+
+  // Number of sync rounds performed by this group.
+  uint64_t num_rounds() const;
+
+ private:
+  struct Round {
+    // Files requested to be synced by this round, without duplicates.
+    std::vector<WritableFile*> files;
+    // Status of syncing the file with the same index.
+    std::vector<Status> statuses;
+    bool done = false;
+  };
+
+  static void DoRound(Round* round);
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  // Round that collects new requests, null when there are no such requests.
+  std::shared_ptr<Round> pending_;
+  // Whether a leader runs a round now.
+  bool syncing_ = false;
+  uint64_t num_rounds_ = 0;
+};
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_LOG_SYNC_GROUP_H
@@ -40,6 +40,7 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include "yb/consensus/log_compression.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/ref_counted_replicate.h"
 #include "yb/fs/fs_manager.h"
@@ -714,10 +715,21 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  // CRC covers the stored form of the batch, so it is checked before uncompressing.
+  Slice batch_data = entry_batch_slice;
+  faststring uncompressed;
+  if (header_.compression() == LZ4_LOG_ENTRY_COMPRESSION) {
+    RETURN_NOT_OK_PREPEND(
+        UncompressLz4(entry_batch_slice, &uncompressed),
+        Substitute("Could not uncompress entry in byte range $0-$1",
+                   *offset, *offset + header.msg_length));
+    batch_data = Slice(uncompressed);
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+                              batch_data.data(),
+                              batch_data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -788,11 +800,17 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
+  Slice data = entry_batch_data;
+  if (header_.compression() == LZ4_LOG_ENTRY_COMPRESSION) {
+    RETURN_NOT_OK(CompressLz4(entry_batch_data, &compression_buffer_));
+    data = Slice(compression_buffer_);
+  }
+
   // First encode the length of the message.
   uint32_t len = data.size();
   InlineEncodeFixed32(&header_buf[0], len);
@@ -379,12 +379,12 @@ class WritableLogSegment {
     return written_offset_;
   }
 
- private:
-
   const std::shared_ptr<WritableFile>& writable_file() const {
     return writable_file_;
   }
 
+ private:
+
   // The path to the log file.
   const std::string path_;
 
@@ -405,6 +405,9 @@ class WritableLogSegment {
   // The offset where the last written entry ends.
   int64_t written_offset_;
 
+  // Buffer for compressed entry batches, reused between writes.
+  faststring compression_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
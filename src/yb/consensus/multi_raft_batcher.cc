@@ -0,0 +1,161 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+
+#include "yb/rpc/messenger.h"
+
+#include "yb/util/flag_tags.h"
+
+using namespace std::literals;
+
+DEFINE_bool(enable_multi_raft_heartbeat_batcher, false,
+            "Send heartbeats of all tablets to the same server in a single MultiUpdateConsensus "
+            "RPC. All servers of the cluster should support this RPC.");
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, advanced);
+
+DEFINE_int32(multi_raft_heartbeat_batch_window_ms, 10,
+             "Max time that a heartbeat waits for other heartbeats to the same server, before "
+             "being sent.");
+TAG_FLAG(multi_raft_heartbeat_batch_window_ms, advanced);
+TAG_FLAG(multi_raft_heartbeat_batch_window_ms, runtime);
+
+DEFINE_int32(multi_raft_heartbeat_batch_size, 512,
+             "Max number of heartbeats sent in a single MultiUpdateConsensus RPC.");
+TAG_FLAG(multi_raft_heartbeat_batch_size, advanced);
+TAG_FLAG(multi_raft_heartbeat_batch_size, runtime);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    const HostPort& hostport, rpc::ProxyCache* proxy_cache,
+    std::shared_ptr<rpc::Messenger> messenger)
+    : hostport_(hostport), messenger_(std::move(messenger)), proxy_(proxy_cache, hostport) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+  // Peers wait for their requests to complete before being destroyed, and keep the batcher alive.
+  DCHECK(pending_.empty());
+}
+
+std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcher::Get(
+    const HostPort& hostport, rpc::ProxyCache* proxy_cache,
+    const std::shared_ptr<rpc::Messenger>& messenger) {
+  typedef std::unordered_map<HostPort, std::weak_ptr<MultiRaftHeartbeatBatcher>, HostPortHash>
+      Batchers;
+  static std::mutex mutex;
+  static std::unordered_map<rpc::ProxyCache*, Batchers>* batchers =
+      new std::unordered_map<rpc::ProxyCache*, Batchers>;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& weak_batcher = (*batchers)[proxy_cache][hostport];
+  auto result = weak_batcher.lock();
+  if (!result) {
+    result = std::make_shared<MultiRaftHeartbeatBatcher>(hostport, proxy_cache, messenger);
+    weak_batcher = result;
+  }
+  return result;
+}
+
+void MultiRaftHeartbeatBatcher::AddRequest(const ConsensusRequestPB* request,
+                                           ConsensusResponsePB* response,
+                                           StdStatusCallback callback) {
+  std::vector<Entry> entries;
+  bool schedule_flush = false;
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    pending_.push_back(Entry{request, response, std::move(callback)});
+    if (pending_.size() >= static_cast<size_t>(FLAGS_multi_raft_heartbeat_batch_size)) {
+      entries.swap(pending_);
+    } else if (!flush_scheduled_) {
+      flush_scheduled_ = true;
+      schedule_flush = true;
+    }
+  }
+
+  if (!entries.empty()) {
+    SendBatch(std::move(entries));
+  } else if (schedule_flush) {
+    std::weak_ptr<MultiRaftHeartbeatBatcher> weak_self = shared_from_this();
+    messenger_->scheduler().Schedule(
+        [weak_self](const Status& status) {
+          auto self = weak_self.lock();
+          if (self) {
+            self->ScheduledFlush(status);
+          }
+        },
+        FLAGS_multi_raft_heartbeat_batch_window_ms * 1ms);
+  }
+}
+
+void MultiRaftHeartbeatBatcher::ScheduledFlush(const Status& status) {
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    flush_scheduled_ = false;
+    entries.swap(pending_);
+  }
+
+  if (!status.ok()) {
+    // Scheduler is shutting down, so fail requests instead of sending them.
+    for (auto& entry : entries) {
+      entry.callback(status);
+    }
+    return;
+  }
+
+  if (!entries.empty()) {
+    SendBatch(std::move(entries));
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendBatch(std::vector<Entry> entries) {
+  auto batch = std::make_shared<Batch>();
+  batch->entries = std::move(entries);
+  batch->request.mutable_consensus_request()->Reserve(batch->entries.size());
+  for (const auto& entry : batch->entries) {
+    *batch->request.add_consensus_request() = *entry.request;
+  }
+  batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  proxy_.MultiUpdateConsensusAsync(
+      batch->request, &batch->response, &batch->controller,
+      std::bind(&MultiRaftHeartbeatBatcher::BatchFinished, shared_from_this(), batch));
+}
+
+void MultiRaftHeartbeatBatcher::BatchFinished(const std::shared_ptr<Batch>& batch) {
+  Status status = batch->controller.status();
+  auto& responses = *batch->response.mutable_consensus_response();
+  if (status.ok() && static_cast<size_t>(responses.size()) != batch->entries.size()) {
+    status = STATUS_FORMAT(IllegalState, "Wrong number of responses from $0: $1, expected: $2",
+                           hostport_, responses.size(), batch->entries.size());
+  }
+
+  for (size_t i = 0; i != batch->entries.size(); ++i) {
+    auto& entry = batch->entries[i];
+    if (status.ok()) {
+      entry.response->Swap(responses.Mutable(i));
+    }
+    entry.callback(status);
+  }
+}
+
+} // namespace consensus
+} // namespace yb
@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <memory>
+#include <vector>
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/util/locks.h"
+#include "yb/util/net/net_util.h"
+#include "yb/util/status_callback.h"
+
+namespace yb {
+
+namespace rpc {
+class Messenger;
+class ProxyCache;
+}
+
+namespace consensus {
+
+// Combines heartbeats, i.e. consensus update requests without operations, of all tablets
+// that are sent from this server to the same remote server, into MultiUpdateConsensus RPCs.
+//
+// Heartbeats are accumulated for at most multi_raft_heartbeat_batch_window_ms, or until
+// multi_raft_heartbeat_batch_size of them are collected.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  MultiRaftHeartbeatBatcher(const HostPort& hostport,
+                            rpc::ProxyCache* proxy_cache,
+                            std::shared_ptr<rpc::Messenger> messenger);
+
+  ~MultiRaftHeartbeatBatcher();
+
+  // Returns batcher for the specified remote server, that is shared by all peers using the same
+  // proxy cache.
+  static std::shared_ptr<MultiRaftHeartbeatBatcher> Get(
+      const HostPort& hostport,
+      rpc::ProxyCache* proxy_cache,
+      const std::shared_ptr<rpc::Messenger>& messenger);
+
+  // Adds request to the batch. Callback is invoked with the status of the batch RPC, after the
+  // response is filled. Request and response should be kept alive until the callback is invoked.
+  void AddRequest(const ConsensusRequestPB* request,
+                  ConsensusResponsePB* response,
+                  StdStatusCallback callback);
+
+ private:
+  struct Entry {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    StdStatusCallback callback;
+  };
+
+  struct Batch {
+    std::vector<Entry> entries;
+    MultiConsensusRequestPB request;
+    MultiConsensusResponsePB response;
+    rpc::RpcController controller;
+  };
+
+  void ScheduledFlush(const Status& status);
+
+  void SendBatch(std::vector<Entry> entries);
+
+  void BatchFinished(const std::shared_ptr<Batch>& batch);
+
+  const HostPort hostport_;
+  const std::shared_ptr<rpc::Messenger> messenger_;
+  ConsensusServiceProxy proxy_;
+
+  simple_spinlock mutex_;
+  std::vector<Entry> pending_;
+  bool flush_scheduled_ = false;
+};
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
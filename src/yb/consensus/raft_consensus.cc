@@ -45,6 +45,7 @@
 #include "yb/consensus/consensus_peers.h"
 #include "yb/consensus/leader_election.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/log_compression.h"
 #include "yb/consensus/peer_manager.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/consensus/replica_state.h"
@@ -170,6 +171,12 @@ DEFINE_int32(min_leader_stepdown_retry_interval_ms,
              "to avoid infinite leader stepdown loops when the current leader never has a chance "
              "to update the intended leader with its latest records.");
 
+DEFINE_bool(use_preelection, true,
+            "Whether to run a pre-election, that does not change terms, before an actual leader "
+            "election triggered by the failure detector.");
+TAG_FLAG(use_preelection, advanced);
+TAG_FLAG(use_preelection, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -400,6 +407,20 @@ Status RaftConsensus::DoStartElection(
     const OpId& must_be_committed_opid,
     const std::string& originator_uuid,
     TEST_SuppressVoteRequest suppress_vote_request) {
+  // Leadership transfer does not need a pre-election, since peers vote even if the leader is alive.
+  const PreElection preelection(FLAGS_use_preelection && mode == NORMAL_ELECTION);
+  return StartElectionImpl(
+      mode, pending_commit, must_be_committed_opid, originator_uuid, suppress_vote_request,
+      preelection);
+}
+
+Status RaftConsensus::StartElectionImpl(
+    ElectionMode mode,
+    const bool pending_commit,
+    const OpId& must_be_committed_opid,
+    const std::string& originator_uuid,
+    TEST_SuppressVoteRequest suppress_vote_request,
+    PreElection preelection) {
   TRACE_EVENT2("consensus", "RaftConsensus::StartElection",
                "peer", peer_uuid(),
                "tablet", tablet_id());
@@ -453,17 +474,24 @@ Status RaftConsensus::DoStartElection(
     }
 
     if (start_now) {
+      const char* election_name = preelection ? "leader pre-election" : "leader election";
       if (state_->HasLeaderUnlocked()) {
         LOG_WITH_PREFIX_UNLOCKED(INFO)
             << "Fail of leader " << state_->GetLeaderUuidUnlocked()
-            << " detected. Triggering leader election, mode=" << mode;
+            << " detected. Triggering " << election_name << ", mode=" << mode;
       } else {
         LOG_WITH_PREFIX_UNLOCKED(INFO)
-            << "Triggering leader election, mode=" << mode;
+            << "Triggering " << election_name << ", mode=" << mode;
       }
 
-      // Increment the term.
-      RETURN_NOT_OK(IncrementTermUnlocked());
+      // Increment the term. Pre-election asks for votes in the next term without changing ours.
+      ConsensusTerm election_term;
+      if (preelection) {
+        election_term = state_->GetCurrentTermUnlocked() + 1;
+      } else {
+        RETURN_NOT_OK(IncrementTermUnlocked());
+        election_term = state_->GetCurrentTermUnlocked();
+      }
 
       // Snooze to avoid the election timer firing again as much as possible.
       // We do not disable the election timer while running an election.
@@ -471,7 +499,7 @@ Status RaftConsensus::DoStartElection(
       SnoozeFailureDetector(ALLOW_LOGGING, timeout);
 
       const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
-      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Starting election with config: "
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Starting " << election_name << " with config: "
                                      << active_config.ShortDebugString();
 
       // Initialize the VoteCounter.
@@ -479,19 +507,23 @@ Status RaftConsensus::DoStartElection(
       int majority_size = MajoritySize(num_voters);
       auto counter = std::make_unique<VoteCounter>(num_voters, majority_size);
 
-      // Vote for ourselves.
+      // Vote for ourselves. The vote in pre-election is not persisted.
       // TODO: Consider using a separate Mutex for voting, which must sync to disk.
-      RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+      if (!preelection) {
+        RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+      }
       bool duplicate;
       RETURN_NOT_OK(counter->RegisterVote(state_->GetPeerUuid(), VOTE_GRANTED, &duplicate));
       CHECK(!duplicate) << state_->LogPrefixUnlocked()
-                        << "Inexplicable duplicate self-vote for term "
-                        << state_->GetCurrentTermUnlocked();
+                        << "Inexplicable duplicate self-vote for term " << election_term;
 
       VoteRequestPB request;
       request.set_ignore_live_leader(mode == ELECT_EVEN_IF_LEADER_IS_ALIVE);
       request.set_candidate_uuid(state_->GetPeerUuid());
-      request.set_candidate_term(state_->GetCurrentTermUnlocked());
+      request.set_candidate_term(election_term);
+      if (preelection) {
+        request.set_preelection(true);
+      }
       request.set_tablet_id(state_->GetOptions().tablet_id);
       *request.mutable_candidate_status()->mutable_last_received() =
         state_->GetLastReceivedOpIdUnlocked();
@@ -503,8 +535,8 @@ Status RaftConsensus::DoStartElection(
           std::move(counter),
           timeout,
           suppress_vote_request,
-          std::bind(&RaftConsensus::ElectionCallback, shared_from_this(), originator_uuid,
-                    std::placeholders::_1)));
+          std::bind(&RaftConsensus::ElectionCallback, shared_from_this(), originator_uuid, mode,
+                    preelection, std::placeholders::_1)));
 
       // Clear the pending election op id so that we won't start the same pending election again.
       state_->ClearPendingElectionOpIdUnlocked();
@@ -592,6 +624,7 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
   }
 
   std::string new_leader_uuid;
+  std::shared_ptr<RunLeaderElectionState> election_state;
   // If a new leader is nominated, find it among peers to send RunLeaderElection request.
   // See https://ramcloud.stanford.edu/~ongaro/thesis.pdf, section 3.10 for this mechanism
   // to transfer the leadership.
@@ -627,12 +660,11 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
       }
       election_lost_by_protege_at_ = MonoTime();
     }
-    bool new_leader_found = false;
     const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
     for (const RaftPeerPB& peer : active_config.peers()) {
       if (peer.member_type() == RaftPeerPB::VOTER &&
           peer.permanent_uuid() == new_leader_uuid) {
-        auto election_state = std::make_shared<RunLeaderElectionState>();
+        election_state = std::make_shared<RunLeaderElectionState>();
         // TODO(sergei) Currently we preserved synchronous DNS resolution in this case.
         // It is possible that it should be changed to async in future.
         // But it looks like it is not a problem to leave synchronous variant here.
@@ -642,16 +674,11 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
         election_state->req.set_tablet_id(tablet_id);
         election_state->req.mutable_committed_index()->CopyFrom(
             state_->GetCommittedOpIdUnlocked());
-        election_state->proxy->RunLeaderElectionAsync(
-            &election_state->req, &election_state->resp, &election_state->rpc,
-            std::bind(&RaftConsensus::RunLeaderElectionResponseRpcCallback, this,
-                election_state));
-        new_leader_found = true;
         LOG(INFO) << "Transferring leadership of " << leadership_transfer_description;
         break;
       }
     }
-    if (!new_leader_found) {
+    if (!election_state) {
       LOG(WARNING) << "New leader " << new_leader_uuid << " not found among " << tablet_id
                    << " tablet peers.";
       resp->mutable_error()->set_code(TabletServerErrorPB::LEADER_NOT_READY_TO_STEP_DOWN);
@@ -666,9 +693,42 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
 
   WithholdElectionAfterStepDown(new_leader_uuid);
 
+  if (election_state) {
+    // We are not leader anymore, so we will not serve reads or writes, and our lease could be
+    // revoked. All hybrid times used by us so far are covered by the current clock reading, so the
+    // protege could start serving right after winning the election for the next term, instead of
+    // waiting out our lease.
+    auto revocation_bound = state_->LeaderLeaseRevocationBoundUnlocked(
+        clock_->Now().GetPhysicalValueMicros());
+    if (revocation_bound) {
+      election_state->req.set_leader_lease_revoked_term(state_->GetCurrentTermUnlocked());
+      election_state->req.set_leader_lease_revoked_ht(*revocation_bound);
+    } else {
+      LOG_WITH_PREFIX_UNLOCKED(INFO)
+          << "Not revoking leader lease, lease of an earlier leader is not waited out yet";
+    }
+    election_state->proxy->RunLeaderElectionAsync(
+        &election_state->req, &election_state->resp, &election_state->rpc,
+        std::bind(&RaftConsensus::RunLeaderElectionResponseRpcCallback, this, election_state));
+  }
+
   return Status::OK();
 }
 
+void RaftConsensus::LeaderLeaseRevoked(ConsensusTerm term, MicrosTime ht_bound) {
+  ReplicaState::UniqueLock lock;
+  Status s = state_->LockForConfigChange(&lock);
+  if (PREDICT_FALSE(!s.ok())) {
+    LOG_WITH_PREFIX(INFO) << "Ignoring revoked leader lease: " << s.ToString();
+    return;
+  }
+  if (term < state_->GetCurrentTermUnlocked()) {
+    // Leadership was already changed since that term.
+    return;
+  }
+  state_->OldLeaderLeaseRevokedUnlocked(term, ht_bound);
+}
+
 Status RaftConsensus::ElectionLostByProtege(const std::string& election_lost_by_uuid) {
   if (election_lost_by_uuid.empty()) {
     return STATUS(InvalidArgument, "election_lost_by_uuid could not be empty");
@@ -1098,6 +1158,8 @@ Status RaftConsensus::Update(ConsensusRequestPB* request,
   RETURN_NOT_OK(ExecuteHook(PRE_UPDATE));
   response->set_responder_uuid(state_->GetPeerUuid());
 
+  RETURN_NOT_OK(log::UncompressOps(request));
+
   VLOG_WITH_PREFIX(2) << "Replica received request: " << request->ShortDebugString();
 
   // see var declaration
@@ -1856,8 +1918,8 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondAlreadyVotedForOther(request, response);
   }
 
-  // The term advanced.
-  if (request->candidate_term() > state_->GetCurrentTermUnlocked()) {
+  // The term advanced. Pre-election should not change our term.
+  if (!request->preelection() && request->candidate_term() > state_->GetCurrentTermUnlocked()) {
     RETURN_NOT_OK_PREPEND(HandleTermAdvanceUnlocked(request->candidate_term()),
         Substitute("Could not step down in RequestVote. Current term: $0, candidate term: $1",
                    state_->GetCurrentTermUnlocked(), request->candidate_term()));
@@ -1870,6 +1932,16 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondLastOpIdTooOld(local_last_logged_opid, request, response);
   }
 
+  if (request->preelection()) {
+    // We would grant the vote in the actual election, but nothing is persisted for pre-election.
+    FillVoteResponseVoteGranted(response);
+    LOG(INFO) << Substitute("$0: Granting yes pre-election vote for candidate $1 in term $2.",
+                            GetRequestVoteLogPrefixUnlocked(),
+                            request->candidate_uuid(),
+                            request->candidate_term());
+    return Status::OK();
+  }
+
   // Clear the pending election op id if any before granting the vote. If another peer jumps in
   // before we can catch up and start the election, let's not disrupt the quorum with another
   // election.
@@ -2559,13 +2631,15 @@ ReplicaState* RaftConsensus::GetReplicaStateForTests() {
 }
 
 void RaftConsensus::ElectionCallback(const std::string& originator_uuid,
+                                     ElectionMode mode,
+                                     PreElection preelection,
                                      const ElectionResult& result) {
   // The election callback runs on a reactor thread, so we need to defer to our
   // threadpool. If the threadpool is already shut down for some reason, it's OK --
   // we're OK with the callback never running.
   WARN_NOT_OK(raft_pool_token_->SubmitFunc(
               std::bind(&RaftConsensus::DoElectionCallback, shared_from_this(), originator_uuid,
-                        result)),
+                        mode, preelection, result)),
               state_->LogPrefixThreadSafe() + "Unable to run election callback");
 }
 
@@ -2613,6 +2687,8 @@ void RaftConsensus::NotifyOriginatorAboutLostElection(const std::string& origina
 }
 
 void RaftConsensus::DoElectionCallback(const std::string& originator_uuid,
+                                       ElectionMode mode,
+                                       PreElection preelection,
                                        const ElectionResult& result) {
   // Snooze to avoid the election timer firing again as much as possible.
   {
@@ -2627,8 +2703,9 @@ void RaftConsensus::DoElectionCallback(const std::string& originator_uuid,
     // disabled.
     SnoozeFailureDetector(ALLOW_LOGGING, LeaderElectionExpBackoffDeltaUnlocked());
   }
+  const char* election_name = preelection ? "Leader pre-election" : "Leader election";
   if (result.decision == VOTE_DENIED) {
-    LOG_WITH_PREFIX(INFO) << "Leader election lost for term " << result.election_term
+    LOG_WITH_PREFIX(INFO) << election_name << " lost for term " << result.election_term
                              << ". Reason: "
                              << (!result.message.empty() ? result.message : "None given")
                              << ". Originator: " << originator_uuid;
@@ -2645,6 +2722,23 @@ void RaftConsensus::DoElectionCallback(const std::string& originator_uuid,
     return;
   }
 
+  if (preelection) {
+    // Pre-election is run for the term following the current one. If the term has changed,
+    // somebody else already started an election, so we should not disrupt it.
+    if (result.election_term != state_->GetCurrentTermUnlocked() + 1) {
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Leader pre-election decision for defunct term "
+                                     << result.election_term << ": won";
+      return;
+    }
+    LOG_WITH_PREFIX_UNLOCKED(INFO) << "Leader pre-election won for term " << result.election_term;
+    lock.unlock();
+    WARN_NOT_OK(StartElectionImpl(mode, false /* pending_commit */, OpId::default_instance(),
+                                  originator_uuid, TEST_SuppressVoteRequest::kFalse,
+                                  PreElection::kFalse),
+                LogPrefix() + "Failed to start leader election");
+    return;
+  }
+
   if (result.election_term != state_->GetCurrentTermUnlocked()) {
     LOG_WITH_PREFIX_UNLOCKED(INFO) << "Leader election decision for defunct term "
                                    << result.election_term << ": "
@@ -2670,7 +2764,9 @@ void RaftConsensus::DoElectionCallback(const std::string& originator_uuid,
 
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Leader election won for term " << result.election_term;
 
-  if (result.old_leader_lease_expiration) {
+  if (state_->ApplyRevokedOldLeaderLeaseUnlocked(result.election_term)) {
+    LOG_WITH_PREFIX_UNLOCKED(INFO) << "Old leader revoked its lease, not waiting it out";
+  } else if (result.old_leader_lease_expiration) {
     // Voters told us about the old leader's lease that we have to wait out.
     state_->UpdateOldLeaderLeaseExpirationUnlocked(
         result.old_leader_lease_expiration,
@@ -2702,6 +2798,12 @@ Status RaftConsensus::GetLastOpId(OpIdType type, OpId* id) {
   return Status::OK();
 }
 
+Status RaftConsensus::ReadReplicatedMessagesForCDC(const OpId& from, ReplicateMsgs* msgs) {
+  OpId committed_op_id;
+  RETURN_NOT_OK(GetLastOpId(COMMITTED_OPID, &committed_op_id));
+  return queue_->ReadReplicatedMessagesForCDC(from.index(), committed_op_id.index(), msgs);
+}
+
 void RaftConsensus::MarkDirty(std::shared_ptr<StateChangeContext> context) {
   LOG(INFO) << "Calling mark dirty synchronously for reason code " << context->reason;
   mark_dirty_clbk_.Run(context);
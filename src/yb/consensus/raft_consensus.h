@@ -136,6 +136,8 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   CHECKED_STATUS ElectionLostByProtege(const std::string& election_lost_by_uuid) override;
 
+  void LeaderLeaseRevoked(ConsensusTerm term, MicrosTime ht_bound) override;
+
   CHECKED_STATUS WaitUntilLeaderForTests(const MonoDelta& timeout) override;
 
   CHECKED_STATUS StepDown(const LeaderStepDownRequestPB* req,
@@ -212,6 +214,8 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   CHECKED_STATUS GetLastOpId(OpIdType type, OpId* id) override;
 
+  CHECKED_STATUS ReadReplicatedMessagesForCDC(const OpId& from, ReplicateMsgs* msgs) override;
+
   MicrosTime MajorityReplicatedHtLeaseExpiration(
       MicrosTime min_allowed, MonoTime deadline) const override;
 
@@ -266,6 +270,17 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
       const std::string& originator_uuid,
       TEST_SuppressVoteRequest suppress_vote_request) override;
 
+  // Starts either a pre-election or an actual election. A pre-election checks whether this peer
+  // could win an election for the next term, without incrementing the term. Only after winning
+  // a pre-election the actual election is started.
+  CHECKED_STATUS StartElectionImpl(
+      ElectionMode mode,
+      const bool pending_commit,
+      const OpId& must_be_committed_opid,
+      const std::string& originator_uuid,
+      TEST_SuppressVoteRequest suppress_vote_request,
+      PreElection preelection);
+
   friend class ReplicaState;
   friend class RaftConsensusQuorumTest;
 
@@ -429,8 +444,14 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   // Callback for leader election driver. ElectionCallback is run on the
   // reactor thread, so it simply defers its work to DoElectionCallback.
-  void ElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
-  void DoElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
+  void ElectionCallback(const std::string& originator_uuid,
+                        ElectionMode mode,
+                        PreElection preelection,
+                        const ElectionResult& result);
+  void DoElectionCallback(const std::string& originator_uuid,
+                          ElectionMode mode,
+                          PreElection preelection,
+                          const ElectionResult& result);
   void NotifyOriginatorAboutLostElection(const std::string& originator_uuid);
 
   // Helper struct that tracks the RunLeaderElection as part of leadership transferral.
@@ -127,5 +127,40 @@ TEST_F(RaftConsensusStateTest, TestPersistentWrites) {
   ASSERT_EQ(2, state_->GetCommittedConfigUnlocked().opid_index());
 }
 
+// Goes through three consecutive leader changes from the point of view of this peer. Leadership
+// is first taken over by election from a leader that is not reachable, so its lease has to be
+// waited out. Then this peer transfers leadership while still waiting, and finally after waiting.
+TEST_F(RaftConsensusStateTest, TestLeaderLeaseRevocation) {
+  const MicrosTime kNow = 1000000;
+  const MicrosTime kOldLeaderHtLease = 5000000;
+  const auto kOldLeaderLease = MonoDelta::FromMilliseconds(100);
+
+  ReplicaState::UniqueLock lock;
+  ASSERT_OK(state_->LockForConfigChange(&lock));
+
+  // Change 1: peer wins election for term 2, voters reported the lease of leader of term 1.
+  ASSERT_FALSE(state_->ApplyRevokedOldLeaderLeaseUnlocked(2));
+  state_->UpdateOldLeaderLeaseExpirationUnlocked(kOldLeaderLease, kOldLeaderHtLease);
+
+  // Change 2: peer transfers leadership of term 2 before the lease of term 1 is waited out, so it
+  // could not revoke its own lease.
+  ASSERT_FALSE(state_->LeaderLeaseRevocationBoundUnlocked(kNow));
+
+  // Change 3: peer transfers leadership after the wait. Revoked bound still covers hybrid times
+  // leased by leader of term 1.
+  SleepFor(kOldLeaderLease);
+  ASSERT_EQ(kOldLeaderHtLease, state_->LeaderLeaseRevocationBoundUnlocked(kNow));
+  ASSERT_EQ(kOldLeaderHtLease + 1,
+            state_->LeaderLeaseRevocationBoundUnlocked(kOldLeaderHtLease + 1));
+
+  // Protege side: revocation is applied only to the election for the next term.
+  state_->OldLeaderLeaseRevokedUnlocked(3, kOldLeaderHtLease);
+  ASSERT_FALSE(state_->ApplyRevokedOldLeaderLeaseUnlocked(5));
+  state_->UpdateOldLeaderLeaseExpirationUnlocked(MonoDelta::FromSeconds(60), kOldLeaderHtLease * 2);
+  ASSERT_TRUE(state_->ApplyRevokedOldLeaderLeaseUnlocked(4));
+  ASSERT_FALSE(state_->RemainingOldLeaderLeaseDuration());
+  ASSERT_EQ(kOldLeaderHtLease, state_->old_leader_ht_lease_expiration());
+}
+
 }  // namespace consensus
 }  // namespace yb
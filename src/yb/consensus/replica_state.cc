@@ -779,6 +779,14 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(IndexToRoundMap::iterator it
     max_allowed_op_id.index = std::numeric_limits<int64_t>::max();
   }
 
+  // Followers do not respond to clients after applying, so applies of consecutive writes could be
+  // combined.
+  const bool batch_applies =
+      operation_factory_ != nullptr && GetActiveRoleUnlocked() != RaftPeerPB::LEADER;
+  if (batch_applies) {
+    operation_factory_->BeginApplyBatch();
+  }
+
   while (iter != end_iter) {
     scoped_refptr<ConsensusRound> round = (*iter).second; // Make a copy.
     DCHECK(round);
@@ -810,6 +818,10 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(IndexToRoundMap::iterator it
     round->NotifyReplicationFinished(Status::OK());
   }
 
+  if (batch_applies) {
+    operation_factory_->EndApplyBatch();
+  }
+
   SetLastCommittedIndexUnlocked(committed_index);
 
   return Status::OK();
@@ -1008,6 +1020,38 @@ void ReplicaState::UpdateOldLeaderLeaseExpirationUnlocked(
   old_leader_ht_lease_expiration_ = std::max(ht_lease_expiration, old_leader_ht_lease_expiration_);
 }
 
+void ReplicaState::OldLeaderLeaseRevokedUnlocked(ConsensusTerm term, MicrosTime ht_bound) {
+  DCHECK(IsLocked());
+  LOG_WITH_PREFIX_UNLOCKED(INFO) << "Leader of term " << term << " revoked its lease, hybrid time "
+                                 << "bound: " << ht_bound;
+  revoked_leader_lease_term_ = term;
+  revoked_leader_lease_ht_ = ht_bound;
+}
+
+bool ReplicaState::ApplyRevokedOldLeaderLeaseUnlocked(ConsensusTerm election_term) {
+  DCHECK(IsLocked());
+  // Only the leader of the directly preceding term could hold a lease that is not expired yet,
+  // because it revokes its lease only after waiting out leases of all earlier leaders, see
+  // LeaderLeaseRevocationBoundUnlocked.
+  if (revoked_leader_lease_term_ == kMinimumTerm ||
+      revoked_leader_lease_term_ + 1 != election_term) {
+    return false;
+  }
+  old_leader_lease_expiration_ = MonoTime::kMin;
+  old_leader_ht_lease_expiration_ = revoked_leader_lease_ht_;
+  revoked_leader_lease_term_ = kMinimumTerm;
+  return true;
+}
+
+boost::optional<MicrosTime> ReplicaState::LeaderLeaseRevocationBoundUnlocked(
+    MicrosTime now) const {
+  DCHECK(IsLocked());
+  if (RemainingOldLeaderLeaseDuration()) {
+    return boost::none;
+  }
+  return std::max(now, old_leader_ht_lease_expiration_);
+}
+
 template <class Policy>
 LeaderLeaseStatus ReplicaState::GetLeaseStatusUnlocked(Policy policy) const {
   DCHECK_EQ(GetActiveRoleUnlocked(), RaftPeerPB_Role_LEADER);
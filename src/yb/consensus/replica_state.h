@@ -40,6 +40,8 @@
 #include <utility>
 #include <vector>
 
+#include <boost/optional/optional.hpp>
+
 #include "yb/common/hybrid_time.h"
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
@@ -354,6 +356,21 @@ class ReplicaState {
   void UpdateOldLeaderLeaseExpirationUnlocked(
       MonoTime lease_expiration, MicrosTime ht_lease_expiration);
 
+  // Remembers that the leader of the specified term stepped down and revoked its lease. None of
+  // hybrid times used by that leader is greater than ht_bound.
+  void OldLeaderLeaseRevokedUnlocked(ConsensusTerm term, MicrosTime ht_bound);
+
+  // Called after winning an election for election_term. If the leader of the previous term revoked
+  // its lease, there is nothing to wait out, so the old leader lease is replaced with the revoked
+  // hybrid time bound and true is returned.
+  bool ApplyRevokedOldLeaderLeaseUnlocked(ConsensusTerm election_term);
+
+  // Called by the leader that stepped down to transfer its leadership. Returns the bound to revoke
+  // its lease with, that is not less than now and than hybrid times leased by earlier leaders.
+  // Returns none while the lease of an earlier leader is not waited out yet, because that leader
+  // could still serve and the protege has to wait it out too.
+  boost::optional<MicrosTime> LeaderLeaseRevocationBoundUnlocked(MicrosTime now) const;
+
   void SetMajorityReplicatedLeaseExpirationUnlocked(
       const MajorityReplicatedData& majority_replicated_data);
 
@@ -485,6 +502,11 @@ class ReplicaState {
 
   mutable MicrosTime old_leader_ht_lease_expiration_ = HybridTime::kMin.GetPhysicalValueMicros();
 
+  // Term of the last leader that revoked its lease while transferring leadership to this peer, and
+  // the upper bound on hybrid times used by that leader.
+  ConsensusTerm revoked_leader_lease_term_ = kMinimumTerm;
+  MicrosTime revoked_leader_lease_ht_ = HybridTime::kMin.GetPhysicalValueMicros();
+
   // LEADER only: the latest committed lease expiration deadline for the current leader. The leader
   // is allowed to serve up-to-date reads and accept writes only while the current time is less than
   // this. However, the leader might manage to replicate a lease extension without losing its
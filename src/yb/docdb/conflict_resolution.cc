@@ -34,8 +34,6 @@ namespace docdb {
 
 namespace {
 
-using TransactionIdSet = std::unordered_set<TransactionId, TransactionIdHash>;
-
 struct TransactionData {
   TransactionId id;
   TransactionStatus status;
@@ -306,12 +304,14 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
  public:
   TransactionConflictResolverContext(const KeyValueWriteBatchPB& write_batch,
                                      HybridTime hybrid_time,
-                                     Counter* conflicts_metric)
+                                     Counter* conflicts_metric,
+                                     TransactionIdSet* blockers)
       : write_batch_(write_batch),
         hybrid_time_(hybrid_time),
         transaction_id_(FullyDecodeTransactionId(
             write_batch.transaction().transaction_id())),
-        conflicts_metric_(conflicts_metric)
+        conflicts_metric_(conflicts_metric),
+        blockers_(blockers)
   {}
 
   virtual ~TransactionConflictResolverContext() {}
@@ -376,6 +376,7 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
   CHECKED_STATUS CheckPriority(ConflictResolver* resolver,
                                std::vector<TransactionData>* transactions) override {
     auto our_priority = metadata_.priority;
+    const TransactionId* higher_priority_transaction = nullptr;
     for (auto& transaction : *transactions) {
       if (!fetched_metadata_for_transactions_) {
         auto their_metadata = resolver->Metadata(transaction.id);
@@ -389,11 +390,20 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
       }
       auto their_priority = transaction.metadata.priority;
       if (our_priority < their_priority) {
-        return MakeConflictStatus(transaction.id, "higher priority", conflicts_metric_);
+        if (!blockers_) {
+          return MakeConflictStatus(transaction.id, "higher priority", conflicts_metric_);
+        }
+        // Collect all transactions with higher priority, so we could wait for them.
+        blockers_->insert(transaction.id);
+        higher_priority_transaction = &transaction.id;
       }
     }
     fetched_metadata_for_transactions_ = true;
 
+    if (higher_priority_transaction) {
+      return MakeConflictStatus(*higher_priority_transaction, "higher priority",
+                                conflicts_metric_);
+    }
     return Status::OK();
   }
 
@@ -423,6 +433,7 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
   Status result_ = Status::OK();
   bool fetched_metadata_for_transactions_ = false;
   Counter* conflicts_metric_ = nullptr;
+  TransactionIdSet* blockers_;
 };
 
 class OperationConflictResolverContext : public ConflictResolverContext {
@@ -489,9 +500,11 @@ Status ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                    HybridTime hybrid_time,
                                    const DocDB& doc_db,
                                    TransactionStatusManager* status_manager,
-                                   Counter* conflicts_metric) {
+                                   Counter* conflicts_metric,
+                                   TransactionIdSet* blockers) {
   DCHECK(hybrid_time.is_valid());
-  TransactionConflictResolverContext context(write_batch, hybrid_time, conflicts_metric);
+  TransactionConflictResolverContext context(
+      write_batch, hybrid_time, conflicts_metric, blockers);
   ConflictResolver resolver(doc_db, status_manager, &context);
   return resolver.Resolve();
 }
@@ -46,11 +46,14 @@ class KeyValueWriteBatchPB;
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
 // conflicts_metric - transaction_conflicts metric to update.
+// blockers - when not null and conflict with higher priority transactions is found, receives ids
+//            of all such transactions, so caller could wait for them instead of failing.
 CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                            HybridTime hybrid_time,
                                            const DocDB& doc_db,
                                            TransactionStatusManager* status_manager,
-                                           Counter* conflicts_metric);
+                                           Counter* conflicts_metric,
+                                           TransactionIdSet* blockers = nullptr);
 
 // Resolves conflicts for doc operations.
 // Read all intents that could conflict with provided doc_ops.
@@ -256,5 +256,9 @@ rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
 
+rocksdb::UserBoundaryTag TagForDocHybridTime() {
+  return kDocHybridTimeTag;
+}
+
 } // namespace docdb
 } // namespace yb
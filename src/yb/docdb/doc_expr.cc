@@ -224,6 +224,106 @@ CHECKED_STATUS DocExprExecutor::EvalAvg(const QLValue& val, QLValue *aggr_avg) {
   return Status::OK();
 }
 
+CHECKED_STATUS DocExprExecutor::EvalSum(const QLValuePB& val, QLValuePB *aggr_sum) {
+  if (IsNull(*aggr_sum)) {
+    *aggr_sum = val;
+    return Status::OK();
+  }
+
+  switch (aggr_sum->value_case()) {
+    case QLValuePB::kInt8Value:
+      aggr_sum->set_int8_value(static_cast<int8_t>(aggr_sum->int8_value() + val.int8_value()));
+      break;
+    case QLValuePB::kInt16Value:
+      aggr_sum->set_int16_value(static_cast<int16_t>(aggr_sum->int16_value() + val.int16_value()));
+      break;
+    case QLValuePB::kInt32Value:
+      aggr_sum->set_int32_value(aggr_sum->int32_value() + val.int32_value());
+      break;
+    case QLValuePB::kInt64Value:
+      aggr_sum->set_int64_value(aggr_sum->int64_value() + val.int64_value());
+      break;
+    case QLValuePB::kFloatValue:
+      aggr_sum->set_float_value(aggr_sum->float_value() + val.float_value());
+      break;
+    case QLValuePB::kDoubleValue:
+      aggr_sum->set_double_value(aggr_sum->double_value() + val.double_value());
+      break;
+    default: {
+      // Types with encoded values, like varint and decimal, are summed by the generic code.
+      QLValue sum(std::move(*aggr_sum));
+      RETURN_NOT_OK(EvalSum(QLValue(val), &sum));
+      *aggr_sum = std::move(*sum.mutable_value());
+      break;
+    }
+  }
+  return Status::OK();
+}
+
+Result<bool> DocExprExecutor::EvalColumnAggregate(const QLExpressionPB& ql_expr,
+                                                  const QLTableRow& table_row,
+                                                  QLValue *aggr_result) {
+  if (!ql_expr.has_tscall()) {
+    return false;
+  }
+  const QLBCallPB& tscall = ql_expr.tscall();
+  if (tscall.operands().size() != 1 || !tscall.operands(0).has_column_id()) {
+    return false;
+  }
+  const TSOpcode tsopcode = static_cast<TSOpcode>(tscall.opcode());
+  switch (tsopcode) {
+    case TSOpcode::kCount: FALLTHROUGH_INTENDED;
+    case TSOpcode::kSum: FALLTHROUGH_INTENDED;
+    case TSOpcode::kMin: FALLTHROUGH_INTENDED;
+    case TSOpcode::kMax: FALLTHROUGH_INTENDED;
+    case TSOpcode::kAvg:
+      break;
+    default:
+      return false;
+  }
+
+  // All these aggregates skip NULL, and a column that is missing from the row is NULL.
+  const auto value = table_row.GetValue(tscall.operands(0).column_id());
+  if (!value || IsNull(*value)) {
+    return true;
+  }
+
+  switch (tsopcode) {
+    case TSOpcode::kCount:
+      RETURN_NOT_OK(EvalCount(aggr_result));
+      break;
+    case TSOpcode::kSum:
+      RETURN_NOT_OK(EvalSum(*value, aggr_result->mutable_value()));
+      break;
+    case TSOpcode::kMin:
+      if (aggr_result->IsNull() || *value < aggr_result->value()) {
+        *aggr_result->mutable_value() = *value;
+      }
+      break;
+    case TSOpcode::kMax:
+      if (aggr_result->IsNull() || *value > aggr_result->value()) {
+        *aggr_result->mutable_value() = *value;
+      }
+      break;
+    case TSOpcode::kAvg: {
+      // Average is accumulated as a map with a single count to sum entry, see EvalAvg.
+      if (aggr_result->IsNull()) {
+        aggr_result->set_map_value();
+        aggr_result->add_map_key()->set_int64_value(1);
+        *aggr_result->add_map_value() = *value;
+        break;
+      }
+      QLMapValuePB* map = aggr_result->mutable_map_value();
+      map->mutable_keys(0)->set_int64_value(map->keys(0).int64_value() + 1);
+      RETURN_NOT_OK(EvalSum(*value, map->mutable_values(0)));
+      break;
+    }
+    default:
+      break;
+  }
+  return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 
 }  // namespace docdb
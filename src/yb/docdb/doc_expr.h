@@ -11,6 +11,8 @@
 #include "yb/common/ql_expr.h"
 #include "yb/common/schema.h"
 
+#include "yb/util/result.h"
+
 namespace yb {
 namespace docdb {
 
@@ -37,7 +39,17 @@ class DocExprExecutor : public QLExprExecutor {
   CHECKED_STATUS EvalMin(const QLValue& val, QLValue *aggr_min);
   CHECKED_STATUS EvalAvg(const QLValue& val, QLValue *aggr_avg);
 
+  // Evaluate aggregate call (COUNT, SUM, MIN, MAX or AVG) over a single column directly on the
+  // column value stored in the row, without copying it. Returns false if the expression is not
+  // such a call, so it should be evaluated with EvalExpr.
+  Result<bool> EvalColumnAggregate(const QLExpressionPB& ql_expr,
+                                   const QLTableRow& table_row,
+                                   QLValue *aggr_result);
+
  protected:
+  // Same as EvalSum above, but works directly on the protobuf values.
+  CHECKED_STATUS EvalSum(const QLValuePB& val, QLValuePB *aggr_sum);
+
   vector<QLValue> aggr_result_;
 };
 
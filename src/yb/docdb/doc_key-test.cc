@@ -225,6 +225,36 @@ TEST(DocKeyTest, TestDocKeyEncoding) {
           PrimitiveValues("range1", 1000, "range2", 2000)).Encode().data()));
 }
 
+TEST(DocKeyTest, TestCoTableIdEncodingDecoding) {
+  Uuid table1;
+  ASSERT_OK(table1.FromHexString("0123456789abcdef0123456789abcdef"));
+  Uuid table2;
+  ASSERT_OK(table2.FromHexString("1123456789abcdef0123456789abcdef"));
+
+  const DocKey doc_key1(table1, PrimitiveValues("range1", 1000));
+  const DocKey doc_key2(table2, PrimitiveValues("range0", 1000));
+  const KeyBytes encoded1 = doc_key1.Encode();
+  const KeyBytes encoded2 = doc_key2.Encode();
+  ASSERT_EQ(ValueType::kTableId, DecodeValueType(encoded1.AsSlice()));
+
+  DocKey decoded;
+  ASSERT_OK(decoded.FullyDecodeFrom(encoded1.AsSlice()));
+  ASSERT_TRUE(decoded.has_cotable_id());
+  ASSERT_EQ(table1, decoded.cotable_id());
+  ASSERT_EQ(doc_key1, decoded);
+  ASSERT_NE(doc_key2, decoded);
+  auto encoded_size = ASSERT_RESULT(
+      DocKey::EncodedSize(encoded1.AsSlice(), DocKeyPart::WHOLE_DOC_KEY));
+  ASSERT_EQ(encoded1.size(), encoded_size);
+
+  // Keys of the same table are adjacent, and the order of keys agrees with the encoded order.
+  ASSERT_LT(encoded1.AsSlice().compare(encoded2.AsSlice()), 0);
+  ASSERT_LT(doc_key1, doc_key2);
+
+  // Table id alone is not a valid document key.
+  ASSERT_NOK(decoded.FullyDecodeFrom(Slice(encoded1.data().data(), kUuidSize + 1)));
+}
+
 TEST(DocKeyTest, TestBasicSubDocKeyEncodingDecoding) {
   const SubDocKey subdoc_key(DocKey({PrimitiveValue("some_doc_key")}),
                              PrimitiveValue("sk1"),
@@ -373,6 +403,45 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestFirstRangeComponentKeyMatching) {
+  DocDbAwareFirstRangeComponentFilterPolicy policy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr);
+  std::string keys[] = { "foo", "bar", "test" };
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  ASSERT_NE(builder, nullptr);
+  for (const auto& key : keys) {
+    builder->AddKey(policy.GetKeyTransformer()->Transform(
+        EncodeSubDocKey(key, "range_key", "sub_key", 12345L)));
+  }
+  // Key without range components.
+  builder->AddKey(policy.GetKeyTransformer()->Transform(
+      DocKey(0, PrimitiveValues("static"), {}).Encode().AsSlice()));
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const std::string& sub_doc_key_str) {
+    return reader->MayMatch(policy.GetKeyTransformer()->Transform(sub_doc_key_str));
+  };
+
+  for (const auto &key : keys) {
+    ASSERT_TRUE(may_match(EncodeSubDocKey(key, "range_key", "sub_key", 12345L))) << key;
+    ASSERT_TRUE(may_match(EncodeSubDocKey(key, "range_key", "another_sub_key", 55555L))) << key;
+    ASSERT_FALSE(may_match(EncodeSubDocKey(key, "another_range_key", "sub_key", 12345L))) << key;
+  }
+  ASSERT_TRUE(may_match(DocKey(0, PrimitiveValues("static"), {}).Encode().AsStringRef()));
+  ASSERT_FALSE(may_match(EncodeSubDocKey("fake", "range_key", "sub_key", 12345L)));
+
+  // Only the first range component is taken into account.
+  KeyBytes key = DocKey(0, PrimitiveValues("foo"), PrimitiveValues("range_key", 10)).Encode();
+  KeyBytes another_key =
+      DocKey(0, PrimitiveValues("foo"), PrimitiveValues("range_key", 20)).Encode();
+  ASSERT_EQ(policy.GetKeyTransformer()->Transform(key.AsSlice()).ToBuffer(),
+            policy.GetKeyTransformer()->Transform(another_key.AsSlice()).ToBuffer());
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
@@ -112,6 +112,13 @@ DocKey::DocKey(DocKeyHash hash,
       range_group_(range_components) {
 }
 
+DocKey::DocKey(const Uuid& cotable_id, const vector<PrimitiveValue>& range_components)
+    : cotable_id_present_(true),
+      cotable_id_(cotable_id),
+      hash_present_(false),
+      range_group_(range_components) {
+}
+
 KeyBytes DocKey::Encode() const {
   KeyBytes result;
   AppendTo(&result);
@@ -119,6 +126,12 @@ KeyBytes DocKey::Encode() const {
 }
 
 void DocKey::AppendTo(KeyBytes* out) const {
+  if (cotable_id_present_) {
+    std::string bytes;
+    CHECK_OK(cotable_id_.ToBytes(&bytes));
+    out->AppendValueType(ValueType::kTableId);
+    out->AppendRawBytes(bytes);
+  }
   if (hash_present_) {
     // We are not setting the "more items in group" bit on the hash field because it is not part
     // of "hashed" or "range" groups.
@@ -130,6 +143,7 @@ void DocKey::AppendTo(KeyBytes* out) const {
 }
 
 void DocKey::Clear() {
+  cotable_id_present_ = false;
   hash_present_ = false;
   hash_ = 0xdead;
   hashed_group_.clear();
@@ -154,6 +168,8 @@ class DecodeDocKeyCallback {
     return out_;
   }
 
+  void SetCoTableId(...) const {}
+
   void SetHash(...) const {}
  private:
   boost::container::small_vector_base<Slice>* out_;
@@ -169,6 +185,8 @@ class DummyCallback {
     return nullptr;
   }
 
+  void SetCoTableId(...) const {}
+
   void SetHash(...) const {}
 
   PrimitiveValue* AddSubkey() const {
@@ -203,6 +221,10 @@ class DocKey::DecodeFromCallback {
     return &key_->range_group_;
   }
 
+  void SetCoTableId(const Uuid& cotable_id) const {
+    key_->set_cotable_id(cotable_id);
+  }
+
   void SetHash(bool present, DocKeyHash hash = 0) const {
     key_->hash_present_ = present;
     if (present) {
@@ -233,6 +255,20 @@ yb::Status DocKey::DoDecode(rocksdb::Slice *slice,
     return STATUS(Corruption, "Document key is empty");
   }
 
+  if (*slice->data() == ValueTypeAsChar::kTableId) {
+    if (slice->size() < kUuidSize + 1) {
+      return STATUS_FORMAT(Corruption,
+          "Could not decode a table id of a document key: only $0 bytes left", slice->size());
+    }
+    Uuid cotable_id;
+    RETURN_NOT_OK(cotable_id.FromSlice(Slice(slice->data() + 1, kUuidSize)));
+    callback.SetCoTableId(cotable_id);
+    slice->remove_prefix(kUuidSize + 1);
+    if (slice->empty()) {
+      return STATUS(Corruption, "Document key has only table id");
+    }
+  }
+
   const ValueType first_value_type = static_cast<ValueType>(*slice->data());
 
   if (!IsPrimitiveValueType(first_value_type) && first_value_type != ValueType::kGroupEnd) {
@@ -288,6 +324,11 @@ yb::Status DocKey::FullyDecodeFrom(const rocksdb::Slice& slice) {
 
 string DocKey::ToString() const {
   string result = "DocKey(";
+  if (cotable_id_present_) {
+    result += "CoTableId=";
+    result += cotable_id_.ToString();
+    result += ", ";
+  }
   if (hash_present_) {
     result += StringPrintf("0x%04x", hash_);
     result += ", ";
@@ -301,7 +342,9 @@ string DocKey::ToString() const {
 }
 
 bool DocKey::operator ==(const DocKey& other) const {
-  return HashedComponentsEqual(other) && range_group_ == other.range_group_;
+  return cotable_id_present_ == other.cotable_id_present_ &&
+         (!cotable_id_present_ || cotable_id_ == other.cotable_id_) &&
+         HashedComponentsEqual(other) && range_group_ == other.range_group_;
 }
 
 bool DocKey::HashedComponentsEqual(const DocKey& other) const {
@@ -323,7 +366,17 @@ int DocKey::CompareTo(const DocKey& other) const {
   //       integration of CQL's hash partition keys in December 2016.
   DCHECK_EQ(hash_present_, other.hash_present_);
 
-  int result = 0;
+  int result = CompareUsingLessThan(cotable_id_present_, other.cotable_id_present_);
+  if (result != 0) return result;
+  if (cotable_id_present_) {
+    // Uuid comparison is not bytewise, so compare bytes to be consistent with the encoded order.
+    std::string bytes, other_bytes;
+    CHECK_OK(cotable_id_.ToBytes(&bytes));
+    CHECK_OK(other.cotable_id_.ToBytes(&other_bytes));
+    result = bytes.compare(other_bytes);
+    if (result != 0) return result;
+  }
+
   if (hash_present_) {
     result = CompareUsingLessThan(hash_, other.hash_);
     if (result != 0) return result;
@@ -678,6 +731,28 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
   }
 };
 
+class HashedAndFirstRangeComponentExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  HashedAndFirstRangeComponentExtractor() {}
+  HashedAndFirstRangeComponentExtractor(const HashedAndFirstRangeComponentExtractor&) = delete;
+  HashedAndFirstRangeComponentExtractor& operator=(
+      const HashedAndFirstRangeComponentExtractor&) = delete;
+
+  static HashedAndFirstRangeComponentExtractor& GetInstance() {
+    static HashedAndFirstRangeComponentExtractor instance;
+    return instance;
+  }
+
+  Slice Transform(Slice key) const override {
+    auto size = CHECK_RESULT(DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY));
+    Slice range_part(key.data() + size, key.size() - size);
+    if (!range_part.empty() && range_part[0] != static_cast<char>(ValueType::kGroupEnd)) {
+      CHECK_OK(PrimitiveValue::DecodeKey(&range_part, nullptr /* out */));
+    }
+    return Slice(key.data(), range_part.data());
+  }
+};
+
 } // namespace
 
 
@@ -709,6 +784,11 @@ const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTrans
   return &HashedComponentsExtractor::GetInstance();
 }
 
+const rocksdb::FilterPolicy::KeyTransformer*
+    DocDbAwareFirstRangeComponentFilterPolicy::GetKeyTransformer() const {
+  return &HashedAndFirstRangeComponentExtractor::GetInstance();
+}
+
 }  // namespace docdb
 
 }  // namespace yb
@@ -18,11 +18,13 @@
 #include <vector>
 
 #include <boost/container/small_vector.hpp>
+#include <boost/uuid/nil_generator.hpp>
 
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/filter_policy.h"
 #include "yb/util/slice.h"
 #include "yb/util/strongly_typed_bool.h"
+#include "yb/util/uuid.h"
 
 #include "yb/common/schema.h"
 #include "yb/docdb/primitive_value.h"
@@ -40,12 +42,15 @@ class DocPath;
 
 // A key that allows us to locate a document. This is the prefix of all RocksDB keys of records
 // inside this document. A document key contains:
+//   - An optional id of the table, for tables that are colocated with other tables in the same
+//     tablet.
 //   - An optional fixed-width hash prefix.
 //   - A group of primitive values representing "hashed" components (this is what the hash is
 //     computed based on, so this group is present/absent together with the hash).
 //   - A group of "range" components suitable for doing ordered scans.
 //
 // The encoded representation of the key is as follows:
+//   - Optional table id: the byte ValueType::kTableId, followed by 16 bytes of table UUID.
 //   - Optional fixed-width hash prefix, followed by hashed components:
 //     * The byte ValueType::kUInt16Hash, followed by two bytes of the hash prefix.
 //     * Hashed components:
@@ -84,6 +89,9 @@ class DocKey {
          const std::vector<PrimitiveValue>& hashed_components,
          const std::vector<PrimitiveValue>& range_components = std::vector<PrimitiveValue>());
 
+  // Construct a document key of a colocated table with the given id.
+  DocKey(const Uuid& cotable_id, const std::vector<PrimitiveValue>& range_components);
+
   KeyBytes Encode() const;
   void AppendTo(KeyBytes* out) const;
 
@@ -97,6 +105,19 @@ class DocKey {
     return hash_;
   }
 
+  bool has_cotable_id() const {
+    return cotable_id_present_;
+  }
+
+  const Uuid& cotable_id() const {
+    return cotable_id_;
+  }
+
+  void set_cotable_id(const Uuid& cotable_id) {
+    cotable_id_present_ = true;
+    cotable_id_ = cotable_id;
+  }
+
   const std::vector<PrimitiveValue>& hashed_group() const {
     return hashed_group_;
   }
@@ -131,7 +152,7 @@ class DocKey {
 
   // Check if it is an empty key.
   bool empty() const {
-    return !hash_present_ && range_group_.empty();
+    return !cotable_id_present_ && !hash_present_ && range_group_.empty();
   }
 
   bool operator ==(const DocKey& other) const;
@@ -175,6 +196,8 @@ class DocKey {
                                  DocKeyPart part_to_decode,
                                  const Callback& callback);
 
+  bool cotable_id_present_ = false;
+  Uuid cotable_id_{boost::uuids::nil_uuid()};
   bool hash_present_;
   DocKeyHash hash_;
   std::vector<PrimitiveValue> hashed_group_;
@@ -531,6 +554,17 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
 };
 
+// This filter policy takes into account hashed components and the first range component of keys,
+// so range bounded scans that fix the first range component could also skip SST files.
+class DocDbAwareFirstRangeComponentFilterPolicy : public DocDbAwareFilterPolicy {
+ public:
+  using DocDbAwareFilterPolicy::DocDbAwareFilterPolicy;
+
+  const char* Name() const override { return "DocKeyHashedAndFirstRangeComponentFilter"; }
+
+  const KeyTransformer* GetKeyTransformer() const override;
+};
+
 // Combined DB to store regular records and intents.
 struct DocDB {
   rocksdb::DB* regular;
@@ -19,6 +19,7 @@
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/stopwatch.h"
 
 #include "yb/util/slice.h"
 #include "yb/rocksdb/util/random.h"
@@ -114,6 +115,121 @@ TEST(DocKVUtilTest, ZeroEncodingAndDecoding) {
   }
 }
 
+TEST(DocKVUtilTest, ComplementZeroEncodingAndDecoding) {
+  rocksdb::Random rng(12345);
+  for (int i = 0; i < 1000; ++i) {
+    int len = rng.Next() % 200;
+    string s;
+    s.reserve(len);
+    for (int j = 0; j < len; ++j) {
+      // Make zeros and 0xff frequent, since they are special for this encoding.
+      const auto r = rng.Next() % 4;
+      s.push_back(r == 0 ? '\0' : (r == 1 ? '\xff' : static_cast<char>(rng.Next())));
+    }
+    string encoded_str;
+    ComplementZeroEncodeAndAppendStrToKey(s, &encoded_str);
+    encoded_str += "suffix";
+    rocksdb::Slice slice(encoded_str);
+    string decoded_str;
+    ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, &decoded_str));
+    ASSERT_EQ(s, decoded_str);
+    ASSERT_EQ("suffix", slice.ToBuffer());
+  }
+}
+
+namespace {
+
+// Byte by byte versions of the zero encoding, used as a baseline for the benchmark below.
+void ByteByByteZeroEncode(const string& s, string* dest) {
+  for (char c : s) {
+    if (c == '\0') {
+      dest->push_back('\0');
+      dest->push_back('\1');
+    } else {
+      dest->push_back(c);
+    }
+  }
+  TerminateZeroEncodedKeyStr(dest);
+}
+
+void ByteByByteZeroDecode(rocksdb::Slice* slice, string* result) {
+  const char* p = slice->cdata();
+  const char* end = p + slice->size();
+  while (p != end) {
+    if (*p == '\0') {
+      ++p;
+      if (*p++ == '\0') {
+        break;
+      }
+      result->push_back('\0');
+    } else {
+      result->push_back(*p++);
+    }
+  }
+  slice->remove_prefix(p - slice->cdata());
+}
+
+} // namespace
+
+TEST(DocKVUtilTest, BenchmarkZeroEncoding) {
+  constexpr int kNumStrings = 1000;
+  constexpr int kStringLength = 64;
+  const int num_iterations = AllowSlowTests() ? 1000 : 50;
+  rocksdb::Random rng(12345);
+  vector<string> strings;
+  for (int i = 0; i < kNumStrings; ++i) {
+    string s;
+    for (int j = 0; j < kStringLength; ++j) {
+      // Real keys contain few zeros.
+      s.push_back(static_cast<char>(rng.Next() % 256 == 0 ? 0 : 'a' + rng.Next() % 26));
+    }
+    strings.push_back(std::move(s));
+  }
+
+  string encoded;
+  LOG_TIMING(INFO, "Byte by byte zero encoding") {
+    for (int i = 0; i < num_iterations; ++i) {
+      encoded.clear();
+      for (const auto& s : strings) {
+        ByteByByteZeroEncode(s, &encoded);
+      }
+    }
+  }
+
+  string expected = encoded;
+  LOG_TIMING(INFO, "Zero encoding") {
+    for (int i = 0; i < num_iterations; ++i) {
+      encoded.clear();
+      for (const auto& s : strings) {
+        ZeroEncodeAndAppendStrToKey(s, &encoded);
+      }
+    }
+  }
+  ASSERT_EQ(expected, encoded);
+
+  string decoded;
+  LOG_TIMING(INFO, "Byte by byte zero decoding") {
+    for (int i = 0; i < num_iterations; ++i) {
+      rocksdb::Slice slice(encoded);
+      while (!slice.empty()) {
+        decoded.clear();
+        ByteByByteZeroDecode(&slice, &decoded);
+      }
+    }
+  }
+
+  LOG_TIMING(INFO, "Zero decoding") {
+    for (int i = 0; i < num_iterations; ++i) {
+      rocksdb::Slice slice(encoded);
+      while (!slice.empty()) {
+        decoded.clear();
+        ASSERT_OK(DecodeZeroEncodedStr(&slice, &decoded));
+      }
+    }
+  }
+  ASSERT_EQ(strings.back(), decoded);
+}
+
 TEST(DocKVUtilTest, TableTTL) {
   Schema schema;
   EXPECT_TRUE(TableTTL(schema).Equals(Value::kMaxTtl));
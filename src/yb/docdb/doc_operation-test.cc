@@ -22,6 +22,7 @@
 #include "yb/docdb/ql_rocksdb_storage.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 
@@ -34,6 +35,8 @@
 DECLARE_uint64(rocksdb_max_file_size_for_compaction);
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_level0_stop_writes_trigger);
+DECLARE_int32(scanner_default_batch_size_bytes);
+DECLARE_int32(ql_scan_iterator_cache_size);
 
 using namespace std::literals; // NOLINT
 
@@ -54,6 +57,7 @@ std::vector<ColumnId> CreateColumnIds(size_t count) {
 }
 
 constexpr int32_t kFixedHashCode = 0;
+constexpr int kNumPagedRows = 20;
 
 } // namespace
 
@@ -193,6 +197,15 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ <max> w: 2 }]) -> 4
   QLRowBlock ReadQLRow(const Schema& schema, int32_t primary_key, const HybridTime& read_time) {
     QLReadRequestPB ql_read_req;
     ql_read_req.add_hashed_column_values()->mutable_value()->set_int32_value(primary_key);
+    return ReadQLRows(schema, read_time, &ql_read_req);
+  }
+
+  // Reads rows with hash code kFixedHashCode, that match the specified request. When storage is
+  // not specified, a new one is used.
+  QLRowBlock ReadQLRows(const Schema& schema, const HybridTime& read_time,
+                        QLReadRequestPB* request, QLResponsePB* response = nullptr,
+                        const QLRocksDBStorage* storage = nullptr) {
+    QLReadRequestPB& ql_read_req = *request;
     ql_read_req.set_hash_code(kFixedHashCode);
     ql_read_req.set_max_hash_code(kFixedHashCode);
 
@@ -212,21 +225,73 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ <max> w: 2 }]) -> 4
     }
 
     QLReadOperation read_op(ql_read_req, kNonTransactionalOperationContext);
-    QLRocksDBStorage ql_storage(doc_db());
-    QLResultSet resultset;
+    boost::optional<QLRocksDBStorage> own_storage;
+    if (storage == nullptr) {
+      own_storage.emplace(doc_db());
+      storage = own_storage.get_ptr();
+    }
+    QLRSRowDesc rsrow_desc_obj(*rsrow_desc);
+    faststring rows_data;
+    QLResultSet resultset(&rsrow_desc_obj, &rows_data);
     HybridTime read_restart_ht;
     EXPECT_OK(read_op.Execute(
-        ql_storage, MonoTime::Max() /* deadline */, ReadHybridTime::SingleTime(read_time),
+        *storage, MonoTime::Max() /* deadline */, ReadHybridTime::SingleTime(read_time),
         schema, query_schema, &resultset, &read_restart_ht));
     EXPECT_FALSE(read_restart_ht.is_valid());
+    if (response != nullptr) {
+      *response = read_op.response();
+    }
 
     // Transfer the column values from result set to rowblock.
-    for (const auto& rsrow : resultset.rsrows()) {
-      QLRow& row = row_block.Extend();
-      row.SetColumnValues(rsrow.rscols());
-    }
+    Slice data = rows_data;
+    EXPECT_OK(row_block.Deserialize(YQL_CLIENT_CQL, &data));
+    EXPECT_EQ(resultset.rsrow_count(), row_block.row_count());
     return row_block;
   }
+
+  void WriteQLRows(const Schema& schema, int num_rows) {
+    for (int i = 0; i != num_rows; ++i) {
+      WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, {i, i, i, i}, 1000,
+                 HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 0));
+    }
+  }
+
+  // Reads rows written by WriteQLRows page by page, continuing from the paging state, like the
+  // CQL executor does. Invokes after_page after each page that returned paging state. Returns
+  // number of rows in each page.
+  std::vector<size_t> ReadQLPages(const Schema& schema, int num_rows,
+                                  const std::function<void()>& after_page = nullptr) {
+    QLRocksDBStorage storage(doc_db());
+    std::vector<size_t> page_sizes;
+    std::set<int32_t> keys;
+    QLPagingStatePB paging_state;
+    for (;;) {
+      QLReadRequestPB ql_read_req;
+      ql_read_req.set_limit(num_rows);
+      ql_read_req.set_return_paging_state(true);
+      if (!page_sizes.empty()) {
+        paging_state.set_total_num_rows_read(keys.size());
+        *ql_read_req.mutable_paging_state() = paging_state;
+      }
+      QLResponsePB response;
+      QLRowBlock row_block = ReadQLRows(
+          schema, HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(2000, 0), &ql_read_req,
+          &response, &storage);
+      page_sizes.push_back(row_block.row_count());
+      for (const auto& row : row_block.rows()) {
+        EXPECT_TRUE(keys.insert(row.column(0).int32_value()).second);
+      }
+      if (!response.has_paging_state()) {
+        break;
+      }
+      paging_state = response.paging_state();
+      if (after_page) {
+        after_page();
+      }
+    }
+    EXPECT_EQ(num_rows, keys.size());
+    return page_sizes;
+  }
 };
 
 TEST_F(DocOperationTest, TestRedisSetKVWithTTL) {
@@ -334,6 +399,33 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ physical: 1000 w: 3 }]) ->
   EXPECT_EQ(3, row_block.row(0).column(3).int32_value());
 }
 
+TEST_F(DocOperationTest, TestQLReadBatchGrowth) {
+  Schema schema = CreateSchema();
+  WriteQLRows(schema, kNumPagedRows);
+
+  // Each batch reaches the default size with its first row, so batches of a scan double.
+  FLAGS_scanner_default_batch_size_bytes = 1;
+  ASSERT_EQ(std::vector<size_t>({1, 1, 2, 4, 8, 4}), ReadQLPages(schema, kNumPagedRows));
+}
+
+TEST_F(DocOperationTest, TestQLScanIteratorCache) {
+  Schema schema = CreateSchema();
+  WriteQLRows(schema, kNumPagedRows);
+
+  FLAGS_scanner_default_batch_size_bytes = 1;
+  FLAGS_ql_scan_iterator_cache_size = 4;
+  auto* statistics = rocksdb()->GetDBOptions().statistics.get();
+  const auto open_iterators = statistics->getTickerCount(rocksdb::NO_ITERATORS);
+  std::vector<size_t> batch_sizes = ReadQLPages(
+      schema, kNumPagedRows, [statistics, open_iterators] {
+        // The iterator of the scan is kept between pages.
+        ASSERT_EQ(open_iterators + 1, statistics->getTickerCount(rocksdb::NO_ITERATORS));
+      });
+  ASSERT_EQ(std::vector<size_t>({1, 1, 2, 4, 8, 4}), batch_sizes);
+  // The last page does not return paging state, so its iterator is not kept.
+  ASSERT_EQ(open_iterators, statistics->getTickerCount(rocksdb::NO_ITERATORS));
+}
+
 TEST_F(DocOperationTest, TestQLReadWithoutLivenessColumn) {
   const DocKey doc_key(kFixedHashCode, PrimitiveValues(PrimitiveValue::Int32(100)),
                        PrimitiveValues());
@@ -923,5 +1015,58 @@ TEST_F(DocOperationTest, MaxFileSizeWithWritesTrigger) {
   ASSERT_EQ(0, stats->GetCFStats(rocksdb::InternalStats::LEVEL0_SLOWDOWN_TOTAL));
 }
 
+TEST_F(DocOperationTest, ColumnAggregate) {
+  constexpr ColumnIdRep kInt32Column = 10;
+  constexpr ColumnIdRep kDoubleColumn = 11;
+  constexpr ColumnIdRep kStringColumn = 12;
+  constexpr ColumnIdRep kMissingColumn = 13;
+
+  std::vector<QLExpressionPB> exprs;
+  for (auto opcode : {bfql::TSOpcode::kCount, bfql::TSOpcode::kSum, bfql::TSOpcode::kMin,
+                      bfql::TSOpcode::kMax, bfql::TSOpcode::kAvg}) {
+    for (auto column : {kInt32Column, kDoubleColumn, kStringColumn, kMissingColumn}) {
+      if (column == kStringColumn &&
+          (opcode == bfql::TSOpcode::kSum || opcode == bfql::TSOpcode::kAvg)) {
+        continue;
+      }
+      QLExpressionPB expr;
+      expr.mutable_tscall()->set_opcode(static_cast<int32_t>(opcode));
+      expr.mutable_tscall()->add_operands()->set_column_id(column);
+      exprs.push_back(expr);
+    }
+  }
+
+  DocExprExecutor executor;
+  std::vector<QLValue> column_results(exprs.size());
+  std::vector<QLValue> generic_results(exprs.size());
+  for (int i = 0; i != 10; ++i) {
+    QLTableRow row;
+    if (i % 3 != 0) {
+      QLValue value;
+      value.set_int32_value((i * 7) % 5 - 2);
+      row.AllocColumn(kInt32Column, value);
+    }
+    QLValue double_value;
+    double_value.set_double_value(i * 0.5);
+    row.AllocColumn(kDoubleColumn, double_value);
+    QLValue string_value;
+    if (i % 4 != 0) {
+      string_value.set_string_value(std::string(i, 'x'));
+    }
+    row.AllocColumn(kStringColumn, string_value);
+
+    for (size_t j = 0; j != exprs.size(); ++j) {
+      ASSERT_TRUE(ASSERT_RESULT(executor.EvalColumnAggregate(exprs[j], row, &column_results[j])));
+      ASSERT_OK(executor.EvalExpr(exprs[j], row, &generic_results[j]));
+      ASSERT_EQ(generic_results[j].ToString(), column_results[j].ToString()) << j;
+    }
+  }
+
+  QLExpressionPB column_expr;
+  column_expr.set_column_id(kInt32Column);
+  QLValue result;
+  ASSERT_FALSE(ASSERT_RESULT(executor.EvalColumnAggregate(column_expr, QLTableRow(), &result)));
+}
+
 }  // namespace docdb
 }  // namespace yb
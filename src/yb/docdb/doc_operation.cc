@@ -29,10 +29,13 @@
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/subdocument.h"
 
 #include "yb/server/hybrid_clock.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/stol_utils.h"
 #include "yb/util/trace.h"
 
@@ -47,6 +50,23 @@ DEFINE_bool(emulate_redis_responses,
     "and HDEL. If emulate_redis_responses is true, we read the required records to compute the "
     "response as specified by the official Redis API documentation. https://redis.io/commands");
 
+DEFINE_bool(ql_enable_packed_row, false,
+            "Write QL inserts that set all non-key columns of a row as a single packed row "
+            "entry, instead of an entry per column. Not used by transactional writes.");
+TAG_FLAG(ql_enable_packed_row, advanced);
+TAG_FLAG(ql_enable_packed_row, runtime);
+
+DEFINE_int32(scanner_default_batch_size_bytes, 64 * 1024,
+             "The default size for batches of scan results. Sequential scans that continue from "
+             "a paging state grow their batches up to scanner_max_batch_size_bytes.");
+TAG_FLAG(scanner_default_batch_size_bytes, advanced);
+TAG_FLAG(scanner_default_batch_size_bytes, runtime);
+
+DEFINE_int32(scanner_max_batch_size_bytes, 8 * 1024 * 1024,
+             "The maximum size for batches of scan results.");
+TAG_FLAG(scanner_max_batch_size_bytes, advanced);
+TAG_FLAG(scanner_max_batch_size_bytes, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -459,6 +479,83 @@ CHECKED_STATUS GetAndPopulateResponseValues(
   return Status::OK();
 }
 
+// Aggregates time series samples into buckets, that start at multiples of the bucket size, and
+// populates response with bucket start and aggregated value pairs, ordered by time.
+void PopulateTsAggregationResponse(const SubDocument::ObjectContainer& samples,
+                                   const RedisCollectionGetRangeRequestPB& request,
+                                   bool newest_first,
+                                   RedisResponsePB* response) {
+  struct Bucket {
+    int64_t count = 0;
+    long double sum = 0;
+    long double min = 0;
+    long double max = 0;
+  };
+
+  const int64_t bucket_size = request.aggregation_bucket_size();
+  std::map<int64_t, Bucket> buckets;
+  for (const auto& sample : samples) {
+    const auto& value = sample.second;
+    if (value.value_type() != ValueType::kString) {
+      response->set_code(RedisResponsePB_RedisStatusCode_WRONG_TYPE);
+      response->set_error_message("ERR value is not a valid float");
+      return;
+    }
+    auto number = util::CheckedStold(value.GetString());
+    if (!number.ok()) {
+      response->set_code(RedisResponsePB_RedisStatusCode_WRONG_TYPE);
+      response->set_error_message("ERR value is not a valid float");
+      return;
+    }
+    const int64_t timestamp = sample.first.GetInt64();
+    // Round down, also for negative timestamps.
+    int64_t bucket_start = timestamp - timestamp % bucket_size;
+    if (bucket_start > timestamp) {
+      bucket_start -= bucket_size;
+    }
+    auto& bucket = buckets[bucket_start];
+    if (bucket.count == 0) {
+      bucket.min = bucket.max = *number;
+    } else {
+      bucket.min = std::min(bucket.min, *number);
+      bucket.max = std::max(bucket.max, *number);
+    }
+    ++bucket.count;
+    bucket.sum += *number;
+  }
+
+  auto* array_response = response->mutable_array_response();
+  auto add_bucket = [&request, array_response](const std::pair<const int64_t, Bucket>& entry) {
+    const auto& bucket = entry.second;
+    array_response->add_elements(std::to_string(entry.first));
+    long double result = 0;
+    switch (request.aggregation_type()) {
+      case RedisCollectionGetRangeRequestPB_AggregationType_AVG:
+        result = bucket.sum / bucket.count;
+        break;
+      case RedisCollectionGetRangeRequestPB_AggregationType_MIN:
+        result = bucket.min;
+        break;
+      case RedisCollectionGetRangeRequestPB_AggregationType_MAX:
+        result = bucket.max;
+        break;
+      case RedisCollectionGetRangeRequestPB_AggregationType_SUM:
+        result = bucket.sum;
+        break;
+      case RedisCollectionGetRangeRequestPB_AggregationType_COUNT:
+        array_response->add_elements(std::to_string(bucket.count));
+        return;
+    }
+    array_response->add_elements(std::to_string(static_cast<double>(result)));
+  };
+  if (newest_first) {
+    std::for_each(buckets.rbegin(), buckets.rend(), add_bucket);
+  } else {
+    std::for_each(buckets.begin(), buckets.end(), add_bucket);
+  }
+  response->set_code(RedisResponsePB_RedisStatusCode_OK);
+}
+
 // Get normalized (with respect to card) upper and lower index bounds for reverse range scans.
 void GetNormalizedBounds(int64 low_idx, int64 high_idx, int64 card, bool reverse,
                          int64* low_idx_normalized, int64* high_idx_normalized) {
@@ -643,6 +740,11 @@ Status RedisWriteOperation::ApplySet(const DocOperationApplyData& data) {
 
         int new_elements_added = 0;
         int return_value = 0;
+        // Existing scores of all members are looked up with the same iterator, instead of creating
+        // a new one per member. Members are not sorted, so each lookup does a full seek.
+        if (!iterator_) {
+          InitializeIterator(data);
+        }
         for (int i = 0; i < kv.subkey_size(); i++) {
           // Check whether the value is already in the document, if so delete it.
           SubDocKey key_reverse = SubDocKey(DocKey::FromRedisKey(kv.hash_code(), kv.key()),
@@ -654,9 +756,7 @@ Status RedisWriteOperation::ApplySet(const DocOperationApplyData& data) {
           GetSubDocumentData get_data = { encoded_key_reverse, &subdoc_reverse,
                                           &subdoc_reverse_found };
           RETURN_NOT_OK(GetSubDocument(
-              data.doc_write_batch->doc_db(),
-              get_data, redis_query_id(), boost::none /* txn_op_context */, data.deadline,
-              data.read_time));
+              iterator_.get(), get_data, /* projection */ nullptr, SeekFwdSuffices::kFalse));
 
           // Flag indicating whether we should add the given entry to the sorted set.
           bool should_add_entry = true;
@@ -1331,6 +1431,23 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
           // If reverse is false, newest element is the first element returned.
           is_reverse = false;
         }
+        if (request_.get_collection_range_request().has_aggregation_type()) {
+          // Only the aggregated buckets are returned, instead of every sample in the range.
+          if (request_.get_collection_range_request().aggregation_bucket_size() <= 0) {
+            return STATUS(InvalidArgument, "Need to specify a positive aggregation bucket size");
+          }
+          RETURN_NOT_OK(GetSubDocument(
+              iterator_.get(), data, /* projection */ nullptr, SeekFwdSuffices::kFalse));
+          response_.set_allocated_array_response(new RedisArrayPB());
+          if (!doc_found) {
+            response_.set_code(RedisResponsePB_RedisStatusCode_NIL);
+          } else if (VerifyTypeAndSetCode(ValueType::kRedisTS, doc.value_type(), &response_)) {
+            PopulateTsAggregationResponse(
+                doc.object_container(), request_.get_collection_range_request(), !is_reverse,
+                &response_);
+          }
+          break;
+        }
         RETURN_NOT_OK(GetAndPopulateResponseValues(iterator_.get(), AddResponseValuesGeneric, data,
             ValueType::kRedisTS, request_, &response_,
             /* add_keys */ true, /* add_values */ true, is_reverse));
@@ -1758,6 +1875,9 @@ bool JoinNonStaticRow(
 Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response) {
   request_.Swap(request);
   response_ = response;
+  if (request_.has_row_block()) {
+    return InitRowBlock();
+  }
   require_read_ = RequireRead(request_, schema_);
   update_indexes_ = !request_.update_index_ids().empty();
 
@@ -1821,11 +1941,98 @@ Status QLWriteOperation::InitializeKeys(const bool hashed_key, const bool primar
   return Status::OK();
 }
 
+Status QLWriteOperation::InitRowBlock() {
+  if (request_.type() != QLWriteRequestPB::QL_STMT_INSERT || request_.has_if_expr() ||
+      request_.has_user_timestamp_usec() || !request_.update_index_ids().empty() ||
+      !request_.hashed_column_values().empty() || !request_.range_column_values().empty() ||
+      !request_.column_values().empty()) {
+    return STATUS(InvalidArgument, "Row block could be used only for plain inserts");
+  }
+
+  std::vector<const ColumnSchema*> columns;
+  columns.reserve(schema_.num_key_columns() + request_.row_block_column_ids_size());
+  for (size_t i = 0; i < schema_.num_key_columns(); i++) {
+    columns.push_back(&schema_.column(i));
+  }
+  for (const auto column_id : request_.row_block_column_ids()) {
+    const auto maybe_column = schema_.column_by_id(ColumnId(column_id));
+    RETURN_NOT_OK(maybe_column);
+    if (maybe_column->is_static() || maybe_column->type()->HasComplexValues() ||
+        schema_.is_key_column(ColumnId(column_id))) {
+      return STATUS_FORMAT(InvalidArgument, "Column $0 could not be written by row block",
+                           maybe_column->name());
+    }
+    columns.push_back(&*maybe_column);
+  }
+
+  const MonoDelta ttl =
+      request_.has_ttl() ? MonoDelta::FromMilliseconds(request_.ttl()) : Value::kMaxTtl;
+  const size_t num_hash_key_columns = schema_.num_hash_key_columns();
+  const size_t num_key_columns = schema_.num_key_columns();
+  block_rows_.reserve(request_.row_block_num_rows());
+
+  Slice data(request_.row_block());
+  QLValue value;
+  std::vector<PrimitiveValue> hashed_components;
+  std::vector<PrimitiveValue> range_components;
+  while (!data.empty()) {
+    if (data.size() < sizeof(uint16_t)) {
+      return STATUS(Corruption, "Truncated row block");
+    }
+    const uint16_t hash_code = NetworkByteOrder::Load16(data.data());
+    data.remove_prefix(sizeof(uint16_t));
+
+    hashed_components.clear();
+    range_components.clear();
+    BlockRow row;
+    row.column_values.reserve(columns.size() - num_key_columns + 1);
+    row.column_values.emplace_back(
+        PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn),
+        Value(PrimitiveValue(), ttl));
+    for (size_t i = 0; i != columns.size(); ++i) {
+      const ColumnSchema& column = *columns[i];
+      RETURN_NOT_OK(value.Deserialize(column.type(), YQL_CLIENT_CQL, &data));
+      if (i < num_key_columns && value.IsNull()) {
+        return STATUS_FORMAT(InvalidArgument, "Null value for key column $0", column.name());
+      }
+      auto primitive_value = PrimitiveValue::FromQLValuePB(value.value(), column.sorting_type());
+      if (i < num_hash_key_columns) {
+        hashed_components.push_back(std::move(primitive_value));
+      } else if (i < num_key_columns) {
+        range_components.push_back(std::move(primitive_value));
+      } else {
+        row.column_values.emplace_back(
+            PrimitiveValue(ColumnId(request_.row_block_column_ids(i - num_key_columns))),
+            Value(std::move(primitive_value), ttl));
+      }
+    }
+    const DocKey doc_key = num_hash_key_columns != 0
+        ? DocKey(hash_code, hashed_components, range_components)
+        : DocKey(range_components);
+    row.encoded_doc_key = doc_key.Encode();
+    block_rows_.push_back(std::move(row));
+  }
+
+  return Status::OK();
+}
+
+Status QLWriteOperation::ApplyRowBlock(const DocOperationApplyData& data) {
+  for (auto& row : block_rows_) {
+    RETURN_NOT_OK(data.doc_write_batch->SetRow(
+        row.encoded_doc_key, std::move(row.column_values), request_.query_id()));
+  }
+  response_->set_status(QLResponsePB::YQL_STATUS_OK);
+  return Status::OK();
+}
+
 void QLWriteOperation::GetDocPathsToLock(list<DocPath> *paths, IsolationLevel *level) const {
   if (hashed_doc_path_ != nullptr)
     paths->push_back(*hashed_doc_path_);
   if (pk_doc_path_ != nullptr)
     paths->push_back(*pk_doc_path_);
+  for (const auto& row : block_rows_) {
+    paths->emplace_back(row.encoded_doc_key);
+  }
   // When this write operation requires a read, it requires a read snapshot so paths will be locked
   // in snapshot isolation for consistency. Otherwise, pure writes will happen in serializable
   // isolation so that they will serialize but do not conflict with one another.
@@ -2111,6 +2318,10 @@ Status QLWriteOperation::ApplyForRegularColumns(const QLColumnValuePB& column_va
 }
 
 Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
+  if (!block_rows_.empty()) {
+    return ApplyRowBlock(data);
+  }
+
   bool should_apply = true;
   QLTableRow existing_row;
   if (request_.has_if_expr()) {
@@ -2163,6 +2374,23 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
         // Add the appropriate liveness column only for inserts.
         // We never use init markers for QL to ensure we perform writes without any reads to
         // ensure our write path is fast while complicating the read path a bit.
+        if (request_.type() == QLWriteRequestPB::QL_STMT_INSERT && pk_doc_path_ != nullptr &&
+            FLAGS_ql_enable_packed_row &&
+            VERIFY_RESULT(ApplyPackedRow(data, existing_row, ttl, user_timestamp, &new_row))) {
+          if (update_indexes_) {
+            RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
+          }
+          break;
+        }
+
+        if (request_.type() == QLWriteRequestPB::QL_STMT_INSERT && pk_doc_path_ != nullptr &&
+            VERIFY_RESULT(ApplyRow(data, existing_row, ttl, user_timestamp, &new_row))) {
+          if (update_indexes_) {
+            RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
+          }
+          break;
+        }
+
         if (request_.type() == QLWriteRequestPB::QL_STMT_INSERT && pk_doc_path_ != nullptr) {
           const DocPath sub_path(pk_doc_path_->encoded_doc_key(),
                                  PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
@@ -2323,6 +2551,112 @@ Status QLWriteOperation::DeleteRow(const DocPath& row_path, DocWriteBatch* doc_w
   return Status::OK();
 }
 
+Result<bool> QLWriteOperation::ApplyPackedRow(const DocOperationApplyData& data,
+                                              const QLTableRow& existing_row,
+                                              const MonoDelta& ttl,
+                                              const UserTimeMicros& user_timestamp,
+                                              QLTableRow* new_row) {
+  // Intents of a packed row write are strong only on the packed row column, so in a transaction
+  // it would not conflict with writes of other columns of the same row.
+  if (txn_op_context_) {
+    return false;
+  }
+  // Packed row hides all values written before it, so it is used only when all non-key columns
+  // are overwritten with regular values.
+  if (user_timestamp != Value::kInvalidUserTimestamp) {
+    return false;
+  }
+  size_t num_regular_columns = 0;
+  for (size_t i = schema_.num_key_columns(); i < schema_.num_columns(); i++) {
+    const auto& column = schema_.column(i);
+    if (column.is_static() || column.type()->HasComplexValues()) {
+      return false;
+    }
+    ++num_regular_columns;
+  }
+  if (num_regular_columns == 0 ||
+      static_cast<size_t>(request_.column_values_size()) != num_regular_columns) {
+    return false;
+  }
+
+  std::unordered_set<ColumnIdRep> column_ids;
+  for (const auto& column_value : request_.column_values()) {
+    if (!column_value.has_column_id() || !column_value.json_args().empty() ||
+        !column_value.subscript_args().empty() ||
+        GetTSWriteInstruction(column_value.expr()) != TSOpcode::kScalarInsert ||
+        !column_ids.insert(column_value.column_id()).second) {
+      return false;
+    }
+  }
+
+  PackedRow packed_row(request_.schema_version());
+  for (const auto& column_value : request_.column_values()) {
+    const ColumnId column_id(column_value.column_id());
+    const auto maybe_column = schema_.column_by_id(column_id);
+    RETURN_NOT_OK(maybe_column);
+    const ColumnSchema& column = *maybe_column;
+    QLValue expr_result;
+    RETURN_NOT_OK(EvalExpr(column_value.expr(), existing_row, &expr_result));
+    // Null values are not stored, since the packed row overwrites all columns.
+    if (!IsNull(expr_result.value())) {
+      packed_row.AddColumn(
+          column_id, PrimitiveValue::FromQLValuePB(expr_result.value(), column.sorting_type()));
+    }
+    if (update_indexes_) {
+      new_row->AllocColumn(column_id, expr_result);
+    }
+  }
+
+  const DocPath sub_path(pk_doc_path_->encoded_doc_key(),
+                         PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow));
+  const auto value = Value(PrimitiveValue(packed_row.Encode()), ttl, user_timestamp);
+  RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(sub_path, value, request_.query_id()));
+  return true;
+}
+
+Result<bool> QLWriteOperation::ApplyRow(const DocOperationApplyData& data,
+                                        const QLTableRow& existing_row,
+                                        const MonoDelta& ttl,
+                                        const UserTimeMicros& user_timestamp,
+                                        QLTableRow* new_row) {
+  for (const auto& column_value : request_.column_values()) {
+    if (!column_value.has_column_id() || !column_value.json_args().empty() ||
+        !column_value.subscript_args().empty() ||
+        GetTSWriteInstruction(column_value.expr()) != TSOpcode::kScalarInsert) {
+      return false;
+    }
+    const auto maybe_column = schema_.column_by_id(ColumnId(column_value.column_id()));
+    RETURN_NOT_OK(maybe_column);
+    if (maybe_column->is_static() || maybe_column->type()->HasComplexValues()) {
+      return false;
+    }
+  }
+
+  std::vector<std::pair<PrimitiveValue, Value>> column_values;
+  column_values.reserve(request_.column_values_size() + 1);
+  column_values.emplace_back(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn),
+                             Value(PrimitiveValue(), ttl, user_timestamp));
+  for (const auto& column_value : request_.column_values()) {
+    const ColumnId column_id(column_value.column_id());
+    const auto maybe_column = schema_.column_by_id(column_id);
+    RETURN_NOT_OK(maybe_column);
+    const ColumnSchema& column = *maybe_column;
+    QLValue expr_result;
+    RETURN_NOT_OK(EvalExpr(column_value.expr(), existing_row, &expr_result));
+    column_values.emplace_back(
+        PrimitiveValue(column_id),
+        Value(PrimitiveValue::FromQLValuePB(expr_result.value(), column.sorting_type()), ttl,
+              user_timestamp));
+    if (update_indexes_) {
+      new_row->AllocColumn(column_id, expr_result);
+    }
+  }
+
+  RETURN_NOT_OK(data.doc_write_batch->SetRow(
+      pk_doc_path_->encoded_doc_key(), std::move(column_values), request_.query_id()));
+  return true;
+}
+
 namespace {
 
 YB_DEFINE_ENUM(ValueState, (kNull)(kNotNull)(kMissing));
@@ -2485,6 +2819,18 @@ Status QLWriteOperation::UpdateIndexes(const QLTableRow& existing_row, const QLT
   return Status::OK();
 }
 
+void QLReadOperation::UpdateMinTtl(const Schema& projection, const QLTableRow& row) {
+  for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
+    int64_t ttl_seconds;
+    if (!row.GetTTL(projection.column_id(i), &ttl_seconds).ok() || ttl_seconds < 0) {
+      continue;
+    }
+    if (min_ttl_seconds_ < 0 || ttl_seconds < min_ttl_seconds_) {
+      min_ttl_seconds_ = ttl_seconds;
+    }
+  }
+}
+
 Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
                                 MonoTime deadline,
                                 const ReadHybridTime& read_time,
@@ -2518,6 +2864,7 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   std::unique_ptr<common::YQLRowwiseIteratorIf> iter;
   std::unique_ptr<common::QLScanSpec> spec, static_row_spec;
   ReadHybridTime req_read_time;
+  MonoTime stage_start = MonoTime::Now();
   RETURN_NOT_OK(ql_storage.BuildYQLScanSpec(
       request_, read_time, schema, read_static_columns, static_projection, &spec,
       &static_row_spec, &req_read_time));
@@ -2543,11 +2890,32 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
       RETURN_NOT_OK(static_row_iter->NextRow(&static_row));
     }
   }
+  MonoTime now = MonoTime::Now();
+  iterator_init_time_ = now.GetDeltaSince(stage_start);
+  stage_start = now;
+
+  // When the read could be continued from the paging state, the batch of results is also bounded
+  // in size. Sequential scans grow their batches exponentially: after the default size is reached,
+  // the batch is returned only when it has as many rows as all previous batches of the scan. Under
+  // memory pressure batches are kept at the default size.
+  const bool limit_batch_size = request_.return_paging_state() && !request_.is_aggregate();
+  const size_t rows_read_before =
+      limit_batch_size && !MemTracker::GetRootTracker()->SoftLimitExceeded(nullptr)
+          ? request_.paging_state().total_num_rows_read() : 0;
+  auto batch_full = [limit_batch_size, rows_read_before, resultset] {
+    if (!limit_batch_size) {
+      return false;
+    }
+    const size_t size = resultset->rows_data_size();
+    return size >= static_cast<size_t>(FLAGS_scanner_max_batch_size_bytes) ||
+           (size >= static_cast<size_t>(FLAGS_scanner_default_batch_size_bytes) &&
+            resultset->rsrow_count() >= rows_read_before);
+  };
 
   // Begin the normal fetch.
   int match_count = 0;
   bool static_dealt_with = true;
-  while (resultset->rsrow_count() < row_count_limit && iter->HasNext()) {
+  while (resultset->rsrow_count() < row_count_limit && !batch_full() && iter->HasNext()) {
     const bool last_read_static = iter->IsNextStaticColumn();
 
     // Note that static columns are sorted before non-static columns in DocDB as follows. This is
@@ -2558,6 +2926,7 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     if (last_read_static) {
       static_row.Clear();
       RETURN_NOT_OK(iter->NextRow(static_projection, &static_row));
+      UpdateMinTtl(static_projection, static_row);
     } else { // Reading a regular row that contains non-static columns.
 
       // Read this regular row.
@@ -2565,6 +2934,7 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
       // would be to only read the first non-static column for each hash key, and skip the rest
       non_static_row.Clear();
       RETURN_NOT_OK(iter->NextRow(non_static_projection, &non_static_row));
+      UpdateMinTtl(non_static_projection, non_static_row);
     }
 
     // We have two possible cases: whether we use distinct or not
@@ -2627,28 +2997,44 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   if (request_.is_aggregate() && match_count > 0) {
     RETURN_NOT_OK(PopulateAggregate(selected_row, resultset));
   }
+  fetch_rows_time_ = MonoTime::Now().GetDeltaSince(stage_start);
 
   if (FLAGS_trace_docdb_calls) {
     TRACE("Fetched $0 rows.", resultset->rsrow_count());
   }
   *restart_read_ht = iter->RestartReadHt();
 
-  if ((resultset->rsrow_count() >= row_count_limit || request_.has_offset()) &&
+  if ((resultset->rsrow_count() >= row_count_limit || request_.has_offset() || batch_full()) &&
       !request_.is_aggregate()) {
     RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, num_rows_skipped, &response_));
   }
 
+  // The next page of the read continues with this iterator, when the storage keeps it.
+  if (!txn_op_context_ && !restart_read_ht->is_valid() &&
+      !response_.paging_state().next_row_key().empty()) {
+    ql_storage.CacheIterator(request_, response_.paging_state(), std::move(iter));
+  }
+
   return Status::OK();
 }
 
 CHECKED_STATUS QLReadOperation::PopulateResultSet(const QLTableRow& table_row,
                                                   QLResultSet *resultset) {
-  int column_count = request_.selected_exprs().size();
-  QLRSRow *rsrow = resultset->AllocateRSRow(column_count);
+  resultset->AllocateRow();
 
   int rscol_index = 0;
   for (const QLExpressionPB& expr : request_.selected_exprs()) {
-    RETURN_NOT_OK(EvalExpr(expr, table_row, rsrow->rscol(rscol_index)));
+    // Columns and constants are serialized in place, other expressions are evaluated first.
+    if (expr.expr_case() == QLExpressionPB::ExprCase::kColumnId) {
+      const auto value = table_row.GetValue(expr.column_id());
+      resultset->AppendColumn(rscol_index, value ? *value : QLValuePB());
+    } else if (expr.expr_case() == QLExpressionPB::ExprCase::kValue) {
+      resultset->AppendColumn(rscol_index, expr.value());
+    } else {
+      QLValue value;
+      RETURN_NOT_OK(EvalExpr(expr, table_row, &value));
+      resultset->AppendColumn(rscol_index, value);
+    }
     rscol_index++;
   }
 
@@ -2663,7 +3049,10 @@ CHECKED_STATUS QLReadOperation::EvalAggregate(const QLTableRow& table_row) {
 
   int aggr_index = 0;
   for (const QLExpressionPB& expr : request_.selected_exprs()) {
-    RETURN_NOT_OK(EvalExpr(expr, table_row, &aggr_result_[aggr_index]));
+    QLValue* aggr_result = &aggr_result_[aggr_index];
+    if (!VERIFY_RESULT(EvalColumnAggregate(expr, table_row, aggr_result))) {
+      RETURN_NOT_OK(EvalExpr(expr, table_row, aggr_result));
+    }
     aggr_index++;
   }
   return Status::OK();
@@ -2672,9 +3061,9 @@ CHECKED_STATUS QLReadOperation::EvalAggregate(const QLTableRow& table_row) {
 CHECKED_STATUS QLReadOperation::PopulateAggregate(const QLTableRow& table_row,
                                                   QLResultSet *resultset) {
   int column_count = request_.selected_exprs().size();
-  QLRSRow *rsrow = resultset->AllocateRSRow(column_count);
+  resultset->AllocateRow();
   for (int rscol_index = 0; rscol_index < column_count; rscol_index++) {
-    *rsrow->rscol(rscol_index) = aggr_result_[rscol_index];
+    resultset->AppendColumn(rscol_index, aggr_result_[rscol_index]);
   }
   return Status::OK();
 }
@@ -2926,9 +3315,10 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     // Match the row with the where condition before adding to the row block.
     bool is_match = true;
     if (request_.has_where_expr()) {
+      // Null, i.e. unknown, result of the condition does not match the row.
       QLValue match;
       RETURN_NOT_OK(EvalExpr(request_.where_expr(), selected_row, &match));
-      is_match = match.bool_value();
+      is_match = !match.IsNull() && match.bool_value();
     }
     if (is_match) {
       match_count++;
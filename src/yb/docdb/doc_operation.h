@@ -249,6 +249,27 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
 
   CHECKED_STATUS DeleteRow(const DocPath& row_path, DocWriteBatch* doc_write_batch);
 
+  // Decodes rows of the row block insert into block_rows_.
+  CHECKED_STATUS InitRowBlock();
+
+  CHECKED_STATUS ApplyRowBlock(const DocOperationApplyData& data);
+
+  // Writes a full row insert as a single packed row entry, when possible. Returns false if the
+  // insert could not be packed and nothing was written.
+  Result<bool> ApplyPackedRow(const DocOperationApplyData& data,
+                              const QLTableRow& existing_row,
+                              const MonoDelta& ttl,
+                              const UserTimeMicros& user_timestamp,
+                              QLTableRow* new_row);
+
+  // Writes an insert that sets only scalar values of regular columns with a single
+  // DocWriteBatch::SetRow call, when possible. Returns false if nothing was written.
+  Result<bool> ApplyRow(const DocOperationApplyData& data,
+                        const QLTableRow& existing_row,
+                        const MonoDelta& ttl,
+                        const UserTimeMicros& user_timestamp,
+                        QLTableRow* new_row);
+
   bool IsRowDeleted(const QLTableRow& current_row, const QLTableRow& new_row) const;
 
   CHECKED_STATUS UpdateIndexes(const QLTableRow& current_row, const QLTableRow& new_row);
@@ -291,6 +312,13 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
 
   // Does the liveness column exist before the write operation?
   bool liveness_column_exists_ = false;
+
+  // Rows of the row block insert, with the values ready to be written by DocWriteBatch::SetRow.
+  struct BlockRow {
+    KeyBytes encoded_doc_key;
+    std::vector<std::pair<PrimitiveValue, Value>> column_values;
+  };
+  std::vector<BlockRow> block_rows_;
 };
 
 class QLReadOperation : public DocExprExecutor {
@@ -323,10 +351,23 @@ class QLReadOperation : public DocExprExecutor {
 
   QLResponsePB& response() { return response_; }
 
+  // Time spent by Execute creating iterators, and seeking and iterating over rows.
+  MonoDelta iterator_init_time() const { return iterator_init_time_; }
+  MonoDelta fetch_rows_time() const { return fetch_rows_time_; }
+
+  // Min remaining TTL in seconds at read time of column values read by Execute, -1 when none of
+  // them has a TTL.
+  int64_t min_ttl_seconds() const { return min_ttl_seconds_; }
+
  private:
+  void UpdateMinTtl(const Schema& projection, const QLTableRow& row);
+
   const QLReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
   QLResponsePB response_;
+  MonoDelta iterator_init_time_ = MonoDelta::kZero;
+  MonoDelta fetch_rows_time_ = MonoDelta::kZero;
+  int64_t min_ttl_seconds_ = -1;
 };
 
 //--------------------------------------------------------------------------------------------------
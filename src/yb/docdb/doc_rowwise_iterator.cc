@@ -26,14 +26,52 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/util/flag_tags.h"
 
 using std::string;
 
 using yb::FormatRocksDBSliceAsStr;
 
+DECLARE_bool(docdb_bloom_filter_with_first_range_component);
+
+DEFINE_bool(docdb_scans_fill_block_cache, true,
+            "Whether data blocks read by scans that are not limited to a single hash key are added "
+            "to the block cache. Even when they are, they stay in the single touch part of the "
+            "cache unless accessed by another query.");
+TAG_FLAG(docdb_scans_fill_block_cache, advanced);
+TAG_FLAG(docdb_scans_fill_block_cache, runtime);
+
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Returns true if bloom filter could be used to skip SST files that do not contain keys between
+// the specified bounds.
+bool CanUseBloomFilter(const Schema& schema, const DocKey& lower, const DocKey& upper) {
+  // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
+  if (lower.empty() || !upper.HashedComponentsEqual(lower)) {
+    return false;
+  }
+  if (!FLAGS_docdb_bloom_filter_with_first_range_component ||
+      schema.num_range_key_columns() == 0) {
+    return true;
+  }
+  // Bloom filter also contains the first range component of keys, so it should be the same for
+  // all keys of the scan.
+  return !lower.range_group().empty() && !upper.range_group().empty() &&
+         lower.range_group()[0] == upper.range_group()[0];
+}
+
+// Returns true if data blocks read by scan between the specified bounds should be added to the
+// block cache.
+bool ShouldFillBlockCache(const DocKey& lower, const DocKey& upper) {
+  return FLAGS_docdb_scans_fill_block_cache ||
+         (!lower.empty() && upper.HashedComponentsEqual(lower));
+}
+
+} // namespace
+
 DocRowwiseIterator::DocRowwiseIterator(
     const Schema &projection,
     const Schema &schema,
@@ -51,8 +89,11 @@ DocRowwiseIterator::DocRowwiseIterator(
       has_bound_key_(false),
       pending_op_(pending_op_counter),
       done_(false) {
-  projection_subkeys_.reserve(projection.num_columns() + 1);
+  projection_subkeys_.reserve(projection.num_columns() + 2);
   projection_subkeys_.push_back(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
+  // Packed row should be read before other columns, that is ensured by sorting, because system
+  // column ids are ordered before regular column ids.
+  projection_subkeys_.push_back(PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow));
   for (size_t i = projection_.num_key_columns(); i < projection.num_columns(); i++) {
     projection_subkeys_.emplace_back(projection.column_id(i));
   }
@@ -67,7 +108,9 @@ Status DocRowwiseIterator::Init() {
 
   db_iter_ = CreateIntentAwareIterator(
       doc_db_, BloomFilterMode::DONT_USE_BLOOM_FILTER,
-      boost::none /* user_key_for_filter */, query_id, txn_op_context_, deadline_, read_time_);
+      boost::none /* user_key_for_filter */, query_id, txn_op_context_, deadline_, read_time_,
+      nullptr /* file_filter */, nullptr /* iterate_upper_bound */,
+      FLAGS_docdb_scans_fill_block_cache);
 
   row_key_ = DocKey();
   db_iter_->Seek(row_key_);
@@ -89,18 +132,16 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   RETURN_NOT_OK(doc_spec.upper_bound(&upper_doc_key));
   VLOG(4) << "DocKey Bounds " << lower_doc_key.ToString() << ", " << upper_doc_key.ToString();
 
-  // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
-  const bool is_fixed_point_get = !lower_doc_key.empty() &&
-      upper_doc_key.HashedComponentsEqual(lower_doc_key);
-  const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
-      BloomFilterMode::DONT_USE_BLOOM_FILTER;
+  const auto mode = CanUseBloomFilter(schema_, lower_doc_key, upper_doc_key) ?
+      BloomFilterMode::USE_BLOOM_FILTER : BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
 
   db_iter_ = CreateIntentAwareIterator(
       doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_,
-      deadline_, read_time_, doc_spec.CreateFileFilter());
+      deadline_, read_time_, doc_spec.CreateFileFilter(), nullptr /* iterate_upper_bound */,
+      ShouldFillBlockCache(lower_doc_key, upper_doc_key));
 
   db_iter_->Seek(row_key_encoded);
   row_ready_ = false;
@@ -144,18 +185,16 @@ Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
   RETURN_NOT_OK(doc_spec.upper_bound(&upper_doc_key));
   VLOG(4) << "DocKey Bounds " << lower_doc_key.ToString() << ", " << upper_doc_key.ToString();
 
-  // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
-  const bool is_fixed_point_get = !lower_doc_key.empty() &&
-      upper_doc_key.HashedComponentsEqual(lower_doc_key);
-  const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
-      BloomFilterMode::DONT_USE_BLOOM_FILTER;
+  const auto mode = CanUseBloomFilter(schema_, lower_doc_key, upper_doc_key) ?
+      BloomFilterMode::USE_BLOOM_FILTER : BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
 
   db_iter_ = CreateIntentAwareIterator(
       doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_,
-      deadline_, read_time_, doc_spec.CreateFileFilter());
+      deadline_, read_time_, doc_spec.CreateFileFilter(), nullptr /* iterate_upper_bound */,
+      ShouldFillBlockCache(lower_doc_key, upper_doc_key));
 
   db_iter_->Seek(row_key_encoded);
   row_ready_ = false;
@@ -255,16 +294,18 @@ bool DocRowwiseIterator::HasNext() const {
 
     if (!doc_found) {
       SubDocument full_row;
-      // If doc is not found, decide if some non-projection column exists.
-      // Currently we read the whole doc here,
-      // may be optimized by exiting on the first column in future.
+      // If doc is not found, decide if some non-projection column exists. It is enough to find
+      // the first live column, so values of other columns are not read and decoded.
       db_iter_->Seek(row_key_);  // Position it for GetSubDocument.
       data.result = &full_row;
+      data.limit = 1;
       status_ = GetSubDocument(db_iter_.get(), data);
       if (!status_.ok()) {
         // Defer error reporting to NextRow().
         return true;
       }
+      // Reading could stop inside the document, so move the iterator past it.
+      db_iter_->SeekOutOfSubDoc(sub_doc_key);
     }
     status_ = EnsureIteratorPositionCorrect();
     if (!status_.ok()) {
@@ -357,14 +398,15 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
   for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
     const auto& column_id = projection.column_id(i);
     const auto ql_type = projection.column(i).type();
-    const SubDocument* column_value = row_.GetChild(PrimitiveValue(column_id));
+    SubDocument* column_value = row_.GetChild(PrimitiveValue(column_id));
     if (column_value != nullptr) {
       QLTableColumn& column = table_row->AllocColumn(column_id);
-      SubDocument::ToQLValuePB(*column_value, ql_type, &column.value);
       column.ttl_seconds = column_value->GetTtl();
       if (column_value->IsWriteTimeSet()) {
         column.write_time = column_value->GetWriteTime();
       }
+      // The row is read only once, so its values could be moved to the result.
+      SubDocument::MoveToQLValuePB(column_value, ql_type, &column.value);
     }
   }
   row_ready_ = false;
@@ -372,9 +414,14 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
 }
 
 bool DocRowwiseIterator::LivenessColumnExists() const {
-  const SubDocument* subdoc = row_.GetChild(
-      PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
-  return subdoc != nullptr && subdoc->value_type() != ValueType::kInvalid;
+  // Packed row is written by insert instead of the liveness column.
+  for (auto column : {SystemColumnIds::kLivenessColumn, SystemColumnIds::kPackedRow}) {
+    const SubDocument* subdoc = row_.GetChild(PrimitiveValue::SystemColumnId(column));
+    if (subdoc != nullptr && subdoc->value_type() != ValueType::kInvalid) {
+      return true;
+    }
+  }
+  return false;
 }
 
 CHECKED_STATUS DocRowwiseIterator::GetNextReadSubDocKey(SubDocKey* sub_doc_key) const {
@@ -13,6 +13,8 @@
 
 #include "yb/docdb/doc_write_batch.h"
 
+#include <algorithm>
+
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/internal_doc_iterator.h"
@@ -34,6 +36,31 @@ DocWriteBatch::DocWriteBatch(const DocDB& doc_db,
       num_rocksdb_seeks_(0) {
 }
 
+namespace {
+
+// Checks whether a write with the specified user timestamp should be applied over the subdocument
+// the iterator was positioned at by SeekToKeyPrefix.
+bool UserTimestampAllowsWrite(UserTimeMicros write_user_timestamp,
+                              const InternalDocIterator& doc_iter) {
+  // We'd like to include tombstones in our timestamp comparisons as well.
+  if ((doc_iter.subdoc_exists() || doc_iter.subdoc_type_unchecked() == ValueType::kTombstone) &&
+      doc_iter.found_exact_key_prefix_unchecked()) {
+    UserTimeMicros user_timestamp = doc_iter.subdoc_user_timestamp_unchecked();
+
+    if (user_timestamp != Value::kInvalidUserTimestamp) {
+      return write_user_timestamp >= user_timestamp;
+    }
+    // Look at the hybrid time instead.
+    const DocHybridTime& doc_hybrid_time = doc_iter.subdoc_ht_unchecked();
+    if (doc_hybrid_time.hybrid_time().is_valid()) {
+      return write_user_timestamp >= doc_hybrid_time.hybrid_time().GetPhysicalValueMicros();
+    }
+  }
+  return true;
+}
+
+} // namespace
+
 Result<bool> DocWriteBatch::SetPrimitiveInternalHandleUserTimestamp(
     const Value &value,
     InternalDocIterator* doc_iter) {
@@ -42,22 +69,7 @@ Result<bool> DocWriteBatch::SetPrimitiveInternalHandleUserTimestamp(
     // Seek for the older version of the key that we're about to write to. This is essentially a
     // NOOP if we've already performed the seek due to the cache used in our iterator.
     RETURN_NOT_OK(doc_iter->SeekToKeyPrefix());
-    // We'd like to include tombstones in our timestamp comparisons as well.
-    if ((doc_iter->subdoc_exists() || doc_iter->subdoc_type_unchecked() == ValueType::kTombstone) &&
-        doc_iter->found_exact_key_prefix_unchecked()) {
-      UserTimeMicros user_timestamp = doc_iter->subdoc_user_timestamp_unchecked();
-
-      if (user_timestamp != Value::kInvalidUserTimestamp) {
-        should_apply = value.user_timestamp() >= user_timestamp;
-      } else {
-        // Look at the hybrid time instead.
-        const DocHybridTime& doc_hybrid_time = doc_iter->subdoc_ht_unchecked();
-        if (doc_hybrid_time.hybrid_time().is_valid()) {
-          should_apply = value.user_timestamp() >=
-              doc_hybrid_time.hybrid_time().GetPhysicalValueMicros();
-        }
-      }
-    }
+    should_apply = UserTimestampAllowsWrite(value.user_timestamp(), *doc_iter);
   }
   return should_apply;
 }
@@ -226,6 +238,66 @@ Status DocWriteBatch::SetPrimitive(const DocPath& doc_path,
   return SetPrimitiveInternal(doc_path, value, &doc_iter, is_deletion, num_subkeys);
 }
 
+Status DocWriteBatch::SetRow(const KeyBytes& encoded_doc_key,
+                             std::vector<std::pair<PrimitiveValue, Value>> column_values,
+                             rocksdb::QueryId query_id) {
+  if (!optional_init_markers()) {
+    // Init markers have to be maintained for each column, so there is nothing to share.
+    for (const auto& column_value : column_values) {
+      RETURN_NOT_OK(SetPrimitive(
+          DocPath(encoded_doc_key, column_value.first), column_value.second, query_id));
+    }
+    return Status::OK();
+  }
+
+  if (!column_values.empty() &&
+      put_batch_.size() + column_values.size() - 1 > numeric_limits<IntraTxnWriteId>::max()) {
+    return STATUS_SUBSTITUTE(
+        NotSupported,
+        "Trying to add more than $0 key/value pairs in the same single-shard txn.",
+        numeric_limits<IntraTxnWriteId>::max());
+  }
+
+  // Columns are written in key order, so the shared iterator only moves forward.
+  std::stable_sort(column_values.begin(), column_values.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+  InternalDocIterator doc_iter(
+      doc_db_.regular, &cache_, BloomFilterMode::USE_BLOOM_FILTER, encoded_doc_key,
+      query_id, &num_rocksdb_seeks_);
+  // An existing document is cached after the first lookup, so it is looked up again for each
+  // column with user timestamp. But a missing document is not cached, so we remember it here to
+  // avoid seeking RocksDB for it again. Columns of a missing document could only be found in the
+  // cache.
+  bool document_missing = false;
+  for (const auto& column_value : column_values) {
+    const Value& value = column_value.second;
+    doc_iter.SetDocumentKey(encoded_doc_key);
+    if (value.has_user_timestamp() && !document_missing) {
+      RETURN_NOT_OK(doc_iter.SeekToKeyPrefix());
+      document_missing = doc_iter.subdoc_type_unchecked() == ValueType::kInvalid;
+      // If the whole document was overwritten with a higher timestamp, skip this column.
+      if (!UserTimestampAllowsWrite(value.user_timestamp(), doc_iter)) {
+        continue;
+      }
+    }
+    doc_iter.AppendToPrefix(column_value.first);
+    if (value.has_user_timestamp() && (!document_missing || cache_.Get(doc_iter.key_prefix()))) {
+      RETURN_NOT_OK(doc_iter.SeekToKeyPrefix());
+      if (!UserTimestampAllowsWrite(value.user_timestamp(), doc_iter)) {
+        continue;
+      }
+    }
+
+    const auto write_id = static_cast<IntraTxnWriteId>(put_batch_.size());
+    put_batch_.emplace_back(doc_iter.key_prefix().AsStringRef(), value.Encode());
+    cache_.Put(doc_iter.key_prefix(), DocHybridTime(HybridTime::kMax, write_id),
+               value.primitive_value().value_type(), value.user_timestamp());
+  }
+
+  return Status::OK();
+}
+
 Status DocWriteBatch::ExtendSubDocument(
     const DocPath& doc_path,
     const SubDocument& value,
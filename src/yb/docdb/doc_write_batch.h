@@ -69,6 +69,14 @@ class DocWriteBatch {
     return SetPrimitive(doc_path, Value(value, Value::kMaxTtl, user_timestamp), query_id);
   }
 
+  // Sets primitive values of several subkeys of the document, e.g. all columns of a row. Adds the
+  // same entries as SetPrimitive for each subkey would, but looks up the document at most once,
+  // uses a single RocksDB iterator for all subkeys and adds entries in the order of subkeys.
+  CHECKED_STATUS SetRow(
+      const KeyBytes& encoded_doc_key,
+      std::vector<std::pair<PrimitiveValue, Value>> column_values,
+      rocksdb::QueryId query_id = rocksdb::kDefaultQueryId);
+
   // Extend the SubDocument in the given key. We'll support List with Append and Prepend mode later.
   // TODO(akashnil): 03/20/17 ENG-1107
   // In each SetPrimitive call, some common work is repeated. It may be made more
@@ -0,0 +1,300 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Benchmarks DocDB with CQL shaped rows: a hash and a range key column followed by a number of
+// regular columns, some of them written with TTL and overwritten several times. Rows are written
+// through DocWriteBatch, optionally as transactional intents, and read back through
+// DocRowwiseIterator, so the whole SubDocKey encoding and intent resolution stack is measured
+// instead of raw RocksDB keys.
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/statistics.h"
+
+#include "yb/common/ql_expr.h"
+
+#include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/docdb_test_util.h"
+
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/random.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DEFINE_int32(docdb_bench_num_rows, 20000, "Number of rows written by the benchmark.");
+DEFINE_int32(docdb_bench_rows_per_hash_key, 10,
+             "Number of rows, i.e. range key values, that share the same hash key.");
+DEFINE_int32(docdb_bench_num_columns, 5, "Number of regular columns in each row.");
+DEFINE_int32(docdb_bench_value_size, 32, "Size of each column value in bytes.");
+DEFINE_int32(docdb_bench_num_overwrites, 2,
+             "Number of times each row is updated after it was inserted.");
+DEFINE_int32(docdb_bench_ttl_percent, 20, "Percent of column writes that have TTL.");
+DEFINE_int32(docdb_bench_num_reads, 20000, "Number of point reads performed by the benchmark.");
+DEFINE_int32(docdb_bench_num_scans, 5, "Number of full table scans performed by the benchmark.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr int kFirstColumnId = 10;
+constexpr int64_t kHighestLatencyUs = 60 * 1000 * 1000;
+
+// Values of RocksDB tickers, that are used to compute statistics of a single benchmark phase.
+struct TickerSnapshot {
+  explicit TickerSnapshot(const rocksdb::Statistics& statistics) {
+    for (size_t i = 0; i != kTickers.size(); ++i) {
+      values[i] = statistics.getTickerCount(kTickers[i]);
+    }
+  }
+
+  uint64_t Get(rocksdb::Tickers ticker) const {
+    for (size_t i = 0; i != kTickers.size(); ++i) {
+      if (kTickers[i] == ticker) {
+        return values[i];
+      }
+    }
+    LOG(FATAL) << "Unexpected ticker: " << ticker;
+    return 0;
+  }
+
+  static constexpr std::array<rocksdb::Tickers, 8> kTickers = {{
+      rocksdb::BYTES_WRITTEN, rocksdb::FLUSH_WRITE_BYTES, rocksdb::COMPACT_WRITE_BYTES,
+      rocksdb::BLOCK_CACHE_HIT, rocksdb::BLOCK_CACHE_MISS, rocksdb::NUMBER_DB_SEEK,
+      rocksdb::NUMBER_DB_NEXT, rocksdb::BLOCK_CACHE_BYTES_READ }};
+
+  std::array<uint64_t, kTickers.size()> values;
+};
+
+constexpr std::array<rocksdb::Tickers, 8> TickerSnapshot::kTickers;
+
+} // namespace
+
+class DocDBBench : public DocDBTestBase {
+ protected:
+  void SetUp() override {
+    DocDBTestBase::SetUp();
+    std::vector<ColumnSchema> columns = {
+        ColumnSchema("h", DataType::INT64, false /* is_nullable */, true /* is_hash_key */),
+        ColumnSchema("r", DataType::INT64) };
+    for (int i = 0; i != FLAGS_docdb_bench_num_columns; ++i) {
+      columns.emplace_back("c" + std::to_string(i), DataType::STRING, true /* is_nullable */);
+    }
+    std::vector<ColumnId> ids;
+    for (size_t i = 0; i != columns.size(); ++i) {
+      ids.emplace_back(kFirstColumnId + i);
+    }
+    schema_ = Schema(columns, ids, 2 /* num_key_columns */);
+  }
+
+  DocKey RowKey(int row) const {
+    const int64_t hash_key = row / FLAGS_docdb_bench_rows_per_hash_key;
+    // Only the order of keys matters here, so a cheap mix is used instead of the partition hash.
+    const auto hash = static_cast<DocKeyHash>((hash_key * 0x9E3779B1ULL) >> 16);
+    const int64_t range_key = row % FLAGS_docdb_bench_rows_per_hash_key;
+    return DocKey(hash, { PrimitiveValue(hash_key) }, { PrimitiveValue(range_key) });
+  }
+
+  // Writes a single row as one DocWriteBatch. The first version of a row also gets the liveness
+  // column, like a CQL INSERT, later versions only update regular columns, like a CQL UPDATE.
+  void WriteRow(int row, int version, const boost::optional<TransactionId>& txn_id) {
+    const KeyBytes encoded_key = RowKey(row).Encode();
+    auto write_batch = MakeDocWriteBatch();
+    if (version == 0) {
+      ASSERT_OK(write_batch.SetPrimitive(
+          DocPath(encoded_key, PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn)),
+          Value(PrimitiveValue())));
+    }
+    for (int column = 0; column != FLAGS_docdb_bench_num_columns; ++column) {
+      const auto ttl = RandomUniformInt(0, 99) < FLAGS_docdb_bench_ttl_percent
+          ? MonoDelta::FromSeconds(3600) : Value::kMaxTtl;
+      const auto value = RandomHumanReadableString(FLAGS_docdb_bench_value_size, &random_);
+      ASSERT_OK(write_batch.SetPrimitive(
+          DocPath(encoded_key, PrimitiveValue(ColumnId(kFirstColumnId + 2 + column))),
+          Value(PrimitiveValue(value), ttl)));
+    }
+    const auto hybrid_time = NextHybridTime();
+    if (txn_id) {
+      SetCurrentTransactionId(*txn_id);
+    }
+    ASSERT_OK(WriteToRocksDBAndClear(&write_batch, hybrid_time));
+    if (txn_id) {
+      ResetCurrentTransactionId();
+      txn_status_manager_.Commit(*txn_id, hybrid_time);
+    }
+  }
+
+  // Inserts all rows and then overwrites them the configured number of times. When
+  // transactional_percent is not zero, that percent of the last overwrites are left as committed
+  // but not yet applied intents, so reads have to resolve them.
+  void WriteRows(int transactional_percent) {
+    const auto before = Tickers();
+    HdrHistogram latency(kHighestLatencyUs, 2);
+    const int num_versions = 1 + FLAGS_docdb_bench_num_overwrites;
+    const auto start = MonoTime::Now();
+    for (int version = 0; version != num_versions; ++version) {
+      for (int row = 0; row != FLAGS_docdb_bench_num_rows; ++row) {
+        boost::optional<TransactionId> txn_id;
+        if (version + 1 == num_versions && RandomUniformInt(0, 99) < transactional_percent) {
+          txn_id = GenerateTransactionId();
+        }
+        const auto op_start = MonoTime::Now();
+        ASSERT_NO_FATALS(WriteRow(row, version, txn_id));
+        latency.Increment((MonoTime::Now() - op_start).ToMicroseconds());
+      }
+    }
+    const auto elapsed = MonoTime::Now() - start;
+    ASSERT_OK(FlushAndWait(rocksdb()));
+    ASSERT_OK(FlushAndWait(intents_db()));
+
+    const auto after = Tickers();
+    const auto user_bytes = Delta(before, after, rocksdb::BYTES_WRITTEN);
+    const auto storage_bytes = Delta(before, after, rocksdb::FLUSH_WRITE_BYTES) +
+                               Delta(before, after, rocksdb::COMPACT_WRITE_BYTES);
+    LOG(INFO) << "Write: " << latency.TotalCount() << " ops, "
+              << OpsPerSecond(latency.TotalCount(), elapsed) << " ops/sec, p99: "
+              << latency.ValueAtPercentile(99) << " us, write amplification: "
+              << Ratio(storage_bytes, user_bytes);
+  }
+
+  // Reads random rows by their primary key.
+  void PointReads(const TransactionOperationContextOpt& txn_op_context) {
+    const auto before = Tickers();
+    HdrHistogram latency(kHighestLatencyUs, 2);
+    QLTableRow row;
+    size_t found = 0;
+    const auto start = MonoTime::Now();
+    for (int i = 0; i != FLAGS_docdb_bench_num_reads; ++i) {
+      const auto op_start = MonoTime::Now();
+      DocQLScanSpec spec(
+          schema_, RowKey(RandomUniformInt(0, FLAGS_docdb_bench_num_rows - 1)),
+          rocksdb::kDefaultQueryId);
+      DocRowwiseIterator iter(
+          schema_, schema_, txn_op_context, doc_db(), MonoTime::Max(), ReadTime());
+      ASSERT_OK(iter.Init(spec));
+      while (iter.HasNext()) {
+        ASSERT_OK(iter.NextRow(&row));
+        ++found;
+      }
+      latency.Increment((MonoTime::Now() - op_start).ToMicroseconds());
+    }
+    const auto elapsed = MonoTime::Now() - start;
+    ASSERT_EQ(FLAGS_docdb_bench_num_reads, found);
+    LogReadStats("Point read", latency, elapsed, found, before);
+  }
+
+  // Scans the whole table.
+  void Scans(const TransactionOperationContextOpt& txn_op_context) {
+    const auto before = Tickers();
+    HdrHistogram latency(kHighestLatencyUs, 2);
+    QLTableRow row;
+    size_t found = 0;
+    const auto start = MonoTime::Now();
+    for (int i = 0; i != FLAGS_docdb_bench_num_scans; ++i) {
+      DocRowwiseIterator iter(
+          schema_, schema_, txn_op_context, doc_db(), MonoTime::Max(), ReadTime());
+      ASSERT_OK(iter.Init());
+      auto op_start = MonoTime::Now();
+      while (iter.HasNext()) {
+        ASSERT_OK(iter.NextRow(&row));
+        ++found;
+        const auto now = MonoTime::Now();
+        latency.Increment((now - op_start).ToMicroseconds());
+        op_start = now;
+      }
+    }
+    const auto elapsed = MonoTime::Now() - start;
+    ASSERT_EQ(static_cast<size_t>(FLAGS_docdb_bench_num_scans) * FLAGS_docdb_bench_num_rows, found);
+    LogReadStats("Scan", latency, elapsed, found, before);
+  }
+
+  void RunBenchmark(int transactional_percent) {
+    ASSERT_NO_FATALS(WriteRows(transactional_percent));
+    const TransactionOperationContext txn_op_context(
+        GenerateTransactionId(), &txn_status_manager_);
+    ASSERT_NO_FATALS(PointReads(txn_op_context));
+    ASSERT_NO_FATALS(Scans(txn_op_context));
+  }
+
+ private:
+  HybridTime NextHybridTime() {
+    return HybridTime::FromMicros(++last_write_micros_);
+  }
+
+  ReadHybridTime ReadTime() const {
+    return ReadHybridTime::FromMicros(last_write_micros_ + 1);
+  }
+
+  TickerSnapshot Tickers() const {
+    return TickerSnapshot(*options().statistics);
+  }
+
+  static uint64_t Delta(
+      const TickerSnapshot& before, const TickerSnapshot& after, rocksdb::Tickers ticker) {
+    return after.Get(ticker) - before.Get(ticker);
+  }
+
+  static double Ratio(uint64_t numerator, uint64_t denominator) {
+    return denominator ? static_cast<double>(numerator) / denominator : 0;
+  }
+
+  static double OpsPerSecond(uint64_t ops, MonoDelta elapsed) {
+    return ops / std::max(elapsed.ToSeconds(), 1e-6);
+  }
+
+  static CHECKED_STATUS FlushAndWait(rocksdb::DB* db) {
+    rocksdb::FlushOptions flush_options;
+    flush_options.wait = true;
+    return db->Flush(flush_options);
+  }
+
+  // Read amplification is reported as the number of RocksDB iterator seeks and nexts per returned
+  // row, i.e. how many SubDocKey entries, including old versions and intents, each row costs.
+  void LogReadStats(const char* name, const HdrHistogram& latency, MonoDelta elapsed,
+                    size_t rows, const TickerSnapshot& before) {
+    const auto after = Tickers();
+    const auto hits = Delta(before, after, rocksdb::BLOCK_CACHE_HIT);
+    const auto misses = Delta(before, after, rocksdb::BLOCK_CACHE_MISS);
+    const auto iterator_ops = Delta(before, after, rocksdb::NUMBER_DB_SEEK) +
+                              Delta(before, after, rocksdb::NUMBER_DB_NEXT);
+    LOG(INFO) << name << ": " << latency.TotalCount() << " ops, "
+              << OpsPerSecond(latency.TotalCount(), elapsed) << " ops/sec, p99: "
+              << latency.ValueAtPercentile(99) << " us, read amplification: "
+              << Ratio(iterator_ops, rows) << ", block cache hit rate: "
+              << Ratio(hits, hits + misses) << ", block cache bytes read: "
+              << Delta(before, after, rocksdb::BLOCK_CACHE_BYTES_READ);
+  }
+
+  Schema schema_;
+  TransactionStatusManagerMock txn_status_manager_;
+  Random random_{static_cast<uint32_t>(SeedRandom())};
+  uint64_t last_write_micros_ = 1000;
+};
+
+TEST_F(DocDBBench, WithoutIntents) {
+  RunBenchmark(0 /* transactional_percent */);
+}
+
+TEST_F(DocDBBench, WithIntents) {
+  RunBenchmark(50 /* transactional_percent */);
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -21,8 +21,10 @@
 #include "yb/rocksdb/util/statistics.h"
 
 #include "yb/common/hybrid_time.h"
+#include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_sst_file_writer.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
@@ -56,6 +58,7 @@ using rocksdb::WriteOptions;
 using namespace std::chrono_literals;
 
 DECLARE_bool(use_docdb_aware_bloom_filter);
+DECLARE_bool(docdb_intents_use_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
 
 namespace yb {
@@ -482,6 +485,10 @@ SubDocKey(DocKey([], ["mydockey", 123456]), [HT{ physical: 4000 }]) -> {}
 SubDocKey(DocKey([], ["mydockey", 123456]), [HT{ physical: 1000 }]) -> {}
 SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey1"; HT{ physical: 3000 }]) -> "value3"
       )#");
+  auto stats = TakeCompactionFilterStats();
+  ASSERT_EQ(2, stats.num_overwritten) << stats.ToString();
+  ASSERT_EQ(0, stats.num_expired) << stats.ToString();
+  ASSERT_EQ(0, stats.num_deleted) << stats.ToString();
 }
 
 TEST_F(DocDBTest, SetPrimitiveQL) {
@@ -946,6 +953,9 @@ SubDocKey(DocKey([], ["k1"]), ["s1"; HT{ physical: 5000 }]) -> "v14"
 SubDocKey(DocKey([], ["k1"]), ["s2"; HT{ physical: 5000 }]) -> "v24"
 SubDocKey(DocKey([], ["k1"]), ["s2"; HT{ physical: 1000 }]) -> "v21"; ttl: 0.003s
       )#");
+  auto stats = TakeCompactionFilterStats();
+  ASSERT_EQ(1, stats.num_expired) << stats.ToString();
+  ASSERT_EQ(0, stats.num_overwritten) << stats.ToString();
 }
 
 TEST_F(DocDBTest, TTLCompactionTest) {
@@ -1531,6 +1541,42 @@ TEST_F(DocDBTest, MultiOperationDocWriteBatch) {
       )#", dwb_str);
 }
 
+TEST_F(DocDBTest, IngestSstFile) {
+  const auto encoded_doc_key_a = DocKey(PrimitiveValues("a")).Encode();
+  const auto encoded_doc_key_b = DocKey(PrimitiveValues("b")).Encode();
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key_a, "x"), PrimitiveValue("v0"), 1000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  const std::string file_path = GetTestPath("ingested.sst");
+  DocDBSstFileWriter writer(rocksdb()->GetOptions(), 2000_usec_ht);
+  ASSERT_OK(writer.Open(file_path));
+  // Records of a batch could be added in any order.
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key_b, "d"), PrimitiveValue("v2")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key_b, "c"), PrimitiveValue("v1")));
+  KeyValueWriteBatchPB write_batch;
+  dwb.MoveToWriteBatchPB(&write_batch);
+  ASSERT_OK(writer.Add(write_batch));
+
+  // Keys of a batch should be greater than keys of previous batches.
+  auto smaller_dwb = MakeDocWriteBatch();
+  ASSERT_OK(smaller_dwb.SetPrimitive(DocPath(encoded_doc_key_b, "a"), PrimitiveValue("v3")));
+  write_batch.Clear();
+  smaller_dwb.MoveToWriteBatchPB(&write_batch);
+  ASSERT_NOK(writer.Add(write_batch));
+
+  rocksdb::ExternalSstFileInfo file_info;
+  ASSERT_OK(writer.Finish(&file_info));
+  ASSERT_EQ(2, file_info.num_entries);
+  ASSERT_OK(rocksdb()->AddFile(file_path, true /* move_file */));
+
+  AssertDocDbDebugDumpStrEq(R"#(
+      SubDocKey(DocKey([], ["a"]), ["x"; HT{ physical: 1000 }]) -> "v0"
+      SubDocKey(DocKey([], ["b"]), ["c"; HT{ physical: 2000 w: 1 }]) -> "v1"
+      SubDocKey(DocKey([], ["b"]), ["d"; HT{ physical: 2000 }]) -> "v2"
+      )#");
+}
+
 class DocDBTestBoundaryValues: public DocDBTest {
  protected:
   void TestBoundaryValues(size_t flush_rate) {
@@ -2009,6 +2055,152 @@ SubDocKey(DocKey([], ["k1"]), ["s3", "s5"; HT{ physical: 10000 w: 1 }]) -> "v1";
       )#");
 }
 
+TEST_F(DocDBTest, SetRow) {
+  SetInitMarkerBehavior(InitMarkerBehavior::kOptional);
+  const DocKey doc_key(PrimitiveValues("k1"));
+  const KeyBytes encoded_doc_key(doc_key.Encode());
+
+  auto doc_write_batch = MakeDocWriteBatch();
+  ASSERT_OK(doc_write_batch.SetRow(encoded_doc_key, {
+      {PrimitiveValue("c"), Value(PrimitiveValue("v3"), Value::kMaxTtl, 1000)},
+      {PrimitiveValue("a"), Value(PrimitiveValue("v1"), Value::kMaxTtl, 1000)},
+      {PrimitiveValue("b"), Value(PrimitiveValue("v2"), Value::kMaxTtl, 1000)}}));
+  // The document does not exist, so it is looked up only once and its columns are not looked up.
+  ASSERT_EQ(1, doc_write_batch.GetAndResetNumRocksDBSeeks());
+  ASSERT_OK(WriteToRocksDB(doc_write_batch, 10000_usec_ht));
+
+  AssertDocDbDebugDumpStrEq(R"#(
+SubDocKey(DocKey([], ["k1"]), ["a"; HT{ physical: 10000 }]) -> "v1"; user_timestamp: 1000
+SubDocKey(DocKey([], ["k1"]), ["b"; HT{ physical: 10000 w: 1 }]) -> "v2"; user_timestamp: 1000
+SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 10000 w: 2 }]) -> "v3"; user_timestamp: 1000
+      )#");
+
+  doc_write_batch.Clear();
+  // Only columns written with newer user timestamps are overwritten.
+  ASSERT_OK(doc_write_batch.SetRow(encoded_doc_key, {
+      {PrimitiveValue("b"), Value(PrimitiveValue("v5"), Value::kMaxTtl, 2000)},
+      {PrimitiveValue("a"), Value(PrimitiveValue("v4"), Value::kMaxTtl, 500)}}));
+  ASSERT_OK(WriteToRocksDB(doc_write_batch, 20000_usec_ht));
+
+  AssertDocDbDebugDumpStrEq(R"#(
+SubDocKey(DocKey([], ["k1"]), ["a"; HT{ physical: 10000 }]) -> "v1"; user_timestamp: 1000
+SubDocKey(DocKey([], ["k1"]), ["b"; HT{ physical: 20000 }]) -> "v5"; user_timestamp: 2000
+SubDocKey(DocKey([], ["k1"]), ["b"; HT{ physical: 10000 w: 1 }]) -> "v2"; user_timestamp: 1000
+SubDocKey(DocKey([], ["k1"]), ["c"; HT{ physical: 10000 w: 2 }]) -> "v3"; user_timestamp: 1000
+      )#");
+}
+
+TEST_F(DocDBTest, SkipFutureVersions) {
+  constexpr int kNumVersions = 100;
+  const DocKey doc_key(PrimitiveValues("k1"));
+  const KeyBytes encoded_doc_key(doc_key.Encode());
+  for (int i = 0; i != kNumVersions; ++i) {
+    ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue("c")),
+                           PrimitiveValue(Format("v$0", i)), HybridTime::FromMicros(1000 + i)));
+  }
+
+  auto encoded_subdoc_key = SubDocKey(doc_key).EncodeWithoutHt();
+  SubDocument subdoc;
+  bool doc_found = false;
+  GetSubDocumentData data = { encoded_subdoc_key, &subdoc, &doc_found };
+  const auto nexts_before = options().statistics->getTickerCount(rocksdb::NUMBER_DB_NEXT);
+  ASSERT_OK(GetSubDocument(
+      doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+      MonoTime::Max() /* deadline */, ReadHybridTime::FromMicros(1000)));
+  ASSERT_TRUE(doc_found);
+  EXPECT_STR_EQ_VERBOSE_TRIMMED(R"#(
+{
+  "c": "v0"
+}
+      )#", subdoc.ToString());
+  // Versions written after the read time are skipped with a seek, not one by one.
+  ASSERT_LT(options().statistics->getTickerCount(rocksdb::NUMBER_DB_NEXT) - nexts_before,
+            kNumVersions / 2);
+}
+
+TEST_F(DocDBTest, SkipFilesWrittenAfterReadTime) {
+  const DocKey doc_key(PrimitiveValues("k1"));
+  const KeyBytes encoded_doc_key(doc_key.Encode());
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue("c")), PrimitiveValue("v1"),
+                         1000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue("c")), PrimitiveValue("v2"),
+                         2000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  auto encoded_subdoc_key = SubDocKey(doc_key).EncodeWithoutHt();
+  auto get_doc = [this, &encoded_subdoc_key](const ReadHybridTime& read_time) {
+    SubDocument subdoc;
+    bool doc_found = false;
+    GetSubDocumentData data = { encoded_subdoc_key, &subdoc, &doc_found };
+    const auto iterators_before =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+    EXPECT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+        MonoTime::Max() /* deadline */, read_time));
+    EXPECT_TRUE(doc_found);
+    const auto num_iterators =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS) - iterators_before;
+    return std::make_pair(subdoc.ToString(), num_iterators);
+  };
+
+  // The second file contains only records written after the read time, so it is not opened.
+  auto result = get_doc(ReadHybridTime::FromMicros(1500));
+  ASSERT_STR_CONTAINS(result.first, "v1");
+  ASSERT_EQ(1, result.second);
+
+  result = get_doc(ReadHybridTime::FromMicros(2000));
+  ASSERT_STR_CONTAINS(result.first, "v2");
+  ASSERT_EQ(2, result.second);
+}
+
+TEST_F(DocDBTest, IntentsBloomFilter) {
+  if (!FLAGS_use_docdb_aware_bloom_filter) {
+    return;
+  }
+  const DocKey key1(0, PrimitiveValues("key1"), PrimitiveValues());
+  const DocKey key2(0, PrimitiveValues("key2"), PrimitiveValues());
+  ASSERT_OK(SetPrimitive(DocPath(key1.Encode(), PrimitiveValue("c")), PrimitiveValue("v1"),
+                         1000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  // Intents db file that contains only intents for key2.
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  SetCurrentTransactionId(ASSERT_RESULT(FullyDecodeTransactionId("0000000000000001")));
+  ASSERT_OK(SetPrimitive(DocPath(key2.Encode(), PrimitiveValue("c")), PrimitiveValue("v2"),
+                         2000_usec_ht));
+  ResetCurrentTransactionId();
+  rocksdb::FlushOptions flush_options;
+  flush_options.wait = true;
+  ASSERT_OK(intents_db()->Flush(flush_options));
+
+  auto encoded_subdoc_key = SubDocKey(key1).EncodeWithoutHt();
+  auto get_doc = [this, &encoded_subdoc_key] {
+    SubDocument subdoc;
+    bool doc_found = false;
+    GetSubDocumentData data = { encoded_subdoc_key, &subdoc, &doc_found };
+    const auto iterators_before =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+    EXPECT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+        MonoTime::Max() /* deadline */, ReadHybridTime::FromMicros(3000)));
+    EXPECT_TRUE(doc_found);
+    const auto num_iterators =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS) - iterators_before;
+    return std::make_pair(subdoc.ToString(), num_iterators);
+  };
+
+  // The intents db file does not match the bloom filter of key1, so it is not opened.
+  auto result = get_doc();
+  ASSERT_STR_CONTAINS(result.first, "v1");
+  ASSERT_EQ(1, result.second);
+
+  FLAGS_docdb_intents_use_bloom_filter = false;
+  result = get_doc();
+  ASSERT_STR_CONTAINS(result.first, "v1");
+  ASSERT_EQ(2, result.second);
+}
+
 TEST_F(DocDBTest, TestCompactionWithUserTimestamp) {
   const DocKey doc_key(PrimitiveValues("k1"));
   HybridTime t3000 = 3000_usec_ht;
@@ -2342,6 +2534,76 @@ TXN REV 30303030-3030-3030-3030-303030303032 HT{ physical: 5000 w: 1 } -> \
       )#");
 }
 
+// Checks that every reverse index record written for transactional writes points to its intent
+// record, and that strong intents also carry the same write id and value as that record.
+TEST_F(DocDBTest, ReverseIndexValueRoundTrip) {
+  const DocKey doc_key(PrimitiveValues("mydockey", 123456));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  const auto txn = ASSERT_RESULT(FullyDecodeTransactionId("0000000000000001"));
+  SetCurrentTransactionId(txn);
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key), PrimitiveValue::kObject, 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, "subkey1"), PrimitiveValue("value1"), 2000_usec_ht));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, "subkey2"), PrimitiveValue("value2"), 3000_usec_ht));
+  ResetCurrentTransactionId();
+
+  const Slice txn_id_slice(txn.data, txn.size());
+  const size_t reverse_index_prefix_size = 1 + txn.size();
+  const rocksdb::ReadOptions read_options;
+  std::unique_ptr<rocksdb::Iterator> reverse_iter(intents_db()->NewIterator(read_options));
+  std::unique_ptr<rocksdb::Iterator> intent_iter(intents_db()->NewIterator(read_options));
+  int num_strong = 0;
+  int num_weak = 0;
+  for (reverse_iter->SeekToFirst(); reverse_iter->Valid(); reverse_iter->Next()) {
+    const auto key = reverse_iter->key();
+    if (key[0] != ValueTypeAsChar::kTransactionId || key.size() <= reverse_index_prefix_size) {
+      continue;
+    }
+    auto reverse_value = ASSERT_RESULT(DecodeReverseIndexValue(reverse_iter->value()));
+    intent_iter->Seek(reverse_value.intent_key);
+    ASSERT_TRUE(intent_iter->Valid());
+    ASSERT_EQ(reverse_value.intent_key, intent_iter->key());
+
+    auto intent = ASSERT_RESULT(ParseIntentKey(intent_iter->key(), txn_id_slice));
+    if (!IsStrongIntent(intent.type)) {
+      ASSERT_FALSE(reverse_value.has_body);
+      ++num_weak;
+      continue;
+    }
+    ASSERT_TRUE(reverse_value.has_body);
+    IntraTxnWriteId write_id;
+    Slice body;
+    ASSERT_OK(DecodeIntentValue(intent_iter->value(), txn_id_slice, &write_id, &body));
+    ASSERT_EQ(write_id, reverse_value.write_id);
+    ASSERT_EQ(body, reverse_value.body);
+    ++num_strong;
+  }
+  // Strong intents for each write, and weak intents on the DocKey for writes of subkeys.
+  ASSERT_EQ(3, num_strong);
+  ASSERT_EQ(2, num_weak);
+}
+
+// Reverse index records written before write ids and values were stored in them contain just the
+// intent key.
+TEST_F(DocDBTest, ReverseIndexValueLegacyFormat) {
+  const DocKey doc_key(PrimitiveValues("mydockey", 123456));
+  const KeyBytes intent_key = doc_key.Encode();
+  auto reverse_value = ASSERT_RESULT(DecodeReverseIndexValue(intent_key.AsSlice()));
+  ASSERT_FALSE(reverse_value.has_body);
+  ASSERT_EQ(intent_key.AsSlice(), reverse_value.intent_key);
+
+  // Truncated values in the new format are reported as corruption.
+  std::string corrupted(1, ValueTypeAsChar::kWriteId);
+  corrupted.append(sizeof(IntraTxnWriteId), '\0');
+  ASSERT_NOK(DecodeReverseIndexValue(corrupted));
+  corrupted.append(1, '\x7f');
+  corrupted.append(sizeof(uint32_t) - 1, '\0');
+  ASSERT_NOK(DecodeReverseIndexValue(corrupted));
+}
 
 }  // namespace docdb
 }  // namespace yb
@@ -18,6 +18,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "yb/common/hybrid_time.h"
 #include "yb/common/redis_protocol.pb.h"
 #include "yb/common/transaction.h"
@@ -32,6 +34,7 @@
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/internal_doc_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -47,6 +50,7 @@
 #include "yb/util/logging.h"
 #include "yb/util/status.h"
 #include "yb/util/metrics.h"
+#include "yb/util/trace.h"
 
 using std::endl;
 using std::list;
@@ -76,13 +80,17 @@ constexpr size_t kMaxWordsPerEncodedHybridTimeWithValueType =
 // Prefix + DocPath + IntentType + DocHybridTime -> TxnId + value of the intent
 // Reverse index by txn id:
 // Prefix + TxnId + DocHybridTime -> Main intent data key
+// For strong intents, i.e. when write_id is specified, reverse index value also contains write id
+// and body of the intent value, see ReverseIndexValue.
 //
 // Expects that last entry of key is DocHybridTime.
 void AddIntent(
     const TransactionId& transaction_id,
     const SliceParts& key,
     const SliceParts& value,
-    rocksdb::WriteBatch* rocksdb_write_batch) {
+    rocksdb::WriteBatch* rocksdb_write_batch,
+    const IntraTxnWriteId* write_id = nullptr,
+    const Slice& body = Slice()) {
   char reverse_key_prefix[1] = { ValueTypeAsChar::kTransactionId };
   size_t doc_ht_buffer[kMaxWordsPerEncodedHybridTimeWithValueType];
   auto doc_ht_slice = key.parts[key.num_parts - 1];
@@ -98,7 +106,29 @@ void AddIntent(
       doc_ht_slice,
   }};
   rocksdb_write_batch->Put(key, value);
-  rocksdb_write_batch->Put(reverse_key, key);
+  if (!write_id) {
+    rocksdb_write_batch->Put(reverse_key, key);
+    return;
+  }
+
+  constexpr int kMaxKeyParts = 4;
+  CHECK_LE(key.num_parts, kMaxKeyParts);
+  uint32_t key_size = 0;
+  for (int i = 0; i != key.num_parts; ++i) {
+    key_size += key.parts[i].size();
+  }
+  char header[1 + sizeof(IntraTxnWriteId) + sizeof(uint32_t)];
+  header[0] = ValueTypeAsChar::kWriteId;
+  BigEndian::Store32(header + 1, *write_id);
+  BigEndian::Store32(header + 1 + sizeof(IntraTxnWriteId), key_size);
+  std::array<Slice, kMaxKeyParts + 2> reverse_value;
+  int num_parts = 0;
+  reverse_value[num_parts++] = Slice(header, sizeof(header));
+  for (int i = 0; i != key.num_parts; ++i) {
+    reverse_value[num_parts++] = key.parts[i];
+  }
+  reverse_value[num_parts++] = body;
+  rocksdb_write_batch->Put(reverse_key, SliceParts(reverse_value.data(), num_parts));
 }
 
 void ApplyIntent(const string& lock_string,
@@ -158,6 +188,7 @@ void PrepareDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_write_
   if (write_lock_latency != nullptr) {
     const MonoDelta elapsed_time = MonoTime::Now().GetDeltaSince(start_time);
     write_lock_latency->Increment(elapsed_time.ToMicroseconds());
+    TRACE("Locked keys in $0 us", elapsed_time.ToMicroseconds());
   }
 }
 
@@ -187,10 +218,12 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
   return Status::OK();
 }
 
-void PrepareNonTransactionWriteBatch(
-    const KeyValueWriteBatchPB& put_batch,
-    HybridTime hybrid_time,
-    rocksdb::WriteBatch* rocksdb_write_batch) {
+namespace {
+
+// Invokes handler with key and value parts of each entry of a non transactional write batch.
+template <class Handler>
+void EnumerateNonTransactionWriteBatch(
+    const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time, const Handler& handler) {
   DocHybridTimeBuffer doc_ht_buffer;
   for (int write_id = 0; write_id < put_batch.kv_pairs_size(); ++write_id) {
     const auto& kv_pair = put_batch.kv_pairs(write_id);
@@ -225,10 +258,32 @@ void PrepareNonTransactionWriteBatch(
         doc_ht_buffer.EncodeWithValueType(hybrid_time, write_id),
     }};
     Slice key_value = kv_pair.value();
-    rocksdb_write_batch->Put(key_parts, { &key_value, 1 });
+    handler(key_parts, { &key_value, 1 });
   }
 }
 
+} // namespace
+
+void PrepareNonTransactionWriteBatch(
+    const KeyValueWriteBatchPB& put_batch,
+    HybridTime hybrid_time,
+    rocksdb::WriteBatch* rocksdb_write_batch) {
+  EnumerateNonTransactionWriteBatch(
+      put_batch, hybrid_time,
+      [rocksdb_write_batch](const SliceParts& key, const SliceParts& value) {
+        rocksdb_write_batch->Put(key, value);
+      });
+}
+
+Status NonTransactionalWriter::Apply(rocksdb::DirectWriteHandler* handler) {
+  EnumerateNonTransactionWriteBatch(
+      put_batch_, hybrid_time_,
+      [handler](const SliceParts& key, const SliceParts& value) {
+        handler->Put(key, value);
+      });
+  return Status::OK();
+}
+
 CHECKED_STATUS EnumerateIntents(
     const google::protobuf::RepeatedPtrField<KeyValuePairPB> &kv_pairs,
     boost::function<Status(IntentKind, Slice, KeyBytes*)> functor) {
@@ -290,7 +345,8 @@ class PrepareTransactionWriteBatchHelper {
 
     const auto transaction_value_type = ValueTypeAsChar::kTransactionId;
     const auto write_id_value_type = ValueTypeAsChar::kWriteId;
-    IntraTxnWriteId big_endian_write_id = BigEndian::FromHost32(*intra_txn_write_id_);
+    const IntraTxnWriteId write_id = *intra_txn_write_id_;
+    IntraTxnWriteId big_endian_write_id = BigEndian::FromHost32(write_id);
     std::array<Slice, 5> value = {{
         Slice(&transaction_value_type, 1),
         Slice(transaction_id_.data, transaction_id_.size()),
@@ -310,7 +366,7 @@ class PrepareTransactionWriteBatchHelper {
         Slice(intent_type, 2),
         doc_ht_buffer.EncodeWithValueType(hybrid_time_, write_id_++),
     }};
-    AddIntent(transaction_id_, key_parts, value, rocksdb_write_batch_);
+    AddIntent(transaction_id_, key_parts, value, rocksdb_write_batch_, &write_id, value_slice);
 
     return Status::OK();
   }
@@ -521,7 +577,7 @@ CHECKED_STATUS BuildSubDocument(
           return Status::OK();
         }
         if (data.low_index->CanInclude(*num_values_observed)) {
-          *data.result = SubDocument(doc_value.primitive_value());
+          *data.result = SubDocument(std::move(*doc_value.mutable_primitive_value()));
         }
         (*num_values_observed)++;
         VLOG(3) << "SeekOutOfSubDoc: " << SubDocKey::DebugSliceToString(key);
@@ -720,6 +776,13 @@ yb::Status GetSubDocument(
   *data.result = SubDocument();
   KeyBytes key_bytes(data.subdocument_key);
   const size_t subdocument_key_size = key_bytes.size();
+  const PrimitiveValue packed_row_subkey =
+      PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow);
+  // Column values written before the packed row were overwritten by it, even if it has expired.
+  DocHybridTime packed_row_time = DocHybridTime::kMin;
+  boost::optional<PackedRow> packed_row;
+  // TTL and write time of the packed row, that are used for its columns.
+  SubDocument packed_row_value;
   for (const PrimitiveValue& subkey : *projection) {
     // Append subkey to subdocument key. Reserve extra kMaxBytesPerEncodedHybridTime + 1 bytes in
     // key_bytes to avoid the internal buffer from getting reallocated and moved by SeekForward()
@@ -733,8 +796,53 @@ yb::Status GetSubDocument(
 
     SubDocument descendant(ValueType::kInvalid);
     int64 num_values_observed = 0;
-    RETURN_NOT_OK(BuildSubDocument(
-        db_iter, data.Adjusted(key_bytes, &descendant), max_deleted_ts, &num_values_observed));
+    DocHybridTime low_ts = max_deleted_ts;
+    bool use_packed_value = false;
+    if (packed_row_time > max_deleted_ts && subkey.value_type() == ValueType::kColumnId) {
+      // Most often there are no column entries after the packed row, so the iterator is already
+      // out of the column.
+      if (!db_iter->valid()) {
+        use_packed_value = true;
+      } else {
+        DocHybridTime column_time = packed_row_time;
+        RETURN_NOT_OK(db_iter->FindLastWriteTime(key_bytes.AsSlice(), &column_time));
+        if (column_time == packed_row_time) {
+          use_packed_value = true;
+        } else {
+          low_ts = packed_row_time;
+          db_iter->SeekForward(&key_bytes);
+        }
+      }
+    } else if (subkey == packed_row_subkey && db_iter->valid()) {
+      packed_row_time = max_deleted_ts;
+      RETURN_NOT_OK(db_iter->FindLastWriteTime(key_bytes.AsSlice(), &packed_row_time));
+      db_iter->SeekForward(&key_bytes);
+    }
+
+    if (use_packed_value) {
+      const PrimitiveValue* value =
+          packed_row ? packed_row->GetColumn(subkey.GetColumnId()) : nullptr;
+      if (value) {
+        descendant = SubDocument(*value);
+        descendant.SetTtl(packed_row_value.GetTtl());
+        if (packed_row_value.IsWriteTimeSet()) {
+          descendant.SetWriteTime(packed_row_value.GetWriteTime());
+        }
+      }
+    } else {
+      RETURN_NOT_OK(BuildSubDocument(
+          db_iter, data.Adjusted(key_bytes, &descendant), low_ts, &num_values_observed));
+    }
+    if (subkey == packed_row_subkey && descendant.value_type() == ValueType::kString) {
+      packed_row = VERIFY_RESULT(PackedRow::Decode(descendant.GetStringAsSlice()));
+      // Keep only TTL and write time of the packed row, to be used for its columns.
+      packed_row_value = SubDocument(PrimitiveValue());
+      packed_row_value.SetTtl(descendant.GetTtl());
+      if (descendant.IsWriteTimeSet()) {
+        packed_row_value.SetWriteTime(descendant.GetWriteTime());
+      }
+      descendant = packed_row_value;
+    }
     if (descendant.value_type() != ValueType::kInvalid) {
       *data.doc_found = true;
     }
@@ -858,8 +966,12 @@ Result<std::string> DocDBValueToDebugStr(
       return ToString(*metadata);
     }
     case KeyType::kReverseTxnKey: {
+      // Intent value stored in reverse index is the same as in the intent record, so we show only
+      // the intent key.
+      auto reverse_value = VERIFY_RESULT(DecodeReverseIndexValue(value));
       KeyType ignore_key_type;
-      return DocDBKeyToDebugStr(value, StorageDbType::kIntents, &ignore_key_type);
+      return DocDBKeyToDebugStr(
+          reverse_value.intent_key, StorageDbType::kIntents, &ignore_key_type);
     }
     case KeyType::kEmpty: FALLTHROUGH_INTENDED;
     case KeyType::kIntentKey: FALLTHROUGH_INTENDED;
@@ -931,8 +1043,9 @@ Slice DocHybridTimeBuffer::EncodeWithValueType(const DocHybridTime& doc_ht) {
   return Slice(buffer_.data(), end);
 }
 
-Status PrepareApplyIntentsBatch(
+Result<KeyBytes> PrepareApplyIntentsBatch(
     const TransactionId& transaction_id, HybridTime commit_ht,
+    const Slice& start_key, size_t max_records,
     rocksdb::WriteBatch* regular_batch,
     rocksdb::DB* intents_db, rocksdb::WriteBatch* intents_batch) {
   Slice reverse_index_upperbound;
@@ -951,11 +1064,13 @@ Status PrepareApplyIntentsBatch(
   txn_reverse_index_upperbound.AppendValueType(ValueType::kMaxByte);
   reverse_index_upperbound = txn_reverse_index_upperbound.AsSlice();
 
-  reverse_index_iter->Seek(txn_reverse_index_prefix.data());
+  reverse_index_iter->Seek(start_key.empty() ? txn_reverse_index_prefix.AsSlice() : start_key);
 
   DocHybridTimeBuffer doc_ht_buffer;
 
+  // Write ids are counted only for the sanity check, when we start from the first record.
   IntraTxnWriteId write_id = 0;
+  size_t num_records = 0;
   while (reverse_index_iter->Valid()) {
     rocksdb::Slice key_slice(reverse_index_iter->key());
 
@@ -963,37 +1078,51 @@ Status PrepareApplyIntentsBatch(
       break;
     }
 
+    if (num_records >= max_records) {
+      return KeyBytes(key_slice);
+    }
+    ++num_records;
+
     VLOG(4) << "Apply reverse index record: "
             << EntryToString(*reverse_index_iter, StorageDbType::kIntents);
 
     // If the key ends at the transaction id then it is transaction metadata (status tablet,
     // isolation level etc.).
     if (key_slice.size() > txn_reverse_index_prefix.size()) {
-      // Value of reverse index is a key of original intent record, so seek it and check match.
-      intent_iter->Seek(reverse_index_iter->value());
-      if (!intent_iter->Valid() || intent_iter->key() != reverse_index_iter->value()) {
-        LOG(DFATAL) << "Unable to find intent: " << reverse_index_iter->value().ToDebugString()
-                    << " for " << reverse_index_iter->key().ToDebugString();
-        continue;
-      }
-      auto intent = VERIFY_RESULT(ParseIntentKey(intent_iter->key(), transaction_id_slice));
+      // Value of reverse index contains key of original intent record, and for strong intents
+      // also the intent value, so the intent record itself should not be read.
+      auto reverse_value = VERIFY_RESULT(DecodeReverseIndexValue(reverse_index_iter->value()));
+      auto intent = VERIFY_RESULT(ParseIntentKey(reverse_value.intent_key, transaction_id_slice));
 
       if (IsStrongIntent(intent.type)) {
-        IntraTxnWriteId stored_write_id;
-        Slice intent_value;
-        RETURN_NOT_OK(DecodeIntentValue(
-            intent_iter->value(), transaction_id_slice, &stored_write_id, &intent_value));
+        IntraTxnWriteId stored_write_id = reverse_value.write_id;
+        Slice intent_value = reverse_value.body;
+        if (!reverse_value.has_body) {
+          // Reverse index record in old format, so seek intent record and check match.
+          intent_iter->Seek(reverse_value.intent_key);
+          if (!intent_iter->Valid() || intent_iter->key() != reverse_value.intent_key) {
+            LOG(DFATAL) << "Unable to find intent: " << reverse_value.intent_key.ToDebugString()
+                        << " for " << reverse_index_iter->key().ToDebugString();
+            reverse_index_iter->Next();
+            continue;
+          }
+          RETURN_NOT_OK(DecodeIntentValue(
+              intent_iter->value(), transaction_id_slice, &stored_write_id, &intent_value));
+        }
 
         // Write id should match to one that were calculated during append of intents.
         // Doing it just for sanity check.
-        DCHECK_EQ(stored_write_id, write_id)
-            << "Value: " << intent_iter->value().ToDebugHexString();
+        DCHECK(!start_key.empty() || stored_write_id == write_id)
+            << "Reverse index value: " << reverse_index_iter->value().ToDebugHexString()
+            << ", expected write id: " << write_id;
 
+        // Stored write id is used, so applying already applied intents again, for instance after
+        // a restart in the middle of a big transaction, produces the same records.
         // After strip of prefix and suffix intent_key contains just SubDocKey w/o a hybrid time.
         // Time will be added when writing batch to rocks db.
         std::array<Slice, 2> key_parts = {{
             intent.doc_path,
-            doc_ht_buffer.EncodeWithValueType(commit_ht, write_id),
+            doc_ht_buffer.EncodeWithValueType(commit_ht, stored_write_id),
         }};
         std::array<Slice, 2> value_parts = {{
             intent.doc_ht,
@@ -1003,15 +1132,18 @@ Status PrepareApplyIntentsBatch(
         ++write_id;
       }
 
-      intents_batch->Delete(intent_iter->key());
+      // Every intent key is written exactly once, so single delete could be used. Unlike a
+      // regular tombstone, it is dropped together with the value by the first compaction that
+      // sees both, instead of being carried to the bottommost level.
+      intents_batch->SingleDelete(reverse_value.intent_key);
     }
 
-    intents_batch->Delete(reverse_index_iter->key());
+    intents_batch->SingleDelete(reverse_index_iter->key());
 
     reverse_index_iter->Next();
   }
 
-  return Status::OK();
+  return KeyBytes();
 }
 
 }  // namespace docdb
@@ -132,6 +132,25 @@ void PrepareNonTransactionWriteBatch(
     HybridTime hybrid_time,
     rocksdb::WriteBatch* rocksdb_write_batch);
 
+// Puts key value pairs of a non transactional batch directly to the memtable insert path, instead
+// of copying them to rocksdb::WriteBatch first. Produces the same entries as
+// PrepareNonTransactionWriteBatch.
+class NonTransactionalWriter : public rocksdb::DirectWriter {
+ public:
+  NonTransactionalWriter(const docdb::KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time)
+      : put_batch_(put_batch), hybrid_time_(hybrid_time) {}
+
+  size_t NumEntries() const override {
+    return put_batch_.kv_pairs_size();
+  }
+
+  CHECKED_STATUS Apply(rocksdb::DirectWriteHandler* handler) override;
+
+ private:
+  const docdb::KeyValueWriteBatchPB& put_batch_;
+  HybridTime hybrid_time_;
+};
+
 // Enumerates intents corresponding to provided key value pairs.
 // For each key in generates a strong intent and for each parent of each it generates a weak one.
 // functor should accept 3 arguments:
@@ -158,8 +177,13 @@ void PrepareTransactionWriteBatch(
     IsolationLevel isolation_level,
     IntraTxnWriteId* write_id);
 
-CHECKED_STATUS PrepareApplyIntentsBatch(
+// Prepares batches that apply at most max_records reverse index records of the transaction,
+// starting from reverse index key start_key, or from the first record when start_key is empty.
+// The regular batch receives the committed values, and the intents batch deletes applied intents.
+// Returns reverse index key to continue from, or an empty key when all intents were processed.
+Result<KeyBytes> PrepareApplyIntentsBatch(
     const TransactionId& transaction_id, HybridTime commit_ht,
+    const Slice& start_key, size_t max_records,
     rocksdb::WriteBatch* regular_batch,
     rocksdb::DB* intents_db, rocksdb::WriteBatch* intents_batch);
 
@@ -18,6 +18,7 @@
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/util/format.h"
 #include "yb/util/string_util.h"
 
 #include "yb/docdb/doc_key.h"
@@ -36,19 +37,43 @@ namespace docdb {
 
 // ------------------------------------------------------------------------------------------------
 
+std::string DocDBCompactionFilterStats::ToString() const {
+  return Format("{ num_expired: $0 num_overwritten: $1 num_deleted: $2 }",
+                num_expired, num_overwritten, num_deleted);
+}
+
+void DocDBCompactionFilterStatsCollector::Add(const DocDBCompactionFilterStats& stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_ += stats;
+}
+
+DocDBCompactionFilterStats DocDBCompactionFilterStatsCollector::Take() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DocDBCompactionFilterStats result = stats_;
+  stats_ = DocDBCompactionFilterStats();
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+
 DocDBCompactionFilter::DocDBCompactionFilter(HybridTime history_cutoff,
                                              ColumnIdsPtr deleted_cols,
                                              bool is_major_compaction,
-                                             MonoDelta table_ttl)
+                                             MonoDelta table_ttl,
+                                             DocDBCompactionFilterStatsCollectorPtr stats_collector)
     : history_cutoff_(history_cutoff),
       is_major_compaction_(is_major_compaction),
       is_first_key_value_(true),
       filter_usage_logged_(false),
       table_ttl_(table_ttl),
-      deleted_cols_(deleted_cols) {
+      deleted_cols_(deleted_cols),
+      stats_collector_(std::move(stats_collector)) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
+  if (stats_collector_) {
+    stats_collector_->Add(stats_);
+  }
 }
 
 bool DocDBCompactionFilter::Filter(int level,
@@ -66,6 +91,7 @@ bool DocDBCompactionFilter::Filter(int level,
   // Just remove intent records from regular DB, because it was beta feature.
   // Currently intents are stored in separate DB.
   if (DecodeValueType(key) == ValueType::kObsoleteIntentPrefix) {
+    ++stats_.num_deleted;
     return true;
   }
 
@@ -129,6 +155,7 @@ bool DocDBCompactionFilter::Filter(int level,
   // hybrid_time stack, and we might as well do that while handling the next key/value pair that
   // does not get cleaned up the same way as this one.
   if (ht < prev_overwrite_ht) {
+    ++stats_.num_overwritten;
     return true;  // Remove this key/value pair.
   }
 
@@ -168,6 +195,7 @@ bool DocDBCompactionFilter::Filter(int level,
     // Column ID is the first subkey in every CQL row.
     if (first_subkey.value_type() == ValueType::kColumnId &&
         deleted_cols_->find(first_subkey.GetColumnId()) != deleted_cols_->end()) {
+      ++stats_.num_deleted;
       return true;
     }
   }
@@ -195,6 +223,7 @@ bool DocDBCompactionFilter::Filter(int level,
   // markers in Redis wouldn't be affected since they don't have any TTL associated with them and
   // the TTL would default to kMaxTtl which would make has_expired false.
   if (has_expired) {
+    ++stats_.num_expired;
     // This is consistent with the condition we're testing for deletes at the bottom of the function
     // because ht_at_or_below_cutoff is implied by has_expired.
     if (is_major_compaction_) {
@@ -211,7 +240,11 @@ bool DocDBCompactionFilter::Filter(int level,
   // compactions. However, we do need to update the overwrite hybrid time stack in this case (as we
   // just did), because this deletion (tombstone) entry might be the only reason for cleaning up
   // more entries appearing at earlier hybrid times.
-  return value_type == ValueType::kTombstone && ht_at_or_below_cutoff && is_major_compaction_;
+  if (value_type == ValueType::kTombstone && ht_at_or_below_cutoff && is_major_compaction_) {
+    ++stats_.num_deleted;
+    return true;
+  }
+  return false;
 }
 
 const char* DocDBCompactionFilter::Name() const {
@@ -221,9 +254,11 @@ const char* DocDBCompactionFilter::Name() const {
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
-    shared_ptr<HistoryRetentionPolicy> retention_policy)
+    shared_ptr<HistoryRetentionPolicy> retention_policy,
+    DocDBCompactionFilterStatsCollectorPtr stats_collector)
     :
-    retention_policy_(retention_policy) {
+    retention_policy_(retention_policy),
+    stats_collector_(std::move(stats_collector)) {
 }
 
 DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
@@ -234,7 +269,8 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
   return unique_ptr<DocDBCompactionFilter>(
       new DocDBCompactionFilter(retention_policy_->GetHistoryCutoff(),
                                 retention_policy_->GetDeletedColumns(),
-                                context.is_full_compaction, retention_policy_->GetTableTTL()));
+                                context.is_full_compaction, retention_policy_->GetTableTTL(),
+                                stats_collector_));
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
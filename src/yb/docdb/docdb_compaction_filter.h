@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "yb/rocksdb/compaction_filter.h"
@@ -27,12 +28,52 @@
 namespace yb {
 namespace docdb {
 
+// Numbers of key/value pairs dropped by DocDBCompactionFilter, by reason.
+struct DocDBCompactionFilterStats {
+  // Values with TTL expired by the history cutoff. They are removed by major compactions and
+  // replaced with tombstones by minor ones.
+  uint64_t num_expired = 0;
+  // Values overwritten or deleted at or before the history cutoff.
+  uint64_t num_overwritten = 0;
+  // Tombstones, values of deleted columns and obsolete intents.
+  uint64_t num_deleted = 0;
+
+  uint64_t total() const { return num_expired + num_overwritten + num_deleted; }
+
+  DocDBCompactionFilterStats& operator+=(const DocDBCompactionFilterStats& rhs) {
+    num_expired += rhs.num_expired;
+    num_overwritten += rhs.num_overwritten;
+    num_deleted += rhs.num_deleted;
+    return *this;
+  }
+
+  std::string ToString() const;
+};
+
+// Accumulates stats of compaction filters when they are destroyed, i.e. when their part of a
+// compaction is done, so they could be picked up by a listener of completed compactions. This
+// class is thread-safe.
+class DocDBCompactionFilterStatsCollector {
+ public:
+  void Add(const DocDBCompactionFilterStats& stats);
+
+  // Returns stats accumulated since the previous call.
+  DocDBCompactionFilterStats Take();
+
+ private:
+  std::mutex mutex_;
+  DocDBCompactionFilterStats stats_;
+};
+
+typedef std::shared_ptr<DocDBCompactionFilterStatsCollector> DocDBCompactionFilterStatsCollectorPtr;
+
 class DocDBCompactionFilter : public rocksdb::CompactionFilter {
  public:
   DocDBCompactionFilter(HybridTime history_cutoff,
                         ColumnIdsPtr deleted_cols,
                         bool is_major_compaction,
-                        MonoDelta table_ttl);
+                        MonoDelta table_ttl,
+                        DocDBCompactionFilterStatsCollectorPtr stats_collector = nullptr);
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -100,6 +141,10 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   MonoDelta table_ttl_;
 
   ColumnIdsPtr deleted_cols_;
+
+  // Stats of this filter are added to the collector on destruction, could be null.
+  DocDBCompactionFilterStatsCollectorPtr stats_collector_;
+  mutable DocDBCompactionFilterStats stats_;
 };
 
 // A strategy for deciding the history cutoff. We may implement this differently in production and
@@ -139,7 +184,9 @@ class FixedHybridTimeRetentionPolicy : public HistoryRetentionPolicy {
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  explicit DocDBCompactionFilterFactory(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy,
+      DocDBCompactionFilterStatsCollectorPtr stats_collector = nullptr);
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
@@ -147,6 +194,7 @@ class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
 
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  DocDBCompactionFilterStatsCollectorPtr stats_collector_;
 };
 
 }  // namespace docdb
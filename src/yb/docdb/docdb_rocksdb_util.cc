@@ -13,18 +13,26 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <algorithm>
+#include <limits>
 #include <thread>
 #include <memory>
 
 #include "yb/common/transaction.h"
 
+#include "yb/rocksdb/db/compaction.h"
+#include "yb/rocksdb/memtablerep.h"
 #include "yb/rocksdb/rate_limiter.h"
 #include "yb/rocksdb/table.h"
+#include "yb/rocksdb/util/compression.h"
 
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/value_type.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/path_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 
@@ -51,10 +59,23 @@ DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 100 * 1024 * 1024,
              "Use to control write rate of flush and compaction.");
+DEFINE_bool(rocksdb_compact_flush_rate_limit_auto_tune, false,
+            "Automatically adjust the write rate of flush and compaction between 1/20 of "
+            "rocksdb_compact_flush_rate_limit_bytes_per_sec and this limit, depending on how often "
+            "the current rate is insufficient. Flushes get strict priority over compactions.");
+TAG_FLAG(rocksdb_compact_flush_rate_limit_auto_tune, advanced);
+DEFINE_bool(rocksdb_compact_flush_rate_limit_per_tserver, false,
+            "Apply rocksdb_compact_flush_rate_limit_bytes_per_sec to flushes and compactions of "
+            "all tablets of the tablet server together, instead of to each tablet separately.");
+TAG_FLAG(rocksdb_compact_flush_rate_limit_per_tserver, advanced);
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_uint64(rocksdb_compaction_readahead_size_bytes, 2_MB,
+              "Size of reads of compaction input files. Compaction inputs are read sequentially, "
+              "so large reads speed up compactions that are limited by disk. 0 - disabled.");
+TAG_FLAG(rocksdb_compaction_readahead_size_bytes, advanced);
 
 DEFINE_int64(db_block_size_bytes, 32_KB,
              "Size of RocksDB data block (in bytes).");
@@ -68,11 +89,31 @@ DEFINE_int64(db_index_block_size_bytes, 32_KB,
 DEFINE_int64(db_min_keys_per_index_block, 100,
              "Minimum number of keys per index block.");
 
+DEFINE_int64(db_max_auto_readahead_size_bytes, 256_KB,
+             "Max size of the range prefetched ahead of iterators that read adjacent data blocks "
+             "of an SST file, e.g. during range scans. 0 disables prefetching.");
+TAG_FLAG(db_max_auto_readahead_size_bytes, advanced);
+
 DEFINE_int64(db_write_buffer_size, -1,
              "Size of RocksDB write buffer (in bytes). -1 to use default.");
 
+DEFINE_bool(db_pin_top_level_index_and_filter, true,
+            "Keep top level data index and bloom filter index blocks of SST files in memory "
+            "outside of block cache, so that they are not evicted by data blocks read by scans.");
+TAG_FLAG(db_pin_top_level_index_and_filter, advanced);
+
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_bool(docdb_bloom_filter_with_first_range_component, false,
+            "Whether DocDB aware bloom filter should also take into account the first range "
+            "component of keys. Allows range bounded scans that fix the first range component to "
+            "skip SST files, but scans that only fix hashed components could not use it.");
+TAG_FLAG(docdb_bloom_filter_with_first_range_component, advanced);
+DEFINE_bool(docdb_filter_files_by_read_time, true,
+            "Whether reads should skip SST files that contain only records written after the "
+            "read time.");
+TAG_FLAG(docdb_filter_files_by_read_time, advanced);
+TAG_FLAG(docdb_filter_files_by_read_time, runtime);
 DEFINE_int32(max_nexts_to_avoid_seek, 1,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
@@ -80,6 +121,58 @@ DEFINE_bool(use_multi_level_index, true, "Whether to use multi-level data index.
 
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, true,
+            "Let writers that are grouped together by the RocksDB write thread insert into the "
+            "memtable concurrently, instead of the group leader inserting all of their batches.");
+TAG_FLAG(rocksdb_allow_concurrent_memtable_write, advanced);
+
+DEFINE_int32(docdb_hash_memtable_bucket_bits, 0,
+             "When positive, memtables are partitioned into 2^docdb_hash_memtable_bucket_bits "
+             "skip lists by the 16 bit hash that starts DocDB keys of hash partitioned tables, so "
+             "point reads and writes search a smaller skip list. At most 16.");
+TAG_FLAG(docdb_hash_memtable_bucket_bits, advanced);
+
+DEFINE_bool(docdb_use_three_shared_parts_key_encoding, false,
+            "Encode keys in data blocks of new SST files as a shared prefix, a shared middle part "
+            "(usually the hybrid time) and delta encoded sequence number, instead of only "
+            "stripping the prefix shared with the previous key. SST files written this way could "
+            "not be read by older versions.");
+TAG_FLAG(docdb_use_three_shared_parts_key_encoding, advanced);
+
+DEFINE_int32(rocksdb_compression_max_dict_bytes, 0,
+             "When positive, data blocks of SST files are compressed with ZSTD, or Zlib when ZSTD "
+             "is not available, using a per file dictionary of this size sampled from the first "
+             "data blocks of the file, instead of the default Snappy compression. Zlib only uses "
+             "the last 16 KB of the dictionary.");
+TAG_FLAG(rocksdb_compression_max_dict_bytes, advanced);
+
+DEFINE_bool(rocksdb_lazy_load_table_metadata, true,
+            "Do not read SST files when opening a DB: compaction planning uses file metadata "
+            "from the MANIFEST only, and filters are loaded on first access to an SST file "
+            "instead of when its table reader is opened.");
+TAG_FLAG(rocksdb_lazy_load_table_metadata, advanced);
+
+DEFINE_string(rocksdb_cold_data_dir, "",
+              "Directory on a cheaper and slower device for cold SST files. When set, the largest "
+              "sorted runs produced by compactions of the regular DB of a tablet are written to "
+              "a subdirectory of this directory, once SST files of the tablet exceed "
+              "rocksdb_hot_data_target_size_bytes in its data dir. Flushed files always stay in "
+              "the data dir. The directory should not be changed or cleared after SST files were "
+              "written to it. Empty value disables tiered storage.");
+TAG_FLAG(rocksdb_cold_data_dir, advanced);
+
+DEFINE_int64(rocksdb_hot_data_target_size_bytes, 10_GB,
+             "Target size of SST files of a tablet kept in its data dir when tiered storage is "
+             "enabled. See rocksdb_cold_data_dir.");
+TAG_FLAG(rocksdb_hot_data_target_size_bytes, advanced);
+
+DEFINE_int64(rocksdb_memtable_huge_page_size, 0,
+             "When positive, memtable arena blocks are allocated from huge pages of this size, "
+             "e.g. 2097152: reserved huge pages (vm.nr_hugepages) are used when available, "
+             "otherwise aligned blocks are advised to be backed by transparent huge pages. "
+             "Reduces TLB misses of memtable lookups. 0 allocates blocks with malloc.");
+TAG_FLAG(rocksdb_memtable_huge_page_size, advanced);
+
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
@@ -313,17 +406,46 @@ void PerformRocksDBReverseSeek(
   }
 }
 
+rocksdb::UserBoundaryTag TagForDocHybridTime();
+
 namespace {
 
+// Skips files whose oldest record was written after the global limit of the read time, because
+// none of their records could be visible to the read. Other files are passed to the base filter.
+class ReadTimeFileFilter : public rocksdb::ReadFileFilter {
+ public:
+  ReadTimeFileFilter(const ReadHybridTime& read_time,
+                     std::shared_ptr<rocksdb::ReadFileFilter> base_filter)
+      : encoded_global_limit_(
+            DocHybridTime(read_time.global_limit, kMaxWriteId).EncodedInDocDbFormat()),
+        base_filter_(std::move(base_filter)) {
+  }
+
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    const Slice* smallest = file.smallest.user_value_with_tag(TagForDocHybridTime());
+    // Doc hybrid times are encoded in reverse order, so the oldest one has the greatest encoding.
+    if (smallest && smallest->compare(encoded_global_limit_) < 0) {
+      return false;
+    }
+    return !base_filter_ || base_filter_->Filter(file);
+  }
+
+ private:
+  const std::string encoded_global_limit_;
+  const std::shared_ptr<rocksdb::ReadFileFilter> base_filter_;
+};
+
 rocksdb::ReadOptions PrepareReadOptions(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    bool fill_block_cache = true) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = query_id;
+  read_opts.fill_cache = fill_block_cache;
   if (FLAGS_use_docdb_aware_bloom_filter &&
     bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER) {
     DCHECK(user_key_for_filter);
@@ -358,10 +480,15 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     MonoTime deadline,
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    bool fill_block_cache) {
+  if (FLAGS_docdb_filter_files_by_read_time && read_time.global_limit != HybridTime::kMax) {
+    file_filter = std::make_shared<ReadTimeFileFilter>(read_time, std::move(file_filter));
+  }
   // TODO(dtxn) do we need separate options for intents db?
   rocksdb::ReadOptions read_opts = PrepareReadOptions(doc_db.regular, bloom_filter_mode,
-      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
+      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound,
+      fill_block_cache);
   return std::make_unique<IntentAwareIterator>(
       doc_db, read_opts, deadline, read_time, txn_op_context);
 }
@@ -378,9 +505,29 @@ void InitRocksDBOptions(
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->memory_monitor = tablet_options.memory_monitor;
+  // Otherwise table properties of several SST files are read on open, to account deletions in
+  // compensated file sizes.
+  options->skip_stats_update_on_db_open = FLAGS_rocksdb_lazy_load_table_metadata;
+  // The default skip list memtable supports concurrent inserts, and DocDB does not use in-place
+  // updates, filter_deletes or merges, that are incompatible with them.
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write;
+  options->enable_write_thread_adaptive_yield = FLAGS_rocksdb_allow_concurrent_memtable_write;
+  if (FLAGS_rocksdb_memtable_huge_page_size > 0) {
+    options->memtable_huge_page_size = FLAGS_rocksdb_memtable_huge_page_size;
+  }
+  if (FLAGS_docdb_hash_memtable_bucket_bits > 0) {
+    options->memtable_factory = std::make_shared<rocksdb::UInt16HashSkipListRepFactory>(
+        static_cast<char>(ValueType::kUInt16Hash),
+        std::min(FLAGS_docdb_hash_memtable_bucket_bits, 16));
+  }
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   }
+  if (FLAGS_rocksdb_compression_max_dict_bytes > 0) {
+    options->compression = rocksdb::ZSTD_Supported() ? rocksdb::kZSTDNotFinalCompression
+                                                     : rocksdb::kZlibCompression;
+    options->compression_opts.max_dict_bytes = FLAGS_rocksdb_compression_max_dict_bytes;
+  }
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
       tablet_options.listeners.end()); // Append listeners
@@ -389,21 +536,33 @@ void InitRocksDBOptions(
   rocksdb::BlockBasedTableOptions table_options;
   if (tablet_options.block_cache) {
     table_options.block_cache = tablet_options.block_cache;
+    table_options.block_cache_compressed = tablet_options.block_cache_compressed;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
+    table_options.pin_top_level_index_and_filter = FLAGS_db_pin_top_level_index_and_filter;
+    table_options.pinned_index_and_filter_mem_tracker =
+        tablet_options.pinned_index_and_filter_mem_tracker;
+    table_options.lazy_load_filter = FLAGS_rocksdb_lazy_load_table_metadata;
   } else {
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
   }
+  table_options.persistent_cache = tablet_options.persistent_cache;
   table_options.block_size = FLAGS_db_block_size_bytes;
   table_options.filter_block_size = FLAGS_db_filter_block_size_bytes;
   table_options.index_block_size = FLAGS_db_index_block_size_bytes;
   table_options.min_keys_per_index_block = FLAGS_db_min_keys_per_index_block;
+  table_options.max_auto_readahead_size = FLAGS_db_max_auto_readahead_size_bytes;
 
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
-    table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+    if (FLAGS_docdb_bloom_filter_with_first_range_component) {
+      table_options.filter_policy.reset(new DocDbAwareFirstRangeComponentFilterPolicy(
+          table_options.filter_block_size * 8, options->info_log.get()));
+    } else {
+      table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
+          table_options.filter_block_size * 8, options->info_log.get()));
+    }
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -411,6 +570,10 @@ void InitRocksDBOptions(
   } else {
     table_options.index_type = rocksdb::IndexType::kBinarySearch;
   }
+  if (FLAGS_docdb_use_three_shared_parts_key_encoding) {
+    table_options.data_block_key_value_encoding_format =
+        rocksdb::KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts;
+  }
 
   options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
 
@@ -457,10 +620,12 @@ void InitRocksDBOptions(
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
-    if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
-      options->rate_limiter.reset(
-          rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
-    }
+    // With a single level every compaction writes one sorted run, i.e. one file, so it could not be
+    // split into parallel subcompactions. Reading the inputs in large chunks is used instead.
+    options->compaction_readahead_size = FLAGS_rocksdb_compaction_readahead_size_bytes;
+    options->rate_limiter = tablet_options.rate_limiter ? tablet_options.rate_limiter
+                                                        : CreateRocksDBRateLimiter();
+    options->priority_thread_pool_for_compactions = tablet_options.priority_thread_pool.get();
   }
 
   uint64_t max_file_size_for_compaction = FLAGS_rocksdb_max_file_size_for_compaction;
@@ -469,5 +634,33 @@ void InitRocksDBOptions(
   }
 }
 
+void InitRocksDBDataPaths(const std::string& db_dir, rocksdb::Options* options) {
+  options->db_paths.clear();
+  // Only universal compaction moves data between paths, see UniversalCompactionPicker::GetPathId.
+  if (FLAGS_rocksdb_cold_data_dir.empty() ||
+      options->compaction_style != rocksdb::CompactionStyle::kCompactionStyleUniversal) {
+    return;
+  }
+  options->db_paths.emplace_back(db_dir, FLAGS_rocksdb_hot_data_target_size_bytes);
+  // Tablet dir names are unique, so there is no need to replicate the table level.
+  options->db_paths.emplace_back(
+      JoinPathSegments(FLAGS_rocksdb_cold_data_dir, BaseName(db_dir)),
+      std::numeric_limits<uint64_t>::max());
+}
+
+std::shared_ptr<rocksdb::RateLimiter> CreateRocksDBRateLimiter() {
+  if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec <= 0) {
+    return nullptr;
+  }
+  const bool auto_tune = FLAGS_rocksdb_compact_flush_rate_limit_auto_tune;
+  // A flush that falls behind stalls writes, so when the rate could be lower than configured,
+  // compactions should never delay flushes.
+  return std::shared_ptr<rocksdb::RateLimiter>(rocksdb::NewGenericRateLimiter(
+      FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec,
+      100 * 1000 /* refill_period_us */,
+      auto_tune ? 0 : 10 /* fairness */,
+      auto_tune));
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -118,6 +118,8 @@ std::unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
 
 // Values and transactions committed later than high_ht can be skipped, so we won't spend time
 // for re-requesting pending transaction status if we already know it wasn't committed at high_ht.
+// fill_block_cache could be set to false by large scans, so the data blocks they read do not
+// replace other entries in the block cache.
 std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const DocDB& doc_db,
     BloomFilterMode bloom_filter_mode,
@@ -127,7 +129,8 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     MonoTime deadline,
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
-    const Slice* iterate_upper_bound = nullptr);
+    const Slice* iterate_upper_bound = nullptr,
+    bool fill_block_cache = true);
 
 // Initialize the RocksDB 'options' object for tablet identified by 'tablet_id'. The 'statistics'
 // object provided by the caller will be used by RocksDB to maintain the stats for the tablet
@@ -137,6 +140,15 @@ void InitRocksDBOptions(
     const std::shared_ptr<rocksdb::Statistics>& statistics,
     const tablet::TabletOptions& tablet_options);
 
+// Configures directories for SST files of the regular DB located at 'db_dir' according to
+// rocksdb_cold_data_dir. Intents DB holds short living data, so it should always use the default
+// single directory.
+void InitRocksDBDataPaths(const std::string& db_dir, rocksdb::Options* options);
+
+// Creates rate limiter for flushes and compactions according to rocksdb_compact_flush_rate_limit_*
+// flags. Returns nullptr when rate limit is disabled.
+std::shared_ptr<rocksdb::RateLimiter> CreateRocksDBRateLimiter();
+
 }  // namespace docdb
 }  // namespace yb
 
@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/docdb/docdb_sst_file_writer.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "yb/docdb/docdb.h"
+
+#include "yb/rocksdb/comparator.h"
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/immutable_options.h"
+
+namespace yb {
+namespace docdb {
+
+DocDBSstFileWriter::DocDBSstFileWriter(const rocksdb::Options& options, HybridTime hybrid_time)
+    : comparator_(options.comparator),
+      writer_(rocksdb::EnvOptions(), rocksdb::ImmutableCFOptions(options), options.comparator),
+      hybrid_time_(hybrid_time) {
+}
+
+Status DocDBSstFileWriter::Open(const std::string& file_path) {
+  return writer_.Open(file_path);
+}
+
+Status DocDBSstFileWriter::Add(const KeyValueWriteBatchPB& write_batch) {
+  if (write_batch.has_transaction()) {
+    return STATUS(InvalidArgument, "Transactional records could not be written to an SST file");
+  }
+
+  std::vector<std::pair<std::string, const std::string*>> records;
+  records.reserve(write_batch.kv_pairs_size());
+  DocHybridTimeBuffer doc_ht_buffer;
+  for (const auto& kv_pair : write_batch.kv_pairs()) {
+    CHECK(!kv_pair.key().empty());
+    CHECK(!kv_pair.value().empty());
+    std::string key = kv_pair.key();
+    auto encoded_doc_ht = doc_ht_buffer.EncodeWithValueType(hybrid_time_, write_id_++);
+    key.append(encoded_doc_ht.cdata(), encoded_doc_ht.size());
+    records.emplace_back(std::move(key), &kv_pair.value());
+  }
+
+  // Records of a single batch could come in any order, but SST file requires sorted keys.
+  std::sort(records.begin(), records.end(), [this](const auto& lhs, const auto& rhs) {
+    return comparator_->Compare(lhs.first, rhs.first) < 0;
+  });
+
+  for (const auto& record : records) {
+    if (!last_key_.empty() && comparator_->Compare(record.first, last_key_) <= 0) {
+      return STATUS_FORMAT(InvalidArgument, "Key $0 is not greater than previous key $1",
+                           Slice(record.first).ToDebugHexString(),
+                           Slice(last_key_).ToDebugHexString());
+    }
+    RETURN_NOT_OK(writer_.Add(record.first, *record.second));
+    last_key_ = record.first;
+  }
+  return Status::OK();
+}
+
+Status DocDBSstFileWriter::Finish(rocksdb::ExternalSstFileInfo* file_info) {
+  return writer_.Finish(file_info);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,68 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_DOCDB_DOCDB_SST_FILE_WRITER_H
+#define YB_DOCDB_DOCDB_SST_FILE_WRITER_H
+
+#include <string>
+
+#include "yb/common/doc_hybrid_time.h"
+#include "yb/common/hybrid_time.h"
+
+#include "yb/docdb/docdb.pb.h"
+
+#include "yb/rocksdb/options.h"
+#include "yb/rocksdb/sst_file_writer.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+// Builds an SST file with regular DocDB records, that could be linked into a tablet's RocksDB
+// instead of writing the same records through the write path.
+//
+// Keys of added key/value pairs are encoded SubDocKeys without a hybrid time, the same as in the
+// write batches replicated by Raft. All records get the same hybrid time, and write ids are
+// assigned in the order the records are added. Keys of each added batch should be greater than
+// keys of previously added batches.
+class DocDBSstFileWriter {
+ public:
+  // options should be options of the RocksDB the file will be ingested into.
+  DocDBSstFileWriter(const rocksdb::Options& options, HybridTime hybrid_time);
+
+  DocDBSstFileWriter(const DocDBSstFileWriter&) = delete;
+  void operator=(const DocDBSstFileWriter&) = delete;
+
+  CHECKED_STATUS Open(const std::string& file_path);
+
+  CHECKED_STATUS Add(const KeyValueWriteBatchPB& write_batch);
+
+  // Finishes the file, file_info could be null.
+  CHECKED_STATUS Finish(rocksdb::ExternalSstFileInfo* file_info);
+
+  HybridTime hybrid_time() const { return hybrid_time_; }
+
+ private:
+  const rocksdb::Comparator* const comparator_;
+  rocksdb::SstFileWriter writer_;
+  const HybridTime hybrid_time_;
+  IntraTxnWriteId write_id_ = 0;
+  std::string last_key_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_DOCDB_SST_FILE_WRITER_H
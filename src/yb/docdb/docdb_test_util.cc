@@ -92,6 +92,15 @@ class NonTransactionalStatusProvider: public TransactionStatusManager {
     Fail();
   }
 
+  boost::optional<TransactionStatusResult> ResolvedStatus(const TransactionId& id) override {
+    Fail();
+    return boost::none;
+  }
+
+  void SetResolvedStatus(const TransactionId& id, const TransactionStatusResult& result) override {
+    Fail();
+  }
+
  private:
   static void Fail() {
     LOG(FATAL) << "Internal error: trying to get transaction status for non transactional table";
@@ -106,6 +115,19 @@ const TransactionOperationContext kNonTransactionalOperationContext = {
     boost::uuids::nil_uuid(), &kNonTransactionalStatusProvider
 };
 
+void TransactionStatusManagerMock::RequestStatusAt(const StatusRequest& request) {
+  auto it = txn_commit_time_.find(*request.id);
+  if (it == txn_commit_time_.end()) {
+    request.callback(STATUS_FORMAT(TryAgain, "Unknown transaction id: $0", *request.id));
+  } else {
+    if (request.read_ht >= it->second) {
+      request.callback(TransactionStatusResult{TransactionStatus::COMMITTED, it->second});
+    } else {
+      request.callback(TransactionStatusResult{TransactionStatus::PENDING, HybridTime::kMin});
+    }
+  }
+}
+
 PrimitiveValue GenRandomPrimitiveValue(RandomNumberGenerator* rng) {
   static vector<string> kFruit = {
       "Apple",
@@ -16,6 +16,7 @@
 
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <boost/uuid/nil_generator.hpp>
@@ -58,6 +59,45 @@ YB_STRONGLY_TYPED_BOOL(UseHash);
 // https://yugabyte.atlassian.net/browse/ENG-2177.
 extern const TransactionOperationContext kNonTransactionalOperationContext;
 
+// Transaction status manager that answers status requests synchronously, using commit times
+// registered by Commit. Transactions that were not committed are reported as unknown.
+class TransactionStatusManagerMock : public TransactionStatusManager {
+ public:
+  HybridTime LocalCommitTime(const TransactionId &id) override {
+    return HybridTime::kInvalid;
+  }
+
+  void RequestStatusAt(const StatusRequest& request) override;
+
+  void Commit(const TransactionId& txn_id, HybridTime commit_time) {
+    txn_commit_time_.emplace(txn_id, commit_time);
+  }
+
+  boost::optional<TransactionMetadata> Metadata(const TransactionId& id) override {
+    return boost::none;
+  }
+
+  void Abort(const TransactionId& id, TransactionStatusCallback callback) override {
+  }
+
+  boost::optional<TransactionStatusResult> ResolvedStatus(const TransactionId& id) override {
+    return boost::none;
+  }
+
+  void SetResolvedStatus(const TransactionId& id, const TransactionStatusResult& result) override {
+  }
+
+  int64_t RegisterRequest() override {
+    return 0;
+  }
+
+  void UnregisterRequest(int64_t) override {
+  }
+
+ private:
+  std::unordered_map<TransactionId, HybridTime, TransactionIdHash> txn_commit_time_;
+};
+
 // Note: test data generator methods below are using a non-const reference for the random number
 // generator for simplicity, even though it is against Google C++ Style Guide. If we used a pointer,
 // we would have to invoke the RNG as (*rng)().
@@ -250,7 +250,8 @@ Status DocDBRocksDBUtil::InitCommonRocksDBOptions() {
                             tablet_options);
   InitRocksDBWriteOptions(&write_options_);
   rocksdb_options_.compaction_filter_factory =
-      std::make_shared<docdb::DocDBCompactionFilterFactory>(retention_policy_);
+      std::make_shared<docdb::DocDBCompactionFilterFactory>(
+          retention_policy_, compaction_filter_stats_);
   return Status::OK();
 }
 
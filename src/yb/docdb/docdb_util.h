@@ -96,6 +96,11 @@ class DocDBRocksDBUtil {
 
   void SetHistoryCutoffHybridTime(HybridTime history_cutoff);
 
+  // Returns numbers of entries dropped by compactions since the previous call.
+  DocDBCompactionFilterStats TakeCompactionFilterStats() {
+    return compaction_filter_stats_->Take();
+  }
+
   // Produces a string listing the contents of the entire RocksDB database, with every key and value
   // decoded as a DocDB key/value and converted to a human-readable string representation.
   std::string DocDBDebugDumpToStr();
@@ -196,6 +201,8 @@ class DocDBRocksDBUtil {
   std::shared_ptr<rocksdb::Cache> block_cache_;
   std::shared_ptr<FixedHybridTimeRetentionPolicy> retention_policy_ {
       std::make_shared<FixedHybridTimeRetentionPolicy>(HybridTime::kMin, MonoDelta::kMax) };
+  DocDBCompactionFilterStatsCollectorPtr compaction_filter_stats_ {
+      std::make_shared<DocDBCompactionFilterStatsCollector>() };
 
   rocksdb::WriteOptions write_options_;
   Schema schema_;
@@ -19,6 +19,7 @@
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 
 #include "yb/server/hybrid_clock.h"
 
@@ -583,6 +584,97 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorValidColumnNotInProjection) {
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, PackedRow) {
+  // Values written before the packed row are overwritten by it.
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("old_c"), HybridTime::FromMicros(500)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)),
+      PrimitiveValue("old_e"), HybridTime::FromMicros(500)));
+
+  PackedRow packed_row(/* schema_version= */ 0);
+  packed_row.AddColumn(40_ColId, PrimitiveValue(10000));
+  packed_row.AddColumn(30_ColId, PrimitiveValue("row1_c"));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow)),
+      PrimitiveValue(packed_row.Encode()), HybridTime::FromMicros(1000)));
+
+  // Values written after the packed row take precedence over it.
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000), HybridTime::FromMicros(2000)));
+  ASSERT_OK(DeleteSubDoc(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)), HybridTime::FromMicros(3000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+
+  // Checks values of columns c, d and e read at the specified time, empty string or 0 for null.
+  auto check_row = [this, &schema, &projection](
+      MicrosTime time, const std::string& c, int64_t d, const std::string& e) {
+    SCOPED_TRACE(Format("Time: $0", time));
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        MonoTime::Max() /* deadline */, ReadHybridTime::FromMicros(time));
+    ASSERT_OK(iter.Init());
+    QLTableRow row;
+    ASSERT_TRUE(iter.HasNext());
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_EQ(time >= 1000, iter.LivenessColumnExists());
+    ASSERT_FALSE(iter.HasNext());
+
+    QLValue value;
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_EQ(c, value.IsNull() ? "" : value.string_value());
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(d, value.IsNull() ? 0 : value.int64_value());
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_EQ(e, value.IsNull() ? "" : value.string_value());
+  };
+
+  check_row(700, "old_c", 0, "old_e");
+  check_row(1500, "row1_c", 10000, "");
+  check_row(2500, "row1_c", 20000, "");
+  check_row(3500, "", 20000, "");
+}
+
+TEST_F(DocRowwiseIteratorTest, RowWithoutProjectedColumns) {
+  // Row 1 has only columns that are not projected.
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(10000), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row1_e"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c"), HybridTime::FromMicros(1000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  Schema projection;
+  ASSERT_OK(schema.CreateProjectionByNames({"c"}, &projection));
+
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      MonoTime::Max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+  QLTableRow row;
+  QLValue value;
+
+  ASSERT_TRUE(iter.HasNext());
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_TRUE(value.IsNull());
+
+  ASSERT_TRUE(iter.HasNext());
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ("row2_c", value.string_value());
+
+  ASSERT_FALSE(iter.HasNext());
+}
+
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorKeyProjection) {
   auto dwb = MakeDocWriteBatch();
 
@@ -626,51 +718,6 @@ SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(50); HT{ physical: 1000 w: 1 }]
   }
 }
 
-namespace {
-
-class TransactionStatusManagerMock : public TransactionStatusManager {
- public:
-  HybridTime LocalCommitTime(const TransactionId &id) override {
-    return HybridTime::kInvalid;
-  }
-
-  void RequestStatusAt(const StatusRequest& request) override {
-    auto it = txn_commit_time_.find(*request.id);
-    if (it == txn_commit_time_.end()) {
-      request.callback(STATUS_FORMAT(TryAgain, "Unknown transaction id: $0", *request.id));
-    } else {
-      if (request.read_ht >= it->second) {
-        request.callback(TransactionStatusResult{TransactionStatus::COMMITTED, it->second});
-      } else {
-        request.callback(TransactionStatusResult{TransactionStatus::PENDING, HybridTime::kMin});
-      }
-    }
-  }
-
-  void Commit(const TransactionId& txn_id, HybridTime commit_time) {
-    txn_commit_time_.emplace(txn_id, commit_time);
-  }
-
-  boost::optional<TransactionMetadata> Metadata(const TransactionId& id) override {
-    return boost::none;
-  }
-
-  void Abort(const TransactionId& id, TransactionStatusCallback callback) override {
-  }
-
-  int64_t RegisterRequest() override {
-    return 0;
-  }
-
-  void UnregisterRequest(int64_t) override {
-  }
-
- private:
-  std::unordered_map<TransactionId, HybridTime, TransactionIdHash> txn_commit_time_;
-};
-
-} // namespace
-
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorResolveWriteIntents) {
   SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
 
@@ -958,5 +1005,57 @@ TXN REV 30303030-3030-3030-3030-303030303031 HT{ physical: 500 w: 1 } -> \
   ASSERT_EQ(doc_ht.ToString(), "HT{ physical: 1000 }");
 }
 
+TEST_F(DocRowwiseIteratorTest, IntentAwareIteratorPrevDocKey) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  for (const auto* doc_key : {&kEncodedDocKey1, &kEncodedDocKey2}) {
+    for (int i = 0; i != 3; ++i) {
+      ASSERT_OK(SetPrimitive(
+          DocPath(*doc_key, PrimitiveValue(30_ColId)),
+          PrimitiveValue(Format("v$0", i)), HybridTime::FromMicros(1000 + i)));
+      ASSERT_OK(SetPrimitive(
+          DocPath(*doc_key, PrimitiveValue(40_ColId)),
+          PrimitiveValue(i), HybridTime::FromMicros(1000 + i)));
+    }
+  }
+  // This row is written after the read time, so it should be skipped.
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key3, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row3_c"), HybridTime::FromMicros(2000)));
+
+  IntentAwareIterator iter(
+      doc_db(), rocksdb::ReadOptions(), MonoTime::Max() /* deadline */,
+      ReadHybridTime::FromMicros(1001), boost::none);
+  auto fetch_key = [&iter]() -> std::string {
+    EXPECT_TRUE(iter.valid());
+    DocHybridTime doc_ht;
+    Slice key = EXPECT_RESULT(iter.FetchKey(&doc_ht));
+    SubDocKey subdoc_key;
+    EXPECT_OK(subdoc_key.FullyDecodeFrom(key, HybridTimeRequired::kFalse));
+    return subdoc_key.ToString() + " " + doc_ht.ToString();
+  };
+
+  iter.SeekToLastDocKey();
+  ASSERT_EQ(R"#(SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(30)]) HT{ physical: 1001 })#",
+            fetch_key());
+
+  // Move to the previous row from the middle of the current one, and from its end.
+  iter.SeekPastSubKey(
+      SubDocKey(DocKey(PrimitiveValues("row2", 22222)), PrimitiveValue(30_ColId))
+          .EncodeWithoutHt().AsSlice());
+  ASSERT_EQ(R"#(SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(40)]) HT{ physical: 1001 })#",
+            fetch_key());
+  iter.PrevDocKey(DocKey(PrimitiveValues("row2", 22222)));
+  ASSERT_EQ(R"#(SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(30)]) HT{ physical: 1001 })#",
+            fetch_key());
+
+  iter.Seek(kEncodedDocKey2);
+  iter.PrevDocKey(DocKey(PrimitiveValues("row2", 22222)));
+  ASSERT_EQ(R"#(SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(30)]) HT{ physical: 1001 })#",
+            fetch_key());
+
+  iter.PrevDocKey(DocKey(PrimitiveValues("row1", 11111)));
+  ASSERT_FALSE(iter.valid());
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -112,5 +112,32 @@ CHECKED_STATUS DecodeIntentValue(
   return Status::OK();
 }
 
+Result<ReverseIndexValue> DecodeReverseIndexValue(Slice value) {
+  ReverseIndexValue result;
+  // Intent key starts with encoded DocKey, so it cannot start with kWriteId.
+  if (value.empty() || value[0] != ValueTypeAsChar::kWriteId) {
+    result.intent_key = value;
+    return result;
+  }
+  value.consume_byte();
+  if (value.size() < sizeof(IntraTxnWriteId) + sizeof(uint32_t)) {
+    return STATUS_FORMAT(Corruption, "Not enough bytes in reverse index value: $0",
+                         value.ToDebugHexString());
+  }
+  result.write_id = BigEndian::Load32(value.data());
+  value.remove_prefix(sizeof(IntraTxnWriteId));
+  const size_t key_size = BigEndian::Load32(value.data());
+  value.remove_prefix(sizeof(uint32_t));
+  if (value.size() < key_size) {
+    return STATUS_FORMAT(Corruption, "Intent key of size $0 does not fit reverse index value: $1",
+                         key_size, value.ToDebugHexString());
+  }
+  result.intent_key = Slice(value.data(), key_size);
+  value.remove_prefix(key_size);
+  result.has_body = true;
+  result.body = value;
+  return result;
+}
+
 }  // namespace docdb
 }  // namespace yb
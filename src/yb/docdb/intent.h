@@ -34,6 +34,21 @@ CHECKED_STATUS DecodeIntentValue(
 // Decodes transaction ID from intent value. Consumes it from intent_value slice.
 Result<TransactionId> DecodeTransactionIdFromIntentValue(Slice* intent_value);
 
+// Decoded value of a transaction reverse index record.
+// For strong intents the record also contains write id and value of the intent, so all intents of
+// a transaction could be applied by a sequential read of its reverse index:
+//   kWriteId + write id + intent key size + intent key + intent value body.
+// Other records, and strong intent records written before this format, contain just intent key.
+struct ReverseIndexValue {
+  Slice intent_key;
+  // Whether write_id and body are stored in the reverse index record.
+  bool has_body = false;
+  IntraTxnWriteId write_id = 0;
+  Slice body;
+};
+
+Result<ReverseIndexValue> DecodeReverseIndexValue(Slice value);
+
 enum class IntentKind {
   // "Weak" intents are written for ancecstor keys of a key that's being modified. For example, if
   // we're writing a.b.c with snapshot isolation, we'll write weak snapshot isolation intents for
@@ -28,12 +28,25 @@
 #include "yb/docdb/value.h"
 
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/flag_tags.h"
 
 using namespace std::literals;
 
 DEFINE_bool(transaction_allow_rerequest_status_in_tests, true,
             "Allow rerequest transaction status when try again is received.");
 
+DEFINE_int32(max_prevs_to_avoid_seek, 16,
+             "The number of prev calls that a reverse scan tries when moving to the previous "
+             "document, before resorting to a rocksdb seek.");
+TAG_FLAG(max_prevs_to_avoid_seek, advanced);
+TAG_FLAG(max_prevs_to_avoid_seek, runtime);
+
+DEFINE_bool(docdb_intents_use_bloom_filter, true,
+            "Use the bloom filter of the regular db read also for the intents db, so files of the "
+            "intents db without intents for the read key are skipped.");
+TAG_FLAG(docdb_intents_use_bloom_filter, advanced);
+TAG_FLAG(docdb_intents_use_bloom_filter, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -87,6 +100,11 @@ Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId&
     return local_commit_time;
   }
 
+  auto resolved_status = txn_status_manager_->ResolvedStatus(transaction_id);
+  if (resolved_status) {
+    return CommitTimeAtReadTime(*resolved_status);
+  }
+
   TransactionStatusResult txn_status;
   BackoffWaiter waiter(deadline_.ToSteadyTimePoint(), 50ms /* max_wait */);
   for(;;) {
@@ -123,11 +141,25 @@ Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId&
   // with ABORTED status. So we recheck whether it was committed locally.
   if (txn_status.status == TransactionStatus::ABORTED) {
     local_commit_time = GetLocalCommitTime(transaction_id);
-    return local_commit_time.is_valid() ? local_commit_time : HybridTime::kMin;
-  } else {
-    return txn_status.status == TransactionStatus::COMMITTED ? txn_status.status_time
-        : HybridTime::kMin;
+    if (local_commit_time.is_valid()) {
+      return local_commit_time;
+    }
+    txn_status_manager_->SetResolvedStatus(transaction_id, txn_status);
+    return HybridTime::kMin;
+  } else if (txn_status.status == TransactionStatus::COMMITTED) {
+    txn_status_manager_->SetResolvedStatus(transaction_id, txn_status);
+    return txn_status.status_time;
+  }
+  return HybridTime::kMin;
+}
+
+// Final status is shared by readers with different read times, so it is interpreted in the same
+// way as local commit time.
+HybridTime TransactionStatusCache::CommitTimeAtReadTime(const TransactionStatusResult& status) {
+  if (status.status != TransactionStatus::COMMITTED) {
+    return HybridTime::kMin;
   }
+  return status.status_time <= read_time_.global_limit ? status.status_time : HybridTime::kMin;
 }
 
 namespace {
@@ -234,12 +266,15 @@ IntentAwareIterator::IntentAwareIterator(
   VLOG(4) << "IntentAwareIterator, read_time: " << read_time
           << ", txp_op_context: " << txn_op_context_;
   if (txn_op_context.is_initialized()) {
-    intent_iter_ = docdb::CreateRocksDBIterator(doc_db.intents,
-                                                docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
-                                                boost::none,
-                                                rocksdb::kDefaultQueryId,
-                                                nullptr /* file_filter */,
-                                                &intent_upperbound_);
+    // Intent keys start with the doc key they were written for, so a file that does not match
+    // the regular db bloom filter does not contain intents for the read either. The file filter
+    // is not used, because HybridTimes of intents are not commit times.
+    rocksdb::ReadOptions intents_read_opts;
+    if (FLAGS_docdb_intents_use_bloom_filter) {
+      intents_read_opts.table_aware_file_filter = read_opts.table_aware_file_filter;
+    }
+    intents_read_opts.iterate_upper_bound = &intent_upperbound_;
+    intent_iter_.reset(doc_db.intents->NewIterator(intents_read_opts));
   }
   iter_.reset(doc_db.regular->NewIterator(read_opts));
 }
@@ -361,17 +396,65 @@ void IntentAwareIterator::SeekToLastDocKey() {
   if (!iter_valid_) {
     return;
   }
-  // Seek to the first rocksdb kv-pair for this row.
-  rocksdb::Slice rocksdb_key(iter_->key());
-  DocKey doc_key;
-  status_ = doc_key.DecodeFrom(&rocksdb_key);
-  if (!status_.ok()) {
+  MoveToDocKeyStart();
+}
+
+void IntentAwareIterator::MoveToDocKeyStart() {
+  Slice key = iter_->key();
+  auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    status_ = doc_key_size.status();
     return;
   }
-  Seek(doc_key.Encode());
+  // Copy the doc key, since the iterator is moved while it is used.
+  seek_key_buffer_.Reset(Slice(key.data(), *doc_key_size));
+  for (int prevs = 0; prevs < FLAGS_max_prevs_to_avoid_seek; ++prevs) {
+    iter_->Prev();
+    if (!iter_->Valid()) {
+      iter_->SeekToFirst();
+      skip_future_records_needed_ = true;
+      return;
+    }
+    if (!iter_->key().starts_with(seek_key_buffer_.AsSlice())) {
+      iter_->Next();
+      skip_future_records_needed_ = true;
+      return;
+    }
+  }
+  Seek(seek_key_buffer_.AsSlice());
+}
+
+bool IntentAwareIterator::PrevDocKeyWithoutSeek(const Slice& encoded_doc_key) {
+  if (iter_->key().compare(encoded_doc_key) < 0) {
+    return false;
+  }
+  int prevs = 0;
+  while (iter_->key().compare(encoded_doc_key) >= 0) {
+    if (++prevs > FLAGS_max_prevs_to_avoid_seek) {
+      return false;
+    }
+    iter_->Prev();
+    if (!iter_->Valid()) {
+      // There are no records before the doc key.
+      skip_future_records_needed_ = false;
+      iter_valid_ = false;
+      return true;
+    }
+  }
+  SkipFutureRecords(Direction::kBackward);
+  skip_future_records_needed_ = false;
+  if (iter_valid_) {
+    MoveToDocKeyStart();
+  }
+  return true;
 }
 
 void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
+  // Intents are not moved backward, so only regular records could be walked through with Prev().
+  if (!intent_iter_ && status_.ok() && iter_->Valid() &&
+      PrevDocKeyWithoutSeek(doc_key.Encode().AsSlice())) {
+    return;
+  }
   Seek(doc_key);
   // TODO(dtxn) - also should move back intent iterator. See ENG-3376.
   if (!status_.ok()) {
@@ -706,7 +789,21 @@ void IntentAwareIterator::SkipFutureRecords(const Direction direction) {
     VLOG(4) << "Skipping because of time: " << SubDocKey::DebugSliceToString(iter_->key());
     switch (direction) {
       case Direction::kForward:
-        iter_->Next(); // TODO(dtxn) use seek with the same key, but read limit as doc hybrid time.
+        if (encoded_doc_ht.compare(Slice(encoded_read_time_global_limit_)) < 0) {
+          // Record was written after the global read limit, so all versions of this key before
+          // the one at the global read limit are invisible. Seek to it, instead of stepping
+          // through each version, because frequently updated keys could have a lot of them.
+          Slice key_without_ht = iter_->key();
+          key_without_ht.remove_suffix(doc_ht_size + 1);
+          DCHECK_EQ(ValueType::kHybridTime, static_cast<ValueType>(key_without_ht.end()[0]));
+          seek_key_buffer_.Reserve(
+              key_without_ht.size() + encoded_read_time_global_limit_.size() + 1);
+          seek_key_buffer_.Reset(key_without_ht);
+          AppendEncodedDocHt(encoded_read_time_global_limit_, &seek_key_buffer_);
+          docdb::SeekForward(seek_key_buffer_, iter_.get());
+        } else {
+          iter_->Next();
+        }
         break;
       case Direction::kBackward:
         iter_->Prev();
@@ -38,6 +38,7 @@ YB_DEFINE_ENUM(Direction, (kForward)(kBackward));
 
 // Caches transaction statuses fetched by single IntentAwareIterator.
 // Thread safety is not required, because IntentAwareIterator is used in a single thread only.
+// Final statuses are also shared with other readers of the tablet through the status manager.
 class TransactionStatusCache {
  public:
   TransactionStatusCache(TransactionStatusManager* txn_status_manager,
@@ -52,6 +53,7 @@ class TransactionStatusCache {
  private:
   HybridTime GetLocalCommitTime(const TransactionId& transaction_id);
   Result<HybridTime> DoGetCommitTime(const TransactionId& transaction_id);
+  HybridTime CommitTimeAtReadTime(const TransactionStatusResult& status);
 
   TransactionStatusManager* txn_status_manager_;
   ReadHybridTime read_time_;
@@ -156,6 +158,16 @@ class IntentAwareIterator {
   // Seek forward on regular sub-iterator.
   void SeekForwardRegular(const Slice& slice);
 
+  // Moves regular sub-iterator from a record of some document to the first record of that
+  // document. Uses Prev() when the document has few records, and Seek() otherwise.
+  void MoveToDocKeyStart();
+
+  // Positions regular sub-iterator at the beginning of the doc key found before the specified
+  // encoded doc key, by moving backward with Prev() from its current position. Returns false if
+  // the iterator is before the encoded doc key or it would take too many steps, in this case the
+  // caller should seek instead.
+  bool PrevDocKeyWithoutSeek(const Slice& encoded_doc_key);
+
   // Skips regular entries with hybrid time after read limit.
   // If `is_forward` is `false` and `iter_` is positioned to the earliest record for the current
   // key, there are two cases:
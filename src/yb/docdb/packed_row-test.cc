@@ -0,0 +1,55 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/docdb/packed_row.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+TEST(PackedRowTest, EncodeDecode) {
+  PackedRow packed_row(/* schema_version= */ 7);
+  packed_row.AddColumn(ColumnId(12), PrimitiveValue("text"));
+  packed_row.AddColumn(ColumnId(10), PrimitiveValue(1234567890123));
+  packed_row.AddColumn(ColumnId(11), PrimitiveValue::Double(3.5));
+  packed_row.AddColumn(ColumnId(10), PrimitiveValue(42));
+
+  auto decoded = PackedRow::Decode(packed_row.Encode());
+  ASSERT_OK(decoded);
+  ASSERT_EQ(7U, decoded->schema_version());
+  ASSERT_EQ(3U, decoded->columns().size());
+  ASSERT_EQ(ColumnId(10), decoded->columns()[0].first);
+  ASSERT_EQ(ColumnId(11), decoded->columns()[1].first);
+  ASSERT_EQ(ColumnId(12), decoded->columns()[2].first);
+
+  ASSERT_EQ(PrimitiveValue(42), *decoded->GetColumn(ColumnId(10)));
+  ASSERT_EQ(PrimitiveValue::Double(3.5), *decoded->GetColumn(ColumnId(11)));
+  ASSERT_EQ(PrimitiveValue("text"), *decoded->GetColumn(ColumnId(12)));
+  ASSERT_EQ(nullptr, decoded->GetColumn(ColumnId(13)));
+}
+
+TEST(PackedRowTest, Corruption) {
+  PackedRow packed_row(/* schema_version= */ 1);
+  packed_row.AddColumn(ColumnId(10), PrimitiveValue("value"));
+  auto encoded = packed_row.Encode();
+
+  ASSERT_NOK(PackedRow::Decode(Slice(encoded.data(), encoded.size() - 1)));
+  ASSERT_NOK(PackedRow::Decode(encoded + "x"));
+  ASSERT_OK(PackedRow::Decode(encoded));
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/docdb/packed_row.h"
+
+#include <algorithm>
+
+#include "yb/util/fast_varint.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+void AppendUnsignedVarInt(uint64_t value, std::string* out) {
+  uint8_t buf[util::kMaxVarIntBufferSize];
+  size_t size = 0;
+  util::FastEncodeUnsignedVarInt(value, buf, &size);
+  out->append(pointer_cast<const char*>(buf), size);
+}
+
+Result<uint64_t> ConsumeUnsignedVarInt(Slice* slice) {
+  uint64_t value = 0;
+  size_t size = 0;
+  RETURN_NOT_OK(util::FastDecodeUnsignedVarInt(slice->data(), slice->size(), &value, &size));
+  slice->remove_prefix(size);
+  return value;
+}
+
+bool ColumnIdLess(const std::pair<ColumnId, PrimitiveValue>& lhs, ColumnId rhs) {
+  return lhs.first < rhs;
+}
+
+} // namespace
+
+void PackedRow::AddColumn(ColumnId column_id, PrimitiveValue value) {
+  auto it = std::lower_bound(columns_.begin(), columns_.end(), column_id, ColumnIdLess);
+  if (it != columns_.end() && it->first == column_id) {
+    it->second = std::move(value);
+  } else {
+    columns_.emplace(it, column_id, std::move(value));
+  }
+}
+
+const PrimitiveValue* PackedRow::GetColumn(ColumnId column_id) const {
+  auto it = std::lower_bound(columns_.begin(), columns_.end(), column_id, ColumnIdLess);
+  return it != columns_.end() && it->first == column_id ? &it->second : nullptr;
+}
+
+std::string PackedRow::Encode() const {
+  std::string result;
+  AppendUnsignedVarInt(schema_version_, &result);
+  AppendUnsignedVarInt(columns_.size(), &result);
+  for (const auto& column : columns_) {
+    AppendUnsignedVarInt(column.first.rep(), &result);
+    auto value = column.second.ToValue();
+    AppendUnsignedVarInt(value.size(), &result);
+    result.append(value);
+  }
+  return result;
+}
+
+Result<PackedRow> PackedRow::Decode(Slice slice) {
+  PackedRow result(static_cast<uint32_t>(VERIFY_RESULT(ConsumeUnsignedVarInt(&slice))));
+  const auto num_columns = VERIFY_RESULT(ConsumeUnsignedVarInt(&slice));
+  result.columns_.reserve(num_columns);
+  for (uint64_t i = 0; i != num_columns; ++i) {
+    const ColumnId column_id(
+        static_cast<ColumnIdRep>(VERIFY_RESULT(ConsumeUnsignedVarInt(&slice))));
+    const auto size = VERIFY_RESULT(ConsumeUnsignedVarInt(&slice));
+    if (size > slice.size()) {
+      return STATUS_FORMAT(Corruption, "Packed row value of column $0 is too long: $1, left: $2",
+                           column_id, size, slice.size());
+    }
+    if (!result.columns_.empty() && !(result.columns_.back().first < column_id)) {
+      return STATUS_FORMAT(Corruption, "Packed row columns are not sorted: $0 after $1",
+                           column_id, result.columns_.back().first);
+    }
+    PrimitiveValue value;
+    RETURN_NOT_OK(value.DecodeFromValue(Slice(slice.data(), size)));
+    slice.remove_prefix(size);
+    result.columns_.emplace_back(column_id, std::move(value));
+  }
+  if (!slice.empty()) {
+    return STATUS_FORMAT(Corruption, "Extra $0 bytes after packed row", slice.size());
+  }
+  return result;
+}
+
+} // namespace docdb
+} // namespace yb
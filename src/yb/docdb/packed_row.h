@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_DOCDB_PACKED_ROW_H
+#define YB_DOCDB_PACKED_ROW_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/common/schema.h"
+
+#include "yb/docdb/primitive_value.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Values of all non-key columns of a QL row, that are stored in a single RocksDB entry of the
+// packed row system column, instead of a separate entry per column.
+//
+// Encoded as schema version and number of columns, followed by column id, value size and value
+// for each column with a non-null value, in the order of column ids. All integers are encoded as
+// unsigned varints, values are encoded as PrimitiveValue values.
+//
+// Columns written after the packed row are stored as separate entries, and take precedence over
+// values in the packed row on read.
+class PackedRow {
+ public:
+  typedef std::vector<std::pair<ColumnId, PrimitiveValue>> Columns;
+
+  explicit PackedRow(uint32_t schema_version) : schema_version_(schema_version) {}
+
+  void AddColumn(ColumnId column_id, PrimitiveValue value);
+
+  // Returns value of the specified column, or nullptr if the column is not present.
+  const PrimitiveValue* GetColumn(ColumnId column_id) const;
+
+  uint32_t schema_version() const {
+    return schema_version_;
+  }
+
+  const Columns& columns() const {
+    return columns_;
+  }
+
+  std::string Encode() const;
+
+  static Result<PackedRow> Decode(Slice slice);
+
+ private:
+  uint32_t schema_version_;
+  // Sorted by column id.
+  Columns columns_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_PACKED_ROW_H
@@ -377,6 +377,22 @@ TEST(PrimitiveValueTest, TestMove) {
   TestMove(PrimitiveValue(HybridTime(1000)), 1000, 1000);
 }
 
+TEST(PrimitiveValueTest, TestMoveToQLValuePB) {
+  const std::string value(100, 'x');
+  PrimitiveValue primitive_value(value);
+  QLValuePB ql_value;
+  PrimitiveValue::MoveToQLValuePB(&primitive_value, QLType::Create(STRING), &ql_value);
+  ASSERT_EQ(value, ql_value.string_value());
+
+  PrimitiveValue binary_value(value);
+  PrimitiveValue::MoveToQLValuePB(&binary_value, QLType::Create(BINARY), &ql_value);
+  ASSERT_EQ(value, ql_value.binary_value());
+
+  PrimitiveValue int_value = PrimitiveValue::Int32(1000);
+  PrimitiveValue::MoveToQLValuePB(&int_value, QLType::Create(INT32), &ql_value);
+  ASSERT_EQ(1000, ql_value.int32_value());
+}
+
 // Ensures that the serialized version of a primitive value compares the same way as the primitive
 // value.
 void ComparePrimitiveValues(const PrimitiveValue& v1, const PrimitiveValue& v2) {
@@ -41,7 +41,8 @@ namespace docdb {
 class SubDocument;
 
 enum class SystemColumnIds : ColumnIdRep {
-  kLivenessColumn = 0  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kLivenessColumn = 0,  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kPackedRow = 1,  // Stores values of all non-key columns of a QL row, see PackedRow.
 };
 
 class PrimitiveValue {
@@ -191,6 +192,12 @@ class PrimitiveValue {
                           const std::shared_ptr<QLType>& ql_type,
                           QLValuePB* ql_val);
 
+  // Same as ToQLValuePB, but string values are moved to ql_val instead of being copied, leaving
+  // them empty in pv.
+  static void MoveToQLValuePB(PrimitiveValue* pv,
+                              const std::shared_ptr<QLType>& ql_type,
+                              QLValuePB* ql_val);
+
   ValueType value_type() const { return type_; }
 
   void AppendToKey(KeyBytes* key_bytes) const;
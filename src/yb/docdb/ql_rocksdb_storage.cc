@@ -17,6 +17,22 @@
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_expr.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(ql_scan_iterator_cache_size, 0,
+             "Max number of iterators of paged QL scans kept per tablet, so the next page of a "
+             "scan continues reading with the same iterator instead of seeking to its start "
+             "again. Cached iterators pin memtables and SST files of the tablet. Zero disables "
+             "caching.");
+TAG_FLAG(ql_scan_iterator_cache_size, advanced);
+TAG_FLAG(ql_scan_iterator_cache_size, runtime);
+
+DEFINE_int32(ql_scan_iterator_cache_ttl_ms, 5000,
+             "Time after which a cached iterator of a paged QL scan is destroyed, if the next page "
+             "was not requested.");
+TAG_FLAG(ql_scan_iterator_cache_ttl_ms, advanced);
+TAG_FLAG(ql_scan_iterator_cache_ttl_ms, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -24,6 +40,10 @@ QLRocksDBStorage::QLRocksDBStorage(const DocDB& doc_db)
     : doc_db_(doc_db) {
 }
 
+QLRocksDBStorage::~QLRocksDBStorage() {
+  ClearIteratorCache();
+}
+
 //--------------------------------------------------------------------------------------------------
 
 CHECKED_STATUS QLRocksDBStorage::GetIterator(
@@ -35,14 +55,88 @@ CHECKED_STATUS QLRocksDBStorage::GetIterator(
     const ReadHybridTime& read_time,
     const common::QLScanSpec& spec,
     std::unique_ptr<common::YQLRowwiseIteratorIf> *iter) const {
+  if (FLAGS_ql_scan_iterator_cache_size <= 0 || !request.return_paging_state() || txn_op_context) {
+    auto doc_iter = std::make_unique<DocRowwiseIterator>(
+        projection, schema, txn_op_context, doc_db_, deadline, read_time);
+    RETURN_NOT_OK(doc_iter->Init(spec));
+    *iter = std::move(doc_iter);
+    return Status::OK();
+  }
+
+  const auto key = IteratorCacheKey(request, txn_op_context, request.paging_state().next_row_key());
+  if (!key.empty()) {
+    std::lock_guard<std::mutex> lock(iterator_cache_mutex_);
+    CleanupIteratorCache(MonoTime::Now());
+    for (auto it = iterator_cache_.begin(); it != iterator_cache_.end(); ++it) {
+      if (it->key == key) {
+        *iter = std::move(it->iter);
+        iterator_cache_.erase(it);
+        return Status::OK();
+      }
+    }
+  }
 
+  // The iterator could outlive the request, so it should own its projection.
   auto doc_iter = std::make_unique<DocRowwiseIterator>(
-      projection, schema, txn_op_context, doc_db_, deadline, read_time);
+      std::make_unique<Schema>(projection), schema, txn_op_context, doc_db_, deadline, read_time);
   RETURN_NOT_OK(doc_iter->Init(spec));
   *iter = std::move(doc_iter);
   return Status::OK();
 }
 
+std::string QLRocksDBStorage::IteratorCacheKey(
+    const QLReadRequestPB& request, const TransactionOperationContextOpt& txn_op_context,
+    const std::string& next_row_key) {
+  // Transactional reads could wait for transaction status, so their iterators are not reused with
+  // the deadline of another request.
+  if (txn_op_context || next_row_key.empty()) {
+    return std::string();
+  }
+  // Pages of a read differ only in the fields reset below, the read time is encoded in the next
+  // row key.
+  QLReadRequestPB scan_request(request);
+  scan_request.clear_paging_state();
+  scan_request.clear_limit();
+  scan_request.clear_offset();
+  scan_request.clear_query_id();
+  std::string result = next_row_key;
+  scan_request.AppendToString(&result);
+  return result;
+}
+
+void QLRocksDBStorage::CacheIterator(const QLReadRequestPB& request,
+                                     const QLPagingStatePB& paging_state,
+                                     std::unique_ptr<common::YQLRowwiseIteratorIf> iter) const {
+  const size_t capacity = std::max(FLAGS_ql_scan_iterator_cache_size, 0);
+  auto key = IteratorCacheKey(request, boost::none, paging_state.next_row_key());
+  if (capacity == 0 || key.empty()) {
+    return;
+  }
+  auto now = MonoTime::Now();
+  // Evicted iterators are destroyed after the mutex is released.
+  std::unique_ptr<common::YQLRowwiseIteratorIf> evicted;
+  std::lock_guard<std::mutex> lock(iterator_cache_mutex_);
+  CleanupIteratorCache(now);
+  if (iterator_cache_.size() >= capacity) {
+    evicted = std::move(iterator_cache_.front().iter);
+    iterator_cache_.pop_front();
+  }
+  iterator_cache_.push_back(CachedIterator{
+      std::move(key), now + MonoDelta::FromMilliseconds(FLAGS_ql_scan_iterator_cache_ttl_ms),
+      std::move(iter)});
+}
+
+void QLRocksDBStorage::CleanupIteratorCache(MonoTime now) const {
+  while (!iterator_cache_.empty() && iterator_cache_.front().expiration < now) {
+    iterator_cache_.pop_front();
+  }
+}
+
+void QLRocksDBStorage::ClearIteratorCache() {
+  std::lock_guard<std::mutex> lock(iterator_cache_mutex_);
+  iterator_cache_.clear();
+}
+
 CHECKED_STATUS QLRocksDBStorage::BuildYQLScanSpec(const QLReadRequestPB& request,
                                                   const ReadHybridTime& read_time,
                                                   const Schema& schema,
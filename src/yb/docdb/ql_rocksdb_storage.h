@@ -14,6 +14,9 @@
 #ifndef YB_DOCDB_QL_ROCKSDB_STORAGE_H
 #define YB_DOCDB_QL_ROCKSDB_STORAGE_H
 
+#include <deque>
+#include <mutex>
+
 #include <boost/optional.hpp>
 
 #include "yb/rocksdb/db.h"
@@ -29,6 +32,7 @@ namespace docdb {
 class QLRocksDBStorage : public common::YQLStorageIf {
  public:
   explicit QLRocksDBStorage(const DocDB& doc_db);
+  ~QLRocksDBStorage();
 
   //------------------------------------------------------------------------------------------------
   // CQL Support.
@@ -50,6 +54,12 @@ class QLRocksDBStorage : public common::YQLStorageIf {
                                   std::unique_ptr<common::QLScanSpec>* static_row_spec,
                                   ReadHybridTime* req_read_time) const override;
 
+  void CacheIterator(const QLReadRequestPB& request,
+                     const QLPagingStatePB& paging_state,
+                     std::unique_ptr<common::YQLRowwiseIteratorIf> iter) const override;
+
+  void ClearIteratorCache() override;
+
   //------------------------------------------------------------------------------------------------
   // PGSQL Support.
   CHECKED_STATUS GetIterator(const PgsqlReadRequestPB& request,
@@ -68,7 +78,27 @@ class QLRocksDBStorage : public common::YQLStorageIf {
                                   ReadHybridTime* req_read_time) const override;
 
  private:
+  // Iterator kept by a paged read, that stopped before the row identified by the key.
+  struct CachedIterator {
+    std::string key;
+    MonoTime expiration;
+    std::unique_ptr<common::YQLRowwiseIteratorIf> iter;
+  };
+
+  // Returns key of the cached iterator that continues the read, or empty string if the read could
+  // not use a cached iterator.
+  static std::string IteratorCacheKey(const QLReadRequestPB& request,
+                                      const TransactionOperationContextOpt& txn_op_context,
+                                      const std::string& next_row_key);
+
+  // Removes expired iterators, should be invoked with iterator_cache_mutex_ locked.
+  void CleanupIteratorCache(MonoTime now) const;
+
   const DocDB doc_db_;
+
+  mutable std::mutex iterator_cache_mutex_;
+  // Cached iterators, oldest first.
+  mutable std::deque<CachedIterator> iterator_cache_;
 };
 
 }  // namespace docdb
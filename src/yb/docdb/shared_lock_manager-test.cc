@@ -22,6 +22,8 @@
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
+using namespace std::literals;
+
 using std::string;
 using std::vector;
 using std::stack;
@@ -271,6 +273,51 @@ inline bool Covers(const LockState& c1, const LockState& c2) {
 
 } // namespace
 
+// Measures throughput of non conflicting lock batches, locked concurrently from multiple threads.
+TEST_F(SharedLockManagerTest, LockBatchPerformance) {
+  constexpr int kNumThreads = 8;
+  constexpr size_t kNumKeys = 10000;
+  constexpr size_t kBatchSize = 4;
+  constexpr int kBenchmarkDurationSec = 3;
+
+  vector<string> keys;
+  keys.reserve(kNumKeys);
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    keys.push_back("key_" + std::to_string(i));
+  }
+
+  std::atomic<bool> stop(false);
+  std::atomic<uint64_t> total_batches(0);
+  vector<thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([this, i, &keys, &stop, &total_batches] {
+      std::mt19937_64 rng(i);
+      uint64_t batches = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        KeyToIntentTypeMap batch;
+        while (batch.size() < kBatchSize) {
+          // Serializable writes do not conflict with each other, so threads never wait.
+          batch.emplace(keys[rng() % keys.size()], IntentType::kStrongSerializableWrite);
+        }
+        LockBatch lock_batch(&lm_, std::move(batch));
+        ++batches;
+      }
+      total_batches += batches;
+    });
+  }
+
+  std::this_thread::sleep_for(kBenchmarkDurationSec * 1s);
+  stop = true;
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  const auto batches_per_second = total_batches.load() / kBenchmarkDurationSec;
+  LOG(INFO) << "Locked " << total_batches.load() << " batches of " << kBatchSize << " keys from "
+            << kNumThreads << " threads, " << batches_per_second << " batches per second";
+  ASSERT_GT(total_batches.load(), 0);
+}
+
 TEST_F(SharedLockManagerTest, CombineIntentsTest) {
   // Verify the lock type returned from SharedLockManager::CombineIntents() that combines two
   // intents satisfies the following rules:
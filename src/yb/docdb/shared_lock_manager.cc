@@ -13,9 +13,9 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <algorithm>
 #include <vector>
 
-#include <boost/range/adaptor/reversed.hpp>
 #include <glog/logging.h>
 
 #include "yb/util/bytes_formatter.h"
@@ -229,6 +229,7 @@ void SharedLockManager::LockEntry::Unlock(IntentType lock_type) {
 void SharedLockManager::Lock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Locking a batch of $0 keys", key_to_intent_type.size());
   std::vector<SharedLockManager::LockEntry*> reserved = Reserve(key_to_intent_type);
+  // Entries are locked in the sorted order of keys, so concurrent batches could not deadlock.
   size_t idx = 0;
   for (const auto& key_and_intent_type : key_to_intent_type) {
     const auto intent_type = key_and_intent_type.second;
@@ -240,30 +241,76 @@ void SharedLockManager::Lock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Acquired a lock batch of $0 keys", key_to_intent_type.size());
 }
 
+template <class Func>
+void SharedLockManager::ForEachKeyByShard(const KeyToIntentTypeMap& batch, const Func& func) {
+  struct KeyInShard {
+    size_t shard;
+    size_t index;
+    const KeyToIntentTypeMap::value_type* key_and_intent_type;
+  };
+
+  std::vector<KeyInShard> keys;
+  keys.reserve(batch.size());
+  for (const auto& key_and_intent_type : batch) {
+    keys.push_back(KeyInShard{
+        std::hash<std::string>()(key_and_intent_type.first) % kNumShards, keys.size(),
+        &key_and_intent_type});
+  }
+  // Keys of the same shard keep their sorted order.
+  std::sort(keys.begin(), keys.end(), [](const KeyInShard& lhs, const KeyInShard& rhs) {
+    return lhs.shard < rhs.shard || (lhs.shard == rhs.shard && lhs.index < rhs.index);
+  });
+
+  auto it = keys.begin();
+  while (it != keys.end()) {
+    auto& shard = shards_[it->shard];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const size_t shard_index = it->shard;
+    for (; it != keys.end() && it->shard == shard_index; ++it) {
+      func(&shard, *it->key_and_intent_type, it->index);
+    }
+  }
+}
+
 std::vector<SharedLockManager::LockEntry*> SharedLockManager::Reserve(
     const KeyToIntentTypeMap& key_to_intent_type) {
-  std::vector<SharedLockManager::LockEntry*> reserved;
-  reserved.reserve(key_to_intent_type.size());
-  {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    for (const auto& key_and_intent_type : key_to_intent_type) {
-      auto it = locks_.emplace(key_and_intent_type.first, std::make_unique<LockEntry>()).first;
-      it->second->num_using++;
-      reserved.push_back(&*it->second);
+  std::vector<SharedLockManager::LockEntry*> reserved(key_to_intent_type.size());
+  ForEachKeyByShard(key_to_intent_type, [&reserved](
+      LockShard* shard, const KeyToIntentTypeMap::value_type& key_and_intent_type, size_t index) {
+    auto it = shard->locks.find(key_and_intent_type.first);
+    if (it == shard->locks.end()) {
+      std::unique_ptr<LockEntry> entry;
+      if (!shard->free_entries.empty()) {
+        entry = std::move(shard->free_entries.back());
+        shard->free_entries.pop_back();
+      } else {
+        entry = std::make_unique<LockEntry>();
+      }
+      it = shard->locks.emplace(key_and_intent_type.first, std::move(entry)).first;
     }
-  }
+    it->second->num_using++;
+    reserved[index] = it->second.get();
+  });
   return reserved;
 }
 
 void SharedLockManager::Unlock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Unlocking a batch of $0 keys", key_to_intent_type.size());
-  std::lock_guard<std::mutex> lock(global_mutex_);
-  for (const auto& key_and_intent_type : boost::adaptors::reverse(key_to_intent_type)) {
+  ForEachKeyByShard(key_to_intent_type, [](
+      LockShard* shard, const KeyToIntentTypeMap::value_type& key_and_intent_type, size_t index) {
     VLOG(4) << "Unlocking " << docdb::ToString(key_and_intent_type.second) << ": "
             << util::FormatBytesAsStr(key_and_intent_type.first);
-    locks_[key_and_intent_type.first]->Unlock(key_and_intent_type.second);
-  }
-  Cleanup(key_to_intent_type);
+    auto it = shard->locks.find(key_and_intent_type.first);
+    it->second->Unlock(key_and_intent_type.second);
+    // Update refcount and maybe collect garbage. Unused entry has no holders, so it could be
+    // reused for another key as is.
+    if (--it->second->num_using == 0) {
+      if (shard->free_entries.size() < kMaxFreeEntriesPerShard) {
+        shard->free_entries.push_back(std::move(it->second));
+      }
+      shard->locks.erase(it);
+    }
+  });
 }
 
 void SharedLockManager::LockInTest(const string& key, IntentType intent_type) {
@@ -274,15 +321,5 @@ void SharedLockManager::UnlockInTest(const string& key, IntentType intent_type)
   Unlock({{key, intent_type}});
 }
 
-void SharedLockManager::Cleanup(const KeyToIntentTypeMap& key_to_intent_type) {
-  for (const auto& item : key_to_intent_type) {
-    auto it = locks_.find(item.first);
-    it->second->num_using--;
-    if (it->second->num_using == 0) {
-      locks_.erase(it);
-    }
-  }
-}
-
 }  // namespace docdb
 }  // namespace yb
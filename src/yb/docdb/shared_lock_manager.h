@@ -14,6 +14,7 @@
 #ifndef YB_DOCDB_SHARED_LOCK_MANAGER_H
 #define YB_DOCDB_SHARED_LOCK_MANAGER_H
 
+#include <array>
 #include <map>
 #include <mutex>
 #include <string>
@@ -22,6 +23,7 @@
 
 #include "yb/docdb/shared_lock_manager_fwd.h"
 #include "yb/docdb/lock_batch.h"
+#include "yb/gutil/port.h"
 #include "yb/gutil/spinlock.h"
 #include "yb/util/cross_thread_mutex.h"
 
@@ -63,7 +65,7 @@ class SharedLockManager {
 
     std::condition_variable cond_var;
 
-    // Refcounting for garbage collection. Can only be used while the global lock is held.
+    // Refcounting for garbage collection. Can only be used while the shard lock is held.
     size_t num_using = 0;
 
     // Number of holders for each type
@@ -81,19 +83,34 @@ class SharedLockManager {
 
   typedef std::unordered_map<std::string, std::unique_ptr<LockEntry>> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
-  std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
+  // Lock entries are partitioned by hash of the key, so operations on unrelated keys, e.g. single
+  // row writes, do not contend on a single mutex. Shards are padded to separate cache lines.
+  struct LockShard {
+    // Taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    // Can only be modified if the shard mutex is held.
+    LockEntryMap locks;
 
-  // Update refcounts and maybe collect garbage.
-  void Cleanup(const KeyToIntentTypeMap& key_to_intent_type);
+    // Released entries kept for reuse, so locking a new key does not allocate an entry.
+    std::vector<std::unique_ptr<LockEntry>> free_entries;
+  } CACHELINE_ALIGNED;
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
+  static constexpr size_t kNumShards = 16;
+  static constexpr size_t kMaxFreeEntriesPerShard = 64;
+
+  // Invokes func(shard, key_and_intent_type, index) for each key of the batch, where index is the
+  // position of the key in the batch. Keys are grouped by shard, so each shard mutex is taken
+  // once per batch and held while func is invoked for keys of this shard.
+  template <class Func>
+  void ForEachKeyByShard(const KeyToIntentTypeMap& batch, const Func& func);
+
+  // Make sure the entries exist in the locks map and return pointers so we can access
+  // them without holding the shard lock. Returns a vector with pointers in the same order
+  // as the keys in the batch.
+  std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
 
-  // Can only be modified if the global mutex is held.
-  LockEntryMap locks_;
+  std::array<LockShard, kNumShards> shards_;
 };
 
 extern const std::array<LockState, kIntentTypeMapSize> kIntentConflicts;
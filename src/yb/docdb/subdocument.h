@@ -171,6 +171,11 @@ class SubDocument : public PrimitiveValue {
                           const std::shared_ptr<QLType>& ql_type,
                           QLValuePB* v);
 
+  // Same as ToQLValuePB, but moves string values of a primitive doc, instead of copying them.
+  static void MoveToQLValuePB(SubDocument* doc,
+                              const std::shared_ptr<QLType>& ql_type,
+                              QLValuePB* v);
+
  private:
 
   CHECKED_STATUS ConvertToCollection(ValueType value_type);
@@ -82,6 +82,9 @@ namespace docdb {
     ((kFloatDescending, 'M')) /* ASCII code 77 */ \
     ((kString, 'S'))  /* ASCII code 83 */ \
     ((kTrue, 'T'))  /* ASCII code 84 */ \
+    /* Prefix of document keys of tables that are colocated in the same tablet, followed by */ \
+    /* 16 bytes of table UUID. */ \
+    ((kTableId, 'V'))  /* ASCII code 86 */ \
     ((kTombstone, 'X'))  /* ASCII code 88 */ \
     ((kArrayIndex, '['))  /* ASCII code 91 */ \
     \
@@ -214,7 +217,7 @@ constexpr inline bool IsCollectionType(const ValueType value_type) {
 constexpr inline bool IsPrimitiveValueType(const ValueType value_type) {
   return kMinPrimitiveValueType <= value_type && value_type <= kMaxPrimitiveValueType &&
          !IsCollectionType(value_type) &&
-         value_type != ValueType::kTombstone;
+         value_type != ValueType::kTombstone && value_type != ValueType::kTableId;
 }
 
 // Decode the first byte of the given slice as a ValueType.
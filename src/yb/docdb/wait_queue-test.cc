@@ -0,0 +1,142 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include <thread>
+#include <vector>
+
+#include "yb/docdb/wait_queue.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+DECLARE_int32(wait_queue_poll_interval_ms);
+
+namespace yb {
+namespace docdb {
+
+class WaitQueueTest : public YBTest {
+ protected:
+  WaitQueue wait_queue_;
+};
+
+TEST_F(WaitQueueTest, WakeOnResolve) {
+  FLAGS_wait_queue_poll_interval_ms = 60000;
+  auto waiter = GenerateTransactionId();
+  auto blocker = GenerateTransactionId();
+  auto start = MonoTime::Now();
+  std::thread thread([this, blocker] {
+    while (wait_queue_.TEST_num_waiters() == 0) {
+      std::this_thread::sleep_for(10ms);
+    }
+    // Transaction that nobody waits for should not wake up the waiter.
+    wait_queue_.TransactionResolved(GenerateTransactionId());
+    wait_queue_.TransactionResolved(blocker);
+  });
+  ASSERT_OK(wait_queue_.Wait(waiter, {blocker}, start + 30s));
+  thread.join();
+  ASSERT_LT(MonoTime::Now() - start, MonoDelta::FromSeconds(10));
+  ASSERT_EQ(0, wait_queue_.TEST_num_waiters());
+}
+
+TEST_F(WaitQueueTest, Timeout) {
+  auto waiter = GenerateTransactionId();
+  auto blocker = GenerateTransactionId();
+  auto status = wait_queue_.Wait(waiter, {blocker}, MonoTime::Now());
+  ASSERT_TRUE(status.IsTimedOut()) << status;
+
+  // Waiter repeats Wait until deadline, when waiting for transaction resolved at another tablet.
+  FLAGS_wait_queue_poll_interval_ms = 10;
+  auto deadline = MonoTime::Now() + 100ms;
+  int waits = 0;
+  for (;;) {
+    status = wait_queue_.Wait(waiter, {blocker}, deadline);
+    if (!status.ok()) {
+      break;
+    }
+    ++waits;
+  }
+  ASSERT_TRUE(status.IsTimedOut()) << status;
+  ASSERT_GT(waits, 1);
+}
+
+TEST_F(WaitQueueTest, Deadlock) {
+  FLAGS_wait_queue_poll_interval_ms = 60000;
+  auto first = GenerateTransactionId();
+  auto second = GenerateTransactionId();
+  auto third = GenerateTransactionId();
+  std::thread thread([this, first, second] {
+    ASSERT_OK(wait_queue_.Wait(first, {second}, MonoTime::Now() + 30s));
+  });
+  std::thread thread2([this, second, third] {
+    ASSERT_OK(wait_queue_.Wait(second, {third}, MonoTime::Now() + 30s));
+  });
+  while (wait_queue_.TEST_num_waiters() != 2) {
+    std::this_thread::sleep_for(10ms);
+  }
+  auto status = wait_queue_.Wait(third, {first}, MonoTime::Now() + 30s);
+  ASSERT_TRUE(status.IsTryAgain()) << status;
+  wait_queue_.TransactionResolved(third);
+  wait_queue_.TransactionResolved(second);
+  thread.join();
+  thread2.join();
+}
+
+TEST_F(WaitQueueTest, Async) {
+  FLAGS_wait_queue_poll_interval_ms = 60000;
+  auto waiter = GenerateTransactionId();
+  auto blocker = GenerateTransactionId();
+  std::vector<Status> resumed;
+  auto resume = [&resumed](const Status& status) { resumed.push_back(status); };
+  auto start = MonoTime::Now();
+  auto wake_time = ASSERT_RESULT(wait_queue_.WaitAsync(waiter, {blocker}, start + 30s, resume));
+  ASSERT_LE(wake_time, start + 30s);
+  ASSERT_EQ(1, wait_queue_.TEST_num_waiters());
+
+  // Waiter is resumed once when its blocker is resolved, without blocking the caller.
+  wait_queue_.TransactionResolved(GenerateTransactionId());
+  ASSERT_TRUE(resumed.empty());
+  wait_queue_.TransactionResolved(blocker);
+  ASSERT_EQ(1, resumed.size());
+  ASSERT_OK(resumed[0]);
+  ASSERT_EQ(0, wait_queue_.TEST_num_waiters());
+  wait_queue_.TransactionResolved(blocker);
+  ASSERT_EQ(1, resumed.size());
+
+  // Waiter is resumed by poll after its wake time, in case blocker was resolved elsewhere.
+  wake_time = ASSERT_RESULT(wait_queue_.WaitAsync(waiter, {blocker}, start + 30s, resume));
+  wait_queue_.Poll(wake_time - 1ms);
+  ASSERT_EQ(1, resumed.size());
+  wait_queue_.Poll(wake_time);
+  ASSERT_EQ(2, resumed.size());
+  ASSERT_OK(resumed[1]);
+
+  // Deadlock is detected with asynchronous waiters as well.
+  ASSERT_OK(wait_queue_.WaitAsync(waiter, {blocker}, start + 30s, resume));
+  auto status = wait_queue_.WaitAsync(blocker, {waiter}, start + 30s, resume).status();
+  ASSERT_TRUE(status.IsTryAgain()) << status;
+
+  // Shutdown resumes remaining waiters with an error and rejects new ones.
+  wait_queue_.Shutdown();
+  ASSERT_EQ(3, resumed.size());
+  ASSERT_TRUE(resumed[2].IsAborted()) << resumed[2];
+  ASSERT_EQ(0, wait_queue_.TEST_num_waiters());
+  status = wait_queue_.WaitAsync(waiter, {blocker}, start + 30s, resume).status();
+  ASSERT_TRUE(status.IsAborted()) << status;
+  ASSERT_EQ(3, resumed.size());
+}
+
+} // namespace docdb
+} // namespace yb
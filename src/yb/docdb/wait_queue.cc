@@ -0,0 +1,168 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/docdb/wait_queue.h"
+
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(wait_queue_poll_interval_ms, 100,
+             "Max time that a waiting transaction sleeps before checking status of conflicting "
+             "transactions again, in case they were resolved at other tablets.");
+TAG_FLAG(wait_queue_poll_interval_ms, advanced);
+TAG_FLAG(wait_queue_poll_interval_ms, runtime);
+
+namespace yb {
+namespace docdb {
+
+Result<WaitQueue::Waiters::iterator> WaitQueue::AddWaiterUnlocked(
+    const TransactionId& waiter, const TransactionIdSet& blockers, MonoTime deadline) {
+  auto now = MonoTime::Now();
+  if (now >= deadline) {
+    return STATUS(TimedOut, "Wait for conflicting transactions timed out");
+  }
+  if (shutdown_) {
+    return STATUS(Aborted, "Wait queue is shutting down");
+  }
+
+  for (const auto& blocker : blockers) {
+    TransactionIdSet visited;
+    if (blocker == waiter || WaitsForUnlocked(blocker, waiter, &visited)) {
+      return STATUS_FORMAT(TryAgain, "Deadlock detected, $0 waits for $1", blocker, waiter);
+    }
+  }
+
+  auto entry = std::make_shared<Waiter>();
+  entry->id = waiter;
+  entry->blockers = blockers;
+  entry->wake_time = std::min(
+      deadline, now + MonoDelta::FromMilliseconds(FLAGS_wait_queue_poll_interval_ms));
+  waiters_.push_back(std::move(entry));
+  return --waiters_.end();
+}
+
+Status WaitQueue::Wait(const TransactionId& waiter,
+                       const TransactionIdSet& blockers,
+                       MonoTime deadline) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = VERIFY_RESULT(AddWaiterUnlocked(waiter, blockers, deadline));
+  auto entry = *it;
+  cond_.wait_until(
+      lock, entry->wake_time.ToSteadyTimePoint(), [&entry] { return entry->resolved; });
+  waiters_.erase(it);
+  return Status::OK();
+}
+
+Result<MonoTime> WaitQueue::WaitAsync(const TransactionId& waiter,
+                                      const TransactionIdSet& blockers,
+                                      MonoTime deadline,
+                                      ResumeCallback resume) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = VERIFY_RESULT(AddWaiterUnlocked(waiter, blockers, deadline));
+  (**it).resume = std::move(resume);
+  return (**it).wake_time;
+}
+
+void WaitQueue::Poll(MonoTime now) {
+  std::vector<ResumeCallback> resumes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = waiters_.begin(); it != waiters_.end();) {
+      if ((**it).resume && (**it).wake_time <= now) {
+        resumes.push_back(std::move((**it).resume));
+        it = waiters_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (const auto& resume : resumes) {
+    resume(Status::OK());
+  }
+}
+
+void WaitQueue::Shutdown() {
+  std::vector<ResumeCallback> resumes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+    for (auto it = waiters_.begin(); it != waiters_.end();) {
+      if ((**it).resume) {
+        resumes.push_back(std::move((**it).resume));
+        it = waiters_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (const auto& resume : resumes) {
+    resume(STATUS(Aborted, "Wait queue is shutting down"));
+  }
+}
+
+void WaitQueue::TransactionResolved(const TransactionId& id) {
+  bool notify = false;
+  std::vector<ResumeCallback> resumes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = waiters_.begin(); it != waiters_.end();) {
+      auto& waiter = **it;
+      if (waiter.resolved || !waiter.blockers.count(id)) {
+        ++it;
+      } else if (waiter.resume) {
+        resumes.push_back(std::move(waiter.resume));
+        it = waiters_.erase(it);
+      } else {
+        waiter.resolved = true;
+        notify = true;
+        ++it;
+      }
+    }
+  }
+  if (notify) {
+    cond_.notify_all();
+  }
+  for (const auto& resume : resumes) {
+    resume(Status::OK());
+  }
+}
+
+size_t WaitQueue::TEST_num_waiters() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return waiters_.size();
+}
+
+bool WaitQueue::WaitsForUnlocked(const TransactionId& from, const TransactionId& to,
+                                 TransactionIdSet* visited) const {
+  if (!visited->insert(from).second) {
+    return false;
+  }
+  for (const auto& waiter : waiters_) {
+    if (waiter->id != from) {
+      continue;
+    }
+    for (const auto& blocker : waiter->blockers) {
+      if (blocker == to || WaitsForUnlocked(blocker, to, visited)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace docdb
+} // namespace yb
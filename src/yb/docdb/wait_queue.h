@@ -0,0 +1,111 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_DOCDB_WAIT_QUEUE_H
+#define YB_DOCDB_WAIT_QUEUE_H
+
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "yb/common/transaction.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+// Keeps transactions of a tablet that wait for conflicting transactions to be resolved, instead
+// of failing their writes because of the conflict.
+//
+// A waiter registers wait-for edges to its blockers and is woken when any of them is committed
+// or aborted at this tablet. Since a transaction could wait only for transactions with higher
+// priority, there could not be a cycle of waiting transactions while priorities are distinct.
+// Cycles are still checked for, and waiting is limited by a deadline, that also bounds waiting
+// for transactions resolved at other tablets.
+class WaitQueue {
+ public:
+  typedef std::function<void(const Status&)> ResumeCallback;
+
+  WaitQueue() = default;
+
+  WaitQueue(const WaitQueue&) = delete;
+  void operator=(const WaitQueue&) = delete;
+
+  // Blocks until one of the blockers is resolved or wait_queue_poll_interval_ms passes, after
+  // that the waiter should resolve conflicts again.
+  // Returns TimedOut when deadline has passed, and TryAgain when waiting would result in a cycle
+  // of waiting transactions.
+  CHECKED_STATUS Wait(const TransactionId& waiter,
+                      const TransactionIdSet& blockers,
+                      MonoTime deadline);
+
+  // Asynchronous version of Wait, that registers the waiter and returns immediately.
+  // resume is invoked exactly once: with OK status when one of the blockers is resolved or Poll
+  // finds that the waiter should check its blockers again, and with error status on Shutdown.
+  // Since resume could be invoked under locks held by the caller of TransactionResolved, it
+  // should only schedule the actual work.
+  // Returns time when Poll should be invoked for this waiter. Returns the same errors as Wait,
+  // in which case resume is not invoked.
+  Result<MonoTime> WaitAsync(const TransactionId& waiter,
+                             const TransactionIdSet& blockers,
+                             MonoTime deadline,
+                             ResumeCallback resume);
+
+  // Resumes asynchronous waiters whose wake time has passed.
+  void Poll(MonoTime now);
+
+  // Resumes all asynchronous waiters with an error and rejects new ones.
+  void Shutdown();
+
+  // Wakes up transactions that wait for the specified transaction.
+  void TransactionResolved(const TransactionId& id);
+
+  size_t TEST_num_waiters() const;
+
+ private:
+  struct Waiter {
+    TransactionId id;
+    TransactionIdSet blockers;
+    bool resolved = false;
+    // Set only for waiters registered by WaitAsync.
+    ResumeCallback resume;
+    MonoTime wake_time;
+  };
+
+  typedef std::list<std::shared_ptr<Waiter>> Waiters;
+
+  // Checks deadline and cycles of waiting transactions, then registers the waiter.
+  Result<Waiters::iterator> AddWaiterUnlocked(const TransactionId& waiter,
+                                              const TransactionIdSet& blockers,
+                                              MonoTime deadline);
+
+  // Whether transaction from waits for transaction to, directly or through other waiters.
+  bool WaitsForUnlocked(const TransactionId& from, const TransactionId& to,
+                        TransactionIdSet* visited) const;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  Waiters waiters_;
+  bool shutdown_ = false;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_WAIT_QUEUE_H
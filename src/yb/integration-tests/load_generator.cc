@@ -13,9 +13,12 @@
 
 #include "yb/integration-tests/load_generator.h"
 
+#include <cmath>
+#include <iostream>
 #include <memory>
 #include <queue>
 #include <random>
+#include <sstream>
 #include <thread>
 
 #include <gflags/gflags_declare.h>
@@ -32,6 +35,7 @@
 #include "yb/util/atomic.h"
 #include "yb/util/env.h"
 #include "yb/util/flags.h"
+#include "yb/util/jsonwriter.h"
 #include "yb/util/logging.h"
 #include "yb/util/net/sockaddr.h"
 #include "yb/util/stopwatch.h"
@@ -85,8 +89,34 @@ DEFINE_int32(load_gen_wait_time_increment_step_ms,
              "In retry loops used in the load test we increment the wait time by this number of "
              "milliseconds after every attempt.");
 
+DEFINE_double(load_gen_zipfian_theta, 0.99,
+              "Skew of the zipfian and latest key distributions, should be in (0, 1).");
+
+DEFINE_double(load_gen_hotspot_keys_fraction, 0.2,
+              "Fraction of keys that form the hot set of the hotspot key distribution.");
+
+DEFINE_double(load_gen_hotspot_ops_fraction, 0.8,
+              "Fraction of operations that access the hot set of the hotspot key distribution.");
+
+DEFINE_bool(load_gen_stats_json, false,
+            "Periodically print stats of writers and readers to stdout as JSON objects, one per "
+            "line, instead of logging them.");
+
 namespace {
 
+// Latency above this value is recorded as this value.
+constexpr int64_t kMaxLatencyUs = 60 * 1000 * 1000;
+
+// Spreads zipfian ranks over the key space, so popular keys are not adjacent.
+uint64_t ScrambleRank(uint64_t rank) {
+  rank ^= rank >> 33;
+  rank *= 0xff51afd7ed558ccdULL;
+  rank ^= rank >> 33;
+  rank *= 0xc4ceb9fe1a85ec53ULL;
+  rank ^= rank >> 33;
+  return rank;
+}
+
 void ConfigureYBSession(YBSession* session) {
   CHECK_OK(session->SetFlushMode(YBSession::FlushMode::MANUAL_FLUSH));
   session->SetTimeout(60s);
@@ -107,6 +137,100 @@ string FormatHexForLoadTestKey(uint64_t x) {
   return buf;
 }
 
+Result<KeyDistribution> ParseKeyDistribution(const std::string& name) {
+  for (auto distribution : kKeyDistributionList) {
+    if (strcasecmp(name.c_str(), ToCString(distribution) + 1) == 0) {
+      return distribution;
+    }
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown key distribution: $0", name);
+}
+
+// ------------------------------------------------------------------------------------------------
+// KeyIndexGenerator
+// ------------------------------------------------------------------------------------------------
+
+KeyIndexGenerator::KeyIndexGenerator(KeyDistribution distribution, uint64_t seed)
+    : distribution_(distribution),
+      random_number_generator_(seed),
+      theta_(FLAGS_load_gen_zipfian_theta),
+      zeta2_(1 + std::pow(0.5, theta_)) {
+  if (distribution_ == KeyDistribution::kZipfian || distribution_ == KeyDistribution::kLatest) {
+    CHECK(theta_ > 0 && theta_ < 1) << "Invalid zipfian theta: " << theta_;
+  }
+}
+
+int64_t KeyIndexGenerator::Next(int64_t num_keys) {
+  DCHECK_GT(num_keys, 0);
+  switch (distribution_) {
+    case KeyDistribution::kDefault: FALLTHROUGH_INTENDED;
+    case KeyDistribution::kUniform:
+      return std::uniform_int_distribution<int64_t>(0, num_keys - 1)(random_number_generator_);
+    case KeyDistribution::kZipfian:
+      return ScrambleRank(NextZipfianRank(num_keys)) % num_keys;
+    case KeyDistribution::kHotspot: {
+      const int64_t hot_keys = std::max<int64_t>(
+          1, std::min<double>(num_keys, num_keys * FLAGS_load_gen_hotspot_keys_fraction));
+      const bool hot = hot_keys == num_keys ||
+          std::uniform_real_distribution<double>()(random_number_generator_) <
+              FLAGS_load_gen_hotspot_ops_fraction;
+      return hot
+          ? std::uniform_int_distribution<int64_t>(0, hot_keys - 1)(random_number_generator_)
+          : std::uniform_int_distribution<int64_t>(hot_keys, num_keys - 1)(
+                random_number_generator_);
+    }
+    case KeyDistribution::kLatest:
+      return num_keys - 1 - NextZipfianRank(num_keys);
+  }
+  FATAL_INVALID_ENUM_VALUE(KeyDistribution, distribution_);
+}
+
+// Algorithm from "Quickly Generating Billion-Record Synthetic Databases" by Gray et al.
+int64_t KeyIndexGenerator::NextZipfianRank(int64_t num_keys) {
+  if (num_keys == 1) {
+    return 0;
+  }
+  for (; zeta_num_keys_ < num_keys; ++zeta_num_keys_) {
+    zeta_ += 1 / std::pow(zeta_num_keys_ + 1, theta_);
+  }
+  const double alpha = 1 / (1 - theta_);
+  const double eta = (1 - std::pow(2.0 / num_keys, 1 - theta_)) / (1 - zeta2_ / zeta_);
+  const double u = std::uniform_real_distribution<double>()(random_number_generator_);
+  const double uz = u * zeta_;
+  if (uz < 1) {
+    return 0;
+  }
+  if (uz < zeta2_) {
+    return 1;
+  }
+  return std::min<int64_t>(
+      num_keys - 1, static_cast<int64_t>(num_keys * std::pow(eta * u - eta + 1, alpha)));
+}
+
+// ------------------------------------------------------------------------------------------------
+// OperationScheduler
+// ------------------------------------------------------------------------------------------------
+
+OperationScheduler::OperationScheduler(double ops_per_sec, uint64_t seed)
+    : random_number_generator_(seed),
+      interval_us_(ops_per_sec > 0 ? ops_per_sec / MonoTime::kMicrosecondsPerSecond : 1),
+      open_loop_(ops_per_sec > 0),
+      next_start_(MonoTime::Now()) {}
+
+MonoTime OperationScheduler::WaitForNextOperation() {
+  if (!open_loop_) {
+    return MonoTime::Now();
+  }
+  const MonoTime start = next_start_;
+  next_start_ += MonoDelta::FromNanoseconds(
+      static_cast<int64_t>(interval_us_(random_number_generator_) * 1000));
+  const MonoTime now = MonoTime::Now();
+  if (now < start) {
+    SleepFor(start - now);
+  }
+  return start;
+}
+
 int KeyIndexSet::NumElements() const {
   MutexLock l(mutex_);
   return set_.size();
@@ -214,7 +338,8 @@ MultiThreadedAction::MultiThreadedAction(
       client_id_(client_id),
       running_threads_latch_(num_action_threads),
       stop_requested_(stop_requested_flag),
-      value_size_(value_size) {
+      value_size_(value_size),
+      latency_histogram_(kMaxLatencyUs, 3) {
   CHECK_OK(
       ThreadPoolBuilder(description)
           .set_max_threads(num_action_threads_ + num_extra_threads)
@@ -245,6 +370,58 @@ string MultiThreadedAction::GetValueByIndex(int64_t key_index) {
   return value;
 }
 
+OperationScheduler MultiThreadedAction::CreateScheduler(int action_index) const {
+  return OperationScheduler(target_ops_per_sec_ / num_action_threads_, action_index);
+}
+
+void MultiThreadedAction::RecordLatency(MonoTime intended_start) {
+  latency_histogram_.Increment(
+      std::min((MonoTime::Now() - intended_start).ToMicroseconds(), kMaxLatencyUs));
+}
+
+void MultiThreadedAction::LogStats(int64_t num_ops, double ops_per_sec, int64_t num_errors) {
+  if (!FLAGS_load_gen_stats_json) {
+    LOG(INFO) << description_ << " latency (us): p50: " << latency_histogram_.ValueAtPercentile(50)
+              << ", p99: " << latency_histogram_.ValueAtPercentile(99)
+              << ", p99.9: " << latency_histogram_.ValueAtPercentile(99.9)
+              << ", max: " << latency_histogram_.MaxValue();
+    return;
+  }
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::COMPACT);
+  writer.StartObject();
+  writer.String("action");
+  writer.String(description_);
+  writer.String("client_id");
+  writer.String(client_id_);
+  writer.String("timestamp_us");
+  writer.Int64(GetCurrentTimeMicros());
+  writer.String("ops");
+  writer.Int64(num_ops);
+  writer.String("ops_per_sec");
+  writer.Double(ops_per_sec);
+  writer.String("target_ops_per_sec");
+  writer.Double(target_ops_per_sec_);
+  writer.String("errors");
+  writer.Int64(num_errors);
+  writer.String("latency_us");
+  writer.StartObject();
+  writer.String("count");
+  writer.Uint64(latency_histogram_.TotalCount());
+  writer.String("mean");
+  writer.Double(latency_histogram_.MeanValue());
+  for (const auto& percentile : { std::make_pair("p50", 50.0), std::make_pair("p90", 90.0),
+                                  std::make_pair("p99", 99.0), std::make_pair("p999", 99.9) }) {
+    writer.String(percentile.first);
+    writer.Uint64(latency_histogram_.ValueAtPercentile(percentile.second));
+  }
+  writer.String("max");
+  writer.Uint64(latency_histogram_.MaxValue());
+  writer.EndObject();
+  writer.EndObject();
+  std::cout << out.str() << std::endl;
+}
+
 void MultiThreadedAction::Start() {
   LOG(INFO) << "Starting " << num_action_threads_ << " " << description_ << " threads";
   CHECK_OK(thread_pool_->SubmitFunc(std::bind(&MultiThreadedAction::RunStatsThread, this)));
@@ -295,11 +472,13 @@ void MultiThreadedWriter::RunActionThread(int writer_index) {
 void SingleThreadedWriter::Run() {
   LOG(INFO) << "Writer thread " << writer_index_ << " started";
   ConfigureSession();
+  auto scheduler = multi_threaded_writer_->CreateScheduler(writer_index_);
   while (!multi_threaded_writer_->IsStopRequested()) {
     if (pause_flag_ && pause_flag_->load(std::memory_order_acquire)) {
       std::this_thread::sleep_for(10ms);
       continue;
     }
+    const MonoTime intended_start = scheduler.WaitForNextOperation();
     int64_t key_index = multi_threaded_writer_->next_key_++;
     if (key_index >= multi_threaded_writer_->num_keys_) {
       break;
@@ -308,7 +487,9 @@ void SingleThreadedWriter::Run() {
     string key_str(multi_threaded_writer_->GetKeyByIndex(key_index));
     string value_str(multi_threaded_writer_->GetValueByIndex(key_index));
 
-    if (Write(key_index, key_str, value_str)) {
+    const bool success = Write(key_index, key_str, value_str);
+    multi_threaded_writer_->RecordLatency(intended_start);
+    if (success) {
       multi_threaded_writer_->inserted_keys_.Insert(key_index);
     } else {
       multi_threaded_writer_->failed_keys_.Insert(key_index);
@@ -450,10 +631,14 @@ void MultiThreadedWriter::RunStatsThread() {
     running_threads_latch_.WaitFor(MonoDelta::FromSeconds(5));
     int64_t num_writes = this->num_writes();
     MicrosecondsInt64 current_time = GetMonoTimeMicros();
-    LOG(INFO) << "Wrote " << num_writes << " rows ("
-              << (num_writes - prev_writes) * 1000000.0 / (current_time - prev_time)
-              << " writes/sec), contiguous insertion point: " << inserted_up_to_inclusive_.load()
-              << ", write errors: " << failed_keys_.NumElements();
+    const double writes_per_sec =
+        (num_writes - prev_writes) * 1000000.0 / (current_time - prev_time);
+    if (!FLAGS_load_gen_stats_json) {
+      LOG(INFO) << "Wrote " << num_writes << " rows (" << writes_per_sec
+                << " writes/sec), contiguous insertion point: " << inserted_up_to_inclusive_.load()
+                << ", write errors: " << failed_keys_.NumElements();
+    }
+    LogStats(num_writes, writes_per_sec, failed_keys_.NumElements());
     prev_writes = num_writes;
     prev_time = current_time;
   }
@@ -524,9 +709,13 @@ void MultiThreadedReader::RunStatsThread() {
     running_threads_latch_.WaitFor(MonoDelta::FromSeconds(5));
     MicrosecondsInt64 current_time = GetMonoTimeMicros();
     int64_t num_rows_read = num_reads_.load();
-    LOG(INFO) << "Read " << num_rows_read << " rows ("
-              << (num_rows_read - prev_rows_read) * 1000000.0 / (current_time - prev_time)
-              << " reads/sec), read errors: " << num_read_errors_.load();
+    const double reads_per_sec =
+        (num_rows_read - prev_rows_read) * 1000000.0 / (current_time - prev_time);
+    if (!FLAGS_load_gen_stats_json) {
+      LOG(INFO) << "Read " << num_rows_read << " rows (" << reads_per_sec
+                << " reads/sec), read errors: " << num_read_errors_.load();
+    }
+    LogStats(num_rows_read, reads_per_sec, num_read_errors_.load());
     prev_rows_read = num_rows_read;
     prev_time = current_time;
   }
@@ -661,7 +850,7 @@ ReadStatus RedisSingleThreadedReader::PerformRead(
 }
 
 void SingleThreadedReader::Run() {
-  std::mt19937_64 random_number_generator(reader_index_);
+  KeyIndexGenerator key_index_generator(multi_threaded_reader_->key_distribution_, reader_index_);
 
   LOG(INFO) << "Reader thread " << reader_index_ << " started";
   ConfigureSession();
@@ -673,13 +862,16 @@ void SingleThreadedReader::Run() {
     SleepFor(MonoDelta::FromMilliseconds(10));
   }
 
+  auto scheduler = multi_threaded_reader_->CreateScheduler(reader_index_);
   while (!multi_threaded_reader_->IsStopRequested()) {
-    const int64_t key_index = NextKeyIndexToRead(&random_number_generator);
+    const MonoTime intended_start = scheduler.WaitForNextOperation();
+    const int64_t key_index = NextKeyIndexToRead(&key_index_generator);
 
     ++multi_threaded_reader_->num_reads_;
     const string key_str(multi_threaded_reader_->GetKeyByIndex(key_index));
     const string expected_value_str(multi_threaded_reader_->GetValueByIndex(key_index));
     const ReadStatus read_status = PerformRead(key_index, key_str, expected_value_str);
+    multi_threaded_reader_->RecordLatency(intended_start);
 
     // Read operation returning zero rows is treated as a read error.
     // See: https://yugabyte.atlassian.net/browse/ENG-1272
@@ -691,11 +883,16 @@ void SingleThreadedReader::Run() {
   CloseSession();
 }
 
-int64_t SingleThreadedReader::NextKeyIndexToRead(std::mt19937_64* random_number_generator) const {
+int64_t SingleThreadedReader::NextKeyIndexToRead(KeyIndexGenerator* key_index_generator) const {
+  auto* random_number_generator = key_index_generator->random_number_generator();
   int64_t key_index = 0;
   VLOG(3) << "Reader thread " << reader_index_ << " waiting to load insertion point";
   int64_t written_up_to = multi_threaded_reader_->insertion_point_->load();
   do {
+    if (multi_threaded_reader_->key_distribution_ != KeyDistribution::kDefault) {
+      key_index = key_index_generator->Next(written_up_to + 1);
+      continue;
+    }
     VLOG(3) << "Reader thread " << reader_index_ << " coin toss";
     switch ((*random_number_generator)() % 3) {
       case 0:
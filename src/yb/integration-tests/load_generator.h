@@ -28,6 +28,10 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/enums.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
 #include "yb/util/test_util.h"
 
 using std::shared_ptr;
@@ -45,6 +49,59 @@ class MultiThreadedWriter;
 
 std::string FormatHexForLoadTestKey(uint64_t x);
 
+// Distribution of keys picked by readers. kDefault mixes the latest inserted key, recently inserted
+// keys and uniformly chosen keys. kZipfian picks keys by popularity with hot keys scattered over
+// the key space, kHotspot sends a fixed fraction of operations to a fixed fraction of keys, and
+// kLatest favors recently inserted keys with zipfian popularity.
+YB_DEFINE_ENUM(KeyDistribution, (kDefault)(kUniform)(kZipfian)(kHotspot)(kLatest));
+
+// Parses the key distribution name without the "k" prefix, case insensitive, e.g. "zipfian".
+Result<KeyDistribution> ParseKeyDistribution(const std::string& name);
+
+// Generates indexes of keys to access according to the key distribution. Not thread safe, every
+// thread should use its own generator.
+class KeyIndexGenerator {
+ public:
+  KeyIndexGenerator(KeyDistribution distribution, uint64_t seed);
+
+  // Returns a key index in [0, num_keys). num_keys could grow between calls, but should not
+  // shrink.
+  int64_t Next(int64_t num_keys);
+
+  std::mt19937_64* random_number_generator() { return &random_number_generator_; }
+
+ private:
+  // Returns zipfian distributed rank in [0, num_keys), where lower ranks are more popular.
+  int64_t NextZipfianRank(int64_t num_keys);
+
+  const KeyDistribution distribution_;
+  std::mt19937_64 random_number_generator_;
+
+  // Zipfian state, zeta is extended incrementally when the number of keys grows.
+  const double theta_;
+  const double zeta2_;
+  int64_t zeta_num_keys_ = 0;
+  double zeta_ = 0;
+};
+
+// Schedules operations of a single thread. With zero rate operations are issued back to back,
+// i.e. closed loop. Otherwise operations arrive as a Poisson process with the specified mean rate,
+// and the schedule does not depend on how long operations take, i.e. open loop. So latency
+// measured from the intended start time includes queueing delay that a closed loop hides.
+class OperationScheduler {
+ public:
+  OperationScheduler(double ops_per_sec, uint64_t seed);
+
+  // Waits until the next operation should be started and returns its intended start time.
+  MonoTime WaitForNextOperation();
+
+ private:
+  std::mt19937_64 random_number_generator_;
+  std::exponential_distribution<double> interval_us_;
+  const bool open_loop_;
+  MonoTime next_start_;
+};
+
 class KeyIndexSet {
  public:
   int NumElements() const;
@@ -126,6 +183,12 @@ class MultiThreadedAction {
   void set_client_id(const std::string& client_id) { client_id_ = client_id; }
   bool IsRunning() { return running_threads_latch_.count() > 0; }
 
+  // Target rate of all action threads together, 0 means that each thread runs closed loop.
+  void set_target_ops_per_sec(double value) { target_ops_per_sec_ = value; }
+
+  // Latency of operations in microseconds, measured from their intended start time.
+  const HdrHistogram& latency_histogram() const { return latency_histogram_; }
+
  protected:
   friend class SingleThreadedReader;
   friend class SingleThreadedWriter;
@@ -139,6 +202,14 @@ class MultiThreadedAction {
   virtual void RunActionThread(int actionIndex) = 0;
   virtual void RunStatsThread() = 0;
 
+  // Creates scheduler of operations for the action thread with the specified index.
+  OperationScheduler CreateScheduler(int action_index) const;
+
+  void RecordLatency(MonoTime intended_start);
+
+  // Logs stats of this action, as a JSON object when load_gen_stats_json is set.
+  void LogStats(int64_t num_ops, double ops_per_sec, int64_t num_errors);
+
   std::string description_;
   const int64_t num_keys_;  // Total number of keys in the table after successful end of this action
   const int64_t start_key_;  // First insertion key index of the write action
@@ -152,6 +223,9 @@ class MultiThreadedAction {
   std::atomic<bool> paused_ { false };
 
   const int value_size_;
+
+  double target_ops_per_sec_ = 0;
+  HdrHistogram latency_histogram_;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -312,6 +386,7 @@ class MultiThreadedReader : public MultiThreadedAction {
   void IncrementReadErrorCount(ReadStatus read_status);
 
   int64_t num_reads() { return num_reads_; }
+  void set_key_distribution(KeyDistribution value) { key_distribution_ = value; }
   int64_t num_read_errors() { return num_read_errors_.load(); }
   void AssertSucceeded() { ASSERT_EQ(num_read_errors(), 0); }
 
@@ -332,6 +407,7 @@ class MultiThreadedReader : public MultiThreadedAction {
   std::atomic<int64_t> num_read_errors_;
   const int max_num_read_errors_;
   const bool stop_on_empty_read_;
+  KeyDistribution key_distribution_ = KeyDistribution::kDefault;
 };
 
 class SingleThreadedReader {
@@ -352,7 +428,7 @@ class SingleThreadedReader {
   virtual void ConfigureSession() = 0;
   virtual void CloseSession() = 0;
 
-  int64_t NextKeyIndexToRead(std::mt19937_64* random_number_generator) const;
+  int64_t NextKeyIndexToRead(KeyIndexGenerator* key_index_generator) const;
 };
 
 class YBSingleThreadedReader : public SingleThreadedReader {
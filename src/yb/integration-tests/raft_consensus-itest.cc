@@ -504,6 +504,16 @@ TEST_F(RaftConsensusITest, TestInsertAndMutateThroughConsensus) {
   ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread * num_iters);
 }
 
+TEST_F(RaftConsensusITest, TestInsertWithMultiRaftHeartbeats) {
+  ASSERT_NO_FATALS(BuildAndStart({"--enable_multi_raft_heartbeat_batcher=true"s}));
+
+  InsertTestRowsRemoteThread(0,
+                             FLAGS_client_inserts_per_thread,
+                             FLAGS_client_num_batches_per_thread,
+                             vector<CountDownLatch*>());
+  ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread);
+}
+
 TEST_F(RaftConsensusITest, TestFailedOperation) {
   ASSERT_NO_FATALS(BuildAndStart(vector<string>()));
 
@@ -2659,6 +2669,44 @@ TEST_F(RaftConsensusITest, TestUpdateConsensusErrorNonePrepared) {
   ASSERT_STR_CONTAINS(resp.ShortDebugString(), "Could not prepare a single operation");
 }
 
+// Checks that each request of MultiUpdateConsensus gets its own response, and that errors of
+// one request do not affect the others.
+TEST_F(RaftConsensusITest, TestMultiUpdateConsensus) {
+  ASSERT_NO_FATALS(BuildAndStart(vector<string>()));
+  ASSERT_OK(WaitForServersToAgree(MonoDelta::FromSeconds(10), tablet_servers_, tablet_id_, 1));
+
+  TServerDetails* replica_ts = TServerDetailsVector(tablet_servers_)[0];
+
+  consensus::MultiConsensusRequestPB req;
+  auto add_request = [&req](const string& dest_uuid, const string& tablet_id) {
+    auto* consensus_req = req.add_consensus_request();
+    consensus_req->set_dest_uuid(dest_uuid);
+    consensus_req->set_tablet_id(tablet_id);
+    consensus_req->set_caller_uuid("fake_caller");
+    // Stale term, so the request is rejected by consensus without changing its state.
+    consensus_req->set_caller_term(0);
+    consensus_req->mutable_committed_index()->CopyFrom(MakeOpId(0, 0));
+    consensus_req->mutable_preceding_id()->CopyFrom(MakeOpId(0, 0));
+  };
+  add_request(replica_ts->uuid(), "no_such_tablet");
+  add_request("wrong_uuid", tablet_id_);
+  add_request(replica_ts->uuid(), tablet_id_);
+
+  consensus::MultiConsensusResponsePB resp;
+  RpcController rpc;
+  rpc.set_timeout(MonoDelta::FromSeconds(10));
+  ASSERT_OK(replica_ts->consensus_proxy->MultiUpdateConsensus(req, &resp, &rpc));
+  LOG(INFO) << resp.ShortDebugString();
+
+  ASSERT_EQ(3, resp.consensus_response_size());
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, resp.consensus_response(0).error().code());
+  ASSERT_EQ(TabletServerErrorPB::WRONG_SERVER_UUID, resp.consensus_response(1).error().code());
+  const auto& valid_resp = resp.consensus_response(2);
+  ASSERT_FALSE(valid_resp.has_error()) << valid_resp.ShortDebugString();
+  ASSERT_GE(valid_resp.responder_term(), 1);
+  ASSERT_EQ(consensus::ConsensusErrorPB::INVALID_TERM, valid_resp.status().error().code());
+}
+
 TEST_F(RaftConsensusITest, TestRemoveTserverFailsWhenVoterInTransition) {
   TestRemoveTserverFailsWhenServerInTransition(RaftPeerPB::PRE_VOTER);
 }
@@ -0,0 +1,229 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <thread>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/client/table_handle.h"
+#include "yb/client/yb_op.h"
+#include "yb/consensus/consensus.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/integration-tests/mini_cluster.h"
+#include "yb/integration-tests/yb_table_test_base.h"
+#include "yb/rpc/messenger.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
+#include "yb/tablet/tablet_peer.h"
+#include "yb/tserver/mini_tablet_server.h"
+#include "yb/tserver/tablet_server.h"
+#include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+using namespace yb::size_literals;
+
+DEFINE_int32(raft_bench_num_peers, 3,
+             "Number of tablet servers, and Raft peers of the benchmarked tablet.");
+DEFINE_string(raft_bench_batch_sizes, "1,16,128",
+              "Comma separated numbers of rows written by each write request, swept by the "
+              "benchmark.");
+DEFINE_string(raft_bench_in_flight_requests, "1,4",
+              "Comma separated values of consensus_max_in_flight_requests_per_peer, swept by the "
+              "benchmark.");
+DEFINE_int32(raft_bench_writer_threads, 8, "Number of threads writing to the tablet.");
+DEFINE_int32(raft_bench_value_size, 64, "Size of each written value in bytes.");
+DEFINE_int32(raft_bench_duration_ms, 5000, "Time in milliseconds each configuration is measured.");
+DEFINE_int32(raft_bench_link_latency_us, 1000,
+             "One-way latency in microseconds injected between tablet servers.");
+DEFINE_int32(raft_bench_link_jitter_us, 200,
+             "Max random jitter in microseconds added to the latency between tablet servers.");
+DEFINE_int32(raft_bench_link_bandwidth_mb_per_sec, 0,
+             "Bandwidth of each link between tablet servers in MB/s, 0 means unlimited.");
+DEFINE_double(raft_bench_link_loss_percent, 0,
+              "Percent of RPC calls between tablet servers that are lost.");
+
+DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_int32(consensus_max_in_flight_requests_per_peer);
+DECLARE_int32(replication_factor);
+
+namespace yb {
+namespace integration_tests {
+
+namespace {
+
+std::vector<int> ParseSweepFlag(const std::string& name, const std::string& value) {
+  std::vector<int> result;
+  std::vector<std::string> values = strings::Split(value, ",", strings::SkipEmpty());
+  for (const auto& str : values) {
+    int number = 0;
+    CHECK(safe_strto32(str, &number) && number > 0) << "Invalid value " << str << " in --" << name;
+    result.push_back(number);
+  }
+  return result;
+}
+
+struct BenchResult {
+  double rows_per_sec;
+  double writes_per_sec;
+  uint64_t p50_us;
+  uint64_t p99_us;
+  // Mean time from prepare to Raft replication of writes on the leader.
+  double replicate_mean_us;
+};
+
+} // namespace
+
+// Measures Raft replication throughput and commit latency of a single tablet, with latency,
+// jitter, bandwidth limit and loss injected into RPC links between tablet servers.
+class RaftReplicationBench : public YBTableTestBase {
+ protected:
+  bool use_external_mini_cluster() override { return false; }
+
+  int num_tablet_servers() override { return FLAGS_raft_bench_num_peers; }
+
+  int num_tablets() override { return 1; }
+
+  bool need_redis_table() override { return false; }
+
+  void CreateTable() override {
+    // MiniCluster limits the replication factor to 3, so it is set for the benchmarked table here.
+    FLAGS_replication_factor = num_tablet_servers();
+    YBTableTestBase::CreateTable();
+  }
+
+  void SetLinkConditions() {
+    rpc::LinkConditions conditions;
+    conditions.latency = MonoDelta::FromMicroseconds(FLAGS_raft_bench_link_latency_us);
+    conditions.jitter = MonoDelta::FromMicroseconds(FLAGS_raft_bench_link_jitter_us);
+    conditions.bandwidth_bytes_per_sec = FLAGS_raft_bench_link_bandwidth_mb_per_sec * 1_MB;
+    conditions.loss_probability = FLAGS_raft_bench_link_loss_percent / 100;
+    for (int i = 0; i != num_tablet_servers(); ++i) {
+      auto* server = mini_cluster()->mini_tablet_server(i)->server();
+      for (int j = 0; j != num_tablet_servers(); ++j) {
+        if (i != j) {
+          server->messenger()->SetLinkConditions(
+              mini_cluster()->mini_tablet_server(j)->bound_rpc_addr().address(), conditions);
+        }
+      }
+    }
+  }
+
+  tablet::TabletPeerPtr LeaderPeer() {
+    for (int i = 0; i != num_tablet_servers(); ++i) {
+      tserver::TSTabletManager::TabletPeers peers;
+      mini_cluster()->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&peers);
+      for (const auto& peer : peers) {
+        if (peer->tablet_metadata()->table_id() == table_.table()->id() &&
+            peer->LeaderStatus() == consensus::Consensus::LeaderStatus::LEADER_AND_READY) {
+          return peer;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  BenchResult Run(int batch_size) {
+    tablet::TabletPeerPtr leader;
+    for (int attempt = 0; !(leader = LeaderPeer()); ++attempt) {
+      CHECK_LT(attempt, 100) << "No leader of the benchmarked tablet";
+      std::this_thread::sleep_for(100ms);
+    }
+    auto* replicate_latency = leader->tablet()->metrics()->write_replicate_latency.get();
+    const auto replicate_count_before = replicate_latency->TotalCount();
+    const auto replicate_sum_before = replicate_latency->TotalSum();
+
+    HdrHistogram latency(60000000, 2);
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> num_writes{0};
+    const std::string value(FLAGS_raft_bench_value_size, 'v');
+    std::vector<std::thread> writers;
+    auto start = MonoTime::Now();
+    for (int t = 0; t != FLAGS_raft_bench_writer_threads; ++t) {
+      writers.emplace_back([this, t, batch_size, &value, &latency, &stop, &num_writes] {
+        auto session = NewSession();
+        for (uint64_t i = 0; !stop.load(std::memory_order_acquire); ++i) {
+          for (int row = 0; row != batch_size; ++row) {
+            auto insert = table_.NewInsertOp();
+            QLAddStringHashValue(insert->mutable_request(), Format("$0_$1_$2", t, i, row));
+            table_.AddStringColumnValue(insert->mutable_request(), "v", value);
+            CHECK_OK(session->Apply(insert));
+          }
+          auto write_start = MonoTime::Now();
+          auto status = session->Flush();
+          if (status.ok()) {
+            latency.Increment(MonoTime::Now().GetDeltaSince(write_start).ToMicroseconds());
+            num_writes.fetch_add(1, std::memory_order_relaxed);
+          } else {
+            // Writes could fail when requests are lost, only successful ones are counted.
+            LOG(WARNING) << "Write failed: " << status;
+          }
+        }
+      });
+    }
+    std::this_thread::sleep_for(FLAGS_raft_bench_duration_ms * 1ms);
+    stop.store(true, std::memory_order_release);
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    const double elapsed_sec = MonoTime::Now().GetDeltaSince(start).ToSeconds();
+
+    const auto replicate_count = replicate_latency->TotalCount() - replicate_count_before;
+    const auto replicate_sum = replicate_latency->TotalSum() - replicate_sum_before;
+    const auto writes = num_writes.load();
+    return BenchResult {
+      writes * batch_size / elapsed_sec,
+      writes / elapsed_sec,
+      latency.ValueAtPercentile(50),
+      latency.ValueAtPercentile(99),
+      replicate_count ? static_cast<double>(replicate_sum) / replicate_count : 0,
+    };
+  }
+};
+
+TEST_F(RaftReplicationBench, Sweep) {
+  const auto batch_sizes = ParseSweepFlag("raft_bench_batch_sizes", FLAGS_raft_bench_batch_sizes);
+  const auto in_flight_requests = ParseSweepFlag(
+      "raft_bench_in_flight_requests", FLAGS_raft_bench_in_flight_requests);
+  SetLinkConditions();
+
+  std::string table = StringPrintf(
+      "\n%8s %10s %10s %12s %10s %10s %14s\n", "batch", "in flight", "rows/sec", "writes/sec",
+      "p50 (us)", "p99 (us)", "replicate (us)");
+  for (auto batch_size : batch_sizes) {
+    for (auto max_in_flight : in_flight_requests) {
+      FLAGS_consensus_max_in_flight_requests_per_peer = max_in_flight;
+      auto result = Run(batch_size);
+      auto line = StringPrintf(
+          "%8d %10d %10.0f %12.0f %10" PRIu64 " %10" PRIu64 " %14.1f\n", batch_size,
+          max_in_flight, result.rows_per_sec, result.writes_per_sec, result.p50_us,
+          result.p99_us, result.replicate_mean_us);
+      LOG(INFO) << line;
+      table += line;
+    }
+  }
+  LOG(INFO) << "Raft replication with " << num_tablet_servers() << " peers, link latency "
+            << FLAGS_raft_bench_link_latency_us << " us, jitter " << FLAGS_raft_bench_link_jitter_us
+            << " us, bandwidth " << FLAGS_raft_bench_link_bandwidth_mb_per_sec << " MB/s, loss "
+            << FLAGS_raft_bench_link_loss_percent << "%, consensus_max_batch_size_bytes "
+            << FLAGS_consensus_max_batch_size_bytes << ":" << table;
+}
+
+} // namespace integration_tests
+} // namespace yb
@@ -356,7 +356,8 @@ void RetryingTSRpcTask::TransitionToTerminalState(MonitoredTaskState expected,
 AsyncCreateReplica::AsyncCreateReplica(Master *master,
                                        ThreadPool *callback_pool,
                                        const string& permanent_uuid,
-                                       const scoped_refptr<TabletInfo>& tablet)
+                                       const scoped_refptr<TabletInfo>& tablet,
+                                       const string& initial_leader_uuid)
   : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, tablet->table().get()),
     tablet_id_(tablet->tablet_id()) {
   deadline_ = start_ts_;
@@ -374,6 +375,9 @@ AsyncCreateReplica::AsyncCreateReplica(Master *master,
   req_.mutable_schema()->CopyFrom(table_lock->data().pb.schema());
   req_.mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
   req_.mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
+  if (!initial_leader_uuid.empty()) {
+    req_.set_initial_leader_uuid(initial_leader_uuid);
+  }
 }
 
 void AsyncCreateReplica::HandleResponse(int attempt) {
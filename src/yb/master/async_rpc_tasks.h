@@ -241,10 +241,12 @@ class RetrySpecificTSRpcTask : public RetryingTSRpcTask {
 // consensus configuration information has been filled into the 'dirty' data.
 class AsyncCreateReplica : public RetrySpecificTSRpcTask {
  public:
+  // initial_leader_uuid is the peer that should start the first election, could be empty.
   AsyncCreateReplica(Master *master,
                      ThreadPool *callback_pool,
                      const std::string& permanent_uuid,
-                     const scoped_refptr<TabletInfo>& tablet);
+                     const scoped_refptr<TabletInfo>& tablet,
+                     const std::string& initial_leader_uuid);
 
   Type type() const override { return ASYNC_CREATE_REPLICA; }
 
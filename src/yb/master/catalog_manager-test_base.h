@@ -179,6 +179,9 @@ class TestLoadBalancerBase {
 
     PrepareTestState(ts_descs_multi_az);
     TestLeaderOverReplication();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestWeightedLoad();
   }
 
  protected:
@@ -486,6 +489,41 @@ class TestLoadBalancerBase {
     ASSERT_EQ(0, cb_->get_total_over_replication());
   }
 
+  void TestWeightedLoad() {
+    LOG(INFO) << "Testing with load weighted by tablet size";
+    PlacementInfoPB* cluster_placement = replication_info_.mutable_live_replicas();
+    cluster_placement->set_num_replicas(kNumReplicas);
+
+    // The first tablet is much bigger than others.
+    TSDescriptor::TabletLoads tablet_loads;
+    for (int i = 0; i < tablets_.size(); ++i) {
+      tablet_loads[tablets_[i]->tablet_id()].sst_file_size = (i == 0 ? 90 : 10) * 1024 * 1024;
+    }
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->set_tablet_loads(tablet_loads);
+    }
+    auto* options = cb_->state_->options_;
+    options->kTabletSizeWeight = 1;
+
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    ResetState();
+    AnalyzeTablets();
+
+    // Moving the big tablet would overload the new TS, so only small tablets are moved to it.
+    string placeholder;
+    for (int i = 0; i < 3; ++i) {
+      string tablet_id;
+      ASSERT_TRUE(HandleAddReplicas(&tablet_id, &placeholder, &placeholder));
+      ASSERT_NE(tablets_[0]->tablet_id(), tablet_id);
+    }
+    ASSERT_FALSE(HandleAddReplicas(&placeholder, &placeholder, &placeholder));
+
+    options->kTabletSizeWeight = 0;
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->set_tablet_loads(TSDescriptor::TabletLoads());
+    }
+  }
+
   void TestWithMissingTabletServers() {
     LOG(INFO) << "Testing with missing tablet servers";
     SetupClusterConfig({"a"}, &replication_info_);
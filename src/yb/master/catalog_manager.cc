@@ -55,6 +55,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -161,6 +162,13 @@ DEFINE_int32(max_create_tablets_per_ts, 20,
              "The number of tablets per TS that can be requested for a new table.");
 TAG_FLAG(max_create_tablets_per_ts, advanced);
 
+DEFINE_bool(catalog_manager_assign_initial_leaders, true,
+            "Whether the catalog manager should choose the initial leader of each new tablet, "
+            "spreading leaders evenly across tablet servers. The chosen replica starts an election "
+            "as soon as it is created, instead of all replicas competing after a random timeout.");
+TAG_FLAG(catalog_manager_assign_initial_leaders, advanced);
+TAG_FLAG(catalog_manager_assign_initial_leaders, runtime);
+
 DEFINE_int32(master_failover_catchup_timeout_ms, 30 * 1000,  // 30 sec
              "Amount of time to give a newly-elected leader master to load"
              " the previous master's metadata and become active. If this time"
@@ -313,7 +321,8 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
     l->mutable_data()->pb.CopyFrom(metadata);
 
     // Add the tablet to the tablet manager.
-    auto inserted = catalog_manager_->tablet_map_.emplace(tablet->tablet_id(), tablet).second;
+    auto inserted =
+        catalog_manager_->mutable_tablet_map()->emplace(tablet->tablet_id(), tablet).second;
     if (!inserted) {
       return STATUS_FORMAT(
           IllegalState, "Loaded tablet that already in map: $0", tablet->tablet_id());
@@ -853,7 +862,7 @@ Status CatalogManager::RunLoaders() {
   // Clear the table and tablet state.
   table_names_map_.clear();
   table_ids_map_.clear();
-  tablet_map_.clear();
+  tablet_map_ = std::make_shared<TabletInfoMap>();
 
   // Clear the namespace mappings.
   namespace_ids_map_.clear();
@@ -1320,8 +1329,9 @@ Status CatalogManager::AbortTableCreation(TableInfo* table,
     tablet->mutable_metadata()->AbortMutation();
   }
   table->mutable_metadata()->AbortMutation();
+  auto* tablet_map = mutable_tablet_map();
   for (const TabletId& tablet_id_to_erase : tablet_ids_to_erase) {
-    CHECK_EQ(tablet_map_.erase(tablet_id_to_erase), 1)
+    CHECK_EQ(tablet_map->erase(tablet_id_to_erase), 1)
         << "Unable to erase tablet " << tablet_id_to_erase << " from tablet map.";
   }
 
@@ -1729,8 +1739,9 @@ Status CatalogManager::CreateTabletsFromTable(const vector<Partition>& partition
 
   // Add the table/tablets to the in-memory map for the assignment.
   table->AddTablets(*tablets);
+  auto* tablet_map = mutable_tablet_map();
   for (TabletInfo* tablet : *tablets) {
-    InsertOrDie(&tablet_map_, tablet->tablet_id(), tablet);
+    InsertOrDie(tablet_map, tablet->tablet_id(), tablet);
   }
   return Status::OK();
 }
@@ -2773,6 +2784,15 @@ scoped_refptr<TableInfo> CatalogManager::GetTableInfoFromNamespaceNameAndTableNa
   return FindPtrOrNull(table_names_map_, {ns->id(), table_name});
 }
 
+TabletInfoMap* CatalogManager::mutable_tablet_map() {
+  // Snapshots are taken only with lock_ held, so while we hold it exclusively, an unique map
+  // could not get new readers and could be modified in place.
+  if (!tablet_map_.unique()) {
+    tablet_map_ = std::make_shared<TabletInfoMap>(*tablet_map_);
+  }
+  return tablet_map_.get();
+}
+
 scoped_refptr<TableInfo> CatalogManager::GetTableInfoUnlocked(const TableId& table_id) {
   return FindPtrOrNull(table_ids_map_, table_id);
 }
@@ -2909,7 +2929,11 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
 
   if (!ts_desc->has_tablet_report()) {
     LOG(INFO) << ts_desc->permanent_uuid() << " now has full report for "
-              << report.updated_tablets_size() << " tablets.";
+              << report.updated_tablets_size() << " tablets, "
+              << report.remaining_tablet_count() << " tablets will be reported later.";
+  } else if (report.remaining_tablet_count()) {
+    VLOG(1) << ts_desc->permanent_uuid() << " reported " << report.updated_tablets_size()
+            << " tablets, " << report.remaining_tablet_count() << " tablets remaining.";
   }
 
   if (!report.is_incremental()) {
@@ -2953,7 +2977,7 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   scoped_refptr<TabletInfo> tablet;
   {
     boost::shared_lock<LockType> l(lock_);
-    tablet = FindPtrOrNull(tablet_map_, report.tablet_id());
+    tablet = FindPtrOrNull(*tablet_map_, report.tablet_id());
   }
   RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
       Substitute("This master is no longer the leader, unable to handle report for tablet $0",
@@ -4358,14 +4382,18 @@ void CatalogManager::GetPendingServerTasksUnlocked(const TableId &table_uuid,
 void CatalogManager::ExtractTabletsToProcess(
     TabletInfos *tablets_to_delete,
     TabletInfos *tablets_to_process) {
-  boost::shared_lock<LockType> l(lock_);
+  std::shared_ptr<const TabletInfoMap> tablet_map;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    tablet_map = tablet_map_snapshot();
+  }
 
   // TODO: At the moment we loop through all the tablets
   //       we can keep a set of tablets waiting for "assignment"
   //       or just a counter to avoid to take the lock and loop through the tablets
   //       if everything is "stable".
 
-  for (const TabletInfoMap::value_type& entry : tablet_map_) {
+  for (const TabletInfoMap::value_type& entry : *tablet_map) {
     scoped_refptr<TabletInfo> tablet = entry.second;
     auto tablet_lock = tablet->LockForRead();
 
@@ -4438,7 +4466,7 @@ void CatalogManager::HandleAssignCreatingTablet(TabletInfo* tablet,
   tablet->table()->AddTablet(replacement);
   {
     std::lock_guard<LockType> l_maps(lock_);
-    tablet_map_[replacement->tablet_id()] = replacement;
+    (*mutable_tablet_map())[replacement->tablet_id()] = replacement;
   }
 
   // Mark old tablet as replaced.
@@ -4624,8 +4652,9 @@ Status CatalogManager::ProcessPendingAssignments(const TabletInfos& tablets) {
     std::lock_guard<LockType> l(lock_);
     unlocker_out.Abort();
     unlocker_in.Abort();
+    auto* tablet_map = mutable_tablet_map();
     for (const TabletId& tablet_id_to_remove : tablet_ids_to_remove) {
-      CHECK_EQ(tablet_map_.erase(tablet_id_to_remove), 1)
+      CHECK_EQ(tablet_map->erase(tablet_id_to_remove), 1)
           << "Unable to erase " << tablet_id_to_remove << " from tablet map.";
     }
     return s;
@@ -4782,13 +4811,32 @@ Status CatalogManager::HandlePlacementUsingPlacementInfo(const PlacementInfoPB&
 }
 
 void CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& tablets) {
+  // Number of initial leaders assigned to each tablet server by this call.
+  std::unordered_map<TabletServerId, int> initial_leaders;
   for (TabletInfo *tablet : tablets) {
     const consensus::RaftConfigPB& config =
         tablet->metadata().dirty().pb.committed_consensus_state().config();
     tablet->set_last_update_time(MonoTime::Now());
+    string initial_leader_uuid;
+    if (FLAGS_catalog_manager_assign_initial_leaders) {
+      int min_leaders = std::numeric_limits<int>::max();
+      for (const RaftPeerPB& peer : config.peers()) {
+        if (peer.member_type() != RaftPeerPB::VOTER) {
+          continue;
+        }
+        int leaders = initial_leaders[peer.permanent_uuid()];
+        if (leaders < min_leaders) {
+          min_leaders = leaders;
+          initial_leader_uuid = peer.permanent_uuid();
+        }
+      }
+      if (!initial_leader_uuid.empty()) {
+        ++initial_leaders[initial_leader_uuid];
+      }
+    }
     for (const RaftPeerPB& peer : config.peers()) {
       auto task = std::make_shared<AsyncCreateReplica>(master_, worker_pool_.get(),
-          peer.permanent_uuid(), tablet);
+          peer.permanent_uuid(), tablet, initial_leader_uuid);
       tablet->table()->AddTask(task);
       WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
     }
@@ -5008,7 +5056,7 @@ Status CatalogManager::RetrieveSystemTablet(const TabletId& tablet_id,
   scoped_refptr<TabletInfo> tablet_info;
   {
     boost::shared_lock<LockType> l(lock_);
-    if (!FindCopy(tablet_map_, tablet_id, &tablet_info)) {
+    if (!FindCopy(*tablet_map_, tablet_id, &tablet_info)) {
       return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
     }
   }
@@ -5030,7 +5078,7 @@ Status CatalogManager::GetTabletLocations(const TabletId& tablet_id,
   scoped_refptr<TabletInfo> tablet_info;
   {
     boost::shared_lock<LockType> l(lock_);
-    if (!FindCopy(tablet_map_, tablet_id, &tablet_info)) {
+    if (!FindCopy(*tablet_map_, tablet_id, &tablet_info)) {
       return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
     }
   }
@@ -5119,7 +5167,7 @@ void CatalogManager::DumpState(std::ostream* out, bool on_disk_dump) const {
   NamespaceInfoMap namespace_ids_copy;
   TableInfoMap ids_copy;
   TableInfoByNameMap names_copy;
-  TabletInfoMap tablets_copy;
+  std::shared_ptr<const TabletInfoMap> tablets_snapshot;
 
   // Copy the internal state so that, if the output stream blocks,
   // we don't end up holding the lock for a long time.
@@ -5128,8 +5176,9 @@ void CatalogManager::DumpState(std::ostream* out, bool on_disk_dump) const {
     namespace_ids_copy = namespace_ids_map_;
     ids_copy = table_ids_map_;
     names_copy = table_names_map_;
-    tablets_copy = tablet_map_;
+    tablets_snapshot = tablet_map_snapshot();
   }
+  TabletInfoMap tablets_copy = *tablets_snapshot;
 
   *out << "Dumping Current state of master.\nNamespaces:\n";
   for (const NamespaceInfoMap::value_type& e : namespace_ids_copy) {
@@ -5303,8 +5352,13 @@ Status CatalogManager::SetBlackList(const BlacklistPB& blacklist) {
     blacklistState.Reset();
   }
 
+  size_t num_tablets;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    num_tablets = tablet_map_->size();
+  }
   LOG(INFO) << "Set blacklist size = " << blacklist.hosts_size() << " with load "
-            << blacklist.initial_replica_load() << " for num_tablets = " << tablet_map_.size();
+            << blacklist.initial_replica_load() << " for num_tablets = " << num_tablets;
 
   for (const auto& pb : blacklist.hosts()) {
     blacklistState.tservers_.insert(HostPortFromPB(pb));
@@ -5427,8 +5481,12 @@ std::string BlacklistState::ToString() {
 
 int64_t CatalogManager::GetNumBlacklistReplicas() {
   int64_t blacklist_replicas = 0;
-  std::lock_guard <LockType> tablet_map_lock(lock_);
-  for (const TabletInfoMap::value_type& entry : tablet_map_) {
+  std::shared_ptr<const TabletInfoMap> tablet_map;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    tablet_map = tablet_map_snapshot();
+  }
+  for (const TabletInfoMap::value_type& entry : *tablet_map) {
     scoped_refptr<TabletInfo> tablet = entry.second;
     auto l = tablet->LockForRead();
     // Not checking being created on purpose as we do not want initial load to be under accounted.
@@ -5454,7 +5512,12 @@ int64_t CatalogManager::GetNumBlacklistReplicas() {
 
 Status CatalogManager::GetLoadMoveCompletionPercent(GetLoadMovePercentResponsePB* resp) {
   int64_t blacklist_replicas = GetNumBlacklistReplicas();
-  LOG(INFO) << "Blacklisted count " << blacklist_replicas << " in " << tablet_map_.size()
+  size_t num_tablets;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    num_tablets = tablet_map_->size();
+  }
+  LOG(INFO) << "Blacklisted count " << blacklist_replicas << " in " << num_tablets
             << " tablets, across " << blacklistState.tservers_.size()
             << " servers, with initial load " << blacklistState.initial_load_;
 
@@ -1372,6 +1372,15 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                      TabletToTabletServerMap *remove_replica_tasks_map,
                                      TabletToTabletServerMap *stepdown_leader_tasks);
 
+  // Returns an immutable snapshot of the tablet map, that could be used after lock_ is released.
+  // Should be called with lock_ held.
+  std::shared_ptr<const TabletInfoMap> tablet_map_snapshot() const {
+    return tablet_map_;
+  }
+
+  // Returns the tablet map for modification. Should be called with lock_ held exclusively.
+  TabletInfoMap* mutable_tablet_map();
+
   // Abort creation of 'table': abort all mutation for TabletInfo and
   // TableInfo objects (releasing all COW locks), abort all pending
   // tasks associated with the table, and erase any state related to
@@ -1441,7 +1450,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                         // [tserver-id, tablet-id] -> DeletedTableInfo
 
   // Tablet maps: tablet-id -> TabletInfo
-  TabletInfoMap tablet_map_;
+  // Snapshots of this map are used for long iterations, so the lock is not held while iterating.
+  // The map is copied on modification, if a snapshot of it is still in use.
+  std::shared_ptr<TabletInfoMap> tablet_map_ = std::make_shared<TabletInfoMap>();
 
   // Namespace maps: namespace-id -> NamespaceInfo and namespace-name -> NamespaceInfo
   typedef std::unordered_map<NamespaceName, scoped_refptr<NamespaceInfo> > NamespaceInfoMap;
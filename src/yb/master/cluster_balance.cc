@@ -20,6 +20,7 @@
 
 #include "yb/consensus/quorum_util.h"
 #include "yb/master/master.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
 DEFINE_bool(enable_load_balancing,
@@ -60,11 +61,32 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_double(load_balancer_tablet_size_weight,
+              0,
+              "Weight of tablet SST file size, relative to the average tablet of the table, in the "
+              "load of a tablet server. Zero means tablets are balanced by replica count only.");
+TAG_FLAG(load_balancer_tablet_size_weight, advanced);
+
+DEFINE_double(load_balancer_tablet_ops_weight,
+              0,
+              "Weight of tablet read and write ops per second, relative to the average tablet of "
+              "the table, in the load of a tablet server. Zero means tablets are balanced by "
+              "replica count only.");
+TAG_FLAG(load_balancer_tablet_ops_weight, advanced);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
 namespace master {
 
+namespace {
+
+// Fixed overhead of moving a tablet replica, so tiny tablets are not preferred regardless of how
+// little they improve the balance.
+constexpr double kMinBytesToMove = 1024 * 1024;
+
+} // namespace
+
 using std::unique_ptr;
 using std::make_unique;
 using std::string;
@@ -86,16 +108,41 @@ bool ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
         // Otherwise, default to cluster policy.
         pb.CopyFrom(GetClusterPlacementInfo());
       }
+      const auto& partition_placements = l->data().pb.replication_info().partition_placements();
+      state_->partition_placements_by_table_[table_id].assign(
+          partition_placements.begin(), partition_placements.end());
     }
     state_->placement_by_table_[table_id] = std::move(pb);
   }
+  UpdatePartitionPlacement(tablet);
 
   return state_->UpdateTablet(tablet);
 }
 
+void ClusterLoadBalancer::UpdatePartitionPlacement(TabletInfo* tablet) {
+  const auto& partition_placements = state_->partition_placements_by_table_[tablet->table()->id()];
+  if (partition_placements.empty()) {
+    return;
+  }
+  auto l = tablet->LockForRead();
+  const auto& partition = l->data().pb.partition();
+  for (const auto& partition_placement : partition_placements) {
+    if (partition.partition_key_start() < partition_placement.partition_key_start()) {
+      continue;
+    }
+    if (!partition_placement.partition_key_end().empty() &&
+        (partition.partition_key_end().empty() ||
+         partition.partition_key_end() > partition_placement.partition_key_end())) {
+      continue;
+    }
+    state_->placement_by_tablet_[tablet->id()] = partition_placement.live_replicas();
+    return;
+  }
+}
+
 const PlacementInfoPB& ClusterLoadBalancer::GetPlacementByTablet(const TabletId& tablet_id) const {
   const auto& table_id = GetTabletMap().at(tablet_id)->table()->id();
-  return state_->placement_by_table_.at(table_id);
+  return state_->GetPlacement(tablet_id, table_id);
 }
 
 int ClusterLoadBalancer::get_total_wrong_placement() const {
@@ -289,6 +336,10 @@ bool ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // low for the given configuration.
   state_->AdjustLeaderBalanceThreshold();
 
+  // Tablet costs depend on the load of all tablets of the table, so they are computed after all
+  // tablets are known.
+  state_->ComputeTabletCosts();
+
   // Once we've analyzed both the tablet server information as well as the tablets, we can sort the
   // load and are ready to apply the load balancing rules.
   state_->SortLoad();
@@ -434,6 +485,9 @@ void ClusterLoadBalancer::DumpSortedLoad() const {
     const TabletServerId& uuid = state_->sorted_load_[left];
     int load = state_->GetLoad(uuid);
     out << uuid << ":" << load << " ";
+    if (state_->use_weighted_load_) {
+      out << "(" << state_->GetWeightedLoad(uuid) << ") ";
+    }
   }
   VLOG(1) << out.str();
 }
@@ -469,10 +523,19 @@ bool ClusterLoadBalancer::GetLoadToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_load_[right];
-      int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
+      bool too_small_variance;
+      if (state_->use_weighted_load_) {
+        // Moving a tablet reduces the variance only if its cost is less than the difference.
+        double load_variance =
+            state_->GetWeightedLoad(high_load_uuid) - state_->GetWeightedLoad(low_load_uuid);
+        too_small_variance = load_variance <= state_->min_tablet_cost_;
+      } else {
+        int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
+        too_small_variance = load_variance < state_->options_->kMinLoadVarianceToBalance;
+      }
 
       // Check for state change or end conditions.
-      if (left == right || load_variance < state_->options_->kMinLoadVarianceToBalance) {
+      if (left == right || too_small_variance) {
         // Either both left and right are at the end, or our load_variance is already too small,
         // which means it will be too small for any TSs between left and right, so we can return.
         if (right == last_pos) {
@@ -546,6 +609,10 @@ bool ClusterLoadBalancer::GetTabletToMove(
 
   bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
                         state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  const double load_variance =
+      state_->GetWeightedLoad(from_ts) - state_->GetWeightedLoad(to_ts);
+  double best_benefit_per_byte = 0;
+  bool found = false;
   for (const auto& tablet_id : non_over_replicated_tablets) {
     const auto& placement_info = GetPlacementByTablet(tablet_id);
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
@@ -565,11 +632,27 @@ bool ClusterLoadBalancer::GetTabletToMove(
     // If we got here, it means we either have no placement, in which case we can pick any TS, or
     // we have placement and it's valid to move across these two tablet servers, so set the tablet
     // and leave.
-    *moving_tablet_id = tablet_id;
-    return true;
+    if (!state_->use_weighted_load_) {
+      *moving_tablet_id = tablet_id;
+      return true;
+    }
+    // With weighted load, pick the tablet that reduces the sum of squared tablet server loads the
+    // most per byte that has to be remote bootstrapped. Moving cost c between loads H and L
+    // reduces H^2 + L^2 by 2c(H - L - c).
+    const auto& tablet_meta = state_->per_tablet_meta_[tablet_id];
+    const double benefit = tablet_meta.cost * (load_variance - tablet_meta.cost);
+    if (benefit <= 0) {
+      continue;
+    }
+    const double benefit_per_byte = benefit / (tablet_meta.sst_file_size + kMinBytesToMove);
+    if (!found || benefit_per_byte > best_benefit_per_byte) {
+      best_benefit_per_byte = benefit_per_byte;
+      *moving_tablet_id = tablet_id;
+      found = true;
+    }
   }
   // If we couldn't select a tablet above, we have to return failure.
-  return false;
+  return found;
 }
 
 bool ClusterLoadBalancer::GetLeaderToMove(
@@ -784,7 +867,7 @@ void ClusterLoadBalancer::GetAllReportedDescriptors(TSDescriptorVector* ts_descs
 }
 
 const TabletInfoMap& ClusterLoadBalancer::GetTabletMap() const {
-  return catalog_manager_->tablet_map_;
+  return *catalog_manager_->tablet_map_;
 }
 
 const scoped_refptr<TableInfo> ClusterLoadBalancer::GetTableInfo(const TableId& table_uuid) const {
@@ -169,6 +169,10 @@ class ClusterLoadBalancer {
   // Returns false only if there are transient errors in updating the internal state.
   virtual bool UpdateTabletInfo(TabletInfo* tablet);
 
+  // Sets the placement of the tablet if its partition is covered by a partition placement of its
+  // table.
+  void UpdatePartitionPlacement(TabletInfo* tablet);
+
   // If a tablet is under-replicated, or has certain placements that have less than the minimum
   // required number of replicas, we need to add extra tablets to its peer set.
   //
@@ -48,6 +48,10 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_double(load_balancer_tablet_size_weight);
+
+DECLARE_double(load_balancer_tablet_ops_weight);
+
 namespace yb {
 namespace master {
 
@@ -116,6 +120,13 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Max SST file size and ops per second reported by replicas of this tablet.
+  uint64_t sst_file_size = 0;
+  double ops_per_sec = 0;
+
+  // Contribution of a single replica of this tablet to the load of a tablet server, see
+  // ClusterLoadState::ComputeTabletCosts.
+  double cost = 1.0;
 };
 
 struct CBTabletServerMetadata {
@@ -130,6 +141,9 @@ struct CBTabletServerMetadata {
 
   // The set of tablet leader ids that this tablet server is currently running.
   std::set<TabletId> leaders;
+
+  // Sum of costs of running and starting tablets.
+  double weighted_load = 0;
 };
 
 struct Options {
@@ -164,6 +178,11 @@ struct Options {
   // Max number of tablet leaders on tablet servers to move in any one run of the load balancer.
   int kMaxConcurrentLeaderMoves = FLAGS_load_balancer_max_concurrent_moves;
 
+  // Weights of tablet size and tablet ops per second in the tablet cost, relative to the weight
+  // of the replica count. When both are zero, tablet servers are balanced by replica count only.
+  double kTabletSizeWeight = FLAGS_load_balancer_tablet_size_weight;
+  double kTabletOpsWeight = FLAGS_load_balancer_tablet_ops_weight;
+
   // TODO(bogdan): add state for leaders starting remote bootstraps, to limit on that end too.
 };
 
@@ -176,6 +195,11 @@ class ClusterLoadState {
 
   // Comparators used for sorting by load.
   bool CompareByUuid(const TabletServerId& a, const TabletServerId& b) {
+    if (use_weighted_load_) {
+      double load_a = GetWeightedLoad(a);
+      double load_b = GetWeightedLoad(b);
+      return load_a == load_b ? a < b : load_a < load_b;
+    }
     int load_a = GetLoad(a);
     int load_b = GetLoad(b);
     if (load_a == load_b) {
@@ -219,6 +243,11 @@ class ClusterLoadState {
     return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
   }
 
+  // Get the sum of tablet costs for a certain TS.
+  double GetWeightedLoad(const TabletServerId& ts_uuid) const {
+    return per_ts_meta_.at(ts_uuid).weighted_load;
+  }
+
   // Get the load for a certain TS.
   int GetLeaderLoad(const TabletServerId& ts_uuid) const {
     return per_ts_meta_.at(ts_uuid).leaders.size();
@@ -226,6 +255,11 @@ class ClusterLoadState {
 
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
+  const PlacementInfoPB& GetPlacement(const TabletId& tablet_id, const TableId& table_id) {
+    auto it = placement_by_tablet_.find(tablet_id);
+    return it != placement_by_tablet_.end() ? it->second : placement_by_table_[table_id];
+  }
+
   // Update the per-tablet information for this tablet.
   bool UpdateTablet(TabletInfo* tablet) {
     const auto& tablet_id = tablet->id();
@@ -233,7 +267,7 @@ class ClusterLoadState {
     auto& tablet_meta = per_tablet_meta_[tablet_id];
 
     // Get the placement for this tablet.
-    const auto& placement = placement_by_table_[tablet->table()->id()];
+    const auto& placement = GetPlacement(tablet_id, tablet->table()->id());
 
     // Get replicas for this tablet.
     TabletInfo::ReplicaMap replica_map;
@@ -255,6 +289,12 @@ class ClusterLoadState {
         return false;
       }
 
+      // Replicas of the same tablet could report different load, e.g. leader serves more
+      // requests, so use the max, since any of them could become the leader.
+      const auto tablet_load = ts_meta_it->second.descriptor->GetTabletLoad(tablet_id);
+      tablet_meta.sst_file_size = std::max(tablet_meta.sst_file_size, tablet_load.sst_file_size);
+      tablet_meta.ops_per_sec = std::max(tablet_meta.ops_per_sec, tablet_load.ops_per_sec);
+
       // Fill leader info.
       if (replica.second.role == consensus::RaftPeerPB::LEADER) {
         tablet_meta.leader_uuid = ts_uuid;
@@ -501,8 +541,53 @@ class ClusterLoadState {
     return false;
   }
 
+  // Computes the cost of each tablet and the weighted load of each tablet server, after all
+  // tablets were updated.
+  //
+  // The cost of a tablet is 1 for the replica itself, plus its size and ops per second relative to
+  // the average tablet of the table, multiplied by the configured weights. So a tablet server with
+  // more bytes or ops than others gets a higher load, even when it has the same number of replicas.
+  void ComputeTabletCosts() {
+    use_weighted_load_ = options_->kTabletSizeWeight > 0 || options_->kTabletOpsWeight > 0;
+    double total_size = 0;
+    double total_ops = 0;
+    for (const auto& entry : per_tablet_meta_) {
+      total_size += entry.second.sst_file_size;
+      total_ops += entry.second.ops_per_sec;
+    }
+    const double num_tablets = std::max<size_t>(per_tablet_meta_.size(), 1);
+    const double avg_size = total_size / num_tablets;
+    const double avg_ops = total_ops / num_tablets;
+    min_tablet_cost_ = 1.0;
+    bool first = true;
+    for (auto& entry : per_tablet_meta_) {
+      auto& tablet_meta = entry.second;
+      tablet_meta.cost = 1.0;
+      if (use_weighted_load_) {
+        if (avg_size > 0) {
+          tablet_meta.cost += options_->kTabletSizeWeight * tablet_meta.sst_file_size / avg_size;
+        }
+        if (avg_ops > 0) {
+          tablet_meta.cost += options_->kTabletOpsWeight * tablet_meta.ops_per_sec / avg_ops;
+        }
+      }
+      min_tablet_cost_ = first ? tablet_meta.cost : std::min(min_tablet_cost_, tablet_meta.cost);
+      first = false;
+    }
+    for (auto& entry : per_ts_meta_) {
+      auto& ts_meta = entry.second;
+      ts_meta.weighted_load = 0;
+      for (const auto* tablets : {&ts_meta.running_tablets, &ts_meta.starting_tablets}) {
+        for (const auto& tablet_id : *tablets) {
+          ts_meta.weighted_load += per_tablet_meta_[tablet_id].cost;
+        }
+      }
+    }
+  }
+
   void AddReplica(const TabletId& tablet_id, const TabletServerId& to_ts) {
     per_ts_meta_[to_ts].starting_tablets.insert(tablet_id);
+    per_ts_meta_[to_ts].weighted_load += per_tablet_meta_[tablet_id].cost;
     ++per_tablet_meta_[tablet_id].starting;
     ++total_starting_;
     tablets_added_.insert(tablet_id);
@@ -512,11 +597,13 @@ class ClusterLoadState {
   void RemoveReplica(const TabletId& tablet_id, const TabletServerId& from_ts) {
     if (per_ts_meta_[from_ts].running_tablets.count(tablet_id)) {
       per_ts_meta_[from_ts].running_tablets.erase(tablet_id);
+      per_ts_meta_[from_ts].weighted_load -= per_tablet_meta_[tablet_id].cost;
       --per_tablet_meta_[tablet_id].running;
       --total_running_;
     }
     if (per_ts_meta_[from_ts].starting_tablets.count(tablet_id)) {
       per_ts_meta_[from_ts].starting_tablets.erase(tablet_id);
+      per_ts_meta_[from_ts].weighted_load -= per_tablet_meta_[tablet_id].cost;
       --per_tablet_meta_[tablet_id].starting;
       --total_starting_;
     }
@@ -593,6 +680,13 @@ class ClusterLoadState {
   // track of the placement block policies between cluster and table level.
   unordered_map<TableId, PlacementInfoPB> placement_by_table_;
 
+  // Partition placements of each table, see ReplicationInfoPB.
+  unordered_map<TableId, std::vector<PartitionPlacementPB>> partition_placements_by_table_;
+
+  // Map from tablet id to placement information, for tablets that are covered by a partition
+  // placement of their table. Such placement is used instead of the table placement.
+  unordered_map<TabletId, PlacementInfoPB> placement_by_tablet_;
+
   // Total number of running tablets in the clusters (including replicas).
   int total_running_ = 0;
 
@@ -602,6 +696,13 @@ class ClusterLoadState {
   // Set of ts_uuid sorted ascending by load. This is the actual raw data of TS load.
   vector<TabletServerId> sorted_load_;
 
+  // Whether tablet servers are sorted and balanced by weighted load instead of replica count.
+  bool use_weighted_load_ = false;
+
+  // Min cost of a tablet of the table being balanced. Servers whose weighted load differs by no
+  // more than this value cannot be improved by moving a replica.
+  double min_tablet_cost_ = 1.0;
+
   // Set ot tablet ids that have been determined to have missing replicas. This can mean they are
   // generically under-replicated (2 replicas active, but 3 configured), or missing replicas in
   // certain placements (3 replicas active out of 3 configured, but no replicas in one of the AZs
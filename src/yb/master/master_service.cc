@@ -169,6 +169,15 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     ts_desc->set_total_sst_file_size(req->metrics().total_sst_file_size());
     ts_desc->set_write_ops_per_sec(req->metrics().write_ops_per_sec());
     ts_desc->set_read_ops_per_sec(req->metrics().read_ops_per_sec());
+    TSDescriptor::TabletLoads tablet_loads;
+    for (const auto& tablet_load : req->metrics().tablet_loads()) {
+      auto& load = tablet_loads[tablet_load.tablet_id()];
+      load.sst_file_size = tablet_load.sst_file_size();
+      load.ops_per_sec = tablet_load.read_ops_per_sec() + tablet_load.write_ops_per_sec();
+      load.conflicts_per_sec = tablet_load.conflicts_per_sec();
+      load.hottest_key_share = tablet_load.hottest_key_share();
+    }
+    ts_desc->set_tablet_loads(std::move(tablet_loads));
   }
 
   if (req->has_tablet_report()) {
@@ -195,6 +204,9 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
   rpc.RespondSuccess();
 }
 
+// Location lookups are served only by the leader. Followers replicate the sys catalog, but replica
+// locations and leaders come from tablet server heartbeats that only the leader receives, and the
+// in memory catalog is only loaded when a master becomes the leader.
 void MasterServiceImpl::GetTabletLocations(const GetTabletLocationsRequestPB* req,
                                            GetTabletLocationsResponsePB* resp,
                                            RpcContext rpc) {
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -234,6 +235,35 @@ TEST_F(SysCatalogTest, TestSysCatalogTablesOperations) {
   ASSERT_EQ(master_->NumSystemTables(), loader->tables.size());
 }
 
+// Concurrent writes are group committed, check that all of them are written.
+TEST_F(SysCatalogTest, TestConcurrentWrites) {
+  SysCatalogTable* sys_catalog = master_->catalog_manager()->sys_catalog();
+
+  constexpr int kNumThreads = 8;
+  constexpr int kTablesPerThread = 20;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([sys_catalog, i] {
+      for (int j = 0; j != kTablesPerThread; ++j) {
+        scoped_refptr<TableInfo> table(new TableInfo(Format("table_$0_$1", i, j)));
+        auto l = table->LockForWrite();
+        l->mutable_data()->pb.set_name(table->id());
+        l->mutable_data()->pb.set_state(SysTablesEntryPB::RUNNING);
+        ASSERT_OK(SchemaToPB(Schema(), l->mutable_data()->pb.mutable_schema()));
+        ASSERT_OK(sys_catalog->AddItem(table.get()));
+        l->Commit();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  unique_ptr<TestTableLoader> loader(new TestTableLoader());
+  ASSERT_OK(sys_catalog->Visit(loader.get()));
+  ASSERT_EQ(kNumThreads * kTablesPerThread + master_->NumSystemTables(), loader->tables.size());
+}
+
 // Verify that data mutations are not available from metadata() until commit.
 TEST_F(SysCatalogTest, TestTableInfoCommit) {
   scoped_refptr<TableInfo> table(new TableInfo("123"));
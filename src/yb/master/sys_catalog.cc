@@ -32,6 +32,7 @@
 
 #include "yb/master/sys_catalog.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include <gflags/gflags.h>
@@ -102,6 +103,13 @@ DEFINE_int32(master_discovery_timeout_ms, 3600000,
              "Timeout for masters to discover each other during cluster creation/startup");
 TAG_FLAG(master_discovery_timeout_ms, hidden);
 
+DEFINE_int32(sys_catalog_write_batch_max_bytes, 4 * 1024 * 1024,
+             "Max size of mutations from concurrent writers that are group committed to the sys "
+             "catalog as a single operation. A writer that is bigger than this limit is still "
+             "written, alone.");
+TAG_FLAG(sys_catalog_write_batch_max_bytes, advanced);
+TAG_FLAG(sys_catalog_write_batch_max_bytes, runtime);
+
 METRIC_DEFINE_histogram(
   server, dns_resolve_latency_during_sys_catalog_setup,
   "yb.master.SysCatalogTable.SetupConfig DNS Resolve",
@@ -546,14 +554,100 @@ Status SysCatalogTable::WaitUntilRunning() {
   return Status::OK();
 }
 
+struct SysCatalogTable::PendingWrite {
+  explicit PendingWrite(SysCatalogWriter* writer_) : writer(writer_) {}
+
+  SysCatalogWriter* writer;
+  Status status;
+  bool done = false;
+};
+
 CHECKED_STATUS SysCatalogTable::SyncWrite(SysCatalogWriter* writer) {
-  tserver::WriteResponsePB resp;
+  PendingWrite pending(writer);
+  const size_t max_batch_bytes = std::max(FLAGS_sys_catalog_write_batch_max_bytes, 0);
+
+  std::unique_lock<std::mutex> lock(pending_writes_mutex_);
+  pending_writes_.push_back(&pending);
+  for (;;) {
+    if (pending.done) {
+      return pending.status;
+    }
+    if (write_in_progress_) {
+      pending_writes_cond_.wait(lock);
+      continue;
+    }
+
+    // Nobody is writing, so write everything that is queued, up to the size limit.
+    std::vector<PendingWrite*> batch;
+    size_t batch_bytes = 0;
+    while (!pending_writes_.empty()) {
+      const size_t bytes = pending_writes_.front()->writer->req_.ByteSizeLong();
+      if (!batch.empty() && batch_bytes + bytes > max_batch_bytes) {
+        break;
+      }
+      batch_bytes += bytes;
+      batch.push_back(pending_writes_.front());
+      pending_writes_.pop_front();
+    }
+    write_in_progress_ = true;
+    lock.unlock();
+
+    WriteBatch(batch);
+
+    lock.lock();
+    for (auto* write : batch) {
+      write->done = true;
+    }
+    write_in_progress_ = false;
+    // Wakes writers of this batch, and lets one of the remaining writers write the next batch.
+    pending_writes_cond_.notify_all();
+  }
+}
+
+void SysCatalogTable::WriteBatch(const std::vector<PendingWrite*>& batch) {
+  if (batch.size() == 1) {
+    WriteResponsePB resp;
+    batch[0]->status = SubmitAndWait(&batch[0]->writer->req_, &resp);
+    return;
+  }
+
+  VLOG_WITH_PREFIX(2) << "Group committing " << batch.size() << " writers";
+  WriteRequestPB req;
+  req.set_tablet_id(batch[0]->writer->req_.tablet_id());
+  // Index of the first row of each writer in the combined request.
+  std::vector<int> first_row;
+  first_row.reserve(batch.size());
+  for (auto* write : batch) {
+    first_row.push_back(req.ql_write_batch_size());
+    req.mutable_ql_write_batch()->MergeFrom(write->writer->req_.ql_write_batch());
+  }
+
+  WriteResponsePB resp;
+  Status status = SubmitAndWait(&req, &resp);
+  for (auto* write : batch) {
+    write->status = status;
+  }
+  if (!status.IsCorruption() || resp.per_row_errors_size() == 0) {
+    return;
+  }
+
+  // Only writers that own the failed rows are failed.
+  for (auto* write : batch) {
+    write->status = Status::OK();
+  }
+  for (const auto& error : resp.per_row_errors()) {
+    size_t idx = std::upper_bound(first_row.begin(), first_row.end(), error.row_index()) -
+                 first_row.begin() - 1;
+    batch[idx]->status = status;
+  }
+}
 
+CHECKED_STATUS SysCatalogTable::SubmitAndWait(const WriteRequestPB* req, WriteResponsePB* resp) {
   CountDownLatch latch(1);
   auto txn_callback = std::make_unique<LatchOperationCompletionCallback<WriteResponsePB>>(
-      &latch, &resp);
+      &latch, resp);
   auto operation_state = std::make_unique<tablet::WriteOperationState>(
-      tablet_peer()->tablet(), &writer->req_, &resp);
+      tablet_peer()->tablet(), req, resp);
   operation_state->set_completion_callback(std::move(txn_callback));
 
   RETURN_NOT_OK(tablet_peer()->SubmitWrite(std::move(operation_state), MonoTime::Max()));
@@ -561,11 +655,11 @@ CHECKED_STATUS SysCatalogTable::SyncWrite(SysCatalogWriter* writer) {
     LOG(DFATAL) << "SyncWrite hang";
   }
 
-  if (resp.has_error()) {
-    return StatusFromPB(resp.error().status());
+  if (resp->has_error()) {
+    return StatusFromPB(resp->error().status());
   }
-  if (resp.per_row_errors_size() > 0) {
-    for (const WriteResponsePB::PerRowErrorPB& error : resp.per_row_errors()) {
+  if (resp->per_row_errors_size() > 0) {
+    for (const WriteResponsePB::PerRowErrorPB& error : resp->per_row_errors()) {
       LOG(WARNING) << "row " << error.row_index() << ": " << StatusFromPB(error.error()).ToString();
     }
     return STATUS(Corruption, "One or more rows failed to write");
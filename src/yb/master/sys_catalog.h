@@ -32,6 +32,9 @@
 #ifndef YB_MASTER_SYS_CATALOG_H_
 #define YB_MASTER_SYS_CATALOG_H_
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -169,9 +172,21 @@ class SysCatalogTable {
   // NOTE: This is the "server-side" schema, so it must have the column IDs.
   Schema BuildTableSchema();
 
-  // Returns 'Status::OK()' if the WriteTranasction completed
+  // Returns 'Status::OK()' if the WriteTranasction completed.
+  //
+  // Concurrent calls are group committed: while one write is being replicated, writers that
+  // arrive are queued, and the next of them writes all queued writers as one operation.
   CHECKED_STATUS SyncWrite(SysCatalogWriter* writer);
 
+  struct PendingWrite;
+
+  // Writes the specified pending writes as a single operation and fills their statuses.
+  void WriteBatch(const std::vector<PendingWrite*>& batch);
+
+  // Submits the request to the sys catalog tablet and waits until it is completed.
+  CHECKED_STATUS SubmitAndWait(const tserver::WriteRequestPB* req,
+                               tserver::WriteResponsePB* resp);
+
   void SysCatalogStateChanged(const std::string& tablet_id,
                               std::shared_ptr<consensus::StateChangeContext> context);
 
@@ -236,6 +251,14 @@ class SysCatalogTable {
 
   scoped_refptr<Histogram> setup_config_dns_histogram_;
 
+  // Protects the group commit state below.
+  std::mutex pending_writes_mutex_;
+  std::condition_variable pending_writes_cond_;
+  // Writers waiting for their mutations to be written, in arrival order.
+  std::deque<PendingWrite*> pending_writes_;
+  // Whether some writer is currently writing a batch.
+  bool write_in_progress_ = false;
+
   DISALLOW_COPY_AND_ASSIGN(SysCatalogTable);
 };
 
@@ -35,6 +35,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/tserver/tserver_service.proxy.h"
@@ -204,6 +205,28 @@ class TSDescriptor {
     return tsMetrics_.write_ops_per_sec;
   }
 
+  // Load of tablet replicas hosted by this tablet server, as reported by the last heartbeat with
+  // metrics.
+  struct TabletLoad {
+    uint64_t sst_file_size = 0;
+    double ops_per_sec = 0;
+    double conflicts_per_sec = 0;
+    double hottest_key_share = 0;
+  };
+  typedef std::unordered_map<std::string, TabletLoad> TabletLoads;
+
+  void set_tablet_loads(TabletLoads tablet_loads) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tsMetrics_.tablet_loads = std::move(tablet_loads);
+  }
+
+  // Returns load of the specified tablet replica, or zero load if it was not reported.
+  TabletLoad GetTabletLoad(const std::string& tablet_id) const {
+    std::lock_guard<simple_spinlock> l(lock_);
+    auto it = tsMetrics_.tablet_loads.find(tablet_id);
+    return it != tsMetrics_.tablet_loads.end() ? it->second : TabletLoad();
+  }
+
   void ClearMetrics() {
     tsMetrics_.ClearMetrics();
   }
@@ -259,11 +282,14 @@ class TSDescriptor {
 
     double write_ops_per_sec = 0;
 
+    TabletLoads tablet_loads;
+
     void ClearMetrics() {
       total_memory_usage = 0;
       total_sst_file_size = 0;
       read_ops_per_sec = 0;
       write_ops_per_sec = 0;
+      tablet_loads.clear();
     }
   };
 
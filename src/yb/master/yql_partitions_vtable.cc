@@ -11,10 +11,18 @@
 // under the License.
 //
 
+#include "yb/master/yql_partitions_vtable.h"
+
 #include "yb/common/ql_value.h"
 #include "yb/common/redis_constants_common.h"
 #include "yb/master/catalog_manager.h"
-#include "yb/master/yql_partitions_vtable.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(partitions_vtable_cache_refresh_secs, 60,
+             "Max age of a cached system.partitions row. Rows are also rebuilt when replica "
+             "locations of the tablet change.");
+TAG_FLAG(partitions_vtable_cache_refresh_secs, advanced);
+TAG_FLAG(partitions_vtable_cache_refresh_secs, runtime);
 
 namespace yb {
 namespace master {
@@ -29,6 +37,12 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
   std::vector<scoped_refptr<TableInfo> > tables;
   CatalogManager* catalog_manager = master_->catalog_manager();
   catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
+
+  const auto now = MonoTime::Now();
+  const auto max_age = MonoDelta::FromSeconds(FLAGS_partitions_vtable_cache_refresh_secs);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Rows of tablets that are no longer listed are dropped with the old map.
+  CachedRows cached_rows;
   for (const scoped_refptr<TableInfo>& table : tables) {
 
     // Get namespace for table.
@@ -45,49 +59,74 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
     // Get tablets for table.
     std::vector<scoped_refptr<TabletInfo> > tablets;
     table->GetAllTablets(&tablets);
+    // Replicas of system tables are the masters, they are not tracked by tablet update time.
+    const bool cacheable = !catalog_manager->IsSystemTable(*table);
     for (const scoped_refptr<TabletInfo>& tablet : tablets) {
-      TabletLocationsPB tabletLocationsPB;
-      Status s = catalog_manager->GetTabletLocations(tablet->id(), &tabletLocationsPB);
-      // Skip not-found tablets: they might not be running yet or have been deleted.
-      if (!s.ok()) {
-        continue;
+      const auto tablet_update_time = tablet->last_update_time();
+      auto it = cached_rows_.find(tablet->id());
+      if (cacheable && it != cached_rows_.end() &&
+          it->second.tablet_update_time == tablet_update_time &&
+          now - it->second.build_time < max_age && tablet->LockForRead()->data().is_running()) {
+        RETURN_NOT_OK((*vtable)->AddRow(it->second.row));
+        cached_rows.emplace(tablet->id(), std::move(it->second));
+      } else {
+        // Skip not-found tablets: they might not be running yet or have been deleted.
+        if (!VERIFY_RESULT(BuildRow(tablet->id(), &(*vtable)->Extend()))) {
+          (*vtable)->rows().pop_back();
+          continue;
+        }
+        if (cacheable) {
+          cached_rows.emplace(
+              tablet->id(), CachedRow{tablet_update_time, now, (*vtable)->rows().back()});
+        }
       }
 
-      QLRow& row = (*vtable)->Extend();
+      // Names are not cached, since tables could be renamed.
+      QLRow& row = (*vtable)->rows().back();
       RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
       RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
-
-      const PartitionPB& partition = tabletLocationsPB.partition();
-      RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), &row));
-      RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), &row));
-
-      // Note: tablet id is in host byte order.
-      Uuid uuid;
-      RETURN_NOT_OK(uuid.FromHexString(tablet->id()));
-      RETURN_NOT_OK(SetColumnValue(kId, uuid, &row));
-
-      // Get replicas for tablet.
-      QLValuePB replica_addresses;
-      QLMapValuePB *map_value = replica_addresses.mutable_map_value();
-      for (const auto replica : tabletLocationsPB.replicas()) {
-        InetAddress addr;
-        RETURN_NOT_OK(addr.FromString(replica.ts_info().rpc_addresses(0).host()));
-        QLValue elem_key;
-        elem_key.set_inetaddress_value(addr);
-        *map_value->add_keys() = elem_key.value();
-
-        const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
-        QLValue elem_value;
-        elem_value.set_string_value(role);
-        *map_value->add_values() = elem_value.value();
-      }
-      RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, &row));
     }
   }
+  cached_rows_.swap(cached_rows);
 
   return Status::OK();
 }
 
+Result<bool> YQLPartitionsVTable::BuildRow(const TabletId& tablet_id, QLRow* row) const {
+  TabletLocationsPB tabletLocationsPB;
+  Status s = master_->catalog_manager()->GetTabletLocations(tablet_id, &tabletLocationsPB);
+  if (!s.ok()) {
+    return false;
+  }
+
+  const PartitionPB& partition = tabletLocationsPB.partition();
+  RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), row));
+  RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), row));
+
+  // Note: tablet id is in host byte order.
+  Uuid uuid;
+  RETURN_NOT_OK(uuid.FromHexString(tablet_id));
+  RETURN_NOT_OK(SetColumnValue(kId, uuid, row));
+
+  // Get replicas for tablet.
+  QLValuePB replica_addresses;
+  QLMapValuePB *map_value = replica_addresses.mutable_map_value();
+  for (const auto replica : tabletLocationsPB.replicas()) {
+    InetAddress addr;
+    RETURN_NOT_OK(addr.FromString(replica.ts_info().rpc_addresses(0).host()));
+    QLValue elem_key;
+    elem_key.set_inetaddress_value(addr);
+    *map_value->add_keys() = elem_key.value();
+
+    const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
+    QLValue elem_value;
+    elem_value.set_string_value(role);
+    *map_value->add_values() = elem_value.value();
+  }
+  RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, row));
+  return true;
+}
+
 Schema YQLPartitionsVTable::CreateSchema() const {
   SchemaBuilder builder;
   CHECK_OK(builder.AddHashKeyColumn(kKeyspaceName, QLType::Create(DataType::STRING)));
@@ -14,6 +14,9 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <mutex>
+#include <unordered_map>
+
 #include "yb/master/master.h"
 #include "yb/master/yql_virtual_table.h"
 
@@ -21,6 +24,9 @@ namespace yb {
 namespace master {
 
 // VTable implementation of system.partitions.
+//
+// Drivers read this table on every connection setup, so rows are cached per tablet and rebuilt
+// only for tablets whose replica locations were updated since the row was built.
 class YQLPartitionsVTable : public YQLVirtualTable {
  public:
   explicit YQLPartitionsVTable(const Master* const master);
@@ -29,6 +35,24 @@ class YQLPartitionsVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
  private:
+  struct CachedRow {
+    // Last update time of the tablet when the row was built.
+    MonoTime tablet_update_time;
+    // Time when the row was built, used to refresh addresses of re-registered tablet servers.
+    MonoTime build_time;
+    QLRow row;
+  };
+  typedef std::unordered_map<TabletId, CachedRow> CachedRows;
+
+  // Builds the row for the specified tablet, except keyspace and table name columns. Returns
+  // false if the tablet should not be listed.
+  Result<bool> BuildRow(const TabletId& tablet_id, QLRow* row) const;
+
+  // Protects cached_rows_, also serializes concurrent RetrieveData calls, so rows that were just
+  // built are reused by the waiting calls.
+  mutable std::mutex mutex_;
+  mutable CachedRows cached_rows_;
+
   static constexpr const char* const kKeyspaceName = "keyspace_name";
   static constexpr const char* const kTableName = "table_name";
   static constexpr const char* const kStartKey = "start_key";
@@ -43,6 +43,12 @@
 #include "yb/util/cache_metrics.h"
 #include "yb/rocksdb/statistics.h"
 
+namespace yb {
+
+class MemTracker;
+
+} // namespace yb
+
 namespace rocksdb {
 
 using std::shared_ptr;
@@ -55,6 +61,16 @@ enum SubCacheType {
 
 class Cache;
 
+// Policy of adding new entries to a full cache.
+enum class CacheAdmissionPolicy {
+  // New entries are always added, evicting least recently used entries.
+  kAlways,
+  // TinyLFU: new entry is added only if it was looked up at least as frequently as the least
+  // recently used entry that it would evict. Frequencies of recent lookups are estimated with a
+  // count-min sketch per shard. This way scans do not evict frequently accessed entries.
+  kFrequency,
+};
+
 // Create a new cache with a fixed size capacity. The cache is sharded
 // to 2^num_shard_bits shards, by hash of the key. The total capacity
 // is divided and evenly assigned to each shard.
@@ -65,6 +81,9 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
+extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
+                                     bool strict_capacity_limit,
+                                     CacheAdmissionPolicy admission_policy);
 
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
@@ -105,6 +124,8 @@ class Cache {
   // The query ids will allow the cache values to be included in the
   // single touch or multi touch cache, which gives scan resistance to the
   // cache.
+  // If the cache uses CacheAdmissionPolicy::kFrequency, the entry may be not admitted. In this
+  // case it could not be looked up, and is deleted when its handle is released.
   virtual Status Insert(const Slice& key, const QueryId query_id,
                         void* value, size_t charge,
                         void (*deleter)(const Slice& key, void* value),
@@ -190,6 +211,13 @@ class Cache {
 
   virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) = 0;
 
+  // Charges memory of cache entries to the specified tracker. Should be set before the cache
+  // is used.
+  virtual void SetMemTracker(const std::shared_ptr<yb::MemTracker>& mem_tracker) = 0;
+
+  // Returns the tracker set by SetMemTracker, or null.
+  virtual yb::MemTracker* GetMemTracker() const = 0;
+
  private:
   void LRU_Remove(Handle* e);
   void LRU_Append(Handle* e);
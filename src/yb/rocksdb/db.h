@@ -873,6 +873,12 @@ class DB {
     return STATUS(NotSupported, "");
   }
 
+  // Returns approximate middle user key of the default column family, that could be used as a
+  // split point. It is taken from the index of the largest SST file, so no data blocks are read.
+  virtual yb::Result<std::string> GetMiddleKey() {
+    return STATUS(NotSupported, "");
+  }
+
   // Used in testing to make the old memtable immutable and start writing to a new one.
   virtual void TEST_SwitchMemtable() {}
 
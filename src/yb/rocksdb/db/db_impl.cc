@@ -36,7 +36,9 @@
 #include <algorithm>
 #include <climits>
 #include <cstdio>
+#include <deque>
 #include <map>
+#include <numeric>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -116,6 +118,7 @@
 
 #include "yb/util/debug-util.h"
 #include "yb/util/fault_injection.h"
+#include "yb/util/priority_thread_pool.h"
 
 DEFINE_bool(dump_dbimpl_info, false, "Dump RocksDB info during constructor.");
 DEFINE_bool(flush_rocksdb_on_shutdown, true,
@@ -282,7 +285,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       total_log_size_(0),
       max_total_in_memory_state_(0),
       is_snapshot_supported_(true),
-      write_buffer_(options.db_write_buffer_size, options.memory_monitor),
+      write_buffer_(options.db_write_buffer_size, options.memory_monitor,
+                    options.memtable_mem_tracker),
       write_thread_(options.enable_write_thread_adaptive_yield
                         ? options.write_thread_max_yield_usec
                         : 0,
@@ -375,6 +379,10 @@ DBImpl::~DBImpl() {
   // marker. After this we do a variant of the waiting and unschedule work
   // (to consider: moving all the waiting into CancelAllBackgroundWork(true))
   CancelAllBackgroundWork(false);
+  if (db_options_.priority_thread_pool_for_compactions) {
+    // Aborted tasks decrement bg_compaction_scheduled_ by themselves.
+    db_options_.priority_thread_pool_for_compactions->Remove(this);
+  }
   int compactions_unscheduled = env_->UnSchedule(this, Env::Priority::LOW);
   int flushes_unscheduled = env_->UnSchedule(this, Env::Priority::HIGH);
   mutex_.Lock();
@@ -1579,7 +1587,9 @@ Status DBImpl::FlushMemTableToOutputFile(
   // Note that flush_job.Run will unlock and lock the db_mutex,
   // and EventListener callback will be called when the db_mutex
   // is unlocked by the current thread.
+  const uint64_t start_micros = env_->NowMicros();
   Status s = flush_job.Run(&file_meta);
+  const uint64_t elapsed_micros = env_->NowMicros() - start_micros;
 
   if (s.ok()) {
     InstallSuperVersionAndScheduleWorkWrapper(cfd, job_context,
@@ -1604,7 +1614,7 @@ Status DBImpl::FlushMemTableToOutputFile(
 #ifndef ROCKSDB_LITE
     // may temporarily unlock and lock the mutex.
     NotifyOnFlushCompleted(cfd, &file_meta, mutable_cf_options,
-                           job_context->job_id, flush_job.GetTableProperties());
+                           job_context->job_id, flush_job.GetTableProperties(), elapsed_micros);
 #endif  // ROCKSDB_LITE
     auto sfm =
         static_cast<SstFileManagerImpl*>(db_options_.sst_file_manager.get());
@@ -1645,7 +1655,8 @@ void DBImpl::SetTotalSSTFileSizeTicker() {
 void DBImpl::NotifyOnFlushCompleted(ColumnFamilyData* cfd,
                                     FileMetaData* file_meta,
                                     const MutableCFOptions& mutable_cf_options,
-                                    int job_id, TableProperties prop) {
+                                    int job_id, TableProperties prop,
+                                    uint64_t elapsed_micros) {
 #ifndef ROCKSDB_LITE
   if (db_options_.listeners.size() == 0U) {
     return;
@@ -1683,6 +1694,8 @@ void DBImpl::NotifyOnFlushCompleted(ColumnFamilyData* cfd,
     info.smallest_seqno = file_meta->smallest.seqno;
     info.largest_seqno = file_meta->largest.seqno;
     info.table_properties = prop;
+    info.file_size = file_meta->fd.GetTotalFileSize();
+    info.elapsed_micros = elapsed_micros;
     for (auto listener : db_options_.listeners) {
       listener->OnFlushCompleted(this, info);
     }
@@ -2503,8 +2516,7 @@ Status DBImpl::RunManualCompaction(ColumnFamilyData* cfd, int input_level,
       ca->m = &manual;
       manual.incomplete = false;
       bg_compaction_scheduled_++;
-      env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                     &DBImpl::UnscheduleCallback);
+      ScheduleCompaction(ca);
       scheduled = true;
     }
   }
@@ -2613,6 +2625,10 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     // Compaction may introduce data race to DB open
     return;
   }
+  if (db_options_.priority_thread_pool_for_compactions) {
+    // Already queued compactions are ranked by the current state of this DB.
+    UpdateCompactionPriority();
+  }
   if (bg_work_paused_ > 0) {
     // we paused the background work
     return;
@@ -2654,9 +2670,105 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     ca->m = nullptr;
     bg_compaction_scheduled_++;
     unscheduled_compactions_--;
+    ScheduleCompaction(ca);
+  }
+}
+
+class DBImpl::CompactionTask : public yb::PriorityThreadPoolTask {
+ public:
+  explicit CompactionTask(CompactionArg* arg) : arg_(arg) {}
+
+  ~CompactionTask() {
+    if (arg_) {
+      UnscheduleCallback(arg_);
+    }
+  }
+
+  void Run(const Status& status) override {
+    if (status.ok()) {
+      BGWorkCompaction(std::exchange(arg_, nullptr));
+      return;
+    }
+    DBImpl* db = arg_->db;
+    // Release the argument before DB could observe that compaction is unscheduled.
+    UnscheduleCallback(std::exchange(arg_, nullptr));
+    InstrumentedMutexLock lock(&db->mutex_);
+    db->bg_compaction_scheduled_--;
+    db->bg_cv_.SignalAll();
+  }
+
+  int64_t Priority() const override {
+    // Manual compactions are requested explicitly, so should not wait for automatic ones.
+    return arg_->m ? std::numeric_limits<int64_t>::max()
+                   : arg_->db->compaction_priority_.load(std::memory_order_relaxed);
+  }
+
+  const void* owner() const override {
+    return arg_->db;
+  }
+
+ private:
+  CompactionArg* arg_;
+};
+
+void DBImpl::ScheduleCompaction(CompactionArg* ca) {
+  mutex_.AssertHeld();
+  auto* pool = db_options_.priority_thread_pool_for_compactions;
+  if (!pool) {
     env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
                    &DBImpl::UnscheduleCallback);
+    return;
+  }
+  std::unique_ptr<yb::PriorityThreadPoolTask> task(new CompactionTask(ca));
+  Status s = pool->Submit(&task);
+  if (!s.ok()) {
+    // Pool is shutting down, so treat compaction as unscheduled. Task frees ca.
+    RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log, "Failed to schedule compaction: %s",
+         s.ToString().c_str());
+    bg_compaction_scheduled_--;
+    bg_cv_.SignalAll();
+  }
+}
+
+void DBImpl::UpdateCompactionPriority() {
+  mutex_.AssertHeld();
+  // Read amplification is the max number of sorted runs a read has to check in a column family.
+  // Space debt is the size of all sorted runs except the largest one, i.e. data that would be
+  // rewritten or dropped by compacting everything into one run.
+  uint64_t read_amplification = 0;
+  uint64_t space_debt = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || cfd->current() == nullptr) {
+      continue;
+    }
+    const auto* vstorage = cfd->current()->storage_info();
+    uint64_t sorted_runs = 0;
+    uint64_t total_size = 0;
+    uint64_t largest_run = 0;
+    for (int level = 0; level < vstorage->num_non_empty_levels(); ++level) {
+      const auto& files = vstorage->LevelFiles(level);
+      if (level == 0) {
+        // Each level 0 file is a separate sorted run.
+        sorted_runs += files.size();
+        for (const auto* file : files) {
+          total_size += file->fd.GetTotalFileSize();
+          largest_run = std::max(largest_run, file->fd.GetTotalFileSize());
+        }
+      } else if (!files.empty()) {
+        ++sorted_runs;
+        const uint64_t level_size = vstorage->NumLevelBytes(level);
+        total_size += level_size;
+        largest_run = std::max(largest_run, level_size);
+      }
+    }
+    read_amplification = std::max(read_amplification, sorted_runs);
+    space_debt += total_size - largest_run;
   }
+  constexpr uint64_t kMaxHalf = std::numeric_limits<uint32_t>::max();
+  const int64_t priority = static_cast<int64_t>(
+      (std::min(read_amplification, kMaxHalf >> 1) << 32) |
+      std::min(space_debt / (1024 * 1024), kMaxHalf));
+  compaction_priority_.store(priority, std::memory_order_relaxed);
 }
 
 int DBImpl::BGCompactionsAllowed() const {
@@ -3592,54 +3704,81 @@ std::vector<Status> DBImpl::MultiGet(
   }
   mutex_.Unlock();
 
-  // Contain a list of merge operations if merge occurs.
-  MergeContext merge_context;
-
   // Note: this always resizes the values array
   size_t num_keys = keys.size();
   std::vector<Status> stat_list(num_keys);
   values->resize(num_keys);
 
+  // Keys are processed grouped by column family and sorted by user key, so SST files are visited
+  // once per batch and consecutive keys share index and data blocks.
+  std::vector<size_t> order(num_keys);
+  std::iota(order.begin(), order.end(), 0);
+  auto cfd_of = [&column_family](size_t i) {
+    return down_cast<ColumnFamilyHandleImpl*>(column_family[i])->cfd();
+  };
+  std::stable_sort(order.begin(), order.end(), [&keys, &cfd_of](size_t lhs, size_t rhs) {
+    auto lhs_cfd = cfd_of(lhs);
+    auto rhs_cfd = cfd_of(rhs);
+    if (lhs_cfd->GetID() != rhs_cfd->GetID()) {
+      return lhs_cfd->GetID() < rhs_cfd->GetID();
+    }
+    return lhs_cfd->user_comparator()->Compare(keys[lhs], keys[rhs]) < 0;
+  });
+
+  // Contain a list of merge operations if merge occurs.
+  std::vector<MergeContext> merge_contexts(num_keys);
+  std::deque<LookupKey> lookup_keys;
+  std::vector<Version::GetRequest> requests;
+
   // Keep track of bytes that we read for statistics-recording later
   uint64_t bytes_read = 0;
   PERF_TIMER_STOP(get_snapshot_time);
 
-  // For each of the given keys, apply the entire "get" process as follows:
-  // First look in the memtable, then in the immutable memtable (if any).
-  // s is both in/out. When in, s could either be OK or MergeInProgress.
-  // merge_operands will contain the sequence of merges in the latter case.
-  for (size_t i = 0; i < num_keys; ++i) {
-    merge_context.Clear();
-    Status& s = stat_list[i];
-    std::string* value = &(*values)[i];
-
-    LookupKey lkey(keys[i], snapshot);
-    auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family[i]);
-    auto mgd_iter = multiget_cf_data.find(cfh->cfd()->GetID());
+  const bool skip_memtable = read_options.read_tier == kPersistedTier && has_unpersisted_data_;
+  for (size_t group_begin = 0; group_begin != num_keys;) {
+    auto cfd = cfd_of(order[group_begin]);
+    auto mgd_iter = multiget_cf_data.find(cfd->GetID());
     assert(mgd_iter != multiget_cf_data.end());
-    auto mgd = mgd_iter->second;
-    auto super_version = mgd->super_version;
-    bool skip_memtable =
-        (read_options.read_tier == kPersistedTier && has_unpersisted_data_);
-    bool done = false;
-    if (!skip_memtable) {
-      if (super_version->mem->Get(lkey, value, &s, &merge_context)) {
-        done = true;
-        // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
-      } else if (super_version->imm->Get(lkey, value, &s, &merge_context)) {
-        done = true;
-        // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
+    auto super_version = mgd_iter->second->super_version;
+    size_t group_end = group_begin;
+
+    // For each of the given keys, first look in the memtable, then in the immutable memtable
+    // (if any). s is both in/out. When in, s could either be OK or MergeInProgress.
+    // merge_operands will contain the sequence of merges in the latter case.
+    // Keys that were not found in memtables are looked up in SST files as a single batch.
+    requests.clear();
+    for (; group_end != num_keys && cfd_of(order[group_end]) == cfd; ++group_end) {
+      const size_t i = order[group_end];
+      Status& s = stat_list[i];
+      std::string* value = &(*values)[i];
+      lookup_keys.emplace_back(keys[i], snapshot);
+      const LookupKey& lkey = lookup_keys.back();
+      bool done = false;
+      if (!skip_memtable) {
+        if (super_version->mem->Get(lkey, value, &s, &merge_contexts[i])) {
+          done = true;
+          // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
+        } else if (super_version->imm->Get(lkey, value, &s, &merge_contexts[i])) {
+          done = true;
+          // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
+        }
+      }
+      if (!done) {
+        requests.push_back({&lkey, value, &s, &merge_contexts[i]});
       }
     }
-    if (!done) {
+
+    if (!requests.empty()) {
       PERF_TIMER_GUARD(get_from_output_files_time);
-      super_version->current->Get(read_options, lkey, value, &s,
-                                  &merge_context);
+      super_version->current->MultiGet(read_options, requests);
       // TODO(?): RecordTick(stats_, MEMTABLE_MISS)?
     }
 
-    if (s.ok()) {
-      bytes_read += value->size();
+    for (; group_begin != group_end; ++group_begin) {
+      const size_t i = order[group_begin];
+      if (stat_list[i].ok()) {
+        bytes_read += (*values)[i].size();
+      }
     }
   }
 
@@ -4387,6 +4526,10 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   if (write_options.timeout_hint_us != 0) {
     return STATUS(InvalidArgument, "timeout_hint_us is deprecated");
   }
+  if (my_batch->direct_writer() && !write_options.disableWAL) {
+    // Entries of direct writer are not present in batch representation, written to WAL.
+    return STATUS(NotSupported, "Direct writer requires disabled WAL");
+  }
 
   Status status;
 
@@ -5222,6 +5365,23 @@ Status DBImpl::Import(const std::string& source_dir) {
   return ApplyVersionEdit(&edit);
 }
 
+yb::Result<std::string> DBImpl::GetMiddleKey() {
+  auto cfd = default_cf_handle_->cfd();
+
+  mutex_.Lock();
+  auto version = cfd->current();
+  version->Ref();
+  mutex_.Unlock();
+
+  auto result = version->GetMiddleKey();
+
+  mutex_.Lock();
+  version->Unref();
+  mutex_.Unlock();
+
+  return result;
+}
+
 void DBImpl::TEST_SwitchMemtable() {
   std::lock_guard<InstrumentedMutex> lock(mutex_);
   WriteContext context;
@@ -5961,6 +6121,11 @@ Status DestroyDB(const std::string& dbname, const Options& options) {
     env->DeleteFile(lockname);
     env->DeleteDir(dbname);  // Ignore error in case dir contains other files
     env->DeleteDir(soptions.wal_dir);
+    for (const auto& db_path : options.db_paths) {
+      if (db_path.path != dbname) {
+        env->DeleteDir(db_path.path);
+      }
+    }
   }
   return result;
 }
@@ -459,6 +459,8 @@ class DBImpl : public DB {
   // And max seqno of imported database is less that active seqno of destination db.
   CHECKED_STATUS Import(const std::string& source_dir) override;
 
+  yb::Result<std::string> GetMiddleKey() override;
+
   // Used in testing to make the old memtable immutable and start writing to a new one.
   void TEST_SwitchMemtable() override;
 
@@ -487,7 +489,7 @@ class DBImpl : public DB {
 
   void NotifyOnFlushCompleted(ColumnFamilyData* cfd, FileMetaData* file_meta,
                               const MutableCFOptions& mutable_cf_options,
-                              int job_id, TableProperties prop);
+                              int job_id, TableProperties prop, uint64_t elapsed_micros);
 
   void NotifyOnCompactionCompleted(ColumnFamilyData* cfd,
                                    Compaction *c, const Status &st,
@@ -872,6 +874,19 @@ class DBImpl : public DB {
     ManualCompaction* m;
   };
 
+  class CompactionTask;
+
+  // Schedules compaction to env or to priority_thread_pool_for_compactions.
+  // REQUIRES: mutex held. bg_compaction_scheduled_ already accounts this compaction.
+  void ScheduleCompaction(CompactionArg* ca);
+  // Recalculates compaction_priority_ from the current versions of column families.
+  // REQUIRES: mutex held.
+  void UpdateCompactionPriority();
+
+  // Priority of automatic compactions of this DB in priority_thread_pool_for_compactions.
+  // Read amplification in the upper half and space debt in megabytes in the lower half.
+  std::atomic<int64_t> compaction_priority_{0};
+
   // Have we encountered a background error in paranoid mode?
   Status bg_error_;
 
@@ -85,6 +85,8 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/rocksdb/util/mock_env.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 #include "yb/rocksdb/util/xfunc.h"
@@ -5063,6 +5065,159 @@ TEST_F(DBTest, MultiGetSimple) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBTest, MultiGetFromFiles) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  const int kNumKeys = 200;
+  auto key = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%05d", i);
+    return std::string(buf);
+  };
+  for (int cf = 0; cf != 2; ++cf) {
+    // Bottom level file with all keys, overwritten later by level 0 files and memtable.
+    for (int i = 0; i != kNumKeys; ++i) {
+      ASSERT_OK(Put(cf, key(i), "base" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush(cf));
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), handles_[cf], nullptr, nullptr));
+    for (int i = 0; i < kNumKeys; i += 3) {
+      ASSERT_OK(Put(cf, key(i), "l0_" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush(cf));
+    for (int i = 0; i < kNumKeys; i += 7) {
+      ASSERT_OK(Delete(cf, key(i)));
+    }
+    ASSERT_OK(Flush(cf));
+    for (int i = 0; i < kNumKeys; i += 11) {
+      ASSERT_OK(Put(cf, key(i), "mem" + std::to_string(i)));
+    }
+  }
+
+  // Unsorted keys from both column families, with duplicates and missing keys.
+  std::vector<std::string> key_strings;
+  std::vector<ColumnFamilyHandle*> cfs;
+  for (int i = kNumKeys + 10; i-- > 0;) {
+    const int k = (i * 37) % (kNumKeys + 10);
+    key_strings.push_back(key(k));
+    cfs.push_back(handles_[i % 2]);
+    if (i % 5 == 0) {
+      key_strings.push_back(key(k));
+      cfs.push_back(handles_[(i + 1) % 2]);
+    }
+  }
+  std::vector<Slice> keys(key_strings.begin(), key_strings.end());
+
+  std::vector<std::string> values;
+  std::vector<Status> statuses = db_->MultiGet(ReadOptions(), cfs, keys, &values);
+  ASSERT_EQ(keys.size(), statuses.size());
+  ASSERT_EQ(keys.size(), values.size());
+  for (size_t i = 0; i != keys.size(); ++i) {
+    std::string expected;
+    Status s = db_->Get(ReadOptions(), cfs[i], keys[i], &expected);
+    ASSERT_EQ(s.ToString(), statuses[i].ToString()) << keys[i].ToString();
+    if (s.ok()) {
+      ASSERT_EQ(expected, values[i]) << keys[i].ToString();
+    }
+  }
+}
+
+namespace {
+
+class SkipFileFilter : public ReadFileFilter {
+ public:
+  explicit SkipFileFilter(uint64_t skipped_file_number)
+      : skipped_file_number_(skipped_file_number) {}
+
+  bool Filter(const FdWithBoundaries& file) const override {
+    return file.fd.GetNumber() != skipped_file_number_;
+  }
+
+ private:
+  uint64_t skipped_file_number_;
+};
+
+} // namespace
+
+TEST_F(DBTest, FileFilter) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  auto last_file_number = [this] {
+    std::vector<LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+    uint64_t result = 0;
+    for (const auto& file : files) {
+      uint64_t number = 0;
+      FileType type;
+      EXPECT_TRUE(ParseFileName(file.name.substr(1), &number, &type)) << file.name;
+      result = std::max(result, number);
+    }
+    return result;
+  };
+  auto check = [this](const ReadOptions& read_options, const std::string& expected) {
+    std::string value;
+    Status s = db_->Get(read_options, "key", &value);
+    ASSERT_EQ(expected.empty(), s.IsNotFound()) << s;
+    ASSERT_EQ(expected, value);
+
+    std::vector<std::string> values;
+    auto statuses = db_->MultiGet(read_options, {"key"}, &values);
+    ASSERT_EQ(expected.empty(), statuses[0].IsNotFound()) << statuses[0];
+    ASSERT_EQ(expected, values[0]);
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    iter->SeekToFirst();
+    ASSERT_EQ(!expected.empty(), iter->Valid());
+    if (iter->Valid()) {
+      ASSERT_EQ(expected, iter->value().ToBuffer());
+    }
+  };
+
+  ASSERT_OK(Put("key", "v1"));
+  ASSERT_OK(Flush());
+  const auto first_file = last_file_number();
+  ASSERT_OK(Put("key", "v2"));
+  ASSERT_OK(Flush());
+
+  ReadOptions read_options;
+  check(read_options, "v2");
+  read_options.file_filter = std::make_shared<SkipFileFilter>(last_file_number());
+  check(read_options, "v1");
+  read_options.file_filter = std::make_shared<SkipFileFilter>(first_file);
+  check(read_options, "v2");
+
+  // Files of levels above 0 are also filtered.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  read_options.file_filter = std::make_shared<SkipFileFilter>(last_file_number());
+  check(read_options, "");
+}
+
+TEST_F(DBTest, MemTableMemTracker) {
+  Options options = CurrentOptions();
+  options.memtable_mem_tracker = yb::MemTracker::CreateTracker("memtable");
+  options.memtable_huge_page_size = 2 * 1024 * 1024;
+  Reopen(options);
+
+  const std::string value(1024, 'v');
+  for (int i = 0; i != 100; ++i) {
+    ASSERT_OK(Put(Key(i), value));
+  }
+  const auto consumption = options.memtable_mem_tracker->consumption();
+  ASSERT_GE(consumption, 100 * static_cast<int64_t>(value.size()));
+
+  ASSERT_OK(Flush());
+  ASSERT_LT(options.memtable_mem_tracker->consumption(), consumption);
+  ASSERT_EQ(value, Get(Key(0)));
+
+  Close();
+  ASSERT_EQ(0, options.memtable_mem_tracker->consumption());
+}
+
 TEST_F(DBTest, MultiGetEmpty) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
@@ -5321,6 +5476,156 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+TEST_F(DBTest, ConcurrentMemtableWritesWithFrontiers) {
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.enable_write_thread_adaptive_yield = true;
+  options.create_if_missing = true;
+  DestroyAndReopen(options);
+
+  const int kNumThreads = 8;
+  const int kBatchesPerThread = 200;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = 0; i != kBatchesPerThread; ++i) {
+        const int value = t * kBatchesPerThread + i + 1;
+        WriteBatch batch;
+        test::TestUserFrontiers frontiers(value, value);
+        batch.SetFrontiers(&frontiers);
+        batch.Put(Key(value), std::to_string(value));
+        batch.Put(Key(value) + "_", std::to_string(value));
+        WriteOptions write_options;
+        write_options.disableWAL = true;
+        ASSERT_OK(dbfull()->Write(write_options, &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int value = 1; value <= kNumThreads * kBatchesPerThread; ++value) {
+    ASSERT_EQ(std::to_string(value), Get(Key(value)));
+    ASSERT_EQ(std::to_string(value), Get(Key(value) + "_"));
+  }
+  ASSERT_OK(dbfull()->TEST_FlushMemTable(true));
+  ASSERT_EQ(static_cast<uint64_t>(kNumThreads * kBatchesPerThread),
+            down_cast<test::TestUserFrontier&>(*dbfull()->GetFlushedFrontier()).Value());
+}
+
+TEST_F(DBTest, UInt16HashSkipListRep) {
+  Options options = CurrentOptions();
+  options.memtable_factory = std::make_shared<UInt16HashSkipListRepFactory>('G', 4);
+  options.allow_concurrent_memtable_write = true;
+  options.create_if_missing = true;
+  DestroyAndReopen(options);
+
+  // Keys before the hash marker, hash partitioned keys spread over all buckets, short keys and
+  // keys after the hash marker.
+  std::vector<std::string> keys = {"", "A", "F\xff", "G", "G\x01", "H", "Z"};
+  for (int hash = 0; hash < 0x10000; hash += 0x0ff1) {
+    std::string key = "G";
+    key.push_back(static_cast<char>(hash >> 8));
+    key.push_back(static_cast<char>(hash & 0xff));
+    keys.push_back(key);
+    keys.push_back(key + "row");
+  }
+  std::sort(keys.begin(), keys.end());
+  for (size_t i = 0; i != keys.size(); ++i) {
+    ASSERT_OK(Put(keys[i], std::to_string(i)));
+  }
+
+  for (size_t i = 0; i != keys.size(); ++i) {
+    ASSERT_EQ(std::to_string(i), Get(keys[i]));
+  }
+  ASSERT_EQ("NOT_FOUND", Get("G\x01\x01"));
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  size_t index = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++index) {
+    ASSERT_LT(index, keys.size());
+    ASSERT_EQ(keys[index], iter->key().ToString());
+  }
+  ASSERT_EQ(keys.size(), index);
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    ASSERT_GT(index, 0U);
+    ASSERT_EQ(keys[--index], iter->key().ToString());
+  }
+  ASSERT_EQ(0U, index);
+
+  // Seek into an empty bucket moves to the next non empty one.
+  iter->Seek("G\x01\x01");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(*std::upper_bound(keys.begin(), keys.end(), "G\x01\x01"), iter->key().ToString());
+}
+
+TEST_F(DBTest, PriorityThreadPoolCompactions) {
+  yb::PriorityThreadPool pool(1);
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.level0_file_num_compaction_trigger = 2;
+  options.priority_thread_pool_for_compactions = &pool;
+  DestroyAndReopen(options);
+
+  for (int file = 0; file != 6; ++file) {
+    for (int i = 0; i != 10; ++i) {
+      ASSERT_OK(Put(Key(file * 10 + i), "value" + std::to_string(file)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_LT(NumTableFilesAtLevel(0), 6);
+  ASSERT_EQ(0, pool.NumQueuedTasks());
+  for (int i = 0; i != 60; ++i) {
+    ASSERT_EQ("value" + std::to_string(i / 10), Get(Key(i)));
+  }
+
+  // Manual compactions are also executed by the pool.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  Close();
+}
+
+TEST_F(DBTest, ThreeSharedPartsKeyEncoding) {
+  Options options = CurrentOptions();
+  BlockBasedTableOptions table_options;
+  table_options.data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.create_if_missing = true;
+  DestroyAndReopen(options);
+
+  const int kNumRows = 1000;
+  const int kNumColumns = 5;
+  auto key = [](int row, int column) {
+    return "row_" + std::to_string(row) + "_" + std::to_string(column) + "_time";
+  };
+  for (int row = 0; row != kNumRows; ++row) {
+    for (int column = 0; column != kNumColumns; ++column) {
+      ASSERT_OK(Put(key(row, column), std::to_string(row * kNumColumns + column)));
+    }
+  }
+  ASSERT_OK(Flush());
+
+  // Format is taken from the table properties, so files are readable with any options.
+  options.table_factory.reset(NewBlockBasedTableFactory(BlockBasedTableOptions()));
+  Reopen(options);
+  for (int row = 0; row != kNumRows; ++row) {
+    for (int column = 0; column != kNumColumns; ++column) {
+      ASSERT_EQ(std::to_string(row * kNumColumns + column), Get(key(row, column)));
+    }
+  }
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++count;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumRows * kNumColumns, count);
+}
+
 #endif  // ROCKSDB_LITE
 
 TEST_F(DBTest, SanitizeNumThreads) {
@@ -72,6 +72,32 @@ TEST_F(DBTest2, IteratorPropertyVersionNumber) {
   delete iter2;
   delete iter3;
 }
+
+TEST_F(DBTest2, GetMiddleKey) {
+  Options options = CurrentOptions();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.compression = kNoCompression;
+  DestroyAndReopen(options);
+
+  auto result = db_->GetMiddleKey();
+  ASSERT_NOK(result);
+  ASSERT_TRUE(result.status().IsIncomplete()) << result.status();
+
+  Random rnd(301);
+  const int kNumKeys = 10000;
+  for (int i = 0; i != kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 100)));
+  }
+  ASSERT_OK(Flush());
+
+  // Keys and values have the same size, so middle key should be close to the middle of key range.
+  auto middle_key = db_->GetMiddleKey();
+  ASSERT_OK(middle_key.status());
+  ASSERT_GT(*middle_key, Key(kNumKeys * 4 / 10));
+  ASSERT_LT(*middle_key, Key(kNumKeys * 6 / 10));
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -83,6 +83,9 @@ inline bool IsValueType(ValueType t) {
 static const SequenceNumber kMaxSequenceNumber =
     ((0x1ull << 56) - 1);
 
+// Size of the packed sequence number and value type, that follow user key in internal key.
+constexpr size_t kLastInternalComponentSize = 8;
+
 struct ParsedInternalKey {
   Slice user_key;
   SequenceNumber sequence;
@@ -375,6 +378,46 @@ class IterKey {
     key_size_ = total_size;
   }
 
+  // Used in Block::Iter::ParseNextKey for kKeyDeltaEncodingThreeSharedParts format.
+  // Replaces current internal key with:
+  // <shared_prefix_len bytes of current key><non_shared_1>
+  // <shared_middle_len bytes of current user key, that end non_shared_2.size() bytes before its
+  //  end><non_shared_2><trailer>
+  void UpdateWithThreeSharedParts(
+      const size_t shared_prefix_len, const Slice& non_shared_1, const size_t shared_middle_len,
+      const Slice& non_shared_2, const uint64_t trailer) {
+    assert(key_size_ >= kLastInternalComponentSize);
+    const size_t user_key_size = key_size_ - kLastInternalComponentSize;
+    assert(shared_prefix_len <= user_key_size);
+    assert(shared_middle_len + non_shared_2.size() <= user_key_size);
+    const char* shared_middle = key_ + user_key_size - non_shared_2.size() - shared_middle_len;
+    const size_t middle_pos = shared_prefix_len + non_shared_1.size();
+    const size_t total_size =
+        middle_pos + shared_middle_len + non_shared_2.size() + kLastInternalComponentSize;
+
+    if (!IsKeyPinned() && total_size <= buf_size_) {
+      // Shared prefix is already in place, and shared middle could overlap with its destination.
+      memmove(buf_ + middle_pos, shared_middle, shared_middle_len);
+    } else {
+      char* p = total_size <= buf_size_ ? buf_ : new char[total_size];
+      memcpy(p, key_, shared_prefix_len);
+      memcpy(p + middle_pos, shared_middle, shared_middle_len);
+      if (p != buf_) {
+        if (buf_ != space_) {
+          delete[] buf_;
+        }
+        buf_ = p;
+        buf_size_ = total_size;
+      }
+    }
+
+    memcpy(buf_ + shared_prefix_len, non_shared_1.data(), non_shared_1.size());
+    memcpy(buf_ + middle_pos + shared_middle_len, non_shared_2.data(), non_shared_2.size());
+    EncodeFixed64(buf_ + total_size - kLastInternalComponentSize, trailer);
+    key_ = buf_;
+    key_size_ = total_size;
+  }
+
   Slice SetKey(const Slice& key, bool copy = true) {
     size_t size = key.size();
     if (copy) {
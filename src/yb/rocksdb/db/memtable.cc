@@ -62,6 +62,7 @@ MemTableOptions::MemTableOptions(
         mutable_cf_options.memtable_prefix_bloom_probes),
     memtable_prefix_bloom_huge_page_tlb_size(
         mutable_cf_options.memtable_prefix_bloom_huge_page_tlb_size),
+    memtable_huge_page_size(mutable_cf_options.memtable_huge_page_size),
     inplace_update_support(ioptions.inplace_update_support),
     inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
     inplace_callback(ioptions.inplace_callback),
@@ -79,7 +80,7 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
       moptions_(ioptions, mutable_cf_options),
       refs_(0),
       kArenaBlockSize(OptimizeBlockSize(moptions_.arena_block_size)),
-      arena_(moptions_.arena_block_size, 0),
+      arena_(moptions_.arena_block_size, moptions_.memtable_huge_page_size),
       allocator_(&arena_, write_buffer),
       table_(ioptions.memtable_factory->CreateMemTableRep(
           comparator_, &allocator_, ioptions.prefix_extractor,
@@ -383,16 +384,36 @@ uint64_t MemTable::ApproximateSize(const Slice& start_ikey,
   return entry_count * (data_size / n);
 }
 
+namespace {
+
+size_t SumSizes(const SliceParts& parts) {
+  size_t result = 0;
+  for (int i = 0; i != parts.num_parts; ++i) {
+    result += parts.parts[i].size();
+  }
+  return result;
+}
+
+char* CopyParts(const SliceParts& parts, char* out) {
+  for (int i = 0; i != parts.num_parts; ++i) {
+    memcpy(out, parts.parts[i].data(), parts.parts[i].size());
+    out += parts.parts[i].size();
+  }
+  return out;
+}
+
+} // namespace
+
 void MemTable::Add(SequenceNumber s, ValueType type,
-                   const Slice& key, /* user key */
-                   const Slice& value, bool allow_concurrent) {
+                   const SliceParts& key_parts, /* user key */
+                   const SliceParts& value_parts, bool allow_concurrent) {
   // Format of an entry is concatenation of:
   //  key_size     : varint32 of internal_key.size()
   //  key bytes    : char[internal_key.size()]
   //  value_size   : varint32 of value.size()
   //  value bytes  : char[value.size()]
-  uint32_t key_size = static_cast<uint32_t>(key.size());
-  uint32_t val_size = static_cast<uint32_t>(value.size());
+  uint32_t key_size = static_cast<uint32_t>(SumSizes(key_parts));
+  uint32_t val_size = static_cast<uint32_t>(SumSizes(value_parts));
   uint32_t internal_key_size = key_size + 8;
   const uint32_t encoded_len = VarintLength(internal_key_size) +
                                internal_key_size + VarintLength(val_size) +
@@ -401,14 +422,15 @@ void MemTable::Add(SequenceNumber s, ValueType type,
   KeyHandle handle = table_->Allocate(encoded_len, &buf);
 
   char* p = EncodeVarint32(buf, internal_key_size);
-  memcpy(p, key.data(), key_size);
-  p += key_size;
+  // Key copied to the memtable entry, used by prefix bloom.
+  const Slice key(p, key_size);
+  p = CopyParts(key_parts, p);
   uint64_t packed = PackSequenceAndType(s, type);
   EncodeFixed64(p, packed);
   p += 8;
   p = EncodeVarint32(p, val_size);
-  memcpy(p, value.data(), val_size);
-  assert((unsigned)(p + val_size - buf) == (unsigned)encoded_len);
+  p = CopyParts(value_parts, p);
+  assert((unsigned)(p - buf) == (unsigned)encoded_len);
   if (!allow_concurrent) {
     table_->Insert(handle);
 
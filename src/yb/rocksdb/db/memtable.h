@@ -30,6 +30,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -63,6 +64,7 @@ struct MemTableOptions {
   uint32_t memtable_prefix_bloom_bits;
   uint32_t memtable_prefix_bloom_probes;
   size_t memtable_prefix_bloom_huge_page_tlb_size;
+  size_t memtable_huge_page_size;
   bool inplace_update_support;
   size_t inplace_update_num_locks;
   UpdateStatus (*inplace_callback)(char* existing_value,
@@ -181,7 +183,13 @@ class MemTable {
   // REQUIRES: if allow_concurrent = false, external synchronization to prevent
   // simultaneous operations on the same MemTable.
   void Add(SequenceNumber seq, ValueType type, const Slice& key,
-           const Slice& value, bool allow_concurrent = false);
+           const Slice& value, bool allow_concurrent = false) {
+    Add(seq, type, SliceParts(&key, 1), SliceParts(&value, 1), allow_concurrent);
+  }
+
+  // Same as above, but key and value are concatenations of their parts.
+  void Add(SequenceNumber seq, ValueType type, const SliceParts& key,
+           const SliceParts& value, bool allow_concurrent = false);
 
   // If memtable contains a value for key, store it in *value and return true.
   // If memtable contains a deletion for key, store a NotFound() error
@@ -333,13 +341,16 @@ class MemTable {
 
   const MemTableOptions* GetMemTableOptions() const { return &moptions_; }
 
+  // Could be invoked concurrently, when allow_concurrent_memtable_write is enabled.
   void UpdateFrontiers(const UserFrontiers& value) {
+    std::lock_guard<std::mutex> lock(frontiers_mutex_);
     if (frontiers_) {
       frontiers_->Merge(value);
     } else {
       frontiers_ = value.Clone();
     }
   }
+  // Should be used only after all writes to this memtable are finished.
   const UserFrontiers* Frontiers() const { return frontiers_.get(); }
 
   std::string ToString() const;
@@ -394,6 +405,7 @@ class MemTable {
 
   Env* env_;
 
+  std::mutex frontiers_mutex_;
   std::unique_ptr<UserFrontiers> frontiers_;
 
   // Returns a heuristic flush decision
@@ -52,6 +52,7 @@ int main() {
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/util/arena.h"
+#include "yb/rocksdb/util/hash.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/testutil.h"
@@ -80,7 +81,8 @@ DEFINE_string(memtablerep, "skiplist",
               "\tvector              -- backed by an std::vector\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
-              "\tcuckoo              -- backed by a cuckoo hash table");
+              "\tcuckoo              -- backed by a cuckoo hash table\n"
+              "\tuint16hashskiplist  -- backed by skip lists partitioned by 16 bit key hash");
 
 DEFINE_int64(bucket_count, 1000000,
              "bucket_count parameter to pass into NewHashSkiplistRepFactory or "
@@ -122,6 +124,19 @@ DEFINE_int64(
     hash_function_count, 4,
     "hash_function_count parameter to pass into NewHashCuckooRepFactory");
 
+DEFINE_int32(uint16hash_bucket_bits, 10,
+             "bucket_bits parameter to pass into UInt16HashSkipListRepFactory");
+
+DEFINE_int64(arena_block_size, 4096,
+             "Block size of the arena that memtablerep allocates from");
+
+DEFINE_int64(huge_page_size, 0,
+             "When positive, arena blocks are allocated from huge pages of this size");
+
+DEFINE_bool(docdb_keys, false,
+            "Use keys shaped like DocDB keys of hash partitioned tables: hash marker, 16 bit "
+            "hash, and a range component, instead of 8 byte integers.");
+
 DEFINE_int32(
     num_threads, 1,
     "Number of concurrent threads to run. If the benchmark includes writes,\n"
@@ -185,6 +200,34 @@ class RandomGenerator {
 
 enum WriteMode { SEQUENTIAL, RANDOM, UNIQUE_RANDOM };
 
+// DocDB hash partitioned keys start with this marker followed by the big endian 16 bit hash.
+constexpr char kDocDBHashMarker = 'G';
+// Size of DocDB shaped user key: marker, hash, range component type, 8 byte value and group end.
+constexpr size_t kDocDBUserKeySize = 1 + 2 + 1 + 8 + 1;
+
+size_t UserKeySize() {
+  return FLAGS_docdb_keys ? kDocDBUserKeySize : 8;
+}
+
+// Encodes user key for the specified key number into buf, that should have UserKeySize() bytes.
+void EncodeUserKey(uint64_t key, char* buf) {
+  if (!FLAGS_docdb_keys) {
+    EncodeFixed64(buf, key);
+    return;
+  }
+  char fixed[8];
+  EncodeFixed64(fixed, key);
+  const uint16_t hash = static_cast<uint16_t>(Hash(fixed, sizeof(fixed), 0));
+  *buf++ = kDocDBHashMarker;
+  *buf++ = static_cast<char>(hash >> 8);
+  *buf++ = static_cast<char>(hash);
+  *buf++ = 'I';
+  for (int i = 7; i >= 0; --i) {
+    *buf++ = static_cast<char>(key >> (i * 8));
+  }
+  *buf = '!';
+}
+
 class KeyGenerator {
  public:
   KeyGenerator(Random64* rand, WriteMode mode, uint64_t num)
@@ -263,15 +306,15 @@ class FillBenchmarkThread : public BenchmarkThread {
 
   void FillOne() {
     char* buf = nullptr;
-    auto internal_key_size = 16;
+    auto internal_key_size = static_cast<uint32_t>(UserKeySize() + 8);
     auto encoded_len =
         FLAGS_item_size + VarintLength(internal_key_size) + internal_key_size;
     KeyHandle handle = table_->Allocate(encoded_len, &buf);
     assert(buf != nullptr);
     char* p = EncodeVarint32(buf, internal_key_size);
     auto key = key_gen_->Next();
-    EncodeFixed64(p, key);
-    p += 8;
+    EncodeUserKey(key, p);
+    p += UserKeySize();
     EncodeFixed64(p, ++(*sequence_));
     p += 8;
     Slice bytes = generator_.Generate(FLAGS_item_size);
@@ -336,9 +379,9 @@ class ReadBenchmarkThread : public BenchmarkThread {
   }
 
   void ReadOne() {
-    std::string user_key;
+    std::string user_key(UserKeySize(), 0);
     auto key = key_gen_->Next();
-    PutFixed64(&user_key, key);
+    EncodeUserKey(key, &user_key[0]);
     LookupKey lookup_key(user_key, *sequence_);
     InternalKeyComparator internal_key_comp(BytewiseComparator());
     CallbackVerifyArgs verify_args;
@@ -348,7 +391,7 @@ class ReadBenchmarkThread : public BenchmarkThread {
     verify_args.comparator = &internal_key_comp;
     table_->Get(lookup_key, &verify_args, callback);
     if (verify_args.found) {
-      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+      *bytes_read_ += VarintLength(UserKeySize() + 8) + UserKeySize() + 8 + FLAGS_item_size;
       ++*read_hits_;
     }
   }
@@ -372,7 +415,7 @@ class SeqReadBenchmarkThread : public BenchmarkThread {
     std::unique_ptr<MemTableRep::Iterator> iter(table_->GetIterator());
     for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
       // pretend to read the value
-      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+      *bytes_read_ += VarintLength(UserKeySize() + 8) + UserKeySize() + 8 + FLAGS_item_size;
     }
     ++*read_hits_;
   }
@@ -629,6 +672,9 @@ int main(int argc, char** argv) {
     options.prefix_extractor.reset(
         rocksdb::NewFixedPrefixTransform(FLAGS_prefix_length));
 #endif  // ROCKSDB_LITE
+  } else if (FLAGS_memtablerep == "uint16hashskiplist") {
+    factory.reset(new rocksdb::UInt16HashSkipListRepFactory(
+        rocksdb::kDocDBHashMarker, FLAGS_uint16hash_bucket_bits));
   } else {
     fprintf(stdout, "Unknown memtablerep: %s\n", FLAGS_memtablerep.c_str());
     exit(1);
@@ -637,7 +683,7 @@ int main(int argc, char** argv) {
   rocksdb::InternalKeyComparator internal_key_comp(
       rocksdb::BytewiseComparator());
   rocksdb::MemTable::KeyComparator key_comp(internal_key_comp);
-  rocksdb::Arena arena;
+  rocksdb::Arena arena(FLAGS_arena_block_size, FLAGS_huge_page_size);
   rocksdb::WriteBuffer wb(FLAGS_write_buffer_size);
   rocksdb::MemTableAllocator memtable_allocator(&arena, &wb);
   uint64_t sequence;
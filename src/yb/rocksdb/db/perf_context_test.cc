@@ -604,6 +604,39 @@ TEST_F(PerfContextTest, FalseDBMutexWait) {
   }
 }
 
+TEST_F(PerfContextTest, ReadCounters) {
+  DestroyDB(kDbName, Options());
+  auto db = OpenDb();
+  const uint64_t kNumKeys = 10;
+  for (uint64_t i = 0; i != kNumKeys; ++i) {
+    ASSERT_OK(db->Put(WriteOptions(), "k" + ToString(i), "v" + ToString(i)));
+  }
+  ASSERT_OK(db->Flush(FlushOptions()));
+
+  perf_context.Reset();
+  {
+    std::unique_ptr<Iterator> iter(db->NewIterator(ReadOptions()));
+    uint64_t num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++num_keys;
+    }
+    ASSERT_EQ(kNumKeys, num_keys);
+    iter->SeekToLast();
+    iter->Prev();
+    iter->Seek("k5");
+  }
+  ASSERT_EQ(3U, perf_context.iter_seek_count);
+  ASSERT_EQ(kNumKeys, perf_context.iter_next_count);
+  ASSERT_EQ(1U, perf_context.iter_prev_count);
+  ASSERT_EQ(1U, perf_context.sst_file_read_count);
+
+  perf_context.Reset();
+  std::string value;
+  ASSERT_OK(db->Get(ReadOptions(), "k1", &value));
+  ASSERT_EQ(1U, perf_context.sst_file_read_count);
+  ASSERT_EQ(0U, perf_context.iter_seek_count);
+}
+
 TEST_F(PerfContextTest, ToString) {
   perf_context.Reset();
   perf_context.block_read_count = 12345;
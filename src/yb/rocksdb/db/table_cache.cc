@@ -137,13 +137,26 @@ Status TableCache::GetTableReader(
     const InternalKeyComparatorPtr& internal_comparator, const FileDescriptor& fd,
     bool sequential_mode, bool record_read_stats, HistogramImpl* file_read_hist,
     unique_ptr<TableReader>* table_reader, bool skip_filters) {
-  const std::string base_fname = TableFileName(ioptions_.db_paths, fd.GetNumber(), fd.GetPathId());
+  std::string base_fname = TableFileName(ioptions_.db_paths, fd.GetNumber(), fd.GetPathId());
 
   Status s;
   {
     unique_ptr<RandomAccessFileReader> base_file_reader;
     s = NewFileReader(ioptions_, env_options, base_fname, sequential_mode, record_read_stats,
         file_read_hist, &base_file_reader);
+    if (!s.ok() && ioptions_.db_paths.size() > 1) {
+      // Checkpoint places all files into a single directory, so after restore the file could
+      // reside in another path than the one it was written to.
+      for (const auto& db_path : ioptions_.db_paths) {
+        auto fname = MakeTableFileName(db_path.path, fd.GetNumber());
+        if (fname != base_fname && ioptions_.env->FileExists(fname).ok()) {
+          base_fname = fname;
+          s = NewFileReader(ioptions_, env_options, base_fname, sequential_mode,
+              record_read_stats, file_read_hist, &base_file_reader);
+          break;
+        }
+      }
+    }
     if (!s.ok()) {
       return s;
     }
@@ -280,6 +293,7 @@ InternalIterator* TableCache::DoNewIterator(
     const ReadOptions& options, TableReaderWithHandle* trwh, bool for_compaction,
     Arena* arena, bool skip_filters) {
   RecordTick(ioptions_.statistics, NO_TABLE_CACHE_ITERATORS);
+  PERF_COUNTER_ADD(sst_file_read_count, 1);
 
   InternalIterator* result =
       trwh->table_reader->NewIterator(options, arena, skip_filters);
@@ -332,6 +346,7 @@ Status TableCache::Get(const ReadOptions& options,
     const FileDescriptor& fd, const Slice& k,
     GetContext* get_context, HistogramImpl* file_read_hist,
     bool skip_filters) {
+  PERF_COUNTER_ADD(sst_file_read_count, 1);
   TableReader* t = fd.table_reader;
   Status s;
   Cache::Handle* handle = nullptr;
@@ -412,6 +427,51 @@ Status TableCache::Get(const ReadOptions& options,
   return s;
 }
 
+void TableCache::MultiGet(const ReadOptions& options,
+                          const InternalKeyComparatorPtr& internal_comparator,
+                          const FileDescriptor& fd,
+                          std::vector<TableReader::MultiGetEntry>* entries,
+                          HistogramImpl* file_read_hist, bool skip_filters) {
+  if (ioptions_.row_cache) {
+    // Row cache is maintained per key.
+    for (auto& entry : *entries) {
+      entry.status = Get(options, internal_comparator, fd, entry.internal_key, entry.get_context,
+                         file_read_hist, skip_filters);
+    }
+    return;
+  }
+
+  TableReader* t = fd.table_reader;
+  Cache::Handle* handle = nullptr;
+  Status s;
+  if (!t) {
+    s = FindTable(env_options_, internal_comparator, fd, &handle,
+                  options.query_id, options.read_tier == kBlockCacheTier /* no_io */,
+                  true /* record_read_stats */, file_read_hist, skip_filters);
+    if (s.ok()) {
+      t = GetTableReaderFromHandle(handle);
+    }
+  }
+  if (!s.ok()) {
+    const bool may_exist = options.read_tier == kBlockCacheTier && s.IsIncomplete();
+    for (auto& entry : *entries) {
+      if (may_exist) {
+        // Couldn't find Table in cache but treat as kFound if no_io set
+        entry.get_context->MarkKeyMayExist();
+        entry.status = Status::OK();
+      } else {
+        entry.status = s;
+      }
+    }
+    return;
+  }
+
+  t->MultiGet(options, entries, skip_filters);
+  if (handle != nullptr) {
+    ReleaseHandle(handle);
+  }
+}
+
 Status TableCache::GetTableProperties(
     const EnvOptions& env_options,
     const InternalKeyComparatorPtr& internal_comparator, const FileDescriptor& fd,
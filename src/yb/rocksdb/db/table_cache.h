@@ -104,6 +104,13 @@ class TableCache {
              GetContext* get_context, HistogramImpl* file_read_hist = nullptr,
              bool skip_filters = false);
 
+  // Batched version of Get for keys sorted by internal key. Table reader is looked up once for
+  // the whole batch. Result of each lookup is stored into entry status.
+  void MultiGet(const ReadOptions& options,
+                const InternalKeyComparatorPtr& internal_comparator,
+                const FileDescriptor& file_fd, std::vector<TableReader::MultiGetEntry>* entries,
+                HistogramImpl* file_read_hist = nullptr, bool skip_filters = false);
+
   // Evict any entry for the specified file number
   static void Evict(Cache* cache, uint64_t file_number);
 
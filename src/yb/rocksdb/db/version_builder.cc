@@ -337,11 +337,13 @@ class VersionBuilder::Rep {
       }
     };
 
-    if (max_threads <= 1) {
+    // There is no need to start more threads than files to load.
+    const size_t num_threads = std::min<size_t>(std::max(max_threads, 1), files_meta.size());
+    if (num_threads <= 1) {
       load_handlers_func();
     } else {
       std::vector<std::thread> threads;
-      for (int i = 0; i < max_threads; i++) {
+      for (size_t i = 0; i < num_threads; i++) {
         threads.emplace_back(load_handlers_func);
       }
 
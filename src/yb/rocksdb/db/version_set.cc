@@ -33,6 +33,7 @@
 #include <map>
 #include <set>
 #include <climits>
+#include <deque>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -444,8 +445,7 @@ class LevelFileNumIterator : public InternalIterator {
                        const LevelFilesBrief* flevel)
       : icmp_(icmp),
         flevel_(flevel),
-        index_(static_cast<uint32_t>(flevel->num_files)),
-        current_value_(0, 0, 0, 0) {  // Marks as invalid
+        index_(static_cast<uint32_t>(flevel->num_files)) {  // Marks as invalid
   }
 
   bool Valid() const override { return index_ < flevel_->num_files; }
@@ -481,13 +481,11 @@ class LevelFileNumIterator : public InternalIterator {
     return flevel_->files[index_].largest.key;
   }
 
+  // Value refers to the file entry of the level, so file filters could check its boundaries.
   Slice value() const override {
     assert(Valid());
-
-    auto file_meta = flevel_->files[index_];
-    current_value_ = file_meta.fd;
-    return Slice(reinterpret_cast<const char*>(&current_value_),
-                 sizeof(FileDescriptor));
+    return Slice(reinterpret_cast<const char*>(&flevel_->files[index_]),
+                 sizeof(FdWithBoundaries));
   }
 
   Status status() const override { return Status::OK(); }
@@ -496,7 +494,6 @@ class LevelFileNumIterator : public InternalIterator {
   const InternalKeyComparator icmp_;
   const LevelFilesBrief* flevel_;
   uint32_t index_;
-  mutable FileDescriptor current_value_;
 };
 
 class LevelFileIteratorState : public TwoLevelIteratorState {
@@ -518,14 +515,17 @@ class LevelFileIteratorState : public TwoLevelIteratorState {
         skip_filters_(skip_filters) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& meta_handle) override {
-    if (meta_handle.size() != sizeof(FileDescriptor)) {
+    if (meta_handle.size() != sizeof(FdWithBoundaries)) {
       return NewErrorInternalIterator(
           STATUS(Corruption, "FileReader invoked with unexpected value"));
     } else {
-      const FileDescriptor* fd =
-          reinterpret_cast<const FileDescriptor*>(meta_handle.data());
+      const FdWithBoundaries* file =
+          reinterpret_cast<const FdWithBoundaries*>(meta_handle.data());
+      if (read_options_.file_filter && !read_options_.file_filter->Filter(*file)) {
+        return NewEmptyInternalIterator();
+      }
       return table_cache_->NewIterator(
-          read_options_, env_options_, icomparator_, *fd,
+          read_options_, env_options_, icomparator_, file->fd,
           nullptr /* don't need reference to table*/, file_read_hist_,
           for_compaction_, nullptr /* arena */, skip_filters_);
     }
@@ -653,6 +653,37 @@ Status Version::GetPropertiesOfAllTables(TablePropertiesCollection* props,
   return Status::OK();
 }
 
+yb::Result<std::string> Version::GetMiddleKey() {
+  const FileMetaData* largest_file = nullptr;
+  for (int level = 0; level < storage_info_.num_levels_; level++) {
+    for (const auto* file_meta : storage_info_.files_[level]) {
+      if (largest_file == nullptr ||
+          file_meta->fd.GetTotalFileSize() > largest_file->fd.GetTotalFileSize()) {
+        largest_file = file_meta;
+      }
+    }
+  }
+  if (largest_file == nullptr) {
+    return STATUS(Incomplete, "No SST files");
+  }
+
+  auto table_cache = cfd_->table_cache();
+  Cache::Handle* table_handle = nullptr;
+  TableReader* table_reader = largest_file->fd.table_reader;
+  if (table_reader == nullptr) {
+    RETURN_NOT_OK(table_cache->FindTable(
+        vset_->env_options_, cfd_->internal_comparator(), largest_file->fd, &table_handle,
+        kDefaultQueryId));
+    table_reader = table_cache->GetTableReaderFromHandle(table_handle);
+  }
+  auto result = table_reader->GetMiddleKey();
+  if (table_handle != nullptr) {
+    table_cache->ReleaseHandle(table_handle);
+  }
+  RETURN_NOT_OK(result);
+  return ExtractUserKey(*result).ToBuffer();
+}
+
 Status Version::GetPropertiesOfTablesInRange(
     const Range* range, std::size_t n, TablePropertiesCollection* props) const {
   for (int level = 0; level < storage_info_.num_non_empty_levels(); level++) {
@@ -940,6 +971,10 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       user_comparator(), internal_comparator().get());
   FdWithBoundaries* f = fp.GetNextFile();
   while (f != nullptr) {
+    if (read_options.file_filter && !read_options.file_filter->Filter(*f)) {
+      f = fp.GetNextFile();
+      continue;
+    }
     *status = table_cache_->Get(
         read_options, internal_comparator(), f->fd, ikey, &get_context,
         cfd_->internal_stats()->GetFileReadHist(fp.GetHitFileLevel()),
@@ -1001,6 +1036,166 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+void Version::MultiGet(const ReadOptions& read_options, const std::vector<GetRequest>& requests) {
+  const Comparator* ucmp = user_comparator();
+  std::deque<GetContext> get_contexts;
+  // Indexes of requests that should be looked up in the next files.
+  std::vector<size_t> pending;
+  pending.reserve(requests.size());
+  for (size_t i = 0; i != requests.size(); ++i) {
+    const auto& request = requests[i];
+    assert(request.status->ok() || request.status->IsMergeInProgress());
+    assert(i == 0 || ucmp->Compare(requests[i - 1].key->user_key(), request.key->user_key()) <= 0);
+    get_contexts.emplace_back(
+        ucmp, merge_operator_, info_log_, db_statistics_,
+        request.status->ok() ? GetContext::kNotFound : GetContext::kMerge,
+        request.key->user_key(), request.value, nullptr /* value_found */,
+        request.merge_context, env_);
+    // Merge in progress is tracked by get context, so status is only used for errors from now on.
+    *request.status = Status::OK();
+    pending.push_back(i);
+  }
+
+  std::vector<TableReader::MultiGetEntry> entries;
+  std::vector<size_t> entry_requests;
+  // Looks up pending requests with specified indexes in file, and removes finished requests from
+  // pending.
+  auto process_file = [&](int level, size_t file_index, const std::vector<size_t>& indexes) {
+    const LevelFilesBrief& files = storage_info_.level_files_brief_[level];
+    if (read_options.file_filter && !read_options.file_filter->Filter(files.files[file_index])) {
+      return;
+    }
+    entries.clear();
+    entry_requests.clear();
+    for (auto index : indexes) {
+      if (get_contexts[index].State() == GetContext::kNotFound ||
+          get_contexts[index].State() == GetContext::kMerge) {
+        if (requests[index].status->ok()) {
+          entries.push_back({requests[index].key->internal_key(), &get_contexts[index],
+                             Status::OK()});
+          entry_requests.push_back(index);
+        }
+      }
+    }
+    if (entries.empty()) {
+      return;
+    }
+    table_cache_->MultiGet(
+        read_options, internal_comparator(), files.files[file_index].fd, &entries,
+        cfd_->internal_stats()->GetFileReadHist(level),
+        IsFilterSkipped(level, file_index == files.num_files - 1));
+    for (size_t i = 0; i != entries.size(); ++i) {
+      const auto& request = requests[entry_requests[i]];
+      *request.status = entries[i].status;
+      if (!request.status->ok()) {
+        continue;
+      }
+      switch (get_contexts[entry_requests[i]].State()) {
+        case GetContext::kNotFound: FALLTHROUGH_INTENDED;
+        case GetContext::kMerge:
+          break;
+        case GetContext::kFound:
+          if (level == 0) {
+            RecordTick(db_statistics_, GET_HIT_L0);
+          } else if (level == 1) {
+            RecordTick(db_statistics_, GET_HIT_L1);
+          } else {
+            RecordTick(db_statistics_, GET_HIT_L2_AND_UP);
+          }
+          break;
+        case GetContext::kDeleted:
+          // Use empty error message for speed
+          *request.status = STATUS(NotFound, "");
+          break;
+        case GetContext::kCorrupt:
+          *request.status = STATUS(Corruption, "corrupted key for ", request.key->user_key());
+          break;
+      }
+    }
+  };
+  // Requests are finished when they have an error or their get context reached final state.
+  auto remove_finished = [&] {
+    auto is_finished = [&](size_t index) {
+      auto state = get_contexts[index].State();
+      return !requests[index].status->ok() ||
+             (state != GetContext::kNotFound && state != GetContext::kMerge);
+    };
+    pending.erase(std::remove_if(pending.begin(), pending.end(), is_finished), pending.end());
+  };
+
+  std::vector<size_t> file_requests;
+  for (int level = 0; level < storage_info_.num_non_empty_levels_ && !pending.empty(); ++level) {
+    const LevelFilesBrief& files = storage_info_.level_files_brief_[level];
+    if (level == 0) {
+      // Level 0 files could overlap, so they are all checked from newest to oldest.
+      for (size_t file_index = 0; file_index != files.num_files; ++file_index) {
+        const FdWithBoundaries& f = files.files[file_index];
+        file_requests.clear();
+        for (auto index : pending) {
+          const Slice user_key = requests[index].key->user_key();
+          if (ucmp->Compare(user_key, f.smallest.user_key()) >= 0 &&
+              ucmp->Compare(user_key, f.largest.user_key()) <= 0) {
+            file_requests.push_back(index);
+          }
+        }
+        process_file(level, file_index, file_requests);
+      }
+    } else {
+      // Files are sorted and do not overlap, except that the same user key could be the largest
+      // key of one file and the smallest key of the next one. So files and sorted keys are merged.
+      size_t file_index = 0;
+      size_t pos = 0;
+      while (pos != pending.size() && file_index != files.num_files) {
+        const FdWithBoundaries& f = files.files[file_index];
+        file_requests.clear();
+        while (pos != pending.size() &&
+               ucmp->Compare(requests[pending[pos]].key->user_key(), f.smallest.user_key()) < 0) {
+          ++pos;
+        }
+        size_t next_pos = pos;
+        while (next_pos != pending.size() &&
+               ucmp->Compare(requests[pending[next_pos]].key->user_key(),
+                             f.largest.user_key()) <= 0) {
+          file_requests.push_back(pending[next_pos]);
+          ++next_pos;
+        }
+        process_file(level, file_index, file_requests);
+        // Keys equal to the largest key of this file could also be present in the next file.
+        while (pos != next_pos &&
+               ucmp->Compare(requests[pending[pos]].key->user_key(), f.largest.user_key()) < 0) {
+          ++pos;
+        }
+        ++file_index;
+      }
+    }
+    remove_finished();
+  }
+
+  for (auto index : pending) {
+    const auto& request = requests[index];
+    if (!request.status->ok()) {
+      continue;
+    }
+    if (get_contexts[index].State() == GetContext::kMerge) {
+      if (!merge_operator_) {
+        *request.status = STATUS(InvalidArgument, "merge_operator is not properly initialized.");
+        continue;
+      }
+      if (merge_operator_->FullMerge(request.key->user_key(), nullptr,
+                                     request.merge_context->GetOperands(), request.value,
+                                     info_log_)) {
+        *request.status = Status::OK();
+      } else {
+        RecordTick(db_statistics_, NUMBER_MERGE_FAILURES);
+        *request.status = STATUS(Corruption, "could not perform end-of-key merge for ",
+                                 request.key->user_key());
+      }
+    } else {
+      *request.status = STATUS(NotFound, ""); // Use an empty error message for speed
+    }
+  }
+}
+
 bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
   // Reaching the bottom level implies misses at all upper levels, so we'll
   // skip checking the filters when we predict a hit.
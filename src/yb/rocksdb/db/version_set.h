@@ -463,6 +463,22 @@ class Version {
            bool* value_found = nullptr, bool* key_exists = nullptr,
            SequenceNumber* seq = nullptr);
 
+  // Single key lookup of the batch processed by MultiGet, fields have the same meaning as
+  // corresponding arguments of Get.
+  struct GetRequest {
+    const LookupKey* key;
+    std::string* value;
+    Status* status;
+    MergeContext* merge_context;
+  };
+
+  // Batched version of Get. Requests should be sorted by user key.
+  // Instead of picking files for each key separately, keys are distributed between files of each
+  // level, so each file is visited once for all keys that it could contain.
+  //
+  // REQUIRES: lock is not held
+  void MultiGet(const ReadOptions& read_options, const std::vector<GetRequest>& requests);
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options,
@@ -508,6 +524,10 @@ class Version {
   Status GetAggregatedTableProperties(
       std::shared_ptr<const TableProperties>* tp, int level = -1);
 
+  // Returns middle user key of the largest SST file of this version. Used as approximate middle
+  // key of the whole column family.
+  yb::Result<std::string> GetMiddleKey();
+
   uint64_t GetEstimatedActiveKeys() {
     return storage_info_.GetEstimatedActiveKeys();
   }
@@ -134,7 +134,9 @@ WriteBatch::WriteBatch(const std::string& rep)
 WriteBatch::WriteBatch(const WriteBatch& src)
     : content_flags_(src.content_flags_.load(std::memory_order_relaxed)),
       rep_(src.rep_),
-      frontiers_(src.frontiers_) {
+      frontiers_(src.frontiers_),
+      direct_writer_(src.direct_writer_),
+      direct_entries_(src.direct_entries_) {
   if (src.save_points_) {
     save_points_.reset(new SavePoints(*src.save_points_));
   }
@@ -144,7 +146,9 @@ WriteBatch::WriteBatch(WriteBatch&& src)
     : save_points_(std::move(src.save_points_)),
       content_flags_(src.content_flags_.load(std::memory_order_relaxed)),
       rep_(std::move(src.rep_)),
-      frontiers_(std::move(src.frontiers_)) {}
+      frontiers_(std::move(src.frontiers_)),
+      direct_writer_(src.direct_writer_),
+      direct_entries_(src.direct_entries_) {}
 
 WriteBatch& WriteBatch::operator=(const WriteBatch& src) {
   if (&src != this) {
@@ -188,12 +192,22 @@ void WriteBatch::Clear() {
   }
 
   frontiers_ = nullptr;
+  direct_writer_ = nullptr;
+  direct_entries_ = 0;
 }
 
 uint32_t WriteBatch::Count() const {
   return WriteBatchInternal::Count(this);
 }
 
+void WriteBatch::SetDirectWriter(DirectWriter* direct_writer) {
+  DCHECK(direct_writer_ == nullptr);
+  direct_writer_ = direct_writer;
+  direct_entries_ = static_cast<uint32_t>(direct_writer->NumEntries());
+  // Count in header includes direct entries, so sequence numbers are reserved for them.
+  WriteBatchInternal::SetCount(this, WriteBatchInternal::Count(this) + direct_entries_);
+}
+
 uint32_t WriteBatch::ComputeContentFlags() const {
   auto rv = content_flags_.load(std::memory_order_relaxed);
   if ((rv & ContentFlags::DEFERRED) != 0) {
@@ -344,7 +358,7 @@ Status WriteBatch::Iterate(Handler* handler) const {
   if (!s.ok()) {
     return s;
   }
-  if (found != WriteBatchInternal::Count(this)) {
+  if (found + direct_entries_ != WriteBatchInternal::Count(this)) {
     return STATUS(Corruption, "WriteBatch has wrong count");
   } else {
     return Status::OK();
@@ -695,6 +709,20 @@ class MemTableInserter : public WriteBatch::Handler {
     return Status::OK();
   }
 
+  // Direct writes go to the default column family only.
+  void DirectPut(const SliceParts& key, const SliceParts& value) {
+    Status seek_status;
+    if (!SeekToColumnFamily(0, &seek_status)) {
+      ++sequence_;
+      return;
+    }
+    MemTable* mem = cf_mems_->GetMemTable();
+    DCHECK(!mem->GetMemTableOptions()->inplace_update_support);
+    mem->Add(CurrentSequenceNumber(), kTypeValue, key, value, concurrent_memtable_writes_);
+    sequence_++;
+    CheckMemtableFull();
+  }
+
   CHECKED_STATUS DeleteImpl(uint32_t column_family_id, const Slice& key,
                             ValueType delete_type) {
     Status seek_status;
@@ -846,6 +874,27 @@ class MemTableInserter : public WriteBatch::Handler {
   }
 };
 
+class DirectInserter : public DirectWriteHandler {
+ public:
+  explicit DirectInserter(MemTableInserter* inserter) : inserter_(inserter) {}
+
+  void Put(const SliceParts& key, const SliceParts& value) override {
+    inserter_->DirectPut(key, value);
+  }
+
+ private:
+  MemTableInserter* inserter_;
+};
+
+Status InsertIntoMemTable(const WriteBatch* batch, MemTableInserter* inserter) {
+  RETURN_NOT_OK(batch->Iterate(inserter));
+  if (batch->direct_writer()) {
+    DirectInserter direct_inserter(inserter);
+    return batch->direct_writer()->Apply(&direct_inserter);
+  }
+  return Status::OK();
+}
+
 }  // namespace
 
 // This function can only be called in these conditions:
@@ -864,7 +913,7 @@ Status WriteBatchInternal::InsertInto(
 
   for (size_t i = 0; i < writers.size(); i++) {
     if (!writers[i]->CallbackFailed()) {
-      writers[i]->status = writers[i]->batch->Iterate(&inserter);
+      writers[i]->status = InsertIntoMemTable(writers[i]->batch, &inserter);
       if (!writers[i]->status.ok()) {
         return writers[i]->status;
       }
@@ -884,7 +933,7 @@ Status WriteBatchInternal::InsertInto(const WriteBatch* batch,
                             flush_scheduler, ignore_missing_column_families,
                             log_number, db, dont_filter_deletes,
                             concurrent_memtable_writes);
-  return batch->Iterate(&inserter);
+  return InsertIntoMemTable(batch, &inserter);
 }
 
 void WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
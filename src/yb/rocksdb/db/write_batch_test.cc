@@ -141,6 +141,40 @@ TEST_F(WriteBatchTest, Multiple) {
   ASSERT_EQ(3, batch.Count());
 }
 
+namespace {
+
+class TestDirectWriter : public DirectWriter {
+ public:
+  size_t NumEntries() const override {
+    return 2;
+  }
+
+  CHECKED_STATUS Apply(DirectWriteHandler* handler) override {
+    std::array<Slice, 2> key_parts = {{ Slice("ke"), Slice("y1") }};
+    Slice value("v1");
+    handler->Put(key_parts, SliceParts(&value, 1));
+    std::array<Slice, 2> value_parts = {{ Slice("v"), Slice("2") }};
+    Slice key("key2");
+    handler->Put(SliceParts(&key, 1), value_parts);
+    return Status::OK();
+  }
+};
+
+} // namespace
+
+TEST_F(WriteBatchTest, DirectWriter) {
+  WriteBatch batch;
+  batch.Put(Slice("foo"), Slice("bar"));
+  TestDirectWriter direct_writer;
+  batch.SetDirectWriter(&direct_writer);
+  WriteBatchInternal::SetSequence(&batch, 100);
+  ASSERT_EQ(3, batch.Count());
+  ASSERT_EQ("Put(foo, bar)@100"
+            "Put(key1, v1)@101"
+            "Put(key2, v2)@102",
+            PrintContents(&batch));
+}
+
 TEST_F(WriteBatchTest, Corruption) {
   WriteBatch batch;
   batch.Put(Slice("foo"), Slice("bar"));
@@ -30,13 +30,17 @@
 
 #include "yb/rocksdb/memory_monitor.h"
 
+#include "yb/util/mem_tracker.h"
+
 namespace rocksdb {
 
 class WriteBuffer {
  public:
   WriteBuffer(size_t _buffer_size,
-              std::shared_ptr<MemoryMonitor> memory_monitor = nullptr)
-    : buffer_size_(_buffer_size), memory_monitor_(memory_monitor) {}
+              std::shared_ptr<MemoryMonitor> memory_monitor = nullptr,
+              std::shared_ptr<yb::MemTracker> mem_tracker = nullptr)
+    : buffer_size_(_buffer_size), memory_monitor_(std::move(memory_monitor)),
+      mem_tracker_(std::move(mem_tracker)) {}
 
   ~WriteBuffer() {}
 
@@ -56,18 +60,25 @@ class WriteBuffer {
     if (memory_monitor_) {
       memory_monitor_->ReservedMem(mem);
     }
+    if (mem_tracker_) {
+      mem_tracker_->Consume(mem);
+    }
   }
   void FreeMem(size_t mem) {
     memory_used_.fetch_sub(mem, std::memory_order_relaxed);
     if (memory_monitor_) {
       memory_monitor_->FreedMem(mem);
     }
+    if (mem_tracker_) {
+      mem_tracker_->Release(mem);
+    }
   }
 
  private:
   const size_t buffer_size_;
   std::atomic<size_t> memory_used_{0};
   std::shared_ptr<MemoryMonitor> memory_monitor_;
+  std::shared_ptr<yb::MemTracker> mem_tracker_;
 
   // No copying allowed
   WriteBuffer(const WriteBuffer&);
@@ -480,6 +480,12 @@ class RandomAccessFile : public File {
   // layer
   virtual void EnableReadAhead() {}
 
+  // Asks to asynchronously load the specified range of the file, so subsequent reads from it
+  // do not wait for the device. Returns immediately, it is just a hint.
+  virtual Status Prefetch(uint64_t offset, size_t n) {
+    return Status::OK();
+  }
+
   // For documentation, refer to File::GetUniqueId()
   virtual size_t GetUniqueId(char* id, size_t max_size) const override {
     return 0; // Default implementation to prevent issues with backwards
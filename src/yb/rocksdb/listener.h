@@ -114,6 +114,10 @@ struct FlushJobInfo {
   SequenceNumber largest_seqno;
   // Table properties of the table being flushed
   TableProperties table_properties;
+  // Total size of the newly created file, including the data file if it is split.
+  uint64_t file_size = 0;
+  // Time spent running the flush job.
+  uint64_t elapsed_micros = 0;
 };
 
 struct CompactionJobInfo {
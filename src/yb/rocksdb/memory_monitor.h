@@ -23,10 +23,13 @@ namespace rocksdb {
 
 // Counts the total memory of the registered write_buffers, and notifies the
 // callback if the limit is exceeded.
+// When soft limit is specified, the callback is also notified once the usage crosses it, so the
+// owner could flush something before the limit is reached.
 class MemoryMonitor {
  public:
-  explicit MemoryMonitor(size_t limit, std::function<void()> exceeded_callback)
-    : limit_(limit), exceeded_callback_(std::move(exceeded_callback)) {}
+  explicit MemoryMonitor(size_t limit, std::function<void()> exceeded_callback,
+                         size_t soft_limit = 0)
+    : limit_(limit), soft_limit_(soft_limit), exceeded_callback_(std::move(exceeded_callback)) {}
 
   ~MemoryMonitor() {}
 
@@ -36,13 +39,20 @@ class MemoryMonitor {
 
   size_t limit() const { return limit_; }
 
+  size_t soft_limit() const { return soft_limit_; }
+
   bool Exceeded() const {
     return Exceeded(memory_usage());
   }
 
+  bool SoftLimitExceeded() const {
+    return SoftLimitExceeded(memory_usage());
+  }
+
   void ReservedMem(size_t mem) {
     auto new_value = memory_used_.fetch_add(mem, std::memory_order_release) + mem;
-    if (UNLIKELY(Exceeded(new_value))) {
+    if (UNLIKELY(Exceeded(new_value) ||
+                 (SoftLimitExceeded(new_value) && !SoftLimitExceeded(new_value - mem)))) {
       exceeded_callback_();
     }
   }
@@ -61,7 +71,12 @@ class MemoryMonitor {
     return limit() > 0 && size >= limit();
   }
 
+  bool SoftLimitExceeded(size_t size) const {
+    return soft_limit() > 0 && size >= soft_limit();
+  }
+
   const size_t limit_;
+  const size_t soft_limit_;
   const std::function<void()> exceeded_callback_;
   std::atomic<size_t> memory_used_ {0};
 
@@ -0,0 +1,281 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <memory>
+
+#include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/db/inlineskiplist.h"
+#include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/util/arena.h"
+
+#include "yb/util/logging.h"
+
+namespace rocksdb {
+namespace {
+
+// Memtable for keys that start with a marker byte followed by a big endian 16 bit hash, like DocDB
+// keys of hash partitioned tables. Keys are split into buckets by the high bits of the hash, and
+// each bucket is an ordered skip list, so point operations only search a small list.
+//
+// Buckets are ordered by hash, keys that sort before the marker go to the first bucket and keys
+// that sort after it go to the last bucket. So ordered iteration just concatenates buckets.
+// This requires a bytewise user key comparator.
+class UInt16HashSkipListRep : public MemTableRep {
+ public:
+  UInt16HashSkipListRep(const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+                        char hash_marker, int bucket_bits)
+      : MemTableRep(allocator),
+        compare_(compare),
+        hash_marker_(static_cast<uint8_t>(hash_marker)),
+        hash_shift_(16 - bucket_bits),
+        num_buckets_((1ULL << bucket_bits) + 2),
+        buckets_(new std::atomic<Bucket*>[num_buckets_]) {
+    DCHECK(bucket_bits >= 0 && bucket_bits <= 16) << bucket_bits;
+    for (size_t i = 0; i != num_buckets_; ++i) {
+      buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    // Nodes do not depend on the list they are allocated by, so the first bucket, that always
+    // exists, is used to allocate nodes for all buckets.
+    allocation_bucket_ = GetOrCreateBucket(0);
+  }
+
+  KeyHandle Allocate(const size_t len, char** buf) override {
+    *buf = allocation_bucket_->list.AllocateKey(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  void Insert(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    auto* bucket = GetOrCreateBucket(BucketIndex(UserKey(key)));
+    bucket->list.Insert(key);
+    bucket->num_entries.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    auto* bucket = GetOrCreateBucket(BucketIndex(UserKey(key)));
+    bucket->list.InsertConcurrently(key);
+    bucket->num_entries.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  bool Contains(const char* key) const override {
+    auto* bucket = GetBucket(BucketIndex(UserKey(key)));
+    return bucket != nullptr && bucket->list.Contains(key);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // Everything except the bucket array is allocated through allocator.
+    return num_buckets_ * sizeof(buckets_[0]);
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    // All entries for the same user key are stored in the same bucket.
+    auto* bucket = GetBucket(BucketIndex(k.user_key()));
+    if (bucket == nullptr) {
+      return;
+    }
+    List::Iterator iter(&bucket->list);
+    for (iter.Seek(k.memtable_key().cdata());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  uint64_t ApproximateNumEntries(const Slice& start_ikey, const Slice& end_ikey) override {
+    std::string tmp;
+    const size_t start_index = BucketIndex(ExtractUserKey(start_ikey));
+    const size_t end_index = BucketIndex(ExtractUserKey(end_ikey));
+    uint64_t result = 0;
+    for (size_t i = start_index; i <= end_index && i < num_buckets_; ++i) {
+      auto* bucket = GetBucket(i);
+      if (bucket == nullptr) {
+        continue;
+      }
+      uint64_t start_count = 0;
+      uint64_t end_count = bucket->num_entries.load(std::memory_order_relaxed);
+      if (i == start_index) {
+        start_count = bucket->list.EstimateCount(EncodeKey(&tmp, start_ikey));
+      }
+      if (i == end_index) {
+        end_count = bucket->list.EstimateCount(EncodeKey(&tmp, end_ikey));
+      }
+      result += end_count >= start_count ? end_count - start_count : 0;
+    }
+    return result;
+  }
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    if (arena == nullptr) {
+      return new Iterator(this);
+    }
+    auto mem = arena->AllocateAligned(sizeof(Iterator));
+    return new (mem) Iterator(this);
+  }
+
+ private:
+  typedef InlineSkipList<const MemTableRep::KeyComparator&> List;
+
+  struct Bucket {
+    Bucket(const MemTableRep::KeyComparator& compare, Allocator* allocator)
+        : list(compare, allocator) {}
+
+    List list;
+    std::atomic<size_t> num_entries{0};
+  };
+
+  size_t BucketIndex(const Slice& user_key) const {
+    const uint8_t first = user_key.empty() ? 0 : user_key[0];
+    if (user_key.empty() || first < hash_marker_) {
+      return 0;
+    }
+    if (first > hash_marker_) {
+      return num_buckets_ - 1;
+    }
+    // Missing hash bytes are treated as zeros, such keys sort before all keys with the same hash
+    // prefix, so they are placed into the bucket of the lowest such hash.
+    const uint16_t hash = (user_key.size() > 1 ? user_key[1] << 8 : 0) |
+                          (user_key.size() > 2 ? user_key[2] : 0);
+    return 1 + (hash >> hash_shift_);
+  }
+
+  Bucket* GetBucket(size_t index) const {
+    return buckets_[index].load(std::memory_order_acquire);
+  }
+
+  Bucket* GetOrCreateBucket(size_t index) {
+    auto* bucket = GetBucket(index);
+    if (bucket != nullptr) {
+      return bucket;
+    }
+    auto mem = allocator_->AllocateAligned(sizeof(Bucket));
+    auto* new_bucket = new (mem) Bucket(compare_, allocator_);
+    // Concurrent writers could create the same bucket, the one that lost simply leaves its
+    // bucket unused in the arena.
+    if (buckets_[index].compare_exchange_strong(bucket, new_bucket, std::memory_order_acq_rel)) {
+      return new_bucket;
+    }
+    return bucket;
+  }
+
+  // Iterates buckets in order, skipping empty ones.
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const UInt16HashSkipListRep* rep) : rep_(rep), iter_(nullptr) {}
+
+    bool Valid() const override {
+      return iter_.Valid();
+    }
+
+    const char* key() const override {
+      return iter_.key();
+    }
+
+    void Next() override {
+      iter_.Next();
+      if (!iter_.Valid()) {
+        ForwardToBucket(bucket_index_ + 1);
+      }
+    }
+
+    void Prev() override {
+      iter_.Prev();
+      if (!iter_.Valid() && bucket_index_ != 0) {
+        BackwardToBucket(bucket_index_ - 1);
+      }
+    }
+
+    void Seek(const Slice& internal_key, const char* memtable_key) override {
+      const char* encoded_key =
+          memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, internal_key);
+      const size_t index = rep_->BucketIndex(rep_->UserKey(encoded_key));
+      auto* bucket = rep_->GetBucket(index);
+      if (bucket != nullptr) {
+        bucket_index_ = index;
+        iter_.SetList(&bucket->list);
+        iter_.Seek(encoded_key);
+        if (iter_.Valid()) {
+          return;
+        }
+      }
+      ForwardToBucket(index + 1);
+    }
+
+    void SeekToFirst() override {
+      ForwardToBucket(0);
+    }
+
+    void SeekToLast() override {
+      BackwardToBucket(rep_->num_buckets_ - 1);
+    }
+
+   private:
+    // Positions at the first entry of the first non empty bucket starting from index.
+    void ForwardToBucket(size_t index) {
+      for (; index < rep_->num_buckets_; ++index) {
+        auto* bucket = rep_->GetBucket(index);
+        if (bucket == nullptr) {
+          continue;
+        }
+        bucket_index_ = index;
+        iter_.SetList(&bucket->list);
+        iter_.SeekToFirst();
+        if (iter_.Valid()) {
+          return;
+        }
+      }
+      iter_.SetList(nullptr);
+    }
+
+    // Positions at the last entry of the last non empty bucket up to index.
+    void BackwardToBucket(size_t index) {
+      for (size_t i = index + 1; i-- > 0;) {
+        auto* bucket = rep_->GetBucket(i);
+        if (bucket == nullptr) {
+          continue;
+        }
+        bucket_index_ = i;
+        iter_.SetList(&bucket->list);
+        iter_.SeekToLast();
+        if (iter_.Valid()) {
+          return;
+        }
+      }
+      iter_.SetList(nullptr);
+    }
+
+    const UInt16HashSkipListRep* rep_;
+    List::Iterator iter_;
+    size_t bucket_index_ = 0;
+    std::string tmp_; // For passing to EncodeKey
+  };
+
+  const MemTableRep::KeyComparator& compare_;
+  const uint8_t hash_marker_;
+  const int hash_shift_;
+  const size_t num_buckets_;
+  std::unique_ptr<std::atomic<Bucket*>[]> buckets_;
+  Bucket* allocation_bucket_;
+};
+
+} // namespace
+
+MemTableRep* UInt16HashSkipListRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+    const SliceTransform* transform, Logger* logger) {
+  return new UInt16HashSkipListRep(compare, allocator, hash_marker_, bucket_bits_);
+}
+
+} // namespace rocksdb
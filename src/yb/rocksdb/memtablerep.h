@@ -253,6 +253,33 @@ class SkipListFactory : public MemTableRepFactory {
   const size_t lookahead_;
 };
 
+// This uses skip lists partitioned by a 16 bit hash, for keys that start with hash_marker byte
+// followed by a big endian 16 bit hash, e.g. DocDB keys of hash partitioned tables.
+// Point lookups and inserts search only the skip list of the key's bucket, while iteration goes
+// through buckets in hash order, so it returns keys in the same order as a single skip list.
+// Requires bytewise user key comparator.
+//
+// Parameters:
+//   hash_marker: first byte of keys that contain hash.
+//   bucket_bits: number of high bits of the hash used to select a bucket, at most 16.
+class UInt16HashSkipListRepFactory : public MemTableRepFactory {
+ public:
+  explicit UInt16HashSkipListRepFactory(char hash_marker, int bucket_bits = 10)
+      : hash_marker_(hash_marker), bucket_bits_(bucket_bits) {}
+
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                 MemTableAllocator*,
+                                 const SliceTransform*,
+                                 Logger* logger) override;
+  const char* Name() const override { return "UInt16HashSkipListRepFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+ private:
+  const char hash_marker_;
+  const int bucket_bits_;
+};
+
 #ifndef ROCKSDB_LITE
 // This creates MemTableReps that are backed by an std::vector. On iteration,
 // the vector is sorted. This is useful for workloads where iteration is very
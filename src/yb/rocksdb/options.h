@@ -42,6 +42,13 @@
 #undef max
 #endif
 
+namespace yb {
+
+class MemTracker;
+class PriorityThreadPool;
+
+} // namespace yb
+
 namespace rocksdb {
 
 class BoundaryValuesExtractor;
@@ -157,9 +164,15 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Max size of dictionary used for compression of data blocks. When positive, dictionary is
+  // sampled from the first data blocks of each table file and stored in its meta block, subsequent
+  // data blocks of the file are compressed with it. Only supported by Zlib and ZSTD. Zlib only
+  // uses the last window of the dictionary, so it should not be greater than 2^|window_bits|.
+  // Default: 0, no dictionary.
+  uint32_t max_dict_bytes;
+  CompressionOptions() : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -753,6 +766,15 @@ struct ColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   size_t memtable_prefix_bloom_huge_page_tlb_size;
 
+  // Page size for huge pages backing memtable arena blocks. If 0, arena blocks are allocated
+  // with malloc. Otherwise blocks are allocated from huge page TLB when huge pages are reserved,
+  // i.e. sysctl -w vm.nr_hugepages=N, falling back to transparent huge pages, and then to malloc.
+  // Pages are not populated on allocation, so they are placed on the NUMA node of the writer
+  // thread that first touches them.
+  //
+  // Dynamically changeable through SetOptions() API
+  size_t memtable_huge_page_size = 0;
+
   // Control locality of bloom filter probes to improve cache miss rate.
   // This option only applies to memtable prefix bloom and plaintable
   // prefix bloom. It essentially limits every bloom checking to one cache line.
@@ -1119,6 +1141,11 @@ struct DBOptions {
   // Default: nullptr (disabled)
   std::shared_ptr<MemoryMonitor> memory_monitor;
 
+  // If set, memory allocated by memtables is consumed from this tracker.
+  //
+  // Default: nullptr (disabled)
+  std::shared_ptr<yb::MemTracker> memtable_mem_tracker;
+
   // Specify the file access pattern once a compaction is started.
   // It will be applied to all input files of a compaction.
   // Default: NORMAL
@@ -1315,6 +1342,12 @@ struct DBOptions {
 
   // Invoked after memtable switched.
   std::shared_ptr<std::function<MemTableFilter()>> mem_table_flush_filter_factory;
+
+  // Thread pool shared by multiple DBs. When set, compactions are submitted to it instead of
+  // the LOW priority pool of env, and compactions of DBs with the highest read amplification and
+  // space debt are started first. max_background_compactions still limits each DB.
+  // The pool should outlive the DB.
+  yb::PriorityThreadPool* priority_thread_pool_for_compactions = nullptr;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -106,6 +106,16 @@ struct PerfContext {
   uint64_t bloom_sst_hit_count;
   // total number of SST table bloom misses
   uint64_t bloom_sst_miss_count;
+  // total number of block cache misses
+  uint64_t block_cache_miss_count;
+  // total number of SST files accessed by point lookups and iterators
+  uint64_t sst_file_read_count;
+  // total number of Seek, SeekToFirst and SeekToLast calls of DB iterators
+  uint64_t iter_seek_count;
+  // total number of Next calls of DB iterators
+  uint64_t iter_next_count;
+  // total number of Prev calls of DB iterators
+  uint64_t iter_prev_count;
 };
 
 #if defined(NPERF_CONTEXT) || defined(IOS_CROSS_COMPILE)
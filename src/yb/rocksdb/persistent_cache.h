@@ -0,0 +1,71 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_PERSISTENT_CACHE_H
+#define YB_ROCKSDB_PERSISTENT_CACHE_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "yb/rocksdb/status.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class Env;
+
+struct PersistentCacheOptions {
+  Env* env = nullptr;
+
+  // Directory where cache segments are stored. It should be located on a fast local device
+  // (flash), and should not be shared with other caches.
+  std::string path;
+
+  // Max total size of cache segments.
+  uint64_t capacity = 0;
+
+  // Cache segments are written sequentially, and evicted as a whole, oldest first.
+  uint64_t segment_size = 64 * 1024 * 1024;
+
+  // Max size of entries that are waiting to be written. Inserts that do not fit are dropped,
+  // so a slow cache device never blocks readers.
+  size_t max_pending_bytes = 16 * 1024 * 1024;
+};
+
+// Secondary cache tier for blocks, located on a persistent device. Its content survives restarts,
+// so keys should be generated from stable identifiers.
+class PersistentCache {
+ public:
+  virtual ~PersistentCache() {}
+
+  // Schedules write of the value to the cache. Returns immediately, the value is written by
+  // a background thread and becomes visible to lookups after it is written.
+  virtual void Insert(const Slice& key, const Slice& value) = 0;
+
+  // Reads value for the specified key. Returns NotFound if there is no such entry.
+  virtual Status Lookup(const Slice& key, std::unique_ptr<char[]>* value, size_t* size) = 0;
+
+  // Total size of cache segments.
+  virtual uint64_t GetUsage() const = 0;
+};
+
+// Opens log structured persistent cache at options.path. Entries written before restart are
+// recovered from existing segments.
+Status NewPersistentCache(const PersistentCacheOptions& options,
+                          std::shared_ptr<PersistentCache>* cache);
+
+}  // namespace rocksdb
+
+#endif // YB_ROCKSDB_PERSISTENT_CACHE_H
@@ -69,10 +69,14 @@ class RateLimiter {
 // from flush. Low-pri requests can get blocked if flush requests come in
 // continuouly. This fairness parameter grants low-pri requests permission by
 // 1/fairness chance even though high-pri requests exist to avoid starvation.
-// You should be good by leaving it at default 10.
+// You should be good by leaving it at default 10. Zero fairness means that low-pri requests are
+// never granted while there are pending high-pri requests.
+// @auto_tuned: Enables dynamic adjustment of rate limit within the range
+// [rate_bytes_per_sec / 20, rate_bytes_per_sec], according to how often the limit is reached.
 extern RateLimiter* NewGenericRateLimiter(
     int64_t rate_bytes_per_sec,
     int64_t refill_period_us = 100 * 1000,
-    int32_t fairness = 10);
+    int32_t fairness = 10,
+    bool auto_tuned = false);
 
 }  // namespace rocksdb
@@ -205,6 +205,10 @@ enum Tickers : uint32_t {
   BLOCK_CACHE_MULTI_TOUCH_BYTES_READ,
   BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
 
+  // Persistent cache.
+  PERSISTENT_CACHE_HIT,
+  PERSISTENT_CACHE_MISS,
+
   // End of ticker enum.
   TICKER_ENUM_MAX,
 };
@@ -298,7 +302,9 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOCK_CACHE_MULTI_TOUCH_HIT, "rocksdb_block_cache_multi_touch_hit"},
     {BLOCK_CACHE_MULTI_TOUCH_ADD, "rocksdb_block_cache_multi_touch_add"},
     {BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, "rocksdb_block_cache_multi_touch_bytes_read"},
-    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"}
+    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"},
+    {PERSISTENT_CACHE_HIT, "rocksdb_persistent_cache_hit"},
+    {PERSISTENT_CACHE_MISS, "rocksdb_persistent_cache_miss"}
 };
 
 /**
@@ -43,10 +43,17 @@
 #include "yb/rocksdb/status.h"
 #include "yb/util/size_literals.h"
 
+namespace yb {
+
+class MemTracker;
+
+} // namespace yb
+
 namespace rocksdb {
 
 // -- Block-based Table
 class FlushBlockPolicyFactory;
+class PersistentCache;
 class RandomAccessFile;
 struct TableReaderOptions;
 struct TableBuilderOptions;
@@ -79,6 +86,18 @@ YB_DEFINE_ENUM(IndexType,
   (kMultiLevelBinarySearch)
 );
 
+YB_DEFINE_ENUM(KeyValueEncodingFormat,
+  // Key is stored as a prefix shared with the previous key and a non shared remainder.
+  (kKeyDeltaEncodingSharedPrefix)
+
+  // Key is stored as a prefix shared with the previous key, a non shared part, a middle part
+  // shared with the previous key at the same distance from the user key end, a second non shared
+  // part, and a delta of the internal key trailer. Designed for DocDB keys, where consecutive keys
+  // usually differ only in a subkey (column id) and a write id, while sharing the document key and
+  // the hybrid time. Only works for internal keys, so only applicable to data blocks.
+  (kKeyDeltaEncodingThreeSharedParts)
+);
+
 // For advanced user only
 struct BlockBasedTableOptions {
   // @flush_block_policy_factory creates the instances of flush block policy.
@@ -97,6 +116,23 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // If true, top level data index and filter are loaded on table open and kept in table reader
+  // even when cache_index_and_filter_blocks is set, so that they are not evicted from block cache
+  // by data blocks, for instance during large scans.
+  // Lower levels of multi-level data index and fixed-size filter blocks still go through block
+  // cache. Index of fixed-size filter blocks is always kept in table reader.
+  bool pin_top_level_index_and_filter = false;
+
+  // If true, filter (index of fixed-size filter blocks for fixed-size filter) is loaded on first
+  // use instead of table open, so opening a DB with many files does not read filters of files that
+  // are not accessed yet. Only used when cache_index_and_filter_blocks is set. Filters loaded
+  // lazily are not pinned in table reader.
+  bool lazy_load_filter = false;
+
+  // If set, memory of blocks pinned because of pin_top_level_index_and_filter is consumed from this
+  // tracker. When its limit is reached, these blocks are stored in block cache instead.
+  std::shared_ptr<yb::MemTracker> pinned_index_and_filter_mem_tracker;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -123,6 +159,10 @@ struct BlockBasedTableOptions {
   // If NULL, rocksdb will not use a compressed block cache.
   std::shared_ptr<Cache> block_cache_compressed = nullptr;
 
+  // If non-NULL, data blocks read from table files are also written to this cache, and are looked
+  // up in it before reading table files. Blocks are stored as they are on disk, i.e. compressed.
+  std::shared_ptr<PersistentCache> persistent_cache = nullptr;
+
   // Approximate size of user data packed per block, in bytes. Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -157,12 +197,22 @@ struct BlockBasedTableOptions {
   // used to avoid too many index levels in case we have large keys.
   size_t min_keys_per_index_block = 64;
 
+  // When an iterator reads several adjacent data blocks in a row, it asks the file to prefetch
+  // the range ahead of it. Prefetch size starts from a few blocks and doubles while the access
+  // stays sequential, up to this value. 0 disables prefetching.
+  size_t max_auto_readahead_size = 256_KB;
+
   // Use delta encoding to compress keys in blocks.
   // Iterator::PinData() requires this option to be disabled.
   //
   // Default: true
   bool use_delta_encoding = true;
 
+  // Key encoding format used for data blocks when use_delta_encoding is true. Format is stored in
+  // table properties, so it could be changed without affecting existing files.
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+
   // If non-nullptr, use the specified filter policy to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
@@ -213,6 +263,8 @@ struct BlockBasedTablePropertyNames {
   static const char kWholeKeyFiltering[];
   // value is "1" for true and "0" for false.
   static const char kPrefixFiltering[];
+  // data block key value encoding format, fixed int32 number.
+  static const char kDataBlockKeyValueEncodingFormat[];
 };
 
 // Create default block based table factory.
@@ -98,7 +98,8 @@ void BlockIter::Prev() {
 
 void BlockIter::Initialize(const Comparator* comparator, const char* data,
                            uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-                           BlockPrefixIndex* prefix_index) {
+                           BlockPrefixIndex* prefix_index,
+                           KeyValueEncodingFormat key_value_encoding_format) {
   DCHECK(data_ == nullptr); // Ensure it is called only once
   DCHECK_GT(num_restarts, 0); // Ensure the param is valid
 
@@ -110,6 +111,7 @@ void BlockIter::Initialize(const Comparator* comparator, const char* data,
   restart_index_ = num_restarts_;
   hash_index_ = hash_index;
   prefix_index_ = prefix_index;
+  key_value_encoding_format_ = key_value_encoding_format;
 }
 
 
@@ -177,28 +179,81 @@ bool BlockIter::ParseNextKey() {
     return false;
   }
 
-  // Decode next entry
+  while (restart_index_ + 1 < num_restarts_ &&
+         GetRestartPoint(restart_index_ + 1) <= current_) {
+    ++restart_index_;
+  }
+
+  // Entries at restart points always use shared prefix format, and store the whole key.
+  const bool parsed =
+      key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts &&
+      GetRestartPoint(restart_index_) != current_
+          ? ParseThreeSharedPartsEntry(p, limit)
+          : ParseSharedPrefixEntry(p, limit);
+  if (!parsed) {
+    CorruptionError();
+    return false;
+  }
+  return true;
+}
+
+bool BlockIter::ParseSharedPrefixEntry(const char* p, const char* limit) {
   uint32_t shared, non_shared, value_length;
   p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
   if (p == nullptr || key_.Size() < shared) {
-    CorruptionError();
     return false;
+  }
+  if (shared == 0) {
+    // If this key dont share any bytes with prev key then we dont need
+    // to decode it and can use it's address in the block directly.
+    key_.SetKey(Slice(p, non_shared), false /* copy */);
   } else {
-    if (shared == 0) {
-      // If this key dont share any bytes with prev key then we dont need
-      // to decode it and can use it's address in the block directly.
-      key_.SetKey(Slice(p, non_shared), false /* copy */);
-    } else {
-      // This key share `shared` bytes with prev key, we need to decode it
-      key_.TrimAppend(shared, p, non_shared);
-    }
-    value_ = Slice(p + non_shared, value_length);
-    while (restart_index_ + 1 < num_restarts_ &&
-           GetRestartPoint(restart_index_ + 1) < current_) {
-      ++restart_index_;
-    }
-    return true;
+    // This key share `shared` bytes with prev key, we need to decode it
+    key_.TrimAppend(shared, p, non_shared);
   }
+  value_ = Slice(p + non_shared, value_length);
+  return true;
+}
+
+bool BlockIter::ParseThreeSharedPartsEntry(const char* p, const char* limit) {
+  uint32_t shared_prefix, non_shared_1, non_shared_2, shared_middle, value_length;
+  uint64_t trailer_delta;
+  if (limit - p >= 6 && ((p[0] | p[1] | p[2] | p[3] | p[4] | p[5]) & 0x80) == 0) {
+    // Fast path: all values are encoded in one byte each.
+    shared_prefix = p[0];
+    non_shared_1 = p[1];
+    non_shared_2 = p[2];
+    shared_middle = p[3];
+    value_length = p[4];
+    trailer_delta = p[5];
+    p += 6;
+  } else if ((p = GetVarint32Ptr(p, limit, &shared_prefix)) == nullptr ||
+             (p = GetVarint32Ptr(p, limit, &non_shared_1)) == nullptr ||
+             (p = GetVarint32Ptr(p, limit, &non_shared_2)) == nullptr ||
+             (p = GetVarint32Ptr(p, limit, &shared_middle)) == nullptr ||
+             (p = GetVarint32Ptr(p, limit, &value_length)) == nullptr ||
+             (p = GetVarint64Ptr(p, limit, &trailer_delta)) == nullptr) {
+    return false;
+  }
+
+  if (static_cast<uint64_t>(limit - p) <
+          static_cast<uint64_t>(non_shared_1) + non_shared_2 + value_length ||
+      key_.Size() < kLastInternalComponentSize) {
+    return false;
+  }
+  const size_t last_user_key_size = key_.Size() - kLastInternalComponentSize;
+  if (shared_prefix > last_user_key_size ||
+      static_cast<size_t>(shared_middle) + non_shared_2 > last_user_key_size) {
+    return false;
+  }
+
+  const uint64_t trailer =
+      DecodeFixed64(key_.GetKey().cdata() + last_user_key_size) + ZigZagDecode64(trailer_delta);
+  key_.UpdateWithThreeSharedParts(
+      shared_prefix, Slice(p, non_shared_1), shared_middle, Slice(p + non_shared_1, non_shared_2),
+      trailer);
+  value_ = Slice(p + non_shared_1 + non_shared_2, value_length);
+  return true;
 }
 
 // Binary search in restart array to find the first restart point
@@ -355,7 +410,8 @@ Block::Block(BlockContents&& contents)
 }
 
 InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
-                                     bool total_order_seek) {
+                                     bool total_order_seek,
+                                     KeyValueEncodingFormat key_value_encoding_format) {
   if (size_ < 2*sizeof(uint32_t)) {
     if (iter != nullptr) {
       iter->SetStatus(STATUS(Corruption, "bad block contents"));
@@ -380,10 +436,10 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
 
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, key_value_encoding_format);
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, key_value_encoding_format);
     }
   }
 
@@ -82,9 +82,13 @@ class Block {
   // If total_order_seek is true, hash_index_ and prefix_index_ are ignored.
   // This option only applies for index block. For data block, hash_index_
   // and prefix_index_ are null, so this option does not matter.
+  //
+  // key_value_encoding_format should match the format the block was built with.
   InternalIterator* NewIterator(const Comparator* comparator,
                                 BlockIter* iter = nullptr,
-                                bool total_order_seek = true);
+                                bool total_order_seek = true,
+                                KeyValueEncodingFormat key_value_encoding_format =
+                                    KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
   void SetBlockHashIndex(BlockHashIndex* hash_index);
   void SetBlockPrefixIndex(BlockPrefixIndex* prefix_index);
 
@@ -115,19 +119,20 @@ class BlockIter : public InternalIterator {
         restart_index_(0),
         status_(Status::OK()),
         hash_index_(nullptr),
-        prefix_index_(nullptr) {}
+        prefix_index_(nullptr),
+        key_value_encoding_format_(KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix) {}
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
-       BlockPrefixIndex* prefix_index)
+       BlockPrefixIndex* prefix_index, KeyValueEncodingFormat key_value_encoding_format)
       : BlockIter() {
     Initialize(comparator, data, restarts, num_restarts,
-        hash_index, prefix_index);
+        hash_index, prefix_index, key_value_encoding_format);
   }
 
   void Initialize(const Comparator* comparator, const char* data,
       uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-      BlockPrefixIndex* prefix_index);
+      BlockPrefixIndex* prefix_index, KeyValueEncodingFormat key_value_encoding_format);
 
   void SetStatus(Status s) {
     status_ = s;
@@ -180,6 +185,7 @@ class BlockIter : public InternalIterator {
   Status status_;
   BlockHashIndex* hash_index_;
   BlockPrefixIndex* prefix_index_;
+  KeyValueEncodingFormat key_value_encoding_format_;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -210,6 +216,11 @@ class BlockIter : public InternalIterator {
 
   bool ParseNextKey();
 
+  // Decode entry at p, that is encoded relative to the previous key. Return false if the entry is
+  // corrupted.
+  bool ParseSharedPrefixEntry(const char* p, const char* limit);
+  bool ParseThreeSharedPartsEntry(const char* p, const char* limit);
+
   bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
                   uint32_t* index);
 
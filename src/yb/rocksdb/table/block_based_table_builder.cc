@@ -27,6 +27,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -99,6 +100,15 @@ FilterBlockBuilder* CreateFilterBlockBuilder(const ImmutableCFOptions& opt,
   return nullptr;
 }
 
+// Number of first data blocks of a file that are sampled for compression dictionary.
+constexpr size_t kCompressionDictSampleBlocks = 8;
+// Length of a single piece of data block, that is copied to compression dictionary.
+constexpr size_t kCompressionDictSampleLen = 64;
+
+bool CompressionSupportsDict(CompressionType type) {
+  return type == kZlibCompression || type == kZSTDNotFinalCompression;
+}
+
 bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
   // Check to see if compressed less than 12.5%
   return compressed_size < raw_size - (raw_size / 8u);
@@ -108,6 +118,7 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const Slice& compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -127,7 +138,7 @@ Slice CompressBlock(const Slice& raw,
       if (Zlib_Compress(
               compression_options,
               GetCompressFormatForVersion(kZlibCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -161,7 +172,7 @@ Slice CompressBlock(const Slice& raw,
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -200,11 +211,13 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
  public:
   explicit BlockBasedTablePropertiesCollector(
       BlockBasedTableBuilder::Rep* rep, IndexType index_type,
-      bool whole_key_filtering, bool prefix_filtering)
+      bool whole_key_filtering, bool prefix_filtering,
+      KeyValueEncodingFormat data_block_key_value_encoding_format)
       : rep_(rep),
         index_type_(index_type),
         whole_key_filtering_(whole_key_filtering),
-        prefix_filtering_(prefix_filtering) {}
+        prefix_filtering_(prefix_filtering),
+        data_block_key_value_encoding_format_(data_block_key_value_encoding_format) {}
 
   virtual Status InternalAdd(const Slice& key, const Slice& value,
                              uint64_t file_size) override {
@@ -230,6 +243,7 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
   IndexType index_type_;
   bool whole_key_filtering_;
   bool prefix_filtering_;
+  KeyValueEncodingFormat data_block_key_value_encoding_format_;
 };
 
 // Originally following data was stored in BlockBasedTableBuilder::Rep and related to a single SST
@@ -297,6 +311,15 @@ struct BlockBasedTableBuilder::Rep {
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
 
+  // Dictionary for compression of data blocks, see CompressionOptions::max_dict_bytes.
+  std::string compression_dict;
+  // Number of data blocks sampled to compression_dict so far.
+  size_t num_compression_dict_samples = 0;
+  // Set when dictionary is complete, data blocks starting from compression_dict_offset are
+  // compressed with it.
+  bool compression_dict_ready = false;
+  uint64_t compression_dict_offset = 0;
+
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
   Rep(const ImmutableCFOptions& _ioptions,
@@ -311,8 +334,45 @@ struct BlockBasedTableBuilder::Rep {
       const bool skip_filters);
 
   bool is_split_sst() const { return data_writer != metadata_writer; }
+
+  bool NeedCompressionDictSamples() const {
+    return compression_opts.max_dict_bytes > 0 && !compression_dict_ready &&
+           CompressionSupportsDict(compression_type);
+  }
+
+  Slice DataBlockCompressionDict() const {
+    return compression_dict_ready ? Slice(compression_dict) : Slice();
+  }
+
+  // Appends evenly spaced pieces of raw data block to compression dictionary. Dictionary is
+  // complete when enough blocks are sampled, and is used for blocks written after that.
+  void AddCompressionDictSample(const Slice& raw_block);
 };
 
+void BlockBasedTableBuilder::Rep::AddCompressionDictSample(const Slice& raw_block) {
+  const size_t max_dict_bytes = compression_opts.max_dict_bytes;
+  const size_t budget = std::max(max_dict_bytes / kCompressionDictSampleBlocks,
+                                 kCompressionDictSampleLen);
+  if (raw_block.size() <= budget) {
+    compression_dict.append(raw_block.cdata(), raw_block.size());
+  } else {
+    const size_t num_pieces = budget / kCompressionDictSampleLen;
+    const size_t step = raw_block.size() / num_pieces;
+    for (size_t i = 0; i != num_pieces; ++i) {
+      compression_dict.append(raw_block.cdata() + i * step, kCompressionDictSampleLen);
+    }
+  }
+  ++num_compression_dict_samples;
+  if (num_compression_dict_samples >= kCompressionDictSampleBlocks ||
+      compression_dict.size() >= max_dict_bytes) {
+    if (compression_dict.size() > max_dict_bytes) {
+      compression_dict.resize(max_dict_bytes);
+    }
+    compression_dict_ready = true;
+    compression_dict_offset = data_writer->offset;
+  }
+}
+
 Status BlockBasedTableBuilder::BlockBasedTablePropertiesCollector::Finish(
     UserCollectedProperties* properties) {
   std::string val;
@@ -327,6 +387,9 @@ Status BlockBasedTableBuilder::BlockBasedTablePropertiesCollector::Finish(
   val.clear();
   PutFixed32(&val, rep_->data_index_builder->NumLevels());
   properties->emplace(BlockBasedTablePropertyNames::kNumIndexLevels, val);
+  val.clear();
+  PutFixed32(&val, static_cast<uint32_t>(data_block_key_value_encoding_format_));
+  properties->emplace(BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat, val);
   return Status::OK();
 }
 
@@ -348,7 +411,8 @@ BlockBasedTableBuilder::Rep::Rep(
       filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
           _ioptions, table_options, filter_type)),
       data_block_builder(table_options.block_restart_interval,
-                 table_options.use_delta_encoding),
+                 table_options.use_delta_encoding,
+                 table_options.data_block_key_value_encoding_format),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -382,7 +446,10 @@ BlockBasedTableBuilder::Rep::Rep(
   table_properties_collectors.emplace_back(
       new BlockBasedTablePropertiesCollector(
           this, table_options.index_type, table_options.whole_key_filtering,
-          _ioptions.prefix_extractor != nullptr));
+          _ioptions.prefix_extractor != nullptr,
+          table_options.use_delta_encoding
+              ? table_options.data_block_key_value_encoding_format
+              : KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix));
 }
 
 BlockBasedTableBuilder::BlockBasedTableBuilder(
@@ -421,7 +488,7 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
     if (rep_->is_split_sst()) {
       GenerateCachePrefix(
           table_options.block_cache_compressed.get(), data_file->writable_file(),
-          &rep_->metadata_writer->compressed_cache_key_prefix);
+          &rep_->data_writer->compressed_cache_key_prefix);
     }
   }
 }
@@ -480,8 +547,13 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   size_t data_block_size = 0;
 
   if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+    const Slice raw_block = r->data_block_builder.Finish();
+    data_block_size = WriteBlock(raw_block, &r->data_pending_handle, r->data_writer.get(),
+        r->DataBlockCompressionDict());
+    if (ok() && r->NeedCompressionDictSamples()) {
+      r->AddCompressionDictSample(raw_block);
+    }
+    r->data_block_builder.Reset();
   }
   if (!ok()) return;
 
@@ -562,7 +634,8 @@ size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -575,7 +648,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict, &r->compressed_output);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -718,6 +791,17 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  // Dictionary is stored only if some data blocks were written after it was complete.
+  if (ok() && r->compression_dict_ready &&
+      r->data_writer->offset > r->compression_dict_offset) {
+    std::string contents;
+    PutVarint64(&contents, r->compression_dict_offset);
+    contents.append(r->compression_dict);
+    BlockHandle compression_dict_handle;
+    WriteRawBlock(contents, kNoCompression, &compression_dict_handle, r->metadata_writer.get());
+    meta_index_builder.Add(block_based_table::kCompressionDictBlock, compression_dict_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
@@ -65,8 +65,12 @@ Status BlockBasedTableFactory::NewTableReader(
     const TableReaderOptions& table_reader_options,
     unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
     unique_ptr<TableReader>* table_reader) const {
+  // Filter could be loaded lazily only through block cache.
+  const bool lazy_load_filter =
+      table_options_.lazy_load_filter && table_options_.cache_index_and_filter_blocks;
   return NewTableReader(table_reader_options, std::move(file), file_size,
-                        table_reader, DataIndexLoadMode::LAZY, PrefetchFilter::YES);
+                        table_reader, DataIndexLoadMode::LAZY,
+                        lazy_load_filter ? PrefetchFilter::NO : PrefetchFilter::YES);
 }
 
 Status BlockBasedTableFactory::NewTableReader(
@@ -136,6 +140,11 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks: %d\n",
            table_options_.cache_index_and_filter_blocks);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  pin_top_level_index_and_filter: %d\n",
+           table_options_.pin_top_level_index_and_filter);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  lazy_load_filter: %d\n", table_options_.lazy_load_filter);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            yb::to_underlying(table_options_.index_type));
   ret.append(buffer);
@@ -165,9 +174,15 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
              table_options_.block_cache_compressed->GetCapacity());
     ret.append(buffer);
   }
+  snprintf(buffer, kBufferSize, "  persistent_cache: %p\n",
+           table_options_.persistent_cache.get());
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  block_size: %" ROCKSDB_PRIszt "\n",
            table_options_.block_size);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  max_auto_readahead_size: %" ROCKSDB_PRIszt "\n",
+           table_options_.max_auto_readahead_size);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  block_size_deviation: %d\n",
            table_options_.block_size_deviation);
   ret.append(buffer);
@@ -177,6 +192,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_key_value_encoding_format: %s\n",
+           ToString(table_options_.data_block_key_value_encoding_format).c_str());
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  filter_policy: %s\n",
            table_options_.filter_policy == nullptr ?
              "nullptr" : table_options_.filter_policy->Name());
@@ -198,7 +216,9 @@ const BlockBasedTableOptions& BlockBasedTableFactory::table_options() const {
 }
 std::shared_ptr<TableAwareReadFileFilter> BlockBasedTableFactory::NewTableAwareReadFileFilter(
     const ReadOptions &read_options, const Slice &user_key) const {
-  return std::make_shared<BloomFilterAwareFileFilter>(read_options, user_key);
+  return std::make_shared<BloomFilterAwareFileFilter>(
+      read_options, user_key,
+      table_options_.filter_policy ? table_options_.filter_policy->GetKeyTransformer() : nullptr);
 }
 
 TableFactory* NewBlockBasedTableFactory(
@@ -214,6 +234,8 @@ const char BlockBasedTablePropertyNames::kWholeKeyFiltering[] =
     "rocksdb.block.based.table.whole.key.filtering";
 const char BlockBasedTablePropertyNames::kPrefixFiltering[] =
     "rocksdb.block.based.table.prefix.filtering";
+const char BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat[] =
+    "rocksdb.block.based.table.data.block.key.value.encoding.format";
 const char kHashIndexPrefixesBlock[] = "rocksdb.hashindex.prefixes";
 const char kHashIndexPrefixesMetadataBlock[] =
     "rocksdb.hashindex.metadata";
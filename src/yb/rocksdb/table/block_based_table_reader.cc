@@ -26,6 +26,7 @@
 #include <string>
 #include <utility>
 #include <cinttypes>
+#include <limits>
 
 #include "yb/rocksdb/db/dbformat.h"
 
@@ -35,6 +36,7 @@
 #include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/persistent_cache.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table_properties.h"
@@ -64,6 +66,8 @@
 #include "yb/gutil/macros.h"
 #include "yb/util/logging.h"
 #include "yb/util/atomic.h"
+#include "yb/util/allocation_sampler.h"
+#include "yb/util/mem_tracker.h"
 
 namespace rocksdb {
 
@@ -107,6 +111,7 @@ Cache::Handle* GetEntryFromCache(Cache* block_cache, const Slice& key,
     // block-type specific cache hit
     RecordTick(statistics, block_cache_hit_ticker);
   } else {
+    PERF_COUNTER_ADD(block_cache_miss_count, 1);
     // block-type specific cache miss
     RecordTick(statistics, block_cache_miss_ticker);
   }
@@ -146,6 +151,10 @@ struct BlockBasedTable::FileReaderWithCachePrefix {
   // Similar prefix, but for compressed blocks cache:
   block_based_table::CacheKeyBuffer compressed_cache_key_prefix;
 
+  // Prefix for the persistent cache. Its content survives restarts, so the prefix is generated
+  // only from the file unique id, and is empty when the file does not provide one.
+  block_based_table::CacheKeyBuffer persistent_cache_key_prefix;
+
   explicit FileReaderWithCachePrefix(unique_ptr<RandomAccessFileReader>&& _reader) :
       reader(std::move(_reader)) {}
 };
@@ -191,7 +200,26 @@ struct BlockBasedTable::Rep {
         filter_type(FilterType::kNoFilter),
         whole_key_filtering(_table_opt.whole_key_filtering),
         prefix_filtering(true),
-        data_index_load_mode(data_index_load_mode_) {}
+        data_index_load_mode(data_index_load_mode_),
+        pinned_mem_tracker(_table_opt.pinned_index_and_filter_mem_tracker) {}
+
+  ~Rep() {
+    if (pinned_mem_tracker && pinned_bytes != 0) {
+      pinned_mem_tracker->Release(pinned_bytes);
+    }
+  }
+
+  // Reserves memory for a block that is about to be pinned in the table reader because of
+  // BlockBasedTableOptions::pin_top_level_index_and_filter. Returns false if the budget is
+  // exhausted, so the block should be stored in block cache instead.
+  bool TryReservePinned(const BlockHandle& handle) {
+    const int64_t bytes = handle.size();
+    if (pinned_mem_tracker && !pinned_mem_tracker->TryConsume(bytes)) {
+      return false;
+    }
+    pinned_bytes += bytes;
+    return true;
+  }
 
   const ImmutableCFOptions& ioptions;
   const EnvOptions& env_options;
@@ -209,7 +237,9 @@ struct BlockBasedTable::Rep {
   std::mutex data_index_reader_mutex;
   yb::AtomicUniquePtr<IndexReader> data_index_reader;
   unique_ptr<BlockEntryIteratorState> data_index_iterator_state;
-  unique_ptr<IndexReader> filter_index_reader;
+  // Index of fixed-size filter blocks, loaded on first use when filter is not prefetched on open.
+  std::mutex filter_index_reader_mutex;
+  yb::AtomicUniquePtr<IndexReader> filter_index_reader;
   unique_ptr<FilterBlockReader> filter;
 
   FilterType filter_type;
@@ -220,6 +250,9 @@ struct BlockBasedTable::Rep {
 
   std::shared_ptr<const TableProperties> table_properties;
   IndexType index_type;
+  // Format of data blocks, files written before it was introduced use shared prefix encoding.
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
   bool hash_index_allow_collision;
   bool whole_key_filtering;
   bool prefix_filtering;
@@ -229,6 +262,24 @@ struct BlockBasedTable::Rep {
   // block to extract prefix without knowing if a key is internal or not.
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
+
+  const std::shared_ptr<yb::MemTracker> pinned_mem_tracker;
+  // Memory consumed from pinned_mem_tracker by blocks pinned in this table reader.
+  int64_t pinned_bytes = 0;
+  // Whether top level data index is kept in data_index_reader, even though
+  // table_options.cache_index_and_filter_blocks is set.
+  bool pin_data_index = false;
+
+  // Dictionary used to compress data blocks starting from compression_dict_offset, see
+  // CompressionOptions::max_dict_bytes. It is loaded on open and kept for the lifetime of the
+  // table reader.
+  std::string compression_dict;
+  uint64_t compression_dict_offset = std::numeric_limits<uint64_t>::max();
+
+  Slice CompressionDict(BlockType block_type, const BlockHandle& handle) const {
+    return block_type == BlockType::kData && handle.offset() >= compression_dict_offset
+        ? Slice(compression_dict) : Slice();
+  }
 };
 
 // BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
@@ -246,6 +297,9 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         block_type_(block_type) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    if (block_type_ == BlockType::kData) {
+      MaybeReadahead(index_value);
+    }
     return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
   }
 
@@ -257,6 +311,44 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   }
 
  private:
+  // Number of adjacent data blocks that should be read before we start prefetching.
+  static constexpr int kMinSequentialReadsForReadahead = 2;
+  static constexpr size_t kInitialReadaheadSize = 8_KB;
+
+  // Detects sequential scans, i.e. range scans and forward seeks within nearby keys, and prefetches
+  // data blocks ahead of them. The prefetch size doubles while access stays sequential, so the
+  // device has enough requests in flight to hide its latency.
+  void MaybeReadahead(const Slice& index_value) {
+    const size_t max_readahead_size = table_->rep_->table_options.max_auto_readahead_size;
+    if (max_readahead_size == 0) {
+      return;
+    }
+    BlockHandle handle;
+    Slice input = index_value;
+    if (!handle.DecodeFrom(&input).ok()) {
+      return;
+    }
+    const uint64_t block_end = handle.offset() + handle.size() + kBlockTrailerSize;
+    if (handle.offset() != last_block_end_) {
+      num_sequential_reads_ = 0;
+      readahead_size_ = kInitialReadaheadSize;
+      readahead_limit_ = 0;
+    } else {
+      ++num_sequential_reads_;
+    }
+    last_block_end_ = block_end;
+    if (num_sequential_reads_ < kMinSequentialReadsForReadahead || block_end <= readahead_limit_) {
+      return;
+    }
+    readahead_size_ = std::min(readahead_size_, max_readahead_size);
+    // Errors are ignored, prefetch is just a hint and the read itself will report a failure.
+    WARN_NOT_OK(table_->GetBlockReader(BlockType::kData)->reader->Prefetch(
+                    handle.offset(), readahead_size_),
+                "Prefetch failed");
+    readahead_limit_ = handle.offset() + readahead_size_;
+    readahead_size_ = std::min(readahead_size_ * 2, max_readahead_size);
+  }
+
   // Don't own table_. BlockEntryIteratorState should only be stored in iterators or in
   // corresponding BlockBasedTable. TableReader (superclass of BlockBasedTable) is only destroyed
   // after iterator is deleted.
@@ -264,6 +356,12 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+
+  // Readahead state, see MaybeReadahead.
+  uint64_t last_block_end_ = std::numeric_limits<uint64_t>::max();
+  int num_sequential_reads_ = 0;
+  size_t readahead_size_ = kInitialReadaheadSize;
+  uint64_t readahead_limit_ = 0;
 };
 
 
@@ -299,6 +397,59 @@ void BlockBasedTable::SetupCacheKeyPrefix(Rep* rep,
         reader_with_cache_prefix->reader->file(),
         &reader_with_cache_prefix->compressed_cache_key_prefix);
   }
+  if (rep->table_options.persistent_cache != nullptr) {
+    auto& prefix = reader_with_cache_prefix->persistent_cache_key_prefix;
+    prefix.size = reader_with_cache_prefix->reader->file()->GetUniqueId(
+        prefix.data, block_based_table::kMaxCacheKeyPrefixSize);
+  } else {
+    reader_with_cache_prefix->persistent_cache_key_prefix.size = 0;
+  }
+}
+
+Status BlockBasedTable::ReadBlockWithPersistentCache(
+    FileReaderWithCachePrefix* reader, const ReadOptions& ro, const BlockHandle& handle,
+    bool do_uncompress, const Slice& compression_dict, std::unique_ptr<Block>* result) {
+  PersistentCache* persistent_cache = rep_->table_options.persistent_cache.get();
+  if (persistent_cache == nullptr || reader->persistent_cache_key_prefix.size == 0) {
+    return block_based_table::ReadBlockFromFile(
+        reader->reader.get(), rep_->footer, ro, handle, result, rep_->ioptions.env, do_uncompress,
+        compression_dict);
+  }
+
+  // Blocks are stored in the same form as in table file: contents followed by compression type.
+  char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
+  auto key = GetCacheKey(reader->persistent_cache_key_prefix, handle, cache_key);
+  const size_t n = static_cast<size_t>(handle.size());
+  Statistics* statistics = rep_->ioptions.statistics;
+  BlockContents contents;
+  std::unique_ptr<char[]> raw;
+  size_t raw_size = 0;
+  if (persistent_cache->Lookup(key, &raw, &raw_size).ok() && raw_size == n + 1) {
+    RecordTick(statistics, PERSISTENT_CACHE_HIT);
+    const auto compression_type = static_cast<CompressionType>(raw[n]);
+    if (do_uncompress && compression_type != kNoCompression) {
+      RETURN_NOT_OK(UncompressBlockContents(
+          raw.get(), n, &contents, rep_->footer.version(), compression_dict));
+    } else {
+      contents = BlockContents(std::move(raw), n, true, compression_type);
+    }
+  } else {
+    RecordTick(statistics, PERSISTENT_CACHE_MISS);
+    RETURN_NOT_OK(ReadBlockContents(
+        reader->reader.get(), rep_->footer, ro, handle, &contents, rep_->ioptions.env,
+        false /* do_uncompress */));
+    std::string value;
+    value.reserve(n + 1);
+    value.append(contents.data.cdata(), n);
+    value.push_back(static_cast<char>(contents.compression_type));
+    persistent_cache->Insert(key, value);
+    if (do_uncompress && contents.compression_type != kNoCompression) {
+      RETURN_NOT_OK(UncompressBlockContents(
+          value.data(), n, &contents, rep_->footer.version(), compression_dict));
+    }
+  }
+  result->reset(new Block(std::move(contents)));
+  return Status::OK();
 }
 
 BlockBasedTable::FileReaderWithCachePrefix* BlockBasedTable::GetBlockReader(BlockType block_type) {
@@ -312,13 +463,16 @@ BlockBasedTable::FileReaderWithCachePrefix* BlockBasedTable::GetBlockReader(Bloc
 }
 
 BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
-    const ReadOptions& read_options, const Slice& user_key)
-    : read_options_(read_options), user_key_(user_key.ToBuffer()) {}
+    const ReadOptions& read_options, const Slice& user_key,
+    const FilterPolicy::KeyTransformer* filter_key_transformer)
+    : read_options_(read_options),
+      filter_key_(filter_key_transformer ? filter_key_transformer->Transform(user_key).ToBuffer()
+                                         : user_key.ToBuffer()) {}
 
 bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
   auto table = down_cast<BlockBasedTable*>(reader);
   if (table->rep_->filter_type == FilterType::kFixedSizeFilter) {
-    const auto filter_key = table->GetFilterKeyFromUserKey(user_key_);
+    const Slice filter_key(filter_key_);
     auto filter_entry = table->GetFilter(read_options_.query_id,
         read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
     FilterBlockReader* filter = filter_entry.value;
@@ -458,6 +612,21 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
         "Cannot find Properties block from file.");
   }
 
+  // Read compression dictionary.
+  BlockHandle compression_dict_handle;
+  if (FindMetaBlock(meta_iter.get(), block_based_table::kCompressionDictBlock,
+                    &compression_dict_handle).ok()) {
+    BlockContents contents;
+    RETURN_NOT_OK(ReadBlockContents(
+        rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+        compression_dict_handle, &contents, rep->ioptions.env, false /* do_uncompress */));
+    Slice input = contents.data;
+    if (!GetVarint64(&input, &rep->compression_dict_offset)) {
+      return STATUS(Corruption, "Bad compression dictionary block");
+    }
+    rep->compression_dict = input.ToBuffer();
+  }
+
   // Determine whether whole key filtering is supported.
   if (rep->table_properties) {
     rep->whole_key_filtering &=
@@ -467,11 +636,25 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     rep->prefix_filtering &= IsFeatureSupported(
         *(rep->table_properties),
         BlockBasedTablePropertyNames::kPrefixFiltering, rep->ioptions.info_log);
+    const auto& props = rep->table_properties->user_collected_properties;
+    const auto pos = props.find(BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat);
+    if (pos != props.end()) {
+      rep->data_block_key_value_encoding_format =
+          static_cast<KeyValueEncodingFormat>(DecodeFixed32(pos->second.c_str()));
+    }
   }
 
+  // Top level index and filter are pinned in table reader instead of block cache if requested and
+  // there is enough memory budget for them.
+  const bool pin_in_reader = table_options.cache_index_and_filter_blocks &&
+                             table_options.pin_top_level_index_and_filter;
+  rep->pin_data_index = pin_in_reader &&
+                        data_index_load_mode != DataIndexLoadMode::USE_CACHE &&
+                        rep->TryReservePinned(footer.index_handle());
+
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
     // Will use block cache for data index access?
-    if (table_options.cache_index_and_filter_blocks) {
+    if (table_options.cache_index_and_filter_blocks && !rep->pin_data_index) {
       DCHECK_ONLY_NOTNULL(table_options.block_cache.get());
       // Hack: Call NewIndexIterator() to implicitly add index to the
       // block_cache
@@ -493,7 +676,9 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     if (rep->filter_policy && rep->filter_type == FilterType::kFixedSizeFilter) {
       // TODO: may be put it in block cache instead of table reader in case
       // table_options.cache_index_and_filter_blocks is set?
-      s = new_table->CreateFilterIndexReader(&rep->filter_index_reader);
+      std::unique_ptr<IndexReader> filter_index_reader;
+      s = new_table->CreateFilterIndexReader(&filter_index_reader);
+      rep->filter_index_reader.reset(filter_index_reader.release());
     }
 
     // Will use block cache for filter blocks access?
@@ -504,9 +689,13 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
         case FilterType::kFullFilter:
           FALLTHROUGH_INTENDED;
         case FilterType::kBlockBasedFilter: {
-          // Hack: Call GetFilter() to implicitly add filter to the block_cache
-          auto filter_entry = new_table->GetFilter(kDefaultQueryId);
-          filter_entry.Release(table_options.block_cache.get());
+          if (pin_in_reader && rep->TryReservePinned(rep->filter_handle)) {
+            rep->filter.reset(ReadFilterBlock(rep->filter_handle, rep, nullptr));
+          } else {
+            // Hack: Call GetFilter() to implicitly add filter to the block_cache
+            auto filter_entry = new_table->GetFilter(kDefaultQueryId);
+            filter_entry.Release(table_options.block_cache.get());
+          }
           corrupted_filter_type = false;
           break;
         }
@@ -609,8 +798,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->filter) {
     usage += rep_->filter->ApproximateMemoryUsage();
   }
-  if (rep_->filter_index_reader) {
-    usage += rep_->filter_index_reader->ApproximateMemoryUsage();
+  IndexReader* filter_index_reader = rep_->filter_index_reader.get(std::memory_order_relaxed);
+  if (filter_index_reader) {
+    usage += filter_index_reader->ApproximateMemoryUsage();
   }
   IndexReader* data_index_reader = rep_->data_index_reader.get(std::memory_order_relaxed);
   if (data_index_reader) {
@@ -677,7 +867,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-    uint32_t format_version, BlockType block_type) {
+    uint32_t format_version, BlockType block_type, const Slice& compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -722,7 +912,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(),
                               compressed_block->size(), &contents,
-                              format_version);
+                              format_version, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -749,7 +939,8 @@ Status BlockBasedTable::PutDataBlockToCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
-    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version) {
+    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+    const Slice& compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -758,7 +949,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version);
+                                format_version, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -803,7 +994,8 @@ Status BlockBasedTable::PutDataBlockToCache(
   return s;
 }
 
-Status BlockBasedTable::CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader) {
+Status BlockBasedTable::CreateFilterIndexReader(
+    std::unique_ptr<IndexReader>* filter_index_reader) const {
   auto base_file_reader = rep_->base_reader_with_cache_prefix->reader.get();
   auto env = rep_->ioptions.env;
   auto footer = rep_->footer;
@@ -860,9 +1052,21 @@ FilterBlockReader* BlockBasedTable::ReadFilterBlock(const BlockHandle& filter_ha
 
 Status BlockBasedTable::GetFixedSizeFilterBlockHandle(const Slice& filter_key,
     BlockHandle* filter_block_handle) const {
+  IndexReader* filter_index_reader = rep_->filter_index_reader.get();
+  if (!filter_index_reader) {
+    std::lock_guard<std::mutex> lock(rep_->filter_index_reader_mutex);
+    filter_index_reader = rep_->filter_index_reader.get(std::memory_order_relaxed);
+    if (!filter_index_reader) {
+      std::unique_ptr<IndexReader> filter_index_reader_holder;
+      RETURN_NOT_OK(CreateFilterIndexReader(&filter_index_reader_holder));
+      filter_index_reader = filter_index_reader_holder.release();
+      rep_->filter_index_reader.reset(filter_index_reader, std::memory_order_acq_rel);
+    }
+  }
+
   // Determine block of fixed-size bloom filter using filter index.
   BlockIter fiter;
-  rep_->filter_index_reader->NewIterator(&fiter,
+  filter_index_reader->NewIterator(&fiter,
       // Following parameters are ignored by BinarySearchIndexReader which we use as
       // filter_index_reader.
       nullptr /* index_iterator_state */, true /* total_order_seek */);
@@ -905,7 +1109,10 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
   // Note: rep_->filter can be nullptr also if Open was called with
   // prefetch_index_and_filter == false. That means bloom filters are not be used if
   // both prefetch_index_and_filter and table_options.cache_index_and_filter_blocks are false.
-  if (!rep_->table_options.cache_index_and_filter_blocks && !is_fixed_size_filter) {
+  // When table_options.pin_top_level_index_and_filter is set, the filter may be pinned in
+  // rep_->filter even though cache_index_and_filter_blocks is true.
+  if ((!rep_->table_options.cache_index_and_filter_blocks || rep_->filter) &&
+      !is_fixed_size_filter) {
     return {rep_->filter.get(), nullptr /* cache handle */};
   }
 
@@ -924,6 +1131,10 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
   // Determine filter block handle
   BlockHandle fixed_size_filter_block_handle;
   if (is_fixed_size_filter) {
+    if (no_io && rep_->filter_index_reader.get() == nullptr) {
+      // Filter index was not loaded yet.
+      return {nullptr /* filter */, nullptr /* cache handle */};
+    }
     Status s = GetFixedSizeFilterBlockHandle(*filter_key, &fixed_size_filter_block_handle);
     if (s.ok()) {
       if (fixed_size_filter_block_handle.IsNull()) {
@@ -936,7 +1147,8 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
       // production to continue operation in case of just filter corruption,
       // but we should fail in debug and under tests to be able to catch possible bugs.
       RLOG(InfoLogLevel::ERROR_LEVEL, rep_->ioptions.info_log,
-          "Failed to decode fixed-size filter block handle from filter index.");
+          "Failed to get fixed-size filter block handle from filter index: %s",
+          s.ToString().c_str());
       FAIL_IF_NOT_PRODUCTION();
       return {nullptr /* filter */, nullptr /* cache handle */};
     }
@@ -1012,7 +1224,7 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
   Cache* const block_cache = rep_->table_options.block_cache.get();
 
   if (block_cache && (rep_->data_index_load_mode == DataIndexLoadMode::USE_CACHE ||
-      rep_->table_options.cache_index_and_filter_blocks)) {
+      (rep_->table_options.cache_index_and_filter_blocks && !rep_->pin_data_index))) {
     char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
     auto key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
         rep_->footer.index_handle(), cache_key);
@@ -1110,6 +1322,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   }
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  const Slice compression_dict = rep_->CompressionDict(block_type, handle);
 
   // If either block cache is enabled, we'll try to read from it.
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
@@ -1130,21 +1343,23 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
     s = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type);
+        rep_->table_options.format_version, block_type, compression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
+      // Blocks read here are charged to the block cache tracker once inserted to the cache.
+      yb::ScopedAllocationAttribution allocation_attribution(
+          block_cache != nullptr ? block_cache->GetMemTracker() : nullptr);
       std::unique_ptr<Block> raw_block;
       {
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
-        s = block_based_table::ReadBlockFromFile(
-            reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            block_cache_compressed == nullptr);
+        s = ReadBlockWithPersistentCache(
+            reader, ro, handle, block_cache_compressed == nullptr, compression_dict, &raw_block);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version);
+                                rep_->table_options.format_version, compression_dict);
       }
     }
   }
@@ -1161,8 +1376,8 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
       }
     }
     std::unique_ptr<Block> block_value;
-    s = block_based_table::ReadBlockFromFile(
-        reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env);
+    s = ReadBlockWithPersistentCache(
+        reader, ro, handle, true /* do_uncompress */, compression_dict, &block_value);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1170,7 +1385,10 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
   InternalIterator* iter;
   if (s.ok() && block.value != nullptr) {
-    iter = block.value->NewIterator(rep_->comparator.get(), input_iter);
+    iter = block.value->NewIterator(
+        rep_->comparator.get(), input_iter, true /* total_order_seek */,
+        block_type == BlockType::kData ? rep_->data_block_key_value_encoding_format
+                                       : KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
     if (block.cache_handle != nullptr) {
       iter->RegisterCleanup(&ReleaseCachedEntry, block_cache,
           block.cache_handle);
@@ -1406,6 +1624,103 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
   return s;
 }
 
+void BlockBasedTable::MultiGet(const ReadOptions& read_options,
+                               std::vector<MultiGetEntry>* entries, bool skip_filters) {
+  const bool is_block_based_filter = rep_->filter_type == FilterType::kBlockBasedFilter;
+  // Created on the first key that passes the filter.
+  std::unique_ptr<IndexIteratorHolder> iiter_holder;
+  // Iterator over the data block, that was used by the previous key, and its encoded handle.
+  std::unique_ptr<BlockIter> biter;
+  std::string biter_handle;
+
+  for (auto& entry : *entries) {
+    const Slice& internal_key = entry.internal_key;
+    GetContext* get_context = entry.get_context;
+    CachableEntry<FilterBlockReader> filter_entry;
+    Slice filter_key;
+    if (!skip_filters) {
+      filter_key = GetFilterKeyFromInternalKey(internal_key);
+      filter_entry = GetFilter(read_options.query_id,
+                               read_options.read_tier == kBlockCacheTier,
+                               &filter_key);
+    }
+    FilterBlockReader* filter = filter_entry.value;
+
+    if (!is_block_based_filter && !NonBlockBasedFilterKeyMayMatch(filter, filter_key)) {
+      RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+      filter_entry.Release(rep_->table_options.block_cache.get());
+      entry.status = Status::OK();
+      continue;
+    }
+
+    if (!iiter_holder) {
+      iiter_holder = std::make_unique<IndexIteratorHolder>(this, read_options);
+    }
+    InternalIterator& iiter = *iiter_holder->iter();
+    Status s = iiter.status();
+    if (!s.ok()) {
+      entry.status = s;
+      filter_entry.Release(rep_->table_options.block_cache.get());
+      continue;
+    }
+
+    bool done = false;
+    for (iiter.Seek(internal_key); !done && iiter.Valid(); iiter.Next()) {
+      Slice data_block_handle_encoded = iiter.value();
+
+      if (!skip_filters && is_block_based_filter) {
+        RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_CHECKED);
+        BlockHandle data_block_handle;
+        Slice input = data_block_handle_encoded;
+        const bool absent_from_filter =
+            data_block_handle.DecodeFrom(&input).ok()
+            && !filter->KeyMayMatch(filter_key, data_block_handle.offset());
+        if (absent_from_filter) {
+          RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+          break;
+        }
+      }
+
+      if (!biter || data_block_handle_encoded != biter_handle) {
+        biter = std::make_unique<BlockIter>();
+        NewDataBlockIterator(read_options, data_block_handle_encoded, BlockType::kData,
+                             biter.get());
+        biter_handle = data_block_handle_encoded.ToBuffer();
+      }
+
+      if (read_options.read_tier == kBlockCacheTier && biter->status().IsIncomplete()) {
+        get_context->MarkKeyMayExist();
+        break;
+      }
+      if (!biter->status().ok()) {
+        s = biter->status();
+        break;
+      }
+
+      for (biter->Seek(internal_key); biter->Valid(); biter->Next()) {
+        ParsedInternalKey parsed_key;
+        if (!ParseInternalKey(biter->key(), &parsed_key)) {
+          s = STATUS(Corruption, Slice());
+        }
+
+        if (!get_context->SaveValue(parsed_key, biter->value())) {
+          done = true;
+          break;
+        }
+      }
+      if (s.ok()) {
+        s = biter->status();
+      }
+    }
+    if (s.ok()) {
+      s = iiter.status();
+    }
+    entry.status = s;
+
+    filter_entry.Release(rep_->table_options.block_cache.get());
+  }
+}
+
 Status BlockBasedTable::Prefetch(const Slice* const begin,
                                  const Slice* const end) {
   auto& comparator = *rep_->comparator;
@@ -1469,7 +1784,8 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
   Slice ckey;
 
   s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version, BlockType::kData);
+      rep_->table_options.format_version, BlockType::kData,
+      rep_->CompressionDict(BlockType::kData, handle));
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1600,6 +1916,40 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
+
+  // Index key of a block is not less than the last key of the block, so the first half of blocks
+  // ends at the key of the middle entry.
+  size_t num_entries = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    ++num_entries;
+  }
+  RETURN_NOT_OK(index_iter->status());
+  if (num_entries == 0) {
+    return STATUS(Incomplete, "Empty SST file");
+  }
+
+  index_iter->SeekToFirst();
+  for (size_t i = 0; i != (num_entries - 1) / 2; ++i) {
+    index_iter->Next();
+  }
+  RETURN_NOT_OK(index_iter->status());
+  if (!index_iter->Valid()) {
+    return STATUS(Corruption, "Index changed during iteration");
+  }
+
+  // Index keys could be shortened separators, that are not present in the table, so return the
+  // actual key the separator points to.
+  unique_ptr<InternalIterator> iter(NewIterator(ReadOptions::kDefault));
+  iter->Seek(index_iter->key());
+  RETURN_NOT_OK(iter->status());
+  if (!iter->Valid()) {
+    return STATUS(Incomplete, "No keys after middle index entry");
+  }
+  return iter->key().ToBuffer();
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
@@ -1608,6 +1958,10 @@ bool BlockBasedTable::TEST_index_reader_loaded() const {
   return rep_->data_index_reader.get() != nullptr;
 }
 
+bool BlockBasedTable::TEST_filter_index_reader_loaded() const {
+  return rep_->filter_index_reader.get() != nullptr;
+}
+
 Status BlockBasedTable::DumpTable(WritableFile* out_file) {
   // Output Footer
   out_file->Append(
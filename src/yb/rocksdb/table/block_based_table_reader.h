@@ -29,6 +29,7 @@
 #include <utility>
 #include <string>
 
+#include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/status.h"
@@ -89,13 +90,16 @@ YB_DEFINE_ENUM(BlockType, (kData)(kIndex));
 // hashed components as the key specified in constructor.
 class BloomFilterAwareFileFilter : public TableAwareReadFileFilter {
  public:
-  BloomFilterAwareFileFilter(const ReadOptions& read_options, const Slice& user_key);
+  // filter_key_transformer should be the one used by tables that will be filtered, it is applied
+  // to user_key once instead of doing it for each table.
+  BloomFilterAwareFileFilter(const ReadOptions& read_options, const Slice& user_key,
+                             const FilterPolicy::KeyTransformer* filter_key_transformer);
 
   bool Filter(TableReader* reader) const override;
 
  private:
   const ReadOptions read_options_;
-  const std::string user_key_;
+  const std::string filter_key_;
 };
 
 // A Table is a sorted map from strings to strings.  Tables are
@@ -151,6 +155,11 @@ class BlockBasedTable : public TableReader {
   Status Get(const ReadOptions& readOptions, const Slice& key,
              GetContext* get_context, bool skip_filters = false) override;
 
+  // Reuses index iterator for the whole batch, and data block iterator for consecutive keys that
+  // are located in the same data block.
+  void MultiGet(const ReadOptions& read_options, std::vector<MultiGetEntry>* entries,
+                bool skip_filters = false) override;
+
   // Pre-fetch the disk blocks that correspond to the key range specified by
   // (kbegin, kend). The call will return return error status in the event of
   // IO or iteration error.
@@ -164,6 +173,11 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Returns the first key at or after the middle entry of the data index. Index entries point to
+  // data blocks of about the same size, so it splits table data into two halves while reading
+  // only one data block.
+  yb::Result<std::string> GetMiddleKey() override;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -190,6 +204,7 @@ class BlockBasedTable : public TableReader {
 
   bool TEST_filter_block_preloaded() const;
   bool TEST_index_reader_loaded() const;
+  bool TEST_filter_index_reader_loaded() const;
 
  private:
   template <class TValue>
@@ -247,7 +262,7 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-      uint32_t format_version, BlockType block_type);
+      uint32_t format_version, BlockType block_type, const Slice& compression_dict);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -261,7 +276,8 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
-      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version);
+      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+      const Slice& compression_dict);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -291,7 +307,7 @@ class BlockBasedTable : public TableReader {
       size_t* filter_size = nullptr);
 
   // CreateFilterIndexReader from sst
-  Status CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader);
+  Status CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader) const;
 
   // Helper function to setup the cache key's prefix for block of file passed within a reader
   // instance. Used for both data and metadata files.
@@ -299,6 +315,12 @@ class BlockBasedTable : public TableReader {
 
   FileReaderWithCachePrefix* GetBlockReader(BlockType block_type);
 
+  // Reads block using the persistent cache, when it is configured. Blocks that are missing in the
+  // persistent cache are read from file and scheduled for write to the persistent cache.
+  CHECKED_STATUS ReadBlockWithPersistentCache(
+      FileReaderWithCachePrefix* reader, const ReadOptions& ro, const BlockHandle& handle,
+      bool do_uncompress, const Slice& compression_dict, std::unique_ptr<Block>* result);
+
   explicit BlockBasedTable(Rep* rep) : rep_(rep) {}
 
   // Helper functions for DumpTable()
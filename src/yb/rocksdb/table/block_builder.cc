@@ -40,6 +40,22 @@
 //     value: char[value_length]
 // shared_bytes == 0 for restart points.
 //
+// With KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts, restart points use the format
+// above, while other entries have the form:
+//     shared_prefix_size: varint32
+//     non_shared_1_size: varint32
+//     non_shared_2_size: varint32
+//     shared_middle_size: varint32
+//     value_length: varint32
+//     trailer_delta: varint64 (zigzag encoded)
+//     non_shared_1: char[non_shared_1_size]
+//     non_shared_2: char[non_shared_2_size]
+//     value: char[value_length]
+// The user key is <shared_prefix><non_shared_1><shared_middle><non_shared_2>, where shared_prefix
+// is the prefix of the previous user key and shared_middle is taken from the previous user key
+// from the same distance to its end. Internal key trailer (sequence number and value type) is
+// stored as the difference with the trailer of the previous key.
+//
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
@@ -57,9 +73,11 @@
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+                           KeyValueEncodingFormat key_value_encoding_format)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      key_value_encoding_format_(key_value_encoding_format),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -95,6 +113,10 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key, const Slice& value)
   }
 
   estimate += sizeof(int32_t); // varint for shared prefix length.
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    // varints for non shared 2, shared middle and trailer delta.
+    estimate += 2 * sizeof(int32_t) + sizeof(int64_t);
+  }
   estimate += VarintLength(key.size()); // varint for key length.
   estimate += VarintLength(value.size()); // varint for value length.
 
@@ -124,6 +146,13 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
     counter_ = 0;
+  } else if (use_delta_encoding_ && !buffer_.empty() &&
+             key_value_encoding_format_ ==
+                 KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    AddWithThreeSharedParts(key, value);
+    last_key_.assign(key.cdata(), key.size());
+    counter_++;
+    return;
   } else if (use_delta_encoding_) {
     // See how much sharing to do with previous string
     const size_t min_length = std::min(last_key_piece.size(), key.size());
@@ -149,4 +178,52 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   counter_++;
 }
 
+void BlockBuilder::AddWithThreeSharedParts(const Slice& key, const Slice& value) {
+  assert(key.size() >= kLastInternalComponentSize);
+  assert(last_key_.size() >= kLastInternalComponentSize);
+  const char* const key_data = key.cdata();
+  const char* const last_key_data = last_key_.data();
+  const size_t user_key_size = key.size() - kLastInternalComponentSize;
+  const size_t last_user_key_size = last_key_.size() - kLastInternalComponentSize;
+  const size_t min_size = std::min(user_key_size, last_user_key_size);
+
+  size_t shared_prefix = 0;
+  while (shared_prefix < min_size && last_key_data[shared_prefix] == key_data[shared_prefix]) {
+    ++shared_prefix;
+  }
+
+  // Find the longest run of bytes that match in both user keys at the same distance from the end.
+  // For DocDB keys it is usually the hybrid time, followed by a write id that differs.
+  size_t shared_middle = 0;
+  size_t non_shared_2 = 0;
+  size_t run_length = 0;
+  const size_t max_suffix = min_size - shared_prefix;
+  for (size_t i = 0; i != max_suffix; ++i) {
+    if (key_data[user_key_size - 1 - i] == last_key_data[last_user_key_size - 1 - i]) {
+      ++run_length;
+      if (run_length > shared_middle) {
+        shared_middle = run_length;
+        non_shared_2 = i + 1 - run_length;
+      }
+    } else {
+      run_length = 0;
+    }
+  }
+  const size_t non_shared_1 = user_key_size - shared_prefix - shared_middle - non_shared_2;
+
+  const uint64_t trailer = DecodeFixed64(key_data + user_key_size);
+  const uint64_t last_trailer = DecodeFixed64(last_key_data + last_user_key_size);
+
+  PutVarint32(&buffer_, static_cast<uint32_t>(shared_prefix));
+  PutVarint32(&buffer_, static_cast<uint32_t>(non_shared_1));
+  PutVarint32(&buffer_, static_cast<uint32_t>(non_shared_2));
+  PutVarint32(&buffer_, static_cast<uint32_t>(shared_middle));
+  PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
+  PutVarint64(&buffer_, ZigZagEncode64(static_cast<int64_t>(trailer - last_trailer)));
+
+  buffer_.append(key_data + shared_prefix, non_shared_1);
+  buffer_.append(key_data + user_key_size - non_shared_2, non_shared_2);
+  buffer_.append(value.cdata(), value.size());
+}
+
 }  // namespace rocksdb
@@ -26,6 +26,9 @@
 
 #include <stdint.h>
 #include <vector>
+
+#include "yb/rocksdb/table.h"
+
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -35,8 +38,12 @@ class BlockBuilder {
   BlockBuilder(const BlockBuilder&) = delete;
   void operator=(const BlockBuilder&) = delete;
 
+  // KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts requires internal keys, and is only
+  // applied when use_delta_encoding is true.
   explicit BlockBuilder(int block_restart_interval,
-                        bool use_delta_encoding = true);
+                        bool use_delta_encoding = true,
+                        KeyValueEncodingFormat key_value_encoding_format =
+                            KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -65,8 +72,11 @@ class BlockBuilder {
   }
 
  private:
+  void AddWithThreeSharedParts(const Slice& key, const Slice& value);
+
   const int          block_restart_interval_;
   const bool         use_delta_encoding_;
+  const KeyValueEncodingFormat key_value_encoding_format_;
 
   std::string           buffer_;    // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
@@ -18,6 +18,8 @@
 // under the License.
 //
 #include <stdio.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -243,6 +245,104 @@ TEST_F(BlockTest, IndexHashWithSharedPrefix) {
   CheckBlockContents(std::move(contents), kMaxKey, keys, values);
 }
 
+namespace {
+
+// Generates sorted internal keys that look like DocDB keys: row key, column id, hybrid time and
+// write id.
+std::vector<std::string> GenerateDocDBLikeKeys(int num_rows, Random* rnd) {
+  std::vector<std::string> keys;
+  SequenceNumber seq = 1000;
+  for (int row = 0; row != num_rows; ++row) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "row%06d", row * 7);
+    const std::string hybrid_time = RandomString(rnd, 8);
+    const int num_columns = 1 + rnd->Uniform(10);
+    for (int column = 0; column != num_columns; ++column) {
+      std::string user_key = buf;
+      // Column ids of different lengths.
+      if (column >= 5) {
+        user_key.push_back('\x7f');
+      }
+      user_key.push_back(static_cast<char>('0' + column));
+      if (rnd->OneIn(5)) {
+        // Some columns are written at a different hybrid time.
+        user_key += 'H' + RandomString(rnd, 8);
+      } else {
+        user_key += 'H' + hybrid_time;
+      }
+      // Write ids of different lengths.
+      user_key.push_back(static_cast<char>(column));
+      if (rnd->OneIn(3)) {
+        user_key.push_back(static_cast<char>(rnd->Uniform(256)));
+      }
+      keys.push_back(InternalKey(user_key, seq, kTypeValue).Encode().ToString());
+      seq += rnd->Uniform(3);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  return keys;
+}
+
+} // namespace
+
+TEST_F(BlockTest, ThreeSharedPartsEncoding) {
+  Random rnd(301);
+  const auto keys = GenerateDocDBLikeKeys(10000, &rnd);
+  std::vector<std::string> values;
+  for (size_t i = 0; i != keys.size(); ++i) {
+    values.push_back(RandomString(&rnd, rnd.Uniform(10)));
+  }
+
+  BlockBuilder shared_prefix_builder(16);
+  BlockBuilder builder(
+      16, true /* use_delta_encoding */, KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts);
+  for (size_t i = 0; i != keys.size(); ++i) {
+    shared_prefix_builder.Add(keys[i], values[i]);
+    builder.Add(keys[i], values[i]);
+  }
+  const size_t shared_prefix_size = shared_prefix_builder.Finish().size();
+  BlockContents contents;
+  contents.data = builder.Finish();
+  contents.cachable = false;
+  ASSERT_LT(contents.data.size(), shared_prefix_size);
+  Block reader(std::move(contents));
+
+  std::unique_ptr<InternalIterator> iter(reader.NewIterator(
+      BytewiseComparator(), nullptr /* iter */, true /* total_order_seek */,
+      KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts));
+
+  size_t index = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++index) {
+    ASSERT_LT(index, keys.size());
+    ASSERT_EQ(keys[index], iter->key().ToString());
+    ASSERT_EQ(values[index], iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(keys.size(), index);
+
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    ASSERT_GT(index, 0U);
+    --index;
+    ASSERT_EQ(keys[index], iter->key().ToString());
+    ASSERT_EQ(values[index], iter->value().ToString());
+  }
+  ASSERT_EQ(0U, index);
+
+  for (int i = 0; i != 10000; ++i) {
+    index = rnd.Uniform(static_cast<int>(keys.size()));
+    iter->Seek(keys[index]);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys[index], iter->key().ToString());
+    ASSERT_EQ(values[index], iter->value().ToString());
+    if (index + 1 < keys.size()) {
+      iter->Next();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(keys[index + 1], iter->key().ToString());
+    }
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char **argv) {
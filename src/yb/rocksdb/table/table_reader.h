@@ -25,7 +25,9 @@
 #define ROCKSDB_TABLE_TABLE_READER_H
 
 #include <memory>
+#include <vector>
 
+#include "yb/util/result.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -72,6 +74,12 @@ class TableReader {
   // be close to the file length.
   virtual uint64_t ApproximateOffsetOf(const Slice& key) = 0;
 
+  // Returns approximate middle key of the table, i.e. the key that splits data of the table into
+  // two parts of about the same size. Returned key is an internal key.
+  virtual yb::Result<std::string> GetMiddleKey() {
+    return STATUS(NotSupported, "GetMiddleKey is not supported by this table format");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -98,6 +106,23 @@ class TableReader {
   virtual Status Get(const ReadOptions& readOptions, const Slice& internal_key,
                      GetContext* get_context, bool skip_filters = false) = 0;
 
+  // Single key lookup of the batch processed by MultiGet.
+  struct MultiGetEntry {
+    Slice internal_key;
+    GetContext* get_context;
+    Status status;
+  };
+
+  // Batched version of Get, that stores result of each lookup into entry status.
+  // Entries should be sorted by internal key, so implementations could share index seeks and
+  // data blocks between consecutive keys.
+  virtual void MultiGet(const ReadOptions& read_options, std::vector<MultiGetEntry>* entries,
+                        bool skip_filters = false) {
+    for (auto& entry : *entries) {
+      entry.status = Get(read_options, entry.internal_key, entry.get_context, skip_filters);
+    }
+  }
+
   // Prefetch data corresponding to a give range of keys
   // Typically this functionality is required for table implementations that
   // persists the data on a non volatile storage medium like disk/SSD
@@ -63,6 +63,8 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/util/enums.h"
+#include "yb/util/format.h"
+#include "yb/util/mem_tracker.h"
 
 DECLARE_double(cache_single_touch_ratio);
 
@@ -323,8 +325,8 @@ class TableConstructor: public Constructor {
 
     // Open the table
     uniq_id_ = cur_uniq_id_++;
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, internal_comparator),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -345,8 +347,8 @@ class TableConstructor: public Constructor {
   }
 
   virtual Status Reopen(const ImmutableCFOptions& ioptions) {
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, last_internal_key_),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -356,6 +358,11 @@ class TableConstructor: public Constructor {
     return table_reader_.get();
   }
 
+  // File the table reader reads from, owned by the table reader.
+  test::StringSource* GetSource() {
+    return source_;
+  }
+
   bool AnywayDeleteIterator() const override {
     return convert_to_internal_key_;
   }
@@ -367,6 +374,7 @@ class TableConstructor: public Constructor {
  private:
   void Reset() {
     uniq_id_ = 0;
+    source_ = nullptr;
     table_reader_.reset();
     file_writer_.reset();
     file_reader_.reset();
@@ -380,6 +388,7 @@ class TableConstructor: public Constructor {
   unique_ptr<WritableFileWriter> file_writer_;
   unique_ptr<RandomAccessFileReader> file_reader_;
   unique_ptr<TableReader> table_reader_;
+  test::StringSource* source_ = nullptr;
   bool convert_to_internal_key_;
 
   TableConstructor();
@@ -1570,6 +1579,61 @@ TEST_F(BlockBasedTableTest, NumBlockStat) {
             c.GetTableReader()->GetTableProperties()->num_data_blocks);
 }
 
+namespace {
+
+// Builds table of values that share structure, but not adjacent content, and checks that it is
+// readable. Returns size of data blocks.
+uint64_t BuildTableWithCompressionDict(uint32_t max_dict_bytes) {
+  Random rnd(301);
+  TableConstructor c(BytewiseComparator());
+  for (int i = 0; i < 2000; ++i) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%06d", i);
+    c.Add(key, yb::Format(
+        R"({"id": $0, "name": "$1", "email": "$1@example.com", "status": "active"})",
+        rnd.Uniform(1000000), RandomString(&rnd, 8)));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  Options options;
+  auto ikc = std::make_shared<test::PlainInternalKeyComparator>(options.comparator);
+  options.compression = kZlibCompression;
+  options.compression_opts.max_dict_bytes = max_dict_bytes;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options, ikc, &keys, &kvmap);
+
+  unique_ptr<InternalIterator> iter(c.NewIterator());
+  iter->SeekToFirst();
+  for (const auto& entry : kvmap) {
+    EXPECT_TRUE(iter->Valid());
+    if (!iter->Valid()) {
+      break;
+    }
+    EXPECT_EQ(entry.second, iter->value().ToBuffer());
+    iter->Next();
+  }
+  EXPECT_FALSE(iter->Valid());
+  EXPECT_OK(iter->status());
+  return c.GetTableReader()->GetTableProperties()->data_size;
+}
+
+} // namespace
+
+TEST_F(BlockBasedTableTest, CompressionDict) {
+  if (!Zlib_Supported()) {
+    fprintf(stderr, "skipping zlib compression dictionary test\n");
+    return;
+  }
+  const auto size_without_dict = BuildTableWithCompressionDict(0);
+  const auto size_with_dict = BuildTableWithCompressionDict(8192);
+  LOG(INFO) << "Data size without dictionary: " << size_without_dict
+            << ", with dictionary: " << size_with_dict;
+  ASSERT_LT(size_with_dict, size_without_dict);
+}
+
 // A simple tool that takes the snapshot of block cache statistics.
 class BlockCachePropertiesSnapshot {
  public:
@@ -1864,6 +1928,117 @@ void ValidateBlockRestartInterval(int value, int expected) {
   delete factory;
 }
 
+TEST_F(BlockBasedTableTest, PinTopLevelIndexAndFilter) {
+  Options options;
+  options.create_if_missing = true;
+  options.statistics = CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1_MB);
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.pin_top_level_index_and_filter = true;
+  table_options.pinned_index_and_filter_mem_tracker = yb::MemTracker::CreateTracker("pinned");
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+
+  TableConstructor c(BytewiseComparator());
+  c.Add("key", "value");
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+  auto* reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+  ASSERT_FALSE(reader->TEST_index_reader_loaded());
+  const auto pinned_bytes = table_options.pinned_index_and_filter_mem_tracker->consumption();
+  ASSERT_GT(pinned_bytes, 0);
+
+  // Index is loaded into the table reader instead of block cache.
+  unique_ptr<InternalIterator> iter(c.NewIterator());
+  iter->SeekToFirst();
+  ASSERT_TRUE(reader->TEST_index_reader_loaded());
+  {
+    BlockCachePropertiesSnapshot props(options.statistics.get());
+    props.AssertEqual(0, 0,  // index block miss and hit
+                      1, 0); // data block miss and hit
+  }
+  iter.reset();
+
+  // There is no memory budget for pinned index, so it is stored in block cache.
+  table_options.block_cache = NewLRUCache(1_MB);
+  table_options.pinned_index_and_filter_mem_tracker = yb::MemTracker::CreateTracker(
+      0 /* byte_limit */, "no_budget");
+  options.statistics = CreateDBStatistics();
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  const ImmutableCFOptions ioptions2(options);
+  ASSERT_OK(c.Reopen(ioptions2));
+  reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+  iter.reset(c.NewIterator());
+  iter->SeekToFirst();
+  ASSERT_FALSE(reader->TEST_index_reader_loaded());
+  {
+    BlockCachePropertiesSnapshot props(options.statistics.get());
+    props.AssertEqual(1, 0,  // index block miss and hit
+                      1, 0); // data block miss and hit
+  }
+  ASSERT_EQ(0, table_options.pinned_index_and_filter_mem_tracker->consumption());
+  iter.reset();
+}
+
+TEST_F(BlockBasedTableTest, LazyLoadFilter) {
+  for (bool fixed_size_filter : {false, true}) {
+    Options options;
+    options.create_if_missing = true;
+    options.statistics = CreateDBStatistics();
+
+    BlockBasedTableOptions table_options;
+    table_options.block_cache = NewLRUCache(1_MB);
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.lazy_load_filter = true;
+    if (fixed_size_filter) {
+      SetFixedSizeFilterPolicy(&table_options);
+    } else {
+      table_options.filter_policy.reset(NewBloomFilterPolicy(10, false /* use_block_based */));
+    }
+    options.table_factory.reset(new BlockBasedTableFactory(table_options));
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+
+    TableConstructor c(BytewiseComparator());
+    c.Add("key", "value");
+    const ImmutableCFOptions ioptions(options);
+    c.Finish(options, ioptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+    auto* reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+
+    // Nothing is read on open.
+    ASSERT_FALSE(reader->TEST_filter_index_reader_loaded());
+    {
+      BlockCachePropertiesSnapshot props(options.statistics.get());
+      props.AssertIndexBlockStat(0, 0);
+      props.AssertFilterBlockStat(0, 0);
+    }
+
+    // Filter is loaded on first access.
+    GetContext get_context(options.comparator, nullptr, nullptr, nullptr,
+                           GetContext::kNotFound, Slice(), nullptr, nullptr,
+                           nullptr, nullptr);
+    ASSERT_OK(reader->Get(ReadOptions(), "non-exist-key", &get_context));
+    if (fixed_size_filter) {
+      ASSERT_TRUE(reader->TEST_filter_index_reader_loaded());
+      continue;
+    }
+    {
+      BlockCachePropertiesSnapshot props(options.statistics.get());
+      props.AssertFilterBlockStat(1, 0);
+    }
+    ASSERT_OK(reader->Get(ReadOptions(), "non-exist-key", &get_context));
+    {
+      BlockCachePropertiesSnapshot props(options.statistics.get());
+      props.AssertFilterBlockStat(1, 1);
+    }
+  }
+}
+
 TEST_F(BlockBasedTableTest, InvalidOptions) {
   // invalid values for block_size_deviation (<0 or >100) are silently set to 0
   ValidateBlockSizeDeviation(-10, 0);
@@ -1960,6 +2135,56 @@ TEST_F(BlockBasedTableTest, BlockReadCountTest) {
   }
 }
 
+TEST_F(BlockBasedTableTest, AutoReadahead) {
+  Options opt;
+  auto ikc = std::make_shared<test::PlainInternalKeyComparator>(opt.comparator);
+  opt.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.max_auto_readahead_size = 16_KB;
+  opt.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator());
+  const int kNumKeys = 1000;
+  const size_t kValueSize = 500;
+  for (int i = 0; i != kNumKeys; ++i) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%06d", i);
+    c.Add(key, std::string(kValueSize, 'a' + i % 26));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(opt);
+  c.Finish(opt, ioptions, table_options, ikc, &keys, &kvmap);
+  auto* source = c.GetSource();
+  ASSERT_EQ(0, source->total_prefetches());
+
+  {
+    // Full scan reads about 500 data blocks, and prefetches them in 16KB chunks.
+    unique_ptr<InternalIterator> iter(c.NewIterator());
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, count);
+  }
+  ASSERT_GT(source->total_prefetches(), 0);
+  ASSERT_LT(source->total_prefetches(), kNumKeys / 10);
+  ASSERT_GT(source->prefetched_bytes(), kNumKeys * kValueSize / 2);
+
+  {
+    // Seeks to distant keys do not trigger prefetch.
+    const int prefetches = source->total_prefetches();
+    unique_ptr<InternalIterator> iter(c.NewIterator());
+    for (int i = 0; i != 100; ++i) {
+      iter->Seek(keys[(i * 397) % keys.size()]);
+      ASSERT_TRUE(iter->Valid());
+    }
+    ASSERT_EQ(prefetches, source->total_prefetches());
+  }
+}
+
 TEST_F(BlockBasedTableTest, BlockCacheLeak) {
   // Check that when we reopen a table we don't lose access to blocks already
   // in the cache. This test checks whether the Table actually makes use of the
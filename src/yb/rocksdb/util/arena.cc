@@ -39,6 +39,35 @@ namespace rocksdb {
 const size_t Arena::kInlineSize;
 #endif
 
+namespace {
+
+#if defined(MAP_HUGETLB) && defined(MADV_HUGEPAGE)
+// Maps anonymous memory aligned to alignment and asks the kernel to back it by transparent huge
+// pages, when huge pages are not reserved for MAP_HUGETLB. bytes should be a multiple of
+// alignment.
+void* MapTransparentHugePages(size_t bytes, size_t alignment) {
+  // The kernel only uses huge pages for aligned ranges, so map extra space and trim it.
+  const size_t mapped_size = bytes + alignment;
+  void* addr = mmap(nullptr, mapped_size, (PROT_READ | PROT_WRITE),
+                    (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+  if (addr == MAP_FAILED) {
+    return MAP_FAILED;
+  }
+  char* start = static_cast<char*>(addr);
+  const size_t head = (alignment - reinterpret_cast<uintptr_t>(start) % alignment) % alignment;
+  char* result = start + head;
+  if (head != 0) {
+    munmap(start, head);
+  }
+  munmap(result + bytes, alignment - head);
+  // Failure is not fatal, memory is still usable with regular pages.
+  madvise(result, bytes, MADV_HUGEPAGE);
+  return result;
+}
+#endif
+
+} // namespace
+
 const size_t Arena::kMinBlockSize = 4096;
 const size_t Arena::kMaxBlockSize = 2 << 30;
 static const int kAlignUnit = sizeof(void*);
@@ -66,6 +95,7 @@ Arena::Arena(size_t block_size, size_t huge_page_size)
   unaligned_alloc_ptr_ = inline_block_ + alloc_bytes_remaining_;
 #ifdef MAP_HUGETLB
   hugetlb_size_ = huge_page_size;
+  huge_page_size_ = huge_page_size;
   if (hugetlb_size_ && kBlockSize > hugetlb_size_) {
     hugetlb_size_ = ((kBlockSize - 1U) / hugetlb_size_ + 1U) * hugetlb_size_;
   }
@@ -134,6 +164,11 @@ char* Arena::AllocateFromHugePage(size_t bytes) {
 
   void* addr = mmap(nullptr, bytes, (PROT_READ | PROT_WRITE),
                     (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB), 0, 0);
+#ifdef MADV_HUGEPAGE
+  if (addr == MAP_FAILED && huge_page_size_ != 0 && bytes % huge_page_size_ == 0) {
+    addr = MapTransparentHugePages(bytes, huge_page_size_);
+  }
+#endif
 
   if (addr == MAP_FAILED) {
     return nullptr;
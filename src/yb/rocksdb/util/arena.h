@@ -51,7 +51,8 @@ class Arena : public Allocator {
 
   // huge_page_size: if 0, don't use huge page TLB. If > 0 (should set to the
   // supported hugepage size of the system), block allocation will try huge
-  // page TLB first. If allocation fails, will fall back to normal case.
+  // page TLB first, then transparent huge pages aligned to huge_page_size.
+  // If allocation fails, will fall back to normal case.
   explicit Arena(size_t block_size = kMinBlockSize, size_t huge_page_size = 0);
   ~Arena();
 
@@ -119,6 +120,8 @@ class Arena : public Allocator {
 
 #ifdef MAP_HUGETLB
   size_t hugetlb_size_ = 0;
+  // Page size used to align transparent huge page blocks.
+  size_t huge_page_size_ = 0;
 #endif  // MAP_HUGETLB
   char* AllocateFromHugePage(size_t bytes);
   char* AllocateFallback(size_t bytes, bool aligned);
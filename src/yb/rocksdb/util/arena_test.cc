@@ -21,6 +21,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <string.h>
+
 #include "yb/rocksdb/util/arena.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/testharness.h"
@@ -203,6 +205,23 @@ TEST_F(ArenaTest, Simple) {
   SimpleTest(0);
   SimpleTest(kHugePageSize);
 }
+
+#if defined(MAP_HUGETLB) && defined(MADV_HUGEPAGE)
+TEST_F(ArenaTest, HugePageBlockAlignment) {
+  Arena arena(Arena::kMinBlockSize, kHugePageSize);
+  // Use up the inline block, so the next allocation gets a new block.
+  arena.AllocateAligned(Arena::kInlineSize);
+  for (int i = 0; i != 3; ++i) {
+    auto* block = arena.AllocateAligned(Arena::kMinBlockSize / 4);
+    // Either reserved or transparent huge page is used, both are aligned to the page size.
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(block) % kHugePageSize);
+    ASSERT_EQ(Arena::kInlineSize + (i + 1) * kHugePageSize, arena.MemoryAllocatedBytes());
+    // Use up the rest of the block.
+    arena.AllocateAligned(kHugePageSize - Arena::kMinBlockSize / 4);
+    memset(block, i, kHugePageSize);
+  }
+}
+#endif
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -24,8 +24,13 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
 #include <gflags/gflags.h>
 
+#include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/statistics.h"
@@ -92,6 +97,8 @@ struct LRUHandle {
   bool in_cache;      // true, if this entry is referenced by the hash table
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
   QueryId query_id;  // Query id that added the value to the cache.
+  bool detached;      // true, if the entry was not admitted to the cache, so it is only owned by
+                      // its handle and is not charged against the cache capacity
   char key_data[1];   // Beginning of key
 
   Slice key() const {
@@ -104,9 +111,12 @@ struct LRUHandle {
     }
   }
 
-  void Free(yb::CacheMetrics* metrics) {
+  void Free(yb::CacheMetrics* metrics, yb::MemTracker* mem_tracker) {
     assert((refs == 1 && in_cache) || (refs == 0 && !in_cache));
     (*deleter)(key(), value);
+    if (mem_tracker != nullptr) {
+      mem_tracker->Release(charge);
+    }
     if (metrics != nullptr) {
       if (GetSubCacheType() == MULTI_TOUCH) {
         metrics->multi_touch_cache_usage->DecrementBy(charge);
@@ -149,7 +159,7 @@ class HandleTable {
   ~HandleTable() {
     ApplyToAllCacheEntries([this](LRUHandle* h) {
       if (h->refs == 1) {
-        h->Free(metrics_.get());
+        h->Free(metrics_.get(), mem_tracker_.get());
       }
     });
     delete[] list_;
@@ -159,8 +169,14 @@ class HandleTable {
     return *FindPointer(key, hash);
   }
 
+  uint32_t elems() const {
+    return elems_;
+  }
+
   void SetMetrics(shared_ptr<yb::CacheMetrics> metrics) { metrics_ = metrics; }
 
+  void SetMemTracker(shared_ptr<yb::MemTracker> mem_tracker) { mem_tracker_ = mem_tracker; }
+
   // Checks if the newly created handle is a candidate to be inserted into the multi touch cache.
   // It checks to see if the same value is in the multi touch cache, or if it is in the single
   // touch cache, checks to see if the query ids are different.
@@ -210,6 +226,7 @@ class HandleTable {
   uint32_t elems_;
   LRUHandle** list_;
   shared_ptr<yb::CacheMetrics> metrics_;
+  shared_ptr<yb::MemTracker> mem_tracker_;
 
   // Return a pointer to slot that points to a cache entry that
   // matches key/hash.  If there is no such cache entry, return a
@@ -254,6 +271,72 @@ class HandleTable {
   }
 };
 
+const uint64_t kFrequencySketchSeeds[4] = {
+    0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL };
+
+// Count-min sketch of recent access frequency of cache keys, which is used by TinyLFU admission.
+// Each key is counted in kDepth rows, and its frequency is the minimal counter among them.
+// Counters saturate at kMaxFrequency, and all of them are halved after kSamplesPerCounter
+// increments per counter of a row, so the sketch forgets old history.
+class FrequencySketch {
+ public:
+  FrequencySketch() : width_(kMinWidth), counters_(kMinWidth * kDepth) {}
+
+  // Makes sure that the sketch is wide enough to track the specified number of entries.
+  // Resets the counters if the sketch is resized.
+  void Reserve(size_t num_entries) {
+    if (num_entries <= width_) {
+      return;
+    }
+    size_t new_width = kMinWidth;
+    while (new_width < num_entries * 2) {
+      new_width *= 2;
+    }
+    width_ = new_width;
+    counters_.assign(width_ * kDepth, 0);
+    num_increments_ = 0;
+  }
+
+  void Increment(uint32_t hash) {
+    for (size_t row = 0; row != kDepth; ++row) {
+      auto& counter = counters_[Index(hash, row)];
+      if (counter < kMaxFrequency) {
+        ++counter;
+      }
+    }
+    if (++num_increments_ >= width_ * kSamplesPerCounter) {
+      for (auto& counter : counters_) {
+        counter >>= 1;
+      }
+      num_increments_ /= 2;
+    }
+  }
+
+  uint8_t Frequency(uint32_t hash) const {
+    uint8_t result = kMaxFrequency;
+    for (size_t row = 0; row != kDepth; ++row) {
+      result = std::min(result, counters_[Index(hash, row)]);
+    }
+    return result;
+  }
+
+ private:
+  static constexpr size_t kDepth = 4;
+  static constexpr size_t kMinWidth = 1024;
+  static constexpr uint8_t kMaxFrequency = 15;
+  static constexpr size_t kSamplesPerCounter = 10;
+
+  size_t Index(uint32_t hash, size_t row) const {
+    // Rows use different odd multipliers, so keys that collide in one row rarely collide in others.
+    const uint64_t mixed = (hash + 1ULL) * kFrequencySketchSeeds[row];
+    return row * width_ + ((mixed >> 32) & (width_ - 1));
+  }
+
+  size_t width_;
+  std::vector<uint8_t> counters_;
+  size_t num_increments_ = 0;
+};
+
 // Sub-cache of the LRUCache that is used to track different LRU pointers, capacity and usage.
 class LRUSubCache {
  public:
@@ -369,9 +452,20 @@ class LRUCache {
     table_.SetMetrics(metrics);
   }
 
+  void SetMemTracker(shared_ptr<yb::MemTracker> mem_tracker) {
+    mem_tracker_ = mem_tracker;
+    table_.SetMemTracker(mem_tracker);
+  }
+
   // Set the flag to reject insertion if cache if full.
   void SetStrictCapacityLimit(bool strict_capacity_limit);
 
+  // Admit new entries to the full cache only if they are accessed at least as frequently as the
+  // entries they would evict.
+  void EnableFrequencyAdmission() {
+    frequency_sketch_.reset(new FrequencySketch);
+  }
+
   // Like Cache methods, but with an extra "hash" parameter.
   Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                 void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
@@ -420,6 +514,10 @@ class LRUCache {
   // Decrements the usage on the appropriate subcache.
   void DecrementUsage(const SubCacheType subcache_type, const size_t charge);
 
+  // Returns true if the new entry could be added to the specified sub cache, evicting other
+  // entries if necessary.
+  bool Admit(LRUSubCache* sub_cache, LRUHandle* candidate);
+
   // Whether to reject insertion if cache reaches its full capacity.
   bool strict_capacity_limit_;
 
@@ -430,7 +528,11 @@ class LRUCache {
 
   HandleTable table_;
 
+  // Not null when frequency admission is enabled.
+  std::unique_ptr<FrequencySketch> frequency_sketch_;
+
   shared_ptr<yb::CacheMetrics> metrics_;
+  shared_ptr<yb::MemTracker> mem_tracker_;
 };
 
 LRUCache::LRUCache() {}
@@ -457,6 +559,18 @@ void LRUCache::DecrementUsage(const SubCacheType subcache_type, const size_t cha
   GetSubCache(subcache_type)->DecrementUsage(charge);
 }
 
+bool LRUCache::Admit(LRUSubCache* sub_cache, LRUHandle* candidate) {
+  if (!frequency_sketch_ || sub_cache->Usage() + candidate->charge <= sub_cache->Capacity() ||
+      sub_cache->IsLRUEmpty() || table_.Lookup(candidate->key(), candidate->hash) != nullptr) {
+    return true;
+  }
+  // Ties are resolved in favor of the candidate, so equally cold entries are still replaced in
+  // LRU order, while entries read once, e.g. by a scan, could not evict frequently used ones.
+  const LRUHandle* victim = sub_cache->LRU_Head().next;
+  return frequency_sketch_->Frequency(candidate->hash) >=
+         frequency_sketch_->Frequency(victim->hash);
+}
+
 // Call deleter and free
 
 void LRUCache::ApplyToAllCacheEntries(void (*callback)(void*, size_t),
@@ -511,7 +625,7 @@ void LRUCache::SetCapacity(size_t capacity) {
   // we free the entries here outside of mutex for
   // performance reasons
   for (auto entry : last_reference_list) {
-    entry->Free(metrics_.get());
+    entry->Free(metrics_.get(), mem_tracker_.get());
   }
 }
 
@@ -523,6 +637,9 @@ void LRUCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
 Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
                                 Statistics* statistics)  {
   MutexLock l(&mutex_);
+  if (frequency_sketch_) {
+    frequency_sketch_->Increment(hash);
+  }
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->in_cache);
@@ -539,7 +656,7 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
       autovector<LRUHandle*> multi_touch_eviction_list;
       EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
       for (auto entry : multi_touch_eviction_list) {
-        entry->Free(metrics_.get());
+        entry->Free(metrics_.get(), mem_tracker_.get());
       }
       // Cannot have any single touch elements in this case.
       assert(FLAGS_cache_single_touch_ratio != 0);
@@ -596,7 +713,7 @@ void LRUCache::Release(Cache::Handle* handle) {
     MutexLock l(&mutex_);
     LRUSubCache* sub_cache = GetSubCache(e->GetSubCacheType());
     last_reference = Unref(e);
-    if (last_reference) {
+    if (last_reference && !e->detached) {
       sub_cache->DecrementUsage(e->charge);
     }
     if (e->refs == 1 && e->in_cache) {
@@ -619,7 +736,7 @@ void LRUCache::Release(Cache::Handle* handle) {
 
   // free outside of mutex
   if (last_reference) {
-    e->Free(metrics_.get());
+    e->Free(metrics_.get(), mem_tracker_.get());
   }
 }
 
@@ -650,7 +767,11 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   e->in_cache = true;
   // Adding query id to the handle.
   e->query_id = query_id;
+  e->detached = false;
   memcpy(e->key_data, key.data(), key.size());
+  if (mem_tracker_) {
+    mem_tracker_->Consume(charge);
+  }
 
   {
     MutexLock l(&mutex_);
@@ -667,14 +788,32 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
     } else {
       subcache_type = table_.GetSubCacheTypeCandidate(e);
     }
-    EvictFromLRU(charge, &last_reference_list, subcache_type);
     LRUSubCache* sub_cache = GetSubCache(subcache_type);
-    // If the cache no longer has any more space in the given pool.
-    if (strict_capacity_limit_ &&
+    const bool admitted = Admit(sub_cache, e);
+    if (admitted) {
+      EvictFromLRU(charge, &last_reference_list, subcache_type);
+    }
+    if (!admitted) {
+      // The entry is not added to the cache, but it is still returned to the caller if requested,
+      // and freed when released.
+      e->in_cache = false;
+      e->detached = true;
+      if (handle == nullptr) {
+        e->refs = 0;
+        last_reference_list.push_back(e);
+      } else {
+        e->refs = 1;
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+      s = Status::OK();
+    } else if (strict_capacity_limit_ &&
         sub_cache->Usage() - sub_cache->LRU_Usage() + charge > sub_cache->Capacity()) {
       if (handle == nullptr) {
         last_reference_list.push_back(e);
       } else {
+        if (mem_tracker_) {
+          mem_tracker_->Release(charge);
+        }
         delete[] reinterpret_cast<char*>(e);
         *handle = nullptr;
       }
@@ -704,7 +843,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       s = Status::OK();
     }
     if (statistics != nullptr) {
-      if (s.ok()) {
+      if (s.ok() && admitted) {
         RecordTick(statistics, BLOCK_CACHE_ADD);
         RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
         if (subcache_type == SubCacheType::SINGLE_TOUCH) {
@@ -726,13 +865,16 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       }
       metrics_->cache_usage->IncrementBy(charge);
     }
+    if (frequency_sketch_) {
+      frequency_sketch_->Reserve(table_.elems());
+    }
   }
 
 
   // we free the entries here outside of mutex for
   // performance reasons
   for (auto entry : last_reference_list) {
-    entry->Free(metrics_.get());
+    entry->Free(metrics_.get(), mem_tracker_.get());
   }
 
   return s;
@@ -758,7 +900,7 @@ void LRUCache::Erase(const Slice& key, uint32_t hash) {
   // mutex not held here
   // last_reference will only be true if e != nullptr
   if (last_reference) {
-    e->Free(metrics_.get());
+    e->Free(metrics_.get(), mem_tracker_.get());
   }
 }
 
@@ -774,6 +916,7 @@ class ShardedLRUCache : public Cache {
   size_t capacity_;
   bool strict_capacity_limit_;
   shared_ptr<yb::CacheMetrics> metrics_;
+  shared_ptr<yb::MemTracker> mem_tracker_;
 
   static inline uint32_t HashSlice(const Slice& s) {
     return Hash(s.data(), s.size(), 0);
@@ -790,7 +933,7 @@ class ShardedLRUCache : public Cache {
 
  public:
   ShardedLRUCache(size_t capacity, int num_shard_bits,
-                  bool strict_capacity_limit)
+                  bool strict_capacity_limit, CacheAdmissionPolicy admission_policy)
       : last_id_(0),
         num_shard_bits_(num_shard_bits),
         capacity_(capacity),
@@ -802,6 +945,9 @@ class ShardedLRUCache : public Cache {
     for (int s = 0; s < num_shards; s++) {
       shards_[s].SetCapacity(per_shard);
       shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+      if (admission_policy == CacheAdmissionPolicy::kFrequency) {
+        shards_[s].EnableFrequencyAdmission();
+      }
     }
   }
 
@@ -921,6 +1067,18 @@ class ShardedLRUCache : public Cache {
       shards_[s].SetMetrics(metrics_);
     }
   }
+
+  void SetMemTracker(const std::shared_ptr<yb::MemTracker>& mem_tracker) override {
+    mem_tracker_ = mem_tracker;
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetMemTracker(mem_tracker);
+    }
+  }
+
+  yb::MemTracker* GetMemTracker() const override {
+    return mem_tracker_.get();
+  }
 };
 
 }  // end anonymous namespace
@@ -935,11 +1093,18 @@ shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits) {
 
 shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                               bool strict_capacity_limit) {
+  return NewLRUCache(capacity, num_shard_bits, strict_capacity_limit,
+                     CacheAdmissionPolicy::kAlways);
+}
+
+shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
+                              bool strict_capacity_limit,
+                              CacheAdmissionPolicy admission_policy) {
   if (num_shard_bits >= 20) {
     return nullptr;  // the cache cannot be sharded into too many fine pieces
   }
   return std::make_shared<ShardedLRUCache>(capacity, num_shard_bits,
-                                           strict_capacity_limit);
+                                           strict_capacity_limit, admission_policy);
 }
 
 }  // namespace rocksdb
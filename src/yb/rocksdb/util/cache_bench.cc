@@ -32,6 +32,9 @@ int main() {
 #include <inttypes.h>
 #include <sys/types.h>
 #include <stdio.h>
+
+#include <atomic>
+
 #include <gflags/gflags.h>
 
 #include "yb/rocksdb/db.h"
@@ -61,6 +64,16 @@ DEFINE_int32(lookup_percent, 50,
 DEFINE_int32(erase_percent, 10,
              "Ratio of erase to total workload (expressed as a percentage)");
 
+DEFINE_bool(frequency_admission, false, "Use TinyLFU admission policy for the cache.");
+DEFINE_int32(skew, 0,
+             "If positive, keys are picked from range [0, 2^skew) with exponential bias towards "
+             "smaller keys, instead of uniformly from [0, max_key).");
+DEFINE_int32(scan_percent, 0,
+             "Ratio of lookups that are part of sequential scans to total workload (expressed as a "
+             "percentage). Scanned keys do not overlap with other keys.");
+DEFINE_bool(insert_on_miss, false,
+            "Insert key after missed lookup, like block cache users do.");
+
 namespace rocksdb {
 
 class CacheBench;
@@ -145,7 +158,9 @@ struct ThreadState {
 class CacheBench {
  public:
   CacheBench() :
-      cache_(NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits)),
+      cache_(NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits, false /* strict_capacity_limit */,
+                         FLAGS_frequency_admission ? CacheAdmissionPolicy::kFrequency
+                                                   : CacheAdmissionPolicy::kAlways)),
       num_threads_(FLAGS_threads) {}
 
   ~CacheBench() {}
@@ -157,7 +172,7 @@ class CacheBench {
       // Cast uint64* to be char*, data would be copied to cache
       Slice key(reinterpret_cast<char*>(&rand_key), 8);
       // do insert
-      cache_->Insert(key, new char[10], 1, &deleter);
+      cache_->Insert(key, kDefaultQueryId, new char[10], 1, &deleter);
     }
   }
 
@@ -194,6 +209,11 @@ class CacheBench {
       uint32_t qps = static_cast<uint32_t>(
           static_cast<double>(FLAGS_threads * FLAGS_ops_per_thread) / elapsed);
       fprintf(stdout, "Complete in %.3f s; QPS = %u\n", elapsed, qps);
+      const uint64_t lookups = lookups_.load();
+      const uint64_t point_lookups = lookups - scan_lookups_.load();
+      fprintf(stdout, "Hit ratio: %.2f%%; point lookups hit ratio: %.2f%%\n",
+              lookups ? hits_.load() * 100.0 / lookups : 0.0,
+              point_lookups ? point_hits_.load() * 100.0 / point_lookups : 0.0);
     }
     return true;
   }
@@ -201,6 +221,10 @@ class CacheBench {
  private:
   std::shared_ptr<Cache> cache_;
   uint32_t num_threads_;
+  std::atomic<uint64_t> lookups_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> scan_lookups_{0};
+  std::atomic<uint64_t> point_hits_{0};
 
   static void ThreadBody(void* v) {
     ThreadState* thread = reinterpret_cast<ThreadState*>(v);
@@ -227,21 +251,51 @@ class CacheBench {
     }
   }
 
+  // Looks up the key, and inserts it on miss if requested. Returns true on hit.
+  bool LookupKey(const Slice& key, QueryId query_id) {
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    auto handle = cache_->Lookup(key, query_id);
+    if (handle) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      cache_->Release(handle);
+      return true;
+    }
+    if (FLAGS_insert_on_miss) {
+      cache_->Insert(key, query_id, new char[10], 1, &deleter);
+    }
+    return false;
+  }
+
   void OperateCache(ThreadState* thread) {
+    // Each thread scans its own range of keys, above keys used by other operations.
+    const uint64_t scan_start = (FLAGS_skew > 0 ? 1ULL << FLAGS_skew : FLAGS_max_key) +
+                                thread->tid * FLAGS_ops_per_thread;
+    uint64_t scan_key = scan_start;
+    const QueryId scan_query_id = thread->tid + 1;
     for (uint64_t i = 0; i < FLAGS_ops_per_thread; i++) {
-      uint64_t rand_key = thread->rnd.Next() % FLAGS_max_key;
+      if (static_cast<int32_t>(thread->rnd.Uniform(100)) < FLAGS_scan_percent) {
+        scan_lookups_.fetch_add(1, std::memory_order_relaxed);
+        Slice key(reinterpret_cast<char*>(&scan_key), 8);
+        LookupKey(key, scan_query_id);
+        ++scan_key;
+        continue;
+      }
+      uint64_t rand_key = FLAGS_skew > 0 ? thread->rnd.Skewed(FLAGS_skew)
+                                         : thread->rnd.Next() % FLAGS_max_key;
       // Cast uint64* to be char*, data would be copied to cache
       Slice key(reinterpret_cast<char*>(&rand_key), 8);
+      // Point operations use distinct query ids, so repeatedly accessed keys are promoted to the
+      // multi touch part of the cache.
+      const QueryId query_id = scan_query_id + FLAGS_threads * (i + 1);
       int32_t prob_op = thread->rnd.Uniform(100);
       if (prob_op >= 0 && prob_op < FLAGS_insert_percent) {
         // do insert
-        cache_->Insert(key, new char[10], 1, &deleter);
+        cache_->Insert(key, query_id, new char[10], 1, &deleter);
       } else if (prob_op -= FLAGS_insert_percent &&
                  prob_op < FLAGS_lookup_percent) {
         // do lookup
-        auto handle = cache_->Lookup(key);
-        if (handle) {
-          cache_->Release(handle);
+        if (LookupKey(key, query_id)) {
+          point_hits_.fetch_add(1, std::memory_order_relaxed);
         }
       } else if (prob_op -= FLAGS_lookup_percent &&
                  prob_op < FLAGS_erase_percent) {
@@ -261,6 +315,10 @@ class CacheBench {
     printf("Insert percentage   : %d%%\n", FLAGS_insert_percent);
     printf("Lookup percentage   : %d%%\n", FLAGS_lookup_percent);
     printf("Erase percentage    : %d%%\n", FLAGS_erase_percent);
+    printf("Scan percentage     : %d%%\n", FLAGS_scan_percent);
+    printf("Key skew            : %d\n", FLAGS_skew);
+    printf("Insert on miss      : %d\n", FLAGS_insert_on_miss);
+    printf("Frequency admission : %d\n", FLAGS_frequency_admission);
     printf("----------------------------\n");
   }
 };
@@ -31,6 +31,7 @@
 #include "yb/rocksdb/util/coding.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
+#include "yb/util/mem_tracker.h"
 
 DECLARE_double(cache_single_touch_ratio);
 
@@ -179,6 +180,37 @@ TEST_F(CacheTest, UsageTest) {
   ASSERT_LT(kCapacity * 0.95, cache->GetUsage());
 }
 
+TEST_F(CacheTest, MemTracker) {
+  const uint64_t kCapacity = 1000;
+  auto mem_tracker = yb::MemTracker::CreateTracker("CacheTest");
+  auto cache = NewLRUCache(kCapacity / FLAGS_cache_single_touch_ratio, 0);
+  cache->SetMemTracker(mem_tracker);
+
+  char value[10] = "abcdef";
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(cache->Insert(ToString(i), kTestQueryId, value, 10, dumbDeleter));
+    ASSERT_EQ(cache->GetUsage(), mem_tracker->consumption());
+  }
+
+  // Pinned entry stays charged after it is erased, until it is released.
+  Cache::Handle* handle = cache->Lookup(ToString(0), kTestQueryId);
+  ASSERT_NE(nullptr, handle);
+  cache->Erase(ToString(0));
+  ASSERT_EQ(100, mem_tracker->consumption());
+  cache->Release(handle);
+  ASSERT_EQ(90, mem_tracker->consumption());
+
+  // Evicted entries are not charged.
+  for (uint64_t i = 10; i < kCapacity; ++i) {
+    cache->Insert(ToString(i), kTestQueryId, value, 10, dumbDeleter);
+  }
+  ASSERT_EQ(cache->GetUsage(), mem_tracker->consumption());
+  ASSERT_GE(kCapacity, mem_tracker->consumption());
+
+  cache.reset();
+  ASSERT_EQ(0, mem_tracker->consumption());
+}
+
 TEST_F(CacheTest, PinnedUsageTest) {
   // cache is shared_ptr and will be automatically cleaned up.
   const uint64_t kCapacity = 100000;
@@ -675,6 +707,47 @@ TEST_F(CacheTest, ApplyToAllCacheEntiresTest) {
   ASSERT_TRUE(inserted == callback_state);
 }
 
+TEST_F(CacheTest, FrequencyAdmission) {
+  const int kCapacity = 100;
+  const int kNumHotKeys = 10;
+  const int kNumScanKeys = 1000;
+  for (auto policy : {CacheAdmissionPolicy::kAlways, CacheAdmissionPolicy::kFrequency}) {
+    auto cache = NewLRUCache(kCapacity, 0 /* num_shard_bits */, false /* strict_capacity_limit */,
+                             policy);
+    for (int key = 0; key != kNumHotKeys; ++key) {
+      ASSERT_EQ(-1, Lookup(cache, key));
+      ASSERT_OK(Insert(cache, key, key));
+      for (int i = 0; i != 3; ++i) {
+        ASSERT_EQ(key, Lookup(cache, key));
+      }
+    }
+
+    // Scan reads each key once.
+    for (int key = kNumHotKeys; key != kNumHotKeys + kNumScanKeys; ++key) {
+      ASSERT_EQ(-1, Lookup(cache, key));
+      Cache::Handle* handle = nullptr;
+      ASSERT_OK(cache->Insert(EncodeKey(key), kTestQueryId, EncodeValue(key), 1 /* charge */,
+                              &CacheTest::Deleter, &handle));
+      ASSERT_EQ(key, DecodeValue(cache->Value(handle)));
+      cache->Release(handle);
+    }
+
+    int num_hot_keys_left = 0;
+    for (int key = 0; key != kNumHotKeys; ++key) {
+      if (Lookup(cache, key) == key) {
+        ++num_hot_keys_left;
+      }
+    }
+    if (policy == CacheAdmissionPolicy::kFrequency) {
+      ASSERT_EQ(kNumHotKeys, num_hot_keys_left);
+    } else {
+      ASSERT_EQ(0, num_hot_keys_left);
+    }
+    ASSERT_LE(cache->GetUsage(), kCapacity);
+    ASSERT_EQ(0, cache->GetPinnedUsage());
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -123,6 +123,15 @@ inline uint64_t DecodeFixed64(const uint8_t* ptr) {
   return DecodeFixed64(reinterpret_cast<const char*>(ptr));
 }
 
+// Maps signed values to unsigned ones, so values with small magnitude have short varint encoding.
+inline uint64_t ZigZagEncode64(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t ZigZagDecode64(uint64_t value) {
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
 // Internal routine for use by fallback path of GetVarint32Ptr
 extern const char* GetVarint32PtrFallback(const char* p,
                                           const char* limit,
@@ -388,6 +388,148 @@ uint32_t ExtendImpl(uint32_t crc, const char* buf, size_t size) {
   return static_cast<uint32_t>(l ^ 0xffffffffu);
 }
 
+#if defined(__SSE4_2__) && defined(__LP64__)
+
+// CRC of large buffers is computed in 3 interleaved streams, because the crc32 instruction has
+// latency of 3 cycles, but a new one could be issued every cycle. CRCs of the streams are
+// combined by shifting the CRC of the preceding part over the length of the following part.
+
+constexpr size_t kLongStreamSize = 8192;
+constexpr size_t kShortStreamSize = 256;
+
+// Reversed CRC32C polynomial.
+constexpr uint32_t kCrc32cPolynomial = 0x82f63b78;
+
+// Table, that applies an operator to CRC, one byte of CRC at a time.
+typedef uint32_t CrcShiftTable[4][256];
+
+uint32_t Gf2MatrixTimes(const uint32_t* matrix, uint32_t vector) {
+  uint32_t sum = 0;
+  for (; vector; vector >>= 1, ++matrix) {
+    if (vector & 1) {
+      sum ^= *matrix;
+    }
+  }
+  return sum;
+}
+
+void Gf2MatrixSquare(uint32_t* square, const uint32_t* matrix) {
+  for (int n = 0; n != 32; ++n) {
+    square[n] = Gf2MatrixTimes(matrix, matrix[n]);
+  }
+}
+
+// Fills table, that shifts CRC over 'length' zero bytes. Length should be a power of 2.
+void FillCrcShiftTable(size_t length, CrcShiftTable* table) {
+  uint32_t odd[32];
+  uint32_t even[32];
+  // Operator for one zero bit.
+  odd[0] = kCrc32cPolynomial;
+  for (int n = 1; n != 32; ++n) {
+    odd[n] = 1U << (n - 1);
+  }
+  // Operators for 2 and 4 zero bits.
+  Gf2MatrixSquare(even, odd);
+  Gf2MatrixSquare(odd, even);
+  // Each square doubles the number of zeros, starting from one byte.
+  const uint32_t* op;
+  for (;;) {
+    Gf2MatrixSquare(even, odd);
+    length >>= 1;
+    if (length == 0) {
+      op = even;
+      break;
+    }
+    Gf2MatrixSquare(odd, even);
+    length >>= 1;
+    if (length == 0) {
+      op = odd;
+      break;
+    }
+  }
+  for (uint32_t n = 0; n != 256; ++n) {
+    for (int i = 0; i != 4; ++i) {
+      (*table)[i][n] = Gf2MatrixTimes(op, n << (8 * i));
+    }
+  }
+}
+
+struct CrcShiftTables {
+  CrcShiftTable long_shift;
+  CrcShiftTable short_shift;
+
+  CrcShiftTables() {
+    FillCrcShiftTable(kLongStreamSize, &long_shift);
+    FillCrcShiftTable(kShortStreamSize, &short_shift);
+  }
+};
+
+const CrcShiftTables& GetCrcShiftTables() {
+  static const CrcShiftTables tables;
+  return tables;
+}
+
+inline uint64_t ShiftCrc(const CrcShiftTable& table, uint64_t crc) {
+  return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^ table[2][(crc >> 16) & 0xff] ^
+         table[3][(crc >> 24) & 0xff];
+}
+
+// Processes blocks of 3 * stream_size bytes, while they fit into [*p, e).
+inline void Crc3Streams(size_t stream_size, const CrcShiftTable& shift, uint64_t* crc,
+                        const uint8_t** p, const uint8_t* e) {
+  while (static_cast<size_t>(e - *p) >= 3 * stream_size) {
+    uint64_t crc0 = *crc;
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const uint8_t* const end = *p + stream_size;
+    for (const uint8_t* q = *p; q != end; q += 8) {
+      crc0 = _mm_crc32_u64(crc0, LE_LOAD64(q));
+      crc1 = _mm_crc32_u64(crc1, LE_LOAD64(q + stream_size));
+      crc2 = _mm_crc32_u64(crc2, LE_LOAD64(q + 2 * stream_size));
+    }
+    crc0 = ShiftCrc(shift, crc0) ^ crc1;
+    *crc = ShiftCrc(shift, crc0) ^ crc2;
+    *p += 3 * stream_size;
+  }
+}
+
+uint32_t ExtendInterleaved(uint32_t crc, const char* buf, size_t size) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(buf);
+  const uint8_t* const e = p + size;
+  uint64_t l = crc ^ 0xffffffffu;
+
+  // Align to 8 bytes.
+  while (p != e && (reinterpret_cast<uintptr_t>(p) & 7)) {
+    l = _mm_crc32_u8(static_cast<uint32_t>(l), *p++);
+  }
+
+  const auto& tables = GetCrcShiftTables();
+  Crc3Streams(kLongStreamSize, tables.long_shift, &l, &p, e);
+  Crc3Streams(kShortStreamSize, tables.short_shift, &l, &p, e);
+
+  while (e - p >= 8) {
+    l = _mm_crc32_u64(l, LE_LOAD64(p));
+    p += 8;
+  }
+  while (p != e) {
+    l = _mm_crc32_u8(static_cast<uint32_t>(l), *p++);
+  }
+  return static_cast<uint32_t>(l ^ 0xffffffffu);
+}
+
+uint32_t ExtendFast(uint32_t crc, const char* buf, size_t size) {
+  return size >= 3 * kShortStreamSize ? ExtendInterleaved(crc, buf, size)
+                                      : ExtendImpl<Fast_CRC32>(crc, buf, size);
+}
+
+#else
+
+uint32_t ExtendFast(uint32_t crc, const char* buf, size_t size) {
+  return ExtendImpl<Fast_CRC32>(crc, buf, size);
+}
+
+#endif
+
 // Detect if SS42 or not.
 static bool isSSE42() {
 #if defined(__GNUC__) && defined(__x86_64__) && !defined(IOS_CROSS_COMPILE)
@@ -403,7 +545,7 @@ static bool isSSE42() {
 typedef uint32_t (*Function)(uint32_t, const char*, size_t);
 
 static inline Function Choose_Extend() {
-  return isSSE42() ? ExtendImpl<Fast_CRC32> : ExtendImpl<Slow_CRC32>;
+  return isSSE42() ? ExtendFast : ExtendImpl<Slow_CRC32>;
 }
 
 bool IsFastCrc32Supported() {
@@ -21,6 +21,11 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
 #include "yb/rocksdb/util/crc32c.h"
 #include "yb/rocksdb/util/testharness.h"
 
@@ -75,6 +80,46 @@ TEST(CRC, Extend) {
             Extend(Value("hello ", 6), "world", 5));
 }
 
+TEST(CRC, LargeBuffers) {
+  std::mt19937 rng(123);
+  std::vector<char> buf(100000);
+  for (auto& c : buf) {
+    c = rng();
+  }
+  for (int i = 0; i != 200; ++i) {
+    const size_t offset = rng() % 64;
+    const size_t size = rng() % (buf.size() - offset);
+    const char* data = buf.data() + offset;
+    // Large buffers use interleaved streams, so compare them with CRC extended by small pieces.
+    uint32_t expected = 0;
+    for (size_t pos = 0; pos < size;) {
+      const size_t piece = std::min<size_t>(size - pos, 1 + rng() % 500);
+      expected = Extend(expected, data + pos, piece);
+      pos += piece;
+    }
+    ASSERT_EQ(expected, Value(data, size)) << "offset: " << offset << ", size: " << size;
+  }
+}
+
+TEST(CRC, Throughput) {
+  std::vector<char> buf(1 << 20);
+  for (size_t i = 0; i != buf.size(); ++i) {
+    buf[i] = static_cast<char>(i * 7);
+  }
+  for (size_t size : {64, 512, 4096, 32768, 1 << 20}) {
+    const size_t kTotalBytes = 1ULL << 28;
+    const size_t runs = kTotalBytes / size;
+    uint32_t crc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t run = 0; run != runs; ++run) {
+      crc = Extend(crc, buf.data() + (run * size) % buf.size(), size);
+    }
+    std::chrono::duration<double> passed = std::chrono::steady_clock::now() - start;
+    fprintf(stderr, "Size: %zu, fast: %d, throughput: %.2f GB/s, crc: %x\n", size,
+            IsFastCrc32Supported(), kTotalBytes / passed.count() / 1e9, crc);
+  }
+}
+
 TEST(CRC, Mask) {
   uint32_t crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
@@ -223,6 +223,20 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
+#ifndef OS_LINUX
+  return Status::OK();
+#else
+  // Kernel starts reading the range in background and returns immediately.
+  int ret = Fadvise(fd_, offset, n, POSIX_FADV_WILLNEED);
+  if (ret == 0) {
+    return Status::OK();
+  }
+  // posix_fadvise returns error number instead of setting errno.
+  return STATUS_IO_ERROR(filename_, ret);
+#endif
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef OS_LINUX
   return Status::OK();
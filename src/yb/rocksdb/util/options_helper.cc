@@ -372,6 +372,10 @@ bool ParseOptionHelper(char* opt_address, const OptionType& opt_type,
       return ParseEnum<IndexType>(
           block_base_table_index_type_string_map, value,
           reinterpret_cast<IndexType*>(opt_address));
+    case OptionType::kKeyValueEncodingFormat:
+      return ParseEnum<KeyValueEncodingFormat>(
+          key_value_encoding_format_string_map, value,
+          reinterpret_cast<KeyValueEncodingFormat*>(opt_address));
     case OptionType::kEncodingType:
       return ParseEnum<EncodingType>(
           encoding_type_string_map, value,
@@ -513,6 +517,11 @@ bool SerializeSingleOptionHelper(const char* opt_address,
           block_base_table_index_type_string_map,
           *reinterpret_cast<const IndexType*>(opt_address),
           value);
+    case OptionType::kKeyValueEncodingFormat:
+      return SerializeEnum<KeyValueEncodingFormat>(
+          key_value_encoding_format_string_map,
+          *reinterpret_cast<const KeyValueEncodingFormat*>(opt_address),
+          value);
     case OptionType::kFlushBlockPolicyFactory: {
       const auto* ptr =
           reinterpret_cast<const std::shared_ptr<FlushBlockPolicyFactory>*>(
@@ -557,6 +566,8 @@ bool ParseMemtableOptions(const std::string& name, const std::string& value,
   } else if (name == "memtable_prefix_bloom_huge_page_tlb_size") {
     new_options->memtable_prefix_bloom_huge_page_tlb_size =
       ParseSizeT(value);
+  } else if (name == "memtable_huge_page_size") {
+    new_options->memtable_huge_page_size = ParseSizeT(value);
   } else if (name == "max_successive_merges") {
     new_options->max_successive_merges = ParseSizeT(value);
   } else if (name == "filter_deletes") {
@@ -824,8 +835,19 @@ Status ParseColumnFamilyOption(const std::string& name,
         return STATUS(InvalidArgument,
             "unable to parse the specified CF option " + name);
       }
+      end = value.find(':', start);
       new_options->compression_opts.strategy =
-          ParseInt(value.substr(start, value.size() - start));
+          ParseInt(value.substr(start, end == std::string::npos ? end : end - start));
+      // max_dict_bytes is optional.
+      if (end != std::string::npos) {
+        start = end + 1;
+        if (start >= value.size()) {
+          return STATUS(InvalidArgument,
+              "unable to parse the specified CF option " + name);
+        }
+        new_options->compression_opts.max_dict_bytes =
+            ParseUint32(value.substr(start, value.size() - start));
+      }
     } else if (name == "compaction_options_fifo") {
       new_options->compaction_options_fifo.max_table_files_size =
           ParseUint64(value);
@@ -1425,6 +1447,7 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
       mutable_cf_options.memtable_prefix_bloom_probes;
   cf_opts.memtable_prefix_bloom_huge_page_tlb_size =
       mutable_cf_options.memtable_prefix_bloom_huge_page_tlb_size;
+  cf_opts.memtable_huge_page_size = mutable_cf_options.memtable_huge_page_size;
   cf_opts.max_successive_merges = mutable_cf_options.max_successive_merges;
   cf_opts.filter_deletes = mutable_cf_options.filter_deletes;
   cf_opts.inplace_update_num_locks =
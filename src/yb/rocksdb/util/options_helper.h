@@ -107,6 +107,7 @@ enum class OptionType {
   kMergeOperator,
   kMemTableRepFactory,
   kBlockBasedTableIndexType,
+  kKeyValueEncodingFormat,
   kFilterPolicy,
   kFlushBlockPolicyFactory,
   kChecksumType,
@@ -452,6 +453,9 @@ static std::unordered_map<std::string, OptionTypeInfo> cf_options_type_info = {
      {offsetof(struct ColumnFamilyOptions,
                memtable_prefix_bloom_huge_page_tlb_size),
       OptionType::kSizeT, OptionVerificationType::kNormal}},
+    {"memtable_huge_page_size",
+     {offsetof(struct ColumnFamilyOptions, memtable_huge_page_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
     {"write_buffer_size",
      {offsetof(struct ColumnFamilyOptions, write_buffer_size),
       OptionType::kSizeT, OptionVerificationType::kNormal}},
@@ -515,6 +519,7 @@ static std::unordered_map<std::string,
     /* currently not supported
       std::shared_ptr<Cache> block_cache = nullptr;
       std::shared_ptr<Cache> block_cache_compressed = nullptr;
+      std::shared_ptr<PersistentCache> persistent_cache = nullptr;
      */
     {"flush_block_policy_factory",
      {offsetof(struct BlockBasedTableOptions, flush_block_policy_factory),
@@ -522,6 +527,12 @@ static std::unordered_map<std::string,
     {"cache_index_and_filter_blocks",
      {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"pin_top_level_index_and_filter",
+     {offsetof(struct BlockBasedTableOptions, pin_top_level_index_and_filter),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"lazy_load_filter",
+     {offsetof(struct BlockBasedTableOptions, lazy_load_filter),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
     {"index_type",
      {offsetof(struct BlockBasedTableOptions, index_type),
       OptionType::kBlockBasedTableIndexType, OptionVerificationType::kNormal}},
@@ -549,12 +560,18 @@ static std::unordered_map<std::string,
     {"index_block_restart_interval",
      {offsetof(struct BlockBasedTableOptions, index_block_restart_interval),
       OptionType::kInt, OptionVerificationType::kNormal}},
+    {"data_block_key_value_encoding_format",
+     {offsetof(struct BlockBasedTableOptions, data_block_key_value_encoding_format),
+      OptionType::kKeyValueEncodingFormat, OptionVerificationType::kNormal}},
     {"index_block_size",
      {offsetof(struct BlockBasedTableOptions, index_block_size), OptionType::kSizeT,
       OptionVerificationType::kNormal}},
     {"min_keys_per_index_block",
      {offsetof(struct BlockBasedTableOptions, min_keys_per_index_block), OptionType::kSizeT,
       OptionVerificationType::kNormal}},
+    {"max_auto_readahead_size",
+     {offsetof(struct BlockBasedTableOptions, max_auto_readahead_size), OptionType::kSizeT,
+      OptionVerificationType::kNormal}},
     {"filter_policy",
      {offsetof(struct BlockBasedTableOptions, filter_policy),
       OptionType::kFilterPolicy, OptionVerificationType::kByName}},
@@ -610,6 +627,12 @@ static std::unordered_map<std::string, IndexType>
         {"kHashSearch", IndexType::kHashSearch},
         {"kMultiLevelBinarySearch", IndexType::kMultiLevelBinarySearch}};
 
+static std::unordered_map<std::string, KeyValueEncodingFormat>
+    key_value_encoding_format_string_map = {
+        {"kKeyDeltaEncodingSharedPrefix", KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix},
+        {"kKeyDeltaEncodingThreeSharedParts",
+         KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts}};
+
 static std::unordered_map<std::string, EncodingType> encoding_type_string_map =
     {{"kPlain", kPlain}, {"kPrefix", kPrefix}};
 
@@ -157,6 +157,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
       {"memtable_prefix_bloom_bits", "26"},
       {"memtable_prefix_bloom_probes", "27"},
       {"memtable_prefix_bloom_huge_page_tlb_size", "28"},
+      {"memtable_huge_page_size", "2097152"},
       {"bloom_locality", "29"},
       {"max_successive_merges", "30"},
       {"min_partial_merge_operands", "31"},
@@ -255,6 +256,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.memtable_prefix_bloom_bits, 26U);
   ASSERT_EQ(new_cf_opt.memtable_prefix_bloom_probes, 27U);
   ASSERT_EQ(new_cf_opt.memtable_prefix_bloom_huge_page_tlb_size, 28U);
+  ASSERT_EQ(new_cf_opt.memtable_huge_page_size, 2097152U);
   ASSERT_EQ(new_cf_opt.bloom_locality, 29U);
   ASSERT_EQ(new_cf_opt.max_successive_merges, 30U);
   ASSERT_EQ(new_cf_opt.min_partial_merge_operands, 31U);
@@ -1617,11 +1619,14 @@ void InitDefault(BlockBasedTableOptions*) {}
 
 Status GetFromString(BlockBasedTableOptions* source, BlockBasedTableOptions* destination) {
   const char* const kOptionsString =
-      "cache_index_and_filter_blocks=1;index_type=kHashSearch;"
+      "cache_index_and_filter_blocks=1;pin_top_level_index_and_filter=1;lazy_load_filter=1;"
+      "index_type=kHashSearch;"
       "checksum=kxxHash;hash_index_allow_collision=1;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;filter_block_size=16384;"
       "block_size_deviation=8;block_restart_interval=4; "
       "index_block_restart_interval=4;index_block_size=16384;min_keys_per_index_block=16;"
+      "max_auto_readahead_size=65536;"
+      "data_block_key_value_encoding_format=kKeyDeltaEncodingThreeSharedParts;"
       "filter_policy=bloomfilter:4:true;whole_key_filtering=1;"
       "skip_table_builder_flush=1;format_version=1;"
       "hash_index_allow_collision=false;";
@@ -1723,6 +1728,7 @@ Status GetFromString(ColumnFamilyOptions* source, ColumnFamilyOptions* destinati
       "bloom_locality=8016;"
       "target_file_size_base=4294976376;"
       "memtable_prefix_bloom_huge_page_tlb_size=2557;"
+      "memtable_huge_page_size=4194304;"
       "max_successive_merges=5497;"
       "max_sequential_skip_in_iterations=4294971408;"
       "arena_block_size=1893;"
@@ -1887,8 +1893,10 @@ TEST_F(OptionsParserTest, BlockBasedTableOptionsAllFieldsSettable) {
   // and not overlapping. Need to updated if new pointer-option is added.
   const OffsetGaps kBbtoBlacklist = {
       BLACKLIST_ENTRY(BlockBasedTableOptions, flush_block_policy_factory),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, pinned_index_and_filter_mem_tracker),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache_compressed),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, persistent_cache),
       BLACKLIST_ENTRY(BlockBasedTableOptions, filter_policy),
   };
 
@@ -1919,6 +1927,7 @@ TEST_F(OptionsParserTest, DBOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(DBOptions, db_log_dir),
       BLACKLIST_ENTRY(DBOptions, wal_dir),
       BLACKLIST_ENTRY(DBOptions, memory_monitor),
+      BLACKLIST_ENTRY(DBOptions, memtable_mem_tracker),
       BLACKLIST_ENTRY(DBOptions, listeners),
       BLACKLIST_ENTRY(DBOptions, row_cache),
       BLACKLIST_ENTRY(DBOptions, wal_filter),
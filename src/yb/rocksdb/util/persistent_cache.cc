@@ -0,0 +1,392 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/persistent_cache.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/crc32c.h"
+
+#include "yb/util/logging.h"
+
+namespace rocksdb {
+
+namespace {
+
+const char kSegmentSuffix[] = ".pcache";
+
+// Record layout: masked crc32c of the rest of the record, key size, value size, key, value.
+constexpr size_t kRecordHeaderSize = 3 * sizeof(uint32_t);
+
+std::string SegmentFileName(const std::string& path, uint64_t id) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "/%012" PRIu64 "%s", id, kSegmentSuffix);
+  return path + buf;
+}
+
+bool ParseSegmentFileName(const std::string& name, uint64_t* id) {
+  const size_t suffix_len = sizeof(kSegmentSuffix) - 1;
+  if (name.size() <= suffix_len ||
+      name.compare(name.size() - suffix_len, suffix_len, kSegmentSuffix) != 0) {
+    return false;
+  }
+  uint64_t result = 0;
+  for (size_t i = 0; i != name.size() - suffix_len; ++i) {
+    if (name[i] < '0' || name[i] > '9') {
+      return false;
+    }
+    result = result * 10 + (name[i] - '0');
+  }
+  *id = result;
+  return true;
+}
+
+class LogStructuredPersistentCache : public PersistentCache {
+ public:
+  explicit LogStructuredPersistentCache(const PersistentCacheOptions& options)
+      : options_(options) {}
+
+  ~LogStructuredPersistentCache() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    pending_cond_.notify_all();
+    if (writer_.joinable()) {
+      writer_.join();
+    }
+    if (active_file_) {
+      WARN_NOT_OK(active_file_->Close(), "Failed to close persistent cache segment");
+    }
+  }
+
+  Status Open() {
+    RETURN_NOT_OK(options_.env->CreateDirIfMissing(options_.path));
+    std::vector<std::string> children;
+    RETURN_NOT_OK(options_.env->GetChildren(options_.path, &children));
+    std::vector<uint64_t> ids;
+    for (const auto& child : children) {
+      uint64_t id;
+      if (ParseSegmentFileName(child, &id)) {
+        ids.push_back(id);
+      }
+    }
+    std::sort(ids.begin(), ids.end());
+    for (auto id : ids) {
+      RETURN_NOT_OK(RecoverSegment(id));
+      next_segment_id_ = id + 1;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      EvictIfNeeded();
+    }
+    LOG(INFO) << "Opened persistent cache at " << options_.path << ", recovered "
+              << index_.size() << " entries in " << segments_.size() << " segments, "
+              << usage_ << " bytes";
+    writer_ = std::thread(&LogStructuredPersistentCache::WriterLoop, this);
+    return Status::OK();
+  }
+
+  void Insert(const Slice& key, const Slice& value) override {
+    const size_t size = key.size() + value.size();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stop_ || pending_bytes_ + size > options_.max_pending_bytes ||
+          index_.count(key.ToBuffer())) {
+        return;
+      }
+      pending_.emplace_back(key.ToBuffer(), value.ToBuffer());
+      pending_bytes_ += size;
+    }
+    pending_cond_.notify_one();
+  }
+
+  Status Lookup(const Slice& key, std::unique_ptr<char[]>* value, size_t* size) override {
+    const std::string key_str = key.ToBuffer();
+    Location location;
+    std::shared_ptr<RandomAccessFile> file;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(key_str);
+      if (it == index_.end()) {
+        return STATUS(NotFound, "");
+      }
+      location = it->second;
+      file = segments_[location.segment].file;
+    }
+
+    std::unique_ptr<char[]> record(new char[location.size]);
+    Slice read;
+    Status s = file->Read(location.offset, location.size, &read, record.get());
+    if (s.ok()) {
+      Slice record_key, record_value;
+      s = ParseRecord(read, &record_key, &record_value);
+      if (s.ok() && record_key != key) {
+        s = STATUS(Corruption, "Wrong key in persistent cache record");
+      }
+      if (s.ok()) {
+        *size = record_value.size();
+        value->reset(new char[*size]);
+        memcpy(value->get(), record_value.data(), *size);
+        return Status::OK();
+      }
+    }
+
+    LOG(WARNING) << "Failed to read persistent cache segment " << location.segment << ": " << s;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key_str);
+    if (it != index_.end() && it->second.segment == location.segment &&
+        it->second.offset == location.offset) {
+      index_.erase(it);
+    }
+    return s;
+  }
+
+  uint64_t GetUsage() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return usage_;
+  }
+
+ private:
+  struct Location {
+    uint64_t segment;
+    uint64_t offset;
+    // Size of the whole record.
+    size_t size;
+  };
+
+  struct Segment {
+    std::shared_ptr<RandomAccessFile> file;
+    uint64_t size = 0;
+    std::vector<std::string> keys;
+  };
+
+  static Status ParseRecord(Slice record, Slice* key, Slice* value) {
+    if (record.size() < kRecordHeaderSize) {
+      return STATUS(Corruption, "Truncated persistent cache record");
+    }
+    const uint32_t crc = crc32c::Unmask(DecodeFixed32(record.cdata()));
+    const uint32_t key_size = DecodeFixed32(record.cdata() + sizeof(uint32_t));
+    const uint32_t value_size = DecodeFixed32(record.cdata() + 2 * sizeof(uint32_t));
+    if (record.size() != kRecordHeaderSize + key_size + value_size) {
+      return STATUS(Corruption, "Wrong persistent cache record size");
+    }
+    if (crc32c::Value(record.cdata() + sizeof(uint32_t), record.size() - sizeof(uint32_t)) != crc) {
+      return STATUS(Corruption, "Persistent cache record checksum mismatch");
+    }
+    *key = Slice(record.data() + kRecordHeaderSize, key_size);
+    *value = Slice(record.data() + kRecordHeaderSize + key_size, value_size);
+    return Status::OK();
+  }
+
+  // Rebuilds index entries for the specified segment. Segments are never appended after restart,
+  // so recovery stops at the first invalid record, that could be left by a torn write.
+  Status RecoverSegment(uint64_t id) {
+    const std::string fname = SegmentFileName(options_.path, id);
+    uint64_t file_size = 0;
+    RETURN_NOT_OK(options_.env->GetFileSize(fname, &file_size));
+    std::unique_ptr<RandomAccessFile> file;
+    RETURN_NOT_OK(options_.env->NewRandomAccessFile(fname, &file, EnvOptions()));
+
+    Segment segment;
+    uint64_t offset = 0;
+    char header[kRecordHeaderSize];
+    std::vector<char> buffer;
+    while (offset + kRecordHeaderSize <= file_size) {
+      Slice read;
+      if (!file->Read(offset, kRecordHeaderSize, &read, header).ok() ||
+          read.size() != kRecordHeaderSize) {
+        break;
+      }
+      const size_t record_size = kRecordHeaderSize + DecodeFixed32(read.cdata() + 4) +
+                                 DecodeFixed32(read.cdata() + 8);
+      if (offset + record_size > file_size) {
+        break;
+      }
+      buffer.resize(record_size);
+      if (!file->Read(offset, record_size, &read, buffer.data()).ok()) {
+        break;
+      }
+      Slice key, value;
+      if (!ParseRecord(read, &key, &value).ok()) {
+        break;
+      }
+      auto key_str = key.ToBuffer();
+      index_[key_str] = Location{id, offset, record_size};
+      segment.keys.push_back(std::move(key_str));
+      offset += record_size;
+    }
+    if (offset != file_size) {
+      LOG(WARNING) << "Ignoring " << file_size - offset << " bytes at the end of " << fname;
+    }
+
+    segment.file = std::move(file);
+    segment.size = file_size;
+    usage_ += file_size;
+    segments_.emplace(id, std::move(segment));
+    return Status::OK();
+  }
+
+  void WriterLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      pending_cond_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+      if (stop_) {
+        return;
+      }
+      std::deque<std::pair<std::string, std::string>> entries;
+      entries.swap(pending_);
+      pending_bytes_ = 0;
+      lock.unlock();
+      Status s = WriteEntries(&entries);
+      if (!s.ok()) {
+        YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to write persistent cache: " << s;
+      }
+      lock.lock();
+    }
+  }
+
+  // Appends entries to the active segment and publishes them. Only invoked by the writer thread.
+  Status WriteEntries(std::deque<std::pair<std::string, std::string>>* entries) {
+    std::vector<std::pair<std::string, Location>> written;
+    std::string record;
+    for (const auto& entry : *entries) {
+      if (!active_file_ || active_size_ >= options_.segment_size) {
+        RETURN_NOT_OK(Publish(&written));
+        RETURN_NOT_OK(StartSegment());
+      }
+      record.clear();
+      PutFixed32(&record, 0);
+      PutFixed32(&record, static_cast<uint32_t>(entry.first.size()));
+      PutFixed32(&record, static_cast<uint32_t>(entry.second.size()));
+      record.append(entry.first);
+      record.append(entry.second);
+      EncodeFixed32(&record[0], crc32c::Mask(crc32c::Value(record.data() + sizeof(uint32_t),
+                                                           record.size() - sizeof(uint32_t))));
+      RETURN_NOT_OK(active_file_->Append(record));
+      written.emplace_back(entry.first, Location{active_id_, active_size_, record.size()});
+      active_size_ += record.size();
+    }
+    return Publish(&written);
+  }
+
+  // Makes written records visible to readers.
+  Status Publish(std::vector<std::pair<std::string, Location>>* written) {
+    if (written->empty()) {
+      return Status::OK();
+    }
+    RETURN_NOT_OK(active_file_->Flush());
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& segment = segments_[active_id_];
+    usage_ += active_size_ - segment.size;
+    segment.size = active_size_;
+    for (auto& entry : *written) {
+      auto it = index_.find(entry.first);
+      if (it != index_.end()) {
+        continue;
+      }
+      index_.emplace(entry.first, entry.second);
+      segment.keys.push_back(std::move(entry.first));
+    }
+    written->clear();
+    EvictIfNeeded();
+    return Status::OK();
+  }
+
+  Status StartSegment() {
+    if (active_file_) {
+      RETURN_NOT_OK(active_file_->Close());
+      active_file_.reset();
+    }
+    const uint64_t id = next_segment_id_++;
+    const std::string fname = SegmentFileName(options_.path, id);
+    std::unique_ptr<WritableFile> file;
+    RETURN_NOT_OK(options_.env->NewWritableFile(fname, &file, EnvOptions()));
+    std::unique_ptr<RandomAccessFile> reader;
+    RETURN_NOT_OK(options_.env->NewRandomAccessFile(fname, &reader, EnvOptions()));
+    active_file_ = std::move(file);
+    active_id_ = id;
+    active_size_ = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    segments_[id].file = std::move(reader);
+    return Status::OK();
+  }
+
+  // Drops oldest segments, until the total size fits into capacity. The active segment is never
+  // dropped.
+  void EvictIfNeeded() {
+    while (usage_ > options_.capacity && segments_.size() > 1) {
+      auto it = segments_.begin();
+      if (active_file_ && it->first == active_id_) {
+        break;
+      }
+      for (const auto& key : it->second.keys) {
+        auto index_it = index_.find(key);
+        if (index_it != index_.end() && index_it->second.segment == it->first) {
+          index_.erase(index_it);
+        }
+      }
+      usage_ -= it->second.size;
+      // Readers that already obtained the file could still use it, deleting an open file is fine.
+      const std::string fname = SegmentFileName(options_.path, it->first);
+      segments_.erase(it);
+      WARN_NOT_OK(options_.env->DeleteFile(fname), "Failed to delete persistent cache segment");
+    }
+  }
+
+  const PersistentCacheOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable pending_cond_;
+  std::deque<std::pair<std::string, std::string>> pending_;
+  size_t pending_bytes_ = 0;
+  bool stop_ = false;
+  std::unordered_map<std::string, Location> index_;
+  std::map<uint64_t, Segment> segments_;
+  uint64_t usage_ = 0;
+
+  // Fields below are accessed only by the writer thread, after Open.
+  std::thread writer_;
+  std::unique_ptr<WritableFile> active_file_;
+  uint64_t active_id_ = 0;
+  uint64_t active_size_ = 0;
+  uint64_t next_segment_id_ = 0;
+};
+
+} // namespace
+
+Status NewPersistentCache(const PersistentCacheOptions& options,
+                          std::shared_ptr<PersistentCache>* cache) {
+  if (options.env == nullptr || options.path.empty() || options.capacity == 0) {
+    return STATUS(InvalidArgument, "Persistent cache requires env, path and capacity");
+  }
+  auto result = std::make_shared<LogStructuredPersistentCache>(options);
+  RETURN_NOT_OK(result->Open());
+  *cache = std::move(result);
+  return Status::OK();
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,133 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/persistent_cache.h"
+#include "yb/rocksdb/util/testharness.h"
+
+namespace rocksdb {
+
+class PersistentCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    env_ = Env::Default();
+    options_.env = env_;
+    options_.path = test::TmpDir(env_) + "/persistent_cache_test";
+    options_.capacity = 64 * 1024;
+    options_.segment_size = 8 * 1024;
+    Cleanup();
+  }
+
+  void TearDown() override {
+    cache_.reset();
+    Cleanup();
+  }
+
+  void Cleanup() {
+    std::vector<std::string> children;
+    if (env_->GetChildren(options_.path, &children).ok()) {
+      for (const auto& child : children) {
+        env_->DeleteFile(options_.path + "/" + child);
+      }
+    }
+    env_->DeleteDir(options_.path);
+  }
+
+  void Open() {
+    cache_.reset();
+    ASSERT_OK(NewPersistentCache(options_, &cache_));
+  }
+
+  static std::string Key(int i) {
+    return "key" + std::to_string(i);
+  }
+
+  static std::string Value(int i) {
+    return std::string(200 + i % 100, 'a' + i % 26);
+  }
+
+  // Returns true if the value for the specified key is present and correct.
+  bool Check(int i) {
+    std::unique_ptr<char[]> value;
+    size_t size = 0;
+    Status s = cache_->Lookup(Key(i), &value, &size);
+    if (!s.ok()) {
+      return false;
+    }
+    EXPECT_EQ(Value(i), std::string(value.get(), size));
+    return true;
+  }
+
+  // Values are written in background, so wait until the specified one is visible.
+  bool WaitFor(int i) {
+    for (int attempt = 0; attempt != 1000; ++attempt) {
+      if (Check(i)) {
+        return true;
+      }
+      env_->SleepForMicroseconds(1000);
+    }
+    return false;
+  }
+
+  Env* env_ = nullptr;
+  PersistentCacheOptions options_;
+  std::shared_ptr<PersistentCache> cache_;
+};
+
+TEST_F(PersistentCacheTest, InsertLookupAndRecover) {
+  Open();
+  std::unique_ptr<char[]> value;
+  size_t size = 0;
+  ASSERT_TRUE(cache_->Lookup(Key(0), &value, &size).IsNotFound());
+
+  const int kNumEntries = 20;
+  for (int i = 0; i != kNumEntries; ++i) {
+    cache_->Insert(Key(i), Value(i));
+    // Inserts are dropped when the writer is behind, so wait for each one.
+    ASSERT_TRUE(WaitFor(i)) << i;
+  }
+
+  // Content survives reopen.
+  Open();
+  for (int i = 0; i != kNumEntries; ++i) {
+    ASSERT_TRUE(Check(i)) << i;
+  }
+}
+
+TEST_F(PersistentCacheTest, Eviction) {
+  Open();
+  const int kNumEntries = 1000;
+  for (int i = 0; i != kNumEntries; ++i) {
+    cache_->Insert(Key(i), Value(i));
+    ASSERT_TRUE(WaitFor(i)) << i;
+  }
+  ASSERT_LE(cache_->GetUsage(), options_.capacity + options_.segment_size);
+
+  // Oldest entries are evicted, most recent are preserved.
+  ASSERT_FALSE(Check(0));
+  ASSERT_TRUE(Check(kNumEntries - 1));
+
+  Open();
+  ASSERT_FALSE(Check(0));
+  ASSERT_TRUE(Check(kNumEntries - 1));
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -22,6 +22,9 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include "yb/rocksdb/util/rate_limiter.h"
+
+#include <algorithm>
+
 #include "yb/rocksdb/env.h"
 
 namespace rocksdb {
@@ -36,12 +39,30 @@ struct GenericRateLimiter::Req {
   bool granted;
 };
 
+namespace {
+
+// Number of refills between adjustments of auto tuned rate limit.
+constexpr int64_t kRefillsPerTune = 10;
+// Rate limit is decreased when less than this percent of refills were not enough to grant all
+// pending requests, and increased when more than kHighWatermarkPct of them were not enough.
+constexpr int64_t kLowWatermarkPct = 50;
+constexpr int64_t kHighWatermarkPct = 90;
+// Increasing rate is faster than decreasing it, to catch up with bursts of flushes and compactions.
+constexpr int64_t kIncreasePct = 10;
+constexpr int64_t kDecreasePct = 5;
+// Auto tuned rate limit is in range [max / kAllowedRangeFactor, max].
+constexpr int64_t kAllowedRangeFactor = 20;
+
+} // namespace
+
 GenericRateLimiter::GenericRateLimiter(int64_t rate_bytes_per_sec,
                                        int64_t refill_period_us,
-                                       int32_t fairness)
+                                       int32_t fairness,
+                                       bool auto_tuned)
     : refill_period_us_(refill_period_us),
+      rate_bytes_per_sec_(auto_tuned ? rate_bytes_per_sec / 2 : rate_bytes_per_sec),
       refill_bytes_per_period_(
-          CalculateRefillBytesPerPeriod(rate_bytes_per_sec)),
+          CalculateRefillBytesPerPeriod(rate_bytes_per_sec_.load(std::memory_order_relaxed))),
       env_(Env::Default()),
       stop_(false),
       exit_cv_(&request_mutex_),
@@ -50,6 +71,8 @@ GenericRateLimiter::GenericRateLimiter(int64_t rate_bytes_per_sec,
       next_refill_us_(env_->NowMicros()),
       fairness_(fairness > 100 ? 100 : fairness),
       rnd_((uint32_t)time(nullptr)),
+      max_bytes_per_sec_(rate_bytes_per_sec),
+      auto_tuned_(auto_tuned),
       leader_(nullptr) {
   total_requests_[0] = 0;
   total_requests_[1] = 0;
@@ -76,6 +99,7 @@ GenericRateLimiter::~GenericRateLimiter() {
 // This API allows user to dynamically change rate limiter's bytes per second.
 void GenericRateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
   assert(bytes_per_second > 0);
+  rate_bytes_per_sec_.store(bytes_per_second, std::memory_order_relaxed);
   refill_bytes_per_period_.store(
       CalculateRefillBytesPerPeriod(bytes_per_second),
       std::memory_order_relaxed);
@@ -196,7 +220,7 @@ void GenericRateLimiter::Refill() {
     available_bytes_ += refill_bytes_per_period;
   }
 
-  int use_low_pri_first = rnd_.OneIn(fairness_) ? 0 : 1;
+  int use_low_pri_first = fairness_ != 0 && rnd_.OneIn(fairness_) ? 0 : 1;
   for (int q = 0; q < 2; ++q) {
     auto use_pri = (use_low_pri_first == q) ? Env::IO_LOW : Env::IO_HIGH;
     auto* queue = &queue_[use_pri];
@@ -216,15 +240,46 @@ void GenericRateLimiter::Refill() {
       }
     }
   }
+
+  if (auto_tuned_) {
+    ++num_refills_;
+    if (!queue_[Env::IO_HIGH].empty() || !queue_[Env::IO_LOW].empty()) {
+      ++num_drains_;
+    }
+    if (num_refills_ >= kRefillsPerTune) {
+      Tune();
+    }
+  }
+}
+
+void GenericRateLimiter::Tune() {
+  // Refills happen only while there are waiting requests, so idle periods do not decrease the rate.
+  const int64_t drained_pct = num_drains_ * 100 / num_refills_;
+  num_refills_ = 0;
+  num_drains_ = 0;
+
+  const int64_t min_bytes_per_sec = std::max<int64_t>(max_bytes_per_sec_ / kAllowedRangeFactor, 1);
+  const int64_t prev_bytes_per_sec = GetBytesPerSecond();
+  int64_t new_bytes_per_sec = prev_bytes_per_sec;
+  if (drained_pct < kLowWatermarkPct) {
+    new_bytes_per_sec = std::max(min_bytes_per_sec,
+                                 prev_bytes_per_sec * 100 / (100 + kDecreasePct));
+  } else if (drained_pct > kHighWatermarkPct) {
+    new_bytes_per_sec = std::min(max_bytes_per_sec_,
+                                 prev_bytes_per_sec * (100 + kIncreasePct) / 100);
+  }
+  if (new_bytes_per_sec != prev_bytes_per_sec) {
+    SetBytesPerSecond(new_bytes_per_sec);
+  }
 }
 
 RateLimiter* NewGenericRateLimiter(
-    int64_t rate_bytes_per_sec, int64_t refill_period_us, int32_t fairness) {
+    int64_t rate_bytes_per_sec, int64_t refill_period_us, int32_t fairness, bool auto_tuned) {
   assert(rate_bytes_per_sec > 0);
   assert(refill_period_us > 0);
-  assert(fairness > 0);
+  assert(fairness >= 0);
   return new GenericRateLimiter(
-      rate_bytes_per_sec, refill_period_us, fairness);
+      rate_bytes_per_sec, refill_period_us, fairness, auto_tuned);
 }
 
 }  // namespace rocksdb
@@ -36,7 +36,7 @@ namespace rocksdb {
 class GenericRateLimiter : public RateLimiter {
  public:
   GenericRateLimiter(int64_t refill_bytes,
-      int64_t refill_period_us, int32_t fairness);
+      int64_t refill_period_us, int32_t fairness, bool auto_tuned = false);
 
   virtual ~GenericRateLimiter();
 
@@ -48,6 +48,10 @@ class GenericRateLimiter : public RateLimiter {
   // bytes <= GetSingleBurstBytes()
   virtual void Request(const int64_t bytes, const Env::IOPriority pri) override;
 
+  int64_t GetBytesPerSecond() const {
+    return rate_bytes_per_sec_.load(std::memory_order_relaxed);
+  }
+
   virtual int64_t GetSingleBurstBytes() const override {
     return refill_bytes_per_period_.load(std::memory_order_relaxed);
   }
@@ -73,6 +77,9 @@ class GenericRateLimiter : public RateLimiter {
 
  private:
   void Refill();
+  // Adjusts rate limit according to the fraction of recent refills, that were not enough to grant
+  // all pending requests.
+  void Tune();
   int64_t CalculateRefillBytesPerPeriod(int64_t rate_bytes_per_sec) {
     return rate_bytes_per_sec * refill_period_us_ / 1000000;
   }
@@ -81,7 +88,8 @@ class GenericRateLimiter : public RateLimiter {
   mutable port::Mutex request_mutex_;
 
   const int64_t refill_period_us_;
-  // This variable can be changed dynamically.
+  // These variables can be changed dynamically.
+  std::atomic<int64_t> rate_bytes_per_sec_;
   std::atomic<int64_t> refill_bytes_per_period_;
   Env* const env_;
 
@@ -97,6 +105,13 @@ class GenericRateLimiter : public RateLimiter {
   int32_t fairness_;
   Random rnd_;
 
+  // Upper bound of rate limit, when it is auto tuned.
+  const int64_t max_bytes_per_sec_;
+  const bool auto_tuned_;
+  // Number of refills since the last tuning, and how many of them left requests waiting.
+  int64_t num_refills_ = 0;
+  int64_t num_drains_ = 0;
+
   struct Req;
   Req* leader_;
   std::deque<Req*> queue_[Env::IO_TOTAL];
@@ -103,6 +103,29 @@ TEST_F(RateLimiterTest, Rate) {
 }
 #endif
 
+TEST_F(RateLimiterTest, AutoTuned) {
+  const int64_t kMaxRate = 1000 * 1000;
+  const int64_t kRefillPeriodUs = 1000;
+  GenericRateLimiter limiter(kMaxRate, kRefillPeriodUs, 10, true /* auto_tuned */);
+  const int64_t initial_rate = limiter.GetBytesPerSecond();
+  ASSERT_LT(initial_rate, kMaxRate);
+
+  // Demand that exceeds the current rate should increase it up to the configured limit.
+  auto until = Env::Default()->NowMicros() + 10 * 1000000;
+  while (limiter.GetBytesPerSecond() < kMaxRate && Env::Default()->NowMicros() < until) {
+    limiter.Request(limiter.GetSingleBurstBytes(), Env::IO_LOW);
+  }
+  ASSERT_EQ(kMaxRate, limiter.GetBytesPerSecond());
+
+  // Low demand should decrease the rate, but not below the allowed minimum.
+  until = Env::Default()->NowMicros() + 10 * 1000000;
+  while (limiter.GetBytesPerSecond() > kMaxRate / 20 && Env::Default()->NowMicros() < until) {
+    limiter.Request(limiter.GetSingleBurstBytes() / 4, Env::IO_LOW);
+    Env::Default()->SleepForMicroseconds(kRefillPeriodUs);
+  }
+  ASSERT_EQ(kMaxRate / 20, limiter.GetBytesPerSecond());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
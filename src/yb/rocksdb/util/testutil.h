@@ -274,15 +274,27 @@ class StringSource: public RandomAccessFile {
     return static_cast<size_t>(rid-id);
   }
 
+  Status Prefetch(uint64_t offset, size_t n) override {
+    ++total_prefetches_;
+    prefetched_bytes_ += n;
+    return Status::OK();
+  }
+
   int total_reads() const { return total_reads_; }
 
   void set_total_reads(int tr) { total_reads_ = tr; }
 
+  int total_prefetches() const { return total_prefetches_; }
+
+  size_t prefetched_bytes() const { return prefetched_bytes_; }
+
  private:
   std::string contents_;
   uint64_t uniq_id_;
   bool mmap_;
   mutable int total_reads_;
+  int total_prefetches_ = 0;
+  size_t prefetched_bytes_ = 0;
 };
 
 class NullLogger : public Logger {
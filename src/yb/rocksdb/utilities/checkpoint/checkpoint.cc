@@ -43,6 +43,22 @@
 namespace rocksdb {
 namespace checkpoint {
 
+namespace {
+
+// Table files could be located in any of db paths, while live files are reported relative to
+// the DB directory. So returns the directory where the specified table file actually resides.
+std::string TableFileDir(DB* db, const std::string& fname) {
+  const auto& db_paths = db->GetDBOptions().db_paths;
+  for (const auto& db_path : db_paths) {
+    if (db_path.path != db->GetName() && db->GetEnv()->FileExists(db_path.path + fname).ok()) {
+      return db_path.path;
+    }
+  }
+  return db->GetName();
+}
+
+} // namespace
+
 // Builds an openable snapshot of RocksDB on the same disk, which
 // accepts an output directory on the same disk, and under the directory
 // (1) hard-linked SST files pointing to existing live SST files
@@ -103,15 +119,16 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
            type == kCurrentFile);
     assert(live_files[i].size() > 0 && live_files[i][0] == '/');
     std::string src_fname = live_files[i];
+    bool is_table_file = type == kTableFile || type == kTableSBlockFile;
+    const std::string src_dir = is_table_file ? TableFileDir(db, src_fname) : db->GetName();
 
     // rules:
     // * if it's kTableFile or kTableSBlockFile, then it's shared
     // * if it's kDescriptorFile, limit the size to manifest_file_size
     // * always copy if cross-device link
-    bool is_table_file = type == kTableFile || type == kTableSBlockFile;
     if (is_table_file && same_fs) {
       RLOG(db->GetOptions().info_log, "Hard Linking %s", src_fname.c_str());
-      s = db->GetEnv()->LinkFile(db->GetName() + src_fname,
+      s = db->GetEnv()->LinkFile(src_dir + src_fname,
                                  full_private_path + src_fname);
       if (s.IsNotSupported()) {
         same_fs = false;
@@ -120,7 +137,7 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
     }
     if (!is_table_file || !same_fs) {
       RLOG(db->GetOptions().info_log, "Copying %s", src_fname.c_str());
-      s = CopyFile(db->GetEnv(), db->GetName() + src_fname,
+      s = CopyFile(db->GetEnv(), src_dir + src_fname,
                    full_private_path + src_fname,
                    (type == kDescriptorFile) ? manifest_file_size : 0);
     }
@@ -27,7 +27,9 @@
 #ifndef OS_WIN
 #include <unistd.h>
 #endif
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <thread>
 #include <utility>
 #include "yb/rocksdb/db/db_impl.h"
@@ -354,6 +356,55 @@ TEST_F(DBTest, CheckpointCF) {
   ASSERT_OK(DestroyDB(snapshot_name, options));
 }
 
+TEST_F(DBTest, CheckpointMultiplePaths) {
+  const std::string snapshot_name = test::TmpDir(env_) + "/snapshot";
+  const std::string cold_path = dbname_ + "_2";
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.db_paths.emplace_back(dbname_, std::numeric_limits<uint64_t>::max());
+  options.db_paths.emplace_back(cold_path, std::numeric_limits<uint64_t>::max());
+  Options snapshot_options = CurrentOptions();
+  snapshot_options.create_if_missing = false;
+  auto snapshot_paths_options = options;
+  snapshot_paths_options.create_if_missing = false;
+  snapshot_paths_options.db_paths = {
+      DbPath(snapshot_name, std::numeric_limits<uint64_t>::max()),
+      DbPath(snapshot_name + "_2", std::numeric_limits<uint64_t>::max())
+  };
+  ASSERT_OK(DestroyDB(snapshot_name, snapshot_paths_options));
+  Destroy(options);
+  Reopen(options);
+
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_OK(Flush());
+  CompactRangeOptions compact_options;
+  compact_options.target_path_id = 1;
+  ASSERT_OK(db_->CompactRange(compact_options, nullptr, nullptr));
+  ASSERT_OK(Put("bar", "v2"));
+  ASSERT_OK(Flush());
+
+  auto files = db_->GetLiveFilesMetaData();
+  ASSERT_EQ(2U, files.size());
+  std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.name < rhs.name;
+  });
+  ASSERT_EQ(cold_path, files[0].db_path);
+  ASSERT_EQ(dbname_, files[1].db_path);
+
+  ASSERT_OK(checkpoint::CreateCheckpoint(db_, snapshot_name));
+  Close();
+
+  // Checkpoint places all files into a single directory, so it could be opened with a single path
+  // and with multiple paths as well.
+  for (const auto* open_options : {&snapshot_options, &snapshot_paths_options}) {
+    ASSERT_OK(DB::Open(*open_options, snapshot_name, &db_));
+    ASSERT_EQ("v1", Get("foo"));
+    ASSERT_EQ("v2", Get("bar"));
+    Close();
+  }
+  ASSERT_OK(DestroyDB(snapshot_name, snapshot_paths_options));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -58,6 +58,28 @@ class ColumnFamilyHandle;
 struct SavePoints;
 class UserFrontiers;
 
+// Used by DirectWriter to insert entries into memtable.
+class DirectWriteHandler {
+ public:
+  virtual void Put(const SliceParts& key, const SliceParts& value) = 0;
+
+ protected:
+  ~DirectWriteHandler() {}
+};
+
+// Provides entries of a write batch directly to the memtable insert path, so they are not copied
+// into WriteBatch representation first. Could be used only when WAL is disabled.
+class DirectWriter {
+ public:
+  // Number of entries that Apply puts to the handler.
+  virtual size_t NumEntries() const = 0;
+
+  virtual CHECKED_STATUS Apply(DirectWriteHandler* handler) = 0;
+
+ protected:
+  ~DirectWriter() {}
+};
+
 class WriteBatch : public WriteBatchBase {
  public:
   explicit WriteBatch(size_t reserved_bytes = 0);
@@ -251,6 +273,12 @@ class WriteBatch : public WriteBatchBase {
   void SetFrontiers(const UserFrontiers* value) { frontiers_ = value; }
   const UserFrontiers* Frontiers() const { return frontiers_; }
 
+  // Entries of the direct writer are inserted into memtable after entries of the batch itself, and
+  // are included in Count(). They are not visible to Iterate. The writer should outlive write of
+  // this batch.
+  void SetDirectWriter(DirectWriter* direct_writer);
+  DirectWriter* direct_writer() const { return direct_writer_; }
+
  private:
   friend class WriteBatchInternal;
   std::unique_ptr<SavePoints> save_points_;
@@ -264,6 +292,8 @@ class WriteBatch : public WriteBatchBase {
  protected:
   std::string rep_;  // See comment in write_batch.cc for the format of rep_
   const UserFrontiers* frontiers_ = nullptr;
+  DirectWriter* direct_writer_ = nullptr;
+  uint32_t direct_entries_ = 0;
 
   // Intentionally copyable
 };
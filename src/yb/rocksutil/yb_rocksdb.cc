@@ -13,9 +13,14 @@
 
 #include <string>
 
+#include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/preprocessor/stringize.hpp>
+
 #include "yb/gutil/strings/substitute.h"
+#include "yb/rocksdb/perf_context.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/format.h"
 
 using std::shared_ptr;
 using std::string;
@@ -41,4 +46,60 @@ std::string FormatRocksDBSliceAsStr(const rocksdb::Slice& rocksdb_slice,
                           max_length);
 }
 
+#define YB_ROCKSDB_READ_PERF_COUNTERS \
+    (block_cache_hits)(block_cache_misses)(block_reads)(block_read_bytes)(bloom_filter_checks) \
+    (bloom_filter_useful)(sst_files_read)(seeks)(nexts)(keys_skipped)(deletes_skipped)
+
+RocksDBReadPerfCounters RocksDBReadPerfCounters::Current() {
+  const auto& context = rocksdb::perf_context;
+  RocksDBReadPerfCounters result;
+  result.block_cache_hits = context.block_cache_hit_count;
+  result.block_cache_misses = context.block_cache_miss_count;
+  result.block_reads = context.block_read_count;
+  result.block_read_bytes = context.block_read_byte;
+  result.bloom_filter_checks = context.bloom_sst_hit_count + context.bloom_sst_miss_count;
+  // A filter miss means that the SST file was not read.
+  result.bloom_filter_useful = context.bloom_sst_miss_count;
+  result.sst_files_read = context.sst_file_read_count;
+  result.seeks = context.iter_seek_count;
+  result.nexts = context.iter_next_count + context.iter_prev_count;
+  result.keys_skipped = context.internal_key_skipped_count;
+  result.deletes_skipped = context.internal_delete_skipped_count;
+  return result;
+}
+
+#define YB_ROCKSDB_READ_PERF_COUNTER_ADD(r, data, counter) counter += rhs.counter;
+#define YB_ROCKSDB_READ_PERF_COUNTER_SUBTRACT(r, data, counter) counter -= rhs.counter;
+#define YB_ROCKSDB_READ_PERF_COUNTER_FORMAT(r, data, counter) \
+    result += Format("$0$1: $2", result.empty() ? "" : ", ", BOOST_PP_STRINGIZE(counter), counter);
+
+void RocksDBReadPerfCounters::Add(const RocksDBReadPerfCounters& rhs) {
+  BOOST_PP_SEQ_FOR_EACH(YB_ROCKSDB_READ_PERF_COUNTER_ADD, ~, YB_ROCKSDB_READ_PERF_COUNTERS)
+}
+
+void RocksDBReadPerfCounters::Subtract(const RocksDBReadPerfCounters& rhs) {
+  BOOST_PP_SEQ_FOR_EACH(YB_ROCKSDB_READ_PERF_COUNTER_SUBTRACT, ~, YB_ROCKSDB_READ_PERF_COUNTERS)
+}
+
+std::string RocksDBReadPerfCounters::ToString() const {
+  std::string result;
+  BOOST_PP_SEQ_FOR_EACH(YB_ROCKSDB_READ_PERF_COUNTER_FORMAT, ~, YB_ROCKSDB_READ_PERF_COUNTERS)
+  return result;
+}
+
+ScopedRocksDBReadPerfContext::ScopedRocksDBReadPerfContext(RocksDBReadPerfCounters* counters)
+    : counters_(counters) {
+  if (counters_) {
+    start_ = RocksDBReadPerfCounters::Current();
+  }
+}
+
+ScopedRocksDBReadPerfContext::~ScopedRocksDBReadPerfContext() {
+  if (counters_) {
+    auto delta = RocksDBReadPerfCounters::Current();
+    delta.Subtract(start_);
+    counters_->Add(delta);
+  }
+}
+
 }  // namespace yb
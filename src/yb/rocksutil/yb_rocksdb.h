@@ -31,6 +31,45 @@ void InitRocksDBWriteOptions(rocksdb::WriteOptions* write_options);
 std::string FormatRocksDBSliceAsStr(const rocksdb::Slice& rocksdb_slice,
                                     size_t max_length = std::numeric_limits<size_t>::max());
 
+// Work done by RocksDB reads, taken from the thread local rocksdb::perf_context.
+struct RocksDBReadPerfCounters {
+  uint64_t block_cache_hits = 0;
+  uint64_t block_cache_misses = 0;
+  uint64_t block_reads = 0;
+  uint64_t block_read_bytes = 0;
+  uint64_t bloom_filter_checks = 0;
+  uint64_t bloom_filter_useful = 0;
+  uint64_t sst_files_read = 0;
+  uint64_t seeks = 0;
+  uint64_t nexts = 0;
+  uint64_t keys_skipped = 0;
+  uint64_t deletes_skipped = 0;
+
+  // Returns counters accumulated by the current thread so far.
+  static RocksDBReadPerfCounters Current();
+
+  void Add(const RocksDBReadPerfCounters& rhs);
+  void Subtract(const RocksDBReadPerfCounters& rhs);
+
+  std::string ToString() const;
+};
+
+// Adds work done by RocksDB reads of the current thread while in scope to counters. Does nothing
+// if counters is null. Perf context counters are maintained on every read, so this only takes
+// snapshots of them.
+class ScopedRocksDBReadPerfContext {
+ public:
+  explicit ScopedRocksDBReadPerfContext(RocksDBReadPerfCounters* counters);
+  ~ScopedRocksDBReadPerfContext();
+
+  ScopedRocksDBReadPerfContext(const ScopedRocksDBReadPerfContext&) = delete;
+  void operator=(const ScopedRocksDBReadPerfContext&) = delete;
+
+ private:
+  RocksDBReadPerfCounters* counters_;
+  RocksDBReadPerfCounters start_;
+};
+
 }  // namespace yb
 
 #endif // YB_ROCKSUTIL_YB_ROCKSDB_H
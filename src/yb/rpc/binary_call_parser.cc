@@ -15,14 +15,58 @@
 
 #include "yb/gutil/endian.h"
 
+#include "yb/rpc/connection.h"
+
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Returns pointer to range [begin, end) of data, if it is fully contained in one io vec.
+// Otherwise returns nullptr.
+const char* ContiguousRange(const IoVecs& data, size_t begin, size_t end) {
+  for (const auto& io_vec : data) {
+    if (begin < io_vec.iov_len) {
+      return end <= io_vec.iov_len ? IoVecBegin(io_vec) + begin : nullptr;
+    }
+    begin -= io_vec.iov_len;
+    end -= io_vec.iov_len;
+  }
+  return nullptr;
+}
+
+} // namespace
+
+Status BinaryCallParserListener::HandlePinnedCall(
+    const ConnectionPtr& connection, GrowableBufferBlockPtr block, const Slice& call_data) {
+  std::vector<char> copy(call_data.cdata(), call_data.cend());
+  return HandleCall(connection, &copy);
+}
+
 BinaryCallParser::BinaryCallParser(
     size_t header_size, size_t size_offset, size_t max_message_length, IncludeHeader include_header,
-    BinaryCallParserListener* listener)
+    BinaryCallParserListener* listener, PinCallData pin_call_data)
     : buffer_(header_size), size_offset_(size_offset), max_message_length_(max_message_length),
-      include_header_(include_header), listener_(listener) {
+      include_header_(include_header), listener_(listener), pin_call_data_(pin_call_data) {
+}
+
+Result<bool> BinaryCallParser::TryHandlePinned(
+    const rpc::ConnectionPtr& connection, const IoVecs& data, size_t begin, size_t end) {
+  const char* start = ContiguousRange(data, begin, end);
+  if (!start) {
+    return false;
+  }
+  auto* read_buffer = connection->read_buffer();
+  if (!read_buffer) {
+    return false;
+  }
+  auto block = read_buffer->Pin(start, end - begin);
+  if (!block) {
+    return false;
+  }
+  RETURN_NOT_OK(listener_->HandlePinnedCall(
+      connection, std::move(block), Slice(start, end - begin)));
+  return true;
 }
 
 Result<size_t> BinaryCallParser::Parse(const rpc::ConnectionPtr& connection, const IoVecs& data) {
@@ -45,10 +89,17 @@ Result<size_t> BinaryCallParser::Parse(const rpc::ConnectionPtr& connection, con
       break;
     }
 
-    std::vector<char> call_data;
-    IoVecsToBuffer(
-        data, consumed + (include_header_ ? 0 : header_size), consumed + total_length, &call_data);
-    RETURN_NOT_OK(listener_->HandleCall(connection, &call_data));
+    const size_t call_begin = consumed + (include_header_ ? 0 : header_size);
+    const size_t call_end = consumed + total_length;
+    bool handled = false;
+    if (pin_call_data_) {
+      handled = VERIFY_RESULT(TryHandlePinned(connection, data, call_begin, call_end));
+    }
+    if (!handled) {
+      std::vector<char> call_data;
+      IoVecsToBuffer(data, call_begin, call_end, &call_data);
+      RETURN_NOT_OK(listener_->HandleCall(connection, &call_data));
+    }
 
     consumed += total_length;
   }
@@ -14,21 +14,32 @@
 #ifndef YB_RPC_BINARY_CALL_PARSER_H
 #define YB_RPC_BINARY_CALL_PARSER_H
 
+#include "yb/util/slice.h"
 #include "yb/util/net/socket.h"
 #include "yb/util/strongly_typed_bool.h"
 
+#include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/rpc_fwd.h"
 
 namespace yb {
 namespace rpc {
 
 YB_STRONGLY_TYPED_BOOL(IncludeHeader);
+YB_STRONGLY_TYPED_BOOL(PinCallData);
 
 // Listener of BinaryCallParser, invoked when call is parsed.
 class BinaryCallParserListener {
  public:
   virtual CHECKED_STATUS HandleCall(
       const ConnectionPtr& connection, std::vector<char>* call_data) = 0;
+
+  // Invoked instead of HandleCall when parser was created with PinCallData::kTrue and call data
+  // is contained in a single block of connection read buffer.
+  // call_data references memory of block, that is kept alive while block is referenced.
+  // Default implementation copies call data and invokes HandleCall.
+  virtual CHECKED_STATUS HandlePinnedCall(
+      const ConnectionPtr& connection, GrowableBufferBlockPtr block, const Slice& call_data);
+
  protected:
   ~BinaryCallParserListener() {}
 };
@@ -36,17 +47,25 @@ class BinaryCallParserListener {
 // Utility class to parse binary calls with fixed length header.
 class BinaryCallParser {
  public:
+  // When pin_call_data is true, parser tries to pass call data to listener without copying it.
   explicit BinaryCallParser(size_t header_size, size_t size_offset, size_t max_message_length,
-                            IncludeHeader include_header, BinaryCallParserListener* listener);
+                            IncludeHeader include_header, BinaryCallParserListener* listener,
+                            PinCallData pin_call_data = PinCallData::kFalse);
 
   Result<size_t> Parse(const rpc::ConnectionPtr& connection, const IoVecs& data);
 
  private:
+  // Tries to pin range [begin, end) of data in connection read buffer and pass it to listener.
+  // Returns false if data could not be pinned, so it should be copied.
+  Result<bool> TryHandlePinned(
+      const rpc::ConnectionPtr& connection, const IoVecs& data, size_t begin, size_t end);
+
   std::vector<char> buffer_;
   const size_t size_offset_;
   const size_t max_message_length_;
   const IncludeHeader include_header_;
   BinaryCallParserListener* const listener_;
+  const PinCallData pin_call_data_;
 };
 
 } // namespace rpc
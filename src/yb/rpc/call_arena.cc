@@ -0,0 +1,117 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/call_arena.h"
+
+#include <mutex>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/locks.h"
+
+DEFINE_bool(rpc_use_call_arenas, false,
+            "Allocate request and response protobufs of inbound calls from a pooled per call "
+            "arena. Fields are allocated from the arena only for proto files with "
+            "cc_enable_arenas, that no server protocol enables yet.");
+TAG_FLAG(rpc_use_call_arenas, advanced);
+TAG_FLAG(rpc_use_call_arenas, runtime);
+
+DEFINE_int32(rpc_call_arena_initial_block_size, 16 * 1024,
+             "Size of preallocated block of call arena, that is reused across calls.");
+TAG_FLAG(rpc_call_arena_initial_block_size, advanced);
+
+DEFINE_int32(rpc_call_arena_pool_size, 1024,
+             "Max number of idle call arenas kept for reuse.");
+TAG_FLAG(rpc_call_arena_pool_size, advanced);
+TAG_FLAG(rpc_call_arena_pool_size, runtime);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+google::protobuf::ArenaOptions MakeArenaOptions(char* initial_block, size_t size) {
+  google::protobuf::ArenaOptions result;
+  result.initial_block = initial_block;
+  result.initial_block_size = size;
+  return result;
+}
+
+class CallArenaPool {
+ public:
+  std::shared_ptr<CallArena> Acquire() {
+    CallArena* arena = nullptr;
+    {
+      std::lock_guard<simple_spinlock> lock(mutex_);
+      if (!free_.empty()) {
+        arena = free_.back();
+        free_.pop_back();
+      }
+    }
+    if (!arena) {
+      arena = new CallArena(FLAGS_rpc_call_arena_initial_block_size);
+    }
+    return std::shared_ptr<CallArena>(arena, [this](CallArena* released) { Release(released); });
+  }
+
+  size_t size() {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    return free_.size();
+  }
+
+ private:
+  void Release(CallArena* arena) {
+    // Destroys messages allocated in the arena and frees all blocks except the initial one.
+    arena->arena()->Reset();
+    {
+      std::lock_guard<simple_spinlock> lock(mutex_);
+      if (free_.size() < static_cast<size_t>(FLAGS_rpc_call_arena_pool_size)) {
+        free_.push_back(arena);
+        return;
+      }
+    }
+    delete arena;
+  }
+
+  simple_spinlock mutex_;
+  std::vector<CallArena*> free_;
+};
+
+// Pool is never destroyed, because call messages could be released during process shutdown.
+CallArenaPool& Pool() {
+  static CallArenaPool* pool = new CallArenaPool;
+  return *pool;
+}
+
+} // namespace
+
+CallArena::CallArena(size_t initial_block_size)
+    : initial_block_(new char[initial_block_size]),
+      arena_(MakeArenaOptions(initial_block_.get(), initial_block_size)) {
+}
+
+std::shared_ptr<CallArena> CallArena::Acquire() {
+  if (!FLAGS_rpc_use_call_arenas) {
+    return nullptr;
+  }
+  return Pool().Acquire();
+}
+
+size_t CallArena::PoolSizeForTests() {
+  return Pool().size();
+}
+
+} // namespace rpc
+} // namespace yb
@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_CALL_ARENA_H
+#define YB_RPC_CALL_ARENA_H
+
+#include <memory>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/message.h>
+
+namespace yb {
+namespace rpc {
+
+// Protobuf arena that owns request and response messages of a single inbound call.
+// Arenas are taken from a process wide pool and are returned to it, after being reset, when the
+// last reference to the call messages is released. So the initial block of the arena is reused
+// across calls.
+//
+// Only messages of files with cc_enable_arenas allocate their fields on the arena. Messages of
+// other files are placed on the arena themselves, but own their fields on the heap, so code that
+// moves their fields with set_allocated_*, release_* or Swap keeps working without copies.
+// Enabling arenas for a file requires checking such code, since moving fields between arenas, or
+// between an arena and the heap, copies them.
+class CallArena {
+ public:
+  explicit CallArena(size_t initial_block_size);
+
+  CallArena(const CallArena&) = delete;
+  void operator=(const CallArena&) = delete;
+
+  google::protobuf::Arena* arena() { return &arena_; }
+
+  // Returns arena from the pool, or nullptr when call arenas are disabled.
+  static std::shared_ptr<CallArena> Acquire();
+
+  static size_t PoolSizeForTests();
+
+ private:
+  std::unique_ptr<char[]> initial_block_;
+  google::protobuf::Arena arena_;
+};
+
+struct CallMessages {
+  std::shared_ptr<google::protobuf::Message> request;
+  std::shared_ptr<google::protobuf::Message> response;
+};
+
+// Creates request and response messages for inbound call. Both of them share the same arena,
+// that is kept alive while any of them is referenced.
+template <class Request, class Response>
+CallMessages MakeCallMessages() {
+  auto call_arena = CallArena::Acquire();
+  if (!call_arena) {
+    return CallMessages{std::make_shared<Request>(), std::make_shared<Response>()};
+  }
+  auto* arena = call_arena->arena();
+  auto* request = google::protobuf::Arena::Create<Request>(arena);
+  auto* response = google::protobuf::Arena::Create<Response>(arena);
+  return CallMessages{
+      std::shared_ptr<google::protobuf::Message>(call_arena, request),
+      std::shared_ptr<google::protobuf::Message>(std::move(call_arena), response)};
+}
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_CALL_ARENA_H
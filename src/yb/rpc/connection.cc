@@ -48,6 +48,7 @@
 #include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/rpc_controller.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/trace.h"
 #include "yb/util/string_util.h"
 
@@ -57,6 +58,11 @@ using std::vector;
 using strings::Substitute;
 
 DEFINE_uint64(rpc_connection_timeout_ms, 15000, "Timeout for RPC connection operations");
+DEFINE_bool(rpc_coalesce_outbound_writes, true,
+            "Write data queued on a connection once per reactor loop iteration, so calls queued "
+            "by separate tasks and handlers are sent to the socket with a single syscall.");
+TAG_FLAG(rpc_coalesce_outbound_writes, advanced);
+TAG_FLAG(rpc_coalesce_outbound_writes, runtime);
 
 METRIC_DEFINE_histogram(
     server, handler_latency_outbound_transfer, "Time taken to transfer the response ",
@@ -143,6 +149,26 @@ void Connection::Shutdown(const Status& status) {
 void Connection::OutboundQueued() {
   DCHECK(reactor_->IsCurrentThread());
 
+  if (FLAGS_rpc_coalesce_outbound_writes) {
+    if (!flush_scheduled_) {
+      flush_scheduled_ = true;
+      reactor_->ScheduleFlush(shared_from_this());
+    }
+    return;
+  }
+
+  Flush();
+}
+
+void Connection::Flush() {
+  DCHECK(reactor_->IsCurrentThread());
+
+  flush_scheduled_ = false;
+  if (!shutdown_status_.ok()) {
+    return;
+  }
+
+  ++reactor_->num_connection_flushes_;
   auto status = stream_->TryWrite();
   if (!status.ok()) {
     VLOG_WITH_PREFIX(1) << "Write failed: " << status;
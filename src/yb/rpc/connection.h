@@ -160,8 +160,13 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
                         RpcConnectionPB* resp);
 
   // Do appropriate actions after adding outbound call.
+  // When rpc_coalesce_outbound_writes is set, the write is postponed till the end of the reactor
+  // loop iteration.
   void OutboundQueued();
 
+  // Writes queued outbound data to the stream.
+  void Flush();
+
   // An incoming packet has completed on the client side. This parses the
   // call response, looks up the CallAwaitingResponse, and calls the
   // client callback.
@@ -169,6 +174,11 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
 
   ConnectionContext& context() { return *context_; }
 
+  // Buffer that contains data passed to ConnectionContext::ProcessCalls, or nullptr if
+  // underlying stream does not expose it.
+  // Should be invoked only from the reactor thread.
+  GrowableBuffer* read_buffer() { return stream_->ReadBuffer(); }
+
   void CallSent(OutboundCallPtr call);
 
   CHECKED_STATUS Start(ev::loop_ref* loop);
@@ -245,6 +255,9 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
 
   std::shared_ptr<ReactorTask> process_response_queue_task_;
 
+  // Whether this connection was scheduled for flush by the reactor.
+  bool flush_scheduled_ = false;
+
   // Connection is responsible for sending and receiving bytes.
   // Context is responsible for what to do with them.
   std::unique_ptr<ConnectionContext> context_;
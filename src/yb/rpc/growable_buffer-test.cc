@@ -108,5 +108,46 @@ TEST_F(GrowableBufferTest, TestConsume) {
   }
 }
 
+TEST_F(GrowableBufferTest, TestPin) {
+  GrowableBuffer buffer(&allocator_, kSizeLimit);
+
+  auto iov = ASSERT_RESULT(buffer.PrepareAppend());
+  ASSERT_EQ(iov.size(), 1);
+  auto* data = static_cast<uint8_t*>(iov[0].iov_base);
+  memset(data, 'x', kBlockSize);
+  buffer.DataAppended(kBlockSize);
+
+  // Range that is not contained in buffer could not be pinned.
+  uint8_t outside[kBlockSize];
+  ASSERT_EQ(buffer.Pin(outside, sizeof(outside)), nullptr);
+  ASSERT_EQ(buffer.Pin(data + 1, kBlockSize), nullptr);
+
+  auto block = buffer.Pin(data + 1, kBlockSize - 1);
+  ASSERT_NE(block, nullptr);
+  ASSERT_EQ(block.get(), data);
+
+  // Pinned block should not be reused after it is consumed.
+  buffer.Consume(kBlockSize);
+  ASSERT_TRUE(buffer.empty());
+  for (;;) {
+    iov = ASSERT_RESULT(buffer.PrepareAppend());
+    for (const auto& io_vec : iov) {
+      ASSERT_TRUE(io_vec.iov_base >= data + kBlockSize ||
+                  static_cast<uint8_t*>(io_vec.iov_base) + io_vec.iov_len <= data);
+      memset(io_vec.iov_base, 'y', io_vec.iov_len);
+    }
+    auto len = IoVecsFullSize(iov);
+    buffer.DataAppended(len);
+    if (buffer.size() >= kBlockSize * 2) {
+      break;
+    }
+    buffer.Consume(len / 2);
+  }
+
+  for (size_t i = 0; i != kBlockSize; ++i) {
+    ASSERT_EQ(data[i], 'x');
+  }
+}
+
 } // namespace rpc
 } // namespace yb
@@ -147,8 +147,15 @@ GrowableBuffer::GrowableBuffer(GrowableBufferAllocator* allocator, size_t limit)
       block_size_(allocator->block_size()),
       limit_(limit),
       buffers_(kDefaultBuffersCapacity) {
-  buffers_.push_back(
-      BufferPtr(allocator_.Allocate(true), GrowableBufferDeleter(&allocator_, true)));
+  buffers_.push_back(AllocateBuffer(true));
+}
+
+GrowableBuffer::BufferPtr GrowableBuffer::AllocateBuffer(bool forced) {
+  auto* buffer = allocator_.Allocate(forced);
+  if (!buffer) {
+    return BufferPtr();
+  }
+  return BufferPtr(buffer, GrowableBufferDeleter(&allocator_, forced));
 }
 
 void GrowableBuffer::DumpTo(std::ostream& out) const {
@@ -165,9 +172,13 @@ void GrowableBuffer::Consume(size_t count) {
       pos_ -= block_size_;
       auto buffer = std::move(buffers_.front());
       buffers_.pop_front();
-      // Reuse buffer if only one left.
+      // Reuse buffer if only one left and it is not pinned by anybody.
       if (buffers_.size() < 2) {
-        buffers_.push_back(std::move(buffer));
+        if (buffer.use_count() == 1) {
+          buffers_.push_back(std::move(buffer));
+        } else if (buffers_.empty()) {
+          buffers_.push_back(AllocateBuffer(true));
+        }
       }
     }
     size_ -= count;
@@ -223,9 +234,7 @@ Result<IoVecs> GrowableBuffer::PrepareAppend() {
       // We need at least 2 buffers for normal functioning.
       // Because with one buffer we could reach situation when our command limit is just several
       // bytes.
-      bool forced = buffers_.size() < 2;
-      new_buffer = BufferPtr(
-          allocator_.Allocate(forced), GrowableBufferDeleter(&allocator_, forced));
+      new_buffer = AllocateBuffer(buffers_.size() < 2);
     }
     if (new_buffer) {
       buffers_.push_back(std::move(new_buffer));
@@ -245,6 +254,15 @@ void GrowableBuffer::DataAppended(size_t len) {
   size_ += len;
 }
 
+GrowableBufferBlockPtr GrowableBuffer::Pin(const void* data, size_t size) const {
+  const auto* begin = static_cast<const uint8_t*>(data);
+  for (const auto& buffer : buffers_) {
+    if (begin >= buffer.get() && begin + size <= buffer.get() + block_size_) {
+      return buffer;
+    }
+  }
+  return nullptr;
+}
 
 std::ostream& operator<<(std::ostream& out, const GrowableBuffer& receiver) {
   receiver.DumpTo(out);
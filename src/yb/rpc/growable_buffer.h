@@ -68,6 +68,10 @@ class GrowableBufferDeleter {
   bool was_forced_;
 };
 
+// Reference counted block of GrowableBuffer. Block is returned to allocator when last reference
+// to it is released.
+typedef std::shared_ptr<uint8_t> GrowableBufferBlockPtr;
+
 // Convenience circular buffer for receiving bytes.
 // Major features:
 //   Limit allocated bytes.
@@ -109,10 +113,17 @@ class GrowableBuffer {
   // Mark next `len` bytes as used.
   void DataAppended(size_t len);
 
+  // Pins block that contains `size` bytes starting at `data`, so they could be referenced after
+  // being consumed from this buffer. Pinned block is not reused for receiving new data.
+  // Returns nullptr if range is not fully contained in one block of this buffer.
+  GrowableBufferBlockPtr Pin(const void* data, size_t size) const;
+
  private:
   IoVecs IoVecsForRange(size_t begin, size_t end);
 
-  typedef std::unique_ptr<uint8_t, GrowableBufferDeleter> BufferPtr;
+  typedef GrowableBufferBlockPtr BufferPtr;
+
+  BufferPtr AllocateBuffer(bool forced);
 
   GrowableBufferAllocator& allocator_;
 
@@ -46,6 +46,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
+#include "yb/util/span_recorder.h"
 #include "yb/util/trace.h"
 #include "yb/util/memory/memory.h"
 
@@ -123,6 +124,13 @@ Trace* InboundCall::trace() {
   return trace_.get();
 }
 
+void InboundCall::MaybeStartSampledTrace() {
+  auto context = TraceContext::NewRootIfSampled();
+  if (PREDICT_FALSE(context.sampled())) {
+    trace_->set_context(context);
+  }
+}
+
 void InboundCall::RecordCallReceived() {
   TRACE_EVENT_ASYNC_BEGIN0("rpc", "InboundCall", this);
   DCHECK(!timing_.time_received.Initialized());  // Protect against multiple calls.
@@ -164,6 +172,9 @@ bool InboundCall::ClientTimedOut() const {
 
 void InboundCall::QueueResponse(bool is_success) {
   TRACE_TO(trace_, is_success ? "Queueing success response" : "Queueing failure response");
+  if (PREDICT_FALSE(trace_->context().sampled())) {
+    RecordSpan(trace_->context(), SpanKind::kServer, method_name(), timing_.time_received);
+  }
   LogTrace();
   connection()->context().QueueResponse(connection(), shared_from(this));
 }
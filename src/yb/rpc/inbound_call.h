@@ -134,6 +134,11 @@ class InboundCall : public RpcCall {
 
   virtual const std::string& method_name() const = 0;
   virtual const std::string& service_name() const = 0;
+
+  // Priority requested by the client, used to pick the ServicePool lane of this call.
+  // Returns false if the client did not request any.
+  virtual bool GetPriority(RequestHeader::Priority* priority) const { return false; }
+
   virtual void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) = 0;
 
   std::string LogPrefix() const override;
@@ -149,6 +154,10 @@ class InboundCall : public RpcCall {
 
   void QueueResponse(bool is_success);
 
+  // Makes this call a root of a new sampled trace, according to trace_sampling_rate. Used by
+  // servers that receive requests from external clients.
+  void MaybeStartSampledTrace();
+
   // The serialized bytes of the request param protobuf. Set by ParseFrom().
   // This references memory held by 'transfer_'.
   Slice serialized_request_;
@@ -156,6 +165,10 @@ class InboundCall : public RpcCall {
   // Data source of this call.
   std::vector<char> request_data_;
 
+  // Read buffer block that contains data of this call, when it was pinned instead of copying to
+  // request_data_.
+  GrowableBufferBlockPtr request_block_;
+
   // The trace buffer.
   scoped_refptr<Trace> trace_;
 
@@ -37,7 +37,7 @@ Status LocalOutboundCall::SetRequestParam(const google::protobuf::Message& req)
   return Status::OK();
 }
 
-void LocalOutboundCall::Serialize(std::deque<RefCntBuffer> *output) const {
+void LocalOutboundCall::Serialize(OutboundSlices* output) const {
   LOG(FATAL) << "local call should not require serialization";
 }
 
@@ -55,8 +55,7 @@ Status LocalOutboundCall::GetSidecar(int idx, Slice* sidecar) const {
     return STATUS(InvalidArgument, strings::Substitute(
         "Index $0 does not reference a valid sidecar", idx));
   }
-  const RefCntBuffer& car = inbound_call_->sidecars()[idx];
-  *sidecar = Slice(car.udata(), car.size());
+  *sidecar = inbound_call_->sidecars()[idx].AsSlice();
   return Status::OK();
 }
 
@@ -60,6 +60,7 @@
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/rpc/rpc_service.h"
 #include "yb/rpc/tcp_stream.h"
+#include "yb/rpc/uring_stream.h"
 #include "yb/rpc/yb_rpc.h"
 
 #include "yb/util/errno.h"
@@ -68,6 +69,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/socket.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
@@ -92,6 +94,10 @@ DEFINE_uint64(io_thread_pool_size, 4, "Size of allocated IO Thread Pool.");
 DEFINE_int64(outbound_rpc_block_size, 1_MB, "Outbound RPC block size");
 DEFINE_int64(outbound_rpc_memory_limit, 0, "Outbound RPC memory limit");
 
+DEFINE_bool(rpc_use_io_uring, false,
+            "Use io_uring based streams for tcp connections when supported by the kernel.");
+TAG_FLAG(rpc_use_io_uring, advanced);
+
 namespace yb {
 namespace rpc {
 
@@ -111,7 +117,14 @@ MessengerBuilder::MessengerBuilder(std::string name)
           rpc::CreateConnectionContextFactory<YBOutboundConnectionContext>(
               FLAGS_outbound_rpc_block_size, FLAGS_outbound_rpc_memory_limit)),
       listen_protocol_(TcpStream::StaticProtocol()) {
-  AddStreamFactory(TcpStream::StaticProtocol(), TcpStream::Factory());
+  AddStreamFactory(TcpStream::StaticProtocol(),
+                   FLAGS_rpc_use_io_uring ? UringStream::Factory() : TcpStream::Factory());
+}
+
+MessengerBuilder& MessengerBuilder::UseIoUring(bool enabled) {
+  stream_factories_[TcpStream::StaticProtocol()] =
+      enabled ? UringStream::Factory() : TcpStream::Factory();
+  return *this;
 }
 
 MessengerBuilder& MessengerBuilder::set_connection_keepalive_time(
@@ -282,6 +295,70 @@ bool Messenger::IsArtificiallyDisconnectedFrom(const IpAddress& remote) {
   return false;
 }
 
+void Messenger::SetLinkConditions(const IpAddress& address, const LinkConditions& conditions) {
+  LOG(INFO) << "TEST: Set link conditions with " << address << ": latency " << conditions.latency
+            << ", jitter " << conditions.jitter << ", bandwidth "
+            << conditions.bandwidth_bytes_per_sec << " bytes/s, loss probability "
+            << conditions.loss_probability;
+
+  std::lock_guard<std::mutex> lock(link_conditions_mutex_);
+  link_conditions_[address].conditions = conditions;
+  has_link_conditions_.store(true, std::memory_order_release);
+}
+
+void Messenger::ClearLinkConditions(const IpAddress& address) {
+  LOG(INFO) << "TEST: Clear link conditions with " << address;
+
+  std::lock_guard<std::mutex> lock(link_conditions_mutex_);
+  link_conditions_.erase(address);
+  if (link_conditions_.empty()) {
+    has_link_conditions_.store(false, std::memory_order_release);
+  }
+}
+
+Result<MonoDelta> Messenger::LinkDelay(const OutboundCall& call) {
+  const auto& remote = call.conn_id().remote().address();
+  std::lock_guard<std::mutex> lock(link_conditions_mutex_);
+  auto it = link_conditions_.find(remote);
+  if (it == link_conditions_.end()) {
+    return MonoDelta::kZero;
+  }
+  const auto& conditions = it->second.conditions;
+  if (RandomActWithProbability(conditions.loss_probability)) {
+    return STATUS(NetworkError, "TEST: Call lost");
+  }
+
+  auto now = MonoTime::Now();
+  auto sent = now;
+  if (conditions.bandwidth_bytes_per_sec != 0) {
+    OutboundSlices slices;
+    call.Serialize(&slices);
+    size_t size = 0;
+    for (const auto& slice : slices) {
+      size += slice.size();
+    }
+    auto& busy_until = it->second.busy_until;
+    if (busy_until.Initialized() && now < busy_until) {
+      sent = busy_until;
+    }
+    sent.AddDelta(MonoDelta::FromSeconds(
+        static_cast<double>(size) / conditions.bandwidth_bytes_per_sec));
+    busy_until = sent;
+  }
+  auto delivered = sent + conditions.latency;
+  if (conditions.jitter > MonoDelta::kZero) {
+    delivered.AddDelta(MonoDelta::FromNanoseconds(
+        RandomUniformInt<int64_t>(0, conditions.jitter.ToNanoseconds())));
+  }
+  // Calls are not reordered by jitter, like over a TCP connection.
+  auto& last_delivered = it->second.last_delivered;
+  if (last_delivered.Initialized() && delivered < last_delivered) {
+    delivered = last_delivered;
+  }
+  last_delivered = delivered;
+  return delivered.GetDeltaSince(now);
+}
+
 void Messenger::ShutdownAcceptor() {
   std::unique_ptr<Acceptor> acceptor;
   {
@@ -342,6 +419,27 @@ void Messenger::QueueOutboundCall(OutboundCallPtr call) {
     return;
   }
 
+  if (PREDICT_FALSE(has_link_conditions_.load(std::memory_order_acquire))) {
+    auto delay = LinkDelay(*call);
+    if (!delay.ok()) {
+      auto status = delay.status();
+      reactor->ScheduleReactorTask(MakeFunctorReactorTask([call, status](Reactor*) {
+        call->Transferred(status, nullptr);
+      }));
+      return;
+    }
+    if (*delay > MonoDelta::kZero) {
+      scheduler_.Schedule([reactor, call](const Status& status) {
+        if (!status.ok()) {
+          call->Transferred(status, nullptr);
+          return;
+        }
+        reactor->QueueOutboundCall(call);
+      }, delay->ToSteadyDuration());
+      return;
+    }
+  }
+
   reactor->QueueOutboundCall(std::move(call));
 }
 
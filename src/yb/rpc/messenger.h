@@ -59,6 +59,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/sockaddr.h"
+#include "yb/util/result.h"
 #include "yb/util/status.h"
 #include "yb/util/debug-util.h"
 
@@ -102,6 +103,11 @@ class MessengerBuilder {
 
   MessengerBuilder &AddStreamFactory(const Protocol* protocol, StreamFactoryPtr factory);
 
+  // Use io_uring based streams for tcp connections, instead of libev readiness notifications.
+  // Falls back to libev when io_uring is not supported by the kernel.
+  // Default is controlled by the rpc_use_io_uring flag.
+  MessengerBuilder &UseIoUring(bool enabled);
+
   MessengerBuilder &SetListenProtocol(const Protocol* protocol) {
     listen_protocol_ = protocol;
     return *this;
@@ -142,6 +148,21 @@ class MessengerBuilder {
   const Protocol* listen_protocol_;
 };
 
+// Network conditions simulated by a messenger for its outbound calls to some address.
+// Used by tests and benchmarks.
+struct LinkConditions {
+  // Delay of each call, a uniformly distributed random delay of up to jitter is added to it.
+  MonoDelta latency = MonoDelta::kZero;
+  MonoDelta jitter = MonoDelta::kZero;
+
+  // Calls are transferred over the link one by one, each taking its size divided by bandwidth.
+  // 0 means unlimited bandwidth.
+  size_t bandwidth_bytes_per_sec = 0;
+
+  // Probability of a call to be lost. Lost calls fail with NetworkError.
+  double loss_probability = 0;
+};
+
 // A Messenger is a container for the reactor threads which run event loops for the RPC services.
 // If the process is a server, a Messenger will also have an Acceptor.  In this case, calls received
 // over the connection are enqueued into the messenger's service_queue for processing by a
@@ -226,12 +247,20 @@ class Messenger : public ProxyContext {
 
   size_t max_concurrent_requests() const;
 
+  size_t num_reactors() const { return reactors_.size(); }
+
+  Reactor* ReactorForTests(size_t index) const { return reactors_[index]; }
+
   const IpAddress& outbound_address_v4() const { return outbound_address_v4_; }
   const IpAddress& outbound_address_v6() const { return outbound_address_v6_; }
 
   void BreakConnectivityWith(const IpAddress& address);
   void RestoreConnectivityWith(const IpAddress& address);
 
+  // Simulates the specified network conditions for outbound calls to address.
+  void SetLinkConditions(const IpAddress& address, const LinkConditions& conditions);
+  void ClearLinkConditions(const IpAddress& address);
+
   Scheduler& scheduler() {
     return scheduler_;
   }
@@ -256,6 +285,10 @@ class Messenger : public ProxyContext {
 
   bool IsArtificiallyDisconnectedFrom(const IpAddress& remote);
 
+  // Returns delay of the outbound call according to link conditions of its remote address, or
+  // NetworkError if the call is lost.
+  Result<MonoDelta> LinkDelay(const OutboundCall& call);
+
   // Take ownership of the socket via Socket::Release
   void RegisterInboundSocket(
       const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote);
@@ -342,6 +375,19 @@ class Messenger : public ProxyContext {
   // Set of addresses with artificially broken connectivity.
   std::unordered_set<IpAddress, IpAddressHash> broken_connectivity_;
 
+  struct LinkState {
+    LinkConditions conditions;
+    // Time when the link finishes transferring already queued calls.
+    MonoTime busy_until;
+    // Time when the last queued call is delivered.
+    MonoTime last_delivered;
+  };
+
+  // Flag that we have at least one address with simulated link conditions.
+  std::atomic<bool> has_link_conditions_ = {false};
+  std::mutex link_conditions_mutex_;
+  std::unordered_map<IpAddress, LinkState, IpAddressHash> link_conditions_;
+
   IoThreadPool io_thread_pool_;
   Scheduler scheduler_;
 
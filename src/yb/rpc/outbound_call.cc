@@ -54,6 +54,7 @@
 #include "yb/util/kernel_stack_watchdog.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/span_recorder.h"
 #include "yb/util/trace.h"
 
 METRIC_DEFINE_histogram(
@@ -79,11 +80,29 @@ DEFINE_int64(
     " (Advanced debugging option)");
 TAG_FLAG(rpc_callback_max_cycles, advanced);
 TAG_FLAG(rpc_callback_max_cycles, runtime);
+DEFINE_int64(rpc_connection_grow_queued_bytes, 1024 * 1024,
+             "Start using one more connection to the server, when a call is about to be queued "
+             "on a connection that already has more than this number of bytes waiting to be "
+             "sent.");
+TAG_FLAG(rpc_connection_grow_queued_bytes, advanced);
+TAG_FLAG(rpc_connection_grow_queued_bytes, runtime);
+DEFINE_int64(rpc_connection_grow_queue_time_us, 5000,
+             "Start using one more connection to the server, when average time that calls "
+             "recently spent in the outbound queue of a connection exceeds this value.");
+TAG_FLAG(rpc_connection_grow_queue_time_us, advanced);
+TAG_FLAG(rpc_connection_grow_queue_time_us, runtime);
+DEFINE_int64(rpc_connection_shrink_interval_ms, 10000,
+             "Stop using one of the connections to the server, when none of them was overloaded "
+             "during this interval.");
+TAG_FLAG(rpc_connection_shrink_interval_ms, advanced);
+TAG_FLAG(rpc_connection_shrink_interval_ms, runtime);
 DECLARE_bool(rpc_dump_all_traces);
 
 namespace yb {
 namespace rpc {
 
+using namespace std::literals;
+
 using strings::Substitute;
 using google::protobuf::Message;
 using google::protobuf::io::CodedOutputStream;
@@ -181,6 +200,10 @@ OutboundCall::OutboundCall(
 
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
+    const auto& context = Trace::CurrentTrace()->context();
+    if (context.sampled()) {
+      trace_->set_context(context.ChildSpan());
+    }
   }
 
   DVLOG(4) << "OutboundCall " << this << " constructed with state_: " << StateName(state_)
@@ -192,6 +215,10 @@ OutboundCall::~OutboundCall() {
   DCHECK(IsFinished());
   DVLOG(4) << "OutboundCall " << this << " destroyed with state_: " << StateName(state_);
 
+  if (connections_load_) {
+    connections_load_->Released(conn_id_.idx(), load_bytes_);
+  }
+
   if (PREDICT_FALSE(FLAGS_rpc_dump_all_traces)) {
     LOG(INFO) << ToString() << " took "
               << MonoTime::Now().GetDeltaSince(start_).ToMicroseconds()
@@ -219,7 +246,7 @@ void OutboundCall::NotifyTransferred(const Status& status, Connection* conn) {
   }
 }
 
-void OutboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
+void OutboundCall::Serialize(OutboundSlices* output) const {
   output->push_back(buffer_);
 }
 
@@ -317,6 +344,10 @@ void OutboundCall::set_state(State new_state) {
 }
 
 void OutboundCall::CallCallback() {
+  if (PREDICT_FALSE(trace_->context().sampled())) {
+    RecordSpan(trace_->context(), SpanKind::kClient, remote_method_->ToString(), start_);
+  }
+
   int64_t start_cycles = CycleClock::Now();
   {
     callback_();
@@ -373,8 +404,15 @@ void OutboundCall::SetResponse(CallResponse&& resp) {
   }
 }
 
+void OutboundCall::SetConnectionsLoad(ConnectionsLoadPtr connections_load) {
+  load_bytes_ = buffer_.size();
+  connections_load->Queued(conn_id_.idx(), load_bytes_);
+  connections_load_ = std::move(connections_load);
+}
+
 void OutboundCall::SetQueued() {
   auto end_time = MonoTime::Now();
+  queued_at_ = end_time;
   // Track time taken to be queued.
   if (outbound_call_metrics_) {
     outbound_call_metrics_->queue_time->Increment(end_time.GetDeltaSince(start_).ToMicroseconds());
@@ -386,6 +424,12 @@ void OutboundCall::SetQueued() {
 void OutboundCall::SetSent() {
   auto end_time = MonoTime::Now();
   buffer_ = RefCntBuffer();
+  if (connections_load_) {
+    auto queue_time =
+        queued_at_.Initialized() ? end_time.GetDeltaSince(queued_at_) : MonoDelta::kZero;
+    connections_load_->Sent(conn_id_.idx(), load_bytes_, queue_time);
+    connections_load_ = nullptr;
+  }
   // Track time taken to be sent
   if (outbound_call_metrics_) {
     outbound_call_metrics_->send_time->Increment(end_time.GetDeltaSince(start_).ToMicroseconds());
@@ -487,7 +531,17 @@ void OutboundCall::InitHeader(RequestHeader* header) {
   if (timeout.Initialized()) {
     header->set_timeout_millis(timeout.ToMilliseconds());
   }
+  if (controller_->has_priority()) {
+    header->set_priority(controller_->priority());
+  }
   header->set_allocated_remote_method(remote_method_pool_->Take());
+  const auto& context = trace_->context();
+  if (PREDICT_FALSE(context.sampled())) {
+    auto* trace_context = header->mutable_trace_context();
+    trace_context->set_trace_id_high(context.trace_id_high);
+    trace_context->set_trace_id_low(context.trace_id_low);
+    trace_context->set_span_id(context.span_id);
+  }
 }
 
 ///
@@ -510,6 +564,69 @@ size_t ConnectionIdHash::operator() (const ConnectionId& conn_id) const {
   return conn_id.HashCode();
 }
 
+///
+/// ConnectionsLoad
+///
+
+ConnectionsLoad::ConnectionsLoad(size_t max_connections)
+    : max_connections_(std::max<size_t>(max_connections, 1)),
+      entries_(new Entry[max_connections_]),
+      last_overloaded_(CoarseMonoClock::Now().time_since_epoch()) {
+}
+
+bool ConnectionsLoad::Overloaded(const Entry& entry) const {
+  return entry.queued_bytes.load(std::memory_order_relaxed) >
+             implicit_cast<size_t>(FLAGS_rpc_connection_grow_queued_bytes) ||
+         entry.queue_time_us.load(std::memory_order_relaxed) >
+             FLAGS_rpc_connection_grow_queue_time_us;
+}
+
+size_t ConnectionsLoad::Pick(size_t call_index) {
+  auto active = active_connections_.load(std::memory_order_acquire);
+  size_t idx = call_index % active;
+  auto now = CoarseMonoClock::Now().time_since_epoch();
+
+  if (Overloaded(entries_[idx])) {
+    last_overloaded_.store(now, std::memory_order_release);
+    if (active < max_connections_ &&
+        active_connections_.compare_exchange_strong(active, active + 1)) {
+      VLOG(2) << "Growing number of connections to " << active + 1;
+      // Send the call over the new connection right away.
+      return active;
+    }
+    return idx;
+  }
+
+  auto last_overloaded = last_overloaded_.load(std::memory_order_acquire);
+  if (active > 1 &&
+      now - last_overloaded > FLAGS_rpc_connection_shrink_interval_ms * 1ms &&
+      last_overloaded_.compare_exchange_strong(last_overloaded, now)) {
+    // Calls could still be picked for the last connection by concurrent Pick, that is fine since
+    // the connection is still open.
+    if (active_connections_.compare_exchange_strong(active, active - 1)) {
+      VLOG(2) << "Shrinking number of connections to " << active - 1;
+    }
+  }
+  return idx;
+}
+
+void ConnectionsLoad::Queued(size_t idx, size_t bytes) {
+  entries_[idx].queued_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void ConnectionsLoad::Sent(size_t idx, size_t bytes, MonoDelta queue_time) {
+  auto& entry = entries_[idx];
+  entry.queued_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+  // Races between concurrent updates could lose a sample, that is acceptable for an average.
+  auto average = entry.queue_time_us.load(std::memory_order_relaxed);
+  entry.queue_time_us.store(
+      average + (queue_time.ToMicroseconds() - average) / 8, std::memory_order_relaxed);
+}
+
+void ConnectionsLoad::Released(size_t idx, size_t bytes) {
+  entries_[idx].queued_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
 ///
 /// CallResponse
 ///
@@ -32,7 +32,9 @@
 #ifndef YB_RPC_OUTBOUND_CALL_H_
 #define YB_RPC_OUTBOUND_CALL_H_
 
+#include <atomic>
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -110,6 +112,54 @@ inline bool operator==(const ConnectionId& lhs, const ConnectionId& rhs) {
   return lhs.remote() == rhs.remote() && lhs.idx() == rhs.idx() && lhs.protocol() == rhs.protocol();
 }
 
+// Tracks load of the connections that a proxy uses to send calls to the remote server, and picks
+// the connection for every new call.
+//
+// Only the first active_connections() connection indexes are used. This number starts at one, and
+// grows when the picked connection has too many bytes waiting to be sent, or its recent queueing
+// delay is too high. It shrinks back when no connection was overloaded for a while, so the unused
+// connection becomes idle and is closed by the reactor after the keepalive time.
+class ConnectionsLoad {
+ public:
+  explicit ConnectionsLoad(size_t max_connections);
+
+  ConnectionsLoad(const ConnectionsLoad&) = delete;
+  void operator=(const ConnectionsLoad&) = delete;
+
+  // Picks connection index for a new call, call_index is the sequential number of the call.
+  size_t Pick(size_t call_index);
+
+  // Bytes of a call were queued for sending on the specified connection.
+  void Queued(size_t idx, size_t bytes);
+
+  // Bytes of a call queued on the specified connection were sent, after waiting in the connection
+  // outbound queue for queue_time.
+  void Sent(size_t idx, size_t bytes, MonoDelta queue_time);
+
+  // Bytes of a call queued on the specified connection were dropped without being sent.
+  void Released(size_t idx, size_t bytes);
+
+  size_t active_connections() const {
+    return active_connections_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Entry {
+    std::atomic<size_t> queued_bytes{0};
+    // Exponentially weighted moving average of the queue time of calls sent on the connection.
+    std::atomic<int64_t> queue_time_us{0};
+  };
+
+  bool Overloaded(const Entry& entry) const;
+
+  const size_t max_connections_;
+  std::unique_ptr<Entry[]> entries_;
+  std::atomic<size_t> active_connections_{1};
+  std::atomic<CoarseMonoClock::Duration> last_overloaded_;
+};
+
+typedef std::shared_ptr<ConnectionsLoad> ConnectionsLoadPtr;
+
 // Container for OutboundCall metrics
 struct OutboundCallMetrics {
   explicit OutboundCallMetrics(const scoped_refptr<MetricEntity>& metric_entity);
@@ -211,7 +261,7 @@ class OutboundCall : public RpcCall {
 
   // Serialize the call for the wire. Requires that SetRequestParam()
   // is called first. This is called from the Reactor thread.
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(OutboundSlices* output) const override;
 
   // Callback after the call has been put on the outbound connection queue.
   void SetQueued();
@@ -250,6 +300,10 @@ class OutboundCall : public RpcCall {
     conn_id_ = value;
   }
 
+  // Accounts bytes of this call in the load of its connection, until the call is sent.
+  // Should be invoked after SetConnectionId() and SetRequestParam().
+  void SetConnectionsLoad(ConnectionsLoadPtr connections_load);
+
   ////////////////////////////////////////////////////////////
   // Getters
   ////////////////////////////////////////////////////////////
@@ -276,6 +330,7 @@ class OutboundCall : public RpcCall {
 
   ConnectionId conn_id_;
   MonoTime start_;
+  MonoTime queued_at_;
   RpcController* const controller_;
   // Pointer for the protobuf where the response should be written.
   google::protobuf::Message* response_;
@@ -344,6 +399,10 @@ class OutboundCall : public RpcCall {
 
   std::shared_ptr<OutboundCallMetrics> outbound_call_metrics_;
 
+  // Load of the connection this call is queued on, reset once the call is sent.
+  ConnectionsLoadPtr connections_load_;
+  size_t load_bytes_ = 0;
+
   RemoteMethodPool* remote_method_pool_;
 
   DISALLOW_COPY_AND_ASSIGN(OutboundCall);
@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/slice.h"
 
 namespace yb {
 
@@ -25,9 +26,34 @@ class Status;
 
 namespace rpc {
 
+class Connection;
 class DumpRunningRpcsRequestPB;
 class RpcCallInProgressPB;
 
+// Part of serialized outbound data, that is passed to the socket as a single iovec.
+//
+// When created from RefCntBuffer, it keeps the buffer alive.
+// When created from Slice, it references memory owned by the OutboundData that produced it.
+// OutboundData is kept alive by the stream until it is transferred, so such memory does not have
+// to be copied.
+class OutboundSlice {
+ public:
+  OutboundSlice(RefCntBuffer buffer) // NOLINT
+      : buffer_(std::move(buffer)), slice_(buffer_.udata(), buffer_.size()) {}
+
+  explicit OutboundSlice(const Slice& slice) : slice_(slice) {}
+
+  const uint8_t* data() const { return slice_.data(); }
+  size_t size() const { return slice_.size(); }
+  const Slice& AsSlice() const { return slice_; }
+
+ private:
+  RefCntBuffer buffer_;
+  Slice slice_;
+};
+
+typedef std::deque<OutboundSlice> OutboundSlices;
+
 // Interface for outbound transfers from the RPC framework. Implementations include:
 // - RpcCall
 // - LocalOutboundCall
@@ -38,7 +64,7 @@ class OutboundData : public std::enable_shared_from_this<OutboundData> {
   virtual void Transferred(const Status& status, Connection* conn) = 0;
 
   // Serializes the data to be sent out via the RPC framework.
-  virtual void Serialize(std::deque<RefCntBuffer> *output) const = 0;
+  virtual void Serialize(OutboundSlices* output) const = 0;
 
   virtual std::string ToString() const {
     return "<ToStringNotImplemented>";
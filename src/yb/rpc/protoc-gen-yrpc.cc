@@ -372,6 +372,7 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "  virtual void Handle(::yb::rpc::InboundCallPtr call);\n"
         "  virtual std::string service_name() const;\n"
         "  static std::string static_service_name();\n"
+        "  virtual scoped_refptr<Histogram> HandlerLatency(const std::string& method_name) const;\n"
         "\n"
         );
 
@@ -515,8 +516,7 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "            metrics_[$metric_enum_key$]) :\n"
         "        ::yb::rpc::RpcContext(\n"
         "            yb_call, \n"
-        "            std::make_shared<$request$>(),\n"
-        "            std::make_shared<$response$>(),\n"
+        "            ::yb::rpc::MakeCallMessages<$request$, $response$>(),\n"
         "            metrics_[$metric_enum_key$]);\n"
         "    if (!rpc_context.responded()) {\n"
         "      const auto* req = static_cast<const $request$*>(rpc_context.request_pb());\n"
@@ -539,6 +539,27 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "  return \"$full_service_name$\";\n"
         "}\n"
         "\n"
+        "scoped_refptr<Histogram> $service_name$If::HandlerLatency(\n"
+        "    const std::string& method_name) const {\n"
+      );
+
+      for (int method_idx = 0; method_idx < service->method_count();
+           ++method_idx) {
+        const MethodDescriptor *method = service->method(method_idx);
+        subs->PushMethod(method);
+
+        Print(printer, *subs,
+          "  if (method_name == \"$rpc_name$\") {\n"
+          "    return metrics_[$metric_enum_key$].handler_latency;\n"
+          "  }\n"
+        );
+
+        subs->Pop();
+      }
+      Print(printer, *subs,
+        "  return nullptr;\n"
+        "}\n"
+        "\n"
       );
 
       Print(printer, *subs,
@@ -54,10 +54,19 @@
 #include "yb/util/net/sockaddr.h"
 #include "yb/util/net/socket.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/status.h"
 #include "yb/util/user.h"
 
-DEFINE_int32(num_connections_to_server, 8, "Number of underlying connections to each server");
+DEFINE_int32(num_connections_to_server, 8,
+             "Maximal number of underlying connections to each server. Calls are spread over "
+             "exactly this number of connections, unless rpc_adaptive_connections_to_server is "
+             "set, in which case it is only the upper bound.");
+DEFINE_bool(rpc_adaptive_connections_to_server, false,
+            "Start with a single connection to each server, and open more of them, up to "
+            "num_connections_to_server, only when existing connections are overloaded. "
+            "Otherwise calls are spread over num_connections_to_server connections.");
+TAG_FLAG(rpc_adaptive_connections_to_server, advanced);
 DEFINE_int32(proxy_resolve_cache_ms, 5000,
              "Time in milliseconds to cache resolution result in Proxy");
 
@@ -77,6 +86,8 @@ Proxy::Proxy(std::shared_ptr<ProxyContext> context, const HostPort& remote,
       protocol_(protocol ? protocol : context_->DefaultProtocol()),
       outbound_call_metrics_(context_->metric_entity() ?
           std::make_shared<OutboundCallMetrics>(context_->metric_entity()) : nullptr),
+      connections_load_(FLAGS_rpc_adaptive_connections_to_server ?
+          std::make_shared<ConnectionsLoad>(FLAGS_num_connections_to_server) : nullptr),
       call_local_service_(remote == HostPort()),
       resolve_waiters_(30),
       resolved_ep_(std::chrono::milliseconds(FLAGS_proxy_resolve_cache_ms)),
@@ -245,9 +256,14 @@ void Proxy::ResolveDone(
 }
 
 void Proxy::QueueCall(RpcController* controller, const Endpoint& endpoint) {
-  uint8_t idx = num_calls_.fetch_add(1) % FLAGS_num_connections_to_server;
+  auto call_index = num_calls_.fetch_add(1);
+  uint8_t idx = connections_load_ ? connections_load_->Pick(call_index)
+                                  : call_index % FLAGS_num_connections_to_server;
   ConnectionId conn_id(endpoint, idx, protocol_);
   controller->call_->SetConnectionId(conn_id);
+  if (connections_load_) {
+    controller->call_->SetConnectionsLoad(connections_load_);
+  }
   context_->QueueOutboundCall(controller->call_);
 }
 
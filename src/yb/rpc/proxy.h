@@ -152,6 +152,11 @@ class Proxy {
   // Is the service local?
   bool IsServiceLocal() const { return call_local_service_; }
 
+  // Number of connections that new calls are spread over, 0 when it is fixed.
+  size_t active_connections() const {
+    return connections_load_ ? connections_load_->active_connections() : 0;
+  }
+
  private:
   typedef boost::asio::ip::tcp::resolver Resolver;
   void Resolve();
@@ -168,6 +173,9 @@ class Proxy {
   mutable std::atomic<bool> is_started_{false};
   mutable std::atomic<size_t> num_calls_{0};
   std::shared_ptr<OutboundCallMetrics> outbound_call_metrics_;
+  // Load of connections to the remote server, nullptr when calls are spread over a fixed number
+  // of connections.
+  const ConnectionsLoadPtr connections_load_;
   const bool call_local_service_;
 
   std::atomic<ResolveState> resolve_state_{ResolveState::kIdle};
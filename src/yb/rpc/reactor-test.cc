@@ -36,6 +36,7 @@
 
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/stopwatch.h"
 
 using std::shared_ptr;
 using namespace std::placeholders;
@@ -114,5 +115,69 @@ TEST_F(ReactorTest, TestReschedulesOnSameReactorThread) {
   latch_.Wait();
 }
 
+// Many producers schedule tasks on an idle reactor at the same time, so some of them race with
+// the reactor finishing the previous batch of tasks. Each task should run without other events
+// waking the reactor up.
+TEST_F(ReactorTest, ScheduleTasksOnIdleReactor) {
+  constexpr size_t kRounds = 200;
+  constexpr size_t kNumProducers = 16;
+  constexpr size_t kTasksPerProducer = 10;
+
+  auto* reactor = messenger_->ReactorForTests(0);
+  for (size_t round = 0; round != kRounds; ++round) {
+    CountDownLatch latch(kNumProducers * kTasksPerProducer);
+    std::atomic<bool> start{false};
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i != kNumProducers; ++i) {
+      producers.emplace_back([reactor, &latch, &start] {
+        while (!start.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+        for (size_t j = 0; j != kTasksPerProducer; ++j) {
+          reactor->ScheduleReactorFunctor([&latch](Reactor*) { latch.CountDown(); });
+          std::this_thread::yield();
+        }
+      });
+    }
+    start.store(true, std::memory_order_release);
+    for (auto& thread : producers) {
+      thread.join();
+    }
+    ASSERT_TRUE(latch.WaitFor(MonoDelta::FromSeconds(10)))
+        << "Round " << round << ", not run tasks: " << latch.count();
+    // Let the reactor become idle before the next round.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+// Measures throughput of tasks scheduled on a single reactor, depending on the number of
+// producer threads.
+TEST_F(ReactorTest, BenchmarkScheduleTasks) {
+  constexpr size_t kTasksPerProducer = 100000;
+
+  auto* reactor = messenger_->ReactorForTests(0);
+  for (size_t num_producers : {1, 2, 4, 8, 16}) {
+    CountDownLatch latch(num_producers * kTasksPerProducer);
+    std::vector<std::thread> producers;
+    Stopwatch stopwatch;
+    stopwatch.start();
+    for (size_t i = 0; i != num_producers; ++i) {
+      producers.emplace_back([reactor, &latch] {
+        for (size_t j = 0; j != kTasksPerProducer; ++j) {
+          reactor->ScheduleReactorFunctor([&latch](Reactor*) { latch.CountDown(); });
+        }
+      });
+    }
+    for (auto& thread : producers) {
+      thread.join();
+    }
+    latch.Wait();
+    stopwatch.stop();
+    auto seconds = stopwatch.elapsed().wall_seconds();
+    LOG(INFO) << num_producers << " producers: "
+              << static_cast<int64_t>(num_producers * kTasksPerProducer / seconds) << " tasks/sec";
+  }
+}
+
 } // namespace rpc
 } // namespace yb
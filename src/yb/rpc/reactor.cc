@@ -55,6 +55,7 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/thread_pool.h"
 #include "yb/rpc/yb_rpc.h"
 
 #include "yb/util/countdown_latch.h"
@@ -122,6 +123,7 @@ Reactor::Reactor(const shared_ptr<Messenger>& messenger,
                  const MessengerBuilder &bld)
     : messenger_(messenger),
       name_(StringPrintf("%s_R%03d", messenger->name().c_str(), index)),
+      index_(index),
       loop_(kDefaultLibEvFlags),
       cur_time_(CoarseMonoClock::Now()),
       last_unused_tcp_scan_(cur_time_),
@@ -153,6 +155,12 @@ Status Reactor::Init() {
   timer_.start(ToSeconds(coarse_timer_granularity_),
                ToSeconds(coarse_timer_granularity_));
 
+  // Flush should happen before other prepare watchers, like the one that submits io_uring
+  // operations, so writes issued by flush are not delayed till the next loop iteration.
+  flush_prepare_.set(loop_);
+  flush_prepare_.set<Reactor, &Reactor::FlushHandler>(this);
+  ev_set_priority(&flush_prepare_, EV_MAXPRI);
+
   // Create Reactor thread.
   const std::string group_name = messenger_->name() + "_reactor";
   return yb::Thread::Create(group_name, group_name, &Reactor::RunThread, this, &thread_);
@@ -216,6 +224,9 @@ void Reactor::ShutdownInternal() {
   }
   server_conns_.clear();
 
+  flush_prepare_.stop();
+  connections_to_flush_.clear();
+
   // Abort any scheduled tasks.
   //
   // These won't be found in the Reactor's list of pending tasks
@@ -250,6 +261,7 @@ Status Reactor::GetMetrics(ReactorMetrics *metrics) {
   return RunOnReactorThread([metrics](Reactor* reactor) {
     metrics->num_client_connections_ = reactor->client_conns_.size();
     metrics->num_server_connections_ = reactor->server_conns_.size();
+    metrics->num_connection_flushes_ = reactor->num_connection_flushes_;
     return Status::OK();
   });
 }
@@ -298,11 +310,9 @@ void Reactor::CheckReadyToStop() {
 
     VLOG(2) << "Marking reactor as closed: " << thread_.get()->ToString();
     ReactorTasks final_tasks;
-    {
-      std::lock_guard<simple_spinlock> lock(pending_tasks_mtx_);
-      state_.store(ReactorState::kClosed, std::memory_order_release);
-      final_tasks.swap(pending_tasks_);
-    }
+    // Tasks scheduled after this point are aborted by ScheduleReactorTask.
+    state_.store(ReactorState::kClosed);
+    PopPendingTasks(&final_tasks);
     VLOG(2) << "Running final pending task aborts: " << thread_.get()->ToString();;
     for (auto task : final_tasks) {
       task->Abort(ServiceUnavailableError());
@@ -318,8 +328,17 @@ void Reactor::CheckReadyToStop() {
 void Reactor::AsyncHandler(ev::async &watcher, int revents) {
   DCHECK(IsCurrentThread());
 
-  BOOST_SCOPE_EXIT(&async_handler_tasks_) {
-    async_handler_tasks_.clear();
+  running_tasks_.store(true);
+  BOOST_SCOPE_EXIT(this_) {
+    this_->async_handler_tasks_.clear();
+    this_->running_tasks_.store(false);
+    // Producers that observed running_tasks_ did not wake us up, so pick up their tasks during
+    // the next loop iteration. This way IO events are not starved by a constant stream of tasks.
+    // Both the store above and the emptiness check are sequentially consistent, as are the push
+    // and the load of running_tasks_ in ScheduleReactorTask, so a wake up could not be lost.
+    if (!this_->pending_tasks_.empty()) {
+      this_->WakeThread();
+    }
   } BOOST_SCOPE_EXIT_END;
 
   if (PREDICT_FALSE(DrainTaskQueueAndCheckIfClosing())) {
@@ -454,6 +473,7 @@ void Reactor::RunThread() {
   ThreadRestrictions::SetWaitAllowed(false);
   ThreadRestrictions::SetIOAllowed(false);
   DVLOG(6) << "Calling Reactor::RunThread()...";
+  SetNumaAffinity(index_);
   loop_.run(/* flags */ 0);
   VLOG(1) << name() << " thread exiting.";
 
@@ -642,6 +662,30 @@ void Reactor::ProcessOutboundQueue() {
   processing_connections_.clear();
 }
 
+void Reactor::ScheduleFlush(ConnectionPtr conn) {
+  DCHECK(IsCurrentThread());
+
+  if (connections_to_flush_.empty()) {
+    flush_prepare_.start();
+  }
+  connections_to_flush_.push_back(std::move(conn));
+}
+
+void Reactor::FlushHandler(ev::prepare &watcher, int revents) { // NOLINT
+  DCHECK(IsCurrentThread());
+
+  // Flush could schedule other connections, for instance when write fails and connection is
+  // destroyed, so iterate over a separate vector.
+  connections_to_flush_.swap(flushing_connections_);
+  for (auto& conn : flushing_connections_) {
+    conn->Flush();
+  }
+  flushing_connections_.clear();
+  if (connections_to_flush_.empty()) {
+    flush_prepare_.stop();
+  }
+}
+
 void Reactor::QueueOutboundCall(OutboundCallPtr call) {
   DVLOG(3) << "Queueing outbound call "
            << call->ToString() << " to remote " << call->conn_id().remote();
@@ -814,34 +858,60 @@ void Reactor::RegisterInboundSocket(Socket *socket, const Endpoint& remote,
 }
 
 void Reactor::ScheduleReactorTask(ReactorTaskPtr task) {
-  bool was_empty;
-  {
-    // Even though state_ is atomic, we still need to take the lock to make sure state_
-    // and pending_tasks_mtx_ are being modified in a consistent way.
-    std::unique_lock<simple_spinlock> pending_lock(pending_tasks_mtx_);
-    if (state_.load(std::memory_order_acquire) == ReactorState::kClosed) {
-      // The reactor thread has already stopped. We can safely call Abort() now. Abort() will
-      // internally deduplicate repeated calls using an atomic.
-      //
-      // Also, we guarantee that pending_tasks_mtx_ is not taken when calling Abort().
-      pending_lock.unlock();
-      std::lock_guard<std::recursive_mutex> final_abort_serializer(final_abort_mutex_);
-      task->Abort(ServiceUnavailableError());
-      return;
-    }
-    was_empty = pending_tasks_.empty();
-    pending_tasks_.emplace_back(std::move(task));
+  if (state_.load(std::memory_order_acquire) == ReactorState::kClosed) {
+    // The reactor thread has already stopped. We can safely call Abort() now. Abort() will
+    // internally deduplicate repeated calls using an atomic.
+    std::lock_guard<std::recursive_mutex> final_abort_serializer(final_abort_mutex_);
+    task->Abort(ServiceUnavailableError());
+    return;
   }
-  if (was_empty) {
+
+  auto* raw_task = task.get();
+  if (raw_task->queued_.exchange(true, std::memory_order_acq_rel)) {
+    // The task is already waiting in the queue, so it will be run once for both schedules.
+    return;
+  }
+  raw_task->queued_self_ = std::move(task);
+  bool was_empty = pending_tasks_.Push(raw_task);
+
+  // The reactor could be closed after the check above but before the push, then nobody else
+  // would take the task from the queue.
+  if (PREDICT_FALSE(state_.load() == ReactorState::kClosed)) {
+    AbortPendingTasks();
+    return;
+  }
+
+  if (was_empty && !running_tasks_.load()) {
     WakeThread();
   }
 }
 
+void Reactor::PopPendingTasks(ReactorTasks* out) {
+  auto* task = pending_tasks_.PopAll();
+  while (task) {
+    auto* next = GetNext(task);
+    out->push_back(std::move(task->queued_self_));
+    task->queued_.store(false, std::memory_order_release);
+    task = next;
+  }
+}
+
+void Reactor::AbortPendingTasks() {
+  ReactorTasks tasks;
+  PopPendingTasks(&tasks);
+  if (tasks.empty()) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> final_abort_serializer(final_abort_mutex_);
+  for (const auto& task : tasks) {
+    task->Abort(ServiceUnavailableError());
+  }
+}
+
 bool Reactor::DrainTaskQueueAndCheckIfClosing() {
   CHECK(async_handler_tasks_.empty());
 
-  std::lock_guard<simple_spinlock> lock(pending_tasks_mtx_);
-  async_handler_tasks_.swap(pending_tasks_);
+  PopPendingTasks(&async_handler_tasks_);
   return HasReactorStartedClosing(state_.load(std::memory_order_acquire));
 }
 
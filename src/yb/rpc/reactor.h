@@ -51,6 +51,7 @@
 #include "yb/rpc/outbound_call.h"
 
 #include "yb/util/thread.h"
+#include "yb/util/lockfree.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/socket.h"
@@ -82,6 +83,8 @@ struct ReactorMetrics {
   int32_t num_client_connections_;
   // Number of server RPC connections currently connected.
   int32_t num_server_connections_;
+  // Number of times queued outbound data of a connection was written to its stream.
+  int64_t num_connection_flushes_;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -107,11 +110,28 @@ class ReactorTask : public std::enable_shared_from_this<ReactorTask> {
   virtual ~ReactorTask();
 
  private:
+  friend class Reactor;
+
+  friend ReactorTask* GetNext(ReactorTask* task) {
+    return task->next_in_queue_;
+  }
+
+  friend void SetNext(ReactorTask* task, ReactorTask* next) {
+    task->next_in_queue_ = next;
+  }
+
   // To be overridden by subclasses.
   virtual void DoAbort(const Status &abort_status) {}
 
   // Used to prevent Abort() from being called twice from multiple threads.
   std::atomic<bool> abort_called_{false};
+
+  // Whether the task is in the pending tasks queue of a reactor.
+  std::atomic<bool> queued_{false};
+  // Next task in the pending tasks queue.
+  ReactorTask* next_in_queue_ = nullptr;
+  // Keeps the task alive while it is in the pending tasks queue.
+  std::shared_ptr<ReactorTask> queued_self_;
 };
 
 typedef std::shared_ptr<ReactorTask> ReactorTaskPtr;
@@ -293,9 +313,22 @@ class Reactor {
   // libev callback for handling timer events in our epoll thread.
   void TimerHandler(ev::timer &watcher, int revents); // NOLINT
 
+  // libev callback invoked before the loop blocks, writes data queued on connections during this
+  // loop iteration.
+  void FlushHandler(ev::prepare &watcher, int revents); // NOLINT
+
+  // Schedules write of data queued on the connection at the end of the current loop iteration, so
+  // all calls queued on the connection by tasks and handlers of this iteration are sent with a
+  // single syscall.
+  // Should be invoked only from the reactor thread.
+  void ScheduleFlush(ConnectionPtr conn);
+
   // This may be called from another thread.
   const std::string &name() const { return name_; }
 
+  // Index of this reactor in the messenger.
+  int index() const { return index_; }
+
   Messenger *messenger() const { return messenger_.get(); }
 
   CoarseMonoClock::TimePoint cur_time() const { return cur_time_; }
@@ -388,6 +421,12 @@ class Reactor {
   // closing.
   bool DrainTaskQueueAndCheckIfClosing();
 
+  // Moves tasks from pending_tasks_ to the specified vector, in scheduling order.
+  void PopPendingTasks(ReactorTasks* out);
+
+  // Aborts tasks that were scheduled after the reactor thread was closed.
+  void AbortPendingTasks();
+
   template<class F>
   CHECKED_STATUS RunOnReactorThread(const F& f);
 
@@ -398,10 +437,9 @@ class Reactor {
 
   const std::string name_;
 
-  mutable simple_spinlock pending_tasks_mtx_;
+  const int index_;
 
-  // Reactor status, mostly used when shutting down. Guarded by pending_tasks_mtx_, but also read
-  // without a lock for sanity checking.
+  // Reactor status, mostly used when shutting down.
   std::atomic<ReactorState> state_{ReactorState::kRunning};
 
   // This mutex is used to make sure that multiple threads that end up running Abort() in case the
@@ -412,8 +450,11 @@ class Reactor {
   std::recursive_mutex final_abort_mutex_;
 
   // Tasks to be run within the reactor thread.
-  // Guarded by pending_tasks_mtx_.
-  ReactorTasks pending_tasks_;
+  MPSCQueue<ReactorTask> pending_tasks_;
+
+  // Set while the reactor thread runs tasks from pending_tasks_, and will check the queue again
+  // before going to sleep. In this case producers don't have to wake it up.
+  std::atomic<bool> running_tasks_{false};
 
   scoped_refptr<yb::Thread> thread_;
 
@@ -426,6 +467,16 @@ class Reactor {
   // Handles the periodic timer.
   ev::timer timer_;
 
+  // Active while there are connections waiting to be flushed.
+  ev::prepare flush_prepare_;
+
+  // Connections that have data queued for sending during the current loop iteration.
+  std::vector<ConnectionPtr> connections_to_flush_;
+  std::vector<ConnectionPtr> flushing_connections_;
+
+  // Number of Connection::Flush calls, that write queued outbound data to the stream.
+  int64_t num_connection_flushes_ = 0;
+
   // Scheduled (but not yet run) delayed tasks.
   std::set<std::shared_ptr<DelayedTask>> scheduled_tasks_;
 
@@ -35,16 +35,46 @@
 
 #include <gtest/gtest.h>
 
+#ifdef TCMALLOC_ENABLED
+#include <gperftools/malloc_hook.h>
+#endif
+
+#include "yb/gutil/stringprintf.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/strings/substitute.h"
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/rpc/rtest.proxy.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_util.h"
 
 using namespace std::literals; // NOLINT
+using namespace yb::size_literals;
 
 using std::string;
 using std::shared_ptr;
 
+DEFINE_string(rpc_bench_payload_sizes, "100,65536,4194304",
+              "Comma separated payload sizes in bytes, swept by RpcBench.Sweep.");
+DEFINE_string(rpc_bench_connections, "1,64",
+              "Comma separated numbers of client connections, swept by RpcBench.Sweep. Every "
+              "connection has a single call in flight.");
+DEFINE_string(rpc_bench_reactors, "4",
+              "Comma separated numbers of reactor threads of server and client messengers, swept "
+              "by RpcBench.Sweep.");
+DEFINE_string(rpc_bench_service_threads, "8",
+              "Comma separated numbers of service threads of the server, swept by RpcBench.Sweep.");
+DEFINE_int32(rpc_bench_duration_ms, 1000,
+             "Time in milliseconds each configuration of RpcBench.Sweep is measured.");
+DEFINE_int64(rpc_bench_max_bytes_in_flight, 64_MB,
+             "Configurations of RpcBench.Sweep whose payload size multiplied by the number of "
+             "connections exceeds this value are skipped.");
+
+DECLARE_int32(num_connections_to_server);
+DECLARE_bool(rpc_adaptive_connections_to_server);
+
 namespace yb {
 namespace rpc {
 
@@ -150,6 +180,274 @@ TEST_F(RpcBench, BenchmarkCalls) {
   LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
 }
 
+// Measures throughput of calls with large sidecar responses, that are dominated by
+// outbound serialization and writes.
+TEST_F(RpcBench, BenchmarkLargeResponses) {
+  constexpr size_t kResponseSize = 256_KB;
+  constexpr size_t kSidecars = 4;
+#if defined(THREAD_SANITIZER) || defined(ADDRESS_SANITIZER)
+  constexpr int kNumThreads = 2;
+#else
+  constexpr int kNumThreads = 8;
+#endif
+
+  StartTestServer(&server_hostport_);
+
+  std::atomic<size_t> total_bytes{0};
+  std::vector<std::thread> threads;
+  Stopwatch sw(Stopwatch::ALL_THREADS);
+  sw.start();
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([this, &total_bytes] {
+      auto client_messenger = CreateMessenger("Client");
+      Proxy proxy(client_messenger, HostPort(server_hostport_));
+      rpc_test::SendStringsRequestPB req;
+      for (size_t j = 0; j != kSidecars; ++j) {
+        req.add_sizes(kResponseSize / kSidecars);
+      }
+      req.set_random_seed(42);
+      while (should_run_.load(std::memory_order_acquire)) {
+        rpc_test::SendStringsResponsePB resp;
+        RpcController controller;
+        controller.set_timeout(MonoDelta::FromSeconds(10));
+        CHECK_OK(proxy.SyncRequest(
+            GenericCalculatorService::SendStringsMethod(), req, &resp, &controller));
+        total_bytes.fetch_add(kResponseSize, std::memory_order_relaxed);
+      }
+      client_messenger->Shutdown();
+    });
+  }
+
+  std::this_thread::sleep_for(10s);
+  should_run_.store(false, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  sw.stop();
+
+  double mb = static_cast<double>(total_bytes.load()) / 1_MB;
+  LOG(INFO) << "MB/sec:           " << mb / sw.elapsed().wall_seconds();
+  LOG(INFO) << "User CPU per MB:  " << sw.elapsed().user / 1000.0 / mb << "us";
+  LOG(INFO) << "Sys CPU per MB:   " << sw.elapsed().system / 1000.0 / mb << "us";
+}
+
+namespace {
+
+std::vector<size_t> ParseSweepFlag(const std::string& name, const std::string& value) {
+  std::vector<size_t> result;
+  std::vector<std::string> values = strings::Split(value, ",", strings::SkipEmpty());
+  for (const auto& str : values) {
+    uint64 number = 0;
+    CHECK(safe_strtou64(str, &number) && number != 0)
+        << "Invalid value " << str << " in --" << name;
+    result.push_back(number);
+  }
+  return result;
+}
+
+#ifdef TCMALLOC_ENABLED
+std::atomic<uint64_t> num_allocations{0};
+
+void CountAllocation(const void* ptr, size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+struct SweepConfig {
+  size_t payload_size;
+  bool use_sidecar;
+  size_t connections;
+  size_t reactors;
+  size_t service_threads;
+};
+
+struct SweepResult {
+  double calls_per_sec;
+  uint64_t p50_us;
+  uint64_t p99_us;
+  double cpu_us_per_call;
+  // Negative when allocations could not be counted.
+  double allocations_per_call;
+};
+
+// Keeps a single echo call in flight, starting the next call from the callback of the previous
+// one until should_run is reset.
+class EchoCaller {
+ public:
+  EchoCaller(Proxy* proxy, const rpc_test::EchoRequestPB* req, HdrHistogram* latency,
+             const std::atomic<bool>* should_run, CountDownLatch* done)
+      : proxy_(proxy), req_(req), latency_(latency), should_run_(should_run), done_(done) {}
+
+  void Start() {
+    // The previous controller is released only after the callback of its call has returned.
+    previous_controller_ = std::move(controller_);
+    controller_ = std::make_unique<RpcController>();
+    controller_->set_timeout(MonoDelta::FromSeconds(60));
+    start_ = MonoTime::Now();
+    proxy_->AsyncRequest(
+        GenericCalculatorService::EchoMethod(), *req_, &resp_, controller_.get(),
+        std::bind(&EchoCaller::Done, this));
+  }
+
+  size_t num_calls() const { return num_calls_; }
+
+ private:
+  void Done() {
+    CHECK_OK(controller_->status());
+    if (req_->use_sidecar()) {
+      Slice sidecar;
+      CHECK_OK(controller_->GetSidecar(0, &sidecar));
+      CHECK_EQ(req_->data().size(), sidecar.size());
+    } else {
+      CHECK_EQ(req_->data().size(), resp_.data().size());
+    }
+    latency_->Increment(MonoTime::Now().GetDeltaSince(start_).ToMicroseconds());
+    ++num_calls_;
+    if (should_run_->load(std::memory_order_acquire)) {
+      Start();
+    } else {
+      done_->CountDown();
+    }
+  }
+
+  Proxy* const proxy_;
+  const rpc_test::EchoRequestPB* const req_;
+  HdrHistogram* const latency_;
+  const std::atomic<bool>* const should_run_;
+  CountDownLatch* const done_;
+
+  std::unique_ptr<RpcController> controller_;
+  std::unique_ptr<RpcController> previous_controller_;
+  rpc_test::EchoResponsePB resp_;
+  MonoTime start_;
+  size_t num_calls_ = 0;
+};
+
+} // namespace
+
+class RpcSweepBench : public RpcBench {
+ protected:
+  SweepResult Run(const SweepConfig& config) {
+    // The number of connections from one messenger to a server is limited by the size of the
+    // connection index, so many connections are spread over several client messengers.
+    constexpr size_t kMaxConnectionsPerMessenger = 128;
+    const size_t num_messengers =
+        (config.connections + kMaxConnectionsPerMessenger - 1) / kMaxConnectionsPerMessenger;
+    const size_t connections_per_messenger =
+        (config.connections + num_messengers - 1) / num_messengers;
+    FLAGS_num_connections_to_server = connections_per_messenger;
+    FLAGS_rpc_adaptive_connections_to_server = false;
+
+    TestServerOptions options;
+    options.messenger_options.n_reactors = config.reactors;
+    options.n_worker_threads = config.service_threads;
+    StartTestServer(&server_hostport_, options);
+
+    MessengerOptions client_options = kDefaultClientMessengerOptions;
+    client_options.n_reactors = config.reactors;
+    std::vector<shared_ptr<Messenger>> messengers;
+    std::vector<std::unique_ptr<Proxy>> proxies;
+    for (size_t i = 0; i != num_messengers; ++i) {
+      messengers.push_back(CreateMessenger(Format("Client-$0", i), client_options));
+      proxies.push_back(std::make_unique<Proxy>(messengers.back(), server_hostport_));
+    }
+
+    rpc_test::EchoRequestPB req;
+    Random rng(42);
+    req.set_data(RandomHumanReadableString(config.payload_size, &rng));
+    req.set_use_sidecar(config.use_sidecar);
+    HdrHistogram latency(60000000, 2);
+    std::atomic<bool> should_run{true};
+    CountDownLatch done(config.connections);
+    std::vector<std::unique_ptr<EchoCaller>> callers;
+    for (size_t i = 0; i != config.connections; ++i) {
+      callers.push_back(std::make_unique<EchoCaller>(
+          proxies[i % num_messengers].get(), &req, &latency, &should_run, &done));
+    }
+
+    // CPU time and allocations are measured for the whole process, so they include both the
+    // client and the server side of each call.
+#ifdef TCMALLOC_ENABLED
+    num_allocations.store(0, std::memory_order_relaxed);
+    CHECK(MallocHook::AddNewHook(&CountAllocation));
+#endif
+    Stopwatch sw(Stopwatch::ALL_THREADS);
+    sw.start();
+    for (auto& caller : callers) {
+      caller->Start();
+    }
+    std::this_thread::sleep_for(FLAGS_rpc_bench_duration_ms * 1ms);
+    should_run.store(false, std::memory_order_release);
+    done.Wait();
+    sw.stop();
+#ifdef TCMALLOC_ENABLED
+    CHECK(MallocHook::RemoveNewHook(&CountAllocation));
+    const double allocations = num_allocations.load(std::memory_order_relaxed);
+#else
+    const double allocations = -1;
+#endif
+
+    size_t num_calls = 0;
+    for (const auto& caller : callers) {
+      num_calls += caller->num_calls();
+    }
+    for (const auto& messenger : messengers) {
+      messenger->Shutdown();
+    }
+
+    const auto elapsed = sw.elapsed();
+    return SweepResult {
+      num_calls / elapsed.wall_seconds(),
+      latency.ValueAtPercentile(50),
+      latency.ValueAtPercentile(99),
+      (elapsed.user + elapsed.system) / 1000.0 / num_calls,
+      allocations < 0 ? allocations : allocations / num_calls,
+    };
+  }
+};
+
+// Sweeps payload size, sidecar usage, number of connections, number of reactor threads and
+// number of service threads, and reports throughput, latency, CPU and allocations per call for
+// each configuration. Dimensions are controlled by rpc_bench_* flags, so a wider sweep, e.g.
+// --rpc_bench_connections=1,16,256,10000, could be used to validate RPC layer changes.
+TEST_F(RpcSweepBench, Sweep) {
+  const auto payload_sizes = ParseSweepFlag(
+      "rpc_bench_payload_sizes", FLAGS_rpc_bench_payload_sizes);
+  const auto connections = ParseSweepFlag("rpc_bench_connections", FLAGS_rpc_bench_connections);
+  const auto reactors = ParseSweepFlag("rpc_bench_reactors", FLAGS_rpc_bench_reactors);
+  const auto service_threads = ParseSweepFlag(
+      "rpc_bench_service_threads", FLAGS_rpc_bench_service_threads);
+
+  std::string table = StringPrintf(
+      "\n%10s %8s %8s %8s %8s %12s %10s %10s %12s %12s\n", "payload", "sidecar", "conns",
+      "reactors", "workers", "calls/sec", "p50 (us)", "p99 (us)", "cpu/call us", "allocs/call");
+  for (auto payload_size : payload_sizes) {
+    for (bool use_sidecar : {false, true}) {
+      for (auto num_connections : connections) {
+        if (payload_size * num_connections >
+                static_cast<uint64_t>(FLAGS_rpc_bench_max_bytes_in_flight)) {
+          continue;
+        }
+        for (auto num_reactors : reactors) {
+          for (auto num_service_threads : service_threads) {
+            SweepConfig config = {
+                payload_size, use_sidecar, num_connections, num_reactors, num_service_threads };
+            auto result = Run(config);
+            auto line = StringPrintf(
+                "%10zu %8s %8zu %8zu %8zu %12.0f %10" PRIu64 " %10" PRIu64 " %12.1f %12.1f\n",
+                payload_size, use_sidecar ? "yes" : "no", num_connections, num_reactors,
+                num_service_threads, result.calls_per_sec, result.p50_us, result.p99_us,
+                result.cpu_us_per_call, result.allocations_per_call);
+            LOG(INFO) << line;
+            table += line;
+          }
+        }
+      }
+    }
+  }
+  LOG(INFO) << "RPC sweep results:" << table;
+}
+
 } // namespace rpc
 } // namespace yb
 
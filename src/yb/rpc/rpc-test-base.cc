@@ -105,6 +105,7 @@ const char* GenericCalculatorService::kFullServiceName = "yb.rpc.GenericCalculat
 const char* GenericCalculatorService::kAddMethodName = "Add";
 const char* GenericCalculatorService::kSleepMethodName = "Sleep";
 const char* GenericCalculatorService::kSendStringsMethodName = "SendStrings";
+const char* GenericCalculatorService::kEchoMethodName = "Echo";
 const char* GenericCalculatorService::kDisconnectMethodName = "Disconnect";
 
 const char* GenericCalculatorService::kFirstString =
@@ -119,6 +120,8 @@ void GenericCalculatorService::Handle(InboundCallPtr incoming) {
     DoSleep(incoming.get());
   } else if (incoming->method_name() == kSendStringsMethodName) {
     DoSendStrings(incoming.get());
+  } else if (incoming->method_name() == kEchoMethodName) {
+    DoEcho(incoming.get());
   } else {
     incoming->RespondFailure(ErrorStatusPB::ERROR_NO_SUCH_METHOD,
         STATUS(InvalidArgument, "bad method"));
@@ -137,6 +140,29 @@ void GenericCalculatorService::GenericCalculatorService::DoAdd(InboundCall* inco
   down_cast<YBInboundCall*>(incoming)->RespondSuccess(resp);
 }
 
+void GenericCalculatorService::DoEcho(InboundCall* incoming) {
+  Slice param(incoming->serialized_request());
+  EchoRequestPB req;
+  if (!req.ParseFromArray(param.data(), param.size())) {
+    LOG(FATAL) << "couldn't parse: " << param.ToDebugString();
+  }
+
+  EchoResponsePB resp;
+  if (!req.use_sidecar()) {
+    resp.set_data(req.data());
+  } else {
+    resp.set_data(std::string());
+    int idx = 0;
+    auto status = down_cast<YBInboundCall*>(incoming)->AddRpcSidecar(
+        RefCntBuffer(req.data().data(), req.data().size()), &idx);
+    if (!status.ok()) {
+      incoming->RespondFailure(ErrorStatusPB::ERROR_APPLICATION, status);
+      return;
+    }
+  }
+  down_cast<YBInboundCall*>(incoming)->RespondSuccess(resp);
+}
+
 void GenericCalculatorService::DoSendStrings(InboundCall* incoming) {
   Slice param(incoming->serialized_request());
   SendStringsRequestPB req;
@@ -146,11 +172,21 @@ void GenericCalculatorService::DoSendStrings(InboundCall* incoming) {
 
   Random r(req.random_seed());
   SendStringsResponsePB resp;
-  for (auto size : req.sizes()) {
-    auto sidecar = RefCntBuffer(size);
-    RandomString(sidecar.udata(), size, &r);
+  for (int i = 0; i != req.sizes().size(); ++i) {
+    auto size = req.sizes(i);
     int idx = 0;
-    auto status = down_cast<YBInboundCall*>(incoming)->AddRpcSidecar(sidecar, &idx);
+    Status status;
+    // Odd sidecars are passed via faststring, so both owning paths are exercised.
+    if (i & 1) {
+      faststring sidecar;
+      sidecar.resize(size);
+      RandomString(sidecar.data(), size, &r);
+      status = down_cast<YBInboundCall*>(incoming)->AddRpcSidecar(&sidecar, &idx);
+    } else {
+      auto sidecar = RefCntBuffer(size);
+      RandomString(sidecar.udata(), size, &r);
+      status = down_cast<YBInboundCall*>(incoming)->AddRpcSidecar(sidecar, &idx);
+    }
     if (!status.ok()) {
       incoming->RespondFailure(ErrorStatusPB::ERROR_APPLICATION, status);
       return;
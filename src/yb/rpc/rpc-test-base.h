@@ -95,6 +95,11 @@ class GenericCalculatorService : public ServiceIf {
     return &method;
   }
 
+  static RemoteMethod* EchoMethod() {
+    static RemoteMethod method(kFullServiceName, kEchoMethodName);
+    return &method;
+  }
+
   static RemoteMethod* DisconnectMethod() {
     static RemoteMethod method(kFullServiceName, kDisconnectMethodName);
     return &method;
@@ -105,9 +110,11 @@ class GenericCalculatorService : public ServiceIf {
   static const char *kAddMethodName;
   static const char *kSleepMethodName;
   static const char *kSendStringsMethodName;
+  static const char *kEchoMethodName;
   static const char *kDisconnectMethodName;
 
   void DoAdd(InboundCall *incoming);
+  void DoEcho(InboundCall* incoming);
   void DoSendStrings(InboundCall* incoming);
   void DoSleep(InboundCall *incoming);
 };
@@ -147,6 +154,7 @@ class TestServer {
 
   const Endpoint& bound_endpoint() const { return bound_endpoint_; }
   Messenger& messenger() const { return *messenger_; }
+  const std::shared_ptr<Messenger>& shared_messenger() const { return messenger_; }
   ServicePool& service_pool() const { return *service_pool_; }
  private:
   string service_name_;
@@ -45,6 +45,7 @@
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/rpc/serialization.h"
+#include "yb/rpc/uring_stream.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/env.h"
 #include "yb/util/test_util.h"
@@ -52,6 +53,13 @@
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
 
+DECLARE_bool(rpc_coalesce_outbound_writes);
+DECLARE_bool(rpc_use_io_uring);
+DECLARE_bool(rpc_adaptive_connections_to_server);
+DECLARE_int64(rpc_connection_grow_queued_bytes);
+DECLARE_int64(rpc_connection_grow_queue_time_us);
+DECLARE_int64(rpc_connection_shrink_interval_ms);
+
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
 
@@ -338,6 +346,156 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(&p, sizes, Status::kRemoteError);
 }
 
+// Test calls and sidecars over io_uring based streams.
+TEST_F(TestRpc, TestIoUring) {
+  if (!UringStream::IsSupported()) {
+    LOG(INFO) << "io_uring is not supported by the kernel, skipping test";
+    return;
+  }
+  FLAGS_rpc_use_io_uring = true;
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+  }
+
+  DoTestSidecar(&p, {123, 456});
+  DoTestSidecar(&p, {3000 * 1024, 2000 * 1024, 24 * 1024 * 1024});
+
+  client_messenger->Shutdown();
+}
+
+// Test that proxy opens additional connections only while existing ones are overloaded.
+TEST_F(TestRpc, TestAdaptiveConnections) {
+  FLAGS_rpc_adaptive_connections_to_server = true;
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+  }
+  ASSERT_EQ(1, p.active_connections());
+
+  // Treat any connection that has unsent bytes as overloaded.
+  FLAGS_rpc_connection_grow_queued_bytes = 0;
+  // Stay below the service queue length of the test server.
+  constexpr size_t kConcurrentCalls = 40;
+  std::vector<rpc_test::AddResponsePB> resps(kConcurrentCalls);
+  std::vector<RpcController> controllers(kConcurrentCalls);
+  rpc_test::AddRequestPB req;
+  req.set_x(1);
+  req.set_y(2);
+  CountDownLatch latch(kConcurrentCalls);
+  for (size_t i = 0; i != kConcurrentCalls; ++i) {
+    controllers[i].set_timeout(10s);
+    p.AsyncRequest(GenericCalculatorService::AddMethod(), req, &resps[i], &controllers[i],
+                   [&latch] { latch.CountDown(); });
+  }
+  latch.Wait();
+  for (auto& controller : controllers) {
+    ASSERT_OK(controller.status());
+  }
+  ASSERT_GT(p.active_connections(), 1);
+
+  // Without overload connections should be released one by one.
+  FLAGS_rpc_connection_grow_queued_bytes = std::numeric_limits<int64_t>::max();
+  FLAGS_rpc_connection_grow_queue_time_us = std::numeric_limits<int64_t>::max();
+  FLAGS_rpc_connection_shrink_interval_ms = 0;
+  ASSERT_OK(WaitFor([this, &p] {
+    EXPECT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+    return p.active_connections() == 1;
+  }, 10s, "Connections released"));
+
+  client_messenger->Shutdown();
+}
+
+namespace {
+
+int64_t ConnectionFlushes(Messenger* messenger) {
+  int64_t result = 0;
+  for (size_t i = 0; i != messenger->num_reactors(); ++i) {
+    ReactorMetrics metrics;
+    CHECK_OK(messenger->ReactorForTests(i)->GetMetrics(&metrics));
+    result += metrics.num_connection_flushes_;
+  }
+  return result;
+}
+
+} // namespace
+
+// Test that many small responses queued by the reactor thread within the same loop iteration are
+// written with a few syscalls. Here those are rejections of calls that overflow the service queue,
+// they are sent right from the reactor thread that parsed the calls.
+TEST_F(TestRpc, TestCoalescedWrites) {
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr);
+  // Establish the connection, so calls are not queued behind negotiation.
+  ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+
+  // Several times more than the service queue length of the test server.
+  constexpr size_t kNumCalls = 300;
+  for (bool coalesce : {true, false}) {
+    FLAGS_rpc_coalesce_outbound_writes = coalesce;
+    const auto flushes_before = ConnectionFlushes(&server_messenger());
+
+    // Client reactors are blocked while the calls are queued, so all calls are sent together and
+    // the server parses them from a few reads.
+    CountDownLatch blocked(client_messenger->num_reactors());
+    CountDownLatch release(1);
+    for (size_t i = 0; i != client_messenger->num_reactors(); ++i) {
+      client_messenger->ReactorForTests(i)->ScheduleReactorFunctor(
+          [&blocked, &release](Reactor* reactor) {
+        blocked.CountDown();
+        release.Wait();
+      });
+    }
+    blocked.Wait();
+
+    rpc_test::SleepRequestPB req;
+    req.set_sleep_micros(100 * 1000);
+    std::vector<rpc_test::SleepResponsePB> resps(kNumCalls);
+    std::vector<RpcController> controllers(kNumCalls);
+    CountDownLatch latch(kNumCalls);
+    for (size_t i = 0; i != kNumCalls; ++i) {
+      controllers[i].set_timeout(30s);
+      p.AsyncRequest(GenericCalculatorService::SleepMethod(), req, &resps[i], &controllers[i],
+                     [&latch] { latch.CountDown(); });
+    }
+    release.CountDown();
+    latch.Wait();
+
+    size_t rejected = 0;
+    for (const auto& controller : controllers) {
+      if (!controller.status().ok()) {
+        ++rejected;
+      }
+    }
+    const auto flushes = ConnectionFlushes(&server_messenger()) - flushes_before;
+    LOG(INFO) << "Coalesce: " << coalesce << ", rejected: " << rejected << ", flushes: "
+              << flushes;
+    ASSERT_GE(rejected, kNumCalls / 2);
+    if (coalesce) {
+      // Rejections of calls parsed from the same read are written by a single flush.
+      ASSERT_LT(flushes, rejected / 4);
+    } else {
+      ASSERT_GE(flushes, rejected);
+    }
+  }
+
+  client_messenger->Shutdown();
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   HostPort server_addr;
@@ -650,5 +808,33 @@ TEST_F(TestRpc, TestDisconnect) {
   ASSERT_EQ(kRequests, total);
 }
 
+TEST_F(TestRpc, TestLinkConditions) {
+  constexpr auto kLatency = 200ms;
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr);
+  // Establish the connection before measuring.
+  ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+
+  const auto server_address = server().bound_endpoint().address();
+  LinkConditions conditions;
+  conditions.latency = kLatency;
+  client_messenger->SetLinkConditions(server_address, conditions);
+  auto start = MonoTime::Now();
+  ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+  ASSERT_GE(MonoTime::Now().GetDeltaSince(start), MonoDelta(kLatency));
+
+  conditions.loss_probability = 1;
+  client_messenger->SetLinkConditions(server_address, conditions);
+  auto status = DoTestSyncCall(&p, GenericCalculatorService::AddMethod());
+  ASSERT_TRUE(status.IsNetworkError()) << status;
+
+  client_messenger->ClearLinkConditions(server_address);
+  start = MonoTime::Now();
+  ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+  ASSERT_LT(MonoTime::Now().GetDeltaSince(start), MonoDelta(kLatency));
+}
+
 } // namespace rpc
 } // namespace yb
@@ -115,6 +115,13 @@ RpcContext::RpcContext(std::shared_ptr<YBInboundCall> call,
                            "request", TracePb(*request_pb_));
 }
 
+RpcContext::RpcContext(std::shared_ptr<YBInboundCall> call,
+                       CallMessages messages,
+                       RpcMethodMetrics metrics)
+    : RpcContext(std::move(call), std::move(messages.request), std::move(messages.response),
+                 std::move(metrics)) {
+}
+
 RpcContext::RpcContext(std::shared_ptr<LocalYBInboundCall> call,
                        RpcMethodMetrics metrics)
     : call_(call),
@@ -127,7 +134,8 @@ RpcContext::RpcContext(std::shared_ptr<LocalYBInboundCall> call,
 }
 
 void RpcContext::RespondSuccess() {
-  if (response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
+  // Local call response is not serialized, so don't compute its size.
+  if (!call_->IsLocalCall() && response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
     RespondFailure(STATUS(InvalidArgument, "RPC message too long"));
     return;
   }
@@ -171,6 +179,10 @@ Status RpcContext::AddRpcSidecar(RefCntBuffer car, int* idx) {
   return call_->AddRpcSidecar(car, idx);
 }
 
+Status RpcContext::AddRpcSidecar(faststring* car, int* idx) {
+  return call_->AddRpcSidecar(car, idx);
+}
+
 void RpcContext::ResetRpcSidecars() {
   call_->ResetRpcSidecars();
 }
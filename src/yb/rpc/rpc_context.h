@@ -35,9 +35,11 @@
 #include <string>
 
 #include "yb/gutil/gscoped_ptr.h"
+#include "yb/rpc/call_arena.h"
 #include "yb/rpc/local_call.h"
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/rpc/service_if.h"
+#include "yb/util/faststring.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 
@@ -75,6 +77,9 @@ class RpcContext {
              std::shared_ptr<google::protobuf::Message> request_pb,
              std::shared_ptr<google::protobuf::Message> response_pb,
              RpcMethodMetrics metrics);
+  RpcContext(std::shared_ptr<YBInboundCall> call,
+             CallMessages messages,
+             RpcMethodMetrics metrics);
   RpcContext(std::shared_ptr<LocalYBInboundCall> call,
              RpcMethodMetrics metrics);
 
@@ -173,6 +178,9 @@ class RpcContext {
   // by the RPC response.
   CHECKED_STATUS AddRpcSidecar(RefCntBuffer car, int* idx);
 
+  // Same as above, but takes ownership of car content, so it is sent without being copied.
+  CHECKED_STATUS AddRpcSidecar(faststring* car, int* idx);
+
   // Removes all RpcSidecars.
   void ResetRpcSidecars();
 
@@ -38,6 +38,7 @@
 
 #include "yb/gutil/macros.h"
 #include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/rpc_header.pb.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/status.h"
@@ -127,6 +128,15 @@ class RpcController {
   // Return the configured timeout.
   MonoDelta timeout() const;
 
+  // Priority class of the call, i.e. the ServicePool lane where the call will wait for a worker.
+  // When not set, the server picks the lane based on the called method.
+  void set_priority(RequestHeader::Priority priority) {
+    priority_ = priority;
+    has_priority_ = true;
+  }
+  RequestHeader::Priority priority() const { return priority_; }
+  bool has_priority() const { return has_priority_; }
+
   // Fills the 'sidecar' parameter with the slice pointing to the i-th
   // sidecar upon success.
   //
@@ -141,6 +151,8 @@ class RpcController {
   friend class Proxy;
 
   MonoDelta timeout_;
+  RequestHeader::Priority priority_ = RequestHeader::NORMAL;
+  bool has_priority_ = false;
 
   mutable simple_spinlock lock_;
 
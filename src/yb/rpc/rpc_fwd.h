@@ -46,6 +46,7 @@ namespace rpc {
 class Acceptor;
 class AcceptorPool;
 class ConnectionContext;
+class GrowableBuffer;
 class GrowableBufferAllocator;
 class Messenger;
 class MessengerBuilder;
@@ -38,6 +38,7 @@
 #include <gtest/gtest.h>
 
 #include "yb/gutil/stl_util.h"
+#include "yb/rpc/call_arena.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/rtest.proxy.h"
 #include "yb/rpc/rtest.service.h"
@@ -45,6 +46,7 @@
 
 #include "yb/util/countdown_latch.h"
 #include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/subprocess.h"
 #include "yb/util/test_util.h"
@@ -55,6 +57,11 @@
 DEFINE_bool(is_panic_test_child, false, "Used by TestRpcPanic");
 DECLARE_bool(socket_inject_short_recvs);
 DECLARE_int32(rpc_slow_query_threshold_ms);
+DECLARE_bool(rpc_zero_copy_inbound_calls);
+DECLARE_bool(rpc_enable_priority_lanes);
+DECLARE_bool(rpc_shed_calls_by_handler_latency);
+DECLARE_bool(rpc_use_call_arenas);
+DECLARE_int32(rpc_max_message_size);
 
 using namespace std::chrono_literals;
 
@@ -148,6 +155,42 @@ TEST_F(RpcStubTest, TestShortRecvs) {
   }
 }
 
+// Checks that call messages allocated from call arenas are handled, and that arenas are returned
+// to the pool for reuse.
+TEST_F(RpcStubTest, TestCallArenas) {
+  google::FlagSaver saver;
+
+  for (bool use_call_arenas : {false, true}) {
+    FLAGS_rpc_use_call_arenas = use_call_arenas;
+    for (int i = 0; i < 100; i++) {
+      ASSERT_NO_FATALS(SendSimpleCall());
+    }
+  }
+
+  ASSERT_OK(WaitFor([] { return CallArena::PoolSizeForTests() > 0; }, 5s, "Arena returned"));
+}
+
+// Local call passes request and response protobufs to the service without serialization, so it
+// is not affected by the max message size.
+TEST_F(RpcStubTest, TestLocalCall) {
+  google::FlagSaver saver;
+  FLAGS_rpc_max_message_size = 1;
+
+  ProxyCache proxy_cache(server().shared_messenger());
+  CalculatorServiceProxy p(&proxy_cache, HostPort());
+  ASSERT_TRUE(p.proxy().IsServiceLocal());
+
+  for (int i = 0; i < 10; i++) {
+    RpcController controller;
+    AddRequestPB req;
+    req.set_x(i);
+    req.set_y(20);
+    AddResponsePB resp;
+    ASSERT_OK(p.Add(req, &resp, &controller));
+    ASSERT_EQ(i + 20, resp.result());
+  }
+}
+
 void CheckForward(CalculatorServiceProxy* proxy,
                   const Endpoint& endpoint,
                   const std::string& expected) {
@@ -235,6 +278,44 @@ TEST_F(RpcStubTest, TestBigCallData) {
   }
 }
 
+class RpcStubZeroCopyTest : public RpcStubTest {
+ public:
+  void SetUp() override {
+    FLAGS_rpc_zero_copy_inbound_calls = true;
+    RpcStubTest::SetUp();
+  }
+};
+
+// Test calls that are parsed directly from the read buffer of server connection.
+// Sizes are picked so some calls fit into a single read buffer block, while others span several
+// blocks and fall back to copying.
+TEST_F(RpcStubZeroCopyTest, TestEcho) {
+  constexpr int kNumSentAtOnce = 20;
+
+  CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
+  Random rng(SeedRandom());
+
+  for (size_t size : {0_KB, 1_KB, 64_KB, 500_KB, 3_MB}) {
+    std::vector<EchoRequestPB> reqs(kNumSentAtOnce);
+    std::vector<EchoResponsePB> resps(kNumSentAtOnce);
+    std::vector<RpcController> controllers(kNumSentAtOnce);
+
+    CountDownLatch latch(kNumSentAtOnce);
+    for (int i = 0; i < kNumSentAtOnce; i++) {
+      reqs[i].set_data(RandomHumanReadableString(size, &rng));
+      controllers[i].set_timeout(60s);
+      p.EchoAsync(reqs[i], &resps[i], &controllers[i], [&latch]() { latch.CountDown(); });
+    }
+
+    latch.Wait();
+
+    for (int i = 0; i < kNumSentAtOnce; i++) {
+      ASSERT_OK(controllers[i].status());
+      ASSERT_EQ(reqs[i].data(), resps[i].data()) << "Size: " << size;
+    }
+  }
+}
+
 TEST_F(RpcStubTest, TestRespondDeferred) {
   CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
 
@@ -452,6 +533,93 @@ TEST_F(RpcStubTest, TestDontHandleTimedOutCalls) {
   ASSERT_EQ(1, timed_out_in_queue->value());
 }
 
+class RpcStubPriorityLanesTest : public RpcStubTest {
+ public:
+  void SetUp() override {
+    FLAGS_rpc_enable_priority_lanes = true;
+    RpcStubTest::SetUp();
+  }
+};
+
+// Test that high priority call does not wait behind all queued low priority calls.
+TEST_F(RpcStubPriorityLanesTest, TestHighPriorityCallOvertakesQueue) {
+  CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
+  vector<AsyncSleep*> sleeps;
+  ElementDeleter d(&sleeps);
+
+  // Enough low priority calls to keep the worker threads busy for about a second.
+  auto count = client_messenger_->max_concurrent_requests() * 4;
+  CountDownLatch latch(count);
+  for (size_t i = 0; i < count; i++) {
+    gscoped_ptr<AsyncSleep> sleep(new AsyncSleep);
+    sleep->rpc.set_timeout(MonoDelta::FromSeconds(30));
+    sleep->rpc.set_priority(RequestHeader::LOW);
+    sleep->req.set_sleep_micros(100 * 1000); // 100ms
+    p.SleepAsync(sleep->req, &sleep->resp, &sleep->rpc, [&latch]() { latch.CountDown(); });
+    sleeps.push_back(sleep.release());
+  }
+
+  RpcController rpc;
+  rpc.set_timeout(MonoDelta::FromSeconds(30));
+  rpc.set_priority(RequestHeader::HIGH);
+  SleepRequestPB req;
+  SleepResponsePB resp;
+  req.set_sleep_micros(1000);
+  ASSERT_OK(p.Sleep(req, &resp, &rpc));
+
+  // The high priority call should be picked by the first worker that becomes free.
+  ASSERT_GT(latch.count(), count / 2);
+
+  latch.Wait();
+  for (auto* sleep : sleeps) {
+    ASSERT_OK(sleep->rpc.status());
+  }
+}
+
+// Test that calls which cannot finish before their deadline are not handled.
+TEST_F(RpcStubTest, TestShedCallsByHandlerLatency) {
+  CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
+
+  // Fill handler latency histogram of Sleep.
+  constexpr size_t kWarmupCalls = 120;
+  vector<AsyncSleep*> sleeps;
+  ElementDeleter d(&sleeps);
+  CountDownLatch latch(kWarmupCalls);
+  for (size_t i = 0; i < kWarmupCalls; i++) {
+    gscoped_ptr<AsyncSleep> sleep(new AsyncSleep);
+    sleep->rpc.set_timeout(MonoDelta::FromSeconds(30));
+    sleep->req.set_sleep_micros(50 * 1000); // 50ms
+    p.SleepAsync(sleep->req, &sleep->resp, &sleep->rpc, [&latch]() { latch.CountDown(); });
+    sleeps.push_back(sleep.release());
+  }
+  latch.Wait();
+
+  FLAGS_rpc_shed_calls_by_handler_latency = true;
+  const Counter* shed = server().service_pool().RpcsShedByHandlerLatencyMetricForTests();
+
+  // Call with deadline way shorter than median latency should be rejected.
+  {
+    RpcController rpc;
+    SleepRequestPB req;
+    SleepResponsePB resp;
+    req.set_sleep_micros(50 * 1000);
+    rpc.set_timeout(MonoDelta::FromMilliseconds(20));
+    ASSERT_NOK(p.Sleep(req, &resp, &rpc));
+  }
+  ASSERT_OK(WaitFor([shed] { return shed->value() == 1; }, 5s, "Call shed"));
+
+  // Call with enough time left should be handled as usual.
+  {
+    RpcController rpc;
+    SleepRequestPB req;
+    SleepResponsePB resp;
+    req.set_sleep_micros(50 * 1000);
+    rpc.set_timeout(MonoDelta::FromSeconds(30));
+    ASSERT_OK(p.Sleep(req, &resp, &rpc));
+  }
+  ASSERT_EQ(1, shed->value());
+}
+
 TEST_F(RpcStubTest, TestDumpCallsInFlight) {
   CountDownLatch latch(1);
   CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
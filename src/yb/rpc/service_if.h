@@ -68,6 +68,12 @@ class ServiceIf {
 
   virtual void Shutdown();
   virtual std::string service_name() const = 0;
+
+  // Returns histogram of handler latency for the specified method, or nullptr if the service does
+  // not track it.
+  virtual scoped_refptr<Histogram> HandlerLatency(const std::string& method_name) const {
+    return nullptr;
+  }
 };
 
 }  // namespace rpc
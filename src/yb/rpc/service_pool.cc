@@ -32,8 +32,11 @@
 
 #include "yb/rpc/service_pool.h"
 
+#include <array>
+#include <deque>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <glog/logging.h>
@@ -41,12 +44,18 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/connection.h"
 #include "yb/rpc/inbound_call.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/reactor.h"
 #include "yb/rpc/service_if.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/status.h"
@@ -69,6 +78,27 @@ TAG_FLAG(backpressure_recovery_period_ms, runtime);
 DEFINE_test_flag(bool, enable_backpressure_mode_for_testing, false,
             "For testing purposes. Enables the rpc's to be considered timed out in the queue even "
             "when we have not had any backpressure in the recent past.");
+DEFINE_bool(rpc_enable_priority_lanes, false,
+            "Queue calls waiting for a worker thread in separate high, normal and low priority "
+            "lanes, that are served using weighted fair queueing. Otherwise calls are served in "
+            "the order they arrived.");
+TAG_FLAG(rpc_enable_priority_lanes, advanced);
+DEFINE_string(rpc_priority_lane_weights, "8,4,1",
+              "Comma separated weights of high, normal and low priority lanes. A lane with a "
+              "larger weight gets a proportionally larger share of worker threads when all lanes "
+              "have queued calls.");
+TAG_FLAG(rpc_priority_lane_weights, advanced);
+DEFINE_string(rpc_method_priorities, "",
+              "Comma separated list of <service>.<method>=<high|normal|low> entries, that "
+              "specify the lane for calls that do not contain priority in the request header, "
+              "e.g. yb.tserver.TabletServerService.Read=high. Methods that are not listed use "
+              "the normal lane.");
+TAG_FLAG(rpc_method_priorities, advanced);
+DEFINE_bool(rpc_shed_calls_by_handler_latency, false,
+            "Reject a call without handling it when its remaining time before the client "
+            "deadline is less than the median handler latency of the called method.");
+TAG_FLAG(rpc_shed_calls_by_handler_latency, advanced);
+TAG_FLAG(rpc_shed_calls_by_handler_latency, runtime);
 
 METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
                         "RPC Queue Time",
@@ -88,6 +118,13 @@ METRIC_DEFINE_counter(server, rpcs_queue_overflow,
                       "Number of RPCs dropped because the service queue "
                       "was full.");
 
+METRIC_DEFINE_counter(server, rpcs_shed_by_handler_latency,
+                      "RPCs Shed By Handler Latency",
+                      yb::MetricUnit::kRequests,
+                      "Number of RPCs rejected before handling because their remaining "
+                      "time before deadline was less than the median handler latency "
+                      "of the called method.");
+
 namespace yb {
 namespace rpc {
 
@@ -96,6 +133,78 @@ namespace {
 static constexpr CoarseMonoClock::Duration kNone{
     CoarseMonoClock::TimePoint::min().time_since_epoch()};
 
+// Lanes, ordered from highest to lowest priority.
+constexpr size_t kHighPriorityLane = 0;
+constexpr size_t kNormalPriorityLane = 1;
+constexpr size_t kLowPriorityLane = 2;
+constexpr size_t kNumPriorityLanes = 3;
+
+// Pass of a lane is advanced by kStrideScale / weight every time a call is taken from it.
+constexpr uint64_t kStrideScale = 1ULL << 20;
+
+// Minimal number of samples in handler latency histogram, before we start to shed calls based
+// on it.
+constexpr uint64_t kMinHandlerLatencySamples = 100;
+
+// How often cached median handler latency is refreshed from the histogram.
+const CoarseMonoClock::Duration kHandlerLatencyRefreshInterval = std::chrono::seconds(1);
+
+size_t PriorityToLane(RequestHeader::Priority priority) {
+  switch (priority) {
+    case RequestHeader::HIGH:
+      return kHighPriorityLane;
+    case RequestHeader::NORMAL:
+      return kNormalPriorityLane;
+    case RequestHeader::LOW:
+      return kLowPriorityLane;
+  }
+  return kNormalPriorityLane;
+}
+
+std::array<uint64_t, kNumPriorityLanes> ParseLaneWeights(const std::string& input) {
+  std::array<uint64_t, kNumPriorityLanes> result = {8, 4, 1};
+  std::vector<std::string> parts = strings::Split(input, ",", strings::SkipEmpty());
+  std::array<uint64_t, kNumPriorityLanes> parsed;
+  bool valid = parts.size() == kNumPriorityLanes;
+  for (size_t i = 0; valid && i != kNumPriorityLanes; ++i) {
+    valid = safe_strtou64(parts[i], &parsed[i]) && parsed[i] > 0 && parsed[i] <= kStrideScale;
+  }
+  if (!valid) {
+    LOG(WARNING) << "Invalid rpc_priority_lane_weights: " << input << ", using default";
+    return result;
+  }
+  return parsed;
+}
+
+// Returns map from method name to lane for methods of the specified service.
+std::unordered_map<std::string, size_t> ParseMethodLanes(
+    const std::string& input, const std::string& service_name) {
+  std::unordered_map<std::string, size_t> result;
+  const std::string prefix = service_name + ".";
+  for (const auto& entry : strings::Split(input, ",", strings::SkipEmpty())) {
+    std::vector<std::string> parts = strings::Split(entry, "=");
+    if (parts.size() != 2) {
+      LOG(WARNING) << "Invalid rpc_method_priorities entry: " << entry;
+      continue;
+    }
+    size_t lane;
+    if (parts[1] == "high") {
+      lane = kHighPriorityLane;
+    } else if (parts[1] == "normal") {
+      lane = kNormalPriorityLane;
+    } else if (parts[1] == "low") {
+      lane = kLowPriorityLane;
+    } else {
+      LOG(WARNING) << "Invalid priority in rpc_method_priorities entry: " << entry;
+      continue;
+    }
+    if (HasPrefixString(parts[0], prefix)) {
+      result[parts[0].substr(prefix.size())] = lane;
+    }
+  }
+  return result;
+}
+
 class InboundCallTask final {
  public:
   InboundCallTask(ServicePoolImpl* pool, InboundCallPtr call)
@@ -123,7 +232,14 @@ class ServicePoolImpl {
         incoming_queue_time_(METRIC_rpc_incoming_queue_time.Instantiate(entity)),
         rpcs_timed_out_in_queue_(METRIC_rpcs_timed_out_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
+        rpcs_shed_by_handler_latency_(METRIC_rpcs_shed_by_handler_latency.Instantiate(entity)),
+        use_priority_lanes_(FLAGS_rpc_enable_priority_lanes),
+        method_lanes_(ParseMethodLanes(FLAGS_rpc_method_priorities, service_->service_name())),
         tasks_pool_(max_tasks) {
+    auto weights = ParseLaneWeights(FLAGS_rpc_priority_lane_weights);
+    for (size_t i = 0; i != kNumPriorityLanes; ++i) {
+      lanes_[i].stride = kStrideScale / weights[i];
+    }
   }
 
   ~ServicePoolImpl() {
@@ -140,11 +256,66 @@ class ServicePoolImpl {
   void Enqueue(InboundCallPtr call) {
     TRACE_TO(call->trace(), "Inserting onto call queue");
 
-    if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call))) {
-      Overflow(call, "service", tasks_pool_.size());
+    // Prefer workers that correspond to the reactor that received the call.
+    size_t affinity = ThreadPool::kNoAffinity;
+    auto connection = call->connection();
+    if (connection) {
+      affinity = connection->reactor()->index();
+    }
+
+    if (!use_priority_lanes_) {
+      if (!tasks_pool_.EnqueueWithAffinity(thread_pool_, affinity, this, std::move(call))) {
+        Overflow(call, "service", tasks_pool_.size());
+      }
+      return;
+    }
+
+    PushToLane(std::move(call));
+    // Each queued call has its own task, but the task does not have to process the same call,
+    // it takes the call chosen by weighted fair queueing at the moment it starts.
+    if (!tasks_pool_.EnqueueWithAffinity(thread_pool_, affinity, this, nullptr)) {
+      // Since the queue is full, drop the most recent call from the lowest priority lane,
+      // that could be a different one than the call that we just added.
+      auto dropped = PopLowestPriority();
+      if (dropped) {
+        Overflow(dropped, "service", tasks_pool_.size());
+      }
     }
   }
 
+  // Takes the next call to handle according to weighted fair queueing, i.e. the call from the
+  // non empty lane with the lowest pass.
+  InboundCallPtr PopNext() {
+    std::lock_guard<simple_spinlock> lock(lanes_mutex_);
+    Lane* best = nullptr;
+    for (auto& lane : lanes_) {
+      if (!lane.calls.empty() && (!best || lane.pass < best->pass)) {
+        best = &lane;
+      }
+    }
+    if (!best) {
+      return nullptr;
+    }
+    current_pass_ = best->pass;
+    best->pass += best->stride;
+    auto result = std::move(best->calls.front());
+    best->calls.pop_front();
+    return result;
+  }
+
+  // Takes the most recent call from the lowest priority non empty lane.
+  InboundCallPtr PopLowestPriority() {
+    std::lock_guard<simple_spinlock> lock(lanes_mutex_);
+    for (auto i = lanes_.rbegin(); i != lanes_.rend(); ++i) {
+      if (!i->calls.empty()) {
+        auto result = std::move(i->calls.back());
+        i->calls.pop_back();
+        return result;
+      }
+    }
+    return nullptr;
+  }
+
   const Counter* RpcsTimedOutInQueueMetricForTests() const {
     return rpcs_timed_out_in_queue_.get();
   }
@@ -153,6 +324,10 @@ class ServicePoolImpl {
     return rpcs_queue_overflow_.get();
   }
 
+  const Counter* RpcsShedByHandlerLatencyMetricForTests() const {
+    return rpcs_shed_by_handler_latency_.get();
+  }
+
   std::string service_name() const {
     return service_->service_name();
   }
@@ -192,6 +367,7 @@ class ServicePoolImpl {
   void Handle(InboundCallPtr incoming) {
     incoming->RecordHandlingStarted(incoming_queue_time_);
     ADOPT_TRACE(incoming->trace());
+    ScopedProfilerTag profiler_tag(incoming->method_name());
 
     if (PREDICT_FALSE(incoming->ClientTimedOut() || ShouldDropRequestDuringHighLoad(incoming))) {
       const char* message =
@@ -209,12 +385,92 @@ class ServicePoolImpl {
       return;
     }
 
+    if (FLAGS_rpc_shed_calls_by_handler_latency && !CanFinishBeforeDeadline(*incoming)) {
+      const char* message =
+          "Remaining time before deadline is less than the median handler latency";
+      TRACE_TO(incoming->trace(), message);
+      VLOG(4) << "Shedding call " << incoming->ToString();
+      rpcs_shed_by_handler_latency_->Increment();
+      incoming->RespondFailure(ErrorStatusPB::ERROR_SERVER_TOO_BUSY, STATUS(TimedOut, message));
+      return;
+    }
+
     TRACE_TO(incoming->trace(), "Handling call");
 
     service_->Handle(std::move(incoming));
   }
 
  private:
+  struct Lane {
+    std::deque<InboundCallPtr> calls;
+    // Virtual time of the lane in stride scheduling.
+    uint64_t pass = 0;
+    uint64_t stride = 0;
+  };
+
+  // Median handler latency of a method, cached to avoid computing percentile for every call.
+  struct MethodLatency {
+    scoped_refptr<Histogram> histogram;
+    std::atomic<int64_t> median_us{0};
+    std::atomic<CoarseMonoClock::Duration> refresh_at{CoarseMonoClock::Duration::zero()};
+  };
+
+  void PushToLane(InboundCallPtr call) {
+    size_t lane_index = kNormalPriorityLane;
+    RequestHeader::Priority priority;
+    if (call->GetPriority(&priority)) {
+      lane_index = PriorityToLane(priority);
+    } else {
+      auto it = method_lanes_.find(call->method_name());
+      if (it != method_lanes_.end()) {
+        lane_index = it->second;
+      }
+    }
+
+    std::lock_guard<simple_spinlock> lock(lanes_mutex_);
+    auto& lane = lanes_[lane_index];
+    // Lane that was idle should not get credit for the time it was idle.
+    if (lane.calls.empty()) {
+      lane.pass = std::max(lane.pass, current_pass_);
+    }
+    lane.calls.push_back(std::move(call));
+  }
+
+  MethodLatency* GetMethodLatency(const std::string& method_name) {
+    std::lock_guard<simple_spinlock> lock(method_latencies_mutex_);
+    auto& result = method_latencies_[method_name];
+    if (!result) {
+      result.reset(new MethodLatency);
+      result->histogram = service_->HandlerLatency(method_name);
+    }
+    return result.get();
+  }
+
+  bool CanFinishBeforeDeadline(const InboundCall& call) {
+    auto deadline = call.GetClientDeadline();
+    if (deadline == MonoTime::Max()) {
+      return true;
+    }
+    auto* latency = GetMethodLatency(call.method_name());
+    if (!latency->histogram) {
+      return true;
+    }
+    auto now = CoarseMonoClock::Now().time_since_epoch();
+    auto refresh_at = latency->refresh_at.load(std::memory_order_acquire);
+    if (now >= refresh_at &&
+        latency->refresh_at.compare_exchange_strong(
+            refresh_at, now + kHandlerLatencyRefreshInterval)) {
+      int64_t median_us = 0;
+      if (latency->histogram->TotalCount() >= kMinHandlerLatencySamples) {
+        median_us = latency->histogram->ValueAtPercentile(50);
+      }
+      latency->median_us.store(median_us, std::memory_order_release);
+    }
+    auto median_us = latency->median_us.load(std::memory_order_acquire);
+    return median_us == 0 ||
+           deadline.GetDeltaSince(MonoTime::Now()).ToMicroseconds() >= median_us;
+  }
+
   bool ShouldDropRequestDuringHighLoad(InboundCallPtr incoming) {
     auto last_backpressure_at = last_backpressure_at_.load(std::memory_order_acquire);
 
@@ -242,18 +498,48 @@ class ServicePoolImpl {
   scoped_refptr<Histogram> incoming_queue_time_;
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
+  scoped_refptr<Counter> rpcs_shed_by_handler_latency_;
   std::atomic<CoarseMonoClock::Duration> last_backpressure_at_;
 
+  const bool use_priority_lanes_;
+  // Lanes for calls that were not picked by a worker yet, used when use_priority_lanes_ is set.
+  simple_spinlock lanes_mutex_;
+  std::array<Lane, kNumPriorityLanes> lanes_;
+  // Pass of the lane that was served last.
+  uint64_t current_pass_ = 0;
+  const std::unordered_map<std::string, size_t> method_lanes_;
+
+  simple_spinlock method_latencies_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<MethodLatency>> method_latencies_;
+
   std::atomic<bool> closing_ = {false};
   TasksPool<InboundCallTask> tasks_pool_;
 };
 
 void InboundCallTask::Run() {
-  pool_->Handle(call_);
+  if (call_) {
+    pool_->Handle(call_);
+    return;
+  }
+  // Task was created in priority lanes mode, so take the call chosen by the pool.
+  auto call = pool_->PopNext();
+  if (call) {
+    pool_->Handle(std::move(call));
+  }
 }
 
 void InboundCallTask::Done(const Status& status) {
   InboundCallPtr call = call_;
+  if (!call) {
+    if (status.ok()) {
+      return;
+    }
+    // Task was not run, so one of the queued calls should be failed instead.
+    call = pool_->PopLowestPriority();
+    if (!call) {
+      return;
+    }
+  }
   pool_->Processed(call, status);
 }
 
@@ -287,6 +573,10 @@ const Counter* ServicePool::RpcsQueueOverflowMetric() const {
   return impl_->RpcsQueueOverflowMetric();
 }
 
+const Counter* ServicePool::RpcsShedByHandlerLatencyMetricForTests() const {
+  return impl_->RpcsShedByHandlerLatencyMetricForTests();
+}
+
 std::string ServicePool::service_name() const {
   return impl_->service_name();
 }
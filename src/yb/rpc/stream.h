@@ -30,6 +30,11 @@ struct loop_ref;
 namespace yb {
 namespace rpc {
 
+// Maximal number of iovecs that stream passes to a single writev. Many small calls queued on a
+// connection during one reactor loop iteration are usually sent with one syscall, so it matches
+// IOV_MAX instead of the number of slices in a single call.
+constexpr size_t kMaxIovPerWrite = 1024;
+
 class StreamContext {
  public:
   virtual void UpdateLastActivity() = 0;
@@ -63,6 +68,11 @@ class Stream {
 
   virtual const Protocol* GetProtocol() = 0;
 
+  // Buffer that holds received data passed to StreamContext::ProcessReceived.
+  // Could be used to pin received data instead of copying it.
+  // Returns nullptr if stream does not support it.
+  virtual GrowableBuffer* ReadBuffer() { return nullptr; }
+
   virtual ~Stream() {}
 };
 
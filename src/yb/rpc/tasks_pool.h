@@ -18,11 +18,11 @@
 #ifndef YB_RPC_TASKS_POOL_H
 #define YB_RPC_TASKS_POOL_H
 
+#include "yb/rpc/thread_pool.h"
+
 namespace yb {
 namespace rpc {
 
-class ThreadPool;
-
 // Tasks pool that could be used in conjunction with ThreadPool, to preallocate a buffer for a fixed
 // number of tasks and avoid allocating memory for each task separately.
 template <class Task>
@@ -36,11 +36,18 @@ class TasksPool {
 
   template <class... Args>
   bool Enqueue(ThreadPool* thread_pool, Args&&... args) {
+    return EnqueueWithAffinity(
+        thread_pool, ThreadPool::kNoAffinity, std::forward<Args>(args)...);
+  }
+
+  // See ThreadPool::Enqueue for affinity details.
+  template <class... Args>
+  bool EnqueueWithAffinity(ThreadPool* thread_pool, size_t affinity, Args&&... args) {
     WrappedTask* task = nullptr;
     if (queue_.pop(task)) {
       task->pool = this;
       new (&task->storage) Task(std::forward<Args>(args)...);
-      thread_pool->Enqueue(task);
+      thread_pool->Enqueue(task, affinity);
       return true;
     } else {
       return false;
@@ -112,12 +112,13 @@ Status TcpStream::DoWrite() {
 
   // If we weren't waiting write to be ready, we could try to write data to socket.
   while (!sending_.empty()) {
-    const size_t kMaxIov = 16;
-    iovec iov[kMaxIov];
-    const int iov_len = static_cast<int>(std::min(kMaxIov, sending_.size()));
+    // Send all calls queued during the reactor loop iteration, including responses with
+    // sidecars that take several iovecs, with a single syscall.
+    iovec iov[kMaxIovPerWrite];
+    const int iov_len = static_cast<int>(std::min(kMaxIovPerWrite, sending_.size()));
     size_t offset = send_position_;
     for (auto i = 0; i != iov_len; ++i) {
-      iov[i].iov_base = sending_[i].data() + offset;
+      iov[i].iov_base = const_cast<uint8_t*>(sending_[i].data() + offset);
       iov[i].iov_len = sending_[i].size() - offset;
       offset = 0;
     }
@@ -17,6 +17,7 @@
 #include <ev++.h>
 
 #include "yb/rpc/growable_buffer.h"
+#include "yb/rpc/outbound_data.h"
 #include "yb/rpc/stream.h"
 
 #include "yb/util/net/socket.h"
@@ -56,6 +57,10 @@ class TcpStream : public Stream {
     return StaticProtocol();
   }
 
+  GrowableBuffer* ReadBuffer() override {
+    return &read_buffer_;
+  }
+
   void ParseReceived() override;
 
   CHECKED_STATUS DoWrite();
@@ -103,7 +108,7 @@ class TcpStream : public Stream {
   bool read_buffer_full_ = false;
 
   // sending_* contain bytes and calls we are currently sending to socket
-  std::deque<RefCntBuffer> sending_;
+  OutboundSlices sending_;
   std::deque<OutboundDataPtr> sending_outbound_datas_;
   size_t send_position_ = 0;
   bool waiting_write_ready_ = false;
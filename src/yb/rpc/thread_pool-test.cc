@@ -208,5 +208,111 @@ TEST_F(ThreadPoolTest, TestShutdown) {
   }
 }
 
+ThreadPoolOptions WorkStealingOptions(size_t queue_limit, size_t workers, size_t groups) {
+  ThreadPoolOptions options{"test", queue_limit, workers};
+  options.work_stealing_groups = groups;
+  return options;
+}
+
+TEST_F(ThreadPoolTest, TestWorkStealingMultiProducers) {
+  constexpr size_t kTotalTasks = 10000;
+  constexpr size_t kTotalWorkers = 8;
+  constexpr size_t kGroups = 3;
+  constexpr size_t kProducers = 4;
+  ThreadPool pool(WorkStealingOptions(kTotalTasks, kTotalWorkers, kGroups));
+
+  CountDownLatch latch(kTotalTasks);
+  std::vector<TestTask> tasks(kTotalTasks);
+  std::vector<std::thread> threads;
+  size_t begin = 0;
+  for (size_t i = 0; i != kProducers; ++i) {
+    size_t end = kTotalTasks * (i + 1) / kProducers;
+    threads.emplace_back([&pool, &latch, &tasks, begin, end, i] {
+      for (size_t j = begin; j != end; ++j) {
+        tasks[j].SetLatch(&latch);
+        ASSERT_TRUE(pool.Enqueue(&tasks[j], i));
+      }
+    });
+    begin = end;
+  }
+  latch.Wait();
+  for (auto& task : tasks) {
+    ASSERT_TRUE(task.IsCompleted());
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+class BlockingTask final : public ThreadPoolTask {
+ public:
+  explicit BlockingTask(CountDownLatch* started, CountDownLatch* release)
+      : started_(started), release_(release) {}
+
+ private:
+  void Run() override {
+    started_->CountDown();
+    release_->Wait();
+  }
+
+  void Done(const Status& status) override {}
+
+  CountDownLatch* started_;
+  CountDownLatch* release_;
+};
+
+// Check that task queued to a busy worker is stolen by an idle one.
+TEST_F(ThreadPoolTest, TestWorkStealingSteal) {
+  constexpr size_t kGroups = 2;
+  ThreadPool pool(WorkStealingOptions(100, kGroups, kGroups));
+
+  CountDownLatch started(1);
+  CountDownLatch release(1);
+  BlockingTask blocking_task(&started, &release);
+  ASSERT_TRUE(pool.Enqueue(&blocking_task, 0));
+  started.Wait();
+
+  // Group 0 consists of the single worker, that is blocked now.
+  CountDownLatch latch(1);
+  TestTask task;
+  task.SetLatch(&latch);
+  ASSERT_TRUE(pool.Enqueue(&task, 0));
+  ASSERT_TRUE(latch.WaitFor(MonoDelta::FromSeconds(10)));
+  ASSERT_TRUE(task.IsCompleted());
+
+  release.CountDown();
+  pool.Shutdown();
+}
+
+TEST_F(ThreadPoolTest, TestWorkStealingShutdown) {
+  constexpr size_t kTotalTasks = 10000;
+  constexpr size_t kTotalWorkers = 4;
+  constexpr size_t kProducers = 4;
+  ThreadPool pool(WorkStealingOptions(kTotalTasks, kTotalWorkers, 2));
+
+  CountDownLatch latch(kTotalTasks);
+  std::vector<TestTask> tasks(kTotalTasks);
+  std::vector<std::thread> threads;
+  size_t begin = 0;
+  for (size_t i = 0; i != kProducers; ++i) {
+    size_t end = kTotalTasks * (i + 1) / kProducers;
+    threads.emplace_back([&pool, &latch, &tasks, begin, end] {
+      for (size_t i = begin; i != end; ++i) {
+        tasks[i].SetLatch(&latch);
+        pool.Enqueue(&tasks[i], i);
+      }
+    });
+    begin = end;
+  }
+  pool.Shutdown();
+  latch.Wait();
+  for (auto& task : tasks) {
+    ASSERT_TRUE(task.IsDone());
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 } // namespace rpc
 } // namespace yb
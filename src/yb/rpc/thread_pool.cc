@@ -15,18 +15,39 @@
 
 #include "yb/rpc/thread_pool.h"
 
+#include <algorithm>
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include <boost/lockfree/queue.hpp>
 #include <boost/scope_exit.hpp>
 
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+#include "yb/util/os-util.h"
+#include "yb/util/random_util.h"
 #include "yb/util/thread.h"
 
+DEFINE_bool(rpc_numa_affinity, false,
+            "Bind reactor threads and workers of work stealing RPC thread pools to NUMA nodes, "
+            "so calls received by a reactor are processed on the same node.");
+TAG_FLAG(rpc_numa_affinity, advanced);
+
 namespace yb {
 namespace rpc {
 
+class ThreadPool::Impl {
+ public:
+  virtual ~Impl() {}
+
+  virtual const ThreadPoolOptions& options() const = 0;
+  virtual bool Enqueue(ThreadPoolTask* task, size_t affinity) = 0;
+  virtual void Shutdown() = 0;
+};
+
 namespace {
 
 class Worker;
@@ -152,11 +173,9 @@ class Worker {
   bool added_to_waiting_workers_ = false;
 };
 
-} // namespace
-
-class ThreadPool::Impl {
+class SharedQueueThreadPool : public ThreadPool::Impl {
  public:
-  explicit Impl(ThreadPoolOptions options)
+  explicit SharedQueueThreadPool(ThreadPoolOptions options)
       : share_(std::move(options)),
         queue_full_status_(STATUS_SUBSTITUTE(ServiceUnavailable,
                                              "Queue is full, max items: $0",
@@ -167,11 +186,11 @@ class ThreadPool::Impl {
     }
   }
 
-  const ThreadPoolOptions& options() const {
+  const ThreadPoolOptions& options() const override {
     return share_.options;
   }
 
-  bool Enqueue(ThreadPoolTask* task) {
+  bool Enqueue(ThreadPoolTask* task, size_t affinity) override {
     ++adding_;
     if (closing_) {
       --adding_;
@@ -206,7 +225,7 @@ class ThreadPool::Impl {
     return true;
   }
 
-  void Shutdown() {
+  void Shutdown() override {
     // Block creating new workers.
     created_workers_ += workers_.size();
     {
@@ -247,8 +266,399 @@ class ThreadPool::Impl {
   const Status queue_full_status_;
 };
 
-ThreadPool::ThreadPool(ThreadPoolOptions options)
-    : impl_(new Impl(std::move(options))) {
+class WorkStealingThreadPool;
+
+// Metric prototypes for a worker of work stealing pool.
+// Metric system expects prototypes to live forever, so they are created once for each pool name
+// and worker index, and never destroyed.
+struct WorkerMetricPrototypes {
+  std::string queue_depth_name;
+  std::string steals_name;
+  std::unique_ptr<GaugePrototype<int64_t>> queue_depth;
+  std::unique_ptr<CounterPrototype> steals;
+};
+
+const WorkerMetricPrototypes& GetWorkerMetricPrototypes(const std::string& pool, size_t index) {
+  static std::mutex mutex;
+  static auto* prototypes =
+      new std::unordered_map<std::string, std::unique_ptr<WorkerMetricPrototypes>>();
+
+  auto prefix = strings::Substitute("rpc_tp_$0_$1", pool, index);
+  std::replace(prefix.begin(), prefix.end(), '-', '_');
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& result = (*prototypes)[prefix];
+  if (!result) {
+    result.reset(new WorkerMetricPrototypes);
+    result->queue_depth_name = prefix + "_queue_depth";
+    result->steals_name = prefix + "_steals";
+    result->queue_depth.reset(new GaugePrototype<int64_t>(MetricPrototype::CtorArgs(
+        "server", result->queue_depth_name.c_str(), "RPC Worker Queue Depth",
+        MetricUnit::kTasks, "Number of tasks waiting in the queue of the rpc worker")));
+    result->steals.reset(new CounterPrototype(MetricPrototype::CtorArgs(
+        "server", result->steals_name.c_str(), "RPC Worker Steals",
+        MetricUnit::kTasks, "Number of tasks the rpc worker stole from queues of other workers")));
+  }
+  return *result;
+}
+
+// Worker of the work stealing pool.
+// Each worker has its own task queue. Tasks are taken from the front of the own queue, and stolen
+// from the back of queues of other workers when the own queue is empty.
+class StealingWorker {
+ public:
+  StealingWorker(WorkStealingThreadPool* pool, size_t index)
+      : pool_(pool), index_(index) {
+  }
+
+  ~StealingWorker() {
+    Join();
+  }
+
+  StealingWorker(const StealingWorker& worker) = delete;
+  void operator=(const StealingWorker& worker) = delete;
+
+  void Start(const std::string& pool_name, MetricEntity* metric_entity);
+
+  void Stop() {
+    stop_requested_ = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    cond_.notify_one();
+  }
+
+  void Join() {
+    if (thread_) {
+      thread_->Join();
+      thread_ = nullptr;
+    }
+  }
+
+  void Push(ThreadPoolTask* task) {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.push_back(task);
+      size_.fetch_add(1, std::memory_order_release);
+    }
+    if (queue_depth_) {
+      queue_depth_->Increment();
+    }
+  }
+
+  // Wakes up the worker if it waits for a task.
+  // Returns false if worker is busy, so task will not be picked up until it completes the current
+  // one, or another worker steals it.
+  bool WakeUp() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!waiting_task_) {
+      return false;
+    }
+    cond_.notify_one();
+    return true;
+  }
+
+  // Invoked for worker popped from the waiting workers queue. See Worker::Notify for details.
+  bool Notify() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    added_to_waiting_workers_ = false;
+    if (!waiting_task_) {
+      return false;
+    }
+    cond_.notify_one();
+    return true;
+  }
+
+  size_t size() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  // Pops task from the front or back of the queue. Back is used for stealing, so owner and thief
+  // pick different tasks and the oldest tasks are processed first by the owner.
+  bool Pop(bool front, ThreadPoolTask** task) {
+    if (size() == 0) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      if (queue_.empty()) {
+        return false;
+      }
+      if (front) {
+        *task = queue_.front();
+        queue_.pop_front();
+      } else {
+        *task = queue_.back();
+        queue_.pop_back();
+      }
+      size_.fetch_sub(1, std::memory_order_release);
+    }
+    if (queue_depth_) {
+      queue_depth_->Decrement();
+    }
+    return true;
+  }
+
+ private:
+  void Execute();
+  bool PopTask(ThreadPoolTask** task);
+  bool TakeTask(ThreadPoolTask** task);
+  void AddToWaitingWorkers();
+
+  WorkStealingThreadPool* const pool_;
+  const size_t index_;
+  scoped_refptr<yb::Thread> thread_;
+
+  std::mutex queue_mutex_;
+  std::deque<ThreadPoolTask*> queue_;
+  std::atomic<size_t> size_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::atomic<bool> stop_requested_ = {false};
+  bool waiting_task_ = false;
+  bool added_to_waiting_workers_ = false;
+
+  scoped_refptr<AtomicGauge<int64_t>> queue_depth_;
+  scoped_refptr<Counter> steals_;
+};
+
+// Thread pool where every worker has its own queue, and idle workers steal tasks from busy ones.
+//
+// Workers are split into groups, so tasks with the same affinity, for instance calls received by
+// the same reactor, are processed by the same subset of workers. This reduces contention on
+// the queues and keeps data used by the task in caches of the cores that run those workers.
+class WorkStealingThreadPool : public ThreadPool::Impl {
+ public:
+  explicit WorkStealingThreadPool(ThreadPoolOptions options)
+      : options_(std::move(options)),
+        num_groups_(std::max<size_t>(
+            1, std::min(options_.work_stealing_groups, options_.max_workers))),
+        waiting_workers_(options_.max_workers),
+        queue_full_status_(STATUS_SUBSTITUTE(ServiceUnavailable,
+                                             "Queue is full, max items: $0",
+                                             options_.queue_limit)) {
+    CHECK_GT(options_.max_workers, 0);
+    workers_.reserve(options_.max_workers);
+    for (size_t i = 0; i != options_.max_workers; ++i) {
+      workers_.emplace_back(new StealingWorker(this, i));
+    }
+    for (auto& worker : workers_) {
+      worker->Start(options_.name, options_.metric_entity);
+    }
+  }
+
+  const ThreadPoolOptions& options() const override {
+    return options_;
+  }
+
+  bool Enqueue(ThreadPoolTask* task, size_t affinity) override {
+    ++adding_;
+    if (closing_) {
+      --adding_;
+      task->Done(shutdown_status_);
+      return false;
+    }
+    if (queued_.fetch_add(1, std::memory_order_acq_rel) >= options_.queue_limit) {
+      queued_.fetch_sub(1, std::memory_order_acq_rel);
+      --adding_;
+      task->Done(queue_full_status_);
+      return false;
+    }
+    auto* worker = ChooseWorker(affinity);
+    worker->Push(task);
+
+    // Workers are accessed until the task is handed off, so Shutdown should wait for this.
+    if (!worker->WakeUp()) {
+      // Chosen worker is busy, so wake up an idle worker, that will steal the task.
+      StealingWorker* idle_worker = nullptr;
+      while (waiting_workers_.pop(idle_worker)) {
+        if (idle_worker->Notify()) {
+          break;
+        }
+      }
+    }
+    --adding_;
+    return true;
+  }
+
+  void Shutdown() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closing_) {
+        CHECK(workers_.empty());
+        return;
+      }
+      closing_ = true;
+    }
+    for (auto& worker : workers_) {
+      worker->Stop();
+    }
+    // See SharedQueueThreadPool::Shutdown for details.
+    while (adding_ != 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // Running workers steal from queues of each other, so all of them should be joined before
+    // queues are drained and workers_ is modified.
+    for (auto& worker : workers_) {
+      worker->Join();
+    }
+    for (auto& worker : workers_) {
+      ThreadPoolTask* task = nullptr;
+      while (worker->Pop(/* front= */ true, &task)) {
+        TaskTaken();
+        task->Done(shutdown_status_);
+      }
+    }
+    workers_.clear();
+  }
+
+  bool PushWaitingWorker(StealingWorker* worker) {
+    return waiting_workers_.bounded_push(worker);
+  }
+
+  // Steals task for the worker with the specified index. Workers of the same group are checked
+  // first.
+  bool Steal(size_t thief, ThreadPoolTask** task) {
+    if (queued_.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    const size_t num_workers = workers_.size();
+    for (size_t delta = num_groups_; delta < num_workers; delta += num_groups_) {
+      if (workers_[(thief + delta) % num_workers]->Pop(/* front= */ false, task)) {
+        return true;
+      }
+    }
+    for (size_t delta = 1; delta < num_workers; ++delta) {
+      if (delta % num_groups_ != 0 &&
+          workers_[(thief + delta) % num_workers]->Pop(/* front= */ false, task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void TaskTaken() {
+    queued_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  size_t num_groups() const {
+    return num_groups_;
+  }
+
+ private:
+  // Picks less loaded of two random workers from the group that corresponds to affinity.
+  StealingWorker* ChooseWorker(size_t affinity) {
+    if (affinity == ThreadPool::kNoAffinity) {
+      affinity = next_group_.fetch_add(1, std::memory_order_relaxed);
+    }
+    const size_t group = affinity % num_groups_;
+    const size_t group_size = (workers_.size() - group + num_groups_ - 1) / num_groups_;
+    auto random_worker = [this, group, group_size] {
+      return workers_[group + RandomUniformInt<size_t>(0, group_size - 1) * num_groups_].get();
+    };
+    auto* first = random_worker();
+    if (group_size == 1 || first->size() == 0) {
+      return first;
+    }
+    auto* second = random_worker();
+    return second->size() < first->size() ? second : first;
+  }
+
+  const ThreadPoolOptions options_;
+  const size_t num_groups_;
+  std::vector<std::unique_ptr<StealingWorker>> workers_;
+  boost::lockfree::queue<StealingWorker*> waiting_workers_;
+  std::atomic<size_t> next_group_{0};
+  // Number of tasks waiting in the queues of all workers.
+  std::atomic<size_t> queued_{0};
+  std::mutex mutex_;
+  std::atomic<bool> closing_ = {false};
+  std::atomic<size_t> adding_ = {0};
+  const Status shutdown_status_ = STATUS(Aborted, "Service is shutting down");
+  const Status queue_full_status_;
+};
+
+void StealingWorker::Start(const std::string& pool_name, MetricEntity* metric_entity) {
+  if (metric_entity) {
+    scoped_refptr<MetricEntity> entity(metric_entity);
+    const auto& prototypes = GetWorkerMetricPrototypes(pool_name, index_);
+    queue_depth_ = prototypes.queue_depth->Instantiate(entity, 0);
+    steals_ = prototypes.steals->Instantiate(entity);
+  }
+  auto name = strings::Substitute("rpc_tp_$0_$1", pool_name, index_);
+  CHECK_OK(yb::Thread::Create(kRpcThreadCategory, name, &StealingWorker::Execute, this, &thread_));
+}
+
+void StealingWorker::Execute() {
+  // Tasks with affinity N are queued to workers of group N % num_groups.
+  SetNumaAffinity(index_ % pool_->num_groups());
+  while (!stop_requested_) {
+    ThreadPoolTask* task = nullptr;
+    if (PopTask(&task)) {
+      task->Run();
+      task->Done(Status::OK());
+    }
+  }
+}
+
+bool StealingWorker::TakeTask(ThreadPoolTask** task) {
+  if (Pop(/* front= */ true, task)) {
+    pool_->TaskTaken();
+    return true;
+  }
+  if (pool_->Steal(index_, task)) {
+    pool_->TaskTaken();
+    if (steals_) {
+      steals_->Increment();
+    }
+    return true;
+  }
+  return false;
+}
+
+bool StealingWorker::PopTask(ThreadPoolTask** task) {
+  if (TakeTask(task)) {
+    return true;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  waiting_task_ = true;
+  BOOST_SCOPE_EXIT(&waiting_task_) {
+      waiting_task_ = false;
+  } BOOST_SCOPE_EXIT_END;
+
+  while (!stop_requested_) {
+    AddToWaitingWorkers();
+
+    // Task could be queued before we were added to waiting workers, so nobody was notified
+    // about it. Same double check as in Worker::PopTask.
+    if (TakeTask(task)) {
+      return true;
+    }
+
+    cond_.wait(lock);
+
+    if (TakeTask(task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void StealingWorker::AddToWaitingWorkers() {
+  if (!added_to_waiting_workers_) {
+    auto pushed = pool_->PushWaitingWorker(this);
+    CHECK(pushed);
+    added_to_waiting_workers_ = true;
+  }
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(ThreadPoolOptions options) {
+  if (options.work_stealing_groups != 0) {
+    impl_.reset(new WorkStealingThreadPool(std::move(options)));
+  } else {
+    impl_.reset(new SharedQueueThreadPool(std::move(options)));
+  }
 }
 
 ThreadPool::ThreadPool(ThreadPool&& rhs)
@@ -272,7 +682,11 @@ bool ThreadPool::IsCurrentThreadRpcWorker() {
 }
 
 bool ThreadPool::Enqueue(ThreadPoolTask* task) {
-  return impl_->Enqueue(task);
+  return impl_->Enqueue(task, kNoAffinity);
+}
+
+bool ThreadPool::Enqueue(ThreadPoolTask* task, size_t affinity) {
+  return impl_->Enqueue(task, affinity);
 }
 
 void ThreadPool::Shutdown() {
@@ -283,5 +697,34 @@ const ThreadPoolOptions& ThreadPool::options() const {
   return impl_->options();
 }
 
+namespace {
+
+const std::vector<std::vector<int>>& NumaNodeCpus() {
+  static const std::vector<std::vector<int>> result = []() -> std::vector<std::vector<int>> {
+    auto nodes = GetNumaNodeCpus();
+    if (!nodes.ok()) {
+      LOG(WARNING) << "Unable to read NUMA topology: " << nodes.status();
+      return {};
+    }
+    LOG(INFO) << "Number of NUMA nodes: " << nodes->size();
+    return std::move(*nodes);
+  }();
+  return result;
+}
+
+} // namespace
+
+void SetNumaAffinity(size_t affinity) {
+  if (!FLAGS_rpc_numa_affinity || affinity == ThreadPool::kNoAffinity) {
+    return;
+  }
+  const auto& nodes = NumaNodeCpus();
+  if (nodes.size() < 2) {
+    return;
+  }
+  WARN_NOT_OK(SetCurrentThreadCpuAffinity(nodes[affinity % nodes.size()]),
+              "Unable to bind thread to NUMA node");
+}
+
 } // namespace rpc
 } // namespace yb
@@ -16,11 +16,13 @@
 #ifndef YB_RPC_THREAD_POOL_H
 #define YB_RPC_THREAD_POOL_H
 
+#include <limits>
 #include <memory>
 #include <string>
 
 namespace yb {
 
+class MetricEntity;
 class Status;
 
 namespace rpc {
@@ -40,10 +42,22 @@ struct ThreadPoolOptions {
   std::string name;
   size_t queue_limit;
   size_t max_workers;
+
+  // When non zero, every worker has its own task queue, and idle workers steal tasks from queues
+  // of busy workers. Workers are split into the specified number of groups, and task enqueued with
+  // affinity N is queued to a worker of group N % work_stealing_groups.
+  // All workers are started when pool is created in this mode.
+  size_t work_stealing_groups = 0;
+
+  // Entity for per worker queue depth and steal count metrics of work stealing pool.
+  // Used only while the pool is created.
+  MetricEntity* metric_entity = nullptr;
 };
 
 class ThreadPool {
  public:
+  static constexpr size_t kNoAffinity = std::numeric_limits<size_t>::max();
+
   explicit ThreadPool(ThreadPoolOptions options);
 
   template <class... Args>
@@ -60,16 +74,27 @@ class ThreadPool {
   const ThreadPoolOptions& options() const;
 
   bool Enqueue(ThreadPoolTask* task);
+
+  // Enqueues task preferring workers of group that corresponds to affinity, for instance index of
+  // the reactor that received the call. Affinity is ignored if work stealing is not enabled.
+  bool Enqueue(ThreadPoolTask* task, size_t affinity);
+
   void Shutdown();
 
   static bool IsCurrentThreadRpcWorker();
 
- private:
+  // Opaque implementation, that is defined in thread_pool.cc.
   class Impl;
 
+ private:
   std::unique_ptr<Impl> impl_;
 };
 
+// When --rpc_numa_affinity is set, binds the calling thread to CPUs of the NUMA node that
+// corresponds to the affinity, i.e. index of the reactor. So a reactor and workers of the group
+// that processes calls received by it run on the same NUMA node.
+void SetNumaAffinity(size_t affinity);
+
 } // namespace rpc
 } // namespace yb
 
@@ -0,0 +1,743 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/uring_stream.h"
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && __has_include(<linux/io_uring.h>)
+#define YB_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#else
+#define YB_HAS_IO_URING 0
+#endif
+
+#include "yb/rpc/outbound_data.h"
+#include "yb/rpc/tcp_stream.h"
+
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/string_util.h"
+
+using namespace std::literals;
+
+DEFINE_int32(rpc_io_uring_queue_depth, 1024,
+             "Number of submission queue entries in the io_uring of each reactor thread.");
+TAG_FLAG(rpc_io_uring_queue_depth, advanced);
+
+DECLARE_uint64(rpc_connection_timeout_ms);
+
+namespace yb {
+namespace rpc {
+
+#if YB_HAS_IO_URING
+
+namespace {
+
+int UringSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int UringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+// Features that UringStream relies on.
+// Fast poll makes the kernel wait for socket readiness instead of punting operations to worker
+// threads, no drop guarantees that completions are not lost when completion queue overflows.
+constexpr uint32_t kRequiredFeatures = IORING_FEAT_FAST_POLL | IORING_FEAT_NODROP;
+
+Status ErrnoStatus(const char* what, int err) {
+  return STATUS(NetworkError, what, ErrnoToString(err), err);
+}
+
+} // namespace
+
+// io_uring shared by all streams of a single reactor thread.
+//
+// Operations are queued to the submission ring by the streams and submitted to the kernel in a
+// batch before the event loop blocks. The ring fd is watched by the event loop, so completions
+// are dispatched to streams from the same reactor thread that handles all other events.
+class UringLoop {
+ public:
+  UringLoop() = default;
+
+  UringLoop(const UringLoop&) = delete;
+  void operator=(const UringLoop&) = delete;
+
+  ~UringLoop() {
+    LOG_IF(DFATAL, !deferred_.empty()) << "Destroying io_uring with pending completions";
+    io_.stop();
+    prepare_.stop();
+    if (sqes_) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  // Returns ring of the current reactor thread, creating it when necessary.
+  static Result<UringLoop*> ForCurrentThread(ev::loop_ref* loop) {
+    static thread_local std::unique_ptr<UringLoop> uring_loop;
+    if (!uring_loop) {
+      auto new_loop = std::make_unique<UringLoop>();
+      RETURN_NOT_OK(new_loop->Init(loop));
+      uring_loop = std::move(new_loop);
+    }
+    DCHECK(uring_loop->loop_ == loop->raw_loop) << "Reactor thread uses several event loops";
+    return uring_loop.get();
+  }
+
+  // Queues operation to the submission ring. The operation is described by fill, that should
+  // setup all sqe fields except user_data, which is used to route completion back to the stream.
+  template <class F>
+  CHECKED_STATUS Queue(UringStream* stream, UringStream::OpType type, const F& fill) {
+    auto* sqe = VERIFY_RESULT(NextSqe());
+    memset(sqe, 0, sizeof(*sqe));
+    fill(sqe);
+    sqe->user_data = reinterpret_cast<uint64_t>(stream) | static_cast<uint64_t>(type);
+    ++stream->ops_in_flight_;
+    return Status::OK();
+  }
+
+  // Blocks until all operations of the specified stream are completed.
+  // Completions of other streams that are reaped meanwhile are dispatched later, from the event
+  // loop.
+  void WaitCompleted(UringStream* stream) {
+    auto status = Flush();
+    LOG_IF(DFATAL, !status.ok()) << "Failed to submit io_uring operations: " << status;
+
+    auto it = deferred_.begin();
+    while (it != deferred_.end()) {
+      if (StreamOf(it->user_data) == stream) {
+        --stream->ops_in_flight_;
+        it = deferred_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    while (stream->ops_in_flight_ != 0) {
+      io_uring_cqe cqe;
+      if (!ReapOne(&cqe)) {
+        int ret = UringEnter(fd_, 0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR) {
+          LOG(DFATAL) << "Failed to wait for io_uring completions: " << ErrnoToString(errno);
+          return;
+        }
+        continue;
+      }
+      if (StreamOf(cqe.user_data) == stream) {
+        --stream->ops_in_flight_;
+      } else {
+        deferred_.push_back(cqe);
+      }
+    }
+  }
+
+ private:
+  CHECKED_STATUS Init(ev::loop_ref* loop) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = UringSetup(FLAGS_rpc_io_uring_queue_depth, &params);
+    if (fd_ < 0) {
+      return ErrnoStatus("io_uring_setup failed", errno);
+    }
+    if ((params.features & kRequiredFeatures) != kRequiredFeatures) {
+      return STATUS_FORMAT(NotSupported, "io_uring features not supported: $0", params.features);
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = Map(sq_ring_size_, IORING_OFF_SQ_RING);
+    if (!sq_ring_) {
+      return ErrnoStatus("Failed to map io_uring submission ring", errno);
+    }
+    cq_ring_ = single_mmap ? sq_ring_ : Map(cq_ring_size_, IORING_OFF_CQ_RING);
+    if (!cq_ring_) {
+      return ErrnoStatus("Failed to map io_uring completion ring", errno);
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(Map(sqes_size_, IORING_OFF_SQES));
+    if (!sqes_) {
+      return ErrnoStatus("Failed to map io_uring submission entries", errno);
+    }
+
+    auto* sq = static_cast<uint8_t*>(sq_ring_);
+    sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_flags_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.flags);
+    sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    sq_local_tail_ = *sq_tail_;
+
+    auto* cq = static_cast<uint8_t*>(cq_ring_);
+    cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    loop_ = loop->raw_loop;
+    io_.set(*loop);
+    io_.set<UringLoop, &UringLoop::IoHandler>(this);
+    io_.start(fd_, ev::READ);
+    prepare_.set(*loop);
+    prepare_.set<UringLoop, &UringLoop::PrepareHandler>(this);
+    prepare_.start();
+
+    LOG(INFO) << "Started io_uring with " << params.sq_entries << " entries, features: "
+              << params.features;
+
+    return Status::OK();
+  }
+
+  void* Map(size_t size, off_t offset) {
+    void* result = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+    return result == MAP_FAILED ? nullptr : result;
+  }
+
+  static UringStream* StreamOf(uint64_t user_data) {
+    return reinterpret_cast<UringStream*>(user_data & ~kTypeMask);
+  }
+
+  static UringStream::OpType TypeOf(uint64_t user_data) {
+    return static_cast<UringStream::OpType>(user_data & kTypeMask);
+  }
+
+  Result<io_uring_sqe*> NextSqe() {
+    if (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+      // Submission ring is full, so we have to submit queued entries right now.
+      RETURN_NOT_OK(Flush());
+      if (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+        return STATUS(ServiceUnavailable, "io_uring submission queue is full");
+      }
+    }
+    auto index = sq_local_tail_ & sq_mask_;
+    sq_array_[index] = index;
+    ++sq_local_tail_;
+    ++pending_submit_;
+    return &sqes_[index];
+  }
+
+  // Submits all queued entries to the kernel.
+  CHECKED_STATUS Flush() {
+    if (pending_submit_ == 0) {
+      return Status::OK();
+    }
+    __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+    while (pending_submit_ != 0) {
+      int ret = UringEnter(fd_, pending_submit_, 0, 0);
+      if (ret < 0) {
+        int err = errno;
+        if (err == EINTR) {
+          continue;
+        }
+        if (err == EAGAIN || err == EBUSY) {
+          // Kernel is out of resources, or completion queue is overflown. Remaining entries will
+          // be submitted after completions are reaped.
+          return Status::OK();
+        }
+        return ErrnoStatus("io_uring_enter failed", err);
+      }
+      pending_submit_ -= std::min<uint32_t>(pending_submit_, ret);
+    }
+    return Status::OK();
+  }
+
+  bool ReapOne(io_uring_cqe* out) {
+    auto head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      return false;
+    }
+    *out = cqes_[head & cq_mask_];
+    // Completion is released before dispatching it, since handler could wait for other
+    // completions.
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  void Dispatch(const io_uring_cqe& cqe) {
+    auto* stream = StreamOf(cqe.user_data);
+    --stream->ops_in_flight_;
+    stream->Completed(TypeOf(cqe.user_data), cqe.res);
+  }
+
+  void DispatchDeferred() {
+    while (!deferred_.empty()) {
+      auto cqe = deferred_.front();
+      deferred_.pop_front();
+      Dispatch(cqe);
+    }
+  }
+
+  void IoHandler(ev::io& watcher, int revents) { // NOLINT
+    DispatchDeferred();
+    io_uring_cqe cqe;
+    for (;;) {
+      while (ReapOne(&cqe)) {
+        Dispatch(cqe);
+      }
+      if (!(__atomic_load_n(sq_flags_, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW)) {
+        break;
+      }
+      // Ask kernel to move overflown completions to the ring.
+      if (UringEnter(fd_, 0, 0, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+        LOG(DFATAL) << "Failed to flush io_uring completions: " << ErrnoToString(errno);
+        break;
+      }
+    }
+  }
+
+  void PrepareHandler(ev::prepare& watcher, int revents) { // NOLINT
+    // Completions deferred by WaitCompleted do not cause ring fd to become readable.
+    DispatchDeferred();
+    auto status = Flush();
+    LOG_IF(DFATAL, !status.ok()) << "Failed to submit io_uring operations: " << status;
+  }
+
+  static constexpr uint64_t kTypeMask = 7;
+
+  int fd_ = -1;
+  struct ev_loop* loop_ = nullptr;
+
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_flags_ = nullptr;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  // Tail including entries that were queued but not yet published to the kernel.
+  uint32_t sq_local_tail_ = 0;
+  uint32_t pending_submit_ = 0;
+
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  ev::io io_;
+  ev::prepare prepare_;
+
+  // Completions reaped while waiting for operations of a particular stream.
+  std::deque<io_uring_cqe> deferred_;
+};
+
+UringStream::UringStream(
+    const Endpoint& remote, Socket socket, GrowableBufferAllocator* allocator, size_t limit)
+    : socket_(std::move(socket)),
+      remote_(remote),
+      read_buffer_(allocator, limit) {
+  static_assert(alignof(UringStream) > 4, "Low bits of stream address are used for op type");
+}
+
+UringStream::~UringStream() {
+  // Must clear the outbound_transfers_ list before deleting.
+  CHECK(sending_.empty()) << ToString();
+
+  // Kernel could still access buffers of this stream, if some operations are in flight.
+  CHECK_EQ(ops_in_flight_, 0) << ToString();
+}
+
+bool UringStream::IsSupported() {
+  static const bool result = [] {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = UringSetup(1, &params);
+    if (fd < 0) {
+      LOG(INFO) << "io_uring is not supported: " << ErrnoToString(errno);
+      return false;
+    }
+    close(fd);
+    if ((params.features & kRequiredFeatures) != kRequiredFeatures) {
+      LOG(INFO) << "io_uring does not support required features: " << params.features;
+      return false;
+    }
+    return true;
+  }();
+  return result;
+}
+
+Status UringStream::Start(bool connect, ev::loop_ref* loop, StreamContext* context) {
+  context_ = context;
+  connected_ = !connect;
+  loop_ = VERIFY_RESULT(UringLoop::ForCurrentThread(loop));
+
+  RETURN_NOT_OK(socket_.SetNoDelay(true));
+  RETURN_NOT_OK(socket_.SetSendTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
+  RETURN_NOT_OK(socket_.SetRecvTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
+
+  if (connect) {
+    auto status = socket_.Connect(remote_);
+    if (!status.ok() && !Socket::IsTemporarySocketError(status)) {
+      LOG_WITH_PREFIX(WARNING) << "Connect failed: " << status;
+      return status;
+    }
+  }
+  RETURN_NOT_OK(socket_.GetSocketAddress(&local_));
+  log_prefix_.clear();
+
+  DVLOG_WITH_PREFIX(4) << "Starting, connect: " << connect << ", fd: " << socket_.GetFd();
+
+  if (!connected_) {
+    return loop_->Queue(this, OpType::kConnect, [this](io_uring_sqe* sqe) {
+      sqe->opcode = IORING_OP_POLL_ADD;
+      sqe->fd = socket_.GetFd();
+      sqe->poll_events = POLLOUT;
+    });
+  }
+
+  // Kernel completes operations on non blocking sockets with EAGAIN instead of waiting for
+  // readiness, so the socket is switched to blocking mode once it is connected.
+  RETURN_NOT_OK(socket_.SetNonBlocking(false));
+  context_->Connected();
+  return SubmitRead();
+}
+
+void UringStream::Close() {
+  if (socket_.GetFd() >= 0) {
+    auto status = socket_.Shutdown(true, true);
+    LOG_IF(INFO, !status.ok()) << "Failed to shutdown socket: " << status;
+  }
+}
+
+void UringStream::Shutdown(const Status& status) {
+  shutdown_ = true;
+
+  if (ops_in_flight_ != 0) {
+    // Shutting down the socket completes pending reads and writes, cancel is used for the
+    // connect poll and as a safety net.
+    if (socket_.GetFd() >= 0) {
+      WARN_NOT_OK(socket_.Shutdown(true, true), "Failed to shutdown socket");
+    }
+    for (auto type : {OpType::kConnect, OpType::kRead, OpType::kWrite}) {
+      auto target = reinterpret_cast<uint64_t>(this) | static_cast<uint64_t>(type);
+      WARN_NOT_OK(loop_->Queue(this, OpType::kCancel, [target](io_uring_sqe* sqe) {
+                    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                    sqe->fd = -1;
+                    sqe->addr = target;
+                  }),
+                  "Failed to cancel io_uring operation");
+    }
+    loop_->WaitCompleted(this);
+  }
+
+  ClearSending(status);
+
+  if (!read_buffer_.empty()) {
+    LOG_WITH_PREFIX(WARNING) << "Shutting down with pending inbound data ("
+                             << read_buffer_ << ", status = " << status << ")";
+  }
+
+  WARN_NOT_OK(socket_.Close(), "Error closing socket");
+}
+
+Status UringStream::TryWrite() {
+  return SubmitWrite();
+}
+
+Status UringStream::SubmitWrite() {
+  if (!connected_ || write_in_flight_ || shutdown_ || sending_.empty()) {
+    return Status::OK();
+  }
+
+  write_iov_.resize(std::min(kMaxIovPerWrite, sending_.size()));
+  size_t offset = send_position_;
+  for (size_t i = 0; i != write_iov_.size(); ++i) {
+    write_iov_[i].iov_base = const_cast<uint8_t*>(sending_[i].data() + offset);
+    write_iov_[i].iov_len = sending_[i].size() - offset;
+    offset = 0;
+  }
+
+  RETURN_NOT_OK(loop_->Queue(this, OpType::kWrite, [this](io_uring_sqe* sqe) {
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = socket_.GetFd();
+    sqe->addr = reinterpret_cast<uint64_t>(write_iov_.data());
+    sqe->len = static_cast<uint32_t>(write_iov_.size());
+  }));
+  write_in_flight_ = true;
+  return Status::OK();
+}
+
+Status UringStream::SubmitRead() {
+  if (read_in_flight_ || shutdown_) {
+    return Status::OK();
+  }
+
+  auto iov = read_buffer_.PrepareAppend();
+  if (!iov.ok()) {
+    if (iov.status().IsBusy()) {
+      // Read is resubmitted by ParseReceived, when there is space in the read buffer.
+      read_buffer_full_ = true;
+      return Status::OK();
+    }
+    return iov.status();
+  }
+  read_buffer_full_ = false;
+  read_iov_ = std::move(*iov);
+
+  RETURN_NOT_OK(loop_->Queue(this, OpType::kRead, [this](io_uring_sqe* sqe) {
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = socket_.GetFd();
+    sqe->addr = reinterpret_cast<uint64_t>(read_iov_.data());
+    sqe->len = static_cast<uint32_t>(read_iov_.size());
+  }));
+  read_in_flight_ = true;
+  return Status::OK();
+}
+
+void UringStream::Completed(OpType type, int res) {
+  DVLOG_WITH_PREFIX(3) << "Completed(type=" << static_cast<int>(type) << ", res=" << res << ")";
+
+  switch (type) {
+    case OpType::kConnect: {
+      if (shutdown_) {
+        return;
+      }
+      auto status = ConnectCompleted(res);
+      if (!status.ok()) {
+        context_->Destroy(status);
+      }
+      return;
+    }
+    case OpType::kRead:
+      read_in_flight_ = false;
+      if (shutdown_) {
+        return;
+      }
+      {
+        auto status = ReadCompleted(res);
+        if (!status.ok()) {
+          context_->Destroy(status);
+        }
+      }
+      return;
+    case OpType::kWrite:
+      write_in_flight_ = false;
+      if (shutdown_) {
+        return;
+      }
+      {
+        auto status = WriteCompleted(res);
+        if (!status.ok()) {
+          context_->Destroy(status);
+        }
+      }
+      return;
+    case OpType::kCancel:
+      return;
+  }
+  LOG_WITH_PREFIX(FATAL) << "Unknown io_uring operation type: " << static_cast<int>(type);
+}
+
+Status UringStream::ConnectCompleted(int res) {
+  if (res < 0) {
+    return ErrnoStatus("Connect poll failed", -res);
+  }
+  RETURN_NOT_OK(socket_.GetSockError());
+  RETURN_NOT_OK(socket_.SetNonBlocking(false));
+  connected_ = true;
+  context_->Connected();
+  RETURN_NOT_OK(SubmitRead());
+  return SubmitWrite();
+}
+
+Status UringStream::ReadCompleted(int res) {
+  if (res < 0) {
+    if (res == -EAGAIN || res == -EINTR) {
+      return SubmitRead();
+    }
+    auto status = ErrnoStatus("Recv failed", -res);
+    YB_LOG_WITH_PREFIX_EVERY_N(INFO, 50) << " Recv failed: " << status;
+    return status;
+  }
+  if (res == 0) {
+    VLOG_WITH_PREFIX(1) << "Shut down by remote end.";
+    return STATUS(NetworkError, "Shut down by remote end", Slice(), ESHUTDOWN);
+  }
+
+  context_->UpdateLastActivity();
+  read_buffer_.DataAppended(res);
+  RETURN_NOT_OK(TryProcessReceived());
+  return SubmitRead();
+}
+
+Status UringStream::WriteCompleted(int res) {
+  if (res < 0) {
+    if (res == -EAGAIN || res == -EINTR) {
+      return SubmitWrite();
+    }
+    auto status = ErrnoStatus("Send failed", -res);
+    YB_LOG_WITH_PREFIX_EVERY_N(WARNING, 50) << "Send failed: " << status;
+    return status;
+  }
+
+  context_->UpdateLastActivity();
+  send_position_ += res;
+  while (!sending_.empty() && send_position_ >= sending_.front().size()) {
+    auto data = sending_outbound_datas_.front();
+    send_position_ -= sending_.front().size();
+    sending_.pop_front();
+    sending_outbound_datas_.pop_front();
+    if (data) {
+      context_->Transferred(data, Status::OK());
+    }
+  }
+
+  return SubmitWrite();
+}
+
+void UringStream::ParseReceived() {
+  auto status = TryProcessReceived();
+  if (status.ok() && read_buffer_full_) {
+    status = SubmitRead();
+  }
+  if (!status.ok()) {
+    context_->Destroy(status);
+  }
+}
+
+Status UringStream::TryProcessReceived() {
+  if (read_buffer_.empty()) {
+    return Status::OK();
+  }
+
+  auto consumed = VERIFY_RESULT(context_->ProcessReceived(
+      read_buffer_.AppendedVecs(), ReadBufferFull(read_buffer_.full())));
+
+  read_buffer_.Consume(consumed);
+  return Status::OK();
+}
+
+std::string UringStream::ToString() const {
+  return Format("{ local: $0 remote: $1 }", local_, remote_);
+}
+
+const std::string& UringStream::LogPrefix() const {
+  if (log_prefix_.empty()) {
+    log_prefix_ = ToString() + ": ";
+  }
+  return log_prefix_;
+}
+
+bool UringStream::Idle(std::string* reason_not_idle) {
+  bool result = true;
+  // Check if we're in the middle of receiving something.
+  if (!read_buffer_.empty()) {
+    if (reason_not_idle) {
+      AppendWithSeparator("read buffer not empty", reason_not_idle);
+    }
+    result = false;
+  }
+
+  // Check if we still need to send something.
+  if (!sending_.empty()) {
+    if (reason_not_idle) {
+      AppendWithSeparator("still sending", reason_not_idle);
+    }
+    result = false;
+  }
+
+  return result;
+}
+
+void UringStream::ClearSending(const Status& status) {
+  // Clear any outbound transfers.
+  for (auto& data : sending_outbound_datas_) {
+    if (data) {
+      context_->Transferred(data, status);
+    }
+  }
+  sending_outbound_datas_.clear();
+  sending_.clear();
+}
+
+void UringStream::Send(OutboundDataPtr data) {
+  // Serialize the actual bytes to be put on the wire.
+  data->Serialize(&sending_);
+
+  sending_outbound_datas_.resize(sending_.size());
+  sending_outbound_datas_.back() = std::move(data);
+}
+
+void UringStream::DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) {
+  auto call_in_flight = resp->add_calls_in_flight();
+  for (auto& data : sending_outbound_datas_) {
+    if (data && data->DumpPB(req, call_in_flight)) {
+      call_in_flight = resp->add_calls_in_flight();
+    }
+  }
+  resp->mutable_calls_in_flight()->DeleteSubrange(resp->calls_in_flight_size() - 1, 1);
+}
+
+const Protocol* UringStream::GetProtocol() {
+  return TcpStream::StaticProtocol();
+}
+
+StreamFactoryPtr UringStream::Factory() {
+  if (!IsSupported()) {
+    LOG(WARNING) << "io_uring is not available, falling back to libev based streams";
+    return TcpStream::Factory();
+  }
+
+  class UringStreamFactory : public StreamFactory {
+   private:
+    std::unique_ptr<Stream> Create(
+        const Endpoint& remote, Socket socket, GrowableBufferAllocator* allocator, size_t limit)
+            override {
+      return std::make_unique<UringStream>(remote, std::move(socket), allocator, limit);
+    }
+  };
+
+  return std::make_shared<UringStreamFactory>();
+}
+
+#else // YB_HAS_IO_URING
+
+bool UringStream::IsSupported() {
+  return false;
+}
+
+StreamFactoryPtr UringStream::Factory() {
+  LOG(WARNING) << "Built without io_uring support, falling back to libev based streams";
+  return TcpStream::Factory();
+}
+
+#endif // YB_HAS_IO_URING
+
+} // namespace rpc
+} // namespace yb
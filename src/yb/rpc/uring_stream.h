@@ -0,0 +1,143 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_URING_STREAM_H
+#define YB_RPC_URING_STREAM_H
+
+#include <ev++.h>
+
+#include "yb/rpc/growable_buffer.h"
+#include "yb/rpc/outbound_data.h"
+#include "yb/rpc/stream.h"
+
+#include "yb/util/net/socket.h"
+
+namespace yb {
+namespace rpc {
+
+class UringLoop;
+
+// Stream that performs socket reads and writes through io_uring instead of readiness
+// notifications.
+//
+// All streams of a reactor thread share a single ring. Operations queued while handling an event
+// loop iteration are submitted to the kernel with a single io_uring_enter call right before the
+// loop blocks, and completions are reaped in batches when the ring fd becomes readable.
+//
+// At most one read and one write are in flight for a stream at any time. New outbound data is
+// accumulated while a write is in flight, and is sent with the next writev.
+class UringStream : public Stream {
+ public:
+  UringStream(
+      const Endpoint& remote, Socket socket, GrowableBufferAllocator* allocator, size_t limit);
+  ~UringStream();
+
+  std::string ToString() const;
+
+  // Whether io_uring is supported by the running kernel.
+  static bool IsSupported();
+
+  // Returns factory that creates UringStream when io_uring is supported, and TcpStream otherwise.
+  // Since both of them use the same wire format, the tcp protocol is used for both.
+  static StreamFactoryPtr Factory();
+
+ private:
+  friend class UringLoop;
+
+  enum class OpType {
+    kConnect = 1,
+    kRead = 2,
+    kWrite = 3,
+    kCancel = 4,
+  };
+
+  CHECKED_STATUS Start(bool connect, ev::loop_ref* loop, StreamContext* context) override;
+  void Close() override;
+  void Shutdown(const Status& status) override;
+  void Send(OutboundDataPtr data) override;
+  CHECKED_STATUS TryWrite() override;
+  void ParseReceived() override;
+
+  bool Idle(std::string* reason_not_idle) override;
+  bool IsConnected() override { return connected_; }
+  void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) override;
+
+  const Endpoint& Remote() override { return remote_; }
+  const Endpoint& Local() override { return local_; }
+
+  const Protocol* GetProtocol() override;
+
+  GrowableBuffer* ReadBuffer() override {
+    return &read_buffer_;
+  }
+
+  // Invoked by the loop when operation of this stream completes, res is the kernel result of the
+  // operation, i.e. number of transferred bytes or negated errno.
+  void Completed(OpType type, int res);
+
+  CHECKED_STATUS ConnectCompleted(int res);
+  CHECKED_STATUS ReadCompleted(int res);
+  CHECKED_STATUS WriteCompleted(int res);
+
+  CHECKED_STATUS SubmitRead();
+  CHECKED_STATUS SubmitWrite();
+
+  // Try to parse received data and process it.
+  CHECKED_STATUS TryProcessReceived();
+
+  void ClearSending(const Status& status);
+
+  const std::string& LogPrefix() const;
+
+  // The socket we're communicating on.
+  Socket socket_;
+
+  // The local address we're talking from.
+  Endpoint local_;
+
+  // The remote address we're talking to.
+  const Endpoint remote_;
+
+  StreamContext* context_ = nullptr;
+
+  // Ring of the reactor thread that this stream was started on.
+  UringLoop* loop_ = nullptr;
+
+  mutable std::string log_prefix_;
+
+  bool connected_ = false;
+  bool shutdown_ = false;
+
+  // Number of submitted operations, that were not completed yet.
+  // The stream cannot be destroyed until all of them are completed, since kernel could access
+  // buffers owned by the stream.
+  size_t ops_in_flight_ = 0;
+  bool read_in_flight_ = false;
+  bool write_in_flight_ = false;
+
+  // Data received on this connection that has not been processed yet.
+  GrowableBuffer read_buffer_;
+  bool read_buffer_full_ = false;
+  IoVecs read_iov_;
+
+  // sending_* contain bytes and calls we are currently sending to socket
+  OutboundSlices sending_;
+  std::deque<OutboundDataPtr> sending_outbound_datas_;
+  size_t send_position_ = 0;
+  std::vector<iovec> write_iov_;
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_URING_STREAM_H
@@ -25,10 +25,12 @@
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/serialization.h"
 
+#include "yb/util/allocation_sampler.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/memory/memory.h"
+#include "yb/util/trace.h"
 
 using google::protobuf::io::CodedInputStream;
 using yb::operator"" _MB;
@@ -43,6 +45,12 @@ DECLARE_bool(rpc_dump_all_traces);
 DEFINE_int32(rpc_max_message_size, 255_MB,
              "The maximum size of a message of any RPC that the server will accept.");
 
+DEFINE_bool(rpc_zero_copy_inbound_calls, false,
+            "Parse inbound RPC calls directly from the connection read buffer, without copying "
+            "them. Blocks of read buffer are kept alive until all calls referencing them are "
+            "processed.");
+TAG_FLAG(rpc_zero_copy_inbound_calls, advanced);
+
 using std::placeholders::_1;
 DECLARE_int32(rpc_slow_query_threshold_ms);
 
@@ -68,7 +76,7 @@ class ConnectionHeader : public OutboundData {
     return false;
   }
 
-  void Serialize(std::deque<RefCntBuffer> *output) const override {
+  void Serialize(OutboundSlices* output) const override {
     output->push_back(buffer_);
   }
 
@@ -92,10 +100,11 @@ using google::protobuf::io::CodedOutputStream;
 
 YBConnectionContext::YBConnectionContext(
     GrowableBufferAllocator* allocator,
-    const MemTrackerPtr& call_tracker)
+    const MemTrackerPtr& call_tracker,
+    PinCallData pin_call_data)
     : ConnectionContextWithCallId(allocator),
       parser_(kMsgLengthPrefixLength, 0 /* size_offset */, FLAGS_rpc_max_message_size,
-              IncludeHeader::kFalse, this),
+              IncludeHeader::kFalse, this, pin_call_data),
       call_tracker_(call_tracker) {}
 
 YBConnectionContext::~YBConnectionContext() {}
@@ -107,6 +116,8 @@ size_t YBConnectionContext::BufferLimit() {
 Result<size_t> YBInboundConnectionContext::ProcessCalls(const ConnectionPtr& connection,
                                                         const IoVecs& data,
                                                         ReadBufferFull read_buffer_full) {
+  // Inbound calls are parsed here, so their memory is attributed to the call tracker.
+  ScopedAllocationAttribution allocation_attribution(call_tracker().get());
   if (state_ == RpcConnectionPB::NEGOTIATING) {
     // We assume that header is fully contained in the first block.
     if (data[0].iov_len < kConnectionHeaderSize) {
@@ -129,19 +140,36 @@ Result<size_t> YBInboundConnectionContext::ProcessCalls(const ConnectionPtr& con
   return parser().Parse(connection, data);
 }
 
+YBInboundConnectionContext::YBInboundConnectionContext(
+    GrowableBufferAllocator* allocator, const MemTrackerPtr& call_tracker)
+    : YBConnectionContext(
+          allocator, call_tracker, PinCallData(FLAGS_rpc_zero_copy_inbound_calls)) {
+}
+
 Status YBInboundConnectionContext::HandleCall(
     const ConnectionPtr& connection, std::vector<char>* call_data) {
-  auto reactor = connection->reactor();
-  DCHECK(reactor->IsCurrentThread());
+  auto call = std::make_shared<YBInboundCall>(connection, call_processed_listener());
+  return QueueCall(connection, call->ParseFrom(call_tracker(), call_data), call);
+}
 
+Status YBInboundConnectionContext::HandlePinnedCall(
+    const ConnectionPtr& connection, GrowableBufferBlockPtr block, const Slice& call_data) {
   auto call = std::make_shared<YBInboundCall>(connection, call_processed_listener());
+  return QueueCall(
+      connection, call->ParseFrom(call_tracker(), std::move(block), call_data), call);
+}
 
-  Status s = call->ParseFrom(call_tracker(), call_data);
-  if (!s.ok()) {
-    return s;
+Status YBInboundConnectionContext::QueueCall(
+    const ConnectionPtr& connection, const Status& parse_status,
+    const std::shared_ptr<YBInboundCall>& call) {
+  auto reactor = connection->reactor();
+  DCHECK(reactor->IsCurrentThread());
+
+  if (!parse_status.ok()) {
+    return parse_status;
   }
 
-  s = Store(call.get());
+  Status s = Store(call.get());
   if (!s.ok()) {
     return s;
   }
@@ -187,7 +215,21 @@ Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<ch
   consumption_ = ScopedTrackedConsumption(mem_tracker, call_data->size());
 
   request_data_.swap(*call_data);
-  Slice source(request_data_.data(), request_data_.size());
+  return ParseHeader(Slice(request_data_.data(), request_data_.size()));
+}
+
+Status YBInboundCall::ParseFrom(
+    const MemTrackerPtr& mem_tracker, GrowableBufferBlockPtr block, const Slice& call_data) {
+  TRACE_EVENT_FLOW_BEGIN0("rpc", "YBInboundCall", this);
+  TRACE_EVENT0("rpc", "YBInboundCall::ParseFrom");
+
+  consumption_ = ScopedTrackedConsumption(mem_tracker, 0);
+
+  request_block_ = std::move(block);
+  return ParseHeader(call_data);
+}
+
+Status YBInboundCall::ParseHeader(const Slice& source) {
   RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &serialized_request_));
 
   // Adopt the service/method info from the header as soon as it's available.
@@ -200,26 +242,51 @@ Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<ch
   }
   remote_method_.FromPB(header_.remote_method());
 
+  if (PREDICT_FALSE(header_.has_trace_context())) {
+    TraceContext caller;
+    caller.trace_id_high = header_.trace_context().trace_id_high();
+    caller.trace_id_low = header_.trace_context().trace_id_low();
+    caller.span_id = header_.trace_context().span_id();
+    trace_->set_context(caller.ChildSpan());
+  }
+
   return Status::OK();
 }
 
-Status YBInboundCall::AddRpcSidecar(RefCntBuffer car, int* idx) {
+Status YBInboundCall::CheckSidecarsLimit() {
   // Check that the number of sidecars does not exceed the number of payload
   // slices that are free.
-  if(sidecars_.size() >= CallResponse::kMaxSidecarSlices) {
+  if (sidecars_.size() >= CallResponse::kMaxSidecarSlices) {
     return STATUS(ServiceUnavailable, "All available sidecars already used");
   }
-  *idx = static_cast<int>(sidecars_.size());
-  if(consumption_) {
+  return Status::OK();
+}
+
+int YBInboundCall::DoAddRpcSidecar(OutboundSlice car) {
+  if (consumption_) {
     consumption_.Add(car.size());
   }
   sidecars_.push_back(std::move(car));
+  return static_cast<int>(sidecars_.size()) - 1;
+}
+
+Status YBInboundCall::AddRpcSidecar(RefCntBuffer car, int* idx) {
+  RETURN_NOT_OK(CheckSidecarsLimit());
+  *idx = DoAddRpcSidecar(std::move(car));
+  return Status::OK();
+}
 
+Status YBInboundCall::AddRpcSidecar(faststring* car, int* idx) {
+  RETURN_NOT_OK(CheckSidecarsLimit());
+  size_t size = car->size();
+  sidecars_storage_.emplace_back(car->release());
+  *idx = DoAddRpcSidecar(OutboundSlice(Slice(sidecars_storage_.back().get(), size)));
   return Status::OK();
 }
 
 void YBInboundCall::ResetRpcSidecars() {
   sidecars_.clear();
+  sidecars_storage_.clear();
 }
 
 Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLite& response,
@@ -312,7 +379,7 @@ void YBInboundCall::LogTrace() const {
   }
 }
 
-void YBInboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
+void YBInboundCall::Serialize(OutboundSlices* output) const {
   TRACE_EVENT0("rpc", "YBInboundCall::Serialize");
   CHECK_GT(response_buf_.size(), 0);
   output->push_back(response_buf_);
@@ -23,9 +23,12 @@
 namespace yb {
 namespace rpc {
 
+class YBInboundCall;
+
 class YBConnectionContext : public ConnectionContextWithCallId, public BinaryCallParserListener {
  public:
-  YBConnectionContext(GrowableBufferAllocator* allocator, const MemTrackerPtr& call_tracker);
+  YBConnectionContext(GrowableBufferAllocator* allocator, const MemTrackerPtr& call_tracker,
+                      PinCallData pin_call_data);
   ~YBConnectionContext();
 
   const MemTrackerPtr& call_tracker() const { return call_tracker_; }
@@ -45,13 +48,17 @@ class YBConnectionContext : public ConnectionContextWithCallId, public BinaryCal
 
 class YBInboundConnectionContext : public YBConnectionContext {
  public:
-  YBInboundConnectionContext(GrowableBufferAllocator* allocator, const MemTrackerPtr& call_tracker)
-      : YBConnectionContext(allocator, call_tracker) {}
+  YBInboundConnectionContext(GrowableBufferAllocator* allocator, const MemTrackerPtr& call_tracker);
 
   static std::string Name() { return "Inbound RPC"; }
  private:
   // Takes ownership of call_data content.
   CHECKED_STATUS HandleCall(const ConnectionPtr& connection, std::vector<char>* call_data) override;
+  CHECKED_STATUS HandlePinnedCall(
+      const ConnectionPtr& connection, GrowableBufferBlockPtr block,
+      const Slice& call_data) override;
+  CHECKED_STATUS QueueCall(const ConnectionPtr& connection, const Status& parse_status,
+                           const std::shared_ptr<YBInboundCall>& call);
   void Connected(const ConnectionPtr& connection) override;
   Result<size_t> ProcessCalls(const ConnectionPtr& connection,
                               const IoVecs& data,
@@ -84,6 +91,12 @@ class YBInboundCall : public InboundCall {
   // Takes ownership of call_data content.
   CHECKED_STATUS ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<char>* call_data);
 
+  // Parses call that references call_data in pinned read buffer block, without copying it.
+  // Memory of block is already tracked by read buffer allocator, so only sidecars are accounted
+  // in mem_tracker.
+  CHECKED_STATUS ParseFrom(const MemTrackerPtr& mem_tracker, GrowableBufferBlockPtr block,
+                           const Slice& call_data);
+
   int32_t call_id() const {
     return header_.call_id();
   }
@@ -94,6 +107,7 @@ class YBInboundCall : public InboundCall {
 
   // See RpcContext::AddRpcSidecar()
   CHECKED_STATUS AddRpcSidecar(RefCntBuffer car, int* idx);
+  CHECKED_STATUS AddRpcSidecar(faststring* car, int* idx);
 
   // See RpcContext::ResetRpcSidecars()
   void ResetRpcSidecars();
@@ -126,7 +140,7 @@ class YBInboundCall : public InboundCall {
 
   // Serialize the response packet for the finished call.
   // The resulting slices refer to memory in this object.
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(OutboundSlices* output) const override;
 
   void LogTrace() const override;
   std::string ToString() const override;
@@ -134,6 +148,14 @@ class YBInboundCall : public InboundCall {
 
   MonoTime GetClientDeadline() const override;
 
+  bool GetPriority(RequestHeader::Priority* priority) const override {
+    if (!header_.has_priority()) {
+      return false;
+    }
+    *priority = header_.priority();
+    return true;
+  }
+
   const std::string& method_name() const override {
     return remote_method_.method_name();
   }
@@ -149,7 +171,11 @@ class YBInboundCall : public InboundCall {
  protected:
   // Vector of additional sidecars that are tacked on to the call's response
   // after serialization of the protobuf. See rpc/rpc_sidecar.h for more info.
-  std::vector<RefCntBuffer> sidecars_;
+  std::vector<OutboundSlice> sidecars_;
+
+  // Memory of sidecars that were added from faststring. Referenced by sidecars_ and sent without
+  // copying, since this call is alive until its response is transferred.
+  std::vector<std::unique_ptr<uint8_t[]>> sidecars_storage_;
 
   // Serialize and queue the response.
   virtual void Respond(const google::protobuf::MessageLite& response, bool is_success);
@@ -161,6 +187,12 @@ class YBInboundCall : public InboundCall {
   CHECKED_STATUS SerializeResponseBuffer(const google::protobuf::MessageLite& response,
                                          bool is_success);
 
+  CHECKED_STATUS CheckSidecarsLimit();
+  int DoAddRpcSidecar(OutboundSlice car);
+
+  // Parses header of call, that is stored in source.
+  CHECKED_STATUS ParseHeader(const Slice& source);
+
   // The header of the incoming call. Set by ParseFrom()
   RequestHeader header_;
 
@@ -177,7 +209,7 @@ class YBInboundCall : public InboundCall {
 class YBOutboundConnectionContext : public YBConnectionContext {
  public:
   YBOutboundConnectionContext(GrowableBufferAllocator* allocator, const MemTrackerPtr& call_tracker)
-      : YBConnectionContext(allocator, call_tracker) {}
+      : YBConnectionContext(allocator, call_tracker, PinCallData::kFalse) {}
 
   static std::string Name() { return "Outbound RPC"; }
 
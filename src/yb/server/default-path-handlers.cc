@@ -59,17 +59,21 @@
 #endif
 
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/human_readable.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/server/pprof-path-handlers.h"
 #include "yb/server/webserver.h"
+#include "yb/util/allocation_sampler.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/histogram.pb.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/url-coding.h"
 
 DEFINE_int64(web_log_bytes, 1024 * 1024,
     "The maximum number of bytes to display on the debug webserver's log page");
@@ -177,7 +181,7 @@ static void MemTrackersHandler(const Webserver::WebRequest& req, std::stringstre
   *output << "<h1>Memory usage by subsystem</h1>\n";
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Id</th><th>Parent</th><th>Limit</th><th>Current Consumption</th>"
-      "<th>Peak consumption</th></tr>\n";
+      "<th>Peak consumption</th><th>Sampled allocations</th></tr>\n";
 
   vector<shared_ptr<MemTracker> > trackers = MemTracker::ListTrackers();
   for (const shared_ptr<MemTracker>& tracker : trackers) {
@@ -186,10 +190,71 @@ static void MemTrackersHandler(const Webserver::WebRequest& req, std::stringstre
                        HumanReadableNumBytes::ToString(tracker->limit());
     string current_consumption_str = HumanReadableNumBytes::ToString(tracker->consumption());
     string peak_consumption_str = HumanReadableNumBytes::ToString(tracker->peak_consumption());
+    const int64_t sampled_bytes = tracker->allocation_samples()->total_bytes();
+    string sampled_str = sampled_bytes == 0 ? "" : Substitute(
+        "<a href=\"/mem-tracker-allocations?tracker=$0\">$1</a>",
+        UrlEncodeToString(tracker->ToString()), HumanReadableNumBytes::ToString(sampled_bytes));
     (*output) << Substitute("  <tr><td>$0</td><td>$1</td><td>$2</td>" // id, parent, limit
-                            "<td>$3</td><td>$4</td></tr>\n", // current, peak
+                            "<td>$3</td><td>$4</td><td>$5</td></tr>\n", // current, peak, sampled
                             tracker->id(), parent, limit_str, current_consumption_str,
-                            peak_consumption_str);
+                            peak_consumption_str, sampled_str);
+  }
+  *output << "</table>\n";
+}
+
+// Registered to handle "/mem-tracker-allocations", and prints out the stacks that allocated most
+// of the sampled memory of a tracker.
+static void MemTrackerAllocationsHandler(const Webserver::WebRequest& req,
+                                         std::stringstream* output) {
+  const string tracker_name = FindWithDefault(req.parsed_args, "tracker", "");
+  shared_ptr<MemTracker> tracker;
+  for (const auto& candidate : MemTracker::ListTrackers()) {
+    if (candidate->ToString() == tracker_name) {
+      tracker = candidate;
+      break;
+    }
+  }
+  if (!tracker) {
+    *output << "Memory tracker not found: " << EscapeForHtmlToString(tracker_name);
+    return;
+  }
+  int limit = 20;
+  auto it = req.parsed_args.find("limit");
+  if (it != req.parsed_args.end() && (!safe_strto32(it->second, &limit) || limit <= 0)) {
+    *output << "Invalid 'limit' argument: " << EscapeForHtmlToString(it->second);
+    return;
+  }
+  auto* samples = tracker->allocation_samples();
+  if (ContainsKey(req.parsed_args, "reset")) {
+    samples->Reset();
+  }
+
+  *output << "<h1>Allocations of " << EscapeForHtmlToString(tracker_name) << "</h1>\n";
+  const int64_t interval = AllocationSamplingInterval();
+  if (interval == 0) {
+    *output << "<p>Allocation sampling is not running, allocations sampled before are shown. "
+               "See --mem_tracker_allocation_sampling_interval_bytes.</p>\n";
+  } else {
+    *output << Substitute("<p>Allocations are sampled once per $0 allocated by a thread, "
+                          "freed memory is not tracked. "
+                          "<a href=\"/mem-tracker-allocations?tracker=$1&reset=1\">Reset</a></p>\n",
+                          HumanReadableNumBytes::ToString(interval),
+                          UrlEncodeToString(tracker_name));
+  }
+  const int64_t total_bytes = samples->total_bytes();
+  *output << "<p>Estimated bytes allocated: " << HumanReadableNumBytes::ToString(total_bytes)
+          << "</p>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Bytes</th><th>Share</th><th>Allocations</th><th>Stack</th></tr>\n";
+  for (const auto& entry : samples->Top(limit)) {
+    const string stack = entry.stack.num_frames() == 0
+        ? "Other stacks" : entry.stack.Symbolize(StackTraceLineFormat::SYMBOL_ONLY);
+    *output << Substitute(
+        "  <tr><td>$0</td><td>$1%</td><td>$2</td><td><pre>$3</pre></td></tr>\n",
+        HumanReadableNumBytes::ToString(entry.bytes),
+        StringPrintf("%.1f", total_bytes ? entry.bytes * 100.0 / total_bytes : 0.0),
+        entry.count,
+        EscapeForHtmlToString(stack));
   }
   *output << "</table>\n";
 }
@@ -201,6 +266,8 @@ void AddDefaultPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/memz", "Memory (total)", MemUsageHandler, true, false);
   webserver->RegisterPathHandler("/mem-trackers", "Memory (detail)",
                                  MemTrackersHandler, true, false);
+  webserver->RegisterPathHandler("/mem-tracker-allocations", "",
+                                 MemTrackerAllocationsHandler, true, false);
 
   AddPprofPathHandlers(webserver);
 }
@@ -227,6 +294,10 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
       JsonWriter::COMPACT : JsonWriter::PRETTY;
   }
 
+  // When epoch is specified, only metrics modified since it are written, and output is wrapped
+  // into an object with the epoch that should be passed to the next request.
+  const string* epoch_param = FindOrNull(req.parsed_args, "epoch");
+
   JsonWriter writer(output, json_mode);
 
   if (requested_metrics_param != nullptr) {
@@ -236,8 +307,19 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
     requested_metrics.push_back("*");
   }
 
+  if (epoch_param != nullptr) {
+    opts.only_modified_in_or_after_epoch = ParseLeadingInt64Value(epoch_param->c_str(), 0);
+    writer.StartObject();
+    writer.String("epoch");
+    // Modifications made after this point are reported by the next request with this epoch.
+    writer.Int64(Metric::IncrementEpoch());
+    writer.String("metrics");
+  }
   WARN_NOT_OK(metrics->WriteAsJson(&writer, requested_metrics, opts),
               "Couldn't write JSON metrics over HTTP");
+  if (epoch_param != nullptr) {
+    writer.EndObject();
+  }
 }
 
 static void WriteForPrometheus(const MetricRegistry* const metrics,
@@ -91,6 +91,32 @@ TEST(MockHybridClockTest, TestMockedSystemClock) {
 }
 
 // Test that two subsequent time reads are monotonically increasing.
+// While the physical clock does not advance, the logical component overflows into microseconds,
+// and the error grows accordingly.
+TEST(MockHybridClockTest, TestLogicalOverflow) {
+  MockClock mock_clock;
+  PhysicalTime time = {1000, 10};
+  mock_clock.Set(time);
+  scoped_refptr<HybridClock> clock(new HybridClock(mock_clock.AsClock()));
+  ASSERT_OK(clock->Init());
+  const uint64_t kLogicalValues = HybridTime::kLogicalBitMask + 1;
+  for (uint64_t i = 0; i != 2 * kLogicalValues; ++i) {
+    HybridTime hybrid_time;
+    uint64_t max_error_usec;
+    clock->NowWithError(&hybrid_time, &max_error_usec);
+    const uint64_t micros = time.time_point + i / kLogicalValues;
+    ASSERT_EQ(HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(
+                  micros, i % kLogicalValues).ToUint64(),
+              hybrid_time.ToUint64()) << i;
+    ASSERT_EQ(micros - (time.time_point - time.max_error), max_error_usec) << i;
+  }
+
+  // Update with the max logical value also carries into microseconds.
+  clock->Update(HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(
+      2000, HybridTime::kLogicalBitMask));
+  ASSERT_EQ(HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(2001, 0), clock->Now());
+}
+
 TEST_F(HybridClockTest, TestNow_ValuesIncreaseMonotonically) {
   const HybridTime now1 = clock_->Now();
   const HybridTime now2 = clock_->Now();
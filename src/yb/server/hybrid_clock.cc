@@ -135,13 +135,13 @@ void HybridClock::NowWithError(HybridTime *hybrid_time, uint64_t *max_error_usec
   }
 
   // If the current time surpasses the last update just return it
-  HybridClockComponents current_components = components_.load(std::memory_order_acquire);
-  HybridClockComponents new_components = { now->time_point, 1 };
+  const HybridTimeRepr now_ht = HybridTimeFromMicroseconds(now->time_point).ToUint64();
+  HybridTimeRepr current = next_hybrid_time_.load(std::memory_order_acquire);
 
   // Loop over the check in case of concurrent updates making the CAS fail.
-  while (now->time_point > current_components.last_usec) {
-    if (components_.compare_exchange_weak(current_components, new_components)) {
-      *hybrid_time = HybridTimeFromMicroseconds(new_components.last_usec);
+  while (now_ht >= current) {
+    if (next_hybrid_time_.compare_exchange_weak(current, now_ht + 1)) {
+      *hybrid_time = HybridTime(now_ht);
       *max_error_usec = now->max_error;
       if (PREDICT_FALSE(VLOG_IS_ON(2))) {
         VLOG(2) << "Current clock is higher than the last one. Resetting logical values."
@@ -169,18 +169,15 @@ void HybridClock::NowWithError(HybridTime *hybrid_time, uint64_t *max_error_usec
   // This broadens the error interval for both cases but always returns
   // a correct error interval.
 
-  do {
-    new_components.last_usec = current_components.last_usec;
-    new_components.logical = current_components.logical + 1;
-    new_components.HandleLogicalComponentOverflow();
-    // Loop over the check until the CAS succeeds, in case there are concurrent updates.
-  } while (!components_.compare_exchange_weak(current_components, new_components));
+  // The stored value is already ahead of the physical clock, and could only grow, so taking the
+  // next logical value does not need a CAS.
+  *hybrid_time = HybridTime(next_hybrid_time_.fetch_add(1, std::memory_order_acq_rel));
+  if (PREDICT_FALSE(hybrid_time->GetLogicalValue() == HybridTime::kLogicalBitMask)) {
+    YB_LOG_EVERY_N_SECS(WARNING, 5) << "Logical component overflow: " << *hybrid_time;
+  }
 
-  *max_error_usec = new_components.last_usec - (now->time_point - now->max_error);
+  *max_error_usec = hybrid_time->GetPhysicalValueMicros() - (now->time_point - now->max_error);
 
-  // We've already atomically incremented the logical, so subtract 1.
-  *hybrid_time = HybridTimeFromMicrosecondsAndLogicalValue(
-      new_components.last_usec, new_components.logical).Decremented();
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
     VLOG(2) << "Current clock is lower than the last one. Returning last read and incrementing"
         " logical values. Hybrid time: " << *hybrid_time << " Error: " << *max_error_usec;
@@ -192,16 +189,11 @@ void HybridClock::Update(const HybridTime& to_update) {
     return;
   }
 
-  HybridClockComponents current_components = components_.load(std::memory_order_acquire);
-  HybridClockComponents new_components = {
-    GetPhysicalValueMicros(to_update), GetLogicalValue(to_update) + 1
-  };
-
-  new_components.HandleLogicalComponentOverflow();
+  HybridTimeRepr current = next_hybrid_time_.load(std::memory_order_acquire);
+  const HybridTimeRepr new_value = to_update.ToUint64() + 1;
 
   // Keep trying to CAS until it works or until HT has advanced past this update.
-  while (current_components < new_components &&
-      !components_.compare_exchange_weak(current_components, new_components)) {}
+  while (current < new_value && !next_hybrid_time_.compare_exchange_weak(current, new_value)) {}
 }
 
 // Used to get the hybrid_time for metrics.
@@ -218,21 +210,6 @@ uint64_t HybridClock::ErrorForMetrics() {
   return error;
 }
 
-void HybridClock::HybridClockComponents::HandleLogicalComponentOverflow() {
-  if (logical > HybridTime::kLogicalBitMask) {
-    static constexpr uint64_t kMaxOverflowValue = 1 << HybridTime::kBitsForLogicalComponent;
-    if (logical > kMaxOverflowValue) {
-      LOG(FATAL) << "Logical component is too high: last_usec=" << last_usec
-                 << "logical=" << logical << ", max allowed is " << kMaxOverflowValue;
-    }
-    YB_LOG_EVERY_N_SECS(WARNING, 5) << "Logical component overflow: "
-        << "last_usec=" << last_usec << ", logical=" << logical;
-
-    last_usec += logical >> HybridTime::kBitsForLogicalComponent;
-    logical &= HybridTime::kLogicalBitMask;
-  }
-}
-
 void HybridClock::RegisterMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
   METRIC_hybrid_clock_hybrid_time.InstantiateFunctionGauge(
       metric_entity,
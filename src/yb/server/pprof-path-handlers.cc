@@ -62,6 +62,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/webserver.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
@@ -260,6 +261,22 @@ static void PprofSymbolHandler(const Webserver::WebRequest& req, stringstream* o
       pieces.size(), invalid_addrs, missing_symbols);
 }
 
+// /profilez?seconds=XX returns samples of the continuous profiler taken during the last XX seconds,
+// in folded stacks format: "method;tablet;frame1;frame2;... count", suitable for flame graphs.
+static void ContinuousProfileHandler(const Webserver::WebRequest& req, stringstream* output) {
+  if (!ContinuousProfilerRunning()) {
+    (*output) << "Continuous profiler is not running, set --continuous_profiler_frequency_hz "
+              << "to enable it.";
+    return;
+  }
+  auto it = req.parsed_args.find("seconds");
+  int seconds = 60;
+  if (it != req.parsed_args.end()) {
+    seconds = atoi(it->second.c_str());
+  }
+  WriteContinuousProfile(MonoDelta::FromSeconds(seconds), output);
+}
+
 void AddPprofPathHandlers(Webserver* webserver) {
   // Path handlers for remote pprof profiling. For information see:
   // https://gperftools.googlecode.com/svn/trunk/doc/pprof_remote_servers.html
@@ -269,6 +286,7 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+  webserver->RegisterPathHandler("/profilez", "", ContinuousProfileHandler, false, false);
 }
 
 } // namespace yb
@@ -69,6 +69,11 @@ TAG_FLAG(rpc_server_allow_ephemeral_ports, unsafe);
 
 DEFINE_int32(rpc_queue_limit, 5000, "Queue limit for rpc server");
 DEFINE_int32(rpc_workers_limit, 128, "Workers limit for rpc server");
+DEFINE_bool(rpc_thread_pool_work_stealing, false,
+            "Use per worker queues with work stealing in rpc server thread pools. Workers are "
+            "split into groups by reactor, and calls prefer workers of the reactor that "
+            "received them.");
+TAG_FLAG(rpc_thread_pool_work_stealing, advanced);
 DECLARE_int32(rpc_default_keepalive_time_ms);
 
 namespace yb {
@@ -87,7 +92,6 @@ RpcServer::RpcServer(const std::string& name, RpcServerOptions opts,
     : name_(name),
       server_state_(UNINITIALIZED),
       options_(std::move(opts)),
-      normal_thread_pool_(CreateThreadPool(name, ServicePriority::kNormal)),
       connection_context_factory_(std::move(connection_context_factory)) {}
 
 RpcServer::~RpcServer() {
@@ -102,6 +106,7 @@ string RpcServer::ToString() const {
 Status RpcServer::Init(const shared_ptr<Messenger>& messenger) {
   CHECK_EQ(server_state_, UNINITIALIZED);
   messenger_ = messenger;
+  normal_thread_pool_ = CreateThreadPool(name_, ServicePriority::kNormal);
 
   RETURN_NOT_OK(HostPort::ParseStrings(options_.rpc_bind_addresses,
                                        options_.default_port,
@@ -182,7 +187,9 @@ Status RpcServer::Start() {
 }
 
 void RpcServer::Shutdown() {
-  normal_thread_pool_->Shutdown();
+  if (normal_thread_pool_) {
+    normal_thread_pool_->Shutdown();
+  }
   if (high_priority_thread_pool_) {
     high_priority_thread_pool_->Shutdown();
   }
@@ -202,7 +209,12 @@ unique_ptr<rpc::ThreadPool> RpcServer::CreateThreadPool(
   string name = priority == ServicePriority::kHigh ? Format("$0-high-pri", name_prefix)
                                                    : name_prefix;
   VLOG(1) << "Creating thread pool '" << name << "'";
-  return make_unique<rpc::ThreadPool>(name, options_.queue_limit, options_.workers_limit);
+  rpc::ThreadPoolOptions thread_pool_options{name, options_.queue_limit, options_.workers_limit};
+  if (FLAGS_rpc_thread_pool_work_stealing) {
+    thread_pool_options.work_stealing_groups = messenger_->num_reactors();
+    thread_pool_options.metric_entity = messenger_->metric_entity().get();
+  }
+  return make_unique<rpc::ThreadPool>(std::move(thread_pool_options));
 }
 
 } // namespace server
@@ -42,6 +42,8 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/server/webserver.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/span_recorder.h"
 
 namespace yb {
 
@@ -70,11 +72,20 @@ void RpczPathHandler(const shared_ptr<Messenger>& messenger,
   writer.Protobuf(dump_resp);
 }
 
+// Returns spans of sampled traces recorded since the previous request, so a collector that polls
+// this page periodically could assemble traces from spans of all servers.
+void SampledSpansPathHandler(const Webserver::WebRequest& req, stringstream* output) {
+  JsonWriter writer(output, JsonWriter::PRETTY);
+  WriteSpansAsJson(CollectRecordedSpans(), &writer);
+}
+
 } // anonymous namespace
 
 void AddRpczPathHandlers(const shared_ptr<Messenger>& messenger, Webserver* webserver) {
   webserver->RegisterPathHandler(
       "/rpcz", "RPCs", std::bind(RpczPathHandler, messenger, _1, _2), false, false);
+  webserver->RegisterPathHandler(
+      "/sampled-spans", "Sampled Spans", SampledSpansPathHandler, false, false);
 }
 
 } // namespace yb
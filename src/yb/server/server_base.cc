@@ -58,7 +58,9 @@
 #include "yb/server/skewed_clock.h"
 #include "yb/server/tracing-path-handlers.h"
 #include "yb/server/webserver.h"
+#include "yb/util/allocation_sampler.h"
 #include "yb/util/atomic.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
@@ -86,6 +88,13 @@ DEFINE_int32(generic_svc_queue_length, 50,
              "RPC Queue length for the generic service");
 TAG_FLAG(generic_svc_queue_length, advanced);
 
+DEFINE_int64(mem_tracker_allocation_sampling_interval_bytes, 0,
+             "When positive, allocations of memory tracked by subsystems such as log cache, block "
+             "cache, inbound RPC calls and memstores are sampled once per this number of bytes "
+             "allocated by a thread, and top allocating stacks are shown at /mem-trackers. "
+             "Requires tcmalloc.");
+TAG_FLAG(mem_tracker_allocation_sampling_interval_bytes, advanced);
+
 DEFINE_string(yb_test_name, "",
               "Specifies test name this daemon is running as part of.");
 
@@ -183,6 +192,11 @@ Status RpcServerBase::Init() {
 
   InitSpinLockContentionProfiling();
 
+  if (FLAGS_mem_tracker_allocation_sampling_interval_bytes > 0) {
+    WARN_NOT_OK(StartAllocationSampling(FLAGS_mem_tracker_allocation_sampling_interval_bytes),
+                "Failed to start allocation sampling");
+  }
+
   SetStackTraceSignal(SIGUSR2);
 
   // Initialize the clock immediately. This checks that the clock is synchronized
@@ -498,6 +512,8 @@ Status RpcAndWebServerBase::Start() {
 
   RETURN_NOT_OK(RpcServerBase::Start());
 
+  WARN_NOT_OK(StartContinuousProfilerIfEnabled(), "Failed to start continuous profiler");
+
   return Status::OK();
 }
 
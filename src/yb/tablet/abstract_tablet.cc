@@ -43,12 +43,19 @@ CHECKED_STATUS AbstractTablet::HandleQLReadRequest(
   RETURN_NOT_OK(schema.CreateProjectionByIdsIgnoreMissing(column_refs, &query_schema));
 
   QLRSRowDesc rsrow_desc(ql_read_request.rsrow_desc());
-  QLResultSet resultset;
+  QLResultSet resultset(&rsrow_desc, &result->rows_data);
   TRACE("Start Execute");
   const Status s = doc_op.Execute(
       QLStorage(), deadline, read_time, schema, query_schema, &resultset, &result->restart_read_ht);
-  TRACE("Done Execute");
+  result->iterator_init_time = doc_op.iterator_init_time();
+  result->fetch_rows_time = doc_op.fetch_rows_time();
+  result->min_ttl_seconds = doc_op.min_ttl_seconds();
+  TRACE("Done Execute: iterator init $0 us, fetched $1 rows in $2 us",
+        result->iterator_init_time.ToMicroseconds(), resultset.rsrow_count(),
+        result->fetch_rows_time.ToMicroseconds());
   if (!s.ok()) {
+    // Drop rows serialized before the failure.
+    result->rows_data.clear();
     if (s.IsQLError()) {
       result->response.set_status(QLResponsePB::YQL_STATUS_USAGE_ERROR);
     } else {
@@ -64,13 +71,8 @@ CHECKED_STATUS AbstractTablet::HandleQLReadRequest(
 
   // TODO(neil) The clients' request should indicate what encoding method should be used. When
   // multi-shard is used to process more complicated queries, proxy-server might prefer a different
-  // encoding. For now, we'll call CQLSerialize() without checking encoding method.
+  // encoding. For now, the result set is serialized with CQL encoding without checking.
   result->response.set_status(QLResponsePB::YQL_STATUS_OK);
-  TRACE("Start Serialize");
-  RETURN_NOT_OK(resultset.CQLSerialize(ql_read_request.client(),
-                                       rsrow_desc,
-                                       &result->rows_data));
-  TRACE("Done Serialize");
   return Status::OK();
 }
 
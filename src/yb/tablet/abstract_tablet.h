@@ -27,6 +27,11 @@ struct QLReadRequestResult {
   QLResponsePB response;
   faststring rows_data;
   HybridTime restart_read_ht;
+  // Time spent creating the iterator and fetching rows, not set when the read was not executed.
+  MonoDelta iterator_init_time;
+  MonoDelta fetch_rows_time;
+  // Min remaining TTL in seconds of values read, -1 when none of them has a TTL.
+  int64_t min_ttl_seconds = -1;
 };
 
 struct PgsqlReadRequestResult {
@@ -0,0 +1,234 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/compaction_history.h"
+
+#include <algorithm>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "yb/rocksdb/db.h"
+#include "yb/tablet/tablet_metadata.h"
+#include "yb/util/format.h"
+
+METRIC_DEFINE_counter(server, flush_jobs_completed, "Flush Jobs Completed",
+                      yb::MetricUnit::kOperations,
+                      "Number of memtable flushes completed by tablets of the server.");
+
+METRIC_DEFINE_counter(server, flush_bytes_written, "Flush Bytes Written",
+                      yb::MetricUnit::kBytes,
+                      "Size of SST files written by memtable flushes.");
+
+METRIC_DEFINE_histogram(server, flush_job_duration, "Flush Job Duration",
+                        yb::MetricUnit::kMicroseconds,
+                        "Time spent running memtable flushes.",
+                        600000000LU, 2);
+
+METRIC_DEFINE_counter(server, compaction_jobs_completed, "Compaction Jobs Completed",
+                      yb::MetricUnit::kOperations,
+                      "Number of compactions completed by tablets of the server.");
+
+METRIC_DEFINE_counter(server, compaction_bytes_read, "Compaction Bytes Read",
+                      yb::MetricUnit::kBytes,
+                      "Size of SST files read by compactions.");
+
+METRIC_DEFINE_counter(server, compaction_bytes_written, "Compaction Bytes Written",
+                      yb::MetricUnit::kBytes,
+                      "Size of SST files written by compactions.");
+
+METRIC_DEFINE_histogram(server, compaction_job_duration, "Compaction Job Duration",
+                        yb::MetricUnit::kMicroseconds,
+                        "Time spent running compactions.",
+                        3600000000LU, 2);
+
+METRIC_DEFINE_counter(server, compaction_keys_expired, "Compaction Keys Expired",
+                      yb::MetricUnit::kEntries,
+                      "Number of values with expired TTL removed, or replaced with tombstones, "
+                      "by compactions.");
+
+METRIC_DEFINE_counter(server, compaction_keys_overwritten, "Compaction Keys Overwritten",
+                      yb::MetricUnit::kEntries,
+                      "Number of overwritten values removed by compactions.");
+
+METRIC_DEFINE_counter(server, compaction_keys_deleted, "Compaction Keys Deleted",
+                      yb::MetricUnit::kEntries,
+                      "Number of tombstones and values of deleted columns removed by "
+                      "compactions.");
+
+METRIC_DEFINE_counter(server, tablet_write_stall_micros, "Tablet Write Stall Time",
+                      yb::MetricUnit::kMicroseconds,
+                      "Time writes to tablets of the server were delayed or stopped because "
+                      "flushes and compactions could not keep up.");
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+const char* CompactionReasonToString(rocksdb::CompactionReason reason) {
+  switch (reason) {
+    case rocksdb::CompactionReason::kUnknown: return "unknown";
+    case rocksdb::CompactionReason::kLevelL0FilesNum: return "L0 files";
+    case rocksdb::CompactionReason::kLevelMaxLevelSize: return "level size";
+    case rocksdb::CompactionReason::kUniversalSizeAmplification: return "size amplification";
+    case rocksdb::CompactionReason::kUniversalSizeRatio: return "size ratio";
+    case rocksdb::CompactionReason::kUniversalSortedRunNum: return "sorted runs";
+    case rocksdb::CompactionReason::kFIFOMaxSize: return "FIFO size";
+    case rocksdb::CompactionReason::kManualCompaction: return "manual";
+    case rocksdb::CompactionReason::kFilesMarkedForCompaction: return "marked files";
+  }
+  FATAL_INVALID_ENUM_VALUE(rocksdb::CompactionReason, reason);
+}
+
+} // namespace
+
+std::string CompactionJobEvent::ToString() const {
+  return Format("{ type: $0 tablet_id: $1 intents_db: $2 job_id: $3 status: $4 reason: $5 "
+                "input_level: $6 output_level: $7 num_input_files: $8 input_bytes: $9 "
+                "num_output_files: $10 output_bytes: $11 num_input_records: $12 "
+                "num_output_records: $13 dropped: $14 elapsed_micros: $15 stall_micros: $16 }",
+                type, tablet_id, intents_db, job_id, status, reason, input_level, output_level,
+                num_input_files, input_bytes, num_output_files, output_bytes, num_input_records,
+                num_output_records, dropped, elapsed_micros, stall_micros);
+}
+
+CompactionHistory::CompactionHistory(
+    size_t capacity, const scoped_refptr<MetricEntity>& metric_entity)
+    : capacity_(std::max<size_t>(capacity, 1)) {
+  events_.reserve(capacity_);
+  if (metric_entity) {
+    flush_jobs_ = METRIC_flush_jobs_completed.Instantiate(metric_entity);
+    flush_bytes_written_ = METRIC_flush_bytes_written.Instantiate(metric_entity);
+    flush_job_duration_ = METRIC_flush_job_duration.Instantiate(metric_entity);
+    compaction_jobs_ = METRIC_compaction_jobs_completed.Instantiate(metric_entity);
+    compaction_bytes_read_ = METRIC_compaction_bytes_read.Instantiate(metric_entity);
+    compaction_bytes_written_ = METRIC_compaction_bytes_written.Instantiate(metric_entity);
+    compaction_job_duration_ = METRIC_compaction_job_duration.Instantiate(metric_entity);
+    compaction_keys_expired_ = METRIC_compaction_keys_expired.Instantiate(metric_entity);
+    compaction_keys_overwritten_ = METRIC_compaction_keys_overwritten.Instantiate(metric_entity);
+    compaction_keys_deleted_ = METRIC_compaction_keys_deleted.Instantiate(metric_entity);
+    write_stall_micros_ = METRIC_tablet_write_stall_micros.Instantiate(metric_entity);
+  }
+}
+
+void CompactionHistory::Record(CompactionJobEvent event) {
+  if (flush_jobs_) {
+    if (event.type == CompactionJobType::kFlush) {
+      flush_jobs_->Increment();
+      flush_bytes_written_->IncrementBy(event.output_bytes);
+      flush_job_duration_->Increment(event.elapsed_micros);
+    } else {
+      compaction_jobs_->Increment();
+      compaction_bytes_read_->IncrementBy(event.input_bytes);
+      compaction_bytes_written_->IncrementBy(event.output_bytes);
+      compaction_job_duration_->Increment(event.elapsed_micros);
+      compaction_keys_expired_->IncrementBy(event.dropped.num_expired);
+      compaction_keys_overwritten_->IncrementBy(event.dropped.num_overwritten);
+      compaction_keys_deleted_->IncrementBy(event.dropped.num_deleted);
+    }
+    write_stall_micros_->IncrementBy(event.stall_micros);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (events_.size() < capacity_) {
+    events_.push_back(std::move(event));
+    return;
+  }
+  events_[next_] = std::move(event);
+  next_ = (next_ + 1) % capacity_;
+}
+
+std::vector<CompactionJobEvent> CompactionHistory::Events() const {
+  std::vector<CompactionJobEvent> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(events_.size());
+    // next_ is the oldest event once the buffer is full, and 0 before that.
+    result.insert(result.end(), events_.begin() + next_, events_.end());
+    result.insert(result.end(), events_.begin(), events_.begin() + next_);
+  }
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+CompactionHistoryListener::CompactionHistoryListener(
+    std::string tablet_id,
+    std::shared_ptr<CompactionHistory> history,
+    docdb::DocDBCompactionFilterStatsCollectorPtr filter_stats,
+    std::shared_ptr<rocksdb::Statistics> rocksdb_statistics)
+    : tablet_id_(std::move(tablet_id)),
+      history_(std::move(history)),
+      filter_stats_(std::move(filter_stats)),
+      rocksdb_statistics_(std::move(rocksdb_statistics)) {
+  if (rocksdb_statistics_) {
+    last_stall_micros_ = rocksdb_statistics_->getTickerCount(rocksdb::STALL_MICROS);
+  }
+}
+
+void CompactionHistoryListener::OnFlushCompleted(
+    rocksdb::DB* db, const rocksdb::FlushJobInfo& info) {
+  CompactionJobEvent event;
+  event.type = CompactionJobType::kFlush;
+  event.job_id = info.job_id;
+  event.status = "OK";
+  event.num_output_files = 1;
+  event.output_bytes = info.file_size;
+  event.num_input_records = info.table_properties.num_entries;
+  event.num_output_records = info.table_properties.num_entries;
+  event.elapsed_micros = info.elapsed_micros;
+  event.triggered_writes_slowdown = info.triggered_writes_slowdown;
+  event.triggered_writes_stop = info.triggered_writes_stop;
+  Record(db, &event);
+}
+
+void CompactionHistoryListener::OnCompactionCompleted(
+    rocksdb::DB* db, const rocksdb::CompactionJobInfo& info) {
+  CompactionJobEvent event;
+  event.type = CompactionJobType::kCompaction;
+  event.job_id = info.job_id;
+  event.status = info.status.ok() ? "OK" : info.status.ToString();
+  event.reason = CompactionReasonToString(info.compaction_reason);
+  event.is_manual = info.stats.is_manual_compaction;
+  event.input_level = info.base_input_level;
+  event.output_level = info.output_level;
+  event.num_input_files = info.stats.num_input_files;
+  event.input_bytes = info.stats.total_input_bytes;
+  event.num_output_files = info.stats.num_output_files;
+  event.output_bytes = info.stats.total_output_bytes;
+  event.num_input_records = info.stats.num_input_records;
+  event.num_output_records = info.stats.num_output_records;
+  event.elapsed_micros = info.stats.elapsed_micros;
+  Record(db, &event);
+}
+
+void CompactionHistoryListener::Record(rocksdb::DB* db, CompactionJobEvent* event) {
+  event->tablet_id = tablet_id_;
+  event->intents_db = boost::ends_with(db->GetName(), kIntentsDBSuffix);
+  event->finish_time = MonoTime::Now();
+  // Only the regular DB has the DocDB compaction filter. When compactions of the tablet run
+  // concurrently, keys dropped by one of them could be attributed to the other.
+  if (event->type == CompactionJobType::kCompaction && !event->intents_db && filter_stats_) {
+    event->dropped = filter_stats_->Take();
+  }
+  if (rocksdb_statistics_) {
+    std::lock_guard<std::mutex> lock(stall_mutex_);
+    const uint64_t stall_micros = rocksdb_statistics_->getTickerCount(rocksdb::STALL_MICROS);
+    event->stall_micros = stall_micros - last_stall_micros_;
+    last_stall_micros_ = stall_micros;
+  }
+  VLOG(1) << "Completed " << event->ToString();
+  history_->Record(std::move(*event));
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,140 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_COMPACTION_HISTORY_H
+#define YB_TABLET_COMPACTION_HISTORY_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/rocksdb/listener.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/util/enums.h"
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace tablet {
+
+YB_DEFINE_ENUM(CompactionJobType, (kFlush)(kCompaction));
+
+// Details of a completed flush or compaction job of a tablet.
+struct CompactionJobEvent {
+  CompactionJobType type = CompactionJobType::kFlush;
+  std::string tablet_id;
+  // Whether the job ran on the intents DB of the tablet, rather than on the regular one.
+  bool intents_db = false;
+  MonoTime finish_time;
+  int job_id = 0;
+  std::string status;
+
+  // Compaction only, flushes always write a single file to level 0.
+  std::string reason;
+  bool is_manual = false;
+  int input_level = 0;
+  int output_level = 0;
+  uint64_t num_input_files = 0;
+  uint64_t input_bytes = 0;
+
+  uint64_t num_output_files = 0;
+  uint64_t output_bytes = 0;
+  uint64_t num_input_records = 0;
+  uint64_t num_output_records = 0;
+  // Keys dropped by the DocDB compaction filter, only set for compactions of the regular DB.
+  docdb::DocDBCompactionFilterStats dropped;
+
+  uint64_t elapsed_micros = 0;
+  // Time writes to the tablet were stalled since the previous job of the tablet completed.
+  uint64_t stall_micros = 0;
+  // Flush only, whether the number of level 0 files triggered write slowdown or stop.
+  bool triggered_writes_slowdown = false;
+  bool triggered_writes_stop = false;
+
+  double output_bytes_per_sec() const {
+    return elapsed_micros ? output_bytes * 1e6 / elapsed_micros : 0;
+  }
+
+  std::string ToString() const;
+};
+
+// Keeps the latest flush and compaction jobs of all tablets of a tablet server in a ring buffer,
+// and exports their totals as server metrics. This class is thread-safe.
+class CompactionHistory {
+ public:
+  // metric_entity could be null, in this case totals are not exported as metrics.
+  CompactionHistory(size_t capacity, const scoped_refptr<MetricEntity>& metric_entity);
+
+  void Record(CompactionJobEvent event);
+
+  // Returns the kept jobs, the most recently completed first.
+  std::vector<CompactionJobEvent> Events() const;
+
+  size_t capacity() const { return capacity_; }
+
+ private:
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  std::vector<CompactionJobEvent> events_;
+  // Position in events_ of the next recorded job, once the buffer is full.
+  size_t next_ = 0;
+
+  // Null when totals are not exported as metrics.
+  scoped_refptr<Counter> flush_jobs_;
+  scoped_refptr<Counter> flush_bytes_written_;
+  scoped_refptr<Histogram> flush_job_duration_;
+  scoped_refptr<Counter> compaction_jobs_;
+  scoped_refptr<Counter> compaction_bytes_read_;
+  scoped_refptr<Counter> compaction_bytes_written_;
+  scoped_refptr<Histogram> compaction_job_duration_;
+  scoped_refptr<Counter> compaction_keys_expired_;
+  scoped_refptr<Counter> compaction_keys_overwritten_;
+  scoped_refptr<Counter> compaction_keys_deleted_;
+  scoped_refptr<Counter> write_stall_micros_;
+};
+
+// Listens to flushes and compactions of both RocksDB instances of a tablet, and records them to
+// the history of the tablet server.
+class CompactionHistoryListener : public rocksdb::EventListener {
+ public:
+  // filter_stats collects keys dropped by compactions of the regular DB. rocksdb_statistics are
+  // used to measure write stall time, could be null.
+  CompactionHistoryListener(std::string tablet_id,
+                            std::shared_ptr<CompactionHistory> history,
+                            docdb::DocDBCompactionFilterStatsCollectorPtr filter_stats,
+                            std::shared_ptr<rocksdb::Statistics> rocksdb_statistics);
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) override;
+
+  void OnCompactionCompleted(rocksdb::DB* db, const rocksdb::CompactionJobInfo& info) override;
+
+ private:
+  void Record(rocksdb::DB* db, CompactionJobEvent* event);
+
+  const std::string tablet_id_;
+  const std::shared_ptr<CompactionHistory> history_;
+  const docdb::DocDBCompactionFilterStatsCollectorPtr filter_stats_;
+  const std::shared_ptr<rocksdb::Statistics> rocksdb_statistics_;
+
+  std::mutex stall_mutex_;
+  // Value of the stall ticker when the previous job of the tablet was recorded.
+  uint64_t last_stall_micros_ = 0;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_COMPACTION_HISTORY_H
@@ -41,6 +41,7 @@
 #include "yb/tablet/tablet.pb.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
@@ -50,6 +51,10 @@ using std::shared_ptr;
 using std::vector;
 using strings::Substitute;
 
+using namespace yb::size_literals;
+
+DECLARE_int64(maintenance_manager_io_budget_bytes);
+
 METRIC_DEFINE_entity(test);
 METRIC_DEFINE_gauge_uint32(test, maintenance_ops_running,
                            "Number of Maintenance Operations Running",
@@ -108,6 +113,7 @@ class TestMaintenanceOp : public MaintenanceOp {
       consumption_(tracker, 500),
       logs_retained_bytes_(0),
       perf_improvement_(0),
+      expected_io_bytes_(0),
       metric_entity_(METRIC_ENTITY_test.Instantiate(&metric_registry_, "test")),
       maintenance_op_duration_(METRIC_maintenance_op_duration.Instantiate(metric_entity_)),
       maintenance_ops_running_(METRIC_maintenance_ops_running.Instantiate(metric_entity_, 0)) {
@@ -140,6 +146,7 @@ class TestMaintenanceOp : public MaintenanceOp {
     stats->set_ram_anchored(consumption_.consumption());
     stats->set_logs_retained_bytes(logs_retained_bytes_);
     stats->set_perf_improvement(perf_improvement_);
+    stats->set_expected_io_bytes(expected_io_bytes_);
   }
 
   void Enable() {
@@ -187,6 +194,11 @@ class TestMaintenanceOp : public MaintenanceOp {
     perf_improvement_ = perf_improvement;
   }
 
+  void set_expected_io_bytes(uint64_t expected_io_bytes) {
+    std::lock_guard<Mutex> guard(lock_);
+    expected_io_bytes_ = expected_io_bytes;
+  }
+
   scoped_refptr<Histogram> DurationHistogram() const override {
     return maintenance_op_duration_;
   }
@@ -202,6 +214,7 @@ class TestMaintenanceOp : public MaintenanceOp {
   ScopedTrackedConsumption consumption_;
   uint64_t logs_retained_bytes_;
   uint64_t perf_improvement_;
+  uint64_t expected_io_bytes_;
   MetricRegistry metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
   scoped_refptr<Histogram> maintenance_op_duration_;
@@ -279,6 +292,43 @@ TEST_F(MaintenanceManagerTest, TestLogRetentionPrioritization) {
   manager_->UnregisterOp(&op2);
 }
 
+// Test that ops improving performance are ranked by improvement per I/O byte, and that ops which
+// don't fit into the I/O budget are deferred.
+TEST_F(MaintenanceManagerTest, TestIOCostPrioritization) {
+  manager_->Shutdown();
+
+  TestMaintenanceOp op1("op1", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op1.set_perf_improvement(10);
+  op1.set_expected_io_bytes(100_MB);
+
+  TestMaintenanceOp op2("op2", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op2.set_perf_improvement(5);
+  op2.set_expected_io_bytes(1_MB);
+
+  manager_->RegisterOp(&op1);
+  manager_->RegisterOp(&op2);
+
+  // op2 has smaller improvement, but is much cheaper.
+  ASSERT_EQ(&op2, manager_->FindBestOp());
+
+  manager_->UnregisterOp(&op2);
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  // op1 does not fit into the budget while another op is running.
+  FLAGS_maintenance_manager_io_budget_bytes = 110_MB;
+  manager_->running_io_bytes_ = 50_MB;
+  ASSERT_EQ(nullptr, manager_->FindBestOp());
+  manager_->running_io_bytes_ = 10_MB;
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  // When nothing is running, op1 is allowed even if it exceeds the budget.
+  FLAGS_maintenance_manager_io_budget_bytes = 10_MB;
+  manager_->running_io_bytes_ = 0;
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  manager_->UnregisterOp(&op1);
+}
+
 // Test adding operations and make sure that the history of recently completed operations
 // is correct in that it wraps around and doesn't grow.
 TEST_F(MaintenanceManagerTest, TestCompletedOpsHistory) {
@@ -47,6 +47,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
 
@@ -54,6 +55,8 @@ using std::pair;
 using std::shared_ptr;
 using strings::Substitute;
 
+using namespace yb::size_literals;
+
 DEFINE_int32(maintenance_manager_num_threads, 1,
        "Size of the maintenance manager thread pool. Beyond a value of '1', one thread is "
        "reserved for emergency flushes. For spinning disks, the number of threads should "
@@ -73,6 +76,13 @@ DEFINE_bool(enable_maintenance_manager, true,
        "Enable the maintenance manager, runs compaction and tablet cleaning tasks.");
 TAG_FLAG(enable_maintenance_manager, unsafe);
 
+DEFINE_int64(maintenance_manager_io_budget_bytes, 0,
+             "Max total expected I/O bytes of maintenance operations running at the same time. "
+             "An operation that does not fit is deferred unless nothing else is running. "
+             "0 means no limit.");
+TAG_FLAG(maintenance_manager_io_budget_bytes, advanced);
+TAG_FLAG(maintenance_manager_io_budget_bytes, runtime);
+
 namespace yb {
 
 using yb::tablet::MaintenanceManagerStatusPB;
@@ -89,6 +99,7 @@ void MaintenanceOpStats::Clear() {
   ram_anchored_ = 0;
   logs_retained_bytes_ = 0;
   perf_improvement_ = 0;
+  expected_io_bytes_ = 0;
 }
 
 MaintenanceOp::MaintenanceOp(std::string name, IOUsage io_usage)
@@ -117,6 +128,7 @@ MaintenanceManager::MaintenanceManager(const Options& options)
     cond_(&lock_),
     shutdown_(false),
     running_ops_(0),
+    running_io_bytes_(0),
     polling_interval_ms_(options.polling_interval_ms <= 0 ?
           FLAGS_maintenance_manager_polling_interval_ms :
           options.polling_interval_ms),
@@ -220,8 +232,10 @@ void MaintenanceManager::RunSchedulerThread() {
     }
 
     // Prepare the maintenance operation.
+    const uint64_t io_bytes = ops_[op].expected_io_bytes();
     op->running_++;
     running_ops_++;
+    running_io_bytes_ += io_bytes;
     guard.unlock();
     bool ready = op->Prepare();
     guard.lock();
@@ -229,12 +243,15 @@ void MaintenanceManager::RunSchedulerThread() {
       LOG(INFO) << "Prepare failed for " << op->name()
                 << ".  Re-running scheduler.";
       op->running_--;
+      running_ops_--;
+      running_io_bytes_ -= io_bytes;
       op->cond_->Signal();
       continue;
     }
 
     // Run the maintenance operation.
-    Status s = thread_pool_->SubmitFunc(std::bind(&MaintenanceManager::LaunchOp, this, op));
+    Status s = thread_pool_->SubmitFunc(
+        std::bind(&MaintenanceManager::LaunchOp, this, op, io_bytes));
     CHECK(s.ok());
   }
 }
@@ -246,7 +263,10 @@ void MaintenanceManager::RunSchedulerThread() {
 // - If there are Ops that retain logs, we run the one that has the highest retention (and if many
 //   qualify, then we run the one that also frees up the most RAM).
 // - Finally, if there's nothing else that we really need to do, we run the Op that will improve
-//   performance the most.
+//   performance the most per byte of I/O that it is expected to do.
+//
+// Except for the first two filters, ops that do not fit into the I/O budget are skipped, so
+// expensive ops do not compete for the disk with each other.
 //
 // The reason it's done this way is that we want to prioritize limiting the amount of resources we
 // hold on to. Low IO Ops go first since we can quickly run them, then we can look at memory usage.
@@ -281,6 +301,7 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
   MaintenanceOp* most_logs_retained_bytes_op = nullptr;
 
   double best_perf_improvement = 0;
+  double best_perf_improvement_per_io = 0;
   MaintenanceOp* best_perf_improvement_op = nullptr;
   for (OpMapTy::value_type &val : ops_) {
     MaintenanceOp* op(val.first);
@@ -301,6 +322,14 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
       most_mem_anchored_op = op;
       most_mem_anchored = stats.ram_anchored();
     }
+    if (!FitsIOBudget(stats)) {
+      VLOG_AND_TRACE("maintenance", 2)
+          << "Skipping " << op->name() << ", because " << stats.expected_io_bytes()
+          << " bytes of I/O do not fit into the budget, " << running_io_bytes_
+          << " bytes are used by running ops";
+      continue;
+    }
+
     // We prioritize ops that can free more logs, but when it's the same we pick the one that
     // also frees up the most memory.
     if (stats.logs_retained_bytes() > 0 &&
@@ -311,10 +340,14 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
       most_logs_retained_bytes = stats.logs_retained_bytes();
       most_logs_retained_bytes_ram_anchored = stats.ram_anchored();
     }
+    // Ops that don't report I/O keep their improvement score as is.
+    const double perf_improvement_per_io =
+        stats.perf_improvement() / (1.0 + static_cast<double>(stats.expected_io_bytes()) / 1_MB);
     if ((!best_perf_improvement_op) ||
-        (stats.perf_improvement() > best_perf_improvement)) {
+        (perf_improvement_per_io > best_perf_improvement_per_io)) {
       best_perf_improvement_op = op;
       best_perf_improvement = stats.perf_improvement();
+      best_perf_improvement_per_io = perf_improvement_per_io;
     }
   }
 
@@ -358,15 +391,23 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
   if (best_perf_improvement_op) {
     if (best_perf_improvement > 0) {
       VLOG_AND_TRACE("maintenance", 1) << "Performing " << best_perf_improvement_op->name() << ", "
-                 << "because it had the best perf_improvement score, "
-                 << "at " << best_perf_improvement;
+                 << "because it had the best perf_improvement score per I/O, "
+                 << "at " << best_perf_improvement << " ("
+                 << best_perf_improvement_per_io << " per MB)";
       return best_perf_improvement_op;
     }
   }
   return nullptr;
 }
 
-void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
+bool MaintenanceManager::FitsIOBudget(const MaintenanceOpStats& stats) const {
+  const int64_t budget = FLAGS_maintenance_manager_io_budget_bytes;
+  // When nothing runs, any op is allowed, so ops larger than the budget are not starved.
+  return budget <= 0 || running_io_bytes_ == 0 ||
+         running_io_bytes_ + stats.expected_io_bytes() <= static_cast<uint64_t>(budget);
+}
+
+void MaintenanceManager::LaunchOp(MaintenanceOp* op, uint64_t io_bytes) {
   MonoTime start_time(MonoTime::Now());
   op->RunningGauge()->Increment();
   LOG_TIMING(INFO, Substitute("running $0", op->name())) {
@@ -389,6 +430,7 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
 
   running_ops_--;
   op->running_--;
+  running_io_bytes_ -= io_bytes;
   op->cond_->Signal();
 }
 
@@ -407,6 +449,7 @@ void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatu
       op_pb->set_ram_anchored_bytes(stat.ram_anchored());
       op_pb->set_logs_retained_bytes(stat.logs_retained_bytes());
       op_pb->set_perf_improvement(stat.perf_improvement());
+      op_pb->set_expected_io_bytes(stat.expected_io_bytes());
     } else {
       op_pb->set_runnable(false);
       op_pb->set_ram_anchored_bytes(0);
@@ -104,6 +104,16 @@ class MaintenanceOpStats {
     perf_improvement_ = perf_improvement;
   }
 
+  uint64_t expected_io_bytes() const {
+    DCHECK(valid_);
+    return expected_io_bytes_;
+  }
+
+  void set_expected_io_bytes(uint64_t expected_io_bytes) {
+    UpdateLastModified();
+    expected_io_bytes_ = expected_io_bytes;
+  }
+
   const MonoTime& last_modified() const {
     DCHECK(valid_);
     return last_modified_;
@@ -138,6 +148,11 @@ class MaintenanceOpStats {
   // absolute scale (yet TBD).
   double perf_improvement_;
 
+  // The approximate number of bytes that this op reads from and writes to disk. Ops that improve
+  // performance are ranked by improvement per I/O byte, and the total of running ops is limited by
+  // maintenance_manager_io_budget_bytes. May be 0.
+  uint64_t expected_io_bytes_;
+
   // The last time that the stats were modified.
   MonoTime last_modified_;
 };
@@ -261,6 +276,7 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
 
  private:
   FRIEND_TEST(MaintenanceManagerTest, TestLogRetentionPrioritization);
+  FRIEND_TEST(MaintenanceManagerTest, TestIOCostPrioritization);
   typedef std::map<MaintenanceOp*, MaintenanceOpStats,
           MaintenanceOpComparator> OpMapTy;
 
@@ -269,7 +285,12 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   // find the best op, or null if there is nothing we want to run
   MaintenanceOp* FindBestOp();
 
-  void LaunchOp(MaintenanceOp* op);
+  // Whether the op fits into the I/O budget, considering ops that are already running.
+  bool FitsIOBudget(const MaintenanceOpStats& stats) const;
+
+  // io_bytes - expected I/O bytes of the op, that were added to running_io_bytes_ when it was
+  // scheduled.
+  void LaunchOp(MaintenanceOp* op, uint64_t io_bytes);
 
   const int32_t num_threads_;
   OpMapTy ops_; // registered operations
@@ -279,6 +300,8 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   ConditionVariable cond_;
   bool shutdown_;
   uint64_t running_ops_;
+  // Total expected I/O bytes of the running ops.
+  uint64_t running_io_bytes_;
   int32_t polling_interval_ms_;
   // Vector used as a circular buffer for recently completed ops. Elements need to be added at
   // the completed_ops_count_ % the vector's size and then the count needs to be incremented.
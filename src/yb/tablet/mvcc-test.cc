@@ -320,5 +320,41 @@ TEST_F(MvccTest, WaitForSafeTime) {
   ASSERT_FALSE(manager_.SafeTime(ht3, MonoTime::Now() + 100ms, HybridTime::kMax));
 }
 
+TEST_F(MvccTest, ConcurrentSafeTimeReaders) {
+  constexpr int kReaders = 4;
+  constexpr int kOperations = 100000;
+
+  std::atomic<bool> stopped{false};
+  std::atomic<uint64_t> max_safe_time{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i != kReaders; ++i) {
+    readers.emplace_back([this, &stopped, &max_safe_time] {
+      HybridTime last_safe_time = HybridTime::kMin;
+      while (!stopped.load(std::memory_order_acquire)) {
+        auto safe_time = manager_.SafeTime();
+        ASSERT_GE(safe_time, last_safe_time);
+        last_safe_time = safe_time;
+        UpdateAtomicMax(&max_safe_time, safe_time.ToUint64());
+      }
+    });
+  }
+
+  BOOST_SCOPE_EXIT(&stopped, &readers) {
+    stopped = true;
+    for (auto& thread : readers) {
+      thread.join();
+    }
+  } BOOST_SCOPE_EXIT_END;
+
+  for (int i = 0; i != kOperations; ++i) {
+    // Operation added after safe time was returned should have greater hybrid time.
+    auto returned_safe_time = max_safe_time.load(std::memory_order_acquire);
+    HybridTime ht;
+    manager_.AddPending(&ht);
+    ASSERT_GT(ht.ToUint64(), returned_safe_time);
+    manager_.Replicated(ht);
+  }
+}
+
 } // namespace tablet
 } // namespace yb
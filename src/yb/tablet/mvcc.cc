@@ -34,19 +34,12 @@
 
 #include <sstream>
 
+#include "yb/util/atomic.h"
 #include "yb/util/logging.h"
 
 namespace yb {
 namespace tablet {
 
-// ------------------------------------------------------------------------------------------------
-// SafeTimeWithSource
-// ------------------------------------------------------------------------------------------------
-
-std::string SafeTimeWithSource::ToString() {
-  return Format("{ safe_time: $0 source: $1 }", safe_time, source);
-}
-
 // ------------------------------------------------------------------------------------------------
 // MvccManager
 // ------------------------------------------------------------------------------------------------
@@ -62,10 +55,12 @@ void MvccManager::Replicated(HybridTime ht) {
     std::lock_guard<std::mutex> lock(mutex_);
     CHECK(!queue_.empty()) << LogPrefix();
     CHECK_EQ(queue_.front(), ht) << LogPrefix();
+    BeginPublish();
     PopFront(&lock);
-    last_replicated_ = ht;
+    last_replicated_.store(ht, std::memory_order_relaxed);
+    EndPublish();
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 void MvccManager::Aborted(HybridTime ht) {
@@ -75,13 +70,15 @@ void MvccManager::Aborted(HybridTime ht) {
     std::lock_guard<std::mutex> lock(mutex_);
     CHECK(!queue_.empty()) << LogPrefix();
     if (queue_.front() == ht) {
+      BeginPublish();
       PopFront(&lock);
+      EndPublish();
     } else {
       aborted_.push(ht);
       return;
     }
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
@@ -100,6 +97,9 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
 void MvccManager::AddPending(HybridTime* ht) {
   const bool is_follower_side = ht->is_valid();
   std::lock_guard<std::mutex> lock(mutex_);
+  // Should be started before reading the clock, so concurrent lock-free reader that obtained
+  // greater time from the clock would notice this modification.
+  BeginPublish();
   if (is_follower_side) {
     // This must be a follower-side transaction with already known hybrid time.
     VLOG_WITH_PREFIX(1) << "AddPending(" << *ht << ")";
@@ -130,12 +130,16 @@ void MvccManager::AddPending(HybridTime* ht) {
   }
   HybridTime last_ht_in_queue = queue_.empty() ? HybridTime::kMin : queue_.back();
 
+  const HybridTime max_safe_time_returned_with_lease = max_safe_time_returned_with_lease_;
+  const HybridTime max_safe_time_returned_without_lease = max_safe_time_returned_without_lease_;
+  const HybridTime max_safe_time_returned_for_follower = max_safe_time_returned_for_follower_;
+  const HybridTime last_replicated = last_replicated_.load(std::memory_order_relaxed);
   HybridTime sanity_check_lower_bound =
       std::max({
-          max_safe_time_returned_with_lease_.safe_time,
-          max_safe_time_returned_without_lease_.safe_time,
-          max_safe_time_returned_for_follower_,
-          last_replicated_,
+          max_safe_time_returned_with_lease,
+          max_safe_time_returned_without_lease,
+          max_safe_time_returned_for_follower,
+          last_replicated,
           last_ht_in_queue});
 
   if (!queue_.empty() && *ht <= sanity_check_lower_bound) {
@@ -149,10 +153,10 @@ void MvccManager::AddPending(HybridTime* ht) {
           << "\n  "
 
       ss << LogPrefix() << ": new operation's hybrid time too low: " << *ht
-         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_with_lease_.safe_time)
-         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_without_lease_.safe_time)
-         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_for_follower_)
-         << LOG_INFO_FOR_HT_LOWER_BOUND(last_replicated_)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_with_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_without_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_for_follower)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(last_replicated)
          << LOG_INFO_FOR_HT_LOWER_BOUND(last_ht_in_queue)
          << "\n  " << EXPR_VALUE_FOR_LOG(is_follower_side)
          << "\n  " << EXPR_VALUE_FOR_LOG(queue_.size())
@@ -188,6 +192,7 @@ void MvccManager::AddPending(HybridTime* ht) {
     }
   }
   queue_.push_back(*ht);
+  EndPublish();
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
@@ -195,9 +200,11 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    last_replicated_ = ht;
+    BeginPublish();
+    last_replicated_.store(ht, std::memory_order_relaxed);
+    EndPublish();
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
@@ -205,15 +212,16 @@ void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (ht >= propagated_safe_time_) {
+    const HybridTime propagated_safe_time = propagated_safe_time_;
+    if (ht >= propagated_safe_time) {
       propagated_safe_time_ = ht;
     } else {
       LOG(WARNING) << "Received propagated safe time " << ht << " less than the old value: "
-                   << propagated_safe_time_ << ". This could happen on followers when a new leader "
+                   << propagated_safe_time << ". This could happen on followers when a new leader "
                    << "is elected.";
     }
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
@@ -225,129 +233,214 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
                             MonoTime::kMax,    // deadline
                             ht_lease,
                             &lock);
+    const HybridTime propagated_safe_time = propagated_safe_time_;
 #ifndef NDEBUG
     // This should only be called from RaftConsensus::UpdateMajorityReplicated, and ht_lease passed
     // in here should keep increasing, so we should not see propagated_safe_time_ going backwards.
-    CHECK_GE(ht, propagated_safe_time_) << LogPrefix();
+    CHECK_GE(ht, propagated_safe_time) << LogPrefix();
     propagated_safe_time_ = ht;
 #else
     // Do not crash in production.
-    if (ht < propagated_safe_time_) {
+    if (ht < propagated_safe_time) {
       YB_LOG_EVERY_N_SECS(ERROR, 5) << LogPrefix()
-          << "Previously saw " << EXPR_VALUE_FOR_LOG(propagated_safe_time_)
+          << "Previously saw " << EXPR_VALUE_FOR_LOG(propagated_safe_time)
           << ", but now safe time is " << ht;
     } else {
       propagated_safe_time_ = ht;
     }
 #endif
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 HybridTime MvccManager::SafeTimeForFollower(
     HybridTime min_allowed, MonoTime deadline) const {
-  std::unique_lock<std::mutex> lock(mutex_);
+  HybridTime enforced_min_time;
   HybridTime result;
-  auto predicate = [this, &result, min_allowed] {
+  // Both values are only increasing, so they could be read without locking. The enforced minimum
+  // is loaded first, so a concurrent call could not make it greater than our result.
+  auto predicate = [this, &enforced_min_time, &result, min_allowed] {
+    enforced_min_time = max_safe_time_returned_for_follower_;
     // last_replicated_ is updated earlier than propagated_safe_time_, so because of concurrency it
     // could be greater than propagated_safe_time_.
-    result = std::max(propagated_safe_time_, last_replicated_);
+    result = std::max(propagated_safe_time_.load(), last_replicated_.load());
     return result >= min_allowed;
   };
-  if (deadline == MonoTime::kMax) {
-    cond_.wait(lock, predicate);
-  } else if (!cond_.wait_until(lock, deadline.ToSteadyTimePoint(), predicate)) {
-    return HybridTime::kInvalid;
+  if (!predicate()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!WaitFor(deadline, &lock, predicate)) {
+      return HybridTime::kInvalid;
+    }
   }
   VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
                       << "), result = " << result;
-  CHECK_GE(result, max_safe_time_returned_for_follower_) << LogPrefix();
-  max_safe_time_returned_for_follower_ = result;
+  CHECK_GE(result, enforced_min_time) << LogPrefix();
+  UpdateAtomicMax(&max_safe_time_returned_for_follower_, result);
   return result;
 }
 
 HybridTime MvccManager::SafeTime(HybridTime min_allowed,
                                  MonoTime deadline,
                                  HybridTime ht_lease) const {
+  auto result = TryGetSafeTimeLockFree(min_allowed, ht_lease);
+  if (result.is_valid()) {
+    return result;
+  }
   std::unique_lock<std::mutex> lock(mutex_);
   return DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
 }
 
-HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
-                                      const MonoTime deadline,
-                                      const HybridTime ht_lease,
-                                      std::unique_lock<std::mutex>* lock) const {
-  DCHECK_ONLY_NOTNULL(lock);
+bool MvccManager::RegisterHtLease(HybridTime min_allowed, HybridTime ht_lease) const {
   CHECK(ht_lease.is_valid());
   CHECK_LE(min_allowed, ht_lease) << LogPrefix();
 
-  bool has_lease = false;
   if (ht_lease.GetPhysicalValueMicros() < kMaxHybridTimePhysicalMicros) {
-    max_ht_lease_seen_ = std::max(ht_lease, max_ht_lease_seen_);
-    has_lease = true;
+    UpdateAtomicMax(&max_ht_lease_seen_, ht_lease);
+    return true;
   }
+  return false;
+}
 
+HybridTime MvccManager::ComputeSafeTime(bool has_lease, SafeTimeSource* source) const {
   HybridTime result;
-  SafeTimeSource source = SafeTimeSource::kUnknown;
-  auto predicate = [this, &result, &source, min_allowed, has_lease] {
-    if (queue_.empty()) {
-      result = clock_->Now();
-      source = SafeTimeSource::kNow;
-      CHECK_GE(result, min_allowed) << LogPrefix();
-      VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Now: " << result;
-    } else {
-      result = queue_.front().Decremented();
-      source = SafeTimeSource::kNextInQueue;
-      VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Queue front (decremented): " << result;
-    }
+  const HybridTime queue_front = queue_front_.load(std::memory_order_relaxed);
+  if (queue_front == HybridTime::kMax) {
+    result = clock_->Now();
+    *source = SafeTimeSource::kNow;
+    VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Now: " << result;
+  } else {
+    result = queue_front.Decremented();
+    *source = SafeTimeSource::kNextInQueue;
+    VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Queue front (decremented): " << result;
+  }
 
-    if (has_lease && result > max_ht_lease_seen_) {
-      result = max_ht_lease_seen_;
-      source = SafeTimeSource::kHybridTimeLease;
+  if (has_lease) {
+    const HybridTime max_ht_lease_seen = max_ht_lease_seen_;
+    if (result > max_ht_lease_seen) {
+      result = max_ht_lease_seen;
+      *source = SafeTimeSource::kHybridTimeLease;
     }
+  }
+
+  // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
+  // is safe to read at least at last_replicated_.
+  return std::max(result, last_replicated_.load(std::memory_order_relaxed));
+}
+
+HybridTime MvccManager::TryGetSafeTimeLockFree(HybridTime min_allowed,
+                                               HybridTime ht_lease) const {
+  const bool has_lease = RegisterHtLease(min_allowed, ht_lease);
+  const HybridTime enforced_min_time = has_lease ? max_safe_time_returned_with_lease_
+                                                 : max_safe_time_returned_without_lease_;
+
+  const uint64_t version = version_.load(std::memory_order_acquire);
+  if (version & 1) {
+    return HybridTime::kInvalid;
+  }
+  SafeTimeSource source = SafeTimeSource::kUnknown;
+  const HybridTime result = ComputeSafeTime(has_lease, &source);
+  // AddPending starts modification before reading the clock. So if we got time from the clock
+  // that is greater than time of a concurrently added operation, we will see changed version here.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (version_.load(std::memory_order_relaxed) != version || result < min_allowed) {
+    return HybridTime::kInvalid;
+  }
+
+  VLOG_WITH_PREFIX(1) << "SafeTime(" << min_allowed << ", " << ht_lease << "), result = "
+                      << result << ", source: " << source;
+  SafeTimeReturned(result, enforced_min_time, has_lease, ht_lease);
+  return result;
+}
 
-    // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
-    // is safe to read at least at last_replicated_.
-    result = std::max(result, last_replicated_);
+HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
+                                      const MonoTime deadline,
+                                      const HybridTime ht_lease,
+                                      std::unique_lock<std::mutex>* lock) const {
+  DCHECK_ONLY_NOTNULL(lock);
+  const bool has_lease = RegisterHtLease(min_allowed, ht_lease);
+  const auto& max_safe_time_returned = has_lease ? max_safe_time_returned_with_lease_
+                                                 : max_safe_time_returned_without_lease_;
 
+  HybridTime enforced_min_time;
+  HybridTime result;
+  SafeTimeSource source = SafeTimeSource::kUnknown;
+  auto predicate = [this, &enforced_min_time, &max_safe_time_returned, &result, &source,
+                    min_allowed, has_lease] {
+    // Lock-free readers could return safe time concurrently, so the enforced minimum should be
+    // loaded before computing the result.
+    enforced_min_time = max_safe_time_returned;
+    result = ComputeSafeTime(has_lease, &source);
+    if (source == SafeTimeSource::kNow) {
+      CHECK_GE(result, min_allowed) << LogPrefix();
+    }
     return result >= min_allowed;
   };
 
   // In the case of an empty queue, the safe hybrid time to read at is only limited by hybrid time
   // ht_lease, which is by definition higher than min_allowed, so we would not get blocked.
-  if (deadline == MonoTime::kMax) {
-    cond_.wait(*lock, predicate);
-  } else if (!cond_.wait_until(*lock, deadline.ToSteadyTimePoint(), predicate)) {
+  if (!WaitFor(deadline, lock, predicate)) {
     return HybridTime::kInvalid;
   }
   VLOG_WITH_PREFIX(1) << "DoGetSafeTime(" << min_allowed << ", "
-                      << ht_lease << "), result = " << result;
+                      << ht_lease << "), result = " << result << ", source: " << source;
 
-  auto enforced_min_time = has_lease ? max_safe_time_returned_with_lease_.safe_time
-                                     : max_safe_time_returned_without_lease_.safe_time;
+  SafeTimeReturned(result, enforced_min_time, has_lease, ht_lease);
+  return result;
+}
+
+void MvccManager::SafeTimeReturned(HybridTime result, HybridTime enforced_min_time,
+                                   bool has_lease, HybridTime ht_lease) const {
   CHECK_GE(result, enforced_min_time) << LogPrefix()
       << ": " << EXPR_VALUE_FOR_LOG(has_lease)
       << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.ToUint64())
       << ", " << EXPR_VALUE_FOR_LOG(ht_lease)
-      << ", " << EXPR_VALUE_FOR_LOG(max_ht_lease_seen_)
-      << ", " << EXPR_VALUE_FOR_LOG(last_replicated_)
-      << ", " << EXPR_VALUE_FOR_LOG(clock_->Now())
-      << ", " << EXPR_VALUE_FOR_LOG(deadline.ToString())
-      << ", " << EXPR_VALUE_FOR_LOG(queue_.size())
-      << ", " << EXPR_VALUE_FOR_LOG(queue_);
+      << ", " << EXPR_VALUE_FOR_LOG(max_ht_lease_seen_.load())
+      << ", " << EXPR_VALUE_FOR_LOG(last_replicated_.load())
+      << ", " << EXPR_VALUE_FOR_LOG(queue_front_.load())
+      << ", " << EXPR_VALUE_FOR_LOG(clock_->Now());
+
+  UpdateAtomicMax(has_lease ? &max_safe_time_returned_with_lease_
+                            : &max_safe_time_returned_without_lease_,
+                  result);
+}
 
-  if (has_lease) {
-    max_safe_time_returned_with_lease_ = { result, source };
+template <class Predicate>
+bool MvccManager::WaitFor(MonoTime deadline, std::unique_lock<std::mutex>* lock,
+                          const Predicate& predicate) const {
+  ++waiters_;
+  bool result = true;
+  if (deadline == MonoTime::kMax) {
+    cond_.wait(*lock, predicate);
   } else {
-    max_safe_time_returned_without_lease_ = { result, source };
+    result = cond_.wait_until(*lock, deadline.ToSteadyTimePoint(), predicate);
   }
+  --waiters_;
   return result;
 }
 
+void MvccManager::BeginPublish() {
+  version_.fetch_add(1, std::memory_order_seq_cst);
+}
+
+void MvccManager::EndPublish() {
+  queue_front_.store(queue_.empty() ? HybridTime::kMax : queue_.front(),
+                     std::memory_order_relaxed);
+  version_.fetch_add(1, std::memory_order_release);
+}
+
+void MvccManager::NotifyWaiters() {
+  // Waiters register themselves with mutex_ locked, before checking their condition, and this is
+  // invoked after a modification made with mutex_ locked. So missing a waiter here means that it
+  // will observe the modification.
+  if (waiters_.load() != 0) {
+    cond_.notify_all();
+  }
+}
+
 HybridTime MvccManager::LastReplicatedHybridTime() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << last_replicated_;
-  return last_replicated_;
+  auto result = last_replicated_.load();
+  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << result;
+  return result;
 }
 
 }  // namespace tablet
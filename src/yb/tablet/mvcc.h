@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
@@ -50,19 +51,17 @@ namespace tablet {
 // checking purposes.
 YB_DEFINE_ENUM(SafeTimeSource, (kUnknown)(kNow)(kNextInQueue)(kHybridTimeLease));
 
-struct SafeTimeWithSource {
-  HybridTime safe_time = HybridTime::kMin;
-  SafeTimeSource source = SafeTimeSource::kUnknown;
-
-  std::string ToString();
-};
-
 // MvccManager is used to track operations.
 // When new operation is initiated its time should be added using AddPending.
 // When operation is replicated or aborted, MvccManager is notified using Replicated or Aborted
 // methods.
 // Operations could be replicated only in the same order as they were added.
 // Time of newly added operation should be after time of all previously added operations.
+//
+// Modifications are serialized by a mutex, but safe time is read without locking in the common
+// case. Modifying methods publish the state required to compute safe time to atomics, guarded by
+// a sequence counter, and readers retry under the mutex only when they observe a concurrent
+// modification or have to wait for safe time to advance.
 class MvccManager {
  public:
   // `prefix` is used for logging.
@@ -129,11 +128,42 @@ class MvccManager {
   HybridTime LastReplicatedHybridTime() const;
 
  private:
+  // Checks ht_lease and updates max_ht_lease_seen_ with it. Returns true if ht_lease is a real
+  // lease, i.e. not kMax.
+  bool RegisterHtLease(HybridTime min_allowed, HybridTime ht_lease) const;
+
+  // Computes safe time from the published state. Should be invoked either with mutex_ locked or
+  // as part of a read validated by version_.
+  HybridTime ComputeSafeTime(bool has_lease, SafeTimeSource* source) const;
+
+  // Returns safe time if it could be computed without locking and it is not less than
+  // min_allowed. Otherwise returns invalid hybrid time.
+  HybridTime TryGetSafeTimeLockFree(HybridTime min_allowed, HybridTime ht_lease) const;
+
   HybridTime DoGetSafeTime(HybridTime min_allowed,
                            MonoTime deadline,
                            HybridTime ht_lease,
                            std::unique_lock<std::mutex>* lock) const;
 
+  // Checks that safe time does not go backwards and remembers the returned value.
+  void SafeTimeReturned(HybridTime result, HybridTime enforced_min_time, bool has_lease,
+                        HybridTime ht_lease) const;
+
+  // Waits on cond_ until predicate is satisfied or deadline happens. Returns false on timeout.
+  template <class Predicate>
+  bool WaitFor(MonoTime deadline, std::unique_lock<std::mutex>* lock,
+               const Predicate& predicate) const;
+
+  // Starts modification, that should be visible to lock-free readers. Should be invoked with
+  // mutex_ locked, before reading the clock.
+  void BeginPublish();
+
+  // Publishes the modified state and finishes modification started by BeginPublish.
+  void EndPublish();
+
+  // Wakes up threads waiting for safe time, if any.
+  void NotifyWaiters();
+
   const std::string& LogPrefix() const { return prefix_; }
   void PopFront(std::lock_guard<std::mutex>* lock);
 
@@ -142,6 +172,10 @@ class MvccManager {
   mutable std::mutex mutex_;
   mutable std::condition_variable cond_;
 
+  // Number of threads waiting on cond_. Updated with mutex_ locked, so writers could skip
+  // notification when nobody waits.
+  mutable std::atomic<size_t> waiters_{0};
+
   // An ordered queue of times of tracked operations.
   std::deque<HybridTime> queue_;
 
@@ -149,21 +183,28 @@ class MvccManager {
   // Required because we could abort operations from the middle of the queue.
   std::priority_queue<HybridTime, std::vector<HybridTime>, std::greater<>> aborted_;
 
-  HybridTime last_replicated_ = HybridTime::kMin;
+  // Sequence counter of modifications. Odd while a modification is in progress. Lock-free readers
+  // use the published state only if the counter was even and did not change while they read it.
+  std::atomic<uint64_t> version_{0};
+
+  // Time of the first operation in queue_, or kMax when the queue is empty.
+  std::atomic<HybridTime> queue_front_{HybridTime::kMax};
+
+  std::atomic<HybridTime> last_replicated_{HybridTime::kMin};
 
   // If we are a follower, this is the latest safe time sent by the leader to us. If we are the
   // leader, this is a safe time that gets updated every time the majority-replicated watermarks
   // change.
-  HybridTime propagated_safe_time_ = HybridTime::kMin;
+  std::atomic<HybridTime> propagated_safe_time_{HybridTime::kMin};
 
   // Because different calls that have current hybrid time leader lease as an argument can come to
   // us out of order, we might see an older value of hybrid time leader lease expiration after a
   // newer value. We mitigate this by always using the highest value we've seen.
-  mutable HybridTime max_ht_lease_seen_ = HybridTime::kMin;
+  mutable std::atomic<HybridTime> max_ht_lease_seen_{HybridTime::kMin};
 
-  mutable SafeTimeWithSource max_safe_time_returned_with_lease_;
-  mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
-  mutable HybridTime max_safe_time_returned_for_follower_ = HybridTime::kMin;
+  mutable std::atomic<HybridTime> max_safe_time_returned_with_lease_{HybridTime::kMin};
+  mutable std::atomic<HybridTime> max_safe_time_returned_without_lease_{HybridTime::kMin};
+  mutable std::atomic<HybridTime> max_safe_time_returned_for_follower_{HybridTime::kMin};
 };
 
 }  // namespace tablet
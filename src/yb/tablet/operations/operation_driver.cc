@@ -36,10 +36,12 @@
 
 #include "yb/client/client.h"
 #include "yb/consensus/consensus.h"
+#include "yb/gutil/casts.h"
 #include "yb/gutil/strings/strcat.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/operation_tracker.h"
+#include "yb/tablet/operations/write_operation.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/logging.h"
@@ -422,6 +424,23 @@ void OperationDriver::ApplyTask() {
   // and end up calling Finalize() while we're still in this code.
   scoped_refptr<OperationDriver> ref(this);
 
+  Tablet* tablet = operation_->state()->tablet();
+  if (tablet) {
+    // Writes of a follower could be combined with writes of the following operations. Such writes
+    // are finished after the combined batch is written.
+    if (operation_->operation_type() == OperationType::kWrite &&
+        operation_->type() == consensus::REPLICA &&
+        tablet->AddToApplyBatch(
+            down_cast<WriteOperationState*>(mutable_state()),
+            [this, ref] {
+              operation_->PreCommit();
+              Finalize();
+            })) {
+      return;
+    }
+    tablet->FlushApplyBatch();
+  }
+
   {
     CHECK_OK(operation_->Apply());
 
@@ -207,6 +207,13 @@ void OperationTracker::Release(OperationDriver* driver) {
   }
 }
 
+int64_t OperationTracker::AvailableMemory() const {
+  if (!mem_tracker_) {
+    return -1;
+  }
+  return std::max<int64_t>(mem_tracker_->SpareCapacity(), 0);
+}
+
 std::vector<scoped_refptr<OperationDriver>> OperationTracker::GetPendingOperations() const {
   std::vector<scoped_refptr<OperationDriver>> result;
   {
@@ -78,6 +78,10 @@ class OperationTracker {
   // Returns number of pending operations.
   int GetNumPendingForTests() const;
 
+  // Returns memory that could be consumed by new operations without hitting the limit, or -1 if
+  // operation memory is not limited.
+  int64_t AvailableMemory() const;
+
   void WaitForAllToFinish() const;
   CHECKED_STATUS WaitForAllToFinish(const MonoDelta& timeout) const;
 
@@ -84,11 +84,13 @@ consensus::ReplicateMsgPtr WriteOperation::NewReplicateMsg() {
 
 Status WriteOperation::Prepare() {
   TRACE_EVENT0("txn", "WriteOperation::Prepare");
+  state()->RecordStage(WriteStage::kPrepared);
   return Status::OK();
 }
 
 void WriteOperation::DoStart() {
   TRACE("Start()");
+  state()->RecordStage(WriteStage::kStarted);
   state()->tablet()->StartOperation(state());
 }
 
@@ -97,6 +99,7 @@ void WriteOperation::DoStart() {
 Status WriteOperation::Apply() {
   TRACE_EVENT0("txn", "WriteOperation::Apply");
   TRACE("APPLY: Starting");
+  state()->RecordStage(WriteStage::kReplicated);
 
   if (PREDICT_FALSE(
           ANNOTATE_UNPROTECTED_READ(FLAGS_tablet_inject_latency_on_apply_write_txn_ms) > 0)) {
@@ -108,6 +111,7 @@ Status WriteOperation::Apply() {
   Tablet* tablet = state()->tablet();
 
   tablet->ApplyRowOperations(state());
+  state()->RecordStage(WriteStage::kApplied);
 
   return Status::OK();
 }
@@ -132,14 +136,46 @@ void WriteOperation::Finish(OperationResult result) {
   // make the changes visible to readers.
   TRACE("FINISH: making edits visible");
   state()->Commit();
+  state()->RecordStage(WriteStage::kCommitted);
 
   TabletMetrics* metrics = tablet()->metrics();
   if (metrics && type() == consensus::LEADER) {
     auto op_duration_usec = MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds();
     metrics->write_op_duration_client_propagated_consistency->Increment(op_duration_usec);
+    RecordStageLatencies(metrics);
   }
 }
 
+void WriteOperation::RecordStageLatencies(TabletMetrics* metrics) {
+  const std::pair<WriteStage, Histogram*> stages[] = {
+    { WriteStage::kDocOperationsPerformed, metrics->write_doc_operations_latency.get() },
+    { WriteStage::kPrepared, metrics->write_prepare_latency.get() },
+    { WriteStage::kStarted, metrics->write_start_latency.get() },
+    { WriteStage::kReplicated, metrics->write_replicate_latency.get() },
+    { WriteStage::kApplied, metrics->write_apply_latency.get() },
+    { WriteStage::kCommitted, metrics->write_commit_latency.get() },
+  };
+  // Each stage is measured from the previous reached one, so a stage that was skipped, e.g. doc
+  // operations of writes that were not submitted through TabletPeer::SubmitWrite, is not reported.
+  MonoTime previous = state()->stage_time(WriteStage::kCreated);
+  std::string breakdown;
+  for (const auto& stage : stages) {
+    const MonoTime time = state()->stage_time(stage.first);
+    if (!time.Initialized()) {
+      continue;
+    }
+    if (previous.Initialized()) {
+      const int64_t elapsed_us = time.GetDeltaSince(previous).ToMicroseconds();
+      stage.second->Increment(elapsed_us);
+      breakdown += Substitute("$0$1: $2 us", breakdown.empty() ? "" : ", ",
+                              ToCString(stage.first) + 1, elapsed_us);
+    }
+    previous = time;
+  }
+  // Slow query traces include these per stage latencies.
+  TRACE("Write stages: $0", breakdown);
+}
+
 string WriteOperation::ToString() const {
   MonoTime now(MonoTime::Now());
   MonoDelta d = now.GetDeltaSince(start_time_);
@@ -158,6 +194,7 @@ WriteOperationState::WriteOperationState(Tablet* tablet,
       // layer.
       request_(request ? new WriteRequestPB(*request) : nullptr),
       response_(response) {
+  RecordStage(WriteStage::kCreated);
 }
 
 void WriteOperationState::Abort() {
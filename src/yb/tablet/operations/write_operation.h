@@ -33,6 +33,7 @@
 #ifndef YB_TABLET_OPERATIONS_WRITE_OPERATION_H
 #define YB_TABLET_OPERATIONS_WRITE_OPERATION_H
 
+#include <array>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -52,7 +53,9 @@
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/operations/operation.h"
 
+#include "yb/util/enums.h"
 #include "yb/util/locks.h"
+#include "yb/util/monotime.h"
 
 namespace yb {
 struct DecodedRowOperation;
@@ -69,9 +72,21 @@ class WriteResponsePB;
 
 namespace tablet {
 class Tablet;
+struct TabletMetrics;
 
 using docdb::LockBatch;
 
+// Stages of the write path on the leader, in the order they are passed:
+// kCreated - the write request was received and the operation state was created.
+// kDocOperationsPerformed - locks were acquired and doc operations produced the write batch.
+// kPrepared - the operation was picked up by the preparer.
+// kStarted - hybrid time was assigned and the operation was appended to the Raft batch.
+// kReplicated - the operation was replicated and its apply started.
+// kApplied - the write batch was applied to RocksDB.
+// kCommitted - the write was made visible to readers.
+YB_DEFINE_ENUM(WriteStage, (kCreated)(kDocOperationsPerformed)(kPrepared)(kStarted)(kReplicated)
+                           (kApplied)(kCommitted));
+
 // A OperationState for a batch of inserts/mutates. This class holds and
 // owns most everything related to a transaction, including the Replicate and Commit PB messages
 //
@@ -147,6 +162,16 @@ class WriteOperationState : public OperationState {
   // Releases all the DocDB locks acquired by this transaction.
   void ReleaseDocDbLocks(Tablet* tablet);
 
+  // Records that the operation has reached the specified stage.
+  void RecordStage(WriteStage stage) {
+    stage_times_[to_underlying(stage)] = MonoTime::Now();
+  }
+
+  // Returns the time the specified stage was reached, uninitialized if it was not reached.
+  MonoTime stage_time(WriteStage stage) const {
+    return stage_times_[to_underlying(stage)];
+  }
+
   // Resets this OperationState, releasing all locks, destroying all prepared
   // writes, clearing the transaction result _and_ committing the current Mvcc
   // transaction.
@@ -179,6 +204,8 @@ class WriteOperationState : public OperationState {
   // or if an error happens.
   LockBatch docdb_locks_;
 
+  std::array<MonoTime, kElementsInWriteStage> stage_times_;
+
   DISALLOW_COPY_AND_ASSIGN(WriteOperationState);
 };
 
@@ -236,6 +263,9 @@ class WriteOperation : public Operation {
   // Actually starts the Mvcc transaction and assigns a hybrid_time to this transaction.
   void DoStart() override;
 
+  // Updates tablet metrics with time spent in each write stage.
+  void RecordStageLatencies(TabletMetrics* metrics);
+
   // this transaction's start time
   MonoTime start_time_;
 
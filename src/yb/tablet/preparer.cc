@@ -22,14 +22,31 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/consensus/consensus.h"
 #include "yb/tablet/preparer.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/threadpool.h"
 
-DEFINE_int32(max_group_replicate_batch_size, 16,
+using namespace yb::size_literals;
+
+DEFINE_int32(max_group_replicate_batch_size, 64,
              "Maximum number of operations to submit to consensus for replication in a batch.");
 
+DEFINE_int32(max_group_replicate_batch_bytes, 4_MB,
+             "Maximum total size of operations to submit to consensus for replication in a batch.");
+TAG_FLAG(max_group_replicate_batch_bytes, advanced);
+TAG_FLAG(max_group_replicate_batch_bytes, runtime);
+
+DEFINE_int32(max_group_replicate_batch_delay_us, 1000,
+             "Maximum time that the first operation of a batch waits for more operations to be "
+             "added to the batch, while the prepare queue is not empty. 0 means no limit.");
+TAG_FLAG(max_group_replicate_batch_delay_us, advanced);
+TAG_FLAG(max_group_replicate_batch_delay_us, runtime);
+
 // We have to make the queue length really long. Otherwise we risk crashes on followers when they
 // fail to append entries to the queue, as we try to cancel the operation in that case, and it
 // is not possible to cancel an already-replicated operation. The proper way to handle that would
@@ -41,6 +58,17 @@ DEFINE_int32(max_group_replicate_batch_size, 16,
 DEFINE_int32(prepare_queue_max_size, 100000,
              "Maximum number of operations waiting in the per-tablet prepare queue.");
 
+METRIC_DEFINE_histogram(
+    tablet, group_replicate_batch_size, "Group Replicate Batch Size",
+    yb::MetricUnit::kOperations,
+    "Number of leader-side operations submitted to consensus for replication in a batch.",
+    1024, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, prepare_queue_wait, "Prepare Queue Wait", yb::MetricUnit::kMicroseconds,
+    "Time from submitting an operation until the preparer starts processing it.",
+    60000000LU, 2);
+
 using std::vector;
 
 namespace yb {
@@ -54,7 +82,8 @@ namespace tablet {
 
 class PreparerImpl {
  public:
-  explicit PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+               const scoped_refptr<MetricEntity>& metric_entity);
   ~PreparerImpl();
   CHECKED_STATUS Start();
   void Stop();
@@ -90,6 +119,15 @@ class PreparerImpl {
 
   OperationDrivers leader_side_batch_;
 
+  // Total size of replicate messages in leader_side_batch_.
+  size_t leader_side_batch_bytes_ = 0;
+
+  // Time when the first operation was added to leader_side_batch_.
+  MonoTime leader_side_batch_start_;
+
+  scoped_refptr<Histogram> batch_size_histogram_;
+  scoped_refptr<Histogram> queue_wait_histogram_;
+
   std::unique_ptr<ThreadPoolToken> tablet_prepare_pool_token_;
 
   // A temporary buffer of rounds to replicate, used to reduce reallocation.
@@ -108,11 +146,16 @@ class PreparerImpl {
 };
 
 PreparerImpl::PreparerImpl(consensus::Consensus* consensus,
-                                     ThreadPool* tablet_prepare_pool)
+                           ThreadPool* tablet_prepare_pool,
+                           const scoped_refptr<MetricEntity>& metric_entity)
     : consensus_(consensus),
       queue_(FLAGS_prepare_queue_max_size),
       tablet_prepare_pool_token_(tablet_prepare_pool
                                      ->NewToken(ThreadPool::ExecutionMode::SERIAL)) {
+  if (metric_entity) {
+    batch_size_histogram_ = METRIC_group_replicate_batch_size.Instantiate(metric_entity);
+    queue_wait_histogram_ = METRIC_prepare_queue_wait.Instantiate(metric_entity);
+  }
 }
 
 PreparerImpl::~PreparerImpl() {
@@ -189,6 +232,12 @@ void PreparerImpl::Run() {
 void PreparerImpl::ProcessItem(OperationDriver* item) {
   CHECK_NOTNULL(item);
 
+  const bool need_now = queue_wait_histogram_ || FLAGS_max_group_replicate_batch_delay_us > 0;
+  const MonoTime now = need_now ? MonoTime::Now() : MonoTime();
+  if (queue_wait_histogram_) {
+    queue_wait_histogram_->Increment((now - item->start_time()).ToMicroseconds());
+  }
+
   if (item->is_leader_side()) {
     // AlterSchemaOperation::Prepare calls Tablet::CreatePreparedAlterSchema, which acquires the
     // schema lock. Because of this, we must not attempt to process two AlterSchemaOperations in
@@ -198,17 +247,30 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
     const bool apply_separately = operation_type == OperationType::kAlterSchema ||
                                   operation_type == OperationType::kEmpty;
     const int64_t bound_term = apply_separately ? -1 : item->consensus_round()->bound_term();
+    const size_t item_bytes =
+        apply_separately ? 0 : item->consensus_round()->replicate_msg()->ByteSizeLong();
 
-    // Don't add more than the max number of operations to a batch, and also don't add
-    // operations bound to different terms, so as not to fail unrelated operations
+    // Don't add operations bound to different terms, so as not to fail unrelated operations
     // unnecessarily in case of a bound term mismatch.
-    if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
-        (!leader_side_batch_.empty() &&
-            bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
+    if (!leader_side_batch_.empty() &&
+        bound_term != leader_side_batch_.back()->consensus_round()->bound_term()) {
       ProcessAndClearLeaderSideBatch();
     }
+    if (leader_side_batch_.empty()) {
+      leader_side_batch_start_ = now;
+    }
     leader_side_batch_.push_back(item);
-    if (apply_separately) {
+    leader_side_batch_bytes_ += item_bytes;
+
+    // The batch is also replicated when the queue becomes empty, so under low load operations do
+    // not wait for the batch to fill up. Under high load batches are limited by the number of
+    // operations, their total size and the delay of the first operation.
+    if (apply_separately ||
+        leader_side_batch_.size() >= static_cast<size_t>(FLAGS_max_group_replicate_batch_size) ||
+        leader_side_batch_bytes_ >= static_cast<size_t>(FLAGS_max_group_replicate_batch_bytes) ||
+        (FLAGS_max_group_replicate_batch_delay_us > 0 &&
+         (now - leader_side_batch_start_).ToMicroseconds() >=
+             FLAGS_max_group_replicate_batch_delay_us)) {
       ProcessAndClearLeaderSideBatch();
     }
   } else {
@@ -224,7 +286,8 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
     return;
   }
 
-  VLOG(1) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations";
+  VLOG(1) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations, "
+          << leader_side_batch_bytes_ << " bytes";
 
   auto iter = leader_side_batch_.begin();
   auto replication_subbatch_begin = iter;
@@ -256,6 +319,7 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
 
   leader_side_batch_.clear();
+  leader_side_batch_bytes_ = 0;
 }
 
 void PreparerImpl::ReplicateSubBatch(
@@ -273,6 +337,10 @@ void PreparerImpl::ReplicateSubBatch(
     }
   }
 
+  if (batch_size_histogram_) {
+    batch_size_histogram_->Increment(std::distance(batch_begin, batch_end));
+  }
+
   rounds_to_replicate_.clear();
   rounds_to_replicate_.reserve(std::distance(batch_begin, batch_end));
   for (auto batch_iter = batch_begin; batch_iter != batch_end; ++batch_iter) {
@@ -299,8 +367,9 @@ void PreparerImpl::ReplicateSubBatch(
 // ------------------------------------------------------------------------------------------------
 // Preparer
 
-Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread)
-    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread)) {
+Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread,
+                   const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread, metric_entity)) {
 }
 
 Preparer::~Preparer() = default;
@@ -16,13 +16,17 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/gutil/ref_counted.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
 
 DECLARE_int32(max_group_replicate_batch_size);
+DECLARE_int32(max_group_replicate_batch_bytes);
+DECLARE_int32(max_group_replicate_batch_delay_us);
 DECLARE_int32(prepare_queue_max_size);
 
 namespace yb {
+class MetricEntity;
 class ThreadPool;
 
 namespace consensus {
@@ -39,9 +43,14 @@ class PreparerImpl;
 // leader-side transactions, submits them for replication to the consensus in batches. This is
 // useful because we have a "fat lock" in the consensus.
 // Preparer does not manage a thread but only submits to a token in a thread pool.
+//
+// Leader-side operations are batched while the prepare queue is not empty, up to
+// max_group_replicate_batch_size operations, max_group_replicate_batch_bytes bytes, or
+// max_group_replicate_batch_delay_us of waiting for the first operation of the batch.
 class Preparer {
  public:
-  explicit Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+           const scoped_refptr<MetricEntity>& metric_entity);
   ~Preparer();
 
   CHECKED_STATUS Start();
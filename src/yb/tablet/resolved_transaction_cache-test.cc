@@ -0,0 +1,66 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/resolved_transaction_cache.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tablet {
+
+class ResolvedTransactionCacheTest : public YBTest {
+};
+
+TEST_F(ResolvedTransactionCacheTest, LookupAndErase) {
+  ResolvedTransactionCache cache(100);
+  auto committed = GenerateTransactionId();
+  auto aborted = GenerateTransactionId();
+  HybridTime commit_time(1000);
+  cache.Insert(committed, {TransactionStatus::COMMITTED, commit_time});
+  cache.Insert(aborted, {TransactionStatus::ABORTED, HybridTime::kInvalid});
+
+  auto result = cache.Lookup(committed);
+  ASSERT_TRUE(result.is_initialized());
+  ASSERT_EQ(TransactionStatus::COMMITTED, result->status);
+  ASSERT_EQ(commit_time, result->status_time);
+
+  result = cache.Lookup(aborted);
+  ASSERT_TRUE(result.is_initialized());
+  ASSERT_EQ(TransactionStatus::ABORTED, result->status);
+
+  ASSERT_FALSE(cache.Lookup(GenerateTransactionId()).is_initialized());
+
+  cache.Erase(committed);
+  ASSERT_FALSE(cache.Lookup(committed).is_initialized());
+  ASSERT_EQ(1U, cache.TEST_size());
+}
+
+TEST_F(ResolvedTransactionCacheTest, Capacity) {
+  constexpr size_t kCapacity = 80;
+  ResolvedTransactionCache cache(kCapacity);
+  std::vector<TransactionId> ids;
+  for (size_t i = 0; i != kCapacity * 10; ++i) {
+    ids.push_back(GenerateTransactionId());
+    cache.Insert(ids.back(), {TransactionStatus::ABORTED, HybridTime::kInvalid});
+    // Keep the first transaction recently used, so it should not be evicted.
+    ASSERT_TRUE(cache.Lookup(ids.front()).is_initialized());
+  }
+  ASSERT_LE(cache.TEST_size(), kCapacity);
+  ASSERT_TRUE(cache.Lookup(ids.back()).is_initialized());
+}
+
+} // namespace tablet
+} // namespace yb
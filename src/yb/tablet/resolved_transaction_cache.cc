@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/tablet/resolved_transaction_cache.h"
+
+namespace yb {
+namespace tablet {
+
+ResolvedTransactionCache::ResolvedTransactionCache(size_t capacity)
+    : shard_capacity_(std::max<size_t>(1, capacity / kShards)) {
+}
+
+ResolvedTransactionCache::Shard& ResolvedTransactionCache::ShardFor(const TransactionId& id) {
+  return shards_[TransactionIdHash()(id) % kShards];
+}
+
+boost::optional<TransactionStatusResult> ResolvedTransactionCache::Lookup(
+    const TransactionId& id) {
+  auto& shard = ShardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(id);
+  if (it == shard.entries.end()) {
+    return boost::none;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru_position);
+  return it->second.result;
+}
+
+void ResolvedTransactionCache::Insert(const TransactionId& id,
+                                      const TransactionStatusResult& result) {
+  DCHECK(result.status == TransactionStatus::COMMITTED ||
+         result.status == TransactionStatus::ABORTED)
+      << "Status: " << TransactionStatus_Name(result.status);
+
+  auto& shard = ShardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(id);
+  if (it != shard.entries.end()) {
+    it->second.result = result;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru_position);
+    return;
+  }
+  if (shard.entries.size() >= shard_capacity_) {
+    shard.entries.erase(shard.lru.back());
+    shard.lru.pop_back();
+  }
+  shard.lru.push_front(id);
+  shard.entries.emplace(id, Entry{result, shard.lru.begin()});
+}
+
+void ResolvedTransactionCache::Erase(const TransactionId& id) {
+  auto& shard = ShardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(id);
+  if (it == shard.entries.end()) {
+    return;
+  }
+  shard.lru.erase(it->second.lru_position);
+  shard.entries.erase(it);
+}
+
+size_t ResolvedTransactionCache::TEST_size() const {
+  size_t result = 0;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.entries.size();
+  }
+  return result;
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,77 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_TABLET_RESOLVED_TRANSACTION_CACHE_H
+#define YB_TABLET_RESOLVED_TRANSACTION_CACHE_H
+
+#include <array>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/optional/optional.hpp>
+
+#include "yb/common/transaction.h"
+
+namespace yb {
+namespace tablet {
+
+// Cache of final statuses, i.e. COMMITTED with commit time or ABORTED, of other transactions that
+// readers of this tablet have found while resolving their intents. Shared by all readers of the
+// tablet, so the status of a transaction is requested from its status tablet only once.
+//
+// Final status does not depend on read time, so it is valid for any reader. Entries are removed
+// when intents of the transaction are applied or cleaned, since nobody would look for them after
+// that. Least recently used entries are evicted when capacity is reached.
+//
+// Entries are split between shards by transaction id, to reduce contention between readers.
+class ResolvedTransactionCache {
+ public:
+  // capacity is max number of cached transactions.
+  explicit ResolvedTransactionCache(size_t capacity);
+
+  boost::optional<TransactionStatusResult> Lookup(const TransactionId& id);
+
+  // Status should be COMMITTED or ABORTED.
+  void Insert(const TransactionId& id, const TransactionStatusResult& result);
+
+  void Erase(const TransactionId& id);
+
+  size_t TEST_size() const;
+
+ private:
+  static constexpr size_t kShards = 8;
+
+  struct Entry {
+    TransactionStatusResult result;
+    std::list<TransactionId>::iterator lru_position;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<TransactionId, Entry, TransactionIdHash> entries;
+    // Most recently used transactions are at front.
+    std::list<TransactionId> lru;
+  };
+
+  Shard& ShardFor(const TransactionId& id);
+
+  const size_t shard_capacity_;
+  std::array<Shard, kShards> shards_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_RESOLVED_TRANSACTION_CACHE_H
@@ -0,0 +1,183 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include <gtest/gtest.h>
+
+#include "yb/common/schema.h"
+
+#include "yb/docdb/doc_key.h"
+
+#include "yb/tablet/row_cache.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+constexpr uint16_t kHashCode = 1;
+constexpr int32_t kKeyColumnId = 10;
+constexpr int32_t kValueColumnId = 11;
+
+Schema CreateSchema() {
+  return Schema({ ColumnSchema("k", INT32, false /* is_nullable */, true /* is_hash_key */),
+                  ColumnSchema("v", INT32) },
+                { ColumnId(kKeyColumnId), ColumnId(kValueColumnId) },
+                1 /* key_columns */);
+}
+
+QLReadRequestPB CreateRequest(int32_t key) {
+  QLReadRequestPB request;
+  request.set_hash_code(kHashCode);
+  request.add_hashed_column_values()->mutable_value()->set_int32_value(key);
+  request.mutable_column_refs()->add_ids(kValueColumnId);
+  return request;
+}
+
+docdb::KeyValueWriteBatchPB CreateWriteBatch(int32_t key) {
+  docdb::KeyValueWriteBatchPB write_batch;
+  auto* kv_pair = write_batch.add_kv_pairs();
+  kv_pair->set_key(docdb::DocKey(kHashCode, { docdb::PrimitiveValue::Int32(key) }).Encode().data());
+  kv_pair->set_value("value");
+  return write_batch;
+}
+
+} // namespace
+
+class RowCacheTest : public YBTest {
+ protected:
+  void Insert(const RowCacheKey& key, uint64_t read_time, const std::string& rows_data) {
+    Insert(key, read_time, rows_data, cache_.generation());
+  }
+
+  void Insert(const RowCacheKey& key, uint64_t read_time, const std::string& rows_data,
+              uint64_t generation, int64_t min_ttl_seconds = -1) {
+    QLReadRequestResult result;
+    result.response.set_status(QLResponsePB::YQL_STATUS_OK);
+    result.rows_data.assign_copy(rows_data);
+    result.min_ttl_seconds = min_ttl_seconds;
+    cache_.Insert(key, HybridTime(read_time), generation, result);
+  }
+
+  bool Lookup(const RowCacheKey& key, uint64_t read_time, std::string* rows_data = nullptr) {
+    QLReadRequestResult result;
+    if (!cache_.Lookup(key, HybridTime(read_time), &result)) {
+      return false;
+    }
+    if (rows_data) {
+      *rows_data = result.rows_data.ToString();
+    }
+    return true;
+  }
+
+  const Schema schema_ = CreateSchema();
+  RowCache cache_{2};
+};
+
+TEST_F(RowCacheTest, MakeKey) {
+  RowCacheKey key;
+  ASSERT_TRUE(RowCache::MakeKey(CreateRequest(1), schema_, &key));
+
+  RowCacheKey same_key;
+  auto request = CreateRequest(1);
+  request.set_request_id(42);
+  ASSERT_TRUE(RowCache::MakeKey(request, schema_, &same_key));
+  ASSERT_EQ(key.doc_key, same_key.doc_key);
+  ASSERT_EQ(key.request, same_key.request);
+
+  // Scans and paged reads are not cached.
+  request = CreateRequest(1);
+  request.clear_hash_code();
+  ASSERT_FALSE(RowCache::MakeKey(request, schema_, &key));
+  request = CreateRequest(1);
+  request.set_max_hash_code(kHashCode + 1);
+  ASSERT_FALSE(RowCache::MakeKey(request, schema_, &key));
+  request = CreateRequest(1);
+  request.mutable_paging_state()->set_total_num_rows_read(1);
+  ASSERT_FALSE(RowCache::MakeKey(request, schema_, &key));
+
+  // Reads of key columns only are not cached, since expiration of such rows is not detected.
+  request = CreateRequest(1);
+  request.mutable_column_refs()->clear_ids();
+  request.mutable_column_refs()->add_ids(kKeyColumnId);
+  ASSERT_FALSE(RowCache::MakeKey(request, schema_, &key));
+}
+
+TEST_F(RowCacheTest, Ttl) {
+  RowCacheKey key1, key2;
+  ASSERT_TRUE(RowCache::MakeKey(CreateRequest(1), schema_, &key1));
+  ASSERT_TRUE(RowCache::MakeKey(CreateRequest(2), schema_, &key2));
+
+  const auto read_time = HybridTime::FromMicros(100 * MonoTime::kMicrosecondsPerSecond);
+  Insert(key1, read_time.ToUint64(), "row1", cache_.generation(), 10 /* min_ttl_seconds */);
+  // Remaining TTL is rounded, so the result is valid for one second less than the TTL.
+  ASSERT_TRUE(Lookup(key1, read_time.AddMicroseconds(
+      9 * MonoTime::kMicrosecondsPerSecond - 1).ToUint64()));
+  ASSERT_FALSE(Lookup(key1, read_time.AddMicroseconds(
+      9 * MonoTime::kMicrosecondsPerSecond).ToUint64()));
+
+  // Values that expire within a second are not cached.
+  Insert(key2, read_time.ToUint64(), "row2", cache_.generation(), 1 /* min_ttl_seconds */);
+  ASSERT_FALSE(Lookup(key2, read_time.ToUint64()));
+}
+
+TEST_F(RowCacheTest, Invalidation) {
+  RowCacheKey key1, key2;
+  ASSERT_TRUE(RowCache::MakeKey(CreateRequest(1), schema_, &key1));
+  ASSERT_TRUE(RowCache::MakeKey(CreateRequest(2), schema_, &key2));
+
+  Insert(key1, 100, "row1");
+  Insert(key2, 100, "row2");
+  ASSERT_FALSE(Lookup(key1, 99));
+  std::string rows_data;
+  ASSERT_TRUE(Lookup(key1, 100, &rows_data));
+  ASSERT_EQ("row1", rows_data);
+
+  // Write to a row invalidates only results for this row.
+  cache_.Invalidate(CreateWriteBatch(1), HybridTime(200));
+  ASSERT_FALSE(Lookup(key1, 300));
+  ASSERT_TRUE(Lookup(key2, 300));
+
+  // Result of a read before the applied write could miss it.
+  Insert(key1, 150, "row1");
+  ASSERT_FALSE(Lookup(key1, 300));
+  Insert(key1, 200, "row1");
+  ASSERT_TRUE(Lookup(key1, 300));
+
+  // Reads that started before data was cleared are not cached.
+  const auto generation = cache_.generation();
+  cache_.Clear();
+  ASSERT_FALSE(Lookup(key2, 300));
+  Insert(key2, 300, "row2", generation);
+  ASSERT_FALSE(Lookup(key2, 300));
+}
+
+TEST_F(RowCacheTest, Eviction) {
+  RowCacheKey keys[3];
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_TRUE(RowCache::MakeKey(CreateRequest(i), schema_, &keys[i]));
+  }
+  Insert(keys[0], 100, "row0");
+  Insert(keys[1], 100, "row1");
+  // Make row 0 the most recently used one.
+  ASSERT_TRUE(Lookup(keys[0], 100));
+  Insert(keys[2], 100, "row2");
+  ASSERT_TRUE(Lookup(keys[0], 100));
+  ASSERT_FALSE(Lookup(keys[1], 100));
+  ASSERT_TRUE(Lookup(keys[2], 100));
+}
+
+} // namespace tablet
+} // namespace yb
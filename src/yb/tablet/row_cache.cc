@@ -0,0 +1,191 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/tablet/row_cache.h"
+
+#include <algorithm>
+
+#include "yb/common/schema.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_util.h"
+
+namespace yb {
+namespace tablet {
+
+RowCache::RowCache(size_t capacity) : capacity_(capacity) {
+}
+
+bool RowCache::MakeKey(const QLReadRequestPB& request, const Schema& schema, RowCacheKey* key) {
+  const size_t num_hash_key_columns = schema.num_hash_key_columns();
+  if (num_hash_key_columns == 0 || !request.has_hash_code() ||
+      static_cast<size_t>(request.hashed_column_values_size()) != num_hash_key_columns ||
+      (request.has_max_hash_code() && request.max_hash_code() != request.hash_code()) ||
+      request.has_paging_state()) {
+    return false;
+  }
+
+  // Existence of rows read without non-key columns depends on the liveness column, whose TTL is not
+  // reported by the read, so their expiration could not be detected.
+  bool has_non_key_column = request.column_refs().static_ids_size() != 0;
+  for (const auto id : request.column_refs().ids()) {
+    const int idx = schema.find_column_by_id(ColumnId(id));
+    if (idx >= 0 && !schema.is_key_column(idx)) {
+      has_non_key_column = true;
+      break;
+    }
+  }
+  if (!has_non_key_column) {
+    return false;
+  }
+
+  std::vector<docdb::PrimitiveValue> hashed_components;
+  if (!docdb::QLKeyColumnValuesToPrimitiveValues(
+          request.hashed_column_values(), schema, 0, num_hash_key_columns,
+          &hashed_components).ok()) {
+    return false;
+  }
+  const auto encoded_doc_key = docdb::DocKey(request.hash_code(), hashed_components).Encode();
+  const auto hashed_part_size = docdb::DocKey::EncodedSize(
+      encoded_doc_key.AsSlice(), docdb::DocKeyPart::HASHED_PART_ONLY);
+  if (!hashed_part_size.ok()) {
+    return false;
+  }
+  key->doc_key.assign(encoded_doc_key.data(), 0, *hashed_part_size);
+
+  QLReadRequestPB request_copy(request);
+  request_copy.clear_request_id();
+  request_copy.clear_remote_endpoint();
+  request_copy.clear_query_id();
+  key->request = request_copy.SerializeAsString();
+  return true;
+}
+
+bool RowCache::Lookup(
+    const RowCacheKey& key, HybridTime read_time, QLReadRequestResult* result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key.doc_key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  for (const auto& cached : it->second.results) {
+    if (cached.request == key.request && cached.read_time <= read_time &&
+        read_time < cached.expire_time) {
+      result->response = cached.response;
+      result->rows_data.assign_copy(cached.rows_data);
+      result->restart_read_ht = HybridTime::kInvalid;
+      lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t RowCache::generation() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return generation_;
+}
+
+void RowCache::Insert(
+    const RowCacheKey& key, HybridTime read_time, uint64_t generation,
+    const QLReadRequestResult& result) {
+  if (result.restart_read_ht.is_valid() ||
+      result.response.status() != QLResponsePB::YQL_STATUS_OK ||
+      result.response.has_paging_state()) {
+    return;
+  }
+
+  HybridTime expire_time = HybridTime::kMax;
+  if (result.min_ttl_seconds >= 0) {
+    // Remaining TTL is rounded to whole seconds, so it could be up to a second longer than the
+    // actual one.
+    if (result.min_ttl_seconds <= 1) {
+      return;
+    }
+    expire_time = read_time.AddMicroseconds(
+        (result.min_ttl_seconds - 1) * MonoTime::kMicrosecondsPerSecond);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A write that was applied after the read could be invisible to it, but its invalidation has
+  // already happened, so the result could not be cached.
+  if (generation != generation_ || read_time < max_write_time_) {
+    return;
+  }
+
+  auto it = entries_.find(key.doc_key);
+  if (it == entries_.end()) {
+    if (entries_.size() >= capacity_) {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+    lru_.push_front(key.doc_key);
+    it = entries_.emplace(key.doc_key, Entry()).first;
+    it->second.lru_position = lru_.begin();
+  } else {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  }
+
+  auto& results = it->second.results;
+  auto result_it = std::find_if(
+      results.begin(), results.end(),
+      [&key](const CachedResult& cached) { return cached.request == key.request; });
+  if (result_it == results.end()) {
+    if (results.size() >= kMaxResultsPerKey) {
+      results.erase(results.begin());
+    }
+    results.emplace_back();
+    result_it = results.end() - 1;
+  } else if (result_it->read_time > read_time) {
+    return;
+  }
+  result_it->request = key.request;
+  result_it->read_time = read_time;
+  result_it->expire_time = expire_time;
+  result_it->response = result.response;
+  result_it->rows_data.assign(result.rows_data.c_str(), result.rows_data.size());
+}
+
+void RowCache::Invalidate(const docdb::KeyValueWriteBatchPB& write_batch, HybridTime hybrid_time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_write_time_.MakeAtLeast(hybrid_time);
+  if (entries_.empty()) {
+    return;
+  }
+  for (const auto& kv_pair : write_batch.kv_pairs()) {
+    const auto hashed_part_size = docdb::DocKey::EncodedSize(
+        kv_pair.key(), docdb::DocKeyPart::HASHED_PART_ONLY);
+    if (!hashed_part_size.ok()) {
+      // Should not happen, but invalidating everything is always safe.
+      entries_.clear();
+      lru_.clear();
+      return;
+    }
+    auto it = entries_.find(kv_pair.key().substr(0, *hashed_part_size));
+    if (it != entries_.end()) {
+      lru_.erase(it->second.lru_position);
+      entries_.erase(it);
+    }
+  }
+}
+
+void RowCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  entries_.clear();
+  lru_.clear();
+}
+
+} // namespace tablet
+} // namespace yb
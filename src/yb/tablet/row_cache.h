@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_TABLET_ROW_CACHE_H
+#define YB_TABLET_ROW_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/ql_protocol.pb.h"
+
+#include "yb/docdb/docdb.pb.h"
+
+#include "yb/tablet/abstract_tablet.h"
+
+namespace yb {
+
+class Schema;
+
+namespace tablet {
+
+struct RowCacheKey {
+  // Hashed part of the encoded DocKey of the rows read by the request.
+  std::string doc_key;
+  // Serialized request without fields that are different for each request.
+  std::string request;
+};
+
+// Cache of results of QL point reads, i.e. reads of rows with a single hashed DocKey.
+//
+// Result read at some hybrid time stays valid for reads at later hybrid times, until a write to
+// the same DocKey is applied. Writes should be passed to Invalidate after they are applied, so a
+// result is accepted for caching only if no write with a greater hybrid time was applied before.
+// Result that contains values with TTL is only served to reads before the first of them expires.
+//
+// Only used for non-transactional tables without default TTL.
+class RowCache {
+ public:
+  // capacity is max number of cached DocKeys.
+  explicit RowCache(size_t capacity);
+
+  // Fills key for the request, returns false if results of this request should not be cached.
+  static bool MakeKey(const QLReadRequestPB& request, const Schema& schema, RowCacheKey* key);
+
+  // Fills result with cached result of the request, if it is valid for the read time.
+  bool Lookup(const RowCacheKey& key, HybridTime read_time, QLReadRequestResult* result);
+
+  // Value of generation should be obtained before reading the result, so results read before
+  // Clear are not cached.
+  uint64_t generation() const;
+
+  void Insert(
+      const RowCacheKey& key, HybridTime read_time, uint64_t generation,
+      const QLReadRequestResult& result);
+
+  // Removes results for rows modified by the applied write batch.
+  void Invalidate(const docdb::KeyValueWriteBatchPB& write_batch, HybridTime hybrid_time);
+
+  // Removes all results. Should be invoked when data is changed without write batches.
+  void Clear();
+
+ private:
+  struct CachedResult {
+    std::string request;
+    HybridTime read_time;
+    // Result is not valid for reads at this or later hybrid times.
+    HybridTime expire_time;
+    QLResponsePB response;
+    std::string rows_data;
+  };
+
+  // Max number of cached results for different requests to the same DocKey.
+  static constexpr size_t kMaxResultsPerKey = 4;
+
+  struct Entry {
+    std::vector<CachedResult> results;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // Most recently used DocKeys are at front.
+  std::list<std::string> lru_;
+  // Max hybrid time of applied writes.
+  HybridTime max_write_time_ = HybridTime::kMin;
+  uint64_t generation_ = 0;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_ROW_CACHE_H
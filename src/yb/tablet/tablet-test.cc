@@ -36,6 +36,9 @@
 
 #include "yb/common/row.h"
 #include "yb/common/ql_rowwise_iterator_interface.h"
+#include "yb/common/ql_value.h"
+
+#include "yb/consensus/consensus.h"
 
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/join.h"
@@ -50,6 +53,8 @@
 
 #include "yb/util/enums.h"
 
+DECLARE_bool(enable_single_row_blind_write_fast_path);
+
 using std::shared_ptr;
 using std::unordered_set;
 
@@ -171,6 +176,33 @@ TYPED_TEST(TestTablet, TestMultipleUpdates) {
   ASSERT_EQ(this->setup_.FormatDebugRow(1, 0, false), out_rows[1]);
 }
 
+// Test that single row blind writes, that skip read snapshot and isolation level resolution, give
+// the same rows as the general write path, and release their row locks.
+TYPED_TEST(TestTablet, TestSingleRowBlindWrite) {
+  LocalTabletWriter writer(this->tablet().get());
+  for (bool fast_path : {true, false}) {
+    FLAGS_enable_single_row_blind_write_fast_path = fast_path;
+    const int64_t key = fast_path ? 0 : 1;
+    const int64_t deleted_key = key + 2;
+
+    // Each write locks the same row, so a lock that is not released would block the next write.
+    ASSERT_OK(this->InsertTestRow(&writer, key, 1));
+    ASSERT_OK(this->UpdateTestRow(&writer, key, 2));
+    ASSERT_OK(this->DeleteTestRow(&writer, key));
+    ASSERT_OK(this->InsertTestRow(&writer, key, 3));
+    ASSERT_OK(this->UpdateTestRow(&writer, key, 4));
+
+    ASSERT_OK(this->InsertTestRow(&writer, deleted_key, 1));
+    ASSERT_OK(this->DeleteTestRow(&writer, deleted_key));
+  }
+
+  vector<string> out_rows;
+  ASSERT_OK(this->IterateToStringList(&out_rows));
+  ASSERT_EQ(2, out_rows.size());
+  ASSERT_EQ(this->setup_.FormatDebugRow(0, 4, false), out_rows[0]);
+  ASSERT_EQ(this->setup_.FormatDebugRow(1, 4, false), out_rows[1]);
+}
+
 // Test that metrics behave properly during tablet initialization
 TYPED_TEST(TestTablet, TestMetricsInit) {
   // Create a tablet, but do not open it
@@ -214,5 +246,62 @@ TYPED_TEST(TestTablet, TestFlushedOpId) {
   ASSERT_EQ(id.index, start_index + 2*kCount);
 }
 
+// Tests that writes of consecutive follower operations are combined into a single RocksDB write,
+// and that operations are finished only after this write.
+TYPED_TEST(TestTablet, TestApplyBatch) {
+  auto tablet = this->tablet().get();
+  constexpr int kCount = 10;
+  const int64_t start_index = 1000;
+
+  std::vector<tserver::WriteRequestPB> requests(kCount);
+  std::vector<tserver::WriteResponsePB> responses(kCount);
+  std::vector<std::unique_ptr<WriteOperationState>> states;
+  int num_finished = 0;
+
+  tablet->BeginApplyBatch();
+  for (int i = 0; i != kCount; ++i) {
+    QLWriteRequestPB* req = requests[i].mutable_ql_write_batch()->Add();
+    req->set_type(QLWriteRequestPB::QL_STMT_INSERT);
+    this->setup_.BuildRow(req, i, 555);
+    req->set_schema_version(tablet->metadata()->schema_version());
+    QLSetHashCode(req);
+
+    states.emplace_back(new WriteOperationState(tablet, &requests[i], &responses[i]));
+    auto* state = states.back().get();
+    HybridTime read_ht;
+    ASSERT_OK(tablet->AcquireLocksAndPerformDocOperations(MonoTime::Max(), state, &read_ht));
+    tablet->StartOperation(state);
+    state->mutable_op_id()->set_term(1);
+    state->mutable_op_id()->set_index(start_index + i);
+
+    // Followers apply the write batch that was replicated by the leader.
+    auto replicate = std::make_shared<consensus::ReplicateMsg>();
+    *replicate->mutable_write_request()->mutable_write_batch() = requests[i].write_batch();
+    state->set_consensus_round(
+        make_scoped_refptr(new consensus::ConsensusRound(nullptr, std::move(replicate))));
+
+    ASSERT_TRUE(tablet->AddToApplyBatch(state, [tablet, state, &num_finished] {
+      state->Commit();
+      state->ReleaseDocDbLocks(tablet);
+      ++num_finished;
+    }));
+  }
+  ASSERT_EQ(0, num_finished);
+  tablet->EndApplyBatch();
+  ASSERT_EQ(kCount, num_finished);
+
+  // Without an apply batch, operations are applied as usual.
+  ASSERT_FALSE(tablet->AddToApplyBatch(states.front().get(), [] {}));
+
+  vector<string> rows;
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(kCount, rows.size());
+
+  // The combined frontier covers the last operation of the batch.
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+  OpId id = ASSERT_RESULT(tablet->MaxPersistentOpId()).regular;
+  ASSERT_EQ(start_index + kCount - 1, id.index);
+}
+
 } // namespace tablet
 } // namespace yb
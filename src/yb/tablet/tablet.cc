@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <ostream>
@@ -57,6 +58,7 @@
 
 #include "yb/common/common.pb.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/partition.h"
 #include "yb/common/schema.h"
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/ql_rowblock.h"
@@ -66,14 +68,19 @@
 
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_sst_file_writer.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/lock_batch.h"
+#include "yb/docdb/value.h"
+#include "yb/docdb/wait_queue.h"
 
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/map-util.h"
@@ -84,7 +91,10 @@
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
 
+#include "yb/tablet/compaction_history.h"
 #include "yb/tablet/maintenance_manager.h"
+#include "yb/tablet/row_cache.h"
+#include "yb/tablet/tablet_load_tracker.h"
 #include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_retention_policy.h"
 #include "yb/tablet/transaction_coordinator.h"
@@ -93,6 +103,7 @@
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/tablet_options.h"
+#include "yb/util/allocation_sampler.h"
 #include "yb/util/bloom_filter.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/enums.h"
@@ -136,6 +147,39 @@ DEFINE_int32(intents_flush_max_delay_ms, 2000,
              "Max time to wait for regular db to flush during flush of intents. "
              "After this time flush of regular db will be forced.");
 
+DEFINE_int32(follower_apply_batch_max_ops, 128,
+             "Max number of consecutive committed write operations that a follower applies to "
+             "RocksDB in a single write batch. 1 disables batching.");
+TAG_FLAG(follower_apply_batch_max_ops, advanced);
+TAG_FLAG(follower_apply_batch_max_ops, runtime);
+
+DEFINE_bool(enable_single_row_blind_write_fast_path, true,
+            "Execute a write batch that consists of QL writes to a non-transactional table, that "
+            "do not read rows and do not update indexes, without read snapshot and index "
+            "maintenance machinery.");
+TAG_FLAG(enable_single_row_blind_write_fast_path, advanced);
+TAG_FLAG(enable_single_row_blind_write_fast_path, runtime);
+
+DEFINE_int32(apply_intents_batch_records, 10000,
+             "Max number of transaction reverse index records applied by a single pair of write "
+             "batches to regular and intents DB, when intents of a committed transaction are "
+             "applied.");
+TAG_FLAG(apply_intents_batch_records, advanced);
+TAG_FLAG(apply_intents_batch_records, runtime);
+
+DEFINE_int32(tablet_row_cache_capacity, 0,
+             "Max number of rows, whose results of QL point reads are cached by each tablet of "
+             "non-transactional tables without default TTL. Cached results are invalidated by "
+             "writes to the same rows, and are not served after values with TTL in them expire. "
+             "0 disables the cache.");
+TAG_FLAG(tablet_row_cache_capacity, advanced);
+
+DEFINE_int32(tablet_row_cache_capacity_for_caching_tables, 10000,
+             "Row cache capacity of tablets of tables with the use_row_cache property, i.e. "
+             "caching = {'rows_per_partition': ...} in CQL, when tablet_row_cache_capacity is 0. "
+             "The property is applied when the tablet is opened.");
+TAG_FLAG(tablet_row_cache_capacity_for_caching_tables, advanced);
+
 using namespace std::placeholders;
 
 using std::shared_ptr;
@@ -290,6 +334,7 @@ struct WriteOperationData {
   LockBatch *keys_locked;
   MonoTime deadline;
   HybridTime* restart_read_ht;
+  ConflictWait* conflict_wait;
 
   tserver::WriteRequestPB* write_request() const {
     return operation_state->mutable_request();
@@ -301,6 +346,7 @@ struct WriteOperationData {
 };
 
 const char* Tablet::kDMSMemTrackerId = "DeltaMemStores";
+const char* Tablet::kMemTableMemTrackerId = "MemTable";
 
 Tablet::Tablet(
     const scoped_refptr<TabletMetadata>& metadata,
@@ -319,6 +365,7 @@ Tablet::Tablet(
       log_anchor_registry_(log_anchor_registry),
       mem_tracker_(MemTracker::CreateTracker(Format("tablet-$0", tablet_id()), parent_mem_tracker)),
       dms_mem_tracker_(MemTracker::CreateTracker(kDMSMemTrackerId, mem_tracker_)),
+      memtable_mem_tracker_(MemTracker::CreateTracker(kMemTableMemTrackerId, mem_tracker_)),
       clock_(clock),
       mvcc_(Format("T $0 ", metadata_->tablet_id()), clock),
       tablet_options_(tablet_options),
@@ -352,6 +399,7 @@ Tablet::Tablet(
 
     metrics_.reset(new TabletMetrics(metric_entity_));
   }
+  load_tracker_ = std::make_unique<TabletLoadTracker>(metric_entity_);
 
   if (transaction_participant_context && metadata->schema().table_properties().is_transactional()) {
     transaction_participant_ = std::make_unique<TransactionParticipant>(
@@ -380,11 +428,18 @@ Tablet::Tablet(
 
   flush_stats_ = make_shared<TabletFlushStats>();
   tablet_options_.listeners.emplace_back(flush_stats_);
+  if (tablet_options_.compaction_history) {
+    compaction_filter_stats_ = std::make_shared<docdb::DocDBCompactionFilterStatsCollector>();
+    tablet_options_.listeners.emplace_back(std::make_shared<CompactionHistoryListener>(
+        tablet_id(), tablet_options_.compaction_history, compaction_filter_stats_,
+        rocksdb_statistics_));
+  }
 }
 
 Tablet::~Tablet() {
   Shutdown();
   dms_mem_tracker_->UnregisterFromParent();
+  memtable_mem_tracker_->UnregisterFromParent();
   mem_tracker_->UnregisterFromParent();
 }
 
@@ -405,6 +460,16 @@ Status Tablet::Open() {
                  << table_type_;
   }
 
+  if (table_type_ == TableType::YQL_TABLE_TYPE) {
+    int row_cache_capacity = FLAGS_tablet_row_cache_capacity;
+    if (row_cache_capacity == 0 && SchemaRef().table_properties().use_row_cache()) {
+      row_cache_capacity = FLAGS_tablet_row_cache_capacity_for_caching_tables;
+    }
+    if (row_cache_capacity > 0) {
+      row_cache_ = std::make_unique<RowCache>(row_cache_capacity);
+    }
+  }
+
   state_ = kBootstrapping;
   return Status::OK();
 }
@@ -473,11 +538,13 @@ Result<bool> Tablet::IntentsDbFlushFilter(const rocksdb::MemTable& memtable) {
 Status Tablet::OpenKeyValueTablet() {
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+  // Memtables of both regular and intents DBs are charged to the same tracker.
+  rocksdb_options.memtable_mem_tracker = memtable_mem_tracker_;
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      make_shared<TabletRetentionPolicy>(this), compaction_filter_stats_);
 
   rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
     if (mem_table_flush_filter_factory_) {
@@ -489,6 +556,16 @@ Status Tablet::OpenKeyValueTablet() {
   const string db_dir = metadata()->rocksdb_dir();
   RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
 
+  docdb::InitRocksDBDataPaths(db_dir, &rocksdb_options);
+  // The first path is db_dir itself, others are cold data dirs.
+  for (size_t i = 1; i < rocksdb_options.db_paths.size(); ++i) {
+    const auto& path = rocksdb_options.db_paths[i].path;
+    RETURN_NOT_OK_PREPEND(metadata()->fs_manager()->CreateDirIfMissingAndSync(DirName(path)),
+                          Format("Failed to create cold data directory $0", DirName(path)));
+    RETURN_NOT_OK_PREPEND(metadata()->fs_manager()->CreateDirIfMissingAndSync(path),
+                          Format("Failed to create RocksDB tablet cold data directory $0", path));
+  }
+
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
   rocksdb::DB* db = nullptr;
   rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
@@ -507,6 +584,7 @@ Status Tablet::OpenKeyValueTablet() {
       return std::bind(&Tablet::IntentsDbFlushFilter, this, _1);
     });
     rocksdb_options.compaction_filter_factory = nullptr;
+    rocksdb_options.db_paths.clear();
     rocksdb::DB* intents_db = nullptr;
     RETURN_NOT_OK(rocksdb::DB::Open(rocksdb_options, db_dir + kIntentsDBSuffix, &intents_db));
     intents_db_.reset(intents_db);
@@ -532,6 +610,11 @@ void Tablet::SetShutdownRequestedFlag() {
 void Tablet::Shutdown() {
   SetShutdownRequestedFlag();
 
+  // Writes waiting for conflicting transactions do not hold pending operations, fail them.
+  if (transaction_participant_) {
+    transaction_participant_->wait_queue()->Shutdown();
+  }
+
   auto op_pause = PauseReadWriteOperations();
   if (!op_pause.ok()) {
     LOG(WARNING) << Substitute("Tablet $0: failed to shut down", tablet_id());
@@ -543,6 +626,9 @@ void Tablet::Shutdown() {
   }
 
   std::lock_guard<rw_spinlock> lock(component_lock_);
+  if (ql_storage_) {
+    ql_storage_->ClearIteratorCache();
+  }
   // Shutdown the RocksDB instance for this table, if present.
   // Destroy intents and regular DBs in reverse order to their creation.
   // Also it makes sure that regular DB is alive during flush filter of intents db.
@@ -557,7 +643,7 @@ void Tablet::Shutdown() {
   op_pause.ReleaseMutexButKeepDisabled();
 }
 
-Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
+Result<std::unique_ptr<docdb::DocRowwiseIterator>> Tablet::CreateRowIterator(
     const Schema &projection, const boost::optional<TransactionId>& transaction_id) const {
   if (state_ != kOpen) {
     return STATUS_FORMAT(IllegalState, "Tablet in wrong state: $0", state_);
@@ -581,10 +667,31 @@ Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
       std::move(mapped_projection), *schema(), txn_op_ctx,
       docdb::DocDB{regular_db_.get(), intents_db_.get()},
       MonoTime::Max() /* deadline */, read_time, &pending_op_counter_);
+  return std::move(result);
+}
+
+Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
+    const Schema &projection, const boost::optional<TransactionId>& transaction_id) const {
+  auto result = VERIFY_RESULT(CreateRowIterator(projection, transaction_id));
   RETURN_NOT_OK(result->Init());
   return std::move(result);
 }
 
+Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
+    const Schema &projection, const boost::optional<TransactionId>& transaction_id,
+    uint16_t min_hash_code, uint16_t max_hash_code) const {
+  if (schema()->num_hash_key_columns() == 0) {
+    return STATUS_FORMAT(NotSupported, "Table of tablet $0 has no hash key columns", tablet_id());
+  }
+  auto result = VERIFY_RESULT(CreateRowIterator(projection, transaction_id));
+  const std::vector<docdb::PrimitiveValue> hashed_components;
+  const docdb::DocQLScanSpec spec(
+      *schema(), min_hash_code, max_hash_code, hashed_components, nullptr /* req */,
+      rocksdb::kDefaultQueryId);
+  RETURN_NOT_OK(result->Init(spec));
+  return std::move(result);
+}
+
 void Tablet::StartOperation(WriteOperationState* operation_state) {
   // If the state already has a hybrid_time then we're replaying a transaction that occurred
   // before a crash or at another node.
@@ -675,8 +782,14 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     PrepareTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
     WriteBatch(frontiers, hybrid_time, &write_batch, intents_db_.get());
   } else {
-    PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
+    // Key value pairs are inserted to the memtable directly from put_batch, without copying them
+    // to write_batch.
+    docdb::NonTransactionalWriter writer(put_batch, hybrid_time);
+    write_batch.SetDirectWriter(&writer);
     WriteBatch(frontiers, hybrid_time, &write_batch, regular_db_.get());
+    if (row_cache_) {
+      row_cache_->Invalidate(put_batch, hybrid_time);
+    }
   }
 }
 
@@ -696,6 +809,7 @@ void Tablet::WriteBatch(const rocksdb::UserFrontiers* frontiers,
   InitRocksDBWriteOptions(&write_options);
 
   flush_stats_->AboutToWriteToDb(hybrid_time);
+  ScopedAllocationAttribution allocation_attribution(memtable_mem_tracker_.get());
   auto rocksdb_write_status = dest_db->Write(write_options, write_batch);
   if (!rocksdb_write_status.ok()) {
     LOG(FATAL) << "Failed to write a batch with " << write_batch->Count() << " operations"
@@ -703,6 +817,94 @@ void Tablet::WriteBatch(const rocksdb::UserFrontiers* frontiers,
   }
 }
 
+void Tablet::BeginApplyBatch() {
+  if (FLAGS_follower_apply_batch_max_ops <= 1) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(apply_batch_mutex_);
+  DCHECK(!apply_batch_active_);
+  apply_batch_active_ = true;
+  apply_batch_thread_ = std::this_thread::get_id();
+}
+
+void Tablet::EndApplyBatch() {
+  std::lock_guard<std::mutex> lock(apply_batch_mutex_);
+  if (!apply_batch_active_) {
+    return;
+  }
+  FlushApplyBatchUnlocked();
+  apply_batch_active_ = false;
+}
+
+bool Tablet::AddToApplyBatch(WriteOperationState* operation_state,
+                             std::function<void()> on_applied) {
+  if (!operation_state->consensus_round() ||
+      !operation_state->consensus_round()->replicate_msg()) {
+    return false;
+  }
+  const KeyValueWriteBatchPB& put_batch =
+      operation_state->consensus_round()->replicate_msg()->write_request().write_batch();
+  if (put_batch.has_transaction()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(apply_batch_mutex_);
+  if (!apply_batch_active_ || apply_batch_thread_ != std::this_thread::get_id()) {
+    return false;
+  }
+
+  const auto& op_id = operation_state->op_id();
+  const auto hybrid_time = operation_state->hybrid_time();
+  last_committed_write_index_.store(op_id.index(), std::memory_order_release);
+  if (apply_batch_callbacks_.empty()) {
+    apply_batch_first_op_id_ = yb::OpId(op_id.term(), op_id.index());
+    apply_batch_first_hybrid_time_ = hybrid_time;
+  }
+  apply_batch_last_op_id_ = yb::OpId(op_id.term(), op_id.index());
+  apply_batch_last_hybrid_time_ = hybrid_time;
+  if (put_batch.kv_pairs_size() != 0) {
+    PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &apply_batch_);
+    // Operation is not visible until its callback is invoked, so cached results of earlier reads
+    // could be invalidated before the batch is written.
+    if (row_cache_) {
+      row_cache_->Invalidate(put_batch, hybrid_time);
+    }
+  }
+  apply_batch_callbacks_.push_back(std::move(on_applied));
+
+  if (apply_batch_callbacks_.size() >= static_cast<size_t>(FLAGS_follower_apply_batch_max_ops)) {
+    FlushApplyBatchUnlocked();
+  }
+  return true;
+}
+
+void Tablet::FlushApplyBatch() {
+  std::lock_guard<std::mutex> lock(apply_batch_mutex_);
+  FlushApplyBatchUnlocked();
+}
+
+void Tablet::FlushApplyBatchUnlocked() {
+  if (apply_batch_callbacks_.empty()) {
+    return;
+  }
+
+  docdb::ConsensusFrontiers frontiers;
+  frontiers.Smallest().set_op_id(apply_batch_first_op_id_);
+  frontiers.Smallest().set_hybrid_time(apply_batch_first_hybrid_time_);
+  frontiers.Largest().set_op_id(apply_batch_last_op_id_);
+  frontiers.Largest().set_hybrid_time(apply_batch_last_hybrid_time_);
+  WriteBatch(&frontiers, apply_batch_last_hybrid_time_, &apply_batch_, regular_db_.get());
+  apply_batch_.Clear();
+
+  // Operations are finished while the mutex is held, so they are made visible in order, even when
+  // the batch is flushed by an operation applied on another thread.
+  std::vector<std::function<void()>> callbacks;
+  callbacks.swap(apply_batch_callbacks_);
+  for (const auto& callback : callbacks) {
+    callback();
+  }
+}
+
 namespace {
 
 // Separate Redis / QL / row operations write batches from write_request in preparation for the
@@ -720,6 +922,30 @@ void SetupKeyValueBatch(WriteRequestPB* write_request, WriteRequestPB* batch_req
   }
 }
 
+void RecordKeyAccess(
+    KeyAccessType type, bool has_hash_code, uint32_t hash_code, TabletLoadTracker* load_tracker) {
+  if (has_hash_code) {
+    load_tracker->Record(type, hash_code);
+  } else {
+    load_tracker->RecordOp(type);
+  }
+}
+
+// Records accesses to keys of all operations of the write request.
+void RecordWriteKeyAccesses(
+    KeyAccessType type, const WriteRequestPB& request, TabletLoadTracker* load_tracker) {
+  for (const auto& ql_write : request.ql_write_batch()) {
+    RecordKeyAccess(type, ql_write.has_hash_code(), ql_write.hash_code(), load_tracker);
+  }
+  for (const auto& redis_write : request.redis_write_batch()) {
+    const auto& key_value = redis_write.key_value();
+    RecordKeyAccess(type, key_value.has_hash_code(), key_value.hash_code(), load_tracker);
+  }
+  for (const auto& pgsql_write : request.pgsql_write_batch()) {
+    RecordKeyAccess(type, pgsql_write.has_hash_code(), pgsql_write.hash_code(), load_tracker);
+  }
+}
+
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -731,13 +957,14 @@ Status Tablet::KeyValueBatchFromRedisWriteBatch(const WriteOperationData& data)
   // Since we take exclusive locks, it's okay to use Now as the read TS for writes.
   WriteRequestPB batch_request;
   SetupKeyValueBatch(data.write_request(), &batch_request);
+  RecordWriteKeyAccesses(KeyAccessType::kWrite, batch_request, load_tracker_.get());
   auto* redis_write_batch = batch_request.mutable_redis_write_batch();
 
   doc_ops.reserve(redis_write_batch->size());
   for (size_t i = 0; i < redis_write_batch->size(); i++) {
     doc_ops.emplace_back(new RedisWriteOperation(redis_write_batch->Mutable(i)));
   }
-  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, data));
+  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, batch_request, data));
   if (data.restart_read_ht->is_valid()) {
     return Status::OK();
   }
@@ -759,6 +986,8 @@ Status Tablet::HandleRedisReadRequest(MonoTime deadline,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+  RecordKeyAccess(KeyAccessType::kRead, redis_read_request.key_value().has_hash_code(),
+                  redis_read_request.key_value().hash_code(), load_tracker_.get());
 
   docdb::RedisReadOperation doc_op(
       redis_read_request, {regular_db_.get(), intents_db_.get()}, deadline, read_time);
@@ -778,6 +1007,12 @@ Status Tablet::HandleQLReadRequest(
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  // Scans over a range of hash codes are not attributed to a key.
+  RecordKeyAccess(KeyAccessType::kRead,
+                  ql_read_request.has_hash_code() &&
+                      (!ql_read_request.has_max_hash_code() ||
+                       ql_read_request.max_hash_code() == ql_read_request.hash_code()),
+                  ql_read_request.hash_code(), load_tracker_.get());
 
   if (metadata()->schema_version() != ql_read_request.schema_version()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
@@ -787,8 +1022,39 @@ Status Tablet::HandleQLReadRequest(
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
-  return AbstractTablet::HandleQLReadRequest(
-      deadline, read_time, ql_read_request, *txn_op_ctx, result);
+
+  RowCacheKey row_cache_key;
+  const bool use_row_cache =
+      row_cache_ && !*txn_op_ctx && !SchemaRef().table_properties().is_transactional() &&
+      !SchemaRef().table_properties().HasDefaultTimeToLive() &&
+      (FLAGS_tablet_row_cache_capacity > 0 || SchemaRef().table_properties().use_row_cache()) &&
+      RowCache::MakeKey(ql_read_request, SchemaRef(), &row_cache_key);
+  if (!use_row_cache) {
+    RETURN_NOT_OK(AbstractTablet::HandleQLReadRequest(
+        deadline, read_time, ql_read_request, *txn_op_ctx, result));
+    RecordReadStageLatencies(*result);
+    return Status::OK();
+  }
+
+  if (row_cache_->Lookup(row_cache_key, read_time.read, result)) {
+    TRACE("Row cache hit");
+    return Status::OK();
+  }
+  const auto generation = row_cache_->generation();
+  RETURN_NOT_OK(AbstractTablet::HandleQLReadRequest(
+      deadline, read_time, ql_read_request, *txn_op_ctx, result));
+  RecordReadStageLatencies(*result);
+  row_cache_->Insert(row_cache_key, read_time.read, generation, *result);
+  return Status::OK();
+}
+
+void Tablet::RecordReadStageLatencies(const QLReadRequestResult& result) {
+  if (result.iterator_init_time) {
+    metrics_->read_iterator_init_latency->Increment(result.iterator_init_time.ToMicroseconds());
+  }
+  if (result.fetch_rows_time) {
+    metrics_->read_fetch_rows_latency->Increment(result.fetch_rows_time.ToMicroseconds());
+  }
 }
 
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_request,
@@ -841,6 +1107,7 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
   docdb::DocOperations doc_ops;
   WriteRequestPB batch_request;
   SetupKeyValueBatch(data.write_request(), &batch_request);
+  RecordWriteKeyAccesses(KeyAccessType::kWrite, batch_request, load_tracker_.get());
   auto* ql_write_batch = batch_request.mutable_ql_write_batch();
 
   doc_ops.reserve(ql_write_batch->size());
@@ -861,7 +1128,12 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
       doc_ops.emplace_back(std::move(write_op));
     }
   }
-  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, data));
+
+  if (IsBlindWriteBatch(doc_ops, data)) {
+    return StartBlindWriteBatch(doc_ops, data);
+  }
+
+  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, batch_request, data));
   if (data.restart_read_ht->is_valid()) {
     return Status::OK();
   }
@@ -881,29 +1153,91 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
   return Status::OK();
 }
 
+bool Tablet::IsBlindWriteBatch(const docdb::DocOperations& doc_ops,
+                               const WriteOperationData& data) const {
+  if (!FLAGS_enable_single_row_blind_write_fast_path || doc_ops.empty() ||
+      data.write_request()->write_batch().has_transaction() ||
+      metadata_->schema().table_properties().is_transactional()) {
+    return false;
+  }
+  for (const auto& doc_op : doc_ops) {
+    const QLWriteOperation* write_op = down_cast<QLWriteOperation*>(doc_op.get());
+    if (write_op->RequireReadSnapshot() || !write_op->request().update_index_ids().empty() ||
+        write_op->request().has_child_transaction_data()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status Tablet::StartBlindWriteBatch(const docdb::DocOperations& doc_ops,
+                                    const WriteOperationData& data) {
+  // Rows are locked with the same keys and intents as in the general path, so writes are still
+  // serialized with concurrent read-modify-write operations on these rows, that lock them in
+  // snapshot isolation.
+  bool need_read_snapshot = false;
+  docdb::PrepareDocWriteOperation(
+      doc_ops, metrics_->write_lock_latency, IsolationLevel::NON_TRANSACTIONAL,
+      &shared_lock_manager_, data.keys_locked, &need_read_snapshot);
+  DCHECK(!need_read_snapshot);
+
+  // The write does not read, so there is no need to register a read point.
+  return docdb::ExecuteDocWriteOperation(
+      doc_ops, data.deadline, ReadHybridTime::SingleTime(clock_->Now()),
+      {regular_db_.get(), intents_db_.get()}, data.write_request()->mutable_write_batch(),
+      InitMarkerBehavior::kOptional, &monotonic_counter_, data.restart_read_ht);
+}
+
+namespace {
+
+// Index updates produced by the write operations of a batch, that belong to the same transaction.
+struct IndexUpdates {
+  std::shared_ptr<YBSession> session;
+  client::YBTransactionPtr txn;
+
+  // Base table write operations that produced the index updates.
+  vector<QLWriteOperation*> write_ops;
+
+  struct IndexOp {
+    QLWriteOperation* write_op;
+    const IndexInfo* index_info;
+    shared_ptr<client::YBqlWriteOp> op;
+  };
+  vector<IndexOp> index_ops;
+};
+
+} // namespace
+
 Status Tablet::UpdateQLIndexes(docdb::DocOperations* doc_ops) {
+  // Index updates of all write operations in the batch that belong to the same transaction are
+  // applied through one session. So the session groups them by index tablet and they are sent in
+  // one RPC per index tablet, instead of a round of RPCs per base table row.
+  std::map<string, IndexUpdates> updates_by_txn;
   for (auto& doc_op : *doc_ops) {
     auto* write_op = static_cast<QLWriteOperation*>(doc_op.get());
     if (write_op->index_requests()->empty()) {
       continue;
     }
-    const YBClientPtr client = client_future_.get();
-    auto session = std::make_shared<YBSession>(client);
-    RETURN_NOT_OK(session->SetFlushMode(client::YBSession::MANUAL_FLUSH));
-    client::YBTransactionPtr txn;
-    if (write_op->request().has_child_transaction_data()) {
-      if (!transaction_manager_) {
-        return STATUS(Corruption, "Transaction manager is not present for index update");
+    const auto& request = write_op->request();
+    auto& updates = updates_by_txn[request.has_child_transaction_data()
+        ? request.child_transaction_data().SerializeAsString() : string()];
+    if (!updates.session) {
+      const YBClientPtr client = client_future_.get();
+      updates.session = std::make_shared<YBSession>(client);
+      RETURN_NOT_OK(updates.session->SetFlushMode(client::YBSession::MANUAL_FLUSH));
+      if (request.has_child_transaction_data()) {
+        if (!transaction_manager_) {
+          return STATUS(Corruption, "Transaction manager is not present for index update");
+        }
+        updates.txn = std::make_shared<YBTransaction>(
+            &transaction_manager_.get(),
+            VERIFY_RESULT(ChildTransactionData::FromPB(request.child_transaction_data())));
+        updates.session->SetTransaction(updates.txn);
       }
-      txn = std::make_shared<YBTransaction>(
-          &transaction_manager_.get(),
-          VERIFY_RESULT(ChildTransactionData::FromPB(
-              write_op->request().child_transaction_data())));
-      session->SetTransaction(txn);
     }
+    updates.write_ops.push_back(write_op);
 
     // Apply the write ops to update the index
-    vector<std::pair<const IndexInfo*, shared_ptr<client::YBqlWriteOp>>> index_ops;
     for (auto& pair : *write_op->index_requests()) {
       client::YBTablePtr index_table;
       bool cache_used_ignored = false;
@@ -915,45 +1249,56 @@ Status Tablet::UpdateQLIndexes(docdb::DocOperations* doc_ops) {
       shared_ptr<client::YBqlWriteOp> index_op(index_table->NewQLWrite());
       index_op->mutable_request()->Swap(&pair.second);
       index_op->mutable_request()->MergeFrom(pair.second);
-      RETURN_NOT_OK(session->Apply(index_op));
-      index_ops.emplace_back(pair.first, index_op);
+      RETURN_NOT_OK(updates.session->Apply(index_op));
+      updates.index_ops.push_back({write_op, pair.first, index_op});
     }
-    const Status s = session->Flush();
+  }
+
+  for (auto& txn_and_updates : updates_by_txn) {
+    auto& updates = txn_and_updates.second;
+    const Status s = updates.session->Flush();
     if (PREDICT_FALSE(!s.ok())) {
       // When any error occurs during the dispatching of YBOperation, YBSession saves the error and
       // returns IOError. When it happens, retrieves the errors and discard the IOError.
       if (s.IsIOError()) {
-        for (const auto& error : session->GetPendingErrors()) {
+        for (const auto& error : updates.session->GetPendingErrors()) {
           return error->status(); // return just the first error seen.
         }
       }
       return s;
     }
 
-    // Check the responses of the index write ops.
-    auto* response = write_op->response();
-    for (const auto& pair : index_ops) {
-      const IndexInfo* index_info = pair.first;
-      shared_ptr<client::YBqlWriteOp> index_op = pair.second;
-      auto* index_response = index_op->mutable_response();
+    // Check the responses of the index write ops. Only the first error is returned for each base
+    // table write op.
+    for (const auto& index_op : updates.index_ops) {
+      auto* response = index_op.write_op->response();
+      if (response->status() != QLResponsePB::YQL_STATUS_OK) {
+        continue;
+      }
+      auto* index_response = index_op.op->mutable_response();
 
       if (index_response->status() != QLResponsePB::YQL_STATUS_OK) {
         response->set_status(index_response->status());
         response->set_error_message(std::move(index_response->error_message()));
-        break;
+        continue;
       }
 
       // For unique index, return error if the update failed due to duplicate values.
-      if (index_info->is_unique() && index_response->has_applied() && !index_response->applied()) {
+      if (index_op.index_info->is_unique() && index_response->has_applied() &&
+          !index_response->applied()) {
         response->set_status(QLResponsePB::YQL_STATUS_USAGE_ERROR);
         response->set_error_message(Format("Duplicate value disallowed by unique index $0",
-                                           index_op->table()->name().ToString()));
-        break;
+                                           index_op.op->table()->name().ToString()));
       }
     }
 
-    if (txn) {
-      *response->mutable_child_transaction_result() = VERIFY_RESULT(txn->FinishChild());
+    // The child transaction has the index tablets written for all base table write ops, any of
+    // their responses could be used by the parent transaction to apply it.
+    if (updates.txn) {
+      const auto result = VERIFY_RESULT(updates.txn->FinishChild());
+      for (auto* write_op : updates.write_ops) {
+        *write_op->response()->mutable_child_transaction_result() = result;
+      }
     }
   }
   return Status::OK();
@@ -1018,6 +1363,7 @@ Status Tablet::KeyValueBatchFromPgsqlWriteBatch(const WriteOperationData& data)
   WriteRequestPB batch_request;
 
   SetupKeyValueBatch(data.write_request(), &batch_request);
+  RecordWriteKeyAccesses(KeyAccessType::kWrite, batch_request, load_tracker_.get());
   auto* pgsql_write_batch = batch_request.mutable_pgsql_write_batch();
 
   doc_ops.reserve(pgsql_write_batch->size());
@@ -1037,7 +1383,7 @@ Status Tablet::KeyValueBatchFromPgsqlWriteBatch(const WriteOperationData& data)
       doc_ops.emplace_back(std::move(write_op));
     }
   }
-  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, data));
+  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, batch_request, data));
   if (data.restart_read_ht->is_valid()) {
     return Status::OK();
   }
@@ -1054,17 +1400,73 @@ Status Tablet::KeyValueBatchFromPgsqlWriteBatch(const WriteOperationData& data)
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Checks that keys of external write batch belong to the tablet with specified schema and
+// partition, and that values could be decoded.
+CHECKED_STATUS ValidateExternalWriteBatch(
+    const KeyValueWriteBatchPB& write_batch, const Schema& schema, const Partition& partition) {
+  for (const auto& kv_pair : write_batch.kv_pairs()) {
+    if (!kv_pair.has_key() || !kv_pair.has_value()) {
+      return STATUS(InvalidArgument, "External write batch entry without key or value");
+    }
+    SubDocKey sub_doc_key;
+    RETURN_NOT_OK_PREPEND(
+        sub_doc_key.FullyDecodeFrom(kv_pair.key(), docdb::HybridTimeRequired::kFalse),
+        "Bad key in external write batch");
+    const auto& doc_key = sub_doc_key.doc_key();
+    if (doc_key.hashed_group().size() != schema.num_hash_key_columns() ||
+        doc_key.range_group().size() != schema.num_key_columns() - schema.num_hash_key_columns()) {
+      return STATUS_FORMAT(InvalidArgument, "Key $0 does not match schema: $1",
+                           sub_doc_key, schema.ToString());
+    }
+    if (!doc_key.hashed_group().empty() &&
+        !partition.ContainsKey(PartitionSchema::EncodeMultiColumnHashValue(doc_key.hash()))) {
+      return STATUS_FORMAT(InvalidArgument, "Key $0 does not belong to partition [$1, $2)",
+                           sub_doc_key,
+                           Slice(partition.partition_key_start()).ToDebugHexString(),
+                           Slice(partition.partition_key_end()).ToDebugHexString());
+    }
+    if (!sub_doc_key.subkeys().empty()) {
+      const auto& column = sub_doc_key.subkeys().front();
+      if (column.value_type() == ValueType::kColumnId &&
+          !schema.column_by_id(column.GetColumnId()).ok()) {
+        return STATUS_FORMAT(InvalidArgument, "Key $0 refers to unknown column", sub_doc_key);
+      }
+    }
+    docdb::Value value;
+    RETURN_NOT_OK_PREPEND(value.Decode(kv_pair.value()), "Bad value in external write batch");
+  }
+  return Status::OK();
+}
+
+} // namespace
+
 Status Tablet::AcquireLocksAndPerformDocOperations(
-    MonoTime deadline, WriteOperationState *state, HybridTime* restart_read_ht) {
+    MonoTime deadline, WriteOperationState *state, HybridTime* restart_read_ht,
+    ConflictWait* conflict_wait) {
   LockBatch locks_held;
   WriteRequestPB* key_value_write_request = state->mutable_request();
 
+  if (PREDICT_FALSE(SchemaRef().table_properties().is_read_only())) {
+    return STATUS_FORMAT(NotSupported, "Table $0 is read only", metadata_->table_name());
+  }
+
+  if (key_value_write_request->external_write_batch()) {
+    // Key value pairs were already prepared by the producer universe, and only replication writes
+    // to such tables, so there is nothing to execute or lock here. Hybrid time of this operation
+    // is appended to the keys when the batch is applied.
+    return ValidateExternalWriteBatch(
+        key_value_write_request->write_batch(), SchemaRef(), metadata_->partition());
+  }
+
   bool invalid_table_type = true;
   WriteOperationData data = {
     state,
     &locks_held,
     deadline,
-    restart_read_ht
+    restart_read_ht,
+    conflict_wait
   };
   switch (table_type_) {
     case TableType::REDIS_TABLE_TYPE: {
@@ -1130,6 +1532,17 @@ Status Tablet::Flush(FlushMode mode, FlushFlags flags) {
   return Status::OK();
 }
 
+uint64_t Tablet::MemTableMemoryUsage() const {
+  uint64_t result = 0;
+  for (auto* db : {regular_db_.get(), intents_db_.get()}) {
+    uint64_t size = 0;
+    if (db && db->GetIntProperty(rocksdb::DB::Properties::kCurSizeAllMemTables, &size)) {
+      result += size;
+    }
+  }
+  return result;
+}
+
 Status Tablet::WaitForFlush() {
   TRACE_EVENT0("tablet", "Tablet::WaitForFlush");
 
@@ -1143,28 +1556,70 @@ Status Tablet::WaitForFlush() {
 
 Status Tablet::ImportData(const std::string& source_dir) {
   // We import only regular records, so don't have to deal with intents here.
-  return regular_db_->Import(source_dir);
+  auto status = regular_db_->Import(source_dir);
+  if (row_cache_) {
+    row_cache_->Clear();
+  }
+  return status;
+}
+
+Result<std::unique_ptr<docdb::DocDBSstFileWriter>> Tablet::CreateSstFileWriter() {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  if (!regular_db_) {
+    return STATUS(NotSupported, "SST file ingestion is supported only for key-value tables");
+  }
+  return std::make_unique<docdb::DocDBSstFileWriter>(regular_db_->GetOptions(), clock_->Now());
+}
+
+Status Tablet::IngestSstFile(const std::string& file_path) {
+  TRACE_EVENT1("tablet", "Tablet::IngestSstFile", "file_path", file_path);
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  if (!regular_db_) {
+    return STATUS(NotSupported, "SST file ingestion is supported only for key-value tables");
+  }
+  // RocksDB enters its write thread unbatched, checks that the key range of the file does not
+  // overlap existing files and memtables, and adds the file to the version atomically.
+  auto status = regular_db_->AddFile(file_path, true /* move_file */);
+  if (row_cache_) {
+    row_cache_->Clear();
+  }
+  return status;
 }
 
 // We apply intents using by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
+//
+// Big transactions are applied in chunks of apply_intents_batch_records reverse index records, so
+// write batches are bounded. All chunks have the frontier of the apply operation. If the tablet is
+// restarted before all of them are flushed, the operation is replayed during bootstrap, and applies
+// intents that are still present. Committed records use write ids stored in intents, so records
+// that were already applied are rewritten with the same keys and values.
 // TODO(dtxn) use separate thread for applying intents.
-// TODO(dtxn) use multiple batches when applying really big transaction.
 Status Tablet::ApplyIntents(const TransactionApplyData& data) {
-  rocksdb::WriteBatch regular_write_batch;
-  rocksdb::WriteBatch intents_write_batch;
-  RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
-      data.transaction_id, data.commit_ht,
-      &regular_write_batch, intents_db_.get(), &intents_write_batch));
-
-  // data.hybrid_time contains transaction commit time.
-  // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
   docdb::ConsensusFrontiers frontiers;
   set_op_id({data.op_id.term(), data.op_id.index()}, &frontiers);
   set_hybrid_time(data.log_ht, &frontiers);
-  WriteBatch(&frontiers, data.commit_ht, &regular_write_batch, regular_db_.get());
-  WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
+
+  const size_t max_records = std::max(FLAGS_apply_intents_batch_records, 1);
+  docdb::KeyBytes next_key;
+  do {
+    rocksdb::WriteBatch regular_write_batch;
+    rocksdb::WriteBatch intents_write_batch;
+    next_key = VERIFY_RESULT(docdb::PrepareApplyIntentsBatch(
+        data.transaction_id, data.commit_ht, next_key.AsSlice(), max_records,
+        &regular_write_batch, intents_db_.get(), &intents_write_batch));
+
+    // data.hybrid_time contains transaction commit time.
+    // We don't set transaction field of put_batch, otherwise we would write another bunch of
+    // intents.
+    WriteBatch(&frontiers, data.commit_ht, &regular_write_batch, regular_db_.get());
+    WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
+  } while (!next_key.empty());
   return Status::OK();
 }
 
@@ -1194,6 +1649,8 @@ Status Tablet::AlterSchema(AlterSchemaOperationState *operation_state) {
       << "Schema keys cannot be altered";
   {
     bool same_schema = schema()->Equals(*operation_state->schema());
+    const bool becomes_read_only = !schema()->table_properties().is_read_only() &&
+                                   operation_state->schema()->table_properties().is_read_only();
 
     // If the current version >= new version, there is nothing to do.
     if (metadata_->schema_version() >= operation_state->schema_version()) {
@@ -1243,6 +1700,13 @@ Status Tablet::AlterSchema(AlterSchemaOperationState *operation_state) {
       metadata_cache_.emplace(client_future_.get());
     }
 
+    // Tablet of a read only table is not written anymore, so memtables are flushed to release
+    // memory and let the WAL be garbage collected.
+    if (becomes_read_only) {
+      LOG(INFO) << "Tablet " << tablet_id() << " of read only table, flushing";
+      WARN_NOT_OK(Flush(FlushMode::kAsync), "Failed to flush read only tablet");
+    }
+
     // If the current schema and the new one are equal, there is nothing to do.
     if (same_schema) {
       return metadata_->Flush();
@@ -1293,6 +1757,13 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   const rocksdb::SequenceNumber sequence_number = regular_db_->GetLatestSequenceNumber();
   const string db_dir = regular_db_->GetName();
 
+  if (row_cache_) {
+    row_cache_->Clear();
+  }
+  if (ql_storage_) {
+    ql_storage_->ClearIteratorCache();
+  }
+
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
 
@@ -1303,6 +1774,7 @@ Status Tablet::Truncate(TruncateOperationState *state) {
     intents_status = rocksdb::DestroyDB(intents_dir, rocksdb_options);
   }
   regular_db_.reset();
+  docdb::InitRocksDBDataPaths(db_dir, &rocksdb_options);
   auto s = rocksdb::DestroyDB(db_dir, rocksdb_options);
   if (s.ok() && !intents_status.ok()) {
     s = intents_status;
@@ -1421,6 +1893,7 @@ Status Tablet::TEST_SwitchMemtable() {
 }
 
 Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
+                                      const WriteRequestPB& batch_request,
                                       const WriteOperationData& data) {
   auto write_batch = data.write_request()->mutable_write_batch();
   auto isolation_level = GetIsolationLevel(*write_batch, transaction_participant_.get());
@@ -1442,10 +1915,14 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
 
   if (*isolation_level == IsolationLevel::NON_TRANSACTIONAL &&
       metadata_->schema().table_properties().is_transactional()) {
+    ScopedTabletMetricsTracker metrics_tracker(metrics_->write_conflict_resolution_latency);
     auto now = clock_->Now();
     auto result = docdb::ResolveOperationConflicts(
         doc_ops, now, {regular_db_.get(), intents_db_.get()}, transaction_participant_.get());
-    RETURN_NOT_OK(result);
+    if (!result.ok()) {
+      RecordWriteKeyAccesses(KeyAccessType::kConflict, batch_request, load_tracker_.get());
+      return result.status();
+    }
     if (now != *result) {
       clock_->Update(*result);
     }
@@ -1465,22 +1942,53 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
   }
 
   if (*isolation_level != IsolationLevel::NON_TRANSACTIONAL) {
-    auto result = docdb::ResolveTransactionConflicts(*write_batch,
-                                                     clock_->Now(),
-                                                     {regular_db_.get(), intents_db_.get()},
-                                                     transaction_participant_.get(),
-                                                     metrics_->transaction_conflicts.get());
-    if (!result.ok()) {
-      *data.keys_locked = LockBatch();  // Unlock the keys.
-      return result;
+    auto status = ResolveTransactionConflicts(data);
+    if (!status.ok()) {
+      RecordWriteKeyAccesses(KeyAccessType::kConflict, batch_request, load_tracker_.get());
     }
+    return status;
   }
 
   return Status::OK();
 }
 
+Status Tablet::ResolveTransactionConflicts(const WriteOperationData& data) {
+  ScopedTabletMetricsTracker metrics_tracker(metrics_->write_conflict_resolution_latency);
+  const auto& write_batch = data.write_request()->write_batch();
+  TransactionIdSet blockers;
+  auto result = docdb::ResolveTransactionConflicts(write_batch,
+                                                   clock_->Now(),
+                                                   {regular_db_.get(), intents_db_.get()},
+                                                   transaction_participant_.get(),
+                                                   metrics_->transaction_conflicts.get(),
+                                                   data.conflict_wait ? &blockers : nullptr);
+  if (result.ok()) {
+    return Status::OK();
+  }
+  *data.keys_locked = LockBatch();  // Unlock the keys.
+  if (!blockers.empty()) {
+    // The caller waits for transactions with higher priority without holding the locks, so they
+    // could proceed. Then the write is retried, that also detects any changes made to those keys
+    // meanwhile.
+    data.conflict_wait->waiter = VERIFY_RESULT(FullyDecodeTransactionId(
+        write_batch.transaction().transaction_id()));
+    data.conflict_wait->blockers = std::move(blockers);
+  }
+  return result;
+}
+
 HybridTime Tablet::DoGetSafeTime(
     tablet::RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const {
+  const MonoTime start_time = MonoTime::Now();
+  auto result = WaitSafeTime(require_lease, min_allowed, deadline);
+  const MonoDelta elapsed_time = MonoTime::Now().GetDeltaSince(start_time);
+  metrics_->read_safe_time_wait_latency->Increment(elapsed_time.ToMicroseconds());
+  TRACE("Waited $0 us for safe time $1", elapsed_time.ToMicroseconds(), result.ToString());
+  return result;
+}
+
+HybridTime Tablet::WaitSafeTime(
+    tablet::RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const {
   HybridTime ht_lease;
   if (!require_lease) {
     return mvcc_.SafeTimeForFollower(min_allowed, deadline);
@@ -1558,6 +2066,20 @@ void Tablet::LostLeadership() {
   }
 }
 
+Result<std::string> Tablet::GetEncodedMiddleSplitKey() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  if (!regular_db_) {
+    return STATUS(IllegalState, "Tablet does not have a RocksDB");
+  }
+  auto middle_key = VERIFY_RESULT(regular_db_->GetMiddleKey());
+  const auto doc_key_size = VERIFY_RESULT(
+      docdb::DocKey::EncodedSize(middle_key, docdb::DocKeyPart::WHOLE_DOC_KEY));
+  middle_key.resize(doc_key_size);
+  return middle_key;
+}
+
 uint64_t Tablet::GetTotalSSTFileSizes() const {
   ScopedPendingOperation scoped_operation(&pending_op_counter_);
   std::lock_guard<rw_spinlock> lock(component_lock_);
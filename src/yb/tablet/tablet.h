@@ -32,11 +32,13 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "yb/rocksdb/cache.h"
@@ -72,6 +74,7 @@
 
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/opid.h"
 #include "yb/util/pending_op_counter.h"
 #include "yb/util/semaphore.h"
 #include "yb/util/slice.h"
@@ -91,6 +94,8 @@ class RowChangeList;
 
 namespace docdb {
 class ConsensusFrontier;
+class DocDBSstFileWriter;
+class DocRowwiseIterator;
 }
 
 namespace log {
@@ -108,7 +113,9 @@ class MaintenanceOpStats;
 namespace tablet {
 
 class AlterSchemaOperationState;
+class RowCache;
 class ScopedReadOperation;
+class TabletLoadTracker;
 struct TabletMetrics;
 struct TransactionApplyData;
 class TransactionCoordinator;
@@ -176,6 +183,13 @@ inline bool HasFlags(FlushFlags lhs, FlushFlags rhs) {
 
 struct WriteOperationData;
 
+// Conflicting transactions of higher priority that a transactional write could wait for, instead
+// of failing with the conflict. The write should be retried after they are resolved.
+struct ConflictWait {
+  TransactionId waiter;
+  TransactionIdSet blockers;
+};
+
 struct DocDbOpIds {
   OpId regular;
   OpId intents;
@@ -230,6 +244,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS ImportData(const std::string& source_dir);
 
+  // Creates writer of an SST file with regular records, whose options match the regular RocksDB of
+  // this tablet. All records of the file get the current hybrid time.
+  Result<std::unique_ptr<docdb::DocDBSstFileWriter>> CreateSstFileWriter();
+
+  // Links SST file built by a writer returned from CreateSstFileWriter into the regular RocksDB,
+  // the file is moved when possible. As with ImportData the file is not replicated, so it should
+  // be ingested on each replica, and its records become visible atomically.
+  CHECKED_STATUS IngestSstFile(const std::string& file_path);
+
   CHECKED_STATUS ApplyIntents(const TransactionApplyData& data) override;
 
   // Finish the Prepare phase of a write transaction.
@@ -275,6 +298,22 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
                   rocksdb::WriteBatch* write_batch,
                   rocksdb::DB* dest_db);
 
+  // Follower-side apply batching. Between BeginApplyBatch() and EndApplyBatch(), RocksDB writes of
+  // consecutive non-transactional write operations, that are applied by the calling thread, are
+  // combined into a single write batch with a combined frontier.
+  void BeginApplyBatch();
+  void EndApplyBatch();
+
+  // Adds RocksDB writes of the operation to the current apply batch. 'on_applied' is invoked,
+  // in order, after the batch is written, and should finish the operation.
+  // Returns false if there is no apply batch for this operation, in which case the operation
+  // should be applied as usual after FlushApplyBatch().
+  bool AddToApplyBatch(WriteOperationState* operation_state, std::function<void()> on_applied);
+
+  // Writes the current apply batch and finishes its operations, so operations that are applied
+  // without batching are applied in order.
+  void FlushApplyBatch();
+
   //------------------------------------------------------------------------------------------------
   // Redis Request Processing.
   // Takes a Redis WriteRequestPB as input with its redis_write_batch.
@@ -336,6 +375,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const Schema &projection,
       const boost::optional<TransactionId>& transaction_id) const;
 
+  // Same as above, but only yields rows whose DocKey hash codes are in
+  // [min_hash_code, max_hash_code]. Only valid for tables with hash key columns.
+  Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> NewRowIterator(
+      const Schema &projection,
+      const boost::optional<TransactionId>& transaction_id,
+      uint16_t min_hash_code,
+      uint16_t max_hash_code) const;
+
   //------------------------------------------------------------------------------------------------
   // Makes RocksDB Flush.
   CHECKED_STATUS Flush(FlushMode mode,
@@ -387,6 +434,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // May be NULL in unit tests, etc.
   TabletMetrics* metrics() { return metrics_.get(); }
 
+  // Return rates of operations and hot keys of this tablet.
+  TabletLoadTracker* load_tracker() const { return load_tracker_.get(); }
+
   // Return handle to the metric entity of this tablet.
   const scoped_refptr<MetricEntity>& GetMetricEntity() const { return metric_entity_; }
 
@@ -407,10 +457,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   // For non-kudu table type fills key-value batch in transaction state request and updates
   // request in state. Due to acquiring locks it can block the thread.
+  // When conflict_wait is specified and a transactional write conflicts with transactions of
+  // higher priority, they are stored in conflict_wait and the conflict is returned, so the caller
+  // could retry the write after waiting for them in the wait queue.
   CHECKED_STATUS AcquireLocksAndPerformDocOperations(
-      MonoTime deadline, WriteOperationState *state, HybridTime* restart_read_ht);
+      MonoTime deadline, WriteOperationState *state, HybridTime* restart_read_ht,
+      ConflictWait* conflict_wait = nullptr);
 
   static const char* kDMSMemTrackerId;
+  static const char* kMemTableMemTrackerId;
 
   // Returns the timestamp corresponding to the oldest active reader. If none exists returns
   // the latest timestamp that is safe to read.
@@ -420,6 +475,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // The HybridTime of the oldest write that is still not scheduled to be flushed in RocksDB.
   TabletFlushStats* flush_stats() const { return flush_stats_.get(); }
 
+  // Approximate memory used by active and immutable memtables of regular and intents DBs.
+  uint64_t MemTableMemoryUsage() const;
+
   const scoped_refptr<server::Clock> &clock() const {
     return clock_;
   }
@@ -460,6 +518,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   uint64_t GetTotalSSTFileSizes() const;
 
+  // Returns encoded document key that splits data of this tablet into two parts of about the same
+  // size, so the tablet leader could pick split point without scanning data. The key is taken
+  // from the SST index, and is truncated to the document key so it never splits a document.
+  Result<std::string> GetEncodedMiddleSplitKey() const;
+
   void SetHybridTimeLeaseProvider(HybridTimeLeaseProvider provider) {
     ht_lease_provider_ = std::move(provider);
   }
@@ -480,8 +543,26 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   friend class ScopedReadOperation;
   FRIEND_TEST(TestTablet, TestGetLogRetentionSizeForIndex);
 
+  // batch_request contains operations of the write, it is used to attribute conflicts to keys.
   CHECKED_STATUS StartDocWriteOperation(
       const docdb::DocOperations &doc_ops,
+      const tserver::WriteRequestPB& batch_request,
+      const WriteOperationData& data);
+
+  // Resolves conflicts of transactional write, whose keys are already locked.
+  // When data has conflict_wait and the write conflicts with transactions of higher priority,
+  // they are stored there, so the write could be retried after they are resolved.
+  CHECKED_STATUS ResolveTransactionConflicts(const WriteOperationData& data);
+
+  // Whether doc_ops consist of QL writes to a non-transactional table, that neither read rows nor
+  // update indexes, i.e. blind writes. It is the case for most unlogged batches of a partition.
+  bool IsBlindWriteBatch(const docdb::DocOperations& doc_ops,
+                         const WriteOperationData& data) const;
+
+  // Specialized version of StartDocWriteOperation for blind writes. It skips read point
+  // registration, isolation level resolution and index maintenance.
+  CHECKED_STATUS StartBlindWriteBatch(
+      const docdb::DocOperations& doc_ops,
       const WriteOperationData& data);
 
   CHECKED_STATUS OpenKeyValueTablet();
@@ -554,6 +635,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   scoped_refptr<log::LogAnchorRegistry> log_anchor_registry_;
   std::shared_ptr<MemTracker> mem_tracker_;
   std::shared_ptr<MemTracker> dms_mem_tracker_;
+  std::shared_ptr<MemTracker> memtable_mem_tracker_;
 
   MetricEntityPtr metric_entity_;
   gscoped_ptr<TabletMetrics> metrics_;
@@ -607,6 +689,12 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<common::YQLStorageIf> ql_storage_;
 
+  // Cache of QL point read results, only created when enabled by tablet_row_cache_capacity or by
+  // the use_row_cache table property.
+  std::unique_ptr<RowCache> row_cache_;
+
+  std::unique_ptr<TabletLoadTracker> load_tracker_;
+
   // This is for docdb fine-grained locking.
   docdb::SharedLockManager shared_lock_manager_;
 
@@ -646,18 +734,47 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::atomic<int64_t> last_committed_write_index_{0};
 
+  // State of the follower-side apply batch, see BeginApplyBatch().
+  std::mutex apply_batch_mutex_;
+  // Thread that started the apply batch, only writes applied by this thread are batched.
+  std::thread::id apply_batch_thread_;
+  bool apply_batch_active_ = false;
+  rocksdb::WriteBatch apply_batch_;
+  OpId apply_batch_first_op_id_;
+  OpId apply_batch_last_op_id_;
+  HybridTime apply_batch_first_hybrid_time_;
+  HybridTime apply_batch_last_hybrid_time_;
+  std::vector<std::function<void()>> apply_batch_callbacks_;
+
   // Remembers he HybridTime of the oldest write that is still not scheduled to
   // be flushed in RocksDB.
   std::shared_ptr<TabletFlushStats> flush_stats_;
 
+  // Collects keys dropped by compactions, null when compactions are not recorded to the history
+  // of the tablet server.
+  docdb::DocDBCompactionFilterStatsCollectorPtr compaction_filter_stats_;
+
   HybridTimeLeaseProvider ht_lease_provider_;
 
  private:
   HybridTime DoGetSafeTime(
       RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const override;
 
+  // Creates a row iterator for NewRowIterator, the caller should initialize it.
+  Result<std::unique_ptr<docdb::DocRowwiseIterator>> CreateRowIterator(
+      const Schema &projection, const boost::optional<TransactionId>& transaction_id) const;
+
+  // Waits until the safe time reaches min_allowed, DoGetSafeTime wraps it to record the wait time.
+  HybridTime WaitSafeTime(
+      RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const;
+
+  // Records time spent in stages of a QL read, that were reported by the doc read operation.
+  void RecordReadStageLatencies(const QLReadRequestResult& result);
+
   CHECKED_STATUS UpdateQLIndexes(docdb::DocOperations* doc_ops);
 
+  void FlushApplyBatchUnlocked();
+
   Result<bool> IntentsDbFlushFilter(const rocksdb::MemTable& memtable);
 
   std::function<rocksdb::MemTableFilter()> mem_table_flush_filter_factory_;
@@ -43,9 +43,18 @@
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tablet/tablet_metadata.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/tostring.h"
 #include "yb/tablet/tablet_options.h"
 
+DECLARE_bool(tablet_bootstrap_read_segments_ahead);
+DECLARE_int32(log_min_segments_to_retain);
+DECLARE_int32(log_min_seconds_to_retain);
+DECLARE_uint64(log_segment_size_bytes);
+
+DEFINE_int32(bootstrap_benchmark_num_ops, 2000,
+             "Number of ops replayed by BootstrapBenchmark.");
+
 using std::shared_ptr;
 using std::string;
 using std::vector;
@@ -76,6 +85,8 @@ using server::Clock;
 using server::LogicalClock;
 using tserver::WriteRequestPB;
 
+using namespace yb::size_literals;
+
 class BootstrapTest : public LogTestBase {
  protected:
 
@@ -337,5 +348,90 @@ TEST_F(BootstrapTest, TestConsensusOnlyOperationOutOfOrderHybridTime) {
   ASSERT_EQ(1, results.size());
 }
 
+// Replays a log of several segments and reports the replay speed.
+TEST_F(BootstrapTest, BootstrapBenchmark) {
+  const int kNumOps = FLAGS_bootstrap_benchmark_num_ops;
+  constexpr int kOpsPerSegment = 500;
+  const std::string kValue(512, 'x');
+  BuildLog();
+
+  OpId committed_opid = MakeOpId(0, 0);
+  for (int i = 1; i <= kNumOps; ++i) {
+    const OpId opid = MakeOpId(1, i);
+    AppendReplicateBatch(opid, committed_opid, {TupleForAppend(i, i, kValue)}, false /* sync */);
+    committed_opid = opid;
+    if (i % kOpsPerSegment == 0) {
+      ASSERT_OK(log_->WaitUntilAllFlushed());
+      ASSERT_OK(RollLog());
+    }
+  }
+  AppendReplicateBatch(MakeOpId(1, kNumOps + 1), committed_opid, {}, true /* sync */);
+
+  log::SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  int64_t total_bytes = 0;
+  for (const auto& segment : segments) {
+    total_bytes += segment->file_size();
+  }
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  auto start = MonoTime::Now();
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  auto elapsed = MonoTime::Now() - start;
+  ASSERT_OPID_EQ(boot_info.last_committed_id, committed_opid);
+
+  LOG(INFO) << "Replayed " << segments.size() << " segments, " << total_bytes << " bytes in "
+            << elapsed.ToString() << " (read ahead: " << FLAGS_tablet_bootstrap_read_segments_ahead
+            << "): " << total_bytes / elapsed.ToSeconds() / 1_MB << " MB/s";
+
+  vector<string> results;
+  IterateTabletRows(tablet.get(), &results);
+  ASSERT_EQ(kNumOps, results.size());
+}
+
+// Old segments with all entries flushed to RocksDB are not replayed by the next bootstrap.
+TEST_F(BootstrapTest, TestSkipFlushedSegments) {
+  constexpr int kNumOps = 2000;
+  const std::string kValue(512, 'x');
+  BuildLog();
+
+  OpId committed_opid = MakeOpId(0, 0);
+  for (int i = 1; i <= kNumOps; ++i) {
+    const OpId opid = MakeOpId(1, i);
+    AppendReplicateBatch(opid, committed_opid, {TupleForAppend(i, i, kValue)}, false /* sync */);
+    committed_opid = opid;
+  }
+  AppendReplicateBatch(MakeOpId(1, kNumOps + 1), committed_opid, {}, true /* sync */);
+
+  // Replayed entries are rewritten to several small segments.
+  FLAGS_log_segment_size_bytes = 64_KB;
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+  tablet->Shutdown();
+  tablet.reset();
+  ASSERT_OK(log_->Close());
+
+  FLAGS_log_min_segments_to_retain = 1;
+  FLAGS_log_min_seconds_to_retain = 0;
+  scoped_refptr<TabletMetadata> meta;
+  ASSERT_OK(LoadTestTabletMetadata(-1, -1, &meta));
+  ConsensusBootstrapInfo reboot_info;
+  ASSERT_OK(RunBootstrapOnTestTablet(meta, &tablet, &reboot_info));
+  ASSERT_OPID_EQ(reboot_info.last_committed_id, committed_opid);
+  ASSERT_OPID_EQ(reboot_info.last_id, MakeOpId(1, kNumOps + 1));
+  ASSERT_EQ(1, reboot_info.orphaned_replicates.size());
+
+  vector<string> results;
+  IterateTabletRows(tablet.get(), &results);
+  ASSERT_EQ(kNumOps, results.size());
+
+  // Skipped entries were not rewritten to the new log.
+  ASSERT_OK(RollLog());
+  ASSERT_GT(log_->GetLogReader()->GetMinReplicateIndex(), 1);
+}
+
 } // namespace tablet
 } // namespace yb
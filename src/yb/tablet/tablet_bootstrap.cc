@@ -46,6 +46,7 @@
 #include "yb/util/opid.h"
 #include "yb/util/logging.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/thread.h"
 
 DEFINE_bool(skip_remove_old_recovery_dir, false,
             "Skip removing WAL recovery dir after startup. (useful for debugging)");
@@ -55,7 +56,19 @@ DEFINE_test_flag(double, fault_crash_during_log_replay, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after processing a log entry during log replay.");
 
+DEFINE_bool(tablet_bootstrap_read_segments_ahead, true,
+            "Read and decode the next WAL segment on a separate thread while entries of the "
+            "current one are replayed during tablet bootstrap.");
+TAG_FLAG(tablet_bootstrap_read_segments_ahead, advanced);
+
+DEFINE_bool(tablet_bootstrap_skip_flushed_segments, true,
+            "Do not replay and rewrite old WAL segments, whose entries are all flushed to RocksDB "
+            "and that log GC would be allowed to remove, during tablet bootstrap.");
+TAG_FLAG(tablet_bootstrap_skip_flushed_segments, advanced);
+
 DECLARE_uint64(max_clock_sync_error_usec);
+DECLARE_int32(log_min_segments_to_retain);
+DECLARE_int32(log_min_seconds_to_retain);
 
 namespace yb {
 namespace tablet {
@@ -100,6 +113,75 @@ static string DebugInfo(const string& tablet_id,
                     segment_path, debug_str);
 }
 
+// ============================================================================
+//  Class SegmentReader.
+// ============================================================================
+
+// Reads entries of log segments in order. When enabled, the segment following the one that was
+// returned is read on a separate thread, so reading and decoding it is overlapped with replaying
+// the returned entries. Only one segment is read ahead, to bound memory usage.
+class SegmentReader {
+ public:
+  explicit SegmentReader(const log::SegmentSequence* segments) : segments_(*segments) {}
+
+  ~SegmentReader() {
+    Join();
+  }
+
+  bool HasNext() const {
+    return next_idx_ < segments_.size();
+  }
+
+  // Fills 'entries' with entries of the next segment, and returns the status of reading it. As
+  // with ReadableLogSegment::ReadEntries, entries read before a failure are still returned.
+  CHECKED_STATUS ReadNext(log::LogEntries* entries) {
+    DCHECK(HasNext());
+    if (thread_) {
+      Join();
+    } else {
+      ReadSegment(next_idx_);
+    }
+    entries->swap(entries_);
+    entries_.clear();
+    Status result = std::move(read_status_);
+    read_status_ = Status::OK();
+    ++next_idx_;
+
+    if (FLAGS_tablet_bootstrap_read_segments_ahead && HasNext()) {
+      Status s = Thread::Create("tablet-bootstrap", "read-segment",
+                                &SegmentReader::ReadSegment, this, next_idx_, &thread_);
+      if (!s.ok()) {
+        LOG(WARNING) << "Unable to read WAL segment on a separate thread: " << s;
+        thread_ = nullptr;
+      }
+    }
+    return result;
+  }
+
+ private:
+  void ReadSegment(size_t idx) {
+    read_status_ = segments_[idx]->ReadEntries(&entries_);
+  }
+
+  void Join() {
+    if (thread_) {
+      thread_->Join();
+      thread_ = nullptr;
+    }
+  }
+
+  const log::SegmentSequence& segments_;
+  size_t next_idx_ = 0;
+
+  // Result of reading segment next_idx_, filled by ReadSegment.
+  log::LogEntries entries_;
+  Status read_status_;
+
+  scoped_refptr<Thread> thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentReader);
+};
+
 // ============================================================================
 //  Class ReplayState.
 // ============================================================================
@@ -708,16 +790,18 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
 
   log::SegmentSequence segments;
   RETURN_NOT_OK(log_reader_->GetSegmentsSnapshot(&segments));
+  SkipFlushedSegments(state, &segments);
 
   // We defer opening the log until here, so that we properly reproduce the point-in-time schema
   // from the log we're reading into the log we're writing.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
   int segment_count = 0;
+  SegmentReader segment_reader(&segments);
   for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
     log::LogEntries entries;
     // TODO: Optimize this to not read the whole thing into memory?
-    Status read_status = segment->ReadEntries(&entries);
+    Status read_status = segment_reader.ReadNext(&entries);
     for (int entry_idx = 0; entry_idx < entries.size(); ++entry_idx) {
       Status s = HandleEntry(&state, &entries[entry_idx]);
       if (!s.ok()) {
@@ -748,7 +832,7 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
     // number of MB processed, but this is better than nothing.
     listener_->StatusMessage(Substitute("Bootstrap replayed $0/$1 log segments. "
                                         "Stats: $2. Pending: $3 replicates",
-                                        segment_count + 1, log_reader_->num_segments(),
+                                        segment_count + 1, segments.size(),
                                         stats_.ToString(),
                                         state.pending_replicates.size()));
     segment_count++;
@@ -779,6 +863,42 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   return Status::OK();
 }
 
+void TabletBootstrap::SkipFlushedSegments(const ReplayState& state,
+                                          log::SegmentSequence* segments) {
+  if (!FLAGS_tablet_bootstrap_skip_flushed_segments) {
+    return;
+  }
+  // Entries of transactional writes are replayed unless they are flushed to intents RocksDB.
+  int64_t flushed_index = state.regular_stored_op_id.index();
+  if (tablet_->transaction_participant()) {
+    flushed_index = std::min(flushed_index, state.intents_stored_op_id.index());
+  }
+
+  // Only segments that log GC could remove are skipped, so followers could still be caught up
+  // from the rewritten log as before. The entry at the flushed index should be replayed to set
+  // the safe time, so segments containing it are always kept.
+  const int64_t max_close_time_us =
+      GetCurrentTimeMicros() - FLAGS_log_min_seconds_to_retain * MonoTime::kMicrosecondsPerSecond;
+  const int64_t max_to_skip =
+      static_cast<int64_t>(segments->size()) - std::max(FLAGS_log_min_segments_to_retain, 1);
+  int64_t num_skipped = 0;
+  for (; num_skipped < max_to_skip; ++num_skipped) {
+    const auto& segment = (*segments)[num_skipped];
+    if (!segment->HasFooter() || segment->footer().max_replicate_index() >= flushed_index ||
+        segment->footer().close_timestamp_micros() > max_close_time_us) {
+      break;
+    }
+  }
+  if (num_skipped == 0) {
+    return;
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Skipping " << num_skipped << " of " << segments->size()
+                        << " log segments, with all entries flushed up to index "
+                        << (*segments)[num_skipped - 1]->footer().max_replicate_index();
+  segments->erase(segments->begin(), segments->begin() + num_skipped);
+}
+
 void TabletBootstrap::PlayWriteRequest(ReplicateMsg* replicate_msg) {
   DCHECK(replicate_msg->has_hybrid_time());
 
@@ -109,6 +109,10 @@ class TabletBootstrap {
   // accepting writes from clients.
   CHECKED_STATUS PlaySegments(consensus::ConsensusBootstrapInfo* results);
 
+  // Removes old segments, that do not have to be replayed because all their entries are flushed
+  // to RocksDB, from the beginning of 'segments'.
+  void SkipFlushedSegments(const ReplayState& state, log::SegmentSequence* segments);
+
   void PlayWriteRequest(consensus::ReplicateMsg* replicate_msg);
 
   CHECKED_STATUS PlayUpdateTransactionRequest(consensus::ReplicateMsg* replicate_msg);
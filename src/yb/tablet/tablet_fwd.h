@@ -23,8 +23,11 @@ class TabletMetadata;
 class TabletPeer;
 class TabletStatusPB;
 class TabletStatusListener;
+class WriteOperation;
 class WriteOperationState;
 
+struct ConflictWait;
+
 class OperationDriver;
 typedef scoped_refptr<OperationDriver> OperationDriverPtr;
 
@@ -0,0 +1,132 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/tablet_load_tracker.h"
+
+#include <algorithm>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(tablet_hot_keys_capacity, 32,
+             "Number of hash codes tracked by each tablet for each type of access, when looking "
+             "for hot keys.");
+
+DEFINE_int32(tablet_hot_keys_sample_every_n, 8,
+             "Only every N-th access to a tablet is recorded when looking for hot keys.");
+TAG_FLAG(tablet_hot_keys_sample_every_n, runtime);
+TAG_FLAG(tablet_hot_keys_sample_every_n, advanced);
+
+DEFINE_int32(tablet_load_window_ms, 10000,
+             "Length of the window over which tablet op rates and hot keys are measured.");
+TAG_FLAG(tablet_load_window_ms, runtime);
+TAG_FLAG(tablet_load_window_ms, advanced);
+
+METRIC_DEFINE_gauge_uint64(tablet, tablet_read_ops_per_sec, "Tablet Read Ops Per Second",
+                           yb::MetricUnit::kOperations,
+                           "Rate of reads of the tablet over the last load window.");
+
+METRIC_DEFINE_gauge_uint64(tablet, tablet_write_ops_per_sec, "Tablet Write Ops Per Second",
+                           yb::MetricUnit::kOperations,
+                           "Rate of writes to the tablet over the last load window.");
+
+METRIC_DEFINE_gauge_uint64(tablet, tablet_conflicts_per_sec, "Tablet Conflicts Per Second",
+                           yb::MetricUnit::kOperations,
+                           "Rate of write conflicts in the tablet over the last load window.");
+
+METRIC_DEFINE_gauge_uint64(tablet, hottest_key_percent, "Hottest Key Percent",
+                           yb::MetricUnit::kUnits,
+                           "Max percent of reads or writes of the tablet that accessed a single "
+                           "hash code over the last load windows.");
+
+namespace yb {
+namespace tablet {
+
+TabletLoadTracker::TabletLoadTracker(const scoped_refptr<MetricEntity>& metric_entity)
+    : window_start_(MonoTime::Now()) {
+  for (auto& num_ops : num_ops_) {
+    num_ops.store(0, std::memory_order_relaxed);
+  }
+  const size_t capacity = std::max(FLAGS_tablet_hot_keys_capacity, 1);
+  for (size_t i = 0; i != kElementsInKeyAccessType; ++i) {
+    sketches_.emplace_back(capacity);
+  }
+  if (metric_entity) {
+    ops_per_sec_gauges_[to_underlying(KeyAccessType::kRead)] =
+        METRIC_tablet_read_ops_per_sec.Instantiate(metric_entity, 0);
+    ops_per_sec_gauges_[to_underlying(KeyAccessType::kWrite)] =
+        METRIC_tablet_write_ops_per_sec.Instantiate(metric_entity, 0);
+    ops_per_sec_gauges_[to_underlying(KeyAccessType::kConflict)] =
+        METRIC_tablet_conflicts_per_sec.Instantiate(metric_entity, 0);
+    hottest_key_percent_gauge_ = METRIC_hottest_key_percent.Instantiate(metric_entity, 0);
+  }
+}
+
+void TabletLoadTracker::Record(KeyAccessType type, uint16_t hash_code) {
+  const uint64_t sample_every_n = std::max(FLAGS_tablet_hot_keys_sample_every_n, 1);
+  const auto op = num_ops_[to_underlying(type)].fetch_add(1, std::memory_order_relaxed);
+  if (op % sample_every_n != 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  sketches_[to_underlying(type)].Record(hash_code, sample_every_n);
+}
+
+std::vector<HotKey> TabletLoadTracker::HotKeys(KeyAccessType type, size_t limit) const {
+  std::vector<HotKey> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& sketch = sketches_[to_underlying(type)];
+  for (const auto& entry : sketch.Top(limit)) {
+    result.push_back(HotKey{
+        entry.key, entry.count, entry.error, static_cast<double>(entry.count) / sketch.total()});
+  }
+  return result;
+}
+
+TabletLoad TabletLoadTracker::GetLoad(MonoTime now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const MonoDelta elapsed = now.GetDeltaSince(window_start_);
+  if (elapsed.ToMilliseconds() < FLAGS_tablet_load_window_ms) {
+    return load_;
+  }
+
+  const double elapsed_sec = elapsed.ToSeconds();
+  load_.hottest_key_share = 0;
+  for (auto type : kKeyAccessTypeList) {
+    const size_t index = to_underlying(type);
+    const uint64_t num_ops = num_ops_[index].load(std::memory_order_relaxed);
+    load_.ops_per_sec[index] = (num_ops - window_start_ops_[index]) / elapsed_sec;
+    window_start_ops_[index] = num_ops;
+    if (ops_per_sec_gauges_[index]) {
+      ops_per_sec_gauges_[index]->set_value(load_.ops_per_sec[index]);
+    }
+
+    auto& sketch = sketches_[index];
+    if (type != KeyAccessType::kConflict && sketch.total() != 0) {
+      auto top = sketch.Top(1);
+      if (!top.empty()) {
+        load_.hottest_key_share = std::max(
+            load_.hottest_key_share, static_cast<double>(top[0].count) / sketch.total());
+      }
+    }
+    // Halving counts every window keeps hot keys of the last few windows.
+    sketch.Decay(2);
+  }
+  if (hottest_key_percent_gauge_) {
+    hottest_key_percent_gauge_->set_value(load_.hottest_key_share * 100);
+  }
+  window_start_ = now;
+  return load_;
+}
+
+} // namespace tablet
+} // namespace yb
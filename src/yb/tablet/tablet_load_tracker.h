@@ -0,0 +1,93 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TABLET_LOAD_TRACKER_H
+#define YB_TABLET_TABLET_LOAD_TRACKER_H
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "yb/util/enums.h"
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+#include "yb/util/space_saving.h"
+
+namespace yb {
+namespace tablet {
+
+YB_DEFINE_ENUM(KeyAccessType, (kRead)(kWrite)(kConflict));
+
+struct HotKey {
+  // Hash code of the DocKey, i.e. hash partition prefix of the key.
+  uint16_t hash_code;
+  // Estimated number of accesses in the recent windows and its max overestimation.
+  uint64_t count;
+  uint64_t error;
+  // Estimated fraction of all accesses of this type to the tablet.
+  double share;
+};
+
+struct TabletLoad {
+  std::array<double, kElementsInKeyAccessType> ops_per_sec{};
+  // Max share of reads or writes that went to a single hash code.
+  double hottest_key_share = 0;
+
+  double ops(KeyAccessType type) const { return ops_per_sec[to_underlying(type)]; }
+};
+
+// Tracks the load of a tablet: rates of reads, writes and conflicts, and the hash codes that
+// receive most of them.
+//
+// Every operation increments a counter, and every N-th one is also recorded in a space-saving
+// sketch, so tracking is cheap on the hot path. Rates are computed over windows of
+// tablet_load_window_ms, and sketches are decayed every window, so they reflect recent load.
+class TabletLoadTracker {
+ public:
+  // metric_entity could be null, in this case load is not exported as metrics.
+  explicit TabletLoadTracker(const scoped_refptr<MetricEntity>& metric_entity);
+
+  // Records an access to a key with the specified hash code.
+  void Record(KeyAccessType type, uint16_t hash_code);
+
+  // Records an access that could not be attributed to a hash code, e.g. a scan.
+  void RecordOp(KeyAccessType type) {
+    num_ops_[to_underlying(type)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Returns up to limit hottest keys for accesses of the specified type.
+  std::vector<HotKey> HotKeys(KeyAccessType type, size_t limit) const;
+
+  // Returns the load measured over the last completed window, and starts a new window if the
+  // current one is over.
+  TabletLoad GetLoad(MonoTime now = MonoTime::Now());
+
+ private:
+  std::array<std::atomic<uint64_t>, kElementsInKeyAccessType> num_ops_;
+
+  mutable std::mutex mutex_;
+  std::vector<SpaceSaving<uint16_t>> sketches_;
+  MonoTime window_start_;
+  std::array<uint64_t, kElementsInKeyAccessType> window_start_ops_{};
+  TabletLoad load_;
+
+  // Null when load is not exported as metrics.
+  std::array<scoped_refptr<AtomicGauge<uint64_t>>, kElementsInKeyAccessType> ops_per_sec_gauges_;
+  scoped_refptr<AtomicGauge<uint64_t>> hottest_key_percent_gauge_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TABLET_LOAD_TRACKER_H
@@ -209,7 +209,9 @@ Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
       &rocksdb_options, tablet_id_, nullptr /* statistics */, tablet_options);
 
   LOG(INFO) << "Destroying regular db at: " << rocksdb_dir_;
-  rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir_, rocksdb_options);
+  rocksdb::Options regular_rocksdb_options = rocksdb_options;
+  docdb::InitRocksDBDataPaths(rocksdb_dir_, &regular_rocksdb_options);
+  rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir_, regular_rocksdb_options);
 
   if (!status.ok()) {
     LOG(ERROR) << "Failed to destroy regular DB at: " << rocksdb_dir_ << ": " << status;
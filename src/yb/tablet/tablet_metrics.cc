@@ -74,6 +74,53 @@ METRIC_DEFINE_histogram(
     tablet, write_lock_latency, "Write lock latency", yb::MetricUnit::kMicroseconds,
     "Time taken to acquire key locks for a write operation", 60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    tablet, write_doc_operations_latency, "Write doc operations latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time from receiving a write until its locks are acquired and doc operations are performed",
+    60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_prepare_latency, "Write prepare latency", yb::MetricUnit::kMicroseconds,
+    "Time a write waits in the preparer queue", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_start_latency, "Write start latency", yb::MetricUnit::kMicroseconds,
+    "Time from preparing a write until it gets a hybrid time and is submitted for replication",
+    60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_replicate_latency, "Write replicate latency", yb::MetricUnit::kMicroseconds,
+    "Time from submitting a write for replication until its apply starts", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_apply_latency, "Write apply latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to apply a replicated write to RocksDB", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_commit_latency, "Write commit latency", yb::MetricUnit::kMicroseconds,
+    "Time from applying a write until it becomes visible to readers", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_conflict_resolution_latency, "Write conflict resolution latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time taken to resolve conflicts of a write operation with other transactions, including "
+    "waiting for conflicting transactions", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, read_safe_time_wait_latency, "Read safe time wait latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time a read waits for the tablet safe time to reach its read time", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, read_iterator_init_latency, "Read iterator init latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time taken to create and position the iterator of a QLReadRequest", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, read_fetch_rows_latency, "Read fetch rows latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to seek and iterate over the rows of a QLReadRequest", 60000000LU, 2);
+
 METRIC_DEFINE_gauge_uint32(tablet, compact_rs_running,
   "RowSet Compactions Running",
   yb::MetricUnit::kMaintenanceOperations,
@@ -136,6 +183,16 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
     MINIT(write_op_duration_client_propagated_consistency),
+    MINIT(write_doc_operations_latency),
+    MINIT(write_prepare_latency),
+    MINIT(write_start_latency),
+    MINIT(write_replicate_latency),
+    MINIT(write_apply_latency),
+    MINIT(write_commit_latency),
+    MINIT(write_conflict_resolution_latency),
+    MINIT(read_safe_time_wait_latency),
+    MINIT(read_iterator_init_latency),
+    MINIT(read_fetch_rows_latency),
     MINIT(leader_memory_pressure_rejections),
     MINIT(transaction_conflicts),
     MINIT(expired_transactions),
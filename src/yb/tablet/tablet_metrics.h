@@ -60,6 +60,20 @@ struct TabletMetrics {
   scoped_refptr<Histogram> write_op_duration_client_propagated_consistency;
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
+  // Time spent by leader write operations in each stage of the write path, see WriteStage.
+  scoped_refptr<Histogram> write_doc_operations_latency;
+  scoped_refptr<Histogram> write_prepare_latency;
+  scoped_refptr<Histogram> write_start_latency;
+  scoped_refptr<Histogram> write_replicate_latency;
+  scoped_refptr<Histogram> write_apply_latency;
+  scoped_refptr<Histogram> write_commit_latency;
+  scoped_refptr<Histogram> write_conflict_resolution_latency;
+
+  // Stages of a read operation.
+  scoped_refptr<Histogram> read_safe_time_wait_latency;
+  scoped_refptr<Histogram> read_iterator_init_latency;
+  scoped_refptr<Histogram> read_fetch_rows_latency;
+
   scoped_refptr<Counter> leader_memory_pressure_rejections;
   scoped_refptr<Counter> transaction_conflicts;
   scoped_refptr<Counter> expired_transactions;
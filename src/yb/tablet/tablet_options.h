@@ -17,15 +17,35 @@ namespace rocksdb {
 class Cache;
 class EventListener;
 class MemoryMonitor;
+class PersistentCache;
+class RateLimiter;
 }
 
 namespace yb {
+
+class MemTracker;
+class PriorityThreadPool;
+
 namespace tablet {
 
+class CompactionHistory;
+
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  // Second block cache tier, that keeps data blocks in compressed form.
+  std::shared_ptr<rocksdb::Cache> block_cache_compressed;
+  // Tracks memory of top level index and filter blocks that are pinned outside of block cache.
+  std::shared_ptr<MemTracker> pinned_index_and_filter_mem_tracker;
+  // Secondary block cache tier on a local flash device.
+  std::shared_ptr<rocksdb::PersistentCache> persistent_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
+  // Runs compactions of all tablets, so the most needed ones are started first.
+  std::shared_ptr<PriorityThreadPool> priority_thread_pool;
+  // Limits write rate of flushes and compactions of all tablets together.
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
+  // Keeps the latest flush and compaction jobs of all tablets.
+  std::shared_ptr<CompactionHistory> compaction_history;
 };
 
 } // namespace tablet
@@ -52,6 +52,7 @@
 #include "yb/tablet/operations/operation.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/tablet/operations/write_operation.h"
+#include "yb/tablet/preparer.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/tablet_peer_mm_ops.h"
 #include "yb/tablet/tablet-test-util.h"
@@ -62,6 +63,8 @@
 #include "yb/util/threadpool.h"
 
 METRIC_DECLARE_entity(tablet);
+METRIC_DECLARE_histogram(group_replicate_batch_size);
+METRIC_DECLARE_histogram(prepare_queue_wait);
 
 DECLARE_int32(log_min_seconds_to_retain);
 
@@ -455,6 +458,43 @@ TEST_P(TabletPeerTest, TestGCEmptyLog) {
   ASSERT_OK(tablet_peer_->RunLogGC());
 }
 
+// Ensure that leader-side operations are replicated in batches limited by
+// max_group_replicate_batch_size, and that batch metrics are exported.
+TEST_P(TabletPeerTest, TestGroupReplicateBatchSize) {
+  constexpr uint64_t kMaxBatchSize = 2;
+  constexpr uint64_t kNumWrites = 50;
+  FLAGS_max_group_replicate_batch_size = kMaxBatchSize;
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartPeer(info));
+
+  auto batch_size = METRIC_group_replicate_batch_size.Instantiate(tablet()->GetMetricEntity());
+  auto queue_wait = METRIC_prepare_queue_wait.Instantiate(tablet()->GetMetricEntity());
+  auto initial_ops = batch_size->TotalSum();
+
+  // Submit all writes before waiting, so the prepare queue has a chance to build up.
+  std::vector<WriteRequestPB> requests(kNumWrites);
+  std::vector<WriteResponsePB> responses(kNumWrites);
+  CountDownLatch latch(kNumWrites);
+  for (size_t i = 0; i != kNumWrites; ++i) {
+    GenerateSequentialInsertRequest(&requests[i]);
+    auto operation_state = std::make_unique<WriteOperationState>(
+        tablet_peer_->tablet(), &requests[i], &responses[i]);
+    operation_state->set_completion_callback(
+        std::make_unique<LatchWriteCallback>(&latch, &responses[i]));
+    ASSERT_OK(tablet_peer_->SubmitWrite(std::move(operation_state), MonoTime::Max()));
+  }
+  latch.Wait();
+  for (const auto& response : responses) {
+    ASSERT_FALSE(response.has_error()) << response.ShortDebugString();
+  }
+
+  // No-op of the emulated election could also be counted.
+  ASSERT_GE(batch_size->TotalSum(), initial_ops + kNumWrites);
+  ASSERT_GE(batch_size->TotalCount(), kNumWrites / kMaxBatchSize);
+  ASSERT_LE(batch_size->MaxValueForTests(), kMaxBatchSize);
+  ASSERT_GE(queue_wait->TotalCount(), kNumWrites);
+}
+
 INSTANTIATE_TEST_CASE_P(Rocks, TabletPeerTest, ::testing::Values(YQL_TABLE_TYPE));
 
 } // namespace tablet
@@ -51,6 +51,7 @@
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/docdb.h"
+#include "yb/docdb/wait_queue.h"
 
 #include "yb/gutil/mathlimits.h"
 #include "yb/gutil/stl_util.h"
@@ -59,6 +60,8 @@
 
 #include "yb/rocksdb/db/memtable.h"
 
+#include "yb/rpc/messenger.h"
+
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
@@ -72,12 +75,25 @@
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 
+DEFINE_bool(enable_wait_queues, false,
+            "When a transactional write conflicts with transactions of higher priority, wait "
+            "until they are resolved instead of failing the write.");
+TAG_FLAG(enable_wait_queues, advanced);
+TAG_FLAG(enable_wait_queues, runtime);
+
+DEFINE_int32(wait_queue_max_wait_ms, 1000,
+             "Max time that a transactional write waits for conflicting transactions to be "
+             "resolved, before failing with a conflict.");
+TAG_FLAG(wait_queue_max_wait_ms, advanced);
+TAG_FLAG(wait_queue_max_wait_ms, runtime);
+
 using std::shared_ptr;
 using std::string;
 
@@ -169,6 +185,7 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
     CHECK_EQ(TabletStatePB::BOOTSTRAPPING, state_);
     tablet_ = tablet;
     client_future_ = client_future;
+    messenger_ = messenger;
     clock_ = clock;
     proxy_cache_ = proxy_cache;
     log_ = log;
@@ -249,7 +266,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
       }
     });
 
-    prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    prepare_thread_ = std::make_unique<Preparer>(
+        consensus_.get(), tablet_prepare_pool, tablet_->GetMetricEntity());
   }
 
   RETURN_NOT_OK(prepare_thread_->Start());
@@ -413,31 +431,142 @@ Status TabletPeer::WaitUntilConsensusRunning(const MonoDelta& timeout) {
   return Status::OK();
 }
 
+// Transactional write that could wait for conflicting transactions and be retried.
+struct TabletPeer::PendingWrite {
+  std::unique_ptr<WriteOperation> operation;
+  MonoTime deadline;
+  // Deadline of waiting for conflicting transactions, over all retries.
+  MonoTime wait_deadline;
+  // Original request and response, that are restored before retrying the write.
+  tserver::WriteRequestPB request;
+  tserver::WriteResponsePB response;
+};
+
 Status TabletPeer::SubmitWrite(
     std::unique_ptr<WriteOperationState> state, MonoTime deadline) {
   auto operation = std::make_unique<WriteOperation>(std::move(state), consensus::LEADER);
   RETURN_NOT_OK(CheckRunning());
 
+  if (GetAtomicFlag(&FLAGS_enable_wait_queues) && tablet_->transaction_participant() &&
+      operation->state()->request()->write_batch().has_transaction()) {
+    auto write = std::make_shared<PendingWrite>();
+    write->deadline = deadline;
+    write->wait_deadline = std::min(
+        deadline,
+        MonoTime::Now() + MonoDelta::FromMilliseconds(
+            GetAtomicFlag(&FLAGS_wait_queue_max_wait_ms)));
+    write->request = *operation->state()->request();
+    write->response = *operation->state()->response();
+    write->operation = std::move(operation);
+    return SubmitPendingWrite(write);
+  }
+
+  return DoSubmitWrite(&operation, deadline, nullptr /* conflict_wait */);
+}
+
+Status TabletPeer::DoSubmitWrite(
+    std::unique_ptr<WriteOperation>* operation, MonoTime deadline, ConflictWait* conflict_wait) {
+  auto* state = (*operation)->state();
   HybridTime restart_read_ht;
   RETURN_NOT_OK(tablet_->AcquireLocksAndPerformDocOperations(
-      deadline, operation->state(), &restart_read_ht));
+      deadline, state, &restart_read_ht, conflict_wait));
+  state->RecordStage(WriteStage::kDocOperationsPerformed);
   // If a restart read is required, then we return this fact to caller and don't perform the write
   // operation.
   if (restart_read_ht.is_valid()) {
-    auto restart_time = operation->state()->response()->mutable_restart_read_time();
+    auto restart_time = state->response()->mutable_restart_read_time();
     restart_time->set_read_ht(restart_read_ht.ToUint64());
     restart_time->set_local_limit_ht(
         tablet_->SafeTime(RequireLease::kTrue).ToUint64());
     // Global limit is ignored by caller, so we don't set it.
-    operation->state()->completion_callback()->OperationCompleted();
+    state->completion_callback()->OperationCompleted();
     tablet_->metrics()->restart_read_requests->Increment();
     return Status::OK();
   }
-  auto driver = VERIFY_RESULT(NewLeaderOperationDriver(std::move(operation)));
+  auto driver = VERIFY_RESULT(NewLeaderOperationDriver(std::move(*operation)));
   driver->ExecuteAsync();
   return Status::OK();
 }
 
+Status TabletPeer::SubmitPendingWrite(const std::shared_ptr<PendingWrite>& write) {
+  ConflictWait conflict_wait;
+  auto status = DoSubmitWrite(&write->operation, write->deadline, &conflict_wait);
+  if (status.ok() || conflict_wait.blockers.empty()) {
+    return status;
+  }
+  if (!messenger_) {
+    // Wait queue is not polled without scheduler, so the conflict is reported to the client.
+    return status;
+  }
+
+  // Undo changes made to the request and response by this attempt, so the write could be
+  // performed from scratch, or the conflict reported to the client.
+  auto* state = write->operation->state();
+  *state->mutable_request() = write->request;
+  *state->response() = write->response;
+  state->ql_write_ops()->clear();
+  state->pgsql_write_ops()->clear();
+
+  std::weak_ptr<TabletPeer> weak_peer = shared_from_this();
+  auto* pool = apply_pool_;
+  auto wake_time = tablet_->transaction_participant()->wait_queue()->WaitAsync(
+      conflict_wait.waiter, conflict_wait.blockers, write->wait_deadline,
+      [weak_peer, pool, write](const Status& resume_status) {
+        if (!resume_status.ok()) {
+          write->operation->state()->completion_callback()->CompleteWithStatus(resume_status);
+          return;
+        }
+        // Resume could be invoked under the participant lock, or on the messenger scheduler,
+        // so the retry is performed by the apply pool.
+        auto submit_status = pool->SubmitFunc([weak_peer, write] {
+          auto peer = weak_peer.lock();
+          if (peer) {
+            peer->RetryPendingWrite(write, Status::OK());
+          } else {
+            write->operation->state()->completion_callback()->CompleteWithStatus(
+                STATUS(Aborted, "Tablet peer was destroyed"));
+          }
+        });
+        if (!submit_status.ok()) {
+          write->operation->state()->completion_callback()->CompleteWithStatus(submit_status);
+        }
+      });
+  if (!wake_time.ok()) {
+    VLOG(2) << "T " << tablet_id() << ": Stop waiting for conflicting transactions: "
+            << wake_time.status();
+    return status;
+  }
+
+  // Blockers resolved at other tablets do not wake up the waiter, so it should be polled.
+  messenger_->scheduler().Schedule([weak_peer](const Status& status) {
+    auto peer = weak_peer.lock();
+    if (status.ok() && peer) {
+      peer->PollWaitQueue();
+    }
+  }, wake_time->ToSteadyTimePoint());
+  return Status::OK();
+}
+
+void TabletPeer::RetryPendingWrite(const std::shared_ptr<PendingWrite>& write, Status status) {
+  if (status.ok()) {
+    status = CheckRunning();
+  }
+  if (status.ok()) {
+    status = SubmitPendingWrite(write);
+  }
+  // Operation is released when it was submitted for replication.
+  if (!status.ok() && write->operation) {
+    write->operation->state()->completion_callback()->CompleteWithStatus(status);
+  }
+}
+
+void TabletPeer::PollWaitQueue() {
+  auto tablet = shared_tablet();
+  if (tablet && tablet->transaction_participant()) {
+    tablet->transaction_participant()->wait_queue()->Poll(MonoTime::Now());
+  }
+}
+
 void TabletPeer::Submit(std::unique_ptr<Operation> operation) {
   auto status = CheckRunning();
 
@@ -731,6 +860,14 @@ void TabletPeer::SetPropagatedSafeTime(HybridTime ht) {
   (**driver).ExecuteAsync();
 }
 
+void TabletPeer::BeginApplyBatch() {
+  tablet_->BeginApplyBatch();
+}
+
+void TabletPeer::EndApplyBatch() {
+  tablet_->EndApplyBatch();
+}
+
 const std::string& TabletPeer::permanent_uuid() const {
   if (cached_permanent_uuid_initialized_.load(std::memory_order_acquire)) {
     return cached_permanent_uuid_;
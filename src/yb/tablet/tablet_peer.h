@@ -90,7 +90,8 @@ namespace tablet {
 // class also splits the work and coordinates multi-threaded execution.
 class TabletPeer : public consensus::ReplicaOperationFactory,
                    public TransactionParticipantContext,
-                   public TransactionCoordinatorContext {
+                   public TransactionCoordinatorContext,
+                   public std::enable_shared_from_this<TabletPeer> {
  public:
   typedef std::map<int64_t, int64_t> MaxIdxToSegmentSizeMap;
 
@@ -136,6 +137,8 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
   // to the RPC WriteRequest, WriteResponse, RpcContext and to the tablet's
   // MvccManager.
   // The operation_state is deallocated after use by this function.
+  // When enable_wait_queues is set, a transactional write that conflicts with transactions of
+  // higher priority is resubmitted after they are resolved, instead of failing with the conflict.
   CHECKED_STATUS SubmitWrite(
       std::unique_ptr<WriteOperationState> operation_state, MonoTime deadline);
 
@@ -161,6 +164,10 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
   // UpdateReplica -> EnqueuePreparesUnlocked on Raft heartbeats.
   void SetPropagatedSafeTime(HybridTime ht) override;
 
+  // Overrides of ReplicaOperationFactory methods, see Tablet::BeginApplyBatch().
+  void BeginApplyBatch() override;
+  void EndApplyBatch() override;
+
   consensus::Consensus* consensus() const;
 
   std::shared_ptr<consensus::Consensus> shared_consensus() const;
@@ -388,8 +395,30 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
   mutable std::string cached_permanent_uuid_;
 
  private:
+  struct PendingWrite;
+
+  // Performs doc operations of the write and submits it for replication, that takes ownership
+  // of the operation. Conflicting transactions are stored in conflict_wait, if it is specified.
+  CHECKED_STATUS DoSubmitWrite(std::unique_ptr<WriteOperation>* operation,
+                               MonoTime deadline,
+                               ConflictWait* conflict_wait);
+
+  // Submits the write, and in case of a conflict registers it in the wait queue of the
+  // participant, to be retried when the conflicting transactions are resolved.
+  CHECKED_STATUS SubmitPendingWrite(const std::shared_ptr<PendingWrite>& write);
+
+  // Invoked on the apply pool, when the pending write was resumed by the wait queue.
+  void RetryPendingWrite(const std::shared_ptr<PendingWrite>& write, Status status);
+
+  // Resumes waiters of the participant wait queue, whose wake time has passed.
+  void PollWaitQueue();
+
   std::shared_future<client::YBClientPtr> client_future_;
 
+  // Schedules polls of the wait queue, for writes that wait for conflicting transactions.
+  // Writes do not wait when it is null.
+  std::shared_ptr<rpc::Messenger> messenger_;
+
   DISALLOW_COPY_AND_ASSIGN(TabletPeer);
 };
 
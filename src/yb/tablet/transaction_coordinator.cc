@@ -87,6 +87,12 @@ struct NotifyApplyingData {
   HybridTime commit_time;
 };
 
+struct CheckStagedWritesData {
+  TabletId tablet;
+  TransactionId transaction;
+  HybridTime staging_deadline;
+};
+
 // Context for transaction state. I.e. access to external facilities required by
 // transaction state to do its job.
 class TransactionStateContext {
@@ -95,6 +101,8 @@ class TransactionStateContext {
 
   virtual void NotifyApplying(NotifyApplyingData data) = 0;
 
+  virtual void CheckStagedWrites(CheckStagedWritesData data) = 0;
+
   virtual Counter& expired_metric() = 0;
 
   // Submits update transaction to the RAFT log. Returns false if was not able to submit.
@@ -160,7 +168,9 @@ class TransactionState {
 
   // Whether this transaction expired at specified time.
   bool ExpiredAt(HybridTime now) const {
-    if (ShouldBeCommitted()) {
+    // Staging transaction could be already reported as committed to the client, so it is resolved
+    // by checking its writes instead.
+    if (ShouldBeCommitted() || status_ == TransactionStatus::STAGING) {
       return false;
     }
     const int64_t passed = now.GetPhysicalValueMicros() - last_touch_.GetPhysicalValueMicros();
@@ -224,6 +234,11 @@ class TransactionState {
       response->set_status_hybrid_time(commit_time_.ToUint64());
     } else if (status_ == TransactionStatus::ABORTED) {
       response->set_status(TransactionStatus::ABORTED);
+    } else if (status_ == TransactionStatus::STAGING) {
+      // Commit time of staging transaction is not less than hybrid time of the staging record.
+      response->set_status(TransactionStatus::PENDING);
+      auto status_ht = std::min(staging_time_, context_.coordinator_context().HtLeaseExpiration());
+      response->set_status_hybrid_time(status_ht.Decremented().ToUint64());
     } else {
       CHECK_EQ(TransactionStatus::PENDING, status_);
       response->set_status(TransactionStatus::PENDING);
@@ -231,6 +246,7 @@ class TransactionState {
       if (replicating_) {
         auto replicating_status = replicating_->request()->status();
         if (replicating_status == TransactionStatus::COMMITTED ||
+            replicating_status == TransactionStatus::STAGING ||
             replicating_status == TransactionStatus::ABORTED) {
           auto replicating_ht = replicating_->hybrid_time_even_if_unset();
           if (replicating_ht.is_valid()) {
@@ -249,6 +265,10 @@ class TransactionState {
       return TransactionStatus::COMMITTED;
     } else if (status_ == TransactionStatus::ABORTED) {
       return TransactionStatus::ABORTED;
+    } else if (status_ == TransactionStatus::STAGING) {
+      // Staging transaction cannot be aborted by others, so just wait until it is resolved.
+      abort_waiters_.emplace_back(std::move(*callback));
+      return TransactionStatus::PENDING;
     } else {
       CHECK_EQ(TransactionStatus::PENDING, status_);
       abort_waiters_.emplace_back(std::move(*callback));
@@ -272,6 +292,40 @@ class TransactionState {
     DoHandle(std::move(request));
   }
 
+  // Checks whether batched heartbeat is accepted for this transaction. Sets *replicate when the
+  // heartbeat should be replicated for it. Heartbeat is rejected when transaction is aborted or
+  // is going to be aborted.
+  bool AcceptBatchedHeartbeat(HybridTime now, bool* replicate) {
+    if (status_ == TransactionStatus::ABORTED || ShouldBeAborted()) {
+      return false;
+    }
+    if (status_ != TransactionStatus::PENDING || ShouldBeCommitted() ||
+        ShouldBeInStatus(TransactionStatus::STAGING)) {
+      // Heartbeat is not required for committing and staging transactions.
+      return true;
+    }
+    if (ExpiredAt(now)) {
+      Abort();
+      return false;
+    }
+    *replicate = true;
+    return true;
+  }
+
+  // Applies replicated batched heartbeat. Such heartbeat is not tracked by replicating_, and is
+  // always replicated before status changes that were submitted after it.
+  void BatchedHeartbeatReplicated(const TransactionCoordinator::ReplicatedData& data) {
+    if (status_ != TransactionStatus::PENDING) {
+      return;
+    }
+    if (data.mode == ProcessingMode::LEADER && ExpiredAt(data.hybrid_time)) {
+      Abort();
+      return;
+    }
+    last_touch_ = data.hybrid_time;
+    first_entry_raft_index_ = data.op_id.index();
+  }
+
   // Aborts this transaction.
   void Abort() {
     if (ShouldBeCommitted()) {
@@ -285,13 +339,52 @@ class TransactionState {
     SubmitUpdateStatus(TransactionStatus::ABORTED);
   }
 
+  // Handles result of staged writes check in specified involved tablet.
+  // writes_time is max hybrid time of staged writes found in this tablet.
+  void StagedWritesChecked(const TabletId& tablet, const Status& status, HybridTime writes_time) {
+    VLOG_WITH_PREFIX(2) << "Staged writes checked in " << tablet << ": " << status;
+    if (status_ != TransactionStatus::STAGING || !resolving_) {
+      return;
+    }
+    if (status.IsNotFound()) {
+      // Some writes were not replicated before the staging deadline, so the client could not
+      // report this transaction as committed.
+      LOG_WITH_PREFIX(INFO) << "Aborting staging transaction: " << status;
+      resolving_ = false;
+      if (!ShouldBeCommitted() && !ShouldBeAborted()) {
+        SubmitUpdateStatus(TransactionStatus::ABORTED);
+      }
+      return;
+    }
+    if (!status.ok()) {
+      // Check will be retried during next poll.
+      resolving_ = false;
+      return;
+    }
+    checked_tablets_.insert(tablet);
+    staged_writes_time_.MakeAtLeast(writes_time);
+    if (checked_tablets_.size() == staged_tablets_.size()) {
+      resolving_ = false;
+      if (!ShouldBeCommitted() && !ShouldBeAborted()) {
+        LOG_WITH_PREFIX(INFO) << "Committing staging transaction, all writes found, writes time: "
+                              << staged_writes_time_;
+        SubmitUpdateStatus(TransactionStatus::COMMITTED, staged_writes_time_);
+      }
+    }
+  }
+
   // Returns logs prefix for this transaction.
   const std::string& LogPrefix() {
     return log_prefix_;
   }
 
-  void Poll(bool leader) {
-    if (status_ == TransactionStatus::COMMITTED) {
+  void Poll(bool leader, HybridTime now) {
+    if (status_ == TransactionStatus::STAGING) {
+      if (leader && !resolving_ && now > staging_deadline_ &&
+          !ShouldBeCommitted() && !ShouldBeAborted()) {
+        ResolveStaging();
+      }
+    } else if (status_ == TransactionStatus::COMMITTED) {
       if (unnotified_tablets_.empty()) {
         if (leader && !ShouldBeInStatus(TransactionStatus::APPLIED_IN_ALL_INVOLVED_TABLETS)) {
           SubmitUpdateStatus(TransactionStatus::APPLIED_IN_ALL_INVOLVED_TABLETS);
@@ -337,6 +430,19 @@ class TransactionState {
     return ShouldBeInStatus(TransactionStatus::ABORTED);
   }
 
+  // The client did not complete staging transaction in time, so check whether all its writes
+  // were replicated before the staging deadline.
+  void ResolveStaging() {
+    VLOG_WITH_PREFIX(1) << "Resolve staging, checked: " << checked_tablets_.size() << " of "
+                        << staged_tablets_.size();
+    resolving_ = true;
+    for (const auto& tablet : staged_tablets_) {
+      if (!checked_tablets_.count(tablet)) {
+        context_.CheckStagedWrites({tablet, id_, staging_deadline_});
+      }
+    }
+  }
+
   // Process operation that was replicated in RAFT.
   CHECKED_STATUS DoProcessReplicated(const TransactionCoordinator::ReplicatedData& data) {
     switch (data.state.status()) {
@@ -347,13 +453,16 @@ class TransactionState {
       case TransactionStatus::CREATED: FALLTHROUGH_INTENDED;
       case TransactionStatus::PENDING:
         return PendingReplicationFinished(data);
+      case TransactionStatus::STAGING:
+        return StagingReplicationFinished(data);
       case TransactionStatus::APPLYING:
         // APPLYING is handled separately, because it is received for transactions not managed by
         // this tablet as a transaction status tablet, but tablets that are involved in the data
         // path (receive write intents) for this transactions
         FATAL_INVALID_ENUM_VALUE(TransactionStatus, data.state.status());
-      case TransactionStatus::APPLIED_IN_ONE_OF_INVOLVED_TABLETS:
-        // APPLIED_IN_ONE_OF_INVOLVED_TABLETS handled w/o use of RAFT log
+      case TransactionStatus::APPLIED_IN_ONE_OF_INVOLVED_TABLETS: FALLTHROUGH_INTENDED;
+      case TransactionStatus::CHECK_STAGED_WRITES:
+        // APPLIED_IN_ONE_OF_INVOLVED_TABLETS and CHECK_STAGED_WRITES handled w/o use of RAFT log
         FATAL_INVALID_ENUM_VALUE(TransactionStatus, data.state.status());
       case TransactionStatus::APPLIED_IN_ALL_INVOLVED_TABLETS:
         return AppliedInAllInvolvedTabletsReplicationFinished(data);
@@ -366,8 +475,26 @@ class TransactionState {
 
     Status status;
     if (state.status() == TransactionStatus::COMMITTED) {
+      if (staging_time_.is_valid() && ShouldBeCommitted()) {
+        // Staging transaction was already committed, while resolving it.
+        request->completion_callback()->CompleteWithStatus(Status::OK());
+        return;
+      }
       status = HandleCommit();
+    } else if (state.status() == TransactionStatus::STAGING) {
+      status = HandleStaging(state);
+    } else if (state.status() == TransactionStatus::ABORTED) {
+      if (status_ != TransactionStatus::PENDING && status_ != TransactionStatus::STAGING) {
+        status = STATUS_FORMAT(IllegalState,
+            "Transaction in wrong state during abort: $0",
+            TransactionStatus_Name(status_));
+      }
     } else if (state.status() == TransactionStatus::PENDING) {
+      if (status_ == TransactionStatus::STAGING) {
+        // Heartbeat is not required for staging transaction.
+        request->completion_callback()->CompleteWithStatus(Status::OK());
+        return;
+      }
       if (status_ != TransactionStatus::PENDING) {
         status = STATUS_FORMAT(IllegalState,
             "Transaction in wrong state during heartbeat: $0",
@@ -390,6 +517,9 @@ class TransactionState {
   }
 
   CHECKED_STATUS HandleCommit() {
+    if (status_ == TransactionStatus::STAGING) {
+      return Status::OK();
+    }
     auto hybrid_time = context_.coordinator_context().clock().Now();
     if (ExpiredAt(hybrid_time)) {
       Abort();
@@ -404,12 +534,37 @@ class TransactionState {
     return Status::OK();
   }
 
-  void SubmitUpdateStatus(TransactionStatus status) {
+  CHECKED_STATUS HandleStaging(const tserver::TransactionStatePB& state) {
+    auto hybrid_time = context_.coordinator_context().clock().Now();
+    if (ExpiredAt(hybrid_time)) {
+      Abort();
+      return STATUS(Expired, "Staging of expired transaction");
+    }
+    if (status_ != TransactionStatus::PENDING || ShouldBeAborted()) {
+      return STATUS_FORMAT(IllegalState,
+                           "Transaction in wrong state when starting to stage: $0",
+                           TransactionStatus_Name(status_));
+    }
+    if (!state.has_staging_deadline() || state.tablets().empty()) {
+      return STATUS(InvalidArgument, "Staging without deadline or involved tablets");
+    }
+    return Status::OK();
+  }
+
+  // commit_time is used only for COMMITTED status of staging transaction.
+  void SubmitUpdateStatus(TransactionStatus status,
+                          HybridTime commit_time = HybridTime::kInvalid) {
     VLOG_WITH_PREFIX(4) << "SubmitUpdateStatus(" << TransactionStatus_Name(status) << ")";
 
     tserver::TransactionStatePB state;
     state.set_transaction_id(id_.begin(), id_.size());
     state.set_status(status);
+    if (commit_time.is_valid()) {
+      for (const auto& tablet : staged_tablets_) {
+        state.add_tablets(tablet);
+      }
+      state.set_commit_hybrid_time(commit_time.ToUint64());
+    }
 
     auto request = context_.coordinator_context().CreateUpdateTransactionState(&state);
     if (replicating_) {
@@ -434,7 +589,8 @@ class TransactionState {
 
   CHECKED_STATUS AbortedReplicationFinished(const TransactionCoordinator::ReplicatedData& data) {
     if (status_ != TransactionStatus::ABORTED &&
-        status_ != TransactionStatus::PENDING) {
+        status_ != TransactionStatus::PENDING &&
+        status_ != TransactionStatus::STAGING) {
       LOG_WITH_PREFIX(DFATAL) << "Invalid status of aborted transaction: "
                               << TransactionStatus_Name(status_);
     }
@@ -446,9 +602,19 @@ class TransactionState {
   }
 
   CHECKED_STATUS CommittedReplicationFinished(const TransactionCoordinator::ReplicatedData& data) {
-    CHECK_EQ(status_, TransactionStatus::PENDING);
+    CHECK(status_ == TransactionStatus::PENDING || status_ == TransactionStatus::STAGING)
+        << TransactionStatus_Name(status_);
     last_touch_ = data.hybrid_time;
-    commit_time_ = data.hybrid_time;
+    if (status_ == TransactionStatus::STAGING && data.state.has_commit_hybrid_time()) {
+      // The client could report commit before this record was written, so hybrid time of the
+      // record could be after the acknowledgement. Both the client and the check of staged writes
+      // send time that is not less than hybrid time of all staged writes, and not greater than
+      // the client clock at the acknowledgement. So reads that follow the acknowledgement see
+      // the writes, whichever of the two records is replicated first.
+      commit_time_ = std::max(HybridTime(data.state.commit_hybrid_time()), staging_time_);
+    } else {
+      commit_time_ = data.hybrid_time;
+    }
     VLOG_WITH_PREFIX(4) << "Commit time: " << commit_time_;
     status_ = TransactionStatus::COMMITTED;
     just_committed_ = true;
@@ -461,6 +627,22 @@ class TransactionState {
     return Status::OK();
   }
 
+  CHECKED_STATUS StagingReplicationFinished(const TransactionCoordinator::ReplicatedData& data) {
+    if (status_ != TransactionStatus::PENDING) {
+      LOG_WITH_PREFIX(DFATAL) << "Invalid status of staging transaction: "
+                              << TransactionStatus_Name(status_);
+    }
+    status_ = TransactionStatus::STAGING;
+    last_touch_ = data.hybrid_time;
+    staging_time_ = data.hybrid_time;
+    staging_deadline_ = HybridTime(data.state.staging_deadline());
+    staged_tablets_.assign(data.state.tablets().begin(), data.state.tablets().end());
+    VLOG_WITH_PREFIX(4) << "Staging time: " << staging_time_ << ", deadline: "
+                        << staging_deadline_;
+    first_entry_raft_index_ = data.op_id.index();
+    return Status::OK();
+  }
+
   CHECKED_STATUS AppliedInAllInvolvedTabletsReplicationFinished(
       const TransactionCoordinator::ReplicatedData& data) {
     CHECK_EQ(status_, TransactionStatus::COMMITTED);
@@ -510,6 +692,15 @@ class TransactionState {
   HybridTime commit_time_;
   std::unordered_set<TabletId> unnotified_tablets_;
   bool just_committed_ = false;
+  // Hybrid time of the staging record, and deadline for replication of staged writes.
+  HybridTime staging_time_;
+  HybridTime staging_deadline_;
+  // Tablets involved in staging transaction, and tablets where its writes were found.
+  std::vector<TabletId> staged_tablets_;
+  std::unordered_set<TabletId> checked_tablets_;
+  // Max hybrid time of staged writes found in checked tablets.
+  HybridTime staged_writes_time_;
+  bool resolving_ = false;
   int64_t first_entry_raft_index_ = std::numeric_limits<int64_t>::max();
 
   // The operation that we a currently replicating in RAFT.
@@ -526,12 +717,15 @@ struct PostponedLeaderActions {
   // List of tablets with transaction id, that should be notified that this transaction
   // is applying.
   std::vector<NotifyApplyingData> notify_applying;
+  // List of tablets with transaction id, where writes of staging transaction should be checked.
+  std::vector<CheckStagedWritesData> check_staged_writes;
   // List of update transaction records, that should be replicated via RAFT.
   std::vector<std::unique_ptr<UpdateTxnOperationState>> updates;
 
   void Swap(PostponedLeaderActions* other) {
     std::swap(leader, other->leader);
     notify_applying.swap(other->notify_applying);
+    check_staged_writes.swap(other->check_staged_writes);
     updates.swap(other->updates);
   }
 };
@@ -624,6 +818,10 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
   }
 
   CHECKED_STATUS ProcessReplicated(const ReplicatedData& data) {
+    if (!data.state.heartbeat_transaction_ids().empty()) {
+      return ProcessHeartbeatsReplicated(data);
+    }
+
     auto id = FullyDecodeTransactionId(data.state.transaction_id());
     if (!id.ok()) {
       return std::move(id.status());
@@ -662,6 +860,11 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
   }
 
   void ProcessAborted(const AbortedData& data) {
+    if (!data.state.heartbeat_transaction_ids().empty()) {
+      // Batched heartbeat does not lock transactions, so there is nothing to release.
+      return;
+    }
+
     auto id = FullyDecodeTransactionId(data.state.transaction_id());
     if (!id.ok()) {
       LOG_WITH_PREFIX(DFATAL) << "Abort of transaction with bad id "
@@ -746,6 +949,38 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     ExecutePostponedLeaderActions(&actions);
   }
 
+  void HandleHeartbeats(std::unique_ptr<tablet::UpdateTxnOperationState> request,
+                        tserver::UpdateTransactionResponsePB* response) {
+    auto& state = *request->request();
+    bool replicate = false;
+    PostponedLeaderActions actions;
+    {
+      std::lock_guard<std::mutex> lock(managed_mutex_);
+      postponed_leader_actions_.leader = true;
+      auto now = context_.clock().Now();
+      for (const auto& encoded_id : state.heartbeat_transaction_ids()) {
+        auto id = FullyDecodeTransactionId(encoded_id);
+        auto it = id.ok() ? managed_transactions_.find(*id) : managed_transactions_.end();
+        if (it == managed_transactions_.end() ||
+            !Modify(it).AcceptBatchedHeartbeat(now, &replicate)) {
+          response->add_expired_transaction_ids(encoded_id);
+        }
+      }
+      postponed_leader_actions_.Swap(&actions);
+    }
+
+    ExecutePostponedLeaderActions(&actions);
+
+    VLOG_WITH_PREFIX(2) << "Batched heartbeat of " << state.heartbeat_transaction_ids_size()
+                        << " transactions, expired: " << response->expired_transaction_ids_size();
+
+    if (!replicate) {
+      request->completion_callback()->CompleteWithStatus(Status::OK());
+      return;
+    }
+    context_.SubmitUpdateTransaction(std::move(request));
+  }
+
   int64_t PrepareGC() {
     std::lock_guard<std::mutex> lock(managed_mutex_);
     if (!managed_transactions_.empty()) {
@@ -824,11 +1059,84 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
       }
     }
 
+    if (!actions->check_staged_writes.empty()) {
+      auto deadline = TransactionRpcDeadline();
+      for (const auto& p : actions->check_staged_writes) {
+        tserver::UpdateTransactionRequestPB req;
+        req.set_tablet_id(p.tablet);
+        req.set_propagated_hybrid_time(context_.clock().Now().ToUint64());
+        auto& state = *req.mutable_state();
+        state.set_transaction_id(p.transaction.begin(), p.transaction.size());
+        state.set_status(TransactionStatus::CHECK_STAGED_WRITES);
+        state.add_tablets(context_.tablet_id());
+        state.set_staging_deadline(p.staging_deadline.ToUint64());
+
+        auto handle = rpcs_.Prepare();
+        if (handle != rpcs_.InvalidHandle()) {
+          auto id = p.transaction;
+          auto tablet = p.tablet;
+          *handle = client::CheckStagedWrites(
+              deadline,
+              nullptr /* remote_tablet */,
+              context_.client_future().get().get(),
+              &req,
+              [this, handle, id, tablet](
+                  const Status& status, const tserver::UpdateTransactionResponsePB& response) {
+                if (response.has_propagated_hybrid_time()) {
+                  context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
+                }
+                rpcs_.Unregister(handle);
+                StagedWritesChecked(
+                    id, tablet, status, HybridTime(response.staged_writes_hybrid_time()));
+              });
+          (**handle).SendRpc();
+        }
+      }
+    }
+
     for (auto& update : actions->updates) {
       context_.SubmitUpdateTransaction(std::move(update));
     }
   }
 
+  void StagedWritesChecked(const TransactionId& id, const TabletId& tablet, const Status& status,
+                           HybridTime writes_time) {
+    PostponedLeaderActions actions;
+    {
+      std::lock_guard<std::mutex> lock(managed_mutex_);
+      auto it = managed_transactions_.find(id);
+      if (it == managed_transactions_.end()) {
+        return;
+      }
+      postponed_leader_actions_.leader = true;
+      Modify(it).StagedWritesChecked(tablet, status, writes_time);
+      actions.Swap(&postponed_leader_actions_);
+    }
+    ExecutePostponedLeaderActions(&actions);
+  }
+
+  CHECKED_STATUS ProcessHeartbeatsReplicated(const ReplicatedData& data) {
+    PostponedLeaderActions actions;
+    {
+      std::lock_guard<std::mutex> lock(managed_mutex_);
+      postponed_leader_actions_.leader = data.mode == ProcessingMode::LEADER;
+      for (const auto& encoded_id : data.state.heartbeat_transaction_ids()) {
+        auto id = FullyDecodeTransactionId(encoded_id);
+        if (!id.ok()) {
+          return std::move(id.status());
+        }
+        auto it = GetTransaction(*id, TransactionStatus::PENDING, data.hybrid_time);
+        Modify(it).BatchedHeartbeatReplicated(data);
+      }
+      actions.Swap(&postponed_leader_actions_);
+    }
+    ExecutePostponedLeaderActions(&actions);
+
+    VLOG_WITH_PREFIX(1) << "Processed batched heartbeat: " << data.mode << ", "
+                        << data.state.heartbeat_transaction_ids_size() << " transactions";
+    return Status::OK();
+  }
+
   ManagedTransactions::iterator GetTransaction(const TransactionId& id,
                                                TransactionStatus status,
                                                HybridTime hybrid_time) {
@@ -850,6 +1158,10 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     postponed_leader_actions_.notify_applying.push_back(std::move(data));
   }
 
+  void CheckStagedWrites(CheckStagedWritesData data) override {
+    postponed_leader_actions_.check_staged_writes.push_back(std::move(data));
+  }
+
   MUST_USE_RESULT bool SubmitUpdateTransaction(
       std::unique_ptr<UpdateTxnOperationState> state) override {
     if (postponed_leader_actions_.leader) {
@@ -895,8 +1207,14 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
 
       auto& index = managed_transactions_.get<LastTouchTag>();
 
-      for (auto it = index.begin(); it != index.end() && it->ExpiredAt(now);) {
-        if (it->status() == TransactionStatus::ABORTED) {
+      for (auto it = index.begin(); it != index.end();) {
+        if (!it->ExpiredAt(now)) {
+          // Staging transactions do not expire, so they should not stop the scan.
+          if (it->status() != TransactionStatus::STAGING) {
+            break;
+          }
+          ++it;
+        } else if (it->status() == TransactionStatus::ABORTED) {
           it = index.erase(it);
         } else {
           bool modified = index.modify(it, [](TransactionState& state) {
@@ -907,7 +1225,7 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
         }
       }
       for (auto& transaction : managed_transactions_) {
-        const_cast<TransactionState&>(transaction).Poll(leader);
+        const_cast<TransactionState&>(transaction).Poll(leader, now);
       }
       postponed_leader_actions_.Swap(&actions);
 
@@ -974,6 +1292,12 @@ void TransactionCoordinator::Handle(std::unique_ptr<tablet::UpdateTxnOperationSt
   impl_->Handle(std::move(request));
 }
 
+void TransactionCoordinator::HandleHeartbeats(
+    std::unique_ptr<tablet::UpdateTxnOperationState> request,
+    tserver::UpdateTransactionResponsePB* response) {
+  impl_->HandleHeartbeats(std::move(request), response);
+}
+
 void TransactionCoordinator::ClearLocks(const Status& status) {
   impl_->ClearLocks(status);
 }
@@ -48,6 +48,7 @@ namespace tserver {
 class AbortTransactionResponsePB;
 class GetTransactionStatusResponsePB;
 class TransactionStatePB;
+class UpdateTransactionResponsePB;
 
 }
 
@@ -123,6 +124,11 @@ class TransactionCoordinator {
   // Handles new request for transaction update.
   void Handle(std::unique_ptr<tablet::UpdateTxnOperationState> request);
 
+  // Handles batched heartbeat of multiple transactions. Ids of transactions that are not alive
+  // anymore are added to the response.
+  void HandleHeartbeats(std::unique_ptr<tablet::UpdateTxnOperationState> request,
+                        tserver::UpdateTransactionResponsePB* response);
+
   // Prepares log garbage collection. Return min index that should be preserved.
   int64_t PrepareGC();
 
@@ -33,11 +33,16 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb.h"
+#include "yb/docdb/wait_queue.h"
 
 #include "yb/rpc/rpc.h"
 
+#include "yb/tablet/resolved_transaction_cache.h"
+#include "yb/tablet/transaction_status_batcher.h"
+
 #include "yb/tserver/tserver_service.pb.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 
@@ -47,6 +52,13 @@ using namespace std::placeholders;
 DEFINE_uint64(transaction_delay_status_reply_usec_in_tests, 0,
               "For tests only. Delay handling status reply by specified amount of usec.");
 
+DEFINE_int32(resolved_transaction_cache_capacity, 10000,
+             "Max number of other transactions, whose final status found by readers is cached "
+             "for all readers of the tablet. 0 to disable.");
+TAG_FLAG(resolved_transaction_cache_capacity, advanced);
+
+DECLARE_bool(enable_transaction_status_batching);
+
 namespace yb {
 namespace tablet {
 
@@ -135,10 +147,21 @@ class RunningTransactionContext {
     return ++request_serial_;
   }
 
+  // Status batcher is kept by the context, so statuses cached by it live while the participant
+  // is alive.
+  const std::shared_ptr<TransactionStatusBatcher>& StatusBatcherUnlocked(
+      client::YBClient* client) {
+    if (!status_batcher_) {
+      status_batcher_ = TransactionStatusBatcher::Get(client);
+    }
+    return status_batcher_;
+  }
+
  protected:
   friend class RunningTransaction;
 
   rpc::Rpcs rpcs_;
+  std::shared_ptr<TransactionStatusBatcher> status_batcher_;
   TransactionParticipantContext& participant_context_;
   int64_t request_serial_ = 0;
   std::mutex mutex_;
@@ -204,8 +227,10 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
       return;
     }
     auto request_id = context_.NextRequestIdUnlocked();
+    auto batcher = FLAGS_enable_transaction_status_batching
+        ? context_.StatusBatcherUnlocked(client) : nullptr;
     lock->unlock();
-    SendStatusRequest(client, request_id);
+    SendStatusRequest(client, batcher.get(), request_id);
   }
 
   void Abort(client::YBClient* client,
@@ -253,7 +278,24 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     }
   }
 
-  void SendStatusRequest(client::YBClient* client, int64_t serial_no) {
+  // Sends status request through batcher, when specified, or directly to the status tablet.
+  void SendStatusRequest(client::YBClient* client,
+                         TransactionStatusBatcher* batcher,
+                         int64_t serial_no) {
+    auto callback = std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, serial_no,
+                              shared_from_this());
+    if (batcher) {
+      context_.rpcs_.RegisterAndStart(
+          batcher->GetStatus(
+              TransactionRpcDeadline(),
+              metadata_.status_tablet,
+              metadata_.transaction_id,
+              context_.participant_context_.Now(),
+              std::move(callback)),
+          &get_status_handle_);
+      return;
+    }
+
     tserver::GetTransactionStatusRequestPB req;
     req.set_tablet_id(metadata_.status_tablet);
     req.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
@@ -264,8 +306,7 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
             nullptr /* tablet */,
             client,
             &req,
-            std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, serial_no,
-                      shared_from_this())),
+            std::move(callback)),
         &get_status_handle_);
   }
 
@@ -300,6 +341,7 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     TransactionStatus transaction_status;
     const bool ok = status.ok();
     int64_t new_request_id = -1;
+    std::shared_ptr<TransactionStatusBatcher> batcher;
     {
       std::unique_lock<std::mutex> lock(context_.mutex_);
       if (!ok) {
@@ -330,10 +372,13 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
           serial_no, time_of_status, transaction_status);
       if (!status_waiters_.empty()) {
         new_request_id = context_.NextRequestIdUnlocked();
+        if (FLAGS_enable_transaction_status_batching) {
+          batcher = context_.StatusBatcherUnlocked(client);
+        }
       }
     }
     if (new_request_id >= 0) {
-      SendStatusRequest(client, new_request_id);
+      SendStatusRequest(client, batcher.get(), new_request_id);
     }
     NotifyWaiters(serial_no, time_of_status, transaction_status, status_waiters);
   }
@@ -447,6 +492,10 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   explicit Impl(TransactionParticipantContext* context)
       : RunningTransactionContext(context), log_prefix_(context->tablet_id() + ": ") {
     LOG_WITH_PREFIX(INFO) << "Start";
+    if (FLAGS_resolved_transaction_cache_capacity > 0) {
+      resolved_cache_ = std::make_unique<ResolvedTransactionCache>(
+          FLAGS_resolved_transaction_cache_capacity);
+    }
   }
 
   ~Impl() {
@@ -480,6 +529,16 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     }
   }
 
+  boost::optional<TransactionStatusResult> ResolvedStatus(const TransactionId& id) {
+    return resolved_cache_ ? resolved_cache_->Lookup(id) : boost::none;
+  }
+
+  void SetResolvedStatus(const TransactionId& id, const TransactionStatusResult& result) {
+    if (resolved_cache_) {
+      resolved_cache_->Insert(id, result);
+    }
+  }
+
   HybridTime LocalCommitTime(const TransactionId& id) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = transactions_.find(id);
@@ -518,6 +577,42 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     (**it).UpdateLastWriteId(value);
   }
 
+  HybridTime MaxIntentHybridTimeUpTo(const TransactionId& id, HybridTime max_time) {
+    docdb::KeyBytes key;
+    AppendTransactionKeyPrefix(id, &key);
+    auto iter = docdb::CreateRocksDBIterator(db_,
+                                             docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
+                                             boost::none,
+                                             rocksdb::kDefaultQueryId);
+    HybridTime result;
+    // Reverse index records follow the metadata record.
+    for (iter->Seek(key.AsSlice()); iter->Valid() && iter->key().starts_with(key); iter->Next()) {
+      if (iter->key().size() == key.size()) {
+        // Metadata record.
+        continue;
+      }
+      auto reverse_value = docdb::DecodeReverseIndexValue(iter->value());
+      if (!reverse_value.ok()) {
+        LOG_WITH_PREFIX(DFATAL) << "Failed to decode reverse index value: "
+                                << reverse_value.status();
+        return HybridTime::kInvalid;
+      }
+      Slice intent_prefix;
+      docdb::IntentType intent_type;
+      DocHybridTime doc_ht;
+      auto status = docdb::DecodeIntentKey(
+          reverse_value->intent_key, &intent_prefix, &intent_type, &doc_ht);
+      if (!status.ok()) {
+        LOG_WITH_PREFIX(DFATAL) << "Failed to decode intent: " << status;
+        return HybridTime::kInvalid;
+      }
+      if (doc_ht.hybrid_time() <= max_time) {
+        result.MakeAtLeast(doc_ht.hybrid_time());
+      }
+    }
+    return result;
+  }
+
   void RequestStatusAt(const StatusRequest& request) {
     std::unique_lock<std::mutex> lock(mutex_);
     auto it = FindOrLoad(*request.id);
@@ -588,6 +683,9 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     }
 
     CHECK_OK(data.applier->ApplyIntents(data));
+    if (resolved_cache_) {
+      resolved_cache_->Erase(data.transaction_id);
+    }
 
     {
       std::lock_guard<std::mutex> lock(mutex_);
@@ -637,6 +735,10 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     return &participant_context_;
   }
 
+  docdb::WaitQueue* wait_queue() {
+    return &wait_queue_;
+  }
+
   size_t TEST_GetNumRunningTransactions() {
     std::lock_guard<std::mutex> lock(mutex_);
     return transactions_.size();
@@ -664,6 +766,13 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   }
 
   bool RemoveUnlocked(const Transactions::iterator& it) {
+    // Transaction is removed after it was applied or aborted, so transactions that wait for it
+    // could resolve their conflicts again.
+    wait_queue_.TransactionResolved((**it).id());
+    if (resolved_cache_) {
+      resolved_cache_->Erase((**it).id());
+    }
+
     if (running_requests_.empty()) {
       transactions_.erase(it);
       VLOG_WITH_PREFIX(2) << "Cleaned transaction: " << (**it).id()
@@ -727,13 +836,24 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     key.Truncate(key.size() - 1);
     IntraTxnWriteId next_write_id = 0;
     while (iter->Valid() && iter->key().starts_with(key)) {
+      auto reverse_value = docdb::DecodeReverseIndexValue(iter->value());
+      LOG_IF_WITH_PREFIX(DFATAL, !reverse_value.ok())
+          << "Failed to decode reverse index value: " << reverse_value.status();
+      if (!reverse_value.ok()) {
+        break;
+      }
       Slice intent_prefix;
       docdb::IntentType intent_type;
       DocHybridTime doc_ht;
-      auto status = docdb::DecodeIntentKey(iter->value(), &intent_prefix, &intent_type, &doc_ht);
+      auto status = docdb::DecodeIntentKey(
+          reverse_value->intent_key, &intent_prefix, &intent_type, &doc_ht);
       LOG_IF_WITH_PREFIX(DFATAL, !status.ok()) << "Failed to decode intent: " << status;
+      if (status.ok() && docdb::IsStrongIntent(intent_type) && reverse_value->has_body) {
+        next_write_id = reverse_value->write_id + 1;
+        break;
+      }
       if (status.ok() && docdb::IsStrongIntent(intent_type)) {
-        iter->Seek(iter->value());
+        iter->Seek(reverse_value->intent_key);
         if (iter->Valid()) {
           VLOG(1) << "Found latest record: " << docdb::SubDocKey::DebugSliceToString(iter->key())
                   << " => " << iter->value().ToDebugHexString();
@@ -779,6 +899,11 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   // Queue of transaction ids that should be cleaned, paired with request that should be completed
   // in order to be able to do clean.
   std::deque<CleanupQueueEntry> cleanup_queue_;
+
+  docdb::WaitQueue wait_queue_;
+
+  // Final statuses of transactions found by readers of this tablet, null when disabled.
+  std::unique_ptr<ResolvedTransactionCache> resolved_cache_;
 };
 
 TransactionParticipant::TransactionParticipant(TransactionParticipantContext* context)
@@ -811,6 +936,16 @@ HybridTime TransactionParticipant::LocalCommitTime(const TransactionId& id) {
   return impl_->LocalCommitTime(id);
 }
 
+boost::optional<TransactionStatusResult> TransactionParticipant::ResolvedStatus(
+    const TransactionId& id) {
+  return impl_->ResolvedStatus(id);
+}
+
+void TransactionParticipant::SetResolvedStatus(const TransactionId& id,
+                                               const TransactionStatusResult& result) {
+  impl_->SetResolvedStatus(id, result);
+}
+
 void TransactionParticipant::RequestStatusAt(const StatusRequest& request) {
   return impl_->RequestStatusAt(request);
 }
@@ -832,6 +967,11 @@ CHECKED_STATUS TransactionParticipant::ProcessApply(const TransactionApplyData&
   return impl_->ProcessApply(data);
 }
 
+HybridTime TransactionParticipant::MaxIntentHybridTimeUpTo(
+    const TransactionId& id, HybridTime max_time) {
+  return impl_->MaxIntentHybridTimeUpTo(id, max_time);
+}
+
 void TransactionParticipant::SetDB(rocksdb::DB* db) {
   impl_->SetDB(db);
 }
@@ -840,6 +980,10 @@ TransactionParticipantContext* TransactionParticipant::context() const {
   return impl_->participant_context();
 }
 
+docdb::WaitQueue* TransactionParticipant::wait_queue() const {
+  return impl_->wait_queue();
+}
+
 size_t TransactionParticipant::TEST_GetNumRunningTransactions() const {
   return impl_->TEST_GetNumRunningTransactions();
 }
@@ -47,6 +47,12 @@ namespace yb {
 class HybridTime;
 class TransactionMetadataPB;
 
+namespace docdb {
+
+class WaitQueue;
+
+}
+
 namespace tablet {
 
 class TransactionIntentApplier;
@@ -101,8 +107,17 @@ class TransactionParticipant : public TransactionStatusManager {
 
   void UpdateLastWriteId(const TransactionId& id, IntraTxnWriteId value);
 
+  // Returns max hybrid time of intents of specified transaction, written with hybrid time not
+  // greater than max_time, or invalid hybrid time when there are no such intents in this tablet.
+  // Caller should ensure that all writes before max_time are already applied.
+  HybridTime MaxIntentHybridTimeUpTo(const TransactionId& id, HybridTime max_time);
+
   HybridTime LocalCommitTime(const TransactionId& id) override;
 
+  boost::optional<TransactionStatusResult> ResolvedStatus(const TransactionId& id) override;
+
+  void SetResolvedStatus(const TransactionId& id, const TransactionStatusResult& result) override;
+
   void RequestStatusAt(const StatusRequest& request) override;
 
   void Abort(const TransactionId& id, TransactionStatusCallback callback) override;
@@ -113,6 +128,9 @@ class TransactionParticipant : public TransactionStatusManager {
 
   TransactionParticipantContext* context() const;
 
+  // Queue of transactions that wait for conflicting transactions of this tablet to be resolved.
+  docdb::WaitQueue* wait_queue() const;
+
   size_t TEST_GetNumRunningTransactions() const;
 
  private:
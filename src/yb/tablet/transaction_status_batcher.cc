@@ -0,0 +1,335 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/transaction_status_batcher.h"
+
+#include <algorithm>
+
+#include <boost/uuid/uuid_io.hpp>
+
+#include <gflags/gflags.h>
+
+#include "yb/rpc/rpc.h"
+
+#include "yb/tserver/tserver_service.pb.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+
+using namespace std::placeholders;
+
+DEFINE_bool(enable_transaction_status_batching, false,
+            "Combine status requests of transactions with the same status tablet, sent by all "
+            "tablets of this server, into a single GetTransactionStatus RPC. All servers of the "
+            "cluster should support multi-transaction status requests.");
+TAG_FLAG(enable_transaction_status_batching, advanced);
+
+DEFINE_int32(transaction_status_batch_size, 256,
+             "Max number of transactions in a single batched GetTransactionStatus RPC.");
+TAG_FLAG(transaction_status_batch_size, advanced);
+TAG_FLAG(transaction_status_batch_size, runtime);
+
+DEFINE_int32(transaction_status_cache_ttl_ms, 500,
+             "How long committed and aborted transaction statuses, received by batched status "
+             "requests, are reused for other requests. 0 to disable caching.");
+TAG_FLAG(transaction_status_cache_ttl_ms, advanced);
+TAG_FLAG(transaction_status_cache_ttl_ms, runtime);
+
+namespace yb {
+namespace tablet {
+
+class TransactionStatusBatcher::StatusCommand : public rpc::RpcCommand {
+ public:
+  StatusCommand(std::shared_ptr<TransactionStatusBatcher> batcher,
+                MonoTime deadline,
+                const TabletId& status_tablet,
+                const TransactionId& transaction_id,
+                HybridTime propagated_hybrid_time,
+                client::GetTransactionStatusCallback callback)
+      : batcher_(std::move(batcher)), deadline_(deadline), status_tablet_(status_tablet),
+        transaction_id_(transaction_id), propagated_hybrid_time_(propagated_hybrid_time),
+        callback_(std::move(callback)) {
+  }
+
+  void SendRpc() override {
+    batcher_->Enqueue(std::static_pointer_cast<StatusCommand>(shared_from_this()));
+  }
+
+  std::string ToString() const override {
+    return Format("TransactionStatus: $0, status tablet: $1", transaction_id_, status_tablet_);
+  }
+
+  void Finished(const Status& status) override {
+    Complete(status, tserver::GetTransactionStatusResponsePB());
+  }
+
+  void Abort() override {
+    batcher_->Abort(this);
+  }
+
+  MonoTime deadline() const override {
+    return deadline_;
+  }
+
+  void Complete(const Status& status, const tserver::GetTransactionStatusResponsePB& response) {
+    auto retain_self = shared_from_this();
+    callback_(status, response);
+  }
+
+  const TabletId& status_tablet() const {
+    return status_tablet_;
+  }
+
+  const TransactionId& transaction_id() const {
+    return transaction_id_;
+  }
+
+  HybridTime propagated_hybrid_time() const {
+    return propagated_hybrid_time_;
+  }
+
+  // Protected by mutex_ of the batcher.
+  bool aborted = false;
+
+ private:
+  const std::shared_ptr<TransactionStatusBatcher> batcher_;
+  const MonoTime deadline_;
+  const TabletId status_tablet_;
+  const TransactionId transaction_id_;
+  const HybridTime propagated_hybrid_time_;
+  client::GetTransactionStatusCallback callback_;
+};
+
+TransactionStatusBatcher::TransactionStatusBatcher(client::YBClient* client) : client_(client) {
+}
+
+TransactionStatusBatcher::~TransactionStatusBatcher() {
+  // Commands keep the batcher alive until they are completed.
+  DCHECK(queues_.empty());
+}
+
+std::shared_ptr<TransactionStatusBatcher> TransactionStatusBatcher::Get(
+    client::YBClient* client) {
+  static std::mutex mutex;
+  static std::unordered_map<client::YBClient*, std::weak_ptr<TransactionStatusBatcher>>*
+      batchers = new std::unordered_map<client::YBClient*, std::weak_ptr<TransactionStatusBatcher>>;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& weak_batcher = (*batchers)[client];
+  auto result = weak_batcher.lock();
+  if (!result) {
+    result = std::make_shared<TransactionStatusBatcher>(client);
+    weak_batcher = result;
+  }
+  return result;
+}
+
+rpc::RpcCommandPtr TransactionStatusBatcher::GetStatus(
+    MonoTime deadline,
+    const TabletId& status_tablet,
+    const TransactionId& transaction_id,
+    HybridTime propagated_hybrid_time,
+    client::GetTransactionStatusCallback callback) {
+  return std::make_shared<StatusCommand>(
+      shared_from_this(), deadline, status_tablet, transaction_id, propagated_hybrid_time,
+      std::move(callback));
+}
+
+void TransactionStatusBatcher::Enqueue(const StatusCommandPtr& command) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  CachedStatus cached;
+  if (LookupCacheUnlocked(command->transaction_id(), &cached)) {
+    lock.unlock();
+    tserver::GetTransactionStatusResponsePB response;
+    response.set_status(cached.status);
+    if (cached.status_hybrid_time.is_valid()) {
+      response.set_status_hybrid_time(cached.status_hybrid_time.ToUint64());
+    }
+    command->Complete(Status::OK(), response);
+    return;
+  }
+
+  queues_[command->status_tablet()].pending.push_back(command);
+  SendIfIdleAndUnlock(command->status_tablet(), &lock);
+}
+
+void TransactionStatusBatcher::Abort(StatusCommand* command) {
+  StatusCommandPtr aborted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queues_.find(command->status_tablet());
+    if (it == queues_.end()) {
+      return;
+    }
+    auto& queue = it->second;
+    auto pending_it = std::find_if(
+        queue.pending.begin(), queue.pending.end(),
+        [command](const StatusCommandPtr& entry) { return entry.get() == command; });
+    if (pending_it != queue.pending.end()) {
+      aborted = std::move(*pending_it);
+      queue.pending.erase(pending_it);
+      if (queue.pending.empty() && !queue.rpc) {
+        queues_.erase(it);
+      }
+    } else {
+      // The RPC that contains this command is shared with other commands, so it could not be
+      // aborted. The command is completed with Aborted status when the RPC finishes.
+      command->aborted = true;
+    }
+  }
+  if (aborted) {
+    aborted->Complete(STATUS(Aborted, "Transaction status request aborted"),
+                      tserver::GetTransactionStatusResponsePB());
+  }
+}
+
+void TransactionStatusBatcher::SendIfIdleAndUnlock(
+    const TabletId& tablet_id, std::unique_lock<std::mutex>* lock) {
+  auto it = queues_.find(tablet_id);
+  if (it == queues_.end()) {
+    lock->unlock();
+    return;
+  }
+  auto& queue = it->second;
+  if (queue.rpc) {
+    lock->unlock();
+    return;
+  }
+  if (queue.pending.empty()) {
+    queues_.erase(it);
+    lock->unlock();
+    return;
+  }
+
+  const size_t batch_size = std::min<size_t>(
+      queue.pending.size(), std::max(FLAGS_transaction_status_batch_size, 1));
+  queue.in_flight.assign(std::make_move_iterator(queue.pending.begin()),
+                         std::make_move_iterator(queue.pending.begin() + batch_size));
+  queue.pending.erase(queue.pending.begin(), queue.pending.begin() + batch_size);
+
+  tserver::GetTransactionStatusRequestPB req;
+  req.set_tablet_id(tablet_id);
+  req.mutable_transaction_ids()->Reserve(batch_size);
+  HybridTime propagated_hybrid_time = HybridTime::kMin;
+  MonoTime deadline = MonoTime::Min();
+  for (const auto& command : queue.in_flight) {
+    const auto& id = command->transaction_id();
+    req.add_transaction_ids(id.begin(), id.size());
+    propagated_hybrid_time = std::max(propagated_hybrid_time, command->propagated_hybrid_time());
+    deadline = std::max(deadline, command->deadline());
+  }
+  req.set_propagated_hybrid_time(propagated_hybrid_time.ToUint64());
+
+  queue.rpc = client::GetTransactionStatus(
+      deadline,
+      nullptr /* tablet */,
+      client_,
+      &req,
+      std::bind(&TransactionStatusBatcher::BatchReceived, shared_from_this(), tablet_id, _1, _2));
+  auto rpc = queue.rpc;
+  lock->unlock();
+  rpc->SendRpc();
+}
+
+void TransactionStatusBatcher::BatchReceived(
+    const TabletId& tablet_id,
+    const Status& status,
+    const tserver::GetTransactionStatusResponsePB& response) {
+  std::vector<StatusCommandPtr> commands;
+  rpc::RpcCommandPtr rpc;
+  std::unique_lock<std::mutex> lock(mutex_);
+  {
+    auto& queue = queues_[tablet_id];
+    commands.swap(queue.in_flight);
+    rpc = std::move(queue.rpc);
+  }
+
+  Status batch_status = status;
+  if (batch_status.ok() && static_cast<size_t>(response.statuses_size()) != commands.size()) {
+    batch_status = STATUS_FORMAT(
+        IllegalState, "Wrong number of transaction statuses from $0: $1, expected: $2",
+        tablet_id, response.statuses_size(), commands.size());
+  }
+
+  std::vector<bool> aborted;
+  aborted.reserve(commands.size());
+  for (size_t i = 0; i != commands.size(); ++i) {
+    aborted.push_back(commands[i]->aborted);
+    if (batch_status.ok()) {
+      const auto& entry = response.statuses(i);
+      if (entry.status() == TransactionStatus::COMMITTED ||
+          entry.status() == TransactionStatus::ABORTED) {
+        CacheStatusUnlocked(
+            commands[i]->transaction_id(),
+            CachedStatus{entry.status(), entry.has_status_hybrid_time()
+                ? HybridTime(entry.status_hybrid_time()) : HybridTime::kInvalid});
+      }
+    }
+  }
+
+  SendIfIdleAndUnlock(tablet_id, &lock);
+
+  for (size_t i = 0; i != commands.size(); ++i) {
+    tserver::GetTransactionStatusResponsePB command_response;
+    if (response.has_propagated_hybrid_time()) {
+      command_response.set_propagated_hybrid_time(response.propagated_hybrid_time());
+    }
+    if (aborted[i]) {
+      commands[i]->Complete(STATUS(Aborted, "Transaction status request aborted"),
+                            command_response);
+      continue;
+    }
+    if (!batch_status.ok()) {
+      if (response.has_error()) {
+        *command_response.mutable_error() = response.error();
+      }
+      commands[i]->Complete(batch_status, command_response);
+      continue;
+    }
+    const auto& entry = response.statuses(i);
+    command_response.set_status(entry.status());
+    if (entry.has_status_hybrid_time()) {
+      command_response.set_status_hybrid_time(entry.status_hybrid_time());
+    }
+    commands[i]->Complete(Status::OK(), command_response);
+  }
+}
+
+bool TransactionStatusBatcher::LookupCacheUnlocked(
+    const TransactionId& id, CachedStatus* result) {
+  const auto now = MonoTime::Now();
+  while (!cache_expiration_.empty() && cache_expiration_.front().first <= now) {
+    cache_.erase(cache_expiration_.front().second);
+    cache_expiration_.pop_front();
+  }
+  auto it = cache_.find(id);
+  if (it == cache_.end()) {
+    return false;
+  }
+  *result = it->second;
+  return true;
+}
+
+void TransactionStatusBatcher::CacheStatusUnlocked(
+    const TransactionId& id, const CachedStatus& status) {
+  const auto ttl_ms = FLAGS_transaction_status_cache_ttl_ms;
+  if (ttl_ms <= 0) {
+    return;
+  }
+  if (cache_.emplace(id, status).second) {
+    cache_expiration_.emplace_back(MonoTime::Now() + MonoDelta::FromMilliseconds(ttl_ms), id);
+  }
+}
+
+} // namespace tablet
+} // namespace yb
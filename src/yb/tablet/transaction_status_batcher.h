@@ -0,0 +1,103 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TRANSACTION_STATUS_BATCHER_H
+#define YB_TABLET_TRANSACTION_STATUS_BATCHER_H
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+#include "yb/client/transaction_rpc.h"
+
+#include "yb/common/entity_ids.h"
+#include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
+
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace tablet {
+
+// Combines status requests of transactions that have the same status tablet, sent by all
+// transaction participants of this server, into multi-transaction GetTransactionStatus RPCs.
+//
+// There is at most one RPC in flight per status tablet. Requests that arrive while it is in flight
+// are sent together when it completes. Final statuses, i.e. COMMITTED and ABORTED, are cached for
+// transaction_status_cache_ttl_ms, so participants of other tablets could reuse them.
+class TransactionStatusBatcher : public std::enable_shared_from_this<TransactionStatusBatcher> {
+ public:
+  explicit TransactionStatusBatcher(client::YBClient* client);
+  ~TransactionStatusBatcher();
+
+  // Returns batcher that is shared by all participants using the same client.
+  static std::shared_ptr<TransactionStatusBatcher> Get(client::YBClient* client);
+
+  // Returns command that requests status of the specified transaction when started.
+  // It should be started and aborted in the same way as client::GetTransactionStatus.
+  MUST_USE_RESULT rpc::RpcCommandPtr GetStatus(
+      MonoTime deadline,
+      const TabletId& status_tablet,
+      const TransactionId& transaction_id,
+      HybridTime propagated_hybrid_time,
+      client::GetTransactionStatusCallback callback);
+
+ private:
+  class StatusCommand;
+  typedef std::shared_ptr<StatusCommand> StatusCommandPtr;
+
+  struct TabletQueue {
+    std::vector<StatusCommandPtr> pending;
+    std::vector<StatusCommandPtr> in_flight;
+    rpc::RpcCommandPtr rpc;
+  };
+
+  struct CachedStatus {
+    TransactionStatus status;
+    HybridTime status_hybrid_time;
+  };
+
+  void Enqueue(const StatusCommandPtr& command);
+
+  void Abort(StatusCommand* command);
+
+  // Sends pending requests of the specified tablet, if it has no RPC in flight.
+  // Releases the lock in any case.
+  void SendIfIdleAndUnlock(const TabletId& tablet_id, std::unique_lock<std::mutex>* lock);
+
+  void BatchReceived(const TabletId& tablet_id,
+                     const Status& status,
+                     const tserver::GetTransactionStatusResponsePB& response);
+
+  bool LookupCacheUnlocked(const TransactionId& id, CachedStatus* result);
+
+  void CacheStatusUnlocked(const TransactionId& id, const CachedStatus& status);
+
+  client::YBClient* const client_;
+
+  std::mutex mutex_;
+  std::unordered_map<TabletId, TabletQueue> queues_;
+  std::unordered_map<TransactionId, CachedStatus, TransactionIdHash> cache_;
+  // Cached transactions in the order of their expiration.
+  std::deque<std::pair<MonoTime, TransactionId>> cache_expiration_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TRANSACTION_STATUS_BATCHER_H
@@ -67,7 +67,25 @@ class MockYsckTabletServer : public YsckTabletServer {
       const Schema& schema,
       const ChecksumOptions& options,
       const ReportResultCallback& callback) override {
-    callback.Run(Status::OK(), 0);
+    callback.Run(Status::OK(), divergent_hash_codes_.size());
+  }
+
+  Status TabletBucketChecksums(
+      const std::string& tablet_id,
+      uint16_t min_hash_code,
+      uint16_t max_hash_code,
+      uint32_t num_buckets,
+      const ChecksumOptions& options,
+      std::vector<uint64_t>* bucket_checksums) override {
+    bucket_requests_.emplace_back(min_hash_code, max_hash_code);
+    bucket_checksums->assign(num_buckets, 0);
+    const uint32_t range_size = max_hash_code - min_hash_code + 1;
+    for (auto hash_code : divergent_hash_codes_) {
+      if (hash_code >= min_hash_code && hash_code <= max_hash_code) {
+        ++(*bucket_checksums)[(hash_code - min_hash_code) * num_buckets / range_size];
+      }
+    }
+    return Status::OK();
   }
 
   Status CurrentHybridTime(uint64_t* hybrid_time) const override {
@@ -79,8 +97,11 @@ class MockYsckTabletServer : public YsckTabletServer {
     return address_;
   }
 
-  // Public because the unit tests mutate this variable directly.
+  // Public because the unit tests mutate these variables directly.
   Status connect_status_;
+  // Hash codes whose rows differ from other replicas.
+  vector<uint16_t> divergent_hash_codes_;
+  vector<std::pair<uint16_t, uint16_t>> bucket_requests_;
 
  private:
   const string address_;
@@ -150,7 +171,7 @@ class YsckTest : public YBTest {
     CreateAndAddTable({ tablet }, YBTableName("test"), 1);
   }
 
-  void CreateOneSmallReplicatedTable() {
+  void CreateOneSmallReplicatedTable(const Schema& schema = Schema()) {
     int num_replicas = 3;
     int num_tablets = 3;
     vector<shared_ptr<YsckTablet>> tablets;
@@ -161,7 +182,7 @@ class YsckTest : public YBTest {
       tablets.push_back(tablet);
     }
 
-    CreateAndAddTable(tablets, YBTableName("test"), num_replicas);
+    CreateAndAddTable(tablets, YBTableName("test"), num_replicas, schema);
   }
 
   void CreateOneOneTabletReplicatedBrokenTable() {
@@ -175,8 +196,9 @@ class YsckTest : public YBTest {
   }
 
   void CreateAndAddTable(vector<shared_ptr<YsckTablet>> tablets,
-                         const YBTableName& name, int num_replicas) {
-    shared_ptr<YsckTable> table(new YsckTable(name, Schema(), num_replicas,
+                         const YBTableName& name, int num_replicas,
+                         const Schema& schema = Schema()) {
+    shared_ptr<YsckTable> table(new YsckTable(name, schema, num_replicas,
         TableType::YQL_TABLE_TYPE));
     table->set_tablets(tablets);
 
@@ -273,5 +295,32 @@ TEST_F(YsckTest, TestOneOneTabletBrokenTable) {
   ASSERT_TRUE(ysck_->CheckTablesConsistency().IsCorruption());
 }
 
+TEST_F(YsckTest, TestLocateChecksumMismatch) {
+  constexpr uint16_t kDivergentHashCode = 12345;
+  CreateOneSmallReplicatedTable(
+      Schema({ ColumnSchema("h", INT32, false, true), ColumnSchema("v", INT32) }, 1));
+  auto divergent_ts = static_pointer_cast<MockYsckTabletServer>(
+      master_->tablet_servers_.begin()->second);
+  divergent_ts->divergent_hash_codes_.push_back(kDivergentHashCode);
+  ASSERT_OK(ysck_->CheckMasterRunning());
+  ASSERT_OK(ysck_->FetchTableAndTabletInfo());
+
+  ChecksumOptions options;
+  options.diff_fanout = 16;
+  options.diff_max_depth = 3;
+  ASSERT_TRUE(ysck_->ChecksumData({}, {}, options).IsCorruption());
+
+  // The divergent hash code is reported by all 3 tablets of the mock. Only one bucket differs at
+  // each level, so each level scans one range of every replica, and the last one is 16 * 16 times
+  // smaller than the whole hash space.
+  const auto& requests = divergent_ts->bucket_requests_;
+  ASSERT_EQ(3 * options.diff_max_depth, requests.size());
+  for (const auto& request : requests) {
+    ASSERT_LE(request.first, kDivergentHashCode);
+    ASSERT_GE(request.second, kDivergentHashCode);
+  }
+  ASSERT_EQ(256, requests.back().second - requests.back().first + 1);
+}
+
 } // namespace tools
 } // namespace yb
@@ -32,7 +32,9 @@
 
 #include "yb/tools/ysck.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <mutex>
 #include <unordered_set>
 #include <glog/logging.h>
@@ -59,14 +61,26 @@ DEFINE_int32(checksum_timeout_sec, 120,
              "before timing out.");
 DEFINE_int32(checksum_scan_concurrency, 4,
              "Number of concurrent checksum scans to execute per tablet server.");
+DEFINE_int32(checksum_scan_max_rows_per_sec, 0,
+             "Maximum number of rows per second read by each checksum scan, to limit the impact "
+             "on foreground traffic. 0 means unlimited.");
+DEFINE_int32(checksum_diff_fanout, 16,
+             "Number of hash code buckets a range is split into when locating checksum mismatches "
+             "between replicas.");
+DEFINE_int32(checksum_diff_max_depth, 3,
+             "Number of times mismatching hash code ranges are split when locating checksum "
+             "mismatches between replicas. 0 disables locating mismatches.");
 
 ChecksumOptions::ChecksumOptions()
-    : timeout(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec)),
-      scan_concurrency(FLAGS_checksum_scan_concurrency) {}
+    : ChecksumOptions(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec),
+                      FLAGS_checksum_scan_concurrency) {}
 
 ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency)
     : timeout(std::move(timeout)),
-      scan_concurrency(scan_concurrency) {}
+      scan_concurrency(scan_concurrency),
+      max_rows_per_sec(std::max(FLAGS_checksum_scan_max_rows_per_sec, 0)),
+      diff_fanout(std::max(FLAGS_checksum_diff_fanout, 2)),
+      diff_max_depth(FLAGS_checksum_diff_max_depth) {}
 
 YsckCluster::~YsckCluster() {
 }
@@ -379,7 +393,9 @@ Status Ysck::ChecksumData(const vector<string>& tables,
           LOG(INFO) << "-----------------------";
         }
         bool seen_first_replica = false;
+        bool mismatch = false;
         uint64_t first_checksum = 0;
+        std::vector<shared_ptr<YsckTabletServer>> ok_servers;
 
         for (const ChecksumResultReporter::ReplicaResultMap::value_type& r :
                       FindOrDie(checksums, tablet->id())) {
@@ -395,17 +411,24 @@ Status Ysck::ChecksumData(const vector<string>& tables,
                                     tablet->id(), ts->uuid(), ts->address(), status_str);
             if (!status.ok()) {
               num_errors++;
-            } else if (!seen_first_replica) {
+              continue;
+            }
+            ok_servers.push_back(ts);
+            if (!seen_first_replica) {
               seen_first_replica = true;
               first_checksum = checksum;
             } else if (checksum != first_checksum) {
               num_mismatches++;
+              mismatch = true;
               LOG(ERROR) << ">> Mismatch found in table " << table->name().ToString()
                          << " tablet " << tablet->id();
             }
           }
           num_results++;
         }
+        if (mismatch) {
+          LocateChecksumMismatches(*table, *tablet, ok_servers, options);
+        }
       }
     }
     if (printed_table_name) LOG(INFO) << "";
@@ -428,6 +451,78 @@ Status Ysck::ChecksumData(const vector<string>& tables,
   return Status::OK();
 }
 
+void Ysck::LocateChecksumMismatches(
+    const YsckTable& table,
+    const YsckTablet& tablet,
+    const std::vector<shared_ptr<YsckTabletServer>>& servers,
+    const ChecksumOptions& options) {
+  if (options.diff_max_depth <= 0 || table.schema().num_hash_key_columns() == 0) {
+    return;
+  }
+
+  struct HashRange {
+    uint32_t min_hash_code;
+    uint32_t max_hash_code;
+    int depth;
+  };
+  // Replicas are compared top-down, like Merkle trees whose nodes are checksums of hash code
+  // ranges, so only the ranges that differ are rescanned at each level.
+  std::vector<HashRange> ranges = {{0, std::numeric_limits<uint16_t>::max(), 0}};
+  std::vector<std::vector<uint64_t>> checksums(servers.size());
+  int num_divergent_ranges = 0;
+  while (!ranges.empty()) {
+    const HashRange range = ranges.back();
+    ranges.pop_back();
+    const uint32_t range_size = range.max_hash_code - range.min_hash_code + 1;
+    const uint32_t num_buckets = std::min<uint32_t>(options.diff_fanout, range_size);
+    for (size_t i = 0; i != servers.size(); ++i) {
+      checksums[i].clear();
+      Status status = servers[i]->TabletBucketChecksums(
+          tablet.id(), range.min_hash_code, range.max_hash_code, num_buckets, options,
+          &checksums[i]);
+      if (status.ok() && checksums[i].size() != num_buckets) {
+        status = STATUS_FORMAT(IllegalState, "Expected $0 bucket checksums, got $1",
+                               num_buckets, checksums[i].size());
+      }
+      if (!status.ok()) {
+        LOG(WARNING) << Substitute("Unable to locate mismatches in tablet $0 on $1: $2",
+                                   tablet.id(), servers[i]->address(), status.ToString());
+        return;
+      }
+    }
+
+    for (uint32_t bucket = 0; bucket != num_buckets; ++bucket) {
+      bool differs = false;
+      for (size_t i = 1; i != servers.size(); ++i) {
+        differs = differs || checksums[i][bucket] != checksums[0][bucket];
+      }
+      if (!differs) {
+        continue;
+      }
+      // Bucket of a hash code is (hash_code - min_hash_code) * num_buckets / range_size.
+      const uint32_t bucket_min = range.min_hash_code +
+          (static_cast<uint64_t>(bucket) * range_size + num_buckets - 1) / num_buckets;
+      const uint32_t bucket_max = range.min_hash_code +
+          (static_cast<uint64_t>(bucket + 1) * range_size + num_buckets - 1) / num_buckets - 1;
+      if (range.depth + 1 < options.diff_max_depth && bucket_min != bucket_max) {
+        ranges.push_back({bucket_min, bucket_max, range.depth + 1});
+        continue;
+      }
+      ++num_divergent_ranges;
+      std::vector<string> replica_checksums;
+      for (size_t i = 0; i != servers.size(); ++i) {
+        replica_checksums.push_back(
+            Substitute("$0: $1", servers[i]->uuid(), checksums[i][bucket]));
+      }
+      LOG(ERROR) << Substitute(">> Hash codes [$0, $1] differ in table $2 tablet $3: $4",
+                               bucket_min, bucket_max, table.name().ToString(), tablet.id(),
+                               JoinStrings(replica_checksums, ", "));
+    }
+  }
+  LOG(ERROR) << Substitute(">> Found $0 divergent hash code ranges in tablet $1",
+                           num_divergent_ranges, tablet.id());
+}
+
 bool Ysck::VerifyTable(const shared_ptr<YsckTable>& table) {
   bool good_table = true;
   vector<shared_ptr<YsckTablet> > tablets = table->tablets();
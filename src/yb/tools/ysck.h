@@ -63,6 +63,15 @@ struct ChecksumOptions {
 
   // The maximum number of concurrent checksum scans to run per tablet server.
   int scan_concurrency;
+
+  // The maximum number of rows per second each checksum scan reads, 0 means unlimited.
+  uint32_t max_rows_per_sec;
+
+  // When replicas of a tablet mismatch, hash code ranges are split into diff_fanout buckets, and
+  // only buckets whose checksums differ are split further, up to diff_max_depth levels.
+  // diff_max_depth of 0 disables locating mismatches.
+  int diff_fanout;
+  int diff_max_depth;
 };
 
 // Representation of a tablet replica on a tablet server.
@@ -182,6 +191,18 @@ class YsckTabletServer {
                   const ChecksumOptions& options,
                   const ReportResultCallback& callback) = 0;
 
+  // Splits [min_hash_code, max_hash_code] into num_buckets equal subranges, and fills
+  // bucket_checksums with the checksum of rows of the tablet in each of them.
+  virtual CHECKED_STATUS TabletBucketChecksums(
+      const std::string& tablet_id,
+      uint16_t min_hash_code,
+      uint16_t max_hash_code,
+      uint32_t num_buckets,
+      const ChecksumOptions& options,
+      std::vector<uint64_t>* bucket_checksums) {
+    return STATUS(NotSupported, "Bucket checksums are not supported");
+  }
+
   virtual const std::string& uuid() const {
     return uuid_;
   }
@@ -305,6 +326,14 @@ class Ysck {
   CHECKED_STATUS CheckAssignments();
 
  private:
+  // Compares checksums of hash code buckets of the specified replicas of the tablet, descending
+  // only into the buckets that differ, and logs the smallest differing ranges that were found.
+  void LocateChecksumMismatches(
+      const YsckTable& table,
+      const YsckTablet& tablet,
+      const std::vector<std::shared_ptr<YsckTabletServer>>& servers,
+      const ChecksumOptions& options);
+
   bool VerifyTable(const std::shared_ptr<YsckTable>& table);
   bool VerifyTableWithTimeout(const std::shared_ptr<YsckTable>& table,
                               const MonoDelta& timeout,
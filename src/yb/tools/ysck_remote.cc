@@ -150,6 +150,9 @@ class ChecksumStepper {
   void SendRequest() {
     req_.set_tablet_id(tablet_id_);
     req_.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    if (options_.max_rows_per_sec != 0) {
+      req_.set_max_rows_per_sec(options_.max_rows_per_sec);
+    }
     rpc_.set_timeout(GetDefaultTimeout());
     auto handler = std::make_unique<ChecksumCallbackHandler>(this);
     rpc::ResponseCallback cb = std::bind(&ChecksumCallbackHandler::Run, handler.get());
@@ -187,6 +190,33 @@ void RemoteYsckTabletServer::RunTabletChecksumScanAsync(
   ignore_result(stepper.release()); // Deletes self on callback.
 }
 
+Status RemoteYsckTabletServer::TabletBucketChecksums(
+    const string& tablet_id,
+    uint16_t min_hash_code,
+    uint16_t max_hash_code,
+    uint32_t num_buckets,
+    const ChecksumOptions& options,
+    vector<uint64_t>* bucket_checksums) {
+  tserver::ChecksumRequestPB req;
+  tserver::ChecksumResponsePB resp;
+  req.set_tablet_id(tablet_id);
+  req.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+  req.set_min_hash_code(min_hash_code);
+  req.set_max_hash_code(max_hash_code);
+  req.set_num_buckets(num_buckets);
+  if (options.max_rows_per_sec != 0) {
+    req.set_max_rows_per_sec(options.max_rows_per_sec);
+  }
+  RpcController rpc;
+  rpc.set_timeout(GetDefaultTimeout());
+  RETURN_NOT_OK(ts_proxy_->Checksum(req, &resp, &rpc));
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  bucket_checksums->assign(resp.bucket_checksums().begin(), resp.bucket_checksums().end());
+  return Status::OK();
+}
+
 Status RemoteYsckMaster::Connect() const {
   server::PingRequestPB req;
   server::PingResponsePB resp;
@@ -75,6 +75,13 @@ class RemoteYsckTabletServer : public YsckTabletServer {
       const ChecksumOptions& options,
       const ReportResultCallback& callback) override;
 
+  CHECKED_STATUS TabletBucketChecksums(
+      const std::string& tablet_id,
+      uint16_t min_hash_code,
+      uint16_t max_hash_code,
+      uint32_t num_buckets,
+      const ChecksumOptions& options,
+      std::vector<uint64_t>* bucket_checksums) override;
 
   const std::string& address() const override {
     return address_;
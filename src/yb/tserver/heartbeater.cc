@@ -33,6 +33,7 @@
 #include "yb/tserver/heartbeater.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
@@ -48,6 +49,8 @@
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_load_tracker.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -161,6 +164,10 @@ class Heartbeater::Thread {
   // True once at least one heartbeat has been sent.
   bool has_heartbeated_;
 
+  // True when the last acknowledged tablet report did not include all tablets, because of
+  // the tablet_report_limit flag.
+  bool has_remaining_tablets_to_report_ = false;
+
   // The number of heartbeats which have failed in a row.
   // This is tracked so as to back-off heartbeating.
   int consecutive_failed_heartbeats_;
@@ -183,6 +190,13 @@ class Heartbeater::Thread {
   uint64_t prev_reads_;
   uint64_t prev_writes_;
 
+  // Stores the total read and write ops of each tablet for computing per tablet iops.
+  struct TabletOps {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+  };
+  std::unordered_map<TabletId, TabletOps> prev_tablet_ops_;
+
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
@@ -328,7 +342,8 @@ int Heartbeater::Thread::GetMillisUntilNextHeartbeat() const {
   // If the master needs something from us, we should immediately
   // send another heartbeat with that info, rather than waiting for the interval.
   if (last_hb_response_.needs_reregister() ||
-      last_hb_response_.needs_full_tablet_report()) {
+      last_hb_response_.needs_full_tablet_report() ||
+      has_remaining_tablets_to_report_) {
     return GetMinimumHeartbeatMillis();
   }
 
@@ -349,6 +364,11 @@ Status Heartbeater::Thread::TryHeartbeat() {
     LOG(INFO) << "Sending a full tablet report to master...";
     server_->tablet_manager()->GenerateFullTabletReport(
       req.mutable_tablet_report());
+    if (req.tablet_report().remaining_tablet_count()) {
+      LOG(INFO) << "Full tablet report contains " << req.tablet_report().updated_tablets_size()
+                << " tablets, " << req.tablet_report().remaining_tablet_count()
+                << " tablets will be sent in following incremental reports";
+    }
   } else {
     VLOG(2) << "Sending an incremental tablet report to master...";
     server_->tablet_manager()->GenerateIncrementalTabletReport(
@@ -372,17 +392,47 @@ Status Heartbeater::Thread::TryHeartbeat() {
     }
 #endif
 
-    // Get the Total SST file sizes and set it in the proto buf
+    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
+    double_t div = diff.ToSeconds();
+
+    // Get the Total SST file sizes and set it in the proto buf, along with per tablet load.
     std::vector<shared_ptr<yb::tablet::TabletPeer> > tablet_peers;
     uint64_t total_file_sizes = 0;
     server_->tablet_manager()->GetTabletPeers(&tablet_peers);
+    std::unordered_map<TabletId, TabletOps> tablet_ops;
     for (auto it = tablet_peers.begin(); it != tablet_peers.end(); it++) {
       shared_ptr<yb::tablet::TabletPeer> tablet_peer = *it;
-      if (tablet_peer) {
-        shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
-        total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+      if (!tablet_peer) {
+        continue;
+      }
+      shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
+      if (!tablet_class) {
+        continue;
+      }
+      const uint64_t file_sizes = tablet_class->GetTotalSSTFileSizes();
+      total_file_sizes += file_sizes;
+
+      auto* tablet_load = req.mutable_metrics()->add_tablet_loads();
+      tablet_load->set_tablet_id(tablet_peer->tablet_id());
+      tablet_load->set_sst_file_size(file_sizes);
+      const auto load = tablet_class->load_tracker()->GetLoad();
+      tablet_load->set_conflicts_per_sec(load.ops(tablet::KeyAccessType::kConflict));
+      tablet_load->set_hottest_key_share(load.hottest_key_share);
+      auto* tablet_metrics = tablet_class->metrics();
+      if (tablet_metrics == nullptr) {
+        continue;
+      }
+      auto& ops = tablet_ops[tablet_peer->tablet_id()];
+      ops.reads = tablet_metrics->ql_read_latency->TotalCount() +
+                  tablet_metrics->redis_read_latency->TotalCount();
+      ops.writes = tablet_metrics->write_op_duration_client_propagated_consistency->TotalCount();
+      auto prev_it = prev_tablet_ops_.find(tablet_peer->tablet_id());
+      if (div > 0 && prev_it != prev_tablet_ops_.end()) {
+        tablet_load->set_read_ops_per_sec((ops.reads - prev_it->second.reads) / div);
+        tablet_load->set_write_ops_per_sec((ops.writes - prev_it->second.writes) / div);
       }
     }
+    prev_tablet_ops_ = std::move(tablet_ops);
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
 
     // Get the total number of read and write operations.
@@ -395,9 +445,6 @@ Status Heartbeater::Thread::TryHeartbeat() {
     uint64_t num_writes = (writes_hist != nullptr) ? writes_hist->TotalCount() : 0;
 
     // Calculate the read and write ops per second.
-    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
-    double_t div = diff.ToSeconds();
-
     double rops_per_sec = (div > 0 && num_reads > 0) ?
         (static_cast<double>(num_reads - prev_reads_) / div) : 0;
 
@@ -462,6 +509,7 @@ Status Heartbeater::Thread::TryHeartbeat() {
 
   // TODO: Handle TSHeartbeatResponsePB (e.g. deleted tablets and schema changes)
   server_->tablet_manager()->MarkTabletReportAcknowledged(req.tablet_report());
+  has_remaining_tablets_to_report_ = req.tablet_report().remaining_tablet_count() != 0;
 
   // Update the live tserver list.
   return server_->PopulateLiveTServers(resp);
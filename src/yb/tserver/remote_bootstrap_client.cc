@@ -32,6 +32,9 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <atomic>
+#include <unordered_set>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -45,6 +48,7 @@
 #include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rocksdb/rate_limiter.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet.h"
@@ -63,6 +67,7 @@
 #include "yb/util/logging.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/thread.h"
 
 using namespace yb::size_literals;
 
@@ -99,6 +104,16 @@ DEFINE_test_flag(double, fault_crash_bootstrap_client_before_changing_role, 0.0,
 DEFINE_int32(remote_bootstrap_max_chunk_size, 1_MB,
              "Maximum chunk size to be transferred at a time during remote bootstrap.");
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Max number of RocksDB files that a single remote bootstrap downloads concurrently.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+
+DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 0,
+             "Max number of bytes per second that all remote bootstraps of this server download "
+             "together. 0 means unlimited.");
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, advanced);
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, runtime);
+
 // RETURN_NOT_OK_PREPEND() with a remote-error unwinding step.
 #define RETURN_NOT_OK_UNWIND_PREPEND(status, controller, msg) \
   RETURN_NOT_OK_PREPEND(UnwindRemoteError(status, controller), msg)
@@ -126,6 +141,45 @@ using tablet::TabletSuperBlockPB;
 
 constexpr int kBytesReservedForMessageHeaders = 16384;
 
+namespace {
+
+// Returns rate limiter shared by all remote bootstrap clients of this process, or nullptr if
+// download rate is not limited.
+rocksdb::RateLimiter* RemoteBootstrapRateLimiter() {
+  static std::mutex mutex;
+  static std::unique_ptr<rocksdb::RateLimiter> rate_limiter;
+  static int64_t bytes_per_sec = 0;
+
+  const int64_t new_bytes_per_sec = FLAGS_remote_bootstrap_rate_limit_bytes_per_sec;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (new_bytes_per_sec <= 0) {
+    return nullptr;
+  }
+  if (!rate_limiter) {
+    rate_limiter.reset(rocksdb::NewGenericRateLimiter(new_bytes_per_sec));
+  } else if (new_bytes_per_sec != bytes_per_sec) {
+    rate_limiter->SetBytesPerSecond(new_bytes_per_sec);
+  }
+  bytes_per_sec = new_bytes_per_sec;
+  return rate_limiter.get();
+}
+
+// Blocks until the rate limiter allows to download the specified number of bytes.
+void RequestBandwidth(int64_t bytes) {
+  auto* rate_limiter = RemoteBootstrapRateLimiter();
+  if (!rate_limiter) {
+    return;
+  }
+  const int64_t burst = std::max<int64_t>(rate_limiter->GetSingleBurstBytes(), 1);
+  while (bytes > 0) {
+    const int64_t request = std::min(bytes, burst);
+    rate_limiter->Request(request, rocksdb::Env::IO_LOW);
+    bytes -= request;
+  }
+}
+
+} // namespace
+
 RemoteBootstrapClient::RemoteBootstrapClient(std::string tablet_id,
                                              FsManager* fs_manager,
                                              string client_permanent_uuid)
@@ -533,16 +587,23 @@ Status RemoteBootstrapClient::DownloadFile(
   RETURN_NOT_OK(fs_manager_->env()->CreateDirs(DirName(file_path)));
 
   if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+    std::string linked_file;
+    {
+      std::lock_guard<std::mutex> lock(inode2file_mutex_);
+      auto it = inode2file_.find(file_pb.inode());
+      if (it != inode2file_.end()) {
+        linked_file = it->second;
+      }
+    }
+    if (!linked_file.empty()) {
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = fs_manager_->env()->LinkFile(it->second, file_path);
+                          << " => " << linked_file;
+      auto link_status = fs_manager_->env()->LinkFile(linked_file, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << linked_file
                              << ": " << link_status;
     }
   }
@@ -559,12 +620,76 @@ Status RemoteBootstrapClient::DownloadFile(
   VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
   return Status::OK();
 }
 
+Status RemoteBootstrapClient::DownloadFilesInParallel(
+    const std::vector<const tablet::FilePB*>& files, const std::string& dir,
+    DataIdPB::IdType type) {
+  const size_t num_threads = std::min<size_t>(
+      std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1), files.size());
+  std::atomic<size_t> next_file(0);
+  std::mutex status_mutex;
+  Status result;
+
+  auto download = [this, &files, &dir, type, &next_file, &status_mutex, &result] {
+    DataIdPB data_id;
+    data_id.set_type(type);
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(status_mutex);
+        if (!result.ok()) {
+          return;
+        }
+      }
+      const size_t idx = next_file.fetch_add(1);
+      if (idx >= files.size()) {
+        return;
+      }
+      auto status = DownloadFile(*files[idx], dir, &data_id);
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(status_mutex);
+        if (result.ok()) {
+          result = status;
+        }
+        return;
+      }
+    }
+  };
+
+  if (num_threads <= 1) {
+    download();
+    return result;
+  }
+
+  std::vector<scoped_refptr<Thread>> threads;
+  Status start_status;
+  for (size_t i = 0; i != num_threads; ++i) {
+    scoped_refptr<Thread> thread;
+    start_status = Thread::Create("remote-bootstrap", Format("rb-download-$0", i), download,
+                                  &thread);
+    if (!start_status.ok()) {
+      break;
+    }
+    threads.push_back(std::move(thread));
+  }
+  // If some threads failed to start, the started ones still download all files.
+  if (threads.empty()) {
+    download();
+  }
+  for (auto& thread : threads) {
+    CHECK_OK(ThreadJoiner(thread.get()).Join());
+  }
+  if (!start_status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to start download thread: " << start_status;
+  }
+  return result;
+}
+
 Status RemoteBootstrapClient::CreateTabletDirectories(const string& db_dir, FsManager* fs) {
   // Create the directory table-uuid first.
   RETURN_NOT_OK_PREPEND(fs->CreateDirIfMissing(DirName(db_dir)),
@@ -586,10 +711,24 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
 
   RETURN_NOT_OK(CreateTabletDirectories(rocksdb_dir, meta_->fs_manager()));
 
+  // Files that share an inode with another file are hard linked to it after it is downloaded,
+  // so only one file per inode is downloaded concurrently.
+  std::vector<const tablet::FilePB*> files_to_download;
+  std::vector<const tablet::FilePB*> files_to_link;
+  std::unordered_set<uint64_t> inodes;
+  for (auto const& file_pb : new_sb->rocksdb_files()) {
+    if (file_pb.inode() != 0 && !inodes.insert(file_pb.inode()).second) {
+      files_to_link.push_back(&file_pb);
+    } else {
+      files_to_download.push_back(&file_pb);
+    }
+  }
+  RETURN_NOT_OK(DownloadFilesInParallel(files_to_download, rocksdb_dir, DataIdPB::ROCKSDB_FILE));
+
   DataIdPB data_id;
   data_id.set_type(DataIdPB::ROCKSDB_FILE);
-  for (auto const& file_pb : new_sb->rocksdb_files()) {
-    RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
+  for (const auto* file_pb : files_to_link) {
+    RETURN_NOT_OK(DownloadFile(*file_pb, rocksdb_dir, &data_id));
   }
 
   // To avoid adding new file type to remote bootstrap we move intents as subdir of regular DB.
@@ -697,6 +836,8 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
 
     // Write the data.
     RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
+    // Throttle the next request by the size of this one.
+    RequestBandwidth(resp.chunk().data().size());
 
     if (offset + resp.chunk().data().size() == resp.chunk().total_data_length()) {
       done = true;
@@ -34,6 +34,7 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -186,6 +187,12 @@ class RemoteBootstrapClient {
   CHECKED_STATUS DownloadFile(
       const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
 
+  // Downloads the specified files using up to remote_bootstrap_max_concurrent_file_downloads
+  // threads. Files should have distinct inodes.
+  CHECKED_STATUS DownloadFilesInParallel(
+      const std::vector<const tablet::FilePB*>& files, const std::string& dir,
+      DataIdPB::IdType type);
+
   // Return standard log prefix.
   std::string LogPrefix();
 
@@ -226,6 +233,7 @@ class RemoteBootstrapClient {
   bool succeeded_;
 
  private:
+  std::mutex inode2file_mutex_;
   std::unordered_map<uint64_t, std::string> inode2file_;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapClient);
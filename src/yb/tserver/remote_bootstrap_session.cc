@@ -43,11 +43,19 @@
 #include "yb/server/metadata.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 
 DECLARE_int32(rpc_max_message_size);
 
+DEFINE_bool(remote_bootstrap_bypass_page_cache, true,
+            "Drop pages that were read to serve remote bootstrap from the OS page cache, unless "
+            "they were already cached before, so serving bootstrap does not evict pages of the "
+            "regular workload.");
+TAG_FLAG(remote_bootstrap_bypass_page_cache, advanced);
+TAG_FLAG(remote_bootstrap_bypass_page_cache, runtime);
+
 namespace yb {
 namespace tserver {
 
@@ -111,6 +119,14 @@ Status RemoteBootstrapSession::ChangeRole() {
                                            tablet::TabletStatePB_Name(tablet_state), tablet_state));
   }
 
+  // When bootstrap was served by a follower, the leader changes the role of the new peer as soon as
+  // it catches up.
+  if (consensus->role() != RaftPeerPB::LEADER) {
+    LOG(INFO) << "Not changing role of " << requestor_uuid_ << " for tablet "
+              << tablet_peer_->tablet_id() << ", because this peer is not the leader";
+    return Status::OK();
+  }
+
   // If peer being bootstrapped is already a VOTER, don't send the ChangeConfig request. This could
   // happen when a tserver that is already a VOTER in the configuration tombstones its tablet, and
   // the leader starts bootstrapping it.
@@ -357,7 +373,8 @@ static Status ReadFileChunkToBuf(const Info* info,
   data->resize(response_data_size);
   uint8_t* buf = reinterpret_cast<uint8_t*>(const_cast<char*>(data->data()));
   Slice slice;
-  Status s = info->ReadFully(offset, response_data_size, &slice, buf);
+  Status s = info->ReadFully(offset, response_data_size, &slice, buf,
+                             FLAGS_remote_bootstrap_bypass_page_cache);
   if (PREDICT_FALSE(!s.ok())) {
     s = s.CloneAndPrepend(
         Substitute("Unable to read existing file for $0", data_name));
@@ -73,8 +73,9 @@ struct ImmutableRandomAccessFileInfo {
                                 int64_t size)
       : readable(std::move(readable)), size(size) {}
 
-  CHECKED_STATUS ReadFully(uint64_t offset, int64_t size, Slice* data, uint8_t* scratch) const {
-    return env_util::ReadFully(readable.get(), offset, size, data, scratch);
+  CHECKED_STATUS ReadFully(uint64_t offset, int64_t size, Slice* data, uint8_t* scratch,
+                           bool uncached) const {
+    return env_util::ReadFully(readable.get(), offset, size, data, scratch, uncached);
   }
 };
 
@@ -90,7 +91,8 @@ struct ImmutableReadableBlockInfo {
     size(size) {
   }
 
-  CHECKED_STATUS ReadFully(uint64_t offset, int64_t size, Slice* data, uint8_t* scratch) const {
+  CHECKED_STATUS ReadFully(uint64_t offset, int64_t size, Slice* data, uint8_t* scratch,
+                           bool uncached) const {
     return readable->Read(offset, size, data, scratch);
   }
 };
@@ -21,6 +21,7 @@
 #include "yb/rpc/rpc_context.h"
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/logging.h"
 
 namespace yb {
@@ -35,32 +36,49 @@ void SetupErrorAndRespond(TabletServerErrorPB* error,
 
 // Template helpers.
 
-template<class ReqClass, class RespClass>
-bool CheckUuidMatchOrRespond(TabletPeerLookupIf* tablet_manager,
-                             const char* method_name,
-                             const ReqClass* req,
-                             RespClass* resp,
-                             rpc::RpcContext* context) {
+// Checks that the request is addressed to this server. On mismatch returns the error and sets
+// error_code, so the caller decides how the error is reported.
+template<class ReqClass>
+CHECKED_STATUS CheckUuidMatch(TabletPeerLookupIf* tablet_manager,
+                              const char* method_name,
+                              const ReqClass* req,
+                              const std::string& requestor_string,
+                              TabletServerErrorPB::Code* error_code) {
   const string& local_uuid = tablet_manager->NodeInstance().permanent_uuid();
   if (PREDICT_FALSE(!req->has_dest_uuid())) {
     // Maintain compat in release mode, but complain.
     string msg = strings::Substitute("$0: Missing destination UUID in request from $1: $2",
-        method_name, context->requestor_string(), req->ShortDebugString());
+        method_name, requestor_string, req->ShortDebugString());
 #ifdef NDEBUG
     YB_LOG_EVERY_N(ERROR, 100) << msg;
 #else
     LOG(FATAL) << msg;
 #endif
-    return true;
+    return Status::OK();
   }
   if (PREDICT_FALSE(req->dest_uuid() != local_uuid)) {
     const Status s = STATUS_SUBSTITUTE(InvalidArgument,
         "$0: Wrong destination UUID requested. Local UUID: $1. Requested UUID: $2",
         method_name, local_uuid, req->dest_uuid());
-    LOG(WARNING) << s.ToString() << ": from " << context->requestor_string()
+    LOG(WARNING) << s.ToString() << ": from " << requestor_string
                  << ": " << req->ShortDebugString();
-    SetupErrorAndRespond(resp->mutable_error(), s,
-                         TabletServerErrorPB::WRONG_SERVER_UUID, context);
+    *error_code = TabletServerErrorPB::WRONG_SERVER_UUID;
+    return s;
+  }
+  return Status::OK();
+}
+
+template<class ReqClass, class RespClass>
+bool CheckUuidMatchOrRespond(TabletPeerLookupIf* tablet_manager,
+                             const char* method_name,
+                             const ReqClass* req,
+                             RespClass* resp,
+                             rpc::RpcContext* context) {
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  Status s = CheckUuidMatch(
+      tablet_manager, method_name, req, context->requestor_string(), &error_code);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
     return false;
   }
   return true;
@@ -92,23 +110,16 @@ StdStatusCallback BindHandleResponse(RespType* resp,
 }
 
 // Lookup the given tablet, ensuring that it both exists and is RUNNING.
-// If it is not, respond to the RPC associated with 'context' after setting
-// resp->mutable_error() to indicate the failure reason.
-//
-// Returns true if successful.
-template<class RespClass>
-bool LookupTabletPeerOrRespond(TabletPeerLookupIf* tablet_manager,
-                               const string& tablet_id,
-                               RespClass* resp,
-                               rpc::RpcContext* context,
-                               std::shared_ptr<tablet::TabletPeer>* peer) {
+// If it is not, returns the failure reason and sets error_code.
+inline CHECKED_STATUS LookupTabletPeer(TabletPeerLookupIf* tablet_manager,
+                                       const string& tablet_id,
+                                       std::shared_ptr<tablet::TabletPeer>* peer,
+                                       TabletServerErrorPB::Code* error_code) {
   Status status = tablet_manager->GetTabletPeer(tablet_id, peer);
   if (PREDICT_FALSE(!status.ok())) {
-    TabletServerErrorPB::Code code = status.IsServiceUnavailable() ?
-                                     TabletServerErrorPB::UNKNOWN_ERROR :
-                                     TabletServerErrorPB::TABLET_NOT_FOUND;
-    SetupErrorAndRespond(resp->mutable_error(), status, code, context);
-    return false;
+    *error_code = status.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                                : TabletServerErrorPB::TABLET_NOT_FOUND;
+    return status;
   }
 
   // Check RUNNING state.
@@ -119,8 +130,28 @@ bool LookupTabletPeerOrRespond(TabletPeerLookupIf* tablet_manager,
     if (state == tablet::FAILED) {
       s = s.CloneAndAppend((*peer)->error().ToString());
     }
-    SetupErrorAndRespond(resp->mutable_error(), s,
-                         TabletServerErrorPB::TABLET_NOT_RUNNING, context);
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return s;
+  }
+  SetProfilerTabletId(tablet_id);
+  return Status::OK();
+}
+
+// Lookup the given tablet, ensuring that it both exists and is RUNNING.
+// If it is not, respond to the RPC associated with 'context' after setting
+// resp->mutable_error() to indicate the failure reason.
+//
+// Returns true if successful.
+template<class RespClass>
+bool LookupTabletPeerOrRespond(TabletPeerLookupIf* tablet_manager,
+                               const string& tablet_id,
+                               RespClass* resp,
+                               rpc::RpcContext* context,
+                               std::shared_ptr<tablet::TabletPeer>* peer) {
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  Status s = LookupTabletPeer(tablet_manager, tablet_id, peer, &error_code);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
     return false;
   }
   return true;
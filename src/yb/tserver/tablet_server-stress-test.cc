@@ -31,7 +31,11 @@
 //
 #include "yb/tserver/tablet_server-test-base.h"
 
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
+#include "yb/tablet/tablet_peer.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/stopwatch.h"
 
@@ -132,5 +136,38 @@ TEST_F(TSStressTest, TestMTInserts) {
   LOG(INFO) << out.str();
 }
 
+// Inserts rows one by one through the full write path of the tablet server and reports the time
+// spent in each stage, so a regression of the per operation cost of a stage is easy to spot.
+TEST_F(TSStressTest, WriteStageBreakdown) {
+  const int num_rows = FLAGS_num_inserts_per_thread;
+  for (int i = 0; i != num_rows; ++i) {
+    MonoTime before = MonoTime::Now();
+    InsertTestRowsRemote(0 /* tid */, i, 1);
+    histogram_->Increment(MonoTime::Now().GetDeltaSince(before).ToMicroseconds());
+  }
+
+  auto* metrics = tablet_peer_->tablet()->metrics();
+  const std::pair<const char*, Histogram*> stages[] = {
+    { "doc operations", metrics->write_doc_operations_latency.get() },
+    { "prepare", metrics->write_prepare_latency.get() },
+    { "start", metrics->write_start_latency.get() },
+    { "replicate", metrics->write_replicate_latency.get() },
+    { "apply", metrics->write_apply_latency.get() },
+    { "commit", metrics->write_commit_latency.get() },
+    { "tablet total", metrics->write_op_duration_client_propagated_consistency.get() },
+    { "client total", histogram_.get() },
+  };
+  std::string table = StringPrintf(
+      "\n%-15s %10s %10s %10s %10s %10s\n", "stage (us)", "count", "mean", "p50", "p99", "max");
+  for (const auto& stage : stages) {
+    StringAppendF(&table, "%-15s %10" PRIu64 " %10.1f %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+                  stage.first, stage.second->TotalCount(), stage.second->MeanValueForTests(),
+                  stage.second->ValueAtPercentile(50), stage.second->ValueAtPercentile(99),
+                  stage.second->MaxValueForTests());
+    ASSERT_EQ(static_cast<uint64_t>(num_rows), stage.second->TotalCount()) << stage.first;
+  }
+  LOG(INFO) << "Write path breakdown for " << num_rows << " single row writes:" << table;
+}
+
 } // namespace tserver
 } // namespace yb
@@ -33,12 +33,14 @@
 #include "yb/tserver/tablet_service.h"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <boost/scope_exit.hpp>
 
+#include "yb/common/ql_columnar.h"
 #include "yb/common/schema.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/consensus/consensus.h"
@@ -52,6 +54,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/escaping.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tserver/remote_bootstrap_service.h"
@@ -60,6 +63,7 @@
 #include "yb/tablet/metadata.pb.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_metrics.h"
+#include "yb/tablet/transaction_participant.h"
 
 #include "yb/tablet/operations/alter_schema_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
@@ -69,6 +73,8 @@
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/util/atomic.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/faststring.h"
@@ -85,24 +91,13 @@
 
 using namespace std::literals;  // NOLINT
 
-DEFINE_int32(scanner_default_batch_size_bytes, 64 * 1024,
-             "The default size for batches of scan results");
-TAG_FLAG(scanner_default_batch_size_bytes, advanced);
-TAG_FLAG(scanner_default_batch_size_bytes, runtime);
-
-DEFINE_int32(scanner_max_batch_size_bytes, 8 * 1024 * 1024,
-             "The maximum batch size that a client may request for "
-             "scan results.");
-TAG_FLAG(scanner_max_batch_size_bytes, advanced);
-TAG_FLAG(scanner_max_batch_size_bytes, runtime);
-
 DEFINE_int32(scanner_batch_size_rows, 100,
              "The number of rows to batch for servicing scan requests.");
 TAG_FLAG(scanner_batch_size_rows, advanced);
 TAG_FLAG(scanner_batch_size_rows, runtime);
 
 DEFINE_bool(parallelize_read_ops, true,
-            "Controls weather multiple (Redis) read ops that are present in a operation "
+            "Controls weather multiple (Redis and QL) read ops that are present in a operation "
             "should be executed in parallel.");
 TAG_FLAG(parallelize_read_ops, advanced);
 TAG_FLAG(parallelize_read_ops, runtime);
@@ -118,6 +113,19 @@ DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_int32(check_staged_writes_max_safe_time_wait_ms, 100,
+             "Max time in milliseconds that check of staged writes waits for the safe time to pass "
+             "the staging deadline. The status tablet retries the check during its next poll.");
+TAG_FLAG(check_staged_writes_max_safe_time_wait_ms, advanced);
+TAG_FLAG(check_staged_writes_max_safe_time_wait_ms, runtime);
+
+DEFINE_bool(enable_external_write_batches, false,
+            "Accept write requests with write batches replicated from another universe. Such "
+            "batches are applied w/o locks and conflict checks, so it should be enabled only on "
+            "tablet servers that are written to only by the replication.");
+TAG_FLAG(enable_external_write_batches, advanced);
+TAG_FLAG(enable_external_write_batches, runtime);
+
 DEFINE_test_flag(bool, tserver_noop_read_write, false, "Respond NOOP to read/write.");
 
 DEFINE_int32(max_stale_read_bound_time_ms, 0, "If we are allowed to read from followers, "
@@ -140,6 +148,19 @@ DEFINE_test_flag(bool, simulate_time_out_failures, false, "If true, we will rand
                  "as failed to simulate time out failures. The periodic refresh of the lookup "
                  "cache will eventually mark them as available");
 
+DEFINE_int32(read_perf_context_sampling_rate, 0,
+             "When positive, RocksDB work done by one of this many reads is added to the RPC "
+             "trace: block cache hits and misses, block reads, bloom filter checks, SST files "
+             "read, iterator seeks and nexts, and skipped keys.");
+TAG_FLAG(read_perf_context_sampling_rate, runtime);
+TAG_FLAG(read_perf_context_sampling_rate, advanced);
+
+DEFINE_int32(read_perf_context_slow_read_threshold_ms, 0,
+             "When positive, RocksDB work done by reads that take longer than this is added to "
+             "the RPC trace, like for reads sampled by read_perf_context_sampling_rate.");
+TAG_FLAG(read_perf_context_slow_read_threshold_ms, runtime);
+TAG_FLAG(read_perf_context_slow_read_threshold_ms, advanced);
+
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -200,6 +221,23 @@ bool GetConsensusOrRespond(const TabletPeerPtr& tablet_peer,
   return true;
 }
 
+// Adds the leader known by tablet_peer to the error, when it rejects request because it is not
+// the leader.
+void SetLeaderHint(const TabletPeer& tablet_peer, TabletServerErrorPB::Code code,
+                   TabletServerErrorPB* error) {
+  if (code != TabletServerErrorPB::NOT_THE_LEADER) {
+    return;
+  }
+  auto consensus = tablet_peer.shared_consensus();
+  if (!consensus) {
+    return;
+  }
+  auto state = consensus->ConsensusState(CONSENSUS_CONFIG_COMMITTED);
+  if (state.has_leader_uuid() && state.leader_uuid() != tablet_peer.permanent_uuid()) {
+    error->set_leader_uuid(state.leader_uuid());
+  }
+}
+
 Status GetTabletRef(const TabletPeerPtr& tablet_peer,
                     shared_ptr<Tablet>* tablet,
                     TabletServerErrorPB::Code* error_code) {
@@ -211,6 +249,108 @@ Status GetTabletRef(const TabletPeerPtr& tablet_peer,
   return Status::OK();
 }
 
+// Responds with success when writes of staging transaction, that were replicated before its
+// staging deadline, are present in the tablet, and sets max hybrid time of those writes.
+// Responds with NotFound when they are missing.
+void CheckStagedWrites(const tserver::TransactionStatePB& state,
+                       tablet::Tablet* tablet,
+                       const server::ClockPtr& clock,
+                       UpdateTransactionResponsePB* resp,
+                       rpc::RpcContext* context) {
+  auto id = FullyDecodeTransactionId(state.transaction_id());
+  if (!id.ok()) {
+    SetupErrorAndRespond(
+        resp->mutable_error(), id.status(), TabletServerErrorPB::UNKNOWN_ERROR, context);
+    return;
+  }
+  auto* participant = tablet->transaction_participant();
+  if (!participant) {
+    SetupErrorAndRespond(
+        resp->mutable_error(), STATUS(IllegalState, "Tablet is not transactional"),
+        TabletServerErrorPB::UNKNOWN_ERROR, context);
+    return;
+  }
+  HybridTime staging_deadline(state.staging_deadline());
+  // Writes with hybrid time before safe time are already applied, and no more writes could be
+  // added before it. The wait is bounded, so the RPC worker is not blocked for the whole RPC
+  // timeout, and the check is retried by the status tablet.
+  auto deadline = std::min(
+      context->GetClientDeadline(),
+      MonoTime::Now() + MonoDelta::FromMilliseconds(
+          GetAtomicFlag(&FLAGS_check_staged_writes_max_safe_time_wait_ms)));
+  auto safe_time = tablet->SafeTime(tablet::RequireLease::kTrue, staging_deadline, deadline);
+  if (!safe_time.is_valid()) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS_FORMAT(TryAgain, "Safe time did not reach $0", staging_deadline),
+        TabletServerErrorPB::UNKNOWN_ERROR, context);
+    return;
+  }
+  resp->set_propagated_hybrid_time(clock->Now().ToUint64());
+  auto writes_time = participant->MaxIntentHybridTimeUpTo(*id, staging_deadline);
+  if (!writes_time.is_valid()) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS_FORMAT(NotFound, "No writes of $0 before $1", *id, staging_deadline),
+        TabletServerErrorPB::UNKNOWN_ERROR, context);
+    return;
+  }
+  resp->set_staged_writes_hybrid_time(writes_time.ToUint64());
+  context->RespondSuccess();
+}
+
+void AppendRespHeader(char prefix, size_t size, faststring* out) {
+  char buffer[kFastToBufferSize];
+  out->push_back(prefix);
+  out->append(FastUInt64ToBufferLeft(size, buffer));
+  out->append("\r\n", 2);
+}
+
+// Encodes array of bulk strings in RESP and attaches it as a sidecar. So the Redis proxy could
+// send it to its client as is, instead of parsing and encoding each element.
+CHECKED_STATUS EncodeRedisArrayResponse(rpc::RpcContext* context, RedisResponsePB* response) {
+  if (response->code() != RedisResponsePB::OK || !response->has_array_response() ||
+      response->array_response().encoded()) {
+    return Status::OK();
+  }
+  const auto& elements = response->array_response().elements();
+  // Each element has header with at most 20 digits length and two line ends.
+  constexpr size_t kMaxElementOverhead = 25;
+  size_t size = kMaxElementOverhead;
+  for (const auto& element : elements) {
+    size += element.size() + kMaxElementOverhead;
+  }
+  faststring encoded;
+  encoded.reserve(size);
+  AppendRespHeader('*', elements.size(), &encoded);
+  for (const auto& element : elements) {
+    AppendRespHeader('$', element.size(), &encoded);
+    encoded.append(element);
+    encoded.append("\r\n", 2);
+  }
+  int sidecar_idx = 0;
+  RETURN_NOT_OK(context->AddRpcSidecar(&encoded, &sidecar_idx));
+  response->clear_array_response();
+  response->set_encoded_response_sidecar(sidecar_idx);
+  return Status::OK();
+}
+
+// Converts rows data of the read result to the format requested by the client.
+Status ConvertRowsDataFormat(const QLReadRequestPB& ql_read_req,
+                             tablet::QLReadRequestResult* result) {
+  if (ql_read_req.rows_data_format() != QL_ROWS_DATA_COLUMNAR || result->rows_data.empty()) {
+    return Status::OK();
+  }
+  std::vector<std::shared_ptr<QLType>> column_types;
+  for (const auto& rscol_desc : ql_read_req.rsrow_desc().rscol_descs()) {
+    column_types.push_back(QLType::FromQLTypePB(rscol_desc.ql_type()));
+  }
+  faststring columnar_rows_data;
+  RETURN_NOT_OK(CQLRowsDataToColumnar(column_types, result->rows_data, &columnar_rows_data));
+  result->rows_data.assign_copy(columnar_rows_data.data(), columnar_rows_data.size());
+  return Status::OK();
+}
+
 } // namespace
 
 // Prepares modification operation, checks limits, fetches tablet_peer and tablet etc.
@@ -306,7 +446,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
         rowblock->Serialize(ql_write_req.client(), &rows_data);
         int rows_data_sidecar_idx = 0;
         RETURN_UNKNOWN_ERROR_IF_NOT_OK(
-            context_->AddRpcSidecar(RefCntBuffer(rows_data), &rows_data_sidecar_idx),
+            context_->AddRpcSidecar(&rows_data, &rows_data_sidecar_idx),
             response_,
             context_.get());
         ql_write_resp->set_rows_data_sidecar(rows_data_sidecar_idx);
@@ -463,15 +603,25 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
   TabletServerErrorPB::Code error_code;
   auto status = CheckPeerIsLeader(*tablet_peer, &error_code);
   if (!status.ok()) {
+    SetLeaderHint(*tablet_peer, error_code, resp->mutable_error());
     SetupErrorAndRespond(resp->mutable_error(), status, error_code, &context);
     return;
   }
 
+  if (req->state().status() == TransactionStatus::CHECK_STAGED_WRITES) {
+    CheckStagedWrites(req->state(), tablet.get(), server_->Clock(), resp, &context);
+    return;
+  }
+
   auto state = std::make_unique<tablet::UpdateTxnOperationState>(tablet_peer->tablet(),
                                                                  &req->state());
   state->set_completion_callback(MakeRpcOperationCompletionCallback(
       std::move(context), resp, server_->Clock()));
 
+  if (!req->state().heartbeat_transaction_ids().empty()) {
+    tablet_peer->tablet()->transaction_coordinator()->HandleHeartbeats(std::move(state), resp);
+    return;
+  }
   tablet_peer->tablet()->transaction_coordinator()->Handle(std::move(state));
 }
 
@@ -491,8 +641,25 @@ void TabletServiceImpl::GetTransactionStatus(const GetTransactionStatusRequestPB
     return;
   }
 
-  auto status = tablet_peer->tablet()->transaction_coordinator()->GetStatus(
-      req->transaction_id(), resp);
+  auto* coordinator = tablet_peer->tablet()->transaction_coordinator();
+  Status status;
+  if (req->transaction_ids().empty()) {
+    status = coordinator->GetStatus(req->transaction_id(), resp);
+  } else {
+    resp->mutable_statuses()->Reserve(req->transaction_ids_size());
+    for (const auto& transaction_id : req->transaction_ids()) {
+      GetTransactionStatusResponsePB single_response;
+      status = coordinator->GetStatus(transaction_id, &single_response);
+      if (!status.ok()) {
+        break;
+      }
+      auto* out = resp->add_statuses();
+      out->set_status(single_response.status());
+      if (single_response.has_status_hybrid_time()) {
+        out->set_status_hybrid_time(single_response.status_hybrid_time());
+      }
+    }
+  }
   resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
   if (status.ok()) {
     context.RespondSuccess();
@@ -601,8 +768,11 @@ void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
             << partition_schema.PartitionDebugString(partition, schema);
   VLOG(1) << "Full request: " << req->DebugString();
 
+  const bool start_election =
+      req->initial_leader_uuid() == server_->instance_pb().permanent_uuid();
   s = server_->tablet_manager()->CreateNewTablet(req->table_id(), req->tablet_id(), partition,
-      req->table_name(), req->table_type(), schema, partition_schema, req->config(), nullptr);
+      req->table_name(), req->table_type(), schema, partition_schema, req->config(), nullptr,
+      start_election);
   if (PREDICT_FALSE(!s.ok())) {
     TabletServerErrorPB::Code code;
     if (s.IsAlreadyPresent()) {
@@ -729,11 +899,24 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
+  // Followers would reject the write during replication anyway, so reject it early and tell the
+  // client who the leader is.
+  {
+    TabletServerErrorPB::Code error_code;
+    auto status = CheckPeerIsLeader(*tablet_peer, &error_code);
+    if (PREDICT_FALSE(!status.ok()) && error_code == TabletServerErrorPB::NOT_THE_LEADER) {
+      SetLeaderHint(*tablet_peer, error_code, resp->mutable_error());
+      SetupErrorAndRespond(resp->mutable_error(), status, error_code, &context);
+      return;
+    }
+  }
+
   if (req->has_write_batch() && req->write_batch().has_transaction()) {
     VLOG(1) << "Write with transaction: " << req->write_batch().transaction().ShortDebugString();
   }
 
-  if (PREDICT_FALSE(req->has_write_batch() && !req->write_batch().kv_pairs().empty())) {
+  if (PREDICT_FALSE(req->has_write_batch() && !req->write_batch().kv_pairs().empty() &&
+                    !req->external_write_batch())) {
     Status s = STATUS(NotSupported, "Write Request contains write batch. This field should be "
         "used only for post-processed write requests during "
         "Raft replication.");
@@ -743,9 +926,28 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
+  if (req->external_write_batch()) {
+    Status s;
+    if (!GetAtomicFlag(&FLAGS_enable_external_write_batches)) {
+      s = STATUS(NotSupported, "External write batches are disabled");
+    } else if (req->write_batch().has_transaction()) {
+      s = STATUS(NotSupported, "Transactional external write batches are not supported");
+    } else if (req->ql_write_batch_size() != 0 || req->redis_write_batch_size() != 0 ||
+               req->pgsql_write_batch_size() != 0) {
+      s = STATUS(InvalidArgument, "External write batch could not be combined with operations");
+    }
+    if (!s.ok()) {
+      SetupErrorAndRespond(resp->mutable_error(), s,
+                           TabletServerErrorPB::INVALID_MUTATION,
+                           &context);
+      return;
+    }
+  }
+
   bool has_operations = (req->ql_write_batch_size() != 0 ||
                          req->redis_write_batch_size() != 0 ||
-                         req->pgsql_write_batch_size());
+                         req->pgsql_write_batch_size() ||
+                         (req->external_write_batch() && req->write_batch().kv_pairs_size() != 0));
   if (!has_operations && tablet->table_type() != TableType::REDIS_TABLE_TYPE) {
     // An empty request. This is fine, can just exit early with ok status instead of working hard.
     // This doesn't need to go to Raft log.
@@ -755,6 +957,13 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
+  // Report the budget before this write is added, it would be released by the time the client
+  // sends the next write.
+  const int64_t write_budget = tablet_peer->operation_tracker()->AvailableMemory();
+  if (write_budget >= 0) {
+    resp->set_write_budget_bytes(write_budget);
+  }
+
   auto operation_state = std::make_unique<WriteOperationState>(tablet_peer->tablet(), req, resp);
 
   auto context_ptr = std::make_shared<RpcContext>(std::move(context));
@@ -854,6 +1063,7 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
 
     s = CheckPeerIsLeader(*tablet_peer.get(), &error_code);
     if (PREDICT_FALSE(!s.ok())) {
+      SetLeaderHint(*tablet_peer, error_code, resp->mutable_error());
       SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
       return false;
     }
@@ -922,6 +1132,13 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
                "tablet_id", req->tablet_id());
   DVLOG(3) << "Received Read RPC: " << req->DebugString();
 
+  const auto sampling_rate = FLAGS_read_perf_context_sampling_rate;
+  const auto slow_read_threshold_ms = FLAGS_read_perf_context_slow_read_threshold_ms;
+  const bool perf_sampled = sampling_rate > 0 && RandomWithChance(sampling_rate);
+  const bool collect_perf = perf_sampled || slow_read_threshold_ms > 0;
+  const auto start_time = collect_perf ? MonoTime::Now() : MonoTime();
+  RocksDBReadPerfCounters perf_counters;
+
   shared_ptr<tablet::AbstractTablet> tablet;
   if (!GetTabletOrRespond(req, resp, &context, &tablet)) {
     if (req->consistency_level() == YBConsistencyLevel::STRONG) {
@@ -954,6 +1171,20 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   bool transactional = tablet->SchemaRef().table_properties().is_transactional();
   if (!read_time) {
     safe_ht_to_read = tablet->SafeTime(require_lease);
+    // Followers learn safe time from leader heartbeats, that are sent even when the tablet is idle.
+    // So a replica that keeps up with the leader could serve such read without waiting.
+    if (req->max_staleness_ms() != 0 && !require_lease) {
+      // Safe time could be ahead of the local clock because of clock skew.
+      const int64_t staleness_us = server_->Clock()->Now().PhysicalDiff(safe_ht_to_read);
+      if (staleness_us > static_cast<int64_t>(req->max_staleness_ms()) * 1000) {
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(IllegalState, "Stale follower: data is $0 ms behind, max allowed $1 ms",
+                          staleness_us / 1000, req->max_staleness_ms()),
+            TabletServerErrorPB::STALE_FOLLOWER, &context);
+        return;
+      }
+    }
     // If the read time is not specified, then it is non transactional read.
     // So we should restart it in server in case of failure.
     read_time.read = safe_ht_to_read;
@@ -993,7 +1224,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     context.ResetRpcSidecars();
     VLOG(1) << "Read time: " << read_time << ", safe: " << safe_ht_to_read;
     auto result = DoRead(tablet.get(), req, read_time, safe_ht_to_read, require_lease,
-                         &host_port_pb, resp, &context);
+                         &host_port_pb, resp, &context, collect_perf ? &perf_counters : nullptr);
     if (!result.ok()) {
       SetupErrorAndRespond(
           resp->mutable_error(), result.status(), TabletServerErrorPB::UNKNOWN_ERROR, &context);
@@ -1021,6 +1252,11 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       return;
     }
   }
+  if (collect_perf &&
+      (perf_sampled ||
+       MonoTime::Now() - start_time >= MonoDelta::FromMilliseconds(slow_read_threshold_ms))) {
+    TRACE("RocksDB read perf: $0", perf_counters.ToString());
+  }
   if (req->include_trace() && Trace::CurrentTrace() != nullptr) {
     resp->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
   }
@@ -1036,9 +1272,15 @@ void HandleRedisReadRequestAsync(
     const ReadHybridTime& read_time,
     const RedisReadRequestPB& redis_read_request,
     RedisResponsePB* response,
+    RocksDBReadPerfCounters* perf_counters,
     const std::function<void(const Status& s)>& status_cb
 ) {
-  status_cb(tablet->HandleRedisReadRequest(deadline, read_time, redis_read_request, response));
+  Status status;
+  {
+    ScopedRocksDBReadPerfContext perf_scope(perf_counters);
+    status = tablet->HandleRedisReadRequest(deadline, read_time, redis_read_request, response);
+  }
+  status_cb(status);
 }
 
 Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
@@ -1048,12 +1290,15 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
                                                  tablet::RequireLease require_lease,
                                                  HostPortPB* host_port_pb,
                                                  ReadResponsePB* resp,
-                                                 rpc::RpcContext* context) {
+                                                 rpc::RpcContext* context,
+                                                 RocksDBReadPerfCounters* perf_counters) {
   tablet::ScopedReadOperation read_tx(tablet, require_lease, read_time);
   switch (tablet->table_type()) {
     case TableType::REDIS_TABLE_TYPE: {
       size_t count = req->redis_batch_size();
       std::vector<Status> rets(count);
+      // Requests could be executed by different threads, so each one has its own counters.
+      std::vector<RocksDBReadPerfCounters> batch_perf_counters(perf_counters ? count : 0);
       CountDownLatch latch(count);
       for (int idx = 0; idx < count; idx++) {
         const RedisReadRequestPB& redis_read_req = req->redis_batch(idx);
@@ -1070,6 +1315,7 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
             read_tx.read_time(),
             redis_read_req,
             Unretained(resp->add_redis_batch()),
+            Unretained(perf_counters ? &batch_perf_counters[idx] : nullptr),
             cb);
 
         Status s;
@@ -1083,6 +1329,9 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
         }
       }
       latch.Wait();
+      for (const auto& counters : batch_perf_counters) {
+        perf_counters->Add(counters);
+      }
       std::vector<Status> failed;
       for (auto& status : rets) {
         if (!status.ok()) {
@@ -1090,6 +1339,11 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
         }
       }
       if (failed.size() == 0) {
+        for (size_t idx = 0; idx != count; ++idx) {
+          if (req->redis_batch(idx).encoded_response_allowed()) {
+            RETURN_NOT_OK(EncodeRedisArrayResponse(context, resp->mutable_redis_batch(idx)));
+          }
+        }
         // TODO(dtxn) implement read restart for Redis.
         return ReadHybridTime();
       } else if (failed.size() == 1) {
@@ -1100,36 +1354,82 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
     }
     case TableType::YQL_TABLE_TYPE: {
       ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(req);
-      for (QLReadRequestPB& ql_read_req : *mutable_req->mutable_ql_batch()) {
-        // Update the remote endpoint.
+      auto* ql_batch = mutable_req->mutable_ql_batch();
+      const size_t count = ql_batch->size();
+      // Update the remote endpoint.
+      for (QLReadRequestPB& ql_read_req : *ql_batch) {
         ql_read_req.set_allocated_remote_endpoint(host_port_pb);
-        BOOST_SCOPE_EXIT(&ql_read_req) {
+      }
+      BOOST_SCOPE_EXIT(ql_batch) {
+        for (QLReadRequestPB& ql_read_req : *ql_batch) {
           ql_read_req.release_remote_endpoint();
-        } BOOST_SCOPE_EXIT_END;
+        }
+      } BOOST_SCOPE_EXIT_END;
+
+      // Requests of the batch are independent point or range reads at the same read time, so
+      // they are executed in parallel on the read pool, except the last one that is executed in
+      // this thread.
+      std::vector<tablet::QLReadRequestResult> results(count);
+      std::vector<Status> statuses(count);
+      std::vector<RocksDBReadPerfCounters> batch_perf_counters(perf_counters ? count : 0);
+      CountDownLatch latch(count);
+      TRACE("Start HandleQLReadRequest");
+      for (size_t idx = 0; idx != count; ++idx) {
+        auto func = [tablet, context, &read_tx, req, ql_batch, &results, &statuses,
+                     &batch_perf_counters, &latch, idx] {
+          {
+            ScopedRocksDBReadPerfContext perf_scope(
+                batch_perf_counters.empty() ? nullptr : &batch_perf_counters[idx]);
+            statuses[idx] = tablet->HandleQLReadRequest(
+                context->GetClientDeadline(), read_tx.read_time(), ql_batch->Get(idx),
+                req->transaction(), &results[idx]);
+            if (statuses[idx].ok()) {
+              statuses[idx] = ConvertRowsDataFormat(ql_batch->Get(idx), &results[idx]);
+            }
+          }
+          latch.CountDown();
+        };
 
-        tablet::QLReadRequestResult result;
-        TRACE("Start HandleQLReadRequest");
-        RETURN_NOT_OK(tablet->HandleQLReadRequest(
-            context->GetClientDeadline(), read_tx.read_time(), ql_read_req, req->transaction(),
-            &result));
-        TRACE("Done HandleQLReadRequest");
-        if (result.restart_read_ht.is_valid()) {
-          DCHECK_GT(result.restart_read_ht, read_time.read);
-          VLOG(1) << "Restart read required at: " << result.restart_read_ht
-                  << ", original: " << read_time;
-          read_time.read = result.restart_read_ht;
-          read_time.local_limit = safe_ht_to_read;
-          return read_time;
+        Status s;
+        bool run_async = FLAGS_parallelize_read_ops && (idx != count - 1);
+        if (run_async) {
+          s = server_->tablet_manager()->read_pool()->SubmitFunc(func);
         }
+
+        if (!s.ok() || !run_async) {
+          func();
+        }
+      }
+      latch.Wait();
+      TRACE("Done HandleQLReadRequest");
+      for (const auto& counters : batch_perf_counters) {
+        perf_counters->Add(counters);
+      }
+
+      HybridTime restart_read_ht;
+      for (size_t idx = 0; idx != count; ++idx) {
+        RETURN_NOT_OK(statuses[idx]);
+        restart_read_ht.MakeAtLeast(results[idx].restart_read_ht);
+      }
+      if (restart_read_ht.is_valid()) {
+        DCHECK_GT(restart_read_ht, read_time.read);
+        VLOG(1) << "Restart read required at: " << restart_read_ht
+                << ", original: " << read_time;
+        read_time.read = restart_read_ht;
+        read_time.local_limit = safe_ht_to_read;
+        return read_time;
+      }
+
+      for (auto& result : results) {
         int rows_data_sidecar_idx = 0;
-        RETURN_NOT_OK(context->AddRpcSidecar(
-            RefCntBuffer(result.rows_data), &rows_data_sidecar_idx));
+        RETURN_NOT_OK(context->AddRpcSidecar(&result.rows_data, &rows_data_sidecar_idx));
         result.response.set_rows_data_sidecar(rows_data_sidecar_idx);
         resp->add_ql_batch()->Swap(&result.response);
       }
       return ReadHybridTime();
     }
     case TableType::PGSQL_TABLE_TYPE: {
+      ScopedRocksDBReadPerfContext perf_scope(perf_counters);
       ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(req);
       for (PgsqlReadRequestPB& pgsql_read_req : *mutable_req->mutable_pgsql_batch()) {
         tablet::PgsqlReadRequestResult result;
@@ -1145,8 +1445,7 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
           return read_time;
         }
         int rows_data_sidecar_idx = 0;
-        RETURN_NOT_OK(context->AddRpcSidecar(
-            RefCntBuffer(result.rows_data), &rows_data_sidecar_idx));
+        RETURN_NOT_OK(context->AddRpcSidecar(&result.rows_data, &rows_data_sidecar_idx));
         result.response.set_rows_data_sidecar(rows_data_sidecar_idx);
         resp->add_pgsql_batch()->Swap(&result.response);
       }
@@ -1165,40 +1464,87 @@ ConsensusServiceImpl::ConsensusServiceImpl(const scoped_refptr<MetricEntity>& me
 ConsensusServiceImpl::~ConsensusServiceImpl() {
 }
 
+namespace {
+
+// Checks that the update is addressed to a running tablet of this server, and applies it to the
+// consensus of that tablet. Used for both standalone and batched updates, so they detect and
+// classify errors the same way.
+Status DoUpdateConsensus(TabletPeerLookupIf* tablet_manager,
+                         const std::string& requestor_string,
+                         ConsensusRequestPB* req,
+                         ConsensusResponsePB* resp,
+                         TabletServerErrorPB::Code* error_code) {
+  RETURN_NOT_OK(CheckUuidMatch(
+      tablet_manager, "UpdateConsensus", req, requestor_string, error_code));
+
+  TabletPeerPtr tablet_peer;
+  RETURN_NOT_OK(LookupTabletPeer(tablet_manager, req->tablet_id(), &tablet_peer, error_code));
+
+  // Submit the update directly to the TabletPeer's Consensus instance.
+  shared_ptr<Consensus> consensus = tablet_peer->shared_consensus();
+  if (PREDICT_FALSE(!consensus)) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running");
+  }
+
+  *error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  return consensus->Update(req, resp);
+}
+
+// Applies update request that is part of a batch. Errors are reported in the response of this
+// request, so they don't affect other requests of the batch.
+void UpdateConsensusInBatch(TabletPeerLookupIf* tablet_manager,
+                            const std::string& requestor_string,
+                            ConsensusRequestPB* req,
+                            ConsensusResponsePB* resp) {
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  Status s = DoUpdateConsensus(tablet_manager, requestor_string, req, resp, &error_code);
+  if (PREDICT_FALSE(!s.ok())) {
+    resp->Clear();
+    StatusToPB(s, resp->mutable_error()->mutable_status());
+    resp->mutable_error()->set_code(error_code);
+  }
+}
+
+} // namespace
+
 void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
                                            ConsensusResponsePB* resp,
                                            rpc::RpcContext context) {
   DVLOG(3) << "Received Consensus Update RPC: " << req->ShortDebugString();
-  if (!CheckUuidMatchOrRespond(tablet_manager_, "UpdateConsensus", req, resp, &context)) {
-    return;
-  }
-  TabletPeerPtr tablet_peer;
-  if (!LookupTabletPeerOrRespond(tablet_manager_, req->tablet_id(), resp, &context, &tablet_peer)) {
-    return;
-  }
-
-  // Submit the update directly to the TabletPeer's Consensus instance.
-  shared_ptr<Consensus> consensus;
-  if (!GetConsensusOrRespond(tablet_peer, resp, &context, &consensus)) return;
 
   // Unfortunately, we have to use const_cast here, because the protobuf-generated interface only
   // gives us a const request, but we need to be able to move messages out of the request for
   // efficiency.
-  Status s = consensus->Update(const_cast<ConsensusRequestPB*>(req), resp);
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  Status s = DoUpdateConsensus(tablet_manager_, context.requestor_string(),
+                               const_cast<ConsensusRequestPB*>(req), resp, &error_code);
   if (PREDICT_FALSE(!s.ok())) {
     // Clear the response first, since a partially-filled response could
     // result in confusing a caller, or in having missing required fields
     // in embedded optional messages.
     resp->Clear();
 
-    SetupErrorAndRespond(resp->mutable_error(), s,
-                         TabletServerErrorPB::UNKNOWN_ERROR,
-                         &context);
+    SetupErrorAndRespond(resp->mutable_error(), s, error_code, &context);
     return;
   }
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiUpdateConsensus(const consensus::MultiConsensusRequestPB* req,
+                                                consensus::MultiConsensusResponsePB* resp,
+                                                rpc::RpcContext context) {
+  DVLOG(3) << "Received Multi Consensus Update RPC: " << req->ShortDebugString();
+
+  // See UpdateConsensus for the reason of const_cast.
+  auto* mutable_req = const_cast<consensus::MultiConsensusRequestPB*>(req);
+  for (auto& consensus_req : *mutable_req->mutable_consensus_request()) {
+    UpdateConsensusInBatch(tablet_manager_, context.requestor_string(), &consensus_req,
+                           resp->add_consensus_response());
+  }
+  context.RespondSuccess();
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -1324,6 +1670,9 @@ void ConsensusServiceImpl::RunLeaderElection(const RunLeaderElectionRequestPB* r
   if (!scope) {
     return;
   }
+  if (req->has_leader_lease_revoked_term()) {
+    scope->LeaderLeaseRevoked(req->leader_lease_revoked_term(), req->leader_lease_revoked_ht());
+  }
   Status s = scope->StartElection(
       consensus::Consensus::ELECT_EVEN_IF_LEADER_IS_ALIVE,
       req->has_committed_index(),
@@ -1495,21 +1844,75 @@ void TabletServiceImpl::ListTabletsForTabletServer(const ListTabletsForTabletSer
 
 namespace {
 
-Result<uint64_t> CalcChecksum(tablet::Tablet* tablet) {
+// Throttles a scan to the specified number of rows per second, 0 means unlimited.
+class ScanThrottler {
+ public:
+  explicit ScanThrottler(uint32_t max_rows_per_sec)
+      : max_rows_per_sec_(max_rows_per_sec), start_(MonoTime::Now()) {}
+
+  void RowScanned() {
+    if (max_rows_per_sec_ == 0 || ++num_rows_ % kCheckEveryRows != 0) {
+      return;
+    }
+    const auto deadline =
+        start_ + MonoDelta::FromSeconds(static_cast<double>(num_rows_) / max_rows_per_sec_);
+    const auto now = MonoTime::Now();
+    if (now < deadline) {
+      SleepFor(deadline - now);
+    }
+  }
+
+ private:
+  static constexpr uint64_t kCheckEveryRows = 64;
+
+  const uint32_t max_rows_per_sec_;
+  const MonoTime start_;
+  uint64_t num_rows_ = 0;
+};
+
+CHECKED_STATUS CalcChecksum(
+    tablet::Tablet* tablet, const ChecksumRequestPB& req, ChecksumResponsePB* resp) {
   const Schema& schema = tablet->metadata()->schema();
   auto client_schema = schema.CopyWithoutColumnIds();
-  auto iter = tablet->NewRowIterator(client_schema, boost::none);
-  RETURN_NOT_OK(iter);
-
+  ScanThrottler throttler(req.max_rows_per_sec());
   QLTableRow value_map;
-  ScanResultChecksummer collector;
 
-  while ((**iter).HasNext()) {
-    RETURN_NOT_OK((**iter).NextRow(&value_map));
-    collector.HandleRow(schema, value_map);
+  if (!req.has_num_buckets()) {
+    auto iter = VERIFY_RESULT(tablet->NewRowIterator(client_schema, boost::none));
+    ScanResultChecksummer collector;
+    while (iter->HasNext()) {
+      RETURN_NOT_OK(iter->NextRow(&value_map));
+      collector.HandleRow(schema, value_map);
+      throttler.RowScanned();
+    }
+    resp->set_checksum(collector.agg_checksum());
+    return Status::OK();
+  }
+
+  const uint32_t min_hash_code = req.min_hash_code();
+  const uint32_t max_hash_code = req.max_hash_code();
+  const uint32_t num_buckets = req.num_buckets();
+  if (num_buckets == 0 || min_hash_code > max_hash_code ||
+      max_hash_code > std::numeric_limits<uint16_t>::max()) {
+    return STATUS_FORMAT(InvalidArgument, "Invalid hash code range [$0, $1] or $2 buckets",
+                         min_hash_code, max_hash_code, num_buckets);
+  }
+  auto iter = VERIFY_RESULT(tablet->NewRowIterator(
+      client_schema, boost::none, min_hash_code, max_hash_code));
+  const auto& doc_iter = *down_cast<docdb::DocRowwiseIterator*>(iter.get());
+  const uint64_t range_size = max_hash_code - min_hash_code + 1;
+  std::vector<ScanResultChecksummer> collectors(num_buckets);
+  while (iter->HasNext()) {
+    RETURN_NOT_OK(iter->NextRow(&value_map));
+    const uint32_t hash_code = doc_iter.row_key().hash();
+    const size_t bucket = (hash_code - min_hash_code) * num_buckets / range_size;
+    collectors[std::min<size_t>(bucket, num_buckets - 1)].HandleRow(schema, value_map);
+    throttler.RowScanned();
+  }
+  for (const auto& collector : collectors) {
+    resp->add_bucket_checksums(collector.agg_checksum());
   }
-
-  return collector.agg_checksum();
+  return Status::OK();
 }
 
 } // namespace
@@ -1523,15 +1926,13 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
   if (!DoGetTabletOrRespond(req, resp, &context, &abstract_tablet)) {
     return;
   }
-  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()));
-  if (!checksum.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(), checksum.status(),
+  auto status = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()), *req, resp);
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), status,
                          TabletServerErrorPB::UNKNOWN_ERROR, &context);
     return;
   }
 
-  resp->set_checksum(*checksum);
-
   context.RespondSuccess();
 }
 
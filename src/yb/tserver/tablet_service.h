@@ -49,6 +49,7 @@
 
 namespace yb {
 class Schema;
+struct RocksDBReadPerfCounters;
 class Status;
 class HybridTime;
 
@@ -145,6 +146,7 @@ class TabletServiceImpl : public TabletServerServiceIf {
 
   // Read implementation. If restart is required returns restart time, in case of success
   // returns invalid ReadHybridTime. Otherwise returns error status.
+  // When perf_counters is not null, RocksDB work done by the read is added to it.
   Result<ReadHybridTime> DoRead(tablet::AbstractTablet* tablet,
                                 const ReadRequestPB* req,
                                 ReadHybridTime read_time,
@@ -152,7 +154,8 @@ class TabletServiceImpl : public TabletServerServiceIf {
                                 tablet::RequireLease require_lease,
                                 HostPortPB* hostPortPB,
                                 ReadResponsePB* resp,
-                                rpc::RpcContext* context);
+                                rpc::RpcContext* context,
+                                RocksDBReadPerfCounters* perf_counters);
 
   TabletServerIf *const server_;
 };
@@ -197,6 +200,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiUpdateConsensus(const consensus::MultiConsensusRequestPB* req,
+                                    consensus::MultiConsensusResponsePB* resp,
+                                    rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -57,6 +57,7 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_int32(tablet_report_limit);
 
 namespace yb {
 namespace tserver {
@@ -193,6 +194,43 @@ TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   }
 }
 
+TEST_F(TsTabletManagerTest, TestTabletOpenPriority) {
+  // Voters that were recently leaders go first, then tablets with smaller WALs.
+  TabletOpenPriority non_voter;
+  TabletOpenPriority voter;
+  voter.voter = true;
+  TabletOpenPriority leader = voter;
+  leader.voted_for_self = true;
+  leader.wal_size = 10;
+  TabletOpenPriority big_leader = leader;
+  big_leader.wal_size = 1000;
+  non_voter.wal_size = 0;
+  ASSERT_TRUE(leader < big_leader);
+  ASSERT_FALSE(big_leader < leader);
+  ASSERT_TRUE(big_leader < voter);
+  ASSERT_TRUE(voter < non_voter);
+  ASSERT_FALSE(non_voter < voter);
+  ASSERT_FALSE(voter < voter);
+
+  std::shared_ptr<TabletPeer> small_peer;
+  std::shared_ptr<TabletPeer> big_peer;
+  ASSERT_OK(CreateNewTablet("small-tablet", schema_, &small_peer));
+  ASSERT_OK(CreateNewTablet("big-tablet", schema_, &big_peer));
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_OK(big_peer->log()->AllocateSegmentAndRollOver());
+  }
+
+  auto small_priority = GetTabletOpenPriority(fs_manager_, *small_peer->tablet_metadata());
+  auto big_priority = GetTabletOpenPriority(fs_manager_, *big_peer->tablet_metadata());
+  ASSERT_TRUE(small_priority.voter);
+  ASSERT_TRUE(big_priority.voter);
+  ASSERT_GT(small_priority.wal_size, 0U);
+  ASSERT_GT(big_priority.wal_size, small_priority.wal_size);
+  if (small_priority.voted_for_self == big_priority.voted_for_self) {
+    ASSERT_TRUE(small_priority < big_priority);
+  }
+}
+
 static void AssertMonotonicReportSeqno(int64_t* report_seqno,
                                        const TabletReportPB &report) {
   ASSERT_LT(*report_seqno, report.sequence_number());
@@ -309,6 +347,26 @@ TEST_F(TsTabletManagerTest, TestTabletReports) {
   ASSERT_REPORT_HAS_UPDATED_TABLET(report, "tablet-1");
   ASSERT_REPORT_HAS_UPDATED_TABLET(report, "tablet-2");
   ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
+  tablet_manager_->MarkTabletReportAcknowledged(report);
+
+  // When the report is limited, the full report contains only part of the tablets, and the rest
+  // are sent by the following incremental reports.
+  FlagSaver flag_saver;
+  FLAGS_tablet_report_limit = 1;
+  tablet_manager_->GenerateFullTabletReport(&report);
+  ASSERT_FALSE(report.is_incremental());
+  ASSERT_EQ(1, report.updated_tablets().size());
+  ASSERT_EQ(1, report.remaining_tablet_count());
+  ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
+  const auto first_tablet_id = report.updated_tablets(0).tablet_id();
+  tablet_manager_->MarkTabletReportAcknowledged(report);
+
+  tablet_manager_->GenerateIncrementalTabletReport(&report);
+  ASSERT_TRUE(report.is_incremental());
+  ASSERT_EQ(1, report.updated_tablets().size());
+  ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
+  ASSERT_REPORT_HAS_UPDATED_TABLET(
+      report, first_tablet_id == "tablet-1" ? "tablet-2" : "tablet-1");
 }
 
 } // namespace tserver
@@ -33,9 +33,12 @@
 #include "yb/tserver/ts_tablet_manager.h"
 
 #include <algorithm>
+#include <deque>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/optional/optional.hpp>
@@ -52,6 +55,8 @@
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
 
+#include "yb/docdb/docdb_rocksdb_util.h"
+
 #include "yb/fs/fs_manager.h"
 
 #include "yb/gutil/strings/substitute.h"
@@ -60,10 +65,14 @@
 #include "yb/master/master.pb.h"
 #include "yb/master/sys_catalog.h"
 
+#include "yb/rocksdb/env.h"
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/persistent_cache.h"
+#include "yb/rocksdb/rate_limiter.h"
 
 #include "yb/rpc/messenger.h"
 
+#include "yb/tablet/compaction_history.h"
 #include "yb/tablet/metadata.pb.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet.pb.h"
@@ -84,20 +93,26 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/priority_thread_pool.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/tsan_util.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
+using namespace yb::size_literals;
 
 DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "Number of threads available to open tablets during startup. If this "
              "is set to 0 (the default), then the number of bootstrap threads will "
              "be set based on the number of data directories. If the data directories "
              "are on some very fast storage device such as SSD or a RAID array, it "
-             "may make sense to manually tune this.");
+             "may make sense to manually tune this. Threads are split evenly between data "
+             "directories, and tablets of each directory are opened in priority order: voters "
+             "that were recently leaders first, then tablets with smaller WALs.");
 TAG_FLAG(num_tablets_to_open_simultaneously, advanced);
 
 DEFINE_int32(tablet_start_warn_threshold_ms, 500,
@@ -109,6 +124,14 @@ DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_int32(tablet_report_limit, 1000,
+             "Max number of tablets to include in a single tablet report sent by a heartbeat. "
+             "Remaining tablets are sent by following heartbeats, so the master does not have to "
+             "process reports for all tablets of all tablet servers at once after failover. "
+             "0 means no limit.");
+TAG_FLAG(tablet_report_limit, advanced);
+TAG_FLAG(tablet_report_limit, runtime);
+
 DEFINE_test_flag(double, fault_crash_after_blocks_deleted, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after deleting the data blocks during tablet deletion.");
@@ -150,6 +173,12 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
 
+DEFINE_int32(global_memstore_soft_limit_percentage, 85,
+             "Percentage of the global memstore size, after which the best flush candidate is "
+             "flushed early, without waiting for the global memstore size to be reached. "
+             "0 - disabled.");
+TAG_FLAG(global_memstore_soft_limit_percentage, advanced);
+
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
              "This defaults to -1 for system auto-generated default, which would use "
@@ -160,6 +189,48 @@ DEFINE_int32(db_block_cache_size_percentage, 50,
              "Default percentage of total available memory to use as block cache size, if not "
              "asking for a raw number, through FLAGS_db_block_cache_size_bytes.");
 
+DEFINE_bool(db_block_cache_frequency_admission, false,
+            "Add blocks to the full block cache only if they are read at least as frequently as "
+            "the blocks they would evict (TinyLFU), so scans do not evict frequently read blocks.");
+TAG_FLAG(db_block_cache_frequency_admission, advanced);
+
+DEFINE_int32(db_compressed_block_cache_size_percentage, 0,
+             "Percentage of the block cache size used for a second block cache tier, that keeps "
+             "data blocks in compressed form. Blocks evicted from the uncompressed tier could be "
+             "read from it without disk I/O. The uncompressed tier gets the rest of the block "
+             "cache size. 0 - disabled.");
+TAG_FLAG(db_compressed_block_cache_size_percentage, advanced);
+
+DEFINE_int32(db_pinned_index_and_filter_size_percentage, 10,
+             "Memory budget for top level index and filter blocks pinned in SST file readers, "
+             "as a percentage of block cache size. See db_pin_top_level_index_and_filter.");
+TAG_FLAG(db_pinned_index_and_filter_size_percentage, advanced);
+
+DEFINE_string(db_persistent_cache_path, "",
+              "Directory on a local flash device for the persistent block cache. Data blocks read "
+              "from SST files are also written there, and are read from there before reading SST "
+              "files. Its content survives restarts. Empty value disables the persistent cache.");
+TAG_FLAG(db_persistent_cache_path, advanced);
+
+DEFINE_int64(db_persistent_cache_size_bytes, 16_GB,
+             "Max size of the persistent block cache. See db_persistent_cache_path.");
+TAG_FLAG(db_persistent_cache_size_bytes, advanced);
+
+DEFINE_int32(priority_thread_pool_size, 0,
+             "Number of threads running compactions of all tablets of the tablet server. When a "
+             "thread becomes free, it runs the pending compaction of the tablet with the highest "
+             "read amplification, and then space debt. 0 - compactions of each tablet are "
+             "scheduled independently to the shared background thread pool.");
+TAG_FLAG(priority_thread_pool_size, advanced);
+
+DEFINE_int32(compaction_history_size, 256,
+             "Number of the latest flush and compaction jobs of all tablets kept by the tablet "
+             "server, and shown at /compactions.");
+TAG_FLAG(compaction_history_size, advanced);
+
+DECLARE_bool(rocksdb_compact_flush_rate_limit_per_tserver);
+DECLARE_bool(enable_leader_failure_detection);
+
 DEFINE_int32(read_pool_max_threads, 128,
              "The maximum number of threads allowed for read_pool_. This pool is used "
              "to run multiple read operations, that are part of the same tablet rpc, "
@@ -250,11 +321,57 @@ using tablet::TabletPeerPtr;
 using tablet::TabletStatusListener;
 using tablet::TabletStatusPB;
 
+namespace {
+
+// Tablets of a single data dir, waiting to be opened.
+struct OpenTabletQueue {
+  std::mutex mutex;
+  std::deque<std::pair<scoped_refptr<TabletMetadata>,
+                       scoped_refptr<TransitionInProgressDeleter>>> tablets;
+};
+
+} // namespace
+
+bool TabletOpenPriority::operator<(const TabletOpenPriority& rhs) const {
+  if (voter != rhs.voter) {
+    return voter;
+  }
+  if (voted_for_self != rhs.voted_for_self) {
+    return voted_for_self;
+  }
+  return wal_size < rhs.wal_size;
+}
+
+TabletOpenPriority GetTabletOpenPriority(FsManager* fs_manager, const TabletMetadata& meta) {
+  TabletOpenPriority result;
+  std::unique_ptr<ConsensusMetadata> cmeta;
+  // Failures are ignored here, they will be reported when the tablet is opened.
+  if (ConsensusMetadata::Load(fs_manager, meta.tablet_id(), fs_manager->uuid(), &cmeta).ok()) {
+    result.voter = consensus::IsRaftConfigVoter(fs_manager->uuid(), cmeta->committed_config());
+    result.voted_for_self = cmeta->has_voted_for() && cmeta->voted_for() == fs_manager->uuid();
+  }
+
+  auto* env = fs_manager->env();
+  auto children = env->GetChildren(meta.wal_dir(), ExcludeDots::kTrue);
+  if (children.ok()) {
+    for (const auto& child : *children) {
+      auto size = env->GetFileSize(JoinPathSegments(meta.wal_dir(), child));
+      if (size.ok()) {
+        result.wal_size += *size;
+      }
+    }
+  }
+  return result;
+}
+
 // Only called from the background task to ensure it's synchronized
 void TSTabletManager::MaybeFlushTablet() {
   int iteration = 0;
+  // Above the soft limit only one tablet is flushed per invocation, so memstores would be flushed
+  // gradually instead of all at once when the limit is reached.
   while (memory_monitor()->Exceeded() ||
-         (iteration++ == 0 && FLAGS_pretend_memory_exceeded_enforce_flush)) {
+         (iteration++ == 0 && (FLAGS_pretend_memory_exceeded_enforce_flush ||
+                               memory_monitor()->SoftLimitExceeded()))) {
     TabletPeerPtr tablet_to_flush = TabletToFlush();
     // TODO(bojanserafimov): If tablet_to_flush flushes now because of other reasons,
     // we will schedule a second flush, which will unnecessarily stall writes for a short time. This
@@ -266,20 +383,70 @@ void TSTabletManager::MaybeFlushTablet() {
   }
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all
-// tablet memstores are empty or about to flush.
+// Return the tablet that benefits most from a flush, or nullptr if all tablet memstores are empty
+// or about to flush.
+//
+// Each candidate is scored by its memstore size, age of the oldest write in memstore, and WAL
+// bytes that could not be GCed, each normalized by the max value among candidates. So big
+// memstores are flushed to free memory, old ones are flushed so cold tablets do not hold memory
+// and WAL forever, while hot tablets keep their memstores growing.
 TabletPeerPtr TSTabletManager::TabletToFlush() {
-  boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
-  HybridTime oldest_write_in_memstores = HybridTime::kMax;
-  TabletPeerPtr tablet_to_flush;
-  for (const TabletMap::value_type& entry : tablet_map_) {
-    const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
+  struct Candidate {
+    TabletPeerPtr peer;
+    double memtable_size;
+    double age;
+    double anchored_wal_bytes;
+  };
+  std::vector<Candidate> candidates;
+  Candidate max{nullptr, 0, 0, 0};
+  {
+    boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
+    const uint64_t now_micros = server_->clock()->Now().GetPhysicalValueMicros();
+    for (const TabletMap::value_type& entry : tablet_map_) {
+      const auto tablet = entry.second->shared_tablet();
+      if (!tablet) {
+        continue;
+      }
       const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
-      if (oldest_write_in_memstore < oldest_write_in_memstores) {
-        oldest_write_in_memstores = oldest_write_in_memstore;
-        tablet_to_flush = entry.second;
+      if (oldest_write_in_memstore == HybridTime::kMax) {
+        continue;
       }
+      const uint64_t oldest_write_micros = oldest_write_in_memstore.GetPhysicalValueMicros();
+      int64_t anchored_wal_bytes = 0;
+      tablet::TabletPeer::MaxIdxToSegmentSizeMap idx_size_map;
+      if (entry.second->GetMaxIndexesToSegmentSizeMap(&idx_size_map).ok()) {
+        for (const auto& idx_and_size : idx_size_map) {
+          anchored_wal_bytes += idx_and_size.second;
+        }
+      }
+      candidates.push_back(Candidate{
+          entry.second,
+          static_cast<double>(tablet->MemTableMemoryUsage()),
+          static_cast<double>(now_micros > oldest_write_micros ? now_micros - oldest_write_micros
+                                                              : 0),
+          static_cast<double>(anchored_wal_bytes)});
+      max.memtable_size = std::max(max.memtable_size, candidates.back().memtable_size);
+      max.age = std::max(max.age, candidates.back().age);
+      max.anchored_wal_bytes = std::max(max.anchored_wal_bytes,
+                                        candidates.back().anchored_wal_bytes);
+    }
+  }
+
+  auto normalized = [](double value, double max_value) {
+    return max_value > 0 ? value / max_value : 0;
+  };
+  TabletPeerPtr tablet_to_flush;
+  double best_score = -1;
+  for (const auto& candidate : candidates) {
+    const double score = normalized(candidate.memtable_size, max.memtable_size) +
+                         normalized(candidate.age, max.age) +
+                         normalized(candidate.anchored_wal_bytes, max.anchored_wal_bytes);
+    VLOG(2) << "Flush candidate " << candidate.peer->tablet_id() << ": memtable size "
+            << candidate.memtable_size << ", age " << candidate.age << "us, anchored WAL "
+            << candidate.anchored_wal_bytes << ", score " << score;
+    if (score > best_score) {
+      best_score = score;
+      tablet_to_flush = candidate.peer;
     }
   }
   return tablet_to_flush;
@@ -306,20 +473,14 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
   // This pool is shared by all replicas hosted by this server.
   //
   // Some submitted tasks use blocking IO, so we configure no upper bound on
-  // the maximum number of threads in each pool (otherwise the default value of
+  // the maximum number of threads in the pool (otherwise the default value of
   // "number of CPUs" may cause blocking tasks to starve other "fast" tasks).
   // However, the effective upper bound is the number of replicas as each will
-  // submit its own tasks via a dedicated token.
-  CHECK_OK(ThreadPoolBuilder("raft")
-               .unlimited_threads()
-               .Build(&raft_pool_));
-  CHECK_OK(ThreadPoolBuilder("prepare")
-               .unlimited_threads()
-               .Build(&tablet_prepare_pool_));
-  CHECK_OK(ThreadPoolBuilder("append")
+  // submit its own tasks via dedicated tokens.
+  CHECK_OK(ThreadPoolBuilder("tablet")
                .unlimited_threads()
                .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
-               .Build(&append_pool_));
+               .Build(&tablet_pool_));
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
       METRIC_op_read_queue_time.Instantiate(server_->metric_entity()),
@@ -345,11 +506,56 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     block_cache_size_bytes = total_ram_avail * FLAGS_db_block_cache_size_percentage / 100;
   }
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                       FLAGS_db_block_cache_num_shard_bits);
+    CHECK(FLAGS_db_compressed_block_cache_size_percentage >= 0 &&
+          FLAGS_db_compressed_block_cache_size_percentage < 100)
+        << "Flag db_compressed_block_cache_size_percentage must be between 0 and 99. "
+        << "Current value: " << FLAGS_db_compressed_block_cache_size_percentage;
+    const int64_t compressed_block_cache_size_bytes =
+        block_cache_size_bytes * FLAGS_db_compressed_block_cache_size_percentage / 100;
+    const int64_t uncompressed_block_cache_size_bytes =
+        block_cache_size_bytes - compressed_block_cache_size_bytes;
+    tablet_options_.block_cache = rocksdb::NewLRUCache(
+        uncompressed_block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits,
+        false /* strict_capacity_limit */,
+        FLAGS_db_block_cache_frequency_admission ? rocksdb::CacheAdmissionPolicy::kFrequency
+                                                 : rocksdb::CacheAdmissionPolicy::kAlways);
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
+    tablet_options_.block_cache->SetMemTracker(MemTracker::CreateTracker(
+        uncompressed_block_cache_size_bytes, "BlockCache", server_->mem_tracker()));
+    if (compressed_block_cache_size_bytes > 0) {
+      tablet_options_.block_cache_compressed = rocksdb::NewLRUCache(
+          compressed_block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits);
+      tablet_options_.block_cache_compressed->SetMemTracker(MemTracker::CreateTracker(
+          compressed_block_cache_size_bytes, "CompressedBlockCache", server_->mem_tracker()));
+    }
+    tablet_options_.pinned_index_and_filter_mem_tracker = MemTracker::CreateTracker(
+        block_cache_size_bytes * FLAGS_db_pinned_index_and_filter_size_percentage / 100,
+        "PinnedIndexAndFilter", server_->mem_tracker());
+  }
+  if (!FLAGS_db_persistent_cache_path.empty()) {
+    rocksdb::PersistentCacheOptions persistent_cache_options;
+    persistent_cache_options.env = rocksdb::Env::Default();
+    persistent_cache_options.path = FLAGS_db_persistent_cache_path;
+    persistent_cache_options.capacity = FLAGS_db_persistent_cache_size_bytes;
+    Status s = rocksdb::NewPersistentCache(
+        persistent_cache_options, &tablet_options_.persistent_cache);
+    if (!s.ok()) {
+      // It is only a cache, so the tablet server could work without it.
+      LOG(WARNING) << "Failed to open persistent cache at " << FLAGS_db_persistent_cache_path
+                   << ", continuing without it: " << s;
+    }
   }
 
+  if (FLAGS_priority_thread_pool_size > 0) {
+    tablet_options_.priority_thread_pool = std::make_shared<PriorityThreadPool>(
+        FLAGS_priority_thread_pool_size);
+  }
+  if (FLAGS_rocksdb_compact_flush_rate_limit_per_tserver) {
+    tablet_options_.rate_limiter = docdb::CreateRocksDBRateLimiter();
+  }
+  tablet_options_.compaction_history = std::make_shared<tablet::CompactionHistory>(
+      FLAGS_compaction_history_size, server_->metric_entity());
+
   // Calculate memstore_size_bytes
   bool should_count_memory = FLAGS_global_memstore_size_percentage > 0;
   CHECK(FLAGS_global_memstore_size_percentage > 0 && FLAGS_global_memstore_size_percentage <= 100)
@@ -374,7 +580,8 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     tablet_options_.memory_monitor = std::make_shared<rocksdb::MemoryMonitor>(
         memstore_size_bytes,
         std::function<void()>([this](){
-                                YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }));
+                                YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }),
+        memstore_size_bytes * FLAGS_global_memstore_soft_limit_percentage / 100);
   }
 }
 
@@ -390,17 +597,16 @@ Status TSTabletManager::Init() {
       &server_->options(), server_->metric_entity(), server_->mem_tracker(),
       server_->messenger());
 
-  // Start the threadpool we'll use to open tablets.
+  // Create the token we'll use to open tablets.
   // This has to be done in Init() instead of the constructor, since the
   // FsManager isn't initialized until this point.
+  const int num_data_dirs = std::max<int>(fs_manager_->GetDataRootDirs().size(), 1);
   int max_bootstrap_threads = FLAGS_num_tablets_to_open_simultaneously;
   if (max_bootstrap_threads == 0) {
     // Default to the number of disks.
-    max_bootstrap_threads = fs_manager_->GetDataRootDirs().size();
+    max_bootstrap_threads = num_data_dirs;
   }
-  RETURN_NOT_OK(ThreadPoolBuilder("tablet-bootstrap")
-                .set_max_threads(max_bootstrap_threads)
-                .Build(&open_tablet_pool_));
+  open_tablet_token_ = tablet_pool_->NewConcurrencyLimitedToken(max_bootstrap_threads);
 
   // Search for tablets in the metadata dir.
   vector<string> tablet_ids;
@@ -432,8 +638,21 @@ Status TSTabletManager::Init() {
     metas.push_back(meta);
   }
 
-  // Now submit the "Open" task for each.
-  for (const scoped_refptr<TabletMetadata>& meta : metas) {
+  // Open tablets that could serve requests soon first, and defer tablets with big WALs, whose
+  // bootstrap takes a long time.
+  std::vector<std::pair<TabletOpenPriority, scoped_refptr<TabletMetadata>>> prioritized_metas;
+  prioritized_metas.reserve(metas.size());
+  for (const auto& meta : metas) {
+    prioritized_metas.emplace_back(GetTabletOpenPriority(fs_manager_, *meta), meta);
+  }
+  std::stable_sort(prioritized_metas.begin(), prioritized_metas.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+  // Tablets are queued per data dir, so bootstrap threads are spread evenly between disks instead
+  // of overloading a single one.
+  std::unordered_map<std::string, std::shared_ptr<OpenTabletQueue>> queues;
+  for (const auto& priority_and_meta : prioritized_metas) {
+    const auto& meta = priority_and_meta.second;
     scoped_refptr<TransitionInProgressDeleter> deleter;
     {
       std::lock_guard<RWMutex> lock(lock_);
@@ -441,8 +660,36 @@ Status TSTabletManager::Init() {
     }
 
     TabletPeerPtr tablet_peer = CreateAndRegisterTabletPeer(meta, NEW_PEER);
-    RETURN_NOT_OK(open_tablet_pool_->SubmitFunc(
-        std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+    auto& queue = queues[meta->data_root_dir()];
+    if (!queue) {
+      queue = std::make_shared<OpenTabletQueue>();
+    }
+    queue->tablets.emplace_back(meta, deleter);
+  }
+
+  // Now submit tasks that open tablets of each data dir in priority order.
+  const size_t tasks_per_data_dir = std::max(max_bootstrap_threads / num_data_dirs, 1);
+  for (const auto& dir_and_queue : queues) {
+    const auto& queue = dir_and_queue.second;
+    const size_t num_tasks = std::min(tasks_per_data_dir, queue->tablets.size());
+    for (size_t i = 0; i != num_tasks; ++i) {
+      RETURN_NOT_OK(open_tablet_token_->SubmitFunc([this, queue] {
+        for (;;) {
+          scoped_refptr<TabletMetadata> meta;
+          scoped_refptr<TransitionInProgressDeleter> deleter;
+          {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (queue->tablets.empty()) {
+              return;
+            }
+            meta = std::move(queue->tablets.front().first);
+            deleter = std::move(queue->tablets.front().second);
+            queue->tablets.pop_front();
+          }
+          OpenTablet(meta, deleter);
+        }
+      }));
+    }
   }
 
   {
@@ -460,7 +707,7 @@ Status TSTabletManager::Init() {
 Status TSTabletManager::WaitForAllBootstrapsToFinish() {
   CHECK_EQ(state(), MANAGER_RUNNING);
 
-  open_tablet_pool_->Wait();
+  open_tablet_token_->Wait();
 
   Status s = Status::OK();
 
@@ -485,7 +732,8 @@ Status TSTabletManager::CreateNewTablet(
     const Schema &schema,
     const PartitionSchema &partition_schema,
     RaftConfigPB config,
-    TabletPeerPtr *tablet_peer) {
+    TabletPeerPtr *tablet_peer,
+    bool start_election) {
   CHECK_EQ(state(), MANAGER_RUNNING);
   CHECK(IsRaftConfigMember(server_->instance_pb().permanent_uuid(), config));
 
@@ -548,8 +796,8 @@ Status TSTabletManager::CreateNewTablet(
   TabletPeerPtr new_peer = CreateAndRegisterTabletPeer(meta, NEW_PEER);
 
   // We can run this synchronously since there is nothing to bootstrap.
-  RETURN_NOT_OK(
-      open_tablet_pool_->SubmitFunc(std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+  RETURN_NOT_OK(open_tablet_token_->SubmitFunc(
+      std::bind(&TSTabletManager::OpenNewTablet, this, meta, deleter, start_election)));
 
   if (tablet_peer) {
     *tablet_peer = new_peer;
@@ -980,6 +1228,28 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
   }
 }
 
+void TSTabletManager::OpenNewTablet(const scoped_refptr<TabletMetadata>& meta,
+                                    const scoped_refptr<TransitionInProgressDeleter>& deleter,
+                                    bool start_election) {
+  OpenTablet(meta, deleter);
+  if (!start_election || !FLAGS_enable_leader_failure_detection) {
+    return;
+  }
+
+  const string& tablet_id = meta->tablet_id();
+  TabletPeerPtr tablet_peer;
+  if (!LookupTablet(tablet_id, &tablet_peer) || tablet_peer->state() != tablet::RUNNING) {
+    return;
+  }
+  auto consensus = tablet_peer->shared_consensus();
+  if (consensus) {
+    LOG(INFO) << tserver::LogPrefix(tablet_id, fs_manager_->uuid())
+              << "Starting election as the initial leader";
+    WARN_NOT_OK(consensus->StartElection(consensus::Consensus::NORMAL_ELECTION),
+                "Failed to start initial election");
+  }
+}
+
 void TSTabletManager::Shutdown() {
   async_client_init_->Shutdown();
 
@@ -1010,8 +1280,8 @@ void TSTabletManager::Shutdown() {
     }
   }
 
-  // Shut down the bootstrap pool, so new tablets are registered after this point.
-  open_tablet_pool_->Shutdown();
+  // Shut down the bootstrap token, so new tablets are registered after this point.
+  open_tablet_token_->Shutdown();
 
   // Take a snapshot of the peers list -- that way we don't have to hold
   // on to the lock while shutting them down, which might cause a lock
@@ -1026,14 +1296,12 @@ void TSTabletManager::Shutdown() {
   // Shut down the apply pool.
   apply_pool_->Shutdown();
 
-  if (raft_pool_) {
-    raft_pool_->Shutdown();
+  if (tablet_pool_) {
+    tablet_pool_->Shutdown();
   }
-  if (tablet_prepare_pool_) {
-    tablet_prepare_pool_->Shutdown();
-  }
-  if (append_pool_) {
-    append_pool_->Shutdown();
+  // Tablets are shut down, so there should be no compactions left.
+  if (tablet_options_.priority_thread_pool) {
+    tablet_options_.priority_thread_pool->Shutdown();
   }
 
   {
@@ -1233,20 +1501,30 @@ void TSTabletManager::GenerateIncrementalTabletReport(TabletReportPB* report) {
   // a local copy of the set of replicas.
   vector<std::shared_ptr<TabletPeer>> to_report;
   {
-    boost::shared_lock<RWMutex> shared_lock(lock_);
-    to_report.reserve(dirty_tablets_.size());
+    // Exclusive lock, since dirty entries that do not fit into this report are updated.
+    std::lock_guard<RWMutex> lock(lock_);
+    const size_t limit = ReportLimit();
+    to_report.reserve(std::min(dirty_tablets_.size(), limit));
     report->set_sequence_number(next_report_seq_++);
-    for (const DirtyMap::value_type& dirty_entry : dirty_tablets_) {
+    int32_t remaining = 0;
+    for (DirtyMap::value_type& dirty_entry : dirty_tablets_) {
       const string& tablet_id = dirty_entry.first;
       TabletPeerPtr* tablet_peer = FindOrNull(tablet_map_, tablet_id);
-      if (tablet_peer) {
+      if (!tablet_peer) {
+        // Removed.
+        report->add_removed_tablet_ids(tablet_id);
+      } else if (to_report.size() < limit) {
         // Dirty entry, report on it.
         to_report.push_back(*tablet_peer);
       } else {
-        // Removed.
-        report->add_removed_tablet_ids(tablet_id);
+        // Does not fit, so should not be cleared when this report is acknowledged.
+        dirty_entry.second.change_seq = next_report_seq_;
+        ++remaining;
       }
     }
+    if (remaining) {
+      report->set_remaining_tablet_count(remaining);
+    }
   }
   for (const auto& replica : to_report) {
     CreateReportedTabletPB(replica, report->add_updated_tablets());
@@ -1263,16 +1541,30 @@ void TSTabletManager::GenerateFullTabletReport(TabletReportPB* report) {
   // a local copy of the set of replicas.
   vector<std::shared_ptr<TabletPeer>> to_report;
   {
-    boost::shared_lock<RWMutex> shared_lock(lock_);
+    std::lock_guard<RWMutex> lock(lock_);
     report->set_sequence_number(next_report_seq_++);
     GetTabletPeersUnlocked(&to_report);
+    dirty_tablets_.clear();
+    const size_t limit = ReportLimit();
+    if (to_report.size() > limit) {
+      // Tablets that do not fit are reported incrementally after this report is acknowledged.
+      TabletReportState state;
+      state.change_seq = next_report_seq_;
+      for (auto i = to_report.begin() + limit; i != to_report.end(); ++i) {
+        dirty_tablets_.emplace((**i).tablet_id(), state);
+      }
+      report->set_remaining_tablet_count(to_report.size() - limit);
+      to_report.resize(limit);
+    }
   }
   for (const auto& replica : to_report) {
     CreateReportedTabletPB(replica, report->add_updated_tablets());
   }
+}
 
-  std::lock_guard<RWMutex> l(lock_);
-  dirty_tablets_.clear();
+size_t TSTabletManager::ReportLimit() {
+  const int32_t limit = FLAGS_tablet_report_limit;
+  return limit > 0 ? limit : std::numeric_limits<size_t>::max();
 }
 
 void TSTabletManager::MarkTabletReportAcknowledged(const TabletReportPB& report) {
@@ -145,10 +145,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Shut down all of the tablets, gracefully flushing before shutdown.
   void Shutdown();
 
-  ThreadPool* tablet_prepare_pool() const { return tablet_prepare_pool_.get(); }
-  ThreadPool* raft_pool() const { return raft_pool_.get(); }
+  // Prepare, Raft and append tasks share the same pool.
+  ThreadPool* tablet_prepare_pool() const { return tablet_pool_.get(); }
+  ThreadPool* raft_pool() const { return tablet_pool_.get(); }
   ThreadPool* read_pool() const { return read_pool_.get(); }
-  ThreadPool* append_pool() const { return append_pool_.get(); }
+  ThreadPool* append_pool() const { return tablet_pool_.get(); }
 
   // Create a new tablet and register it with the tablet manager. The new tablet
   // is persisted on disk and opened before this method returns.
@@ -157,6 +158,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   //
   // If another tablet already exists with this ID, logs a DFATAL
   // and returns a bad Status.
+  //
+  // If start_election is true, the new replica starts a leader election as soon as it is started.
   CHECKED_STATUS CreateNewTablet(
     const string &table_id,
     const string &tablet_id,
@@ -166,7 +169,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
     const Schema &schema,
     const PartitionSchema &partition_schema,
     consensus::RaftConfigPB config,
-    std::shared_ptr<tablet::TabletPeer> *tablet_peer);
+    std::shared_ptr<tablet::TabletPeer> *tablet_peer,
+    bool start_election = false);
 
   // Delete the specified tablet.
   // 'delete_type' must be one of TABLET_DATA_DELETED or TABLET_DATA_TOMBSTONED
@@ -213,9 +217,16 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   //
   // This is thread-safe to call along with tablet modification, but not safe
   // to call from multiple threads at the same time.
+  //
+  // At most FLAGS_tablet_report_limit tablets are included, the number of tablets left for the
+  // following reports is stored in remaining_tablet_count.
   void GenerateIncrementalTabletReport(master::TabletReportPB* report);
 
   // Generate a full tablet report and reset any incremental state tracking.
+  //
+  // When there are more than FLAGS_tablet_report_limit tablets, only the first chunk is sent in
+  // the full report, and the rest are marked dirty, so they are sent by subsequent incremental
+  // reports.
   void GenerateFullTabletReport(master::TabletReportPB* report);
 
   // Mark that the master successfully received and processed the given
@@ -281,6 +292,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
 
   MemoryMonitor* memory_monitor() { return tablet_options_.memory_monitor.get(); }
 
+  tablet::CompactionHistory* compaction_history() {
+    return tablet_options_.compaction_history.get();
+  }
+
   // Flush some tablet if the memstore memory limit is exceeded
   void MaybeFlushTablet();
 
@@ -335,6 +350,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   void OpenTablet(const scoped_refptr<tablet::TabletMetadata>& meta,
                   const scoped_refptr<TransitionInProgressDeleter>& deleter);
 
+  // Open a newly created tablet, and start a leader election on it if it was chosen to be the
+  // initial leader.
+  void OpenNewTablet(const scoped_refptr<tablet::TabletMetadata>& meta,
+                     const scoped_refptr<TransitionInProgressDeleter>& deleter,
+                     bool start_election);
+
   // Open a tablet whose metadata has already been loaded.
   void BootstrapAndInitTablet(const scoped_refptr<tablet::TabletMetadata>& meta,
                               std::shared_ptr<tablet::TabletPeer>* peer);
@@ -362,6 +383,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   void CreateReportedTabletPB(const std::shared_ptr<tablet::TabletPeer>& tablet_peer,
                               master::ReportedTabletPB* reported_tablet);
 
+  // Max number of tablets in a single tablet report.
+  static size_t ReportLimit();
+
   // Mark that the provided TabletPeer's state has changed. That should be taken into
   // account in the next report.
   //
@@ -430,21 +454,19 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
 
   TSTabletManagerStatePB state_;
 
-  // Thread pool used to open the tablets async, whether bootstrap is required or not.
-  std::unique_ptr<ThreadPool> open_tablet_pool_;
+  // Thread pool shared between all tablets, used for preparing transactions, Raft-related
+  // operations, log appenders and opening tablets. Each of them submits tasks via their own
+  // tokens, so idle threads of one stage are reused by other stages, instead of every stage
+  // keeping its own set of threads.
+  std::unique_ptr<ThreadPool> tablet_pool_;
 
-  // Thread pool for preparing transactions, shared between all tablets.
-  std::unique_ptr<ThreadPool> tablet_prepare_pool_;
+  // Token used to open the tablets async, whether bootstrap is required or not. Its concurrency
+  // limits the number of tablets opened simultaneously.
+  std::unique_ptr<ThreadPoolToken> open_tablet_token_;
 
   // Thread pool for apply transactions, shared between all tablets.
   std::unique_ptr<ThreadPool> apply_pool_;
 
-  // Thread pool for Raft-related operations, shared between all tablets.
-  std::unique_ptr<ThreadPool> raft_pool_;
-
-  // Thread pool for appender threads, shared between all tablets.
-  std::unique_ptr<ThreadPool> append_pool_;
-
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
@@ -475,6 +497,24 @@ class TransitionInProgressDeleter : public RefCountedThreadSafe<TransitionInProg
   const std::string entry_;
 };
 
+// Tablets found on startup are opened in the order of these priorities, see operator<.
+struct TabletOpenPriority {
+  // Local peer is a voter in the committed config, so the tablet could get a leader here.
+  bool voter = false;
+  // Local peer voted for itself in its last term, so it was likely the recent leader and received
+  // the most recent writes.
+  bool voted_for_self = false;
+  // Total size of WAL segments, that should be replayed during bootstrap.
+  uint64_t wal_size = 0;
+
+  // Whether this tablet should be opened before rhs.
+  bool operator<(const TabletOpenPriority& rhs) const;
+};
+
+// Loads the open priority of the tablet from its consensus metadata and WAL dir.
+TabletOpenPriority GetTabletOpenPriority(FsManager* fs_manager,
+                                         const tablet::TabletMetadata& meta);
+
 // Print a log message using the given info and tombstone the specified tablet.
 // If tombstoning the tablet fails, a FATAL error is logged, resulting in a crash.
 // If ts_manager pointer is passed in, it will unregister from the directory assignment map.
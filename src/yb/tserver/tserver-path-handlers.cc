@@ -42,15 +42,18 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/server/webui_util.h"
+#include "yb/tablet/compaction_history.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
+#include "yb/tablet/tablet_load_tracker.h"
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
@@ -65,10 +68,14 @@ using yb::consensus::CONSENSUS_CONFIG_COMMITTED;
 using yb::consensus::ConsensusStatePB;
 using yb::consensus::RaftPeerPB;
 using yb::consensus::OperationStatusPB;
+using yb::tablet::CompactionJobEvent;
+using yb::tablet::CompactionJobType;
 using yb::tablet::MaintenanceManagerStatusPB;
 using yb::tablet::MaintenanceManagerStatusPB_CompletedOpPB;
 using yb::tablet::MaintenanceManagerStatusPB_MaintenanceOpPB;
+using yb::tablet::KeyAccessType;
 using yb::tablet::Tablet;
+using yb::tablet::TabletLoad;
 using yb::tablet::TabletPeer;
 using yb::tablet::TabletStatusPB;
 using yb::tablet::Operation;
@@ -112,6 +119,17 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/tablet-load", "",
+      std::bind(&TabletServerPathHandlers::HandleTabletLoadPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/hotkeys", "", std::bind(&TabletServerPathHandlers::HandleHotKeysPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/compactions", "",
+      std::bind(&TabletServerPathHandlers::HandleCompactionsPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
 
   return Status::OK();
 }
@@ -405,6 +423,222 @@ void TabletServerPathHandlers::HandleDashboardsPage(const Webserver::WebRequest&
   *output << GetDashboardLine("maintenance-manager", "Maintenance Manager",
                               "List of operations that are currently running and those "
                               "that are registered.");
+  *output << GetDashboardLine("tablet-load", "Tablet Load",
+                              "Rates of reads, writes and conflicts of tablets, hottest first.");
+  *output << GetDashboardLine("hotkeys", "Hot Keys",
+                              "Hash codes of keys that receive most of reads, writes and "
+                              "conflicts.");
+  *output << GetDashboardLine("compactions", "Compactions",
+                              "Latest flushes and compactions of tablets, with their sizes, keys "
+                              "dropped, durations and write stalls.");
+}
+
+namespace {
+
+struct TabletLoadEntry {
+  std::shared_ptr<TabletPeer> peer;
+  TabletLoad load;
+
+  double total_ops() const {
+    return load.ops(KeyAccessType::kRead) + load.ops(KeyAccessType::kWrite);
+  }
+};
+
+}  // anonymous namespace
+
+void TabletServerPathHandlers::HandleTabletLoadPage(const Webserver::WebRequest& req,
+                                                    std::stringstream* output) {
+  vector<std::shared_ptr<TabletPeer>> peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+  vector<TabletLoadEntry> entries;
+  for (const auto& peer : peers) {
+    auto tablet = peer->shared_tablet();
+    if (tablet == nullptr) {
+      continue;
+    }
+    entries.push_back(TabletLoadEntry{peer, tablet->load_tracker()->GetLoad()});
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.total_ops() > rhs.total_ops();
+  });
+
+  *output << "<h1>Tablet Load</h1>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table name</th><th>Tablet ID</th><th>Role</th><th>Reads/sec</th>"
+             "<th>Writes/sec</th><th>Conflicts/sec</th><th>Hottest key share</th></tr>\n";
+  for (const auto& entry : entries) {
+    shared_ptr<consensus::Consensus> consensus = entry.peer->shared_consensus();
+    *output << Substitute(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td>"
+        "<td>$6%</td></tr>\n",
+        EscapeForHtmlToString(entry.peer->tablet_metadata()->table_name()),
+        TabletLink(entry.peer->tablet_id()),
+        consensus ? RaftPeerPB::Role_Name(consensus->role()) : "",
+        StringPrintf("%.1f", entry.load.ops(KeyAccessType::kRead)),
+        StringPrintf("%.1f", entry.load.ops(KeyAccessType::kWrite)),
+        StringPrintf("%.1f", entry.load.ops(KeyAccessType::kConflict)),
+        StringPrintf("%.1f", entry.load.hottest_key_share * 100));
+  }
+  *output << "</table>\n";
+}
+
+void TabletServerPathHandlers::HandleHotKeysPage(const Webserver::WebRequest& req,
+                                                 std::stringstream* output) {
+  int limit = 20;
+  auto it = req.parsed_args.find("limit");
+  if (it != req.parsed_args.end() && (!safe_strto32(it->second, &limit) || limit <= 0)) {
+    *output << "Invalid 'limit' argument: " << EscapeForHtmlToString(it->second);
+    return;
+  }
+
+  vector<std::shared_ptr<TabletPeer>> peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+
+  *output << "<h1>Hot Keys</h1>\n";
+  *output << "<p>Hash codes that receive most of accesses, over the last few load windows. "
+             "Counts are estimated from sampled accesses and could be overestimated by the "
+             "error.</p>\n";
+  for (auto type : tablet::kKeyAccessTypeList) {
+    struct Entry {
+      std::shared_ptr<TabletPeer> peer;
+      tablet::HotKey key;
+    };
+    vector<Entry> entries;
+    for (const auto& peer : peers) {
+      auto tablet = peer->shared_tablet();
+      if (tablet == nullptr) {
+        continue;
+      }
+      for (const auto& key : tablet->load_tracker()->HotKeys(type, limit)) {
+        entries.push_back(Entry{peer, key});
+      }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+      return lhs.key.count > rhs.key.count;
+    });
+    if (entries.size() > static_cast<size_t>(limit)) {
+      entries.resize(limit);
+    }
+
+    *output << Substitute("<h3>$0</h3>\n", ToCString(type) + 1);
+    *output << "<table class='table table-striped'>\n";
+    *output << "  <tr><th>Table name</th><th>Tablet ID</th><th>Hash code</th><th>Count</th>"
+               "<th>Error</th><th>Share of tablet</th></tr>\n";
+    for (const auto& entry : entries) {
+      *output << Substitute(
+          "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5%</td></tr>\n",
+          EscapeForHtmlToString(entry.peer->tablet_metadata()->table_name()),
+          TabletLink(entry.peer->tablet_id()),
+          StringPrintf("0x%04x", entry.key.hash_code),
+          entry.key.count,
+          entry.key.error,
+          StringPrintf("%.1f", entry.key.share * 100));
+    }
+    *output << "</table>\n";
+  }
+}
+
+void TabletServerPathHandlers::HandleCompactionsPage(const Webserver::WebRequest& req,
+                                                     std::stringstream* output) {
+  auto* history = tserver_->tablet_manager()->compaction_history();
+  if (history == nullptr) {
+    *output << "Compaction history is not available";
+    return;
+  }
+  const string tablet_id = FindWithDefault(req.parsed_args, "tablet_id", "");
+  vector<CompactionJobEvent> events = history->Events();
+  if (!tablet_id.empty()) {
+    events.erase(std::remove_if(events.begin(), events.end(), [&tablet_id](const auto& event) {
+      return event.tablet_id != tablet_id;
+    }), events.end());
+  }
+
+  struct Totals {
+    size_t num_jobs = 0;
+    uint64_t input_bytes = 0;
+    uint64_t output_bytes = 0;
+    uint64_t elapsed_micros = 0;
+    uint64_t stall_micros = 0;
+    docdb::DocDBCompactionFilterStats dropped;
+  };
+  Totals totals[tablet::kElementsInCompactionJobType];
+  for (const auto& event : events) {
+    auto& total = totals[to_underlying(event.type)];
+    ++total.num_jobs;
+    total.input_bytes += event.input_bytes;
+    total.output_bytes += event.output_bytes;
+    total.elapsed_micros += event.elapsed_micros;
+    total.stall_micros += event.stall_micros;
+    total.dropped += event.dropped;
+  }
+
+  *output << "<h1>Compactions</h1>\n";
+  *output << Substitute("<p>The latest $0 flush and compaction jobs of all tablets. Stall is the "
+                        "time writes to the tablet were delayed or stopped since its previous "
+                        "job.</p>\n", history->capacity());
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Type</th><th>Jobs</th><th>Bytes read</th><th>Bytes written</th>"
+             "<th>Keys dropped</th><th>Total time</th><th>Bytes written/sec</th>"
+             "<th>Stall</th></tr>\n";
+  for (auto type : tablet::kCompactionJobTypeList) {
+    const auto& total = totals[to_underlying(type)];
+    *output << Substitute(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>"
+        "<td>$7</td></tr>\n",
+        ToCString(type) + 1,
+        total.num_jobs,
+        HumanReadableNumBytes::ToString(total.input_bytes),
+        HumanReadableNumBytes::ToString(total.output_bytes),
+        total.dropped.total(),
+        HumanReadableElapsedTime::ToShortString(total.elapsed_micros / 1e6),
+        HumanReadableNumBytes::ToString(
+            total.elapsed_micros ? total.output_bytes * 1e6 / total.elapsed_micros : 0),
+        HumanReadableElapsedTime::ToShortString(total.stall_micros / 1e6));
+  }
+  *output << "</table>\n";
+
+  const MonoTime now = MonoTime::Now();
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Finished</th><th>Tablet ID</th><th>DB</th><th>Type</th><th>Reason</th>"
+             "<th>Levels</th><th>Input files</th><th>Bytes read</th><th>Output files</th>"
+             "<th>Bytes written</th><th>Records in / out</th>"
+             "<th>Expired / overwritten / deleted</th><th>Time</th><th>Bytes written/sec</th>"
+             "<th>Stall</th><th>Status</th></tr>\n";
+  for (const auto& event : events) {
+    const bool is_flush = event.type == CompactionJobType::kFlush;
+    string reason = is_flush ? "" : event.reason;
+    if (is_flush && event.triggered_writes_stop) {
+      reason = "writes stopped";
+    } else if (is_flush && event.triggered_writes_slowdown) {
+      reason = "writes slowed down";
+    }
+    *output << Substitute(
+        "<tr><td>$0 ago</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>"
+        "<td>$7</td><td>$8</td><td>$9</td>",
+        HumanReadableElapsedTime::ToShortString(now.GetDeltaSince(event.finish_time).ToSeconds()),
+        TabletLink(event.tablet_id),
+        event.intents_db ? "intents" : "regular",
+        ToCString(event.type) + 1,
+        EscapeForHtmlToString(reason),
+        is_flush ? "mem -> 0" : Substitute("$0 -> $1", event.input_level, event.output_level),
+        is_flush ? "" : std::to_string(event.num_input_files),
+        is_flush ? "" : HumanReadableNumBytes::ToString(event.input_bytes),
+        event.num_output_files,
+        HumanReadableNumBytes::ToString(event.output_bytes));
+    *output << Substitute(
+        "<td>$0 / $1</td><td>$2 / $3 / $4</td><td>$5</td><td>$6</td><td>$7</td><td>$8</td>"
+        "</tr>\n",
+        event.num_input_records,
+        event.num_output_records,
+        event.dropped.num_expired,
+        event.dropped.num_overwritten,
+        event.dropped.num_deleted,
+        HumanReadableElapsedTime::ToShortString(event.elapsed_micros / 1e6),
+        HumanReadableNumBytes::ToString(event.output_bytes_per_sec()),
+        HumanReadableElapsedTime::ToShortString(event.stall_micros / 1e6),
+        EscapeForHtmlToString(event.status));
+  }
+  *output << "</table>\n";
 }
 
 string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
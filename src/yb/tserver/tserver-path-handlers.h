@@ -78,6 +78,12 @@ class TabletServerPathHandlers {
                             std::stringstream* output);
   void HandleMaintenanceManagerPage(const Webserver::WebRequest& req,
                                     std::stringstream* output);
+  void HandleTabletLoadPage(const Webserver::WebRequest& req,
+                            std::stringstream* output);
+  void HandleHotKeysPage(const Webserver::WebRequest& req,
+                         std::stringstream* output);
+  void HandleCompactionsPage(const Webserver::WebRequest& req,
+                             std::stringstream* output);
   std::string ConsensusStatePBToHtml(const consensus::ConsensusStatePB& cstate) const;
   std::string GetDashboardLine(const std::string& link,
                                const std::string& text, const std::string& desc);
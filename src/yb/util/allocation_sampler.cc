@@ -0,0 +1,212 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/allocation_sampler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#ifdef TCMALLOC_ENABLED
+#include <gperftools/malloc_hook.h>
+#endif
+
+#include "yb/util/mem_tracker.h"
+
+namespace yb {
+
+namespace {
+
+// Limits memory used by samples of a tracker, allocations from other stacks are accumulated
+// together.
+constexpr size_t kMaxStacksPerTracker = 1024;
+
+std::atomic<int64_t> sampling_interval_bytes{0};
+
+// Trivially constructed, so it is safe to use from malloc hooks of any thread.
+struct ThreadSamplerState {
+  MemTracker* tracker;
+  int64_t bytes_until_sample;
+  uint64_t random_state;
+  // Set while the sampler itself runs on this thread, so its own allocations are not sampled.
+  bool in_sampler;
+};
+
+thread_local ThreadSamplerState thread_sampler_state = {nullptr, 0, 0, false};
+
+class SamplerGuard {
+ public:
+  SamplerGuard() : state_(thread_sampler_state), previous_(state_.in_sampler) {
+    state_.in_sampler = true;
+  }
+
+  ~SamplerGuard() {
+    state_.in_sampler = previous_;
+  }
+
+ private:
+  ThreadSamplerState& state_;
+  bool previous_;
+};
+
+#ifdef TCMALLOC_ENABLED
+
+// Returns a random number of bytes to allocate before the next sample, exponentially distributed
+// with the mean of interval, so sampled allocations form a Poisson process over allocated bytes.
+int64_t NextSampleDistance(ThreadSamplerState* state, int64_t interval) {
+  if (state->random_state == 0) {
+    state->random_state = reinterpret_cast<uintptr_t>(state) | 1;
+  }
+  // xorshift64*, it does not allocate and does not need locking.
+  state->random_state ^= state->random_state >> 12;
+  state->random_state ^= state->random_state << 25;
+  state->random_state ^= state->random_state >> 27;
+  const uint64_t random = state->random_state * 2685821657736338717ULL;
+  // Uniform in (0, 1].
+  const double uniform = ((random >> 11) + 1) * (1.0 / (1ULL << 53));
+  return std::max<int64_t>(1, -std::log(uniform) * interval);
+}
+
+void SampleAllocation(size_t size) {
+  auto& state = thread_sampler_state;
+  if (state.tracker == nullptr || state.in_sampler || size == 0) {
+    return;
+  }
+  state.bytes_until_sample -= size;
+  if (state.bytes_until_sample > 0) {
+    return;
+  }
+  const int64_t interval = sampling_interval_bytes.load(std::memory_order_relaxed);
+  if (interval <= 0) {
+    return;
+  }
+  SamplerGuard guard;
+  state.bytes_until_sample = NextSampleDistance(&state, interval);
+
+  // Allocation of size bytes is sampled with probability 1 - exp(-size / interval), so it
+  // represents 1 / probability allocations of this size.
+  const double probability = -std::expm1(-static_cast<double>(size) / interval);
+  StackTrace stack;
+  // Skips Collect(), this function and the malloc hook.
+  stack.Collect(3);
+  state.tracker->allocation_samples()->Record(
+      stack, std::llround(size / probability), std::llround(1 / probability));
+}
+
+void AllocationSamplerNewHook(const void* ptr, size_t size) {
+  SampleAllocation(size);
+}
+
+#endif // TCMALLOC_ENABLED
+
+} // namespace
+
+void AllocationSamples::Record(const StackTrace& stack, int64_t bytes, int64_t count) {
+  const uint64_t hash = stack.HashCode();
+  std::lock_guard<std::mutex> lock(mutex_);
+  total_bytes_ += bytes;
+  auto it = stacks_.find(hash);
+  if (it == stacks_.end()) {
+    if (stacks_.size() >= kMaxStacksPerTracker) {
+      other_.bytes += bytes;
+      other_.count += count;
+      return;
+    }
+    it = stacks_.emplace(hash, AllocationStack()).first;
+    it->second.stack.CopyFrom(stack);
+  }
+  it->second.bytes += bytes;
+  it->second.count += count;
+}
+
+std::vector<AllocationStack> AllocationSamples::Top(size_t limit) const {
+  // Allocations below are made while holding the mutex, so they should not be sampled.
+  SamplerGuard guard;
+  std::vector<AllocationStack> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(stacks_.size() + 1);
+    for (const auto& entry : stacks_) {
+      result.push_back(entry.second);
+    }
+    if (other_.count) {
+      result.push_back(other_);
+    }
+  }
+  auto middle = result.begin() + std::min(limit, result.size());
+  std::partial_sort(
+      result.begin(), middle, result.end(),
+      [](const AllocationStack& lhs, const AllocationStack& rhs) { return lhs.bytes > rhs.bytes; });
+  result.erase(middle, result.end());
+  return result;
+}
+
+int64_t AllocationSamples::total_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_bytes_;
+}
+
+void AllocationSamples::Reset() {
+  SamplerGuard guard;
+  std::lock_guard<std::mutex> lock(mutex_);
+  stacks_.clear();
+  other_ = AllocationStack();
+  total_bytes_ = 0;
+}
+
+ScopedAllocationAttribution::ScopedAllocationAttribution(MemTracker* tracker)
+    : previous_(thread_sampler_state.tracker) {
+  if (tracker) {
+    thread_sampler_state.tracker = tracker;
+  }
+}
+
+ScopedAllocationAttribution::~ScopedAllocationAttribution() {
+  thread_sampler_state.tracker = previous_;
+}
+
+MemTracker* CurrentAllocationTracker() {
+  return thread_sampler_state.tracker;
+}
+
+Status StartAllocationSampling(int64_t interval_bytes) {
+  if (interval_bytes <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Invalid sampling interval: $0", interval_bytes);
+  }
+#ifdef TCMALLOC_ENABLED
+  if (sampling_interval_bytes.exchange(interval_bytes) == 0) {
+    if (!MallocHook::AddNewHook(&AllocationSamplerNewHook)) {
+      sampling_interval_bytes = 0;
+      return STATUS(IllegalState, "Failed to add malloc hook");
+    }
+  }
+  LOG(INFO) << "Sampling allocations once per " << interval_bytes << " bytes";
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Allocation sampling requires tcmalloc");
+#endif
+}
+
+void StopAllocationSampling() {
+#ifdef TCMALLOC_ENABLED
+  if (sampling_interval_bytes.exchange(0) != 0) {
+    MallocHook::RemoveNewHook(&AllocationSamplerNewHook);
+  }
+#endif
+}
+
+int64_t AllocationSamplingInterval() {
+  return sampling_interval_bytes.load(std::memory_order_relaxed);
+}
+
+} // namespace yb
@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_ALLOCATION_SAMPLER_H
+#define YB_UTIL_ALLOCATION_SAMPLER_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/util/debug-util.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class MemTracker;
+
+// Stack that allocated memory, with the estimated number of bytes and allocations made from it.
+struct AllocationStack {
+  StackTrace stack;
+  int64_t bytes = 0;
+  int64_t count = 0;
+};
+
+// Sampled allocations attributed to a single MemTracker. This class is thread-safe.
+//
+// Only allocations are recorded, freed memory is not tracked, so samples show where the memory
+// of a tracker was allocated since sampling was started or reset.
+class AllocationSamples {
+ public:
+  void Record(const StackTrace& stack, int64_t bytes, int64_t count);
+
+  // Returns up to limit stacks that allocated most bytes, in descending order of bytes.
+  std::vector<AllocationStack> Top(size_t limit) const;
+
+  // Estimated total bytes allocated, including stacks that are not kept.
+  int64_t total_bytes() const;
+
+  void Reset();
+
+ private:
+  mutable std::mutex mutex_;
+  // Stacks by their hash codes.
+  std::unordered_map<uint64_t, AllocationStack> stacks_;
+  // Allocations from stacks that were not kept because of the limit on the number of stacks.
+  AllocationStack other_;
+  int64_t total_bytes_ = 0;
+};
+
+// Allocations made by the current thread while this object is alive are attributed to the
+// tracker by the allocation sampler. Scopes could be nested, a null tracker keeps the current
+// attribution.
+//
+// The tracker should outlive the scope.
+class ScopedAllocationAttribution {
+ public:
+  explicit ScopedAllocationAttribution(MemTracker* tracker);
+  ~ScopedAllocationAttribution();
+
+  ScopedAllocationAttribution(const ScopedAllocationAttribution&) = delete;
+  void operator=(const ScopedAllocationAttribution&) = delete;
+
+ private:
+  MemTracker* previous_;
+};
+
+// Returns the tracker the allocations of the current thread are attributed to, could be null.
+MemTracker* CurrentAllocationTracker();
+
+// Starts sampling allocations made within ScopedAllocationAttribution, so that on average one
+// allocation is sampled per interval_bytes allocated by a thread. Allocations outside of such
+// scopes only pay for a thread local check.
+//
+// Requires tcmalloc, returns NotSupported otherwise.
+CHECKED_STATUS StartAllocationSampling(int64_t interval_bytes);
+
+void StopAllocationSampling();
+
+// Returns the current sampling interval, 0 when sampling is not started.
+int64_t AllocationSamplingInterval();
+
+} // namespace yb
+
+#endif // YB_UTIL_ALLOCATION_SAMPLER_H
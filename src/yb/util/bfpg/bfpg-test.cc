@@ -401,5 +401,67 @@ TEST_F(BfPgsqlTest, TestErroneousFuncCalls) {
   ASSERT_NOK(BFCompileApiTest::FindPgsqlOpcode("+", params, &opcode, &bfdecl, result));
 }
 
+// Test comparison and logical operators that are used in WHERE conditions.
+TEST_F(BfPgsqlTest, TestComparisonAndLogicalOperators) {
+  BFOpcode opcode;
+  const BFDecl *bfdecl;
+
+  BFTestValue::SharedPtr result = make_shared<BFTestValue>();
+  BFTestValue::SharedPtr param0 = make_shared<BFTestValue>();
+  BFTestValue::SharedPtr param1 = make_shared<BFTestValue>();
+  vector<BFTestValue::SharedPtr> params = { param0, param1 };
+
+  // Numbers of different types are compared by value.
+  param0->set_ql_type_id(DataType::INT32);
+  param0->set_int32_value(5);
+  param1->set_ql_type_id(DataType::INT64);
+  param1->set_int64_value(7);
+  ASSERT_OK(BFCompileApiTest::FindPgsqlOpcode("<", params, &opcode, &bfdecl, result));
+  ASSERT_OK(BFExecApiTest::ExecPgsqlOpcode(opcode, params, result));
+  ASSERT_TRUE(result->bool_value());
+
+  ASSERT_OK(BFCompileApiTest::FindPgsqlOpcode(">=", params, &opcode, &bfdecl, result));
+  ASSERT_OK(BFExecApiTest::ExecPgsqlOpcode(opcode, params, result));
+  ASSERT_FALSE(result->bool_value());
+
+  param1->set_ql_type_id(DataType::DOUBLE);
+  param1->set_double_value(5.0);
+  ASSERT_OK(BFCompileApiTest::FindPgsqlOpcode("==", params, &opcode, &bfdecl, result));
+  ASSERT_OK(BFExecApiTest::ExecPgsqlOpcode(opcode, params, result));
+  ASSERT_TRUE(result->bool_value());
+
+  // Comparison with null is null.
+  param1->SetNull();
+  ASSERT_OK(BFCompileApiTest::FindPgsqlOpcode("<>", params, &opcode, &bfdecl, result));
+  ASSERT_OK(BFExecApiTest::ExecPgsqlOpcode(opcode, params, result));
+  ASSERT_TRUE(result->IsNull());
+
+  // Values of different non numeric types cannot be compared.
+  param1->set_ql_type_id(DataType::STRING);
+  param1->set_string_value("5");
+  ASSERT_OK(BFCompileApiTest::FindPgsqlOpcode("<", params, &opcode, &bfdecl, result));
+  ASSERT_NOK(BFExecApiTest::ExecPgsqlOpcode(opcode, params, result));
+
+  // Logical operators use three-valued logic.
+  param0->set_ql_type_id(DataType::BOOL);
+  param0->set_bool_value(false);
+  param1->set_ql_type_id(DataType::BOOL);
+  param1->SetNull();
+  result->set_ql_type_id(DataType::UNKNOWN_DATA);
+  ASSERT_OK(BFCompileApiTest::FindPgsqlOpcode("and", params, &opcode, &bfdecl, result));
+  ASSERT_OK(BFExecApiTest::ExecPgsqlOpcode(opcode, params, result));
+  ASSERT_FALSE(result->IsNull());
+  ASSERT_FALSE(result->bool_value());
+
+  ASSERT_OK(BFCompileApiTest::FindPgsqlOpcode("or", params, &opcode, &bfdecl, result));
+  ASSERT_OK(BFExecApiTest::ExecPgsqlOpcode(opcode, params, result));
+  ASSERT_TRUE(result->IsNull());
+
+  vector<BFTestValue::SharedPtr> not_params = { param0 };
+  ASSERT_OK(BFCompileApiTest::FindPgsqlOpcode("not", not_params, &opcode, &bfdecl, result));
+  ASSERT_OK(BFExecApiTest::ExecPgsqlOpcode(opcode, not_params, result));
+  ASSERT_TRUE(result->bool_value());
+}
+
 } // namespace bfpg
 } // namespace yb
@@ -142,12 +142,133 @@ Status SubDoubleDouble(PTypePtr x, PTypePtr y, RTypePtr result) {
 
 //--------------------------------------------------------------------------------------------------
 // Comparison.
+// Arguments of comparison are not casted by the analyzer, so numbers of different types are
+// compared by value here. Other values must be of the same type.
+inline bool IsIntegerValue(const QLValuePB& v) {
+  switch (v.value_case()) {
+    case QLValuePB::kInt8Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt16Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt32Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt64Value:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline int64_t IntegerValue(const QLValuePB& v) {
+  switch (v.value_case()) {
+    case QLValuePB::kInt8Value: return v.int8_value();
+    case QLValuePB::kInt16Value: return v.int16_value();
+    case QLValuePB::kInt32Value: return v.int32_value();
+    default: return v.int64_value();
+  }
+}
+
+inline bool IsFloatingValue(const QLValuePB& v) {
+  return v.value_case() == QLValuePB::kFloatValue || v.value_case() == QLValuePB::kDoubleValue;
+}
+
+inline double NumericValue(const QLValuePB& v) {
+  switch (v.value_case()) {
+    case QLValuePB::kFloatValue: return v.float_value();
+    case QLValuePB::kDoubleValue: return v.double_value();
+    default: return IntegerValue(v);
+  }
+}
+
+template <class T>
+int CompareNumbers(T lhs, T rhs) {
+  return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+}
+
+// Compares two values, predicate is invoked with the comparison result. As in SQL, comparison
+// with null is null.
+template<typename PTypePtr, typename RTypePtr, typename Predicate>
+Status CompareValues(PTypePtr x, PTypePtr y, RTypePtr result, const Predicate& predicate) {
+  if (x->IsNull() || y->IsNull()) {
+    result->SetNull();
+    return Status::OK();
+  }
+  const QLValuePB& lhs = x->value();
+  const QLValuePB& rhs = y->value();
+  int cmp;
+  if (IsIntegerValue(lhs) && IsIntegerValue(rhs)) {
+    cmp = CompareNumbers(IntegerValue(lhs), IntegerValue(rhs));
+  } else if ((IsIntegerValue(lhs) || IsFloatingValue(lhs)) &&
+             (IsIntegerValue(rhs) || IsFloatingValue(rhs))) {
+    cmp = CompareNumbers(NumericValue(lhs), NumericValue(rhs));
+  } else if (Comparable(lhs, rhs)) {
+    cmp = Compare(lhs, rhs);
+  } else {
+    return STATUS(InvalidArgument, "Cannot compare values of different datatypes");
+  }
+  result->set_bool_value(predicate(cmp));
+  return Status::OK();
+}
+
 template<typename PTypePtr, typename RTypePtr>
 Status Equal(PTypePtr x, PTypePtr y, RTypePtr result) {
-  if (x->IsNull() || y->IsNull()) {
+  return CompareValues(x, y, result, [](int cmp) { return cmp == 0; });
+}
+
+template<typename PTypePtr, typename RTypePtr>
+Status NotEqual(PTypePtr x, PTypePtr y, RTypePtr result) {
+  return CompareValues(x, y, result, [](int cmp) { return cmp != 0; });
+}
+
+template<typename PTypePtr, typename RTypePtr>
+Status LessThan(PTypePtr x, PTypePtr y, RTypePtr result) {
+  return CompareValues(x, y, result, [](int cmp) { return cmp < 0; });
+}
+
+template<typename PTypePtr, typename RTypePtr>
+Status LessThanOrEqual(PTypePtr x, PTypePtr y, RTypePtr result) {
+  return CompareValues(x, y, result, [](int cmp) { return cmp <= 0; });
+}
+
+template<typename PTypePtr, typename RTypePtr>
+Status GreaterThan(PTypePtr x, PTypePtr y, RTypePtr result) {
+  return CompareValues(x, y, result, [](int cmp) { return cmp > 0; });
+}
+
+template<typename PTypePtr, typename RTypePtr>
+Status GreaterThanOrEqual(PTypePtr x, PTypePtr y, RTypePtr result) {
+  return CompareValues(x, y, result, [](int cmp) { return cmp >= 0; });
+}
+
+//--------------------------------------------------------------------------------------------------
+// Logical operators use SQL three-valued logic, where null means unknown.
+template<typename PTypePtr, typename RTypePtr>
+Status And(PTypePtr x, PTypePtr y, RTypePtr result) {
+  if ((!x->IsNull() && !x->bool_value()) || (!y->IsNull() && !y->bool_value())) {
+    result->set_bool_value(false);
+  } else if (x->IsNull() || y->IsNull()) {
+    result->SetNull();
+  } else {
+    result->set_bool_value(true);
+  }
+  return Status::OK();
+}
+
+template<typename PTypePtr, typename RTypePtr>
+Status Or(PTypePtr x, PTypePtr y, RTypePtr result) {
+  if ((!x->IsNull() && x->bool_value()) || (!y->IsNull() && y->bool_value())) {
+    result->set_bool_value(true);
+  } else if (x->IsNull() || y->IsNull()) {
+    result->SetNull();
+  } else {
     result->set_bool_value(false);
+  }
+  return Status::OK();
+}
+
+template<typename PTypePtr, typename RTypePtr>
+Status Not(PTypePtr x, RTypePtr result) {
+  if (x->IsNull()) {
+    result->SetNull();
   } else {
-    result->set_bool_value(x->value() == y->value());
+    result->set_bool_value(!x->bool_value());
   }
   return Status::OK();
 }
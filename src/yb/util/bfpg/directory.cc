@@ -147,8 +147,18 @@ const vector<BFDecl> kBFDirectory = {
   { "SubI64I64", "-", INT64, {INT64, INT64} },
   { "SubDoubleDouble", "-", DOUBLE, {DOUBLE, DOUBLE} },
 
-  // "=="
+  // Comparison.
   { "Equal", "==", BOOL, {ANYTYPE, ANYTYPE} },
+  { "NotEqual", "<>", BOOL, {ANYTYPE, ANYTYPE} },
+  { "LessThan", "<", BOOL, {ANYTYPE, ANYTYPE} },
+  { "LessThanOrEqual", "<=", BOOL, {ANYTYPE, ANYTYPE} },
+  { "GreaterThan", ">", BOOL, {ANYTYPE, ANYTYPE} },
+  { "GreaterThanOrEqual", ">=", BOOL, {ANYTYPE, ANYTYPE} },
+
+  // Logical operators.
+  { "And", "and", BOOL, {BOOL, BOOL} },
+  { "Or", "or", BOOL, {BOOL, BOOL} },
+  { "Not", "not", BOOL, {BOOL} },
 };
 
 } // namespace bfpg
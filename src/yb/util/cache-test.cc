@@ -33,7 +33,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include <glog/logging.h>
@@ -252,6 +254,37 @@ TEST_P(CacheTest, HeavyEntries) {
   ASSERT_LE(cached_weight, kCacheSize + kCacheSize/10);
 }
 
+TEST_P(CacheTest, ConcurrentLookups) {
+  constexpr int kNumKeys = 1000;
+  constexpr int kNumThreads = 8;
+  constexpr int kLookupsPerThread = 200000;
+  for (int i = 0; i != kNumKeys; ++i) {
+    Insert(i, i + 1000);
+  }
+
+  std::atomic<int> misses(0);
+  std::vector<std::thread> threads;
+  auto start = MonoTime::Now();
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t, &misses] {
+      for (int i = 0; i != kLookupsPerThread; ++i) {
+        // All threads hit the same hot keys, so they contend on the same shards.
+        const int key = (i * 7 + t) % kNumKeys;
+        if (Lookup(key) != key + 1000) {
+          ++misses;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto passed = MonoTime::Now() - start;
+  LOG(INFO) << kNumThreads * kLookupsPerThread << " lookups in " << passed << ", "
+            << kNumThreads * kLookupsPerThread / passed.ToSeconds() << " lookups/s";
+  ASSERT_EQ(0, misses.load());
+}
+
 TEST_P(CacheTest, NewId) {
   uint64_t a = cache_->NewId();
   uint64_t b = cache_->NewId();
@@ -74,7 +74,10 @@ typedef simple_spinlock MutexType;
 // LRU cache implementation
 
 // An entry is a variable length heap-allocated structure.  Entries
-// are kept in a circular doubly linked list ordered by access time.
+// are kept in a circular doubly linked list, that is used as the ring of CLOCK algorithm:
+// lookups only set the referenced bit of an entry, and eviction gives referenced entries
+// a second chance by moving them to the end of the list. So lookups don't modify the list and
+// could run concurrently.
 struct LRUHandle {
   void* value;
   CacheDeleter* deleter;
@@ -84,6 +87,7 @@ struct LRUHandle {
   size_t charge;      // TODO(opt): Only allow uint32_t?
   size_t key_length;
   Atomic32 refs;
+  Atomic32 referenced; // Set by lookups, cleared by eviction.
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
   uint8_t key_data[1];   // Beginning of key
 
@@ -206,6 +210,10 @@ class LRUCache {
  private:
   void LRU_Remove(LRUHandle* e);
   void LRU_Append(LRUHandle* e);
+  // Makes room for new entries, by removing unreferenced entries from the head of the list, until
+  // usage fits the capacity. Referenced entries get their bit cleared and are moved to the tail.
+  // Removed entries, whose last reference was dropped, are prepended to *to_remove_head.
+  void EvictUnlocked(LRUHandle** to_remove_head);
   // Just reduce the reference count by 1.
   // Return true if last reference
   bool Unref(LRUHandle* e);
@@ -215,8 +223,9 @@ class LRUCache {
   // Initialized before use.
   size_t capacity_;
 
-  // mutex_ protects the following state.
-  MutexType mutex_;
+  // mutex_ protects the following state. Lookups lock it in shared mode, since they only
+  // set the referenced bit of the found entry.
+  rw_spinlock mutex_;
   size_t usage_;
 
   // Dummy head of LRU list.
@@ -284,12 +293,14 @@ void LRUCache::LRU_Append(LRUHandle* e) {
 Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, bool caching) {
   LRUHandle* e;
   {
-    std::lock_guard<MutexType> l(mutex_);
+    shared_lock<rw_spinlock> l(mutex_);
     e = table_.Lookup(key, hash);
     if (e != nullptr) {
       base::RefCountInc(&e->refs);
-      LRU_Remove(e);
-      LRU_Append(e);
+      // Avoid dirtying the cache line of hot entries, that already have the bit set.
+      if (!base::subtle::NoBarrier_Load(&e->referenced)) {
+        base::subtle::NoBarrier_Store(&e->referenced, 1);
+      }
     }
   }
 
@@ -337,6 +348,8 @@ Cache::Handle* LRUCache::Insert(
   e->key_length = key.size();
   e->hash = hash;
   e->refs = 2;  // One from LRUCache, one for the returned handle
+  // New entry gets a second chance, like in the LRU the newest entry is evicted last.
+  e->referenced = 1;
   memcpy(e->key_data, key.data(), key.size());
   mem_tracker_->Consume(charge);
   if (PREDICT_TRUE(metrics_)) {
@@ -345,7 +358,7 @@ Cache::Handle* LRUCache::Insert(
   }
 
   {
-    std::lock_guard<MutexType> l(mutex_);
+    std::lock_guard<rw_spinlock> l(mutex_);
 
     LRU_Append(e);
 
@@ -358,15 +371,7 @@ Cache::Handle* LRUCache::Insert(
       }
     }
 
-    while (usage_ > capacity_ && lru_.next != &lru_) {
-      LRUHandle* old = lru_.next;
-      LRU_Remove(old);
-      table_.Remove(old->key(), old->hash);
-      if (Unref(old)) {
-        old->next = to_remove_head;
-        to_remove_head = old;
-      }
-    }
+    EvictUnlocked(&to_remove_head);
   }
 
   // we free the entries here outside of mutex for
@@ -380,11 +385,31 @@ Cache::Handle* LRUCache::Insert(
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
+void LRUCache::EvictUnlocked(LRUHandle** to_remove_head) {
+  // Lookups are blocked while we hold the exclusive lock, so every entry has its bit cleared at
+  // most once, and the loop finishes in at most two passes over the list.
+  while (usage_ > capacity_ && lru_.next != &lru_) {
+    LRUHandle* old = lru_.next;
+    if (base::subtle::NoBarrier_Load(&old->referenced)) {
+      base::subtle::NoBarrier_Store(&old->referenced, 0);
+      LRU_Remove(old);
+      LRU_Append(old);
+      continue;
+    }
+    LRU_Remove(old);
+    table_.Remove(old->key(), old->hash);
+    if (Unref(old)) {
+      old->next = *to_remove_head;
+      *to_remove_head = old;
+    }
+  }
+}
+
 void LRUCache::Erase(const Slice& key, uint32_t hash) {
   LRUHandle* e;
   bool last_reference = false;
   {
-    std::lock_guard<MutexType> l(mutex_);
+    std::lock_guard<rw_spinlock> l(mutex_);
     e = table_.Remove(key, hash);
     if (e != nullptr) {
       LRU_Remove(e);
@@ -51,7 +51,8 @@ enum CacheType {
 };
 
 // Create a new cache with a fixed size capacity.  This implementation
-// of Cache uses a least-recently-used eviction policy.
+// of Cache uses CLOCK eviction policy, that approximates least-recently-used, while
+// allowing concurrent lookups.
 Cache* NewLRUCache(CacheType type, size_t capacity, const std::string& id);
 
 // Callback interface for deleting a value stored in the cache.
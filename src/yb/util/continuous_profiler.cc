@@ -0,0 +1,208 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/continuous_profiler.h"
+
+#include <signal.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+#include "yb/util/debug-util.h"
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(continuous_profiler_frequency_hz, 0,
+             "Frequency of CPU samples taken by the continuous profiler, whose results are "
+             "available at /profilez. 0 disables the profiler. Low values, like 10, have "
+             "negligible overhead.");
+TAG_FLAG(continuous_profiler_frequency_hz, advanced);
+
+namespace yb {
+
+namespace {
+
+constexpr size_t kMaxSamples = 16384;
+
+struct Sample {
+  // Odd while the sample is being written, so readers could detect torn samples.
+  std::atomic<uint64_t> version{0};
+  int64_t time_nanos;
+  ProfilerTag tag;
+  StackTrace stack;
+};
+
+Sample g_samples[kMaxSamples];
+std::atomic<uint64_t> g_next_sample{0};
+std::atomic<bool> g_running{false};
+
+__thread ProfilerTag tls_tag;
+
+int64_t MonotonicNanos() {
+  // clock_gettime is async-signal safe.
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void HandleProfilerSignal(int signum) {
+  const int saved_errno = errno;
+  auto& sample = g_samples[g_next_sample.fetch_add(1, std::memory_order_relaxed) % kMaxSamples];
+  sample.version.fetch_add(1, std::memory_order_acq_rel);
+  sample.time_nanos = MonotonicNanos();
+  memcpy(&sample.tag, &tls_tag, sizeof(tls_tag));
+  // Skip the handler and the signal trampoline.
+  sample.stack.Collect(2);
+  sample.version.fetch_add(1, std::memory_order_release);
+  errno = saved_errno;
+}
+
+void CopyTagString(const std::string& value, char* out, size_t size) {
+  const size_t len = std::min(value.size(), size - 1);
+  memcpy(out, value.data(), len);
+  out[len] = 0;
+}
+
+std::string FrameName(void* pc, std::unordered_map<void*, std::string>* cache) {
+  auto it = cache->find(pc);
+  if (it != cache->end()) {
+    return it->second;
+  }
+  std::string name = SymbolizeAddress(pc, StackTraceLineFormat::SYMBOL_ONLY);
+  // Folded format uses ';' as separator and a space before the count.
+  while (!name.empty() && isspace(name.back())) {
+    name.pop_back();
+  }
+  for (auto& c : name) {
+    if (c == ';' || c == '\n') {
+      c = ':';
+    }
+  }
+  return cache->emplace(pc, std::move(name)).first->second;
+}
+
+} // namespace
+
+Status StartContinuousProfilerIfEnabled() {
+  const int frequency = FLAGS_continuous_profiler_frequency_hz;
+  if (frequency <= 0 || g_running.load(std::memory_order_acquire)) {
+    return Status::OK();
+  }
+#if defined(__linux__)
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (g_running.load(std::memory_order_acquire)) {
+    return Status::OK();
+  }
+  // SIGPROF is used by the on demand gperftools profiler, so use a real time signal.
+  const int signum = SIGRTMIN + 2;
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = &HandleProfilerSignal;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(signum, &action, nullptr) != 0) {
+    return STATUS(RuntimeError, "Failed to install profiler signal handler", ErrnoToString(errno));
+  }
+
+  // Signal of a timer on process CPU time is usually delivered to the thread that is running,
+  // so idle threads are rarely interrupted.
+  struct sigevent event;
+  memset(&event, 0, sizeof(event));
+  event.sigev_notify = SIGEV_SIGNAL;
+  event.sigev_signo = signum;
+  timer_t timer;
+  if (timer_create(CLOCK_PROCESS_CPUTIME_ID, &event, &timer) != 0) {
+    return STATUS(RuntimeError, "Failed to create profiler timer", ErrnoToString(errno));
+  }
+  struct itimerspec spec;
+  spec.it_interval.tv_sec = 0;
+  spec.it_interval.tv_nsec = 1000000000L / std::min(frequency, 1000);
+  spec.it_value = spec.it_interval;
+  if (timer_settime(timer, 0, &spec, nullptr) != 0) {
+    return STATUS(RuntimeError, "Failed to start profiler timer", ErrnoToString(errno));
+  }
+  g_running.store(true, std::memory_order_release);
+  LOG(INFO) << "Started continuous profiler at " << frequency << " Hz";
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Continuous profiler is supported only on Linux");
+#endif
+}
+
+bool ContinuousProfilerRunning() {
+  return g_running.load(std::memory_order_acquire);
+}
+
+void WriteContinuousProfile(MonoDelta period, std::ostream* out) {
+  const int64_t min_time = MonotonicNanos() - period.ToNanoseconds();
+  std::map<std::string, size_t> stacks;
+  std::unordered_map<void*, std::string> frame_names;
+  Sample sample;
+  for (auto& source : g_samples) {
+    const uint64_t version = source.version.load(std::memory_order_acquire);
+    if (version == 0 || (version & 1)) {
+      continue;
+    }
+    sample.time_nanos = source.time_nanos;
+    sample.tag = source.tag;
+    sample.stack.CopyFrom(source.stack);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (source.version.load(std::memory_order_relaxed) != version ||
+        sample.time_nanos < min_time) {
+      continue;
+    }
+    std::string key = sample.tag.method[0] ? sample.tag.method : "<no method>";
+    key += ';';
+    key += sample.tag.tablet_id[0] ? sample.tag.tablet_id : "<no tablet>";
+    for (int i = sample.stack.num_frames(); i-- > 0;) {
+      key += ';';
+      key += FrameName(sample.stack.frame(i), &frame_names);
+    }
+    ++stacks[key];
+  }
+  for (const auto& entry : stacks) {
+    *out << entry.first << " " << entry.second << "\n";
+  }
+}
+
+ScopedProfilerTag::ScopedProfilerTag(const std::string& method)
+    : active_(ContinuousProfilerRunning()) {
+  if (active_) {
+    saved_ = tls_tag;
+    CopyTagString(method, tls_tag.method, sizeof(tls_tag.method));
+    tls_tag.tablet_id[0] = 0;
+  }
+}
+
+ScopedProfilerTag::~ScopedProfilerTag() {
+  if (active_) {
+    tls_tag = saved_;
+  }
+}
+
+void SetProfilerTabletId(const std::string& tablet_id) {
+  if (ContinuousProfilerRunning()) {
+    CopyTagString(tablet_id, tls_tag.tablet_id, sizeof(tls_tag.tablet_id));
+  }
+}
+
+} // namespace yb
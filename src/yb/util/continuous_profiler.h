@@ -0,0 +1,69 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CONTINUOUS_PROFILER_H
+#define YB_UTIL_CONTINUOUS_PROFILER_H
+
+#include <iosfwd>
+#include <string>
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+// Low frequency CPU profiler, that could be left running in production. The process CPU time
+// timer sends a signal to the running thread, and its handler records the stack and the tag of
+// the thread (RPC method and tablet) into a fixed size ring of samples. Samples are aggregated
+// only when the profile is requested.
+
+// Starts the profiler, if it is enabled by continuous_profiler_frequency_hz. Does nothing when it
+// is already started.
+CHECKED_STATUS StartContinuousProfilerIfEnabled();
+
+bool ContinuousProfilerRunning();
+
+// Writes samples taken during the last 'period' in folded stacks format, accepted by flame graph
+// tools: one line per distinct stack, that starts with the method and tablet tags, followed by
+// frames starting from the outermost one and the number of samples.
+void WriteContinuousProfile(MonoDelta period, std::ostream* out);
+
+// Tag of samples taken on a thread. Strings are copied into fixed size arrays, so the signal
+// handler could copy them without synchronization with the string owners.
+struct ProfilerTag {
+  char method[64];
+  char tablet_id[40];
+};
+
+// Tags samples of the current thread with the RPC method for the lifetime of this object.
+// The previous tag is restored on destruction.
+class ScopedProfilerTag {
+ public:
+  explicit ScopedProfilerTag(const std::string& method);
+  ~ScopedProfilerTag();
+
+  ScopedProfilerTag(const ScopedProfilerTag&) = delete;
+  void operator=(const ScopedProfilerTag&) = delete;
+
+ private:
+  bool active_;
+  ProfilerTag saved_;
+};
+
+// Adds the tablet id to the tag of the current thread, until the enclosing ScopedProfilerTag is
+// destroyed.
+void SetProfilerTabletId(const std::string& tablet_id);
+
+} // namespace yb
+
+#endif // YB_UTIL_CONTINUOUS_PROFILER_H
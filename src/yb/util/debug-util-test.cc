@@ -40,6 +40,7 @@
 #include <glog/stl_logging.h>
 
 #include "yb/gutil/ref_counted.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/test_util.h"
@@ -48,6 +49,8 @@
 using std::string;
 using std::vector;
 
+DECLARE_int32(continuous_profiler_frequency_hz);
+
 namespace yb {
 
 class DebugUtilTest : public YBTest {
@@ -247,4 +250,27 @@ TEST_F(DebugUtilTest, TestConcurrentStackTrace) {
 }
 #endif
 
+#if defined(__linux__)
+TEST_F(DebugUtilTest, TestContinuousProfiler) {
+  FLAGS_continuous_profiler_frequency_hz = 100;
+  ASSERT_OK(StartContinuousProfilerIfEnabled());
+  ASSERT_TRUE(ContinuousProfilerRunning());
+
+  {
+    ScopedProfilerTag tag("TestMethod");
+    SetProfilerTabletId("test-tablet");
+    auto deadline = MonoTime::Now() + MonoDelta::FromSeconds(1);
+    volatile uint64_t value = 0;
+    while (MonoTime::Now() < deadline) {
+      value = value * 31 + 7;
+    }
+  }
+
+  std::stringstream out;
+  WriteContinuousProfile(MonoDelta::FromSeconds(60), &out);
+  LOG(INFO) << "Profile: " << out.str();
+  ASSERT_STR_CONTAINS(out.str(), "TestMethod;test-tablet;");
+}
+#endif
+
 } // namespace yb
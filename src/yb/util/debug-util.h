@@ -177,6 +177,14 @@ class StackTrace {
 
   uint64_t HashCode() const;
 
+  int num_frames() const {
+    return num_frames_;
+  }
+
+  void* frame(int i) const {
+    return frames_[i];
+  }
+
  private:
   enum {
     // The maximum number of stack frames to collect.
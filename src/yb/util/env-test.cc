@@ -33,8 +33,10 @@
 #include <fcntl.h>
 #include <sys/types.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
@@ -209,7 +211,7 @@ class TestEnv : public YBTest, public ::testing::WithParamInterface<bool> {
         if (!fast) {
           // Verify as write. Note: this requires that file is pre-allocated, otherwise
           // the ReadFully() fails with EINVAL.
-          if (opts.o_direct) {
+          if (opts.o_direct || opts.use_io_uring) {
             ASSERT_OK(file->Sync());
           }
           ASSERT_NO_FATALS(ReadAndVerifyTestData(raf.get(), num_slices * slice_size * i,
@@ -520,6 +522,26 @@ TEST_F(TestEnv, TestReadFully) {
   ASSERT_STR_CONTAINS(status.ToString(), "EOF");
 }
 
+TEST_F(TestEnv, TestReadUncached) {
+  Env* env = Env::Default();
+  const string test_file = GetTestPath("test");
+  const int kFileSize = 1024 * 1024 + 11;
+  ASSERT_NO_FATALS(WriteTestFile(env, test_file, kFileSize));
+  gscoped_ptr<RandomAccessFile> readable_file;
+  ASSERT_OK(env->NewRandomAccessFile(test_file, &readable_file));
+
+  // Reads that are not aligned to pages, including the tail of the file.
+  for (uint64_t offset : {0, 1000, 4096, 100000, kFileSize - 5000}) {
+    const size_t length = std::min<size_t>(70000, kFileSize - offset);
+    gscoped_ptr<uint8_t[]> scratch(new uint8_t[length]);
+    Slice s;
+    ASSERT_OK(env_util::ReadFully(readable_file.get(), offset, length, &s, scratch.get(),
+                                  true /* uncached */));
+    ASSERT_EQ(length, s.size());
+    ASSERT_NO_FATALS(VerifyTestData(s, offset));
+  }
+}
+
 TEST_P(TestEnv, TestAppendVector) {
   WritableFileOptions opts;
   opts.o_direct = GetParam();
@@ -543,6 +565,45 @@ TEST_F(TestEnv, TestRandomData) {
   ASSERT_NO_FATALS(TestAppendRandomData(true, opts));
 }
 
+TEST_F(TestEnv, TestIoUringWritableFile) {
+  // When the kernel does not support io_uring, the file falls back to synchronous writes, and the
+  // test still checks the same contract.
+  WritableFileOptions opts;
+  opts.use_io_uring = true;
+  ASSERT_NO_FATALS(TestAppendRandomData(true, opts));
+  ASSERT_NO_FATALS(TestAppendVector(2000, 1024, 5, true, false, opts));
+  if (fallocate_supported_) {
+    // Reads written data after Sync.
+    ASSERT_NO_FATALS(TestAppendVector(128, 4096, 5, false, true, opts));
+  }
+}
+
+// Checks that data of appends is readable through another file after WaitForAppends, without
+// syncing the file.
+TEST_F(TestEnv, TestIoUringWaitForAppends) {
+  const string path = GetTestPath("io_uring_wait_for_appends");
+  WritableFileOptions opts;
+  opts.use_io_uring = true;
+  gscoped_ptr<WritableFile> writer;
+  ASSERT_OK(env_->NewWritableFile(opts, path, &writer));
+
+  string expected;
+  for (int i = 0; i != 100; ++i) {
+    string data = Format("chunk $0;", i);
+    ASSERT_OK(writer->Append(data));
+    expected += data;
+  }
+  ASSERT_OK(writer->WaitForAppends());
+
+  gscoped_ptr<RandomAccessFile> reader;
+  ASSERT_OK(env_->NewRandomAccessFile(path, &reader));
+  Slice result;
+  gscoped_ptr<uint8_t[]> scratch(new uint8_t[expected.size()]);
+  ASSERT_OK(reader->Read(0, expected.size(), &result, scratch.get()));
+  ASSERT_EQ(expected, result.ToBuffer());
+  ASSERT_OK(writer->Close());
+}
+
 TEST_F(TestEnv, TestGetExecutablePath) {
   string p;
   ASSERT_OK(Env::Default()->GetExecutablePath(&p));
@@ -810,6 +871,37 @@ TEST_F(TestEnv, TestCopyFile) {
   ASSERT_NO_FATALS(ReadAndVerifyTestData(copy.get(), 0, kFileSize));
 }
 
+// Concurrent syncs of the same directory are coalesced, every caller should still get the result.
+TEST_F(TestEnv, TestConcurrentSyncDir) {
+  Env* env = Env::Default();
+  const string dir = GetTestPath("sync_dir");
+  ASSERT_OK(env->CreateDir(dir));
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumSyncsPerThread = 20;
+  std::vector<std::thread> threads;
+  std::atomic<int> failures(0);
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([env, &dir, &failures, i] {
+      for (int j = 0; j != kNumSyncsPerThread; ++j) {
+        gscoped_ptr<WritableFile> file;
+        auto path = JoinPathSegments(dir, strings::Substitute("file_$0_$1", i, j));
+        if (!env->NewWritableFile(path, &file).ok() || !file->Close().ok() ||
+            !env->SyncDir(dir).ok()) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, failures.load());
+
+  // Errors are not hidden by coalescing.
+  ASSERT_NOK(env->SyncDir(GetTestPath("missing_dir")));
+}
+
 INSTANTIATE_TEST_CASE_P(BufferedIO, TestEnv, ::testing::Values(false));
 INSTANTIATE_TEST_CASE_P(DirectIO, TestEnv, ::testing::Values(true));
 
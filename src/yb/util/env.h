@@ -357,6 +357,14 @@ class RandomAccessFile {
   virtual CHECKED_STATUS Read(uint64_t offset, size_t n, Slice* result,
                       uint8_t *scratch) const = 0;
 
+  // Same as Read(), but tries to leave the OS page cache as it was before the read: pages that
+  // were not cached before are dropped from the cache after the read. Used by bulk readers, that
+  // should not evict data of the foreground workload.
+  virtual CHECKED_STATUS ReadUncached(uint64_t offset, size_t n, Slice* result,
+                                      uint8_t *scratch) const {
+    return Read(offset, n, result, scratch);
+  }
+
   // Returns the size of the file
   virtual Result<uint64_t> Size() const = 0;
 
@@ -377,12 +385,17 @@ struct WritableFileOptions {
 
   bool o_direct;
 
+  // Submit writes asynchronously through io_uring, when the kernel supports it. Errors of such
+  // writes are reported by subsequent calls. Ignored when o_direct is set.
+  bool use_io_uring;
+
   // See CreateMode for details.
   Env::CreateMode mode;
 
   WritableFileOptions()
     : sync_on_close(false),
       o_direct(false),
+      use_io_uring(false),
       mode(Env::CREATE_IF_NON_EXISTING_TRUNCATE) { }
 };
 
@@ -429,6 +442,12 @@ class WritableFile {
 
   virtual CHECKED_STATUS Sync() = 0;
 
+  // Waits until data of all previous appends is written to the file, so it could be read through
+  // other file descriptors. Does not make the data durable.
+  virtual CHECKED_STATUS WaitForAppends() {
+    return Status::OK();
+  }
+
   virtual uint64_t Size() const = 0;
 
   // Returns the filename provided when the WritableFile was constructed.
@@ -34,7 +34,12 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include <glog/logging.h>
@@ -49,6 +54,7 @@
 #include "yb/util/env.h"
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/io_uring.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/malloc.h"
@@ -307,6 +313,45 @@ class PosixRandomAccessFile: public RandomAccessFile {
     return s;
   }
 
+#if defined(__linux__)
+  Status ReadUncached(uint64_t offset, size_t n, Slice* result,
+                      uint8_t *scratch) const override {
+    static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+    const uint64_t begin = offset / kPageSize * kPageSize;
+    const size_t length = offset + n - begin;
+    const size_t num_pages = (length + kPageSize - 1) / kPageSize;
+
+    // Mapping the range does not fault its pages in, so it could be used to check which pages
+    // are already cached.
+    std::vector<unsigned char> resident(num_pages);
+    void* addr = n != 0 ? mmap(nullptr, length, PROT_READ, MAP_SHARED, fd_, begin) : MAP_FAILED;
+    if (addr == MAP_FAILED) {
+      return Read(offset, n, result, scratch);
+    }
+    const bool checked = mincore(addr, length, resident.data()) == 0;
+    munmap(addr, length);
+
+    RETURN_NOT_OK(Read(offset, n, result, scratch));
+    if (!checked) {
+      return Status::OK();
+    }
+
+    // Drop runs of pages that were not cached before the read.
+    size_t run_start = 0;
+    for (size_t i = 0; i <= num_pages; ++i) {
+      if (i != num_pages && !(resident[i] & 1)) {
+        continue;
+      }
+      if (i > run_start) {
+        posix_fadvise(fd_, begin + run_start * kPageSize, (i - run_start) * kPageSize,
+                      POSIX_FADV_DONTNEED);
+      }
+      run_start = i + 1;
+    }
+    return Status::OK();
+  }
+#endif
+
   Result<uint64_t> Size() const override {
     TRACE_EVENT1("io", __PRETTY_FUNCTION__, "path", filename_);
     ThreadRestrictions::AssertIOAllowed();
@@ -529,6 +574,157 @@ class PosixWritableFile : public WritableFile {
 };
 
 #if defined(__linux__)
+// Max number of not completed operations of io_uring writable file.
+constexpr uint32_t kIoUringWritableFileQueueDepth = 32;
+
+// Submits writes to io_uring and returns without waiting for them, so the caller could prepare
+// the next write while the kernel copies the previous one. Data is copied, so callers could reuse
+// their buffers. Sync queues a data sync that starts after all submitted writes, and waits for
+// everything, so a group of writes and its sync are issued with a single system call.
+// Errors of background writes are returned by the next call.
+class PosixIoUringWritableFile : public PosixWritableFile {
+ public:
+  PosixIoUringWritableFile(std::string fname, int fd, uint64_t file_size, bool sync_on_close,
+                           std::unique_ptr<IoUring> ring)
+      : PosixWritableFile(std::move(fname), fd, file_size, sync_on_close),
+        ring_(std::move(ring)) {}
+
+  ~PosixIoUringWritableFile() {
+    if (fd_ >= 0) {
+      WARN_NOT_OK(Close(), "Failed to close " + filename_);
+    }
+  }
+
+  Status AppendVector(const vector<Slice>& data_vector) override {
+    ThreadRestrictions::AssertIOAllowed();
+    RETURN_NOT_OK(error_);
+    size_t size = 0;
+    for (const auto& data : data_vector) {
+      size += data.size();
+    }
+    if (size == 0) {
+      return Status::OK();
+    }
+    RETURN_NOT_OK(WaitInFlight(ring_->sq_entries() - 1));
+
+    auto& write = in_flight_writes_[next_write_id_];
+    write.data.reserve(size);
+    for (const auto& data : data_vector) {
+      write.data.append(data.cdata(), data.size());
+    }
+    write.iov.iov_base = &write.data[0];
+    write.iov.iov_len = size;
+    if (!ring_->PrepareWritev(fd_, &write.iov, 1, filesize_, next_write_id_)) {
+      in_flight_writes_.erase(next_write_id_);
+      return STATUS(IllegalState, "io_uring submission queue is full");
+    }
+    ++next_write_id_;
+    filesize_ += size;
+    pending_sync_ = true;
+    RETURN_NOT_OK(ring_->Submit(0));
+    ReapCompletions();
+    return error_;
+  }
+
+  Status Close() override {
+    Status s = WaitInFlight(0);
+    Status close_status = PosixWritableFile::Close();
+    return s.ok() ? close_status : s;
+  }
+
+  Status Flush(FlushMode mode) override {
+    RETURN_NOT_OK(WaitInFlight(0));
+    return PosixWritableFile::Flush(mode);
+  }
+
+  Status WaitForAppends() override {
+    ThreadRestrictions::AssertIOAllowed();
+    return WaitInFlight(0);
+  }
+
+  Status Sync() override {
+    TRACE_EVENT1("io", "PosixIoUringWritableFile::Sync", "path", filename_);
+    ThreadRestrictions::AssertIOAllowed();
+    RETURN_NOT_OK(error_);
+    LOG_SLOW_EXECUTION(WARNING, 1000, Substitute("sync call for $0", filename_)) {
+      if (pending_sync_ && !FLAGS_never_fsync) {
+        if (!ring_->PrepareDrainedSync(fd_, !FLAGS_writable_file_use_fsync, kSyncId)) {
+          // Free an entry and retry, the sync is still ordered after all submitted writes.
+          RETURN_NOT_OK(WaitInFlight(ring_->sq_entries() - 1));
+          CHECK(ring_->PrepareDrainedSync(fd_, !FLAGS_writable_file_use_fsync, kSyncId));
+        }
+        sync_in_flight_ = true;
+      }
+      pending_sync_ = false;
+      RETURN_NOT_OK(WaitInFlight(0));
+    }
+    return Status::OK();
+  }
+
+ private:
+  static constexpr uint64_t kSyncId = std::numeric_limits<uint64_t>::max();
+
+  struct InFlightWrite {
+    std::string data;
+    iovec iov;
+  };
+
+  size_t InFlight() const {
+    return in_flight_writes_.size() + (sync_in_flight_ ? 1 : 0);
+  }
+
+  // Submits queued entries and waits until at most max_in_flight operations are not completed.
+  Status WaitInFlight(size_t max_in_flight) {
+    for (;;) {
+      ReapCompletions();
+      if (InFlight() <= max_in_flight) {
+        break;
+      }
+      // The kernel still references buffers of submitted writes, so they could not be dropped on
+      // failure.
+      CHECK_OK(ring_->Submit(1));
+    }
+    return error_;
+  }
+
+  void ReapCompletions() {
+    uint64_t id;
+    int32_t res;
+    while (ring_->PopCompletion(&id, &res)) {
+      if (id == kSyncId) {
+        sync_in_flight_ = false;
+        if (res < 0) {
+          SetError(STATUS_IO_ERROR(filename_, -res));
+        }
+        continue;
+      }
+      auto it = in_flight_writes_.find(id);
+      CHECK(it != in_flight_writes_.end()) << "Unknown io_uring completion: " << id;
+      if (res < 0) {
+        SetError(STATUS_IO_ERROR(filename_, -res));
+      } else if (implicit_cast<size_t>(res) != it->second.iov.iov_len) {
+        SetError(STATUS(IOError,
+            Substitute("pwritev error: expected to write $0 bytes, wrote $1 bytes instead",
+                       it->second.iov.iov_len, res)));
+      }
+      in_flight_writes_.erase(it);
+    }
+  }
+
+  void SetError(const Status& status) {
+    LOG(ERROR) << "Background write to " << filename_ << " failed: " << status;
+    if (error_.ok()) {
+      error_ = status;
+    }
+  }
+
+  std::unique_ptr<IoUring> ring_;
+  std::unordered_map<uint64_t, InFlightWrite> in_flight_writes_;
+  uint64_t next_write_id_ = 0;
+  bool sync_in_flight_ = false;
+  Status error_;
+};
+
 class PosixDirectIOWritableFile : public PosixWritableFile {
  public:
   PosixDirectIOWritableFile(const std::string &fname, int fd, uint64_t file_size,
@@ -1136,6 +1332,29 @@ class PosixEnv : public Env {
     TRACE_EVENT1("io", "SyncDir", "path", dirname);
     ThreadRestrictions::AssertIOAllowed();
     if (FLAGS_never_fsync) return Status::OK();
+    // Consensus metadata and superblocks of all tablets are flushed into the same directories,
+    // so concurrent callers share directory syncs instead of issuing one each.
+    std::shared_ptr<DirSyncState> state;
+    {
+      std::lock_guard<std::mutex> lock(dir_syncs_mutex_);
+      auto& entry = dir_syncs_[dirname];
+      if (!entry) {
+        entry = std::make_shared<DirSyncState>();
+      }
+      state = entry;
+      ++state->num_users;
+    }
+    Status result = state->Sync(dirname);
+    {
+      std::lock_guard<std::mutex> lock(dir_syncs_mutex_);
+      if (--state->num_users == 0) {
+        dir_syncs_.erase(dirname);
+      }
+    }
+    return result;
+  }
+
+  static Status DoSyncDir(const std::string& dirname) {
     int dir_fd;
     if ((dir_fd = open(dirname.c_str(), O_DIRECTORY|O_RDONLY)) == -1) {
       return STATUS_IO_ERROR(dirname, errno);
@@ -1430,6 +1649,41 @@ class PosixEnv : public Env {
   }
 
  private:
+  // Group commit of syncs of a single directory. A sync makes durable all changes made to the
+  // directory before it started, so a caller that arrives while a sync is in progress waits for
+  // the next one, which is shared by all callers that arrived in the meantime.
+  struct DirSyncState {
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint64_t started = 0;
+    uint64_t finished = 0;
+    bool in_progress = false;
+    Status last_status;
+    // Protected by dir_syncs_mutex_.
+    size_t num_users = 0;
+
+    Status Sync(const std::string& dirname) {
+      std::unique_lock<std::mutex> lock(mutex);
+      const uint64_t required = started + 1;
+      while (finished < required) {
+        if (in_progress) {
+          cond.wait(lock);
+          continue;
+        }
+        in_progress = true;
+        const uint64_t current = ++started;
+        lock.unlock();
+        Status status = DoSyncDir(dirname);
+        lock.lock();
+        in_progress = false;
+        finished = current;
+        last_status = status;
+        cond.notify_all();
+      }
+      return last_status;
+    }
+  };
+
   // gscoped_ptr Deleter implementation for fts_close
   struct FtsCloser {
     void operator()(FTS *fts) const {
@@ -1447,11 +1701,23 @@ class PosixEnv : public Env {
     }
     PosixWritableFile *posix_writable_file;
 #if defined(__linux)
-    if (opts.o_direct)
+    if (opts.o_direct) {
       posix_writable_file = new PosixDirectIOWritableFile(fname, fd, file_size, opts.sync_on_close);
-    else
+      result->reset(posix_writable_file);
+      return Status::OK();
+    }
+    if (opts.use_io_uring) {
+      auto ring = IoUring::Create(kIoUringWritableFileQueueDepth);
+      if (ring.ok()) {
+        result->reset(new PosixIoUringWritableFile(
+            fname, fd, file_size, opts.sync_on_close, std::move(*ring)));
+        return Status::OK();
+      }
+      YB_LOG_FIRST_N(WARNING, 1) << "io_uring is not available, using synchronous writes: "
+                                 << ring.status();
+    }
 #endif
-      posix_writable_file = new PosixWritableFile(fname, fd, file_size, opts.sync_on_close);
+    posix_writable_file = new PosixWritableFile(fname, fd, file_size, opts.sync_on_close);
     result->reset(posix_writable_file);
     return Status::OK();
   }
@@ -1473,6 +1739,9 @@ class PosixEnv : public Env {
         return Status::OK();
     }
   }
+
+  std::mutex dir_syncs_mutex_;
+  std::unordered_map<std::string, std::shared_ptr<DirSyncState>> dir_syncs_;
 };
 
 PosixEnv::PosixEnv() {}
@@ -140,7 +140,7 @@ Status OpenFileForSequential(Env *env, const string &path,
 }
 
 Status ReadFully(RandomAccessFile* file, uint64_t offset, size_t n,
-                 Slice* result, uint8_t* scratch) {
+                 Slice* result, uint8_t* scratch, bool uncached) {
 
   bool first_read = true;
 
@@ -148,7 +148,8 @@ Status ReadFully(RandomAccessFile* file, uint64_t offset, size_t n,
   uint8_t* dst = scratch;
   while (rem > 0) {
     Slice this_result;
-    RETURN_NOT_OK(file->Read(offset, rem, &this_result, dst));
+    RETURN_NOT_OK(uncached ? file->ReadUncached(offset, rem, &this_result, dst)
+                           : file->Read(offset, rem, &this_result, dst));
     DCHECK_LE(this_result.size(), rem);
     if (this_result.size() == 0) {
       // EOF
@@ -73,8 +73,10 @@ Status OpenFileForSequential(Env *env, const std::string &path,
 // NOTE: even if this returns an error, some data _may_ be read into
 // the provided scratch buffer, but no guarantee that that will be the
 // case.
+//
+// If 'uncached' is true, RandomAccessFile::ReadUncached is used for reading.
 Status ReadFully(RandomAccessFile* file, uint64_t offset, size_t n,
-                 Slice* result, uint8_t* scratch);
+                 Slice* result, uint8_t* scratch, bool uncached = false);
 
 // Creates the directory given by 'path', unless it already exists.
 //
@@ -446,6 +446,49 @@ TEST(FastVarIntTest, DecodeDescendingSignedPerformancePositiveValues) {
   TestDecodeDescendingSignedPerformance<uint64_t>();
 }
 
+TEST(FastVarIntTest, DecodeDescendingSignedBulkPerformance) {
+  auto values = GenerateRandomValues<int64_t>();
+  std::vector<char> buf(kMaxVarIntBufferSize * values.size());
+  char* end = FastEncodeDescendingSignedVarInts(values.data(), values.size(), buf.data());
+
+  std::vector<int64_t> decoded(values.size());
+  LOG(INFO) << "Start measure";
+  std::clock_t start_time = std::clock();
+  for (int i = 0; i != 25; ++i) {
+    Slice slice(buf.data(), end);
+    ASSERT_OK_FAST(FastDecodeDescendingSignedVarInts(&slice, decoded.data(), decoded.size()));
+    ASSERT_TRUE(slice.empty());
+  }
+  std::clock_t end_time = std::clock();
+  LOG(INFO) << std::fixed << std::setprecision(2) << "CPU time used: "
+            << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms\n";
+  ASSERT_EQ(values, decoded);
+}
+
+TEST(FastVarIntTest, DecodeDescendingSignedBulkCheck) {
+  auto values = GenerateRandomValues<int64_t>(500);
+  std::vector<char> buf(kMaxVarIntBufferSize * values.size());
+  char* end = FastEncodeDescendingSignedVarInts(values.data(), values.size(), buf.data());
+
+  // Bulk encoding is the same as encoding values one by one.
+  std::string expected;
+  for (auto value : values) {
+    FastEncodeDescendingSignedVarInt(value, &expected);
+  }
+  ASSERT_EQ(expected, std::string(buf.data(), end));
+
+  std::vector<int64_t> decoded(values.size());
+  Slice slice(buf.data(), end);
+  ASSERT_OK(FastDecodeDescendingSignedVarInts(&slice, decoded.data(), decoded.size()));
+  ASSERT_TRUE(slice.empty());
+  ASSERT_EQ(values, decoded);
+
+  // Truncated input is reported as corruption.
+  slice = Slice(buf.data(), end - 1);
+  ASSERT_TRUE(FastDecodeDescendingSignedVarInts(
+      &slice, decoded.data(), decoded.size()).IsCorruption());
+}
+
 TEST(FastVarIntTest, DecodeDescendingSignedCheck) {
   auto values = GenerateRandomValues<int64_t>(500);
 
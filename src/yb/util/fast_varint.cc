@@ -47,15 +47,35 @@ Status NotEnoughEncodedBytes(size_t decoded_varint_size, size_t bytes_provided)
 
 int SignedPositiveVarIntLength(uint64_t v) {
   // Compute the number of bytes needed to represent this number.
-  v >>= 6;
-  int n = 1;
-  while (v != 0) {
-    v >>= 7;
-    n += 1;
+  // n bytes hold 7 * n - 1 bits, so it is bit length / 7 + 1. Zero is treated as a 1 bit number.
+  return (64 - __builtin_clzll(v | 1)) / 7 + 1;
+}
+
+namespace {
+
+// Writes the lowest n bytes of value to dest in big endian order.
+inline void StoreBigEndian(uint64_t value, size_t n, uint8_t* dest) {
+  const uint64_t big_endian = __builtin_bswap64(value << (64 - 8 * n));
+  memcpy(dest, &big_endian, n);
+}
+
+// Returns a number, whose lowest n bytes are bytes [src, src + n) in big endian order, n should be
+// in [1, 8]. Higher bytes are unspecified, so the caller should mask them out.
+inline uint64_t LoadBigEndianTail(const uint8_t* src, size_t n) {
+#if defined(THREAD_SANITIZER) || defined(ADDRESS_SANITIZER)
+  uint64_t result = 0;
+  for (const uint8_t* i = src; i != src + n; ++i) {
+    result = (result << 8) | *i;
   }
-  return n;
+  return result;
+#else
+  // We are interested in range [src, src+n), so we use 64bit number that ends at src+n.
+  return __builtin_bswap64(*reinterpret_cast<const uint64_t*>(src - 8 + n));
+#endif
 }
 
+} // namespace
+
 /*
  * - First bit is sign bit (0 for negative, 1 for positive)
  * - The rest is the unsigned representation of the absolute value, except for 2 differences:
@@ -87,6 +107,15 @@ void FastEncodeSignedVarInt(int64_t v, uint8_t *dest, size_t *size) {
   const int n = SignedPositiveVarIntLength(uv);
   *size = n;
 
+  if (PREDICT_TRUE(n <= 8)) {
+    // Header of n ones is followed by zero and the value, so the whole encoding is computed as
+    // one 64 bit number. Negative numbers are complemented within n bytes.
+    uint64_t encoded = uv | (((1ULL << n) - 1) << (7 * n));
+    encoded ^= -static_cast<uint64_t>(negative) & (~0ULL >> (64 - 8 * n));
+    StoreBigEndian(encoded, n, dest);
+    return;
+  }
+
   // For n = 1 we should get 128 (10000000) as the first byte.
   //   In this case we have 6 available bits to use in the first byte.
   //
@@ -250,20 +279,42 @@ Result<int64_t> FastDecodeDescendingSignedVarInt(Slice* slice) {
   return -temp.first;
 }
 
-size_t UnsignedVarIntLength(uint64_t v) {
-  size_t result = 1;
-  v >>= 7;
-  while (v != 0) {
-    v >>= 7;
-    ++result;
+char* FastEncodeDescendingSignedVarInts(const int64_t* values, size_t count, char* buf) {
+  for (const int64_t* end = values + count; values != end; ++values) {
+    size_t size = 0;
+    FastEncodeSignedVarInt(-*values, to_uchar_ptr(buf), &size);
+    buf += size;
   }
-  return result;
+  return buf;
+}
+
+Status FastDecodeDescendingSignedVarInts(Slice* slice, int64_t* values, size_t count) {
+  const uint8_t* src = slice->data();
+  const uint8_t* const end = slice->end();
+  for (int64_t* const values_end = values + count; values != values_end; ++values) {
+    auto temp = VERIFY_RESULT(FastDecodeSignedVarInt(src, end - src));
+    *values = -temp.first;
+    src += temp.second;
+  }
+  *slice = Slice(src, end);
+  return Status::OK();
+}
+
+size_t UnsignedVarIntLength(uint64_t v) {
+  // n bytes hold 7 * n bits. Zero is treated as a 1 bit number.
+  return (64 - __builtin_clzll(v | 1) + 6) / 7;
 }
 
 void FastEncodeUnsignedVarInt(uint64_t v, uint8_t *dest, size_t *size) {
   const size_t n = UnsignedVarIntLength(v);
   *size = n;
 
+  if (PREDICT_TRUE(n <= 8)) {
+    // Header of n - 1 ones is followed by zero and the value.
+    StoreBigEndian(v | (((1ULL << (n - 1)) - 1) << (7 * n + 1)), n, dest);
+    return;
+  }
+
   size_t i;
   if (n == 10) {
     dest[0] = 0xff;
@@ -298,27 +349,23 @@ CHECKED_STATUS FastDecodeUnsignedVarInt(
   if (src_size < n_bytes) {
     return NotEnoughEncodedBytes(n_bytes, src_size);
   }
-  if (n_bytes == 1) {
-    // Fast path for single-byte decoding.
-    *v = first_byte & 0x7f;
-    *decoded_size = 1;
+  if (PREDICT_TRUE(n_bytes <= 8)) {
+    // Fast path, n bytes contain 7 * n bits of value after the header.
+    *v = LoadBigEndianTail(src, n_bytes) & ((1ULL << (7 * n_bytes)) - 1);
+    *decoded_size = n_bytes;
     return Status::OK();
   }
 
+  // The first byte is 0xff, so it is a 9 or 10 byte encoding.
   uint64_t result = 0;
   int i = 0;
-  if (n_bytes == 9) {
-    if (src[1] & 0x80) {
-      n_bytes = 10;
-      result = src[1] & 0x3f;
-      i = 2;
-    }
-    if (src_size < n_bytes) {
-      return NotEnoughEncodedBytes(n_bytes, src_size);
-    }
-  } else {
-    result = src[0] & ((1 << (8 - n_bytes)) - 1);
-    i = 1;
+  if (src[1] & 0x80) {
+    n_bytes = 10;
+    result = src[1] & 0x3f;
+    i = 2;
+  }
+  if (src_size < n_bytes) {
+    return NotEnoughEncodedBytes(n_bytes, src_size);
   }
 
   for (; i < n_bytes; ++i) {
@@ -65,6 +65,13 @@ inline void FastEncodeDescendingSignedVarInt(int64_t v, std::string *dest) {
 CHECKED_STATUS FastDecodeDescendingSignedVarInt(Slice *slice, int64_t *dest);
 Result<int64_t> FastDecodeDescendingSignedVarInt(Slice* slice);
 
+// Encodes 'count' values as consecutive "descending VarInts" into buf, that should have room for
+// at most 10 bytes per value. Returns the end of encoded data.
+char* FastEncodeDescendingSignedVarInts(const int64_t* values, size_t count, char* buf);
+
+// Decodes 'count' consecutive "descending VarInts" into values. Consumes decoded part of the slice.
+CHECKED_STATUS FastDecodeDescendingSignedVarInts(Slice* slice, int64_t* values, size_t count);
+
 size_t UnsignedVarIntLength(uint64_t v);
 void FastEncodeUnsignedVarInt(uint64_t v, uint8_t *dest, size_t *size);
 CHECKED_STATUS FastDecodeUnsignedVarInt(
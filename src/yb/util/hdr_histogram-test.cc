@@ -125,4 +125,26 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, MergeTest) {
+  uint64_t highest_val = 10000LU;
+  HdrHistogram hist(highest_val, kSigDigits);
+  HdrHistogram other(highest_val, kSigDigits);
+  hist.Increment(10);
+  hist.Increment(20);
+  other.IncrementBy(5, 2);
+  other.Increment(1000);
+
+  hist.MergeFrom(other);
+  ASSERT_EQ(5, hist.TotalCount());
+  ASSERT_EQ(10 + 20 + 5 * 2 + 1000, hist.TotalSum());
+  ASSERT_EQ(5, hist.MinValue());
+  ASSERT_EQ(1000, hist.MaxValue());
+  ASSERT_EQ(2, hist.CountInBucketForValue(5));
+  ASSERT_EQ(1, hist.CountInBucketForValue(10));
+  ASSERT_EQ(1, hist.CountInBucketForValue(1000));
+
+  // Merged histogram is not affected.
+  ASSERT_EQ(3, other.TotalCount());
+}
+
 } // namespace yb
@@ -104,6 +104,11 @@ class HdrHistogram {
   void IncrementWithExpectedInterval(int64_t value,
                                      int64_t expected_interval_between_samples);
 
+  // Add values recorded by other, that should have the same configuration, to this histogram.
+  // Like the copy constructor it is not consistent with concurrent updates of other, but this
+  // histogram could be concurrently updated or merged into.
+  void MergeFrom(const HdrHistogram& other);
+
   // Fetch configuration params.
   uint64_t highest_trackable_value() const { return highest_trackable_value_; }
   int num_significant_digits() const { return num_significant_digits_; }
@@ -184,6 +189,8 @@ class HdrHistogram {
   static const int kMaxValidNumSignificantDigits = 5;
 
   void Init();
+  void UpdateMinValue(base::subtle::Atomic64 value);
+  void UpdateMaxValue(base::subtle::Atomic64 value);
   int CountsArrayIndex(int bucket_index, int sub_bucket_index) const;
 
   uint64_t highest_trackable_value_;
@@ -0,0 +1,232 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/io_uring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define YB_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#include "yb/util/errno.h"
+#include "yb/util/format.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+#ifdef YB_HAVE_IO_URING
+
+namespace {
+
+template <class T>
+T* RingPtr(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+void* MapRing(int fd, size_t size, off_t offset) {
+  void* result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+  return result == MAP_FAILED ? nullptr : result;
+}
+
+Status MapError(const char* what) {
+  int err = errno;
+  return STATUS_FORMAT(IOError, "Failed to map io_uring $0: $1", what, ErrnoToString(err));
+}
+
+} // namespace
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = syscall(__NR_io_uring_setup, entries, &params);
+  if (fd < 0) {
+    // ENOSYS on old kernels, EPERM when io_uring is disabled by the administrator.
+    int err = errno;
+    return STATUS(NotSupported, "io_uring_setup failed", ErrnoToString(err), err);
+  }
+
+  std::unique_ptr<IoUring> result(new IoUring());
+  result->fd_ = fd;
+  result->sq_entries_ = params.sq_entries;
+  result->sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  result->cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    single_mmap = true;
+    result->sq_ring_size_ = result->cq_ring_size_ =
+        std::max(result->sq_ring_size_, result->cq_ring_size_);
+  }
+#endif
+  result->sq_ring_ = MapRing(fd, result->sq_ring_size_, IORING_OFF_SQ_RING);
+  if (!result->sq_ring_) {
+    return MapError("submission queue");
+  }
+  if (single_mmap) {
+    result->cq_ring_ = result->sq_ring_;
+  } else {
+    result->cq_ring_ = MapRing(fd, result->cq_ring_size_, IORING_OFF_CQ_RING);
+    if (!result->cq_ring_) {
+      return MapError("completion queue");
+    }
+  }
+  result->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  result->sqes_ = static_cast<io_uring_sqe*>(MapRing(fd, result->sqes_size_, IORING_OFF_SQES));
+  if (!result->sqes_) {
+    return MapError("entries");
+  }
+
+  void* sq = result->sq_ring_;
+  result->sq_head_ = RingPtr<uint32_t>(sq, params.sq_off.head);
+  result->sq_tail_ = RingPtr<uint32_t>(sq, params.sq_off.tail);
+  result->sq_mask_ = *RingPtr<uint32_t>(sq, params.sq_off.ring_mask);
+  result->sq_array_ = RingPtr<uint32_t>(sq, params.sq_off.array);
+  result->sq_local_tail_ = *result->sq_tail_;
+
+  void* cq = result->cq_ring_;
+  result->cq_head_ = RingPtr<uint32_t>(cq, params.cq_off.head);
+  result->cq_tail_ = RingPtr<uint32_t>(cq, params.cq_off.tail);
+  result->cq_mask_ = *RingPtr<uint32_t>(cq, params.cq_off.ring_mask);
+  result->cqes_ = RingPtr<io_uring_cqe>(cq, params.cq_off.cqes);
+
+  return std::move(result);
+}
+
+IoUring::~IoUring() {
+  if (sqes_) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+io_uring_sqe* IoUring::NextSqe() {
+  const uint32_t head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (sq_local_tail_ - head >= sq_entries_) {
+    return nullptr;
+  }
+  const uint32_t index = sq_local_tail_ & sq_mask_;
+  ++sq_local_tail_;
+  sq_array_[index] = index;
+  io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+bool IoUring::PrepareWritev(
+    int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data) {
+  io_uring_sqe* sqe = NextSqe();
+  if (!sqe) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd;
+  sqe->off = offset;
+  sqe->addr = reinterpret_cast<uintptr_t>(iov);
+  sqe->len = iovcnt;
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool IoUring::PrepareDrainedSync(int fd, bool datasync, uint64_t user_data) {
+  io_uring_sqe* sqe = NextSqe();
+  if (!sqe) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_FSYNC;
+  sqe->fd = fd;
+  sqe->flags = IOSQE_IO_DRAIN;
+  sqe->fsync_flags = datasync ? IORING_FSYNC_DATASYNC : 0;
+  sqe->user_data = user_data;
+  return true;
+}
+
+Status IoUring::Submit(uint32_t min_complete) {
+  __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+  for (;;) {
+    const uint32_t to_submit = sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (to_submit == 0 && min_complete == 0) {
+      return Status::OK();
+    }
+    const unsigned flags = min_complete != 0 ? IORING_ENTER_GETEVENTS : 0;
+    const int res = syscall(
+        __NR_io_uring_enter, fd_, to_submit, min_complete, flags, nullptr, 0);
+    if (res >= 0) {
+      return Status::OK();
+    }
+    const int err = errno;
+    if (err != EINTR) {
+      return STATUS(IOError, "io_uring_enter failed", ErrnoToString(err), err);
+    }
+  }
+}
+
+bool IoUring::PopCompletion(uint64_t* user_data, int32_t* res) {
+  const uint32_t head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+  const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+  *user_data = cqe.user_data;
+  *res = cqe.res;
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+#else
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t entries) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+IoUring::~IoUring() {}
+
+bool IoUring::PrepareWritev(
+    int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data) {
+  return false;
+}
+
+bool IoUring::PrepareDrainedSync(int fd, bool datasync, uint64_t user_data) {
+  return false;
+}
+
+Status IoUring::Submit(uint32_t min_complete) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+bool IoUring::PopCompletion(uint64_t* user_data, int32_t* res) {
+  return false;
+}
+
+#endif // YB_HAVE_IO_URING
+
+} // namespace yb
@@ -0,0 +1,89 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_IO_URING_H
+#define YB_UTIL_IO_URING_H
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <memory>
+
+#include "yb/util/result.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace yb {
+
+// io_uring submission and completion queues, driven through raw system calls, so liburing is not
+// required. Availability is detected at runtime: on kernels without io_uring Create returns
+// NotSupported, and callers should fall back to synchronous system calls.
+//
+// Not thread safe.
+class IoUring {
+ public:
+  // Creates a ring with at least 'entries' submission queue entries.
+  static Result<std::unique_ptr<IoUring>> Create(uint32_t entries);
+
+  ~IoUring();
+
+  IoUring(const IoUring&) = delete;
+  void operator=(const IoUring&) = delete;
+
+  // Queues vectored write of fd at offset. iov and the buffers it points to should stay valid
+  // until completion with user_data is reaped. Returns false when the submission queue is full.
+  bool PrepareWritev(int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data);
+
+  // Queues sync of fd, that is started only after all previously queued operations complete.
+  bool PrepareDrainedSync(int fd, bool datasync, uint64_t user_data);
+
+  // Submits queued entries, and waits until at least min_complete completions are available.
+  CHECKED_STATUS Submit(uint32_t min_complete);
+
+  // Reaps available completion. Returns false when there are none.
+  bool PopCompletion(uint64_t* user_data, int32_t* res);
+
+  uint32_t sq_entries() const { return sq_entries_; }
+
+ private:
+  IoUring() = default;
+
+  io_uring_sqe* NextSqe();
+
+  int fd_ = -1;
+  uint32_t sq_entries_ = 0;
+
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t* sq_array_ = nullptr;
+  // Tail including prepared entries, that were not published to the kernel yet.
+  uint32_t sq_local_tail_ = 0;
+
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_IO_URING_H
@@ -0,0 +1,99 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/lockfree.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+struct TestEntry {
+  size_t producer;
+  size_t index;
+  TestEntry* next = nullptr;
+};
+
+TestEntry* GetNext(TestEntry* entry) {
+  return entry->next;
+}
+
+void SetNext(TestEntry* entry, TestEntry* next) {
+  entry->next = next;
+}
+
+} // namespace
+
+TEST(LockfreeTest, MPSCQueueSingleThread) {
+  MPSCQueue<TestEntry> queue;
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(nullptr, queue.PopAll());
+
+  std::vector<TestEntry> entries(10);
+  for (size_t i = 0; i != entries.size(); ++i) {
+    entries[i].index = i;
+    ASSERT_EQ(i == 0, queue.Push(&entries[i]));
+  }
+  ASSERT_FALSE(queue.empty());
+
+  size_t expected = 0;
+  for (auto* entry = queue.PopAll(); entry; entry = GetNext(entry)) {
+    ASSERT_EQ(expected, entry->index);
+    ++expected;
+  }
+  ASSERT_EQ(entries.size(), expected);
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(LockfreeTest, MPSCQueueMultipleProducers) {
+  constexpr size_t kProducers = 8;
+  constexpr size_t kEntriesPerProducer = 100000;
+
+  MPSCQueue<TestEntry> queue;
+  std::vector<std::vector<TestEntry>> entries(kProducers);
+  std::vector<std::thread> producers;
+  for (size_t producer = 0; producer != kProducers; ++producer) {
+    entries[producer].resize(kEntriesPerProducer);
+    producers.emplace_back([&queue, &entries, producer] {
+      for (size_t i = 0; i != kEntriesPerProducer; ++i) {
+        auto& entry = entries[producer][i];
+        entry.producer = producer;
+        entry.index = i;
+        queue.Push(&entry);
+      }
+    });
+  }
+
+  // Entries of each producer should be received in the order they were pushed.
+  std::vector<size_t> received(kProducers);
+  size_t total = 0;
+  while (total != kProducers * kEntriesPerProducer) {
+    for (auto* entry = queue.PopAll(); entry; entry = GetNext(entry)) {
+      ASSERT_EQ(received[entry->producer], entry->index);
+      ++received[entry->producer];
+      ++total;
+    }
+  }
+
+  for (auto& thread : producers) {
+    thread.join();
+  }
+  ASSERT_TRUE(queue.empty());
+}
+
+} // namespace yb
@@ -0,0 +1,77 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+#ifndef YB_UTIL_LOCKFREE_H
+#define YB_UTIL_LOCKFREE_H
+
+#include <atomic>
+
+namespace yb {
+
+// Intrusive lock-free queue with multiple producers and a single consumer, that takes all queued
+// entries at once.
+//
+// Entries are linked through the functions GetNext(T*) and SetNext(T*, T*), that are looked up
+// by ADL. An entry could be present in at most one queue at a time, and only once.
+template <class T>
+class MPSCQueue {
+ public:
+  MPSCQueue() = default;
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  void operator=(const MPSCQueue&) = delete;
+
+  // Adds entry to the queue. Returns true if the queue was empty before this call.
+  // Could be called concurrently from any number of threads.
+  bool Push(T* value) {
+    auto head = head_.load(std::memory_order_acquire);
+    for (;;) {
+      SetNext(value, head);
+      if (head_.compare_exchange_weak(head, value)) {
+        return head == nullptr;
+      }
+    }
+  }
+
+  // Takes all entries from the queue, and returns the first one of them, in push order.
+  // The rest entries could be iterated using GetNext, the last one has nullptr as next.
+  // Concurrent calls are safe, each of them gets its own entries.
+  T* PopAll() {
+    T* head = head_.exchange(nullptr);
+    // Entries are stored in reversed order, so restore the push order.
+    T* result = nullptr;
+    while (head) {
+      T* next = GetNext(head);
+      SetNext(head, result);
+      result = head;
+      head = next;
+    }
+    return result;
+  }
+
+  // Uses sequentially consistent load, so a consumer could store its own flag, then check
+  // emptiness, while a producer pushes, then checks that flag. At least one of them observes
+  // the other.
+  bool empty() const {
+    return head_.load(std::memory_order_seq_cst) == nullptr;
+  }
+
+ private:
+  // The most recently pushed entry.
+  std::atomic<T*> head_{nullptr};
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_LOCKFREE_H
@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -41,6 +42,7 @@
 #include <gperftools/malloc_extension.h>
 #endif
 
+#include "yb/util/allocation_sampler.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/test_util.h"
 
@@ -334,6 +336,52 @@ TEST(MemTrackerTest, TcMallocRootTracker) {
     return root->GetUpdatedConsumption() > value;
   }, kWaitTimeout, "Consumption increased"));
 }
+
+TEST(MemTrackerTest, AllocationSampling) {
+  constexpr int64_t kInterval = 4_KB;
+  constexpr size_t kAllocationSize = 256;
+  constexpr size_t kNumAllocations = 4_MB / kAllocationSize;
+  shared_ptr<MemTracker> tracker = MemTracker::CreateTracker("sampled");
+  shared_ptr<MemTracker> other = MemTracker::CreateTracker("not_sampled");
+  ASSERT_OK(StartAllocationSampling(kInterval));
+
+  std::vector<std::unique_ptr<char[]>> allocations;
+  allocations.reserve(kNumAllocations * 2);
+  {
+    ScopedAllocationAttribution attribution(tracker.get());
+    ASSERT_EQ(tracker.get(), CurrentAllocationTracker());
+    for (size_t i = 0; i != kNumAllocations; ++i) {
+      allocations.emplace_back(new char[kAllocationSize]);
+    }
+    {
+      ScopedAllocationAttribution nested(nullptr);
+      ASSERT_EQ(tracker.get(), CurrentAllocationTracker());
+    }
+  }
+  ASSERT_EQ(nullptr, CurrentAllocationTracker());
+  // Allocations outside of attribution scopes are not sampled.
+  for (size_t i = 0; i != kNumAllocations; ++i) {
+    allocations.emplace_back(new char[kAllocationSize]);
+  }
+  StopAllocationSampling();
+  VLOG(8) << static_cast<void*>(allocations.back().get());
+
+  auto* samples = tracker->allocation_samples();
+  LOG(INFO) << "Estimated allocated bytes: " << samples->total_bytes();
+  ASSERT_GT(samples->total_bytes(), 3_MB);
+  ASSERT_LT(samples->total_bytes(), 5_MB);
+  auto top = samples->Top(10);
+  ASSERT_FALSE(top.empty());
+  ASSERT_LE(top.size(), 10);
+  for (size_t i = 1; i < top.size(); ++i) {
+    ASSERT_GE(top[i - 1].bytes, top[i].bytes);
+  }
+  ASSERT_EQ(0, other->allocation_samples()->total_bytes());
+
+  samples->Reset();
+  ASSERT_EQ(0, samples->total_bytes());
+  ASSERT_TRUE(samples->Top(10).empty());
+}
 #endif
 
 TEST(MemTrackerTest, UnregisterFromParent) {
@@ -358,4 +406,38 @@ TEST(MemTrackerTest, UnregisterFromParent) {
   shared_ptr<MemTracker> c2 = MemTracker::CreateTracker("child", p);
 }
 
+TEST(MemTrackerTest, ConcurrentParentConsumption) {
+  shared_ptr<MemTracker> p = MemTracker::CreateTracker("parent");
+  constexpr int kNumThreads = 8;
+  constexpr int kNumIterations = 10000;
+  constexpr int64_t kBytes = 100;
+  std::vector<shared_ptr<MemTracker>> children;
+  for (int i = 0; i != kNumThreads; ++i) {
+    children.push_back(MemTracker::CreateTracker(Format("child$0", i), p));
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([child = children[i]] {
+      for (int j = 0; j != kNumIterations; ++j) {
+        child->Consume(kBytes);
+      }
+      // Leave part of consumption to check that parent does not lose not yet flushed changes.
+      for (int j = 0; j != kNumIterations / 2; ++j) {
+        child->Release(kBytes);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(kNumThreads * kNumIterations / 2 * kBytes, p->consumption());
+  for (const auto& child : children) {
+    ASSERT_EQ(kNumIterations / 2 * kBytes, child->consumption());
+    child->Release(kNumIterations / 2 * kBytes);
+  }
+  ASSERT_EQ(0, p->consumption());
+}
+
 } // namespace yb
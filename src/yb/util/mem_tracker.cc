@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <limits>
 #include <list>
@@ -48,6 +49,7 @@
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/allocation_sampler.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env.h"
@@ -101,6 +103,12 @@ DEFINE_int64(mem_tracker_update_consumption_interval_us, 2000000,
              "Interval that is used to update memory consumption from external source. "
              "For instance from tcmalloc statistics.");
 
+DEFINE_int64(mem_tracker_consumption_slack_bytes, 64 * 1024,
+             "Consumption changes of memory trackers that have children are accumulated per "
+             "thread, and are added to the shared counter after they reach this size. "
+             "0 disables accumulation.");
+TAG_FLAG(mem_tracker_consumption_slack_bytes, advanced);
+
 namespace yb {
 
 // NOTE: this class has been adapted from Impala, so the code style varies
@@ -183,6 +191,9 @@ shared_ptr<MemTracker> MemTracker::CreateChild(int64_t byte_limit,
     }
   }
   auto result = std::make_shared<MemTracker>(byte_limit, id, shared_from_this(), add_to_parent);
+  if (add_to_parent) {
+    MaybeEnableConsumptionShards();
+  }
   auto p = child_trackers_.emplace(id, result);
   if (!p.second) {
     auto existing = p.first->second.lock();
@@ -202,10 +213,12 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id, shared_ptr<MemTrack
       id_(id),
       descr_(Substitute("memory consumption for $0", id)),
       parent_(std::move(parent)),
+      consumption_slack_(FLAGS_mem_tracker_consumption_slack_bytes),
       rand_(GetRandomSeed32()),
       enable_logging_(FLAGS_mem_tracker_logging),
       log_stack_(FLAGS_mem_tracker_log_stack_trace),
-      add_to_parent_(add_to_parent) {
+      add_to_parent_(add_to_parent),
+      allocation_samples_(std::make_unique<AllocationSamples>()) {
   VLOG(1) << "Creating tracker " << ToString();
   UpdateConsumption();
   soft_limit_ = (limit_ == -1)
@@ -231,6 +244,44 @@ MemTracker::~MemTracker() {
       parent_->Release(consumption());
     }
   }
+  delete[] consumption_shards_.load(std::memory_order_acquire);
+}
+
+void MemTracker::MaybeEnableConsumptionShards() {
+  if (consumption_slack_ <= 0 || consumption_shards_.load(std::memory_order_acquire)) {
+    return;
+  }
+#if TCMALLOC_ENABLED
+  // Root consumption is taken from tcmalloc.
+  if (!parent_) {
+    return;
+  }
+#endif
+  // Limit checks ignore not yet flushed changes, so sharding is used only when the possible error
+  // is small compared to the limit.
+  if (has_limit() && limit_ < 100 * consumption_slack_ * kNumConsumptionShards) {
+    return;
+  }
+  auto shards = std::make_unique<ConsumptionShard[]>(kNumConsumptionShards);
+  ConsumptionShard* expected = nullptr;
+  if (consumption_shards_.compare_exchange_strong(expected, shards.get())) {
+    shards.release();
+  }
+}
+
+void MemTracker::IncrementConsumption(int64_t bytes) {
+  auto* shards = consumption_shards_.load(std::memory_order_acquire);
+  if (shards) {
+    static std::atomic<size_t> next_shard{0};
+    static thread_local size_t shard_idx = next_shard.fetch_add(1) % kNumConsumptionShards;
+    auto& delta = shards[shard_idx].delta;
+    const int64_t new_delta = delta.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (std::abs(new_delta) < consumption_slack_) {
+      return;
+    }
+    bytes = delta.exchange(0, std::memory_order_relaxed);
+  }
+  consumption_.IncrementBy(bytes);
 }
 
 void MemTracker::UnregisterFromParent() {
@@ -341,8 +392,8 @@ void MemTracker::Consume(int64_t bytes) {
   }
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
-      tracker->consumption_.IncrementBy(bytes);
-      DCHECK_GE(tracker->consumption_.current_value(), 0);
+      tracker->IncrementConsumption(bytes);
+      DCHECK_GE(tracker->consumption(), 0);
     }
   }
 }
@@ -423,14 +474,14 @@ void MemTracker::Release(int64_t bytes) {
 
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
-      tracker->consumption_.IncrementBy(-bytes);
+      tracker->IncrementConsumption(-bytes);
       // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
       // reported amount, the subsequent call to FunctionContext::Free() may cause the
       // process mem tracker to go negative until it is synced back to the tcmalloc
       // metric. Don't blow up in this case. (Note that this doesn't affect non-process
       // trackers since we can enforce that the reported memory usage is internally
       // consistent.)
-      DCHECK_GE(tracker->consumption_.current_value(), 0) << "Tracker: " << tracker->ToString();
+      DCHECK_GE(tracker->consumption(), 0) << "Tracker: " << tracker->ToString();
     }
   }
 }
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -44,6 +45,7 @@
 #include <gperftools/malloc_extension.h>
 #endif
 
+#include "yb/gutil/port.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/high_water_mark.h"
 #include "yb/util/locks.h"
@@ -53,6 +55,7 @@
 
 namespace yb {
 
+class AllocationSamples;
 class Status;
 class MemTracker;
 typedef std::shared_ptr<MemTracker> MemTrackerPtr;
@@ -287,7 +290,7 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   // Returns the memory consumed in bytes.
   int64_t consumption() const {
-    return consumption_.current_value();
+    return consumption_.current_value() + UnflushedConsumption();
   }
 
   int64_t GetUpdatedConsumption() {
@@ -324,9 +327,42 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // globally unique.
   std::string ToString() const;
 
+  // Allocations sampled while this tracker was set by ScopedAllocationAttribution.
+  AllocationSamples* allocation_samples() const { return allocation_samples_.get(); }
+
  private:
+  // Consumption changes of trackers that have children are accumulated in per thread shards, and
+  // are added to consumption_ when a shard goes over mem_tracker_consumption_slack_bytes. Parents
+  // are updated on each change of any descendant, so it avoids contention on their counters.
+  // Trackers with small limits are never sharded, so their limit checks stay exact.
+  struct alignas(CACHELINE_SIZE) ConsumptionShard {
+    std::atomic<int64_t> delta{0};
+  };
+
+  static constexpr size_t kNumConsumptionShards = 32;
+
+  // Starts accumulating consumption changes in shards, if applicable to this tracker.
+  void MaybeEnableConsumptionShards();
+
+  // Adds 'bytes' to consumption of this tracker, possibly via its shard.
+  void IncrementConsumption(int64_t bytes);
+
+  // Sum of changes that were not yet added to consumption_.
+  int64_t UnflushedConsumption() const {
+    const auto* shards = consumption_shards_.load(std::memory_order_acquire);
+    if (!shards) {
+      return 0;
+    }
+    int64_t result = 0;
+    for (size_t i = 0; i != kNumConsumptionShards; ++i) {
+      result += shards[i].delta.load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  // Limit checks use consumption_ only, i.e. ignore not yet flushed changes of sharded trackers.
   bool CheckLimitExceeded() const {
-    return limit_ >= 0 && limit_ < consumption();
+    return limit_ >= 0 && limit_ < consumption_.current_value();
   }
 
   // If consumption is higher than max_consumption, attempts to free memory by calling any
@@ -376,6 +412,10 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   HighWaterMark consumption_{0};
 
+  // Shards with not yet flushed consumption changes, nullptr if consumption is not sharded.
+  std::atomic<ConsumptionShard*> consumption_shards_{nullptr};
+  const int64_t consumption_slack_;
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
@@ -403,6 +443,8 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   bool log_stack_;
 
   AddToParent add_to_parent_;
+
+  std::unique_ptr<AllocationSamples> allocation_samples_;
 };
 
 // An std::allocator that manipulates a MemTracker during allocation
@@ -34,6 +34,7 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -54,6 +55,8 @@ DECLARE_int32(metrics_retirement_age_ms);
 namespace yb {
 
 METRIC_DEFINE_entity(test_entity);
+// Prometheus output aggregates entities with this name at the table level.
+METRIC_DEFINE_entity(tablet);
 
 class MetricsTest : public YBTest {
  public:
@@ -173,14 +176,40 @@ TEST_F(MetricsTest, SimpleHistogramTest) {
   scoped_refptr<Histogram> hist = METRIC_test_hist.Instantiate(entity_);
   hist->Increment(2);
   hist->IncrementBy(4, 1);
-  ASSERT_EQ(2, hist->histogram_->MinValue());
-  ASSERT_EQ(3, hist->histogram_->MeanValue());
-  ASSERT_EQ(4, hist->histogram_->MaxValue());
-  ASSERT_EQ(2, hist->histogram_->TotalCount());
-  ASSERT_EQ(6, hist->histogram_->TotalSum());
+  auto snapshot = hist->Snapshot();
+  ASSERT_EQ(2, snapshot->MinValue());
+  ASSERT_EQ(3, snapshot->MeanValue());
+  ASSERT_EQ(4, snapshot->MaxValue());
+  ASSERT_EQ(2, snapshot->TotalCount());
+  ASSERT_EQ(6, snapshot->TotalSum());
   // TODO: Test coverage needs to be improved a lot.
 }
 
+TEST_F(MetricsTest, ConcurrentHistogramTest) {
+  scoped_refptr<Histogram> hist = METRIC_test_hist.Instantiate(entity_);
+  constexpr int kNumThreads = 16;
+  constexpr int kNumIncrements = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([hist, i] {
+      for (int j = 0; j != kNumIncrements; ++j) {
+        hist->Increment(i + 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Values recorded to all stripes are visible.
+  ASSERT_EQ(kNumThreads * kNumIncrements, hist->TotalCount());
+  auto snapshot = hist->Snapshot();
+  ASSERT_EQ(kNumThreads * kNumIncrements, snapshot->TotalCount());
+  ASSERT_EQ(kNumIncrements * kNumThreads * (kNumThreads + 1) / 2, snapshot->TotalSum());
+  ASSERT_EQ(1, snapshot->MinValue());
+  ASSERT_EQ(kNumThreads, snapshot->MaxValue());
+}
+
 TEST_F(MetricsTest, JsonPrintTest) {
   scoped_refptr<Counter> bytes_seen = METRIC_reqs_pending.Instantiate(entity_);
   bytes_seen->Increment();
@@ -217,6 +246,49 @@ TEST_F(MetricsTest, JsonPrintTest) {
   ASSERT_EQ("", out.str());
 }
 
+TEST_F(MetricsTest, JsonOnlyModifiedTest) {
+  scoped_refptr<Counter> reqs_pending = METRIC_reqs_pending.Instantiate(entity_);
+  reqs_pending->Increment();
+
+  MetricJsonOptions opts;
+  opts.only_modified_in_or_after_epoch = Metric::IncrementEpoch();
+
+  // Nothing was modified in the new epoch, so the entity is skipped.
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::PRETTY);
+  ASSERT_OK(entity_->WriteAsJson(&writer, { "*" }, opts));
+  ASSERT_EQ("", out.str());
+
+  reqs_pending->Increment();
+  ASSERT_OK(entity_->WriteAsJson(&writer, { "*" }, opts));
+  JsonReader reader(out.str());
+  ASSERT_OK(reader.Init());
+  vector<const rapidjson::Value*> metrics;
+  ASSERT_OK(reader.ExtractObjectArray(reader.root(), "metrics", &metrics));
+  ASSERT_EQ(1, metrics.size());
+  int64_t metric_value;
+  ASSERT_OK(reader.ExtractInt64(metrics[0], "value", &metric_value));
+  ASSERT_EQ(2L, metric_value);
+}
+
+METRIC_DEFINE_counter(tablet, tablet_reqs, "Tablet Requests", MetricUnit::kRequests,
+                      "Number of requests to the tablet");
+
+TEST_F(MetricsTest, PrometheusTableAggregationTest) {
+  scoped_refptr<MetricEntity> tablet1 = METRIC_ENTITY_tablet.Instantiate(
+      &registry_, "tablet1", {{"table_id", "table"}, {"table_name", "test_table"}});
+  scoped_refptr<MetricEntity> tablet2 = METRIC_ENTITY_tablet.Instantiate(
+      &registry_, "tablet2", {{"table_id", "table"}, {"table_name", "test_table"}});
+  METRIC_tablet_reqs.Instantiate(tablet1)->IncrementBy(3);
+  METRIC_tablet_reqs.Instantiate(tablet2)->IncrementBy(4);
+
+  std::stringstream out;
+  PrometheusWriter writer(&out);
+  ASSERT_OK(registry_.WriteForPrometheus(&writer));
+  // Values of all tablets, including the first one, are summed into a single table level entry.
+  ASSERT_STR_CONTAINS(out.str(), "tablet_reqs{table_id=\"table\",table_name=\"test_table\"} 7 ");
+}
+
 // Test that metrics are retired when they are no longer referenced.
 TEST_F(MetricsTest, RetirementTest) {
   FLAGS_metrics_retirement_age_ms = 100;
@@ -57,6 +57,12 @@ TAG_FLAG(metrics_retirement_age_ms, runtime);
 TAG_FLAG(metrics_retirement_age_ms, advanced);
 
 // TODO: changed to empty string and add logic to get this from cluster_uuid in case empty.
+DEFINE_int32(metrics_histogram_stripes, 8,
+             "Max number of stripes that are used by a single histogram metric. Concurrent "
+             "threads update different stripes, that reduces contention at the cost of extra "
+             "memory for histograms that are actively updated by many threads.");
+TAG_FLAG(metrics_histogram_stripes, advanced);
+
 DEFINE_string(metric_node_name, "DEFAULT_NODE_NAME",
               "Value to use as node name for metrics reporting");
 
@@ -229,7 +235,8 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
       const MetricPrototype* prototype = val.first;
       const scoped_refptr<Metric>& metric = val.second;
 
-      if (select_all || MatchMetricInList(prototype->name(), requested_metrics)) {
+      if ((select_all || MatchMetricInList(prototype->name(), requested_metrics)) &&
+          metric->ModifiedInOrAfterEpoch(opts.only_modified_in_or_after_epoch)) {
         InsertOrDie(&metrics, prototype->name(), metric);
       }
     }
@@ -241,6 +248,12 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
     return Status::OK();
   }
 
+  // The same for entities without metrics modified since the requested epoch. External metrics
+  // are not tracked, so they are also skipped in this case.
+  if (opts.only_modified_in_or_after_epoch > 0 && metrics.empty()) {
+    return Status::OK();
+  }
+
   writer->StartObject();
 
   writer->String("type");
@@ -582,8 +595,11 @@ scoped_refptr<MetricEntity> MetricRegistry::FindOrCreateEntity(
 //
 // Metric
 //
+std::atomic<int64_t> Metric::current_epoch_{0};
+
 Metric::Metric(const MetricPrototype* prototype)
-  : prototype_(prototype) {
+  : prototype_(prototype),
+    modification_epoch_(current_epoch()) {
 }
 
 Metric::~Metric() {
@@ -620,8 +636,11 @@ std::string StringGauge::value() const {
 }
 
 void StringGauge::set_value(const std::string& value) {
-  std::lock_guard<simple_spinlock> l(lock_);
-  value_ = value;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    value_ = value;
+  }
+  UpdateModificationEpoch();
 }
 
 void StringGauge::WriteValue(JsonWriter* writer) const {
@@ -657,6 +676,7 @@ void Counter::Increment() {
 
 void Counter::IncrementBy(int64_t amount) {
   value_.IncrementBy(amount);
+  UpdateModificationEpoch();
 }
 
 Status Counter::WriteAsJson(JsonWriter* writer,
@@ -686,7 +706,9 @@ HistogramPrototype::HistogramPrototype(const MetricPrototype::CtorArgs& args,
                                        uint64_t max_trackable_value, int num_sig_digits)
   : MetricPrototype(args),
     max_trackable_value_(max_trackable_value),
-    num_sig_digits_(num_sig_digits) {
+    num_sig_digits_(num_sig_digits),
+    prometheus_sum_name_(std::string(args.name_) + "_sum"),
+    prometheus_count_name_(std::string(args.name_) + "_count") {
   // Better to crash at definition time that at instantiation time.
   CHECK(HdrHistogram::IsValidHighestTrackableValue(max_trackable_value))
       << Substitute("Invalid max trackable value on histogram $0: $1",
@@ -707,15 +729,65 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
-    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
+    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())),
+    num_stripes_(std::max(FLAGS_metrics_histogram_stripes, 1)),
+    stripes_(new std::atomic<HdrHistogram*>[num_stripes_ - 1]) {
+  for (size_t i = 0; i != num_stripes_ - 1; ++i) {
+    stripes_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+Histogram::~Histogram() {
+  for (size_t i = 0; i != num_stripes_ - 1; ++i) {
+    delete stripes_[i].load(std::memory_order_acquire);
+  }
+}
+
+HdrHistogram* Histogram::Stripe() {
+  if (num_stripes_ == 1) {
+    return histogram_.get();
+  }
+  // Threads are assigned to stripes round robin, so a set of threads that updates the same
+  // histograms is evenly spread over stripes.
+  static std::atomic<size_t> next_thread_index{0};
+  static thread_local size_t thread_index = next_thread_index.fetch_add(
+      1, std::memory_order_relaxed);
+  const size_t index = thread_index % num_stripes_;
+  if (index == 0) {
+    return histogram_.get();
+  }
+  auto& stripe = stripes_[index - 1];
+  auto* result = stripe.load(std::memory_order_acquire);
+  if (PREDICT_TRUE(result != nullptr)) {
+    return result;
+  }
+  auto new_stripe = std::make_unique<HdrHistogram>(
+      histogram_->highest_trackable_value(), histogram_->num_significant_digits());
+  if (stripe.compare_exchange_strong(result, new_stripe.get(), std::memory_order_acq_rel)) {
+    return new_stripe.release();
+  }
+  return result;
+}
+
+std::unique_ptr<HdrHistogram> Histogram::Snapshot() const {
+  auto result = std::make_unique<HdrHistogram>(*histogram_);
+  for (size_t i = 0; i != num_stripes_ - 1; ++i) {
+    auto* stripe = stripes_[i].load(std::memory_order_acquire);
+    if (stripe != nullptr) {
+      result->MergeFrom(*stripe);
+    }
+  }
+  return result;
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  Stripe()->Increment(value);
+  UpdateModificationEpoch();
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  Stripe()->IncrementBy(value, amount);
+  UpdateModificationEpoch();
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -729,15 +801,10 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
-  HdrHistogram snapshot(*histogram_);
-
-  // Representing the sum and count require suffixed names.
-  std::string hist_name = prototype_->name();
-  auto copy_of_attr = attr;
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name + "_sum", snapshot.TotalSum()));
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name + "_count", snapshot.TotalCount()));
+  // Only totals are exported, so there is no need to merge stripes into a snapshot.
+  const auto* proto = down_cast<const HistogramPrototype*>(prototype_);
+  RETURN_NOT_OK(writer->WriteSingleEntry(attr, proto->prometheus_sum_name(), TotalSum()));
+  RETURN_NOT_OK(writer->WriteSingleEntry(attr, proto->prometheus_count_name(), TotalCount()));
   /*
   // Copy the label map to add the quatiles.
   copy_of_attr["quantile"] = "0.75";
@@ -762,7 +829,8 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                          const MetricJsonOptions& opts) const {
-  HdrHistogram snapshot(*histogram_);
+  const auto snapshot_ptr = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_ptr;
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
     snapshot_pb->set_type(MetricType::Name(prototype_->type()));
@@ -796,22 +864,44 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
 }
 
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  return Snapshot()->CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  uint64_t result = histogram_->TotalCount();
+  for (size_t i = 0; i != num_stripes_ - 1; ++i) {
+    auto* stripe = stripes_[i].load(std::memory_order_acquire);
+    if (stripe != nullptr) {
+      result += stripe->TotalCount();
+    }
+  }
+  return result;
+}
+
+uint64_t Histogram::TotalSum() const {
+  uint64_t result = histogram_->TotalSum();
+  for (size_t i = 0; i != num_stripes_ - 1; ++i) {
+    auto* stripe = stripes_[i].load(std::memory_order_acquire);
+    if (stripe != nullptr) {
+      result += stripe->TotalSum();
+    }
+  }
+  return result;
+}
+
+uint64_t Histogram::ValueAtPercentile(double percentile) const {
+  return Snapshot()->ValueAtPercentile(percentile);
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  return Snapshot()->MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  return Snapshot()->MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  return Snapshot()->MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(
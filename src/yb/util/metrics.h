@@ -239,6 +239,8 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -426,7 +428,8 @@ class MetricType {
 struct MetricJsonOptions {
   MetricJsonOptions() :
     include_raw_histograms(false),
-    include_schema_info(false) {
+    include_schema_info(false),
+    only_modified_in_or_after_epoch(0) {
   }
 
   // Include the raw histogram values and counts in the JSON output.
@@ -439,6 +442,12 @@ struct MetricJsonOptions {
   // unit, etc).
   // Default: false
   bool include_schema_info;
+
+  // Include only metrics that were modified in or after the specified epoch (see
+  // Metric::IncrementEpoch), and entities that have such metrics. So consumers that poll
+  // metrics periodically could fetch only changes since the previous poll.
+  // Default: 0, i.e. all metrics.
+  int64_t only_modified_in_or_after_epoch;
 };
 
 class MetricEntityPrototype {
@@ -585,14 +594,19 @@ class PrometheusWriter {
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
     auto it = attr.find("table_id");
     if (it != attr.end()) {
-      // For tablet level metrics, we roll up on the table level.
-      if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
-        // If it's the first time we see this table, create the aggregate structures.
-        per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
+      // For tablet level metrics, we roll up on the table level. Metrics of the same tablet are
+      // written one after another, so remember the last table to avoid looking it up every time.
+      if (last_table_values_ == nullptr || *last_table_id_ != it->second) {
+        auto table_it = per_table_values_.find(it->second);
+        if (table_it == per_table_values_.end()) {
+          // If it's the first time we see this table, create the aggregate structures.
+          per_table_attributes_[it->second] = attr;
+          table_it = per_table_values_.emplace(it->second, std::map<std::string, double>()).first;
+        }
+        last_table_id_ = &table_it->first;
+        last_table_values_ = &table_it->second;
       }
+      (*last_table_values_)[name] += value;
     } else {
       // For non-tablet level metrics, export them directly.
       RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
@@ -602,33 +616,44 @@ class PrometheusWriter {
 
   CHECKED_STATUS FlushAggregatedValues() {
     for (const auto& entry : per_table_values_) {
-      const auto& attrs = per_table_attributes_[entry.first];
+      // All metrics of the table have the same labels, so they are serialized only once.
+      const std::string labels = SerializeLabels(per_table_attributes_[entry.first]);
       for (const auto& metric_entry : entry.second) {
-        RETURN_NOT_OK(FlushSingleEntry(attrs, metric_entry.first, metric_entry.second));
+        WriteLine(metric_entry.first, labels, metric_entry.second);
       }
     }
     return Status::OK();
   }
 
  private:
+  static std::string SerializeLabels(const MetricEntity::AttributeMap& attr) {
+    std::string result;
+    if (attr.empty()) {
+      return result;
+    }
+    result += '{';
+    for (const auto& entry : attr) {
+      if (result.size() > 1) {
+        result += ',';
+      }
+      result += entry.first;
+      result += "=\"";
+      result += entry.second;
+      result += '"';
+    }
+    result += '}';
+    return result;
+  }
+
+  template<typename T>
+  void WriteLine(const std::string& name, const std::string& labels, const T& value) {
+    *output_ << name << labels << " " << value << " " << timestamp_ << "\n";
+  }
+
   template<typename T>
   CHECKED_STATUS FlushSingleEntry(
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
-    *output_ << name;
-    size_t total_elements = attr.size();
-    if (total_elements > 0) {
-      *output_ << "{";
-      for (const auto& entry : attr) {
-        *output_ << entry.first << "=\"" << entry.second << "\"";
-        if (--total_elements > 0) {
-          *output_ << ",";
-        }
-      }
-      *output_ << "}";
-    }
-    *output_ << " " << value;
-    *output_ << " " << timestamp_;
-    *output_ << std::endl;
+    WriteLine(name, SerializeLabels(attr), value);
     return Status::OK();
   }
 
@@ -636,6 +661,9 @@ class PrometheusWriter {
   std::map<std::string, MetricEntity::AttributeMap> per_table_attributes_;
   // Map from table_id to map of metric_name to value
   std::map<std::string, std::map<std::string, double>> per_table_values_;
+  // Table of the last tablet level entry and its values in per_table_values_.
+  const std::string* last_table_id_ = nullptr;
+  std::map<std::string, double>* last_table_values_ = nullptr;
   // Output stream
   std::stringstream* output_;
   // Timestamp for all metrics belonging to this writer instance.
@@ -657,16 +685,45 @@ class Metric : public RefCountedThreadSafe<Metric> {
 
   const MetricPrototype* prototype() const { return prototype_; }
 
+  // Returns true if this metric was modified in or after the specified epoch.
+  virtual bool ModifiedInOrAfterEpoch(int64_t epoch) const {
+    return modification_epoch_.load(std::memory_order_relaxed) >= epoch;
+  }
+
+  // Starts a new modification epoch and returns its number. Metrics that are modified after this
+  // call are reported as modified in the returned epoch.
+  static int64_t IncrementEpoch() {
+    return current_epoch_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  static int64_t current_epoch() {
+    return current_epoch_.load(std::memory_order_relaxed);
+  }
+
  protected:
   explicit Metric(const MetricPrototype* prototype);
   virtual ~Metric();
 
+  // Should be invoked by every modification of the metric value. Epoch changes rarely, so usually
+  // it is just two relaxed loads.
+  void UpdateModificationEpoch() {
+    const int64_t current_epoch = current_epoch_.load(std::memory_order_relaxed);
+    if (PREDICT_FALSE(modification_epoch_.load(std::memory_order_relaxed) < current_epoch)) {
+      modification_epoch_.store(current_epoch, std::memory_order_relaxed);
+    }
+  }
+
   const MetricPrototype* const prototype_;
 
  private:
   friend class MetricEntity;
   friend class RefCountedThreadSafe<Metric>;
 
+  static std::atomic<int64_t> current_epoch_;
+
+  // Epoch of the last modification of this metric.
+  std::atomic<int64_t> modification_epoch_;
+
   // The time at which we should retire this metric if it is still un-referenced outside
   // of the metrics subsystem. If this metric is not due for retirement, this member is
   // uninitialized.
@@ -901,12 +958,15 @@ class AtomicGauge : public Gauge {
   }
   virtual void set_value(const T& value) {
     value_.Store(static_cast<int64_t>(value), kMemOrderNoBarrier);
+    UpdateModificationEpoch();
   }
   void Increment() {
     value_.IncrementBy(1, kMemOrderNoBarrier);
+    UpdateModificationEpoch();
   }
   virtual void IncrementBy(int64_t amount) {
     value_.IncrementBy(amount, kMemOrderNoBarrier);
+    UpdateModificationEpoch();
   }
   void Decrement() {
     IncrementBy(-1);
@@ -999,6 +1059,11 @@ class FunctionGauge : public Gauge {
     writer->Value(value());
   }
 
+  // Value is computed on demand, so we don't know when it was changed.
+  bool ModifiedInOrAfterEpoch(int64_t epoch) const override {
+    return true;
+  }
+
   // Reset this FunctionGauge to return a specific value.
   // This should be used during destruction. If you want a settable
   // Gauge, use a normal Gauge instead of a FunctionGauge.
@@ -1107,14 +1172,26 @@ class HistogramPrototype : public MetricPrototype {
   int num_sig_digits() const { return num_sig_digits_; }
   virtual MetricType::Type type() const override { return MetricType::kHistogram; }
 
+  // Prometheus names of exported sum and count, prepared once to avoid building them on every
+  // scrape.
+  const std::string& prometheus_sum_name() const { return prometheus_sum_name_; }
+  const std::string& prometheus_count_name() const { return prometheus_count_name_; }
+
  private:
   const uint64_t max_trackable_value_;
   const int num_sig_digits_;
+  const std::string prometheus_sum_name_;
+  const std::string prometheus_count_name_;
   DISALLOW_COPY_AND_ASSIGN(HistogramPrototype);
 };
 
+// Histograms that are updated by many threads are striped. Each thread records values to one of
+// the stripes, so concurrent updates do not contend on the same counters, and stripes are merged
+// when the histogram is read.
 class Histogram : public Metric {
  public:
+  ~Histogram();
+
   // Increment the histogram for the given value.
   // 'value' must be non-negative.
   void Increment(int64_t value);
@@ -1127,6 +1204,12 @@ class Histogram : public Metric {
   // or IncrementBy()).
   uint64_t TotalCount() const;
 
+  // Return the sum of all values added to the histogram.
+  uint64_t TotalSum() const;
+
+  // Return the value at the given percentile, e.g. 50.0 for the median.
+  uint64_t ValueAtPercentile(double percentile) const;
+
   virtual CHECKED_STATUS WriteAsJson(JsonWriter* w,
                              const MetricJsonOptions& opts) const override;
 
@@ -1137,6 +1220,9 @@ class Histogram : public Metric {
   CHECKED_STATUS GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot,
                                 const MetricJsonOptions& opts) const;
 
+  // Returns a (non-consistent) snapshot of values recorded by all stripes.
+  std::unique_ptr<HdrHistogram> Snapshot() const;
+
   uint64_t CountInBucketForValueForTests(uint64_t value) const;
   uint64_t MinValueForTests() const;
   uint64_t MaxValueForTests() const;
@@ -1147,7 +1233,14 @@ class Histogram : public Metric {
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
 
+  // Returns the stripe that should be updated by the current thread.
+  HdrHistogram* Stripe();
+
+  // The first stripe, always allocated.
   const gscoped_ptr<HdrHistogram> histogram_;
+  const size_t num_stripes_;
+  // Remaining stripes, allocated when first used.
+  std::unique_ptr<std::atomic<HdrHistogram*>[]> stripes_;
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -71,4 +71,16 @@ TEST(OsUtilTest, TestSelfNameWithParens) {
   RunTest("a(b(c((d))e)", 111, 222, 333);
 }
 
+TEST(OsUtilTest, TestParseCpuList) {
+  auto cpus = ParseCpuList("0-3,8,10-11");
+  ASSERT_OK(cpus);
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}), *cpus);
+  cpus = ParseCpuList("");
+  ASSERT_OK(cpus);
+  ASSERT_TRUE(cpus->empty());
+  ASSERT_NOK(ParseCpuList("3-1"));
+  ASSERT_NOK(ParseCpuList("a"));
+  ASSERT_NOK(ParseCpuList("1-2-3"));
+}
+
 } // namespace yb
@@ -39,15 +39,23 @@
 #include "yb/util/os-util.h"
 
 #include <fstream>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
+#include "yb/util/env.h"
 #include "yb/util/errno.h"
+#include "yb/util/path_util.h"
 
 using std::ifstream;
 using std::istreambuf_iterator;
@@ -159,4 +167,69 @@ bool RunShellProcess(const string& cmd, string* msg) {
   return false;
 }
 
+Result<std::vector<int>> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> result;
+  std::vector<std::string> ranges = Split(cpu_list, ",", strings::SkipWhitespace());
+  for (const std::string& range : ranges) {
+    std::vector<std::string> bounds = Split(range, "-");
+    int32 first = 0;
+    int32 last = 0;
+    if (bounds.size() > 2 || !safe_strto32(bounds[0], &first) ||
+        !safe_strto32(bounds.back(), &last) || first < 0 || last < first) {
+      return STATUS_FORMAT(InvalidArgument, "Invalid CPU list: $0", cpu_list);
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+Result<std::vector<std::vector<int>>> GetNumaNodeCpus() {
+  static const std::string kNodesDir = "/sys/devices/system/node";
+  std::vector<std::vector<int>> result;
+  Env* env = Env::Default();
+  if (!env->FileExists(kNodesDir)) {
+    return result;
+  }
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env->GetChildren(kNodesDir, &children));
+  std::map<int, std::vector<int>> nodes;
+  for (const std::string& child : children) {
+    int32 node = 0;
+    if (!HasPrefixString(child, "node") || !safe_strto32(child.substr(4), &node)) {
+      continue;
+    }
+    ifstream cpu_list_file(JoinPathSegments(kNodesDir, child, "cpulist"));
+    std::string cpu_list;
+    if (!cpu_list_file.is_open() || !std::getline(cpu_list_file, cpu_list)) {
+      return STATUS_FORMAT(IOError, "Could not read CPU list of NUMA node $0", node);
+    }
+    nodes[node] = VERIFY_RESULT(ParseCpuList(cpu_list));
+  }
+  for (auto& node : nodes) {
+    // Memory only nodes do not have CPUs.
+    if (!node.second.empty()) {
+      result.push_back(std::move(node.second));
+    }
+  }
+  return result;
+}
+
+Status SetCurrentThreadCpuAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0 /* calling thread */, sizeof(cpu_set), &cpu_set) != 0) {
+    return STATUS(RuntimeError, "sched_setaffinity failed", ErrnoToString(errno));
+  }
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Setting CPU affinity is not supported on this platform");
+#endif
+}
+
 } // namespace yb
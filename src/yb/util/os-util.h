@@ -38,7 +38,9 @@
 #define YB_UTIL_OS_UTIL_H
 
 #include <string>
+#include <vector>
 
+#include "yb/util/result.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -74,6 +76,16 @@ Status GetThreadStats(int64_t tid, ThreadStats* stats);
 // first 1k of output otherwise.
 bool RunShellProcess(const std::string& cmd, std::string* msg);
 
+// Parses CPU list in the format used by sysfs, e.g. "0-3,8,10-11".
+Result<std::vector<int>> ParseCpuList(const std::string& cpu_list);
+
+// Returns CPUs of each NUMA node of the machine, ordered by node id. Returns an empty vector when
+// NUMA topology is not available.
+Result<std::vector<std::vector<int>>> GetNumaNodeCpus();
+
+// Allows the calling thread to run only on the specified CPUs.
+CHECKED_STATUS SetCurrentThreadCpuAffinity(const std::vector<int>& cpus);
+
 } // namespace yb
 
 #endif /* YB_UTIL_OS_UTIL_H */
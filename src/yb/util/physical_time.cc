@@ -33,6 +33,13 @@ TAG_FLAG(disable_clock_sync_error, advanced);
 TAG_FLAG(max_clock_sync_error_usec, advanced);
 TAG_FLAG(max_clock_sync_error_usec, runtime);
 
+DEFINE_uint64(clock_sync_check_interval_usec, 100000,
+              "How often the wall clock queries the kernel for the clock synchronization error. "
+              "Between the queries time is read with the cheap clock call, and the last reported "
+              "error is grown by the max drift rate of the clock. 0 to query on every read.");
+TAG_FLAG(clock_sync_check_interval_usec, advanced);
+TAG_FLAG(clock_sync_check_interval_usec, runtime);
+
 DEFINE_uint64(max_clock_skew_usec, 50000,
               "Transaction read clock skew in usec. "
               "This is the maximum allowed time delta between servers of a single cluster.");
@@ -98,6 +105,25 @@ class WallClockImpl : public PhysicalClock {
   Result<PhysicalTime> Now() override {
     const MicrosTime kMicrosPerSec = 1000000;
 
+    // ntp_adjtime is a real system call, that takes the kernel time keeping lock, so it is invoked
+    // only periodically, while the time itself is read through vDSO.
+    const MicrosTime check_interval = GetAtomicFlag(&FLAGS_clock_sync_check_interval_usec);
+    const MicrosTime checked_at = checked_at_.load(std::memory_order_acquire);
+    if (check_interval != 0 && checked_at != 0) {
+      // Loaded after checked_at_, so it is at least as recent, and growing it by the time passed
+      // since checked_at_ gives an upper bound of the current error.
+      const MicrosTime checked_error = checked_error_.load(std::memory_order_relaxed);
+      const MicrosTime now = GetCurrentTimeMicros();
+      if (now >= checked_at && now - checked_at < check_interval) {
+        // The kernel grows maxerror by the max clock frequency error, that is 500 ppm, until it
+        // is reset by the next NTP update.
+        constexpr MicrosTime kMaxErrorGrowthPpm = 500;
+        const MicrosTime drift = ((now - checked_at) * kMaxErrorGrowthPpm + kMicrosPerSec - 1) /
+                                 kMicrosPerSec;
+        return CheckClockSyncError({ now, checked_error + drift });
+      }
+    }
+
     timex tx;
     RETURN_NOT_OK(CallAdjTime(&tx));
 
@@ -106,14 +132,22 @@ class WallClockImpl : public PhysicalClock {
     }
     DCHECK_LT(tx.time.tv_usec, 1000000);
 
-    return CheckClockSyncError(
-        { tx.time.tv_sec * kMicrosPerSec + tx.time.tv_usec,
-          static_cast<yb::MicrosTime>(tx.maxerror) });
+    const PhysicalTime result = {
+        tx.time.tv_sec * kMicrosPerSec + tx.time.tv_usec,
+        static_cast<yb::MicrosTime>(tx.maxerror) };
+    checked_error_.store(result.max_error, std::memory_order_relaxed);
+    checked_at_.store(result.time_point, std::memory_order_release);
+    return CheckClockSyncError(result);
   }
 
   MicrosTime MaxGlobalTime(PhysicalTime time) override {
     return time.time_point + GetAtomicFlag(&FLAGS_max_clock_skew_usec);
   }
+
+ private:
+  // Time and error reported by the last successful ntp_adjtime call.
+  std::atomic<MicrosTime> checked_at_{0};
+  std::atomic<MicrosTime> checked_error_{0};
 };
 #endif
 
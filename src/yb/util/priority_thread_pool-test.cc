@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/priority_thread_pool.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class PriorityThreadPoolTest : public YBTest {
+};
+
+namespace {
+
+class TestTask : public PriorityThreadPoolTask {
+ public:
+  TestTask(int64_t priority, const void* owner, std::mutex* mutex, std::vector<int64_t>* log,
+           CountDownLatch* block = nullptr)
+      : priority_(priority), owner_(owner), mutex_(mutex), log_(log), block_(block) {}
+
+  void Run(const Status& status) override {
+    if (block_) {
+      block_->Wait();
+    }
+    std::lock_guard<std::mutex> lock(*mutex_);
+    log_->push_back(status.ok() ? priority_ : -priority_);
+  }
+
+  int64_t Priority() const override {
+    return priority_;
+  }
+
+  const void* owner() const override {
+    return owner_;
+  }
+
+ private:
+  const int64_t priority_;
+  const void* const owner_;
+  std::mutex* const mutex_;
+  std::vector<int64_t>* const log_;
+  CountDownLatch* const block_;
+};
+
+} // namespace
+
+TEST_F(PriorityThreadPoolTest, RunsHighestPriorityFirst) {
+  PriorityThreadPool pool(1);
+  std::mutex mutex;
+  std::vector<int64_t> log;
+  CountDownLatch block(1);
+  const int kOwner1 = 1, kOwner2 = 2;
+
+  std::unique_ptr<PriorityThreadPoolTask> blocker(
+      new TestTask(1000, &kOwner1, &mutex, &log, &block));
+  ASSERT_OK(pool.Submit(&blocker));
+  ASSERT_OK(WaitFor([&pool] { return pool.NumRunningTasks() == 1; }, MonoDelta::FromSeconds(10),
+                    "Blocker started"));
+
+  for (int64_t priority : {3, 7, 1, 5}) {
+    std::unique_ptr<PriorityThreadPoolTask> task(
+        new TestTask(priority, priority == 5 ? &kOwner2 : &kOwner1, &mutex, &log));
+    ASSERT_OK(pool.Submit(&task));
+  }
+  ASSERT_EQ(4, pool.NumQueuedTasks());
+
+  // Removed tasks are aborted in the calling thread.
+  pool.Remove(&kOwner2);
+  ASSERT_EQ(3, pool.NumQueuedTasks());
+
+  block.CountDown();
+  ASSERT_OK(WaitFor([&pool] {
+    return pool.NumQueuedTasks() == 0 && pool.NumRunningTasks() == 0;
+  }, MonoDelta::FromSeconds(10), "All tasks completed"));
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ((std::vector<int64_t>{-5, 1000, 7, 3, 1}), log);
+}
+
+TEST_F(PriorityThreadPoolTest, Shutdown) {
+  PriorityThreadPool pool(2);
+  std::mutex mutex;
+  std::vector<int64_t> log;
+  const int kOwner = 0;
+  pool.Shutdown();
+
+  std::unique_ptr<PriorityThreadPoolTask> task(new TestTask(1, &kOwner, &mutex, &log));
+  ASSERT_NOK(pool.Submit(&task));
+  // Task is left with the caller.
+  ASSERT_NE(nullptr, task);
+}
+
+} // namespace yb
@@ -0,0 +1,126 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/priority_thread_pool.h"
+
+#include <algorithm>
+
+#include "yb/util/logging.h"
+#include "yb/util/thread.h"
+
+namespace yb {
+
+PriorityThreadPool::PriorityThreadPool(size_t max_running_tasks) {
+  CHECK_GT(max_running_tasks, 0);
+  threads_.reserve(max_running_tasks);
+  for (size_t i = 0; i != max_running_tasks; ++i) {
+    scoped_refptr<Thread> thread;
+    CHECK_OK(Thread::Create(
+        "priority_thread_pool", "priority-worker", &PriorityThreadPool::Execute, this, &thread));
+    threads_.push_back(std::move(thread));
+  }
+}
+
+PriorityThreadPool::~PriorityThreadPool() {
+  Shutdown();
+}
+
+Status PriorityThreadPool::Submit(std::unique_ptr<PriorityThreadPoolTask>* task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closing_) {
+      return STATUS(ServiceUnavailable, "Priority thread pool is shutting down");
+    }
+    queue_.push_back(std::move(*task));
+  }
+  cond_.notify_one();
+  return Status::OK();
+}
+
+void PriorityThreadPool::Remove(const void* owner) {
+  std::vector<std::unique_ptr<PriorityThreadPoolTask>> removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::stable_partition(queue_.begin(), queue_.end(), [owner](const auto& task) {
+      return task->owner() != owner;
+    });
+    std::move(it, queue_.end(), std::back_inserter(removed));
+    queue_.erase(it, queue_.end());
+  }
+  // Tasks are aborted without holding the mutex, so they could submit new tasks.
+  const Status status = STATUS(Aborted, "Task removed from priority thread pool");
+  for (const auto& task : removed) {
+    task->Run(status);
+  }
+}
+
+void PriorityThreadPool::Shutdown() {
+  std::vector<std::unique_ptr<PriorityThreadPoolTask>> removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closing_) {
+      return;
+    }
+    closing_ = true;
+    removed.swap(queue_);
+  }
+  cond_.notify_all();
+  const Status status = STATUS(Aborted, "Priority thread pool shutdown");
+  for (const auto& task : removed) {
+    task->Run(status);
+  }
+  for (const auto& thread : threads_) {
+    thread->Join();
+  }
+}
+
+size_t PriorityThreadPool::NumQueuedTasks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size();
+}
+
+size_t PriorityThreadPool::NumRunningTasks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return running_tasks_;
+}
+
+void PriorityThreadPool::Execute() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cond_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+    if (closing_) {
+      return;
+    }
+    // Priorities are dynamic, so the queue is scanned each time. It contains at most a few tasks
+    // per owner, so it is cheaper than maintaining a heap of changing priorities.
+    auto best = queue_.begin();
+    int64_t best_priority = (*best)->Priority();
+    for (auto it = best + 1; it != queue_.end(); ++it) {
+      const int64_t priority = (*it)->Priority();
+      if (priority > best_priority) {
+        best = it;
+        best_priority = priority;
+      }
+    }
+    std::unique_ptr<PriorityThreadPoolTask> task = std::move(*best);
+    queue_.erase(best);
+    ++running_tasks_;
+    lock.unlock();
+    task->Run(Status::OK());
+    task.reset();
+    lock.lock();
+    --running_tasks_;
+  }
+}
+
+} // namespace yb
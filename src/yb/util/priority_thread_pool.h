@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_PRIORITY_THREAD_POOL_H
+#define YB_UTIL_PRIORITY_THREAD_POOL_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Thread;
+
+class PriorityThreadPoolTask {
+ public:
+  virtual ~PriorityThreadPoolTask() = default;
+
+  // Invoked in a pool thread with OK status, or with not OK status when the task is removed from
+  // the pool before it was started.
+  virtual void Run(const Status& status) = 0;
+
+  // Priority of the task, higher priority tasks are started first.
+  // Evaluated each time a task is picked, so it could reflect the current state of the owner.
+  // Invoked with pool mutex held, so should be cheap and must not lock anything that could be held
+  // while submitting tasks.
+  virtual int64_t Priority() const = 0;
+
+  // Owner of the task, used to remove all tasks of the owner from the pool.
+  virtual const void* owner() const = 0;
+};
+
+// Thread pool that runs at most max_running_tasks tasks at once, and when a thread becomes free
+// starts the queued task with the highest priority.
+class PriorityThreadPool {
+ public:
+  explicit PriorityThreadPool(size_t max_running_tasks);
+  ~PriorityThreadPool();
+
+  // Takes ownership of the task on success. Submitting to a pool that is shut down fails, and
+  // leaves the task with the caller.
+  CHECKED_STATUS Submit(std::unique_ptr<PriorityThreadPoolTask>* task);
+
+  // Removes all queued tasks of the owner, invoking them with Aborted status in the current thread.
+  // Running tasks are not affected.
+  void Remove(const void* owner);
+
+  // Aborts all queued tasks and waits for running tasks to complete.
+  void Shutdown();
+
+  size_t NumQueuedTasks() const;
+  size_t NumRunningTasks() const;
+
+ private:
+  void Execute();
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  bool closing_ = false;
+  size_t running_tasks_ = 0;
+  std::vector<std::unique_ptr<PriorityThreadPoolTask>> queue_;
+  std::vector<scoped_refptr<Thread>> threads_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_PRIORITY_THREAD_POOL_H
@@ -0,0 +1,91 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/util/random_util.h"
+#include "yb/util/space_saving.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class SpaceSavingTest : public YBTest {};
+
+TEST_F(SpaceSavingTest, Exact) {
+  SpaceSaving<int> sketch(4);
+  for (int i = 0; i != 4; ++i) {
+    sketch.Record(i, i + 1);
+  }
+  auto top = sketch.Top(10);
+  ASSERT_EQ(4, top.size());
+  for (int i = 0; i != 4; ++i) {
+    ASSERT_EQ(3 - i, top[i].key);
+    ASSERT_EQ(4 - i, top[i].count);
+    ASSERT_EQ(0, top[i].error);
+  }
+  ASSERT_EQ(10, sketch.total());
+
+  top = sketch.Top(2);
+  ASSERT_EQ(2, top.size());
+  ASSERT_EQ(3, top[0].key);
+}
+
+TEST_F(SpaceSavingTest, HeavyHitters) {
+  constexpr int kCapacity = 16;
+  constexpr int kNumHotKeys = 4;
+  constexpr int kNumOps = 100000;
+  SpaceSaving<int> sketch(kCapacity);
+  std::vector<uint64_t> frequency(kNumHotKeys);
+  // Half of the operations go to a few hot keys, the rest is spread over many cold keys.
+  for (int i = 0; i != kNumOps; ++i) {
+    if (i % 2 == 0) {
+      const int key = RandomUniformInt(0, kNumHotKeys - 1);
+      ++frequency[key];
+      sketch.Record(key);
+    } else {
+      sketch.Record(RandomUniformInt(kNumHotKeys, 1000000));
+    }
+  }
+  ASSERT_EQ(kNumOps, sketch.total());
+  ASSERT_EQ(kCapacity, sketch.size());
+
+  auto top = sketch.Top(kNumHotKeys);
+  ASSERT_EQ(kNumHotKeys, top.size());
+  for (const auto& entry : top) {
+    ASSERT_LT(entry.key, kNumHotKeys);
+    ASSERT_GE(entry.count, frequency[entry.key]);
+    ASSERT_LE(entry.guaranteed_count(), frequency[entry.key]);
+    ASSERT_LE(entry.error, kNumOps / kCapacity);
+  }
+}
+
+TEST_F(SpaceSavingTest, Decay) {
+  SpaceSaving<int> sketch(4);
+  sketch.Record(1, 10);
+  sketch.Record(2, 1);
+  sketch.Decay(2);
+  ASSERT_EQ(5, sketch.total());
+  auto top = sketch.Top(10);
+  ASSERT_EQ(1, top.size());
+  ASSERT_EQ(1, top[0].key);
+  ASSERT_EQ(5, top[0].count);
+
+  // Removed key is tracked again from scratch.
+  sketch.Record(2, 7);
+  top = sketch.Top(10);
+  ASSERT_EQ(2, top.size());
+  ASSERT_EQ(2, top[0].key);
+  ASSERT_EQ(7, top[0].count);
+}
+
+} // namespace yb
@@ -0,0 +1,119 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SPACE_SAVING_H
+#define YB_UTIL_SPACE_SAVING_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace yb {
+
+// Space-saving sketch (Metwally et al.) of the most frequent keys of a stream, using a fixed
+// number of counters.
+//
+// Each tracked key has a count, that overestimates its real frequency by at most error. When a
+// key that is not tracked arrives and all counters are used, the key with the smallest count is
+// replaced, and the new key inherits its count as error. So every key with frequency greater than
+// total / capacity is guaranteed to be tracked.
+//
+// Not thread safe.
+template <class Key, class Hash = std::hash<Key>>
+class SpaceSaving {
+ public:
+  struct Entry {
+    Key key;
+    uint64_t count;
+    uint64_t error;
+
+    // Lower bound of the real frequency of the key.
+    uint64_t guaranteed_count() const { return count - error; }
+  };
+
+  explicit SpaceSaving(size_t capacity) : capacity_(capacity) {
+    CHECK_GT(capacity, 0);
+    entries_.reserve(capacity);
+    index_.reserve(capacity);
+  }
+
+  void Record(const Key& key, uint64_t weight = 1) {
+    total_ += weight;
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_[it->second].count += weight;
+      return;
+    }
+    if (entries_.size() < capacity_) {
+      index_.emplace(key, entries_.size());
+      entries_.push_back(Entry{key, weight, 0});
+      return;
+    }
+    // Capacity is expected to be small, so the minimum is found by a linear scan.
+    auto min_it = std::min_element(
+        entries_.begin(), entries_.end(),
+        [](const Entry& lhs, const Entry& rhs) { return lhs.count < rhs.count; });
+    index_.erase(min_it->key);
+    index_.emplace(key, min_it - entries_.begin());
+    min_it->key = key;
+    min_it->error = min_it->count;
+    min_it->count += weight;
+  }
+
+  // Returns up to limit tracked keys with the greatest counts, in descending order of count.
+  std::vector<Entry> Top(size_t limit) const {
+    std::vector<Entry> result(entries_);
+    auto middle = result.begin() + std::min(limit, result.size());
+    std::partial_sort(
+        result.begin(), middle, result.end(),
+        [](const Entry& lhs, const Entry& rhs) { return lhs.count > rhs.count; });
+    result.erase(middle, result.end());
+    return result;
+  }
+
+  // Divides all counts by factor, so the sketch reflects recent keys. Entries with zero count are
+  // removed.
+  void Decay(uint64_t factor) {
+    DCHECK_GT(factor, 0);
+    total_ /= factor;
+    size_t out = 0;
+    for (auto& entry : entries_) {
+      entry.count /= factor;
+      entry.error /= factor;
+      if (entry.count == 0) {
+        index_.erase(entry.key);
+        continue;
+      }
+      index_[entry.key] = out;
+      entries_[out++] = entry;
+    }
+    entries_.erase(entries_.begin() + out, entries_.end());
+  }
+
+  // Sum of weights of all recorded keys, including keys that are not tracked.
+  uint64_t total() const { return total_; }
+
+  size_t size() const { return entries_.size(); }
+
+ private:
+  const size_t capacity_;
+  std::vector<Entry> entries_;
+  std::unordered_map<Key, size_t, Hash> index_;
+  uint64_t total_ = 0;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SPACE_SAVING_H
@@ -0,0 +1,154 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/span_recorder.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+#include <boost/circular_buffer.hpp>
+
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/walltime.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/locks.h"
+
+DEFINE_int32(sampled_spans_per_thread, 1024,
+             "Max number of spans of sampled traces that are kept by each thread until they are "
+             "collected. Older spans are dropped.");
+TAG_FLAG(sampled_spans_per_thread, advanced);
+
+namespace yb {
+
+namespace {
+
+// Spans recorded by a single thread. Its lock is contended only when spans are collected.
+class SpanBuffer {
+ public:
+  SpanBuffer() : spans_(std::max(FLAGS_sampled_spans_per_thread, 1)) {}
+
+  void Add(SpanRecord span) {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    spans_.push_back(std::move(span));
+  }
+
+  void MoveTo(std::vector<SpanRecord>* out) {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    for (auto& span : spans_) {
+      out->push_back(std::move(span));
+    }
+    spans_.clear();
+  }
+
+ private:
+  simple_spinlock lock_;
+  boost::circular_buffer<SpanRecord> spans_;
+};
+
+// Buffers of all threads that recorded spans. Buffers of exited threads are kept until their spans
+// are collected.
+class SpanBuffers {
+ public:
+  static SpanBuffers& Instance() {
+    static SpanBuffers instance;
+    return instance;
+  }
+
+  std::shared_ptr<SpanBuffer> Register() {
+    auto result = std::make_shared<SpanBuffer>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.push_back(result);
+    return result;
+  }
+
+  std::vector<SpanRecord> Collect() {
+    std::vector<std::shared_ptr<SpanBuffer>> buffers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers = buffers_;
+      // Besides the copy above, buffer of a finished thread is referenced only by this registry,
+      // so it could be dropped after its spans are collected.
+      auto it = std::remove_if(buffers_.begin(), buffers_.end(), [](const auto& buffer) {
+        return buffer.use_count() == 2;
+      });
+      buffers_.erase(it, buffers_.end());
+    }
+    std::vector<SpanRecord> result;
+    for (const auto& buffer : buffers) {
+      buffer->MoveTo(&result);
+    }
+    return result;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<SpanBuffer>> buffers_;
+};
+
+SpanBuffer& ThreadSpanBuffer() {
+  static thread_local std::shared_ptr<SpanBuffer> buffer = SpanBuffers::Instance().Register();
+  return *buffer;
+}
+
+std::string HexId(uint64_t id) {
+  char buffer[kFastToBufferSize];
+  return FastHex64ToBuffer(id, buffer);
+}
+
+} // namespace
+
+void RecordSpan(const TraceContext& context, SpanKind kind, std::string name, MonoTime start) {
+  DCHECK(context.sampled());
+  SpanRecord span;
+  span.context = context;
+  span.kind = kind;
+  span.name = std::move(name);
+  // Span duration is measured with monotonic clock, while exported times should use wall clock.
+  span.end_time_unix_micros = GetCurrentTimeMicros();
+  span.start_time_unix_micros =
+      span.end_time_unix_micros - MonoTime::Now().GetDeltaSince(start).ToMicroseconds();
+  ThreadSpanBuffer().Add(std::move(span));
+}
+
+std::vector<SpanRecord> CollectRecordedSpans() {
+  return SpanBuffers::Instance().Collect();
+}
+
+void WriteSpansAsJson(const std::vector<SpanRecord>& spans, JsonWriter* writer) {
+  writer->StartArray();
+  for (const auto& span : spans) {
+    writer->StartObject();
+    writer->String("traceId");
+    writer->String(HexId(span.context.trace_id_high) + HexId(span.context.trace_id_low));
+    writer->String("spanId");
+    writer->String(HexId(span.context.span_id));
+    if (span.context.parent_span_id != 0) {
+      writer->String("parentSpanId");
+      writer->String(HexId(span.context.parent_span_id));
+    }
+    writer->String("name");
+    writer->String(span.name);
+    writer->String("kind");
+    writer->String(span.kind == SpanKind::kServer ? "SPAN_KIND_SERVER" : "SPAN_KIND_CLIENT");
+    writer->String("startTimeUnixNano");
+    writer->Int64(span.start_time_unix_micros * 1000);
+    writer->String("endTimeUnixNano");
+    writer->Int64(span.end_time_unix_micros * 1000);
+    writer->EndObject();
+  }
+  writer->EndArray();
+}
+
+} // namespace yb
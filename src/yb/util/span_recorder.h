@@ -0,0 +1,55 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SPAN_RECORDER_H
+#define YB_UTIL_SPAN_RECORDER_H
+
+#include <string>
+#include <vector>
+
+#include "yb/util/monotime.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+
+class JsonWriter;
+
+enum class SpanKind {
+  kServer,
+  kClient,
+};
+
+// Completed span of a sampled trace.
+struct SpanRecord {
+  TraceContext context;
+  SpanKind kind = SpanKind::kServer;
+  std::string name;
+  int64_t start_time_unix_micros = 0;
+  int64_t end_time_unix_micros = 0;
+};
+
+// Records span of the operation with the specified sampled context, that was started at start and
+// is finished now. Spans are kept in a ring buffer of the current thread, so recording does not
+// contend with other threads, and the oldest spans are overwritten when they are not collected
+// in time.
+void RecordSpan(const TraceContext& context, SpanKind kind, std::string name, MonoTime start);
+
+// Removes recorded spans from buffers of all threads and returns them.
+std::vector<SpanRecord> CollectRecordedSpans();
+
+// Writes spans as a JSON array, using attribute names of the OpenTelemetry JSON encoding.
+void WriteSpansAsJson(const std::vector<SpanRecord>& spans, JsonWriter* writer);
+
+} // namespace yb
+
+#endif // YB_UTIL_SPAN_RECORDER_H
@@ -517,6 +517,38 @@ TEST_F(TestThreadPool, TestTokenSubmitsNonSequential) {
   b->Wait();
 }
 
+TEST_F(TestThreadPool, TestConcurrencyLimitedToken) {
+  const int kMaxConcurrency = 3;
+  const int kNumSubmissions = 20;
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_max_threads(kMaxConcurrency * 3)
+                .Build(&thread_pool));
+  unique_ptr<ThreadPoolToken> limited = thread_pool->NewConcurrencyLimitedToken(kMaxConcurrency);
+  unique_ptr<ThreadPoolToken> other = thread_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT);
+
+  std::atomic<int> running(0);
+  std::atomic<int> max_running(0);
+  for (int i = 0; i != kNumSubmissions; ++i) {
+    ASSERT_OK(limited->SubmitFunc([&running, &max_running] {
+      int current = ++running;
+      int max_value = max_running.load();
+      while (current > max_value && !max_running.compare_exchange_weak(max_value, current)) {}
+      SleepFor(MonoDelta::FromMilliseconds(10));
+      --running;
+    }));
+  }
+
+  // Limited token should leave threads for other tokens.
+  CountDownLatch latch(1);
+  ASSERT_OK(other->SubmitFunc([&latch] { latch.CountDown(); }));
+  ASSERT_TRUE(latch.WaitFor(MonoDelta::FromSeconds(5)));
+
+  limited->Wait();
+  ASSERT_EQ(0, running.load());
+  ASSERT_EQ(kMaxConcurrency, max_running.load());
+}
+
 TEST_P(TestThreadPoolTokenTypes, TestTokenShutdown) {
   gscoped_ptr<ThreadPool> thread_pool;
   ASSERT_OK(ThreadPoolBuilder("test")
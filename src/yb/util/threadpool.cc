@@ -117,14 +117,16 @@ Status ThreadPoolBuilder::Build(unique_ptr<ThreadPool>* pool) const {
 ////////////////////////////////////////////////////////
 
 ThreadPoolToken::ThreadPoolToken(ThreadPool* pool,
-                                 ThreadPool::ExecutionMode mode,
+                                 int max_concurrency,
                                  ThreadPoolMetrics metrics)
-    : mode_(mode),
+    : max_concurrency_(max_concurrency),
       pool_(pool),
       metrics_(std::move(metrics)),
       state_(ThreadPoolTokenState::kIdle),
       not_running_cond_(&pool->lock_),
-      active_threads_(0) {
+      active_threads_(0),
+      queue_entries_(0) {
+  CHECK_GT(max_concurrency, 0);
 }
 
 ThreadPoolToken::~ThreadPoolToken() {
@@ -177,6 +179,7 @@ void ThreadPoolToken::Shutdown() {
           it++;
         }
       }
+      queue_entries_ = 0;
 
       if (active_threads_ == 0) {
         Transition(ThreadPoolTokenState::kQuiesced);
@@ -351,6 +354,7 @@ void ThreadPool::Shutdown() {
     if (!t->entries_.empty()) {
       to_release.emplace_back(std::move(t->entries_));
     }
+    t->queue_entries_ = 0;
     switch (t->state()) {
       case ThreadPoolTokenState::kIdle:
         // The token is idle; we can quiesce it immediately.
@@ -402,8 +406,14 @@ unique_ptr<ThreadPoolToken> ThreadPool::NewToken(ExecutionMode mode) {
 
 unique_ptr<ThreadPoolToken> ThreadPool::NewTokenWithMetrics(
     ExecutionMode mode, ThreadPoolMetrics metrics) {
+  return NewConcurrencyLimitedToken(
+      mode == ExecutionMode::SERIAL ? 1 : std::numeric_limits<int>::max(), std::move(metrics));
+}
+
+unique_ptr<ThreadPoolToken> ThreadPool::NewConcurrencyLimitedToken(
+    int max_concurrency, ThreadPoolMetrics metrics) {
   MutexLock guard(lock_);
-  unique_ptr<ThreadPoolToken> t(new ThreadPoolToken(this, mode, std::move(metrics)));
+  unique_ptr<ThreadPoolToken> t(new ThreadPoolToken(this, max_concurrency, std::move(metrics)));
   InsertOrDie(&tokens_, t.get());
   return t;
 }
@@ -466,8 +476,10 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
   // It's also harmless.
   //
   // Of course, we never create more than max_threads_ threads no matter what.
+  // Tasks of a token that already runs its max number of concurrent tasks will not be picked
+  // up by a new thread.
   int threads_from_this_submit =
-      token->IsActive() && token->mode() == ExecutionMode::SERIAL ? 0 : 1;
+      token->queue_entries_ + token->active_threads_ < token->max_concurrency_ ? 1 : 0;
   int inactive_threads = num_threads_ - active_threads_;
   int additional_threads = (queue_.size() + threads_from_this_submit) - inactive_threads;
   if (additional_threads > 0 && num_threads_ < max_threads_) {
@@ -499,12 +511,12 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
   DCHECK(state == ThreadPoolTokenState::kIdle ||
          state == ThreadPoolTokenState::kRunning);
   token->entries_.emplace_back(std::move(e));
-  if (state == ThreadPoolTokenState::kIdle ||
-      token->mode() == ExecutionMode::CONCURRENT) {
+  if (token->MayQueueTask()) {
     queue_.emplace_back(token);
-    if (state == ThreadPoolTokenState::kIdle) {
-      token->Transition(ThreadPoolTokenState::kRunning);
-    }
+    ++token->queue_entries_;
+  }
+  if (state == ThreadPoolTokenState::kIdle) {
+    token->Transition(ThreadPoolTokenState::kRunning);
   }
   int length_at_submit = total_queued_tasks_++;
 
@@ -576,6 +588,7 @@ void ThreadPool::DispatchThread(bool permanent) {
     // Get the next token and task to execute.
     ThreadPoolToken* token = queue_.front();
     queue_.pop_front();
+    --token->queue_entries_;
     DCHECK_EQ(ThreadPoolTokenState::kRunning, token->state());
     DCHECK(!token->entries_.empty());
     Task task = std::move(token->entries_.front());
@@ -627,19 +640,19 @@ void ThreadPool::DispatchThread(bool permanent) {
     // Possible states:
     // 1. The token was shut down while we ran its task. Transition to kQuiesced.
     // 2. The token has no more queued tasks. Transition back to kIdle.
-    // 3. The token has more tasks. Requeue it and transition back to RUNNABLE.
+    // 3. The token has more tasks. Requeue it, if it was limited by max concurrency.
     ThreadPoolTokenState state = token->state();
     DCHECK(state == ThreadPoolTokenState::kRunning ||
            state == ThreadPoolTokenState::kQuiescing);
-    if (--token->active_threads_ == 0) {
-      if (state == ThreadPoolTokenState::kQuiescing) {
-        DCHECK(token->entries_.empty());
-        token->Transition(ThreadPoolTokenState::kQuiesced);
-      } else if (token->entries_.empty()) {
-        token->Transition(ThreadPoolTokenState::kIdle);
-      } else if (token->mode() == ExecutionMode::SERIAL) {
-        queue_.emplace_back(token);
-      }
+    --token->active_threads_;
+    if (token->active_threads_ == 0 && state == ThreadPoolTokenState::kQuiescing) {
+      DCHECK(token->entries_.empty());
+      token->Transition(ThreadPoolTokenState::kQuiesced);
+    } else if (token->active_threads_ == 0 && token->entries_.empty()) {
+      token->Transition(ThreadPoolTokenState::kIdle);
+    } else if (state == ThreadPoolTokenState::kRunning && token->MayQueueTask()) {
+      queue_.emplace_back(token);
+      ++token->queue_entries_;
     }
     if (--active_threads_ == 0) {
       idle_cond_.Broadcast();
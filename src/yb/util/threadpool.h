@@ -261,6 +261,12 @@ class ThreadPool {
   std::unique_ptr<ThreadPoolToken> NewTokenWithMetrics(ExecutionMode mode,
                                                        ThreadPoolMetrics metrics);
 
+  // Allocates a token whose tasks may be executed concurrently, but at most 'max_concurrency'
+  // of them at once. It allows several subsystems to share threads of one pool, while keeping
+  // each of them from occupying all threads.
+  std::unique_ptr<ThreadPoolToken> NewConcurrencyLimitedToken(int max_concurrency,
+                                                              ThreadPoolMetrics metrics = {});
+
  private:
   friend class ThreadPoolBuilder;
   friend class ThreadPoolToken;
@@ -323,7 +329,8 @@ class ThreadPool {
   // Protected by lock_.
   std::unordered_set<ThreadPoolToken*> tokens_;
 
-  // FIFO of tokens from which tasks should be executed. Does not own the
+  // FIFO of tokens from which tasks should be executed. A token is present once per task that
+  // could be started without exceeding its max concurrency. Does not own the
   // tokens; they are owned by clients and are removed from the FIFO on shutdown.
   //
   // Protected by lock_.
@@ -420,7 +427,7 @@ class ThreadPoolToken {
   // Constructs a new token.
   //
   // The token may not outlive its thread pool ('pool').
-  ThreadPoolToken(ThreadPool* pool, ThreadPool::ExecutionMode mode, ThreadPoolMetrics metrics);
+  ThreadPoolToken(ThreadPool* pool, int max_concurrency, ThreadPoolMetrics metrics);
 
   // Changes this token's state to 'new_state' taking actions as needed.
   void Transition(ThreadPoolTokenState new_state);
@@ -438,11 +445,17 @@ class ThreadPoolToken {
            state_ != ThreadPoolTokenState::kQuiesced;
   }
 
+  // Returns true if one more task of this token could be placed into the pool's queue.
+  bool MayQueueTask() const {
+    return queue_entries_ + active_threads_ < max_concurrency_ &&
+           queue_entries_ < static_cast<int64_t>(entries_.size());
+  }
+
   ThreadPoolTokenState state() const { return state_; }
-  ThreadPool::ExecutionMode mode() const { return mode_; }
 
-  // Token's configured execution mode.
-  const ThreadPool::ExecutionMode mode_;
+  // Max number of tasks of this token, that could run concurrently. It is 1 for
+  // ExecutionMode::SERIAL tokens.
+  const int max_concurrency_;
 
   // Pointer to the token's thread pool.
   ThreadPool* pool_;
@@ -464,6 +477,9 @@ class ThreadPoolToken {
   // token.
   int active_threads_;
 
+  // Number of times this token is present in the pool's queue.
+  int queue_entries_;
+
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolToken);
 };
 
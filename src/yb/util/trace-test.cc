@@ -30,7 +30,9 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <string>
+#include <thread>
 
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
@@ -41,6 +43,8 @@
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/debug/trace_event_synthetic_delay.h"
 #include "yb/util/debug/trace_logging.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/span_recorder.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
 
@@ -52,6 +56,8 @@ using rapidjson::Value;
 using std::string;
 using std::vector;
 
+DECLARE_double(trace_sampling_rate);
+
 namespace yb {
 
 class TraceTest : public YBTest {
@@ -121,6 +127,70 @@ TEST_F(TraceTest, TestChildTrace) {
             XOutDigits(traceA->DumpToString(false)));
 }
 
+TEST_F(TraceTest, TestSampledContext) {
+  FLAGS_trace_sampling_rate = 0;
+  ASSERT_FALSE(TraceContext::NewRootIfSampled().sampled());
+
+  FLAGS_trace_sampling_rate = 1;
+  auto root = TraceContext::NewRootIfSampled();
+  ASSERT_TRUE(root.sampled());
+  ASSERT_NE(0, root.span_id);
+  ASSERT_EQ(0, root.parent_span_id);
+
+  auto child = root.ChildSpan();
+  ASSERT_EQ(root.trace_id_high, child.trace_id_high);
+  ASSERT_EQ(root.trace_id_low, child.trace_id_low);
+  ASSERT_EQ(root.span_id, child.parent_span_id);
+  ASSERT_NE(root.span_id, child.span_id);
+
+  // Child traces inherit context, and sampled trace is adopted even when tracing is disabled.
+  FLAGS_enable_tracing = false;
+  scoped_refptr<Trace> parent_trace(new Trace);
+  scoped_refptr<Trace> child_trace(new Trace);
+  parent_trace->set_context(root);
+  parent_trace->AddChildTrace(child_trace.get());
+  ASSERT_EQ(root.span_id, child_trace->context().span_id);
+  {
+    ADOPT_TRACE(child_trace.get());
+    ASSERT_EQ(child_trace.get(), Trace::CurrentTrace());
+  }
+  ASSERT_EQ(nullptr, Trace::CurrentTrace());
+}
+
+TEST_F(TraceTest, TestRecordSpans) {
+  // Drop spans recorded by other tests.
+  CollectRecordedSpans();
+
+  FLAGS_trace_sampling_rate = 1;
+  auto root = TraceContext::NewRootIfSampled();
+  auto start = MonoTime::Now();
+  RecordSpan(root, SpanKind::kServer, "server", start);
+  std::thread thread([&root, start] {
+    RecordSpan(root.ChildSpan(), SpanKind::kClient, "client", start);
+  });
+  thread.join();
+
+  auto spans = CollectRecordedSpans();
+  ASSERT_EQ(2, spans.size());
+  std::sort(spans.begin(), spans.end(), [](const SpanRecord& lhs, const SpanRecord& rhs) {
+    return lhs.name < rhs.name;
+  });
+  ASSERT_EQ("client", spans[0].name);
+  ASSERT_EQ(SpanKind::kClient, spans[0].kind);
+  ASSERT_EQ(root.span_id, spans[0].context.parent_span_id);
+  ASSERT_EQ("server", spans[1].name);
+  ASSERT_LE(spans[1].start_time_unix_micros, spans[1].end_time_unix_micros);
+
+  // Spans are returned only once.
+  ASSERT_TRUE(CollectRecordedSpans().empty());
+
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::COMPACT);
+  WriteSpansAsJson(spans, &writer);
+  ASSERT_STR_CONTAINS(out.str(), "\"name\":\"server\"");
+  ASSERT_STR_CONTAINS(out.str(), "\"kind\":\"SPAN_KIND_CLIENT\"");
+}
+
 static void GenerateTraceEvents(int thread_id,
                                 int num_events) {
   for (int i = 0; i < num_events; i++) {
@@ -35,6 +35,7 @@
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <limits>
 #include <strstream>
 #include <string>
 #include <vector>
@@ -45,13 +46,22 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/memory/arena.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/object_pool.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_tracing, false, "Flag to enable/disable tracing across the code.");
 
+DEFINE_double(trace_sampling_rate, 0,
+              "Fraction of requests, received by CQL and Redis servers, that are traced across "
+              "all servers they reach. Spans of sampled requests are available at /sampled-spans. "
+              "Entries are added to traces only when enable_tracing is set.");
+TAG_FLAG(trace_sampling_rate, advanced);
+TAG_FLAG(trace_sampling_rate, runtime);
+
 namespace yb {
 
 using strings::internal::SubstituteArg;
@@ -159,7 +169,9 @@ int64_t GetCurrentMicrosFast(MonoTime now) {
 } // namespace
 
 ScopedAdoptTrace::ScopedAdoptTrace(Trace* t)
-    : old_trace_(Trace::threadlocal_trace_), is_enabled_(GetAtomicFlag(&FLAGS_enable_tracing)) {
+    : old_trace_(Trace::threadlocal_trace_),
+      // Sampled traces are adopted even when tracing is disabled, to propagate their context.
+      is_enabled_(GetAtomicFlag(&FLAGS_enable_tracing) || (t && t->context().sampled())) {
   if (is_enabled_) {
     trace_ = t;
     Trace::threadlocal_trace_ = t;
@@ -212,6 +224,24 @@ struct TraceEntry {
   }
 };
 
+TraceContext TraceContext::ChildSpan() const {
+  TraceContext result = *this;
+  result.parent_span_id = span_id;
+  // Zero span id is treated as absent, so avoid generating it.
+  result.span_id = RandomUniformInt<uint64_t>(1, std::numeric_limits<uint64_t>::max());
+  return result;
+}
+
+TraceContext TraceContext::NewRootIfSampled() {
+  TraceContext result;
+  if (RandomActWithProbability(GetAtomicFlag(&FLAGS_trace_sampling_rate))) {
+    result.trace_id_high = RandomUniformInt<uint64_t>();
+    result.trace_id_low = RandomUniformInt<uint64_t>(1, std::numeric_limits<uint64_t>::max());
+    result.span_id = RandomUniformInt<uint64_t>(1, std::numeric_limits<uint64_t>::max());
+  }
+  return result;
+}
+
 Trace::Trace() {
 }
 
@@ -351,6 +381,9 @@ void Trace::DumpCurrentTrace() {
 
 void Trace::AddChildTrace(Trace* child_trace) {
   CHECK_NOTNULL(child_trace);
+  if (context_.sampled() && !child_trace->context_.sampled()) {
+    child_trace->context_ = context_;
+  }
   {
     std::lock_guard<simple_spinlock> l(lock_);
     scoped_refptr<Trace> ptr(child_trace);
@@ -102,6 +102,26 @@ namespace yb {
 
 struct TraceEntry;
 
+// Identifies a span of a sampled distributed trace. It is propagated to other servers in RPC
+// headers, so spans recorded by all servers that took part in a request share the same trace id.
+struct TraceContext {
+  uint64_t trace_id_high = 0;
+  uint64_t trace_id_low = 0;
+  uint64_t span_id = 0;
+  uint64_t parent_span_id = 0;
+
+  bool sampled() const {
+    return trace_id_high != 0 || trace_id_low != 0;
+  }
+
+  // Returns context of a new span of the same trace, whose parent is this span.
+  TraceContext ChildSpan() const;
+
+  // Starts a new trace with probability trace_sampling_rate. Returns not sampled context
+  // otherwise.
+  static TraceContext NewRootIfSampled();
+};
+
 // A trace for a request or other process. This supports collecting trace entries
 // from a number of threads, and later dumping the results to a stream.
 //
@@ -154,8 +174,19 @@ class Trace : public RefCountedThreadSafe<Trace> {
   std::string DumpToString(bool include_time_deltas) const;
 
   // Attaches the given trace which will get appended at the end when Dumping.
+  // Child inherits the sampled trace context if it does not have its own.
   void AddChildTrace(Trace* child_trace);
 
+  // Sampled trace context of the operation traced by this trace. Should be set before the trace
+  // is shared with other threads.
+  const TraceContext& context() const {
+    return context_;
+  }
+
+  void set_context(const TraceContext& context) {
+    context_ = context;
+  }
+
   // Return the current trace attached to this thread, if there is one.
   static Trace* CurrentTrace() {
     return threadlocal_trace_;
@@ -198,6 +229,8 @@ class Trace : public RefCountedThreadSafe<Trace> {
 
   std::vector<scoped_refptr<Trace> > child_traces_;
 
+  TraceContext context_;
+
   DISALLOW_COPY_AND_ASSIGN(Trace);
 };
 
@@ -24,6 +24,14 @@
 #include "yb/gutil/endian.h"
 #include "yb/gutil/strings/substitute.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cql_compression_min_body_size, 512,
+             "Bodies of CQL responses smaller than this are sent uncompressed, even if the client "
+             "negotiated compression.");
+TAG_FLAG(cql_compression_min_body_size, advanced);
+TAG_FLAG(cql_compression_min_body_size, runtime);
+
 namespace yb {
 namespace cqlserver {
 
@@ -912,38 +920,17 @@ CQLResponse::~CQLResponse() {
 
 void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststring* mesg) const {
   const size_t start_pos = mesg->size(); // save the start position
-  const bool compress = (compression_scheme != CQLMessage::CompressionScheme::NONE);
-  SerializeHeader(compress, mesg);
-  if (compress) {
+  SerializeHeader(false /* compress */, mesg);
+  if (compression_scheme != CQLMessage::CompressionScheme::NONE) {
     faststring body;
     SerializeBody(&body);
-    switch (compression_scheme) {
-      case CQLMessage::CompressionScheme::LZ4: {
-        SerializeInt(static_cast<int32_t>(body.size()), mesg);
-        const size_t curr_size = mesg->size();
-        const int max_comp_size = LZ4_compressBound(body.size());
-        mesg->resize(curr_size + max_comp_size);
-        const int comp_size = LZ4_compress_default(to_char_ptr(body.data()),
-                                                   to_char_ptr(mesg->data() + curr_size),
-                                                   body.size(),
-                                                   max_comp_size);
-        CHECK_NE(comp_size, 0) << "LZ4 compression failed";
-        mesg->resize(curr_size + comp_size);
-        break;
-      }
-      case CQLMessage::CompressionScheme::SNAPPY: {
-        const size_t curr_size = mesg->size();
-        const size_t max_comp_size = MaxCompressedLength(body.size());
-        size_t comp_size = 0;
-        mesg->resize(curr_size + max_comp_size);
-        RawCompress(to_char_ptr(body.data()), body.size(),
-                    to_char_ptr(mesg->data() + curr_size), &comp_size);
-        mesg->resize(curr_size + comp_size);
-        break;
-      }
-      case CQLMessage::CompressionScheme::NONE:
-        LOG(FATAL) << "No compression scheme";
-        break;
+    // The compression flag is set per frame, so bodies that are too small to benefit from
+    // compression, or that do not get smaller, are sent uncompressed.
+    if (body.size() >= implicit_cast<size_t>(FLAGS_cql_compression_min_body_size) &&
+        CompressBody(compression_scheme, body, mesg)) {
+      mesg->data()[start_pos + kHeaderPosFlags] |= kCompressionFlag;
+    } else {
+      mesg->append(body.data(), body.size());
     }
   } else {
     SerializeBody(mesg);
@@ -952,6 +939,44 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
 }
 
+bool CQLResponse::CompressBody(
+    const CompressionScheme compression_scheme, const faststring& body, faststring* mesg) const {
+  const size_t start_pos = mesg->size();
+  switch (compression_scheme) {
+    case CQLMessage::CompressionScheme::LZ4: {
+      SerializeInt(static_cast<int32_t>(body.size()), mesg);
+      const size_t curr_size = mesg->size();
+      const int max_comp_size = LZ4_compressBound(body.size());
+      mesg->resize(curr_size + max_comp_size);
+      const int comp_size = LZ4_compress_default(to_char_ptr(body.data()),
+                                                 to_char_ptr(mesg->data() + curr_size),
+                                                 body.size(),
+                                                 max_comp_size);
+      CHECK_NE(comp_size, 0) << "LZ4 compression failed";
+      mesg->resize(curr_size + comp_size);
+      break;
+    }
+    case CQLMessage::CompressionScheme::SNAPPY: {
+      const size_t curr_size = mesg->size();
+      const size_t max_comp_size = MaxCompressedLength(body.size());
+      size_t comp_size = 0;
+      mesg->resize(curr_size + max_comp_size);
+      RawCompress(to_char_ptr(body.data()), body.size(),
+                  to_char_ptr(mesg->data() + curr_size), &comp_size);
+      mesg->resize(curr_size + comp_size);
+      break;
+    }
+    case CQLMessage::CompressionScheme::NONE:
+      LOG(FATAL) << "No compression scheme";
+      break;
+  }
+  if (mesg->size() - start_pos >= body.size()) {
+    mesg->resize(start_pos);
+    return false;
+  }
+  return true;
+}
+
 void CQLResponse::SerializeHeader(const bool compress, faststring* mesg) const {
   uint8_t buffer[kMessageHeaderLength];
   SERIALIZE_BYTE(buffer, kHeaderPosVersion, version());
@@ -1730,7 +1755,7 @@ CQLServerEvent::CQLServerEvent(std::unique_ptr<EventResponse> event_response)
   serialized_response_ = RefCntBuffer(temp);
 }
 
-void CQLServerEvent::Serialize(std::deque<RefCntBuffer>* output) const {
+void CQLServerEvent::Serialize(rpc::OutboundSlices* output) const {
   output->push_back(serialized_response_);
 }
 
@@ -1747,7 +1772,7 @@ void CQLServerEventList::Transferred(const Status& status, rpc::Connection*) {
   }
 }
 
-void CQLServerEventList::Serialize(std::deque<RefCntBuffer>* output) const {
+void CQLServerEventList::Serialize(rpc::OutboundSlices* output) const {
   for (const auto& cql_server_event : cql_server_events_) {
     cql_server_event->Serialize(output);
   }
@@ -470,6 +470,11 @@ class CQLResponse : public CQLMessage {
   CQLResponse(StreamId stream_id, Opcode opcode);
   void SerializeHeader(bool compress, faststring* mesg) const;
 
+  // Appends compressed body to mesg. Returns false and leaves mesg unchanged if the compressed
+  // body is not smaller than the original one.
+  bool CompressBody(CompressionScheme compression_scheme, const faststring& body,
+                    faststring* mesg) const;
+
   // Function to serialize a response body that all CQLResponse subclasses need to implement
   virtual void SerializeBody(faststring* mesg) const = 0;
 };
@@ -901,7 +906,7 @@ class AuthSuccessResponse : public CQLResponse {
 class CQLServerEvent : public rpc::ServerEvent {
  public:
   explicit CQLServerEvent(std::unique_ptr<EventResponse> event_response);
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(rpc::OutboundSlices* output) const override;
   std::string ToString() const override;
  private:
 
@@ -916,7 +921,7 @@ class CQLServerEventList : public rpc::ServerEventList {
  public:
   CQLServerEventList();
   void AddEvent(std::unique_ptr<CQLServerEvent> event);
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(rpc::OutboundSlices* output) const override;
   std::string ToString() const override;
  private:
   void Transferred(const Status& status, rpc::Connection*) override;
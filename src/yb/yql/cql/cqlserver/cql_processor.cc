@@ -21,6 +21,8 @@
 #include "yb/rpc/rpc_context.h"
 
 #include "yb/util/crypt.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
 
 #include "yb/yql/cql/cqlserver/cql_service.h"
 
@@ -58,7 +60,15 @@ METRIC_DEFINE_histogram(
     "RPC requests",
     60000000LU, 2);
 
+using yb::operator"" _KB;
+
+DEFINE_int32(cql_processor_max_response_buffer_size, 256_KB,
+             "Max capacity of the response buffer kept by an idle CQL processor. Buffers grown "
+             "by larger responses are released after the response is sent.");
+TAG_FLAG(cql_processor_max_response_buffer_size, advanced);
+
 DECLARE_bool(use_cassandra_authentication);
+DECLARE_int32(cql_service_max_query_statements);
 
 namespace yb {
 namespace cqlserver {
@@ -169,9 +179,13 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   MonoTime response_begin = MonoTime::Now();
   const auto& context = static_cast<const CQLConnectionContext&>(call_->connection()->context());
   const auto compression_scheme = context.compression_scheme();
-  faststring msg;
-  response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  response_buffer_.clear();
+  response.Serialize(compression_scheme, &response_buffer_);
+  call_->RespondSuccess(RefCntBuffer(response_buffer_), cql_metrics_->rpc_method_metrics_);
+  if (response_buffer_.capacity() > implicit_cast<size_t>(
+          FLAGS_cql_processor_max_response_buffer_size)) {
+    delete[] response_buffer_.release();
+  }
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -188,6 +202,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   request_ = nullptr;
   stmts_.clear();
   parse_trees_.clear();
+  query_stmt_ = nullptr;
   SetCurrentCall(nullptr);
   service_impl_->ReturnProcessor(pos_);
 }
@@ -301,6 +316,17 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
+  if (FLAGS_cql_service_max_query_statements > 0) {
+    shared_ptr<const CQLStatement> stmt;
+    Status s = GetQueryStatement(req.query(), &stmt);
+    if (s.ok()) {
+      s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
+    }
+    if (PREDICT_FALSE(!s.ok())) {
+      StatementExecuted(s);
+    }
+    return nullptr;
+  }
   RunAsync(req.query(), req.params(), statement_executed_cb_);
   return nullptr;
 }
@@ -382,6 +408,27 @@ shared_ptr<const CQLStatement> CQLProcessor::GetPreparedStatement(const CQLMessa
   return stmt;
 }
 
+Status CQLProcessor::GetQueryStatement(const string& query, shared_ptr<const CQLStatement>* stmt) {
+  shared_ptr<CQLStatement> query_stmt = service_impl_->AllocateQueryStatement(
+      ql_env_.CurrentKeyspace(), query);
+  // The prepared result is only needed to tell DML statements, worth caching, from the rest, so
+  // only request it when the statement is parsed for the first time.
+  PreparedResult::UniPtr result;
+  const bool cached = !query_stmt->unprepared();
+  const Status s = query_stmt->Prepare(
+      this, service_impl_->prepared_stmts_mem_tracker(), cached ? nullptr : &result);
+  if (!s.ok() || (!cached && result == nullptr)) {
+    // Do not keep statements that failed to parse, or that are not DML (such as DDL or USE), in
+    // the cache. The latter are still executed by this call.
+    service_impl_->DeleteQueryStatement(query_stmt);
+  }
+  RETURN_NOT_OK(s);
+  query_stmt->clear_reparsed();
+  query_stmt_ = query_stmt;
+  *stmt = std::move(query_stmt);
+  return Status::OK();
+}
+
 void CQLProcessor::StatementExecuted(const Status& s,
                                      const ql::ExecutedResult::SharedPtr& result) {
   unique_ptr<CQLResponse> response(ProcessResult(s, result));
@@ -403,6 +450,9 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
         // Delete all stale prepared statements from our cache. Since CQL protocol allows only one
         // unprepared query id to be returned, we will return just the last unprepared / stale one
         // we found.
+        if (query_stmt_ != nullptr && query_stmt_->stale()) {
+          service_impl_->DeleteQueryStatement(query_stmt_);
+        }
         for (auto stmt : stmts_) {
           if (stmt->stale()) {
             service_impl_->DeletePreparedStatement(stmt);
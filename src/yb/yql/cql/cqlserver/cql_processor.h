@@ -22,6 +22,8 @@
 
 #include "yb/rpc/service_if.h"
 
+#include "yb/util/faststring.h"
+
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_rpc.h"
 #include "yb/yql/cql/cqlserver/cql_statement.h"
@@ -81,6 +83,10 @@ class CQLProcessor : public ql::QLProcessor {
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
+  // Get a parsed non-prepared statement from the query statements cache, parsing it if needed.
+  CHECKED_STATUS GetQueryStatement(
+      const std::string& query, std::shared_ptr<const CQLStatement>* stmt);
+
   // Statement executed callback.
   void StatementExecuted(const Status& s, const ql::ExecutedResult::SharedPtr& result = nullptr);
 
@@ -107,6 +113,9 @@ class CQLProcessor : public ql::QLProcessor {
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
+  // Cached non-prepared statement being executed.
+  std::shared_ptr<const CQLStatement> query_stmt_;
+
   // Current retry count.
   int retry_count_ = 0;
 
@@ -120,6 +129,9 @@ class CQLProcessor : public ql::QLProcessor {
   // Statement executed callback.
   ql::StatementExecutedCallback statement_executed_cb_;
 
+  // Buffer to serialize responses to, reused by calls processed by this processor.
+  faststring response_buffer_;
+
   //----------------------------------------------------------------------------------------------
 };
 
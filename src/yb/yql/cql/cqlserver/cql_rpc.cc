@@ -132,6 +132,8 @@ Status CQLInboundCall::ParseFrom(const MemTrackerPtr& call_tracker, std::vector<
   // tracing only. Inside CQLServiceImpl::Handle, we rely on the opcode to dispatch the execution.
   stream_id_ = cqlserver::CQLRequest::ParseStreamId(serialized_request_);
 
+  MaybeStartSampledTrace();
+
   return Status::OK();
 }
 
@@ -145,7 +147,7 @@ const std::string& CQLInboundCall::method_name() const {
   return result;
 }
 
-void CQLInboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
+void CQLInboundCall::Serialize(rpc::OutboundSlices* output) const {
   TRACE_EVENT0("rpc", "CQLInboundCall::Serialize");
   CHECK_GT(response_msg_buf_.size(), 0);
 
@@ -89,7 +89,7 @@ class CQLInboundCall : public rpc::InboundCall {
 
   // Serialize the response packet for the finished call.
   // The resulting slices refer to memory in this object.
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(rpc::OutboundSlices* output) const override;
 
   void LogTrace() const override;
   std::string ToString() const override;
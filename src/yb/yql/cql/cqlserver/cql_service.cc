@@ -27,6 +27,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 
 using namespace std::placeholders;
@@ -34,6 +35,11 @@ using namespace std::placeholders;
 DEFINE_int64(cql_service_max_prepared_statement_size_bytes, 0,
              "The maximum amount of memory the CQL proxy should use to maintain prepared "
              "statements. 0 or negative means unlimited.");
+DEFINE_int32(cql_service_max_query_statements, 1000,
+             "The maximum number of parsed and analyzed non-prepared statements the CQL proxy "
+             "should cache to reuse when the same statement text is queried again. The cache "
+             "shares the memory limit with prepared statements. 0 disables the cache.");
+TAG_FLAG(cql_service_max_query_statements, advanced);
 DEFINE_int32(cql_ybclient_reactor_threads, 24,
              "The number of reactor threads to be used for processing ybclient "
              "requests originating in the cql layer");
@@ -225,6 +231,45 @@ void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 }
 
+shared_ptr<CQLStatement> CQLServiceImpl::AllocateQueryStatement(
+    const string& keyspace, const string& ql_stmt) {
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(keyspace, ql_stmt);
+
+  // Get exclusive lock before allocating a query statement and updating the LRU list.
+  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+
+  shared_ptr<CQLStatement> stmt;
+  const auto itr = query_stmts_map_.find(query_id);
+  if (itr == query_stmts_map_.end()) {
+    stmt = query_stmts_map_.emplace(
+        query_id, std::make_shared<CQLStatement>(
+            keyspace, ql_stmt, query_stmts_list_.end())).first->second;
+    stmt->set_pos(query_stmts_list_.insert(query_stmts_list_.begin(), stmt));
+    // Ad-hoc statements with literal values are rarely repeated, so keep the cache bounded by the
+    // number of statements also.
+    const size_t max_query_stmts = std::max(FLAGS_cql_service_max_query_statements, 1);
+    while (query_stmts_list_.size() > max_query_stmts) {
+      DeleteQueryStatementUnlocked(query_stmts_list_.back());
+    }
+  } else {
+    stmt = itr->second;
+    query_stmts_list_.splice(query_stmts_list_.begin(), query_stmts_list_, stmt->pos());
+  }
+
+  VLOG(1) << "AllocateQueryStatement: CQL query statement cache count = "
+          << query_stmts_map_.size() << "/" << query_stmts_list_.size()
+          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+
+  return stmt;
+}
+
+void CQLServiceImpl::DeleteQueryStatement(const shared_ptr<const CQLStatement>& stmt) {
+  // Get exclusive lock before deleting the query statement.
+  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+
+  DeleteQueryStatementUnlocked(stmt);
+}
+
 void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
   // Insert the statement at the front of the LRU list.
   stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
@@ -252,12 +297,28 @@ void CQLServiceImpl::DeletePreparedStatementUnlocked(
   }
 }
 
+void CQLServiceImpl::DeleteQueryStatementUnlocked(const shared_ptr<const CQLStatement> stmt) {
+  // Same as DeletePreparedStatementUnlocked() but for the query statements cache.
+  const auto itr = query_stmts_map_.find(stmt->query_id());
+  if (itr != query_stmts_map_.end() && itr->second == stmt) {
+    query_stmts_map_.erase(itr);
+  }
+  if (stmt->pos() != query_stmts_list_.end()) {
+    query_stmts_list_.erase(stmt->pos());
+    stmt->set_pos(query_stmts_list_.end());
+  }
+}
+
 void CQLServiceImpl::CollectGarbage(size_t required) {
   // Get exclusive lock before deleting the least recently used statement at the end of the LRU
   // list from the cache.
   std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
 
-  if (!prepared_stmts_list_.empty()) {
+  // Query statements are only an optimization, so they are freed before prepared statements that
+  // clients would have to reprepare.
+  if (!query_stmts_list_.empty()) {
+    DeleteQueryStatementUnlocked(query_stmts_list_.back());
+  } else if (!prepared_stmts_list_.empty()) {
     DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
   }
 
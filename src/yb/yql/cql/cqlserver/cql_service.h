@@ -78,6 +78,15 @@ class CQLServiceImpl : public CQLServerServiceIf,
   // Delete the prepared statement from the cache.
   void DeletePreparedStatement(const std::shared_ptr<const CQLStatement>& stmt);
 
+  // Allocate a non-prepared statement in the query statements cache, that keeps parse trees of
+  // recently queried statements by keyspace and text. If the statement already exists, return it
+  // instead.
+  std::shared_ptr<CQLStatement> AllocateQueryStatement(
+      const std::string& keyspace, const std::string& ql_stmt);
+
+  // Delete the statement from the query statements cache.
+  void DeleteQueryStatement(const std::shared_ptr<const CQLStatement>& stmt);
+
   // Return the memory tracker for prepared statements.
   std::shared_ptr<MemTracker> prepared_stmts_mem_tracker() const {
     return prepared_stmts_mem_tracker_;
@@ -120,6 +129,10 @@ class CQLServiceImpl : public CQLServerServiceIf,
   // be locked before this call.
   void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
 
+  // Delete a query statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to be
+  // locked before this call.
+  void DeleteQueryStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
+
   // Delete the least recently used prepared statement from the cache to free up memory.
   void CollectGarbage(size_t required) override;
 
@@ -150,7 +163,11 @@ class CQLServiceImpl : public CQLServerServiceIf,
   // Prepared statements LRU list (least recently used one at the end).
   CQLStatementList prepared_stmts_list_;
 
-  // Mutex that protects the prepared statements and the LRU list.
+  // Non-prepared statements cache and its LRU list (least recently used one at the end).
+  CQLStatementMap query_stmts_map_;
+  CQLStatementList query_stmts_list_;
+
+  // Mutex that protects the prepared and query statements and the LRU lists.
   std::mutex prepared_stmts_mutex_;
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
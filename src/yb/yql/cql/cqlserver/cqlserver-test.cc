@@ -26,6 +26,9 @@
 #include "yb/util/net/net_util.h"
 #include "yb/util/test_util.h"
 
+DEFINE_int32(cql_process_call_benchmark_iterations, 1000,
+             "Number of calls for each request type in ProcessCallBenchmark.");
+
 namespace yb {
 namespace cqlserver {
 
@@ -186,6 +189,25 @@ TEST_F(TestCQLService, OptionsRequest) {
                                "\x00\x02" "\x00\x05" "3.0.0" "\x00\x05" "3.4.2"));
 }
 
+TEST_F(TestCQLService, SmallResponseNotCompressed) {
+  LOG(INFO) << "Test small CQL response with compression";
+  // Send STARTUP request with LZ4 compression.
+  SendRequestAndExpectResponse(
+      BINARY_STRING("\x04\x00\x00\x00\x01" "\x00\x00\x00\x28"
+                    "\x00\x02" "\x00\x0b" "CQL_VERSION" "\x00\x05" "3.0.0"
+                               "\x00\x0b" "COMPRESSION" "\x00\x03" "lz4"),
+      BINARY_STRING("\x84\x00\x00\x00\x02" "\x00\x00\x00\x00"));
+
+  // Response to OPTIONS request is below compression threshold, so compression flag is not set.
+  SendRequestAndExpectResponse(
+      BINARY_STRING("\x04\x00\x00\x00\x05" "\x00\x00\x00\x00"),
+      BINARY_STRING("\x84\x00\x00\x00\x06" "\x00\x00\x00\x3b"
+                    "\x00\x02" "\x00\x0b" "COMPRESSION"
+                               "\x00\x02" "\x00\x03" "lz4" "\x00\x06" "snappy"
+                               "\x00\x0b" "CQL_VERSION"
+                               "\x00\x02" "\x00\x05" "3.0.0" "\x00\x05" "3.4.2"));
+}
+
 TEST_F(TestCQLService, InvalidRequest) {
   LOG(INFO) << "Test invalid CQL request";
   // Send response (0x84) as request
@@ -234,6 +256,34 @@ TEST_F(TestCQLService, InvalidRequest) {
                     "\x00\x00\x00\x0a" "\x00\x17" "Request length too long"));
 }
 
+// Measures per call processing time of simple requests, i.e. mostly overhead of the CQL server.
+TEST_F(TestCQLService, ProcessCallBenchmark) {
+  const std::vector<std::pair<string, string>> requests = {
+      // OPTIONS request.
+      {BINARY_STRING("\x04\x00\x00\x00\x05" "\x00\x00\x00\x00"),
+       BINARY_STRING("\x84\x00\x00\x00\x06" "\x00\x00\x00\x3b"
+                     "\x00\x02" "\x00\x0b" "COMPRESSION"
+                                "\x00\x02" "\x00\x03" "lz4" "\x00\x06" "snappy"
+                                "\x00\x0b" "CQL_VERSION"
+                                "\x00\x02" "\x00\x05" "3.0.0" "\x00\x05" "3.4.2")},
+      // QUERY request "USE system;", executed by the QL processor.
+      {BINARY_STRING("\x04\x00\x00\x00\x07" "\x00\x00\x00\x12"
+                     "\x00\x00\x00\x0b" "USE system;" "\x00\x01" "\x00"),
+       BINARY_STRING("\x84\x00\x00\x00\x08" "\x00\x00\x00\x0c"
+                     "\x00\x00\x00\x03" "\x00\x06" "system")}};
+
+  for (const auto& request_and_response : requests) {
+    const auto start = MonoTime::Now();
+    for (int i = 0; i != FLAGS_cql_process_call_benchmark_iterations; ++i) {
+      SendRequestAndExpectResponse(request_and_response.first, request_and_response.second);
+    }
+    const auto elapsed = MonoTime::Now().GetDeltaSince(start);
+    LOG(INFO) << "Opcode " << static_cast<int>(request_and_response.first[4]) << ": "
+              << elapsed.ToMicroseconds() / FLAGS_cql_process_call_benchmark_iterations
+              << "us per call";
+  }
+}
+
 TEST_F(TestCQLService, TestCQLServerEventConst) {
   std::unique_ptr<SchemaChangeEventResponse> response(
       new SchemaChangeEventResponse("", "", "", "", {}));
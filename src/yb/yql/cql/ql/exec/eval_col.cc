@@ -15,6 +15,14 @@
 
 #include "yb/yql/cql/ql/exec/executor.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(cql_use_insert_request_templates, true,
+            "Build column values of prepared INSERT statements once, and only fill bind "
+            "variables on each execution.");
+TAG_FLAG(cql_use_insert_request_templates, advanced);
+TAG_FLAG(cql_use_insert_request_templates, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -101,5 +109,98 @@ CHECKED_STATUS Executor::ColumnArgsToPB(const PTDmlStmt *tnode, QLWriteRequestPB
   return Status::OK();
 }
 
+std::unique_ptr<const InsertRequestTemplate> Executor::BuildRequestTemplate(
+    const PTInsertStmt *tnode) {
+  if (!tnode->subscripted_col_args().empty() || !tnode->json_col_args().empty()) {
+    return nullptr;
+  }
+
+  // Only constants and bind variables are supported, and a template is useful only when the
+  // statement has bind variables, i.e. it is prepared.
+  bool has_bind_vars = false;
+  for (const ColumnArg& col : tnode->column_args()) {
+    if (!col.IsInitialized()) {
+      continue;
+    }
+    const ExprOperator op = col.expr()->expr_op();
+    if (op == ExprOperator::kBindVar) {
+      has_bind_vars = true;
+    } else if (op != ExprOperator::kConst) {
+      return nullptr;
+    }
+  }
+  if (!has_bind_vars) {
+    return nullptr;
+  }
+
+  auto result = std::make_unique<InsertRequestTemplate>();
+  QLWriteRequestPB* req = &result->request;
+  for (const ColumnArg& col : tnode->column_args()) {
+    if (!col.IsInitialized()) {
+      continue;
+    }
+
+    const ColumnDesc *col_desc = col.desc();
+    QLExpressionPB *expr_pb;
+    int index;
+    if (col_desc->is_hash()) {
+      index = req->hashed_column_values_size();
+      expr_pb = req->add_hashed_column_values();
+    } else if (col_desc->is_primary()) {
+      index = req->range_column_values_size();
+      expr_pb = req->add_range_column_values();
+    } else {
+      index = req->column_values_size();
+      QLColumnValuePB* col_pb = req->add_column_values();
+      col_pb->set_column_id(col_desc->id());
+      expr_pb = col_pb->mutable_expr();
+    }
+
+    if (col.expr()->expr_op() == ExprOperator::kBindVar) {
+      result->bind_slots.push_back(InsertRequestTemplate::BindSlot{
+          static_cast<const PTBindVar*>(col.expr().get()), col_desc, index});
+      continue;
+    }
+
+    // Errors, including null primary key constants, are reported by the regular path.
+    if (!PTExprToPB(col.expr(), expr_pb).ok() ||
+        (col_desc->is_primary() && (!expr_pb->has_value() || IsNull(expr_pb->value())))) {
+      return nullptr;
+    }
+  }
+
+  if (!ColumnRefsToPB(tnode, req->mutable_column_refs()).ok()) {
+    return nullptr;
+  }
+  return std::move(result);
+}
+
+CHECKED_STATUS Executor::RequestTemplateToPB(const PTInsertStmt *tnode,
+                                             const InsertRequestTemplate& request_template,
+                                             QLWriteRequestPB *req) {
+  // Request fields set when the operation is created are not present in the template, so the
+  // template could be merged into it.
+  req->MergeFrom(request_template.request);
+
+  for (const auto& slot : request_template.bind_slots) {
+    QLExpressionPB *expr_pb;
+    if (slot.col_desc->is_hash()) {
+      expr_pb = req->mutable_hashed_column_values(slot.index);
+    } else if (slot.col_desc->is_primary()) {
+      expr_pb = req->mutable_range_column_values(slot.index);
+    } else {
+      expr_pb = req->mutable_column_values(slot.index)->mutable_expr();
+    }
+    RETURN_NOT_OK(PTExprToPB(slot.bind_var, expr_pb));
+
+    // Null values not allowed for primary key.
+    if (slot.col_desc->is_primary() && IsNull(expr_pb->value())) {
+      LOG(INFO) << "Unexpected null value. Current request: " << req->DebugString();
+      return exec_context().Error(tnode, ErrorCode::NULL_ARGUMENT_FOR_PRIMARY_KEY);
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace ql
 }  // namespace yb
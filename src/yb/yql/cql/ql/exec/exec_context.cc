@@ -62,17 +62,24 @@ void TnodeContext::InitializePartition(QLReadRequestPB *req, uint64_t start_part
     req->add_hashed_column_values();
   }
 
+  SetPartition(start_partition, req);
+}
+
+void TnodeContext::SetPartition(uint64_t partition, QLReadRequestPB *req) const {
+  int hash_key_size = req->hashed_column_values().size();
+  int fixed_cols_size = hash_key_size - hash_values_options_->size();
+
   // Set the right values for the missing/unset columns by converting partition index into positions
   // for each hash column and using the corresponding values from the hash values options vector.
-  // E.g. In example above, with start_partition = 0:
-  //    h4 = 6 since pos is "0 % 1 = 0", (start_position becomes 0 / 1 = 0).
-  //    h3 = 4 since pos is "0 % 2 = 0", (start_position becomes 0 / 2 = 0).
-  //    h2 = 2 since pos is "0 % 2 = 0", (start_position becomes 0 / 2 = 0).
-  for (int i = unset_cols_size - 1; i >= 0; i--) {
-    const auto& options = (*hash_values_options_)[i];
-    int pos = start_partition % options.size();
-    *req->mutable_hashed_column_values(i + set_cols_size) = options[pos];
-    start_partition /= options.size();
+  // E.g. In example above, with partition = 0:
+  //    h4 = 6 since pos is "0 % 1 = 0", (partition becomes 0 / 1 = 0).
+  //    h3 = 4 since pos is "0 % 2 = 0", (partition becomes 0 / 2 = 0).
+  //    h2 = 2 since pos is "0 % 2 = 0", (partition becomes 0 / 2 = 0).
+  for (int i = hash_key_size - 1; i >= fixed_cols_size; i--) {
+    const auto& options = (*hash_values_options_)[i - fixed_cols_size];
+    int pos = partition % options.size();
+    *req->mutable_hashed_column_values(i) = options[pos];
+    partition /= options.size();
   }
 }
 
@@ -20,6 +20,9 @@
 #ifndef YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 #define YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 
+#include <deque>
+
+#include "yb/client/yb_op.h"
 #include "yb/yql/cql/ql/ptree/process_context.h"
 #include "yb/yql/cql/ql/util/ql_env.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
@@ -88,6 +91,11 @@ class TnodeContext {
   // this will do, index: 2 -> 3 and hashed_column_values: [1, 3, 4, 6] -> [1, 3, 5, 6].
   void AdvanceToNextPartition(QLReadRequestPB *req);
 
+  // Used for multi-partition selects (i.e. with 'IN' conditions on hash columns).
+  // Sets the hashed column values in a request, that was already initialized by
+  // InitializePartition, so that it references the specified partition.
+  void SetPartition(uint64_t partition, QLReadRequestPB *req) const;
+
   std::unique_ptr<std::vector<std::vector<QLExpressionPB>>>& hash_values_options() {
     if (hash_values_options_ == nullptr) {
       hash_values_options_ = std::make_unique<std::vector<std::vector<QLExpressionPB>>>();
@@ -103,6 +111,23 @@ class TnodeContext {
     partitions_count_ = count;
   }
 
+  // Used for aggregate selects that read all tablets in parallel. Rows returned by a partial read
+  // are merged by the context of the first read of the statement.
+  bool is_partial_read() const {
+    return partial_read_;
+  }
+
+  void set_partial_read() {
+    partial_read_ = true;
+  }
+
+  // Used for multi-partition selects that read the following partitions in parallel with the
+  // current one. Reads are ordered by partition index, and their rows are appended to the result
+  // in this order by Executor::FetchMoreRowsIfNeeded.
+  std::deque<std::shared_ptr<client::YBqlReadOp>>& partition_reads() {
+    return partition_reads_;
+  }
+
  private:
   // Tree node of the statement being executed.
   const TreeNode* tnode_ = nullptr;
@@ -125,6 +150,12 @@ class TnodeContext {
   std::unique_ptr<std::vector<std::vector<QLExpressionPB>>> hash_values_options_;
   uint64_t partitions_count_ = 0;
   uint64_t current_partition_index_ = 0;
+
+  // Is this a partial read of a parallel aggregate select?
+  bool partial_read_ = false;
+
+  // Reads of the partitions following the current one, applied in parallel with it.
+  std::deque<std::shared_ptr<client::YBqlReadOp>> partition_reads_;
 };
 
 class ExecContext : public ProcessContextBase {
@@ -21,7 +21,23 @@
 #include "yb/common/ql_protocol_util.h"
 #include "yb/yql/cql/ql/ql_processor.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
 #include "yb/common/common.pb.h"
+#include "yb/common/partition.h"
+
+DEFINE_bool(cql_parallel_aggregate_scan, true,
+            "Evaluate aggregates over whole tables by reading all tablets in parallel, instead "
+            "of scanning tablets one after another.");
+TAG_FLAG(cql_parallel_aggregate_scan, advanced);
+TAG_FLAG(cql_parallel_aggregate_scan, runtime);
+
+DEFINE_int32(cql_max_parallel_partition_reads, 128,
+             "The maximum number of partitions of a select with IN conditions on hash columns to "
+             "read in parallel. 1 or less makes partitions read one after another.");
+TAG_FLAG(cql_max_parallel_partition_reads, advanced);
+TAG_FLAG(cql_max_parallel_partition_reads, runtime);
+
+DECLARE_bool(cql_use_insert_request_templates);
 
 namespace yb {
 namespace ql {
@@ -736,18 +752,150 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
   }
 
   // If we have several hash partitions (i.e. IN condition on hash columns) we initialize the
-  // start partition here, and then iteratively scan the rest in FetchMoreRowsIfNeeded.
+  // start partition here, read the following ones in parallel with it, and then iteratively scan
+  // the rest in FetchMoreRowsIfNeeded.
   // Otherwise, the request will already have the right hashed column values set.
   TnodeContext* tnode_context = exec_context().tnode_context();
   if (tnode_context->UnreadPartitionsRemaining() > 0) {
     tnode_context->InitializePartition(select_op->mutable_request(),
                                        continue_select ? params.next_partition_index() : 0);
+    RETURN_NOT_OK(ApplyPartitionReads(tnode, select_op, tnode_context));
+  } else if (!continue_select) {
+    auto applied = ApplyParallelAggregate(tnode, select_op);
+    if (!applied.ok() || *applied) {
+      return applied.ok() ? Status::OK() : applied.status();
+    }
   }
 
   // Apply the operator.
   return exec_context().Apply(select_op);
 }
 
+Result<bool> Executor::ApplyParallelAggregate(const PTSelectStmt* tnode,
+                                              const shared_ptr<YBqlReadOp>& select_op) {
+  const QLReadRequestPB& req = select_op->request();
+  const shared_ptr<client::YBTable>& table = tnode->table();
+  const auto& partitions = table->GetPartitions();
+  if (!FLAGS_cql_parallel_aggregate_scan || !tnode->is_aggregate() || partitions.size() <= 1 ||
+      tnode->has_limit() || tnode->has_offset() || !req.hashed_column_values().empty() ||
+      req.has_hash_code() || req.has_max_hash_code() ||
+      table->partition_schema().hash_schema() != YBHashSchema::kMultiColumnHash) {
+    return false;
+  }
+
+  // Each read is restricted to the hash range of its tablet, so the tablet does not return paging
+  // state pointing to the next tablet. Tablets do not page aggregates, so a read returns the
+  // partial aggregate of the whole tablet in one round trip.
+  for (size_t i = 0; i != partitions.size(); ++i) {
+    shared_ptr<YBqlReadOp> op;
+    if (i == 0) {
+      op = select_op;
+    } else {
+      op.reset(table->NewQLSelect());
+      *op->mutable_request() = req;
+      op->set_yb_consistency_level(select_op->yb_consistency_level());
+      exec_context().AddTnode(tnode);
+      exec_context().tnode_context()->set_partial_read();
+    }
+    QLReadRequestPB* op_req = op->mutable_request();
+    op_req->set_hash_code(
+        partitions[i].empty() ? 0 : PartitionSchema::DecodeMultiColumnHashValue(partitions[i]));
+    op_req->set_max_hash_code(
+        i + 1 == partitions.size()
+            ? std::numeric_limits<uint16_t>::max()
+            : PartitionSchema::DecodeMultiColumnHashValue(partitions[i + 1]) - 1);
+    RETURN_NOT_OK(exec_context().tnode_context()->Apply(op, ql_env_));
+  }
+  return true;
+}
+
+Status Executor::ApplyPartitionReads(const PTSelectStmt* tnode,
+                                     const shared_ptr<YBqlReadOp>& select_op,
+                                     TnodeContext* tnode_context) {
+  // Rows skipped by OFFSET are counted across partitions, so such selects read partitions one
+  // after another.
+  const uint64_t num_reads = std::min<uint64_t>(
+      tnode_context->UnreadPartitionsRemaining(),
+      std::max(FLAGS_cql_max_parallel_partition_reads, 1));
+  if (tnode->has_offset() || num_reads <= 1) {
+    return Status::OK();
+  }
+
+  // Following partitions are read from their beginning with the same limit as the current one,
+  // FetchMoreRowsIfNeeded uses only the reads that fit the limit.
+  const QLReadRequestPB& req = select_op->request();
+  for (uint64_t i = 1; i != num_reads; ++i) {
+    shared_ptr<YBqlReadOp> op(tnode->table()->NewQLSelect());
+    QLReadRequestPB* op_req = op->mutable_request();
+    *op_req = req;
+    op_req->clear_paging_state();
+    op_req->clear_hash_code();
+    op_req->clear_max_hash_code();
+    tnode_context->SetPartition(tnode_context->current_partition_index() + i, op_req);
+    op->set_yb_consistency_level(select_op->yb_consistency_level());
+    RETURN_NOT_OK(ql_env_->Apply(op));
+    tnode_context->partition_reads().push_back(std::move(op));
+  }
+  return Status::OK();
+}
+
+Status Executor::MergePartitionReads(const PTSelectStmt* tnode,
+                                     const shared_ptr<YBqlReadOp>& op,
+                                     uint64_t fetch_limit,
+                                     ExecContext* exec_context,
+                                     TnodeContext* tnode_context) {
+  RowsResult::SharedPtr current_result = std::static_pointer_cast<RowsResult>(result_);
+  auto& partition_reads = tnode_context->partition_reads();
+  bool advanced = false;
+  while (!partition_reads.empty()) {
+    // Rows of the next partition could be appended only when the current partition is read
+    // completely and the limit is not reached yet. Otherwise, the rest of partitions is read one
+    // after another, as usual.
+    StatementParameters current_params;
+    RETURN_NOT_OK(current_params.set_paging_state(current_result->paging_state()));
+    if (!current_params.next_partition_key().empty() || !current_params.next_row_key().empty()) {
+      break;
+    }
+    size_t row_count = 0;
+    RETURN_NOT_OK(QLRowBlock::GetRowCount(current_result->client(),
+                                          current_result->rows_data(),
+                                          &row_count));
+    if (row_count >= fetch_limit) {
+      break;
+    }
+
+    const shared_ptr<YBqlReadOp> partition_read = std::move(partition_reads.front());
+    partition_reads.pop_front();
+    Status s = ProcessOpStatus(partition_read.get(), tnode, exec_context);
+    if (s.ok()) {
+      s = ProcessOpResponse(partition_read.get(), tnode, exec_context, false /* append_rows */);
+    }
+    RETURN_NOT_OK(ProcessStatementStatus(*exec_context->parse_tree(), s));
+    size_t partition_row_count = 0;
+    if (partition_read->rows_data().empty()) {
+      break;
+    }
+    RETURN_NOT_OK(QLRowBlock::GetRowCount(current_result->client(),
+                                          partition_read->rows_data(),
+                                          &partition_row_count));
+    if (row_count + partition_row_count > fetch_limit) {
+      break;
+    }
+
+    tnode_context->AdvanceToNextPartition(op->mutable_request());
+    advanced = true;
+    RETURN_NOT_OK(AppendResult(std::make_shared<RowsResult>(partition_read.get())));
+  }
+
+  // Partitions that were not merged are read again by the select op.
+  partition_reads.clear();
+  if (advanced) {
+    op->mutable_request()->clear_hash_code();
+    op->mutable_request()->clear_max_hash_code();
+  }
+  return Status::OK();
+}
+
 Result<bool> Executor::FetchMoreRowsIfNeeded(const PTSelectStmt* tnode,
                                              const std::shared_ptr<YBqlReadOp>& op,
                                              ExecContext* exec_context,
@@ -756,6 +904,24 @@ Result<bool> Executor::FetchMoreRowsIfNeeded(const PTSelectStmt* tnode,
     return false;
   }
 
+  size_t previous_fetches_row_count = exec_context->params()->total_num_rows_read();
+
+  // The limit for this select: min of page size and result limit (if set).
+  uint64_t fetch_limit = exec_context->params()->page_size(); // default;
+  if (tnode->has_limit()) {
+    QLExpressionPB limit_pb;
+    RETURN_NOT_OK(PTExprToPB(tnode->limit(), &limit_pb));
+    int64_t limit = limit_pb.value().int32_value() - previous_fetches_row_count;
+    if (limit < fetch_limit) {
+      fetch_limit = limit;
+    }
+  }
+
+  // Append rows of the following partitions that were read in parallel with the current one.
+  if (!tnode_context->partition_reads().empty()) {
+    RETURN_NOT_OK(MergePartitionReads(tnode, op, fetch_limit, exec_context, tnode_context));
+  }
+
   // Rows read so far: in this fetch, previous fetches (for paging selects), and in total.
   RowsResult::SharedPtr current_result = std::static_pointer_cast<RowsResult>(result_);
   size_t current_fetch_row_count = 0;
@@ -763,7 +929,6 @@ Result<bool> Executor::FetchMoreRowsIfNeeded(const PTSelectStmt* tnode,
                                         current_result->rows_data(),
                                         &current_fetch_row_count));
 
-  size_t previous_fetches_row_count = exec_context->params()->total_num_rows_read();
   size_t total_row_count = previous_fetches_row_count + current_fetch_row_count;
 
   // Statement (paging) parameters.
@@ -773,17 +938,6 @@ Result<bool> Executor::FetchMoreRowsIfNeeded(const PTSelectStmt* tnode,
   size_t total_rows_skipped = exec_context->params()->total_rows_skipped() +
       current_params.total_rows_skipped();
 
-  // The limit for this select: min of page size and result limit (if set).
-  uint64_t fetch_limit = exec_context->params()->page_size(); // default;
-  if (tnode->has_limit()) {
-    QLExpressionPB limit_pb;
-    RETURN_NOT_OK(PTExprToPB(tnode->limit(), &limit_pb));
-    int64_t limit = limit_pb.value().int32_value() - previous_fetches_row_count;
-    if (limit < fetch_limit) {
-      fetch_limit = limit;
-    }
-  }
-
   //------------------------------------------------------------------------------------------------
   // Check if we should fetch more rows (return with 'done=true' otherwise).
 
@@ -871,16 +1025,29 @@ Status Executor::ExecPTNode(const PTInsertStmt *tnode) {
     return exec_context().Error(tnode, s, ErrorCode::INVALID_ARGUMENTS);
   }
 
-  // Set the values for columns.
-  s = ColumnArgsToPB(tnode, req);
-  if (PREDICT_FALSE(!s.ok())) {
-    return exec_context().Error(tnode, s, ErrorCode::INVALID_ARGUMENTS);
+  // Set the values for columns and the column values that need to be read. Prepared statements
+  // reuse values that do not depend on bind variables.
+  const InsertRequestTemplate* request_template = nullptr;
+  if (FLAGS_cql_use_insert_request_templates) {
+    request_template = tnode->request_template([this, tnode] {
+      return BuildRequestTemplate(tnode);
+    });
   }
+  if (request_template != nullptr) {
+    s = RequestTemplateToPB(tnode, *request_template, req);
+    if (PREDICT_FALSE(!s.ok())) {
+      return exec_context().Error(tnode, s, ErrorCode::INVALID_ARGUMENTS);
+    }
+  } else {
+    s = ColumnArgsToPB(tnode, req);
+    if (PREDICT_FALSE(!s.ok())) {
+      return exec_context().Error(tnode, s, ErrorCode::INVALID_ARGUMENTS);
+    }
 
-  // Setup the column values that need to be read.
-  s = ColumnRefsToPB(tnode, req->mutable_column_refs());
-  if (PREDICT_FALSE(!s.ok())) {
-    return exec_context().Error(tnode, s, ErrorCode::INVALID_ARGUMENTS);
+    s = ColumnRefsToPB(tnode, req->mutable_column_refs());
+    if (PREDICT_FALSE(!s.ok())) {
+      return exec_context().Error(tnode, s, ErrorCode::INVALID_ARGUMENTS);
+    }
   }
 
   // Set the IF clause.
@@ -1056,11 +1223,30 @@ Status Executor::ExecPTNode(const PTUseKeyspace *tnode) {
 void Executor::FlushAsync() {
   batched_writes_by_primary_key_.clear();
   batched_writes_by_hash_key_.clear();
+  if (IsLastFlushBeforeCommit()) {
+    ql_env_->ExpectCommitAfterFlush();
+  }
   if (!ql_env_->FlushAsync(&flush_async_cb_)) {
     StatementExecuted(Status::OK());
   }
 }
 
+bool Executor::IsLastFlushBeforeCommit() {
+  if (exec_context().tnode_contexts()->empty() ||
+      exec_context().tnode_contexts()->back().tnode()->opcode() != TreeNodeOpcode::kPTCommit) {
+    return false;
+  }
+  // Deferred operations are applied in another flush after this one.
+  for (ExecContext& exec_context : exec_contexts_) {
+    for (const TnodeContext& tnode_context : *exec_context.tnode_contexts()) {
+      if (tnode_context.IsDeferred()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 void Executor::FlushAsyncDone(const Status &s, const bool rescheduled_call) {
 
   RETURN_STMT_NOT_OK(ProcessAsyncResults(s));
@@ -1091,6 +1277,13 @@ void Executor::FlushAsyncDone(const Status &s, const bool rescheduled_call) {
           }
         }
 
+        // Rows of partial reads were merged into the result of the first read of the statement,
+        // that completes the whole select.
+        if (tnode_context.is_partial_read()) {
+          tnode_contexts->erase(curr);
+          continue;
+        }
+
         // For SELECT statement, check if there are more rows to fetch.
         if (tnode->opcode() == TreeNodeOpcode::kPTSelectStmt) {
           const auto* select_stmt = static_cast<const PTSelectStmt *>(tnode);
@@ -1398,7 +1591,8 @@ Status Executor::ProcessStatementStatus(const ParseTree &parse_tree, const Statu
 
 Status Executor::ProcessOpResponse(client::YBqlOp* op,
                                    const TreeNode* tnode,
-                                   ExecContext* exec_context) {
+                                   ExecContext* exec_context,
+                                   bool append_rows) {
   const QLResponsePB &resp = op->response();
   CHECK(resp.has_status()) << "QLResponsePB status missing";
   if (resp.status() != QLResponsePB::YQL_STATUS_OK) {
@@ -1408,7 +1602,22 @@ Status Executor::ProcessOpResponse(client::YBqlOp* op,
     const ErrorCode errcode = QLStatusToErrorCode(resp.status());
     return exec_context->Error(tnode, resp.error_message().c_str(), errcode);
   }
-  return op->rows_data().empty() ? Status::OK() : AppendResult(std::make_shared<RowsResult>(op));
+  if (!append_rows || op->rows_data().empty()) {
+    return Status::OK();
+  }
+  return AppendResult(std::make_shared<RowsResult>(op));
+}
+
+Status Executor::ProcessOpStatus(client::YBqlOp* op,
+                                 const TreeNode* tnode,
+                                 ExecContext* exec_context) {
+  Status s = ql_env_->GetOpError(op);
+  if (PREDICT_FALSE(!s.ok() && !s.IsTryAgain())) {
+    // YBOperation returns not-found error when the tablet is not found.
+    const auto errcode = s.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::EXEC_ERROR;
+    s = exec_context->Error(tnode, s, errcode);
+  }
+  return s;
 }
 
 Status Executor::ProcessAsyncResults(const Status& s) {
@@ -1420,12 +1629,7 @@ Status Executor::ProcessAsyncResults(const Status& s) {
       if (op == nullptr || tnode_context.IsDeferred()) {
         continue; // Skip empty or deferred op.
       }
-      Status ss = ql_env_->GetOpError(op);
-      if (PREDICT_FALSE(!ss.ok() && !ss.IsTryAgain())) {
-        // YBOperation returns not-found error when the tablet is not found.
-        const auto errcode = ss.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::EXEC_ERROR;
-        ss = exec_context.Error(tnode, ss, errcode);
-      }
+      Status ss = ProcessOpStatus(op, tnode, &exec_context);
       if (ss.ok()) {
         ss = ProcessOpResponse(op, tnode, &exec_context);
       }
@@ -1444,7 +1648,9 @@ Status Executor::AppendResult(const RowsResult::SharedPtr& result) {
     return Status::OK();
   }
   CHECK(result_->type() == ExecutedResult::Type::ROWS);
-  return std::static_pointer_cast<RowsResult>(result_)->Append(*result);
+  // The result was just built from an op response and is not referenced elsewhere, so its rows
+  // could be moved instead of copied.
+  return std::static_pointer_cast<RowsResult>(result_)->Append(std::move(*result));
 }
 
 void Executor::StatementExecuted(const Status& s) {
@@ -155,6 +155,9 @@ class Executor : public QLExprExecutor {
   // Flush operations that have been applied. If there is none, finish the statement execution.
   void FlushAsync();
 
+  // Returns true when the pending flush is the last one before the transaction is committed.
+  bool IsLastFlushBeforeCommit();
+
   // Callback for FlushAsync.
   void FlushAsyncDone(const Status& s, bool rescheduled_call);
 
@@ -164,10 +167,16 @@ class Executor : public QLExprExecutor {
   // Process the status of executing a statement.
   CHECKED_STATUS ProcessStatementStatus(const ParseTree& parse_tree, const Status& s);
 
-  // Process the read/write op response.
+  // Process the status of applying a read/write op.
+  CHECKED_STATUS ProcessOpStatus(client::YBqlOp* op,
+                                 const TreeNode* tnode,
+                                 ExecContext* exec_context);
+
+  // Process the read/write op response. Returned rows are appended to the result if requested.
   CHECKED_STATUS ProcessOpResponse(client::YBqlOp* op,
                                    const TreeNode* tnode,
-                                   ExecContext* exec_context);
+                                   ExecContext* exec_context,
+                                   bool append_rows = true);
 
   // Process result of FlushAsyncDone.
   CHECKED_STATUS ProcessAsyncResults(const Status& s);
@@ -183,6 +192,25 @@ class Executor : public QLExprExecutor {
 
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets(const PTSelectStmt* pt_select);
+
+  // Apply reads of the partitions following the current one of a multi-partition select (i.e.
+  // with 'IN' condition on hash cols), so that they are executed in parallel with it.
+  CHECKED_STATUS ApplyPartitionReads(const PTSelectStmt* tnode,
+                                     const std::shared_ptr<client::YBqlReadOp>& select_op,
+                                     TnodeContext* tnode_context);
+
+  // Append rows of the partition reads, in partition order, while the fetch limit allows.
+  // Partitions that were not appended are read by the select op later.
+  CHECKED_STATUS MergePartitionReads(const PTSelectStmt* tnode,
+                                     const std::shared_ptr<client::YBqlReadOp>& op,
+                                     uint64_t fetch_limit,
+                                     ExecContext* exec_context,
+                                     TnodeContext* tnode_context);
+
+  // Apply an aggregate select over the whole table as a set of reads, one per tablet, executed in
+  // parallel. Returns false if the select should be applied as a regular sequential scan.
+  Result<bool> ApplyParallelAggregate(const PTSelectStmt* tnode,
+                                      const std::shared_ptr<client::YBqlReadOp>& select_op);
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
                            int column_index,
                            QLValue *ql_value);
@@ -278,6 +306,15 @@ class Executor : public QLExprExecutor {
   // Convert column arguments to protobuf.
   CHECKED_STATUS ColumnArgsToPB(const PTDmlStmt *tnode, QLWriteRequestPB *req);
 
+  // Build column values and column references of a prepared insert statement that do not depend
+  // on bind variables. Returns nullptr if the statement should be executed without a template.
+  std::unique_ptr<const InsertRequestTemplate> BuildRequestTemplate(const PTInsertStmt *tnode);
+
+  // Fill column values and column references of the request from the template and bind variables.
+  CHECKED_STATUS RequestTemplateToPB(const PTInsertStmt *tnode,
+                                     const InsertRequestTemplate& request_template,
+                                     QLWriteRequestPB *req);
+
   //------------------------------------------------------------------------------------------------
   // Where clause evaluation.
 
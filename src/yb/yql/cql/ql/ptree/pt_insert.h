@@ -18,6 +18,10 @@
 #ifndef YB_YQL_CQL_QL_PTREE_PT_INSERT_H_
 #define YB_YQL_CQL_QL_PTREE_PT_INSERT_H_
 
+#include <mutex>
+
+#include "yb/common/ql_protocol.pb.h"
+
 #include "yb/yql/cql/ql/ptree/list_node.h"
 #include "yb/yql/cql/ql/ptree/tree_node.h"
 #include "yb/yql/cql/ql/ptree/pt_select.h"
@@ -29,6 +33,21 @@ namespace ql {
 
 //--------------------------------------------------------------------------------------------------
 
+// Column values of an insert request that are the same for all executions of a prepared
+// statement. Bind variables are left empty, and are filled in for each execution.
+struct InsertRequestTemplate {
+  // Place of a bind variable value in the request.
+  struct BindSlot {
+    const PTBindVar* bind_var;
+    const ColumnDesc* col_desc;
+    // Index in hashed_column_values, range_column_values or column_values depending on column.
+    int index;
+  };
+
+  QLWriteRequestPB request;
+  std::vector<BindSlot> bind_slots;
+};
+
 class PTInsertStmt : public PTDmlStmt {
  public:
   //------------------------------------------------------------------------------------------------
@@ -73,6 +92,17 @@ class PTInsertStmt : public PTDmlStmt {
     return relation_->loc();
   }
 
+  // Returns request template of this statement, building it with the specified function on first
+  // call. Returns nullptr if the builder did not produce a template, i.e. statement should be
+  // executed without it.
+  template <class Builder>
+  const InsertRequestTemplate* request_template(const Builder& builder) const {
+    std::call_once(request_template_once_, [this, &builder] {
+      request_template_ = builder();
+    });
+    return request_template_.get();
+  }
+
  private:
   // --- The parser will decorate this node with the following information --
 
@@ -82,6 +112,11 @@ class PTInsertStmt : public PTDmlStmt {
 
   // -- The semantic analyzer will decorate this node with the following information --
 
+  // -- The executor will decorate this node with the following information --
+
+  // Prepared statements are executed concurrently, so the template is built only once.
+  mutable std::once_flag request_template_once_;
+  mutable std::unique_ptr<const InsertRequestTemplate> request_template_;
 };
 
 }  // namespace ql
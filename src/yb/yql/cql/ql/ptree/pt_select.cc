@@ -398,21 +398,26 @@ CHECKED_STATUS PTSelectStmt::AnalyzeIndexes(SemContext *sem_context) {
   }
   std::sort(selectivities.begin(), selectivities.end(), std::greater<Selectivity>());
 
-  // Find the best selectivity. For now, we will use an index only if it covers the read fully.
+  // Find the best selectivity. For now, we will use an index only if it covers the read fully,
+  // i.e. all referenced columns are indexed or included, so the read is an index-only scan.
+  // Reading the non-covered columns from the indexed table would need a second read of the
+  // indexed table for the primary keys found in the index, which the executor does not support.
   for (const Selectivity& selectivity : selectivities) {
-    if (selectivity.covers_fully()) {
-      VLOG(3) << "Selected = " << selectivity.ToString();
-      if (selectivity.is_index()) {
-        use_index_ = true;
-        read_just_index_ = true;
-        index_id_ = selectivity.index_id();
-
-        // If index is to be used, re-analyze using the index.
-        sem_context->Reset();
-        return Analyze(sem_context);
-      }
-      break;
+    if (!selectivity.covers_fully()) {
+      VLOG(3) << "Skipped, because it does not cover the read: " << selectivity.ToString();
+      continue;
+    }
+    VLOG(3) << "Selected = " << selectivity.ToString();
+    if (selectivity.is_index()) {
+      use_index_ = true;
+      read_just_index_ = true;
+      index_id_ = selectivity.index_id();
+
+      // If index is to be used, re-analyze using the index.
+      sem_context->Reset();
+      return Analyze(sem_context);
     }
+    break;
   }
 
   return Status::OK();
@@ -42,6 +42,7 @@ const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPrope
     {"memtable_flush_period_in_ms", KVProperty::kMemtableFlushPeriodInMs},
     {"min_index_interval", KVProperty::kMinIndexInterval},
     {"max_index_interval", KVProperty::kMaxIndexInterval},
+    {"read_only", KVProperty::kReadOnly},
     {"read_repair_chance", KVProperty::kReadRepairChance},
     {"speculative_retry", KVProperty::kSpeculativeRetry},
     {"transactions", KVProperty::kTransactions}
@@ -154,6 +155,7 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
   long double double_val;
   int64_t int_val;
   string str_val;
+  bool bool_val;
 
   switch (iterator->second) {
     case KVProperty::kBloomFilterFpChance:
@@ -220,6 +222,9 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetStringValueFromExpr(rhs_, true, table_property_name,
                                                              &str_val));
       break;
+    case KVProperty::kReadOnly:
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetBoolValueFromExpr(rhs_, table_property_name, &bool_val));
+      break;
     case KVProperty::kCompaction: FALLTHROUGH_INTENDED;
     case KVProperty::kCaching: FALLTHROUGH_INTENDED;
     case KVProperty::kCompression: FALLTHROUGH_INTENDED;
@@ -367,6 +372,14 @@ Status PTTableProperty::SetTableProperty(yb::TableProperties *table_property) co
       table_property->SetDefaultTimeToLive(val * MonoTime::kMillisecondsPerSecond);
       break;
     }
+    case KVProperty::kReadOnly: {
+      bool val;
+      if (!GetBoolValueFromExpr(rhs_, table_property_name, &val).ok()) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for read_only"));
+      }
+      table_property->SetReadOnly(val);
+      break;
+    }
     case KVProperty::kBloomFilterFpChance: FALLTHROUGH_INTENDED;
     case KVProperty::kComment: FALLTHROUGH_INTENDED;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
@@ -453,7 +466,26 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
     return STATUS(InvalidArgument, Substitute("$0 is not a valid table property", lhs_->c_str()));
   }
   switch (iterator->second) {
-    case PropertyMapType::kCaching: FALLTHROUGH_INTENDED;
+    case PropertyMapType::kCaching:
+      // Only 'rows_per_partition' is used: caching any rows enables the tablet row cache, that
+      // keeps results of point reads. 'keys' has no equivalent and is ignored.
+      for (const auto& subproperty : map_elements_->node_list()) {
+        string subproperty_name;
+        ToLowerCase(subproperty->lhs()->c_str(), &subproperty_name);
+        if (subproperty_name != common::kCachingRowsPerPartition) {
+          continue;
+        }
+        string str_val;
+        int64_t int_val;
+        if (GetStringValueFromExpr(subproperty->rhs(), true, subproperty_name, &str_val).ok()) {
+          ToUpperCase(str_val, &str_val);
+          table_property->SetUseRowCache(str_val != common::kCachingNone);
+        } else {
+          RETURN_NOT_OK(GetIntValueFromExpr(subproperty->rhs(), subproperty_name, &int_val));
+          table_property->SetUseRowCache(int_val > 0);
+        }
+      }
+      break;
     case PropertyMapType::kCompaction: FALLTHROUGH_INTENDED;
     case PropertyMapType::kCompression:
       LOG(WARNING) << "Ignoring table property " << table_property_name;
@@ -51,6 +51,7 @@ class PTTableProperty : public PTProperty {
     kMemtableFlushPeriodInMs,
     kMinIndexInterval,
     kMaxIndexInterval,
+    kReadOnly,
     kReadRepairChance,
     kSpeculativeRetry,
     kTransactions
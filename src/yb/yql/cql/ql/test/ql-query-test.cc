@@ -29,6 +29,8 @@ using std::unique_ptr;
 using std::shared_ptr;
 using strings::Substitute;
 
+DECLARE_int32(cql_max_parallel_partition_reads);
+
 namespace yb {
 namespace ql {
 
@@ -1245,6 +1247,57 @@ TEST_F(TestQLQuery, TestPagination) {
   EXPECT_EQ(55, sum);
 }
 
+TEST_F(TestQLQuery, TestParallelPartitionReads) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, v int, primary key((h), r));");
+  // Hash keys with different number of rows, some hash keys in the IN list have no rows.
+  for (int h = 1; h <= 50; h++) {
+    for (int r = 1; r <= h % 4; r++) {
+      CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r, v) VALUES ($0, $1, $2);", h, r, h + r));
+    }
+  }
+
+  string in_list = "1";
+  for (int h = 2; h <= 50; h += 2) {
+    in_list += Substitute(", $0", h + 1);
+  }
+
+  // Reads all pages of the select and returns rows of each page in braces.
+  auto read_pages = [processor](const string& select_stmt, int page_size) {
+    StatementParameters params;
+    params.set_page_size(page_size);
+    string result;
+    do {
+      CHECK_OK(processor->Run(select_stmt, params));
+      result += "{" + processor->row_block()->ToString() + "}";
+      if (processor->rows_result()->paging_state().empty()) {
+        break;
+      }
+      CHECK_OK(params.set_paging_state(processor->rows_result()->paging_state()));
+    } while (true);
+    return result;
+  };
+
+  // Rows and page boundaries should be the same as when partitions are read one after another.
+  for (const string& select_stmt : {
+           Substitute("SELECT h, r, v FROM t WHERE h IN ($0);", in_list),
+           Substitute("SELECT h, r, v FROM t WHERE h IN ($0) ORDER BY r DESC;", in_list),
+           Substitute("SELECT h, r, v FROM t WHERE h IN ($0) LIMIT 7;", in_list),
+           Substitute("SELECT h, r, v FROM t WHERE h IN ($0) AND r > 1;", in_list)}) {
+    for (int page_size : {1, 2, 5, 100}) {
+      FLAGS_cql_max_parallel_partition_reads = 1;
+      const string expected = read_pages(select_stmt, page_size);
+      FLAGS_cql_max_parallel_partition_reads = 128;
+      ASSERT_EQ(expected, read_pages(select_stmt, page_size)) << select_stmt << ", " << page_size;
+    }
+  }
+}
+
 TEST_F(TestQLQuery, TestTokenBcall) {
   //------------------------------------------------------------------------------------------------
   // Setting up cluster
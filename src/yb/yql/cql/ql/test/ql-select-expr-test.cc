@@ -13,6 +13,8 @@ using std::unique_ptr;
 using std::shared_ptr;
 using strings::Substitute;
 
+DECLARE_bool(cql_parallel_aggregate_scan);
+
 namespace yb {
 namespace ql {
 
@@ -304,6 +306,43 @@ TEST_F(QLTestSelectedExpr, TestAggregateExpr) {
   }
 }
 
+TEST_F(QLTestSelectedExpr, TestParallelAggregate) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE test_parallel_aggr(h int, r int, v int, primary key(h, r));");
+  const int kNumRows = 100;
+  for (int i = 0; i != kNumRows; ++i) {
+    CHECK_VALID_STMT(Substitute(
+        "INSERT INTO test_parallel_aggr(h, r, v) VALUES($0, $1, $2);", i, i % 7, i * 3));
+  }
+
+  // Parallel reads of all tablets should produce the same result as a sequential scan.
+  const string select_stmt =
+      "SELECT count(*), sum(v), min(v), max(v), avg(v) FROM test_parallel_aggr;";
+  std::vector<string> results;
+  for (bool parallel : {true, false}) {
+    FLAGS_cql_parallel_aggregate_scan = parallel;
+    CHECK_VALID_STMT(select_stmt);
+    auto row_block = processor->row_block();
+    ASSERT_EQ(1, row_block->row_count());
+    const QLRow& row = row_block->row(0);
+    EXPECT_EQ(kNumRows, row.column(0).int64_value());
+    EXPECT_EQ(3 * kNumRows * (kNumRows - 1) / 2, row.column(1).int32_value());
+    EXPECT_EQ(0, row.column(2).int32_value());
+    EXPECT_EQ(3 * (kNumRows - 1), row.column(3).int32_value());
+    results.push_back(row_block->ToString());
+  }
+  ASSERT_EQ(results[0], results[1]);
+
+  // Aggregate over rows of a single partition is not affected.
+  CHECK_VALID_STMT("SELECT count(*) FROM test_parallel_aggr WHERE h = 7;");
+  ASSERT_EQ(1, processor->row_block()->row(0).column(0).int64_value());
+}
+
 TEST_F(QLTestSelectedExpr, TestQLSelectNumericExpr) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -39,13 +39,34 @@ class TestQLStatement : public QLTestBase {
     cb.Run(s);
   }
 
-  Status ExecuteAsync(Statement *stmt, QLProcessor *processor, Callback<void(const Status&)> cb) {
-    return stmt->ExecuteAsync(processor, StatementParameters(),
+  Status ExecuteAsync(Statement *stmt, QLProcessor *processor, Callback<void(const Status&)> cb,
+                      const StatementParameters& params = StatementParameters()) {
+    return stmt->ExecuteAsync(processor, params,
                               Bind(&TestQLStatement::ExecuteAsyncDone, Unretained(this), cb));
   }
 
 };
 
+// Statement parameters with positional bind variables.
+class TestBindParameters : public StatementParameters {
+ public:
+  explicit TestBindParameters(std::vector<QLValue> values) : values_(std::move(values)) {}
+
+  CHECKED_STATUS GetBindVariable(const std::string& name,
+                                 int64_t pos,
+                                 const std::shared_ptr<QLType>& type,
+                                 QLValue* value) const override {
+    if (pos < 0 || pos >= static_cast<int64_t>(values_.size())) {
+      return STATUS_FORMAT(RuntimeError, "Bind variable at position $0 not found", pos);
+    }
+    *value = values_[pos];
+    return Status::OK();
+  }
+
+ private:
+  std::vector<QLValue> values_;
+};
+
 TEST_F(TestQLStatement, TestExecutePrepareAfterTableDrop) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -103,5 +124,50 @@ TEST_F(TestQLStatement, TestPKIndices) {
   LOG(INFO) << "Done.";
 }
 
+TEST_F(TestQLStatement, TestPreparedInsert) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  EXEC_VALID_STMT("create table t (h int, r int, c text, primary key ((h), r));");
+
+  // Insert with both constant and bind values, executed several times with different binds.
+  Statement stmt(processor->CurrentKeyspace(), "insert into t (h, r, c) values (?, 1, ?);");
+  ASSERT_OK(stmt.Prepare(processor));
+
+  const int kNumRows = 10;
+  for (int i = 0; i != kNumRows; ++i) {
+    QLValue h, c;
+    h.set_int32_value(i);
+    c.set_string_value(Substitute("v$0", i));
+    TestBindParameters params({h, c});
+    Synchronizer sync;
+    ASSERT_OK(ExecuteAsync(&stmt, processor, Bind(&Synchronizer::StatusCB, Unretained(&sync)),
+                           params));
+    ASSERT_OK(sync.Wait());
+  }
+
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_OK(processor->Run(Substitute("select r, c from t where h = $0;", i)));
+    auto row_block = processor->row_block();
+    ASSERT_EQ(1, row_block->row_count());
+    EXPECT_EQ(1, row_block->row(0).column(0).int32_value());
+    EXPECT_EQ(Substitute("v$0", i), row_block->row(0).column(1).string_value());
+  }
+
+  // Null bind value for a primary key column is rejected.
+  QLValue c;
+  c.set_string_value("null");
+  TestBindParameters params({QLValue(), c});
+  Synchronizer sync;
+  ASSERT_OK(ExecuteAsync(&stmt, processor, Bind(&Synchronizer::StatusCB, Unretained(&sync)),
+                         params));
+  Status s = sync.Wait();
+  ASSERT_TRUE(s.IsQLError() && GetErrorCode(s) == ErrorCode::NULL_ARGUMENT_FOR_PRIMARY_KEY)
+      << "Expect NULL_ARGUMENT_FOR_PRIMARY_KEY but got " << s.ToString();
+}
+
 } // namespace ql
 } // namespace yb
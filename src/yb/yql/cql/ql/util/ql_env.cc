@@ -157,6 +157,12 @@ void QLEnv::CommitTransaction(CommitCallback callback) {
   transaction->Commit(std::move(callback));
 }
 
+void QLEnv::ExpectCommitAfterFlush() {
+  if (transaction_ != nullptr) {
+    transaction_->ExpectCommitAfterNextFlush();
+  }
+}
+
 void QLEnv::SetReadPoint(const ReExecute reexecute) {
   session_->SetReadPoint(static_cast<client::Retry>(reexecute));
 }
@@ -104,6 +104,9 @@ class QLEnv {
   // Commit the current distributed transaction.
   void CommitTransaction(client::CommitCallback callback);
 
+  // Notify the current distributed transaction that it will be committed after the next flush.
+  void ExpectCommitAfterFlush();
+
   virtual std::shared_ptr<client::YBTable> GetTableDesc(const client::YBTableName& table_name,
                                                         bool *cache_used);
   virtual std::shared_ptr<client::YBTable> GetTableDesc(const TableId& table_id, bool *cache_used);
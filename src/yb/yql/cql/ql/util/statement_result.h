@@ -141,7 +141,9 @@ class RowsResult : public ExecutedResult {
   const std::string& paging_state() const { return paging_state_; }
   QLClient client() const { return client_; }
 
-  CHECKED_STATUS Append(const RowsResult& other);
+  // Appends rows of the other result, that is consumed. Rows are already in the wire format, so
+  // they are moved when this result is empty, and only the row count is patched otherwise.
+  CHECKED_STATUS Append(RowsResult&& other);
   void clear_paging_state() { paging_state_.clear(); }
   void set_paging_state(const QLPagingStatePB& paging_state) {
     paging_state.SerializeToString(&paging_state_);
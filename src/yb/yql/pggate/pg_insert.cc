@@ -15,6 +15,13 @@
 
 #include "yb/yql/pggate/pg_insert.h"
 #include "yb/client/yb_op.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(pggate_insert_batch_size, 1024,
+             "Max number of rows of a multi-row insert that are buffered before they are sent "
+             "to the tablet servers.");
+TAG_FLAG(pggate_insert_batch_size, advanced);
+TAG_FLAG(pggate_insert_batch_size, runtime);
 
 namespace yb {
 namespace pggate {
@@ -53,10 +60,15 @@ PgInsert::~PgInsert() {
 Status PgInsert::Prepare() {
   RETURN_NOT_OK(pg_session_->LoadTable(table_name_, true, &table_, &col_descs_, &key_col_count_,
                                        &partition_col_count_));
+  NewRow();
+  return Status::OK();
+}
+
+void PgInsert::NewRow() {
   op_.reset(table_->NewPgsqlInsert());
   req_ = op_->mutable_request();
 
-  col_values_.resize(col_descs_.size());
+  col_values_.assign(col_descs_.size(), nullptr);
   for (ColumnDesc col : col_descs_) {
     if (col.is_partition()) {
       col_values_[col.id()] = req_->add_partition_column_values();
@@ -66,7 +78,6 @@ Status PgInsert::Prepare() {
       col_values_[col.id()] = nullptr;
     }
   }
-  return Status::OK();
 }
 
 PgsqlExpressionPB *PgInsert::AllocColumnPB(int attr_num) {
@@ -138,8 +149,28 @@ Status PgInsert::SetColumnSerializedData(int attr_num, const char *attr_value, i
   return STATUS(NotSupported, "Setting serialized values is not yet supported");
 }
 
+Status PgInsert::NextRow() {
+  buffered_rows_.push_back(op_);
+  NewRow();
+  if (buffered_rows_.size() >= static_cast<size_t>(std::max(FLAGS_pggate_insert_batch_size, 1))) {
+    return FlushRows();
+  }
+  return Status::OK();
+}
+
+Status PgInsert::FlushRows() {
+  auto rows = std::move(buffered_rows_);
+  buffered_rows_.clear();
+  return pg_session_->Apply(rows);
+}
+
 Status PgInsert::Exec() {
-  return pg_session_->Apply(op_);
+  if (buffered_rows_.empty()) {
+    return pg_session_->Apply(op_);
+  }
+  buffered_rows_.push_back(op_);
+  NewRow();
+  return FlushRows();
 }
 
 }  // namespace pggate
@@ -55,10 +55,21 @@ class PgInsert : public PgStatement {
   // Set serialized-to-string types.
   CHECKED_STATUS SetColumnSerializedData(int attnum, const char *att_value, int att_bytes);
 
-  // Execute.
+  // Complete the current row and start a new one. Completed rows are buffered and sent together,
+  // so bulk loads do not pay an RPC round trip per row.
+  CHECKED_STATUS NextRow();
+
+  // Execute. Sends the current row together with all rows completed by NextRow().
   CHECKED_STATUS Exec();
 
  private:
+  // Allocate new write operation for the next row.
+  void NewRow();
+
+  // Send buffered rows. Rows are grouped per tablet by the session, and batches to different
+  // tablets are sent in parallel.
+  CHECKED_STATUS FlushRows();
+
   // Allocate column protobuf.
   PgsqlExpressionPB *AllocColumnPB(int attr_num);
 
@@ -74,6 +85,9 @@ class PgInsert : public PgStatement {
   vector<PgsqlExpressionPB *> col_values_;
   std::shared_ptr<client::YBPgsqlWriteOp> op_;
   PgsqlWriteRequestPB *req_ = nullptr;
+
+  // Rows completed by NextRow() that were not sent yet.
+  std::vector<client::YBOperationPtr> buffered_rows_;
 };
 
 }  // namespace pggate
@@ -15,6 +15,14 @@
 
 #include "yb/yql/pggate/pg_session.h"
 #include "yb/client/yb_op.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(pggate_session_max_buffered_operations, 0,
+             "Max number of write operations that a PostgreSQL session buffers before sending "
+             "them to the tablet servers. Errors of buffered writes are reported when they are "
+             "flushed. 0 means that each write is sent immediately.");
+TAG_FLAG(pggate_session_max_buffered_operations, advanced);
+TAG_FLAG(pggate_session_max_buffered_operations, runtime);
 
 namespace yb {
 namespace pggate {
@@ -85,6 +93,8 @@ client::YBTableCreator *PgSession::NewTableCreator() {
 }
 
 CHECKED_STATUS PgSession::DropTable(const client::YBTableName& name) {
+  // Buffered writes could refer to the dropped table, so they should complete first.
+  RETURN_NOT_OK(FlushBufferedOperations());
   return client_->DeleteTable(name);
 }
 
@@ -156,7 +166,37 @@ Status PgSession::LoadTable(
 }
 
 CHECKED_STATUS PgSession::Apply(const std::shared_ptr<client::YBPgsqlOp>& op) {
-  return session_->Apply(std::move(op));
+  const int max_buffered_ops = FLAGS_pggate_session_max_buffered_operations;
+  if (max_buffered_ops <= 0 && buffered_ops_.empty()) {
+    return session_->Apply(op);
+  }
+  buffered_ops_.push_back(op);
+  return FlushBufferedOperationsIfFull(max_buffered_ops);
+}
+
+CHECKED_STATUS PgSession::Apply(const std::vector<client::YBOperationPtr>& ops) {
+  const int max_buffered_ops = FLAGS_pggate_session_max_buffered_operations;
+  if (max_buffered_ops <= 0 && buffered_ops_.empty()) {
+    return session_->Apply(ops);
+  }
+  buffered_ops_.insert(buffered_ops_.end(), ops.begin(), ops.end());
+  return FlushBufferedOperationsIfFull(max_buffered_ops);
+}
+
+CHECKED_STATUS PgSession::FlushBufferedOperationsIfFull(int max_buffered_ops) {
+  if (max_buffered_ops <= 0 || buffered_ops_.size() >= static_cast<size_t>(max_buffered_ops)) {
+    return FlushBufferedOperations();
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS PgSession::FlushBufferedOperations() {
+  if (buffered_ops_.empty()) {
+    return Status::OK();
+  }
+  auto ops = std::move(buffered_ops_);
+  buffered_ops_.clear();
+  return session_->Apply(ops);
 }
 
 }  // namespace pggate
@@ -68,8 +68,24 @@ class PgSession {
                            std::shared_ptr<client::YBTable>* table, vector<ColumnDesc>* col_descs,
                            int* key_col_count, int* partition_col_count);
 
+  // Apply write operations. When write buffering is enabled by
+  // pggate_session_max_buffered_operations, operations are buffered until the limit is reached or
+  // FlushBufferedOperations() is called, so a transaction that runs many small writes does not
+  // wait for a round trip per write.
   CHECKED_STATUS Apply(const std::shared_ptr<client::YBPgsqlOp>& op);
 
+  // Apply multiple operations with one flush.
+  CHECKED_STATUS Apply(const std::vector<client::YBOperationPtr>& ops);
+
+  // Send all buffered write operations. Operations are grouped per tablet, and batches to
+  // different tablets are sent in parallel. Should be called before reads, so they observe
+  // writes of this session, and before commit.
+  CHECKED_STATUS FlushBufferedOperations();
+
+  bool HasBufferedOperations() const {
+    return !buffered_ops_.empty();
+  }
+
   //------------------------------------------------------------------------------------------------
   // Access functions.
   // TODO(neil) Need to double check these code later.
@@ -95,6 +111,8 @@ class PgSession {
   }
 
  private:
+  CHECKED_STATUS FlushBufferedOperationsIfFull(int max_buffered_ops);
+
   // YBClient, an API that SQL engine uses to communicate with all servers.
   std::shared_ptr<client::YBClient> client_;
 
@@ -104,6 +122,9 @@ class PgSession {
   // Connected database.
   std::string connected_database_;
 
+  // Write operations that were applied but not sent yet.
+  std::vector<client::YBOperationPtr> buffered_ops_;
+
   // Execution status.
   Status status_;
   string errmsg_;
@@ -159,6 +159,14 @@ CHECKED_STATUS PgApiImpl::ConnectDatabase(PgSession *pg_session, const char *dat
   return pg_session->ConnectDatabase(database_name);
 }
 
+CHECKED_STATUS PgApiImpl::FlushBufferedOperations(PgSession *pg_session) {
+  if (sessions_.find(pg_session) == sessions_.end()) {
+    // Invalid session.
+    return STATUS(InvalidArgument, "Invalid session handle");
+  }
+  return pg_session->FlushBufferedOperations();
+}
+
 CHECKED_STATUS PgApiImpl::AllocCreateDatabase(PgSession *pg_session,
                                               const char *database_name,
                                               PgStatement **handle) {
@@ -440,6 +448,17 @@ CHECKED_STATUS PgApiImpl::InsertSetColumnSerializedData(PgStatement *handle, int
   return pg_stmt->SetColumnSerializedData(attr_num, attr_value, attr_bytes);
 }
 
+CHECKED_STATUS PgApiImpl::InsertNextRow(PgStatement *handle) {
+  PgStatement::SharedPtr stmt = GetStatement(handle);
+  if (!PgStatement::IsValidStmt(stmt, StmtOp::STMT_INSERT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+
+  PgInsert *pg_stmt = static_cast<PgInsert*>(handle);
+  return pg_stmt->NextRow();
+}
+
 CHECKED_STATUS PgApiImpl::ExecInsert(PgStatement *handle) {
   PgStatement::SharedPtr stmt = GetStatement(handle);
   if (!PgStatement::IsValidStmt(stmt, StmtOp::STMT_INSERT)) {
@@ -80,6 +80,9 @@ class PgApiImpl {
   // Connect database. Switch the connected database to the given "database_name".
   CHECKED_STATUS ConnectDatabase(PgSession *pg_session, const char *database_name);
 
+  // Send buffered write operations of the session.
+  CHECKED_STATUS FlushBufferedOperations(PgSession *pg_session);
+
   // Create database.
   CHECKED_STATUS AllocCreateDatabase(PgSession *pg_session,
                                      const char *database_name,
@@ -159,6 +162,8 @@ class PgApiImpl {
   CHECKED_STATUS InsertSetColumnSerializedData(PgStatement *handle, int attr_num,
                                                const char *attr_value, int attr_bytes);
 
+  CHECKED_STATUS InsertNextRow(PgStatement *handle);
+
   CHECKED_STATUS ExecInsert(PgStatement *handle);
 
   //------------------------------------------------------------------------------------------------
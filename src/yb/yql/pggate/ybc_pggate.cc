@@ -60,6 +60,10 @@ YBCStatus YBCPgConnectDatabase(YBCPgSession pg_session, const char *database_nam
   return ToYBCStatus(pgapi->ConnectDatabase(pg_session, database_name));
 }
 
+YBCStatus YBCPgFlushBufferedOperations(YBCPgSession pg_session) {
+  return ToYBCStatus(pgapi->FlushBufferedOperations(pg_session));
+}
+
 YBCStatus YBCPgAllocCreateDatabase(YBCPgSession pg_session,
                                     const char *database_name,
                                     YBCPgStatement *handle) {
@@ -204,6 +208,10 @@ YBCStatus YBCPgInsertSetColumnSerializedData(YBCPgStatement handle, int attr_num
                                                           attr_bytes));
 }
 
+YBCStatus YBCPgInsertNextRow(YBCPgStatement handle) {
+  return ToYBCStatus(pgapi->InsertNextRow(handle));
+}
+
 YBCStatus YBCPgExecInsert(YBCPgStatement handle) {
   return ToYBCStatus(pgapi->ExecInsert(handle));
 }
@@ -43,6 +43,9 @@ YBCStatus YBCPgDestroySession(YBCPgSession pg_session);
 // Connect database. Switch the connected database to the given "database_name".
 YBCStatus YBCPgConnectDatabase(YBCPgSession pg_session, const char *database_name);
 
+// Send write operations buffered by the session. Should be called before reads and commit.
+YBCStatus YBCPgFlushBufferedOperations(YBCPgSession pg_session);
+
 // Create database.
 YBCStatus YBCPgAllocCreateDatabase(YBCPgSession pg_session,
                                    const char *database_name,
@@ -123,6 +126,10 @@ YBCStatus YBCPgInsertSetColumnText(YBCPgStatement handle, int attr_num, const ch
 YBCStatus YBCPgInsertSetColumnSerializedData(YBCPgStatement handle, int attr_num,
                                              const char *attr_value, int attr_bytes);
 
+// Complete the current row of a multi-row insert and start a new one. Completed rows are sent in
+// batches, the last row is completed and all remaining rows are sent by YBCPgExecInsert.
+YBCStatus YBCPgInsertNextRow(YBCPgStatement handle);
+
 YBCStatus YBCPgExecInsert(YBCPgStatement handle);
 
 #ifdef __cplusplus
@@ -241,14 +241,12 @@ CHECKED_STATUS PgCoder::TStmtToPB(const PgTSelectStmt *tstmt) {
     RETURN_NOT_OK(TExprToPB(col.expr(), col_pb));
   }
 
-#if 0
-  // TODO(neil)
-  // - Process where clause properly as soon as DocDB layer is working.
-  // - Fake a where clause for now. To save time, don't implement details yet because we need to
-  //   find out what is needed during execution phase first before constructing data here.
-  RETURN_NOT_OK(WhereClauseToPB(req, tstmt->key_where_ops(), tstmt->where_ops(),
-                                tstmt->partition_key_ops(), tstmt->func_ops(), &no_results));
-#endif
+  // Push the whole WHERE condition down to DocDB, so rows are filtered by the tablet scan and only
+  // matching rows are sent back. Columns of the condition are already in column_refs, so DocDB
+  // reads them together with the selected columns.
+  if (tstmt->where_clause() != nullptr) {
+    RETURN_NOT_OK(TExprToPB(tstmt->where_clause(), req->mutable_where_expr()));
+  }
 
   // Specify selected list by adding the expressions to selected_exprs in read request.
   PgsqlRSRowDescPB *rsrow_desc_pb = req->mutable_rsrow_desc();
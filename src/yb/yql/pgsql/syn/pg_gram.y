@@ -2771,7 +2771,6 @@ opt_where_clause:
     $$ = nullptr;
   }
   | where_clause {
-    PARSER_UNSUPPORTED(@1);
     $$ = $1;
   }
 ;
@@ -17,6 +17,7 @@
 #include "yb/yql/pgsql/ybpostgres/pg_pqcomm.h"
 #include "yb/yql/pgsql/ybpostgres/pg_type.h"
 #include "yb/common/ql_value.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/util/bytes_formatter.h"
 
 namespace yb {
@@ -182,38 +183,94 @@ void PGSend::WriteTupleDesc(const PgsqlRSRowDesc& tuple_desc, faststring *rows_d
   rows_data->append(pg_command->data);
 }
 
+namespace {
+
+void AppendInt16(uint16_t value, faststring *buffer) {
+  const uint16_t n16 = htons(value);
+  buffer->append(&n16, sizeof(n16));
+}
+
+void AppendInt32(uint32_t value, faststring *buffer) {
+  const uint32_t n32 = htonl(value);
+  buffer->append(&n32, sizeof(n32));
+}
+
+void AppendCountedText(const char *data, size_t size, faststring *buffer) {
+  AppendInt32(static_cast<uint32_t>(size), buffer);
+  buffer->append(data, size);
+}
+
+} // namespace
+
+// Result sets could be large, so DataRow messages are written straight into rows_data, without
+// building each message in its own buffer first.
 void PGSend::WriteTuples(const PgsqlResultSet& tuples,
                          const PgsqlRSRowDesc& tuple_desc,
                          faststring *rows_data) {
+  const bool write_length = PG_PROTOCOL_MAJOR(protocol_version_) >= 3;
   for (const PgsqlRSRow& tuple : tuples.rsrows()) {
-    // Start writing a row.
-    PGPqFormatter formatter;
-    formatter.pq_beginmessage('D');
+    // Start writing a row. The length is filled in when the row is complete.
+    const size_t start = rows_data->size();
+    rows_data->push_back('D');
+    if (write_length) {
+      AppendInt32(0, rows_data);
+    }
 
     // Send number of columns.
     CHECK_EQ(tuple.rscol_count(), tuple_desc.rscol_count());
-    int count = tuple_desc.rscol_count();
-    formatter.pq_sendint(count, 2);
+    AppendInt16(tuple_desc.rscol_count(), rows_data);
 
     // Send column values.
     int col_index = 0;
     for (const PgsqlRSRowDesc::RSColDesc& col_desc : tuple_desc.rscol_descs()) {
       const QLValue& col_value = tuple.rscol_value(col_index);
       if (col_value.IsNull()) {
-        formatter.pq_sendint(-1, 4);
+        AppendInt32(-1, rows_data);
       } else {
         // TODO(neil) We also need to support binary format for efficiency.
         // Output text only for now.
-        const string data = WriteColumnToString(col_value, col_desc.ql_type());
-        formatter.pq_sendcountedtext(data.c_str(), data.size(), false);
+        WriteColumnText(col_value, col_desc.ql_type(), rows_data);
       }
       col_index++;
     }
 
-    // Complete the tuple / row.
-    StringInfo pg_command;
-    WriteRpcCommand(formatter.send_buf(), '\0', &pg_command);
-    rows_data->append(pg_command->data);
+    // Complete the tuple / row. Message length includes itself, but not the message type.
+    if (write_length) {
+      const uint32_t n32 = htonl(static_cast<uint32_t>(rows_data->size() - start - 1));
+      memcpy(rows_data->data() + start + 1, &n32, sizeof(n32));
+    }
+  }
+}
+
+void PGSend::WriteColumnText(const QLValue& col_value, const QLType::SharedPtr& col_type,
+                             faststring *rows_data) {
+  char buffer[kFastToBufferSize];
+  switch (col_type->main()) {
+    case DataType::INT16: {
+      const char* end = FastInt32ToBufferLeft(col_value.int16_value(), buffer);
+      AppendCountedText(buffer, end - buffer, rows_data);
+      return;
+    }
+    case DataType::INT32: {
+      const char* end = FastInt32ToBufferLeft(col_value.int32_value(), buffer);
+      AppendCountedText(buffer, end - buffer, rows_data);
+      return;
+    }
+    case DataType::INT64: {
+      const char* end = FastInt64ToBufferLeft(col_value.int64_value(), buffer);
+      AppendCountedText(buffer, end - buffer, rows_data);
+      return;
+    }
+    case DataType::STRING: {
+      const string& value = col_value.string_value();
+      AppendCountedText(value.data(), value.size(), rows_data);
+      return;
+    }
+    default: {
+      const string data = WriteColumnToString(col_value, col_type);
+      AppendCountedText(data.data(), data.size(), rows_data);
+      return;
+    }
   }
 }
 
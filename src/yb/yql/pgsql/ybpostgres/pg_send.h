@@ -81,6 +81,10 @@ class PGSend {
                    faststring *rows_data);
   string WriteColumnToString(const QLValue& col_value, const QLType::SharedPtr& col_type);
 
+  // Write text representation of the column value as a counted field of DataRow message.
+  void WriteColumnText(const QLValue& col_value, const QLType::SharedPtr& col_type,
+                       faststring *rows_data);
+
  private:
   ProtocolVersion protocol_version_ = PG_PROTOCOL_LATEST;
 
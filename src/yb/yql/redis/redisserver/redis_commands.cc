@@ -43,7 +43,7 @@ namespace redisserver {
 
 #define REDIS_COMMANDS \
     ((get, Get, 2, READ)) \
-    ((mget, MGet, -2, READ)) \
+    ((mget, MGet, -2, MULTI_READ)) \
     ((hget, HGet, 3, READ)) \
     ((tsget, TsGet, 3, READ)) \
     ((hmget, HMGet, -3, READ)) \
@@ -61,7 +61,7 @@ namespace redisserver {
     ((getrange, GetRange, 4, READ)) \
     ((zcard, ZCard, 2, READ)) \
     ((set, Set, -3, WRITE)) \
-    ((mset, MSet, -3, WRITE)) \
+    ((mset, MSet, -3, MULTI_WRITE)) \
     ((hset, HSet, 4, WRITE)) \
     ((hmset, HMSet, -4, WRITE)) \
     ((hincrby, HIncrBy, 4, WRITE)) \
@@ -69,7 +69,7 @@ namespace redisserver {
     ((sadd, SAdd, -3, WRITE)) \
     ((srem, SRem, -3, WRITE)) \
     ((tsadd, TsAdd, -4, WRITE)) \
-    ((tsrangebytime, TsRangeByTime, 4, READ)) \
+    ((tsrangebytime, TsRangeByTime, -4, READ)) \
     ((tsrevrangebytime, TsRevRangeByTime, -4, READ)) \
     ((tslastn, TsLastN, 3, READ)) \
     ((tscard, TsCard, 2, READ)) \
@@ -82,7 +82,7 @@ namespace redisserver {
     ((zadd, ZAdd, -4, WRITE)) \
     ((getset, GetSet, 3, WRITE)) \
     ((append, Append, 3, WRITE)) \
-    ((del, Del, 2, WRITE)) \
+    ((del, Del, -2, MULTI_WRITE)) \
     ((setrange, SetRange, 4, WRITE)) \
     ((incr, Incr, 2, WRITE)) \
     ((incrby, IncrBy, 3, WRITE)) \
@@ -94,6 +94,8 @@ namespace redisserver {
     ((ping, Ping, -1, LOCAL)) \
     ((command, Command, -1, LOCAL)) \
     ((quit, Quit, 1, LOCAL)) \
+    ((readonly, ReadOnly, 1, LOCAL)) \
+    ((readwrite, ReadWrite, 1, LOCAL)) \
     ((flushdb, FlushDB, 1, LOCAL)) \
     ((flushall, FlushAll, 1, LOCAL)) \
     ((debugsleep, DebugSleep, 2, LOCAL)) \
@@ -108,6 +110,9 @@ BOOST_PP_SEQ_FOR_EACH(DEFINE_HISTOGRAM, ~, REDIS_COMMANDS)
 
 #define READ_OP yb::client::YBRedisReadOp
 #define WRITE_OP yb::client::YBRedisWriteOp
+// Parsers of multi-key commands are invoked for each key, with arguments of this key only.
+#define MULTI_READ_OP yb::client::YBRedisReadOp
+#define MULTI_WRITE_OP yb::client::YBRedisWriteOp
 #define LOCAL_OP RedisResponsePB
 #define CLUSTER_OP RedisResponsePB
 
@@ -142,10 +147,63 @@ void Command(
   context->Apply(idx, std::move(op), info.metrics);
 }
 
+// Number of arguments that belong to each key of multi-key commands.
+constexpr size_t kMGetArgsPerKey = 1;
+constexpr size_t kMSetArgsPerKey = 2;
+constexpr size_t kDelArgsPerKey = 1;
+
+// Splits command into separate operations for each of its keys. They are applied as usual, so
+// operations for keys located in different tablets are sent in parallel, and their responses are
+// merged into a single response by merger.
+template<class Op>
+void MultiKeyCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    Parser<Op> parser,
+    size_t args_per_key,
+    MultiKeyResponse::Merger merger,
+    BatchContext* context) {
+  VLOG(1) << "Processing " << info.name << ".";
+
+  const auto& command = context->command(idx);
+  if ((command.size() - 1) % args_per_key != 0) {
+    RespondWithFailure(context->call(), idx, "wrong number of arguments");
+    return;
+  }
+
+  std::vector<std::shared_ptr<Op>> ops;
+  ops.reserve((command.size() - 1) / args_per_key);
+  RedisClientCommand key_command;
+  for (auto it = command.begin() + 1; it != command.end(); it += args_per_key) {
+    key_command.clear();
+    key_command.push_back(command[0]);
+    key_command.insert(key_command.end(), it, it + args_per_key);
+    auto op = std::make_shared<Op>(context->table());
+    Status s = parser(op.get(), key_command);
+    if (!s.ok()) {
+      RespondWithFailure(context->call(), idx, s.message().ToBuffer());
+      return;
+    }
+    ops.push_back(std::move(op));
+  }
+
+  auto response = std::make_shared<MultiKeyResponse>(
+      context->call(), idx, ops.size(), info.metrics, std::move(merger));
+  for (size_t i = 0; i != ops.size(); ++i) {
+    context->Apply(idx, std::move(ops[i]), info.metrics, response, i);
+  }
+}
+
 #define READ_COMMAND(cname) \
     Command<yb::client::YBRedisReadOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
 #define WRITE_COMMAND(cname) \
     Command<yb::client::YBRedisWriteOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
+#define MULTI_COMMAND(op, cname) \
+    MultiKeyCommand<op>(info, idx, &BOOST_PP_CAT(Parse, cname), \
+                        BOOST_PP_CAT(BOOST_PP_CAT(k, cname), ArgsPerKey), \
+                        &BOOST_PP_CAT(Merge, cname), context)
+#define MULTI_READ_COMMAND(cname) MULTI_COMMAND(yb::client::YBRedisReadOp, cname)
+#define MULTI_WRITE_COMMAND(cname) MULTI_COMMAND(yb::client::YBRedisWriteOp, cname)
 #define LOCAL_COMMAND(cname) \
     BOOST_PP_CAT(Handle, cname)({info, idx, context});
 #define CLUSTER_COMMAND(cname) ClusterCommand(info, idx, context)
@@ -319,6 +377,50 @@ void AddElements(const RefCntBuffer& buffer, RedisArrayPB* array) {
   array->add_elements(buffer.data(), buffer.size());
 }
 
+void MergeMGet(std::vector<RedisResponsePB>* key_responses, RedisResponsePB* response) {
+  auto array_response = response->mutable_array_response();
+  for (auto& key_response : *key_responses) {
+    // Same as Redis, nil is returned for keys that do not hold a string value.
+    if (key_response.code() == RedisResponsePB::OK && key_response.has_string_response()) {
+      AddElements(redisserver::EncodeAsBulkString(key_response.string_response()), array_response);
+    } else {
+      array_response->add_elements(kNilResponse);
+    }
+  }
+  array_response->set_encoded(true);
+  response->set_code(RedisResponsePB::OK);
+}
+
+void MergeMSet(std::vector<RedisResponsePB>* key_responses, RedisResponsePB* response) {
+  for (auto& key_response : *key_responses) {
+    if (key_response.code() != RedisResponsePB::OK) {
+      response->Swap(&key_response);
+      return;
+    }
+  }
+  response->set_code(RedisResponsePB::OK);
+}
+
+void MergeDel(std::vector<RedisResponsePB>* key_responses, RedisResponsePB* response) {
+  int64_t num_deleted = 0;
+  bool has_count = false;
+  for (auto& key_response : *key_responses) {
+    if (key_response.code() != RedisResponsePB::OK) {
+      response->Swap(&key_response);
+      return;
+    }
+    // Deleted keys are counted only when Redis responses are emulated.
+    if (key_response.has_int_response()) {
+      num_deleted += key_response.int_response();
+      has_count = true;
+    }
+  }
+  response->set_code(RedisResponsePB::OK);
+  if (has_count) {
+    response->set_int_response(num_deleted);
+  }
+}
+
 void HandleRole(LocalCommandData data) {
   RedisResponsePB response;
   response.set_code(RedisResponsePB::OK);
@@ -358,6 +460,19 @@ void HandleQuit(LocalCommandData data) {
   data.Respond();
 }
 
+// Same as in Redis cluster, READONLY allows reads of the connection to be served by follower
+// replicas. The closest replica is used, and its staleness is bounded by
+// max_stale_read_bound_time_ms on the tablet server.
+void HandleReadOnly(LocalCommandData data) {
+  data.call()->connection_context().set_follower_reads_allowed(true);
+  data.Respond();
+}
+
+void HandleReadWrite(LocalCommandData data) {
+  data.call()->connection_context().set_follower_reads_allowed(false);
+  data.Respond();
+}
+
 void HandleFlushDB(LocalCommandData data) {
   RedisResponsePB resp;
 
@@ -444,6 +559,49 @@ void RespondWithFailure(
   call->RespondFailure(idx, STATUS_FORMAT(InvalidCommand, "ERR $0: $1", cmd, error));
 }
 
+MultiKeyResponse::MultiKeyResponse(std::shared_ptr<RedisInboundCall> call,
+                                   size_t idx,
+                                   size_t num_keys,
+                                   const rpc::RpcMethodMetrics& metrics,
+                                   Merger merger)
+    : call_(std::move(call)),
+      idx_(idx),
+      metrics_(metrics),
+      merger_(std::move(merger)),
+      key_responses_(num_keys),
+      keys_left_(num_keys) {
+}
+
+void MultiKeyResponse::KeyDone(size_t key_idx, const Status& status, RedisResponsePB* response) {
+  auto& key_response = key_responses_[key_idx];
+  if (response) {
+    key_response.Swap(response);
+  }
+  if (!status.ok()) {
+    // Server errors already have their message in the response.
+    if (key_response.code() != RedisResponsePB::SERVER_ERROR) {
+      Slice message = status.message();
+      key_response.set_code(RedisResponsePB::PARSING_ERROR);
+      key_response.set_error_message(message.data(), message.size());
+    }
+    size_t expected = kNoFailure;
+    failed_key_.compare_exchange_strong(expected, key_idx, std::memory_order_acq_rel);
+  }
+
+  if (keys_left_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  auto failed_key = failed_key_.load(std::memory_order_acquire);
+  if (failed_key != kNoFailure) {
+    call_->Respond(idx_, false, &key_responses_[failed_key]);
+    return;
+  }
+  RedisResponsePB merged_response;
+  merger_(&key_responses_, &merged_response);
+  call_->RespondSuccess(idx_, metrics_, &merged_response);
+}
+
 void FillRedisCommands(const scoped_refptr<MetricEntity>& metric_entity,
                        const std::function<void(const RedisCommandInfo& info)>& setup_method) {
   BOOST_PP_SEQ_FOR_EACH(POPULATE_HANDLER, ~, REDIS_COMMANDS);
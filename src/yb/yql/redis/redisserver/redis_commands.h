@@ -14,13 +14,18 @@
 #ifndef YB_YQL_REDIS_REDISSERVER_REDIS_COMMANDS_H
 #define YB_YQL_REDIS_REDISSERVER_REDIS_COMMANDS_H
 
+#include <atomic>
 #include <functional>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include <boost/function.hpp>
 
 #include "yb/client/client_fwd.h"
 
+#include "yb/common/redis_protocol.pb.h"
+
 #include "yb/rpc/service_if.h"
 
 #include "yb/yql/redis/redisserver/redis_fwd.h"
@@ -32,6 +37,37 @@ namespace redisserver {
 
 typedef boost::function<void(const Status&)> StatusFunctor;
 
+// Combines responses to operations, that were created for keys of the same multi-key command like
+// MGET, into a single response to this command. It is sent when operations for all keys are done.
+class MultiKeyResponse {
+ public:
+  // Fills response to the command from responses for its keys, that are passed in key order.
+  typedef std::function<void(std::vector<RedisResponsePB>*, RedisResponsePB*)> Merger;
+
+  MultiKeyResponse(std::shared_ptr<RedisInboundCall> call,
+                   size_t idx,
+                   size_t num_keys,
+                   const rpc::RpcMethodMetrics& metrics,
+                   Merger merger);
+
+  // Should be invoked once per key. A failed operation fails the whole command, like it does for
+  // a single key command.
+  void KeyDone(size_t key_idx, const Status& status, RedisResponsePB* response);
+
+ private:
+  static constexpr size_t kNoFailure = std::numeric_limits<size_t>::max();
+
+  std::shared_ptr<RedisInboundCall> call_;
+  size_t idx_;
+  rpc::RpcMethodMetrics metrics_;
+  Merger merger_;
+  std::vector<RedisResponsePB> key_responses_;
+  std::atomic<size_t> keys_left_;
+  std::atomic<size_t> failed_key_{kNoFailure};
+};
+
+typedef std::shared_ptr<MultiKeyResponse> MultiKeyResponsePtr;
+
 // Context for batch of Redis commands.
 class BatchContext : public RefCountedThreadSafe<BatchContext> {
  public:
@@ -51,6 +87,22 @@ class BatchContext : public RefCountedThreadSafe<BatchContext> {
       std::shared_ptr<client::YBRedisWriteOp> operation,
       const rpc::RpcMethodMetrics& metrics) = 0;
 
+  // Applies operation for key with index key_idx of a multi-key command, its response is passed to
+  // multi_key_response instead of the call.
+  virtual void Apply(
+      size_t index,
+      std::shared_ptr<client::YBRedisReadOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      const MultiKeyResponsePtr& multi_key_response,
+      size_t key_idx) = 0;
+
+  virtual void Apply(
+      size_t index,
+      std::shared_ptr<client::YBRedisWriteOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      const MultiKeyResponsePtr& multi_key_response,
+      size_t key_idx) = 0;
+
   virtual void Apply(
       size_t index,
       std::function<bool(const StatusFunctor&)> functor,
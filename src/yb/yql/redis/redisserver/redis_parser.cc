@@ -145,13 +145,13 @@ CHECKED_STATUS ParseSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// TODO: support MSET
+// Invoked for each key of MSET, with the key and its value as arguments.
 CHECKED_STATUS ParseMSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
-  if (args.size() < 3 || args.size() % 2 == 0) {
+  if (args.size() != 3) {
     return STATUS_SUBSTITUTE(InvalidCommand,
-        "An MSET request must have at least 3, odd number of arguments, found $0", args.size());
+        "An MSET request must have an odd number of arguments, found $0", args.size());
   }
-  return STATUS(InvalidCommand, "MSET command not yet supported");
+  return ParseSet(op, args);
 }
 
 CHECKED_STATUS ParseHSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
@@ -407,7 +407,7 @@ CHECKED_STATUS ParseAppend(YBRedisWriteOp* op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// Note: deleting only one key is supported using one command as of now.
+// Invoked for each key of DEL, with this key as the only argument.
 CHECKED_STATUS ParseDel(YBRedisWriteOp* op, const RedisClientCommand& args) {
   const auto& key = args[1];
   op->mutable_request()->set_allocated_del_request(new RedisDelRequestPB());
@@ -481,9 +481,9 @@ CHECKED_STATUS ParseHGetLikeCommands(YBRedisReadOp* op, const RedisClientCommand
   return ParseCollection(op, args, boost::none, add_string_subkey, remove_duplicates);
 }
 
-// TODO: Support MGET
+// Invoked for each key of MGET, with this key as the only argument.
 CHECKED_STATUS ParseMGet(YBRedisReadOp* op, const RedisClientCommand& args) {
-  return STATUS(InvalidCommand, "MGET command not yet supported");
+  return ParseGet(op, args);
 }
 
 CHECKED_STATUS ParseHGet(YBRedisReadOp* op, const RedisClientCommand& args) {
@@ -602,6 +602,36 @@ CHECKED_STATUS ParseTsRangeByTime(YBRedisReadOp* op, const RedisClientCommand& a
       RedisCollectionGetRangeRequestPB_GetRangeRequestType_TSRANGEBYTIME));
 
   op->mutable_request()->mutable_key_value()->set_key(key.ToBuffer());
+
+  if (args.size() > 4) {
+    if (args.size() != 7) {
+      return STATUS_SUBSTITUTE(InvalidCommand,
+                               "Invalid number of arguments. Command should have 4 or 7 arguments");
+    }
+    string upper_arg;
+    ToUpperCase(args[4].ToBuffer(), &upper_arg);
+    if (upper_arg != "AGGREGATION") {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "Invalid argument $0. Expecting $1", args[4].ToBuffer(),
+                               "aggregation");
+    }
+    RedisCollectionGetRangeRequestPB::AggregationType aggregation_type;
+    ToUpperCase(args[5].ToBuffer(), &upper_arg);
+    if (!RedisCollectionGetRangeRequestPB::AggregationType_Parse(upper_arg, &aggregation_type)) {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "Invalid aggregation $0. Expecting one of AVG, MIN, MAX, SUM, COUNT",
+                               args[5].ToBuffer());
+    }
+    auto bucket_size = util::CheckedStoll(args[6]);
+    RETURN_NOT_OK(bucket_size);
+    if (*bucket_size <= 0) {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+          "$0 field $1 is not within valid bounds", "bucket size", args[6].ToDebugString());
+    }
+    auto* range_request = op->mutable_request()->mutable_get_collection_range_request();
+    range_request->set_aggregation_type(aggregation_type);
+    range_request->set_aggregation_bucket_size(*bucket_size);
+  }
   return Status::OK();
 }
 
@@ -970,12 +1000,15 @@ CHECKED_STATUS RedisParser::FindEndOfLine() {
   auto p = offset_to_idx_and_local_offset(pos_);
 
   size_t new_line_offset = pos_;
+  // Set when the preceding character was found in the same block as \n.
+  bool prefixed_with_cr = false;
   while (p.first != source_.size()) {
     auto begin = IoVecBegin(source_[p.first]) + p.second;
     auto new_line = static_cast<const char*>(memchr(
         begin, '\n', IoVecEnd(source_[p.first]) - begin));
     if (new_line) {
       new_line_offset += new_line - begin;
+      prefixed_with_cr = new_line != IoVecBegin(source_[p.first]) && new_line[-1] == '\r';
       break;
     }
     new_line_offset += source_[p.first].iov_len - p.second;
@@ -988,7 +1021,7 @@ CHECKED_STATUS RedisParser::FindEndOfLine() {
     if (new_line_offset == token_begin_) {
       return STATUS(NetworkError, "End of line at the beginning of a Redis command");
     }
-    if (char_at_offset(new_line_offset - 1) != '\r') {
+    if (!prefixed_with_cr && char_at_offset(new_line_offset - 1) != '\r') {
       return STATUS(NetworkError, "\\n is not prefixed with \\r");
     }
     pos_ = ++new_line_offset;
@@ -1014,6 +1047,30 @@ const char* RedisParser::offset_to_pointer(size_t offset) const {
   return IoVecBegin(source_[p.first]) + p.second;
 }
 
+bool RedisParser::ParseDigitsInPlace(size_t begin, size_t end, int64_t* result) const {
+  // Longer numbers could overflow, they are handled by the generic path.
+  constexpr size_t kMaxDigits = std::numeric_limits<int64_t>::digits10;
+  if (begin == end || end - begin > kMaxDigits) {
+    return false;
+  }
+  auto p = offset_to_idx_and_local_offset(begin);
+  const auto& block = source_[p.first];
+  if (p.second + (end - begin) > block.iov_len) {
+    return false;
+  }
+  const char* it = IoVecBegin(block) + p.second;
+  const char* stop = it + (end - begin);
+  int64_t value = 0;
+  for (; it != stop; ++it) {
+    if (*it < '0' || *it > '9') {
+      return false;
+    }
+    value = value * 10 + (*it - '0');
+  }
+  *result = value;
+  return true;
+}
+
 // Parses number with specified bounds.
 // Number is located in separate line, and contain prefix before actual number.
 // Line starts at token_begin_ and pos_ is a start of next line.
@@ -1032,11 +1089,14 @@ Result<ptrdiff_t> RedisParser::ParseNumber(char prefix,
     return STATUS_FORMAT(
         Corruption, "Too long $0 of length $1", name, expected_stop - number_begin);
   }
-  number_buffer_.reserve(kMaxNumberLength);
-  IoVecsToBuffer(source_, number_begin, expected_stop, &number_buffer_);
-  number_buffer_.push_back(0);
-  auto parsed_number = VERIFY_RESULT(util::CheckedStoll(
-      Slice(number_buffer_.data(), number_buffer_.size() - 1)));
+  int64_t parsed_number;
+  if (!ParseDigitsInPlace(number_begin, expected_stop, &parsed_number)) {
+    number_buffer_.reserve(kMaxNumberLength);
+    IoVecsToBuffer(source_, number_begin, expected_stop, &number_buffer_);
+    number_buffer_.push_back(0);
+    parsed_number = VERIFY_RESULT(util::CheckedStoll(
+        Slice(number_buffer_.data(), number_buffer_.size() - 1)));
+  }
   static_assert(sizeof(parsed_number) == sizeof(ptrdiff_t), "Expected size");
   SCHECK_BOUNDS(parsed_number,
                 min,
@@ -105,6 +105,10 @@ class RedisParser {
                                 ptrdiff_t max,
                                 const char* name);
 
+  // Fast path of ParseNumber for a number that consists of digits only and is located in a single
+  // block, so it could be parsed without copying. Returns false if the generic path should be used.
+  bool ParseDigitsInPlace(size_t begin, size_t end, int64_t* result) const;
+
   // Returns pointer to byte with specified offset in all iovecs of source_.
   // Pointer byte is valid, the end of valid range should be determined separately if required.
   const char* offset_to_pointer(size_t offset) const;
@@ -185,6 +185,8 @@ Status RedisInboundCall::ParseFrom(
                          end_of_command, request_data_.size());
   }
 
+  MaybeStartSampledTrace();
+
   parsed_.store(true, std::memory_order_release);
   return Status::OK();
 }
@@ -213,6 +215,10 @@ void RedisInboundCall::LogTrace() const {
   }
 }
 
+RedisConnectionContext& RedisInboundCall::connection_context() const {
+  return static_cast<RedisConnectionContext&>(connection()->context());
+}
+
 string RedisInboundCall::ToString() const {
   return Format("Redis Call from $0", connection()->remote());
 }
@@ -265,6 +271,8 @@ Out DoSerializeResponses(const Collection& responses, Out out) {
       out = SerializeEncoded(kNilResponse, out);
     } else if (redis_response.code() != RedisResponsePB_RedisStatusCode_OK) {
       out = SerializeError(error_message, out);
+    } else if (redis_response.has_encoded_response()) {
+      out = SerializeEncoded(redis_response.encoded_response(), out);
     } else if (redis_response.has_string_response()) {
       out = SerializeBulkString(redis_response.string_response(), out);
     } else if (redis_response.has_status_response()) {
@@ -295,7 +303,7 @@ RefCntBuffer SerializeResponses(const Collection& responses) {
   return result;
 }
 
-void RedisInboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
+void RedisInboundCall::Serialize(rpc::OutboundSlices* output) const {
   output->push_back(SerializeResponses(responses_));
 }
 
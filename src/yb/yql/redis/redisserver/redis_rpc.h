@@ -16,6 +16,8 @@
 #ifndef YB_YQL_REDIS_REDISSERVER_REDIS_RPC_H
 #define YB_YQL_REDIS_REDISSERVER_REDIS_RPC_H
 
+#include <atomic>
+
 #include <boost/container/small_vector.hpp>
 
 #include "yb/yql/redis/redisserver/redis_fwd.h"
@@ -41,6 +43,15 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
 
   static std::string Name() { return "Redis"; }
 
+  // Whether reads of this connection could be served by followers, i.e. READONLY was issued.
+  bool follower_reads_allowed() const {
+    return follower_reads_allowed_.load(std::memory_order_acquire);
+  }
+
+  void set_follower_reads_allowed(bool value) {
+    follower_reads_allowed_.store(value, std::memory_order_release);
+  }
+
  private:
   void Connected(const rpc::ConnectionPtr& connection) override {}
 
@@ -63,6 +74,7 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
   size_t end_of_batch_ = 0;
 
   MemTrackerPtr call_mem_tracker_;
+  std::atomic<bool> follower_reads_allowed_{false};
 };
 
 class RedisInboundCall : public rpc::QueueableInboundCall {
@@ -79,7 +91,7 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
 
   // Serialize the response packet for the finished call.
   // The resulting slices refer to memory in this object.
-  void Serialize(std::deque<RefCntBuffer>* output) const override;
+  void Serialize(rpc::OutboundSlices* output) const override;
 
   void LogTrace() const override;
   std::string ToString() const override;
@@ -89,6 +101,8 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
 
   RedisClientBatch& client_batch() { return client_batch_; }
 
+  RedisConnectionContext& connection_context() const;
+
   const std::string& service_name() const override;
   const std::string& method_name() const override;
 
@@ -47,6 +47,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/memory/mc_types.h"
 #include "yb/util/size_literals.h"
@@ -100,6 +101,11 @@ DEFINE_int32(redis_callbacks_threadpool_size, 64,
              "The maximum size for the threadpool which handles callbacks from the ybclient layer");
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
+DEFINE_bool(redis_encoded_read_responses, true,
+            "Allow tablet servers to return array responses to Redis reads already encoded in "
+            "RESP, so they are sent to the client without being encoded by the Redis service.");
+TAG_FLAG(redis_encoded_read_responses, advanced);
+TAG_FLAG(redis_encoded_read_responses, runtime);
 
 DECLARE_string(placement_cloud);
 DECLARE_string(placement_region);
@@ -144,12 +150,16 @@ class Operation {
   Operation(const std::shared_ptr<RedisInboundCall>& call,
             size_t index,
             std::shared_ptr<Op> operation,
-            const rpc::RpcMethodMetrics& metrics)
+            const rpc::RpcMethodMetrics& metrics,
+            MultiKeyResponsePtr multi_key_response = nullptr,
+            size_t key_idx = 0)
     : type_(std::is_same<Op, YBRedisReadOp>::value ? OperationType::kRead : OperationType::kWrite),
       call_(call),
       index_(index),
       operation_(std::move(operation)),
-      metrics_(metrics) {
+      metrics_(metrics),
+      multi_key_response_(std::move(multi_key_response)),
+      key_idx_(key_idx) {
     auto status = operation_->GetPartitionKey(&partition_key_);
     if (!status.ok()) {
       Respond(status);
@@ -257,6 +267,13 @@ class Operation {
   }
 
   void Respond(const Status& status) {
+    if (multi_key_response_) {
+      // Response for each key should be passed exactly once.
+      if (!responded_.exchange(true, std::memory_order_acq_rel)) {
+        multi_key_response_->KeyDone(key_idx_, status, &response());
+      }
+      return;
+    }
     responded_.store(true, std::memory_order_release);
     if (status.ok()) {
       if (operation_) {
@@ -285,6 +302,8 @@ class Operation {
   std::function<bool(const StatusFunctor&)> functor_;
   std::string partition_key_;
   rpc::RpcMethodMetrics metrics_;
+  MultiKeyResponsePtr multi_key_response_;
+  size_t key_idx_;
   scoped_refptr<client::internal::RemoteTablet> tablet_;
   std::atomic<bool> responded_{false};
 };
@@ -646,6 +665,14 @@ class TabletOperations {
   OperationType last_conflict_type_ = OperationType::kNone;
 };
 
+// Operations of a batch that belong to the same partition, so they share a single tablet lookup.
+struct TabletLookup {
+  explicit TabletLookup(Arena* arena) : operations(MCVector<Operation*>::allocator_type(arena)) {}
+
+  scoped_refptr<client::internal::RemoteTablet> tablet;
+  MCVector<Operation*> operations;
+};
+
 class BatchContextImpl : public BatchContext {
  public:
   BatchContextImpl(
@@ -664,6 +691,7 @@ class BatchContextImpl : public BatchContext {
         metrics_internal_(metrics_internal),
         consumption_(mem_tracker, 0),
         operations_(&arena_),
+        lookups_(&arena_),
         tablets_(&arena_) {}
 
   virtual ~BatchContextImpl() {}
@@ -695,14 +723,24 @@ class BatchContextImpl : public BatchContext {
 
     MonoTime deadline = MonoTime::Now() +
                         MonoDelta::FromMilliseconds(FLAGS_redis_service_yb_client_timeout_millis);
-    lookups_left_.store(operations_.size(), std::memory_order_release);
+    // Pipelined batches usually contain many operations per tablet, so meta cache is asked once
+    // per partition instead of once per operation.
     for (auto& operation : operations_) {
+      Slice partition_start(table_->FindPartitionStart(operation.partition_key()));
+      auto it = lookups_.find(partition_start);
+      if (it == lookups_.end()) {
+        it = lookups_.emplace(partition_start, TabletLookup(&arena_)).first;
+      }
+      it->second.operations.push_back(&operation);
+    }
+    lookups_left_.store(lookups_.size(), std::memory_order_release);
+    for (auto& lookup : lookups_) {
       client_->LookupTabletByKey(
           table_.get(),
-          operation.partition_key(),
+          lookup.second.operations.front()->partition_key(),
           deadline,
-          &operation.tablet(),
-          Bind(&BatchContextImpl::LookupDone, this, &operation));
+          &lookup.second.tablet,
+          Bind(&BatchContextImpl::LookupDone, this, &lookup.second));
     }
   }
 
@@ -710,6 +748,11 @@ class BatchContextImpl : public BatchContext {
       size_t index,
       std::shared_ptr<client::YBRedisReadOp> operation,
       const rpc::RpcMethodMetrics& metrics) override {
+    PrepareRead(operation.get());
+    // The response is sent to the client as is, so it could be encoded by the tablet server.
+    if (FLAGS_redis_encoded_read_responses) {
+      operation->mutable_request()->set_encoded_response_allowed(true);
+    }
     DoApply(index, std::move(operation), metrics);
   }
 
@@ -720,6 +763,25 @@ class BatchContextImpl : public BatchContext {
     DoApply(index, std::move(operation), metrics);
   }
 
+  void Apply(
+      size_t index,
+      std::shared_ptr<client::YBRedisReadOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      const MultiKeyResponsePtr& multi_key_response,
+      size_t key_idx) override {
+    PrepareRead(operation.get());
+    DoApply(index, std::move(operation), metrics, multi_key_response, key_idx);
+  }
+
+  void Apply(
+      size_t index,
+      std::shared_ptr<client::YBRedisWriteOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      const MultiKeyResponsePtr& multi_key_response,
+      size_t key_idx) override {
+    DoApply(index, std::move(operation), metrics, multi_key_response, key_idx);
+  }
+
   void Apply(
       size_t index,
       std::function<bool(const StatusFunctor&)> functor,
@@ -733,6 +795,12 @@ class BatchContextImpl : public BatchContext {
   }
 
  private:
+  void PrepareRead(client::YBRedisReadOp* operation) {
+    if (call_->connection_context().follower_reads_allowed()) {
+      operation->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    }
+  }
+
   template <class... Args>
   void DoApply(Args&&... args) {
     operations_.emplace_back(call_, std::forward<Args>(args)...);
@@ -743,9 +811,13 @@ class BatchContextImpl : public BatchContext {
     }
   }
 
-  void LookupDone(Operation* operation, const Status& status) {
-    if (!status.ok()) {
-      operation->Respond(status);
+  void LookupDone(TabletLookup* lookup, const Status& status) {
+    for (auto* operation : lookup->operations) {
+      if (status.ok()) {
+        operation->tablet() = lookup->tablet;
+      } else {
+        operation->Respond(status);
+      }
     }
     if (lookups_left_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
       return;
@@ -780,6 +852,7 @@ class BatchContextImpl : public BatchContext {
   Arena arena_;
   MCDeque<Operation> operations_;
   std::atomic<size_t> lookups_left_;
+  MCUnorderedMap<Slice, TabletLookup, Slice::Hash> lookups_;
   MCUnorderedMap<Slice, TabletOperations, Slice::Hash> tablets_;
 };
 
@@ -2047,6 +2047,45 @@ TEST_F(TestRedisService, TestTsRangeByTime) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestTsRangeByTimeAggregation) {
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_agg",
+      "-3", "4",
+      "0", "1",
+      "1", "2",
+      "4", "3",
+      "5", "10",
+      "9", "20",
+  });
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_str", "1", "v1"});
+  SyncClient();
+
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "AGGREGATION", "AVG", "5"},
+      {"-5", "4.000000", "0", "2.000000", "5", "15.000000"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "aggregation", "count",
+      "5"}, {"-5", "1", "0", "3", "5", "2"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "+inf", "AGGREGATION", "MAX", "5"},
+      {"0", "3.000000", "5", "20.000000"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-3", "(5", "AGGREGATION", "MIN", "5"},
+      {"-5", "4.000000", "0", "1.000000"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-3", "9", "AGGREGATION", "SUM", "100"},
+      {"0", "40.000000"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "10", "20", "AGGREGATION", "SUM", "5"},
+      {});
+
+  // Test invalid requests.
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "10", "AGGREGATION", "AVG"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "10", "AGGREGATION", "MEDIAN",
+      "5"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "10", "AGGREGATION", "AVG",
+      "0"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "10", "LIMIT", "AVG", "5"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_str", "0", "10", "AGGREGATION", "AVG",
+      "5"});
+
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestTsRevRangeByTime) {
   DoRedisTestOk(__LINE__, {"TSADD", "ts_key",
       "-50", "v1",
@@ -2583,6 +2622,63 @@ TEST_F(TestRedisService, TestDel) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestReadOnly) {
+  DoRedisTestOk(__LINE__, {"SET", "key", "value"});
+  SyncClient();
+  DoRedisTestOk(__LINE__, {"READONLY"});
+  DoRedisTestBulkString(__LINE__, {"GET", "key"}, "value");
+  // Writes are still allowed, and are served by the leader.
+  DoRedisTestOk(__LINE__, {"SET", "key", "new_value"});
+  SyncClient();
+  DoRedisTestOk(__LINE__, {"READWRITE"});
+  DoRedisTestBulkString(__LINE__, {"GET", "key"}, "new_value");
+  SyncClient();
+  VerifyCallbacks();
+}
+
+TEST_F(TestRedisService, TestMultiKeyCommands) {
+  FLAGS_emulate_redis_responses = true;
+
+  // Enough keys to be spread over different tablets.
+  constexpr int kNumKeys = 50;
+  std::vector<std::string> mset = {"MSET"};
+  std::vector<std::string> mget = {"MGET"};
+  std::vector<std::string> del = {"DEL"};
+  std::vector<std::string> expected;
+  for (int i = 0; i != kNumKeys; ++i) {
+    const auto key = Format("key_$0", i);
+    mset.push_back(key);
+    mset.push_back(Format("value_$0", i));
+    mget.push_back(key);
+    expected.push_back(Format("value_$0", i));
+    // Every other key is deleted.
+    if (i % 2 == 0) {
+      del.push_back(key);
+    }
+  }
+  mget.push_back("non_existent");
+  expected.push_back("");
+
+  DoRedisTestOk(__LINE__, mset);
+  SyncClient();
+  DoRedisTestArray(__LINE__, mget, expected);
+  SyncClient();
+  DoRedisTestInt(__LINE__, del, kNumKeys / 2);
+  SyncClient();
+  for (int i = 0; i < kNumKeys; i += 2) {
+    expected[i] = "";
+  }
+  DoRedisTestArray(__LINE__, mget, expected);
+  DoRedisTestExpectError(__LINE__, {"MSET", "key_1", "value_1", "key_2"});
+  SyncClient();
+  // Keys that do not hold a string are returned as nil.
+  DoRedisTestInt(__LINE__, {"HSET", "map_key", "subkey", "value"}, 1);
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"MGET", "key_1", "map_key"}, {"value_1", ""});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestHDel) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;